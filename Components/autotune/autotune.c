@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "autotune_api.h"
+
+static autotune_result_t autotune_results[AUTOTUNE_MAX_RESULTS];
+static uint32_t autotune_count = 0;
+
+static const struct {
+    uint32_t bit;
+    const char *name;
+} autotune_features[] = {
+    {TUNING_BPU, "bpu"},
+    {TUNING_LDSPEC, "ldspec"},
+    {TUNING_ICACHE, "icache"},
+    {TUNING_DCACHE, "dcache"},
+    {TUNING_L2, "l2"},
+};
+
+/* Spread the bits of combination idx to the bits set in mask */
+static uint32_t autotune_expand(uint32_t mask, uint32_t idx)
+{
+    uint32_t enable = 0, bit;
+
+    for (bit = 1; mask != 0; bit <<= 1) {
+        if (mask & bit) {
+            if (idx & 1) {
+                enable |= bit;
+            }
+            idx >>= 1;
+            mask &= ~bit;
+        }
+    }
+    return enable;
+}
+
+static uint64_t autotune_measure(autotune_fn_t fn, void *arg, uint32_t repeat)
+{
+    uint64_t start, cycles, best = UINT64_MAX;
+    uint32_t i;
+
+    // warm up caches and branch predictor under the new setting
+    fn(arg);
+    for (i = 0; i < repeat; i++) {
+        start = __get_rv_cycle();
+        fn(arg);
+        cycles = __get_rv_cycle() - start;
+        if (cycles < best) {
+            best = cycles;
+        }
+    }
+    return best;
+}
+
+static void autotune_print(const autotune_result_t *result, uint64_t base)
+{
+    uint32_t i;
+
+    if (base == 0) {
+        base = 1;
+    }
+    for (i = 0; i < sizeof(autotune_features) / sizeof(autotune_features[0]); i++) {
+        if (result->mask & autotune_features[i].bit) {
+            printf("%s=%c ", autotune_features[i].name, (result->enable & autotune_features[i].bit) ? '1' : '0');
+        }
+    }
+    printf(": %lu cycles, %lu.%02lu%%\n", (unsigned long)result->cycles,
+           (unsigned long)(result->cycles * 100 / base), (unsigned long)(result->cycles * 10000 / base % 100));
+}
+
+uint32_t autotune_run(autotune_fn_t fn, void *arg, uint32_t vary_mask, uint32_t repeat, autotune_result_t *best)
+{
+    uint32_t orig = SystemTuning_Get();
+    uint32_t mask = vary_mask & SystemTuning_Supported();
+    uint32_t bits = 0, combs, i, bestidx = 0;
+    autotune_result_t *result;
+
+    for (i = mask; i != 0; i &= i - 1) {
+        bits++;
+    }
+    combs = 1U << bits;
+    if ((mask == 0) || (combs > AUTOTUNE_MAX_RESULTS)) {
+        autotune_count = 0;
+        return 0;
+    }
+    if (repeat == 0) {
+        repeat = AUTOTUNE_REPEAT;
+    }
+    // measure from all enabled to all disabled, so the first one is the usual setting
+    for (i = 0; i < combs; i++) {
+        result = &autotune_results[i];
+        result->mask = mask;
+        result->enable = autotune_expand(mask, combs - 1 - i);
+        SystemTuning_Set(mask, result->enable);
+        result->cycles = autotune_measure(fn, arg, repeat);
+        if (result->cycles < autotune_results[bestidx].cycles) {
+            bestidx = i;
+        }
+    }
+    SystemTuning_Set(mask, orig);
+    autotune_count = combs;
+
+    printf("Autotune %lu combinations, %lu runs each, relative to first one:\n", (unsigned long)combs, (unsigned long)repeat);
+    for (i = 0; i < combs; i++) {
+        printf("%c ", (i == bestidx) ? '*' : ' ');
+        autotune_print(&autotune_results[i], autotune_results[0].cycles);
+    }
+    if (best != NULL) {
+        *best = autotune_results[bestidx];
+    }
+    return combs;
+}
+
+int32_t autotune_get_result(uint32_t idx, autotune_result_t *result)
+{
+    if (idx >= autotune_count) {
+        return -1;
+    }
+    *result = autotune_results[idx];
+    return 0;
+}
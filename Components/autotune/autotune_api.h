@@ -0,0 +1,58 @@
+#ifndef _AUTOTUNE_API_H_
+#define _AUTOTUNE_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*
+ * A/B selection of micro-architecture tuning features.
+ *
+ * autotune_run() runs a workload under every combination of the features to vary, using
+ * SystemTuning_Set() of the SoC, measures the minimal cycles of each combination, prints a
+ * table of them, and returns the fastest combination, the features of current hart are
+ * restored before it returns, so the caller decides whether to apply the result by
+ * SystemTuning_Set(result.mask, result.enable).
+ *
+ * - Workload must be repeatable and produce the same result under all settings, it runs
+ *   once for warm up and then AUTOTUNE_REPEAT times for each combination by default
+ * - Features not supported by the hart are removed from the vary mask
+ * - Only current hart is tuned, interrupts of it should be quiet during the run to get
+ *   stable numbers
+ */
+
+/* max number of results recorded, one for each combination */
+#define AUTOTUNE_MAX_RESULTS    32
+
+/* measured runs of each combination when repeat of autotune_run is 0 */
+#ifndef AUTOTUNE_REPEAT
+#define AUTOTUNE_REPEAT         5
+#endif
+
+/* workload to measure */
+typedef void (*autotune_fn_t)(void *arg);
+
+/* measure result of one combination */
+typedef struct autotune_result {
+    uint32_t mask;                  /* features varied */
+    uint32_t enable;                /* features enabled of mask */
+    uint64_t cycles;                /* minimal cycles of one run */
+} autotune_result_t;
+
+/*
+ * Run fn(arg) under all combinations of features in vary_mask, repeat times each,
+ * store the fastest one in best and return the number of combinations measured,
+ * return 0 if no feature in vary_mask is supported
+ */
+uint32_t autotune_run(autotune_fn_t fn, void *arg, uint32_t vary_mask, uint32_t repeat, autotune_result_t *best);
+
+/* Get result of combination idx measured by last autotune_run, return -1 if not exist */
+int32_t autotune_get_result(uint32_t idx, autotune_result_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_AUTOTUNE_API_H_ */
@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# autotune middleware runs a workload under combinations of micro-architecture
+# tuning features and selects the fastest one
+MIDDLEWARE_AUTOTUNE := $(NUCLEI_SDK_MIDDLEWARE)/autotune
+
+C_SRCDIRS += $(MIDDLEWARE_AUTOTUNE)
+
+INCDIRS += $(MIDDLEWARE_AUTOTUNE)
@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# canrx middleware drains gd32vf103 CAN receive FIFOs into a time stamped frame ring,
+# and sets filter banks from a list of wanted identifiers
+MIDDLEWARE_CANRX := $(NUCLEI_SDK_MIDDLEWARE)/canrx
+
+C_SRCDIRS += $(MIDDLEWARE_CANRX)
+
+INCDIRS += $(MIDDLEWARE_CANRX)
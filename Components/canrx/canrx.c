@@ -0,0 +1,295 @@
+#include <stdint.h>
+#include <stddef.h>
+#include "nuclei_sdk_soc.h"
+#include "canrx_api.h"
+
+#if defined(__GD32VF103_H__)
+
+#define CANRX_STD_BITS              0x7FFUL
+#define CANRX_EXT_BITS              0x1FFFFFFFUL
+
+/* frame format and type bits of filter fields, extended data frames and standard data frames */
+#define CANRX_F32_IDE_RTR           0x6UL
+#define CANRX_F32_IDE               0x4UL
+#define CANRX_F16_IDE_RTR           0x18UL
+
+/* identifiers or identifier groups, mask bits set must match */
+typedef struct {
+    uint32_t id;
+    uint32_t mask;
+    uint32_t ext;
+} canrx_group_t;
+
+static canrx_t *canrx_devs[2];
+static canrx_group_t canrx_groups[CANRX_FILTER_MAX_IDS];
+
+static void canrx_fifo_irq(uint32_t idx, uint8_t fifo)
+{
+    canrx_t *rx = canrx_devs[idx];
+    uint32_t periph, head;
+    canrx_frame_t *f;
+    volatile uint32_t *rfifo;
+
+    if (rx == NULL) {
+        return;
+    }
+    periph = rx->periph;
+    rfifo = (fifo == CAN_FIFO0) ? &CAN_RFIFO0(periph) : &CAN_RFIFO1(periph);
+    if ((*rfifo & CAN_RFIFO0_RFO0) != 0) {
+        // a frame was lost by the hardware FIFO
+        *rfifo = CAN_RFIFO0_RFO0;
+        rx->hw_overruns++;
+    }
+    head = rx->head;
+    while ((*rfifo & CAN_RFIFO0_RFL0) != 0) {
+        if (head - rx->tail >= rx->size) {
+            // ring full, drop the frame to keep the hardware FIFO going
+            rx->overruns++;
+        } else {
+            f = &rx->ring[head & (rx->size - 1)];
+            f->time = SysTimer_GetLoadValue();
+            f->rfifomi = CAN_RFIFOMI(periph, fifo);
+            f->rfifomp = CAN_RFIFOMP(periph, fifo);
+            f->rfifomdata0 = CAN_RFIFOMDATA0(periph, fifo);
+            f->rfifomdata1 = CAN_RFIFOMDATA1(periph, fifo);
+            head++;
+        }
+        *rfifo = CAN_RFIFO0_RFD0;
+    }
+    // frame contents are visible before the new head
+    __RWMB();
+    rx->head = head;
+}
+
+static void canrx_can0_rx0_handler(void) { canrx_fifo_irq(0, CAN_FIFO0); }
+static void canrx_can0_rx1_handler(void) { canrx_fifo_irq(0, CAN_FIFO1); }
+static void canrx_can1_rx0_handler(void) { canrx_fifo_irq(1, CAN_FIFO0); }
+static void canrx_can1_rx1_handler(void) { canrx_fifo_irq(1, CAN_FIFO1); }
+
+int32_t canrx_init(canrx_t *rx, uint8_t lvl)
+{
+    uint32_t idx = (rx->periph == CAN1) ? 1 : 0;
+    IRQn_Type irq0 = (idx == 0) ? CAN0_RX0_IRQn : CAN1_RX0_IRQn;
+    IRQn_Type irq1 = (idx == 0) ? CAN0_RX1_IRQn : CAN1_RX1_IRQn;
+
+    if ((rx->ring == NULL) || (rx->size == 0) || ((rx->size & (rx->size - 1)) != 0)) {
+        return -1;
+    }
+    rx->head = 0;
+    rx->tail = 0;
+    rx->overruns = 0;
+    rx->hw_overruns = 0;
+    canrx_devs[idx] = rx;
+    if ((ECLIC_Register_IRQ(irq0, ECLIC_NON_VECTOR_INTERRUPT, ECLIC_LEVEL_TRIGGER, lvl, 0,
+                            (void *)((idx == 0) ? canrx_can0_rx0_handler : canrx_can1_rx0_handler)) != 0) ||
+        (ECLIC_Register_IRQ(irq1, ECLIC_NON_VECTOR_INTERRUPT, ECLIC_LEVEL_TRIGGER, lvl, 0,
+                            (void *)((idx == 0) ? canrx_can0_rx1_handler : canrx_can1_rx1_handler)) != 0)) {
+        canrx_devs[idx] = NULL;
+        return -1;
+    }
+    can_interrupt_enable(rx->periph, CAN_INT_RFNE0 | CAN_INT_RFO0 | CAN_INT_RFNE1 | CAN_INT_RFO1);
+    return 0;
+}
+
+void canrx_deinit(canrx_t *rx)
+{
+    uint32_t idx = (rx->periph == CAN1) ? 1 : 0;
+
+    can_interrupt_disable(rx->periph, CAN_INT_RFNE0 | CAN_INT_RFO0 | CAN_INT_RFNE1 | CAN_INT_RFO1);
+    ECLIC_DisableIRQ((idx == 0) ? CAN0_RX0_IRQn : CAN1_RX0_IRQn);
+    ECLIC_DisableIRQ((idx == 0) ? CAN0_RX1_IRQn : CAN1_RX1_IRQn);
+    canrx_devs[idx] = NULL;
+}
+
+uint32_t canrx_count(canrx_t *rx)
+{
+    return rx->head - rx->tail;
+}
+
+uint32_t canrx_read(canrx_t *rx, can_receive_message_struct *msg, uint64_t *time)
+{
+    uint32_t tail = rx->tail;
+    canrx_frame_t *f;
+    uint32_t i;
+
+    if (rx->head == tail) {
+        return 0;
+    }
+    // frame contents are read after the head
+    __RWMB();
+    f = &rx->ring[tail & (rx->size - 1)];
+    msg->rx_ff = (uint8_t)(CAN_RFIFOMI_FF & f->rfifomi);
+    if (msg->rx_ff == CAN_FF_STANDARD) {
+        msg->rx_sfid = GET_RFIFOMI_SFID(f->rfifomi);
+    } else {
+        msg->rx_efid = GET_RFIFOMI_EFID(f->rfifomi);
+    }
+    msg->rx_ft = (uint8_t)(CAN_RFIFOMI_FT & f->rfifomi);
+    msg->rx_fi = (uint8_t)GET_RFIFOMP_FI(f->rfifomp);
+    msg->rx_dlen = (uint8_t)GET_RFIFOMP_DLENC(f->rfifomp);
+    for (i = 0; i < 4; i++) {
+        msg->rx_data[i] = (uint8_t)(f->rfifomdata0 >> (i * 8));
+        msg->rx_data[i + 4] = (uint8_t)(f->rfifomdata1 >> (i * 8));
+    }
+    if (time != NULL) {
+        *time = f->time;
+    }
+    // slot is free for the interrupt after the copy
+    __RWMB();
+    rx->tail = tail + 1;
+    return 1;
+}
+
+/* banks taken by groups */
+static uint32_t canrx_banks(canrx_group_t *g, uint32_t n)
+{
+    uint32_t i, cnt[4] = {0, 0, 0, 0};
+
+    // 0: standard list, 1: standard mask, 2: extended list, 3: extended mask
+    for (i = 0; i < n; i++) {
+        cnt[(g[i].ext ? 2 : 0) + ((g[i].mask != (g[i].ext ? CANRX_EXT_BITS : CANRX_STD_BITS)) ? 1 : 0)]++;
+    }
+    return (cnt[0] + 3) / 4 + (cnt[1] + 1) / 2 + (cnt[2] + 1) / 2 + cnt[3];
+}
+
+/* merge the two groups of the same format keeping most matched bits, return 0 if none */
+static uint32_t canrx_merge(canrx_group_t *g, uint32_t n)
+{
+    uint32_t i, j, m, bi = 0, bj = 0, bm = 0;
+    int32_t best = -1;
+
+    for (i = 0; i < n; i++) {
+        for (j = i + 1; j < n; j++) {
+            if (g[i].ext != g[j].ext) {
+                continue;
+            }
+            m = g[i].mask & g[j].mask & ~(g[i].id ^ g[j].id);
+            if ((int32_t)__builtin_popcount(m) > best) {
+                best = __builtin_popcount(m);
+                bi = i;
+                bj = j;
+                bm = m;
+            }
+        }
+    }
+    if (best < 0) {
+        return 0;
+    }
+    g[bi].mask = bm;
+    g[bi].id &= bm;
+    g[bj] = g[n - 1];
+    return 1;
+}
+
+static void canrx_filter_set(uint32_t bank, uint32_t bits, uint32_t mode, const uint32_t *v)
+{
+    can_filter_parameter_struct f;
+
+    // field order of can_filter_init(): 16 bits FDATA0 = mask_low:list_low, FDATA1 = mask_high:list_high,
+    // 32 bits FDATA0 = list_high:list_low, FDATA1 = mask_high:mask_low
+    if (bits == CAN_FILTERBITS_16BIT) {
+        f.filter_list_low = (uint16_t)v[0];
+        f.filter_mask_low = (uint16_t)v[1];
+        f.filter_list_high = (uint16_t)v[2];
+        f.filter_mask_high = (uint16_t)v[3];
+    } else {
+        f.filter_list_high = (uint16_t)(v[0] >> 16);
+        f.filter_list_low = (uint16_t)v[0];
+        f.filter_mask_high = (uint16_t)(v[1] >> 16);
+        f.filter_mask_low = (uint16_t)v[1];
+    }
+    f.filter_number = (uint16_t)bank;
+    f.filter_bits = (uint16_t)bits;
+    f.filter_mode = (uint16_t)mode;
+    // banks go to FIFO0 and FIFO1 in turn
+    f.filter_fifo_number = (uint16_t)((bank & 1) ? CAN_FIFO1 : CAN_FIFO0);
+    f.filter_enable = ENABLE;
+    can_filter_init(&f);
+}
+
+int32_t canrx_filter_config(const uint32_t *ids, uint32_t n, uint32_t first_bank, uint32_t nbanks)
+{
+    canrx_group_t *g = canrx_groups;
+    uint32_t i, j, k, ng = 0, bank = first_bank;
+    uint32_t v[4];
+    uint32_t kind, per, full, list;
+    can_filter_parameter_struct off;
+
+    if ((n > CANRX_FILTER_MAX_IDS) || (nbanks == 0)) {
+        return -1;
+    }
+    for (i = 0; i < n; i++) {
+        full = (ids[i] & CANRX_ID_EXT) ? CANRX_EXT_BITS : CANRX_STD_BITS;
+        for (j = 0; j < ng; j++) {
+            if ((g[j].ext == ((ids[i] & CANRX_ID_EXT) ? 1U : 0U)) && (g[j].id == (ids[i] & full))) {
+                break;
+            }
+        }
+        if (j == ng) {
+            g[ng].id = ids[i] & full;
+            g[ng].mask = full;
+            g[ng].ext = (ids[i] & CANRX_ID_EXT) ? 1 : 0;
+            ng++;
+        }
+    }
+    while (canrx_banks(g, ng) > nbanks) {
+        if (canrx_merge(g, ng) == 0) {
+            return -1;
+        }
+        ng--;
+    }
+    // fill banks kind by kind: standard list, standard mask, extended list, extended mask
+    for (kind = 0; kind < 4; kind++) {
+        list = ((kind & 1) == 0) ? 1 : 0;
+        per = (kind < 2) ? (list ? 4 : 2) : (list ? 2 : 1);
+        k = 0;
+        for (i = 0; i < ng; i++) {
+            full = g[i].ext ? CANRX_EXT_BITS : CANRX_STD_BITS;
+            if ((g[i].ext != ((kind >= 2) ? 1U : 0U)) || ((g[i].mask == full) != (list == 1))) {
+                continue;
+            }
+            if (kind < 2) {
+                if (list) {
+                    v[k] = g[i].id << 5;
+                } else {
+                    v[k * 2] = g[i].id << 5;
+                    v[k * 2 + 1] = (g[i].mask << 5) | CANRX_F16_IDE_RTR;
+                }
+            } else {
+                if (list) {
+                    v[k] = (g[i].id << 3) | CANRX_F32_IDE;
+                } else {
+                    v[0] = (g[i].id << 3) | CANRX_F32_IDE;
+                    v[1] = (g[i].mask << 3) | CANRX_F32_IDE_RTR;
+                }
+            }
+            if (++k == per) {
+                canrx_filter_set(bank++, (kind < 2) ? CAN_FILTERBITS_16BIT : CAN_FILTERBITS_32BIT,
+                                 list ? CAN_FILTERMODE_LIST : CAN_FILTERMODE_MASK, v);
+                k = 0;
+            }
+        }
+        if (k > 0) {
+            // repeat the first entry in the free slots
+            for (j = k; j < per; j++) {
+                if (list) {
+                    v[j] = v[0];
+                } else {
+                    v[j * 2] = v[0];
+                    v[j * 2 + 1] = v[1];
+                }
+            }
+            canrx_filter_set(bank++, (kind < 2) ? CAN_FILTERBITS_16BIT : CAN_FILTERBITS_32BIT,
+                             list ? CAN_FILTERMODE_LIST : CAN_FILTERMODE_MASK, v);
+        }
+    }
+    for (i = bank; i < first_bank + nbanks; i++) {
+        can_struct_para_init(CAN_FILTER_STRUCT, &off);
+        off.filter_number = (uint16_t)i;
+        off.filter_enable = DISABLE;
+        can_filter_init(&off);
+    }
+    return (int32_t)(bank - first_bank);
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef _CANRX_API_H_
+#define _CANRX_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+
+/*
+ * CAN receive layer for the gd32vf103 CAN0/CAN1.
+ *
+ * - Both hardware receive FIFOs of a CAN are drained in their not empty interrupts into a
+ *   caller owned ring of frames, each frame is stamped with the SysTimer counter when it is
+ *   taken, the interrupt only copies the four mailbox registers, canrx_read() decodes them
+ * - The ring has one producer (the interrupts) and one consumer (canrx_read()), no lock is
+ *   taken, a frame arriving on a full ring is dropped and counted in overruns, frames lost
+ *   by a hardware FIFO overfull are counted in hw_overruns
+ * - canrx_filter_config() sets filter banks from a list of wanted identifiers: identifiers
+ *   are put in list mode banks (four standard or two extended ones per bank), when they do
+ *   not fit in the banks given the closest identifiers are merged into mask mode filters,
+ *   banks are given to FIFO0 and FIFO1 in turn so both FIFOs share the traffic
+ *
+ * Filter banks are shared by CAN0 and CAN1, the banks of CAN1 start at the one set by
+ * can1_filter_start_bank(), give each CAN its own range.
+ */
+
+/* identifier flags of canrx_filter_config() id list */
+#define CANRX_ID_EXT                0x80000000UL    /* extended identifier, else standard */
+#define CANRX_ID_MASK               0x1FFFFFFFUL
+
+/* most identifiers of one canrx_filter_config() call */
+#ifndef CANRX_FILTER_MAX_IDS
+#define CANRX_FILTER_MAX_IDS        112
+#endif
+
+/* frame as read from a FIFO mailbox */
+typedef struct canrx_frame {
+    uint64_t time;                  /* SysTimer counter when the frame was taken */
+    uint32_t rfifomi;
+    uint32_t rfifomp;
+    uint32_t rfifomdata0;
+    uint32_t rfifomdata1;
+} canrx_frame_t;
+
+typedef struct canrx {
+    uint32_t periph;                /* CAN0 or CAN1 */
+    canrx_frame_t *ring;            /* ring of frames */
+    uint32_t size;                  /* frames in ring, power of 2 */
+    /* private */
+    volatile uint32_t head;         /* written by interrupt */
+    volatile uint32_t tail;         /* written by canrx_read() */
+    volatile uint32_t overruns;
+    volatile uint32_t hw_overruns;
+} canrx_t;
+
+/*
+ * Start receiving of an initialized CAN, periph, ring and size of rx must be set, the
+ * FIFO interrupts are registered at level lvl, return 0 on success
+ */
+int32_t canrx_init(canrx_t *rx, uint8_t lvl);
+
+/* Stop receiving */
+void canrx_deinit(canrx_t *rx);
+
+/* Return number of frames in ring */
+uint32_t canrx_count(canrx_t *rx);
+
+/* Read the oldest frame to msg and its time stamp to time (can be NULL), return 0 if no frame */
+uint32_t canrx_read(canrx_t *rx, can_receive_message_struct *msg, uint64_t *time);
+
+/*
+ * Configure filter banks first_bank to first_bank + nbanks - 1 to pass the n identifiers of
+ * ids (CANRX_ID_EXT flags extended ones), data frames only, unused banks of the
+ * range are disabled, return number of banks used, or -1 if ids is too long or the identifiers
+ * do not fit (nbanks is 0, or 1 with both standard and extended ones)
+ */
+int32_t canrx_filter_config(const uint32_t *ids, uint32_t n, uint32_t first_bank, uint32_t nbanks);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _CANRX_API_H_ */
@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# caustream middleware runs streaming AES/DES/TDES on gd32vw55x CAU with FIFOs fed
+# by dmaq DMA and the context of the last used stream kept in the CAU, add dmaq to MIDDLEWARE too
+MIDDLEWARE_CAUSTREAM := $(NUCLEI_SDK_MIDDLEWARE)/caustream
+
+C_SRCDIRS += $(MIDDLEWARE_CAUSTREAM)
+
+INCDIRS += $(MIDDLEWARE_CAUSTREAM)
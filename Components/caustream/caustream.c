@@ -0,0 +1,362 @@
+#include <stdint.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "caustream_api.h"
+
+/* GCM phase of stream */
+#define CAUS_PHASE_NONE             0
+#define CAUS_PHASE_PREPARE          1
+#define CAUS_PHASE_AAD              2
+#define CAUS_PHASE_PAYLOAD          3
+
+/* words of one DMA transfer, below 65535 and a multiple of the AES block */
+#define CAUS_DMA_WORDS              0xFFF0
+
+#define CAUS_DI_ADDR                ((uint32_t)(unsigned long)&CAU_DI)
+#define CAUS_DO_ADDR                ((uint32_t)(unsigned long)&CAU_DO)
+
+static uint32_t caus_in_chan = CAUSTREAM_NO_DMA;
+static uint32_t caus_out_chan = CAUSTREAM_NO_DMA;
+/* stream whose state is loaded in the CAU */
+static caustream_t *caus_owner = NULL;
+
+static uint32_t caus_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline void caus_wait_idle(void)
+{
+    while ((CAU_STAT0 & (CAU_STAT0_IEM | CAU_STAT0_BUSY)) != CAU_STAT0_IEM) {
+    }
+}
+
+/* make cs the owner of the CAU, saving the state of the stream owning it before */
+static void caus_own(caustream_t *cs)
+{
+    if (caus_owner == cs) {
+        return;
+    }
+    if (caus_owner != NULL) {
+        cau_context_save(&caus_owner->ctx, &caus_owner->key);
+    }
+    cau_context_restore(&cs->ctx);
+    if (cs->phase == CAUS_PHASE_PREPARE) {
+        // restored in prepare phase, the hash subkey is computed again
+        while (cau_enable_state_get() == ENABLE) {
+        }
+    }
+    caus_owner = cs;
+}
+
+/*
+ * Feed len bytes of in and take the output to out, or drop it if out is NULL, the IN FIFO is
+ * kept filled while the OUT FIFO is drained, so the core never waits for the CPU between blocks
+ */
+static void caus_cpu(const uint8_t *in, uint8_t *out, uint32_t len)
+{
+    uint32_t words = len / 4;
+    uint32_t wi = 0, ri = 0;
+    uint32_t val;
+
+    while ((wi < words) || ((out != NULL) && (ri < words))) {
+        if ((wi < words) && ((CAU_STAT0 & CAU_STAT0_INF) != 0)) {
+            memcpy(&val, in + wi * 4, 4);
+            CAU_DI = val;
+            wi++;
+        }
+        if ((out != NULL) && ((CAU_STAT0 & CAU_STAT0_ONE) != 0)) {
+            val = CAU_DO;
+            memcpy(out + ri * 4, &val, 4);
+            ri++;
+        }
+    }
+    if (out == NULL) {
+        caus_wait_idle();
+    }
+}
+
+/* Move len bytes through the CAU by IN and OUT FIFO DMA, buffers are 4 bytes aligned */
+static int32_t caus_dma(const uint8_t *in, uint8_t *out, uint32_t len)
+{
+    dmaq_req_t inreq, outreq;
+    uint32_t words;
+    int32_t ret = 0;
+
+    while ((len > 0) && (ret == 0)) {
+        words = len / 4;
+        if (words > CAUS_DMA_WORDS) {
+            words = CAUS_DMA_WORDS;
+        }
+        inreq.periph_addr = CAUS_DI_ADDR;
+        inreq.mem = (void *)in;
+        inreq.count = words;
+        inreq.dir = DMAQ_DIR_M2P;
+        inreq.width = 4;
+        inreq.periph_inc = 0;
+        inreq.mem_inc = 1;
+        inreq.cb = NULL;
+        inreq.arg = NULL;
+        if (out != NULL) {
+            outreq = inreq;
+            outreq.periph_addr = CAUS_DO_ADDR;
+            outreq.mem = out;
+            outreq.dir = DMAQ_DIR_P2M;
+            // output channel first, the core stalls if the OUT FIFO is full and not served
+            if (dmaq_submit(caus_out_chan, &outreq) != 0) {
+                return -1;
+            }
+        }
+        if (dmaq_submit(caus_in_chan, &inreq) != 0) {
+            ret = -1;
+            break;
+        }
+        CAU_DMAEN = (out != NULL) ? (CAU_DMA_INFIFO | CAU_DMA_OUTFIFO) : CAU_DMA_INFIFO;
+        if (dmaq_wait(&inreq) != DMAQ_DONE) {
+            ret = -1;
+        }
+        if (out != NULL) {
+            if (dmaq_wait(&outreq) != DMAQ_DONE) {
+                ret = -1;
+            }
+            out += words * 4;
+        } else {
+            caus_wait_idle();
+        }
+        CAU_DMAEN = 0;
+        in += words * 4;
+        len -= words * 4;
+    }
+    if (ret != 0) {
+        // drop the partial output, the stream is not usable any more
+        CAU_DMAEN = 0;
+        cau_fifo_flush();
+    }
+    return ret;
+}
+
+static int32_t caus_xfer(const uint8_t *in, uint8_t *out, uint32_t len)
+{
+    if ((caus_in_chan != CAUSTREAM_NO_DMA) && (len >= CAUSTREAM_DMA_MIN) &&
+        ((((unsigned long)in | (unsigned long)out) & 3) == 0)) {
+        return caus_dma(in, out, len);
+    }
+    caus_cpu(in, out, len);
+    return 0;
+}
+
+/* feed len bytes less than a block padded with zero, return output in the same block */
+static void caus_last_block(caustream_t *cs, const uint8_t *in, uint8_t *out, uint32_t len)
+{
+    uint32_t block[4] = {0};
+
+    memcpy(block, in, len);
+    caus_cpu((const uint8_t *)block, (out != NULL) ? (uint8_t *)block : NULL, cs->block);
+    if (out != NULL) {
+        memcpy(out, block, len);
+    }
+}
+
+static void caus_gcm_phase(caustream_t *cs, uint32_t phase, uint32_t reg)
+{
+    cau_phase_config(reg);
+    cau_fifo_flush();
+    cau_enable();
+    cs->phase = phase;
+}
+
+int32_t caustream_init(uint32_t in_chan, uint32_t out_chan)
+{
+    if ((in_chan == CAUSTREAM_NO_DMA) != (out_chan == CAUSTREAM_NO_DMA)) {
+        return -1;
+    }
+    rcu_periph_clock_enable(RCU_CAU);
+    caus_in_chan = in_chan;
+    caus_out_chan = out_chan;
+    caus_owner = NULL;
+    return 0;
+}
+
+int32_t caustream_start(caustream_t *cs, uint32_t mode, uint32_t dir, const uint8_t *key,
+                        uint32_t keylen, const uint8_t *iv)
+{
+    uint32_t k[8] = {0};
+    uint32_t keysize = 0;
+    uint32_t first, i;
+    cau_iv_parameter_struct ivs = {0};
+
+    switch (mode) {
+        case CAU_MODE_AES_ECB:
+        case CAU_MODE_AES_CBC:
+        case CAU_MODE_AES_CTR:
+        case CAU_MODE_AES_GCM:
+            if (keylen == 16) {
+                keysize = CAU_KEYSIZE_128BIT;
+            } else if (keylen == 24) {
+                keysize = CAU_KEYSIZE_192BIT;
+            } else if (keylen == 32) {
+                keysize = CAU_KEYSIZE_256BIT;
+            } else {
+                return -1;
+            }
+            // AES key ends at KEY3L
+            first = 8 - keylen / 4;
+            cs->block = 16;
+            break;
+        case CAU_MODE_DES_ECB:
+        case CAU_MODE_DES_CBC:
+        case CAU_MODE_TDES_ECB:
+        case CAU_MODE_TDES_CBC:
+            if (keylen != (((mode == CAU_MODE_DES_ECB) || (mode == CAU_MODE_DES_CBC)) ? 8 : 24)) {
+                return -1;
+            }
+            // DES keys start at KEY1H
+            first = 2;
+            cs->block = 8;
+            break;
+        default:
+            return -1;
+    }
+    for (i = 0; i < keylen / 4; i++) {
+        k[first + i] = caus_be32(key + i * 4);
+    }
+    cs->key.key_0_high = k[0];
+    cs->key.key_0_low = k[1];
+    cs->key.key_1_high = k[2];
+    cs->key.key_1_low = k[3];
+    cs->key.key_2_high = k[4];
+    cs->key.key_2_low = k[5];
+    cs->key.key_3_high = k[6];
+    cs->key.key_3_low = k[7];
+    if ((mode != CAU_MODE_AES_ECB) && (mode != CAU_MODE_DES_ECB) && (mode != CAU_MODE_TDES_ECB)) {
+        ivs.iv_0_high = caus_be32(iv);
+        ivs.iv_0_low = caus_be32(iv + 4);
+        if (cs->block == 16) {
+            ivs.iv_1_high = caus_be32(iv + 8);
+            ivs.iv_1_low = caus_be32(iv + 12);
+        }
+    }
+    cs->mode = mode;
+    cs->dir = dir;
+    cs->phase = CAUS_PHASE_NONE;
+    cs->aadlen = 0;
+    cs->datalen = 0;
+
+    // the new stream takes the CAU, its state is set up below instead of restored
+    if ((caus_owner != NULL) && (caus_owner != cs)) {
+        cau_context_save(&caus_owner->ctx, &caus_owner->key);
+    }
+    caus_owner = cs;
+    cau_disable();
+    CAU_DMAEN = 0;
+    CAU_CTL &= ~(CAU_CTL_GCM_CCMPH | CAU_CTL_NBPILB);
+    cau_aes_keysize_config(keysize);
+    cau_key_init(&cs->key);
+    if ((dir == CAU_DECRYPT) && ((mode == CAU_MODE_AES_ECB) || (mode == CAU_MODE_AES_CBC))) {
+        // decryption key schedule, prepared once here and kept for all updates
+        cau_fifo_flush();
+        cau_init(CAU_DECRYPT, CAU_MODE_AES_KEY, CAU_SWAPPING_32BIT);
+        cau_enable();
+        while (cau_flag_get(CAU_FLAG_BUSY) != RESET) {
+        }
+        cau_disable();
+    }
+    cau_init(dir, mode, CAU_SWAPPING_8BIT);
+    cau_iv_init(&ivs);
+    cau_fifo_flush();
+    if (mode == CAU_MODE_AES_GCM) {
+        caus_gcm_phase(cs, CAUS_PHASE_PREPARE, CAU_PREPARE_PHASE);
+        while (cau_enable_state_get() == ENABLE) {
+        }
+    } else {
+        cau_enable();
+    }
+    return 0;
+}
+
+int32_t caustream_aad(caustream_t *cs, const uint8_t *aad, uint32_t len)
+{
+    uint32_t full = len & ~0xFUL;
+    int32_t ret = 0;
+
+    if ((cs->mode != CAU_MODE_AES_GCM) || (cs->phase > CAUS_PHASE_AAD) || ((cs->aadlen & 0xF) != 0)) {
+        return -1;
+    }
+    if (len == 0) {
+        return 0;
+    }
+    caus_own(cs);
+    if (cs->phase == CAUS_PHASE_PREPARE) {
+        caus_gcm_phase(cs, CAUS_PHASE_AAD, CAU_AAD_PHASE);
+    }
+    if (full > 0) {
+        ret = caus_xfer(aad, NULL, full);
+    }
+    if ((ret == 0) && (len > full)) {
+        caus_last_block(cs, aad + full, NULL, len - full);
+    }
+    cs->aadlen += len;
+    return ret;
+}
+
+int32_t caustream_update(caustream_t *cs, const uint8_t *in, uint8_t *out, uint32_t len)
+{
+    if ((len % cs->block) != 0) {
+        return -1;
+    }
+    if (len == 0) {
+        return 0;
+    }
+    caus_own(cs);
+    if ((cs->mode == CAU_MODE_AES_GCM) && (cs->phase != CAUS_PHASE_PAYLOAD)) {
+        caus_gcm_phase(cs, CAUS_PHASE_PAYLOAD, CAU_ENCRYPT_DECRYPT_PHASE);
+    }
+    cs->datalen += len;
+    return caus_xfer(in, out, len);
+}
+
+int32_t caustream_finish(caustream_t *cs, const uint8_t *in, uint8_t *out, uint32_t len, uint8_t *tag)
+{
+    uint64_t aadbits, databits;
+    uint32_t val, i;
+
+    if ((len >= cs->block) ||
+        ((len > 0) && (cs->mode != CAU_MODE_AES_CTR) && (cs->mode != CAU_MODE_AES_GCM))) {
+        return -1;
+    }
+    caus_own(cs);
+    if (len > 0) {
+        if (cs->mode == CAU_MODE_AES_GCM) {
+            if (cs->phase != CAUS_PHASE_PAYLOAD) {
+                caus_gcm_phase(cs, CAUS_PHASE_PAYLOAD, CAU_ENCRYPT_DECRYPT_PHASE);
+            }
+            if (cs->dir == CAU_ENCRYPT) {
+                // padding is left out of the tag of encryption
+                CAU_CTL |= CAU_PADDING_BYTES(cs->block - len);
+            }
+        }
+        caus_last_block(cs, in, out, len);
+        cs->datalen += len;
+    }
+    if (cs->mode == CAU_MODE_AES_GCM) {
+        caus_gcm_phase(cs, CAUS_PHASE_NONE, CAU_TAG_PHASE);
+        aadbits = cs->aadlen * 8;
+        databits = cs->datalen * 8;
+        CAU_DI = __REV((uint32_t)(aadbits >> 32));
+        CAU_DI = __REV((uint32_t)aadbits);
+        CAU_DI = __REV((uint32_t)(databits >> 32));
+        CAU_DI = __REV((uint32_t)databits);
+        for (i = 0; i < 4; i++) {
+            while ((CAU_STAT0 & CAU_STAT0_ONE) == 0) {
+            }
+            val = CAU_DO;
+            if (tag != NULL) {
+                memcpy(tag + i * 4, &val, 4);
+            }
+        }
+    }
+    cau_disable();
+    CAU_DMAEN = 0;
+    caus_owner = NULL;
+    return 0;
+}
@@ -0,0 +1,83 @@
+#ifndef _CAUSTREAM_API_H_
+#define _CAUSTREAM_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "dmaq_api.h"
+
+/*
+ * Streaming AES/DES/TDES on the gd32vw55x CAU, for payloads that arrive in pieces.
+ *
+ * - Init once, update many: caustream_start() loads key and IV and, for AES ECB/CBC decryption,
+ *   runs the key preparation once, caustream_update() then continues the chaining or counter
+ *   state of the CAU, caustream_finish() takes the partial last block of CTR/GCM and the tag
+ * - Resident context: the last used stream owns the CAU, its key, IV and GCM state stay in the
+ *   CAU between calls, only a call on another stream saves the owner by cau_context_save() and
+ *   restores the caller by cau_context_restore()
+ * - DMA: data of CAUSTREAM_DMA_MIN bytes or more with 4 bytes aligned buffers goes by dmaq,
+ *   IN FIFO on in_chan and OUT FIFO on out_chan run together, so blocks are pipelined through
+ *   the core, smaller or unaligned data is fed by CPU keeping the IN FIFO full while draining
+ *   the OUT FIFO, instead of one block at a time
+ *
+ * Modes are CAU_MODE_AES_ECB/CBC/CTR/GCM, CAU_MODE_DES_ECB/CBC and CAU_MODE_TDES_ECB/CBC.
+ * The IV is 16 bytes for AES, for GCM it is the 12 bytes nonce followed by the 32-bit counter
+ * 0x00000002 as cau_aes_gcm() takes, and 8 bytes for DES/TDES. The key is 16, 24 or 32 bytes
+ * for AES, 8 for DES and 24 for TDES. Streams are used from thread context, not interrupts.
+ */
+
+/* bytes from which update uses DMA, below it the setup costs more than CPU feeding */
+#ifndef CAUSTREAM_DMA_MIN
+#define CAUSTREAM_DMA_MIN           64
+#endif
+
+/* no DMA channel, FIFOs fed by CPU */
+#define CAUSTREAM_NO_DMA            0xFFFFFFFFUL
+
+typedef struct caustream {
+    /* private */
+    cau_context_parameter_struct ctx;   /* saved CAU state while another stream owns the CAU */
+    cau_key_parameter_struct key;
+    uint32_t mode;
+    uint32_t dir;
+    uint32_t block;                 /* block size in bytes, 8 or 16 */
+    uint32_t phase;                 /* GCM phase reached */
+    uint64_t aadlen;                /* GCM bytes of additional data */
+    uint64_t datalen;               /* GCM bytes of payload */
+} caustream_t;
+
+/*
+ * Enable the CAU and set the dmaq channels, initialized by dmaq_chan_init() with the CAU IN
+ * and OUT DMA requests, or CAUSTREAM_NO_DMA for both, return 0 on success
+ */
+int32_t caustream_init(uint32_t in_chan, uint32_t out_chan);
+
+/*
+ * Start stream in mode and dir (CAU_ENCRYPT or CAU_DECRYPT) with key of keylen bytes and iv,
+ * iv is not used in ECB, return 0 on success, -1 on bad parameters
+ */
+int32_t caustream_start(caustream_t *cs, uint32_t mode, uint32_t dir, const uint8_t *key,
+                        uint32_t keylen, const uint8_t *iv);
+
+/*
+ * Add len bytes of GCM additional data, all additional data comes before the payload, len is
+ * a multiple of 16 except in the last call, return 0 on success, -1 on error
+ */
+int32_t caustream_aad(caustream_t *cs, const uint8_t *aad, uint32_t len);
+
+/* Process len bytes of in to out, len is a multiple of the block size, return 0 on success */
+int32_t caustream_update(caustream_t *cs, const uint8_t *in, uint8_t *out, uint32_t len);
+
+/*
+ * End stream, process the last len bytes of in, less than the block size and only in CTR or GCM,
+ * and for GCM write the 16 bytes tag, tag may be NULL for other modes, return 0 on success
+ */
+int32_t caustream_finish(caustream_t *cs, const uint8_t *in, uint8_t *out, uint32_t len, uint8_t *tag);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _CAUSTREAM_API_H_ */
@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# clkmgr middleware provides reference counted peripheral clock gating and clock domains
+# over the gd32vf103 and gd32vw55x RCU drivers
+MIDDLEWARE_CLKMGR := $(NUCLEI_SDK_MIDDLEWARE)/clkmgr
+
+C_SRCDIRS += $(MIDDLEWARE_CLKMGR)
+
+INCDIRS += $(MIDDLEWARE_CLKMGR)
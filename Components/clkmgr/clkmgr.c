@@ -0,0 +1,208 @@
+#include <stdint.h>
+#include <stdio.h>
+#include "nuclei_sdk_soc.h"
+#include "clkmgr_api.h"
+
+/* enable register of RCU and its bits of peripheral clocks */
+typedef struct clkmgr_reg {
+    uint32_t offset;
+    uint32_t mask;
+    const char *name;
+} clkmgr_reg_t;
+
+#if defined(GD32VW55x_H)
+static const clkmgr_reg_t clkmgr_regs[] = {
+    // SRAM0 ~ SRAM3 are left out
+    { AHB1EN_REG_OFFSET, 0x80207007UL, "AHB1" },
+    { AHB2EN_REG_OFFSET, 0x00000078UL, "AHB2" },
+    { AHB3EN_REG_OFFSET, 0x00000002UL, "AHB3" },
+    { APB1EN_REG_OFFSET, 0x10668813UL, "APB1" },
+    { APB2EN_REG_OFFSET, 0x80065111UL, "APB2" },
+};
+#else
+static const clkmgr_reg_t clkmgr_regs[] = {
+    // SRAM and FMC sleep mode clocks are left out
+    { AHBEN_REG_OFFSET, 0x00001143UL, "AHB" },
+    { APB1EN_REG_OFFSET, 0x3E7EC83FUL, "APB1" },
+    { APB2EN_REG_OFFSET, 0x00005E7DUL, "APB2" },
+};
+#endif
+
+#define CLKMGR_NREGS                (sizeof(clkmgr_regs) / sizeof(clkmgr_regs[0]))
+
+static uint8_t clkmgr_counts[CLKMGR_NREGS][32];
+static clkmgr_domain_t *clkmgr_domains;
+
+/* return index of enable register of periph, -1 if its clock is not managed */
+static int32_t clkmgr_reg_index(rcu_periph_enum periph)
+{
+    uint32_t offset = (uint32_t)periph >> 6;
+    uint32_t bit = (uint32_t)periph & 0x1F;
+    uint32_t i;
+
+    for (i = 0; i < CLKMGR_NREGS; i++) {
+        if (clkmgr_regs[i].offset == offset) {
+            return ((clkmgr_regs[i].mask & (1UL << bit)) != 0) ? (int32_t)i : -1;
+        }
+    }
+    return -1;
+}
+
+int32_t clkmgr_acquire(rcu_periph_enum periph)
+{
+    int32_t reg = clkmgr_reg_index(periph);
+    uint8_t *count;
+    rv_csr_t mstatus;
+    int32_t ret = 0;
+
+    if (reg < 0) {
+        return -1;
+    }
+    count = &clkmgr_counts[reg][(uint32_t)periph & 0x1F];
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if (*count == UINT8_MAX) {
+        ret = -1;
+    } else if ((*count)++ == 0) {
+        rcu_periph_clock_enable(periph);
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return ret;
+}
+
+void clkmgr_release(rcu_periph_enum periph)
+{
+    int32_t reg = clkmgr_reg_index(periph);
+    uint8_t *count;
+    rv_csr_t mstatus;
+
+    if (reg < 0) {
+        return;
+    }
+    count = &clkmgr_counts[reg][(uint32_t)periph & 0x1F];
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if ((*count != 0) && (--(*count) == 0)) {
+        rcu_periph_clock_disable(periph);
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
+
+uint32_t clkmgr_refs(rcu_periph_enum periph)
+{
+    int32_t reg = clkmgr_reg_index(periph);
+
+    return (reg < 0) ? 0 : clkmgr_counts[reg][(uint32_t)periph & 0x1F];
+}
+
+int32_t clkmgr_domain_register(clkmgr_domain_t *domain)
+{
+    clkmgr_domain_t *d;
+    rv_csr_t mstatus;
+
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    for (d = clkmgr_domains; d != NULL; d = d->next) {
+        if (d == domain) {
+            break;
+        }
+    }
+    if (d == NULL) {
+        domain->next = clkmgr_domains;
+        clkmgr_domains = domain;
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return 0;
+}
+
+int32_t clkmgr_domain_acquire(clkmgr_domain_t *domain)
+{
+    uint32_t i;
+    rv_csr_t mstatus;
+
+    for (i = 0; i < domain->nclocks; i++) {
+        if (clkmgr_acquire(domain->clocks[i]) != 0) {
+            // give back the clocks acquired before the failed one
+            while (i-- > 0) {
+                clkmgr_release(domain->clocks[i]);
+            }
+            return -1;
+        }
+    }
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    domain->refs++;
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return 0;
+}
+
+void clkmgr_domain_release(clkmgr_domain_t *domain)
+{
+    uint32_t i;
+    rv_csr_t mstatus;
+
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if (domain->refs == 0) {
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+        return;
+    }
+    domain->refs--;
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    for (i = 0; i < domain->nclocks; i++) {
+        clkmgr_release(domain->clocks[i]);
+    }
+}
+
+uint32_t clkmgr_gate_unused(void)
+{
+    uint32_t i, bit, en, scan, gated = 0;
+    rv_csr_t mstatus;
+
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    for (i = 0; i < CLKMGR_NREGS; i++) {
+        en = REG32(RCU + clkmgr_regs[i].offset) & clkmgr_regs[i].mask;
+        // visit the enabled clocks only
+        for (scan = en; scan != 0; scan &= scan - 1) {
+            bit = __CTZL(scan);
+            if (clkmgr_counts[i][bit] == 0) {
+                en &= ~(1UL << bit);
+                gated++;
+            }
+        }
+        // one write per register, bits not managed are kept
+        REG32(RCU + clkmgr_regs[i].offset) = (REG32(RCU + clkmgr_regs[i].offset) & ~clkmgr_regs[i].mask) | en;
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return gated;
+}
+
+uint32_t clkmgr_deepsleep_allowed(void)
+{
+    clkmgr_domain_t *d;
+
+    for (d = clkmgr_domains; d != NULL; d = d->next) {
+        if ((d->refs != 0) && ((d->flags & CLKMGR_NO_DEEPSLEEP) != 0)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void clkmgr_report(void)
+{
+    clkmgr_domain_t *d;
+    uint32_t i, bit;
+
+    printf("Clock domains:\r\n");
+    for (d = clkmgr_domains; d != NULL; d = d->next) {
+        printf("  %s: %s, refs %u%s\r\n", d->name, (d->refs != 0) ? "on" : "off", (unsigned int)d->refs,
+               ((d->flags & CLKMGR_NO_DEEPSLEEP) != 0) ? ", no deep-sleep" : "");
+    }
+    printf("Clocks:\r\n");
+    for (i = 0; i < CLKMGR_NREGS; i++) {
+        printf("  %s enabled 0x%08lx:", clkmgr_regs[i].name,
+               (unsigned long)(REG32(RCU + clkmgr_regs[i].offset) & clkmgr_regs[i].mask));
+        for (bit = 0; bit < 32; bit++) {
+            if (clkmgr_counts[i][bit] != 0) {
+                printf(" %u(%u)", (unsigned int)bit, (unsigned int)clkmgr_counts[i][bit]);
+            }
+        }
+        printf("\r\n");
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef _CLKMGR_API_H_
+#define _CLKMGR_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+
+#if !defined(__GD32VF103_H__) && !defined(GD32VW55x_H)
+#error "clkmgr middleware only supports gd32vf103 and gd32vw55x"
+#endif
+
+/*
+ * Reference counted peripheral clock gating over the gd32vf103 and gd32vw55x RCU drivers.
+ *
+ * - Clocks: clkmgr_acquire() enables the clock of a peripheral at its first reference and
+ *   clkmgr_release() disables it at its last one, so drivers sharing a clock, as DMA or
+ *   GPIO ports, don't turn it off under each other
+ * - Domains: a domain is a caller owned group of clocks used together, as a sensor on
+ *   I2C0 with its GPIO port and DMA, acquiring it acquires each of its clocks, registered
+ *   domains are listed by clkmgr_report()
+ * - Gating: clkmgr_gate_unused() turns off the peripheral clocks enabled in RCU without a
+ *   reference, as the ones enabled at init and never used again, clocks of SRAM, flash and
+ *   backup domain are never managed
+ * - Sleep: a domain with CLKMGR_NO_DEEPSLEEP, as one of a peripheral which must run during
+ *   sleep, blocks deep-sleep while it is acquired, clkmgr_deepsleep_allowed() tells the
+ *   sleep entry, as retention_suspend(), whether deep-sleep can be taken
+ *
+ * Drivers which enable their clock by rcu_periph_clock_enable() directly must have it
+ * acquired before clkmgr_gate_unused() is called. All functions can be called in interrupt.
+ */
+
+/* domain flags */
+#define CLKMGR_NO_DEEPSLEEP         0x1     /* block deep-sleep while acquired */
+
+typedef struct clkmgr_domain {
+    const char *name;
+    const rcu_periph_enum *clocks;  /* clocks of the domain */
+    uint32_t nclocks;
+    uint32_t flags;                 /* CLKMGR_* */
+    /* private */
+    struct clkmgr_domain *next;     /* registered domains */
+    uint32_t refs;
+} clkmgr_domain_t;
+
+/* Acquire clock of periph, enable it at the first reference, return 0 on success, -1 if not managed */
+int32_t clkmgr_acquire(rcu_periph_enum periph);
+
+/* Release clock of periph, disable it at the last reference */
+void clkmgr_release(rcu_periph_enum periph);
+
+/* Return references of clock of periph */
+uint32_t clkmgr_refs(rcu_periph_enum periph);
+
+/* Register domain for clkmgr_report(), return 0 on success */
+int32_t clkmgr_domain_register(clkmgr_domain_t *domain);
+
+/* Acquire clocks of domain, return 0 on success, -1 if one is not managed */
+int32_t clkmgr_domain_acquire(clkmgr_domain_t *domain);
+
+/* Release clocks of domain */
+void clkmgr_domain_release(clkmgr_domain_t *domain);
+
+/* Disable enabled clocks without reference, return number of clocks disabled */
+uint32_t clkmgr_gate_unused(void);
+
+/* Return 1 if no acquired domain blocks deep-sleep */
+uint32_t clkmgr_deepsleep_allowed(void);
+
+/* Print acquired domains and referenced clocks */
+void clkmgr_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _CLKMGR_API_H_ */
@@ -0,0 +1,12 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# crcsvc middleware provides a CRC32 checksum service over the gd32vf103/gd32vw55x CRC unit,
+# or clmul/table software on other SoCs, CRCSVC_DMA=1 feeds the CRC unit by dmaq, add dmaq to MIDDLEWARE too
+MIDDLEWARE_CRCSVC := $(NUCLEI_SDK_MIDDLEWARE)/crcsvc
+
+C_SRCDIRS += $(MIDDLEWARE_CRCSVC)
+
+INCDIRS += $(MIDDLEWARE_CRCSVC)
+
+ifeq ($(CRCSVC_DMA),1)
+COMMON_FLAGS += -DNUCLEI_CRCSVC_DMA=1
+endif
@@ -0,0 +1,236 @@
+#include <stdint.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "crcsvc_api.h"
+
+#if defined(__GD32VF103_H__) || defined(GD32VW55x_H)
+#define CRCS_HW                     1
+#if defined(NUCLEI_CRCSVC_DMA) && (NUCLEI_CRCSVC_DMA == 1)
+#include "dmaq_api.h"
+#define CRCS_DMA                    1
+#endif
+#endif
+
+/* carry-less multiply instructions of Zbc or Zbkc replace the table */
+#if defined(__riscv_zbc) || defined(__riscv_zbkc)
+#define CRCS_CLMUL                  1
+#endif
+
+#define CRCS_POLY                   0x04C11DB7UL
+#define CRCS_INIT                   0xFFFFFFFFUL
+/* low 32 bits of x^64 / (x^32 + CRCS_POLY), Barrett constant */
+#define CRCS_MU                     0x04D101DFUL
+
+/* words of one DMA transfer */
+#define CRCS_DMA_WORDS              0xFFFF
+
+#if defined(CRCS_DMA)
+static uint32_t crcs_chan = CRCSVC_NO_DMA;
+#endif
+#if !defined(CRCS_HW) && !defined(CRCS_CLMUL)
+static uint32_t crcs_table[256];
+#endif
+
+/* CRC of one byte, used for the last bytes of data */
+static uint32_t crcs_byte(uint32_t crc, uint8_t b)
+{
+    uint32_t i;
+
+    crc ^= (uint32_t)b << 24;
+    for (i = 0; i < 8; i++) {
+        crc = (crc & 0x80000000UL) ? ((crc << 1) ^ CRCS_POLY) : (crc << 1);
+    }
+    return crc;
+}
+
+static inline uint32_t crcs_load32(const uint8_t *p)
+{
+    uint32_t w;
+
+    memcpy(&w, p, 4);
+    return w;
+}
+
+#if defined(CRCS_HW)
+/* value that the CRC unit must be at for ctx, CRC_DATA is read only */
+static uint32_t crcs_unshift(uint32_t crc)
+{
+    uint32_t i;
+
+    // undo 32 steps, the lowest bit is set only when the highest bit was shifted out
+    for (i = 0; i < 32; i++) {
+        crc = (crc & 1) ? (((crc ^ CRCS_POLY) >> 1) | 0x80000000UL) : (crc >> 1);
+    }
+    return crc;
+}
+
+static void crcs_hw_load(uint32_t crc)
+{
+    if (CRC_DATA == crc) {
+        return;
+    }
+    CRC_CTL |= CRC_CTL_RST;
+    if (crc != CRCS_INIT) {
+        CRC_DATA = CRCS_INIT ^ crcs_unshift(crc);
+    }
+}
+
+#if defined(CRCS_DMA)
+/* write words of aligned p to CRC_DATA by memory to memory DMA, return bytes done */
+static uint32_t crcs_dma(const uint8_t *p, uint32_t len)
+{
+    dmaq_req_t req;
+    uint32_t done = 0;
+    uint32_t words;
+
+    while (len - done >= 4) {
+        words = (len - done) / 4;
+        if (words > CRCS_DMA_WORDS) {
+            words = CRCS_DMA_WORDS;
+        }
+        req.periph_addr = (uint32_t)(unsigned long)(p + done);
+        req.mem = (void *)&CRC_DATA;
+        req.count = words;
+        req.dir = DMAQ_DIR_M2M;
+        req.width = 4;
+        req.periph_inc = 1;
+        req.mem_inc = 0;
+        req.cb = NULL;
+        req.arg = NULL;
+        if ((dmaq_submit(crcs_chan, &req) != 0) || (dmaq_wait(&req) != DMAQ_DONE)) {
+            break;
+        }
+        done += words * 4;
+    }
+    return done;
+}
+#endif
+
+/* CRC of whole words of p, len is a multiple of 4 */
+static uint32_t crcs_words(uint32_t crc, const uint8_t *p, uint32_t len)
+{
+    uint32_t done = 0;
+
+    crcs_hw_load(crc);
+#if defined(CRCS_DMA)
+    if ((crcs_chan != CRCSVC_NO_DMA) && (len >= CRCSVC_DMA_MIN) && (((unsigned long)p & 3) == 0)) {
+        done = crcs_dma(p, len);
+    }
+#endif
+    for (; done < len; done += 4) {
+        CRC_DATA = crcs_load32(p + done);
+    }
+    return CRC_DATA;
+}
+#else
+/* CRC of one word */
+static inline uint32_t crcs_word(uint32_t crc, uint32_t w)
+{
+#if defined(CRCS_CLMUL)
+    unsigned long t = crc ^ w;
+    unsigned long q;
+
+    // q = t * x^32 / P by Barrett reduction, the remainder is the low half of q * P
+#if __RISCV_XLEN == 32
+    q = __CLMULHL(t, CRCS_MU);
+#else
+    q = __CLMULL(t, CRCS_MU) >> 32;
+#endif
+    q ^= t;
+    return (uint32_t)__CLMULL(q, CRCS_POLY);
+#else
+    crc ^= w;
+    crc = (crc << 8) ^ crcs_table[crc >> 24];
+    crc = (crc << 8) ^ crcs_table[crc >> 24];
+    crc = (crc << 8) ^ crcs_table[crc >> 24];
+    crc = (crc << 8) ^ crcs_table[crc >> 24];
+    return crc;
+#endif
+}
+
+static uint32_t crcs_words(uint32_t crc, const uint8_t *p, uint32_t len)
+{
+    uint32_t done;
+
+    for (done = 0; done < len; done += 4) {
+        crc = crcs_word(crc, crcs_load32(p + done));
+    }
+    return crc;
+}
+#endif
+
+void crcsvc_init(uint32_t dma_chan)
+{
+#if defined(CRCS_HW)
+    rcu_periph_clock_enable(RCU_CRC);
+    CRC_CTL |= CRC_CTL_RST;
+#if defined(CRCS_DMA)
+    crcs_chan = dma_chan;
+#else
+    (void)dma_chan;
+#endif
+#elif !defined(CRCS_CLMUL)
+    uint32_t i, j, crc;
+
+    (void)dma_chan;
+    for (i = 0; i < 256; i++) {
+        crc = i << 24;
+        for (j = 0; j < 8; j++) {
+            crc = (crc & 0x80000000UL) ? ((crc << 1) ^ CRCS_POLY) : (crc << 1);
+        }
+        crcs_table[i] = crc;
+    }
+#endif
+}
+
+void crcsvc_start(crcsvc_t *ctx)
+{
+    ctx->crc = CRCS_INIT;
+    ctx->npend = 0;
+}
+
+void crcsvc_update(crcsvc_t *ctx, const void *data, uint32_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t n;
+
+    if (ctx->npend > 0) {
+        // complete the word split by the previous update
+        while ((ctx->npend < 4) && (len > 0)) {
+            ctx->pend[ctx->npend++] = *p++;
+            len--;
+        }
+        if (ctx->npend < 4) {
+            return;
+        }
+        ctx->crc = crcs_words(ctx->crc, ctx->pend, 4);
+        ctx->npend = 0;
+    }
+    n = len & ~3UL;
+    if (n > 0) {
+        ctx->crc = crcs_words(ctx->crc, p, n);
+    }
+    for (; n < len; n++) {
+        ctx->pend[ctx->npend++] = p[n];
+    }
+}
+
+uint32_t crcsvc_finish(crcsvc_t *ctx)
+{
+    uint32_t crc = ctx->crc;
+    uint32_t i;
+
+    for (i = 0; i < ctx->npend; i++) {
+        crc = crcs_byte(crc, ctx->pend[i]);
+    }
+    return crc;
+}
+
+uint32_t crcsvc_calc(const void *data, uint32_t len)
+{
+    crcsvc_t ctx;
+
+    crcsvc_start(&ctx);
+    crcsvc_update(&ctx, data, len);
+    return crcsvc_finish(&ctx);
+}
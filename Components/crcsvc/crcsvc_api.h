@@ -0,0 +1,65 @@
+#ifndef _CRCSVC_API_H_
+#define _CRCSVC_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*
+ * CRC32 checksum service, one API for flash integrity checks and protocol stacks.
+ *
+ * The CRC is the one of the GD32 CRC unit: polynomial 0x04C11DB7, initial value 0xFFFFFFFF,
+ * no reflection and no final xor, data is taken as 32-bit little endian words counted from
+ * the start of data, trailing 1 ~ 3 bytes are taken one byte at a time, so 4 bytes aligned
+ * data of whole words gives the same value as crc_block_data_calculate().
+ *
+ * - gd32vf103/gd32vw55x: words go to the CRC unit, with NUCLEI_CRCSVC_DMA=1 (CRCSVC_DMA=1 in
+ *   make, dmaq in MIDDLEWARE) aligned runs of CRCSVC_DMA_MIN bytes or more are written to
+ *   CRC_DATA by memory to memory DMA, a context switch loads the CRC of the other context by
+ *   writing the word that takes the reset value to it, since CRC_DATA is not writable
+ * - other SoCs: software, with Zbc or Zbkc one word takes a clmul Barrett reduction, else a 1KB table
+ *   built by crcsvc_init() is used
+ *
+ * Bytes of a word split over updates are kept in the context, so data can be fed in any
+ * pieces. The CRC unit is shared, contexts are used from thread context, not interrupts.
+ */
+
+/* bytes from which update uses DMA */
+#ifndef CRCSVC_DMA_MIN
+#define CRCSVC_DMA_MIN              256
+#endif
+
+/* no DMA channel */
+#define CRCSVC_NO_DMA               0xFFFFFFFFUL
+
+typedef struct crcsvc {
+    /* private */
+    uint32_t crc;
+    uint32_t npend;                 /* bytes in pend */
+    uint8_t pend[4];
+} crcsvc_t;
+
+/*
+ * Set up CRC calculation, dma_chan is a dmaq channel initialized by dmaq_chan_init() used
+ * for memory to memory transfers, or CRCSVC_NO_DMA, it is not used without NUCLEI_CRCSVC_DMA
+ */
+void crcsvc_init(uint32_t dma_chan);
+
+/* Start context */
+void crcsvc_start(crcsvc_t *ctx);
+
+/* Add len bytes of data to context */
+void crcsvc_update(crcsvc_t *ctx, const void *data, uint32_t len);
+
+/* Return CRC of all data of context, the context can be updated again after it */
+uint32_t crcsvc_finish(crcsvc_t *ctx);
+
+/* Return CRC of len bytes of data */
+uint32_t crcsvc_calc(const void *data, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _CRCSVC_API_H_ */
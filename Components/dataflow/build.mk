@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# dataflow middleware connects DMA sources, NMSIS DSP stages and sinks by zero-copy block FIFOs,
+# stages are fired bare-metal on harts or in RTOS tasks, with cycles of each stage in nmsis_bench.h slots
+MIDDLEWARE_DATAFLOW := $(NUCLEI_SDK_MIDDLEWARE)/dataflow
+
+C_SRCDIRS += $(MIDDLEWARE_DATAFLOW)
+
+INCDIRS += $(MIDDLEWARE_DATAFLOW)
@@ -0,0 +1,210 @@
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "dataflow_api.h"
+
+static inline uint8_t *df_fifo_block(const df_fifo_t *fifo, uint32_t idx)
+{
+    return fifo->mem + (idx & (fifo->nblk - 1)) * fifo->blksize;
+}
+
+static inline void df_notify(df_fifo_t *fifo, df_stage_t *stage)
+{
+    df_graph_t *graph = fifo->graph;
+
+    if ((graph != NULL) && (graph->notify != NULL) && (stage != NULL)) {
+        graph->notify(graph, stage);
+    }
+}
+
+void *df_fifo_acquire_at(df_fifo_t *fifo, uint32_t n)
+{
+    uint32_t head = fifo->head;
+
+    if (head - fifo->tail + n >= fifo->nblk) {
+        return NULL;
+    }
+    // the block is released by consumer before tail is seen
+    __SMP_RWMB();
+    return df_fifo_block(fifo, head + n);
+}
+
+void *df_fifo_acquire(df_fifo_t *fifo)
+{
+    return df_fifo_acquire_at(fifo, 0);
+}
+
+void df_fifo_commit(df_fifo_t *fifo)
+{
+    // make the block written visible before it is committed
+    __SMP_RWMB();
+    fifo->head = fifo->head + 1;
+    df_notify(fifo, fifo->consumer);
+}
+
+void *df_fifo_peek_at(df_fifo_t *fifo, uint32_t n)
+{
+    uint32_t tail = fifo->tail;
+
+    if (fifo->head - tail <= n) {
+        return NULL;
+    }
+    // read the block after head is seen
+    __SMP_RWMB();
+    return df_fifo_block(fifo, tail + n);
+}
+
+void *df_fifo_peek(df_fifo_t *fifo)
+{
+    return df_fifo_peek_at(fifo, 0);
+}
+
+void df_fifo_release(df_fifo_t *fifo)
+{
+    // finish reading the block before producer can write it
+    __SMP_RWMB();
+    fifo->tail = fifo->tail + 1;
+    df_notify(fifo, fifo->producer);
+}
+
+static int32_t df_graph_connect(df_fifo_t *fifo, df_stage_t **end, df_stage_t *stage, df_graph_t *graph)
+{
+    if ((fifo->mem == NULL) || (fifo->blksize == 0) || (fifo->nblk == 0) ||
+        ((fifo->nblk & (fifo->nblk - 1)) != 0) || (*end != NULL)) {
+        return -1;
+    }
+    *end = stage;
+    fifo->graph = graph;
+    fifo->head = 0;
+    fifo->tail = 0;
+    return 0;
+}
+
+int32_t df_graph_init(df_graph_t *graph)
+{
+    df_stage_t *stage;
+    uint32_t i, j;
+
+    graph->stopped = 0;
+    graph->slots = NULL;
+    // ends are cleared first, so an end set by an earlier stage tells a FIFO shared by two stages
+    for (i = 0; i < graph->nstages; i++) {
+        stage = graph->stages[i];
+        if ((stage->fire == NULL) || (stage->nin > DF_MAX_PORTS) || (stage->nout > DF_MAX_PORTS)) {
+            return -1;
+        }
+        for (j = 0; j < stage->nin; j++) {
+            if (stage->in[j] == NULL) {
+                return -1;
+            }
+            stage->in[j]->consumer = NULL;
+        }
+        for (j = 0; j < stage->nout; j++) {
+            if (stage->out[j] == NULL) {
+                return -1;
+            }
+            stage->out[j]->producer = NULL;
+        }
+    }
+    for (i = 0; i < graph->nstages; i++) {
+        stage = graph->stages[i];
+        for (j = 0; j < stage->nin; j++) {
+            if (df_graph_connect(stage->in[j], &stage->in[j]->consumer, stage, graph) != 0) {
+                return -1;
+            }
+        }
+        for (j = 0; j < stage->nout; j++) {
+            if (df_graph_connect(stage->out[j], &stage->out[j]->producer, stage, graph) != 0) {
+                return -1;
+            }
+        }
+        // registered here, not at first fire, as stages of different harts would race on it
+        stage->slot.name = stage->name;
+        stage->slot.registered = 0;
+        __bench_slot_reset(&stage->slot);
+        __bench_slot_register(&graph->slots, &stage->slot);
+    }
+    graph->ovhcyc = __bench_slot_calibrate();
+    return 0;
+}
+
+int32_t df_stage_fire(df_graph_t *graph, df_stage_t *stage)
+{
+    void *in[DF_MAX_PORTS];
+    void *out[DF_MAX_PORTS];
+    uint32_t i;
+
+    for (i = 0; i < stage->nin; i++) {
+        if ((in[i] = df_fifo_peek(stage->in[i])) == NULL) {
+            return 0;
+        }
+    }
+    for (i = 0; i < stage->nout; i++) {
+        if ((out[i] = df_fifo_acquire(stage->out[i])) == NULL) {
+            return 0;
+        }
+    }
+    __bench_slot_start(NULL, &stage->slot);
+    stage->fire(stage, in, out);
+    __bench_slot_sample(&stage->slot, graph->ovhcyc);
+    for (i = 0; i < stage->nout; i++) {
+        df_fifo_commit(stage->out[i]);
+    }
+    for (i = 0; i < stage->nin; i++) {
+        df_fifo_release(stage->in[i]);
+    }
+    return 1;
+}
+
+void df_graph_run(df_graph_t *graph, uint32_t runner)
+{
+    df_stage_t *stage;
+    uint32_t i, fired;
+
+    while (graph->stopped == 0) {
+        fired = 0;
+        // one fire of each stage per pass, so a block goes down the stages in one pass
+        for (i = 0; i < graph->nstages; i++) {
+            stage = graph->stages[i];
+            if (stage->runner == runner) {
+                fired += df_stage_fire(graph, stage);
+            }
+        }
+        if ((fired == 0) && (graph->wait != NULL) && (graph->stopped == 0)) {
+            graph->wait(graph, runner, NULL);
+        }
+    }
+}
+
+void df_stage_run(df_graph_t *graph, df_stage_t *stage)
+{
+    while (graph->stopped == 0) {
+        if ((df_stage_fire(graph, stage) == 0) && (graph->wait != NULL) && (graph->stopped == 0)) {
+            graph->wait(graph, stage->runner, stage);
+        }
+    }
+}
+
+void df_graph_stop(df_graph_t *graph)
+{
+    uint32_t i;
+
+    graph->stopped = 1;
+    __SMP_RWMB();
+    if (graph->notify != NULL) {
+        for (i = 0; i < graph->nstages; i++) {
+            graph->notify(graph, graph->stages[i]);
+        }
+    }
+}
+
+void df_graph_dump(df_graph_t *graph, uint32_t reset)
+{
+    uint32_t i;
+
+    __bench_slot_dump(graph->slots);
+    if (reset != 0) {
+        for (i = 0; i < graph->nstages; i++) {
+            __bench_slot_reset(&graph->stages[i]->slot);
+        }
+    }
+}
@@ -0,0 +1,158 @@
+#ifndef _DATAFLOW_API_H_
+#define _DATAFLOW_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "nmsis_bench.h"
+
+/*
+ * Synchronous dataflow of signal processing stages.
+ *
+ * - FIFO: a ring of nblk blocks of blksize bytes, statically sized by DF_FIFO_DEFINE(), with
+ *   one producer and one consumer, which can be stages on different harts, or an interrupt.
+ *   The producer writes into the block got by df_fifo_acquire() and passes it by
+ *   df_fifo_commit(), the consumer reads the block got by df_fifo_peek() and gives it back
+ *   by df_fifo_release(), so blocks are never copied.
+ * - Stage: fire() is called with one block of each input FIFO and one free block of each
+ *   output FIFO once all of them are there, the blocks are committed and released when it
+ *   returns, so the rates of a stage are fixed by the block sizes of its FIFOs, as a
+ *   decimating FIR reading blocks of 256 samples and writing blocks of 64 samples.
+ * - Source and sink: a FIFO without producer stage is filled outside the graph, as by the
+ *   DMA callback of an ADC committing the block just filled and queuing a request on the
+ *   block got by df_fifo_acquire_at(), a FIFO without consumer stage is drained in the same
+ *   way by output DMA with df_fifo_peek_at().
+ * - Runner: each stage belongs to one runner, df_graph_run() fires the ready stages of a
+ *   runner in graph order until df_graph_stop(), a runner is a hart in bare-metal, with the
+ *   graph shared by all harts, or a RTOS task, df_stage_run() runs one stage in its own task.
+ *   wait is called when nothing of a runner is ready, notify when a block is committed or
+ *   released with the stage which may be ready now, so a RTOS task can block on a semaphore
+ *   or notification instead of polling, notify is also called in the interrupt of sources.
+ * - Cycles: each fire is measured in the benchmark slot of its stage, with the overhead of
+ *   nmsis_bench.h removed, df_graph_dump() prints the slots as BENCH_SLOT_DUMP does.
+ *
+ * Stages get blocks in calling order of their FIFOs, blocks are DF_BLOCK_ALIGN aligned.
+ */
+
+/* max input or output FIFOs of one stage */
+#ifndef DF_MAX_PORTS
+#define DF_MAX_PORTS                4
+#endif
+
+/* alignment of FIFO memory, so blocks of aligned size are aligned too */
+#ifndef DF_BLOCK_ALIGN
+#define DF_BLOCK_ALIGN              8
+#endif
+
+/* Runner of a stage not run by df_graph_run() */
+#define DF_RUNNER_NONE              0xFF
+
+struct df_graph;
+struct df_stage;
+
+typedef struct df_fifo {
+    uint8_t *mem;                   /* nblk * blksize bytes */
+    uint32_t blksize;               /* bytes of one block */
+    uint32_t nblk;                  /* blocks of ring, power of 2 */
+    /* private */
+    volatile uint32_t head;         /* blocks committed */
+    volatile uint32_t tail;         /* blocks released */
+    struct df_stage *producer;      /* NULL for source */
+    struct df_stage *consumer;      /* NULL for sink */
+    struct df_graph *graph;
+} df_fifo_t;
+
+/* Define static FIFO name of nblk blocks of blksize bytes */
+#define DF_FIFO_DEFINE(name, nblk, blksize) \
+    static uint8_t name##_mem[(nblk) * (blksize)] __attribute__((aligned(DF_BLOCK_ALIGN))); \
+    static df_fifo_t name = { name##_mem, (blksize), (nblk), 0, 0, NULL, NULL, NULL }
+
+/* process in one block of each input to one block of each output, called by runner */
+typedef void (*df_fire_t)(struct df_stage *stage, void *const *in, void *const *out);
+
+typedef struct df_stage {
+    const char *name;               /* name of benchmark slot */
+    df_fire_t fire;
+    void *arg;                      /* free for fire */
+    df_fifo_t *in[DF_MAX_PORTS];    /* input FIFOs */
+    df_fifo_t *out[DF_MAX_PORTS];   /* output FIFOs */
+    uint8_t nin;                    /* inputs, 0 ~ DF_MAX_PORTS */
+    uint8_t nout;                   /* outputs, 0 ~ DF_MAX_PORTS */
+    uint8_t runner;                 /* runner index of df_graph_run(), or DF_RUNNER_NONE */
+    void *task;                     /* free for wait and notify, as RTOS task of the stage */
+    /* private */
+    NMSIS_BENCH_SLOT_Type slot;     /* cycles of fire */
+} df_stage_t;
+
+/* called when nothing of runner is ready, or when stage of df_stage_run() is not ready */
+typedef void (*df_wait_t)(struct df_graph *graph, uint32_t runner, df_stage_t *stage);
+/* called when stage may be ready, in the context of committing or releasing a block */
+typedef void (*df_notify_t)(struct df_graph *graph, df_stage_t *stage);
+
+typedef struct df_graph {
+    df_stage_t **stages;            /* stages in topological order */
+    uint32_t nstages;
+    df_wait_t wait;                 /* NULL to poll */
+    df_notify_t notify;             /* can be NULL */
+    void *arg;                      /* free for wait and notify */
+    /* private */
+    volatile uint32_t stopped;
+    uint64_t ovhcyc;                /* overhead of benchmark slot */
+    NMSIS_BENCH_SLOT_Type *slots;   /* registry of benchmark slots */
+} df_graph_t;
+
+/*
+ * Connect FIFOs of stages and reset them, return 0 on success, -1 if a FIFO is not a power
+ * of 2 blocks, has more than one producer or consumer, or a stage has too many ports
+ */
+int32_t df_graph_init(df_graph_t *graph);
+
+/* Fire the ready stages of runner in graph order until df_graph_stop() */
+void df_graph_run(df_graph_t *graph, uint32_t runner);
+
+/* Fire stage whenever it is ready until df_graph_stop(), as the body of its RTOS task */
+void df_stage_run(df_graph_t *graph, df_stage_t *stage);
+
+/* Make df_graph_run() and df_stage_run() return, notify is called for each stage */
+void df_graph_stop(df_graph_t *graph);
+
+/* Fire stage once if ready, return 1 if fired, 0 if not ready */
+int32_t df_stage_fire(df_graph_t *graph, df_stage_t *stage);
+
+/* Print cycles of fire of all stages, and reset them if reset is 1 */
+void df_graph_dump(df_graph_t *graph, uint32_t reset);
+
+/* Return the free block to write, NULL if FIFO is full */
+void *df_fifo_acquire(df_fifo_t *fifo);
+
+/*
+ * Return the n-th free block after the one of df_fifo_acquire(), NULL if there is not, so
+ * a DMA source can queue its requests on the next blocks before the current one is committed
+ */
+void *df_fifo_acquire_at(df_fifo_t *fifo, uint32_t n);
+
+/* Pass the block got by df_fifo_acquire() to consumer */
+void df_fifo_commit(df_fifo_t *fifo);
+
+/* Return the oldest committed block to read, NULL if FIFO is empty */
+void *df_fifo_peek(df_fifo_t *fifo);
+
+/* Return the n-th committed block after the one of df_fifo_peek(), NULL if there is not */
+void *df_fifo_peek_at(df_fifo_t *fifo, uint32_t n);
+
+/* Give back the block got by df_fifo_peek() to producer */
+void df_fifo_release(df_fifo_t *fifo);
+
+/* Return committed blocks not released */
+__STATIC_FORCEINLINE uint32_t df_fifo_count(const df_fifo_t *fifo)
+{
+    return fifo->head - fifo->tail;
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _DATAFLOW_API_H_ */
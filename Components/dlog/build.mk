@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# dlog middleware records log calls into per-hart ring buffers and formats them later,
+# define NUCLEI_DLOG=1 to route NSDK_DEBUG into it and let RTOS ports flush it in idle
+MIDDLEWARE_DLOG := $(NUCLEI_SDK_MIDDLEWARE)/dlog
+
+C_SRCDIRS += $(MIDDLEWARE_DLOG)
+
+INCDIRS += $(MIDDLEWARE_DLOG)
@@ -0,0 +1,290 @@
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "dlog_api.h"
+#if defined(NUCLEI_RTT) && (NUCLEI_RTT == 1)
+#include "rtt_api.h"
+#endif
+
+#if DLOG_MAX_ARGS != 20
+#error "dlog_flush_ring passes 20 arguments to snprintf"
+#endif
+
+#if (DLOG_RING_SIZE & (DLOG_RING_SIZE - 1)) != 0
+#error "DLOG_RING_SIZE must be power of 2"
+#endif
+
+/*
+ * dlog.out layout, all fields are in cpu native little-endian
+ * - header: struct dloghdr
+ * - DLOG_HART_NUM rings: struct dlogring, records between tail and head are valid
+ *
+ * Each record is 2 + nargs words of unsigned long in ring, a record may wrap around ring end
+ * - word 0: format string address, written last, so a record is complete when it is not 0
+ * - word 1: (low bits of cycle counter << 8) | nargs
+ * - word 2 ~ 2 + nargs - 1: arguments
+ * Consumer clears the words of each record before moving tail, so the words after tail are 0
+ * until producers write them.
+ */
+struct dloghdr {
+    char magic[4];      /* "NDLG" */
+    uint16_t version;   /* version number */
+    uint16_t xlenbytes; /* size of ring word in bytes */
+    uint32_t harts;     /* ring count */
+    uint32_t size;      /* word count of each ring */
+    uint32_t freq;      /* cpu frequency in Hz */
+    uint32_t reserved;
+};
+
+struct dlogring {
+    uint32_t hartid;                /* hart id of this ring */
+    volatile uint32_t head;         /* words reserved by producers */
+    volatile uint32_t tail;         /* words consumed */
+    uint32_t dropped;               /* records dropped as ring full */
+    uint32_t records;               /* records stored */
+    uint32_t reserved;
+    volatile unsigned long words[DLOG_RING_SIZE];
+};
+
+#define DLOGVERSION         1
+
+/* dlog data structure */
+struct dlogdata {
+    char *buf;
+    uint32_t size;
+};
+
+/* Where the dlog data stored after execute dlog_collect(0) */
+struct dlogdata dlog_data = {NULL, 0};
+
+static struct {
+    struct dloghdr hdr;
+    struct dlogring rings[DLOG_HART_NUM];
+} dlog_buf;
+
+static volatile uint32_t dlog_flushing = 0;
+
+#define DLOG_WORD(ring, idx)    ((ring)->words[(idx) & (DLOG_RING_SIZE - 1)])
+
+#if defined(__riscv_atomic)
+/* Reserve cnt words of ring, return 0 if ring is full, atomic to interrupts and other harts */
+static inline int dlog_reserve(struct dlogring *ring, uint32_t cnt, uint32_t *pos)
+{
+    uint32_t head = ring->head;
+
+    do {
+        if ((head - ring->tail) > (DLOG_RING_SIZE - cnt)) {
+            return 0;
+        }
+    } while (__atomic_compare_exchange_n(&ring->head, &head, head + cnt, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED) == 0);
+    *pos = head;
+    return 1;
+}
+
+#define DLOG_LOCK()
+#define DLOG_UNLOCK()
+#define DLOG_COMMIT(ring, pos, fmt)     __atomic_store_n(&DLOG_WORD(ring, pos), (unsigned long)(fmt), __ATOMIC_RELEASE)
+#define DLOG_STAT_INC(ring, member)     __atomic_fetch_add(&(ring)->member, 1, __ATOMIC_RELAXED)
+#else
+/* no amo instruction, the whole record is written with interrupts disabled */
+static inline int dlog_reserve(struct dlogring *ring, uint32_t cnt, uint32_t *pos)
+{
+    uint32_t head = ring->head;
+
+    if ((head - ring->tail) > (DLOG_RING_SIZE - cnt)) {
+        return 0;
+    }
+    ring->head = head + cnt;
+    *pos = head;
+    return 1;
+}
+
+#define DLOG_LOCK()                     rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE)
+#define DLOG_UNLOCK()                   __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE)
+#define DLOG_COMMIT(ring, pos, fmt)     DLOG_WORD(ring, pos) = (unsigned long)(fmt)
+#define DLOG_STAT_INC(ring, member)     ((ring)->member++)
+#endif
+
+void dlog_record(const char *fmt, unsigned long nargs, ...)
+{
+    unsigned long hartidx = __get_hart_index();
+    struct dlogring *ring;
+    uint32_t pos, i;
+    va_list ap;
+
+    if ((hartidx >= DLOG_HART_NUM) || (fmt == NULL) || (nargs > DLOG_MAX_ARGS)) {
+        return;
+    }
+    ring = &dlog_buf.rings[hartidx];
+    DLOG_LOCK();
+    if (dlog_reserve(ring, nargs + 2, &pos) == 0) {
+        DLOG_STAT_INC(ring, dropped);
+    } else {
+        va_start(ap, nargs);
+        for (i = 0; i < nargs; i++) {
+            DLOG_WORD(ring, pos + 2 + i) = va_arg(ap, unsigned long);
+        }
+        va_end(ap);
+        DLOG_WORD(ring, pos + 1) = ((unsigned long)__RV_CSR_READ(CSR_MCYCLE) << 8) | nargs;
+        DLOG_COMMIT(ring, pos, fmt);
+        DLOG_STAT_INC(ring, records);
+    }
+    DLOG_UNLOCK();
+}
+
+__WEAK void dlog_port_output(const char *str, size_t len)
+{
+#if defined(NUCLEI_RTT_STDOUT) && (NUCLEI_RTT_STDOUT == 1)
+    // putchar of SoC writes uart directly, follow printf to rtt terminal channel
+    rtt_write(RTT_CHAN_TERMINAL, str, len);
+#else
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        putchar(str[i]);
+    }
+#endif
+}
+
+/* Format and emit the complete records at tail of ring, and release their words */
+static uint32_t dlog_flush_ring(struct dlogring *ring)
+{
+    static char line[DLOG_LINE_SIZE];
+    unsigned long args[DLOG_MAX_ARGS] = {0};
+    const char *fmt;
+    uint32_t tail = ring->tail;
+    uint32_t nargs, i, cnt = 0;
+    int len;
+
+#if defined(__riscv_atomic)
+    while ((fmt = (const char *)__atomic_load_n(&DLOG_WORD(ring, tail), __ATOMIC_ACQUIRE)) != NULL) {
+#else
+    while ((fmt = (const char *)DLOG_WORD(ring, tail)) != NULL) {
+#endif
+        nargs = DLOG_WORD(ring, tail + 1) & 0xFF;
+        for (i = 0; i < nargs; i++) {
+            args[i] = DLOG_WORD(ring, tail + 2 + i);
+        }
+        for (i = 0; i < nargs + 2; i++) {
+            DLOG_WORD(ring, tail + i) = 0;
+        }
+        tail += nargs + 2;
+        __RWMB();
+        ring->tail = tail;
+        // each argument takes one register or stack slot as unsigned long, extra ones are ignored
+        len = snprintf(line, sizeof(line), fmt, args[0], args[1], args[2], args[3], args[4], args[5],
+                       args[6], args[7], args[8], args[9], args[10], args[11], args[12], args[13],
+                       args[14], args[15], args[16], args[17], args[18], args[19]);
+        if (len > 0) {
+            dlog_port_output(line, ((size_t)len < sizeof(line)) ? (size_t)len : sizeof(line) - 1);
+        }
+        cnt++;
+    }
+    return cnt;
+}
+
+uint32_t dlog_flush(void)
+{
+    uint32_t i, cnt = 0;
+
+    // only one consumer at a time, other callers just return
+#if defined(__riscv_atomic)
+    if (__atomic_exchange_n(&dlog_flushing, 1, __ATOMIC_ACQUIRE) != 0) {
+        return 0;
+    }
+#else
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if (dlog_flushing != 0) {
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+        return 0;
+    }
+    dlog_flushing = 1;
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+#endif
+    for (i = 0; i < DLOG_HART_NUM; i++) {
+        cnt += dlog_flush_ring(&dlog_buf.rings[i]);
+    }
+    __RWMB();
+    dlog_flushing = 0;
+    return cnt;
+}
+
+void dlog_get_stat(unsigned long hartidx, dlog_stat_t *stat)
+{
+    if (hartidx < DLOG_HART_NUM) {
+        stat->records = dlog_buf.rings[hartidx].records;
+        stat->dropped = dlog_buf.rings[hartidx].dropped;
+    }
+}
+
+#define NUM_OCTETS_PER_LINE 20
+#define FLUSH_OUTPUT()      fflush(stdout)
+static void hexdumpbuf(char *buf, unsigned long sz)
+{
+    unsigned long rem, cur = 0, i = 0;
+
+    FLUSH_OUTPUT();
+
+    while (cur < sz) {
+        rem = ((sz - cur) < NUM_OCTETS_PER_LINE) ? (sz - cur) : NUM_OCTETS_PER_LINE;
+        for (i = 0; i < rem; i++) {
+            printf("%02x", (uint8_t)buf[cur + i]);
+        }
+        printf("\n");
+        FLUSH_OUTPUT();
+        cur += rem;
+    }
+}
+
+long dlog_collect(unsigned long interface)
+{
+    static const char dlog_out[] = "dlog.out";
+    uint32_t i;
+    int fd;
+
+    dlog_buf.hdr.magic[0] = 'N';
+    dlog_buf.hdr.magic[1] = 'D';
+    dlog_buf.hdr.magic[2] = 'L';
+    dlog_buf.hdr.magic[3] = 'G';
+    dlog_buf.hdr.version = DLOGVERSION;
+    dlog_buf.hdr.xlenbytes = sizeof(unsigned long);
+    dlog_buf.hdr.harts = DLOG_HART_NUM;
+    dlog_buf.hdr.size = DLOG_RING_SIZE;
+    dlog_buf.hdr.freq = SystemCoreClock;
+    for (i = 0; i < DLOG_HART_NUM; i++) {
+#ifdef __HARTID_OFFSET
+        dlog_buf.rings[i].hartid = i + __HARTID_OFFSET;
+#else
+        dlog_buf.rings[i].hartid = i;
+#endif
+    }
+    if (interface == 0) {
+        dlog_data.buf = (char *)&dlog_buf;
+        dlog_data.size = sizeof(dlog_buf);
+        printf("Collected dlog data @0x%lx, size %lu bytes\n", (unsigned long)dlog_data.buf, (unsigned long)dlog_data.size);
+    } else if (interface == 1) {
+        fd = open(dlog_out, O_CREAT | O_TRUNC | O_WRONLY, 0666);
+        if (fd < 0) {
+            printf("Unable to open %s\n", dlog_out);
+            return -1;
+        }
+        write(fd, (const char *)&dlog_buf, sizeof(dlog_buf));
+        close(fd);
+        printf("Write %s done!\n", dlog_out);
+#if defined(NUCLEI_RTT) && (NUCLEI_RTT == 1)
+    } else if (interface == 4) {
+        rtt_file_write(dlog_out, 0, &dlog_buf, sizeof(dlog_buf));
+        rtt_file_write(dlog_out, sizeof(dlog_buf), NULL, 0);
+        printf("Send %s done!\n", dlog_out);
+#endif
+    } else {
+        printf("\nDump dlog data start\n");
+        hexdumpbuf((char *)&dlog_buf, sizeof(dlog_buf));
+        printf("\nCREATE: %s\n", dlog_out);
+        printf("\nDump dlog data finished\n");
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+#ifndef _DLOG_API_H_
+#define _DLOG_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Deferred logging
+ *
+ * DLOG(fmt, ...) stores only the format string pointer, a timestamp and the raw arguments
+ * into the ring buffer of current hart, which takes tens of cycles instead of formatting
+ * and sending the whole line, dlog_flush() formats the records later in a low priority
+ * context such as idle hook, and emits them by dlog_port_output().
+ *
+ * - Arguments are stored as unsigned long, so they must be integers or pointers, at most
+ *   DLOG_MAX_ARGS of them, float and 64-bit integers on rv32 are not supported
+ * - Format string and strings passed by %s are not copied, they must be kept until flushed,
+ *   such as string literals, the arguments of NSDK_DEBUG in system_<Device>.c meet these
+ * - Rings are lock-free with atomic extension, and protected by disabling interrupts without
+ *   it, a full ring drops the new records and counts them
+ * - With NUCLEI_DLOG=1, NSDK_DEBUG is routed into DLOG, the RT-Thread and UCOSII ports flush
+ *   it in idle hook and RT-Thread emits it by rt_hw_console_output, call dlog_flush() in
+ *   vApplicationIdleHook for FreeRTOS and in main loop for bare-metal
+ * - Instead of dlog_flush(), dlog_collect() dumps the raw rings, which are decoded by
+ *   parse_dlog.py on host against the elf file, so target never formats them
+ */
+
+/* ring size of each hart in unsigned long words, must be power of 2 */
+#ifndef DLOG_RING_SIZE
+#define DLOG_RING_SIZE          1024
+#endif
+
+/* max hart count can be logged, harts with hart index larger than it are dropped */
+#ifndef DLOG_HART_NUM
+#if defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1)
+#define DLOG_HART_NUM           SMP_CPU_CNT
+#else
+#define DLOG_HART_NUM           1
+#endif
+#endif
+
+/* max formatted line length of dlog_flush, longer lines are truncated, fits the register dump of exception handler */
+#ifndef DLOG_LINE_SIZE
+#define DLOG_LINE_SIZE          384
+#endif
+
+/* max arguments of one record, enough for the register dump of exception handler */
+#define DLOG_MAX_ARGS           20
+
+#define DLOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, N, ...)     N
+#define DLOG_NARGS(...)         DLOG_NARGS_(_0, ##__VA_ARGS__, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define DLOG_ARGS_0(...)
+#define DLOG_ARGS_1(a)          , (unsigned long)(a)
+#define DLOG_ARGS_2(a, ...)     , (unsigned long)(a) DLOG_ARGS_1(__VA_ARGS__)
+#define DLOG_ARGS_3(a, ...)     , (unsigned long)(a) DLOG_ARGS_2(__VA_ARGS__)
+#define DLOG_ARGS_4(a, ...)     , (unsigned long)(a) DLOG_ARGS_3(__VA_ARGS__)
+#define DLOG_ARGS_5(a, ...)     , (unsigned long)(a) DLOG_ARGS_4(__VA_ARGS__)
+#define DLOG_ARGS_6(a, ...)     , (unsigned long)(a) DLOG_ARGS_5(__VA_ARGS__)
+#define DLOG_ARGS_7(a, ...)     , (unsigned long)(a) DLOG_ARGS_6(__VA_ARGS__)
+#define DLOG_ARGS_8(a, ...)     , (unsigned long)(a) DLOG_ARGS_7(__VA_ARGS__)
+#define DLOG_ARGS_9(a, ...)     , (unsigned long)(a) DLOG_ARGS_8(__VA_ARGS__)
+#define DLOG_ARGS_10(a, ...)    , (unsigned long)(a) DLOG_ARGS_9(__VA_ARGS__)
+#define DLOG_ARGS_11(a, ...)    , (unsigned long)(a) DLOG_ARGS_10(__VA_ARGS__)
+#define DLOG_ARGS_12(a, ...)    , (unsigned long)(a) DLOG_ARGS_11(__VA_ARGS__)
+#define DLOG_ARGS_13(a, ...)    , (unsigned long)(a) DLOG_ARGS_12(__VA_ARGS__)
+#define DLOG_ARGS_14(a, ...)    , (unsigned long)(a) DLOG_ARGS_13(__VA_ARGS__)
+#define DLOG_ARGS_15(a, ...)    , (unsigned long)(a) DLOG_ARGS_14(__VA_ARGS__)
+#define DLOG_ARGS_16(a, ...)    , (unsigned long)(a) DLOG_ARGS_15(__VA_ARGS__)
+#define DLOG_ARGS_17(a, ...)    , (unsigned long)(a) DLOG_ARGS_16(__VA_ARGS__)
+#define DLOG_ARGS_18(a, ...)    , (unsigned long)(a) DLOG_ARGS_17(__VA_ARGS__)
+#define DLOG_ARGS_19(a, ...)    , (unsigned long)(a) DLOG_ARGS_18(__VA_ARGS__)
+#define DLOG_ARGS_20(a, ...)    , (unsigned long)(a) DLOG_ARGS_19(__VA_ARGS__)
+#define DLOG_ARGS__(n, ...)     DLOG_ARGS_##n(__VA_ARGS__)
+#define DLOG_ARGS_(n, ...)      DLOG_ARGS__(n, ##__VA_ARGS__)
+
+/* Record a log line in printf format, each argument is casted to unsigned long */
+#define DLOG(fmt, ...)          dlog_record((fmt), DLOG_NARGS(__VA_ARGS__) \
+                                            DLOG_ARGS_(DLOG_NARGS(__VA_ARGS__), ##__VA_ARGS__))
+
+/* statistics of one hart */
+typedef struct dlog_stat {
+    uint32_t records;               /* records stored */
+    uint32_t dropped;               /* records dropped as ring full */
+} dlog_stat_t;
+
+/* Store a record of nargs unsigned long arguments, use DLOG instead of calling it directly */
+void dlog_record(const char *fmt, unsigned long nargs, ...);
+
+/* Format and emit the stored records of all harts, return records emitted */
+uint32_t dlog_flush(void);
+
+/* Emit a formatted line of len bytes, str is null terminated, weak function using putchar by default */
+void dlog_port_output(const char *str, size_t len);
+
+/* Get statistics of hart */
+void dlog_get_stat(unsigned long hartidx, dlog_stat_t *stat);
+
+/* - if interface == 0, it will dump raw rings in buffer called dlog_data, use dump_dlog.gdb to dump it
+ * - if interface == 1, it will write dlog.out file using open/write api
+ * - if interface == 4, it will send dlog.out in rtt data channel with rtt middleware, see parse_rtt.py
+ * - otherwise it will dump raw rings in console, use parse.py of profiling middleware to convert it into dlog.out
+ * dlog.out is decoded by parse_dlog.py with the elf file of the program
+ */
+long dlog_collect(unsigned long interface);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_DLOG_API_H_ */
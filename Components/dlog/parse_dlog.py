@@ -0,0 +1,156 @@
+#!/bin/env python3
+
+import re
+import sys
+import struct
+import argparse
+
+DLOG_MAGIC = b"NDLG"
+DLOG_HEADER = struct.Struct("<4sHHIIII")
+DLOG_RING_HEADER = struct.Struct("<IIIIII")
+
+# printf conversion, width and precision of '*' take an argument
+FORMAT_SPEC = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|z|j|t)?([diouxXcsp%])")
+
+
+class ElfImage(object):
+    """ Initialized data of allocated sections in elf file, used to read format strings """
+
+    def __init__(self, elffile):
+        self.sections = []
+        with open(elffile, "rb") as elf:
+            data = elf.read()
+        if data[:4] != b"\x7fELF":
+            raise ValueError("%s is not an elf file" % (elffile))
+        is64 = data[4] == 2
+        if is64:
+            shoff, = struct.unpack_from("<Q", data, 0x28)
+            shentsize, shnum = struct.unpack_from("<HH", data, 0x3A)
+            shdr = struct.Struct("<IIQQQQIIQQ")
+        else:
+            shoff, = struct.unpack_from("<I", data, 0x20)
+            shentsize, shnum = struct.unpack_from("<HH", data, 0x2E)
+            shdr = struct.Struct("<IIIIIIIIII")
+        for i in range(shnum):
+            _, shtype, flags, addr, offset, size = shdr.unpack_from(data, shoff + i * shentsize)[:6]
+            # SHF_ALLOC and not SHT_NOBITS
+            if (flags & 0x2) and shtype != 8 and size > 0:
+                self.sections.append((addr, data[offset:offset + size]))
+
+    def string(self, addr):
+        """ Return null terminated string at addr, None if it is not in elf """
+        for base, content in self.sections:
+            if base <= addr < base + len(content):
+                end = content.find(b"\0", addr - base)
+                if end < 0:
+                    end = len(content)
+                return content[addr - base:end].decode("utf-8", errors="replace")
+        return None
+
+
+def decode_dlog_data(data):
+    """
+    Decode the raw rings written by dlog_collect in dlog.c
+
+    Args:
+        data (bytes): binary dlog data
+
+    Returns:
+        tuple: (freq, xlen, rings), rings is a list of per hart dict with hartid, dropped and
+               records as (cycle, fmt, args) tuples in recorded order, None if data is invalid
+    """
+    if len(data) < DLOG_HEADER.size:
+        return None
+    magic, version, xlenbytes, harts, size, freq, _ = DLOG_HEADER.unpack_from(data, 0)
+    if magic != DLOG_MAGIC or version != 1 or xlenbytes not in (4, 8):
+        return None
+    wordfmt = "<%d%s" % (size, "Q" if xlenbytes == 8 else "I")
+    ringsize = DLOG_RING_HEADER.size + size * xlenbytes
+    # ring words are aligned to xlenbytes after the ring header
+    offset = (DLOG_HEADER.size + xlenbytes - 1) // xlenbytes * xlenbytes
+    rings = []
+    for i in range(harts):
+        if offset + ringsize > len(data):
+            return None
+        hartid, head, tail, dropped, records, _ = DLOG_RING_HEADER.unpack_from(data, offset)
+        words = struct.unpack_from(wordfmt, data, offset + DLOG_RING_HEADER.size)
+        offset += (ringsize + xlenbytes - 1) // xlenbytes * xlenbytes
+        recs = []
+        pos = tail
+        while pos != head:
+            fmt = words[pos % size]
+            if fmt == 0:
+                break
+            stamp = words[(pos + 1) % size]
+            nargs = stamp & 0xFF
+            args = [words[(pos + 2 + j) % size] for j in range(nargs)]
+            recs.append((stamp >> 8, fmt, args))
+            pos = (pos + 2 + nargs) & 0xFFFFFFFF
+        rings.append({"hartid": hartid, "dropped": dropped, "records": recs})
+    return freq, xlenbytes * 8, rings
+
+
+def format_record(elf, fmt, args, xlen):
+    """ Format a record like printf on target, strings are read from elf """
+    text = elf.string(fmt)
+    if text is None:
+        return "<unknown format @0x%x> %s" % (fmt, " ".join("0x%x" % (arg) for arg in args))
+    args = list(args)
+
+    def next_arg():
+        return args.pop(0) if args else 0
+
+    def convert(match):
+        flags, width, prec, length, conv = match.groups()
+        if conv == "%":
+            return "%"
+        if width == "*":
+            width = str(next_arg())
+        if prec == "*":
+            prec = str(next_arg())
+        spec = "%" + flags + (width or "") + ("." + prec if prec is not None else "")
+        value = next_arg()
+        bits = {"hh": 8, "h": 16, "l": xlen, "ll": xlen, "z": xlen, "j": xlen, "t": xlen}.get(length, 32)
+        value &= (1 << bits) - 1
+        if conv in "di":
+            if value >> (bits - 1):
+                value -= 1 << bits
+            return (spec + "d") % (value)
+        if conv == "u":
+            return (spec + "d") % (value)
+        if conv in "oxX":
+            return (spec + conv) % (value)
+        if conv == "c":
+            return (spec + "c") % (chr(value & 0xFF))
+        if conv == "p":
+            return (spec + "s") % ("0x%x" % (value))
+        string = elf.string(value)
+        return (spec + "s") % (string if string is not None else "<0x%x>" % (value))
+
+    return FORMAT_SPEC.sub(convert, text)
+
+
+# Usage:
+# python nuclei_sdk/Components/dlog/parse_dlog.py --elf build/app.elf dlog.out
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Decode dlog.out collected by dlog_collect against elf file")
+    parser.add_argument("--elf", required=True, help="elf file of the program, used to read format strings")
+    parser.add_argument("dlogfile", help="dlog.out file")
+    args = parser.parse_args()
+
+    with open(args.dlogfile, "rb") as df:
+        result = decode_dlog_data(df.read())
+    if result is None:
+        print("Error: %s is not a valid dlog data file" % (args.dlogfile))
+        sys.exit(1)
+    freq, xlen, rings = result
+    elf = ElfImage(args.elf)
+    stampmask = (1 << (xlen - 8)) - 1
+    for ring in rings:
+        print("==== hart %d: %d records, %d dropped ====" % (ring["hartid"], len(ring["records"]), ring["dropped"]))
+        base = ring["records"][0][0] if ring["records"] else 0
+        for cycle, fmt, fargs in ring["records"]:
+            delta = (cycle - base) & stampmask
+            stamp = "%.3fus" % (delta * 1e6 / freq) if freq else "%d" % (delta)
+            line = format_record(elf, fmt, fargs, xlen)
+            sys.stdout.write("[%12s] %s" % (stamp, line if line.endswith("\n") else line + "\n"))
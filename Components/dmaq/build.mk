@@ -0,0 +1,12 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# dmaq middleware provides DMA request queues, double-buffer streams, USART streaming, SPI and I2C transactions,
+# timer PWM update and input capture, timer paced GPIO waveforms and ADC acquisition over the gd32vf103 and gd32vw55x DMA drivers, UART_DMA=1 routes newlib stdio through it
+MIDDLEWARE_DMAQ := $(NUCLEI_SDK_MIDDLEWARE)/dmaq
+
+C_SRCDIRS += $(MIDDLEWARE_DMAQ)
+
+INCDIRS += $(MIDDLEWARE_DMAQ)
+
+ifeq ($(UART_DMA),1)
+COMMON_FLAGS += -DNUCLEI_UART_DMA=1
+endif
@@ -0,0 +1,516 @@
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "dmaq_api.h"
+
+/* channel state, queue is protected by disabling interrupts */
+typedef struct dmaq_chan {
+    dmaq_req_t *head;               /* running request */
+    dmaq_req_t *tail;
+    dmaq_stream_t *stream;          /* running stream, requests are not accepted */
+    uint32_t subperiph;
+    uint32_t priority;
+    uint32_t inited;
+    dmaq_stat_t stat;
+} dmaq_chan_t;
+
+static dmaq_chan_t dmaq_chans[DMAQ_MAX_CHANNELS];
+
+#define DMAQ_WIDTH_IDX(width)       (((width) == 4) ? 2 : (((width) == 2) ? 1 : 0))
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1) && defined(__CCM_PRESENT) && (__CCM_PRESENT == 1)
+static inline unsigned long dmaq_cache_lines(unsigned long *addr, uint32_t bytes)
+{
+    unsigned long start = *addr & ~(unsigned long)(DMAQ_CACHE_LINE - 1);
+    unsigned long end = *addr + bytes;
+
+    *addr = start;
+    return (end - start + DMAQ_CACHE_LINE - 1) / DMAQ_CACHE_LINE;
+}
+
+/* memory written by CPU is visible to DMA */
+static void dmaq_cache_flush(void *mem, uint32_t bytes)
+{
+    unsigned long addr = (unsigned long)mem;
+    unsigned long cnt = dmaq_cache_lines(&addr, bytes);
+
+    MFlushDCacheLines(addr, cnt);
+}
+
+/* memory written by DMA is read from memory, not from stale lines */
+static void dmaq_cache_inval(void *mem, uint32_t bytes)
+{
+    unsigned long addr = (unsigned long)mem;
+    unsigned long cnt = dmaq_cache_lines(&addr, bytes);
+
+    MInvalDCacheLines(addr, cnt);
+}
+#else
+#define dmaq_cache_flush(mem, bytes)
+#define dmaq_cache_inval(mem, bytes)
+#endif
+
+/* flags returned by dmaq_hw_irq_flags */
+#define DMAQ_HW_FTF                 0x1
+#define DMAQ_HW_HTF                 0x2
+#define DMAQ_HW_ERR                 0x4
+
+#if defined(GD32VW55x_H)
+static const uint32_t dmaq_hw_widths[3] = {
+    DMA_PERIPH_WIDTH_8BIT, DMA_PERIPH_WIDTH_16BIT, DMA_PERIPH_WIDTH_32BIT
+};
+
+static const IRQn_Type dmaq_hw_irqs[DMAQ_MAX_CHANNELS] = {
+    DMA_Channel0_IRQn, DMA_Channel1_IRQn, DMA_Channel2_IRQn, DMA_Channel3_IRQn,
+    DMA_Channel4_IRQn, DMA_Channel5_IRQn, DMA_Channel6_IRQn, DMA_Channel7_IRQn
+};
+
+#define DMAQ_HW_ALL_FLAGS           (DMA_INT_FLAG_FEE | DMA_INT_FLAG_SDE | DMA_INT_FLAG_TAE | DMA_INT_FLAG_HTF | DMA_INT_FLAG_FTF)
+
+static void dmaq_hw_clock_enable(uint32_t chan)
+{
+    rcu_periph_clock_enable(RCU_DMA);
+}
+
+static void dmaq_hw_config(uint32_t chan, uint32_t periph, void *mem, uint32_t count, uint8_t dir,
+                           uint8_t width, uint8_t periph_inc, uint8_t mem_inc, uint32_t circular)
+{
+    dma_channel_enum ch = (dma_channel_enum)chan;
+    dma_single_data_parameter_struct init;
+
+    dma_channel_disable(ch);
+    dma_switch_buffer_mode_disable(ch);
+    dma_interrupt_flag_clear(ch, DMAQ_HW_ALL_FLAGS);
+    dma_single_data_para_struct_init(&init);
+    init.periph_addr = periph;
+    init.periph_inc = periph_inc ? DMA_PERIPH_INCREASE_ENABLE : DMA_PERIPH_INCREASE_DISABLE;
+    init.memory0_addr = (uint32_t)(unsigned long)mem;
+    init.memory_inc = mem_inc ? DMA_MEMORY_INCREASE_ENABLE : DMA_MEMORY_INCREASE_DISABLE;
+    init.periph_memory_width = dmaq_hw_widths[DMAQ_WIDTH_IDX(width)];
+    init.circular_mode = circular ? DMA_CIRCULAR_MODE_ENABLE : DMA_CIRCULAR_MODE_DISABLE;
+    init.direction = (dir == DMAQ_DIR_M2P) ? DMA_MEMORY_TO_PERIPH :
+                     ((dir == DMAQ_DIR_M2M) ? DMA_MEMORY_TO_MEMORY : DMA_PERIPH_TO_MEMORY);
+    init.number = count;
+    init.priority = dmaq_chans[chan].priority;
+    dma_single_data_mode_init(ch, &init);
+    dma_channel_subperipheral_select(ch, (dma_subperipheral_enum)dmaq_chans[chan].subperiph);
+    dma_interrupt_enable(ch, DMA_INT_FTF | DMA_INT_TAE);
+}
+
+static inline void dmaq_hw_enable(uint32_t chan)
+{
+    dma_channel_enable((dma_channel_enum)chan);
+}
+
+static inline void dmaq_hw_disable(uint32_t chan)
+{
+    dma_interrupt_disable((dma_channel_enum)chan, DMA_INT_FTF | DMA_INT_HTF | DMA_INT_TAE);
+    dma_channel_disable((dma_channel_enum)chan);
+}
+
+static uint32_t dmaq_hw_irq_flags(uint32_t chan)
+{
+    dma_channel_enum ch = (dma_channel_enum)chan;
+    uint32_t flags = 0;
+
+    if (dma_interrupt_flag_get(ch, DMA_INT_FLAG_FTF) == SET) {
+        flags |= DMAQ_HW_FTF;
+    }
+    if (dma_interrupt_flag_get(ch, DMA_INT_FLAG_TAE) == SET) {
+        flags |= DMAQ_HW_ERR;
+    }
+    dma_interrupt_flag_clear(ch, DMAQ_HW_ALL_FLAGS);
+    return flags;
+}
+
+/* switch-buffer mode, each full transfer finish is one buffer */
+static int32_t dmaq_hw_stream_start(uint32_t chan, dmaq_stream_t *stream)
+{
+    dma_channel_enum ch = (dma_channel_enum)chan;
+
+    dmaq_hw_config(chan, stream->periph_addr, stream->buf[0], stream->count, stream->dir,
+                   stream->width, 0, 1, 1);
+    dma_switch_buffer_mode_config(ch, (uint32_t)(unsigned long)stream->buf[1], DMA_MEMORY_0);
+    dma_switch_buffer_mode_enable(ch);
+    return 0;
+}
+
+/* data done in current cycle over both buffers, retry when buffer switched between the reads */
+static uint32_t dmaq_hw_stream_position(uint32_t chan, uint32_t count)
+{
+    dma_channel_enum ch = (dma_channel_enum)chan;
+    uint32_t mem, left;
+
+    do {
+        mem = dma_using_memory_get(ch);
+        left = dma_transfer_number_get(ch);
+    } while (mem != dma_using_memory_get(ch));
+    return ((mem == DMA_MEMORY_1) ? count : 0) + count - left;
+}
+
+/* consume one finished buffer event in flags, return the buffer, DMA has switched to the other one */
+static inline uint32_t dmaq_hw_stream_done(uint32_t chan, uint32_t *flags)
+{
+    *flags &= ~DMAQ_HW_FTF;
+    return (dma_using_memory_get((dma_channel_enum)chan) == DMA_MEMORY_1) ? 0 : 1;
+}
+#else
+static const uint32_t dmaq_hw_pwidths[3] = {
+    DMA_PERIPHERAL_WIDTH_8BIT, DMA_PERIPHERAL_WIDTH_16BIT, DMA_PERIPHERAL_WIDTH_32BIT
+};
+
+static const uint32_t dmaq_hw_mwidths[3] = {
+    DMA_MEMORY_WIDTH_8BIT, DMA_MEMORY_WIDTH_16BIT, DMA_MEMORY_WIDTH_32BIT
+};
+
+static const IRQn_Type dmaq_hw_irqs[DMAQ_MAX_CHANNELS] = {
+    DMA0_Channel0_IRQn, DMA0_Channel1_IRQn, DMA0_Channel2_IRQn, DMA0_Channel3_IRQn,
+    DMA0_Channel4_IRQn, DMA0_Channel5_IRQn, DMA0_Channel6_IRQn,
+    DMA1_Channel0_IRQn, DMA1_Channel1_IRQn, DMA1_Channel2_IRQn, DMA1_Channel3_IRQn,
+    DMA1_Channel4_IRQn
+};
+
+#define DMAQ_HW_DMA(chan)           (((chan) < 7) ? DMA0 : DMA1)
+#define DMAQ_HW_CH(chan)            ((dma_channel_enum)(((chan) < 7) ? (chan) : ((chan) - 7)))
+
+static void dmaq_hw_clock_enable(uint32_t chan)
+{
+    rcu_periph_clock_enable((chan < 7) ? RCU_DMA0 : RCU_DMA1);
+}
+
+static void dmaq_hw_config(uint32_t chan, uint32_t periph, void *mem, uint32_t count, uint8_t dir,
+                           uint8_t width, uint8_t periph_inc, uint8_t mem_inc, uint32_t circular)
+{
+    uint32_t dma = DMAQ_HW_DMA(chan);
+    dma_channel_enum ch = DMAQ_HW_CH(chan);
+    dma_parameter_struct init;
+
+    dma_channel_disable(dma, ch);
+    dma_interrupt_flag_clear(dma, ch, DMA_INT_FLAG_G);
+    dma_struct_para_init(&init);
+    init.periph_addr = periph;
+    init.periph_width = dmaq_hw_pwidths[DMAQ_WIDTH_IDX(width)];
+    init.periph_inc = periph_inc ? DMA_PERIPH_INCREASE_ENABLE : DMA_PERIPH_INCREASE_DISABLE;
+    init.memory_addr = (uint32_t)(unsigned long)mem;
+    init.memory_width = dmaq_hw_mwidths[DMAQ_WIDTH_IDX(width)];
+    init.memory_inc = mem_inc ? DMA_MEMORY_INCREASE_ENABLE : DMA_MEMORY_INCREASE_DISABLE;
+    init.number = count;
+    init.priority = dmaq_chans[chan].priority;
+    init.direction = (dir == DMAQ_DIR_M2P) ? DMA_MEMORY_TO_PERIPHERAL : DMA_PERIPHERAL_TO_MEMORY;
+    dma_init(dma, ch, &init);
+    if (dir == DMAQ_DIR_M2M) {
+        dma_memory_to_memory_enable(dma, ch);
+    } else {
+        dma_memory_to_memory_disable(dma, ch);
+    }
+    if (circular) {
+        dma_circulation_enable(dma, ch);
+    } else {
+        dma_circulation_disable(dma, ch);
+    }
+    dma_interrupt_enable(dma, ch, DMA_INT_FTF | DMA_INT_ERR);
+}
+
+static inline void dmaq_hw_enable(uint32_t chan)
+{
+    dma_channel_enable(DMAQ_HW_DMA(chan), DMAQ_HW_CH(chan));
+}
+
+static inline void dmaq_hw_disable(uint32_t chan)
+{
+    dma_interrupt_disable(DMAQ_HW_DMA(chan), DMAQ_HW_CH(chan), DMA_INT_FTF | DMA_INT_HTF | DMA_INT_ERR);
+    dma_channel_disable(DMAQ_HW_DMA(chan), DMAQ_HW_CH(chan));
+}
+
+static uint32_t dmaq_hw_irq_flags(uint32_t chan)
+{
+    uint32_t dma = DMAQ_HW_DMA(chan);
+    dma_channel_enum ch = DMAQ_HW_CH(chan);
+    uint32_t flags = 0;
+
+    if (dma_interrupt_flag_get(dma, ch, DMA_INT_FLAG_FTF) == SET) {
+        flags |= DMAQ_HW_FTF;
+    }
+    if (dma_interrupt_flag_get(dma, ch, DMA_INT_FLAG_HTF) == SET) {
+        flags |= DMAQ_HW_HTF;
+    }
+    if (dma_interrupt_flag_get(dma, ch, DMA_INT_FLAG_ERR) == SET) {
+        flags |= DMAQ_HW_ERR;
+    }
+    dma_interrupt_flag_clear(dma, ch, DMA_INT_FLAG_G);
+    return flags;
+}
+
+/* no switch-buffer mode, circular over both buffers, half transfer finish is first buffer */
+static int32_t dmaq_hw_stream_start(uint32_t chan, dmaq_stream_t *stream)
+{
+    if ((uint8_t *)stream->buf[1] != (uint8_t *)stream->buf[0] + stream->count * stream->width) {
+        return -1;
+    }
+    if (stream->count * 2 > 0xFFFF) {
+        return -1;
+    }
+    dmaq_hw_config(chan, stream->periph_addr, stream->buf[0], stream->count * 2, stream->dir,
+                   stream->width, 0, 1, 1);
+    dma_interrupt_enable(DMAQ_HW_DMA(chan), DMAQ_HW_CH(chan), DMA_INT_HTF);
+    return 0;
+}
+
+static uint32_t dmaq_hw_stream_position(uint32_t chan, uint32_t count)
+{
+    return count * 2 - dma_transfer_number_get(DMAQ_HW_DMA(chan), DMAQ_HW_CH(chan));
+}
+
+static inline uint32_t dmaq_hw_stream_done(uint32_t chan, uint32_t *flags)
+{
+    if (*flags & DMAQ_HW_HTF) {
+        *flags &= ~DMAQ_HW_HTF;
+        return 0;
+    }
+    *flags &= ~DMAQ_HW_FTF;
+    return 1;
+}
+#endif
+
+static inline void dmaq_start(uint32_t chan, dmaq_req_t *req)
+{
+    if (req->dir != DMAQ_DIR_P2M) {
+        dmaq_cache_flush(req->mem, req->count * req->width);
+    }
+    dmaq_hw_config(chan, req->periph_addr, req->mem, req->count, req->dir, req->width,
+                   (req->dir == DMAQ_DIR_M2M) ? 1 : req->periph_inc, req->mem_inc, 0);
+    dmaq_hw_enable(chan);
+}
+
+static void dmaq_irq(uint32_t chan)
+{
+    dmaq_chan_t *c = &dmaq_chans[chan];
+    dmaq_stream_t *stream = c->stream;
+    uint32_t flags = dmaq_hw_irq_flags(chan);
+    dmaq_req_t *req;
+    uint32_t buf;
+
+    if (stream != NULL) {
+        if (flags & DMAQ_HW_ERR) {
+            c->stat.errors++;
+        }
+        // on gd32vf103 both halves are reported if the handler was late
+        while (flags & (DMAQ_HW_FTF | DMAQ_HW_HTF)) {
+            buf = dmaq_hw_stream_done(chan, &flags);
+            if (stream->dir == DMAQ_DIR_P2M) {
+                dmaq_cache_inval(stream->buf[buf], stream->count * stream->width);
+            }
+            c->stat.buffers++;
+            if (stream->cb != NULL) {
+                stream->cb(stream, buf, stream->arg);
+            }
+            // the buffer is refilled by cpu in callback before DMA reads it again
+            if (stream->dir == DMAQ_DIR_M2P) {
+                dmaq_cache_flush(stream->buf[buf], stream->count * stream->width);
+            }
+        }
+        return;
+    }
+
+    req = c->head;
+    if ((req == NULL) || ((flags & (DMAQ_HW_FTF | DMAQ_HW_ERR)) == 0)) {
+        return;
+    }
+    // start next one before callback, so the channel is idle as short as possible
+    c->head = req->next;
+    if (c->head != NULL) {
+        dmaq_start(chan, c->head);
+    } else {
+        c->tail = NULL;
+        dmaq_hw_disable(chan);
+    }
+    if (flags & DMAQ_HW_ERR) {
+        c->stat.errors++;
+        req->status = DMAQ_ERROR;
+    } else {
+        if (req->dir != DMAQ_DIR_M2P) {
+            dmaq_cache_inval(req->mem, req->count * req->width);
+        }
+        c->stat.done++;
+        req->status = DMAQ_DONE;
+    }
+    if (req->cb != NULL) {
+        req->cb(req, req->arg);
+    }
+}
+
+#define DMAQ_IRQ_HANDLER(n)         static void dmaq_irq_handler##n(void) { dmaq_irq(n); }
+DMAQ_IRQ_HANDLER(0)
+DMAQ_IRQ_HANDLER(1)
+DMAQ_IRQ_HANDLER(2)
+DMAQ_IRQ_HANDLER(3)
+DMAQ_IRQ_HANDLER(4)
+DMAQ_IRQ_HANDLER(5)
+DMAQ_IRQ_HANDLER(6)
+DMAQ_IRQ_HANDLER(7)
+#if DMAQ_MAX_CHANNELS > 8
+DMAQ_IRQ_HANDLER(8)
+DMAQ_IRQ_HANDLER(9)
+DMAQ_IRQ_HANDLER(10)
+DMAQ_IRQ_HANDLER(11)
+#endif
+
+static void (*const dmaq_irq_handlers[DMAQ_MAX_CHANNELS])(void) = {
+    dmaq_irq_handler0, dmaq_irq_handler1, dmaq_irq_handler2, dmaq_irq_handler3,
+    dmaq_irq_handler4, dmaq_irq_handler5, dmaq_irq_handler6, dmaq_irq_handler7,
+#if DMAQ_MAX_CHANNELS > 8
+    dmaq_irq_handler8, dmaq_irq_handler9, dmaq_irq_handler10, dmaq_irq_handler11,
+#endif
+};
+
+int32_t dmaq_chan_init(uint32_t chan, uint32_t subperiph, uint32_t priority, uint8_t lvl)
+{
+    dmaq_chan_t *c;
+
+    if (chan >= DMAQ_MAX_CHANNELS) {
+        return -1;
+    }
+    c = &dmaq_chans[chan];
+    c->head = NULL;
+    c->tail = NULL;
+    c->stream = NULL;
+    c->subperiph = subperiph;
+    c->priority = priority;
+    c->inited = 1;
+    dmaq_hw_clock_enable(chan);
+    dmaq_hw_disable(chan);
+    return ECLIC_Register_IRQ(dmaq_hw_irqs[chan], ECLIC_NON_VECTOR_INTERRUPT, ECLIC_LEVEL_TRIGGER, lvl, 0,
+                              (void *)dmaq_irq_handlers[chan]);
+}
+
+int32_t dmaq_submit(uint32_t chan, dmaq_req_t *req)
+{
+    dmaq_chan_t *c;
+    rv_csr_t mstatus;
+
+    if ((chan >= DMAQ_MAX_CHANNELS) || (dmaq_chans[chan].inited == 0) || (req->count == 0) || (req->count > 0xFFFF)) {
+        return -1;
+    }
+    c = &dmaq_chans[chan];
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if (c->stream != NULL) {
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+        return -1;
+    }
+    req->next = NULL;
+    req->status = DMAQ_PENDING;
+    c->stat.submits++;
+    if (c->tail != NULL) {
+        c->tail->next = req;
+        c->tail = req;
+    } else {
+        c->head = req;
+        c->tail = req;
+        dmaq_start(chan, req);
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return 0;
+}
+
+int32_t dmaq_wait(dmaq_req_t *req)
+{
+    return __wfi_while_pending(&req->status, DMAQ_PENDING);
+}
+
+int32_t dmaq_cancel(uint32_t chan, dmaq_req_t *req)
+{
+    dmaq_chan_t *c;
+    dmaq_req_t *p, *prev = NULL;
+    rv_csr_t mstatus;
+    int32_t ret = -1;
+
+    if (chan >= DMAQ_MAX_CHANNELS) {
+        return -1;
+    }
+    c = &dmaq_chans[chan];
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    for (p = c->head; p != NULL; prev = p, p = p->next) {
+        if (p != req) {
+            continue;
+        }
+        if (prev == NULL) {
+            // running one, a pending finish flag is cleared by the next dmaq_hw_config
+            dmaq_hw_disable(chan);
+            c->head = req->next;
+            if (c->head != NULL) {
+                dmaq_start(chan, c->head);
+            }
+        } else {
+            prev->next = req->next;
+        }
+        if (c->tail == req) {
+            c->tail = prev;
+        }
+        req->status = DMAQ_ERROR;
+        ret = 0;
+        break;
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return ret;
+}
+
+int32_t dmaq_stream_start(uint32_t chan, dmaq_stream_t *stream)
+{
+    dmaq_chan_t *c;
+    rv_csr_t mstatus;
+    int32_t ret = -1;
+
+    if ((chan >= DMAQ_MAX_CHANNELS) || (dmaq_chans[chan].inited == 0) || (stream->count == 0) ||
+        (stream->count > 0xFFFF) || (stream->dir == DMAQ_DIR_M2M)) {
+        return -1;
+    }
+    c = &dmaq_chans[chan];
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if ((c->head == NULL) && (c->stream == NULL)) {
+        if (stream->dir == DMAQ_DIR_M2P) {
+            dmaq_cache_flush(stream->buf[0], stream->count * stream->width);
+            dmaq_cache_flush(stream->buf[1], stream->count * stream->width);
+        }
+        ret = dmaq_hw_stream_start(chan, stream);
+        if (ret == 0) {
+            c->stream = stream;
+            dmaq_hw_enable(chan);
+        }
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return ret;
+}
+
+void dmaq_stream_stop(uint32_t chan)
+{
+    rv_csr_t mstatus;
+
+    if (chan >= DMAQ_MAX_CHANNELS) {
+        return;
+    }
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if (dmaq_chans[chan].stream != NULL) {
+        dmaq_hw_disable(chan);
+        dmaq_chans[chan].stream = NULL;
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
+
+uint32_t dmaq_stream_position(uint32_t chan)
+{
+    dmaq_stream_t *stream;
+    uint32_t pos;
+
+    if ((chan >= DMAQ_MAX_CHANNELS) || ((stream = dmaq_chans[chan].stream) == NULL)) {
+        return 0;
+    }
+    pos = dmaq_hw_stream_position(chan, stream->count);
+    // counter is reloaded after the last data of cycle
+    return (pos >= stream->count * 2) ? 0 : pos;
+}
+
+void dmaq_get_stat(uint32_t chan, dmaq_stat_t *stat)
+{
+    if (chan < DMAQ_MAX_CHANNELS) {
+        *stat = dmaq_chans[chan].stat;
+    }
+}
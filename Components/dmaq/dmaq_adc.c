@@ -0,0 +1,112 @@
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "dmaq_api.h"
+
+#if defined(__GD32VF103_H__)
+
+/* convert left aligned unsigned samples to signed q15 in place */
+static void dmaq_adc_to_q15(uint16_t *samples, uint32_t count)
+{
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        samples[i] ^= 0x8000;
+    }
+}
+
+/* half buf of buffer finished, DMA is filling the other half */
+static void dmaq_adc_stream_cb(dmaq_stream_t *stream, uint32_t buf, void *arg)
+{
+    dmaq_adc_t *adc = (dmaq_adc_t *)arg;
+    void *samples = stream->buf[buf];
+    uint32_t pos;
+
+    if (adc->ready[buf ^ 1] != 0) {
+        // DMA is writing the half not released yet
+        adc->ready[buf ^ 1] = 0;
+        adc->overruns++;
+    }
+    if ((adc->q15 != 0) && (adc->width == 2)) {
+        dmaq_adc_to_q15((uint16_t *)samples, adc->count);
+    }
+    if (adc->proc == NULL) {
+        adc->ready[buf] = 1;
+        return;
+    }
+    adc->proc(adc, samples, adc->count, adc->arg);
+    pos = dmaq_stream_position(adc->chan);
+    if ((pos / adc->count) == buf) {
+        // processing took longer than one half, DMA came back to it
+        adc->overruns++;
+    }
+}
+
+int32_t dmaq_adc_start(dmaq_adc_t *adc)
+{
+    dmaq_stream_t *stream = &adc->stream;
+
+    if (((adc->width != 2) && (adc->width != 4)) || (adc->count == 0) || (adc->count * 2 > 0xFFFF)) {
+        return -1;
+    }
+    adc->ready[0] = 0;
+    adc->ready[1] = 0;
+    adc->overruns = 0;
+    stream->periph_addr = (uint32_t)(unsigned long)&ADC_RDATA(adc->periph);
+    stream->buf[0] = adc->buf;
+    stream->buf[1] = (uint8_t *)adc->buf + adc->count * adc->width;
+    stream->count = adc->count;
+    stream->dir = DMAQ_DIR_P2M;
+    stream->width = adc->width;
+    stream->cb = dmaq_adc_stream_cb;
+    stream->arg = adc;
+
+    adc_dma_mode_enable(adc->periph);
+    adc_special_function_config(adc->periph, ADC_CONTINUOUS_MODE,
+                                (adc->trigger == ADC0_1_EXTTRIG_REGULAR_NONE) ? ENABLE : DISABLE);
+    // software trigger also needs the external trigger of regular group enabled
+    adc_external_trigger_source_config(adc->periph, ADC_REGULAR_CHANNEL, adc->trigger);
+    adc_external_trigger_config(adc->periph, ADC_REGULAR_CHANNEL, ENABLE);
+    if (dmaq_stream_start(adc->chan, stream) != 0) {
+        adc_dma_mode_disable(adc->periph);
+        return -1;
+    }
+    if (adc->trigger == ADC0_1_EXTTRIG_REGULAR_NONE) {
+        adc_software_trigger_enable(adc->periph, ADC_REGULAR_CHANNEL);
+    }
+    if (adc->timer != 0) {
+        timer_enable(adc->timer);
+    }
+    return 0;
+}
+
+void dmaq_adc_stop(dmaq_adc_t *adc)
+{
+    if (adc->timer != 0) {
+        timer_disable(adc->timer);
+    }
+    adc_special_function_config(adc->periph, ADC_CONTINUOUS_MODE, DISABLE);
+    adc_external_trigger_config(adc->periph, ADC_REGULAR_CHANNEL, DISABLE);
+    dmaq_stream_stop(adc->chan);
+    adc_dma_mode_disable(adc->periph);
+}
+
+uint32_t dmaq_adc_get(dmaq_adc_t *adc, void **samples)
+{
+    uint32_t buf;
+
+    for (buf = 0; buf < 2; buf++) {
+        if (adc->ready[buf] != 0) {
+            *samples = adc->stream.buf[buf];
+            return adc->count;
+        }
+    }
+    return 0;
+}
+
+void dmaq_adc_release(dmaq_adc_t *adc)
+{
+    adc->ready[0] = 0;
+    adc->ready[1] = 0;
+}
+
+#endif
@@ -0,0 +1,495 @@
+#ifndef _DMAQ_API_H_
+#define _DMAQ_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+
+/*
+ * DMA service layer over the GD32 DMA drivers, so peripheral drivers don't manage channels.
+ *
+ * - Request queue: each channel has a FIFO of caller owned requests, dmaq_submit() queues
+ *   one and starts it if the channel is idle, the full transfer finish interrupt completes
+ *   it, starts the next one, then calls its callback
+ * - Stream: continuous transfer alternating between two buffers, the callback is called
+ *   with the index of the buffer just finished while DMA fills or drains the other one,
+ *   gd32vw55x uses switch-buffer mode, gd32vf103 has no switch-buffer mode and uses
+ *   circular mode with half transfer interrupt, so its two buffers must be contiguous
+ * - Cache: memory range of a request is flushed before memory to peripheral transfers and
+ *   invalidated after peripheral to memory transfers when D-Cache and CCM are present,
+ *   gd32vf103 and gd32vw55x have no D-Cache, so it is compiled out on them
+ *
+ * Callbacks run in the channel interrupt handler, in RTOS give a semaphore or task
+ * notification from it, in bare-metal dmaq_wait() sleeps until the request completes.
+ *
+ * Channel number: gd32vw55x DMA_CHx is x, gd32vf103 DMA0 DMA_CHx is x, DMA1 DMA_CHx is 7 + x,
+ * see DMAQ_CHANNEL().
+ */
+
+#if defined(GD32VW55x_H)
+#define DMAQ_MAX_CHANNELS           8
+#define DMAQ_CHANNEL(dma, ch)       (ch)
+#elif defined(__GD32VF103_H__)
+#define DMAQ_MAX_CHANNELS           12
+#define DMAQ_CHANNEL(dma, ch)       (((dma) == DMA1) ? (7 + (ch)) : (ch))
+#else
+#error "dmaq middleware only supports gd32vf103 and gd32vw55x"
+#endif
+
+/* cache line size used by cache maintenance */
+#ifndef DMAQ_CACHE_LINE
+#define DMAQ_CACHE_LINE             64
+#endif
+
+/* transfer direction */
+#define DMAQ_DIR_P2M                0       /* peripheral to memory */
+#define DMAQ_DIR_M2P                1       /* memory to peripheral */
+#define DMAQ_DIR_M2M                2       /* periph_addr to memory, both increase */
+
+/* request status */
+#define DMAQ_DONE                   0
+#define DMAQ_PENDING                1
+#define DMAQ_ERROR                  -1
+
+struct dmaq_req;
+/* completion callback of request, called in interrupt */
+typedef void (*dmaq_cb_t)(struct dmaq_req *req, void *arg);
+
+/* transfer request, owned by caller until completed */
+typedef struct dmaq_req {
+    struct dmaq_req *next;
+    uint32_t periph_addr;           /* peripheral address, or source address of DMAQ_DIR_M2M */
+    void *mem;                      /* memory address */
+    uint32_t count;                 /* number of data, 1 ~ 65535 */
+    uint8_t dir;                    /* DMAQ_DIR_* */
+    uint8_t width;                  /* data width in bytes, 1, 2 or 4 */
+    uint8_t periph_inc;             /* 1 to increase peripheral address */
+    uint8_t mem_inc;                /* 1 to increase memory address */
+    dmaq_cb_t cb;                   /* completion callback, can be NULL */
+    void *arg;
+    volatile int32_t status;        /* DMAQ_PENDING when queued, DMAQ_DONE or DMAQ_ERROR */
+} dmaq_req_t;
+
+struct dmaq_stream;
+/* stream callback, buf is the index of buffer just finished */
+typedef void (*dmaq_stream_cb_t)(struct dmaq_stream *stream, uint32_t buf, void *arg);
+
+/* continuous double-buffer transfer */
+typedef struct dmaq_stream {
+    uint32_t periph_addr;           /* peripheral address */
+    void *buf[2];                   /* two buffers of count data each */
+    uint32_t count;                 /* number of data of one buffer */
+    uint8_t dir;                    /* DMAQ_DIR_P2M or DMAQ_DIR_M2P */
+    uint8_t width;                  /* data width in bytes, 1, 2 or 4 */
+    dmaq_stream_cb_t cb;
+    void *arg;
+} dmaq_stream_t;
+
+/* statistics of one channel */
+typedef struct dmaq_stat {
+    uint32_t submits;               /* requests submitted */
+    uint32_t done;                  /* requests completed */
+    uint32_t errors;                /* transfer errors */
+    uint32_t buffers;               /* stream buffers finished */
+} dmaq_stat_t;
+
+/*
+ * Initialize channel and install its interrupt handler at level lvl, subperiph is the
+ * DMA_SUBPERIx peripheral request of gd32vw55x and ignored on gd32vf103, priority is the
+ * DMA_PRIORITY_* of driver. Return 0 on success, -1 if chan is invalid
+ */
+int32_t dmaq_chan_init(uint32_t chan, uint32_t subperiph, uint32_t priority, uint8_t lvl);
+
+/* Queue req to chan, return 0 on success, -1 if chan is invalid or streaming */
+int32_t dmaq_submit(uint32_t chan, dmaq_req_t *req);
+
+/* Sleep until req completes in bare-metal, return status of req */
+int32_t dmaq_wait(dmaq_req_t *req);
+
+/*
+ * Remove req from chan without its callback, a running one is stopped and the next one is
+ * started, its status is DMAQ_ERROR. Return 0 if removed, -1 if req is not queued on chan
+ */
+int32_t dmaq_cancel(uint32_t chan, dmaq_req_t *req);
+
+/* Start stream on idle chan, return 0 on success, -1 on invalid argument or busy chan */
+int32_t dmaq_stream_start(uint32_t chan, dmaq_stream_t *stream);
+
+/* Stop stream of chan */
+void dmaq_stream_stop(uint32_t chan);
+
+/*
+ * Data transferred in current cycle of stream, counting buf[0] then buf[1], so it is
+ * 0 ~ 2 * count - 1, return 0 if no stream is running
+ */
+uint32_t dmaq_stream_position(uint32_t chan);
+
+/* Get statistics of chan */
+void dmaq_get_stat(uint32_t chan, dmaq_stat_t *stat);
+
+/*
+ * USART streaming over dmaq
+ *
+ * - RX: circular stream into rxbuf, the two halves of rxbuf are the two stream buffers,
+ *   received data is handed off in place at half and full buffer and at idle line, so
+ *   a variable-length frame is passed to rx_cb once the line goes idle after it, without
+ *   copying. rx_cb data is consumed when it returns, without rx_cb data is read by
+ *   dmaq_uart_rx_peek()/dmaq_uart_rx_consume() or dmaq_uart_read(). Data not consumed
+ *   within rxsize bytes is overwritten and counted in overruns.
+ * - TX: scatter list of buffers is sent by chained requests of tx_chan without gaps
+ *   between them, buffers must not change until the callback of the last request.
+ * - stdio: with NUCLEI_UART_DMA=1, _write and _read of newlib stubs go through a dmaq_uart
+ *   on SOC_DEBUG_UART, set up at first use, see dmaq_uart.c for the DMA channel macros.
+ *
+ * tx_chan and rx_chan must be initialized by dmaq_chan_init() with the DMA requests of the
+ * USART, and the USART must be initialized for baudrate and frame format.
+ */
+/* max number of dmaq_uart */
+#ifndef DMAQ_UART_MAX
+#define DMAQ_UART_MAX               4
+#endif
+
+struct dmaq_uart;
+/* received data callback, called in interrupt, idle is 1 when the line is idle after data */
+typedef void (*dmaq_uart_rx_cb_t)(struct dmaq_uart *uart, const uint8_t *data, uint32_t len,
+                                  uint32_t idle, void *arg);
+
+/* one buffer of scatter list */
+typedef struct dmaq_uart_sg {
+    const void *buf;
+    uint32_t len;
+} dmaq_uart_sg_t;
+
+typedef struct dmaq_uart {
+    uint32_t periph;                /* USARTx */
+    IRQn_Type irqn;                 /* interrupt of USARTx for idle line */
+    uint32_t tx_chan;               /* dmaq channel of transmission */
+    uint32_t rx_chan;               /* dmaq channel of reception */
+    uint8_t *rxbuf;                 /* ring buffer of reception */
+    uint32_t rxsize;                /* size of rxbuf, even */
+    dmaq_uart_rx_cb_t rx_cb;        /* can be NULL */
+    void *arg;
+    /* private */
+    dmaq_stream_t rxstream;
+    uint32_t rxpos;                 /* position of ring handed off */
+    volatile uint32_t rxhead;       /* bytes received */
+    volatile uint32_t rxtail;       /* bytes consumed */
+    uint32_t overruns;              /* bytes lost as not consumed in time */
+} dmaq_uart_t;
+
+/* Start reception and install USART interrupt at level lvl, return 0 on success, -1 on error */
+int32_t dmaq_uart_init(dmaq_uart_t *uart, uint8_t lvl);
+
+/*
+ * Send cnt buffers of sg by DMA using reqs[cnt], cb is called with reqs[cnt - 1] after
+ * all is sent, return 0 on success, -1 on error
+ */
+int32_t dmaq_uart_write_sg(dmaq_uart_t *uart, dmaq_req_t *reqs, const dmaq_uart_sg_t *sg,
+                           uint32_t cnt, dmaq_cb_t cb, void *arg);
+
+/* Get received data in place, return the contiguous length at *data, 0 if none */
+uint32_t dmaq_uart_rx_peek(dmaq_uart_t *uart, const uint8_t **data);
+
+/* Consume len bytes got by dmaq_uart_rx_peek() */
+void dmaq_uart_rx_consume(dmaq_uart_t *uart, uint32_t len);
+
+/* Copy received data up to len bytes to buf, return bytes copied, it doesn't block */
+uint32_t dmaq_uart_read(dmaq_uart_t *uart, void *buf, uint32_t len);
+
+/*
+ * SPI transactions over dmaq
+ *
+ * Each transaction is full duplex on tx_chan and rx_chan, with its own clock mode, prescaler,
+ * frame width and chip select. Transactions are queued, the finish interrupt of the later of
+ * its two requests ends one, releases its chip select, reprograms the SPI and starts the next
+ * one before calling the callback, so queued transactions run back to back without the caller.
+ *
+ * The SPI must be initialized as master with software NSS by spi_init(), tx_chan and rx_chan
+ * initialized by dmaq_chan_init() with the DMA requests of the SPI, on gd32vf103 SPI0 is DMA0
+ * channel 2 for TX and channel 1 for RX, SPI1 is DMA0 channel 4 for TX and channel 3 for RX.
+ * The chip select GPIO is active low and configured as output by caller.
+ */
+struct dmaq_spi_xfer;
+/* completion callback of transaction, called in interrupt */
+typedef void (*dmaq_spi_cb_t)(struct dmaq_spi_xfer *xfer, void *arg);
+
+/* SPI transaction, owned by caller until completed */
+typedef struct dmaq_spi_xfer {
+    struct dmaq_spi_xfer *next;
+    const void *tx;                 /* data to send, NULL to send 0xFF */
+    void *rx;                       /* buffer of received data, NULL to discard */
+    uint32_t len;                   /* number of frames, 1 ~ 65535 */
+    uint32_t mode;                  /* SPI_CK_PL_* clock polarity and phase */
+    uint32_t psc;                   /* SPI_PSC_* clock prescaler */
+    uint8_t width;                  /* frame width in bytes, 1 or 2 */
+    uint8_t cs_keep;                /* 1 to keep chip select asserted for the next transaction */
+    uint32_t cs_port;               /* GPIO port of chip select, 0 for none */
+    uint32_t cs_pin;                /* GPIO pin of chip select */
+    dmaq_spi_cb_t cb;               /* completion callback, can be NULL */
+    void *arg;
+    volatile int32_t status;        /* DMAQ_PENDING when queued, DMAQ_DONE or DMAQ_ERROR */
+} dmaq_spi_xfer_t;
+
+typedef struct dmaq_spi {
+    uint32_t periph;                /* SPIx, ignored on gd32vw55x which has one SPI */
+    uint32_t tx_chan;               /* dmaq channel of transmission */
+    uint32_t rx_chan;               /* dmaq channel of reception */
+    /* private */
+    dmaq_spi_xfer_t *head;          /* running transaction */
+    dmaq_spi_xfer_t *tail;
+    dmaq_req_t txreq;
+    dmaq_req_t rxreq;
+    uint16_t txdummy;
+    uint16_t rxdummy;
+    uint32_t parts;                 /* requests of running transaction not completed */
+} dmaq_spi_t;
+
+/* Enable DMA requests of SPI, return 0 on success, -1 on error */
+int32_t dmaq_spi_init(dmaq_spi_t *spi);
+
+/* Queue xfer, return 0 on success, -1 on invalid argument */
+int32_t dmaq_spi_submit(dmaq_spi_t *spi, dmaq_spi_xfer_t *xfer);
+
+/* Sleep until xfer completes in bare-metal, return status of xfer */
+int32_t dmaq_spi_wait(dmaq_spi_xfer_t *xfer);
+
+/*
+ * I2C transactions over dmaq
+ *
+ * Each transaction writes wr then reads rd from a 7-bit address, with a repeated START
+ * between both parts, so a register read is one transaction. Data bytes are moved by DMA on
+ * tx_chan and rx_chan, START, address, direction change and STOP are driven by the I2C event
+ * and error interrupts, which end one transaction and start the next one before calling the
+ * callback, so queued transactions run back to back without the caller. A NACK, bus error
+ * or lost arbitration ends the transaction with DMAQ_ERROR and the queue goes on.
+ *
+ * The I2C must be initialized as master for clock and enabled by caller, tx_chan and rx_chan
+ * initialized by dmaq_chan_init() with the DMA requests of the I2C, on gd32vf103 I2C0 is DMA0
+ * channel 5 for TX and channel 6 for RX, I2C1 is DMA0 channel 3 for TX and channel 4 for RX.
+ * gd32vw55x transfers at most 255 bytes in each direction, as reload mode is not used.
+ */
+#if defined(GD32VW55x_H)
+#define DMAQ_I2C_MAX_LEN            255
+#else
+#define DMAQ_I2C_MAX_LEN            0xFFFF
+#endif
+
+struct dmaq_i2c_xfer;
+/* completion callback of transaction, called in interrupt */
+typedef void (*dmaq_i2c_cb_t)(struct dmaq_i2c_xfer *xfer, void *arg);
+
+/* I2C transaction, owned by caller until completed */
+typedef struct dmaq_i2c_xfer {
+    struct dmaq_i2c_xfer *next;
+    uint8_t addr;                   /* 7-bit slave address */
+    const void *wr;                 /* data to write, can be NULL if wrlen is 0 */
+    uint32_t wrlen;                 /* bytes to write, 0 ~ DMAQ_I2C_MAX_LEN */
+    void *rd;                       /* buffer of data read, can be NULL if rdlen is 0 */
+    uint32_t rdlen;                 /* bytes to read, 0 ~ DMAQ_I2C_MAX_LEN */
+    dmaq_i2c_cb_t cb;               /* completion callback, can be NULL */
+    void *arg;
+    volatile int32_t status;        /* DMAQ_PENDING when queued, DMAQ_DONE or DMAQ_ERROR */
+} dmaq_i2c_xfer_t;
+
+typedef struct dmaq_i2c {
+    uint32_t periph;                /* I2C0 or I2C1 */
+    uint32_t tx_chan;               /* dmaq channel of transmission */
+    uint32_t rx_chan;               /* dmaq channel of reception */
+    /* private */
+    dmaq_i2c_xfer_t *head;          /* running transaction */
+    dmaq_i2c_xfer_t *tail;
+    dmaq_req_t txreq;
+    dmaq_req_t rxreq;
+    uint32_t phase;                 /* part of running transaction on the bus */
+    uint32_t parts;                 /* bus and requests of running transaction not completed */
+    uint32_t err;                   /* running transaction failed */
+} dmaq_i2c_t;
+
+/* Enable DMA and interrupts of I2C, install its interrupts at level lvl, return 0 on success */
+int32_t dmaq_i2c_init(dmaq_i2c_t *i2c, uint8_t lvl);
+
+/* Queue xfer, return 0 on success, -1 on invalid argument */
+int32_t dmaq_i2c_submit(dmaq_i2c_t *i2c, dmaq_i2c_xfer_t *xfer);
+
+/* Sleep until xfer completes in bare-metal, return status of xfer */
+int32_t dmaq_i2c_wait(dmaq_i2c_xfer_t *xfer);
+
+/*
+ * Timer PWM update and input capture over dmaq
+ *
+ * - PWM: at each update event the timer DMA burst writes nch values of table to CHxCV from
+ *   channel first on, through TIMER_DMATB, so the duty of each period comes from the table
+ *   without an interrupt per period. Without loop the table is played once and cb is called
+ *   at its end, as for a LED strip frame, with loop it is played again and again as a stream
+ *   over its two halves, cb is called with the half just played, which can be refilled
+ *   while the other one plays, as for motor control.
+ * - Capture: each capture of channel writes CHxCV by DMA into the two halves of buf, cb is
+ *   called with the half just filled while DMA fills the other one, so timestamps of edges
+ *   are collected without an interrupt per edge.
+ *
+ * The timer time base, PWM output or input capture channels are configured by caller, for
+ * PWM with CHxCV shadow enabled so values written in a period take effect at the next one.
+ * chan is initialized by dmaq_chan_init() with the update DMA request of the timer for PWM
+ * and with the channel DMA request for capture, as TIMER0 on gd32vf103 is DMA0 channel 4
+ * for update and channel 1, 2, 5 and 3 for CH0 ~ CH3. The timer counter is enabled at start.
+ */
+struct dmaq_pwm;
+/* PWM callback, half is the half of table just played, always 0 without loop */
+typedef void (*dmaq_pwm_cb_t)(struct dmaq_pwm *pwm, uint32_t half, void *arg);
+
+typedef struct dmaq_pwm {
+    uint32_t periph;                /* TIMERx */
+    uint32_t chan;                  /* dmaq channel of update DMA request of TIMERx */
+    uint8_t first;                  /* first channel written, TIMER_CH_0 ~ TIMER_CH_3 */
+    uint8_t nch;                    /* channels written per period, 1 ~ 4 - first */
+    uint8_t loop;                   /* 1 to repeat table */
+    const uint16_t *table;          /* nch values per period */
+    uint32_t periods;               /* periods of table, even with loop */
+    dmaq_pwm_cb_t cb;               /* can be NULL */
+    void *arg;
+    /* private */
+    dmaq_req_t req;
+    dmaq_stream_t stream;
+} dmaq_pwm_t;
+
+struct dmaq_capture;
+/* capture callback of one half of buf, called in interrupt */
+typedef void (*dmaq_capture_cb_t)(struct dmaq_capture *cap, void *stamps, uint32_t count, void *arg);
+
+typedef struct dmaq_capture {
+    uint32_t periph;                /* TIMERx */
+    uint32_t chan;                  /* dmaq channel of channel DMA request of TIMERx */
+    uint16_t channel;               /* TIMER_CH_0 ~ TIMER_CH_3 */
+    uint8_t width;                  /* bytes of captured value, 2, or 4 for a 32-bit timer */
+    void *buf;                      /* 2 * count values */
+    uint32_t count;                 /* values of one half */
+    dmaq_capture_cb_t cb;
+    void *arg;
+    /* private */
+    dmaq_stream_t stream;
+} dmaq_capture_t;
+
+/* Start PWM update, return 0 on success, -1 on error */
+int32_t dmaq_pwm_start(dmaq_pwm_t *pwm);
+
+/* Stop PWM update, the output keeps the last values and the counter keeps running */
+void dmaq_pwm_stop(dmaq_pwm_t *pwm);
+
+/* Start capture, return 0 on success, -1 on error */
+int32_t dmaq_capture_start(dmaq_capture_t *cap);
+
+/* Stop capture */
+void dmaq_capture_stop(dmaq_capture_t *cap);
+
+/* Return values captured in current cycle of buf, 0 ~ 2 * count - 1 */
+uint32_t dmaq_capture_position(dmaq_capture_t *cap);
+
+/*
+ * GPIO waveform over dmaq
+ *
+ * At each update event of the timer DMA writes the next GPIO_BOP value of table to the GPIO
+ * port, so the pins of the port set in it change together at the timer rate, and a waveform,
+ * as a parallel bus write or a bit-banged protocol, is replayed without the CPU. Values are
+ * made by GPIO_BOP_VALUE() and GPIO_BUS_BOP(), dmaq_wave_bus() makes them for a parallel bus
+ * with a write strobe. Without loop the table is played once and cb is called at its end, with
+ * loop it is played again and again as a stream over its two halves, cb is called with the
+ * half just played, which can be refilled while the other one plays.
+ *
+ * The timer time base is configured by caller, one update event per step, chan is initialized
+ * by dmaq_chan_init() with the update DMA request of the timer, as TIMER0 on gd32vf103 is DMA0
+ * channel 4 and TIMER1 is DMA0 channel 1. The pins are configured as output by caller, and
+ * the timer counter is enabled at start.
+ */
+struct dmaq_wave;
+/* waveform callback, half is the half of table just played, always 0 without loop */
+typedef void (*dmaq_wave_cb_t)(struct dmaq_wave *wave, uint32_t half, void *arg);
+
+typedef struct dmaq_wave {
+    uint32_t periph;                /* TIMERx pacing the steps */
+    uint32_t chan;                  /* dmaq channel of update DMA request of TIMERx */
+    uint32_t port;                  /* GPIOx written */
+    uint8_t loop;                   /* 1 to repeat table */
+    const uint32_t *table;          /* GPIO_BOP value of each step */
+    uint32_t steps;                 /* steps of table, 1 ~ 65535, even with loop */
+    dmaq_wave_cb_t cb;              /* can be NULL */
+    void *arg;
+    /* private */
+    dmaq_req_t req;
+    dmaq_stream_t stream;
+} dmaq_wave_t;
+
+/* Start waveform, return 0 on success, -1 on error */
+int32_t dmaq_wave_start(dmaq_wave_t *wave);
+
+/* Stop waveform, the pins keep the last step and the counter keeps running */
+void dmaq_wave_stop(dmaq_wave_t *wave);
+
+/* Return steps played in current cycle of table with loop, 0 ~ steps - 1, 0 without loop */
+uint32_t dmaq_wave_position(dmaq_wave_t *wave);
+
+/*
+ * Make steps into table writing len data of width bits to the pins from pin offset on, each
+ * data takes two steps, the first one puts data on the bus and drives wr_pin low, the second
+ * one drives wr_pin high, on which the device latches data. Return steps made, 2 * len, or 0
+ * if wr_pin is one of the bus pins, the bus is out of the port or len is over 32767
+ */
+uint32_t dmaq_wave_bus(uint32_t *table, const uint16_t *data, uint32_t len, uint32_t offset,
+                       uint32_t width, uint32_t wr_pin);
+
+#if defined(__GD32VF103_H__)
+/*
+ * ADC acquisition over dmaq, gd32vf103 only
+ *
+ * Regular group conversions, triggered by a timer event or run continuously, are written by
+ * a dmaq stream into the two halves of buf, each finished half is handed off while DMA fills
+ * the other one, so capture has no gap. With proc the half is processed in the DMA interrupt,
+ * for example by NMSIS DSP FIR or FFT functions, without proc it is taken by dmaq_adc_get()
+ * and given back by dmaq_adc_release(). A half not processed or released before DMA comes
+ * back to it is counted in overruns.
+ *
+ * The ADC regular group, sample time, alignment and resolution are configured by caller,
+ * with ADC_DATAALIGN_LEFT and q15 set samples are converted in place to signed q15. chan is
+ * initialized by dmaq_chan_init() with the DMA request of ADC0, DMA0 channel 0. A timer
+ * trigger must be configured by caller to give the event of trigger.
+ */
+struct dmaq_adc;
+/* processing callback of one half of buf, called in interrupt */
+typedef void (*dmaq_adc_proc_t)(struct dmaq_adc *adc, void *samples, uint32_t count, void *arg);
+
+typedef struct dmaq_adc {
+    uint32_t periph;                /* ADC0, or ADC0 as master of ADC0/ADC1 sync modes */
+    uint32_t chan;                  /* dmaq channel of ADC0 */
+    uint32_t trigger;               /* ADC0_1_EXTTRIG_REGULAR_*, _NONE for continuous conversion */
+    uint32_t timer;                 /* TIMERx enabled at start and disabled at stop, 0 for none */
+    void *buf;                      /* 2 * count samples */
+    uint32_t count;                 /* samples of one half, 2 * count <= 65535 */
+    uint8_t width;                  /* bytes of sample, 2, or 4 for both ADC0 and ADC1 data */
+    uint8_t q15;                    /* 1 to convert left aligned samples of width 2 to q15 */
+    dmaq_adc_proc_t proc;           /* can be NULL */
+    void *arg;
+    /* private */
+    dmaq_stream_t stream;
+    volatile uint8_t ready[2];      /* half finished and not released */
+    uint32_t overruns;              /* halves lost as not processed in time */
+} dmaq_adc_t;
+
+/* Start acquisition, return 0 on success, -1 on error */
+int32_t dmaq_adc_start(dmaq_adc_t *adc);
+
+/* Stop acquisition */
+void dmaq_adc_stop(dmaq_adc_t *adc);
+
+/* Get the finished half without proc, return number of samples at *samples, 0 if none */
+uint32_t dmaq_adc_get(dmaq_adc_t *adc, void **samples);
+
+/* Give back the half got by dmaq_adc_get() */
+void dmaq_adc_release(dmaq_adc_t *adc);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _DMAQ_API_H_ */
@@ -0,0 +1,95 @@
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "dmaq_api.h"
+
+static void dmaq_wave_req_done(dmaq_req_t *req, void *arg)
+{
+    dmaq_wave_t *wave = (dmaq_wave_t *)arg;
+
+    timer_dma_disable(wave->periph, TIMER_DMA_UPD);
+    if (wave->cb != NULL) {
+        wave->cb(wave, 0, wave->arg);
+    }
+}
+
+static void dmaq_wave_stream_cb(dmaq_stream_t *stream, uint32_t buf, void *arg)
+{
+    dmaq_wave_t *wave = (dmaq_wave_t *)arg;
+
+    if (wave->cb != NULL) {
+        wave->cb(wave, buf, wave->arg);
+    }
+}
+
+int32_t dmaq_wave_start(dmaq_wave_t *wave)
+{
+    dmaq_stream_t *stream = &wave->stream;
+    dmaq_req_t *req = &wave->req;
+    int32_t ret;
+
+    if ((wave->table == NULL) || (wave->steps == 0) || (wave->steps > 0xFFFF) ||
+        ((wave->loop != 0) && ((wave->steps & 1) != 0))) {
+        return -1;
+    }
+    // each update event writes one GPIO_BOP value, set and reset pins of the port in one store
+    if (wave->loop != 0) {
+        stream->periph_addr = (uint32_t)(unsigned long)&GPIO_BOP(wave->port);
+        stream->buf[0] = (void *)wave->table;
+        stream->buf[1] = (void *)(wave->table + wave->steps / 2);
+        stream->count = wave->steps / 2;
+        stream->dir = DMAQ_DIR_M2P;
+        stream->width = 4;
+        stream->cb = dmaq_wave_stream_cb;
+        stream->arg = wave;
+        ret = dmaq_stream_start(wave->chan, stream);
+    } else {
+        req->periph_addr = (uint32_t)(unsigned long)&GPIO_BOP(wave->port);
+        req->mem = (void *)wave->table;
+        req->count = wave->steps;
+        req->dir = DMAQ_DIR_M2P;
+        req->width = 4;
+        req->periph_inc = 0;
+        req->mem_inc = 1;
+        req->cb = dmaq_wave_req_done;
+        req->arg = wave;
+        ret = dmaq_submit(wave->chan, req);
+    }
+    if (ret != 0) {
+        return -1;
+    }
+    timer_dma_enable(wave->periph, TIMER_DMA_UPD);
+    timer_enable(wave->periph);
+    return 0;
+}
+
+void dmaq_wave_stop(dmaq_wave_t *wave)
+{
+    timer_dma_disable(wave->periph, TIMER_DMA_UPD);
+    if (wave->loop != 0) {
+        dmaq_stream_stop(wave->chan);
+    } else {
+        dmaq_cancel(wave->chan, &wave->req);
+    }
+}
+
+uint32_t dmaq_wave_position(dmaq_wave_t *wave)
+{
+    return (wave->loop != 0) ? dmaq_stream_position(wave->chan) : 0;
+}
+
+uint32_t dmaq_wave_bus(uint32_t *table, const uint16_t *data, uint32_t len, uint32_t offset,
+                       uint32_t width, uint32_t wr_pin)
+{
+    uint32_t i;
+
+    if ((width == 0) || (offset + width > 16) || ((GPIO_BUS_MASK(offset, width) & wr_pin) != 0) ||
+        (len > 0xFFFF / 2)) {
+        return 0;
+    }
+    for (i = 0; i < len; i++) {
+        // data and the falling edge of strobe in one store, so data is settled at the rising edge
+        table[2 * i] = GPIO_BUS_BOP(data[i], offset, width) | GPIO_BOP_VALUE(0, wr_pin);
+        table[2 * i + 1] = GPIO_BOP_VALUE(wr_pin, 0);
+    }
+    return 2 * len;
+}
@@ -0,0 +1,360 @@
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "dmaq_api.h"
+
+/* part of running transaction on the bus */
+#define DMAQ_I2C_PHASE_WRITE        0
+#define DMAQ_I2C_PHASE_READ         1
+#define DMAQ_I2C_PHASE_END          2
+
+#if defined(GD32VW55x_H)
+#define DMAQ_I2C_TDATA(periph)      ((uint32_t)(unsigned long)&I2C_TDATA(periph))
+#define DMAQ_I2C_RDATA(periph)      ((uint32_t)(unsigned long)&I2C_RDATA(periph))
+#define DMAQ_I2C_ERRORS             (I2C_STAT_BERR | I2C_STAT_LOSTARB | I2C_STAT_OUERR | I2C_STAT_PECERR | I2C_STAT_TIMEOUT)
+#else
+#define DMAQ_I2C_TDATA(periph)      ((uint32_t)(unsigned long)&I2C_DATA(periph))
+#define DMAQ_I2C_RDATA(periph)      ((uint32_t)(unsigned long)&I2C_DATA(periph))
+#define DMAQ_I2C_ERRORS             (I2C_STAT0_BERR | I2C_STAT0_LOSTARB | I2C_STAT0_AERR | I2C_STAT0_OUERR)
+#endif
+
+static dmaq_i2c_t *dmaq_i2cs[2];
+
+static void dmaq_i2c_start(dmaq_i2c_t *i2c, dmaq_i2c_xfer_t *xfer);
+static void dmaq_i2c_req_done(dmaq_req_t *req, void *arg);
+
+static void dmaq_i2c_req_init(dmaq_i2c_t *i2c, dmaq_req_t *req, uint32_t periph_addr, void *mem,
+                              uint32_t count, uint8_t dir)
+{
+    req->periph_addr = periph_addr;
+    req->mem = mem;
+    req->count = count;
+    req->dir = dir;
+    req->width = 1;
+    req->periph_inc = 0;
+    req->mem_inc = 1;
+    req->cb = dmaq_i2c_req_done;
+    req->arg = i2c;
+}
+
+/*
+ * n parts of running transaction completed, with interrupts disabled, end it when the bus
+ * and both requests are done and start the next one, return the ended one or NULL
+ */
+static dmaq_i2c_xfer_t *dmaq_i2c_done(dmaq_i2c_t *i2c, uint32_t n)
+{
+    dmaq_i2c_xfer_t *xfer = i2c->head;
+
+    if ((xfer == NULL) || (i2c->parts == 0)) {
+        return NULL;
+    }
+    i2c->parts = (n < i2c->parts) ? (i2c->parts - n) : 0;
+    if (i2c->parts != 0) {
+        return NULL;
+    }
+    xfer->status = (i2c->err == 0) ? DMAQ_DONE : DMAQ_ERROR;
+    i2c->head = xfer->next;
+    if (i2c->head != NULL) {
+        dmaq_i2c_start(i2c, i2c->head);
+    } else {
+        i2c->tail = NULL;
+    }
+    return xfer;
+}
+
+/* bus part ended by an error, requests which will not complete are removed */
+static dmaq_i2c_xfer_t *dmaq_i2c_abort(dmaq_i2c_t *i2c)
+{
+    uint32_t n = 1;
+
+    i2c->err = 1;
+    i2c->phase = DMAQ_I2C_PHASE_END;
+    if (dmaq_cancel(i2c->tx_chan, &i2c->txreq) == 0) {
+        n++;
+    }
+    if (dmaq_cancel(i2c->rx_chan, &i2c->rxreq) == 0) {
+        n++;
+    }
+    return dmaq_i2c_done(i2c, n);
+}
+
+static void dmaq_i2c_end(dmaq_i2c_xfer_t *xfer)
+{
+    if ((xfer != NULL) && (xfer->cb != NULL)) {
+        xfer->cb(xfer, xfer->arg);
+    }
+}
+
+#if defined(GD32VW55x_H)
+/*
+ * gd32vw55x: the I2C counts bytes itself, each part is one START with BYTENUM bytes, the
+ * write part stops at TC for the repeated START of read, the last part ends by AUTOEND STOP
+ */
+static void dmaq_i2c_read(dmaq_i2c_t *i2c, dmaq_i2c_xfer_t *xfer)
+{
+    i2c->phase = DMAQ_I2C_PHASE_READ;
+    dmaq_i2c_req_init(i2c, &i2c->rxreq, DMAQ_I2C_RDATA(i2c->periph), xfer->rd, xfer->rdlen, DMAQ_DIR_P2M);
+    i2c->parts++;
+    dmaq_submit(i2c->rx_chan, &i2c->rxreq);
+    I2C_CTL1(i2c->periph) = ((uint32_t)xfer->addr << 1) | I2C_CTL1_TRDIR | (xfer->rdlen << 16) |
+                            I2C_CTL1_AUTOEND | I2C_CTL1_START;
+}
+
+static void dmaq_i2c_start(dmaq_i2c_t *i2c, dmaq_i2c_xfer_t *xfer)
+{
+    i2c->err = 0;
+    i2c->parts = 1;
+    I2C_STATC(i2c->periph) = I2C_STATC_NACKC | I2C_STATC_STPDETC | DMAQ_I2C_ERRORS;
+    if (xfer->wrlen == 0) {
+        dmaq_i2c_read(i2c, xfer);
+        return;
+    }
+    // flush a byte left in TDATA by a NACKed write
+    I2C_STAT(i2c->periph) |= I2C_STAT_TBE;
+    i2c->phase = DMAQ_I2C_PHASE_WRITE;
+    dmaq_i2c_req_init(i2c, &i2c->txreq, DMAQ_I2C_TDATA(i2c->periph), (void *)xfer->wr, xfer->wrlen, DMAQ_DIR_M2P);
+    i2c->parts++;
+    dmaq_submit(i2c->tx_chan, &i2c->txreq);
+    I2C_CTL1(i2c->periph) = ((uint32_t)xfer->addr << 1) | (xfer->wrlen << 16) |
+                            ((xfer->rdlen == 0) ? I2C_CTL1_AUTOEND : 0) | I2C_CTL1_START;
+}
+
+static void dmaq_i2c_irq(uint32_t idx)
+{
+    dmaq_i2c_t *i2c = dmaq_i2cs[idx];
+    dmaq_i2c_xfer_t *xfer = NULL;
+    rv_csr_t mstatus;
+    uint32_t stat;
+
+    if (i2c == NULL) {
+        return;
+    }
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    stat = I2C_STAT(i2c->periph);
+    if ((stat & DMAQ_I2C_ERRORS) != 0) {
+        // no STOP follows a bus error or lost arbitration, the bus is released
+        I2C_STATC(i2c->periph) = stat & DMAQ_I2C_ERRORS;
+        if (i2c->head != NULL) {
+            xfer = dmaq_i2c_abort(i2c);
+        }
+    } else if ((stat & I2C_STAT_NACK) != 0) {
+        I2C_STATC(i2c->periph) = I2C_STATC_NACKC;
+        i2c->err = 1;
+        if ((I2C_CTL1(i2c->periph) & I2C_CTL1_AUTOEND) == 0) {
+            I2C_CTL1(i2c->periph) |= I2C_CTL1_STOP;
+        }
+    } else if ((stat & I2C_STAT_STPDET) != 0) {
+        I2C_STATC(i2c->periph) = I2C_STATC_STPDETC;
+        if (i2c->head != NULL) {
+            xfer = (i2c->err != 0) ? dmaq_i2c_abort(i2c) : dmaq_i2c_done(i2c, 1);
+        }
+    } else if (((stat & I2C_STAT_TC) != 0) && (i2c->head != NULL) && (i2c->phase == DMAQ_I2C_PHASE_WRITE)) {
+        // write part done, TC is cleared by repeated START
+        dmaq_i2c_read(i2c, i2c->head);
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    dmaq_i2c_end(xfer);
+}
+
+/* requests complete on the data bytes, the bus part ends at the STOP */
+static void dmaq_i2c_req_done(dmaq_req_t *req, void *arg)
+{
+    dmaq_i2c_t *i2c = (dmaq_i2c_t *)arg;
+    dmaq_i2c_xfer_t *xfer;
+    rv_csr_t mstatus;
+
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    xfer = dmaq_i2c_done(i2c, 1);
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    dmaq_i2c_end(xfer);
+}
+
+static void dmaq_i2c_hw_init(dmaq_i2c_t *i2c)
+{
+    I2C_CTL0(i2c->periph) |= I2C_CTL0_DENT | I2C_CTL0_DENR | I2C_CTL0_NACKIE | I2C_CTL0_STPDETIE |
+                             I2C_CTL0_TCIE | I2C_CTL0_ERRIE;
+}
+#else
+/*
+ * gd32vf103: START, address and direction change are events of the I2C, TX ends at BTC after
+ * the last byte from DMA, RX of two bytes or more NACKs the last byte by DMALST and STOPs at
+ * the RX request finish, RX of one byte NACKs and STOPs before it is received, as DMA is late
+ */
+static void dmaq_i2c_start(dmaq_i2c_t *i2c, dmaq_i2c_xfer_t *xfer)
+{
+    i2c->err = 0;
+    i2c->parts = 1;
+    i2c->phase = (xfer->wrlen != 0) ? DMAQ_I2C_PHASE_WRITE : DMAQ_I2C_PHASE_READ;
+    // START set while STOP of previous transaction is pending is lost, STOP takes a few us
+    while ((I2C_CTL0(i2c->periph) & I2C_CTL0_STOP) != 0) {
+    }
+    I2C_CTL1(i2c->periph) = (I2C_CTL1(i2c->periph) & ~(I2C_CTL1_DMAON | I2C_CTL1_DMALST | I2C_CTL1_BUFIE)) |
+                            I2C_CTL1_EVIE;
+    I2C_CTL0(i2c->periph) |= I2C_CTL0_ACKEN | I2C_CTL0_START;
+}
+
+static void dmaq_i2c_irq(uint32_t idx)
+{
+    dmaq_i2c_t *i2c = dmaq_i2cs[idx];
+    dmaq_i2c_xfer_t *xfer;
+    dmaq_i2c_xfer_t *ended = NULL;
+    rv_csr_t mstatus;
+    uint32_t stat;
+
+    if (i2c == NULL) {
+        return;
+    }
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    xfer = i2c->head;
+    stat = I2C_STAT0(i2c->periph);
+    if ((stat & DMAQ_I2C_ERRORS) != 0) {
+        // error flags are cleared by writing 0, a NACK needs STOP, the bus is released on others
+        I2C_STAT0(i2c->periph) = ~(stat & DMAQ_I2C_ERRORS) & 0xFFFF;
+        I2C_CTL1(i2c->periph) &= ~(I2C_CTL1_DMAON | I2C_CTL1_DMALST | I2C_CTL1_BUFIE | I2C_CTL1_EVIE);
+        if ((stat & I2C_STAT0_AERR) != 0) {
+            I2C_CTL0(i2c->periph) |= I2C_CTL0_STOP;
+        }
+        if (xfer != NULL) {
+            ended = dmaq_i2c_abort(i2c);
+        }
+    } else if ((xfer == NULL) || (i2c->phase == DMAQ_I2C_PHASE_END)) {
+        I2C_CTL1(i2c->periph) &= ~(I2C_CTL1_BUFIE | I2C_CTL1_EVIE);
+    } else if ((stat & I2C_STAT0_SBSEND) != 0) {
+        // SBSEND is cleared by writing the address after reading STAT0
+        if ((i2c->phase == DMAQ_I2C_PHASE_READ) && (xfer->rdlen >= 2)) {
+            dmaq_i2c_req_init(i2c, &i2c->rxreq, DMAQ_I2C_RDATA(i2c->periph), xfer->rd, xfer->rdlen, DMAQ_DIR_P2M);
+            i2c->parts++;
+            dmaq_submit(i2c->rx_chan, &i2c->rxreq);
+            I2C_CTL1(i2c->periph) |= I2C_CTL1_DMAON | I2C_CTL1_DMALST;
+        }
+        I2C_DATA(i2c->periph) = ((uint32_t)xfer->addr << 1) | ((i2c->phase == DMAQ_I2C_PHASE_READ) ? 1 : 0);
+    } else if ((stat & I2C_STAT0_ADDSEND) != 0) {
+        if (i2c->phase == DMAQ_I2C_PHASE_WRITE) {
+            dmaq_i2c_req_init(i2c, &i2c->txreq, DMAQ_I2C_TDATA(i2c->periph), (void *)xfer->wr, xfer->wrlen, DMAQ_DIR_M2P);
+            i2c->parts++;
+            dmaq_submit(i2c->tx_chan, &i2c->txreq);
+            I2C_CTL1(i2c->periph) |= I2C_CTL1_DMAON;
+        } else if (xfer->rdlen == 1) {
+            I2C_CTL0(i2c->periph) &= ~I2C_CTL0_ACKEN;
+        } else {
+            // RX request finish ends the read, no event till then
+            I2C_CTL1(i2c->periph) &= ~I2C_CTL1_EVIE;
+        }
+        // ADDSEND is cleared by reading STAT1 after STAT0
+        (void)I2C_STAT1(i2c->periph);
+        if ((i2c->phase == DMAQ_I2C_PHASE_READ) && (xfer->rdlen == 1)) {
+            I2C_CTL0(i2c->periph) |= I2C_CTL0_STOP;
+            I2C_CTL1(i2c->periph) |= I2C_CTL1_BUFIE;
+        }
+    } else if ((i2c->phase == DMAQ_I2C_PHASE_WRITE) && ((stat & I2C_STAT0_BTC) != 0)) {
+        // BTC before the TX request finish is DMA late, the last byte is sent after it
+        if (i2c->txreq.status != DMAQ_PENDING) {
+            I2C_CTL1(i2c->periph) &= ~I2C_CTL1_DMAON;
+            if (xfer->rdlen != 0) {
+                i2c->phase = DMAQ_I2C_PHASE_READ;
+                I2C_CTL0(i2c->periph) |= I2C_CTL0_START;
+            } else {
+                i2c->phase = DMAQ_I2C_PHASE_END;
+                I2C_CTL0(i2c->periph) |= I2C_CTL0_STOP;
+                I2C_CTL1(i2c->periph) &= ~I2C_CTL1_EVIE;
+                ended = dmaq_i2c_done(i2c, 1);
+            }
+        }
+    } else if ((i2c->phase == DMAQ_I2C_PHASE_READ) && ((stat & I2C_STAT0_RBNE) != 0) && (xfer->rdlen == 1)) {
+        *(uint8_t *)xfer->rd = (uint8_t)I2C_DATA(i2c->periph);
+        i2c->phase = DMAQ_I2C_PHASE_END;
+        I2C_CTL1(i2c->periph) &= ~(I2C_CTL1_BUFIE | I2C_CTL1_EVIE);
+        ended = dmaq_i2c_done(i2c, 1);
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    dmaq_i2c_end(ended);
+}
+
+/* TX request finishes before the last byte is sent, RX request finish after the last byte ends the read */
+static void dmaq_i2c_req_done(dmaq_req_t *req, void *arg)
+{
+    dmaq_i2c_t *i2c = (dmaq_i2c_t *)arg;
+    dmaq_i2c_xfer_t *xfer;
+    rv_csr_t mstatus;
+    uint32_t n = 1;
+
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if ((req == &i2c->rxreq) && (i2c->phase == DMAQ_I2C_PHASE_READ)) {
+        I2C_CTL0(i2c->periph) |= I2C_CTL0_STOP;
+        I2C_CTL1(i2c->periph) &= ~(I2C_CTL1_DMAON | I2C_CTL1_DMALST);
+        i2c->phase = DMAQ_I2C_PHASE_END;
+        n = 2;
+    }
+    xfer = dmaq_i2c_done(i2c, n);
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    dmaq_i2c_end(xfer);
+}
+
+static void dmaq_i2c_hw_init(dmaq_i2c_t *i2c)
+{
+    I2C_CTL1(i2c->periph) |= I2C_CTL1_ERRIE;
+}
+#endif
+
+#define DMAQ_I2C_IRQ_HANDLER(n)     static void dmaq_i2c_irq_handler##n(void) { dmaq_i2c_irq(n); }
+DMAQ_I2C_IRQ_HANDLER(0)
+DMAQ_I2C_IRQ_HANDLER(1)
+
+static void (*const dmaq_i2c_irq_handlers[2])(void) = {
+    dmaq_i2c_irq_handler0, dmaq_i2c_irq_handler1
+};
+
+int32_t dmaq_i2c_init(dmaq_i2c_t *i2c, uint8_t lvl)
+{
+    uint32_t idx;
+
+    if (i2c->periph == I2C0) {
+        idx = 0;
+    } else if (i2c->periph == I2C1) {
+        idx = 1;
+    } else {
+        return -1;
+    }
+    i2c->head = NULL;
+    i2c->tail = NULL;
+    i2c->phase = DMAQ_I2C_PHASE_END;
+    i2c->parts = 0;
+    i2c->err = 0;
+    dmaq_i2cs[idx] = i2c;
+    dmaq_i2c_hw_init(i2c);
+    // event and error interrupts share the state machine
+    if (ECLIC_Register_IRQ((idx == 0) ? I2C0_EV_IRQn : I2C1_EV_IRQn, ECLIC_NON_VECTOR_INTERRUPT,
+                           ECLIC_LEVEL_TRIGGER, lvl, 0, (void *)dmaq_i2c_irq_handlers[idx]) != 0) {
+        return -1;
+    }
+    return ECLIC_Register_IRQ((idx == 0) ? I2C0_ER_IRQn : I2C1_ER_IRQn, ECLIC_NON_VECTOR_INTERRUPT,
+                              ECLIC_LEVEL_TRIGGER, lvl, 0, (void *)dmaq_i2c_irq_handlers[idx]);
+}
+
+int32_t dmaq_i2c_submit(dmaq_i2c_t *i2c, dmaq_i2c_xfer_t *xfer)
+{
+    rv_csr_t mstatus;
+
+    if (((xfer->wrlen == 0) && (xfer->rdlen == 0)) || (xfer->wrlen > DMAQ_I2C_MAX_LEN) ||
+        (xfer->rdlen > DMAQ_I2C_MAX_LEN) || ((xfer->wrlen != 0) && (xfer->wr == NULL)) ||
+        ((xfer->rdlen != 0) && (xfer->rd == NULL)) || (xfer->addr > 0x7F)) {
+        return -1;
+    }
+    xfer->next = NULL;
+    xfer->status = DMAQ_PENDING;
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if (i2c->tail != NULL) {
+        i2c->tail->next = xfer;
+        i2c->tail = xfer;
+    } else {
+        i2c->head = xfer;
+        i2c->tail = xfer;
+        dmaq_i2c_start(i2c, xfer);
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return 0;
+}
+
+int32_t dmaq_i2c_wait(dmaq_i2c_xfer_t *xfer)
+{
+    return __wfi_while_pending(&xfer->status, DMAQ_PENDING);
+}
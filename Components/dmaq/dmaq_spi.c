@@ -0,0 +1,141 @@
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "dmaq_api.h"
+
+#if defined(GD32VW55x_H)
+#define DMAQ_SPI_CTL0(periph)       SPI_CTL0
+#define DMAQ_SPI_DATA(periph)       ((uint32_t)(unsigned long)&SPI_DATA)
+#define DMAQ_SPI_DMA_ENABLE(periph)                                 \
+    do {                                                            \
+        spi_dma_enable(SPI_DMA_RECEIVE);                            \
+        spi_dma_enable(SPI_DMA_TRANSMIT);                           \
+    } while (0)
+#else
+#define DMAQ_SPI_CTL0(periph)       SPI_CTL0(periph)
+#define DMAQ_SPI_DATA(periph)       ((uint32_t)(unsigned long)&SPI_DATA(periph))
+#define DMAQ_SPI_DMA_ENABLE(periph)                                 \
+    do {                                                            \
+        spi_dma_enable(periph, SPI_DMA_RECEIVE);                    \
+        spi_dma_enable(periph, SPI_DMA_TRANSMIT);                   \
+    } while (0)
+#endif
+
+#define DMAQ_SPI_CTL0_XFER_MASK     (SPI_CTL0_CKPL | SPI_CTL0_CKPH | SPI_CTL0_PSC | SPI_CTL0_FF16)
+
+static void dmaq_spi_req_done(dmaq_req_t *req, void *arg);
+
+/* program SPI for xfer and start both directions, the SPI is idle here */
+static void dmaq_spi_start(dmaq_spi_t *spi, dmaq_spi_xfer_t *xfer)
+{
+    uint32_t ctl = DMAQ_SPI_CTL0(spi->periph);
+    uint32_t val;
+
+    val = (ctl & ~(DMAQ_SPI_CTL0_XFER_MASK | SPI_CTL0_SPIEN)) | xfer->mode | xfer->psc |
+          ((xfer->width == 2) ? SPI_FRAMESIZE_16BIT : SPI_FRAMESIZE_8BIT);
+    if ((val | SPI_CTL0_SPIEN) != ctl) {
+        // format and clock are only changed with SPI disabled
+        DMAQ_SPI_CTL0(spi->periph) = ctl & ~SPI_CTL0_SPIEN;
+        DMAQ_SPI_CTL0(spi->periph) = val;
+        DMAQ_SPI_CTL0(spi->periph) = val | SPI_CTL0_SPIEN;
+    }
+    if (xfer->cs_port != 0) {
+        gpio_bit_reset(xfer->cs_port, xfer->cs_pin);
+    }
+
+    spi->rxreq.periph_addr = DMAQ_SPI_DATA(spi->periph);
+    spi->rxreq.mem = (xfer->rx != NULL) ? xfer->rx : (void *)&spi->rxdummy;
+    spi->rxreq.mem_inc = (xfer->rx != NULL) ? 1 : 0;
+    spi->rxreq.count = xfer->len;
+    spi->rxreq.dir = DMAQ_DIR_P2M;
+    spi->rxreq.width = xfer->width;
+    spi->rxreq.periph_inc = 0;
+    spi->rxreq.cb = dmaq_spi_req_done;
+    spi->rxreq.arg = spi;
+
+    spi->txreq.periph_addr = DMAQ_SPI_DATA(spi->periph);
+    spi->txreq.mem = (xfer->tx != NULL) ? (void *)xfer->tx : (void *)&spi->txdummy;
+    spi->txreq.mem_inc = (xfer->tx != NULL) ? 1 : 0;
+    spi->txreq.count = xfer->len;
+    spi->txreq.dir = DMAQ_DIR_M2P;
+    spi->txreq.width = xfer->width;
+    spi->txreq.periph_inc = 0;
+    spi->txreq.cb = dmaq_spi_req_done;
+    spi->txreq.arg = spi;
+
+    // reception first, so no frame is received before its DMA request is enabled
+    spi->parts = 2;
+    dmaq_submit(spi->rx_chan, &spi->rxreq);
+    dmaq_submit(spi->tx_chan, &spi->txreq);
+}
+
+/*
+ * Both requests completed, the last frame is received and the SPI is idle, end xfer and
+ * start the next one, requests are reused only after both left their channel queues
+ */
+static void dmaq_spi_req_done(dmaq_req_t *req, void *arg)
+{
+    dmaq_spi_t *spi = (dmaq_spi_t *)arg;
+    dmaq_spi_xfer_t *xfer;
+    rv_csr_t mstatus;
+
+    // TX and RX channel interrupts can nest at different levels
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    xfer = spi->head;
+    if ((xfer == NULL) || (--spi->parts != 0)) {
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+        return;
+    }
+    if ((xfer->cs_keep == 0) && (xfer->cs_port != 0)) {
+        gpio_bit_set(xfer->cs_port, xfer->cs_pin);
+    }
+    // before the requests are reused by the next one
+    xfer->status = ((spi->rxreq.status == DMAQ_DONE) && (spi->txreq.status == DMAQ_DONE)) ? DMAQ_DONE : DMAQ_ERROR;
+    spi->head = xfer->next;
+    if (spi->head != NULL) {
+        dmaq_spi_start(spi, spi->head);
+    } else {
+        spi->tail = NULL;
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    if (xfer->cb != NULL) {
+        xfer->cb(xfer, xfer->arg);
+    }
+}
+
+int32_t dmaq_spi_init(dmaq_spi_t *spi)
+{
+    spi->head = NULL;
+    spi->tail = NULL;
+    spi->txdummy = 0xFFFF;
+    spi->rxdummy = 0;
+    spi->parts = 0;
+    DMAQ_SPI_DMA_ENABLE(spi->periph);
+    return 0;
+}
+
+int32_t dmaq_spi_submit(dmaq_spi_t *spi, dmaq_spi_xfer_t *xfer)
+{
+    rv_csr_t mstatus;
+
+    if ((xfer->len == 0) || (xfer->len > 0xFFFF) || ((xfer->width != 1) && (xfer->width != 2))) {
+        return -1;
+    }
+    xfer->next = NULL;
+    xfer->status = DMAQ_PENDING;
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if (spi->tail != NULL) {
+        spi->tail->next = xfer;
+        spi->tail = xfer;
+    } else {
+        spi->head = xfer;
+        spi->tail = xfer;
+        dmaq_spi_start(spi, xfer);
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return 0;
+}
+
+int32_t dmaq_spi_wait(dmaq_spi_xfer_t *xfer)
+{
+    return __wfi_while_pending(&xfer->status, DMAQ_PENDING);
+}
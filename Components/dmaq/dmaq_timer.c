@@ -0,0 +1,125 @@
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "dmaq_api.h"
+
+/* DMACFG access start of CH0CV, CH1CV ~ CH3CV follow it */
+#define DMAQ_TIMER_DMATA_CH0CV      13
+
+static void dmaq_pwm_req_done(dmaq_req_t *req, void *arg)
+{
+    dmaq_pwm_t *pwm = (dmaq_pwm_t *)arg;
+
+    timer_dma_disable(pwm->periph, TIMER_DMA_UPD);
+    if (pwm->cb != NULL) {
+        pwm->cb(pwm, 0, pwm->arg);
+    }
+}
+
+static void dmaq_pwm_stream_cb(dmaq_stream_t *stream, uint32_t buf, void *arg)
+{
+    dmaq_pwm_t *pwm = (dmaq_pwm_t *)arg;
+
+    if (pwm->cb != NULL) {
+        pwm->cb(pwm, buf, pwm->arg);
+    }
+}
+
+int32_t dmaq_pwm_start(dmaq_pwm_t *pwm)
+{
+    uint32_t count = pwm->periods * pwm->nch;
+    dmaq_stream_t *stream = &pwm->stream;
+    dmaq_req_t *req = &pwm->req;
+    int32_t ret;
+
+    if ((pwm->table == NULL) || (pwm->nch == 0) || (pwm->first + pwm->nch > 4) || (count == 0) ||
+        (count > 0xFFFF) || ((pwm->loop != 0) && ((pwm->periods & 1) != 0))) {
+        return -1;
+    }
+    // each update event writes nch values to CHxCV from first on
+    timer_dma_transfer_config(pwm->periph, DMACFG_DMATA(DMAQ_TIMER_DMATA_CH0CV + pwm->first),
+                              DMACFG_DMATC(pwm->nch - 1));
+    if (pwm->loop != 0) {
+        stream->periph_addr = (uint32_t)(unsigned long)&TIMER_DMATB(pwm->periph);
+        stream->buf[0] = (void *)pwm->table;
+        stream->buf[1] = (void *)(pwm->table + count / 2);
+        stream->count = count / 2;
+        stream->dir = DMAQ_DIR_M2P;
+        stream->width = 2;
+        stream->cb = dmaq_pwm_stream_cb;
+        stream->arg = pwm;
+        ret = dmaq_stream_start(pwm->chan, stream);
+    } else {
+        req->periph_addr = (uint32_t)(unsigned long)&TIMER_DMATB(pwm->periph);
+        req->mem = (void *)pwm->table;
+        req->count = count;
+        req->dir = DMAQ_DIR_M2P;
+        req->width = 2;
+        req->periph_inc = 0;
+        req->mem_inc = 1;
+        req->cb = dmaq_pwm_req_done;
+        req->arg = pwm;
+        ret = dmaq_submit(pwm->chan, req);
+    }
+    if (ret != 0) {
+        return -1;
+    }
+    timer_dma_enable(pwm->periph, TIMER_DMA_UPD);
+    timer_enable(pwm->periph);
+    return 0;
+}
+
+void dmaq_pwm_stop(dmaq_pwm_t *pwm)
+{
+    timer_dma_disable(pwm->periph, TIMER_DMA_UPD);
+    if (pwm->loop != 0) {
+        dmaq_stream_stop(pwm->chan);
+    } else {
+        dmaq_cancel(pwm->chan, &pwm->req);
+    }
+}
+
+static void dmaq_capture_stream_cb(dmaq_stream_t *stream, uint32_t buf, void *arg)
+{
+    dmaq_capture_t *cap = (dmaq_capture_t *)arg;
+
+    if (cap->cb != NULL) {
+        cap->cb(cap, stream->buf[buf], cap->count, cap->arg);
+    }
+}
+
+int32_t dmaq_capture_start(dmaq_capture_t *cap)
+{
+    dmaq_stream_t *stream = &cap->stream;
+
+    if ((cap->buf == NULL) || (cap->channel > TIMER_CH_3) || ((cap->width != 2) && (cap->width != 4)) ||
+        (cap->count == 0) || (cap->count * 2 > 0xFFFF)) {
+        return -1;
+    }
+    stream->periph_addr = (uint32_t)(unsigned long)&TIMER_CH0CV(cap->periph) + 4 * cap->channel;
+    stream->buf[0] = cap->buf;
+    stream->buf[1] = (uint8_t *)cap->buf + cap->count * cap->width;
+    stream->count = cap->count;
+    stream->dir = DMAQ_DIR_P2M;
+    stream->width = cap->width;
+    stream->cb = dmaq_capture_stream_cb;
+    stream->arg = cap;
+    if (dmaq_stream_start(cap->chan, stream) != 0) {
+        return -1;
+    }
+    // channel DMA request at capture event, not at update event
+    timer_channel_dma_request_source_select(cap->periph, TIMER_DMAREQUEST_CHANNELEVENT);
+    timer_dma_enable(cap->periph, TIMER_DMA_CH0D << cap->channel);
+    timer_enable(cap->periph);
+    return 0;
+}
+
+void dmaq_capture_stop(dmaq_capture_t *cap)
+{
+    timer_dma_disable(cap->periph, TIMER_DMA_CH0D << cap->channel);
+    dmaq_stream_stop(cap->chan);
+}
+
+uint32_t dmaq_capture_position(dmaq_capture_t *cap)
+{
+    return dmaq_stream_position(cap->chan);
+}
@@ -0,0 +1,379 @@
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include "nuclei_sdk_soc.h"
+#include "dmaq_api.h"
+
+#if defined(GD32VW55x_H)
+#define DMAQ_UART_RDATA(periph)     ((uint32_t)(unsigned long)&USART_RDATA(periph))
+#define DMAQ_UART_TDATA(periph)     ((uint32_t)(unsigned long)&USART_TDATA(periph))
+#define DMAQ_UART_DMA_ENABLE(periph)                                \
+    do {                                                            \
+        usart_dma_receive_config(periph, USART_RECEIVE_DMA_ENABLE); \
+        usart_dma_transmit_config(periph, USART_TRANSMIT_DMA_ENABLE); \
+    } while (0)
+/* cleared by writing the clear register */
+#define DMAQ_UART_IDLE_CLEAR(periph)    usart_interrupt_flag_clear(periph, USART_INT_FLAG_IDLE)
+#else
+#define DMAQ_UART_RDATA(periph)     ((uint32_t)(unsigned long)&USART_DATA(periph))
+#define DMAQ_UART_TDATA(periph)     ((uint32_t)(unsigned long)&USART_DATA(periph))
+#define DMAQ_UART_DMA_ENABLE(periph)                                \
+    do {                                                            \
+        usart_dma_receive_config(periph, USART_DENR_ENABLE);        \
+        usart_dma_transmit_config(periph, USART_DENT_ENABLE);       \
+    } while (0)
+/* cleared by reading status then data register */
+#define DMAQ_UART_IDLE_CLEAR(periph)                                \
+    do {                                                            \
+        (void)USART_STAT(periph);                                   \
+        (void)USART_DATA(periph);                                   \
+    } while (0)
+#endif
+
+static dmaq_uart_t *dmaq_uarts[DMAQ_UART_MAX];
+
+/*
+ * Hand off data received up to the DMA position, called with interrupts disabled.
+ * Half and full buffer interrupts update at least twice per ring cycle, so the
+ * position never laps rxpos unless interrupts are blocked for half of rxbuf.
+ */
+static void dmaq_uart_rx_update(dmaq_uart_t *uart, uint32_t idle)
+{
+    uint32_t pos = dmaq_stream_position(uart->rx_chan);
+    uint32_t delta, len;
+
+    delta = (pos >= uart->rxpos) ? (pos - uart->rxpos) : (uart->rxsize - uart->rxpos + pos);
+    uart->rxhead += delta;
+    if ((uart->rxhead - uart->rxtail) > uart->rxsize) {
+        uart->overruns += uart->rxhead - uart->rxtail - uart->rxsize;
+        uart->rxtail = uart->rxhead - uart->rxsize;
+    }
+    if (uart->rx_cb != NULL) {
+        // data is passed in place, split in two at ring end
+        len = uart->rxsize - uart->rxpos;
+        if (delta > len) {
+            uart->rx_cb(uart, uart->rxbuf + uart->rxpos, len, 0, uart->arg);
+            uart->rx_cb(uart, uart->rxbuf, delta - len, idle, uart->arg);
+        } else if ((delta > 0) || idle) {
+            uart->rx_cb(uart, uart->rxbuf + uart->rxpos, delta, idle, uart->arg);
+        }
+        uart->rxtail = uart->rxhead;
+    }
+    uart->rxpos = pos;
+}
+
+static void dmaq_uart_rx_stream_cb(dmaq_stream_t *stream, uint32_t buf, void *arg)
+{
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+
+    dmaq_uart_rx_update((dmaq_uart_t *)arg, 0);
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
+
+static void dmaq_uart_irq(uint32_t idx)
+{
+    dmaq_uart_t *uart = dmaq_uarts[idx];
+    rv_csr_t mstatus;
+
+    if ((uart == NULL) || (usart_interrupt_flag_get(uart->periph, USART_INT_FLAG_IDLE) == RESET)) {
+        return;
+    }
+    DMAQ_UART_IDLE_CLEAR(uart->periph);
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    dmaq_uart_rx_update(uart, 1);
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
+
+#define DMAQ_UART_IRQ_HANDLER(n)    static void dmaq_uart_irq_handler##n(void) { dmaq_uart_irq(n); }
+DMAQ_UART_IRQ_HANDLER(0)
+DMAQ_UART_IRQ_HANDLER(1)
+DMAQ_UART_IRQ_HANDLER(2)
+DMAQ_UART_IRQ_HANDLER(3)
+
+#if DMAQ_UART_MAX > 4
+#error "DMAQ_UART_MAX is at most 4"
+#endif
+
+static void (*const dmaq_uart_irq_handlers[4])(void) = {
+    dmaq_uart_irq_handler0, dmaq_uart_irq_handler1, dmaq_uart_irq_handler2, dmaq_uart_irq_handler3
+};
+
+int32_t dmaq_uart_init(dmaq_uart_t *uart, uint8_t lvl)
+{
+    dmaq_stream_t *stream = &uart->rxstream;
+    uint32_t i, idx = DMAQ_UART_MAX;
+
+    if ((uart->rxbuf == NULL) || (uart->rxsize < 2) || ((uart->rxsize & 1) != 0)) {
+        return -1;
+    }
+    for (i = 0; i < DMAQ_UART_MAX; i++) {
+        if ((dmaq_uarts[i] == uart) || ((dmaq_uarts[i] == NULL) && (idx == DMAQ_UART_MAX))) {
+            idx = i;
+        }
+    }
+    if (idx == DMAQ_UART_MAX) {
+        return -1;
+    }
+    dmaq_stream_stop(uart->rx_chan);
+    uart->rxpos = 0;
+    uart->rxhead = 0;
+    uart->rxtail = 0;
+    uart->overruns = 0;
+    stream->periph_addr = DMAQ_UART_RDATA(uart->periph);
+    stream->buf[0] = uart->rxbuf;
+    stream->buf[1] = uart->rxbuf + uart->rxsize / 2;
+    stream->count = uart->rxsize / 2;
+    stream->dir = DMAQ_DIR_P2M;
+    stream->width = 1;
+    stream->cb = dmaq_uart_rx_stream_cb;
+    stream->arg = uart;
+    DMAQ_UART_DMA_ENABLE(uart->periph);
+    if (dmaq_stream_start(uart->rx_chan, stream) != 0) {
+        return -1;
+    }
+    dmaq_uarts[idx] = uart;
+    DMAQ_UART_IDLE_CLEAR(uart->periph);
+    usart_interrupt_enable(uart->periph, USART_INT_IDLE);
+    return ECLIC_Register_IRQ(uart->irqn, ECLIC_NON_VECTOR_INTERRUPT, ECLIC_LEVEL_TRIGGER, lvl, 0,
+                              (void *)dmaq_uart_irq_handlers[idx]);
+}
+
+int32_t dmaq_uart_write_sg(dmaq_uart_t *uart, dmaq_req_t *reqs, const dmaq_uart_sg_t *sg,
+                           uint32_t cnt, dmaq_cb_t cb, void *arg)
+{
+    uint32_t i;
+
+    if (cnt == 0) {
+        return -1;
+    }
+    for (i = 0; i < cnt; i++) {
+        if ((sg[i].len == 0) || (sg[i].len > 0xFFFF)) {
+            return -1;
+        }
+    }
+    // queued back to back, each one is started by the finish interrupt of previous one
+    for (i = 0; i < cnt; i++) {
+        reqs[i].periph_addr = DMAQ_UART_TDATA(uart->periph);
+        reqs[i].mem = (void *)sg[i].buf;
+        reqs[i].count = sg[i].len;
+        reqs[i].dir = DMAQ_DIR_M2P;
+        reqs[i].width = 1;
+        reqs[i].periph_inc = 0;
+        reqs[i].mem_inc = 1;
+        reqs[i].cb = (i == cnt - 1) ? cb : NULL;
+        reqs[i].arg = arg;
+        if (dmaq_submit(uart->tx_chan, &reqs[i]) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+uint32_t dmaq_uart_rx_peek(dmaq_uart_t *uart, const uint8_t **data)
+{
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    uint32_t avail, off;
+
+    // poll the DMA position, so data before next idle line is seen too
+    dmaq_uart_rx_update(uart, 0);
+    avail = uart->rxhead - uart->rxtail;
+    // rxpos is the ring offset of rxhead
+    off = (uart->rxpos + uart->rxsize - avail) % uart->rxsize;
+    if (avail > uart->rxsize - off) {
+        avail = uart->rxsize - off;
+    }
+    *data = uart->rxbuf + off;
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return avail;
+}
+
+void dmaq_uart_rx_consume(dmaq_uart_t *uart, uint32_t len)
+{
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+
+    // data may be dropped by overrun after peek
+    if (len > uart->rxhead - uart->rxtail) {
+        len = uart->rxhead - uart->rxtail;
+    }
+    uart->rxtail += len;
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
+
+uint32_t dmaq_uart_read(dmaq_uart_t *uart, void *buf, uint32_t len)
+{
+    uint8_t *out = (uint8_t *)buf;
+    const uint8_t *data;
+    uint32_t n, i, cnt = 0;
+
+    while (cnt < len) {
+        n = dmaq_uart_rx_peek(uart, &data);
+        if (n == 0) {
+            break;
+        }
+        if (n > len - cnt) {
+            n = len - cnt;
+        }
+        for (i = 0; i < n; i++) {
+            out[cnt + i] = data[i];
+        }
+        dmaq_uart_rx_consume(uart, n);
+        cnt += n;
+    }
+    return cnt;
+}
+
+#if defined(NUCLEI_UART_DMA) && (NUCLEI_UART_DMA == 1)
+#include <stdio.h>
+#include "nuclei_sdk_hal.h"
+
+#undef putchar
+
+/*
+ * newlib stdio over DMA on SOC_DEBUG_UART, which is initialized by board code before main.
+ * Default channels are the gd32vf103 USART0 ones, DMA0 channel 3 for TX and channel 4 for RX,
+ * define the macros below for other USARTs, such as USART2 of gd32vf103c_dlink which is DMA0
+ * channel 1 for TX and channel 2 for RX, gd32vw55x must define all of them.
+ */
+#if defined(GD32VW55x_H) && !defined(NUCLEI_UART_DMA_TX_CHAN)
+#error "NUCLEI_UART_DMA_TX_CHAN, NUCLEI_UART_DMA_RX_CHAN, NUCLEI_UART_DMA_TX_SUB and NUCLEI_UART_DMA_RX_SUB must be defined for gd32vw55x"
+#endif
+#ifndef NUCLEI_UART_DMA_TX_CHAN
+#define NUCLEI_UART_DMA_TX_CHAN     DMAQ_CHANNEL(DMA0, DMA_CH3)
+#endif
+#ifndef NUCLEI_UART_DMA_RX_CHAN
+#define NUCLEI_UART_DMA_RX_CHAN     DMAQ_CHANNEL(DMA0, DMA_CH4)
+#endif
+#ifndef NUCLEI_UART_DMA_TX_SUB
+#define NUCLEI_UART_DMA_TX_SUB      0
+#endif
+#ifndef NUCLEI_UART_DMA_RX_SUB
+#define NUCLEI_UART_DMA_RX_SUB      0
+#endif
+#ifndef NUCLEI_UART_DMA_IRQ
+#define NUCLEI_UART_DMA_IRQ         USART0_IRQn
+#endif
+#ifndef NUCLEI_UART_DMA_IRQ_LEVEL
+#define NUCLEI_UART_DMA_IRQ_LEVEL   1
+#endif
+#ifndef NUCLEI_UART_DMA_RXSIZE
+#define NUCLEI_UART_DMA_RXSIZE      256
+#endif
+/* scatter list entries of one DMA write */
+#define NUCLEI_UART_DMA_SG          8
+
+static uint8_t dmaq_stdio_rxbuf[NUCLEI_UART_DMA_RXSIZE];
+
+static dmaq_uart_t dmaq_stdio = {
+    .periph = SOC_DEBUG_UART,
+    .irqn = NUCLEI_UART_DMA_IRQ,
+    .tx_chan = NUCLEI_UART_DMA_TX_CHAN,
+    .rx_chan = NUCLEI_UART_DMA_RX_CHAN,
+    .rxbuf = dmaq_stdio_rxbuf,
+    .rxsize = NUCLEI_UART_DMA_RXSIZE,
+};
+
+/* set up at first use, return 0 if DMA is usable */
+static int32_t dmaq_stdio_init(void)
+{
+    // 1 before first use, then 0 or -1, only set up once
+    static int32_t state = 1;
+
+    if (state > 0) {
+        state = -1;
+        if ((dmaq_chan_init(NUCLEI_UART_DMA_TX_CHAN, NUCLEI_UART_DMA_TX_SUB, DMA_PRIORITY_LOW, NUCLEI_UART_DMA_IRQ_LEVEL) == 0) &&
+            (dmaq_chan_init(NUCLEI_UART_DMA_RX_CHAN, NUCLEI_UART_DMA_RX_SUB, DMA_PRIORITY_LOW, NUCLEI_UART_DMA_IRQ_LEVEL) == 0) &&
+            (dmaq_uart_init(&dmaq_stdio, NUCLEI_UART_DMA_IRQ_LEVEL) == 0)) {
+            state = 0;
+        }
+    }
+    return state;
+}
+
+ssize_t _write(int fd, const void *ptr, size_t len)
+{
+    static const char crlf[2] = {'\r', '\n'};
+    const uint8_t *buf = (const uint8_t *)ptr;
+    dmaq_uart_sg_t sg[NUCLEI_UART_DMA_SG];
+    dmaq_req_t reqs[NUCLEI_UART_DMA_SG];
+    size_t i = 0, start;
+    uint32_t cnt;
+
+    if (!isatty(fd)) {
+        return -1;
+    }
+    // dmaq_wait needs the completion interrupt, use polled putchar of newlib stubs when interrupts are disabled
+    if (((__RV_CSR_READ(CSR_MSTATUS) & MSTATUS_MIE) == 0) || (dmaq_stdio_init() != 0)) {
+        for (i = 0; i < len; i++) {
+            putchar((int)buf[i]);
+        }
+        return len;
+    }
+    while (i < len) {
+        // LF becomes a CRLF entry, the text is sent in place
+        cnt = 0;
+        while ((i < len) && (cnt < NUCLEI_UART_DMA_SG - 1)) {
+            start = i;
+            while ((i < len) && (buf[i] != '\n') && ((i - start) < 0xFFFF)) {
+                i++;
+            }
+            if (i > start) {
+                sg[cnt].buf = buf + start;
+                sg[cnt].len = i - start;
+                cnt++;
+            }
+            if ((i < len) && (buf[i] == '\n')) {
+                sg[cnt].buf = crlf;
+                sg[cnt].len = sizeof(crlf);
+                cnt++;
+                i++;
+            }
+        }
+        if ((dmaq_uart_write_sg(&dmaq_stdio, reqs, sg, cnt, NULL, NULL) != 0) ||
+            (dmaq_wait(&reqs[cnt - 1]) != DMAQ_DONE)) {
+            return -1;
+        }
+    }
+    return len;
+}
+
+ssize_t _read(int fd, void *ptr, size_t len)
+{
+    uint8_t *buf = (uint8_t *)ptr;
+    const uint8_t *data;
+    rv_csr_t mstatus;
+    size_t cnt = 0;
+    uint32_t n, i;
+
+    if (fd != STDIN_FILENO) {
+        return -1;
+    }
+    if (dmaq_stdio_init() != 0) {
+        return -1;
+    }
+    while (cnt < len) {
+        n = dmaq_uart_rx_peek(&dmaq_stdio, &data);
+        if (n == 0) {
+            // return what is got, or sleep until idle line of next input
+            if (cnt > 0) {
+                break;
+            }
+            mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+            if (dmaq_stdio.rxhead == dmaq_stdio.rxtail) {
+                __WFI();
+            }
+            __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+            continue;
+        }
+        for (i = 0; (i < n) && (cnt < len); i++) {
+            buf[cnt++] = data[i];
+            // return partial buffer at EOL, like the polled _read
+            if (data[i] == '\n') {
+                dmaq_uart_rx_consume(&dmaq_stdio, i + 1);
+                return cnt;
+            }
+        }
+        dmaq_uart_rx_consume(&dmaq_stdio, i);
+    }
+    return cnt;
+}
+#endif
@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# dsppar middleware splits NMSIS DSP matrix multiplication, convolution and correlation into
+# output tiles run on all harts, add smpwork to MIDDLEWARE and nmsis_dsp to NMSIS_LIB too
+MIDDLEWARE_DSPPAR := $(NUCLEI_SDK_MIDDLEWARE)/dsppar
+
+C_SRCDIRS += $(MIDDLEWARE_DSPPAR)
+
+INCDIRS += $(MIDDLEWARE_DSPPAR)
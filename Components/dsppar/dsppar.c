@@ -0,0 +1,119 @@
+#include <stdint.h>
+#include "riscv_math.h"
+#include "dsppar_api.h"
+
+typedef struct dsppar_mat_job {
+    const riscv_matrix_instance_f32 *a;
+    const riscv_matrix_instance_f32 *b;
+    riscv_matrix_instance_f32 *c;
+} dsppar_mat_job_t;
+
+typedef struct dsppar_conv_job {
+    const float32_t *a;
+    uint32_t alen;
+    const float32_t *b;
+    uint32_t blen;
+    float32_t *dst;
+} dsppar_conv_job_t;
+
+static void dsppar_default_runner(unsigned long begin, unsigned long end, unsigned long grain, smpwork_fn_t fn, void *arg)
+{
+    smpwork_parallel_for(begin, end, grain, fn, arg);
+}
+
+static dsppar_runner_t dsppar_runner = dsppar_default_runner;
+
+void dsppar_set_runner(dsppar_runner_t runner)
+{
+    dsppar_runner = (runner != NULL) ? runner : dsppar_default_runner;
+}
+
+/* rows [begin, end) of c = a * b */
+static void dsppar_mat_tile(void *arg, unsigned long begin, unsigned long end)
+{
+    const dsppar_mat_job_t *job = (const dsppar_mat_job_t *)arg;
+    riscv_matrix_instance_f32 a, c;
+
+    a.numRows = (uint16_t)(end - begin);
+    a.numCols = job->a->numCols;
+    a.pData = job->a->pData + begin * job->a->numCols;
+    c.numRows = a.numRows;
+    c.numCols = job->c->numCols;
+    c.pData = job->c->pData + begin * job->c->numCols;
+    riscv_mat_mult_f32(&a, job->b, &c);
+}
+
+riscv_status dsppar_mat_mult_f32(const riscv_matrix_instance_f32 *pSrcA, const riscv_matrix_instance_f32 *pSrcB,
+                                 riscv_matrix_instance_f32 *pDst, uint32_t grain)
+{
+    dsppar_mat_job_t job;
+
+    if ((pSrcA->numCols != pSrcB->numRows) || (pSrcA->numRows != pDst->numRows) ||
+        (pSrcB->numCols != pDst->numCols)) {
+        return RISCV_MATH_SIZE_MISMATCH;
+    }
+    grain = (grain != 0) ? grain : DSPPAR_MAT_GRAIN;
+    if (pDst->numRows <= grain) {
+        return riscv_mat_mult_f32(pSrcA, pSrcB, pDst);
+    }
+    job.a = pSrcA;
+    job.b = pSrcB;
+    job.c = pDst;
+    dsppar_runner(0, pDst->numRows, grain, dsppar_mat_tile, &job);
+    return RISCV_MATH_SUCCESS;
+}
+
+/* output samples [begin, end) of conv(a, b) */
+static void dsppar_conv_tile(void *arg, unsigned long begin, unsigned long end)
+{
+    const dsppar_conv_job_t *job = (const dsppar_conv_job_t *)arg;
+
+    riscv_conv_partial_f32(job->a, job->alen, job->b, job->blen, job->dst, (uint32_t)begin, (uint32_t)(end - begin));
+}
+
+static void dsppar_conv_run(dsppar_conv_job_t *job, uint32_t grain)
+{
+    uint32_t len = job->alen + job->blen - 1;
+
+    dsppar_runner(0, len, (grain != 0) ? grain : DSPPAR_CONV_GRAIN, dsppar_conv_tile, job);
+}
+
+void dsppar_conv_f32(const float32_t *pSrcA, uint32_t srcALen, const float32_t *pSrcB, uint32_t srcBLen,
+                     float32_t *pDst, uint32_t grain)
+{
+    dsppar_conv_job_t job;
+
+    if ((srcALen + srcBLen - 1) <= ((grain != 0) ? grain : DSPPAR_CONV_GRAIN)) {
+        riscv_conv_f32(pSrcA, srcALen, pSrcB, srcBLen, pDst);
+        return;
+    }
+    job.a = pSrcA;
+    job.alen = srcALen;
+    job.b = pSrcB;
+    job.blen = srcBLen;
+    job.dst = pDst;
+    dsppar_conv_run(&job, grain);
+}
+
+void dsppar_correlate_f32(const float32_t *pSrcA, uint32_t srcALen, const float32_t *pSrcB, uint32_t srcBLen,
+                          float32_t *pDst, float32_t *pScratch, uint32_t grain)
+{
+    dsppar_conv_job_t job;
+    uint32_t i;
+
+    if ((srcALen + srcBLen - 1) <= ((grain != 0) ? grain : DSPPAR_CONV_GRAIN)) {
+        riscv_correlate_f32(pSrcA, srcALen, pSrcB, srcBLen, pDst);
+        return;
+    }
+    // correlation is conv(a, reversed b), riscv_correlate_f32() writes it after the
+    // srcALen - srcBLen samples of zero padding when a is longer, from pDst[0] otherwise
+    for (i = 0; i < srcBLen; i++) {
+        pScratch[i] = pSrcB[srcBLen - 1 - i];
+    }
+    job.a = pSrcA;
+    job.alen = srcALen;
+    job.b = pScratch;
+    job.blen = srcBLen;
+    job.dst = pDst + ((srcALen > srcBLen) ? (srcALen - srcBLen) : 0);
+    dsppar_conv_run(&job, grain);
+}
@@ -0,0 +1,64 @@
+#ifndef _DSPPAR_API_H_
+#define _DSPPAR_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "riscv_math.h"
+#include "smpwork_api.h"
+
+/*
+ * Parallel layer over NMSIS DSP for workloads too big for one hart.
+ *
+ * - Tiles: an operation is split by its output, rows of the product for matrix
+ *   multiplication, ranges of output samples for convolution and correlation, each tile is
+ *   computed by the serial NMSIS DSP function on its part, riscv_mat_mult_f32() on a block
+ *   of rows and riscv_conv_partial_f32() on a range of samples, so no tile depends on another
+ * - Grain: max rows or samples of one tile, 0 selects DSPPAR_MAT_GRAIN or DSPPAR_CONV_GRAIN,
+ *   a smaller grain balances better, a larger one pays less dispatch per tile
+ * - Runner: tiles are run by smpwork_parallel_for() by default, the other harts run
+ *   smpwork_worker() in smp_main, dsppar_set_runner() hands them to worker tasks of an RTOS
+ *   instead, a runner must return after all the tiles are done
+ *
+ * Operations smaller than one tile call the serial function directly, the caller and the
+ * other harts must share the memory of inputs and outputs, as for smpwork.
+ */
+
+/* rows of product in one tile of matrix multiplication */
+#ifndef DSPPAR_MAT_GRAIN
+#define DSPPAR_MAT_GRAIN            4
+#endif
+
+/* output samples in one tile of convolution and correlation */
+#ifndef DSPPAR_CONV_GRAIN
+#define DSPPAR_CONV_GRAIN           256
+#endif
+
+/* runs fn on range [begin, end) in tiles of at most grain, returns when all are done */
+typedef void (*dsppar_runner_t)(unsigned long begin, unsigned long end, unsigned long grain, smpwork_fn_t fn, void *arg);
+
+/* Use runner to run tiles, NULL restores smpwork_parallel_for() */
+void dsppar_set_runner(dsppar_runner_t runner);
+
+/* Same as riscv_mat_mult_f32(), tiles of grain rows of pDst */
+riscv_status dsppar_mat_mult_f32(const riscv_matrix_instance_f32 *pSrcA, const riscv_matrix_instance_f32 *pSrcB,
+                                 riscv_matrix_instance_f32 *pDst, uint32_t grain);
+
+/* Same as riscv_conv_f32(), tiles of grain samples of pDst */
+void dsppar_conv_f32(const float32_t *pSrcA, uint32_t srcALen, const float32_t *pSrcB, uint32_t srcBLen,
+                     float32_t *pDst, uint32_t grain);
+
+/*
+ * Same as riscv_correlate_f32(), tiles of grain samples of pDst, pScratch of srcBLen
+ * samples holds pSrcB reversed, the samples riscv_correlate_f32() leaves untouched are
+ * left untouched too
+ */
+void dsppar_correlate_f32(const float32_t *pSrcA, uint32_t srcALen, const float32_t *pSrcB, uint32_t srcBLen,
+                          float32_t *pDst, float32_t *pScratch, uint32_t grain);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _DSPPAR_API_H_ */
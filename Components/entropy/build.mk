@@ -0,0 +1,12 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# entropy middleware provides a health tested pool of random bytes refilled from gd32vw55x TRNG interrupts,
+# ENTROPY_DRBG=1 adds an AES-128 CTR_DRBG on the CAU, add caustream and dmaq to MIDDLEWARE too
+MIDDLEWARE_ENTROPY := $(NUCLEI_SDK_MIDDLEWARE)/entropy
+
+C_SRCDIRS += $(MIDDLEWARE_ENTROPY)
+
+INCDIRS += $(MIDDLEWARE_ENTROPY)
+
+ifeq ($(ENTROPY_DRBG),1)
+COMMON_FLAGS += -DNUCLEI_ENTROPY_DRBG=1
+endif
@@ -0,0 +1,339 @@
+#include <stdint.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "entropy_api.h"
+
+#if defined(NUCLEI_ENTROPY_DRBG) && (NUCLEI_ENTROPY_DRBG == 1)
+#include "caustream_api.h"
+#endif
+
+#if (ENTROPY_POOL_WORDS & (ENTROPY_POOL_WORDS - 1)) != 0
+#error "ENTROPY_POOL_WORDS must be a power of 2"
+#endif
+
+#define ENTROPY_POOL_BYTES          (ENTROPY_POOL_WORDS * 4)
+
+typedef struct entropy_pool {
+    uint32_t ring[ENTROPY_POOL_WORDS];
+    volatile uint32_t head;         /* bytes put, written by interrupt */
+    volatile uint32_t tail;         /* bytes taken */
+    uint32_t startup;               /* words to drop before the pool is refilled */
+    uint32_t failures;              /* failures in a row */
+    volatile uint32_t stopped;
+    volatile int32_t events;        /* refills and stops, bumped by interrupt */
+    uint32_t rct_last;
+    uint32_t rct_count;
+    uint32_t apt_sample;
+    uint32_t apt_count;
+    uint32_t apt_n;                 /* bytes of current window */
+    entropy_stat_t stat;
+} entropy_pool_t;
+
+static entropy_pool_t entropy_pool;
+
+/* continuous health tests of word, return 0 if it passes */
+static int32_t entropy_health(entropy_pool_t *ep, uint32_t word)
+{
+    uint32_t i, b;
+
+    if ((ep->rct_count != 0) && (word == ep->rct_last)) {
+        if (++ep->rct_count >= ENTROPY_RCT_CUTOFF) {
+            ep->stat.rct_fails++;
+            return -1;
+        }
+    } else {
+        ep->rct_last = word;
+        ep->rct_count = 1;
+    }
+    for (i = 0; i < 4; i++) {
+        b = (word >> (i * 8)) & 0xFF;
+        if (ep->apt_n == 0) {
+            // first byte of window is the sample counted in it
+            ep->apt_sample = b;
+            ep->apt_count = 1;
+        } else if ((b == ep->apt_sample) && (++ep->apt_count >= ENTROPY_APT_CUTOFF)) {
+            ep->stat.apt_fails++;
+            return -1;
+        }
+        if (++ep->apt_n == ENTROPY_APT_WINDOW) {
+            ep->apt_n = 0;
+        }
+    }
+    return 0;
+}
+
+/* (re)start TRNG with the startup test, with interrupts disabled */
+static void entropy_restart(entropy_pool_t *ep)
+{
+    ep->startup = ENTROPY_STARTUP_WORDS;
+    ep->rct_count = 0;
+    ep->apt_n = 0;
+    TRNG_CTL &= ~(TRNG_CTL_TRNGEN | TRNG_CTL_IE);
+    TRNG_STAT &= ~(TRNG_STAT_CEIF | TRNG_STAT_SEIF);
+    TRNG_CTL |= TRNG_CTL_TRNGEN | TRNG_CTL_IE;
+}
+
+/* words of the ring may come from a bad source, drop them */
+static void entropy_fail(entropy_pool_t *ep)
+{
+    ep->tail = ep->head;
+    if (++ep->failures >= ENTROPY_MAX_FAILURES) {
+        ep->stopped = 1;
+        ep->events++;
+        TRNG_CTL &= ~(TRNG_CTL_TRNGEN | TRNG_CTL_IE);
+        return;
+    }
+    entropy_restart(ep);
+}
+
+static void entropy_irq_handler(void)
+{
+    entropy_pool_t *ep = &entropy_pool;
+    uint32_t stat = TRNG_STAT;
+    uint32_t word;
+
+    if ((stat & (TRNG_STAT_CEIF | TRNG_STAT_SEIF)) != 0) {
+        ep->stat.hw_errors++;
+        entropy_fail(ep);
+        return;
+    }
+    if ((stat & TRNG_STAT_DRDY) == 0) {
+        return;
+    }
+    word = TRNG_DATA;
+    if (entropy_health(ep, word) != 0) {
+        entropy_fail(ep);
+        return;
+    }
+    if (ep->startup > 0) {
+        ep->startup--;
+        return;
+    }
+    ep->failures = 0;
+    ep->ring[(ep->head / 4) % ENTROPY_POOL_WORDS] = word;
+    ep->head += 4;
+    ep->events++;
+    ep->stat.words++;
+    if ((ep->head - ep->tail) > (ENTROPY_POOL_BYTES - 4)) {
+        // full, the read taking words out enables it again
+        TRNG_CTL &= ~TRNG_CTL_IE;
+    }
+}
+
+int32_t entropy_init(uint8_t lvl)
+{
+    entropy_pool_t *ep = &entropy_pool;
+    rv_csr_t mstatus;
+
+    memset(ep, 0, sizeof(*ep));
+    rcu_periph_clock_enable(RCU_TRNG);
+    if (ECLIC_Register_IRQ(HAU_TRNG_IRQn, ECLIC_NON_VECTOR_INTERRUPT, ECLIC_LEVEL_TRIGGER, lvl, 0,
+                           (void *)entropy_irq_handler) != 0) {
+        return -1;
+    }
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    entropy_restart(ep);
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return 0;
+}
+
+uint32_t entropy_avail(void)
+{
+    return entropy_pool.head - entropy_pool.tail;
+}
+
+uint32_t entropy_get(void *buf, uint32_t len)
+{
+    entropy_pool_t *ep = &entropy_pool;
+    const uint8_t *ring = (const uint8_t *)ep->ring;
+    uint8_t *out = (uint8_t *)buf;
+    uint32_t avail, off, n;
+    rv_csr_t mstatus;
+
+    // a failure in interrupt drops the ring, so take it with interrupts disabled
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    avail = ep->head - ep->tail;
+    if (len > avail) {
+        len = avail;
+    }
+    off = ep->tail % ENTROPY_POOL_BYTES;
+    n = ENTROPY_POOL_BYTES - off;
+    if (n > len) {
+        n = len;
+    }
+    memcpy(out, ring + off, n);
+    memcpy(out + n, ring, len - n);
+    // bytes taken are not given again
+    memset((uint8_t *)ring + off, 0, n);
+    memset((uint8_t *)ring, 0, len - n);
+    ep->tail += len;
+    if ((len != 0) && (ep->stopped == 0) && (ep->startup == 0)) {
+        TRNG_CTL |= TRNG_CTL_IE;
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return len;
+}
+
+/* take len bytes of the pool, sleeping while it refills, return 0 on success */
+static int32_t entropy_pool_read(uint8_t *buf, uint32_t len)
+{
+    entropy_pool_t *ep = &entropy_pool;
+    int32_t seen;
+    uint32_t n;
+
+    while (len > 0) {
+        n = entropy_get(buf, len);
+        buf += n;
+        len -= n;
+        if (len == 0) {
+            break;
+        }
+        // take events before the checks, a refill or stop after them ends the wait at once
+        seen = ep->events;
+        if (ep->stopped != 0) {
+            return -1;
+        }
+        if (ep->head == ep->tail) {
+            __wfi_while_pending(&ep->events, seen);
+        }
+    }
+    return 0;
+}
+
+#if defined(NUCLEI_ENTROPY_DRBG) && (NUCLEI_ENTROPY_DRBG == 1)
+/* blocks of output, the seed length of AES-128 CTR_DRBG and most bytes of one request */
+#define ENTROPY_DRBG_BLOCKS         4
+#define ENTROPY_DRBG_SEEDLEN        32
+#define ENTROPY_DRBG_MAX_REQ        65536
+
+static caustream_t entropy_drbg_cs;
+static uint8_t entropy_drbg_key[16];
+static uint8_t entropy_drbg_v[16];
+static uint32_t entropy_drbg_reqs;
+static uint32_t entropy_drbg_seeded;
+
+static void entropy_drbg_inc(uint8_t *v)
+{
+    int32_t i;
+
+    for (i = 15; i >= 0; i--) {
+        if (++v[i] != 0) {
+            break;
+        }
+    }
+}
+
+/*
+ * Generate len bytes to out, then update key and V by the next two blocks xored with
+ * provided (NULL for none), as CTR_DRBG generate and update, return 0 on success
+ */
+static int32_t entropy_drbg_blocks(uint8_t *out, uint32_t len, const uint8_t *provided)
+{
+    uint32_t blk[ENTROPY_DRBG_BLOCKS * 4];
+    uint8_t temp[ENTROPY_DRBG_SEEDLEN];
+    uint8_t *p = (uint8_t *)blk;
+    uint32_t nout = (len + 15) / 16;
+    uint32_t nb = nout + 2;
+    uint32_t b, i, k, n;
+    int32_t ret = 0;
+
+    if (caustream_start(&entropy_drbg_cs, CAU_MODE_AES_ECB, CAU_ENCRYPT, entropy_drbg_key, 16, NULL) != 0) {
+        return -1;
+    }
+    for (b = 0; b < nb; b += n) {
+        n = (nb - b < ENTROPY_DRBG_BLOCKS) ? (nb - b) : ENTROPY_DRBG_BLOCKS;
+        for (i = 0; i < n; i++) {
+            entropy_drbg_inc(entropy_drbg_v);
+            memcpy(p + i * 16, entropy_drbg_v, 16);
+        }
+        if (caustream_update(&entropy_drbg_cs, p, p, n * 16) != 0) {
+            ret = -1;
+            break;
+        }
+        for (i = 0; i < n; i++) {
+            k = b + i;
+            if (k < nout) {
+                memcpy(out + k * 16, p + i * 16, ((len - k * 16) < 16) ? (len - k * 16) : 16);
+            } else {
+                memcpy(temp + (k - nout) * 16, p + i * 16, 16);
+            }
+        }
+    }
+    caustream_finish(&entropy_drbg_cs, NULL, NULL, 0, NULL);
+    if (ret == 0) {
+        for (i = 0; (provided != NULL) && (i < ENTROPY_DRBG_SEEDLEN); i++) {
+            temp[i] ^= provided[i];
+        }
+        memcpy(entropy_drbg_key, temp, 16);
+        memcpy(entropy_drbg_v, temp + 16, 16);
+    }
+    memset(blk, 0, sizeof(blk));
+    memset(temp, 0, sizeof(temp));
+    return ret;
+}
+
+/* seed from the pool, key and V are zero before the first seed */
+static int32_t entropy_drbg_reseed(void)
+{
+    uint8_t seed[ENTROPY_DRBG_SEEDLEN];
+    int32_t ret;
+
+    if (entropy_drbg_seeded == 0) {
+        memset(entropy_drbg_key, 0, sizeof(entropy_drbg_key));
+        memset(entropy_drbg_v, 0, sizeof(entropy_drbg_v));
+    }
+    if (entropy_pool_read(seed, sizeof(seed)) != 0) {
+        return -1;
+    }
+    ret = entropy_drbg_blocks(NULL, 0, seed);
+    memset(seed, 0, sizeof(seed));
+    if (ret == 0) {
+        entropy_drbg_seeded = 1;
+        entropy_drbg_reqs = 0;
+        entropy_pool.stat.reseeds++;
+    }
+    return ret;
+}
+
+int32_t entropy_random(void *buf, uint32_t len)
+{
+    uint8_t *out = (uint8_t *)buf;
+    uint32_t n;
+
+    while (len > 0) {
+        if ((entropy_drbg_seeded == 0) || (entropy_drbg_reqs >= ENTROPY_DRBG_RESEED)) {
+            if (entropy_drbg_reseed() != 0) {
+                return -1;
+            }
+        }
+        n = (len < ENTROPY_DRBG_MAX_REQ) ? len : ENTROPY_DRBG_MAX_REQ;
+        if (entropy_drbg_blocks(out, n, NULL) != 0) {
+            return -1;
+        }
+        entropy_drbg_reqs++;
+        out += n;
+        len -= n;
+    }
+    return 0;
+}
+#endif
+
+int32_t entropy_get_random_bytes(void *buf, uint32_t len)
+{
+    uint8_t *out = (uint8_t *)buf;
+    uint32_t n = entropy_get(out, len);
+
+    if (n == len) {
+        return 0;
+    }
+#if defined(NUCLEI_ENTROPY_DRBG) && (NUCLEI_ENTROPY_DRBG == 1)
+    return entropy_random(out + n, len - n);
+#else
+    return entropy_pool_read(out + n, len - n);
+#endif
+}
+
+void entropy_get_stat(entropy_stat_t *stat)
+{
+    *stat = entropy_pool.stat;
+}
@@ -0,0 +1,100 @@
+#ifndef _ENTROPY_API_H_
+#define _ENTROPY_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+
+/*
+ * Entropy pool on the gd32vw55x TRNG.
+ *
+ * - Pool: a ring of ENTROPY_POOL_WORDS words is refilled from the TRNG data ready interrupt
+ *   in the background, the interrupt is disabled when the ring is full and enabled again by
+ *   the read taking words out, so entropy_get() is a copy out of the ring, it never polls
+ * - Health tests: each word goes through a repetition count test of words and an adaptive
+ *   proportion test of bytes, as the SP 800-90B continuous tests, the first
+ *   ENTROPY_STARTUP_WORDS words after each start are tested and dropped. A failed test or a
+ *   clock or seed error of the TRNG drops the ring and restarts the TRNG, after
+ *   ENTROPY_MAX_FAILURES of them in a row the pool stops and reads fail
+ * - DRBG: with NUCLEI_ENTROPY_DRBG=1, entropy_random() runs an AES-128 CTR_DRBG of SP 800-90A
+ *   without derivation function on the CAU by caustream, seeded and reseeded every
+ *   ENTROPY_DRBG_RESEED requests by 32 bytes of the pool, to give more bytes than the pool,
+ *   caustream_init() is called by caller
+ *
+ * The TRNG clock source and divider are set by caller, HAU_TRNG_IRQn is owned by the pool.
+ * entropy_get() can be called in interrupt, entropy_random() and entropy_get_random_bytes(),
+ * which falls back to it or waits for the pool, only in thread context, as caustream is.
+ */
+
+/* words of the pool, power of 2 */
+#ifndef ENTROPY_POOL_WORDS
+#define ENTROPY_POOL_WORDS          64
+#endif
+
+/* words tested and dropped after each start of TRNG, 1024 samples of bytes */
+#ifndef ENTROPY_STARTUP_WORDS
+#define ENTROPY_STARTUP_WORDS       256
+#endif
+
+/* repetition count test cutoff of words, 2 fails at any repeated word, 2^-32 false alarm */
+#ifndef ENTROPY_RCT_CUTOFF
+#define ENTROPY_RCT_CUTOFF          2
+#endif
+
+/* adaptive proportion test of bytes, window and cutoff for about 2^-20 false alarm */
+#ifndef ENTROPY_APT_WINDOW
+#define ENTROPY_APT_WINDOW          512
+#endif
+#ifndef ENTROPY_APT_CUTOFF
+#define ENTROPY_APT_CUTOFF          13
+#endif
+
+/* failed tests or TRNG errors in a row which stop the pool */
+#ifndef ENTROPY_MAX_FAILURES
+#define ENTROPY_MAX_FAILURES        8
+#endif
+
+/* DRBG requests between reseeds */
+#ifndef ENTROPY_DRBG_RESEED
+#define ENTROPY_DRBG_RESEED         4096
+#endif
+
+/* statistics of the pool */
+typedef struct entropy_stat {
+    uint32_t words;                 /* words put in pool */
+    uint32_t rct_fails;             /* repetition count test failures */
+    uint32_t apt_fails;             /* adaptive proportion test failures */
+    uint32_t hw_errors;             /* TRNG clock and seed errors */
+    uint32_t reseeds;               /* DRBG seeds and reseeds */
+} entropy_stat_t;
+
+/* Start TRNG and refill of the pool, install its interrupt at level lvl, return 0 on success */
+int32_t entropy_init(uint8_t lvl);
+
+/* Return bytes in pool */
+uint32_t entropy_avail(void);
+
+/* Copy up to len bytes of pool to buf, return bytes copied, it doesn't block */
+uint32_t entropy_get(void *buf, uint32_t len);
+
+/*
+ * Fill buf with len random bytes, from the pool, then from the DRBG with NUCLEI_ENTROPY_DRBG=1
+ * or by waiting for the pool, return 0 on success, -1 if the pool is stopped
+ */
+int32_t entropy_get_random_bytes(void *buf, uint32_t len);
+
+#if defined(NUCLEI_ENTROPY_DRBG) && (NUCLEI_ENTROPY_DRBG == 1)
+/* Fill buf with len bytes of the DRBG, return 0 on success, -1 on error */
+int32_t entropy_random(void *buf, uint32_t len);
+#endif
+
+/* Get statistics of the pool */
+void entropy_get_stat(entropy_stat_t *stat);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _ENTROPY_API_H_ */
@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# exmcfb middleware provides a framebuffer with dirty rectangles flushed by dmaq memory to memory DMA
+# to an 8080 LCD on the gd32vf103 EXMC, add dmaq to MIDDLEWARE too
+MIDDLEWARE_EXMCFB := $(NUCLEI_SDK_MIDDLEWARE)/exmcfb
+
+C_SRCDIRS += $(MIDDLEWARE_EXMCFB)
+
+INCDIRS += $(MIDDLEWARE_EXMCFB)
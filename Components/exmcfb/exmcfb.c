@@ -0,0 +1,332 @@
+#include <stdint.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "dmaq_api.h"
+#include "exmcfb_api.h"
+
+/* most data of one request */
+#define EXMCFB_DMA_MAX              65535
+
+static inline uint32_t exmcfb_area(const exmcfb_rect_t *r)
+{
+    return (uint32_t)r->w * r->h;
+}
+
+/* return 1 if a and b overlap or touch */
+static inline uint32_t exmcfb_touch(const exmcfb_rect_t *a, const exmcfb_rect_t *b)
+{
+    return ((a->x <= b->x + b->w) && (b->x <= a->x + a->w) &&
+            (a->y <= b->y + b->h) && (b->y <= a->y + a->h)) ? 1 : 0;
+}
+
+static exmcfb_rect_t exmcfb_union(const exmcfb_rect_t *a, const exmcfb_rect_t *b)
+{
+    exmcfb_rect_t r;
+    uint32_t x1 = ((a->x + a->w) > (b->x + b->w)) ? (a->x + a->w) : (b->x + b->w);
+    uint32_t y1 = ((a->y + a->h) > (b->y + b->h)) ? (a->y + a->h) : (b->y + b->h);
+
+    r.x = (a->x < b->x) ? a->x : b->x;
+    r.y = (a->y < b->y) ? a->y : b->y;
+    r.w = x1 - r.x;
+    r.h = y1 - r.y;
+    return r;
+}
+
+/* clip rectangle to fb, return 0 if nothing is left */
+static uint32_t exmcfb_clip(exmcfb_t *fb, exmcfb_rect_t *r, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+    int32_t x1 = x + w;
+    int32_t y1 = y + h;
+
+    x = (x < 0) ? 0 : x;
+    y = (y < 0) ? 0 : y;
+    x1 = (x1 > fb->width) ? fb->width : x1;
+    y1 = (y1 > fb->height) ? fb->height : y1;
+    if ((x >= x1) || (y >= y1)) {
+        return 0;
+    }
+    r->x = x;
+    r->y = y;
+    r->w = x1 - x;
+    r->h = y1 - y;
+    return 1;
+}
+
+/* add r to dirty list with interrupts disabled */
+static void exmcfb_add(exmcfb_t *fb, exmcfb_rect_t r)
+{
+    exmcfb_rect_t u;
+    uint32_t i, best, cost, best_cost;
+
+    while (1) {
+        // a merged rectangle may touch others, so merge again until none is touched
+        for (i = 0; i < fb->ndirty; i++) {
+            if (exmcfb_touch(&fb->dirty[i], &r)) {
+                break;
+            }
+        }
+        if ((i == fb->ndirty) && (fb->ndirty < EXMCFB_MAX_DIRTY)) {
+            fb->dirty[fb->ndirty++] = r;
+            return;
+        }
+        if (i == fb->ndirty) {
+            best = 0;
+            best_cost = UINT32_MAX;
+            for (i = 0; i < fb->ndirty; i++) {
+                u = exmcfb_union(&fb->dirty[i], &r);
+                cost = exmcfb_area(&u) - exmcfb_area(&fb->dirty[i]);
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best = i;
+                }
+            }
+            i = best;
+        }
+        r = exmcfb_union(&fb->dirty[i], &r);
+        fb->dirty[i] = fb->dirty[--fb->ndirty];
+    }
+}
+
+static inline void exmcfb_lcd_cmd(exmcfb_t *fb, uint16_t cmd)
+{
+    REG16(fb->lcd_cmd) = cmd;
+}
+
+static inline void exmcfb_lcd_data(exmcfb_t *fb, uint16_t data)
+{
+    REG16(fb->lcd_data) = data;
+}
+
+/* set LCD window to r and start memory write */
+static void exmcfb_window(exmcfb_t *fb, const exmcfb_rect_t *r)
+{
+    uint32_t x1 = r->x + r->w - 1;
+    uint32_t y1 = r->y + r->h - 1;
+
+    exmcfb_lcd_cmd(fb, EXMCFB_CMD_CASET);
+    exmcfb_lcd_data(fb, r->x >> 8);
+    exmcfb_lcd_data(fb, r->x & 0xFF);
+    exmcfb_lcd_data(fb, x1 >> 8);
+    exmcfb_lcd_data(fb, x1 & 0xFF);
+    exmcfb_lcd_cmd(fb, EXMCFB_CMD_PASET);
+    exmcfb_lcd_data(fb, r->y >> 8);
+    exmcfb_lcd_data(fb, r->y & 0xFF);
+    exmcfb_lcd_data(fb, y1 >> 8);
+    exmcfb_lcd_data(fb, y1 & 0xFF);
+    exmcfb_lcd_cmd(fb, EXMCFB_CMD_RAMWR);
+    // the commands reach EXMC before the DMA writes pixels
+    __RWMB();
+}
+
+static void exmcfb_done(dmaq_req_t *req, void *arg);
+
+/* queue next rows of current rectangle on req, a full width rectangle is contiguous in fb */
+static int32_t exmcfb_queue(exmcfb_t *fb, dmaq_req_t *req)
+{
+    const exmcfb_rect_t *r = &fb->flushing[fb->cur];
+    uint32_t rows = (r->w == fb->width) ? (EXMCFB_DMA_MAX / r->w) : 1;
+
+    if (rows > r->h - fb->row) {
+        rows = r->h - fb->row;
+    }
+    req->periph_addr = (uint32_t)(unsigned long)&fb->fb[(uint32_t)(r->y + fb->row) * fb->width + r->x];
+    req->mem = (void *)(unsigned long)fb->lcd_data;
+    req->count = rows * r->w;
+    req->dir = DMAQ_DIR_M2M;
+    req->width = 2;
+    req->periph_inc = 1;
+    req->mem_inc = 0;
+    req->cb = exmcfb_done;
+    req->arg = fb;
+    if (dmaq_submit(fb->chan, req) != 0) {
+        return -1;
+    }
+    fb->row += rows;
+    fb->inflight++;
+    return 0;
+}
+
+/* set window of current rectangle and queue its first rows, return 0 if started */
+static int32_t exmcfb_start(exmcfb_t *fb)
+{
+    const exmcfb_rect_t *r = &fb->flushing[fb->cur];
+
+    exmcfb_window(fb, r);
+    fb->row = 0;
+    if (exmcfb_queue(fb, &fb->reqs[0]) != 0) {
+        return -1;
+    }
+    if ((fb->row < r->h) && (exmcfb_queue(fb, &fb->reqs[1]) != 0)) {
+        // the queued one still completes and ends the flush
+        fb->err = -1;
+    }
+    return 0;
+}
+
+static void exmcfb_finish(exmcfb_t *fb)
+{
+    fb->busy = 0;
+    if (fb->cb != NULL) {
+        fb->cb(fb, fb->err, fb->arg);
+    }
+}
+
+/* completion of a request, the other one, if queued, is already started by dmaq */
+static void exmcfb_done(dmaq_req_t *req, void *arg)
+{
+    exmcfb_t *fb = (exmcfb_t *)arg;
+
+    fb->inflight--;
+    if (req->status != DMAQ_DONE) {
+        fb->err = -1;
+    }
+    if ((fb->err == 0) && (fb->row < fb->flushing[fb->cur].h)) {
+        if (exmcfb_queue(fb, req) == 0) {
+            return;
+        }
+        fb->err = -1;
+    }
+    // the window of next rectangle is set when LCD has all pixels of this one
+    if (fb->inflight != 0) {
+        return;
+    }
+    if ((fb->err == 0) && (++fb->cur < fb->nflushing)) {
+        if (exmcfb_start(fb) == 0) {
+            return;
+        }
+        fb->err = -1;
+    }
+    exmcfb_finish(fb);
+}
+
+void exmcfb_exmc_init(uint32_t addr_setup, uint32_t addr_hold, uint32_t data_setup)
+{
+    exmc_norsram_parameter_struct param;
+    exmc_norsram_timing_parameter_struct timing;
+
+    rcu_periph_clock_enable(RCU_EXMC);
+    timing.bus_latency = 0;
+    timing.asyn_data_setuptime = data_setup;
+    timing.asyn_address_holdtime = addr_hold;
+    timing.asyn_address_setuptime = addr_setup;
+    param.norsram_region = EXMC_BANK0_NORSRAM_REGION0;
+    param.asyn_wait = DISABLE;
+    param.nwait_signal = DISABLE;
+    param.memory_write = ENABLE;
+    param.nwait_polarity = EXMC_NWAIT_POLARITY_LOW;
+    param.databus_width = EXMC_NOR_DATABUS_WIDTH_16B;
+    param.memory_type = EXMC_MEMORY_TYPE_SRAM;
+    param.address_data_mux = DISABLE;
+    param.read_write_timing = &timing;
+    exmc_norsram_deinit(EXMC_BANK0_NORSRAM_REGION0);
+    exmc_norsram_init(&param);
+    exmc_norsram_enable(EXMC_BANK0_NORSRAM_REGION0);
+}
+
+int32_t exmcfb_init(exmcfb_t *fb)
+{
+    if ((fb->fb == NULL) || (fb->width == 0) || (fb->height == 0) || (fb->chan >= DMAQ_MAX_CHANNELS)) {
+        return -1;
+    }
+    fb->ndirty = 0;
+    fb->nflushing = 0;
+    fb->inflight = 0;
+    fb->err = 0;
+    fb->busy = 0;
+    return 0;
+}
+
+void exmcfb_mark(exmcfb_t *fb, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+    exmcfb_rect_t r;
+    rv_csr_t mstatus;
+
+    if (exmcfb_clip(fb, &r, x, y, w, h) == 0) {
+        return;
+    }
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    exmcfb_add(fb, r);
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
+
+void exmcfb_mark_all(exmcfb_t *fb)
+{
+    exmcfb_mark(fb, 0, 0, fb->width, fb->height);
+}
+
+void exmcfb_fill(exmcfb_t *fb, int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color)
+{
+    exmcfb_rect_t r;
+    uint16_t *p;
+    uint32_t i, j;
+
+    if (exmcfb_clip(fb, &r, x, y, w, h) == 0) {
+        return;
+    }
+    for (j = 0; j < r.h; j++) {
+        p = &fb->fb[(uint32_t)(r.y + j) * fb->width + r.x];
+        for (i = 0; i < r.w; i++) {
+            p[i] = color;
+        }
+    }
+    exmcfb_mark(fb, r.x, r.y, r.w, r.h);
+}
+
+void exmcfb_blit(exmcfb_t *fb, int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *src, uint32_t stride)
+{
+    exmcfb_rect_t r;
+    uint32_t j;
+
+    if (exmcfb_clip(fb, &r, x, y, w, h) == 0) {
+        return;
+    }
+    // skip the part of src clipped off at left and top
+    src += (uint32_t)(r.y - y) * stride + (uint32_t)(r.x - x);
+    for (j = 0; j < r.h; j++) {
+        memcpy(&fb->fb[(uint32_t)(r.y + j) * fb->width + r.x], src + j * stride, r.w * 2);
+    }
+    exmcfb_mark(fb, r.x, r.y, r.w, r.h);
+}
+
+int32_t exmcfb_flush(exmcfb_t *fb)
+{
+    rv_csr_t mstatus;
+    int32_t ret = 0;
+
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if (fb->busy != 0) {
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+        return -1;
+    }
+    memcpy(fb->flushing, fb->dirty, fb->ndirty * sizeof(exmcfb_rect_t));
+    fb->nflushing = fb->ndirty;
+    fb->ndirty = 0;
+    fb->cur = 0;
+    fb->inflight = 0;
+    fb->err = 0;
+    if (fb->nflushing != 0) {
+        fb->busy = 1;
+        // started with interrupts disabled, so the DMA callback sees the queued state
+        if (exmcfb_start(fb) != 0) {
+            fb->busy = 0;
+            fb->err = -1;
+            ret = -1;
+        }
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    if ((ret == 0) && (fb->nflushing == 0) && (fb->cb != NULL)) {
+        fb->cb(fb, 0, fb->arg);
+    }
+    return ret;
+}
+
+int32_t exmcfb_wait(exmcfb_t *fb)
+{
+    __wfi_while_pending(&fb->busy, 1);
+    return fb->err;
+}
+
+uint32_t exmcfb_busy(exmcfb_t *fb)
+{
+    return (fb->busy != 0) ? 1 : 0;
+}
@@ -0,0 +1,122 @@
+#ifndef _EXMCFB_API_H_
+#define _EXMCFB_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "dmaq_api.h"
+
+#if !defined(__GD32VF103_H__)
+#error "exmcfb middleware only supports gd32vf103"
+#endif
+
+/*
+ * Framebuffer with dirty rectangles flushed to an 8080 interface LCD on the gd32vf103 EXMC.
+ *
+ * - LCD: the LCD is a 16-bit SRAM on EXMC NOR/SRAM region 0, an address line drives its RS
+ *   pin, so a write to lcd_cmd is a command and a write to lcd_data is data, it takes the
+ *   MIPI DCS column, page and memory write commands of ILI9341, ST7789 and alike controllers
+ * - Framebuffer: width x height RGB565 pixels at fb, in external SRAM decoded on region 0
+ *   by an upper address line, as gd32vf103 has only EXMC_NE0, or in internal SRAM for a
+ *   small panel, the CPU draws into it and marks the rectangles it changed
+ * - Dirty rectangles: up to EXMCFB_MAX_DIRTY rectangles are kept, a rectangle overlapping
+ *   or touching a kept one is merged into it, when the list is full it is merged into the
+ *   one which grows least
+ * - Flush: for each dirty rectangle the LCD window is set by the CPU, then its rows are
+ *   written to lcd_data by dmaq memory to memory DMA, two requests in flight, so the next
+ *   row is queued while one is sent, a full width rectangle is sent as contiguous blocks
+ *
+ * exmcfb_flush() returns at once, cb is called in the DMA interrupt when the flush is done,
+ * marks made during a flush go to the next one, pixels drawn in a rectangle being flushed
+ * may show in this flush or the next one. The EXMC pins and LCD reset and init sequence
+ * are set up by caller, chan is initialized by dmaq_chan_init() and owned by the fb.
+ */
+
+/* dirty rectangles kept between flushes */
+#ifndef EXMCFB_MAX_DIRTY
+#define EXMCFB_MAX_DIRTY            8
+#endif
+
+/* MIPI DCS commands */
+#define EXMCFB_CMD_CASET            0x2A    /* column address set */
+#define EXMCFB_CMD_PASET            0x2B    /* page address set */
+#define EXMCFB_CMD_RAMWR            0x2C    /* memory write */
+
+/* address of region 0, lcd_cmd and lcd_data are in it */
+#define EXMCFB_REGION0              0x60000000UL
+
+/* rectangle of pixels */
+typedef struct exmcfb_rect {
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+} exmcfb_rect_t;
+
+struct exmcfb;
+/* flush done callback, called in interrupt, status is 0 or -1 on DMA error */
+typedef void (*exmcfb_cb_t)(struct exmcfb *fb, int32_t status, void *arg);
+
+typedef struct exmcfb {
+    uint16_t *fb;                   /* width x height RGB565 pixels, row by row */
+    uint16_t width;
+    uint16_t height;
+    uint32_t lcd_cmd;               /* command address of LCD, RS low */
+    uint32_t lcd_data;              /* data address of LCD, RS high */
+    uint32_t chan;                  /* dmaq channel */
+    exmcfb_cb_t cb;                 /* flush done callback, can be NULL */
+    void *arg;
+    /* private */
+    exmcfb_rect_t dirty[EXMCFB_MAX_DIRTY];
+    uint32_t ndirty;
+    exmcfb_rect_t flushing[EXMCFB_MAX_DIRTY];
+    uint32_t nflushing;
+    uint32_t cur;                   /* rectangle being flushed */
+    uint32_t row;                   /* next row of it to queue */
+    uint32_t inflight;              /* requests queued */
+    int32_t err;
+    volatile int32_t busy;
+    dmaq_req_t reqs[2];
+} exmcfb_t;
+
+/*
+ * Set EXMC region 0 to 16-bit asynchronous SRAM with address setup, address hold and
+ * data setup time in HCLK cycles, the region is shared by LCD and external SRAM, so
+ * the timing must meet the slower of them
+ */
+void exmcfb_exmc_init(uint32_t addr_setup, uint32_t addr_hold, uint32_t data_setup);
+
+/* Initialize fb, nothing is dirty, return 0 on success, -1 on invalid argument */
+int32_t exmcfb_init(exmcfb_t *fb);
+
+/* Mark rectangle dirty, it is clipped to fb */
+void exmcfb_mark(exmcfb_t *fb, int32_t x, int32_t y, int32_t w, int32_t h);
+
+/* Mark whole fb dirty */
+void exmcfb_mark_all(exmcfb_t *fb);
+
+/* Fill rectangle with color and mark it */
+void exmcfb_fill(exmcfb_t *fb, int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color);
+
+/* Copy w x h pixels of src, stride pixels per row, to x,y and mark it */
+void exmcfb_blit(exmcfb_t *fb, int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *src, uint32_t stride);
+
+/*
+ * Start flush of dirty rectangles, return 0 if started or nothing is dirty, cb is called
+ * in both cases, -1 if a flush is running
+ */
+int32_t exmcfb_flush(exmcfb_t *fb);
+
+/* Sleep until the flush is done in bare-metal, return 0 or -1 on DMA error */
+int32_t exmcfb_wait(exmcfb_t *fb);
+
+/* Return 1 if a flush is running */
+uint32_t exmcfb_busy(exmcfb_t *fb);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _EXMCFB_API_H_ */
@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# fastmem middleware replaces memcpy, memset, memcmp, strlen and strcmp of libc,
+# define FASTMEM_VECTOR=1 to use RVV versions when compiled with vector extension
+MIDDLEWARE_FASTMEM := $(NUCLEI_SDK_MIDDLEWARE)/fastmem
+
+C_SRCDIRS += $(MIDDLEWARE_FASTMEM)
+
+INCDIRS += $(MIDDLEWARE_FASTMEM)
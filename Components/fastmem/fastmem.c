@@ -0,0 +1,273 @@
+#include <stdint.h>
+#include <stddef.h>
+#include "nuclei_sdk_soc.h"
+#include "fastmem_api.h"
+
+#if defined(FASTMEM_VECTOR) && (FASTMEM_VECTOR == 1) && defined(__riscv_vector)
+#define FASTMEM_USE_VECTOR      1
+#endif
+
+/* word type which may alias the bytes of any object */
+typedef unsigned long __attribute__((may_alias)) fastmem_word_t;
+
+#define WSIZE                   sizeof(unsigned long)
+#define WMASK                   (WSIZE - 1)
+#define WBITS                   (WSIZE * 8)
+#define ONES                    ((unsigned long)-1 / 0xFF)
+#define HIGHS                   (ONES << 7)
+
+/* loops here must not be turned back into calls of themselves by gcc */
+#define FASTMEM_FUNC            __attribute__((optimize("no-tree-loop-distribute-patterns")))
+
+/*
+ * Return a mask whose lowest set bit is in the first zero byte of x, 0 if there is none,
+ * bytes after the first zero one may be marked wrongly without Zbb, and they are not used
+ */
+__STATIC_FORCEINLINE unsigned long fastmem_zero_bytes(unsigned long x)
+{
+#if defined(__riscv_zbb)
+    unsigned long res;
+
+    __ASM("orc.b %0, %1" : "=r"(res) : "r"(x));
+    return ~res;
+#else
+    return (x - ONES) & ~x & HIGHS;
+#endif
+}
+
+#if defined(FASTMEM_USE_VECTOR)
+/* vector registers are clobbered by asm, so gcc doesn't keep its own values in them */
+#define FASTMEM_VCLOBBER        "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", \
+                                "v8", "v9", "v10", "v11", "v12", "v13", "v14", "v15", \
+                                "v16", "v17", "v18", "v19", "v20", "v21", "v22", "v23"
+
+void *memcpy(void *dst, const void *src, size_t n)
+{
+    unsigned char *d = (unsigned char *)dst;
+    const unsigned char *s = (const unsigned char *)src;
+
+    if (n != 0) {
+        __ASM volatile("1:\n"
+                       "vsetvli t0, %2, e8, m8, ta, ma\n"
+                       "vle8.v v0, (%1)\n"
+                       "vse8.v v0, (%0)\n"
+                       "add %1, %1, t0\n"
+                       "add %0, %0, t0\n"
+                       "sub %2, %2, t0\n"
+                       "bnez %2, 1b\n"
+                       : "+r"(d), "+r"(s), "+r"(n) : : "t0", "memory", FASTMEM_VCLOBBER);
+    }
+    return dst;
+}
+
+void *memset(void *dst, int c, size_t n)
+{
+    unsigned char *d = (unsigned char *)dst;
+
+    if (n != 0) {
+        __ASM volatile("1:\n"
+                       "vsetvli t0, %1, e8, m8, ta, ma\n"
+                       "vmv.v.x v0, %2\n"
+                       "vse8.v v0, (%0)\n"
+                       "add %0, %0, t0\n"
+                       "sub %1, %1, t0\n"
+                       "bnez %1, 1b\n"
+                       : "+r"(d), "+r"(n) : "r"(c) : "t0", "memory", FASTMEM_VCLOBBER);
+    }
+    return dst;
+}
+
+int memcmp(const void *s1, const void *s2, size_t n)
+{
+    const unsigned char *a = (const unsigned char *)s1;
+    const unsigned char *b = (const unsigned char *)s2;
+    long idx;
+
+    if (n == 0) {
+        return 0;
+    }
+    __ASM volatile("1:\n"
+                   "vsetvli t0, %2, e8, m8, ta, ma\n"
+                   "vle8.v v0, (%0)\n"
+                   "vle8.v v8, (%1)\n"
+                   "vmsne.vv v16, v0, v8\n"
+                   "vfirst.m %3, v16\n"
+                   "bgez %3, 2f\n"
+                   "add %0, %0, t0\n"
+                   "add %1, %1, t0\n"
+                   "sub %2, %2, t0\n"
+                   "bnez %2, 1b\n"
+                   "j 3f\n"
+                   "2:\n"
+                   "add %0, %0, %3\n"
+                   "add %1, %1, %3\n"
+                   "3:\n"
+                   : "+r"(a), "+r"(b), "+r"(n), "=&r"(idx) : : "t0", "memory", FASTMEM_VCLOBBER);
+    return (idx < 0) ? 0 : ((int)*a - (int)*b);
+}
+
+size_t strlen(const char *s)
+{
+    const char *p = s;
+
+    // fault-only-first load stops at the end of accessible memory instead of trapping
+    __ASM volatile("1:\n"
+                   "vsetvli t0, zero, e8, m8, ta, ma\n"
+                   "vle8ff.v v0, (%0)\n"
+                   "csrr t0, vl\n"
+                   "vmseq.vi v8, v0, 0\n"
+                   "vfirst.m t1, v8\n"
+                   "add %0, %0, t0\n"
+                   "bltz t1, 1b\n"
+                   "sub %0, %0, t0\n"
+                   "add %0, %0, t1\n"
+                   : "+r"(p) : : "t0", "t1", "memory", FASTMEM_VCLOBBER);
+    return (size_t)(p - s);
+}
+#else
+FASTMEM_FUNC void *memcpy(void *dst, const void *src, size_t n)
+{
+    unsigned char *d = (unsigned char *)dst;
+    const unsigned char *s = (const unsigned char *)src;
+    fastmem_word_t *wd;
+    const fastmem_word_t *ws;
+    unsigned long w0, w1, w2, w3, shift;
+
+    if (n >= FASTMEM_SMALL) {
+        for (; ((uintptr_t)d & WMASK) != 0; n--) {
+            *d++ = *s++;
+        }
+        wd = (fastmem_word_t *)d;
+        if (((uintptr_t)s & WMASK) == 0) {
+            ws = (const fastmem_word_t *)s;
+            for (; n >= 4 * WSIZE; n -= 4 * WSIZE, wd += 4, ws += 4) {
+                w0 = ws[0];
+                w1 = ws[1];
+                w2 = ws[2];
+                w3 = ws[3];
+                wd[0] = w0;
+                wd[1] = w1;
+                wd[2] = w2;
+                wd[3] = w3;
+            }
+            for (; n >= WSIZE; n -= WSIZE) {
+                *wd++ = *ws++;
+            }
+        } else {
+            // each destination word is merged from two aligned source words, so no misaligned access,
+            // the aligned words read only hold bytes of the source
+            shift = ((uintptr_t)s & WMASK) * 8;
+            ws = (const fastmem_word_t *)((uintptr_t)s & ~(uintptr_t)WMASK);
+            w0 = *ws++;
+            for (; n >= WSIZE; n -= WSIZE) {
+                w1 = *ws++;
+                *wd++ = (w0 >> shift) | (w1 << (WBITS - shift));
+                w0 = w1;
+            }
+            ws = (const fastmem_word_t *)((const unsigned char *)ws - WSIZE + (shift / 8));
+        }
+        d = (unsigned char *)wd;
+        s = (const unsigned char *)ws;
+    }
+    while (n-- != 0) {
+        *d++ = *s++;
+    }
+    return dst;
+}
+
+FASTMEM_FUNC void *memset(void *dst, int c, size_t n)
+{
+    unsigned char *d = (unsigned char *)dst;
+    unsigned long pattern = (unsigned char)c * ONES;
+    fastmem_word_t *wd;
+
+    if (n >= FASTMEM_SMALL) {
+        for (; ((uintptr_t)d & WMASK) != 0; n--) {
+            *d++ = (unsigned char)c;
+        }
+        wd = (fastmem_word_t *)d;
+        for (; n >= 4 * WSIZE; n -= 4 * WSIZE, wd += 4) {
+            wd[0] = pattern;
+            wd[1] = pattern;
+            wd[2] = pattern;
+            wd[3] = pattern;
+        }
+        for (; n >= WSIZE; n -= WSIZE) {
+            *wd++ = pattern;
+        }
+        d = (unsigned char *)wd;
+    }
+    while (n-- != 0) {
+        *d++ = (unsigned char)c;
+    }
+    return dst;
+}
+
+FASTMEM_FUNC int memcmp(const void *s1, const void *s2, size_t n)
+{
+    const unsigned char *a = (const unsigned char *)s1;
+    const unsigned char *b = (const unsigned char *)s2;
+
+    // words are compared when both have the same alignment, the differing word is compared bytewise
+    if ((n >= FASTMEM_SMALL) && ((((uintptr_t)a ^ (uintptr_t)b) & WMASK) == 0)) {
+        for (; ((uintptr_t)a & WMASK) != 0; n--, a++, b++) {
+            if (*a != *b) {
+                return (int)*a - (int)*b;
+            }
+        }
+        for (; (n >= WSIZE) && (*(const fastmem_word_t *)a == *(const fastmem_word_t *)b); n -= WSIZE) {
+            a += WSIZE;
+            b += WSIZE;
+        }
+    }
+    for (; n != 0; n--, a++, b++) {
+        if (*a != *b) {
+            return (int)*a - (int)*b;
+        }
+    }
+    return 0;
+}
+
+FASTMEM_FUNC size_t strlen(const char *s)
+{
+    const fastmem_word_t *p = (const fastmem_word_t *)((uintptr_t)s & ~(uintptr_t)WMASK);
+    unsigned long off = (uintptr_t)s & WMASK;
+    unsigned long w, mask;
+
+    // aligned word never crosses a page or pmp region, so reading the whole word is safe,
+    // bytes before s in the first word are set to be not zero
+    w = *p;
+    if (off != 0) {
+        w |= (1UL << (off * 8)) - 1;
+    }
+    while ((mask = fastmem_zero_bytes(w)) == 0) {
+        w = *++p;
+    }
+    return (size_t)((const char *)p - s) + __CTZL(mask) / 8;
+}
+#endif /* FASTMEM_USE_VECTOR */
+
+FASTMEM_FUNC int strcmp(const char *s1, const char *s2)
+{
+    const unsigned char *a = (const unsigned char *)s1;
+    const unsigned char *b = (const unsigned char *)s2;
+    unsigned long wa;
+
+    if ((((uintptr_t)a ^ (uintptr_t)b) & WMASK) == 0) {
+        for (; ((uintptr_t)a & WMASK) != 0; a++, b++) {
+            if ((*a != *b) || (*a == 0)) {
+                return (int)*a - (int)*b;
+            }
+        }
+        // stop at the word which differs or has the end, then find the byte in it
+        while (((wa = *(const fastmem_word_t *)a) == *(const fastmem_word_t *)b) && (fastmem_zero_bytes(wa) == 0)) {
+            a += WSIZE;
+            b += WSIZE;
+        }
+    }
+    while ((*a == *b) && (*a != 0)) {
+        a++;
+        b++;
+    }
+    return (int)*a - (int)*b;
+}
@@ -0,0 +1,39 @@
+#ifndef _FASTMEM_API_H_
+#define _FASTMEM_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stddef.h>
+
+/*
+ * Memory and string routines replacing the generic ones of newlib and libncrt, they are
+ * linked before libc, so adding this middleware is enough to use them.
+ *
+ * - Default: word at a time versions, unaligned copies are merged from aligned words by
+ *   shifts, strlen and strcmp find zero bytes in a word with Zbb orc.b when compiled with
+ *   Zbb, or by the (x - 0x01..01) & ~x & 0x80..80 trick without it
+ * - FASTMEM_VECTOR=1 and compiled with vector extension: strip-mined RVV versions of
+ *   memcpy, memset, memcmp and strlen, they clobber vector registers, so interrupt
+ *   handlers calling them must save vector context, see __VECTOR_LazySave, it is off by
+ *   default for this reason
+ * - Copies shorter than FASTMEM_SMALL bytes are done bytewise, since setting up word
+ *   copy costs more than it saves
+ */
+
+#ifndef FASTMEM_SMALL
+#define FASTMEM_SMALL           (4 * sizeof(unsigned long))
+#endif
+
+void *memcpy(void *dst, const void *src, size_t n);
+void *memset(void *dst, int c, size_t n);
+int memcmp(const void *s1, const void *s2, size_t n);
+size_t strlen(const char *s);
+int strcmp(const char *s1, const char *s2);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_FASTMEM_API_H_ */
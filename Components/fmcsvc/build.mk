@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# fmcsvc middleware provides interrupt driven flash erase and program of the gd32vf103/gd32vw55x FMC
+# with SRAM resident burst programming, and a log-structured key-value store on it
+MIDDLEWARE_FMCSVC := $(NUCLEI_SDK_MIDDLEWARE)/fmcsvc
+
+C_SRCDIRS += $(MIDDLEWARE_FMCSVC)
+
+INCDIRS += $(MIDDLEWARE_FMCSVC)
@@ -0,0 +1,224 @@
+#include <stdint.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "fmcsvc_api.h"
+
+#define FMCKV_ERASED                0xFFFFFFFFUL
+/* area header: sequence number and its complement */
+#define FMCKV_AREA_HDR              8
+
+/* record: header word of key and length, data padded to words, commit word ~header */
+#define FMCKV_REC_HDR(key, len)     ((uint32_t)(key) | ((uint32_t)(len) << 16))
+#define FMCKV_REC_KEY(hdr)          ((hdr) & 0xFFFF)
+#define FMCKV_REC_LEN(hdr)          ((hdr) >> 16)
+#define FMCKV_REC_SIZE(len)         (8 + (((len) + 3) & ~3UL))
+
+static inline uint32_t fmckv_word(uint32_t addr)
+{
+    return *(volatile uint32_t *)(unsigned long)addr;
+}
+
+/* return 1 if the record at addr with header hdr is committed */
+static inline uint32_t fmckv_committed(uint32_t addr, uint32_t hdr)
+{
+    return (fmckv_word(addr + FMCKV_REC_SIZE(FMCKV_REC_LEN(hdr)) - 4) == ~hdr) ? 1 : 0;
+}
+
+static void fmckv_req(fmcsvc_req_t *req, uint8_t op, uint32_t addr, const void *data, uint32_t len)
+{
+    req->op = op;
+    req->addr = addr;
+    req->data = data;
+    req->len = len;
+    req->cb = NULL;
+    req->arg = NULL;
+}
+
+/* run reqs[0] ~ reqs[n - 1] back to back and wait for them, return 0 if all are done */
+static int32_t fmckv_run(fmckv_t *kv, uint32_t n)
+{
+    int32_t ret = 0;
+    uint32_t i;
+
+    for (i = 0; i < n; i++) {
+        if (fmcsvc_submit(&kv->reqs[i]) != 0) {
+            ret = -1;
+            n = i;
+            break;
+        }
+    }
+    for (i = 0; i < n; i++) {
+        if (fmcsvc_wait(&kv->reqs[i]) != FMCSVC_DONE) {
+            ret = -1;
+        }
+    }
+    return ret;
+}
+
+/* return sequence number of area at addr, 0 if it is not formatted */
+static uint32_t fmckv_area_seq(uint32_t addr)
+{
+    uint32_t seq = fmckv_word(addr);
+
+    if ((seq == 0) || (seq == FMCKV_ERASED) || (fmckv_word(addr + 4) != ~seq)) {
+        return 0;
+    }
+    return seq;
+}
+
+/* program area header at addr, the area is valid after it */
+static int32_t fmckv_area_header(fmckv_t *kv, uint32_t addr, uint32_t seq)
+{
+    kv->words[0] = seq;
+    kv->words[1] = ~seq;
+    fmckv_req(&kv->reqs[0], FMCSVC_PROGRAM, addr, kv->words, 8);
+    return fmckv_run(kv, 1);
+}
+
+/* find the end of log of active area */
+static void fmckv_scan(fmckv_t *kv)
+{
+    uint32_t off = FMCKV_AREA_HDR;
+    uint32_t hdr, size;
+
+    kv->full = 0;
+    while (off + 8 <= kv->size) {
+        hdr = fmckv_word(kv->active + off);
+        if (hdr == FMCKV_ERASED) {
+            break;
+        }
+        size = FMCKV_REC_SIZE(FMCKV_REC_LEN(hdr));
+        if ((FMCKV_REC_LEN(hdr) > FMCKV_MAX_LEN) || (off + size > kv->size)) {
+            // header cut by reset, the records before it are kept by next compaction
+            kv->full = 1;
+            break;
+        }
+        off += size;
+    }
+    kv->wr = off;
+}
+
+/* return offset of the last committed record of key in active area, 0 if none */
+static uint32_t fmckv_find(fmckv_t *kv, uint32_t key)
+{
+    uint32_t off, hdr, size, found = 0;
+
+    for (off = FMCKV_AREA_HDR; off < kv->wr; off += size) {
+        hdr = fmckv_word(kv->active + off);
+        size = FMCKV_REC_SIZE(FMCKV_REC_LEN(hdr));
+        if ((FMCKV_REC_KEY(hdr) == key) && fmckv_committed(kv->active + off, hdr)) {
+            found = off;
+        }
+    }
+    return found;
+}
+
+/* copy the last record of each key to the other area and make it active */
+static int32_t fmckv_compact(fmckv_t *kv)
+{
+    uint32_t dst = (kv->active == kv->base) ? (kv->base + kv->size) : kv->base;
+    uint32_t off, hdr, size, wr = FMCKV_AREA_HDR;
+
+    fmckv_req(&kv->reqs[0], FMCSVC_ERASE, dst, NULL, kv->size);
+    if (fmckv_run(kv, 1) != 0) {
+        return -1;
+    }
+    for (off = FMCKV_AREA_HDR; off < kv->wr; off += size) {
+        hdr = fmckv_word(kv->active + off);
+        size = FMCKV_REC_SIZE(FMCKV_REC_LEN(hdr));
+        // deleted keys and older values are dropped
+        if ((FMCKV_REC_LEN(hdr) == 0) || (fmckv_find(kv, FMCKV_REC_KEY(hdr)) != off)) {
+            continue;
+        }
+        // fmcsvc copies the data to RAM before each burst, so the source can be flash
+        fmckv_req(&kv->reqs[0], FMCSVC_PROGRAM, dst + wr, (const void *)(unsigned long)(kv->active + off), size);
+        if (fmckv_run(kv, 1) != 0) {
+            return -1;
+        }
+        wr += size;
+    }
+    // old area stays active until here
+    if (fmckv_area_header(kv, dst, kv->seq + 1) != 0) {
+        return -1;
+    }
+    kv->active = dst;
+    kv->seq++;
+    kv->wr = wr;
+    kv->full = 0;
+    return 0;
+}
+
+int32_t fmckv_init(fmckv_t *kv)
+{
+    uint32_t seq0, seq1;
+
+    if (((kv->base % FMCSVC_PAGE_SIZE) != 0) || ((kv->size % FMCSVC_PAGE_SIZE) != 0) || (kv->size == 0)) {
+        return -1;
+    }
+    seq0 = fmckv_area_seq(kv->base);
+    seq1 = fmckv_area_seq(kv->base + kv->size);
+    if ((seq0 == 0) && (seq1 == 0)) {
+        kv->active = kv->base;
+        kv->seq = 1;
+        fmckv_req(&kv->reqs[0], FMCSVC_ERASE, kv->active, NULL, kv->size);
+        if ((fmckv_run(kv, 1) != 0) || (fmckv_area_header(kv, kv->active, kv->seq) != 0)) {
+            return -1;
+        }
+    } else if (seq1 > seq0) {
+        kv->active = kv->base + kv->size;
+        kv->seq = seq1;
+    } else {
+        kv->active = kv->base;
+        kv->seq = seq0;
+    }
+    fmckv_scan(kv);
+    return 0;
+}
+
+int32_t fmckv_get(fmckv_t *kv, uint16_t key, void *buf, uint32_t len)
+{
+    uint32_t off = fmckv_find(kv, key);
+    uint32_t n;
+
+    if (off == 0) {
+        return -1;
+    }
+    n = FMCKV_REC_LEN(fmckv_word(kv->active + off));
+    if (n == 0) {
+        return -1;
+    }
+    memcpy(buf, (const void *)(unsigned long)(kv->active + off + 4), (n < len) ? n : len);
+    return (int32_t)n;
+}
+
+int32_t fmckv_set(fmckv_t *kv, uint16_t key, const void *data, uint32_t len)
+{
+    uint32_t size = FMCKV_REC_SIZE(len);
+    uint32_t addr, n = 0;
+    int32_t ret;
+
+    if ((key == 0xFFFF) || (len > FMCKV_MAX_LEN) || ((len != 0) && (data == NULL))) {
+        return -1;
+    }
+    if ((kv->full != 0) || (kv->wr + size > kv->size)) {
+        if ((fmckv_compact(kv) != 0) || (kv->wr + size > kv->size)) {
+            return -1;
+        }
+    }
+    addr = kv->active + kv->wr;
+    kv->words[0] = FMCKV_REC_HDR(key, len);
+    kv->words[1] = ~kv->words[0];
+    // header, data, then commit, queued back to back
+    fmckv_req(&kv->reqs[n++], FMCSVC_PROGRAM, addr, &kv->words[0], 4);
+    if (len != 0) {
+        fmckv_req(&kv->reqs[n++], FMCSVC_PROGRAM, addr + 4, data, len);
+    }
+    fmckv_req(&kv->reqs[n++], FMCSVC_PROGRAM, addr + size - 4, &kv->words[1], 4);
+    // the record takes its space even if it fails, it is never committed then
+    kv->wr += size;
+    ret = fmckv_run(kv, n);
+    if (ret != 0) {
+        kv->full = 1;
+    }
+    return ret;
+}
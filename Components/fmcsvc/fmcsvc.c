@@ -0,0 +1,218 @@
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "fmcsvc_api.h"
+
+#if defined(GD32VW55x_H)
+#define FMCSVC_CTL                  FMC_CTL
+#define FMCSVC_STAT                 FMC_STAT
+#define FMCSVC_ADDR                 FMC_ADDR
+#define FMCSVC_CTL_PG               FMC_CTL_PG
+#define FMCSVC_CTL_PER              FMC_CTL_PER
+#define FMCSVC_CTL_START            FMC_CTL_START
+#define FMCSVC_CTL_ERRIE            FMC_CTL_ERRIE
+#define FMCSVC_CTL_ENDIE            FMC_CTL_ENDIE
+#define FMCSVC_STAT_BUSY            FMC_STAT_BUSY
+#define FMCSVC_STAT_ENDF            FMC_STAT_ENDF
+#define FMCSVC_STAT_ERRORS          FMC_STAT_WPERR
+#else
+#define FMCSVC_CTL                  FMC_CTL0
+#define FMCSVC_STAT                 FMC_STAT0
+#define FMCSVC_ADDR                 FMC_ADDR0
+#define FMCSVC_CTL_PG               FMC_CTL0_PG
+#define FMCSVC_CTL_PER              FMC_CTL0_PER
+#define FMCSVC_CTL_START            FMC_CTL0_START
+#define FMCSVC_CTL_ERRIE            FMC_CTL0_ERRIE
+#define FMCSVC_CTL_ENDIE            FMC_CTL0_ENDIE
+#define FMCSVC_STAT_BUSY            FMC_STAT0_BUSY
+#define FMCSVC_STAT_ENDF            FMC_STAT0_ENDF
+#define FMCSVC_STAT_ERRORS          (FMC_STAT0_PGERR | FMC_STAT0_WPERR)
+#endif
+
+#define FMCSVC_CTL_STEP             (FMCSVC_CTL_PG | FMCSVC_CTL_PER | FMCSVC_CTL_ERRIE | FMCSVC_CTL_ENDIE)
+
+static fmcsvc_req_t *fmcsvc_head;
+static fmcsvc_req_t *fmcsvc_tail;
+/* bytes of running step */
+static uint32_t fmcsvc_step;
+/* words of running burst, read by SRAM code while flash is busy */
+static uint32_t fmcsvc_words[FMCSVC_BURST];
+
+/*
+ * Program n words of fmcsvc_words from addr, the last one ends by interrupt, return error
+ * flags of a polled one. It only touches registers and RAM, a flash fetch or read here
+ * would stall until the word is programmed.
+ */
+static __HOT_ILM uint32_t fmcsvc_program_burst(uint32_t addr, uint32_t n)
+{
+    uint32_t i, stat;
+
+    for (i = 0; i + 1 < n; i++) {
+        FMCSVC_CTL |= FMCSVC_CTL_PG;
+        REG32(addr) = fmcsvc_words[i];
+        do {
+            stat = FMCSVC_STAT;
+        } while ((stat & FMCSVC_STAT_BUSY) != 0);
+        FMCSVC_CTL &= ~FMCSVC_CTL_PG;
+        FMCSVC_STAT = stat & (FMCSVC_STAT_ENDF | FMCSVC_STAT_ERRORS);
+        if ((stat & FMCSVC_STAT_ERRORS) != 0) {
+            return stat & FMCSVC_STAT_ERRORS;
+        }
+        addr += 4;
+    }
+    FMCSVC_CTL |= FMCSVC_CTL_PG | FMCSVC_CTL_ERRIE | FMCSVC_CTL_ENDIE;
+    REG32(addr) = fmcsvc_words[n - 1];
+    return 0;
+}
+
+/* copy the data of next burst of req to fmcsvc_words while flash is idle, return words */
+static uint32_t fmcsvc_stage(fmcsvc_req_t *req)
+{
+    const uint8_t *src = (const uint8_t *)req->data + req->done;
+    uint32_t bytes = req->len - req->done;
+    uint32_t i, b, word;
+
+    if (bytes > FMCSVC_BURST * 4) {
+        bytes = FMCSVC_BURST * 4;
+    }
+    fmcsvc_step = bytes;
+    // data may be unaligned, bytes past len are left erased
+    for (i = 0; i < bytes; i += 4) {
+        word = 0xFFFFFFFFUL;
+        for (b = 0; (b < 4) && (i + b < bytes); b++) {
+            word &= ~(0xFFUL << (b * 8));
+            word |= (uint32_t)src[i + b] << (b * 8);
+        }
+        fmcsvc_words[i / 4] = word;
+    }
+    return (bytes + 3) / 4;
+}
+
+/* start next step of req with interrupts disabled, return 0 if started, 1 if req is complete, -1 on error */
+static int32_t fmcsvc_start(fmcsvc_req_t *req)
+{
+    if (req->done >= req->len) {
+        return 1;
+    }
+    FMCSVC_STAT = FMCSVC_STAT_ENDF | FMCSVC_STAT_ERRORS;
+    if (req->op == FMCSVC_ERASE) {
+        fmcsvc_step = FMCSVC_PAGE_SIZE;
+        FMCSVC_CTL |= FMCSVC_CTL_PER;
+        FMCSVC_ADDR = req->addr + req->done;
+        FMCSVC_CTL |= FMCSVC_CTL_START | FMCSVC_CTL_ERRIE | FMCSVC_CTL_ENDIE;
+        return 0;
+    }
+    if (fmcsvc_program_burst(req->addr + req->done, fmcsvc_stage(req)) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Go on with queued requests with interrupts disabled, ret is -1 if the step of head failed,
+ * requests ended are unlinked and returned as a list for their callbacks
+ */
+static fmcsvc_req_t *fmcsvc_run(int32_t ret)
+{
+    fmcsvc_req_t *req, *ended = NULL, **last = &ended;
+
+    while ((req = fmcsvc_head) != NULL) {
+        if (ret == 0) {
+            ret = fmcsvc_start(req);
+            if (ret == 0) {
+                return ended;
+            }
+        }
+        fmcsvc_head = req->next;
+        req->next = NULL;
+        req->status = (ret > 0) ? FMCSVC_DONE : FMCSVC_ERROR;
+        *last = req;
+        last = &req->next;
+        ret = 0;
+    }
+    fmcsvc_tail = NULL;
+    fmc_lock();
+    return ended;
+}
+
+static void fmcsvc_complete(fmcsvc_req_t *ended)
+{
+    fmcsvc_req_t *next;
+
+    while (ended != NULL) {
+        next = ended->next;
+        if (ended->cb != NULL) {
+            ended->cb(ended, ended->arg);
+        }
+        ended = next;
+    }
+}
+
+static void fmcsvc_irq_handler(void)
+{
+    fmcsvc_req_t *ended = NULL;
+    uint32_t stat = FMCSVC_STAT;
+    rv_csr_t mstatus;
+
+    FMCSVC_CTL &= ~FMCSVC_CTL_STEP;
+    FMCSVC_STAT = stat & (FMCSVC_STAT_ENDF | FMCSVC_STAT_ERRORS);
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if ((fmcsvc_head != NULL) && ((stat & (FMCSVC_STAT_ENDF | FMCSVC_STAT_ERRORS)) != 0)) {
+        if ((stat & FMCSVC_STAT_ERRORS) == 0) {
+            fmcsvc_head->done += fmcsvc_step;
+            ended = fmcsvc_run(0);
+        } else {
+            ended = fmcsvc_run(-1);
+        }
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    fmcsvc_complete(ended);
+}
+
+int32_t fmcsvc_init(uint8_t lvl)
+{
+    FMCSVC_CTL &= ~FMCSVC_CTL_STEP;
+    fmcsvc_head = NULL;
+    fmcsvc_tail = NULL;
+    return ECLIC_Register_IRQ(FMC_IRQn, ECLIC_NON_VECTOR_INTERRUPT, ECLIC_LEVEL_TRIGGER, lvl, 0,
+                              (void *)fmcsvc_irq_handler);
+}
+
+int32_t fmcsvc_submit(fmcsvc_req_t *req)
+{
+    fmcsvc_req_t *ended = NULL;
+    rv_csr_t mstatus;
+
+    if ((req->len == 0) || ((req->addr & 3) != 0) ||
+        ((req->op == FMCSVC_ERASE) && ((req->addr % FMCSVC_PAGE_SIZE) != 0)) ||
+        ((req->op == FMCSVC_PROGRAM) && (req->data == NULL)) ||
+        ((req->op != FMCSVC_ERASE) && (req->op != FMCSVC_PROGRAM))) {
+        return -1;
+    }
+    req->next = NULL;
+    req->done = 0;
+    req->status = FMCSVC_PENDING;
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if (fmcsvc_tail != NULL) {
+        fmcsvc_tail->next = req;
+        fmcsvc_tail = req;
+    } else {
+        fmcsvc_head = req;
+        fmcsvc_tail = req;
+        fmc_unlock();
+        ended = fmcsvc_run(0);
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    // a burst failed at once
+    fmcsvc_complete(ended);
+    return 0;
+}
+
+int32_t fmcsvc_wait(fmcsvc_req_t *req)
+{
+    return __wfi_while_pending(&req->status, FMCSVC_PENDING);
+}
+
+uint32_t fmcsvc_busy(void)
+{
+    return (fmcsvc_head != NULL) ? 1 : 0;
+}
@@ -0,0 +1,126 @@
+#ifndef _FMCSVC_API_H_
+#define _FMCSVC_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+
+/*
+ * Background flash erase and program service for the gd32vf103 and gd32vw55x FMC.
+ *
+ * - Requests: caller owned erase or program requests are queued, each one is split into
+ *   steps of one page erase or one burst of FMCSVC_BURST words, a step is started from
+ *   the FMC end of operation interrupt of the previous one, so the caller does not poll
+ *   and pending interrupts are taken between steps, instead of after the whole operation
+ * - RAM resident: the burst loop runs from .ilm_text (__HOT_ILM), which the linker script
+ *   places in SRAM, since a flash fetch while the FMC is busy stalls until the operation
+ *   ends, code running from SRAM, and DMA, go on during a step, flash code waits for it.
+ *   Program data is copied to a RAM buffer before each burst, so it may also be in flash
+ * - Key-value store: fmckv is a log-structured store of small records on two areas of
+ *   pages, a write appends one record, so it programs a few words and does not erase,
+ *   the erase is only done when the area is full and live records are compacted to the
+ *   other area
+ *
+ * Callbacks run in the FMC interrupt handler, in RTOS give a semaphore or task notification
+ * from it, in bare-metal fmcsvc_wait() sleeps until the request completes.
+ */
+
+#if defined(GD32VW55x_H)
+#define FMCSVC_PAGE_SIZE            4096
+#elif defined(__GD32VF103_H__)
+#define FMCSVC_PAGE_SIZE            1024
+#else
+#error "fmcsvc middleware only supports gd32vf103 and gd32vw55x"
+#endif
+
+/*
+ * words programmed by one step, all but the last one are polled by SRAM code with interrupts
+ * disabled, so interrupts wait for up to FMCSVC_BURST - 1 word program times
+ */
+#ifndef FMCSVC_BURST
+#define FMCSVC_BURST                8
+#endif
+
+/* request operation */
+#define FMCSVC_ERASE                0       /* erase pages of addr ~ addr + len - 1 */
+#define FMCSVC_PROGRAM              1       /* program len bytes of data at addr */
+
+/* request status */
+#define FMCSVC_DONE                 0
+#define FMCSVC_PENDING              1
+#define FMCSVC_ERROR                -1
+
+struct fmcsvc_req;
+/* completion callback of request, called in interrupt */
+typedef void (*fmcsvc_cb_t)(struct fmcsvc_req *req, void *arg);
+
+/* erase or program request, owned by caller until completed */
+typedef struct fmcsvc_req {
+    struct fmcsvc_req *next;
+    uint8_t op;                     /* FMCSVC_ERASE or FMCSVC_PROGRAM */
+    uint32_t addr;                  /* word aligned, page aligned for FMCSVC_ERASE */
+    const void *data;               /* data of FMCSVC_PROGRAM */
+    uint32_t len;                   /* bytes, the last word of program is padded by 0xFF */
+    fmcsvc_cb_t cb;                 /* completion callback, can be NULL */
+    void *arg;
+    volatile int32_t status;        /* FMCSVC_PENDING when queued, FMCSVC_DONE or FMCSVC_ERROR */
+    /* private */
+    uint32_t done;                  /* bytes erased or programmed */
+} fmcsvc_req_t;
+
+/* Install FMC interrupt handler at level lvl, return 0 on success */
+int32_t fmcsvc_init(uint8_t lvl);
+
+/* Queue req, return 0 on success, -1 on invalid argument */
+int32_t fmcsvc_submit(fmcsvc_req_t *req);
+
+/* Sleep until req completes in bare-metal, return status of req */
+int32_t fmcsvc_wait(fmcsvc_req_t *req);
+
+/* Return 1 if requests are queued */
+uint32_t fmcsvc_busy(void);
+
+/*
+ * Log-structured key-value store on fmcsvc
+ *
+ * Two areas of size bytes at base and base + size hold records of key, length, data and
+ * a commit word programmed last, so a record cut by reset is skipped. The area with the
+ * larger sequence number in its header is the active one, records are appended to it,
+ * the last committed record of a key is its value, a record of length 0 deletes the key.
+ * When the active area is full, the other one is erased, the last record of each key is
+ * copied to it, then its header is programmed, so a reset during compaction keeps the
+ * old area. fmckv_set() waits for its requests, so it must not be called in interrupt.
+ */
+/* most data bytes of one record */
+#ifndef FMCKV_MAX_LEN
+#define FMCKV_MAX_LEN               256
+#endif
+
+typedef struct fmckv {
+    uint32_t base;                  /* address of first area, page aligned */
+    uint32_t size;                  /* bytes of one area, multiple of FMCSVC_PAGE_SIZE */
+    /* private */
+    uint32_t active;                /* address of active area */
+    uint32_t seq;                   /* sequence number of active area */
+    uint32_t wr;                    /* offset of next record in active area */
+    uint32_t full;                  /* a broken record ends the log, compact before next write */
+    uint32_t words[2];              /* header and commit word being programmed */
+    fmcsvc_req_t reqs[3];
+} fmckv_t;
+
+/* Mount the store, the areas are formatted if none is valid, return 0 on success */
+int32_t fmckv_init(fmckv_t *kv);
+
+/* Copy value of key to buf up to len bytes, return the length of value, -1 if not found */
+int32_t fmckv_get(fmckv_t *kv, uint16_t key, void *buf, uint32_t len);
+
+/* Set value of key, 0 ~ 0xFFFE, len 0 deletes it, return 0 on success, -1 on error or full */
+int32_t fmckv_set(fmckv_t *kv, uint16_t key, const void *data, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _FMCSVC_API_H_ */
@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# hal middleware provides one async UART, SPI, I2C and DMA device model over evalsoc uart_buffered
+# and gd32vf103/gd32vw55x dmaq, selected at compile time, add dmaq to MIDDLEWARE too on gd32
+MIDDLEWARE_HAL := $(NUCLEI_SDK_MIDDLEWARE)/hal
+
+C_SRCDIRS += $(MIDDLEWARE_HAL)
+
+INCDIRS += $(MIDDLEWARE_HAL)
@@ -0,0 +1,199 @@
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "hal_api.h"
+
+#if HAL_HAS_DMA
+
+static void hal_uart_req_done(dmaq_req_t *req, void *arg)
+{
+    hal_uart_xfer_t *xfer = (hal_uart_xfer_t *)arg;
+
+    xfer->status = (req->status == DMAQ_DONE) ? HAL_DONE : HAL_ERROR;
+    if (xfer->cb != NULL) {
+        xfer->cb(xfer, xfer->arg);
+    }
+}
+
+int32_t hal_uart_init(hal_uart_t *uart, const hal_uart_cfg_t *cfg, uint8_t lvl)
+{
+    dmaq_uart_t *dev = &uart->dev;
+
+    usart_baudrate_set(cfg->periph, cfg->baudrate);
+    usart_word_length_set(cfg->periph, USART_WL_8BIT);
+    usart_stop_bit_set(cfg->periph, USART_STB_1BIT);
+    usart_parity_config(cfg->periph, USART_PM_NONE);
+    usart_receive_config(cfg->periph, USART_RECEIVE_ENABLE);
+    usart_transmit_config(cfg->periph, USART_TRANSMIT_ENABLE);
+    usart_enable(cfg->periph);
+    if ((dmaq_chan_init(cfg->tx_chan, cfg->tx_sub, DMA_PRIORITY_LOW, lvl) != 0) ||
+        (dmaq_chan_init(cfg->rx_chan, cfg->rx_sub, DMA_PRIORITY_LOW, lvl) != 0)) {
+        return -1;
+    }
+    dev->periph = cfg->periph;
+    dev->irqn = cfg->irqn;
+    dev->tx_chan = cfg->tx_chan;
+    dev->rx_chan = cfg->rx_chan;
+    dev->rxbuf = cfg->rxbuf;
+    dev->rxsize = cfg->rxsize;
+    dev->rx_cb = NULL;
+    dev->arg = NULL;
+    return dmaq_uart_init(dev, lvl);
+}
+
+int32_t hal_uart_write(hal_uart_t *uart, hal_uart_xfer_t *xfer)
+{
+    dmaq_uart_sg_t sg;
+
+    if ((xfer->buf == NULL) || (xfer->len == 0) || (xfer->len > 0xFFFF)) {
+        return -1;
+    }
+    sg.buf = xfer->buf;
+    sg.len = xfer->len;
+    xfer->next = NULL;
+    xfer->status = HAL_PENDING;
+    if (dmaq_uart_write_sg(&uart->dev, &xfer->req, &sg, 1, hal_uart_req_done, xfer) != 0) {
+        xfer->status = HAL_ERROR;
+        return -1;
+    }
+    return 0;
+}
+
+uint32_t hal_uart_read(hal_uart_t *uart, void *buf, uint32_t len)
+{
+    return dmaq_uart_read(&uart->dev, buf, len);
+}
+
+#else
+
+static hal_uart_t *hal_uarts[HAL_UART_MAX];
+
+/* copy queued writes into tx ring with interrupts disabled, return the writes completed */
+static hal_uart_xfer_t *hal_uart_push(hal_uart_t *uart)
+{
+    UART_RING_Type *tx = &uart->dev.tx;
+    hal_uart_xfer_t *xfer, *ended = NULL, **last = &ended;
+    const uint8_t *data;
+    uint32_t head = tx->head;
+
+    while ((xfer = uart->head) != NULL) {
+        data = (const uint8_t *)xfer->buf;
+        while ((xfer->done < xfer->len) && ((head - tx->tail) < tx->size)) {
+            tx->buf[head & (tx->size - 1)] = data[xfer->done++];
+            head++;
+        }
+        if (xfer->done < xfer->len) {
+            break;
+        }
+        uart->head = xfer->next;
+        xfer->next = NULL;
+        xfer->status = HAL_DONE;
+        *last = xfer;
+        last = &xfer->next;
+    }
+    if (uart->head == NULL) {
+        uart->tail = NULL;
+    }
+    tx->head = head;
+    // the tx interrupt moves the ring into tx fifo
+    if (head != tx->tail) {
+        uart->dev.uart->IE |= UART_IE_TXIE_MASK;
+    }
+    return ended;
+}
+
+static void hal_uart_complete(hal_uart_xfer_t *ended)
+{
+    hal_uart_xfer_t *next;
+
+    while (ended != NULL) {
+        next = ended->next;
+        if (ended->cb != NULL) {
+            ended->cb(ended, ended->arg);
+        }
+        ended = next;
+    }
+}
+
+static void hal_uart_irq(uint32_t idx)
+{
+    hal_uart_t *uart = hal_uarts[idx];
+    hal_uart_xfer_t *ended;
+    rv_csr_t mstatus;
+
+    uart_buffered_irq_handler(&uart->dev);
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    ended = hal_uart_push(uart);
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    hal_uart_complete(ended);
+}
+
+#define HAL_UART_IRQ_HANDLER(n)     static void hal_uart_irq_handler##n(void) { hal_uart_irq(n); }
+HAL_UART_IRQ_HANDLER(0)
+HAL_UART_IRQ_HANDLER(1)
+
+#if HAL_UART_MAX > 2
+#error "HAL_UART_MAX larger than 2 needs more hal_uart_irq_handler"
+#endif
+
+static void (*const hal_uart_irq_handlers[2])(void) = {
+    hal_uart_irq_handler0, hal_uart_irq_handler1
+};
+
+int32_t hal_uart_init(hal_uart_t *uart, const hal_uart_cfg_t *cfg, uint8_t lvl)
+{
+    uint32_t i, idx = HAL_UART_MAX;
+
+    for (i = 0; i < HAL_UART_MAX; i++) {
+        if ((hal_uarts[i] == uart) || ((hal_uarts[i] == NULL) && (idx == HAL_UART_MAX))) {
+            idx = i;
+        }
+    }
+    if ((idx == HAL_UART_MAX) || (uart_init(cfg->uart, cfg->baudrate) != 0) ||
+        (uart_buffered_init(&uart->dev, cfg->uart, cfg->txbuf, cfg->txsize, cfg->rxbuf, cfg->rxsize) != 0)) {
+        return -1;
+    }
+    uart->head = NULL;
+    uart->tail = NULL;
+    hal_uarts[idx] = uart;
+    return ECLIC_Register_IRQ(cfg->irqn, ECLIC_NON_VECTOR_INTERRUPT, ECLIC_LEVEL_TRIGGER, lvl, 0,
+                              (void *)hal_uart_irq_handlers[idx]);
+}
+
+int32_t hal_uart_write(hal_uart_t *uart, hal_uart_xfer_t *xfer)
+{
+    hal_uart_xfer_t *ended;
+    rv_csr_t mstatus;
+
+    if ((xfer->buf == NULL) || (xfer->len == 0) || (xfer->len > 0xFFFF) || (uart->dev.uart == NULL)) {
+        return -1;
+    }
+    xfer->next = NULL;
+    xfer->done = 0;
+    xfer->status = HAL_PENDING;
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if (uart->tail != NULL) {
+        uart->tail->next = xfer;
+    } else {
+        uart->head = xfer;
+    }
+    uart->tail = xfer;
+    ended = hal_uart_push(uart);
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    // a write fitting in the ring completes at once
+    hal_uart_complete(ended);
+    return 0;
+}
+
+uint32_t hal_uart_read(hal_uart_t *uart, void *buf, uint32_t len)
+{
+    int32_t ret = uart_buffered_read(&uart->dev, (uint8_t *)buf, len, 0);
+
+    return (ret < 0) ? 0 : (uint32_t)ret;
+}
+
+#endif
+
+int32_t hal_uart_wait(hal_uart_xfer_t *xfer)
+{
+    return __wfi_while_pending(&xfer->status, HAL_PENDING);
+}
@@ -0,0 +1,183 @@
+#ifndef _HAL_API_H_
+#define _HAL_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+
+/*
+ * Device model shared by evalsoc, gd32vf103 and gd32vw55x, so portable middleware uses one
+ * asynchronous API instead of the polled lowest common path of three driver APIs.
+ *
+ * - Static dispatch: the backend is selected at compile time by the SoC header, the device
+ *   types are the backend types and the calls are inline wrappers or direct calls, there is
+ *   no table of function pointers on the transfer path
+ * - Async: a transfer is a caller owned descriptor, submit queues it and returns, its status
+ *   is HAL_PENDING until it completes, then its callback is called in interrupt, the wait
+ *   functions sleep in bare-metal until it completes
+ * - Backends: gd32vf103 and gd32vw55x use dmaq for UART, SPI, I2C and DMA, evalsoc has only
+ *   the UART, which uses the interrupt driven uart_buffered ring. HAL_HAS_* tell which
+ *   classes the SoC has, so middleware can fall back at compile time
+ *
+ * Configuration is SoC specific and given once in hal_*_cfg_t by the board, the transfer
+ * API is the same on all SoCs. A UART write completes when its buffer can be reused, after
+ * DMA took the last byte on gd32, after it is copied into the tx ring on evalsoc.
+ */
+
+#if defined(__GD32VF103_H__) || defined(GD32VW55x_H)
+#include "dmaq_api.h"
+#define HAL_HAS_UART                1
+#define HAL_HAS_SPI                 1
+#define HAL_HAS_I2C                 1
+#define HAL_HAS_DMA                 1
+#elif defined(__EVALSOC_H__)
+#define HAL_HAS_UART                1
+#define HAL_HAS_SPI                 0
+#define HAL_HAS_I2C                 0
+#define HAL_HAS_DMA                 0
+#else
+#error "hal middleware only supports evalsoc, gd32vf103 and gd32vw55x"
+#endif
+
+/* transfer status */
+#define HAL_DONE                    0
+#define HAL_PENDING                 1
+#define HAL_ERROR                   -1
+
+/* max number of UARTs on evalsoc, gd32 uses DMAQ_UART_MAX */
+#ifndef HAL_UART_MAX
+#define HAL_UART_MAX                2
+#endif
+
+struct hal_uart_xfer;
+/* UART write callback, called in interrupt */
+typedef void (*hal_uart_cb_t)(struct hal_uart_xfer *xfer, void *arg);
+
+/* UART write, owned by caller until completed */
+typedef struct hal_uart_xfer {
+    struct hal_uart_xfer *next;
+    const void *buf;
+    uint32_t len;                   /* bytes, 1 ~ 65535 */
+    hal_uart_cb_t cb;               /* can be NULL */
+    void *arg;
+    volatile int32_t status;        /* HAL_PENDING when queued, HAL_DONE or HAL_ERROR */
+    /* private */
+#if HAL_HAS_DMA
+    dmaq_req_t req;
+#endif
+    uint32_t done;                  /* bytes copied into tx ring */
+} hal_uart_xfer_t;
+
+#if HAL_HAS_DMA
+/* UART of gd32, the USART clock and pins are set up by caller */
+typedef struct hal_uart_cfg {
+    uint32_t periph;                /* USARTx */
+    IRQn_Type irqn;                 /* interrupt of USARTx */
+    uint32_t baudrate;
+    uint32_t tx_chan;               /* dmaq channel of transmission */
+    uint32_t tx_sub;                /* DMA_SUBPERIx of transmission on gd32vw55x */
+    uint32_t rx_chan;               /* dmaq channel of reception */
+    uint32_t rx_sub;                /* DMA_SUBPERIx of reception on gd32vw55x */
+    uint8_t *rxbuf;                 /* ring of reception */
+    uint32_t rxsize;                /* size of rxbuf, even */
+} hal_uart_cfg_t;
+
+typedef struct hal_uart {
+    dmaq_uart_t dev;
+} hal_uart_t;
+#else
+/* UART of evalsoc */
+typedef struct hal_uart_cfg {
+    UART_TypeDef *uart;
+    IRQn_Type irqn;                 /* interrupt of uart */
+    uint32_t baudrate;
+    uint8_t *txbuf;                 /* tx ring, size power of 2 */
+    uint32_t txsize;
+    uint8_t *rxbuf;                 /* rx ring, size power of 2 */
+    uint32_t rxsize;
+} hal_uart_cfg_t;
+
+typedef struct hal_uart {
+    UART_BUFFERED_Type dev;
+    /* private */
+    hal_uart_xfer_t *head;          /* writes not copied into tx ring yet */
+    hal_uart_xfer_t *tail;
+} hal_uart_t;
+#endif
+
+/* Set up UART, its transfers and interrupts at level lvl, return 0 on success, -1 on error */
+int32_t hal_uart_init(hal_uart_t *uart, const hal_uart_cfg_t *cfg, uint8_t lvl);
+
+/* Queue write of xfer, return 0 on success, -1 on invalid argument */
+int32_t hal_uart_write(hal_uart_t *uart, hal_uart_xfer_t *xfer);
+
+/* Sleep until xfer completes in bare-metal, return status of xfer */
+int32_t hal_uart_wait(hal_uart_xfer_t *xfer);
+
+/* Copy received data up to len bytes to buf, return bytes copied, it doesn't block */
+uint32_t hal_uart_read(hal_uart_t *uart, void *buf, uint32_t len);
+
+#if HAL_HAS_DMA
+/* SPI, I2C and DMA are the dmaq objects, see dmaq_api.h for their fields */
+typedef dmaq_spi_t hal_spi_t;
+typedef dmaq_spi_xfer_t hal_spi_xfer_t;
+typedef dmaq_i2c_t hal_i2c_t;
+typedef dmaq_i2c_xfer_t hal_i2c_xfer_t;
+typedef dmaq_req_t hal_dma_req_t;
+
+/* Set up SPI on its dmaq channels, return 0 on success */
+__STATIC_FORCEINLINE int32_t hal_spi_init(hal_spi_t *spi)
+{
+    return dmaq_spi_init(spi);
+}
+
+/* Queue SPI transaction, return 0 on success, -1 on invalid argument */
+__STATIC_FORCEINLINE int32_t hal_spi_submit(hal_spi_t *spi, hal_spi_xfer_t *xfer)
+{
+    return dmaq_spi_submit(spi, xfer);
+}
+
+/* Sleep until SPI transaction completes, return its status */
+__STATIC_FORCEINLINE int32_t hal_spi_wait(hal_spi_xfer_t *xfer)
+{
+    return dmaq_spi_wait(xfer);
+}
+
+/* Set up I2C and its interrupts at level lvl, return 0 on success */
+__STATIC_FORCEINLINE int32_t hal_i2c_init(hal_i2c_t *i2c, uint8_t lvl)
+{
+    return dmaq_i2c_init(i2c, lvl);
+}
+
+/* Queue I2C transaction, return 0 on success, -1 on invalid argument */
+__STATIC_FORCEINLINE int32_t hal_i2c_submit(hal_i2c_t *i2c, hal_i2c_xfer_t *xfer)
+{
+    return dmaq_i2c_submit(i2c, xfer);
+}
+
+/* Sleep until I2C transaction completes, return its status */
+__STATIC_FORCEINLINE int32_t hal_i2c_wait(hal_i2c_xfer_t *xfer)
+{
+    return dmaq_i2c_wait(xfer);
+}
+
+/* Queue DMA request on chan, return 0 on success, -1 on error */
+__STATIC_FORCEINLINE int32_t hal_dma_submit(uint32_t chan, hal_dma_req_t *req)
+{
+    return dmaq_submit(chan, req);
+}
+
+/* Sleep until DMA request completes, return its status */
+__STATIC_FORCEINLINE int32_t hal_dma_wait(hal_dma_req_t *req)
+{
+    return dmaq_wait(req);
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _HAL_API_H_ */
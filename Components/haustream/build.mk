@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# haustream middleware runs incremental SHA/MD5/HMAC on gd32vw55x HAU with DMA fed
+# input and interleaved streams by context save/restore, add dmaq to MIDDLEWARE too
+MIDDLEWARE_HAUSTREAM := $(NUCLEI_SDK_MIDDLEWARE)/haustream
+
+C_SRCDIRS += $(MIDDLEWARE_HAUSTREAM)
+
+INCDIRS += $(MIDDLEWARE_HAUSTREAM)
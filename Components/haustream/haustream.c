@@ -0,0 +1,215 @@
+#include <stdint.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "haustream_api.h"
+
+/* words of one DMA transfer, below 65535 and a multiple of the block */
+#define HAUS_DMA_WORDS              0xFFF0
+
+#define HAUS_DI_ADDR                ((uint32_t)(unsigned long)&HAU_DI)
+
+static uint32_t haus_chan = HAUSTREAM_NO_DMA;
+/* stream whose state is loaded in the HAU */
+static haustream_t *haus_owner = NULL;
+
+static inline void haus_wait_idle(void)
+{
+    while ((HAU_STAT & HAU_STAT_BUSY) != 0) {
+    }
+}
+
+/* make hs the owner of the HAU, saving the state of the stream owning it before */
+static void haus_own(haustream_t *hs)
+{
+    if (haus_owner == hs) {
+        return;
+    }
+    if (haus_owner != NULL) {
+        haus_wait_idle();
+        hau_context_save(&haus_owner->ctx);
+    }
+    hau_context_restore(&hs->ctx);
+    haus_owner = hs;
+}
+
+/* write len bytes by CPU, data may be unaligned, the bus waits while the FIFO is full */
+static void haus_cpu(const uint8_t *data, uint32_t len)
+{
+    uint32_t val;
+
+    while (len >= 4) {
+        memcpy(&val, data, 4);
+        HAU_DI = val;
+        data += 4;
+        len -= 4;
+    }
+    if (len > 0) {
+        val = 0;
+        memcpy(&val, data, len);
+        HAU_DI = val;
+    }
+}
+
+/* write len bytes of whole blocks, by DMA if possible */
+static int32_t haus_blocks(const uint8_t *data, uint32_t len)
+{
+    dmaq_req_t req;
+    uint32_t words;
+    int32_t ret = 0;
+
+    if ((haus_chan == HAUSTREAM_NO_DMA) || (len < HAUSTREAM_DMA_MIN) || (((unsigned long)data & 3) != 0)) {
+        haus_cpu(data, len);
+        return 0;
+    }
+    // CALEN is only set by finish, not at the end of each transfer
+    hau_multiple_single_dma_config(MULTIPLE_DMA_NO_DIGEST);
+    while ((len > 0) && (ret == 0)) {
+        words = len / 4;
+        if (words > HAUS_DMA_WORDS) {
+            words = HAUS_DMA_WORDS;
+        }
+        req.periph_addr = HAUS_DI_ADDR;
+        req.mem = (void *)data;
+        req.count = words;
+        req.dir = DMAQ_DIR_M2P;
+        req.width = 4;
+        req.periph_inc = 0;
+        req.mem_inc = 1;
+        req.cb = NULL;
+        req.arg = NULL;
+        if (dmaq_submit(haus_chan, &req) != 0) {
+            ret = -1;
+            break;
+        }
+        hau_dma_enable();
+        if (dmaq_wait(&req) != DMAQ_DONE) {
+            ret = -1;
+        }
+        hau_dma_disable();
+        data += words * 4;
+        len -= words * 4;
+    }
+    haus_wait_idle();
+    return ret;
+}
+
+/* write key and close it, the first and last step of HMAC */
+static void haus_key(haustream_t *hs)
+{
+    hau_last_word_validbits_num_config(8 * (hs->keylen % 4));
+    haus_cpu(hs->key, hs->keylen);
+    hau_digest_calculation_enable();
+    haus_wait_idle();
+}
+
+int32_t haustream_init(uint32_t dma_chan)
+{
+    rcu_periph_clock_enable(RCU_HAU);
+    haus_chan = dma_chan;
+    haus_owner = NULL;
+    return 0;
+}
+
+int32_t haustream_start(haustream_t *hs, uint32_t algo, const uint8_t *key, uint32_t keylen)
+{
+    hau_init_parameter_struct init_para;
+
+    if ((algo != HAU_ALGO_SHA1) && (algo != HAU_ALGO_SHA224) && (algo != HAU_ALGO_SHA256) &&
+        (algo != HAU_ALGO_MD5)) {
+        return -1;
+    }
+    hs->key = key;
+    hs->keylen = (key != NULL) ? keylen : 0;
+    hs->algo = algo;
+    hs->fill = 0;
+
+    // the new stream takes the HAU, its state is set up below instead of restored
+    if ((haus_owner != NULL) && (haus_owner != hs)) {
+        haus_wait_idle();
+        hau_context_save(&haus_owner->ctx);
+    }
+    haus_owner = hs;
+    hau_dma_disable();
+    init_para.algo = algo;
+    init_para.mode = (key != NULL) ? HAU_MODE_HMAC : HAU_MODE_HASH;
+    init_para.datatype = HAU_SWAPPING_8BIT;
+    init_para.keytype = (keylen > 64) ? HAU_KEY_LONGGER_64 : HAU_KEY_SHORTER_64;
+    hau_init(&init_para);
+    if (key != NULL) {
+        haus_key(hs);
+    }
+    return 0;
+}
+
+int32_t haustream_update(haustream_t *hs, const uint8_t *data, uint32_t len)
+{
+    uint8_t *buf = (uint8_t *)hs->buf;
+    uint32_t take;
+
+    if (len == 0) {
+        return 0;
+    }
+    haus_own(hs);
+    while (len > 0) {
+        if (hs->fill == HAUSTREAM_BLOCK_SIZE) {
+            // more data follows, so the buffered block is not the last one
+            haus_cpu(buf, HAUSTREAM_BLOCK_SIZE);
+            hs->fill = 0;
+        }
+        if ((hs->fill == 0) && (len > HAUSTREAM_BLOCK_SIZE)) {
+            // keep 1 ~ 64 bytes back for finish
+            take = (len - 1) & ~(uint32_t)(HAUSTREAM_BLOCK_SIZE - 1);
+            if (haus_blocks(data, take) != 0) {
+                return -1;
+            }
+            data += take;
+            len -= take;
+        }
+        take = HAUSTREAM_BLOCK_SIZE - hs->fill;
+        if (take > len) {
+            take = len;
+        }
+        memcpy(buf + hs->fill, data, take);
+        hs->fill += take;
+        data += take;
+        len -= take;
+    }
+    return 0;
+}
+
+int32_t haustream_finish(haustream_t *hs, uint8_t *digest)
+{
+    hau_digest_parameter_struct out;
+    uint32_t words, i, val;
+
+    switch (hs->algo) {
+        case HAU_ALGO_SHA1:
+            words = 5;
+            break;
+        case HAU_ALGO_SHA224:
+            words = 7;
+            break;
+        case HAU_ALGO_SHA256:
+            words = 8;
+            break;
+        default:
+            words = 4;
+            break;
+    }
+    haus_own(hs);
+    hau_last_word_validbits_num_config(8 * (hs->fill % 4));
+    haus_cpu((const uint8_t *)hs->buf, hs->fill);
+    hau_digest_calculation_enable();
+    haus_wait_idle();
+    if (hs->key != NULL) {
+        haus_key(hs);
+    }
+    hau_digest_read(&out);
+    for (i = 0; i < words; i++) {
+        val = __REV(out.out[i]);
+        memcpy(digest + i * 4, &val, 4);
+    }
+    hs->fill = 0;
+    haus_owner = NULL;
+    return words * 4;
+}
@@ -0,0 +1,71 @@
+#ifndef _HAUSTREAM_API_H_
+#define _HAUSTREAM_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "dmaq_api.h"
+
+/*
+ * Incremental SHA1/SHA224/SHA256/MD5 and HMAC on the gd32vw55x HAU, for data arriving in
+ * pieces such as an OTA image read from flash or received from network.
+ *
+ * - Update/finish: only whole 64 bytes blocks are written to the HAU while more data may
+ *   follow, the rest is kept in the stream until the next update, the last 1 ~ 64 bytes are
+ *   written by haustream_finish() with the valid bits of the last word
+ * - Interleaved streams: the last used stream owns the HAU, a call on another stream saves
+ *   the owner by hau_context_save() and restores the caller by hau_context_restore()
+ * - DMA: blocks of HAUSTREAM_DMA_MIN bytes or more from 4 bytes aligned data go to HAU_DI by
+ *   dmaq in multiple DMA mode, so the digest is not closed at the end of each transfer
+ *
+ * The HMAC key is used again by haustream_finish() and must stay valid until then.
+ * Streams are used from thread context, not interrupts.
+ */
+
+/* bytes from which update uses DMA */
+#ifndef HAUSTREAM_DMA_MIN
+#define HAUSTREAM_DMA_MIN           256
+#endif
+
+/* no DMA channel, data written by CPU */
+#define HAUSTREAM_NO_DMA            0xFFFFFFFFUL
+
+#define HAUSTREAM_BLOCK_SIZE        64
+/* bytes of the longest digest, SHA256 */
+#define HAUSTREAM_DIGEST_MAX        32
+
+typedef struct haustream {
+    /* private */
+    hau_context_parameter_struct ctx;   /* saved HAU state while another stream owns the HAU */
+    const uint8_t *key;                 /* HMAC key, NULL for hash */
+    uint32_t keylen;
+    uint32_t algo;
+    uint32_t fill;                      /* bytes in buf */
+    uint32_t buf[HAUSTREAM_BLOCK_SIZE / 4];
+} haustream_t;
+
+/*
+ * Enable the HAU and set the dmaq channel initialized by dmaq_chan_init() with the HAU DMA
+ * request, or HAUSTREAM_NO_DMA, return 0 on success
+ */
+int32_t haustream_init(uint32_t dma_chan);
+
+/*
+ * Start stream with algo HAU_ALGO_SHA1/SHA224/SHA256/MD5, in HMAC mode with key of keylen
+ * bytes or in hash mode if key is NULL, return 0 on success, -1 on error
+ */
+int32_t haustream_start(haustream_t *hs, uint32_t algo, const uint8_t *key, uint32_t keylen);
+
+/* Hash len bytes of data, return 0 on success, -1 on error */
+int32_t haustream_update(haustream_t *hs, const uint8_t *data, uint32_t len);
+
+/* End stream and write digest, return bytes of digest, or -1 on error */
+int32_t haustream_finish(haustream_t *hs, uint8_t *digest);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _HAUSTREAM_API_H_ */
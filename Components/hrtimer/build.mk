@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# hrtimer middleware multiplexes software timers on SysTimer compare interrupt,
+# it is for bare-metal, RTOS ports use the SysTimer interrupt for tick
+MIDDLEWARE_HRTIMER := $(NUCLEI_SDK_MIDDLEWARE)/hrtimer
+
+C_SRCDIRS += $(MIDDLEWARE_HRTIMER)
+
+INCDIRS += $(MIDDLEWARE_HRTIMER)
@@ -0,0 +1,201 @@
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "hrtimer_api.h"
+
+/* min-heap of active timers of one hart, heap[0] is the earliest */
+typedef struct hrtimer_heap {
+    hrtimer_t *heap[HRTIMER_MAX];
+    uint32_t count;
+    hrtimer_stat_t stat;
+} hrtimer_heap_t;
+
+static hrtimer_heap_t hrtimer_heaps[HRTIMER_MAX_HARTS];
+
+#define HRTIMER_DISABLED        UINT64_MAX
+
+static inline void hrtimer_place(hrtimer_heap_t *h, hrtimer_t *tmr, uint32_t idx)
+{
+    h->heap[idx] = tmr;
+    tmr->index = (int32_t)idx;
+}
+
+static void hrtimer_sift_up(hrtimer_heap_t *h, uint32_t idx)
+{
+    hrtimer_t *tmr = h->heap[idx];
+    uint32_t parent;
+
+    while (idx > 0) {
+        parent = (idx - 1) / 2;
+        if (h->heap[parent]->expires <= tmr->expires) {
+            break;
+        }
+        hrtimer_place(h, h->heap[parent], idx);
+        idx = parent;
+    }
+    hrtimer_place(h, tmr, idx);
+}
+
+static void hrtimer_sift_down(hrtimer_heap_t *h, uint32_t idx)
+{
+    hrtimer_t *tmr = h->heap[idx];
+    uint32_t child;
+
+    while ((child = idx * 2 + 1) < h->count) {
+        if ((child + 1 < h->count) && (h->heap[child + 1]->expires < h->heap[child]->expires)) {
+            child++;
+        }
+        if (tmr->expires <= h->heap[child]->expires) {
+            break;
+        }
+        hrtimer_place(h, h->heap[child], idx);
+        idx = child;
+    }
+    hrtimer_place(h, tmr, idx);
+}
+
+static void hrtimer_remove(hrtimer_heap_t *h, hrtimer_t *tmr)
+{
+    uint32_t idx = (uint32_t)tmr->index;
+    hrtimer_t *last = h->heap[--h->count];
+
+    tmr->index = -1;
+    if (last == tmr) {
+        return;
+    }
+    // move last one into the hole, it may go either way
+    hrtimer_place(h, last, idx);
+    if ((idx > 0) && (h->heap[(idx - 1) / 2]->expires > last->expires)) {
+        hrtimer_sift_up(h, idx);
+    } else {
+        hrtimer_sift_down(h, idx);
+    }
+}
+
+static inline void hrtimer_program(hrtimer_heap_t *h)
+{
+    SysTimer_SetCompareValue((h->count != 0) ? h->heap[0]->expires : HRTIMER_DISABLED);
+}
+
+void hrtimer_init(hrtimer_t *tmr, hrtimer_fn_t fn, void *arg)
+{
+    tmr->expires = 0;
+    tmr->period = 0;
+    tmr->fn = fn;
+    tmr->arg = arg;
+    tmr->index = -1;
+    tmr->runs = 0;
+    tmr->overruns = 0;
+}
+
+int32_t hrtimer_start(hrtimer_t *tmr, uint64_t expires, uint64_t period)
+{
+    hrtimer_heap_t *h = &hrtimer_heaps[__get_hart_index()];
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    hrtimer_t *first;
+    int32_t ret = 0;
+
+    if (tmr->index >= 0) {
+        hrtimer_remove(h, tmr);
+    }
+    if (h->count < HRTIMER_MAX) {
+        first = (h->count != 0) ? h->heap[0] : NULL;
+        tmr->expires = expires;
+        tmr->period = period;
+        hrtimer_place(h, tmr, h->count++);
+        hrtimer_sift_up(h, (uint32_t)tmr->index);
+        // only reprogram when the earliest deadline changed
+        if (h->heap[0] != first) {
+            hrtimer_program(h);
+        }
+    } else {
+        ret = -1;
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return ret;
+}
+
+int32_t hrtimer_start_after(hrtimer_t *tmr, uint64_t delay, uint64_t period)
+{
+    return hrtimer_start(tmr, SysTimer_GetLoadValue() + delay, period);
+}
+
+int32_t hrtimer_cancel(hrtimer_t *tmr)
+{
+    hrtimer_heap_t *h = &hrtimer_heaps[__get_hart_index()];
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    int32_t active = 0;
+
+    // clear period, so a periodic timer cancelled in its callback is not rearmed
+    tmr->period = 0;
+    if (tmr->index >= 0) {
+        // compare value of removed earliest one is left, the interrupt just finds nothing expired
+        hrtimer_remove(h, tmr);
+        active = 1;
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return active;
+}
+
+int32_t hrtimer_is_active(const hrtimer_t *tmr)
+{
+    return tmr->index >= 0;
+}
+
+/* SysTimer interrupt handler, heap is accessed with interrupts disabled, callbacks run with them restored */
+static void hrtimer_irq_handler(void)
+{
+    hrtimer_heap_t *h = &hrtimer_heaps[__get_hart_index()];
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    hrtimer_t *tmr;
+    uint64_t now, late, missed;
+
+    h->stat.irqs++;
+    now = SysTimer_GetLoadValue();
+    while (1) {
+        while ((h->count != 0) && (h->heap[0]->expires <= now)) {
+            tmr = h->heap[0];
+            hrtimer_remove(h, tmr);
+            late = now - tmr->expires;
+            if (late > h->stat.max_latency) {
+                h->stat.max_latency = late;
+            }
+            __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+            tmr->fn(tmr->arg);
+            __RV_CSR_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+            tmr->runs++;
+            h->stat.runs++;
+            // not rearmed when the callback started or cancelled it
+            if ((tmr->index < 0) && (tmr->period != 0) && (h->count < HRTIMER_MAX)) {
+                missed = late / tmr->period;
+                tmr->overruns += (uint32_t)missed;
+                tmr->expires += (missed + 1) * tmr->period;
+                hrtimer_place(h, tmr, h->count++);
+                hrtimer_sift_up(h, (uint32_t)tmr->index);
+            }
+        }
+        hrtimer_program(h);
+        // run the deadlines passed during callbacks here instead of taking the interrupt again
+        now = SysTimer_GetLoadValue();
+        if ((h->count == 0) || (h->heap[0]->expires > now)) {
+            break;
+        }
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
+
+int32_t hrtimer_service_init(uint8_t lvl)
+{
+    hrtimer_heap_t *h = &hrtimer_heaps[__get_hart_index()];
+
+    h->count = 0;
+    hrtimer_program(h);
+    return ECLIC_Register_IRQ(SysTimer_IRQn, ECLIC_NON_VECTOR_INTERRUPT, ECLIC_LEVEL_TRIGGER, lvl, 0,
+                              (void *)hrtimer_irq_handler);
+}
+
+void hrtimer_get_stat(unsigned long hartidx, hrtimer_stat_t *stat)
+{
+    if (hartidx < HRTIMER_MAX_HARTS) {
+        *stat = hrtimer_heaps[hartidx].stat;
+    }
+}
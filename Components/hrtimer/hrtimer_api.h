@@ -0,0 +1,99 @@
+#ifndef _HRTIMER_API_H_
+#define _HRTIMER_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*
+ * High resolution software timers for bare-metal.
+ *
+ * Timers of one hart are kept in a min-heap ordered by their deadlines in 64-bit
+ * SysTimer counter units, only the earliest deadline is programmed into the compare
+ * register of the hart, the SysTimer interrupt handler runs all the expired timers in
+ * one batch and programs the next deadline, so waiting code can sleep by __WFI()
+ * instead of polling the counter.
+ *
+ * - Call hrtimer_service_init() on each hart using timers, it installs the SysTimer
+ *   interrupt handler, which requires a writable vector table, so build with
+ *   NUCLEI_VECTOR_RAM=1 in flashxip download mode
+ * - Timers are started and cancelled on the hart they run on, or in their callbacks,
+ *   heap is protected by disabling interrupts
+ * - Callbacks run in interrupt context, a timer can be started again or cancelled
+ *   in its own callback
+ * - A periodic timer missing some periods is moved to the next period in the future,
+ *   the missed ones are counted in overruns instead of running callback for each
+ */
+
+/* number of harts using hrtimer, hart index must be less than it */
+#ifndef HRTIMER_MAX_HARTS
+#if defined(SMP_CPU_CNT)
+#define HRTIMER_MAX_HARTS       SMP_CPU_CNT
+#else
+#define HRTIMER_MAX_HARTS       1
+#endif
+#endif
+
+/* max active timers of one hart */
+#ifndef HRTIMER_MAX
+#define HRTIMER_MAX             16
+#endif
+
+/* Convert us and ms to SysTimer counter units */
+#define HRTIMER_US(us)          ((uint64_t)(us) * SOC_TIMER_FREQ / 1000000)
+#define HRTIMER_MS(ms)          ((uint64_t)(ms) * SOC_TIMER_FREQ / 1000)
+
+/* function run when timer expires */
+typedef void (*hrtimer_fn_t)(void *arg);
+
+/* software timer, initialize it by hrtimer_init() or HRTIMER_INIT */
+typedef struct hrtimer {
+    uint64_t expires;               /* deadline of next run in SysTimer counter */
+    uint64_t period;                /* 0 for one-shot timer */
+    hrtimer_fn_t fn;
+    void *arg;
+    int32_t index;                  /* position in heap, -1 if not active */
+    uint32_t runs;                  /* times of callback run */
+    uint32_t overruns;              /* periods missed by periodic timer */
+} hrtimer_t;
+
+#define HRTIMER_INIT(fn, arg)           { 0, 0, (fn), (arg), -1, 0, 0 }
+
+/* statistics of one hart */
+typedef struct hrtimer_stat {
+    uint32_t irqs;                  /* times of SysTimer interrupt */
+    uint32_t runs;                  /* times of callbacks run, runs / irqs is the batch size */
+    uint64_t max_latency;           /* max counter units from deadline to callback */
+} hrtimer_stat_t;
+
+/* Initialize timer to run fn(arg) */
+void hrtimer_init(hrtimer_t *tmr, hrtimer_fn_t fn, void *arg);
+
+/*
+ * Start or restart timer on current hart at absolute deadline expires, then every
+ * period if it is not 0, return 0 if success, -1 if the heap of hart is full
+ */
+int32_t hrtimer_start(hrtimer_t *tmr, uint64_t expires, uint64_t period);
+
+/* Start timer to expire delay counter units later, then every period if it is not 0 */
+int32_t hrtimer_start_after(hrtimer_t *tmr, uint64_t delay, uint64_t period);
+
+/* Stop timer, return 1 if it was active */
+int32_t hrtimer_cancel(hrtimer_t *tmr);
+
+/* Return 1 if timer is waiting to expire */
+int32_t hrtimer_is_active(const hrtimer_t *tmr);
+
+/* Install SysTimer interrupt handler at lvl and clear timers of current hart */
+int32_t hrtimer_service_init(uint8_t lvl);
+
+/* Get statistics of hart */
+void hrtimer_get_stat(unsigned long hartidx, hrtimer_stat_t *stat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_HRTIMER_API_H_ */
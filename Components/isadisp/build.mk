@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# isadisp middleware resolves NMSIS-DSP and NMSIS-NN kernels to their scalar, P-ext or vector
+# variants at startup, link the variant libraries prefixed by tools/scripts/isadisp.py by LDLIBS
+MIDDLEWARE_ISADISP := $(NUCLEI_SDK_MIDDLEWARE)/isadisp
+
+C_SRCDIRS += $(MIDDLEWARE_ISADISP)
+
+INCDIRS += $(MIDDLEWARE_ISADISP)
@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "isadisp_api.h"
+
+#if defined(ISADISP_KERNELS_FILE)
+#define ISADISP_KERNELS             ISADISP_KERNELS_FILE
+#else
+#define ISADISP_KERNELS             "isadisp_kernels.h"
+#endif
+
+/* misa bits of P and V */
+#define ISADISP_MISA_P              (1UL << ('P' - 'A'))
+#define ISADISP_MISA_V              (1UL << ('V' - 'A'))
+
+/* prefixed variants of libraries, only the scalar one must be linked */
+#define ISADISP_KERNEL(ret, name, params, args)                                             \
+    extern ret isadisp_scalar_##name params;                                                \
+    extern ret isadisp_dsp_##name params __WEAK;                                            \
+    extern ret isadisp_vector_##name params __WEAK;
+#define ISADISP_KERNEL_VOID(name, params, args)     ISADISP_KERNEL(void, name, params, args)
+#include ISADISP_KERNELS
+#undef ISADISP_KERNEL
+#undef ISADISP_KERNEL_VOID
+
+/* scalar variants until isadisp_init() */
+isadisp_table_t isadisp_table = {
+#define ISADISP_KERNEL(ret, name, params, args)     isadisp_scalar_##name,
+#define ISADISP_KERNEL_VOID(name, params, args)     isadisp_scalar_##name,
+#include ISADISP_KERNELS
+#undef ISADISP_KERNEL
+#undef ISADISP_KERNEL_VOID
+};
+
+static const char *const isadisp_names[] = {
+#define ISADISP_KERNEL(ret, name, params, args)     #name,
+#define ISADISP_KERNEL_VOID(name, params, args)     #name,
+#include ISADISP_KERNELS
+#undef ISADISP_KERNEL
+#undef ISADISP_KERNEL_VOID
+};
+
+#define ISADISP_NUM                 (sizeof(isadisp_names) / sizeof(isadisp_names[0]))
+
+/* ISADISP_* variant selected of each kernel */
+static uint8_t isadisp_selected[ISADISP_NUM];
+
+/* forwarders in place of the library kernels, a tail call of the table entry */
+#define ISADISP_KERNEL(ret, name, params, args)                                             \
+    ret name params                                                                         \
+    {                                                                                       \
+        return isadisp_table.name args;                                                     \
+    }
+#define ISADISP_KERNEL_VOID(name, params, args)                                             \
+    void name params                                                                        \
+    {                                                                                       \
+        isadisp_table.name args;                                                            \
+    }
+#include ISADISP_KERNELS
+#undef ISADISP_KERNEL
+#undef ISADISP_KERNEL_VOID
+
+uint32_t isadisp_probe(void)
+{
+    rv_csr_t misa = __RV_CSR_READ(CSR_MISA);
+    uint32_t features = 0;
+
+    if (misa & ISADISP_MISA_P) {
+        features |= ISADISP_HAS_DSP;
+    }
+    if (misa & ISADISP_MISA_V) {
+        features |= ISADISP_HAS_VECTOR;
+    }
+    return features;
+}
+
+uint32_t isadisp_select(uint32_t allow)
+{
+    uint32_t idx = 0, used = 0;
+
+    // best variant allowed and linked in, a NULL weak symbol is a variant not linked in
+#define ISADISP_KERNEL(ret, name, params, args)                                             \
+    if ((allow & ISADISP_HAS_VECTOR) && (isadisp_vector_##name != NULL)) {                  \
+        isadisp_table.name = isadisp_vector_##name;                                         \
+        isadisp_selected[idx] = ISADISP_VECTOR;                                             \
+    } else if ((allow & ISADISP_HAS_DSP) && (isadisp_dsp_##name != NULL)) {                 \
+        isadisp_table.name = isadisp_dsp_##name;                                            \
+        isadisp_selected[idx] = ISADISP_DSP;                                                \
+    } else {                                                                                \
+        isadisp_table.name = isadisp_scalar_##name;                                         \
+        isadisp_selected[idx] = ISADISP_SCALAR;                                             \
+    }                                                                                       \
+    used |= (1UL << isadisp_selected[idx]) & ~1UL;                                          \
+    idx++;
+#define ISADISP_KERNEL_VOID(name, params, args)     ISADISP_KERNEL(void, name, params, args)
+#include ISADISP_KERNELS
+#undef ISADISP_KERNEL
+#undef ISADISP_KERNEL_VOID
+    if ((used & ISADISP_HAS_VECTOR) && ((__RV_CSR_READ(CSR_MSTATUS) & MSTATUS_VS) == 0)) {
+        // startup of an image built without vector leaves it off
+        __RV_CSR_SET(CSR_MSTATUS, MSTATUS_VS_INITIAL);
+    }
+    __RWMB();
+    return used;
+}
+
+void isadisp_init(void)
+{
+    isadisp_select(isadisp_probe());
+}
+
+/* called by _premain_init() of the SoC before main */
+void SystemDispatchInit(void)
+{
+    isadisp_init();
+}
+
+int32_t isadisp_variant(uint32_t idx)
+{
+    return (idx < ISADISP_NUM) ? isadisp_selected[idx] : -1;
+}
+
+void isadisp_dump(void)
+{
+    static const char *const variants[ISADISP_VARIANTS] = {"scalar", "dsp", "vector"};
+    uint32_t idx;
+
+    printf("isadisp: misa 0x%lx, features 0x%lx\r\n", (unsigned long)__RV_CSR_READ(CSR_MISA),
+           (unsigned long)isadisp_probe());
+    for (idx = 0; idx < ISADISP_NUM; idx++) {
+        printf("%-48s %s\r\n", isadisp_names[idx], variants[isadisp_selected[idx]]);
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef _ISADISP_API_H_
+#define _ISADISP_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "riscv_math.h"
+#include "riscv_nnfunctions.h"
+
+/*
+ * Runtime ISA dispatch of NMSIS-DSP and NMSIS-NN kernels, for one firmware image running on
+ * cores with and without P-ext DSP and Vector.
+ *
+ * - Variants: the libraries are built or taken once per ISA, and every symbol they define is
+ *   prefixed by tools/scripts/isadisp.py with isadisp_scalar_, isadisp_dsp_ or isadisp_vector_,
+ *   so all of them link into one image, the scalar one is required, the others are weak
+ * - Probe: misa.P and misa.V of the boot hart tell which variants can run
+ * - Resolve: isadisp_init() points each entry of isadisp_table to the best variant present,
+ *   vector before DSP before scalar, and is called by _premain_init() of evalsoc through
+ *   SystemDispatchInit() before main, the table starts with the scalar variants
+ * - Call: isadisp defines each riscv_* kernel of isadisp_kernels.h as a forwarder which tail
+ *   calls the table entry, so callers and the riscv_* names are unchanged, and a call costs
+ *   one indirect jump
+ *
+ * Build the application with the -march of the scalar variant and the same -mabi as all the
+ * variants. Vector is enabled on the boot hart when it is selected, other harts calling
+ * vector kernels have to set mstatus.VS themselves, and vector registers are only saved by
+ * RTOS ports built for vector.
+ */
+
+/* variants of a kernel */
+#define ISADISP_SCALAR              0
+#define ISADISP_DSP                 1
+#define ISADISP_VECTOR              2
+#define ISADISP_VARIANTS            3
+
+/* features of isadisp_probe() */
+#define ISADISP_HAS_DSP             (1UL << ISADISP_DSP)
+#define ISADISP_HAS_VECTOR          (1UL << ISADISP_VECTOR)
+
+/* one entry of each kernel */
+typedef struct isadisp_table {
+#define ISADISP_KERNEL(ret, name, params, args)     ret (*name) params;
+#define ISADISP_KERNEL_VOID(name, params, args)     void (*name) params;
+#if defined(ISADISP_KERNELS_FILE)
+#include ISADISP_KERNELS_FILE
+#else
+#include "isadisp_kernels.h"
+#endif
+#undef ISADISP_KERNEL
+#undef ISADISP_KERNEL_VOID
+} isadisp_table_t;
+
+/* kernels in use, filled by isadisp_init() */
+extern isadisp_table_t isadisp_table;
+
+/* Return ISADISP_HAS_* features of current hart */
+uint32_t isadisp_probe(void);
+
+/*
+ * Point each kernel to the best variant linked in of the ISADISP_HAS_* features allowed,
+ * eg. 0 selects the scalar ones for comparison, return the features used
+ */
+uint32_t isadisp_select(uint32_t allow);
+
+/* Select the variants of the probed features */
+void isadisp_init(void);
+
+/* Return ISADISP_* variant of kernel idx in order of isadisp_kernels.h, -1 if idx is out of range */
+int32_t isadisp_variant(uint32_t idx);
+
+/* Print kernels and their variants */
+void isadisp_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _ISADISP_API_H_ */
@@ -0,0 +1,88 @@
+/*
+ * Kernels dispatched by isadisp, included with ISADISP_KERNEL and ISADISP_KERNEL_VOID
+ * defined, without include guard.
+ *
+ * ISADISP_KERNEL(ret, name, params, args) is a kernel returning ret, ISADISP_KERNEL_VOID(name,
+ * params, args) one returning nothing, params is the parenthesized parameter list and args
+ * the parenthesized argument list passing them on. Kernels whose scratch size differs by ISA
+ * are listed with their *_get_buffer_size(), so the size matches the variant selected.
+ *
+ * Define ISADISP_KERNELS_FILE to a file of the same form to dispatch other kernels.
+ */
+
+/* NMSIS-DSP */
+ISADISP_KERNEL_VOID(riscv_add_f32,
+    (const float32_t *pSrcA, const float32_t *pSrcB, float32_t *pDst, uint32_t blockSize),
+    (pSrcA, pSrcB, pDst, blockSize))
+ISADISP_KERNEL_VOID(riscv_add_q15,
+    (const q15_t *pSrcA, const q15_t *pSrcB, q15_t *pDst, uint32_t blockSize),
+    (pSrcA, pSrcB, pDst, blockSize))
+ISADISP_KERNEL_VOID(riscv_mult_f32,
+    (const float32_t *pSrcA, const float32_t *pSrcB, float32_t *pDst, uint32_t blockSize),
+    (pSrcA, pSrcB, pDst, blockSize))
+ISADISP_KERNEL_VOID(riscv_dot_prod_f32,
+    (const float32_t *pSrcA, const float32_t *pSrcB, uint32_t blockSize, float32_t *result),
+    (pSrcA, pSrcB, blockSize, result))
+ISADISP_KERNEL_VOID(riscv_dot_prod_q7,
+    (const q7_t *pSrcA, const q7_t *pSrcB, uint32_t blockSize, q31_t *result),
+    (pSrcA, pSrcB, blockSize, result))
+ISADISP_KERNEL_VOID(riscv_dot_prod_q15,
+    (const q15_t *pSrcA, const q15_t *pSrcB, uint32_t blockSize, q63_t *result),
+    (pSrcA, pSrcB, blockSize, result))
+ISADISP_KERNEL_VOID(riscv_fir_f32,
+    (const riscv_fir_instance_f32 *S, const float32_t *pSrc, float32_t *pDst, uint32_t blockSize),
+    (S, pSrc, pDst, blockSize))
+ISADISP_KERNEL_VOID(riscv_fir_q15,
+    (const riscv_fir_instance_q15 *S, const q15_t *pSrc, q15_t *pDst, uint32_t blockSize),
+    (S, pSrc, pDst, blockSize))
+ISADISP_KERNEL_VOID(riscv_cfft_f32,
+    (const riscv_cfft_instance_f32 *S, float32_t *p1, uint8_t ifftFlag, uint8_t bitReverseFlag),
+    (S, p1, ifftFlag, bitReverseFlag))
+ISADISP_KERNEL(riscv_status, riscv_mat_mult_f32,
+    (const riscv_matrix_instance_f32 *pSrcA, const riscv_matrix_instance_f32 *pSrcB, riscv_matrix_instance_f32 *pDst),
+    (pSrcA, pSrcB, pDst))
+ISADISP_KERNEL(riscv_status, riscv_mat_mult_q15,
+    (const riscv_matrix_instance_q15 *pSrcA, const riscv_matrix_instance_q15 *pSrcB, riscv_matrix_instance_q15 *pDst,
+     q15_t *pState),
+    (pSrcA, pSrcB, pDst, pState))
+
+/* NMSIS-NN */
+ISADISP_KERNEL(riscv_nmsis_nn_status, riscv_convolve_wrapper_s8,
+    (const nmsis_nn_context *ctx, const nmsis_nn_conv_params *conv_params,
+     const nmsis_nn_per_channel_quant_params *quant_params, const nmsis_nn_dims *input_dims,
+     const int8_t *input_data, const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+     const nmsis_nn_dims *bias_dims, const int32_t *bias_data, const nmsis_nn_dims *output_dims,
+     int8_t *output_data),
+    (ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims, bias_data,
+     output_dims, output_data))
+ISADISP_KERNEL(int32_t, riscv_convolve_wrapper_s8_get_buffer_size,
+    (const nmsis_nn_conv_params *conv_params, const nmsis_nn_dims *input_dims, const nmsis_nn_dims *filter_dims,
+     const nmsis_nn_dims *output_dims),
+    (conv_params, input_dims, filter_dims, output_dims))
+ISADISP_KERNEL(riscv_nmsis_nn_status, riscv_depthwise_conv_wrapper_s8,
+    (const nmsis_nn_context *ctx, const nmsis_nn_dw_conv_params *dw_conv_params,
+     const nmsis_nn_per_channel_quant_params *quant_params, const nmsis_nn_dims *input_dims,
+     const int8_t *input_data, const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+     const nmsis_nn_dims *bias_dims, const int32_t *bias_data, const nmsis_nn_dims *output_dims,
+     int8_t *output_data),
+    (ctx, dw_conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims, bias_data,
+     output_dims, output_data))
+ISADISP_KERNEL(int32_t, riscv_depthwise_conv_wrapper_s8_get_buffer_size,
+    (const nmsis_nn_dw_conv_params *dw_conv_params, const nmsis_nn_dims *input_dims,
+     const nmsis_nn_dims *filter_dims, const nmsis_nn_dims *output_dims),
+    (dw_conv_params, input_dims, filter_dims, output_dims))
+ISADISP_KERNEL(riscv_nmsis_nn_status, riscv_fully_connected_s8,
+    (const nmsis_nn_context *ctx, const nmsis_nn_fc_params *fc_params,
+     const nmsis_nn_per_tensor_quant_params *quant_params, const nmsis_nn_dims *input_dims,
+     const int8_t *input_data, const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+     const nmsis_nn_dims *bias_dims, const int32_t *bias_data, const nmsis_nn_dims *output_dims,
+     int8_t *output_data),
+    (ctx, fc_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims, bias_data,
+     output_dims, output_data))
+ISADISP_KERNEL(int32_t, riscv_fully_connected_s8_get_buffer_size,
+    (const nmsis_nn_dims *filter_dims),
+    (filter_dims))
+ISADISP_KERNEL_VOID(riscv_softmax_s8,
+    (const int8_t *input, const int32_t num_rows, const int32_t row_size, const int32_t mult,
+     const int32_t shift, const int32_t diff_min, int8_t *output),
+    (input, num_rows, row_size, mult, shift, diff_min, output))
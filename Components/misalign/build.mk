@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# misalign middleware emulates misaligned load/store in exception handler,
+# and records the pc of each misaligned access site
+MIDDLEWARE_MISALIGN := $(NUCLEI_SDK_MIDDLEWARE)/misalign
+
+C_SRCDIRS += $(MIDDLEWARE_MISALIGN)
+
+INCDIRS += $(MIDDLEWARE_MISALIGN)
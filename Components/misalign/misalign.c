@@ -0,0 +1,340 @@
+#include <stdio.h>
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "misalign_api.h"
+
+misalign_stat_t misalign_stats[MISALIGN_STAT_SIZE];
+uint32_t misalign_lost;
+
+/* handlers registered before misalign_init, called for the instructions not emulated */
+static unsigned long misalign_prev_handler[2];
+
+#define MISALIGN_STR(x)         #x
+#if __riscv_xlen == 64
+#define MISALIGN_SAVE(reg, idx) "sd " #reg ", " MISALIGN_STR(idx) "*8(sp)\n"
+#define MISALIGN_LOAD(reg, idx) "ld " #reg ", " MISALIGN_STR(idx) "*8(sp)\n"
+#else
+#define MISALIGN_SAVE(reg, idx) "sw " #reg ", " MISALIGN_STR(idx) "*4(sp)\n"
+#define MISALIGN_LOAD(reg, idx) "lw " #reg ", " MISALIGN_STR(idx) "*4(sp)\n"
+#endif
+
+/* s-registers and ra saved by misalign_exception_handler, stack size rounded up to 16 bytes */
+#ifndef __riscv_32e
+#define MISALIGN_SREGS(op)      op(s0, 0) op(s1, 1) op(s2, 2) op(s3, 3) op(s4, 4) op(s5, 5) \
+                                op(s6, 6) op(s7, 7) op(s8, 8) op(s9, 9) op(s10, 10) op(s11, 11) \
+                                op(ra, 12)
+#if __riscv_xlen == 64
+#define MISALIGN_FRAME          "112"
+#else
+#define MISALIGN_FRAME          "64"
+#endif
+#else
+#define MISALIGN_SREGS(op)      op(s0, 0) op(s1, 1) op(ra, 2)
+#define MISALIGN_FRAME          "16"
+#endif
+
+void misalign_emulate(unsigned long mcause, unsigned long sp, unsigned long *sregs);
+
+/*
+ * Exception handler of misaligned load/store, the trap frame at sp only holds the
+ * caller saved registers, so s-registers are saved here where they still hold the
+ * values of trapped code, and restored after emulation since one of them may be
+ * the destination of load.
+ */
+__attribute__((naked)) static void misalign_exception_handler(unsigned long mcause, unsigned long sp)
+{
+    __ASM volatile(
+        "addi sp, sp, -" MISALIGN_FRAME "\n"
+        MISALIGN_SREGS(MISALIGN_SAVE)
+        "mv a2, sp\n"
+        "call misalign_emulate\n"
+        MISALIGN_SREGS(MISALIGN_LOAD)
+        "addi sp, sp, " MISALIGN_FRAME "\n"
+        "ret\n"
+    );
+}
+
+/* Decoded misaligned load/store */
+typedef struct misalign_insn {
+    uint8_t len;                /* instruction length, 2 or 4 */
+    uint8_t size;               /* access bytes */
+    uint8_t reg;                /* rd of load or rs2 of store */
+    uint8_t is_store : 1;
+    uint8_t is_unsigned : 1;
+} misalign_insn_t;
+
+/* Decode integer load/store, return 0 if it is not emulated */
+static int misalign_decode(uint32_t insn, misalign_insn_t *out)
+{
+    uint32_t funct3;
+
+    if ((insn & 0x3) == 0x3) {
+        funct3 = (insn >> 12) & 0x7;
+        out->len = 4;
+        if ((insn & 0x7F) == 0x03) {
+            // LH(1) LW(2) LD(3) LHU(5) LWU(6), bytes never trap
+            if ((funct3 == 0) || (funct3 == 4) || (funct3 == 7)) {
+                return 0;
+            }
+            out->is_store = 0;
+            out->is_unsigned = (funct3 >> 2) & 1;
+            out->size = 1 << (funct3 & 0x3);
+            out->reg = (insn >> 7) & 0x1F;
+        } else if ((insn & 0x7F) == 0x23) {
+            // SH(1) SW(2) SD(3)
+            if ((funct3 == 0) || (funct3 > 3)) {
+                return 0;
+            }
+            out->is_store = 1;
+            out->is_unsigned = 0;
+            out->size = 1 << funct3;
+            out->reg = (insn >> 20) & 0x1F;
+        } else {
+            return 0;
+        }
+#if __riscv_xlen == 32
+        if (out->size == 8) {
+            return 0;
+        }
+#endif
+        return 1;
+    }
+
+    funct3 = (insn >> 13) & 0x7;
+    out->len = 2;
+    out->is_unsigned = 0;
+    switch (((insn & 0x3) << 3) | funct3) {
+        case (0 << 3) | 2:      // C.LW
+        case (0 << 3) | 6:      // C.SW
+            out->size = 4;
+            out->is_store = funct3 >> 2;
+            out->reg = ((insn >> 2) & 0x7) + 8;
+            return 1;
+        case (0 << 3) | 4:      // Zcb C.LHU/C.LH/C.SH: funct6 100001/100011
+            if (((insn >> 10) & 0x5) != 0x1) {
+                return 0;
+            }
+            out->size = 2;
+            out->is_store = (insn >> 11) & 1;
+            out->is_unsigned = ((insn >> 6) & 1) ^ 1;
+            out->reg = ((insn >> 2) & 0x7) + 8;
+            return (out->is_store == 0) || (((insn >> 6) & 1) == 0);
+        case (2 << 3) | 2:      // C.LWSP
+            out->size = 4;
+            out->is_store = 0;
+            out->reg = (insn >> 7) & 0x1F;
+            return out->reg != 0;
+        case (2 << 3) | 6:      // C.SWSP
+            out->size = 4;
+            out->is_store = 1;
+            out->reg = (insn >> 2) & 0x1F;
+            return 1;
+#if __riscv_xlen == 64
+        case (0 << 3) | 3:      // C.LD
+        case (0 << 3) | 7:      // C.SD
+            out->size = 8;
+            out->is_store = funct3 >> 2;
+            out->reg = ((insn >> 2) & 0x7) + 8;
+            return 1;
+        case (2 << 3) | 3:      // C.LDSP
+            out->size = 8;
+            out->is_store = 0;
+            out->reg = (insn >> 7) & 0x1F;
+            return out->reg != 0;
+        case (2 << 3) | 7:      // C.SDSP
+            out->size = 8;
+            out->is_store = 1;
+            out->reg = (insn >> 2) & 0x1F;
+            return 1;
+#endif
+        default:
+            return 0;
+    }
+}
+
+/* Saved register of trapped code, NULL for x0, sp and gp which are not in the frames */
+static unsigned long *misalign_reg(EXC_Frame_Type *frame, unsigned long *sregs, uint32_t reg)
+{
+    switch (reg) {
+        case 1: return &frame->ra;
+        case 4: return &frame->tp;
+        case 5: return &frame->t0;
+        case 6: return &frame->t1;
+        case 7: return &frame->t2;
+        case 8: return &sregs[0];
+        case 9: return &sregs[1];
+        case 10: return &frame->a0;
+        case 11: return &frame->a1;
+        case 12: return &frame->a2;
+        case 13: return &frame->a3;
+        case 14: return &frame->a4;
+        case 15: return &frame->a5;
+#ifndef __riscv_32e
+        case 16: return &frame->a6;
+        case 17: return &frame->a7;
+        case 28: return &frame->t3;
+        case 29: return &frame->t4;
+        case 30: return &frame->t5;
+        case 31: return &frame->t6;
+        default:
+            if ((reg >= 18) && (reg <= 27)) {
+                return &sregs[reg - 16];
+            }
+            return NULL;
+#else
+        default: return NULL;
+#endif
+    }
+}
+
+/* Value of store source register */
+static unsigned long misalign_reg_value(EXC_Frame_Type *frame, unsigned long *sregs, uint32_t reg)
+{
+    unsigned long *preg;
+    unsigned long val;
+
+    switch (reg) {
+        case 0: return 0;
+        case 2: return (unsigned long)frame + sizeof(EXC_Frame_Type);
+        case 3:
+            __ASM volatile("mv %0, gp" : "=r"(val));
+            return val;
+        default:
+            preg = misalign_reg(frame, sregs, reg);
+            return (preg != NULL) ? *preg : 0;
+    }
+}
+
+/* Count hit of pc, the table is open addressing so the lookup is short in exception */
+static void misalign_record(unsigned long pc, uint32_t is_store)
+{
+    uint32_t idx = (uint32_t)(pc >> 1) % MISALIGN_STAT_SIZE;
+    uint32_t i;
+    misalign_stat_t *stat;
+
+    for (i = 0; i < MISALIGN_STAT_SIZE; i++) {
+        stat = &misalign_stats[(idx + i) % MISALIGN_STAT_SIZE];
+        if (stat->pc == 0) {
+            stat->pc = pc;
+        }
+        if (stat->pc == pc) {
+            if (is_store) {
+                stat->stores++;
+            } else {
+                stat->loads++;
+            }
+            return;
+        }
+    }
+    misalign_lost++;
+}
+
+void misalign_emulate(unsigned long mcause, unsigned long sp, unsigned long *sregs)
+{
+    EXC_Frame_Type *frame = (EXC_Frame_Type *)sp;
+    unsigned long epc = __RV_CSR_READ(CSR_MEPC);
+    uint8_t *addr = (uint8_t *)__RV_CSR_READ(CSR_MTVAL);
+    uint32_t insn;
+    misalign_insn_t dec;
+    unsigned long val = 0;
+    unsigned long *preg;
+    uint32_t i;
+
+    // mepc may be only 2 bytes aligned with compressed extension
+    insn = *(volatile uint16_t *)epc;
+    if ((insn & 0x3) == 0x3) {
+        insn |= (uint32_t)(*(volatile uint16_t *)(epc + 2)) << 16;
+    }
+
+    if (misalign_decode(insn, &dec) == 0) {
+        goto unhandled;
+    }
+    if (dec.is_store) {
+        val = misalign_reg_value(frame, sregs, dec.reg);
+        for (i = 0; i < dec.size; i++) {
+            addr[i] = (uint8_t)(val >> (i * 8));
+        }
+    } else {
+        // rd of x0 is a hint, sp and gp are not saved in frame
+        preg = misalign_reg(frame, sregs, dec.reg);
+        if (dec.reg == 0) {
+            preg = &val;
+        } else if (preg == NULL) {
+            goto unhandled;
+        }
+        for (i = 0; i < dec.size; i++) {
+            val |= (unsigned long)addr[i] << (i * 8);
+        }
+        if ((dec.is_unsigned == 0) && (dec.size < sizeof(unsigned long))) {
+            i = (sizeof(unsigned long) - dec.size) * 8;
+            val = (unsigned long)((long)(val << i) >> i);
+        }
+        *preg = val;
+    }
+    misalign_record(epc, dec.is_store);
+
+    // epc in frame is restored by slow path, fast path keeps mepc
+    epc += dec.len;
+    frame->epc = epc;
+    __RV_CSR_WRITE(CSR_MEPC, epc);
+    return;
+
+unhandled:
+    // fast path does not save csr in frame, fill them for the handler dumping frame
+    frame->cause = mcause;
+    frame->epc = epc;
+    frame->msubm = __RV_CSR_READ(CSR_MSUBM);
+    ((void (*)(unsigned long, unsigned long))misalign_prev_handler[(mcause & 0xFFF) == CAUSE_MISALIGNED_STORE])(mcause, sp);
+}
+
+void misalign_init(void)
+{
+    misalign_prev_handler[0] = Exception_Get_EXC(CAUSE_MISALIGNED_LOAD);
+    misalign_prev_handler[1] = Exception_Get_EXC(CAUSE_MISALIGNED_STORE);
+#if defined(NUCLEI_FAST_EXC) && (NUCLEI_FAST_EXC == 1)
+    Exception_Register_Fast_EXC(CAUSE_MISALIGNED_LOAD, (unsigned long)misalign_exception_handler);
+    Exception_Register_Fast_EXC(CAUSE_MISALIGNED_STORE, (unsigned long)misalign_exception_handler);
+#else
+    Exception_Register_EXC(CAUSE_MISALIGNED_LOAD, (unsigned long)misalign_exception_handler);
+    Exception_Register_EXC(CAUSE_MISALIGNED_STORE, (unsigned long)misalign_exception_handler);
+#endif
+}
+
+void misalign_dump(void)
+{
+    misalign_stat_t sorted[MISALIGN_STAT_SIZE];
+    misalign_stat_t tmp;
+    uint32_t cnt = 0;
+    uint32_t i, j;
+
+    for (i = 0; i < MISALIGN_STAT_SIZE; i++) {
+        if (misalign_stats[i].pc != 0) {
+            sorted[cnt++] = misalign_stats[i];
+        }
+    }
+    // insertion sort by hits, the table is small
+    for (i = 1; i < cnt; i++) {
+        tmp = sorted[i];
+        for (j = i; (j > 0) && ((sorted[j - 1].loads + sorted[j - 1].stores) < (tmp.loads + tmp.stores)); j--) {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = tmp;
+    }
+    printf("Misaligned access sites: %u, lost hits: %u\r\n", (unsigned int)cnt, (unsigned int)misalign_lost);
+    for (i = 0; i < cnt; i++) {
+        printf("  pc 0x%lx: loads %u, stores %u\r\n", sorted[i].pc,
+               (unsigned int)sorted[i].loads, (unsigned int)sorted[i].stores);
+    }
+}
+
+void misalign_reset(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < MISALIGN_STAT_SIZE; i++) {
+        misalign_stats[i].pc = 0;
+        misalign_stats[i].loads = 0;
+        misalign_stats[i].stores = 0;
+    }
+    misalign_lost = 0;
+}
@@ -0,0 +1,59 @@
+#ifndef _MISALIGN_API_H_
+#define _MISALIGN_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*
+ * Misaligned load/store emulation for cores without hardware misaligned access.
+ *
+ * misalign_init() registers the exception handler of misaligned load and store,
+ * which emulates the integer load/store instructions including the compressed ones
+ * by byte accesses, and counts the hits of each pc in misalign_stats, so the hot
+ * misaligned sites can be located by misalign_dump() and fixed in source code.
+ *
+ * - Floating point and atomic instructions are not emulated, and are passed to the
+ *   exception handler registered before
+ * - With NUCLEI_FAST_EXC=1, it is registered as fast path handler, which is the
+ *   recommended way since the trap cost is lower, and the saved registers s0-s11 are
+ *   exactly the ones of trapped code, otherwise the handlers between exc_entry and
+ *   this one must not change s0-s11 before calling it, which is true for
+ *   core_exception_handler in system_<Device>.c
+ * - If the cpu supports hardware misaligned access, set MMISC_CTL_MISALIGN in
+ *   CSR_MMISC_CTL instead
+ */
+
+/* max different pcs recorded, hits of other pcs are counted in misalign_lost */
+#ifndef MISALIGN_STAT_SIZE
+#define MISALIGN_STAT_SIZE      32
+#endif
+
+/* hits of one misaligned access site */
+typedef struct misalign_stat {
+    unsigned long pc;           /* pc of load/store instruction, 0 for unused entry */
+    uint32_t loads;             /* emulated loads */
+    uint32_t stores;            /* emulated stores */
+} misalign_stat_t;
+
+/* per pc statistics, can be read by debugger such as `print misalign_stats` in gdb */
+extern misalign_stat_t misalign_stats[MISALIGN_STAT_SIZE];
+/* hits not recorded since misalign_stats is full */
+extern uint32_t misalign_lost;
+
+/* Register misaligned load/store exception handlers */
+void misalign_init(void);
+
+/* Print recorded pcs and their hits, most hit first */
+void misalign_dump(void);
+
+/* Clear the statistics */
+void misalign_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_MISALIGN_API_H_ */
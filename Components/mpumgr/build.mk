@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# mpumgr middleware encodes PMP, sPMP or SMPU regions of tasks once and reprograms only
+# the changed entries in task switch
+MIDDLEWARE_MPUMGR := $(NUCLEI_SDK_MIDDLEWARE)/mpumgr
+
+C_SRCDIRS += $(MIDDLEWARE_MPUMGR)
+
+INCDIRS += $(MIDDLEWARE_MPUMGR)
@@ -0,0 +1,247 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "mpumgr_api.h"
+
+#if __RISCV_XLEN == 32
+#define MPUMGR_CFG_CSR_IDX(w)       (w)
+#else
+/* For RV64, pmpcfg0 and pmpcfg2 each hold 8 entries */
+#define MPUMGR_CFG_CSR_IDX(w)       ((w) << 1)
+#endif
+
+static uint32_t mpumgr_entry_num(uint32_t unit)
+{
+    switch (unit) {
+#if defined(__PMP_PRESENT) && (__PMP_PRESENT == 1)
+        case MPUMGR_PMP: return __PMP_ENTRY_NUM;
+#endif
+#if defined(__SPMP_PRESENT) && (__SPMP_PRESENT == 1)
+        case MPUMGR_SPMP: return __SPMP_ENTRY_NUM;
+#endif
+#if defined(__SMPU_PRESENT) && (__SMPU_PRESENT == 1)
+        case MPUMGR_SMPU: return __SMPU_ENTRY_NUM;
+#endif
+        default: return 0;
+    }
+}
+
+/* permissions allowed in task regions of unit, no lock and no address matching */
+static uint8_t mpumgr_perm_mask(uint32_t unit)
+{
+    switch (unit) {
+        case MPUMGR_PMP: return PMP_R | PMP_W | PMP_X;
+        case MPUMGR_SPMP: return SPMP_U | SPMP_R | SPMP_W | SPMP_X;
+        default: return SMPU_S | SMPU_R | SMPU_W | SMPU_X;
+    }
+}
+
+static rv_csr_t mpumgr_read_cfg(uint32_t unit, uint32_t w)
+{
+#if defined(__SPMP_PRESENT) && (__SPMP_PRESENT == 1)
+    if (unit != MPUMGR_PMP) {
+        return __get_sPMPCFGx(MPUMGR_CFG_CSR_IDX(w));
+    }
+#endif
+#if defined(__PMP_PRESENT) && (__PMP_PRESENT == 1)
+    return __get_PMPCFGx(MPUMGR_CFG_CSR_IDX(w));
+#else
+    return 0;
+#endif
+}
+
+static void mpumgr_write_cfg(uint32_t unit, uint32_t w, rv_csr_t val)
+{
+#if defined(__SPMP_PRESENT) && (__SPMP_PRESENT == 1)
+    if (unit != MPUMGR_PMP) {
+        __set_sPMPCFGx(MPUMGR_CFG_CSR_IDX(w), val);
+        return;
+    }
+#endif
+#if defined(__PMP_PRESENT) && (__PMP_PRESENT == 1)
+    __set_PMPCFGx(MPUMGR_CFG_CSR_IDX(w), val);
+#endif
+}
+
+static rv_csr_t mpumgr_read_addr(uint32_t unit, uint32_t entry)
+{
+#if defined(__SPMP_PRESENT) && (__SPMP_PRESENT == 1)
+    if (unit != MPUMGR_PMP) {
+        return __get_sPMPADDRx(entry);
+    }
+#endif
+#if defined(__PMP_PRESENT) && (__PMP_PRESENT == 1)
+    return __get_PMPADDRx(entry);
+#else
+    return 0;
+#endif
+}
+
+static void mpumgr_write_addr(uint32_t unit, uint32_t entry, rv_csr_t val)
+{
+#if defined(__SPMP_PRESENT) && (__SPMP_PRESENT == 1)
+    if (unit != MPUMGR_PMP) {
+        __set_sPMPADDRx(entry, val);
+        return;
+    }
+#endif
+#if defined(__PMP_PRESENT) && (__PMP_PRESENT == 1)
+    __set_PMPADDRx(entry, val);
+#endif
+}
+
+int32_t mpumgr_init(mpumgr_t *mgr, uint32_t unit, uint32_t first, uint32_t num)
+{
+    uint32_t entry, w;
+
+    if ((mgr == NULL) || (num == 0) || (first + num > mpumgr_entry_num(unit))) {
+        return MPUMGR_EINVAL;
+    }
+    memset(mgr, 0, sizeof(mpumgr_t));
+    mgr->unit = unit;
+    mgr->first = first;
+    mgr->num = num;
+    for (entry = first; entry < first + num; entry++) {
+        mgr->winmask |= 1U << entry;
+        mgr->cfgmask[entry / MPUMGR_CFG_PER_CSR] |= 0xFFUL << ((entry % MPUMGR_CFG_PER_CSR) << 3);
+        mgr->loaded.addr[entry] = mpumgr_read_addr(unit, entry);
+    }
+    for (w = 0; w < MPUMGR_CFG_CSRS; w++) {
+        if (mgr->cfgmask[w] == 0) {
+            continue;
+        }
+        // keep the static entries sharing the CSR word, disable the window
+        mgr->loaded.cfg[w] = mpumgr_read_cfg(unit, w) & ~mgr->cfgmask[w];
+        mpumgr_write_cfg(unit, w, mgr->loaded.cfg[w]);
+    }
+#if defined(__SMPU_PRESENT) && (__SMPU_PRESENT == 1)
+    if (unit == MPUMGR_SMPU) {
+        // SMPU entries match only when switched on, then A field of cfg turns them on and off
+        __set_SMPUSWITCHx(__get_SMPUSWITCHx() | mgr->winmask);
+    }
+#endif
+    return 0;
+}
+
+int32_t mpumgr_compile(const mpumgr_t *mgr, mpumgr_image_t *img, const mpumgr_region_t *regions, uint32_t cnt)
+{
+    uint32_t i, entry, used = 0;
+    unsigned long base, size, bottom, top = 0;
+    int32_t has_top = 0;
+    uint8_t permmask, pmpcfg;
+
+    if ((mgr == NULL) || (img == NULL) || ((regions == NULL) && (cnt != 0))) {
+        return MPUMGR_EINVAL;
+    }
+    memset(img, 0, sizeof(mpumgr_image_t));
+    permmask = mpumgr_perm_mask(mgr->unit);
+    for (i = 0; i < cnt; i++) {
+        base = regions[i].base;
+        size = regions[i].size;
+        if ((size == 0) || ((base | size) & ((1UL << PMP_SHIFT) - 1)) || (size - 1 > ~base) ||
+            (regions[i].perm & ~permmask)) {
+            return MPUMGR_EINVAL;
+        }
+        entry = mgr->first + used;
+        if (((size & (size - 1)) == 0) && ((base & (size - 1)) == 0)) {
+            // naturally aligned power of 2, one NA4 or NAPOT entry
+            if (used + 1 > mgr->num) {
+                return MPUMGR_ENOSPC;
+            }
+            if (size == (1UL << PMP_SHIFT)) {
+                img->addr[entry] = base >> PMP_SHIFT;
+                pmpcfg = regions[i].perm | PMP_A_NA4;
+            } else {
+                img->addr[entry] = (base >> PMP_SHIFT) | ((size >> (PMP_SHIFT + 1)) - 1);
+                pmpcfg = regions[i].perm | PMP_A_NAPOT;
+            }
+            has_top = 0;
+        } else {
+            // TOR matches [pmpaddr[entry - 1], pmpaddr[entry]), bottom entry is disabled
+            bottom = base >> PMP_SHIFT;
+            if ((has_top && (top == bottom)) || ((bottom == 0) && (entry == 0))) {
+                if (used + 1 > mgr->num) {
+                    return MPUMGR_ENOSPC;
+                }
+            } else {
+                if (used + 2 > mgr->num) {
+                    return MPUMGR_ENOSPC;
+                }
+                img->addr[entry] = bottom;
+                img->addrmask |= 1U << entry;
+                used++;
+                entry++;
+            }
+            top = bottom + (size >> PMP_SHIFT);
+            has_top = 1;
+            img->addr[entry] = top;
+            pmpcfg = regions[i].perm | PMP_A_TOR;
+        }
+        img->addrmask |= 1U << entry;
+        img->cfg[entry / MPUMGR_CFG_PER_CSR] |= (rv_csr_t)pmpcfg << ((entry % MPUMGR_CFG_PER_CSR) << 3);
+        used++;
+    }
+    img->entries = used;
+    return used;
+}
+
+uint32_t mpumgr_switch(mpumgr_t *mgr, const mpumgr_image_t *img)
+{
+    mpumgr_image_t *ld = &mgr->loaded;
+    unsigned long mask;
+    uint32_t entry, w, writes = 0;
+    rv_csr_t cfg;
+
+    if (img == mgr->current) {
+        return 0;
+    }
+    /*
+     * update the addresses first, an entry changed is matched by the cfg of the previous
+     * image until its cfg word is written, no task runs in between
+     */
+    mask = (img != NULL) ? img->addrmask : 0;
+    while (mask) {
+        entry = __CTZ(mask);
+        mask &= mask - 1;
+        if (ld->addr[entry] != img->addr[entry]) {
+            ld->addr[entry] = img->addr[entry];
+            mpumgr_write_addr(mgr->unit, entry, img->addr[entry]);
+            writes++;
+        }
+    }
+    for (w = 0; w < MPUMGR_CFG_CSRS; w++) {
+        if (mgr->cfgmask[w] == 0) {
+            continue;
+        }
+        cfg = ld->cfg[w] & ~mgr->cfgmask[w];
+        if (img != NULL) {
+            cfg |= img->cfg[w];
+        }
+        if (cfg != ld->cfg[w]) {
+            ld->cfg[w] = cfg;
+            mpumgr_write_cfg(mgr->unit, w, cfg);
+            writes++;
+        }
+    }
+    mgr->current = img;
+    return writes;
+}
+
+void mpumgr_reload(mpumgr_t *mgr, const mpumgr_image_t *img)
+{
+    mpumgr_image_t *ld = &mgr->loaded;
+    uint32_t entry, w;
+
+    for (entry = mgr->first; entry < (uint32_t)mgr->first + mgr->num; entry++) {
+        ld->addr[entry] = mpumgr_read_addr(mgr->unit, entry);
+    }
+    for (w = 0; w < MPUMGR_CFG_CSRS; w++) {
+        if (mgr->cfgmask[w] != 0) {
+            // static entries sharing the word may be changed too, take them from the CSR
+            ld->cfg[w] = mpumgr_read_cfg(mgr->unit, w);
+        }
+    }
+    // no image is loaded, so mpumgr_switch() compares img with the values read
+    mgr->current = ld;
+    mpumgr_switch(mgr, img);
+}
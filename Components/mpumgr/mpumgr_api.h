@@ -0,0 +1,95 @@
+#ifndef _MPUMGR_API_H_
+#define _MPUMGR_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+
+/*
+ * Memory protection region manager for isolated RTOS tasks, on PMP, sPMP or SMPU.
+ *
+ * - Window: a manager owns the entries [first, first + num) of one unit, entries below the
+ *   window hold the static regions of the kernel, set once by __set_PMPENTRYx() and the like,
+ *   they match first, so the kernel is never affected by task entries, even half reprogrammed
+ * - Image: mpumgr_compile() encodes the regions of a task once, at task creation, to the
+ *   pmpaddr values and pmpcfg CSR words of the window, power of 2 sized and aligned regions
+ *   take one NA4 or NAPOT entry, others take a TOR entry, plus one for the bottom unless it is
+ *   the top of the previous TOR region or address 0 at entry 0
+ * - Switch: mpumgr_switch() called in the task switch loads the image of next task, it keeps
+ *   the values of the CSRs it loaded, and only writes the pmpaddr and pmpcfg CSRs which
+ *   differ from them, pmpaddr of a disabled entry is not cared, so tasks with common regions
+ *   or with less regions cost a few CSR writes, switching to the image loaded costs nothing
+ *
+ * Locked entries can't be reprogrammed, so PMP_L is rejected in task regions. A PMP manager
+ * must switch in machine mode and an sPMP or SMPU manager in supervisor mode or above, with
+ * no task running, the CSRs of the window must not be written by others after mpumgr_init().
+ */
+
+/* memory protection units */
+#define MPUMGR_PMP                  0
+#define MPUMGR_SPMP                 1
+#define MPUMGR_SMPU                 2
+
+/* errors of mpumgr_init() and mpumgr_compile() */
+#define MPUMGR_EINVAL               -1      /* invalid unit, window or region */
+#define MPUMGR_ENOSPC               -2      /* regions need more entries than the window */
+
+/* entries and pmpcfg CSR words of one unit at most */
+#define MPUMGR_MAX_ENTRIES          16
+#define MPUMGR_CFG_PER_CSR          (__RISCV_XLEN / 8)
+#define MPUMGR_CFG_CSRS             (MPUMGR_MAX_ENTRIES / MPUMGR_CFG_PER_CSR)
+
+/* one region of a task */
+typedef struct mpumgr_region {
+    unsigned long base;             /* base address, 4 bytes aligned */
+    unsigned long size;             /* size in bytes, multiple of 4 */
+    uint8_t perm;                   /* PMP_R/W/X of PMP, SPMP_U/R/W/X of sPMP, SMPU_S/R/W/X of SMPU */
+} mpumgr_region_t;
+
+/* CSR values of one window */
+typedef struct mpumgr_image {
+    rv_csr_t addr[MPUMGR_MAX_ENTRIES];  /* pmpaddr of each entry */
+    rv_csr_t cfg[MPUMGR_CFG_CSRS];      /* bytes of the window in each pmpcfg CSR word */
+    uint16_t addrmask;                  /* entries whose pmpaddr is used */
+    uint16_t entries;                   /* entries used from the window start */
+} mpumgr_image_t;
+
+/* manager of one window */
+typedef struct mpumgr {
+    uint8_t unit;                   /* MPUMGR_PMP, MPUMGR_SPMP or MPUMGR_SMPU */
+    uint8_t first;                  /* first entry of the window */
+    uint8_t num;                    /* entries of the window */
+    uint16_t winmask;               /* entries of the window */
+    rv_csr_t cfgmask[MPUMGR_CFG_CSRS];  /* bytes of the window in each pmpcfg CSR word */
+    const mpumgr_image_t *current;  /* image loaded, NULL after mpumgr_init() */
+    mpumgr_image_t loaded;          /* CSR values loaded, cfg holds the whole CSR words */
+} mpumgr_t;
+
+/*
+ * Init manager of entries [first, first + num) of unit, and disable them
+ * Return 0, or MPUMGR_EINVAL if unit is not present or window is out of its entries
+ */
+int32_t mpumgr_init(mpumgr_t *mgr, uint32_t unit, uint32_t first, uint32_t num);
+
+/*
+ * Encode regions of a task to img, regions are matched in the given order
+ * Return entries used, or MPUMGR_EINVAL/MPUMGR_ENOSPC, img is not usable then
+ */
+int32_t mpumgr_compile(const mpumgr_t *mgr, mpumgr_image_t *img, const mpumgr_region_t *regions, uint32_t cnt);
+
+/*
+ * Load img to the window, only CSRs with a different value are written, NULL disables the window
+ * Return number of CSRs written
+ */
+uint32_t mpumgr_switch(mpumgr_t *mgr, const mpumgr_image_t *img);
+
+/* Write all CSRs of img to the window, after they are changed by others */
+void mpumgr_reload(mpumgr_t *mgr, const mpumgr_image_t *img);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _MPUMGR_API_H_ */
@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# niceq middleware offloads work to NICE accelerators, with intrinsic templates of custom
+# instructions, an asynchronous command queue and a reference vs offload benchmark harness
+MIDDLEWARE_NICEQ := $(NUCLEI_SDK_MIDDLEWARE)/niceq
+
+C_SRCDIRS += $(MIDDLEWARE_NICEQ)
+
+INCDIRS += $(MIDDLEWARE_NICEQ)
@@ -0,0 +1,135 @@
+#include <stdint.h>
+#include <stddef.h>
+#include "niceq_api.h"
+
+void niceq_unit_init(niceq_unit_t *unit)
+{
+    unit->head = NULL;
+    unit->issue_next = NULL;
+    unit->tail = NULL;
+    unit->inflight = 0;
+    unit->submits = 0;
+    unit->done = 0;
+    unit->errors = 0;
+    if (unit->depth == 0) {
+        unit->depth = 1;
+    }
+}
+
+int32_t niceq_submit(niceq_unit_t *unit, niceq_cmd_t *cmd)
+{
+    rv_csr_t mstatus;
+
+    if (cmd == NULL) {
+        return -1;
+    }
+    cmd->next = NULL;
+    cmd->status = NICEQ_PENDING;
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if (unit->tail != NULL) {
+        unit->tail->next = cmd;
+    } else {
+        unit->head = cmd;
+    }
+    unit->tail = cmd;
+    if (unit->issue_next == NULL) {
+        unit->issue_next = cmd;
+    }
+    unit->submits++;
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    niceq_poll(unit);
+    return 0;
+}
+
+/* remove head of unit as completed with status, called with interrupts disabled */
+static niceq_cmd_t *niceq_complete(niceq_unit_t *unit, int32_t status)
+{
+    niceq_cmd_t *cmd = unit->head;
+
+    unit->head = cmd->next;
+    if (unit->head == NULL) {
+        unit->tail = NULL;
+    }
+    if (unit->issue_next == cmd) {
+        unit->issue_next = cmd->next;
+    } else {
+        unit->inflight--;
+    }
+    if (status == NICEQ_DONE) {
+        unit->done++;
+    } else {
+        unit->errors++;
+    }
+    cmd->next = NULL;
+    cmd->status = status;
+    return cmd;
+}
+
+uint32_t niceq_poll(niceq_unit_t *unit)
+{
+    niceq_cmd_t *cmd, *done = NULL, *last = NULL;
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    uint32_t left;
+    int32_t status;
+
+    // issued commands complete in order, the oldest one first
+    while (unit->inflight > 0) {
+        status = unit->poll(unit, unit->head);
+        if (status == NICEQ_PENDING) {
+            break;
+        }
+        cmd = niceq_complete(unit, (status == NICEQ_DONE) ? NICEQ_DONE : NICEQ_ERROR);
+        if (cmd->cb != NULL) {
+            if (last != NULL) {
+                last->next = cmd;
+            } else {
+                done = cmd;
+            }
+            last = cmd;
+        }
+    }
+    while ((unit->issue_next != NULL) && (unit->inflight < unit->depth)) {
+        cmd = unit->issue_next;
+        if (unit->issue(unit, cmd) != 0) {
+            // a refused command fails once nothing else runs, else it is issued again later
+            if (unit->inflight > 0) {
+                break;
+            }
+            cmd = niceq_complete(unit, NICEQ_ERROR);
+            if (cmd->cb != NULL) {
+                if (last != NULL) {
+                    last->next = cmd;
+                } else {
+                    done = cmd;
+                }
+                last = cmd;
+            }
+            continue;
+        }
+        unit->issue_next = cmd->next;
+        unit->inflight++;
+    }
+    left = unit->submits - unit->done - unit->errors;
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    // callbacks run with interrupts as the caller had them, a callback may submit again
+    while (done != NULL) {
+        cmd = done;
+        done = (cmd == last) ? NULL : cmd->next;
+        cmd->cb(cmd, cmd->cb_arg);
+    }
+    return left;
+}
+
+int32_t niceq_wait(niceq_unit_t *unit, niceq_cmd_t *cmd)
+{
+    while (cmd->status == NICEQ_PENDING) {
+        niceq_poll(unit);
+    }
+    return cmd->status;
+}
+
+void niceq_flush(niceq_unit_t *unit)
+{
+    while (niceq_poll(unit) != 0) {
+    }
+}
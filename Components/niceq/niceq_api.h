@@ -0,0 +1,109 @@
+#ifndef _NICEQ_API_H_
+#define _NICEQ_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "niceq_insn.h"
+
+/*
+ * Offload framework of NICE accelerators.
+ *
+ * - Instructions: niceq_insn.h defines intrinsics of custom opcodes from templates
+ * - Queue: a niceq_unit_t is one long-latency accelerator, issue() of it starts a command
+ *   by its NICE instructions and returns at once, poll() reads whether the oldest issued
+ *   command is done, commands are submitted to a FIFO, up to depth of them are issued to the
+ *   unit while the hart goes on with other work, niceq_poll() completes the done ones in
+ *   order and issues the queued ones, niceq_wait() polls until one command is done
+ * - Bench: niceq_bench_run() runs cases of a scalar reference and an offloaded version,
+ *   like normal_case() and nice_case() of demo_nice, counts cycles and instructions of both,
+ *   checks the results are the same and prints a table of them
+ *
+ * Callbacks run in the caller of niceq_poll(), which can be an interrupt handler, eg. a
+ * timer or the interrupt of the accelerator, queue operations disable interrupts.
+ */
+
+/* command status */
+#define NICEQ_DONE                  0
+#define NICEQ_PENDING               1
+#define NICEQ_ERROR                 -1
+
+struct niceq_cmd;
+/* completion callback of command */
+typedef void (*niceq_cb_t)(struct niceq_cmd *cmd, void *arg);
+
+/* command, owned by caller until completed */
+typedef struct niceq_cmd {
+    struct niceq_cmd *next;
+    uint32_t op;                    /* operation, meaning defined by unit */
+    unsigned long arg[3];           /* operands, eg. addresses and length */
+    unsigned long result;           /* set by poll() of unit */
+    niceq_cb_t cb;                  /* can be NULL */
+    void *cb_arg;
+    volatile int32_t status;        /* NICEQ_PENDING when submitted, NICEQ_DONE or NICEQ_ERROR */
+} niceq_cmd_t;
+
+typedef struct niceq_unit {
+    /* start cmd on accelerator, return 0 on success, -1 if it is refused */
+    int32_t (*issue)(struct niceq_unit *unit, niceq_cmd_t *cmd);
+    /* oldest issued cmd is NICEQ_PENDING, NICEQ_DONE with result set, or NICEQ_ERROR */
+    int32_t (*poll)(struct niceq_unit *unit, niceq_cmd_t *cmd);
+    uint32_t depth;                 /* commands the accelerator holds at once, at least 1 */
+    void *priv;                     /* for issue() and poll() */
+    /* private */
+    niceq_cmd_t *head;              /* oldest command */
+    niceq_cmd_t *issue_next;        /* first command not issued yet, or NULL */
+    niceq_cmd_t *tail;
+    uint32_t inflight;              /* commands issued and not completed */
+    uint32_t submits;
+    uint32_t done;
+    uint32_t errors;
+} niceq_unit_t;
+
+/* Init queue of unit, issue, poll, depth and priv must be set */
+void niceq_unit_init(niceq_unit_t *unit);
+
+/* Queue cmd to unit and issue it if the unit has room, return 0 on success, -1 on invalid cmd */
+int32_t niceq_submit(niceq_unit_t *unit, niceq_cmd_t *cmd);
+
+/* Complete done commands and issue queued ones, return number of commands not completed */
+uint32_t niceq_poll(niceq_unit_t *unit);
+
+/* Poll until cmd completes, return status of cmd */
+int32_t niceq_wait(niceq_unit_t *unit, niceq_cmd_t *cmd);
+
+/* Poll until all commands of unit complete */
+void niceq_flush(niceq_unit_t *unit);
+
+/* one case of niceq_bench_run(), functions get arg */
+typedef struct niceq_bench_case {
+    const char *name;
+    void (*prepare)(void *arg);     /* reset outputs of ref and nice before each loop, can be NULL */
+    void (*ref)(void *arg);         /* scalar reference */
+    void (*nice)(void *arg);        /* offloaded version */
+    int32_t (*check)(void *arg);    /* 0 if outputs of ref and nice are the same */
+    void *arg;
+} niceq_bench_case_t;
+
+/* counters of one case, the least of all loops */
+typedef struct niceq_bench_result {
+    uint64_t ref_cycles;
+    uint64_t ref_instret;
+    uint64_t nice_cycles;
+    uint64_t nice_instret;
+    int32_t pass;                   /* 1 if check passed in all loops */
+} niceq_bench_result_t;
+
+/*
+ * Run cnt cases loops times each, fill results if not NULL, print a table of them and
+ * return number of cases failed
+ */
+uint32_t niceq_bench_run(const niceq_bench_case_t *cases, uint32_t cnt, uint32_t loops,
+                         niceq_bench_result_t *results);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _NICEQ_API_H_ */
@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "niceq_api.h"
+
+/* cycles and instructions of fn(arg) */
+static void niceq_bench_count(void (*fn)(void *arg), void *arg, uint64_t *cycles, uint64_t *instret)
+{
+    uint64_t c, i;
+
+    c = __get_rv_cycle();
+    i = __get_rv_instret();
+    fn(arg);
+    i = __get_rv_instret() - i;
+    c = __get_rv_cycle() - c;
+    // the least of all loops, as the first one also warms up caches
+    *cycles = ((*cycles == 0) || (c < *cycles)) ? c : *cycles;
+    *instret = ((*instret == 0) || (i < *instret)) ? i : *instret;
+}
+
+uint32_t niceq_bench_run(const niceq_bench_case_t *cases, uint32_t cnt, uint32_t loops,
+                         niceq_bench_result_t *results)
+{
+    const niceq_bench_case_t *bc;
+    niceq_bench_result_t r;
+    uint32_t n, l, failed = 0;
+
+    __enable_mcycle_counter();
+    __enable_minstret_counter();
+    printf("%-16s %12s %12s %12s %12s %8s %s\r\n", "case", "ref cycle", "ref instret", "nice cycle",
+           "nice instret", "speedup", "check");
+    for (n = 0; n < cnt; n++) {
+        bc = &cases[n];
+        r.ref_cycles = 0;
+        r.ref_instret = 0;
+        r.nice_cycles = 0;
+        r.nice_instret = 0;
+        r.pass = 1;
+        for (l = 0; l < loops; l++) {
+            if (bc->prepare != NULL) {
+                bc->prepare(bc->arg);
+            }
+            niceq_bench_count(bc->ref, bc->arg, &r.ref_cycles, &r.ref_instret);
+            niceq_bench_count(bc->nice, bc->arg, &r.nice_cycles, &r.nice_instret);
+            if (bc->check(bc->arg) != 0) {
+                r.pass = 0;
+            }
+        }
+        if (!r.pass) {
+            failed++;
+        }
+        // speedup in hundredths, cycles of reference over cycles of nice
+        l = (r.nice_cycles != 0) ? (uint32_t)(r.ref_cycles * 100 / r.nice_cycles) : 0;
+        printf("%-16s %12lu %12lu %12lu %12lu %5lu.%02lu %s\r\n", bc->name, (unsigned long)r.ref_cycles,
+               (unsigned long)r.ref_instret, (unsigned long)r.nice_cycles, (unsigned long)r.nice_instret,
+               (unsigned long)(l / 100), (unsigned long)(l % 100), r.pass ? "PASS" : "FAIL");
+        if (results != NULL) {
+            results[n] = r;
+        }
+    }
+    return failed;
+}
@@ -0,0 +1,105 @@
+#ifndef _NICEQ_INSN_H_
+#define _NICEQ_INSN_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+
+/*
+ * Intrinsic templates of NICE custom instructions.
+ *
+ * A NICE instruction is a R-type instruction of a custom opcode, bits of funct3 tell the
+ * core which of rd, rs1 and rs2 it uses, funct7 selects the operation of the accelerator.
+ * NICEQ_INSN_* define a __STATIC_FORCEINLINE function issuing one, eg. the instructions of
+ * the NICE demo are
+ *
+ *     NICEQ_INSN_S1(custom_lbuf, NICEQ_OPCODE_CUSTOM0, 1)
+ *     NICEQ_INSN_S1(custom_sbuf, NICEQ_OPCODE_CUSTOM0, 2)
+ *     NICEQ_INSN_D_S1(custom_rowsum, NICEQ_OPCODE_CUSTOM0, 6)
+ *
+ * opcode and funct7 must be integer literals or macros of them, operands are unsigned long,
+ * the instructions are volatile and clobber memory, as they may read or write memory by the
+ * addresses of operands. MSTATUS_XS must be set before the first one, see niceq_enable().
+ */
+
+/* major opcodes of custom instructions */
+#define NICEQ_OPCODE_CUSTOM0        0x0b
+#define NICEQ_OPCODE_CUSTOM1        0x2b
+#define NICEQ_OPCODE_CUSTOM2        0x5b
+#define NICEQ_OPCODE_CUSTOM3        0x7b
+
+/* funct3 bits of NICE instruction */
+#define NICEQ_XD                    4       /* writes rd */
+#define NICEQ_XS1                   2       /* reads rs1 */
+#define NICEQ_XS2                   1       /* reads rs2 */
+
+#define __NICEQ_STR(x)              #x
+#define NICEQ_STR(x)                __NICEQ_STR(x)
+
+/* rd = name(rs1, rs2) */
+#define NICEQ_INSN_D_S1_S2(name, opcode, funct7)                                            \
+__STATIC_FORCEINLINE unsigned long name(unsigned long rs1, unsigned long rs2)               \
+{                                                                                           \
+    unsigned long rd;                                                                       \
+    __ASM volatile(".insn r " NICEQ_STR(opcode) ", 7, " NICEQ_STR(funct7) ", %0, %1, %2"    \
+                   : "=r"(rd) : "r"(rs1), "r"(rs2) : "memory");                             \
+    return rd;                                                                              \
+}
+
+/* rd = name(rs1) */
+#define NICEQ_INSN_D_S1(name, opcode, funct7)                                               \
+__STATIC_FORCEINLINE unsigned long name(unsigned long rs1)                                  \
+{                                                                                           \
+    unsigned long rd;                                                                       \
+    __ASM volatile(".insn r " NICEQ_STR(opcode) ", 6, " NICEQ_STR(funct7) ", %0, %1, x0"    \
+                   : "=r"(rd) : "r"(rs1) : "memory");                                       \
+    return rd;                                                                              \
+}
+
+/* rd = name(), eg. status of accelerator */
+#define NICEQ_INSN_D(name, opcode, funct7)                                                  \
+__STATIC_FORCEINLINE unsigned long name(void)                                               \
+{                                                                                           \
+    unsigned long rd;                                                                       \
+    __ASM volatile(".insn r " NICEQ_STR(opcode) ", 4, " NICEQ_STR(funct7) ", %0, x0, x0"    \
+                   : "=r"(rd) : : "memory");                                                \
+    return rd;                                                                              \
+}
+
+/* name(rs1, rs2) */
+#define NICEQ_INSN_S1_S2(name, opcode, funct7)                                              \
+__STATIC_FORCEINLINE void name(unsigned long rs1, unsigned long rs2)                        \
+{                                                                                           \
+    __ASM volatile(".insn r " NICEQ_STR(opcode) ", 3, " NICEQ_STR(funct7) ", x0, %0, %1"    \
+                   : : "r"(rs1), "r"(rs2) : "memory");                                      \
+}
+
+/* name(rs1) */
+#define NICEQ_INSN_S1(name, opcode, funct7)                                                 \
+__STATIC_FORCEINLINE void name(unsigned long rs1)                                           \
+{                                                                                           \
+    __ASM volatile(".insn r " NICEQ_STR(opcode) ", 2, " NICEQ_STR(funct7) ", x0, %0, x0"    \
+                   : : "r"(rs1) : "memory");                                                \
+}
+
+/* name(), eg. start or reset of accelerator */
+#define NICEQ_INSN(name, opcode, funct7)                                                    \
+__STATIC_FORCEINLINE void name(void)                                                        \
+{                                                                                           \
+    __ASM volatile(".insn r " NICEQ_STR(opcode) ", 0, " NICEQ_STR(funct7) ", x0, x0, x0"    \
+                   : : : "memory");                                                         \
+}
+
+/* Enable custom extension state, so NICE instructions don't trap */
+__STATIC_FORCEINLINE void niceq_enable(void)
+{
+    __RV_CSR_SET(CSR_MSTATUS, MSTATUS_XS);
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _NICEQ_INSN_H_ */
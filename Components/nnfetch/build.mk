@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# nnfetch middleware copies the fetched weights of a nnplan plan from external flash or memory into
+# its arena by DMA while layers run, add nnplan and dmaq to MIDDLEWARE too, and qspiflash on gd32vw55x
+MIDDLEWARE_NNFETCH := $(NUCLEI_SDK_MIDDLEWARE)/nnfetch
+
+C_SRCDIRS += $(MIDDLEWARE_NNFETCH)
+
+INCDIRS += $(MIDDLEWARE_NNFETCH)
@@ -0,0 +1,200 @@
+#include <stdint.h>
+#include <stddef.h>
+#include "nnfetch_api.h"
+
+/* max data of one dmaq request */
+#define NNFETCH_DMA_COUNT           0xFFFFUL
+
+static void nnfetch_dmaq_done(dmaq_req_t *req, void *arg);
+
+/* request the next part of running copy, return 1 if started */
+static int32_t nnfetch_dmaq_start(nnfetch_t *fetch)
+{
+    dmaq_req_t *req = &fetch->req;
+    uint32_t width, count;
+
+    width = ((((uintptr_t)fetch->cur.dst | fetch->cur.src | fetch->cur.size) & 3) == 0) ? 4 : 1;
+    count = fetch->cur.size / width;
+    count = (count > NNFETCH_DMA_COUNT) ? NNFETCH_DMA_COUNT : count;
+    fetch->chunk = count * width;
+    req->periph_addr = (uint32_t)fetch->cur.src;
+    req->mem = fetch->cur.dst;
+    req->count = count;
+    req->dir = DMAQ_DIR_M2M;
+    req->width = (uint8_t)width;
+    req->periph_inc = 1;
+    req->mem_inc = 1;
+    req->cb = nnfetch_dmaq_done;
+    req->arg = fetch;
+    return (dmaq_submit(fetch->chan, req) == 0) ? 1 : -1;
+}
+
+#if defined(GD32VW55x_H)
+static void nnfetch_qspiflash_done(qspiflash_job_t *job, int32_t status, void *arg);
+
+/*
+ * Read all of running copy, return 1 if started in background, 0 if read by qspiflash_read()
+ * when sync, as a background read is refused when the flash has to stay mapped
+ */
+static int32_t nnfetch_qspiflash_start(nnfetch_t *fetch, uint32_t sync)
+{
+    fetch->chunk = fetch->cur.size;
+    if (qspiflash_read_start(&fetch->job, (uint32_t)fetch->cur.src, fetch->cur.dst, fetch->cur.size,
+                             nnfetch_qspiflash_done, fetch) == 0) {
+        return 1;
+    }
+    if (!sync || (qspiflash_read((uint32_t)fetch->cur.src, fetch->cur.dst, fetch->cur.size) != 0)) {
+        return -1;
+    }
+    fetch->cur.size = 0;
+    return 0;
+}
+#endif
+
+/*
+ * Start running copy, or the next queued one when it is done, until one runs in background
+ * or the ring is empty, sync is 1 when called by nnfetch_start() with interrupts enabled,
+ * 0 in completion interrupt
+ */
+static void nnfetch_run(nnfetch_t *fetch, uint32_t sync)
+{
+    int32_t ret;
+
+    while (1) {
+        if (fetch->cur.size == 0) {
+            if (fetch->head == fetch->tail) {
+                fetch->busy = 0;
+                return;
+            }
+            fetch->cur = fetch->ring[fetch->head % NNFETCH_MAX_COPIES];
+            fetch->head++;
+        }
+#if defined(GD32VW55x_H)
+        if (fetch->engine == NNFETCH_QSPIFLASH) {
+            ret = nnfetch_qspiflash_start(fetch, sync);
+        } else
+#endif
+        {
+            ret = nnfetch_dmaq_start(fetch);
+        }
+        if (ret > 0) {
+            return;
+        }
+        if (ret < 0) {
+            // drop the queued copies too, the plan fails at its wait
+            fetch->error = -1;
+            fetch->cur.size = 0;
+            fetch->head = fetch->tail;
+            fetch->busy = 0;
+            return;
+        }
+    }
+}
+
+/* running part is done, go on with the rest */
+static void nnfetch_done(nnfetch_t *fetch, uint32_t ok)
+{
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+
+    if (ok) {
+        fetch->cur.dst += fetch->chunk;
+        fetch->cur.src += fetch->chunk;
+        fetch->cur.size -= fetch->chunk;
+    } else {
+        fetch->error = -1;
+        fetch->cur.size = 0;
+        fetch->head = fetch->tail;
+    }
+    nnfetch_run(fetch, 0);
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
+
+static void nnfetch_dmaq_done(dmaq_req_t *req, void *arg)
+{
+    nnfetch_done((nnfetch_t *)arg, req->status == DMAQ_DONE);
+}
+
+#if defined(GD32VW55x_H)
+static void nnfetch_qspiflash_done(qspiflash_job_t *job, int32_t status, void *arg)
+{
+    nnfetch_done((nnfetch_t *)arg, status == 0);
+}
+#endif
+
+/* start() of hook */
+static int32_t nnfetch_start(void *dst, uintptr_t src, uint32_t size, void *arg)
+{
+    nnfetch_t *fetch = (nnfetch_t *)arg;
+    nnfetch_copy_t *copy;
+    rv_csr_t mstatus;
+    uint32_t idle;
+
+    if (fetch->error != 0) {
+        return -1;
+    }
+    if (size == 0) {
+        return 0;
+    }
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    // ring is full, sleep until the running copy is done
+    while (fetch->tail - fetch->head == NNFETCH_MAX_COPIES) {
+        __WFI();
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+        mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    }
+    copy = &fetch->ring[fetch->tail % NNFETCH_MAX_COPIES];
+    copy->dst = (uint8_t *)dst;
+    copy->src = src;
+    copy->size = size;
+    fetch->tail++;
+    idle = !fetch->busy;
+    fetch->busy = 1;
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    // no interrupt of fetch is pending while idle, a synchronous qspiflash_read() needs them
+    if (idle) {
+        nnfetch_run(fetch, 1);
+    }
+    return 0;
+}
+
+/* wait() of hook */
+static int32_t nnfetch_wait(void *arg)
+{
+    nnfetch_t *fetch = (nnfetch_t *)arg;
+    rv_csr_t mstatus;
+    int32_t ret;
+
+    __wfi_while_pending(&fetch->busy, 1);
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    ret = fetch->error;
+    fetch->error = 0;
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return ret;
+}
+
+static void nnfetch_init(nnfetch_t *fetch, uint32_t engine, uint32_t chan)
+{
+    fetch->hook.start = nnfetch_start;
+    fetch->hook.wait = nnfetch_wait;
+    fetch->hook.arg = fetch;
+    fetch->engine = engine;
+    fetch->chan = chan;
+    fetch->head = 0;
+    fetch->tail = 0;
+    fetch->busy = 0;
+    fetch->error = 0;
+    fetch->cur.size = 0;
+    fetch->chunk = 0;
+}
+
+void nnfetch_dmaq_init(nnfetch_t *fetch, uint32_t chan)
+{
+    nnfetch_init(fetch, NNFETCH_DMAQ, chan);
+}
+
+#if defined(GD32VW55x_H)
+void nnfetch_qspiflash_init(nnfetch_t *fetch)
+{
+    nnfetch_init(fetch, NNFETCH_QSPIFLASH, 0);
+}
+#endif
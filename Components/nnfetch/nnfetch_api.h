@@ -0,0 +1,78 @@
+#ifndef _NNFETCH_API_H_
+#define _NNFETCH_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "nnplan_api.h"
+#include "dmaq_api.h"
+#if defined(GD32VW55x_H)
+#include "qspiflash_api.h"
+#endif
+
+/*
+ * Copy engines of NNPLAN_TENSOR_FETCH tensors of nnplan, for weights streamed from external
+ * flash into on-chip RAM during inference.
+ *
+ * - Queue: copies started by nnplan are queued in a ring of NNFETCH_MAX_COPIES and run one
+ *   after another in the background, the completion interrupt of one starts the next one, so
+ *   the weights of the next layer are copied while the current layer computes
+ * - DMA: nnfetch_dmaq_init() copies src as a memory address, eg. the memory-mapped XIP window,
+ *   by memory to memory requests of a dmaq channel, words when dst, src and size are 4 bytes
+ *   aligned, else bytes
+ * - QSPI flash: nnfetch_qspiflash_init() on gd32vw55x reads src as a flash address by
+ *   qspiflash_read_start(), XIP is off while a copy runs, so layers must run from RAM, when
+ *   the flash can't read in background, eg. xip_code is set, the copy is a qspiflash_read()
+ *   which returns when done
+ *
+ * Give hook to nnplan_set_fetch(), the nnfetch_t must stay valid while the plan runs.
+ */
+
+/* max copies queued */
+#ifndef NNFETCH_MAX_COPIES
+#define NNFETCH_MAX_COPIES          8
+#endif
+
+/* engine of nnfetch_t */
+#define NNFETCH_DMAQ                0
+#define NNFETCH_QSPIFLASH           1
+
+/* one queued copy */
+typedef struct nnfetch_copy {
+    uint8_t *dst;
+    uintptr_t src;
+    uint32_t size;
+} nnfetch_copy_t;
+
+typedef struct nnfetch {
+    nnplan_fetch_t hook;            /* for nnplan_set_fetch() */
+    /* private */
+    uint32_t engine;                /* NNFETCH_* */
+    uint32_t chan;                  /* dmaq channel of NNFETCH_DMAQ */
+    nnfetch_copy_t ring[NNFETCH_MAX_COPIES];
+    volatile uint32_t head;         /* copies taken from ring */
+    volatile uint32_t tail;         /* copies put to ring */
+    volatile int32_t busy;          /* cur is running */
+    volatile int32_t error;         /* a copy failed since the last nnfetch wait */
+    nnfetch_copy_t cur;             /* rest of running copy */
+    uint32_t chunk;                 /* bytes of running request */
+    dmaq_req_t req;
+#if defined(GD32VW55x_H)
+    qspiflash_job_t job;
+#endif
+} nnfetch_t;
+
+/* Copy by memory to memory DMA of chan, initialized by dmaq_chan_init() */
+void nnfetch_dmaq_init(nnfetch_t *fetch, uint32_t chan);
+
+#if defined(GD32VW55x_H)
+/* Copy by background reads of qspiflash, initialized by qspiflash_init() */
+void nnfetch_qspiflash_init(nnfetch_t *fetch);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _NNFETCH_API_H_ */
@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# nnfuse middleware runs conv and pooling, depthwise and pointwise, FC and softmax of NMSIS-NN
+# as fused layers by strips of output rows, add nmsis_nn to NMSIS_LIB too
+MIDDLEWARE_NNFUSE := $(NUCLEI_SDK_MIDDLEWARE)/nnfuse
+
+C_SRCDIRS += $(MIDDLEWARE_NNFUSE)
+
+INCDIRS += $(MIDDLEWARE_NNFUSE)
@@ -0,0 +1,276 @@
+#include <stdint.h>
+#include <stddef.h>
+#include "riscv_nnfunctions.h"
+#include "nnfuse_api.h"
+
+/* the kernel buffer follows the strip on this boundary */
+#define NNFUSE_ALIGN                16
+#define NNFUSE_ROUND(x)             (((x) + NNFUSE_ALIGN - 1) & ~(int32_t)(NNFUSE_ALIGN - 1))
+
+static int32_t nnfuse_min(int32_t a, int32_t b)
+{
+    return (a < b) ? a : b;
+}
+
+static int32_t nnfuse_max(int32_t a, int32_t b)
+{
+    return (a > b) ? a : b;
+}
+
+/*
+ * Rows [*i0, *i1) of an input of in_h rows read by output rows [o0, o1) of a window of
+ * extent rows, return the top padding of the slice, which places output row o0 at its first
+ * row as in the whole layer, rows past *i1 are padding of the whole layer too
+ */
+static int32_t nnfuse_rows(int32_t o0, int32_t o1, int32_t stride, int32_t pad, int32_t extent, int32_t in_h,
+                           int32_t *i0, int32_t *i1)
+{
+    int32_t lo = o0 * stride - pad, hi = (o1 - 1) * stride - pad + extent;
+
+    *i0 = nnfuse_max(lo, 0);
+    *i1 = nnfuse_min(hi, in_h);
+    return *i0 - lo;
+}
+
+/* kernel buffer of a slice, the wrapper may select another kernel for slices without top padding */
+static int32_t nnfuse_conv_buffer(const nmsis_nn_conv_params *conv_params, const nmsis_nn_dims *input_dims,
+                                  const nmsis_nn_dims *filter_dims, const nmsis_nn_dims *output_dims)
+{
+    nmsis_nn_conv_params p = *conv_params;
+    int32_t size = riscv_convolve_wrapper_s8_get_buffer_size(&p, input_dims, filter_dims, output_dims);
+
+    p.padding.h = 0;
+    return nnfuse_max(size, riscv_convolve_wrapper_s8_get_buffer_size(&p, input_dims, filter_dims, output_dims));
+}
+
+static int32_t nnfuse_dw_buffer(const nmsis_nn_dw_conv_params *dw_params, const nmsis_nn_dims *input_dims,
+                                const nmsis_nn_dims *filter_dims, const nmsis_nn_dims *output_dims)
+{
+    nmsis_nn_dw_conv_params p = *dw_params;
+    int32_t size = riscv_depthwise_conv_wrapper_s8_get_buffer_size(&p, input_dims, filter_dims, output_dims);
+
+    p.padding.h = 0;
+    return nnfuse_max(size, riscv_depthwise_conv_wrapper_s8_get_buffer_size(&p, input_dims, filter_dims, output_dims));
+}
+
+/* kernel context in ctx after strip bytes */
+static riscv_nmsis_nn_status nnfuse_split(const nmsis_nn_context *ctx, int32_t strip, int32_t need,
+                                          nmsis_nn_context *kctx)
+{
+    if ((ctx == NULL) || (ctx->buf == NULL) || (ctx->size < need)) {
+        return RISCV_NMSIS_NN_ARG_ERROR;
+    }
+    kctx->buf = (need > strip) ? (void *)((int8_t *)ctx->buf + strip) : NULL;
+    kctx->size = ctx->size - strip;
+    return RISCV_NMSIS_NN_SUCCESS;
+}
+
+/* buffer of nnfuse_conv_pool_s8(), *strip gets the bytes of its strip part */
+static int32_t nnfuse_conv_pool_plan(const nmsis_nn_conv_params *conv_params, const nmsis_nn_dims *input_dims,
+                                     const nmsis_nn_dims *filter_dims, const nmsis_nn_dims *conv_dims,
+                                     const nmsis_nn_pool_params *pool_params, const nmsis_nn_dims *pool_dims,
+                                     const nmsis_nn_dims *output_dims, nnfuse_pool_t pool, int32_t *strip)
+{
+    int32_t extent = (filter_dims->h - 1) * conv_params->dilation.h + 1, kbuf;
+    nmsis_nn_dims in = *input_dims, out = *conv_dims;
+
+    out.n = 1;
+    out.h = nnfuse_min(conv_dims->h, (NNFUSE_STRIP_ROWS - 1) * pool_params->stride.h + pool_dims->h);
+    in.n = 1;
+    in.h = nnfuse_min(input_dims->h, (out.h - 1) * conv_params->stride.h + extent);
+    *strip = NNFUSE_ROUND(out.h * out.w * out.c);
+    kbuf = nnfuse_conv_buffer(conv_params, &in, filter_dims, &out);
+    if (pool == NNFUSE_POOL_AVG) {
+        kbuf = nnfuse_max(kbuf, riscv_avgpool_s8_get_buffer_size(output_dims->w, conv_dims->c));
+    }
+    return *strip + kbuf;
+}
+
+int32_t nnfuse_conv_pool_s8_get_buffer_size(const nmsis_nn_conv_params *conv_params, const nmsis_nn_dims *input_dims,
+                                            const nmsis_nn_dims *filter_dims, const nmsis_nn_dims *conv_dims,
+                                            const nmsis_nn_pool_params *pool_params, const nmsis_nn_dims *pool_dims,
+                                            const nmsis_nn_dims *output_dims, nnfuse_pool_t pool)
+{
+    int32_t strip;
+
+    return nnfuse_conv_pool_plan(conv_params, input_dims, filter_dims, conv_dims, pool_params, pool_dims,
+                                 output_dims, pool, &strip);
+}
+
+riscv_nmsis_nn_status nnfuse_conv_pool_s8(const nmsis_nn_context *ctx, const nmsis_nn_conv_params *conv_params,
+                                          const nmsis_nn_per_channel_quant_params *quant_params,
+                                          const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                          const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                          const nmsis_nn_dims *bias_dims, const int32_t *bias_data,
+                                          const nmsis_nn_dims *conv_dims, const nmsis_nn_pool_params *pool_params,
+                                          const nmsis_nn_dims *pool_dims, const nmsis_nn_dims *output_dims,
+                                          nnfuse_pool_t pool, int8_t *output_data)
+{
+    nmsis_nn_conv_params cp = *conv_params;
+    nmsis_nn_pool_params pp = *pool_params;
+    nmsis_nn_dims in = *input_dims, mid = *conv_dims, out = *output_dims;
+    nmsis_nn_context kctx;
+    int32_t extent = (filter_dims->h - 1) * conv_params->dilation.h + 1;
+    int32_t in_row = input_dims->w * input_dims->c, out_row = output_dims->w * output_dims->c;
+    int32_t strip, need, b, p0, p1, c0, c1, i0, i1;
+    int8_t *buf;
+    riscv_nmsis_nn_status status;
+
+    need = nnfuse_conv_pool_plan(conv_params, input_dims, filter_dims, conv_dims, pool_params, pool_dims,
+                                 output_dims, pool, &strip);
+    status = nnfuse_split(ctx, strip, need, &kctx);
+    if (status != RISCV_NMSIS_NN_SUCCESS) {
+        return status;
+    }
+    buf = (int8_t *)ctx->buf;
+    in.n = mid.n = out.n = 1;
+    for (b = 0; b < input_dims->n; b++) {
+        for (p0 = 0; p0 < output_dims->h; p0 += NNFUSE_STRIP_ROWS) {
+            p1 = nnfuse_min(output_dims->h, p0 + NNFUSE_STRIP_ROWS);
+            // pooled rows [p0, p1) read convolution rows [c0, c1), which read input rows [i0, i1)
+            pp.padding.h = nnfuse_rows(p0, p1, pool_params->stride.h, pool_params->padding.h, pool_dims->h,
+                                       conv_dims->h, &c0, &c1);
+            cp.padding.h = nnfuse_rows(c0, c1, conv_params->stride.h, conv_params->padding.h, extent,
+                                       input_dims->h, &i0, &i1);
+            in.h = i1 - i0;
+            mid.h = c1 - c0;
+            out.h = p1 - p0;
+            status = riscv_convolve_wrapper_s8(&kctx, &cp, quant_params, &in, input_data + i0 * in_row, filter_dims,
+                                               filter_data, bias_dims, bias_data, &mid, buf);
+            if (status != RISCV_NMSIS_NN_SUCCESS) {
+                return status;
+            }
+            if (pool == NNFUSE_POOL_AVG) {
+                status = riscv_avgpool_s8(&kctx, &pp, &mid, buf, pool_dims, &out, output_data + p0 * out_row);
+            } else {
+                status = riscv_max_pool_s8(&kctx, &pp, &mid, buf, pool_dims, &out, output_data + p0 * out_row);
+            }
+            if (status != RISCV_NMSIS_NN_SUCCESS) {
+                return status;
+            }
+        }
+        input_data += input_dims->h * in_row;
+        output_data += output_dims->h * out_row;
+    }
+    return RISCV_NMSIS_NN_SUCCESS;
+}
+
+/* buffer of nnfuse_dw_pw_s8(), *strip gets the bytes of its strip part */
+static int32_t nnfuse_dw_pw_plan(const nmsis_nn_dw_conv_params *dw_params, const nmsis_nn_dims *input_dims,
+                                 const nmsis_nn_dims *dw_filter_dims, const nmsis_nn_dims *dw_dims,
+                                 const nmsis_nn_conv_params *pw_params, const nmsis_nn_dims *pw_filter_dims,
+                                 const nmsis_nn_dims *output_dims, int32_t *strip)
+{
+    int32_t extent = (dw_filter_dims->h - 1) * dw_params->dilation.h + 1, kbuf;
+    nmsis_nn_dims in = *input_dims, mid = *dw_dims, out = *output_dims;
+
+    mid.n = 1;
+    mid.h = nnfuse_min(dw_dims->h, NNFUSE_STRIP_ROWS);
+    in.n = 1;
+    in.h = nnfuse_min(input_dims->h, (mid.h - 1) * dw_params->stride.h + extent);
+    out.n = 1;
+    out.h = mid.h;
+    *strip = NNFUSE_ROUND(mid.h * mid.w * mid.c);
+    kbuf = nnfuse_max(nnfuse_dw_buffer(dw_params, &in, dw_filter_dims, &mid),
+                      riscv_convolve_wrapper_s8_get_buffer_size(pw_params, &mid, pw_filter_dims, &out));
+    return *strip + kbuf;
+}
+
+int32_t nnfuse_dw_pw_s8_get_buffer_size(const nmsis_nn_dw_conv_params *dw_params, const nmsis_nn_dims *input_dims,
+                                        const nmsis_nn_dims *dw_filter_dims, const nmsis_nn_dims *dw_dims,
+                                        const nmsis_nn_conv_params *pw_params, const nmsis_nn_dims *pw_filter_dims,
+                                        const nmsis_nn_dims *output_dims)
+{
+    int32_t strip;
+
+    return nnfuse_dw_pw_plan(dw_params, input_dims, dw_filter_dims, dw_dims, pw_params, pw_filter_dims,
+                             output_dims, &strip);
+}
+
+riscv_nmsis_nn_status nnfuse_dw_pw_s8(const nmsis_nn_context *ctx, const nmsis_nn_dw_conv_params *dw_params,
+                                      const nmsis_nn_per_channel_quant_params *dw_quant,
+                                      const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                      const nmsis_nn_dims *dw_filter_dims, const int8_t *dw_filter_data,
+                                      const nmsis_nn_dims *dw_bias_dims, const int32_t *dw_bias_data,
+                                      const nmsis_nn_dims *dw_dims, const nmsis_nn_conv_params *pw_params,
+                                      const nmsis_nn_per_channel_quant_params *pw_quant,
+                                      const nmsis_nn_dims *pw_filter_dims, const int8_t *pw_filter_data,
+                                      const nmsis_nn_dims *pw_bias_dims, const int32_t *pw_bias_data,
+                                      const nmsis_nn_dims *output_dims, int8_t *output_data)
+{
+    nmsis_nn_dw_conv_params dp = *dw_params;
+    nmsis_nn_dims in = *input_dims, mid = *dw_dims, out = *output_dims;
+    nmsis_nn_context kctx;
+    int32_t extent = (dw_filter_dims->h - 1) * dw_params->dilation.h + 1;
+    int32_t in_row = input_dims->w * input_dims->c, out_row = output_dims->w * output_dims->c;
+    int32_t strip, need, b, r0, r1, i0, i1;
+    int8_t *buf;
+    riscv_nmsis_nn_status status;
+
+    // rows of the strip map one to one to output rows only for a plain 1x1 pointwise
+    if ((pw_filter_dims->h != 1) || (pw_filter_dims->w != 1) || (pw_params->stride.h != 1) ||
+        (pw_params->stride.w != 1) || (pw_params->padding.h != 0) || (pw_params->padding.w != 0)) {
+        return RISCV_NMSIS_NN_ARG_ERROR;
+    }
+    need = nnfuse_dw_pw_plan(dw_params, input_dims, dw_filter_dims, dw_dims, pw_params, pw_filter_dims,
+                             output_dims, &strip);
+    status = nnfuse_split(ctx, strip, need, &kctx);
+    if (status != RISCV_NMSIS_NN_SUCCESS) {
+        return status;
+    }
+    buf = (int8_t *)ctx->buf;
+    in.n = mid.n = out.n = 1;
+    for (b = 0; b < input_dims->n; b++) {
+        for (r0 = 0; r0 < dw_dims->h; r0 += NNFUSE_STRIP_ROWS) {
+            r1 = nnfuse_min(dw_dims->h, r0 + NNFUSE_STRIP_ROWS);
+            dp.padding.h = nnfuse_rows(r0, r1, dw_params->stride.h, dw_params->padding.h, extent, input_dims->h,
+                                       &i0, &i1);
+            in.h = i1 - i0;
+            mid.h = out.h = r1 - r0;
+            status = riscv_depthwise_conv_wrapper_s8(&kctx, &dp, dw_quant, &in, input_data + i0 * in_row,
+                                                     dw_filter_dims, dw_filter_data, dw_bias_dims, dw_bias_data,
+                                                     &mid, buf);
+            if (status != RISCV_NMSIS_NN_SUCCESS) {
+                return status;
+            }
+            status = riscv_convolve_wrapper_s8(&kctx, pw_params, pw_quant, &mid, buf, pw_filter_dims, pw_filter_data,
+                                               pw_bias_dims, pw_bias_data, &out, output_data + r0 * out_row);
+            if (status != RISCV_NMSIS_NN_SUCCESS) {
+                return status;
+            }
+        }
+        input_data += input_dims->h * in_row;
+        output_data += output_dims->h * out_row;
+    }
+    return RISCV_NMSIS_NN_SUCCESS;
+}
+
+int32_t nnfuse_fc_softmax_s8_get_buffer_size(const nmsis_nn_dims *filter_dims, const nmsis_nn_dims *output_dims)
+{
+    return NNFUSE_ROUND(output_dims->n * output_dims->c) + riscv_fully_connected_s8_get_buffer_size(filter_dims);
+}
+
+riscv_nmsis_nn_status nnfuse_fc_softmax_s8(const nmsis_nn_context *ctx, const nmsis_nn_fc_params *fc_params,
+                                           const nmsis_nn_per_tensor_quant_params *quant_params,
+                                           const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                           const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                           const nmsis_nn_dims *bias_dims, const int32_t *bias_data,
+                                           const nmsis_nn_dims *output_dims, int32_t mult, int32_t shift,
+                                           int32_t diff_min, int8_t *output_data)
+{
+    int32_t strip = NNFUSE_ROUND(output_dims->n * output_dims->c);
+    nmsis_nn_context kctx;
+    riscv_nmsis_nn_status status;
+
+    status = nnfuse_split(ctx, strip, nnfuse_fc_softmax_s8_get_buffer_size(filter_dims, output_dims), &kctx);
+    if (status != RISCV_NMSIS_NN_SUCCESS) {
+        return status;
+    }
+    status = riscv_fully_connected_s8(&kctx, fc_params, quant_params, input_dims, input_data, filter_dims,
+                                      filter_data, bias_dims, bias_data, output_dims, (int8_t *)ctx->buf);
+    if (status != RISCV_NMSIS_NN_SUCCESS) {
+        return status;
+    }
+    riscv_softmax_s8((const int8_t *)ctx->buf, output_dims->n, output_dims->c, mult, shift, diff_min, output_data);
+    return RISCV_NMSIS_NN_SUCCESS;
+}
@@ -0,0 +1,104 @@
+#ifndef _NNFUSE_API_H_
+#define _NNFUSE_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "riscv_nnfunctions.h"
+
+/*
+ * Fused layers over NMSIS-NN s8 kernels, for graphs where a layer only feeds the next one.
+ *
+ * - Strips: the first layer is run on a strip of output rows into a small buffer, the
+ *   second layer consumes the strip right away, so the intermediate map never goes through
+ *   memory as a whole, the strip stays in L1 or data cache while it is read back
+ * - Slicing: a strip is computed by the wrapper NMSIS-NN kernels on a slice of input rows,
+ *   with the top padding of the slice set so it gives the same rows as the whole layer,
+ *   results are bit exact to running the two kernels in turn
+ * - Activation: ReLU and ReLU6 are the activation range of conv_params or dw_conv_params,
+ *   clamped in the requantization of the convolution, so no pass is needed for them
+ * - Overlap: pooling windows which overlap, as 3x3 with stride 2, share convolution rows
+ *   between strips, these rows are computed once per strip, NNFUSE_STRIP_ROWS larger makes
+ *   them a smaller part of the work
+ * - Scratch: ctx holds the strip and the buffer of the kernels, nnfuse_*_get_buffer_size()
+ *   gives its size, the fused function returns RISCV_NMSIS_NN_ARG_ERROR if ctx is smaller
+ *
+ * Dims follow the kernels, [N, H, W, C] with N of 1 for the maps, batches are run one by one.
+ */
+
+/* output rows of one strip */
+#ifndef NNFUSE_STRIP_ROWS
+#define NNFUSE_STRIP_ROWS           2
+#endif
+
+typedef enum {
+    NNFUSE_POOL_MAX = 0,            /* riscv_max_pool_s8() */
+    NNFUSE_POOL_AVG = 1,            /* riscv_avgpool_s8() */
+} nnfuse_pool_t;
+
+/*
+ * Bytes of ctx for nnfuse_conv_pool_s8(), conv_dims is the output of the convolution and the
+ * input of the pooling
+ */
+int32_t nnfuse_conv_pool_s8_get_buffer_size(const nmsis_nn_conv_params *conv_params, const nmsis_nn_dims *input_dims,
+                                            const nmsis_nn_dims *filter_dims, const nmsis_nn_dims *conv_dims,
+                                            const nmsis_nn_pool_params *pool_params, const nmsis_nn_dims *pool_dims,
+                                            const nmsis_nn_dims *output_dims, nnfuse_pool_t pool);
+
+/*
+ * Same as riscv_convolve_wrapper_s8() into conv_dims followed by riscv_max_pool_s8() or
+ * riscv_avgpool_s8() with pool_params and pool_dims into output_dims, by strips of
+ * NNFUSE_STRIP_ROWS pooled rows
+ */
+riscv_nmsis_nn_status nnfuse_conv_pool_s8(const nmsis_nn_context *ctx, const nmsis_nn_conv_params *conv_params,
+                                          const nmsis_nn_per_channel_quant_params *quant_params,
+                                          const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                          const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                          const nmsis_nn_dims *bias_dims, const int32_t *bias_data,
+                                          const nmsis_nn_dims *conv_dims, const nmsis_nn_pool_params *pool_params,
+                                          const nmsis_nn_dims *pool_dims, const nmsis_nn_dims *output_dims,
+                                          nnfuse_pool_t pool, int8_t *output_data);
+
+/* Bytes of ctx for nnfuse_dw_pw_s8(), dw_dims is the output of the depthwise convolution */
+int32_t nnfuse_dw_pw_s8_get_buffer_size(const nmsis_nn_dw_conv_params *dw_params, const nmsis_nn_dims *input_dims,
+                                        const nmsis_nn_dims *dw_filter_dims, const nmsis_nn_dims *dw_dims,
+                                        const nmsis_nn_conv_params *pw_params, const nmsis_nn_dims *pw_filter_dims,
+                                        const nmsis_nn_dims *output_dims);
+
+/*
+ * Same as riscv_depthwise_conv_wrapper_s8() into dw_dims followed by the 1x1 pointwise
+ * riscv_convolve_wrapper_s8() into output_dims, by strips of NNFUSE_STRIP_ROWS rows, the
+ * pointwise convolution has stride 1 and no padding
+ */
+riscv_nmsis_nn_status nnfuse_dw_pw_s8(const nmsis_nn_context *ctx, const nmsis_nn_dw_conv_params *dw_params,
+                                      const nmsis_nn_per_channel_quant_params *dw_quant,
+                                      const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                      const nmsis_nn_dims *dw_filter_dims, const int8_t *dw_filter_data,
+                                      const nmsis_nn_dims *dw_bias_dims, const int32_t *dw_bias_data,
+                                      const nmsis_nn_dims *dw_dims, const nmsis_nn_conv_params *pw_params,
+                                      const nmsis_nn_per_channel_quant_params *pw_quant,
+                                      const nmsis_nn_dims *pw_filter_dims, const int8_t *pw_filter_data,
+                                      const nmsis_nn_dims *pw_bias_dims, const int32_t *pw_bias_data,
+                                      const nmsis_nn_dims *output_dims, int8_t *output_data);
+
+/* Bytes of ctx for nnfuse_fc_softmax_s8() */
+int32_t nnfuse_fc_softmax_s8_get_buffer_size(const nmsis_nn_dims *filter_dims, const nmsis_nn_dims *output_dims);
+
+/*
+ * Same as riscv_fully_connected_s8() followed by riscv_softmax_s8() with mult, shift and
+ * diff_min on each of output_dims->n rows of output_dims->c logits, the logits stay in ctx
+ */
+riscv_nmsis_nn_status nnfuse_fc_softmax_s8(const nmsis_nn_context *ctx, const nmsis_nn_fc_params *fc_params,
+                                           const nmsis_nn_per_tensor_quant_params *quant_params,
+                                           const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                           const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                           const nmsis_nn_dims *bias_dims, const int32_t *bias_data,
+                                           const nmsis_nn_dims *output_dims, int32_t mult, int32_t shift,
+                                           int32_t diff_min, int8_t *output_data);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _NNFUSE_API_H_ */
@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# nnpar middleware splits NMSIS-NN convolution, depthwise convolution and fully connected
+# layers into tiles run on all harts, add smpwork to MIDDLEWARE and nmsis_nn to NMSIS_LIB too
+MIDDLEWARE_NNPAR := $(NUCLEI_SDK_MIDDLEWARE)/nnpar
+
+C_SRCDIRS += $(MIDDLEWARE_NNPAR)
+
+INCDIRS += $(MIDDLEWARE_NNPAR)
@@ -0,0 +1,344 @@
+#include <stdint.h>
+#include <stddef.h>
+#include "nuclei_sdk_soc.h"
+#include "riscv_nnfunctions.h"
+#include "nnpar_api.h"
+
+/* parts of scratch start on this boundary */
+#define NNPAR_ALIGN                 16
+#define NNPAR_ROUND(x)              (((x) + NNPAR_ALIGN - 1) & ~(int32_t)(NNPAR_ALIGN - 1))
+
+/* convolution or depthwise convolution split by rows, dw selects which one */
+typedef struct nnpar_conv_job {
+    const nmsis_nn_conv_params *conv;
+    const nmsis_nn_dw_conv_params *dw;
+    const nmsis_nn_per_channel_quant_params *quant;
+    const nmsis_nn_dims *input_dims;
+    const int8_t *input;
+    const nmsis_nn_dims *filter_dims;
+    const int8_t *filter;
+    const nmsis_nn_dims *bias_dims;
+    const int32_t *bias;
+    const nmsis_nn_dims *output_dims;
+    int8_t *output;
+    int8_t *scratch;
+    int32_t part;                   /* bytes of scratch of one hart */
+    volatile riscv_nmsis_nn_status status;
+} nnpar_conv_job_t;
+
+typedef struct nnpar_fc_job {
+    const nmsis_nn_fc_params *fc;
+    const nmsis_nn_per_tensor_quant_params *quant;
+    const nmsis_nn_dims *input_dims;
+    const int8_t *input;
+    const nmsis_nn_dims *filter_dims;
+    const int8_t *filter;
+    const nmsis_nn_dims *bias_dims;
+    const int32_t *bias;
+    const nmsis_nn_dims *output_dims;
+    int8_t *output;
+    int8_t *scratch;
+    int32_t part;
+    int32_t by_batch;               /* tiles are batches instead of output channels */
+    volatile riscv_nmsis_nn_status status;
+} nnpar_fc_job_t;
+
+static void nnpar_default_runner(unsigned long begin, unsigned long end, unsigned long grain, smpwork_fn_t fn, void *arg)
+{
+    smpwork_parallel_for(begin, end, grain, fn, arg);
+}
+
+static nnpar_runner_t nnpar_runner = nnpar_default_runner;
+
+void nnpar_set_runner(nnpar_runner_t runner)
+{
+    nnpar_runner = (runner != NULL) ? runner : nnpar_default_runner;
+}
+
+static int32_t nnpar_min(int32_t a, int32_t b)
+{
+    return (a < b) ? a : b;
+}
+
+static int32_t nnpar_max(int32_t a, int32_t b)
+{
+    return (a > b) ? a : b;
+}
+
+/*
+ * Rows [*i0, *i1) of an input of in_h rows read by output rows [o0, o1) of a window of
+ * extent rows, return the top padding of the slice, which places output row o0 at its first
+ * row as in the whole layer
+ */
+static int32_t nnpar_rows(int32_t o0, int32_t o1, int32_t stride, int32_t pad, int32_t extent, int32_t in_h,
+                          int32_t *i0, int32_t *i1)
+{
+    int32_t lo = o0 * stride - pad, hi = (o1 - 1) * stride - pad + extent;
+
+    *i0 = nnpar_max(lo, 0);
+    *i1 = nnpar_min(hi, in_h);
+    return *i0 - lo;
+}
+
+/* scratch of the calling hart */
+static void nnpar_part(int8_t *scratch, int32_t part, nmsis_nn_context *ctx)
+{
+    ctx->buf = (part != 0) ? (void *)(scratch + __get_hart_index() * part) : NULL;
+    ctx->size = part;
+}
+
+/* bytes of scratch of one hart from the whole ctx, -1 if it is short of need bytes */
+static int32_t nnpar_split(const nmsis_nn_context *ctx, int32_t need)
+{
+    int32_t part = (ctx != NULL) ? ((ctx->size / SMPWORK_MAX_HARTS) & ~(int32_t)(NNPAR_ALIGN - 1)) : 0;
+
+    if ((need > 0) && ((part < need) || (ctx->buf == NULL))) {
+        return -1;
+    }
+    return part;
+}
+
+/* scratch of a tile, the wrapper may select another kernel for slices without top padding */
+static int32_t nnpar_conv_need(const nmsis_nn_conv_params *conv_params, const nmsis_nn_dw_conv_params *dw_params,
+                               const nmsis_nn_dims *input_dims, const nmsis_nn_dims *filter_dims,
+                               const nmsis_nn_dims *output_dims, uint32_t grain)
+{
+    nmsis_nn_dims in = *input_dims, out = *output_dims;
+    nmsis_nn_conv_params cp;
+    nmsis_nn_dw_conv_params dp;
+    int32_t stride, extent, size;
+
+    stride = (dw_params != NULL) ? dw_params->stride.h : conv_params->stride.h;
+    extent = (filter_dims->h - 1) * ((dw_params != NULL) ? dw_params->dilation.h : conv_params->dilation.h) + 1;
+    out.n = in.n = 1;
+    out.h = nnpar_min(output_dims->h, (int32_t)grain);
+    in.h = nnpar_min(input_dims->h, (out.h - 1) * stride + extent);
+    if (dw_params != NULL) {
+        dp = *dw_params;
+        size = riscv_depthwise_conv_wrapper_s8_get_buffer_size(&dp, &in, filter_dims, &out);
+        dp.padding.h = 0;
+        size = nnpar_max(size, riscv_depthwise_conv_wrapper_s8_get_buffer_size(&dp, &in, filter_dims, &out));
+    } else {
+        cp = *conv_params;
+        size = riscv_convolve_wrapper_s8_get_buffer_size(&cp, &in, filter_dims, &out);
+        cp.padding.h = 0;
+        size = nnpar_max(size, riscv_convolve_wrapper_s8_get_buffer_size(&cp, &in, filter_dims, &out));
+    }
+    return size;
+}
+
+/* output rows [begin, end) counted over all batches */
+static void nnpar_conv_tile(void *arg, unsigned long begin, unsigned long end)
+{
+    nnpar_conv_job_t *job = (nnpar_conv_job_t *)arg;
+    nmsis_nn_conv_params cp;
+    nmsis_nn_dw_conv_params dp;
+    nmsis_nn_dims in = *job->input_dims, out = *job->output_dims;
+    nmsis_nn_context ctx;
+    int32_t in_h = job->input_dims->h, out_h = job->output_dims->h;
+    int32_t in_row = job->input_dims->w * job->input_dims->c, out_row = job->output_dims->w * job->output_dims->c;
+    int32_t stride, pad, extent, pad_h, b, r0, r1, i0, i1;
+    riscv_nmsis_nn_status status;
+
+    if (job->dw != NULL) {
+        dp = *job->dw;
+        stride = dp.stride.h;
+        pad = dp.padding.h;
+        extent = (job->filter_dims->h - 1) * dp.dilation.h + 1;
+    } else {
+        cp = *job->conv;
+        stride = cp.stride.h;
+        pad = cp.padding.h;
+        extent = (job->filter_dims->h - 1) * cp.dilation.h + 1;
+    }
+    nnpar_part(job->scratch, job->part, &ctx);
+    in.n = out.n = 1;
+    // a tile may cross batches, each batch is one call
+    while (begin < end) {
+        b = (int32_t)(begin / (unsigned long)out_h);
+        r0 = (int32_t)(begin % (unsigned long)out_h);
+        r1 = nnpar_min(out_h, r0 + (int32_t)(end - begin));
+        pad_h = nnpar_rows(r0, r1, stride, pad, extent, in_h, &i0, &i1);
+        in.h = i1 - i0;
+        out.h = r1 - r0;
+        if (job->dw != NULL) {
+            dp.padding.h = pad_h;
+            status = riscv_depthwise_conv_wrapper_s8(&ctx, &dp, job->quant, &in,
+                                                     job->input + (b * in_h + i0) * in_row, job->filter_dims,
+                                                     job->filter, job->bias_dims, job->bias, &out,
+                                                     job->output + (b * out_h + r0) * out_row);
+        } else {
+            cp.padding.h = pad_h;
+            status = riscv_convolve_wrapper_s8(&ctx, &cp, job->quant, &in, job->input + (b * in_h + i0) * in_row,
+                                               job->filter_dims, job->filter, job->bias_dims, job->bias, &out,
+                                               job->output + (b * out_h + r0) * out_row);
+        }
+        if (status != RISCV_NMSIS_NN_SUCCESS) {
+            job->status = status;
+        }
+        begin += (unsigned long)(r1 - r0);
+    }
+}
+
+static riscv_nmsis_nn_status nnpar_conv_run(nnpar_conv_job_t *job, const nmsis_nn_context *ctx, uint32_t grain)
+{
+    int32_t rows = job->input_dims->n * job->output_dims->h;
+
+    grain = (grain != 0) ? grain : NNPAR_CONV_GRAIN;
+    job->part = nnpar_split(ctx, nnpar_conv_need(job->conv, job->dw, job->input_dims, job->filter_dims,
+                                                 job->output_dims, grain));
+    if (job->part < 0) {
+        return RISCV_NMSIS_NN_ARG_ERROR;
+    }
+    job->scratch = (int8_t *)((ctx != NULL) ? ctx->buf : NULL);
+    job->status = RISCV_NMSIS_NN_SUCCESS;
+    nnpar_runner(0, (unsigned long)rows, grain, nnpar_conv_tile, job);
+    return job->status;
+}
+
+int32_t nnpar_convolve_wrapper_s8_get_buffer_size(const nmsis_nn_conv_params *conv_params,
+                                                  const nmsis_nn_dims *input_dims, const nmsis_nn_dims *filter_dims,
+                                                  const nmsis_nn_dims *output_dims, uint32_t grain)
+{
+    grain = (grain != 0) ? grain : NNPAR_CONV_GRAIN;
+    return SMPWORK_MAX_HARTS * NNPAR_ROUND(nnpar_conv_need(conv_params, NULL, input_dims, filter_dims,
+                                                           output_dims, grain));
+}
+
+riscv_nmsis_nn_status nnpar_convolve_wrapper_s8(const nmsis_nn_context *ctx, const nmsis_nn_conv_params *conv_params,
+                                                const nmsis_nn_per_channel_quant_params *quant_params,
+                                                const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                                const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                                const nmsis_nn_dims *bias_dims, const int32_t *bias_data,
+                                                const nmsis_nn_dims *output_dims, int8_t *output_data, uint32_t grain)
+{
+    nnpar_conv_job_t job;
+
+    if ((input_dims->n * output_dims->h) <= (int32_t)((grain != 0) ? grain : NNPAR_CONV_GRAIN)) {
+        return riscv_convolve_wrapper_s8(ctx, conv_params, quant_params, input_dims, input_data, filter_dims,
+                                         filter_data, bias_dims, bias_data, output_dims, output_data);
+    }
+    job.conv = conv_params;
+    job.dw = NULL;
+    job.quant = quant_params;
+    job.input_dims = input_dims;
+    job.input = input_data;
+    job.filter_dims = filter_dims;
+    job.filter = filter_data;
+    job.bias_dims = bias_dims;
+    job.bias = bias_data;
+    job.output_dims = output_dims;
+    job.output = output_data;
+    return nnpar_conv_run(&job, ctx, grain);
+}
+
+int32_t nnpar_depthwise_conv_wrapper_s8_get_buffer_size(const nmsis_nn_dw_conv_params *dw_conv_params,
+                                                        const nmsis_nn_dims *input_dims,
+                                                        const nmsis_nn_dims *filter_dims,
+                                                        const nmsis_nn_dims *output_dims, uint32_t grain)
+{
+    grain = (grain != 0) ? grain : NNPAR_CONV_GRAIN;
+    return SMPWORK_MAX_HARTS * NNPAR_ROUND(nnpar_conv_need(NULL, dw_conv_params, input_dims, filter_dims,
+                                                           output_dims, grain));
+}
+
+riscv_nmsis_nn_status nnpar_depthwise_conv_wrapper_s8(const nmsis_nn_context *ctx,
+                                                      const nmsis_nn_dw_conv_params *dw_conv_params,
+                                                      const nmsis_nn_per_channel_quant_params *quant_params,
+                                                      const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                                      const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                                      const nmsis_nn_dims *bias_dims, const int32_t *bias_data,
+                                                      const nmsis_nn_dims *output_dims, int8_t *output_data,
+                                                      uint32_t grain)
+{
+    nnpar_conv_job_t job;
+
+    if ((input_dims->n * output_dims->h) <= (int32_t)((grain != 0) ? grain : NNPAR_CONV_GRAIN)) {
+        return riscv_depthwise_conv_wrapper_s8(ctx, dw_conv_params, quant_params, input_dims, input_data,
+                                               filter_dims, filter_data, bias_dims, bias_data, output_dims,
+                                               output_data);
+    }
+    job.conv = NULL;
+    job.dw = dw_conv_params;
+    job.quant = quant_params;
+    job.input_dims = input_dims;
+    job.input = input_data;
+    job.filter_dims = filter_dims;
+    job.filter = filter_data;
+    job.bias_dims = bias_dims;
+    job.bias = bias_data;
+    job.output_dims = output_dims;
+    job.output = output_data;
+    return nnpar_conv_run(&job, ctx, grain);
+}
+
+/* output channels, or batches, [begin, end) */
+static void nnpar_fc_tile(void *arg, unsigned long begin, unsigned long end)
+{
+    nnpar_fc_job_t *job = (nnpar_fc_job_t *)arg;
+    nmsis_nn_dims in = *job->input_dims, filter = *job->filter_dims, bias = *job->bias_dims;
+    nmsis_nn_dims out = *job->output_dims;
+    int32_t depth = job->filter_dims->n, n = (int32_t)(end - begin), i = (int32_t)begin;
+    nmsis_nn_context ctx;
+    riscv_nmsis_nn_status status;
+
+    nnpar_part(job->scratch, job->part, &ctx);
+    if (job->by_batch) {
+        in.n = out.n = n;
+        status = riscv_fully_connected_s8(&ctx, job->fc, job->quant, &in, job->input + i * depth, job->filter_dims,
+                                          job->filter, job->bias_dims, job->bias, &out,
+                                          job->output + i * job->output_dims->c);
+    } else {
+        // the filter is output channels of depth weights, a tile is a block of its rows
+        filter.c = bias.c = out.c = n;
+        status = riscv_fully_connected_s8(&ctx, job->fc, job->quant, &in, job->input, &filter,
+                                          job->filter + i * depth, &bias,
+                                          (job->bias != NULL) ? (job->bias + i) : NULL, &out, job->output + i);
+    }
+    if (status != RISCV_NMSIS_NN_SUCCESS) {
+        job->status = status;
+    }
+}
+
+int32_t nnpar_fully_connected_s8_get_buffer_size(const nmsis_nn_dims *filter_dims)
+{
+    return SMPWORK_MAX_HARTS * NNPAR_ROUND(riscv_fully_connected_s8_get_buffer_size(filter_dims));
+}
+
+riscv_nmsis_nn_status nnpar_fully_connected_s8(const nmsis_nn_context *ctx, const nmsis_nn_fc_params *fc_params,
+                                               const nmsis_nn_per_tensor_quant_params *quant_params,
+                                               const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                               const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                               const nmsis_nn_dims *bias_dims, const int32_t *bias_data,
+                                               const nmsis_nn_dims *output_dims, int8_t *output_data, uint32_t grain)
+{
+    nnpar_fc_job_t job;
+    int32_t count;
+
+    // channels of one batch are contiguous in output, while a channel of all batches is not
+    job.by_batch = (input_dims->n > 1);
+    count = job.by_batch ? input_dims->n : output_dims->c;
+    grain = (grain != 0) ? grain : (job.by_batch ? 1U : NNPAR_FC_GRAIN);
+    if (count <= (int32_t)grain) {
+        return riscv_fully_connected_s8(ctx, fc_params, quant_params, input_dims, input_data, filter_dims,
+                                        filter_data, bias_dims, bias_data, output_dims, output_data);
+    }
+    job.part = nnpar_split(ctx, riscv_fully_connected_s8_get_buffer_size(filter_dims));
+    if (job.part < 0) {
+        return RISCV_NMSIS_NN_ARG_ERROR;
+    }
+    job.fc = fc_params;
+    job.quant = quant_params;
+    job.input_dims = input_dims;
+    job.input = input_data;
+    job.filter_dims = filter_dims;
+    job.filter = filter_data;
+    job.bias_dims = bias_dims;
+    job.bias = bias_data;
+    job.output_dims = output_dims;
+    job.output = output_data;
+    job.scratch = (int8_t *)((ctx != NULL) ? ctx->buf : NULL);
+    job.status = RISCV_NMSIS_NN_SUCCESS;
+    nnpar_runner(0, (unsigned long)count, grain, nnpar_fc_tile, &job);
+    return job.status;
+}
@@ -0,0 +1,91 @@
+#ifndef _NNPAR_API_H_
+#define _NNPAR_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "riscv_nnfunctions.h"
+#include "smpwork_api.h"
+
+/*
+ * Parallel layer over NMSIS-NN s8 kernels for multi-hart parts.
+ *
+ * - Tiles: convolution and depthwise convolution are split by output rows, each tile is run
+ *   by the serial wrapper kernel on a slice of input rows with its top padding set so it
+ *   gives the same rows as the whole layer, fully connected is split by output channels,
+ *   or by batches when there are more than one, results are bit exact to the serial kernels
+ * - Scratch: ctx->buf is split in SMPWORK_MAX_HARTS equal parts, the tiles of hart index h
+ *   use part h as their nmsis_nn_context, nnpar_*_get_buffer_size() gives the whole size
+ * - Runner: tiles are run by smpwork_parallel_for() by default, nnpar_set_runner() hands
+ *   them to an RTOS instead, a runner must run at most one tile at a time on each hart and
+ *   return after all the tiles are done, which is the barrier between layers
+ *
+ * Layers smaller than one tile call the serial kernel directly with the whole ctx,
+ * the other harts run smpwork_worker() in smp_main, and share the memory of tensors.
+ */
+
+/* output rows of one tile of convolution */
+#ifndef NNPAR_CONV_GRAIN
+#define NNPAR_CONV_GRAIN            1
+#endif
+
+/* output channels of one tile of fully connected */
+#ifndef NNPAR_FC_GRAIN
+#define NNPAR_FC_GRAIN              16
+#endif
+
+/* runs fn on range [begin, end) in tiles of at most grain, returns when all are done */
+typedef void (*nnpar_runner_t)(unsigned long begin, unsigned long end, unsigned long grain, smpwork_fn_t fn, void *arg);
+
+/* Use runner to run tiles, NULL restores smpwork_parallel_for() */
+void nnpar_set_runner(nnpar_runner_t runner);
+
+/* Bytes of ctx for nnpar_convolve_wrapper_s8() with tiles of grain rows, 0 selects NNPAR_CONV_GRAIN */
+int32_t nnpar_convolve_wrapper_s8_get_buffer_size(const nmsis_nn_conv_params *conv_params,
+                                                  const nmsis_nn_dims *input_dims, const nmsis_nn_dims *filter_dims,
+                                                  const nmsis_nn_dims *output_dims, uint32_t grain);
+
+/* Same as riscv_convolve_wrapper_s8(), tiles of grain rows of output */
+riscv_nmsis_nn_status nnpar_convolve_wrapper_s8(const nmsis_nn_context *ctx, const nmsis_nn_conv_params *conv_params,
+                                                const nmsis_nn_per_channel_quant_params *quant_params,
+                                                const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                                const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                                const nmsis_nn_dims *bias_dims, const int32_t *bias_data,
+                                                const nmsis_nn_dims *output_dims, int8_t *output_data, uint32_t grain);
+
+/* Bytes of ctx for nnpar_depthwise_conv_wrapper_s8() with tiles of grain rows, 0 selects NNPAR_CONV_GRAIN */
+int32_t nnpar_depthwise_conv_wrapper_s8_get_buffer_size(const nmsis_nn_dw_conv_params *dw_conv_params,
+                                                        const nmsis_nn_dims *input_dims,
+                                                        const nmsis_nn_dims *filter_dims,
+                                                        const nmsis_nn_dims *output_dims, uint32_t grain);
+
+/* Same as riscv_depthwise_conv_wrapper_s8(), tiles of grain rows of output */
+riscv_nmsis_nn_status nnpar_depthwise_conv_wrapper_s8(const nmsis_nn_context *ctx,
+                                                      const nmsis_nn_dw_conv_params *dw_conv_params,
+                                                      const nmsis_nn_per_channel_quant_params *quant_params,
+                                                      const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                                      const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                                      const nmsis_nn_dims *bias_dims, const int32_t *bias_data,
+                                                      const nmsis_nn_dims *output_dims, int8_t *output_data,
+                                                      uint32_t grain);
+
+/* Bytes of ctx for nnpar_fully_connected_s8() */
+int32_t nnpar_fully_connected_s8_get_buffer_size(const nmsis_nn_dims *filter_dims);
+
+/*
+ * Same as riscv_fully_connected_s8(), tiles of grain output channels, 0 selects
+ * NNPAR_FC_GRAIN, or of grain batches, 0 selects 1, when input_dims->n is more than 1
+ */
+riscv_nmsis_nn_status nnpar_fully_connected_s8(const nmsis_nn_context *ctx, const nmsis_nn_fc_params *fc_params,
+                                               const nmsis_nn_per_tensor_quant_params *quant_params,
+                                               const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                               const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                               const nmsis_nn_dims *bias_dims, const int32_t *bias_data,
+                                               const nmsis_nn_dims *output_dims, int8_t *output_data, uint32_t grain);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _NNPAR_API_H_ */
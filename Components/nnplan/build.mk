@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# nnplan middleware plans the tensors of an NMSIS-NN layer list into one arena with reuse of
+# memory of dead tensors and one shared scratch buffer, add nmsis_nn to NMSIS_LIB too
+MIDDLEWARE_NNPLAN := $(NUCLEI_SDK_MIDDLEWARE)/nnplan
+
+C_SRCDIRS += $(MIDDLEWARE_NNPLAN)
+
+INCDIRS += $(MIDDLEWARE_NNPLAN)
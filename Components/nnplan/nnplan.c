@@ -0,0 +1,267 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "nnplan_api.h"
+
+#define NNPLAN_UNPLACED             UINT32_MAX
+#define NNPLAN_ROUND(x)             (((x) + NNPLAN_ALIGN - 1U) & ~(uint32_t)(NNPLAN_ALIGN - 1U))
+
+/* lifetimes of a and b have a layer in common */
+static int nnplan_overlap(const nnplan_tensor_t *a, const nnplan_tensor_t *b)
+{
+    return (a->first <= b->last) && (b->first <= a->last);
+}
+
+static riscv_nmsis_nn_status nnplan_lifetimes(nnplan_t *plan)
+{
+    nnplan_tensor_t *t;
+    const nnplan_layer_t *l;
+    uint32_t i, k;
+    int32_t in;
+
+    for (i = 0; i < plan->num_tensors; i++) {
+        // first stays -1 until a layer writes it, last until a layer reads it
+        plan->tensors[i].first = -1;
+        plan->tensors[i].last = -1;
+        plan->tensors[i].offset = NNPLAN_UNPLACED;
+    }
+    for (i = 0; i < plan->num_layers; i++) {
+        l = &plan->layers[i];
+        for (k = 0; k < NNPLAN_MAX_INPUTS; k++) {
+            in = l->in[k];
+            if (in == NNPLAN_NONE) {
+                continue;
+            }
+            if ((in < 0) || ((uint32_t)in >= plan->num_tensors) || (in == l->out)) {
+                return RISCV_NMSIS_NN_ARG_ERROR;
+            }
+            t = &plan->tensors[in];
+            // a graph input is read before anything is written, so it is live from layer 0,
+            // a fetched one from the layer before, which runs while it is copied
+            if ((t->first < 0) && (t->last < 0)) {
+                t->first = ((t->flags & NNPLAN_TENSOR_FETCH) && (i > 0)) ? (int32_t)(i - 1U) : 0;
+            }
+            t->last = (int32_t)i;
+        }
+        if ((l->out < 0) || ((uint32_t)l->out >= plan->num_tensors) || (l->scratch < 0)) {
+            return RISCV_NMSIS_NN_ARG_ERROR;
+        }
+        t = &plan->tensors[l->out];
+        if ((t->first >= 0) || (t->last >= 0) || (t->flags & NNPLAN_TENSOR_FETCH)) {
+            // written twice, or read by an earlier layer
+            return RISCV_NMSIS_NN_ARG_ERROR;
+        }
+        t->first = (int32_t)i;
+    }
+    for (i = 0; i < plan->num_tensors; i++) {
+        t = &plan->tensors[i];
+        if (t->first < 0) {
+            t->first = 0;
+        }
+        if ((t->last < t->first) || (t->flags & NNPLAN_TENSOR_KEEP)) {
+            t->last = (plan->num_layers > 0) ? (int32_t)(plan->num_layers - 1U) : 0;
+        }
+    }
+    return RISCV_NMSIS_NN_SUCCESS;
+}
+
+/* layer l reads tensor in */
+static int nnplan_reads(const nnplan_layer_t *l, int32_t in)
+{
+    uint32_t k;
+
+    for (k = 0; k < NNPLAN_MAX_INPUTS; k++) {
+        if (l->in[k] == in) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* input k of layer j is a fetched tensor first read by j, and not an earlier input of j */
+static int nnplan_first_fetch(const nnplan_t *plan, uint32_t j, uint32_t k)
+{
+    const nnplan_layer_t *l = &plan->layers[j];
+    const nnplan_tensor_t *t;
+    uint32_t p;
+
+    if ((l->in[k] == NNPLAN_NONE) || !(plan->tensors[l->in[k]].flags & NNPLAN_TENSOR_FETCH)) {
+        return 0;
+    }
+    for (p = 0; p < k; p++) {
+        if (l->in[p] == l->in[k]) {
+            return 0;
+        }
+    }
+    t = &plan->tensors[l->in[k]];
+    // first reader j > 0 set first to j - 1, a tensor read by layer 0 and 1 has first 0 too
+    return (j == 0) || ((t->first == (int32_t)(j - 1U)) && !nnplan_reads(&plan->layers[j - 1U], l->in[k]));
+}
+
+/* lowest offset of t free of the placed tensors live together with it */
+static uint32_t nnplan_fit(const nnplan_t *plan, const nnplan_tensor_t *t)
+{
+    const nnplan_tensor_t *p;
+    uint32_t off = 0, i;
+    int moved;
+
+    // off only grows to the end of a conflicting tensor, so this ends after at most one
+    // round per placed tensor
+    do {
+        moved = 0;
+        for (i = 0; i < plan->num_tensors; i++) {
+            p = &plan->tensors[i];
+            if ((p == t) || (p->offset == NNPLAN_UNPLACED) || (p->size == 0) || !nnplan_overlap(p, t)) {
+                continue;
+            }
+            if ((off < p->offset + p->size) && (p->offset < off + t->size)) {
+                off = NNPLAN_ROUND(p->offset + p->size);
+                moved = 1;
+            }
+        }
+    } while (moved);
+    return off;
+}
+
+riscv_nmsis_nn_status nnplan_init(nnplan_t *plan, nnplan_tensor_t *tensors, uint32_t num_tensors,
+                                  const nnplan_layer_t *layers, uint32_t num_layers)
+{
+    nnplan_tensor_t *t, *big;
+    riscv_nmsis_nn_status status;
+    uint32_t i, n, end;
+
+    plan->tensors = tensors;
+    plan->num_tensors = num_tensors;
+    plan->layers = layers;
+    plan->num_layers = num_layers;
+    plan->tensor_size = 0;
+    plan->scratch_size = 0;
+    plan->arena_size = 0;
+    plan->naive_size = 0;
+    plan->fetch_size = 0;
+    plan->arena = NULL;
+    plan->fetch = NULL;
+    status = nnplan_lifetimes(plan);
+    if (status != RISCV_NMSIS_NN_SUCCESS) {
+        return status;
+    }
+    // largest first, ties by earliest lifetime, the usual greedy by size order, large
+    // tensors placed late would otherwise land above the gaps left between small ones
+    for (n = 0; n < num_tensors; n++) {
+        big = NULL;
+        for (i = 0; i < num_tensors; i++) {
+            t = &tensors[i];
+            if ((t->offset == NNPLAN_UNPLACED) &&
+                ((big == NULL) || (t->size > big->size) || ((t->size == big->size) && (t->first < big->first)))) {
+                big = t;
+            }
+        }
+        big->offset = (big->size != 0) ? nnplan_fit(plan, big) : 0;
+        end = NNPLAN_ROUND(big->offset + big->size);
+        plan->tensor_size = (end > plan->tensor_size) ? end : plan->tensor_size;
+        plan->naive_size += NNPLAN_ROUND(big->size);
+    }
+    for (i = 0; i < num_layers; i++) {
+        if ((uint32_t)layers[i].scratch > plan->scratch_size) {
+            plan->scratch_size = (uint32_t)layers[i].scratch;
+        }
+        for (n = 0; n < NNPLAN_MAX_INPUTS; n++) {
+            if (nnplan_first_fetch(plan, i, n)) {
+                plan->fetch_size += tensors[layers[i].in[n]].size;
+            }
+        }
+    }
+    plan->arena_size = plan->tensor_size + NNPLAN_ROUND(plan->scratch_size);
+    plan->naive_size += NNPLAN_ROUND(plan->scratch_size);
+    return RISCV_NMSIS_NN_SUCCESS;
+}
+
+riscv_nmsis_nn_status nnplan_bind(nnplan_t *plan, void *arena, uint32_t size)
+{
+    if ((size < plan->arena_size) || (((uintptr_t)arena & (NNPLAN_ALIGN - 1U)) != 0)) {
+        return RISCV_NMSIS_NN_ARG_ERROR;
+    }
+    plan->arena = (uint8_t *)arena;
+    return RISCV_NMSIS_NN_SUCCESS;
+}
+
+void nnplan_set_fetch(nnplan_t *plan, const nnplan_fetch_t *fetch)
+{
+    plan->fetch = fetch;
+}
+
+int8_t *nnplan_tensor(const nnplan_t *plan, int32_t index)
+{
+    if ((plan->arena == NULL) || (index < 0) || ((uint32_t)index >= plan->num_tensors)) {
+        return NULL;
+    }
+    return (int8_t *)(plan->arena + plan->tensors[index].offset);
+}
+
+/* start copies of the tensors first read by layer j */
+static int32_t nnplan_fetch_layer(const nnplan_t *plan, uint32_t j)
+{
+    const nnplan_tensor_t *t;
+    uint32_t k;
+    int32_t ret = 0;
+
+    for (k = 0; (k < NNPLAN_MAX_INPUTS) && (ret == 0); k++) {
+        if (!nnplan_first_fetch(plan, j, k)) {
+            continue;
+        }
+        t = &plan->tensors[plan->layers[j].in[k]];
+        if (plan->fetch != NULL) {
+            ret = plan->fetch->start(plan->arena + t->offset, t->src, t->size, plan->fetch->arg);
+        } else {
+            memcpy(plan->arena + t->offset, (const void *)t->src, t->size);
+        }
+    }
+    return ret;
+}
+
+/* wait for all copies started */
+static int32_t nnplan_fetch_wait(const nnplan_t *plan)
+{
+    return (plan->fetch != NULL) ? plan->fetch->wait(plan->fetch->arg) : 0;
+}
+
+riscv_nmsis_nn_status nnplan_run(const nnplan_t *plan)
+{
+    const int8_t *in[NNPLAN_MAX_INPUTS];
+    const nnplan_layer_t *l;
+    nmsis_nn_context ctx;
+    riscv_nmsis_nn_status status;
+    uint32_t i, k;
+    int32_t fetched;
+
+    if (plan->arena == NULL) {
+        return RISCV_NMSIS_NN_ARG_ERROR;
+    }
+    ctx.buf = (plan->scratch_size != 0) ? (void *)(plan->arena + plan->tensor_size) : NULL;
+    ctx.size = (int32_t)plan->scratch_size;
+    if (plan->num_layers > 0) {
+        fetched = nnplan_fetch_layer(plan, 0);
+        if ((nnplan_fetch_wait(plan) != 0) || (fetched != 0)) {
+            return RISCV_NMSIS_NN_ARG_ERROR;
+        }
+    }
+    for (i = 0; i < plan->num_layers; i++) {
+        l = &plan->layers[i];
+        for (k = 0; k < NNPLAN_MAX_INPUTS; k++) {
+            in[k] = (l->in[k] != NNPLAN_NONE) ? nnplan_tensor(plan, l->in[k]) : NULL;
+        }
+        // the tensors of the next layer are copied while this one runs
+        fetched = (i + 1U < plan->num_layers) ? nnplan_fetch_layer(plan, i + 1U) : 0;
+        status = l->fn(l, &ctx, in, nnplan_tensor(plan, l->out));
+        if (nnplan_fetch_wait(plan) != 0) {
+            fetched = -1;
+        }
+        if (status != RISCV_NMSIS_NN_SUCCESS) {
+            return status;
+        }
+        if (fetched != 0) {
+            return RISCV_NMSIS_NN_ARG_ERROR;
+        }
+    }
+    return RISCV_NMSIS_NN_SUCCESS;
+}
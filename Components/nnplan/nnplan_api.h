@@ -0,0 +1,140 @@
+#ifndef _NNPLAN_API_H_
+#define _NNPLAN_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "riscv_nn_types.h"
+
+/*
+ * Static memory planner and runner of NMSIS-NN graphs.
+ *
+ * - Graph: a list of layers in order of execution, each one reads up to NNPLAN_MAX_INPUTS
+ *   tensors and writes one, its fn calls the NMSIS-NN kernel with the layer params, weights
+ *   and biases stay in the params and are not tensors of the plan
+ * - Lifetimes: a tensor lives from the layer which writes it to the last layer which reads
+ *   it, graph inputs, which no layer writes, live from the first layer, graph outputs, which
+ *   no layer reads, and NNPLAN_TENSOR_KEEP tensors live until the last layer
+ * - Arena: tensors are placed largest first at the lowest offset free over their lifetime,
+ *   so tensors which are never live together share memory, the input and output of a layer
+ *   never share memory since NMSIS-NN kernels do not work in place
+ * - Scratch: one nmsis_nn_context buffer after the tensors, of the largest scratch of all
+ *   layers, as given by the *_get_buffer_size() query of their kernels
+ * - Fetch: NNPLAN_TENSOR_FETCH tensors, eg. weights in external flash, are inputs copied
+ *   from their src into the arena by the nnplan_fetch_t of the plan, a layer ahead, while the
+ *   layer before their first reader runs, so they live from that layer on, and the fetched
+ *   tensors of two layers in a row never share memory while the ones of layers further apart
+ *   do, the planner makes the ping-pong buffers of the largest two consecutive layers
+ *
+ * nnplan_init() plans without memory, so arena_size can size a static buffer, nnplan_bind()
+ * gives the arena, inputs are written to nnplan_tensor() before nnplan_run() and outputs
+ * are read from it after.
+ */
+
+/* alignment of tensors and scratch in arena, for vector loads of NMSIS-NN */
+#ifndef NNPLAN_ALIGN
+#define NNPLAN_ALIGN                16
+#endif
+
+/* tensors read by one layer */
+#ifndef NNPLAN_MAX_INPUTS
+#define NNPLAN_MAX_INPUTS           2
+#endif
+
+/* unused input of layer */
+#define NNPLAN_NONE                 (-1)
+
+/* tensor stays live until the last layer, eg. an intermediate result read after nnplan_run() */
+#define NNPLAN_TENSOR_KEEP          0x1U
+/* tensor is copied from src before it is read, no layer writes it */
+#define NNPLAN_TENSOR_FETCH         0x2U
+
+typedef struct nnplan_tensor {
+    uint32_t size;                  /* bytes of tensor */
+    uint32_t flags;                 /* NNPLAN_TENSOR_* */
+    uintptr_t src;                  /* source of NNPLAN_TENSOR_FETCH, address for fetch of plan */
+    /* set by nnplan_init() */
+    uint32_t offset;                /* bytes from start of arena */
+    int32_t first;                  /* first layer of lifetime */
+    int32_t last;                   /* last layer of lifetime */
+} nnplan_tensor_t;
+
+struct nnplan_layer;
+
+/*
+ * Run one layer, in are the input tensors of layer, NULL for NNPLAN_NONE, out is its output,
+ * ctx is the shared scratch, return the status of the kernel
+ */
+typedef riscv_nmsis_nn_status (*nnplan_fn_t)(const struct nnplan_layer *layer, const nmsis_nn_context *ctx,
+                                             const int8_t *const *in, int8_t *out);
+
+typedef struct nnplan_layer {
+    nnplan_fn_t fn;                 /* runs the kernel of layer */
+    const void *params;             /* kernel params, dims, weights and biases, for fn */
+    int32_t in[NNPLAN_MAX_INPUTS];  /* tensors read by layer, NNPLAN_NONE if unused */
+    int32_t out;                    /* tensor written by layer */
+    int32_t scratch;                /* bytes of scratch from *_get_buffer_size() of kernel */
+} nnplan_layer_t;
+
+/*
+ * Copy engine of NNPLAN_TENSOR_FETCH tensors, start() queues a copy of size bytes of src to
+ * dst and may return before it is done, wait() returns when all queued copies are done, both
+ * return 0 on success, see nnfetch middleware for DMA ones
+ */
+typedef struct nnplan_fetch {
+    int32_t (*start)(void *dst, uintptr_t src, uint32_t size, void *arg);
+    int32_t (*wait)(void *arg);
+    void *arg;
+} nnplan_fetch_t;
+
+typedef struct nnplan {
+    nnplan_tensor_t *tensors;
+    uint32_t num_tensors;
+    const nnplan_layer_t *layers;
+    uint32_t num_layers;
+    /* set by nnplan_init() */
+    uint32_t tensor_size;           /* bytes of tensors, the peak of live tensors with reuse */
+    uint32_t scratch_size;          /* bytes of shared scratch */
+    uint32_t arena_size;            /* bytes of arena, tensors and scratch */
+    uint32_t naive_size;            /* bytes of arena without reuse, for comparison */
+    uint32_t fetch_size;            /* bytes of NNPLAN_TENSOR_FETCH tensors copied by each nnplan_run() */
+    /* private */
+    uint8_t *arena;
+    const nnplan_fetch_t *fetch;
+} nnplan_t;
+
+/*
+ * Compute lifetimes and offsets of num_tensors tensors read and written by num_layers layers,
+ * return RISCV_NMSIS_NN_ARG_ERROR if a layer refers to a missing tensor, a tensor is written
+ * twice, read before it is written, or is NNPLAN_TENSOR_FETCH and written
+ */
+riscv_nmsis_nn_status nnplan_init(nnplan_t *plan, nnplan_tensor_t *tensors, uint32_t num_tensors,
+                                  const nnplan_layer_t *layers, uint32_t num_layers);
+
+/*
+ * Use size bytes of arena for plan, NNPLAN_ALIGN aligned, return RISCV_NMSIS_NN_ARG_ERROR if
+ * it is smaller than arena_size or not aligned
+ */
+riscv_nmsis_nn_status nnplan_bind(nnplan_t *plan, void *arena, uint32_t size);
+
+/*
+ * Copy NNPLAN_TENSOR_FETCH tensors with fetch, which must stay valid, NULL copies them by
+ * memcpy() from src as an address before their first reader, without overlap, the default
+ */
+void nnplan_set_fetch(nnplan_t *plan, const nnplan_fetch_t *fetch);
+
+/* Return memory of tensor index in the bound arena, NULL if there is none */
+int8_t *nnplan_tensor(const nnplan_t *plan, int32_t index);
+
+/*
+ * Run all layers in order, stop at the first one which fails and return its status, or
+ * RISCV_NMSIS_NN_ARG_ERROR if a fetch fails
+ */
+riscv_nmsis_nn_status nnplan_run(const nnplan_t *plan);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _NNPLAN_API_H_ */
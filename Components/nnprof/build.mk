@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# nnprof middleware records cycles, hpm events, MACs and bytes of each NMSIS-NN layer,
+# add nmsis_nn to NMSIS_LIB too, and -DNNPROF_ENABLE to profile the riscv_* kernel calls
+MIDDLEWARE_NNPROF := $(NUCLEI_SDK_MIDDLEWARE)/nnprof
+
+C_SRCDIRS += $(MIDDLEWARE_NNPROF)
+
+INCDIRS += $(MIDDLEWARE_NNPROF)
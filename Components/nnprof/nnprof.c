@@ -0,0 +1,361 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "nuclei_sdk_soc.h"
+#include "riscv_nnfunctions.h"
+/* this file calls the real kernels */
+#define NNPROF_IMPL
+#include "nnprof_api.h"
+
+static nnprof_layer_t nnprof_layers[NNPROF_MAX_LAYERS];
+static uint32_t nnprof_next;            /* layer of next call in this frame */
+static uint32_t nnprof_used;            /* layers recorded */
+static uint32_t nnprof_frames;
+static uint32_t nnprof_dropped;
+
+static uint64_t nnprof_event(void)
+{
+#if NNPROF_HPM_IDX != 0
+    return __get_hpm_counter(NNPROF_HPM_IDX);
+#else
+    return 0;
+#endif
+}
+
+void nnprof_reset(void)
+{
+    for (uint32_t i = 0; i < NNPROF_MAX_LAYERS; i++) {
+        nnprof_layers[i].name = NULL;
+        nnprof_layers[i].calls = 0;
+        nnprof_layers[i].cycles = 0;
+        nnprof_layers[i].events = 0;
+        nnprof_layers[i].macs = 0;
+        nnprof_layers[i].bytes = 0;
+    }
+    nnprof_next = 0;
+    nnprof_used = 0;
+    nnprof_frames = 0;
+    nnprof_dropped = 0;
+}
+
+void nnprof_init(void)
+{
+    __enable_all_counter();
+#if NNPROF_HPM_IDX != 0
+    __set_hpm_event(NNPROF_HPM_IDX, NNPROF_HPM_EVENT);
+    __set_hpm_counter(NNPROF_HPM_IDX, 0);
+#endif
+    nnprof_reset();
+}
+
+void nnprof_frame(void)
+{
+    nnprof_next = 0;
+    nnprof_frames++;
+}
+
+void nnprof_begin(nnprof_mark_t *mark)
+{
+    mark->event = nnprof_event();
+    mark->cycle = __get_rv_cycle();
+}
+
+void nnprof_end(const nnprof_mark_t *mark, const char *name, uint64_t macs, uint64_t bytes)
+{
+    uint64_t cycle = __get_rv_cycle();
+    /* hpm counter may only return low xlen bits */
+    uint64_t event = (unsigned long)(nnprof_event() - mark->event);
+    nnprof_layer_t *layer;
+
+    if (nnprof_next >= NNPROF_MAX_LAYERS) {
+        nnprof_dropped++;
+        return;
+    }
+    layer = &nnprof_layers[nnprof_next++];
+    if (layer->name == NULL) {
+        layer->name = name;
+    }
+    layer->calls++;
+    layer->cycles += cycle - mark->cycle;
+    layer->events += event;
+    layer->macs += macs;
+    layer->bytes += bytes;
+    if (nnprof_next > nnprof_used) {
+        nnprof_used = nnprof_next;
+    }
+}
+
+uint32_t nnprof_num_layers(void)
+{
+    return nnprof_used;
+}
+
+const nnprof_layer_t *nnprof_layer(uint32_t idx)
+{
+    return (idx < nnprof_used) ? &nnprof_layers[idx] : NULL;
+}
+
+void nnprof_dump(void)
+{
+    uint64_t total = 0, calls, mpc;
+    const nnprof_layer_t *layer;
+
+    for (uint32_t i = 0; i < nnprof_used; i++) {
+        total += nnprof_layers[i].cycles;
+    }
+    printf("NNPROF: %lu layers, %lu frames, %lu dropped, %lu cycles\n", (unsigned long)nnprof_used,
+           (unsigned long)nnprof_frames, (unsigned long)nnprof_dropped, (unsigned long)total);
+    printf("NNPROF: idx, kernel, calls, cycles/call, MACs/call, MACs/cycle, hpm/call, bytes/call, share%%\n");
+    for (uint32_t i = 0; i < nnprof_used; i++) {
+        layer = &nnprof_layers[i];
+        calls = layer->calls ? layer->calls : 1;
+        /* MACs per cycle in 1/100 */
+        mpc = layer->cycles ? (layer->macs * 100) / layer->cycles : 0;
+        printf("NNPROF: %lu, %s, %lu, %lu, %lu, %lu.%02lu, %lu, %lu, %lu\n", (unsigned long)i, layer->name,
+               (unsigned long)layer->calls, (unsigned long)(layer->cycles / calls),
+               (unsigned long)(layer->macs / calls), (unsigned long)(mpc / 100), (unsigned long)(mpc % 100),
+               (unsigned long)(layer->events / calls), (unsigned long)(layer->bytes / calls),
+               (unsigned long)(total ? (layer->cycles * 100) / total : 0));
+    }
+}
+
+/* values of a nhwc tensor */
+static uint64_t nnprof_size(const nmsis_nn_dims *dims)
+{
+    return (uint64_t)dims->n * dims->h * dims->w * dims->c;
+}
+
+/* MACs and bytes of a convolution, with in and out bytes of one activation value */
+static void nnprof_conv_work(const nmsis_nn_dims *input_dims, const nmsis_nn_dims *filter_dims,
+                             const nmsis_nn_dims *output_dims, uint32_t in, uint32_t bias, uint32_t out,
+                             uint64_t *macs, uint64_t *bytes)
+{
+    uint64_t weights = (uint64_t)output_dims->c * filter_dims->h * filter_dims->w * input_dims->c;
+
+    *macs = (uint64_t)output_dims->n * output_dims->h * output_dims->w * weights;
+    *bytes = nnprof_size(input_dims) * in + weights + (uint64_t)output_dims->c * bias + nnprof_size(output_dims) * out;
+}
+
+static void nnprof_dw_work(const nmsis_nn_dims *input_dims, const nmsis_nn_dims *filter_dims,
+                           const nmsis_nn_dims *output_dims, uint32_t in, uint32_t bias, uint32_t out,
+                           uint64_t *macs, uint64_t *bytes)
+{
+    uint64_t weights = (uint64_t)output_dims->c * filter_dims->h * filter_dims->w;
+
+    *macs = (uint64_t)output_dims->n * output_dims->h * output_dims->w * weights;
+    *bytes = nnprof_size(input_dims) * in + weights + (uint64_t)output_dims->c * bias + nnprof_size(output_dims) * out;
+}
+
+/* filter_dims->n is the accumulation depth, output_dims->c the output channels */
+static void nnprof_fc_work(const nmsis_nn_dims *input_dims, const nmsis_nn_dims *filter_dims,
+                           const nmsis_nn_dims *output_dims, uint32_t in, uint32_t bias, uint32_t out,
+                           uint64_t *macs, uint64_t *bytes)
+{
+    uint64_t weights = (uint64_t)filter_dims->n * output_dims->c;
+
+    *macs = (uint64_t)input_dims->n * weights;
+    *bytes = (uint64_t)input_dims->n * filter_dims->n * in + weights + (uint64_t)output_dims->c * bias +
+             (uint64_t)input_dims->n * output_dims->c * out;
+}
+
+static void nnprof_pool_work(const nmsis_nn_dims *input_dims, const nmsis_nn_dims *filter_dims,
+                             const nmsis_nn_dims *output_dims, uint64_t *macs, uint64_t *bytes)
+{
+    *macs = nnprof_size(output_dims) * filter_dims->h * filter_dims->w;
+    *bytes = nnprof_size(input_dims) + nnprof_size(output_dims);
+}
+
+riscv_nmsis_nn_status nnprof_convolve_wrapper_s8(const nmsis_nn_context *ctx, const nmsis_nn_conv_params *conv_params,
+                                                 const nmsis_nn_per_channel_quant_params *quant_params,
+                                                 const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                                 const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                                 const nmsis_nn_dims *bias_dims, const int32_t *bias_data,
+                                                 const nmsis_nn_dims *output_dims, int8_t *output_data)
+{
+    nnprof_mark_t mark;
+    uint64_t macs, bytes;
+    riscv_nmsis_nn_status ret;
+
+    nnprof_begin(&mark);
+    ret = riscv_convolve_wrapper_s8(ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data,
+                                    bias_dims, bias_data, output_dims, output_data);
+    nnprof_conv_work(input_dims, filter_dims, output_dims, 1, 4, 1, &macs, &bytes);
+    nnprof_end(&mark, "convolve_s8", macs, bytes);
+    return ret;
+}
+
+riscv_nmsis_nn_status nnprof_convolve_wrapper_s16(const nmsis_nn_context *ctx, const nmsis_nn_conv_params *conv_params,
+                                                  const nmsis_nn_per_channel_quant_params *quant_params,
+                                                  const nmsis_nn_dims *input_dims, const int16_t *input_data,
+                                                  const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                                  const nmsis_nn_dims *bias_dims, const int64_t *bias_data,
+                                                  const nmsis_nn_dims *output_dims, int16_t *output_data)
+{
+    nnprof_mark_t mark;
+    uint64_t macs, bytes;
+    riscv_nmsis_nn_status ret;
+
+    nnprof_begin(&mark);
+    ret = riscv_convolve_wrapper_s16(ctx, conv_params, quant_params, input_dims, input_data, filter_dims,
+                                     filter_data, bias_dims, bias_data, output_dims, output_data);
+    nnprof_conv_work(input_dims, filter_dims, output_dims, 2, 8, 2, &macs, &bytes);
+    nnprof_end(&mark, "convolve_s16", macs, bytes);
+    return ret;
+}
+
+riscv_nmsis_nn_status nnprof_depthwise_conv_wrapper_s8(const nmsis_nn_context *ctx,
+                                                       const nmsis_nn_dw_conv_params *dw_conv_params,
+                                                       const nmsis_nn_per_channel_quant_params *quant_params,
+                                                       const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                                       const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                                       const nmsis_nn_dims *bias_dims, const int32_t *bias_data,
+                                                       const nmsis_nn_dims *output_dims, int8_t *output_data)
+{
+    nnprof_mark_t mark;
+    uint64_t macs, bytes;
+    riscv_nmsis_nn_status ret;
+
+    nnprof_begin(&mark);
+    ret = riscv_depthwise_conv_wrapper_s8(ctx, dw_conv_params, quant_params, input_dims, input_data, filter_dims,
+                                          filter_data, bias_dims, bias_data, output_dims, output_data);
+    nnprof_dw_work(input_dims, filter_dims, output_dims, 1, 4, 1, &macs, &bytes);
+    nnprof_end(&mark, "depthwise_s8", macs, bytes);
+    return ret;
+}
+
+riscv_nmsis_nn_status nnprof_depthwise_conv_wrapper_s16(const nmsis_nn_context *ctx,
+                                                        const nmsis_nn_dw_conv_params *dw_conv_params,
+                                                        const nmsis_nn_per_channel_quant_params *quant_params,
+                                                        const nmsis_nn_dims *input_dims, const int16_t *input_data,
+                                                        const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                                        const nmsis_nn_dims *bias_dims, const int64_t *bias_data,
+                                                        const nmsis_nn_dims *output_dims, int16_t *output_data)
+{
+    nnprof_mark_t mark;
+    uint64_t macs, bytes;
+    riscv_nmsis_nn_status ret;
+
+    nnprof_begin(&mark);
+    ret = riscv_depthwise_conv_wrapper_s16(ctx, dw_conv_params, quant_params, input_dims, input_data, filter_dims,
+                                           filter_data, bias_dims, bias_data, output_dims, output_data);
+    nnprof_dw_work(input_dims, filter_dims, output_dims, 2, 8, 2, &macs, &bytes);
+    nnprof_end(&mark, "depthwise_s16", macs, bytes);
+    return ret;
+}
+
+riscv_nmsis_nn_status nnprof_fully_connected_s8(const nmsis_nn_context *ctx, const nmsis_nn_fc_params *fc_params,
+                                                const nmsis_nn_per_tensor_quant_params *quant_params,
+                                                const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                                const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                                const nmsis_nn_dims *bias_dims, const int32_t *bias_data,
+                                                const nmsis_nn_dims *output_dims, int8_t *output_data)
+{
+    nnprof_mark_t mark;
+    uint64_t macs, bytes;
+    riscv_nmsis_nn_status ret;
+
+    nnprof_begin(&mark);
+    ret = riscv_fully_connected_s8(ctx, fc_params, quant_params, input_dims, input_data, filter_dims, filter_data,
+                                   bias_dims, bias_data, output_dims, output_data);
+    nnprof_fc_work(input_dims, filter_dims, output_dims, 1, 4, 1, &macs, &bytes);
+    nnprof_end(&mark, "fully_connected_s8", macs, bytes);
+    return ret;
+}
+
+riscv_nmsis_nn_status nnprof_fully_connected_s16(const nmsis_nn_context *ctx, const nmsis_nn_fc_params *fc_params,
+                                                 const nmsis_nn_per_tensor_quant_params *quant_params,
+                                                 const nmsis_nn_dims *input_dims, const int16_t *input_data,
+                                                 const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                                 const nmsis_nn_dims *bias_dims, const int64_t *bias_data,
+                                                 const nmsis_nn_dims *output_dims, int16_t *output_data)
+{
+    nnprof_mark_t mark;
+    uint64_t macs, bytes;
+    riscv_nmsis_nn_status ret;
+
+    nnprof_begin(&mark);
+    ret = riscv_fully_connected_s16(ctx, fc_params, quant_params, input_dims, input_data, filter_dims, filter_data,
+                                    bias_dims, bias_data, output_dims, output_data);
+    nnprof_fc_work(input_dims, filter_dims, output_dims, 2, 8, 2, &macs, &bytes);
+    nnprof_end(&mark, "fully_connected_s16", macs, bytes);
+    return ret;
+}
+
+riscv_nmsis_nn_status nnprof_avgpool_s8(const nmsis_nn_context *ctx, const nmsis_nn_pool_params *pool_params,
+                                        const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                        const nmsis_nn_dims *filter_dims, const nmsis_nn_dims *output_dims,
+                                        int8_t *output_data)
+{
+    nnprof_mark_t mark;
+    uint64_t macs, bytes;
+    riscv_nmsis_nn_status ret;
+
+    nnprof_begin(&mark);
+    ret = riscv_avgpool_s8(ctx, pool_params, input_dims, input_data, filter_dims, output_dims, output_data);
+    nnprof_pool_work(input_dims, filter_dims, output_dims, &macs, &bytes);
+    nnprof_end(&mark, "avgpool_s8", macs, bytes);
+    return ret;
+}
+
+riscv_nmsis_nn_status nnprof_max_pool_s8(const nmsis_nn_context *ctx, const nmsis_nn_pool_params *pool_params,
+                                         const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                         const nmsis_nn_dims *filter_dims, const nmsis_nn_dims *output_dims,
+                                         int8_t *output_data)
+{
+    nnprof_mark_t mark;
+    uint64_t macs, bytes;
+    riscv_nmsis_nn_status ret;
+
+    nnprof_begin(&mark);
+    ret = riscv_max_pool_s8(ctx, pool_params, input_dims, input_data, filter_dims, output_dims, output_data);
+    nnprof_pool_work(input_dims, filter_dims, output_dims, &macs, &bytes);
+    nnprof_end(&mark, "max_pool_s8", macs, bytes);
+    return ret;
+}
+
+void nnprof_softmax_s8(const int8_t *input, const int32_t num_rows, const int32_t row_size, const int32_t mult,
+                       const int32_t shift, const int32_t diff_min, int8_t *output)
+{
+    nnprof_mark_t mark;
+    uint64_t size = (uint64_t)num_rows * row_size;
+
+    nnprof_begin(&mark);
+    riscv_softmax_s8(input, num_rows, row_size, mult, shift, diff_min, output);
+    nnprof_end(&mark, "softmax_s8", size, 2 * size);
+}
+
+riscv_nmsis_nn_status nnprof_elementwise_add_s8(const int8_t *input_1_vect, const int8_t *input_2_vect,
+                                                const int32_t input_1_offset, const int32_t input_1_mult,
+                                                const int32_t input_1_shift, const int32_t input_2_offset,
+                                                const int32_t input_2_mult, const int32_t input_2_shift,
+                                                const int32_t left_shift, int8_t *output, const int32_t out_offset,
+                                                const int32_t out_mult, const int32_t out_shift,
+                                                const int32_t out_activation_min, const int32_t out_activation_max,
+                                                const int32_t block_size)
+{
+    nnprof_mark_t mark;
+    riscv_nmsis_nn_status ret;
+
+    nnprof_begin(&mark);
+    ret = riscv_elementwise_add_s8(input_1_vect, input_2_vect, input_1_offset, input_1_mult, input_1_shift,
+                                   input_2_offset, input_2_mult, input_2_shift, left_shift, output, out_offset,
+                                   out_mult, out_shift, out_activation_min, out_activation_max, block_size);
+    nnprof_end(&mark, "elementwise_add_s8", 2 * (uint64_t)block_size, 3 * (uint64_t)block_size);
+    return ret;
+}
+
+riscv_nmsis_nn_status nnprof_elementwise_mul_s8(const int8_t *input_1_vect, const int8_t *input_2_vect,
+                                                const int32_t input_1_offset, const int32_t input_2_offset,
+                                                int8_t *output, const int32_t out_offset, const int32_t out_mult,
+                                                const int32_t out_shift, const int32_t out_activation_min,
+                                                const int32_t out_activation_max, const int32_t block_size)
+{
+    nnprof_mark_t mark;
+    riscv_nmsis_nn_status ret;
+
+    nnprof_begin(&mark);
+    ret = riscv_elementwise_mul_s8(input_1_vect, input_2_vect, input_1_offset, input_2_offset, output, out_offset,
+                                   out_mult, out_shift, out_activation_min, out_activation_max, block_size);
+    nnprof_end(&mark, "elementwise_mul_s8", 2 * (uint64_t)block_size, 3 * (uint64_t)block_size);
+    return ret;
+}
@@ -0,0 +1,172 @@
+#ifndef _NNPROF_API_H_
+#define _NNPROF_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "riscv_nnfunctions.h"
+
+/*
+ * Per layer profiler of NMSIS-NN kernels.
+ *
+ * - Layers: each profiled kernel call is one layer, numbered in call order from the last
+ *   nnprof_frame(), so calling nnprof_frame() after each inference gives one row per layer
+ *   of the model, accumulated over all the inferences
+ * - Counters: each call records mcycle, and the hpm counter NNPROF_HPM_IDX programmed with
+ *   NNPROF_HPM_EVENT, d-cache miss by default, NNPROF_HPM_IDX 0 records cycles only
+ * - Work: MACs and bytes of a call are computed from its nmsis_nn_dims, bytes is input,
+ *   weights, bias and output read or written once, the least traffic of the layer, pooling,
+ *   softmax and elementwise count one MAC per input value they read
+ * - Gate: with NNPROF_ENABLE defined, including this header after riscv_nnfunctions.h
+ *   renames the profiled riscv_* kernels to the nnprof_* wrappers of the same arguments,
+ *   without it the wrappers can be called directly, or not linked at all
+ *
+ * nnprof_dump() prints the table, nnprof_begin() and nnprof_end() profile other code such
+ * as nnfuse or nnpar layers as rows of the same table.
+ */
+
+/* max layers of one frame, calls after it are counted as dropped */
+#ifndef NNPROF_MAX_LAYERS
+#define NNPROF_MAX_LAYERS           64
+#endif
+
+/* hpm counter used by nnprof, must be a decimal number 3 - 31, or 0 for no hpm counter */
+#ifndef NNPROF_HPM_IDX
+#define NNPROF_HPM_IDX              7
+#endif
+
+/* hpm event of NNPROF_HPM_IDX, default d-cache miss in all modes */
+#ifndef NNPROF_HPM_EVENT
+#define NNPROF_HPM_EVENT            ((0x0FUL << 28) | (2UL << 4) | 1UL)
+#endif
+
+/* counted work and counters of one layer, sums of all its calls */
+typedef struct nnprof_layer {
+    const char *name;               /* kernel of first call */
+    uint32_t calls;
+    uint64_t cycles;
+    uint64_t events;                /* NNPROF_HPM_EVENT count */
+    uint64_t macs;
+    uint64_t bytes;
+} nnprof_layer_t;
+
+/* counters at start of a call */
+typedef struct nnprof_mark {
+    uint64_t cycle;
+    uint64_t event;
+} nnprof_mark_t;
+
+/* Program the hpm counter, enable counters and clear all layers */
+void nnprof_init(void);
+
+/* Clear all layers and frames */
+void nnprof_reset(void);
+
+/* End one inference, the next call is layer 0 again */
+void nnprof_frame(void);
+
+/* Read counters at start of a call */
+void nnprof_begin(nnprof_mark_t *mark);
+
+/* Add the counters since mark, macs and bytes to the next layer, named name */
+void nnprof_end(const nnprof_mark_t *mark, const char *name, uint64_t macs, uint64_t bytes);
+
+/* Number of layers recorded and layer idx of them, NULL if idx is out of range */
+uint32_t nnprof_num_layers(void);
+const nnprof_layer_t *nnprof_layer(uint32_t idx);
+
+/* Print per layer table of cycles, MACs per cycle, hpm events and bytes per call */
+void nnprof_dump(void);
+
+riscv_nmsis_nn_status nnprof_convolve_wrapper_s8(const nmsis_nn_context *ctx, const nmsis_nn_conv_params *conv_params,
+                                                 const nmsis_nn_per_channel_quant_params *quant_params,
+                                                 const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                                 const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                                 const nmsis_nn_dims *bias_dims, const int32_t *bias_data,
+                                                 const nmsis_nn_dims *output_dims, int8_t *output_data);
+
+riscv_nmsis_nn_status nnprof_convolve_wrapper_s16(const nmsis_nn_context *ctx, const nmsis_nn_conv_params *conv_params,
+                                                  const nmsis_nn_per_channel_quant_params *quant_params,
+                                                  const nmsis_nn_dims *input_dims, const int16_t *input_data,
+                                                  const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                                  const nmsis_nn_dims *bias_dims, const int64_t *bias_data,
+                                                  const nmsis_nn_dims *output_dims, int16_t *output_data);
+
+riscv_nmsis_nn_status nnprof_depthwise_conv_wrapper_s8(const nmsis_nn_context *ctx,
+                                                       const nmsis_nn_dw_conv_params *dw_conv_params,
+                                                       const nmsis_nn_per_channel_quant_params *quant_params,
+                                                       const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                                       const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                                       const nmsis_nn_dims *bias_dims, const int32_t *bias_data,
+                                                       const nmsis_nn_dims *output_dims, int8_t *output_data);
+
+riscv_nmsis_nn_status nnprof_depthwise_conv_wrapper_s16(const nmsis_nn_context *ctx,
+                                                        const nmsis_nn_dw_conv_params *dw_conv_params,
+                                                        const nmsis_nn_per_channel_quant_params *quant_params,
+                                                        const nmsis_nn_dims *input_dims, const int16_t *input_data,
+                                                        const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                                        const nmsis_nn_dims *bias_dims, const int64_t *bias_data,
+                                                        const nmsis_nn_dims *output_dims, int16_t *output_data);
+
+riscv_nmsis_nn_status nnprof_fully_connected_s8(const nmsis_nn_context *ctx, const nmsis_nn_fc_params *fc_params,
+                                                const nmsis_nn_per_tensor_quant_params *quant_params,
+                                                const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                                const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                                const nmsis_nn_dims *bias_dims, const int32_t *bias_data,
+                                                const nmsis_nn_dims *output_dims, int8_t *output_data);
+
+riscv_nmsis_nn_status nnprof_fully_connected_s16(const nmsis_nn_context *ctx, const nmsis_nn_fc_params *fc_params,
+                                                 const nmsis_nn_per_tensor_quant_params *quant_params,
+                                                 const nmsis_nn_dims *input_dims, const int16_t *input_data,
+                                                 const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                                                 const nmsis_nn_dims *bias_dims, const int64_t *bias_data,
+                                                 const nmsis_nn_dims *output_dims, int16_t *output_data);
+
+riscv_nmsis_nn_status nnprof_avgpool_s8(const nmsis_nn_context *ctx, const nmsis_nn_pool_params *pool_params,
+                                        const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                        const nmsis_nn_dims *filter_dims, const nmsis_nn_dims *output_dims,
+                                        int8_t *output_data);
+
+riscv_nmsis_nn_status nnprof_max_pool_s8(const nmsis_nn_context *ctx, const nmsis_nn_pool_params *pool_params,
+                                         const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                                         const nmsis_nn_dims *filter_dims, const nmsis_nn_dims *output_dims,
+                                         int8_t *output_data);
+
+void nnprof_softmax_s8(const int8_t *input, const int32_t num_rows, const int32_t row_size, const int32_t mult,
+                       const int32_t shift, const int32_t diff_min, int8_t *output);
+
+riscv_nmsis_nn_status nnprof_elementwise_add_s8(const int8_t *input_1_vect, const int8_t *input_2_vect,
+                                                const int32_t input_1_offset, const int32_t input_1_mult,
+                                                const int32_t input_1_shift, const int32_t input_2_offset,
+                                                const int32_t input_2_mult, const int32_t input_2_shift,
+                                                const int32_t left_shift, int8_t *output, const int32_t out_offset,
+                                                const int32_t out_mult, const int32_t out_shift,
+                                                const int32_t out_activation_min, const int32_t out_activation_max,
+                                                const int32_t block_size);
+
+riscv_nmsis_nn_status nnprof_elementwise_mul_s8(const int8_t *input_1_vect, const int8_t *input_2_vect,
+                                                const int32_t input_1_offset, const int32_t input_2_offset,
+                                                int8_t *output, const int32_t out_offset, const int32_t out_mult,
+                                                const int32_t out_shift, const int32_t out_activation_min,
+                                                const int32_t out_activation_max, const int32_t block_size);
+
+#if defined(NNPROF_ENABLE) && !defined(NNPROF_IMPL)
+#define riscv_convolve_wrapper_s8           nnprof_convolve_wrapper_s8
+#define riscv_convolve_wrapper_s16          nnprof_convolve_wrapper_s16
+#define riscv_depthwise_conv_wrapper_s8     nnprof_depthwise_conv_wrapper_s8
+#define riscv_depthwise_conv_wrapper_s16    nnprof_depthwise_conv_wrapper_s16
+#define riscv_fully_connected_s8            nnprof_fully_connected_s8
+#define riscv_fully_connected_s16           nnprof_fully_connected_s16
+#define riscv_avgpool_s8                    nnprof_avgpool_s8
+#define riscv_max_pool_s8                   nnprof_max_pool_s8
+#define riscv_softmax_s8                    nnprof_softmax_s8
+#define riscv_elementwise_add_s8            nnprof_elementwise_add_s8
+#define riscv_elementwise_mul_s8            nnprof_elementwise_mul_s8
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _NNPROF_API_H_ */
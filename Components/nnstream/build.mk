@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# nnstream middleware runs NMSIS-NN LSTM and SVDF one frame at a time with state kept
+# between calls, add nmsis_nn to NMSIS_LIB too
+MIDDLEWARE_NNSTREAM := $(NUCLEI_SDK_MIDDLEWARE)/nnstream
+
+C_SRCDIRS += $(MIDDLEWARE_NNSTREAM)
+
+INCDIRS += $(MIDDLEWARE_NNSTREAM)
@@ -0,0 +1,238 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "nnstream_api.h"
+
+/* parts of buffer start on this boundary */
+#define NNSTREAM_ALIGN              4
+#define NNSTREAM_ROUND(x)           (((x) + NNSTREAM_ALIGN - 1) & ~(int32_t)(NNSTREAM_ALIGN - 1))
+
+int32_t nnstream_lstm_get_buffer_size(const nmsis_nn_lstm_dims *dims)
+{
+    int32_t cells = dims->num_batches * dims->num_outputs;
+
+    // 4 gates and cell state of int16, output state of int8
+    return 5 * NNSTREAM_ROUND(cells * (int32_t)sizeof(int16_t)) + NNSTREAM_ROUND(cells);
+}
+
+riscv_nmsis_nn_status nnstream_lstm_init(nnstream_lstm_t *lstm, const nmsis_nn_lstm_dims *dims,
+                                         const nnstream_lstm_weights_t *weights, const nmsis_nn_lstm_params *params,
+                                         void *buf)
+{
+    int32_t cells = dims->num_batches * dims->num_outputs;
+    int32_t gate = NNSTREAM_ROUND(cells * (int32_t)sizeof(int16_t));
+    int8_t *p = (int8_t *)buf;
+
+    if ((buf == NULL) || (weights == NULL) || (params == NULL) || (cells <= 0) || (dims->num_inputs <= 0)) {
+        return RISCV_NMSIS_NN_ARG_ERROR;
+    }
+    lstm->num_batches = dims->num_batches;
+    lstm->num_inputs = dims->num_inputs;
+    lstm->num_outputs = dims->num_outputs;
+    lstm->weights = weights;
+    lstm->params = params;
+    lstm->scratch.input_gate = (int16_t *)p;
+    lstm->scratch.forget_gate = (int16_t *)(p + gate);
+    lstm->scratch.cell_gate = (int16_t *)(p + 2 * gate);
+    lstm->scratch.output_gate = (int16_t *)(p + 3 * gate);
+    lstm->cell_state = (int16_t *)(p + 4 * gate);
+    lstm->output_state = p + 5 * gate;
+    nnstream_lstm_reset(lstm);
+    return RISCV_NMSIS_NN_SUCCESS;
+}
+
+void nnstream_lstm_reset(nnstream_lstm_t *lstm)
+{
+    int32_t cells = lstm->num_batches * lstm->num_outputs;
+
+    // hidden_offset is the zero point of the output state
+    memset(lstm->output_state, (int8_t)lstm->params->hidden_offset, (size_t)cells);
+    memset(lstm->cell_state, 0, (size_t)cells * sizeof(int16_t));
+}
+
+riscv_nmsis_nn_status nnstream_lstm_step(nnstream_lstm_t *lstm, const int8_t *input, int8_t *output)
+{
+    const nnstream_lstm_weights_t *w = lstm->weights;
+
+    // one time step of the time major loop of riscv_lstm_unidirectional_s16_s8()
+    return riscv_nn_lstm_step_s8_s16(input, w->input_to_input, w->input_to_forget, w->input_to_cell,
+                                     w->input_to_output, w->recurrent_to_input, w->recurrent_to_forget,
+                                     w->recurrent_to_cell, w->recurrent_to_output, lstm->params, lstm->num_batches,
+                                     lstm->num_outputs, lstm->num_inputs, lstm->num_outputs, lstm->output_state,
+                                     lstm->cell_state, output, &lstm->scratch);
+}
+
+int32_t nnstream_svdf_get_buffer_size(const nmsis_nn_dims *input_dims, const nmsis_nn_dims *weights_feature_dims,
+                                      const nmsis_nn_dims *weights_time_dims, int32_t state_bytes)
+{
+    int32_t features = weights_feature_dims->n;
+    int32_t state = input_dims->n * features * weights_time_dims->h * state_bytes;
+
+    // kernel sums are only used by the int8 state
+    return ((state_bytes == 1) ? features * (int32_t)sizeof(int32_t) : 0) + NNSTREAM_ROUND(state);
+}
+
+static riscv_nmsis_nn_status nnstream_svdf_init(nnstream_svdf_t *svdf, const nmsis_nn_svdf_params *svdf_params,
+                                                const nmsis_nn_per_tensor_quant_params *input_quant_params,
+                                                const nmsis_nn_per_tensor_quant_params *output_quant_params,
+                                                const nmsis_nn_dims *input_dims,
+                                                const nmsis_nn_dims *weights_feature_dims,
+                                                const int8_t *weights_feature_data,
+                                                const nmsis_nn_dims *weights_time_dims, const int32_t *bias_data,
+                                                void *buf)
+{
+    if ((buf == NULL) || (svdf_params->rank <= 0) || (weights_feature_dims->n % svdf_params->rank != 0) ||
+        (input_dims->n <= 0) || (weights_time_dims->h <= 0)) {
+        return RISCV_NMSIS_NN_ARG_ERROR;
+    }
+    svdf->params = *svdf_params;
+    svdf->input_quant = *input_quant_params;
+    svdf->output_quant = *output_quant_params;
+    svdf->batches = input_dims->n;
+    svdf->input_size = input_dims->h;
+    svdf->features = weights_feature_dims->n;
+    svdf->time = weights_time_dims->h;
+    svdf->units = svdf->features / svdf_params->rank;
+    svdf->weights_feature = weights_feature_data;
+    svdf->weights_time_s8 = NULL;
+    svdf->weights_time_s16 = NULL;
+    svdf->bias = bias_data;
+    svdf->kernel_sum = NULL;
+    svdf->state = buf;
+    return RISCV_NMSIS_NN_SUCCESS;
+}
+
+riscv_nmsis_nn_status nnstream_svdf_s8_init(nnstream_svdf_t *svdf, const nmsis_nn_svdf_params *svdf_params,
+                                            const nmsis_nn_per_tensor_quant_params *input_quant_params,
+                                            const nmsis_nn_per_tensor_quant_params *output_quant_params,
+                                            const nmsis_nn_dims *input_dims,
+                                            const nmsis_nn_dims *weights_feature_dims,
+                                            const int8_t *weights_feature_data,
+                                            const nmsis_nn_dims *weights_time_dims,
+                                            const int8_t *weights_time_data, const int32_t *bias_data, void *buf)
+{
+    riscv_nmsis_nn_status ret;
+
+    ret = nnstream_svdf_init(svdf, svdf_params, input_quant_params, output_quant_params, input_dims,
+                             weights_feature_dims, weights_feature_data, weights_time_dims, bias_data, buf);
+    if (ret != RISCV_NMSIS_NN_SUCCESS) {
+        return ret;
+    }
+    svdf->weights_time_s8 = weights_time_data;
+    svdf->kernel_sum = (int32_t *)buf;
+    svdf->state = svdf->kernel_sum + svdf->features;
+    // same for all the frames, riscv_svdf_s8() gets them on each call
+    riscv_vector_sum_s8(svdf->kernel_sum, svdf->input_size, svdf->features, weights_feature_data);
+    nnstream_svdf_reset(svdf);
+    return RISCV_NMSIS_NN_SUCCESS;
+}
+
+riscv_nmsis_nn_status nnstream_svdf_state_s16_s8_init(nnstream_svdf_t *svdf, const nmsis_nn_svdf_params *svdf_params,
+                                                      const nmsis_nn_per_tensor_quant_params *input_quant_params,
+                                                      const nmsis_nn_per_tensor_quant_params *output_quant_params,
+                                                      const nmsis_nn_dims *input_dims,
+                                                      const nmsis_nn_dims *weights_feature_dims,
+                                                      const int8_t *weights_feature_data,
+                                                      const nmsis_nn_dims *weights_time_dims,
+                                                      const int16_t *weights_time_data, const int32_t *bias_data,
+                                                      void *buf)
+{
+    riscv_nmsis_nn_status ret;
+
+    ret = nnstream_svdf_init(svdf, svdf_params, input_quant_params, output_quant_params, input_dims,
+                             weights_feature_dims, weights_feature_data, weights_time_dims, bias_data, buf);
+    if (ret != RISCV_NMSIS_NN_SUCCESS) {
+        return ret;
+    }
+    svdf->weights_time_s16 = weights_time_data;
+    nnstream_svdf_reset(svdf);
+    return RISCV_NMSIS_NN_SUCCESS;
+}
+
+void nnstream_svdf_reset(nnstream_svdf_t *svdf)
+{
+    size_t bytes = (svdf->weights_time_s16 != NULL) ? sizeof(int16_t) : sizeof(int8_t);
+
+    memset(svdf->state, 0, (size_t)(svdf->batches * svdf->features * svdf->time) * bytes);
+    // the first frame goes to slot 0
+    svdf->head = svdf->time - 1;
+}
+
+/*
+ * Time weights times the memory of one feature, oldest frame first, the ring of the memory
+ * starts at slot old, so it is two runs of contiguous frames
+ */
+static int32_t nnstream_time_s8(const int8_t *w, const int8_t *v, int32_t time, int32_t old)
+{
+    int32_t sum = 0, n = time - old, j;
+
+    for (j = 0; j < n; j++) {
+        sum += w[j] * v[old + j];
+    }
+    for (j = 0; j < old; j++) {
+        sum += w[n + j] * v[j];
+    }
+    return sum;
+}
+
+static int32_t nnstream_time_s16(const int16_t *w, const int16_t *v, int32_t time, int32_t old)
+{
+    int32_t sum = 0, n = time - old, j;
+
+    for (j = 0; j < n; j++) {
+        sum += w[j] * v[old + j];
+    }
+    for (j = 0; j < old; j++) {
+        sum += w[n + j] * v[j];
+    }
+    return sum;
+}
+
+riscv_nmsis_nn_status nnstream_svdf_step(nnstream_svdf_t *svdf, const int8_t *input, int8_t *output)
+{
+    const int32_t time = svdf->time, features = svdf->features, rank = svdf->params.rank;
+    const int32_t lhs_offset = -svdf->params.input_offset;
+    int32_t b, u, r, f, old, sum;
+    riscv_nmsis_nn_status ret;
+
+    svdf->head = (svdf->head + 1 == time) ? 0 : svdf->head + 1;
+    old = (svdf->head + 1 == time) ? 0 : svdf->head + 1;
+    for (b = 0; b < svdf->batches; b++) {
+        // project the new frame into the slot of it of all the features
+        if (svdf->weights_time_s16 != NULL) {
+            ret = riscv_nn_vec_mat_mult_t_svdf_s8(input + b * svdf->input_size, svdf->weights_feature,
+                                                  (int16_t *)svdf->state + b * features * time + svdf->head,
+                                                  lhs_offset, time, svdf->input_quant.multiplier,
+                                                  svdf->input_quant.shift, svdf->input_size, features,
+                                                  svdf->params.input_activation.min,
+                                                  svdf->params.input_activation.max);
+        } else {
+            ret = riscv_nn_vec_mat_mult_t_s8(input + b * svdf->input_size, svdf->weights_feature, svdf->kernel_sum,
+                                             NULL, (int8_t *)svdf->state + b * features * time + svdf->head,
+                                             lhs_offset, 0, svdf->input_quant.multiplier, svdf->input_quant.shift,
+                                             svdf->input_size, features, svdf->params.input_activation.min,
+                                             svdf->params.input_activation.max, time);
+        }
+        if (ret != RISCV_NMSIS_NN_SUCCESS) {
+            return ret;
+        }
+        for (u = 0; u < svdf->units; u++) {
+            sum = (svdf->bias != NULL) ? svdf->bias[u] : 0;
+            for (r = 0; r < rank; r++) {
+                f = u * rank + r;
+                if (svdf->weights_time_s16 != NULL) {
+                    sum += nnstream_time_s16(svdf->weights_time_s16 + f * time,
+                                             (const int16_t *)svdf->state + (b * features + f) * time, time, old);
+                } else {
+                    sum += nnstream_time_s8(svdf->weights_time_s8 + f * time,
+                                            (const int8_t *)svdf->state + (b * features + f) * time, time, old);
+                }
+            }
+            sum = riscv_nn_requantize(sum, svdf->output_quant.multiplier, svdf->output_quant.shift) +
+                  svdf->params.output_offset;
+            sum = MAX(sum, svdf->params.output_activation.min);
+            output[b * svdf->units + u] = (int8_t)MIN(sum, svdf->params.output_activation.max);
+        }
+    }
+    return RISCV_NMSIS_NN_SUCCESS;
+}
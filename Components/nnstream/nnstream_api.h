@@ -0,0 +1,116 @@
+#ifndef _NNSTREAM_API_H_
+#define _NNSTREAM_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "riscv_nnfunctions.h"
+#include "riscv_nnsupportfunctions.h"
+
+/*
+ * Frame by frame LSTM and SVDF over NMSIS-NN for streaming audio.
+ *
+ * - LSTM: a nnstream_lstm_t keeps output and cell state between calls, each
+ *   nnstream_lstm_step() runs one time step of riscv_lstm_unidirectional_s16_s8() on one
+ *   frame of num_batches x num_inputs, same results as the whole sequence in time major
+ * - SVDF: a nnstream_svdf_t keeps the feature projections of the last time_batches frames
+ *   in a ring, each nnstream_svdf_step() projects only the new frame into it, with kernel
+ *   sums computed once at init, instead of moving the whole state one frame left as
+ *   riscv_svdf_s8() and riscv_svdf_state_s16_s8() do, results are bit exact to them
+ *
+ * All the memory of a stream is one buffer of nnstream_*_get_buffer_size() bytes, at least
+ * 4 bytes aligned, weights, bias and params are referenced and must stay valid.
+ */
+
+/* Weights of a LSTM, as arguments of riscv_lstm_unidirectional_s16_s8() */
+typedef struct nnstream_lstm_weights {
+    const int8_t *input_to_input;
+    const int8_t *input_to_forget;
+    const int8_t *input_to_cell;
+    const int8_t *input_to_output;
+    const int8_t *recurrent_to_input;
+    const int8_t *recurrent_to_forget;
+    const int8_t *recurrent_to_cell;
+    const int8_t *recurrent_to_output;
+} nnstream_lstm_weights_t;
+
+typedef struct nnstream_lstm {
+    int32_t num_batches;
+    int32_t num_inputs;
+    int32_t num_outputs;
+    const nnstream_lstm_weights_t *weights;
+    const nmsis_nn_lstm_params *params;
+    nmsis_nn_lstm_context scratch;
+    int8_t *output_state;           /* num_batches x num_outputs */
+    int16_t *cell_state;            /* num_batches x num_outputs */
+} nnstream_lstm_t;
+
+/* Bytes of buffer for a LSTM, max_time of dims is not used */
+int32_t nnstream_lstm_get_buffer_size(const nmsis_nn_lstm_dims *dims);
+
+/* Init a LSTM on buf and reset its state */
+riscv_nmsis_nn_status nnstream_lstm_init(nnstream_lstm_t *lstm, const nmsis_nn_lstm_dims *dims,
+                                         const nnstream_lstm_weights_t *weights, const nmsis_nn_lstm_params *params,
+                                         void *buf);
+
+/* Start a new sequence, output state is hidden_offset of params, cell state is 0 */
+void nnstream_lstm_reset(nnstream_lstm_t *lstm);
+
+/* Run one frame of num_batches x num_inputs, output is num_batches x num_outputs */
+riscv_nmsis_nn_status nnstream_lstm_step(nnstream_lstm_t *lstm, const int8_t *input, int8_t *output);
+
+typedef struct nnstream_svdf {
+    nmsis_nn_svdf_params params;
+    nmsis_nn_per_tensor_quant_params input_quant;
+    nmsis_nn_per_tensor_quant_params output_quant;
+    int32_t batches;
+    int32_t input_size;
+    int32_t features;               /* units x rank */
+    int32_t time;                   /* frames of memory */
+    int32_t units;
+    int32_t head;                   /* slot of the last frame in the ring */
+    const int8_t *weights_feature;
+    const int8_t *weights_time_s8;  /* riscv_svdf_s8() weights, or NULL */
+    const int16_t *weights_time_s16;/* riscv_svdf_state_s16_s8() weights, or NULL */
+    const int32_t *bias;
+    void *state;                    /* batches x features x time of int8 or int16 */
+    int32_t *kernel_sum;            /* features, for riscv_nn_vec_mat_mult_t_s8() */
+} nnstream_svdf_t;
+
+/* Bytes of buffer for a SVDF, state_bytes is 1 for riscv_svdf_s8() and 2 for riscv_svdf_state_s16_s8() */
+int32_t nnstream_svdf_get_buffer_size(const nmsis_nn_dims *input_dims, const nmsis_nn_dims *weights_feature_dims,
+                                      const nmsis_nn_dims *weights_time_dims, int32_t state_bytes);
+
+/* Init a SVDF of riscv_svdf_s8() arguments on buf and reset its state */
+riscv_nmsis_nn_status nnstream_svdf_s8_init(nnstream_svdf_t *svdf, const nmsis_nn_svdf_params *svdf_params,
+                                            const nmsis_nn_per_tensor_quant_params *input_quant_params,
+                                            const nmsis_nn_per_tensor_quant_params *output_quant_params,
+                                            const nmsis_nn_dims *input_dims,
+                                            const nmsis_nn_dims *weights_feature_dims,
+                                            const int8_t *weights_feature_data,
+                                            const nmsis_nn_dims *weights_time_dims,
+                                            const int8_t *weights_time_data, const int32_t *bias_data, void *buf);
+
+/* Init a SVDF of riscv_svdf_state_s16_s8() arguments on buf and reset its state */
+riscv_nmsis_nn_status nnstream_svdf_state_s16_s8_init(nnstream_svdf_t *svdf, const nmsis_nn_svdf_params *svdf_params,
+                                                      const nmsis_nn_per_tensor_quant_params *input_quant_params,
+                                                      const nmsis_nn_per_tensor_quant_params *output_quant_params,
+                                                      const nmsis_nn_dims *input_dims,
+                                                      const nmsis_nn_dims *weights_feature_dims,
+                                                      const int8_t *weights_feature_data,
+                                                      const nmsis_nn_dims *weights_time_dims,
+                                                      const int16_t *weights_time_data, const int32_t *bias_data,
+                                                      void *buf);
+
+/* Start a new stream, all the frames of memory are 0 */
+void nnstream_svdf_reset(nnstream_svdf_t *svdf);
+
+/* Run one frame of batches x input_size, output is batches x units */
+riscv_nmsis_nn_status nnstream_svdf_step(nnstream_svdf_t *svdf, const int8_t *input, int8_t *output);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _NNSTREAM_API_H_ */
@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# pkcauq middleware queues RSA and ECC operations on gd32vw55x PKCAU with interrupt
+# completion and cached Montgomery parameters
+MIDDLEWARE_PKCAUQ := $(NUCLEI_SDK_MIDDLEWARE)/pkcauq
+
+C_SRCDIRS += $(MIDDLEWARE_PKCAUQ)
+
+INCDIRS += $(MIDDLEWARE_PKCAUQ)
@@ -0,0 +1,403 @@
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "pkcauq_api.h"
+
+/* PKCAU RAM offsets, as used by the PKCAU driver */
+#define PKQ_EXP_LEN                 0x400
+#define PKQ_MOD_LEN                 0x404
+#define PKQ_MONT_N                  0x594
+#define PKQ_EXP_RESULT              0x724
+#define PKQ_EXP_A                   0xA44
+#define PKQ_EXP_E                   0xBD0
+#define PKQ_EXP_N                   0xD5C
+
+#define PKQ_ECC_A_SIGN              0x408
+#define PKQ_ECC_COFF_A              0x40C
+#define PKQ_ECC_P                   0x460
+#define PKQ_ECC_MONT_P              0x4B4
+#define PKQ_ECC_K                   0x508
+#define PKQ_ECC_X                   0x55C
+#define PKQ_ECC_Y                   0x5B0
+
+#define PKQ_SIGN_Z                  0xDE8
+#define PKQ_SIGN_D                  0xE3C
+#define PKQ_SIGN_N                  0xE94
+#define PKQ_SIGN_R                  0x700
+#define PKQ_SIGN_S                  0x754
+#define PKQ_SIGN_RES                0xEE8
+#define PKQ_SIGN_KPX                0x103C
+#define PKQ_SIGN_KPY                0x1090
+
+#define PKQ_VER_N_LEN               0x404
+#define PKQ_VER_A_SIGN              0x45C
+#define PKQ_VER_COFF_A              0x460
+#define PKQ_VER_P_LEN               0x4B4
+#define PKQ_VER_P                   0x4B8
+#define PKQ_VER_GX                  0x5E8
+#define PKQ_VER_GY                  0x63C
+#define PKQ_VER_QX                  0xF40
+#define PKQ_VER_QY                  0xF94
+#define PKQ_VER_R                   0x1098
+#define PKQ_VER_S                   0xA44
+#define PKQ_VER_Z                   0xFE8
+#define PKQ_VER_N                   0xD5C
+#define PKQ_VER_RES                 0x5B0
+
+#define PKQ_RAM(offset)             (*(volatile uint32_t *)(unsigned long)(PKCAU_BASE + (offset)))
+#define PKQ_FLAG_ERR                (PKCAU_STAT_RAMERR | PKCAU_STAT_ADDRERR)
+
+static pkcauq_op_t *pkq_head = NULL;
+static pkcauq_op_t *pkq_tail = NULL;
+
+static void pkq_value(uint32_t offset, uint32_t value)
+{
+    PKQ_RAM(offset) = value;
+}
+
+/* write big endian operand as little endian words followed by the zero word PKCAU expects */
+static void pkq_operand(uint32_t offset, const uint8_t *operand, uint32_t size)
+{
+    uint32_t data, j;
+
+    while (size >= 4) {
+        data = (uint32_t)operand[size - 1] | ((uint32_t)operand[size - 2] << 8) |
+               ((uint32_t)operand[size - 3] << 16) | ((uint32_t)operand[size - 4] << 24);
+        PKQ_RAM(offset) = data;
+        offset += 4;
+        size -= 4;
+    }
+    if (size > 0) {
+        data = 0;
+        for (j = 0; j < size; j++) {
+            data = (data << 8) | operand[j];
+        }
+        PKQ_RAM(offset) = data;
+        offset += 4;
+    }
+    PKQ_RAM(offset) = 0;
+}
+
+static void pkq_read(uint32_t offset, uint8_t *buf, uint32_t size)
+{
+    uint32_t data, j;
+
+    while (size >= 4) {
+        data = PKQ_RAM(offset);
+        offset += 4;
+        buf[size - 1] = (uint8_t)data;
+        buf[size - 2] = (uint8_t)(data >> 8);
+        buf[size - 3] = (uint8_t)(data >> 16);
+        buf[size - 4] = (uint8_t)(data >> 24);
+        size -= 4;
+    }
+    if (size > 0) {
+        data = PKQ_RAM(offset);
+        for (j = 0; j < size; j++) {
+            buf[j] = (uint8_t)(data >> ((size - 1 - j) * 8));
+        }
+    }
+}
+
+static void pkq_run(uint32_t mode)
+{
+    PKCAU_CTL = (PKCAU_CTL & ~PKCAU_CTL_MODESEL) | mode;
+    PKCAU_CTL |= PKCAU_CTL_START;
+}
+
+/* modulus of the Montgomery parameter of op */
+static void pkq_modulus(const pkcauq_op_t *op, const uint8_t **mod, uint32_t *len)
+{
+    if (op->kind == PKCAUQ_OP_MOD_EXP) {
+        const pkcau_mod_exp_parameter_struct *e = (const pkcau_mod_exp_parameter_struct *)op->para;
+        *mod = e->modulus_n;
+        *len = e->modulus_n_len;
+    } else {
+        const pkcau_ec_group_parameter_struct *c = (const pkcau_ec_group_parameter_struct *)op->para;
+        *mod = c->modulus_p;
+        *len = c->modulus_p_len;
+    }
+}
+
+static void pkq_start_mod_exp(pkcauq_op_t *op)
+{
+    const pkcau_mod_exp_parameter_struct *e = (const pkcau_mod_exp_parameter_struct *)op->para;
+
+    pkq_value(PKQ_EXP_LEN, e->e_len << 3);
+    pkq_value(PKQ_MOD_LEN, e->modulus_n_len << 3);
+    pkq_operand(PKQ_EXP_A, e->oprd_a, e->oprd_a_len);
+    pkq_operand(PKQ_EXP_E, e->exp_e, e->e_len);
+    pkq_operand(PKQ_EXP_N, e->modulus_n, e->modulus_n_len);
+    if (op->mont != NULL) {
+        pkq_operand(PKQ_MONT_N, op->mont->r2, op->mont->len);
+        pkq_run(PKCAU_MODE_MOD_EXP_FAST);
+    } else {
+        pkq_run(PKCAU_MODE_MOD_EXP);
+    }
+}
+
+static void pkq_start_ecc_mul(pkcauq_op_t *op)
+{
+    const pkcau_ec_group_parameter_struct *c = (const pkcau_ec_group_parameter_struct *)op->para;
+
+    pkq_value(PKQ_EXP_LEN, c->multi_k_len << 3);
+    pkq_value(PKQ_MOD_LEN, c->modulus_p_len << 3);
+    pkq_value(PKQ_ECC_A_SIGN, c->a_sign);
+    pkq_operand(PKQ_ECC_COFF_A, c->coff_a, c->coff_a_len);
+    pkq_operand(PKQ_ECC_P, c->modulus_p, c->modulus_p_len);
+    pkq_operand(PKQ_ECC_K, c->multi_k, c->multi_k_len);
+    pkq_operand(PKQ_ECC_X, op->point->point_x, op->point->point_x_len);
+    pkq_operand(PKQ_ECC_Y, op->point->point_y, op->point->point_y_len);
+    if (op->mont != NULL) {
+        pkq_operand(PKQ_ECC_MONT_P, op->mont->r2, op->mont->len);
+        pkq_run(PKCAU_MODE_ECC_SCALAR_MUL_FAST);
+    } else {
+        pkq_run(PKCAU_MODE_ECC_SCALAR_MUL);
+    }
+}
+
+static void pkq_start_sign(pkcauq_op_t *op)
+{
+    const pkcau_ec_group_parameter_struct *c = (const pkcau_ec_group_parameter_struct *)op->para;
+
+    pkq_value(PKQ_EXP_LEN, c->order_n_len << 3);
+    pkq_value(PKQ_MOD_LEN, c->modulus_p_len << 3);
+    pkq_value(PKQ_ECC_A_SIGN, c->a_sign);
+    pkq_operand(PKQ_ECC_COFF_A, c->coff_a, c->coff_a_len);
+    pkq_operand(PKQ_ECC_P, c->modulus_p, c->modulus_p_len);
+    pkq_operand(PKQ_ECC_K, c->integer_k, c->integer_k_len);
+    pkq_operand(PKQ_ECC_X, c->base_point_x, c->base_point_x_len);
+    pkq_operand(PKQ_ECC_Y, c->base_point_y, c->base_point_y_len);
+    pkq_operand(PKQ_SIGN_Z, op->hash->hash_z, op->hash->hash_z_len);
+    pkq_operand(PKQ_SIGN_D, c->private_key_d, c->private_key_d_len);
+    pkq_operand(PKQ_SIGN_N, c->order_n, c->order_n_len);
+    pkq_run(PKCAU_MODE_ECDSA_SIGN);
+}
+
+static void pkq_start_verify(pkcauq_op_t *op)
+{
+    const pkcau_ec_group_parameter_struct *c = (const pkcau_ec_group_parameter_struct *)op->para;
+
+    pkq_value(PKQ_VER_N_LEN, c->order_n_len << 3);
+    pkq_value(PKQ_VER_P_LEN, c->modulus_p_len << 3);
+    pkq_value(PKQ_VER_A_SIGN, c->a_sign);
+    pkq_operand(PKQ_VER_COFF_A, c->coff_a, c->coff_a_len);
+    pkq_operand(PKQ_VER_P, c->modulus_p, c->modulus_p_len);
+    pkq_operand(PKQ_VER_GX, c->base_point_x, c->base_point_x_len);
+    pkq_operand(PKQ_VER_GY, c->base_point_y, c->base_point_y_len);
+    pkq_operand(PKQ_VER_QX, op->point->point_x, op->point->point_x_len);
+    pkq_operand(PKQ_VER_QY, op->point->point_y, op->point->point_y_len);
+    pkq_operand(PKQ_VER_R, op->sign->sign_r, op->sign->sign_r_len);
+    pkq_operand(PKQ_VER_S, op->sign->sign_s, op->sign->sign_s_len);
+    pkq_operand(PKQ_VER_Z, op->hash->hash_z, op->hash->hash_z_len);
+    pkq_operand(PKQ_VER_N, c->order_n, c->order_n_len);
+    pkq_run(PKCAU_MODE_ECDSA_VERIFICATION);
+}
+
+/* start op, the PKCAU is idle here */
+static void pkq_start(pkcauq_op_t *op)
+{
+    const uint8_t *mod;
+    uint32_t len;
+
+    if ((op->mont != NULL) && (op->mont->valid == 0)) {
+        // compute the Montgomery parameter first, the operation itself starts when it ends
+        pkq_modulus(op, &mod, &len);
+        op->step = 1;
+        pkq_value(PKQ_MOD_LEN, len << 3);
+        pkq_operand(PKQ_EXP_N, mod, len);
+        pkq_run(PKCAU_MODE_MONT_PARAM);
+        return;
+    }
+    op->step = 0;
+    switch (op->kind) {
+        case PKCAUQ_OP_MOD_EXP:
+            pkq_start_mod_exp(op);
+            break;
+        case PKCAUQ_OP_ECC_MUL:
+            pkq_start_ecc_mul(op);
+            break;
+        case PKCAUQ_OP_ECDSA_SIGN:
+            pkq_start_sign(op);
+            break;
+        default:
+            pkq_start_verify(op);
+            break;
+    }
+}
+
+/* read results of op from PKCAU RAM before the next operation overwrites them */
+static void pkq_results(pkcauq_op_t *op)
+{
+    const pkcau_mod_exp_parameter_struct *e;
+    const pkcau_ec_group_parameter_struct *c;
+    uint8_t res = 0;
+
+    switch (op->kind) {
+        case PKCAUQ_OP_MOD_EXP:
+            e = (const pkcau_mod_exp_parameter_struct *)op->para;
+            pkq_read(PKQ_EXP_RESULT, op->result, e->modulus_n_len);
+            break;
+        case PKCAUQ_OP_ECC_MUL:
+            c = (const pkcau_ec_group_parameter_struct *)op->para;
+            pkq_read(PKQ_ECC_X, op->out->point_x, c->modulus_p_len);
+            pkq_read(PKQ_ECC_Y, op->out->point_y, c->modulus_p_len);
+            break;
+        case PKCAUQ_OP_ECDSA_SIGN:
+            c = (const pkcau_ec_group_parameter_struct *)op->para;
+            pkq_read(PKQ_SIGN_R, op->out->sign_r, c->order_n_len);
+            pkq_read(PKQ_SIGN_S, op->out->sign_s, c->order_n_len);
+            pkq_read(PKQ_SIGN_RES, &res, 1);
+            if (op->out->sign_extra != 0) {
+                pkq_read(PKQ_SIGN_KPX, op->out->point_x, c->order_n_len);
+                pkq_read(PKQ_SIGN_KPY, op->out->point_y, c->order_n_len);
+            }
+            break;
+        default:
+            pkq_read(PKQ_VER_RES, &res, 1);
+            break;
+    }
+    op->res = res;
+}
+
+static void pkcauq_irq_handler(void)
+{
+    pkcauq_op_t *op = pkq_head;
+    uint32_t stat = PKCAU_STAT;
+    const uint8_t *mod;
+    uint32_t len;
+
+    PKCAU_STATC = PKCAU_STATC_ENDFC | PKCAU_STATC_RAMERRC | PKCAU_STATC_ADDRERRC;
+    if (op == NULL) {
+        return;
+    }
+    if ((stat & PKQ_FLAG_ERR) != 0) {
+        op->status = PKCAUQ_ERROR;
+    } else if (op->step != 0) {
+        pkq_modulus(op, &mod, &len);
+        pkq_read(PKQ_MONT_N, op->mont->r2, len);
+        op->mont->len = len;
+        op->mont->valid = 1;
+        pkq_start(op);
+        return;
+    } else {
+        pkq_results(op);
+        op->status = PKCAUQ_DONE;
+    }
+    pkq_head = op->next;
+    if (pkq_head != NULL) {
+        pkq_start(pkq_head);
+    } else {
+        pkq_tail = NULL;
+    }
+    if (op->cb != NULL) {
+        op->cb(op, op->arg);
+    }
+}
+
+int32_t pkcauq_init(uint8_t lvl)
+{
+    rcu_periph_clock_enable(RCU_PKCAU);
+    pkcau_deinit();
+    pkcau_enable();
+    // PKCAU RAM is cleared after enable
+    while ((PKCAU_STAT & PKCAU_STAT_BUSY) != 0) {
+    }
+    PKCAU_STATC = PKCAU_STATC_ENDFC | PKCAU_STATC_RAMERRC | PKCAU_STATC_ADDRERRC;
+    PKCAU_CTL |= PKCAU_CTL_ENDIE | PKCAU_CTL_RAMERRIE | PKCAU_CTL_ADDRERRIE;
+    pkq_head = NULL;
+    pkq_tail = NULL;
+    return ECLIC_Register_IRQ(PKCAU_IRQn, ECLIC_NON_VECTOR_INTERRUPT, ECLIC_LEVEL_TRIGGER, lvl, 0,
+                              (void *)pkcauq_irq_handler);
+}
+
+int32_t pkcauq_submit(pkcauq_op_t *op)
+{
+    const uint8_t *mod;
+    uint32_t len;
+    rv_csr_t mstatus;
+
+    if ((op->kind > PKCAUQ_OP_ECDSA_VERIFY) || (op->para == NULL)) {
+        return -1;
+    }
+    if ((op->kind == PKCAUQ_OP_ECDSA_SIGN) || (op->kind == PKCAUQ_OP_ECDSA_VERIFY)) {
+        // no fast mode for ECDSA
+        op->mont = NULL;
+    } else if (op->mont != NULL) {
+        pkq_modulus(op, &mod, &len);
+        if ((len > PKCAUQ_MAX_BYTES) || ((op->mont->valid != 0) && (op->mont->len != len))) {
+            return -1;
+        }
+    }
+    op->next = NULL;
+    op->res = 0;
+    op->status = PKCAUQ_PENDING;
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if (pkq_tail != NULL) {
+        pkq_tail->next = op;
+        pkq_tail = op;
+    } else {
+        pkq_head = op;
+        pkq_tail = op;
+        pkq_start(op);
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return 0;
+}
+
+int32_t pkcauq_wait(pkcauq_op_t *op)
+{
+    return __wfi_while_pending(&op->status, PKCAUQ_PENDING);
+}
+
+int32_t pkcauq_mod_exp(pkcauq_op_t *op, const pkcau_mod_exp_parameter_struct *para, pkcauq_mont_t *mont,
+                       uint8_t *result, pkcauq_cb_t cb, void *arg)
+{
+    op->kind = PKCAUQ_OP_MOD_EXP;
+    op->para = para;
+    op->mont = mont;
+    op->result = result;
+    op->cb = cb;
+    op->arg = arg;
+    return pkcauq_submit(op);
+}
+
+int32_t pkcauq_ecc_mul(pkcauq_op_t *op, const pkcau_point_parameter_struct *point,
+                       const pkcau_ec_group_parameter_struct *curve, pkcauq_mont_t *mont,
+                       pkcau_ecc_out_struct *out, pkcauq_cb_t cb, void *arg)
+{
+    op->kind = PKCAUQ_OP_ECC_MUL;
+    op->para = curve;
+    op->point = point;
+    op->mont = mont;
+    op->out = out;
+    op->cb = cb;
+    op->arg = arg;
+    return pkcauq_submit(op);
+}
+
+int32_t pkcauq_ecdsa_sign(pkcauq_op_t *op, const pkcau_hash_parameter_struct *hash,
+                          const pkcau_ec_group_parameter_struct *curve, pkcau_ecc_out_struct *out,
+                          pkcauq_cb_t cb, void *arg)
+{
+    op->kind = PKCAUQ_OP_ECDSA_SIGN;
+    op->para = curve;
+    op->hash = hash;
+    op->out = out;
+    op->cb = cb;
+    op->arg = arg;
+    return pkcauq_submit(op);
+}
+
+int32_t pkcauq_ecdsa_verify(pkcauq_op_t *op, const pkcau_point_parameter_struct *point,
+                            const pkcau_hash_parameter_struct *hash, const pkcau_signature_parameter_struct *sign,
+                            const pkcau_ec_group_parameter_struct *curve, pkcauq_cb_t cb, void *arg)
+{
+    op->kind = PKCAUQ_OP_ECDSA_VERIFY;
+    op->para = curve;
+    op->point = point;
+    op->hash = hash;
+    op->sign = sign;
+    op->cb = cb;
+    op->arg = arg;
+    return pkcauq_submit(op);
+}
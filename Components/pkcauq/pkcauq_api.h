@@ -0,0 +1,102 @@
+#ifndef _PKCAUQ_API_H_
+#define _PKCAUQ_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+
+/*
+ * Asynchronous RSA and ECC operations on the gd32vw55x PKCAU.
+ *
+ * - Operation queue: operations are caller owned and queued, the end of operation interrupt
+ *   reads the results, starts the next operation and calls the callback of the finished one,
+ *   so the CPU is free while the PKCAU computes, in RTOS the callback posts an event, in
+ *   bare-metal pkcauq_wait() sleeps until the operation completes
+ * - Montgomery cache: a pkcauq_mont_t keeps R2 mod n of one modulus, the first operation with
+ *   it computes the parameter as a separate step and stores it, later ones run the fast
+ *   modular exponentiation or ECC scalar multiplication mode without computing it again
+ *
+ * Parameter structures are those of the PKCAU driver, operands are big endian, all buffers
+ * of an operation must stay valid until it completes. mont_para fields of the driver
+ * structures are not used, the cache replaces them.
+ */
+
+/* largest modulus in bytes */
+#ifndef PKCAUQ_MAX_BYTES
+#define PKCAUQ_MAX_BYTES            384
+#endif
+
+/* status of operation */
+#define PKCAUQ_DONE                 0
+#define PKCAUQ_PENDING              1
+#define PKCAUQ_ERROR                -1
+
+/* operation kinds */
+#define PKCAUQ_OP_MOD_EXP           0
+#define PKCAUQ_OP_ECC_MUL           1
+#define PKCAUQ_OP_ECDSA_SIGN        2
+#define PKCAUQ_OP_ECDSA_VERIFY      3
+
+/* Montgomery parameter cache of one modulus */
+typedef struct pkcauq_mont {
+    uint8_t r2[PKCAUQ_MAX_BYTES];   /* R2 mod n, big endian */
+    uint32_t len;                   /* bytes of r2 */
+    volatile uint8_t valid;         /* 1 when r2 is computed, clear it when the modulus changes */
+} pkcauq_mont_t;
+
+struct pkcauq_op;
+/* completion callback of operation, called in interrupt */
+typedef void (*pkcauq_cb_t)(struct pkcauq_op *op, void *arg);
+
+typedef struct pkcauq_op {
+    struct pkcauq_op *next;
+    uint8_t kind;                   /* PKCAUQ_OP_* */
+    uint8_t step;                   /* private, 1 while computing the Montgomery parameter */
+    const void *para;               /* pkcau_mod_exp_parameter_struct or pkcau_ec_group_parameter_struct */
+    const pkcau_point_parameter_struct *point;
+    const pkcau_hash_parameter_struct *hash;
+    const pkcau_signature_parameter_struct *sign;
+    pkcauq_mont_t *mont;            /* Montgomery cache, or NULL */
+    uint8_t *result;                /* result of modular exponentiation */
+    pkcau_ecc_out_struct *out;      /* result of ECC scalar multiplication or ECDSA sign */
+    pkcauq_cb_t cb;                 /* completion callback, can be NULL */
+    void *arg;
+    uint32_t res;                   /* ECDSA result flag, as returned by the driver functions */
+    volatile int32_t status;        /* PKCAUQ_PENDING when queued, PKCAUQ_DONE or PKCAUQ_ERROR */
+} pkcauq_op_t;
+
+/* Reset and enable PKCAU, register its interrupt at level lvl, return 0 on success */
+int32_t pkcauq_init(uint8_t lvl);
+
+/* Queue an operation with kind and parameter fields set, return 0 on success */
+int32_t pkcauq_submit(pkcauq_op_t *op);
+
+/* Wait for an operation to complete, return its status */
+int32_t pkcauq_wait(pkcauq_op_t *op);
+
+/* Queue modular exponentiation result = a ^ e mod n, result has modulus_n_len bytes */
+int32_t pkcauq_mod_exp(pkcauq_op_t *op, const pkcau_mod_exp_parameter_struct *para, pkcauq_mont_t *mont,
+                       uint8_t *result, pkcauq_cb_t cb, void *arg);
+
+/* Queue ECC scalar multiplication k * point, to out->point_x and out->point_y */
+int32_t pkcauq_ecc_mul(pkcauq_op_t *op, const pkcau_point_parameter_struct *point,
+                       const pkcau_ec_group_parameter_struct *curve, pkcauq_mont_t *mont,
+                       pkcau_ecc_out_struct *out, pkcauq_cb_t cb, void *arg);
+
+/* Queue ECDSA sign of hash, to out->sign_r and out->sign_s, res is 0 on success */
+int32_t pkcauq_ecdsa_sign(pkcauq_op_t *op, const pkcau_hash_parameter_struct *hash,
+                          const pkcau_ec_group_parameter_struct *curve, pkcau_ecc_out_struct *out,
+                          pkcauq_cb_t cb, void *arg);
+
+/* Queue ECDSA verification of sign over hash with public key point, res is 0 if valid */
+int32_t pkcauq_ecdsa_verify(pkcauq_op_t *op, const pkcau_point_parameter_struct *point,
+                            const pkcau_hash_parameter_struct *hash, const pkcau_signature_parameter_struct *sign,
+                            const pkcau_ec_group_parameter_struct *curve, pkcauq_cb_t cb, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _PKCAUQ_API_H_ */
@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# pktbuf middleware provides a zero-copy packet buffer pool with chained segments, headroom and
+# reference counting, with DMA aligned payloads for dmaq, caustream and haustream, add dmaq to MIDDLEWARE too
+MIDDLEWARE_PKTBUF := $(NUCLEI_SDK_MIDDLEWARE)/pktbuf
+
+C_SRCDIRS += $(MIDDLEWARE_PKTBUF)
+
+INCDIRS += $(MIDDLEWARE_PKTBUF)
@@ -0,0 +1,221 @@
+#include <stdint.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "pktbuf_api.h"
+
+#define PKTBUF_ALIGN_UP(x)          (((x) + PKTBUF_ALIGN - 1) & ~(unsigned long)(PKTBUF_ALIGN - 1))
+
+uint32_t pktbuf_pool_init(pktbuf_pool_t *pool, void *mem, uint32_t memsize, uint32_t bufsize)
+{
+    unsigned long start = ((unsigned long)mem + sizeof(void *) - 1) & ~(unsigned long)(sizeof(void *) - 1);
+    unsigned long end = (unsigned long)mem + memsize;
+    unsigned long payload;
+    pktbuf_t *descs = (pktbuf_t *)start;
+    uint32_t i, count;
+
+    pool->free = NULL;
+    pool->count = 0;
+    pool->avail = 0;
+    pool->min_avail = 0;
+    pool->fails = 0;
+    bufsize = PKTBUF_ALIGN_UP(bufsize);
+    pool->bufsize = bufsize;
+    if ((bufsize == 0) || (end < start + PKTBUF_ALIGN)) {
+        return 0;
+    }
+    // descriptors first, then aligned payloads, alignment may take up to PKTBUF_ALIGN - 1 bytes
+    count = (end - start - (PKTBUF_ALIGN - 1)) / (sizeof(pktbuf_t) + bufsize);
+    payload = PKTBUF_ALIGN_UP(start + count * sizeof(pktbuf_t));
+    for (i = 0; i < count; i++) {
+        descs[i].buf = (uint8_t *)(payload + i * bufsize);
+        descs[i].pool = pool;
+        descs[i].refs = 0;
+        descs[i].next = pool->free;
+        pool->free = &descs[i];
+    }
+    pool->count = count;
+    pool->avail = count;
+    pool->min_avail = count;
+    return count;
+}
+
+uint32_t pktbuf_pool_avail(pktbuf_pool_t *pool)
+{
+    return pool->avail;
+}
+
+pktbuf_t *pktbuf_alloc(pktbuf_pool_t *pool, uint32_t headroom, uint32_t len)
+{
+    pktbuf_t *head, *p;
+    uint32_t n = 1, i, room, seg;
+    rv_csr_t mstatus;
+
+    if (headroom >= pool->bufsize) {
+        return NULL;
+    }
+    room = pool->bufsize - headroom;
+    if (len > room) {
+        n += (len - room + pool->bufsize - 1) / pool->bufsize;
+    }
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if (pool->avail < n) {
+        pool->fails++;
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+        return NULL;
+    }
+    head = pool->free;
+    for (p = head, i = 1; i < n; i++) {
+        p = p->next;
+    }
+    pool->free = p->next;
+    p->next = NULL;
+    pool->avail -= n;
+    if (pool->avail < pool->min_avail) {
+        pool->min_avail = pool->avail;
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+
+    for (p = head; p != NULL; p = p->next) {
+        seg = (len < room) ? len : room;
+        p->data = p->buf + ((p == head) ? headroom : 0);
+        p->len = seg;
+        p->tot_len = len;
+        p->refs = 1;
+        len -= seg;
+        room = pool->bufsize;
+    }
+    return head;
+}
+
+void pktbuf_ref(pktbuf_t *p)
+{
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+
+    p->refs++;
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
+
+void pktbuf_free(pktbuf_t *p)
+{
+    pktbuf_pool_t *pool;
+    pktbuf_t *next;
+    rv_csr_t mstatus;
+
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    // segments of a chain may come from different pools, each one goes back to its own
+    while ((p != NULL) && (--p->refs == 0)) {
+        next = p->next;
+        pool = p->pool;
+        p->next = pool->free;
+        pool->free = p;
+        pool->avail++;
+        p = next;
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
+
+uint8_t *pktbuf_push(pktbuf_t *p, uint32_t n)
+{
+    if ((uint32_t)(p->data - p->buf) < n) {
+        return NULL;
+    }
+    p->data -= n;
+    p->len += n;
+    p->tot_len += n;
+    return p->data;
+}
+
+uint8_t *pktbuf_pull(pktbuf_t *p, uint32_t n)
+{
+    if (p->len < n) {
+        return NULL;
+    }
+    p->data += n;
+    p->len -= n;
+    p->tot_len -= n;
+    return p->data;
+}
+
+uint8_t *pktbuf_put(pktbuf_t *p, uint32_t n)
+{
+    pktbuf_t *last = p;
+    uint8_t *tail;
+
+    while (last->next != NULL) {
+        last = last->next;
+    }
+    tail = last->data + last->len;
+    if ((uint32_t)(last->buf + last->pool->bufsize - tail) < n) {
+        return NULL;
+    }
+    for (; p != NULL; p = p->next) {
+        p->tot_len += n;
+    }
+    last->len += n;
+    return tail;
+}
+
+void pktbuf_cat(pktbuf_t *h, pktbuf_t *t)
+{
+    for (; h->next != NULL; h = h->next) {
+        h->tot_len += t->tot_len;
+    }
+    h->tot_len += t->tot_len;
+    h->next = t;
+}
+
+uint32_t pktbuf_copy_out(const pktbuf_t *p, uint32_t off, void *buf, uint32_t len)
+{
+    uint8_t *dst = (uint8_t *)buf;
+    uint32_t n, done = 0;
+
+    for (; (p != NULL) && (done < len); p = p->next) {
+        if (off >= p->len) {
+            off -= p->len;
+            continue;
+        }
+        n = p->len - off;
+        n = (n < len - done) ? n : (len - done);
+        memcpy(dst + done, p->data + off, n);
+        done += n;
+        off = 0;
+    }
+    return done;
+}
+
+uint32_t pktbuf_copy_in(pktbuf_t *p, uint32_t off, const void *buf, uint32_t len)
+{
+    const uint8_t *src = (const uint8_t *)buf;
+    uint32_t n, done = 0;
+
+    for (; (p != NULL) && (done < len); p = p->next) {
+        if (off >= p->len) {
+            off -= p->len;
+            continue;
+        }
+        n = p->len - off;
+        n = (n < len - done) ? n : (len - done);
+        memcpy(p->data + off, src + done, n);
+        done += n;
+        off = 0;
+    }
+    return done;
+}
+
+uint32_t pktbuf_sg(const pktbuf_t *p, dmaq_uart_sg_t *sg, uint32_t max)
+{
+    uint32_t cnt = 0;
+
+    for (; p != NULL; p = p->next) {
+        if (p->len == 0) {
+            continue;
+        }
+        if (cnt == max) {
+            return 0;
+        }
+        sg[cnt].buf = p->data;
+        sg[cnt].len = p->len;
+        cnt++;
+    }
+    return cnt;
+}
@@ -0,0 +1,105 @@
+#ifndef _PKTBUF_API_H_
+#define _PKTBUF_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "dmaq_api.h"
+
+/*
+ * Zero-copy packet buffers for networking on gd32vw55x, also usable on gd32vf103.
+ *
+ * - Pool: fixed size buffers carved from caller memory, the descriptors are kept apart from
+ *   the payload, each payload starts on a PKTBUF_ALIGN boundary and its size is rounded up
+ *   to PKTBUF_ALIGN, so cache maintenance by DMA of one buffer never touches another one
+ * - Chains: a packet larger than one buffer is a chain of segments, tot_len of the first one
+ *   is the packet length, pktbuf_sg() gives the segments as a dmaq_uart_sg_t list for the
+ *   chained DMA requests of dmaq_uart_write_sg(), and the segments can be passed one by one
+ *   to caustream_update() and haustream_update(), payloads are 4 bytes aligned and, with a
+ *   buffer size and headroom multiple of 16, the full segments are whole AES blocks
+ * - Headroom: pktbuf_alloc() leaves room before the payload of the first segment, so lower
+ *   layers prepend their headers in place by pktbuf_push(), and strip them by pktbuf_pull()
+ * - References: a packet queued to several consumers is shared by pktbuf_ref(), each one
+ *   drops it by pktbuf_free(), its segments go back to the pool with the last reference
+ *
+ * Allocation and free can be called in interrupt, as in DMA completion callbacks.
+ */
+
+/* alignment of payload and size of buffers, the size of a cache line for DMA */
+#ifndef PKTBUF_ALIGN
+#define PKTBUF_ALIGN                DMAQ_CACHE_LINE
+#endif
+
+struct pktbuf_pool;
+
+/* one segment of packet */
+typedef struct pktbuf {
+    struct pktbuf *next;            /* next segment of packet, NULL for the last one */
+    uint8_t *data;                  /* payload of segment */
+    uint32_t len;                   /* bytes of payload in segment */
+    uint32_t tot_len;               /* bytes of this and next segments */
+    /* private */
+    struct pktbuf_pool *pool;
+    uint8_t *buf;                   /* start of buffer */
+    uint32_t refs;
+} pktbuf_t;
+
+typedef struct pktbuf_pool {
+    /* private */
+    pktbuf_t *free;                 /* free segments */
+    uint32_t bufsize;               /* bytes of one buffer */
+    uint32_t count;                 /* buffers in pool */
+    uint32_t avail;                 /* free buffers */
+    uint32_t min_avail;             /* lowest avail seen */
+    uint32_t fails;                 /* allocations failed */
+} pktbuf_pool_t;
+
+/*
+ * Carve as many buffers of bufsize bytes as fit in memsize bytes of mem, return the number
+ * of buffers, 0 if none fits
+ */
+uint32_t pktbuf_pool_init(pktbuf_pool_t *pool, void *mem, uint32_t memsize, uint32_t bufsize);
+
+/* Return free buffers of pool */
+uint32_t pktbuf_pool_avail(pktbuf_pool_t *pool);
+
+/*
+ * Allocate a packet of len bytes with headroom bytes reserved before it, chained over as many
+ * buffers as needed, headroom is less than the buffer size, return NULL if pool is short
+ */
+pktbuf_t *pktbuf_alloc(pktbuf_pool_t *pool, uint32_t headroom, uint32_t len);
+
+/* Take one more reference of packet p */
+void pktbuf_ref(pktbuf_t *p);
+
+/* Drop a reference of packet p, segments without reference go back to their pool */
+void pktbuf_free(pktbuf_t *p);
+
+/* Prepend n bytes in headroom of p, return the new start of payload, NULL if no room */
+uint8_t *pktbuf_push(pktbuf_t *p, uint32_t n);
+
+/* Strip n bytes from start of first segment of p, return new start of payload, NULL if too short */
+uint8_t *pktbuf_pull(pktbuf_t *p, uint32_t n);
+
+/* Append n bytes at end of last segment of p, return their start, NULL if no room */
+uint8_t *pktbuf_put(pktbuf_t *p, uint32_t n);
+
+/* Chain packet t after packet h, the reference of t is taken over by h */
+void pktbuf_cat(pktbuf_t *h, pktbuf_t *t);
+
+/* Copy len bytes from offset off of p to buf, return bytes copied */
+uint32_t pktbuf_copy_out(const pktbuf_t *p, uint32_t off, void *buf, uint32_t len);
+
+/* Copy len bytes of buf to offset off of p, return bytes copied */
+uint32_t pktbuf_copy_in(pktbuf_t *p, uint32_t off, const void *buf, uint32_t len);
+
+/* Fill sg with non-empty segments of p, return their number, 0 if more than max */
+uint32_t pktbuf_sg(const pktbuf_t *p, dmaq_uart_sg_t *sg, uint32_t max);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _PKTBUF_API_H_ */
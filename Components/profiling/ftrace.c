@@ -0,0 +1,188 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "ftrace_api.h"
+
+/*
+ * NOTE: all functions in this file must not be instrumented, and no NMSIS inline
+ * functions is called in the hook functions, since they are instrumented too when
+ * inlined into a source file compiled with -finstrument-functions
+ */
+#define FTRACE_NOTRACE      __attribute__((no_instrument_function))
+
+#if (FTRACE_RING_SIZE & (FTRACE_RING_SIZE - 1)) != 0
+#error "FTRACE_RING_SIZE must be power of 2"
+#endif
+
+/*
+ * ftrace.out layout, all fields are in cpu native little-endian
+ * - header: struct ftracehdr
+ * - FTRACE_HART_NUM rings: struct ftracering, only the latest min(head, size) records are valid,
+ *   the oldest one is located at records[(head - valid) % size]
+ */
+struct ftracehdr {
+    char magic[4];      /* "NFTR" */
+    uint16_t version;   /* version number */
+    uint16_t xlenbytes; /* size of pc and cycle delta in bytes */
+    uint32_t harts;     /* ring count */
+    uint32_t size;      /* record count of each ring */
+};
+
+/*
+ * pc is the address of function, bit 0 is set for function exit,
+ * delta is the cycles elapsed since previous record of the same hart
+ */
+struct ftracerec {
+    unsigned long pc;
+    unsigned long delta;
+};
+
+struct ftracering {
+    uint32_t hartid;            /* hart id of this ring */
+    volatile uint32_t head;     /* total records written */
+    unsigned long lastcyc;      /* cycle of previous record */
+    struct ftracerec records[FTRACE_RING_SIZE];
+};
+
+#define FTRACEVERSION       1
+#define FTRACE_EXIT_FLAG    0x1
+
+/* ftrace data structure */
+struct ftracedata {
+    char *buf;
+    uint32_t size;
+};
+
+/* Where the ftrace data stored after execute ftrace_collect(0) */
+struct ftracedata ftrace_data = {NULL, 0};
+
+static struct {
+    struct ftracehdr hdr;
+    struct ftracering rings[FTRACE_HART_NUM];
+} ftrace_buf;
+
+static volatile unsigned long ftrace_active = 0;
+
+#ifdef __HARTID_OFFSET
+#define FTRACE_HART_INDEX()     (__RV_CSR_READ(CSR_MHARTID) - __HARTID_OFFSET)
+#else
+#define FTRACE_HART_INDEX()     (__RV_CSR_READ(CSR_MHARTID))
+#endif
+
+FTRACE_NOTRACE static inline void ftrace_record(unsigned long pc)
+{
+    unsigned long hartidx = FTRACE_HART_INDEX();
+    unsigned long cycle;
+    struct ftracering *ring;
+    struct ftracerec *rec;
+    rv_csr_t mstatus;
+    uint32_t idx;
+
+    if ((ftrace_active == 0) || (hartidx >= FTRACE_HART_NUM)) {
+        return;
+    }
+    ring = &ftrace_buf.rings[hartidx];
+    /*
+     * ring is only written by its own hart, mask interrupts so a record made by a
+     * nested interrupt can't come between reading cycle and lastcyc and storing them,
+     * which would give it a wrong or backwards delta
+     */
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    cycle = __RV_CSR_READ(CSR_MCYCLE);
+    idx = ring->head;
+    ring->head = idx + 1;
+    rec = &ring->records[idx & (FTRACE_RING_SIZE - 1)];
+    rec->pc = pc;
+    rec->delta = cycle - ring->lastcyc;
+    ring->lastcyc = cycle;
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
+
+FTRACE_NOTRACE void __cyg_profile_func_enter(void *this_fn, void *call_site)
+{
+    ftrace_record((unsigned long)this_fn);
+}
+
+FTRACE_NOTRACE void __cyg_profile_func_exit(void *this_fn, void *call_site)
+{
+    ftrace_record((unsigned long)this_fn | FTRACE_EXIT_FLAG);
+}
+
+FTRACE_NOTRACE void ftrace_start(void)
+{
+    ftrace_active = 0;
+    ftrace_buf.hdr.magic[0] = 'N';
+    ftrace_buf.hdr.magic[1] = 'F';
+    ftrace_buf.hdr.magic[2] = 'T';
+    ftrace_buf.hdr.magic[3] = 'R';
+    ftrace_buf.hdr.version = FTRACEVERSION;
+    ftrace_buf.hdr.xlenbytes = sizeof(unsigned long);
+    ftrace_buf.hdr.harts = FTRACE_HART_NUM;
+    ftrace_buf.hdr.size = FTRACE_RING_SIZE;
+    for (int i = 0; i < FTRACE_HART_NUM; i ++) {
+#ifdef __HARTID_OFFSET
+        ftrace_buf.rings[i].hartid = i + __HARTID_OFFSET;
+#else
+        ftrace_buf.rings[i].hartid = i;
+#endif
+        ftrace_buf.rings[i].head = 0;
+        ftrace_buf.rings[i].lastcyc = __RV_CSR_READ(CSR_MCYCLE);
+    }
+    __RWMB();
+    ftrace_active = 1;
+}
+
+FTRACE_NOTRACE void ftrace_stop(void)
+{
+    ftrace_active = 0;
+    __RWMB();
+}
+
+#define NUM_OCTETS_PER_LINE 20
+#define FLUSH_OUTPUT()      fflush(stdout)
+FTRACE_NOTRACE static void hexdumpbuf(char *buf, unsigned long sz)
+{
+    unsigned long rem, cur = 0, i = 0;
+
+    FLUSH_OUTPUT();
+
+    while (cur < sz) {
+        rem = ((sz - cur) < NUM_OCTETS_PER_LINE) ? (sz - cur) : NUM_OCTETS_PER_LINE;
+        for (i = 0; i < rem; i++) {
+            printf("%02x", (uint8_t)buf[cur + i]);
+        }
+        printf("\n");
+        FLUSH_OUTPUT();
+        cur += rem;
+    }
+}
+
+FTRACE_NOTRACE long ftrace_collect(unsigned long interface)
+{
+    static const char ftrace_out[] = "ftrace.out";
+    int fd;
+
+    ftrace_stop();
+    if (interface == 0) {
+        ftrace_data.buf = (char *)&ftrace_buf;
+        ftrace_data.size = sizeof(ftrace_buf);
+        printf("Collected ftrace data @0x%lx, size %lu bytes\n", (unsigned long)ftrace_data.buf, (unsigned long)ftrace_data.size);
+    } else if (interface == 1) {
+        fd = open(ftrace_out, O_CREAT | O_TRUNC | O_WRONLY, 0666);
+        if (fd < 0) {
+            printf("Unable to open %s\n", ftrace_out);
+            return -1;
+        }
+        write(fd, (const char *)&ftrace_buf, sizeof(ftrace_buf));
+        close(fd);
+        printf("Write %s done!\n", ftrace_out);
+    } else {
+        printf("\nDump ftrace data start\n");
+        hexdumpbuf((char *)&ftrace_buf, sizeof(ftrace_buf));
+        printf("\nCREATE: %s\n", ftrace_out);
+        printf("\nDump ftrace data finished\n");
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+#ifndef _FTRACE_API_H_
+#define _FTRACE_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Function level cycle tracing using -finstrument-functions
+ *
+ * Each function entry and exit of the source files compiled with extra `-finstrument-functions`
+ * compiler option is recorded as a compact (pc, cycle delta) record into a per-hart ring buffer,
+ * the oldest records are overwritten when ring buffer is full, so the latest timeline is kept.
+ *
+ * Compared to `-pg` used by gprof, no hash table lookup is done when a function is called,
+ * so the timing of small hot functions is much less distorted.
+ *
+ * Each hart only writes its own ring buffer, records are reserved using atomic instruction,
+ * so it can also be used in interrupt handlers.
+ */
+
+/* record count of each hart ring buffer, must be power of 2 */
+#ifndef FTRACE_RING_SIZE
+#define FTRACE_RING_SIZE    1024
+#endif
+
+/* max hart count can be traced, harts with hart index larger than it are not traced */
+#ifndef FTRACE_HART_NUM
+#if defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1)
+#define FTRACE_HART_NUM     SMP_CPU_CNT
+#else
+#define FTRACE_HART_NUM     1
+#endif
+#endif
+
+/* Start tracing, previous recorded records are cleared */
+void ftrace_start(void);
+
+/* Stop tracing, recorded records are kept until next ftrace_start */
+void ftrace_stop(void);
+
+/* - if interface == 0, it will dump ftrace data in buffer called ftrace_data, use dump_ftrace.gdb to dump it
+ * - if interface == 1, it will write ftrace.out file using open/write api
+ * - otherwise it will dump ftrace data in console, use parse.py to convert it into ftrace.out
+ * ftrace.out can be converted into chrome trace or flame graph format by parse_ftrace.py
+ */
+long ftrace_collect(unsigned long interface);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_FTRACE_API_H_ */
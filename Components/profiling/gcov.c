@@ -20,6 +20,7 @@
 #include <unistd.h>
 
 #include <stdio.h>
+#include "prof_stream.h"
 
 //#define DEBUG
 
@@ -272,14 +273,41 @@ size_t store_gcov_u64(void *buffer, size_t off, u64 v)
     return sizeof(*data) * 2;
 }
 
+/*
+ * emit_gcov_u32/emit_gcov_u64 - store number to buffer, or append it to
+ * @stream if it is not %NULL, returns the number of bytes stored
+ */
+static size_t emit_gcov_u32(char *buffer, prof_stream_t *stream, size_t off, u32 v)
+{
+    if (stream) {
+        prof_stream_write(stream, &v, sizeof(v));
+        return sizeof(v);
+    }
+    return store_gcov_u32(buffer, off, v);
+}
+
+static size_t emit_gcov_u64(char *buffer, prof_stream_t *stream, size_t off, u64 v)
+{
+    u32 data[2];
+
+    if (stream) {
+        data[0] = (v & 0xffffffffUL);
+        data[1] = (v >> 32);
+        prof_stream_write(stream, data, sizeof(data));
+        return sizeof(data);
+    }
+    return store_gcov_u64(buffer, off, v);
+}
+
 /**
- * convert_to_gcda - convert coverage info set to gcda file format
+ * emit_gcda - convert coverage info set to gcda file format
  * @buffer: the buffer to store file data or %NULL if no data should be stored
+ * @stream: the stream to emit file data chunk by chunk, @buffer is ignored if not %NULL
  * @info: coverage info set to be converted
  *
- * Returns the number of bytes that were/would have been stored into the buffer.
+ * Returns the number of bytes that were/would have been stored.
  */
-size_t convert_to_gcda(char *buffer, struct gcov_info *info)
+static size_t emit_gcda(char *buffer, prof_stream_t *stream, struct gcov_info *info)
 {
     struct gcov_fn_info *fi_ptr;
     struct gcov_ctr_info *ci_ptr;
@@ -289,25 +317,25 @@ size_t convert_to_gcda(char *buffer, struct gcov_info *info)
     size_t pos = 0;
 
     /* File header. */
-    pos += store_gcov_u32(buffer, pos, GCOV_DATA_MAGIC);
-    pos += store_gcov_u32(buffer, pos, info->version);
-    pos += store_gcov_u32(buffer, pos, info->stamp);
+    pos += emit_gcov_u32(buffer, stream, pos, GCOV_DATA_MAGIC);
+    pos += emit_gcov_u32(buffer, stream, pos, info->version);
+    pos += emit_gcov_u32(buffer, stream, pos, info->stamp);
 
 #if (__GNUC__ >= 12)
     /* Use zero as checksum of the compilation unit. */
-    pos += store_gcov_u32(buffer, pos, 0);
+    pos += emit_gcov_u32(buffer, stream, pos, 0);
 #endif
 
     for (fi_idx = 0; fi_idx < info->n_functions; fi_idx++) {
         fi_ptr = info->functions[fi_idx];
 
         /* Function record. */
-        pos += store_gcov_u32(buffer, pos, GCOV_TAG_FUNCTION);
-        pos += store_gcov_u32(buffer, pos,
+        pos += emit_gcov_u32(buffer, stream, pos, GCOV_TAG_FUNCTION);
+        pos += emit_gcov_u32(buffer, stream, pos,
             GCOV_TAG_FUNCTION_LENGTH * GCOV_UNIT_SIZE);
-        pos += store_gcov_u32(buffer, pos, fi_ptr->ident);
-        pos += store_gcov_u32(buffer, pos, fi_ptr->lineno_checksum);
-        pos += store_gcov_u32(buffer, pos, fi_ptr->cfg_checksum);
+        pos += emit_gcov_u32(buffer, stream, pos, fi_ptr->ident);
+        pos += emit_gcov_u32(buffer, stream, pos, fi_ptr->lineno_checksum);
+        pos += emit_gcov_u32(buffer, stream, pos, fi_ptr->cfg_checksum);
 
         ci_ptr = fi_ptr->ctrs;
 
@@ -316,13 +344,13 @@ size_t convert_to_gcda(char *buffer, struct gcov_info *info)
                 continue;
 
             /* Counter record. */
-            pos += store_gcov_u32(buffer, pos,
+            pos += emit_gcov_u32(buffer, stream, pos,
                           GCOV_TAG_FOR_COUNTER(ct_idx));
-            pos += store_gcov_u32(buffer, pos,
+            pos += emit_gcov_u32(buffer, stream, pos,
                 ci_ptr->num * 2 * GCOV_UNIT_SIZE);
 
             for (cv_idx = 0; cv_idx < ci_ptr->num; cv_idx++) {
-                pos += store_gcov_u64(buffer, pos,
+                pos += emit_gcov_u64(buffer, stream, pos,
                               ci_ptr->values[cv_idx]);
             }
 
@@ -333,6 +361,36 @@ size_t convert_to_gcda(char *buffer, struct gcov_info *info)
     return pos;
 }
 
+/**
+ * convert_to_gcda - convert coverage info set to gcda file format
+ * @buffer: the buffer to store file data or %NULL if no data should be stored
+ * @info: coverage info set to be converted
+ *
+ * Returns the number of bytes that were/would have been stored into the buffer.
+ */
+size_t convert_to_gcda(char *buffer, struct gcov_info *info)
+{
+    return emit_gcda(buffer, NULL, info);
+}
+
+/**
+ * stream_gcda - emit coverage info set in gcda file format via streaming interface
+ * @info: coverage info set to be emitted
+ * @interface: PROF_STREAM_xxx interface
+ *
+ * Only a chunk buffer of PROF_STREAM_CHUNK_SIZE bytes is used.
+ */
+static int stream_gcda(struct gcov_info *info, unsigned long interface)
+{
+    prof_stream_t stream;
+
+    if (prof_stream_open(&stream, interface, info->filename) != 0) {
+        return -1;
+    }
+    emit_gcda(NULL, &stream, info);
+    return prof_stream_close(&stream);
+}
+
 /*
  * These functions may be referenced by gcc-generated profiling code but serve
  * no function for kernel profiling.
@@ -388,64 +446,204 @@ void __gcov_init(struct gcov_info *info)
     }
 }
 
-#define NUM_OCTETS_PER_LINE     20
-#define FLUSH_OUTPUT()        fflush(stdout)
-static void hexdumpbuf(char *buf, unsigned long sz)
+void gcov_dump(void)
 {
-    unsigned long rem, cur = 0, i = 0;
+    struct gcov_info *info;
 
-    FLUSH_OUTPUT();
+    if (!gcov_info_head) {
+        return;
+    }
 
-    while (cur < sz) {
-        rem = ((sz - cur) < NUM_OCTETS_PER_LINE) ? (sz - cur) : NUM_OCTETS_PER_LINE;
-        for (i = 0; i < rem; i++) {
-            printf("%02x", buf[cur + i]);
-        }
-        printf("\n");
-        FLUSH_OUTPUT();
-        cur += rem;
+    printf("\nDump coverage data start\n");
+    fflush(stdout);
+
+    for (info = gcov_info_head; info != NULL; info = info->next) {
+        stream_gcda(info, PROF_STREAM_CONSOLE);
     }
+    printf("\nDump coverage data finish\n");
+    fflush(stdout);
 }
 
-// Modified based on https://github.com/astarasikov/lk/commit/2a4af09a894194dfaff3e05f6fd505241d54d074
-static void dump_gcov_info(struct gcov_info *info)
+/*
+ * Coverage delta snapshot
+ *
+ * Only counters changed since last snapshot are emitted, additive counters(merged by
+ * __gcov_merge_add, such as arcs) are reset to zero after they are emitted, so no shadow
+ * copy of counters is required, other counters are emitted with current value.
+ * All numbers are LEB128 varint encoded, zero counters are run-length encoded:
+ *
+ * snapshot: "NGCD" version seq unit_size has_checksum counters_num {file} 0
+ * file:     1 namelen name gcov_version stamp additive_mask active_mask {function} 0
+ * function: (fn_idx + 1) ident lineno_checksum cfg_checksum {counter of each active type}
+ * counter:  num {zeros nonzeros value...} until num values covered
+ */
+#define GCOV_DELTA_MAGIC    "NGCD"
+#define GCOV_DELTA_VERSION  1
+
+static unsigned int gcov_delta_seq = 0;
+
+static void stream_varint(prof_stream_t *stream, u64 v)
 {
-    size_t sz = 0;
-    char *bufptr = NULL;
-    if (!info) {
-        return;
+    uint8_t buf[10];
+    size_t len = 0;
+
+    do {
+        buf[len] = v & 0x7f;
+        v >>= 7;
+        if (v) {
+            buf[len] |= 0x80;
+        }
+        len++;
+    } while (v);
+    prof_stream_write(stream, buf, len);
+}
+
+static int counter_additive(struct gcov_info *info, unsigned int type)
+{
+    return info->merge[type] == __gcov_merge_add;
+}
+
+/* Return 1 if any additive counter of this function changed since last snapshot */
+static int function_changed(struct gcov_info *info, struct gcov_fn_info *fi_ptr)
+{
+    struct gcov_ctr_info *ci_ptr = fi_ptr->ctrs;
+    unsigned int ct_idx, cv_idx;
+
+    for (ct_idx = 0; ct_idx < GCOV_COUNTERS; ct_idx++) {
+        if (!counter_active(info, ct_idx))
+            continue;
+        if (counter_additive(info, ct_idx)) {
+            for (cv_idx = 0; cv_idx < ci_ptr->num; cv_idx++) {
+                if (ci_ptr->values[cv_idx] != 0) {
+                    return 1;
+                }
+            }
+        }
+        ci_ptr++;
     }
+    return 0;
+}
 
-    sz = convert_to_gcda(NULL, info);
-    bufptr = (char *)malloc(sz);
-    if (bufptr == NULL) {
-        printf("ERROR: Can't allocate gcda buffer for %s\n", info->filename);
-        return;
+static void stream_delta_counter(prof_stream_t *stream, struct gcov_ctr_info *ci_ptr, int additive)
+{
+    unsigned int start = 0, zeros, run, cv_idx;
+    gcov_type value;
+
+    stream_varint(stream, ci_ptr->num);
+    while (start < ci_ptr->num) {
+        for (zeros = 0; (start + zeros < ci_ptr->num) && (ci_ptr->values[start + zeros] == 0); zeros++);
+        start += zeros;
+        for (run = 0; (start + run < ci_ptr->num) && (ci_ptr->values[start + run] != 0); run++);
+        stream_varint(stream, zeros);
+        stream_varint(stream, run);
+        for (cv_idx = start; cv_idx < start + run; cv_idx++) {
+            // counter may be updated by running code, not atomic
+            value = ci_ptr->values[cv_idx];
+            if (additive) {
+                ci_ptr->values[cv_idx] -= value;
+            }
+            stream_varint(stream, (u64)value);
+        }
+        start += run;
     }
-    sz = convert_to_gcda(bufptr, info);
+}
 
-    hexdumpbuf(bufptr, sz);
+static void stream_delta_info(prof_stream_t *stream, struct gcov_info *info)
+{
+    struct gcov_fn_info *fi_ptr;
+    struct gcov_ctr_info *ci_ptr;
+    unsigned int fi_idx, ct_idx;
+    unsigned int additive_mask = 0, active_mask = 0;
+    size_t namelen = strlen(info->filename);
+    int header = 0;
+
+    for (ct_idx = 0; ct_idx < GCOV_COUNTERS; ct_idx++) {
+        if (counter_active(info, ct_idx)) {
+            active_mask |= 1 << ct_idx;
+            if (counter_additive(info, ct_idx)) {
+                additive_mask |= 1 << ct_idx;
+            }
+        }
+    }
 
-    free(bufptr);
-    printf("\nCREATE: %s\n", info->filename);
+    for (fi_idx = 0; fi_idx < info->n_functions; fi_idx++) {
+        fi_ptr = info->functions[fi_idx];
+        if (!function_changed(info, fi_ptr))
+            continue;
+        if (!header) {
+            stream_varint(stream, 1);
+            stream_varint(stream, namelen);
+            prof_stream_write(stream, info->filename, namelen);
+            stream_varint(stream, info->version);
+            stream_varint(stream, info->stamp);
+            stream_varint(stream, additive_mask);
+            stream_varint(stream, active_mask);
+            header = 1;
+        }
+        stream_varint(stream, fi_idx + 1);
+        stream_varint(stream, fi_ptr->ident);
+        stream_varint(stream, fi_ptr->lineno_checksum);
+        stream_varint(stream, fi_ptr->cfg_checksum);
+        ci_ptr = fi_ptr->ctrs;
+        for (ct_idx = 0; ct_idx < GCOV_COUNTERS; ct_idx++) {
+            if (!counter_active(info, ct_idx))
+                continue;
+            stream_delta_counter(stream, ci_ptr, counter_additive(info, ct_idx));
+            ci_ptr++;
+        }
+    }
+    if (header) {
+        stream_varint(stream, 0);
+    }
 }
 
-void gcov_dump(void)
+/**
+ * gcov_delta_dump - emit coverage counters changed since last snapshot
+ * @interface: 1 to write file, 3 to send via prof_mailbox, otherwise dump in console
+ *
+ * Each snapshot is emitted as gcov_delta_<seq>.bin, use parse_gcov.py to merge them into gcda files.
+ * Return 0 if snapshot is emitted
+ */
+int gcov_delta_dump(unsigned long interface)
 {
     struct gcov_info *info;
+    prof_stream_t stream;
+    char filename[32];
 
     if (!gcov_info_head) {
-        return;
+        return -1;
     }
-
-    printf("\nDump coverage data start\n");
-    fflush(stdout);
-
+    if ((interface != PROF_STREAM_FILE) && (interface != PROF_STREAM_MAILBOX)) {
+        interface = PROF_STREAM_CONSOLE;
+    }
+    snprintf(filename, sizeof(filename), "gcov_delta_%u.bin", gcov_delta_seq);
+    if (interface == PROF_STREAM_CONSOLE) {
+        printf("\nDump coverage delta start\n");
+    }
+    if (prof_stream_open(&stream, interface, filename) != 0) {
+        return -1;
+    }
+    prof_stream_write(&stream, GCOV_DELTA_MAGIC, 4);
+    stream_varint(&stream, GCOV_DELTA_VERSION);
+    stream_varint(&stream, gcov_delta_seq);
+    stream_varint(&stream, GCOV_UNIT_SIZE);
+#if (__GNUC__ >= 12)
+    stream_varint(&stream, 1);
+#else
+    stream_varint(&stream, 0);
+#endif
+    stream_varint(&stream, GCOV_COUNTERS);
     for (info = gcov_info_head; info != NULL; info = info->next) {
-        dump_gcov_info(info);
+        stream_delta_info(&stream, info);
     }
-    printf("\nDump coverage data finish\n");
-    fflush(stdout);
+    stream_varint(&stream, 0);
+    prof_stream_close(&stream);
+    if (interface == PROF_STREAM_CONSOLE) {
+        printf("\nDump coverage delta finish\n");
+        fflush(stdout);
+    }
+    gcov_delta_seq++;
+    return 0;
 }
 
 /**
@@ -469,7 +667,8 @@ void gcov_free(void)
 
 /**
  * gcov_collect - collect and convert coverage data from gcov_info_head
- *      It need to malloc buffer from heap, so it may fail if your heap is not big enough
+ *      For interface 0, it need to malloc buffer from heap, so it may fail if your heap is not big enough,
+ *      other interfaces stream the data using a PROF_STREAM_CHUNK_SIZE bytes chunk buffer
  *
  * Return 0, if all coverage data is collected and converted
  */
@@ -479,13 +678,26 @@ int gcov_collect(unsigned long interface)
     struct gcov_data *data;
     size_t sz = 0, count = 0;
     char *bufptr = NULL;
-    int fd = -1;
 
     // Make sure there are coverage information in it
     if (!gcov_info_head) {
         return -1;
     }
 
+    // file, mailbox and rtt interface stream gcda data chunk by chunk, no heap buffer required
+    if ((interface == PROF_STREAM_FILE) || ((interface >= PROF_STREAM_MAILBOX) && (interface <= PROF_STREAM_MAX))) {
+        for (info = gcov_info_head; info != NULL; info = info->next) {
+            if (stream_gcda(info, interface) == 0) {
+                if (interface == PROF_STREAM_FILE) {
+                    printf("Create and store coverage data in %s file\n", info->filename);
+                }
+                count += 1;
+            }
+        }
+        printf("%u files coverage data collected\n", (unsigned int)count);
+        return 0;
+    }
+
     // if you want to dump in console, just call gcov_dump() function
     if (interface > 1) {
         gcov_dump();
@@ -509,16 +721,6 @@ int gcov_collect(unsigned long interface)
         data->size = sz;
         convert_to_gcda(bufptr, info);
         gcov_data_link(data);
-        if (interface == 1) {
-            fd = open(data->filename, O_CREAT | O_TRUNC | O_WRONLY, 0666);
-            if (fd > 0) {
-                printf("Create and store coverage data in %s file\n", data->filename);
-                write(fd, (const char*) data->buffer, (size_t)data->size);
-                close(fd);
-            } else {
-                printf("Unable to open %s file\n", data->filename);
-            }
-        }
         count += 1;
     }
     if (count) {
@@ -25,7 +25,10 @@
 /*
  * - If interface == 0, it will collect coverage data and store in gcov_data_head
  * - If interface == 1, it will dump gcda files in filesystem using open/write API
- * - otherwise, it will execute gcov_dump() to dump in console */
+ * - If interface == 3, it will send gcda files to debugger via prof_mailbox, see dump_mailbox.gdb
+ * - If interface == 4, it will send gcda files in rtt data channel with rtt middleware, see parse_rtt.py
+ * - otherwise, it will execute gcov_dump() to dump in console
+ * Except interface 0, gcda data is streamed using a PROF_STREAM_CHUNK_SIZE bytes buffer */
 int gcov_collect(unsigned long interface);
 
 /* Use gcov_dump to dump coverage data in console */
@@ -57,6 +60,17 @@ Dump coverage data finish
  */
 void gcov_dump(void);
 
+/*
+ * Emit coverage counters changed since last snapshot, varint and run-length encoded,
+ * it can be called periodically in long-running program, parse_gcov.py can merge the
+ * snapshots into gcda files, additive counters such as arcs are reset after emitted,
+ * so gcov_collect/gcov_dump after it only contain counters since last snapshot
+ * - If interface == 1, it will write gcov_delta_<seq>.bin using open/write API
+ * - If interface == 3, it will send gcov_delta_<seq>.bin to debugger via prof_mailbox
+ * - otherwise, it will dump in console
+ */
+int gcov_delta_dump(unsigned long interface);
+
 #ifdef __cplusplus
 }
 #endif
@@ -37,6 +37,7 @@
 #include <stdint.h>
 #include <string.h>
 #include "gprof_api.h"
+#include "prof_stream.h"
 
 //#define DEBUG
 
@@ -184,6 +185,26 @@ static struct gmonparam _gmonparam = { GMON_PROF_OFF, 0, NULL,
 /* Where the gprof data stored after execute gprof_collect(0) */
 struct gprofdata gprof_data = {NULL, 0};
 
+#if defined(NUCLEI_GPROF_TASK) && (NUCLEI_GPROF_TASK == 1)
+/* histogram of a sampled task, id NULL means the slot is free */
+struct gproftask {
+    const void *id;
+    char name[GPROF_TASK_NAME_LEN]; /* used in file name, so only safe chars are kept */
+    unsigned short *kcount; /* points into gprof_task_kcount */
+};
+
+static struct gproftask gprof_tasks[GPROF_TASK_SLOTS];
+/* GPROF_TASK_SLOTS histograms of kcountsize bytes each */
+static unsigned short *gprof_task_kcount = NULL;
+#endif
+
+/* Default when no RTOS port implements it, samples are not attributed to any task */
+__attribute__((weak)) const void *gprof_current_task(const char **name)
+{
+    *name = NULL;
+    return NULL;
+}
+
 /*
  * Control profiling
  *    profiling is what mcount checks to see if
@@ -245,6 +266,14 @@ static void monstartup(size_t lowpc, size_t highpc)
 
     p->tos[0].link = 0;
 
+#if defined(NUCLEI_GPROF_TASK) && (NUCLEI_GPROF_TASK == 1)
+    gprof_task_kcount = calloc(GPROF_TASK_SLOTS, p->kcountsize);
+    if (gprof_task_kcount == NULL) {
+        /* profiling goes on with the global histogram only */
+        ERR("monstartup: out of memory for task histograms\n");
+    }
+#endif
+
     o = p->highpc - p->lowpc;
     if (p->kcountsize < o) {
 #ifndef notdef
@@ -375,41 +404,98 @@ void _mcount(uint32_t *frompcindex)
     goto out;
 }
 
-#define NUM_OCTETS_PER_LINE 20
-#define FLUSH_OUTPUT()      fflush(stdout)
-static void hexdumpbuf(char *buf, unsigned long sz)
+/* write to stream, or to buffer at *bufptr when stream is NULL */
+static void gprof_write(prof_stream_t *stream, char **bufptr, const void *data, size_t len)
+{
+    if (stream == NULL) {
+        memcpy(*bufptr, data, len);
+        *bufptr += len;
+    } else {
+        prof_stream_write(stream, data, len);
+    }
+}
+
+/* write gmon data of histogram kcount, followed by all the call graph arcs */
+static void gprof_write_gmon(prof_stream_t *stream, char **bufptr, const struct gmonhdr *hdr,
+                             const unsigned short *kcount)
 {
-    unsigned long rem, cur = 0, i = 0;
+    int fromindex;
+    int endfrom;
+    size_t frompc;
+    int toindex;
+    struct rawarc rawarc;
+    struct gmonparam *p = GMONPARAM;
+#ifdef DEBUG
+    int len;
+    char dbuf[200];
+#endif
 
-    FLUSH_OUTPUT();
+    gprof_write(stream, bufptr, (const void *) hdr, sizeof *hdr);
+    gprof_write(stream, bufptr, (const void *) kcount, p->kcountsize);
 
-    while (cur < sz) {
-        rem = ((sz - cur) < NUM_OCTETS_PER_LINE) ? (sz - cur) : NUM_OCTETS_PER_LINE;
-        for (i = 0; i < rem; i++) {
-            printf("%02x", buf[cur + i]);
+#ifdef DEBUG
+    len = sprintf(dbuf, "[mcleanup1] lowpc 0x%lx highpc 0x%lx ncnt %d\n",
+                hdr->lpc, hdr->hpc, hdr->ncnt);
+    write(STDOUT_FILENO, dbuf, len);
+#endif
+    endfrom = p->fromssize / sizeof(*p->froms);
+    for (fromindex = 0; fromindex < endfrom; fromindex++) {
+        if (p->froms[fromindex] == 0) {
+            continue;
+        }
+        frompc = p->lowpc;
+        frompc += fromindex * HASHFRACTION * sizeof(*p->froms);
+        for (toindex = p->froms[fromindex]; toindex != 0; toindex =
+                p->tos[toindex].link) {
+#ifdef DEBUG
+            len = sprintf(dbuf,
+            "[mcleanup2] frompc 0x%x selfpc 0x%x count %d\n" ,
+                frompc, p->tos[toindex].selfpc,
+                p->tos[toindex].count);
+            write(STDOUT_FILENO, dbuf, len);
+#endif
+            rawarc.raw_frompc = frompc;
+            rawarc.raw_selfpc = p->tos[toindex].selfpc;
+            rawarc.raw_count = p->tos[toindex].count;
+            gprof_write(stream, bufptr, (const void *) &rawarc, sizeof rawarc);
+        }
+    }
+}
+
+#if defined(NUCLEI_GPROF_TASK) && (NUCLEI_GPROF_TASK == 1)
+/* write gmon_<task>.out of each sampled task */
+static void gprof_write_tasks(unsigned long interface, const struct gmonhdr *hdr)
+{
+    static char fname[GPROF_TASK_NAME_LEN + sizeof("gmon_.out")];
+    prof_stream_t stream;
+
+    for (int i = 0; i < GPROF_TASK_SLOTS; i++) {
+        if (gprof_tasks[i].id == NULL) {
+            break;
+        }
+        snprintf(fname, sizeof(fname), "gmon_%s.out", gprof_tasks[i].name);
+        if (prof_stream_open(&stream, interface, fname) != 0) {
+            return;
+        }
+        gprof_write_gmon(&stream, NULL, hdr, gprof_tasks[i].kcount);
+        prof_stream_close(&stream);
+        if (interface == PROF_STREAM_FILE) {
+            printf("Write %s done!\n", fname);
         }
-        printf("\n");
-        FLUSH_OUTPUT();
-        cur += rem;
     }
 }
+#endif
 
 long gprof_collect(unsigned long interface)
 {
     static const char gmon_out[] = "gmon.out";
-    int fd = -1;
     int hz;
-    int fromindex;
-    int endfrom;
-    size_t frompc;
-    int toindex;
-    struct rawarc rawarc;
     struct gmonparam *p = GMONPARAM;
     struct gmonhdr gmonhdr, *hdr;
-    const char *proffile;
+    prof_stream_t stream;
     char *bufptr;
 #ifdef DEBUG
-    int log, len;
+    int len;
     char dbuf[200];
 #endif
 
@@ -419,6 +505,9 @@ long gprof_collect(unsigned long interface)
     }
     hz = PROF_HZ;
     moncontrol(0); /* stop */
+    if (interface > PROF_STREAM_MAX) {
+        interface = PROF_STREAM_CONSOLE;
+    }
     if (interface == 0) {
         gprof_data.size = 0;
         if (gprof_data.buf == NULL) {
@@ -429,15 +518,13 @@ long gprof_collect(unsigned long interface)
             }
         }
         bufptr = gprof_data.buf;
-    } else if (interface == 1) {
-        proffile = gmon_out;
-        fd = open(proffile, O_CREAT | O_TRUNC | O_WRONLY, 0666);
-        if (fd < 0) {
-            printf("Unable to open %s\n", proffile);
+    } else {
+        if (interface == PROF_STREAM_CONSOLE) {
+            printf("\nDump profiling data start\n");
+        }
+        if (prof_stream_open(&stream, interface, gmon_out) != 0) {
             return -1;
         }
-    } else {
-        printf("\nDump profiling data start\n");
     }
 
 #ifdef DEBUG
@@ -453,75 +540,81 @@ long gprof_collect(unsigned long interface)
     hdr->version = GMONVERSION;
     hdr->profrate = hz;
     if (interface == 0) {
-        memcpy(bufptr, (void*) hdr, sizeof *hdr);
-        bufptr += sizeof *hdr;
-        memcpy(bufptr, (void*) p->kcount, p->kcountsize);
-        bufptr += p->kcountsize;
-    } else if (interface == 1) {
-        write(fd, (const char*) hdr, sizeof *hdr);
-        write(fd, (const char*) p->kcount, p->kcountsize);
+        gprof_write_gmon(NULL, &bufptr, hdr, p->kcount);
+        gprof_data.size = bufptr - gprof_data.buf;
+        printf("Collected gprof data @0x%lx, size %lu bytes\n", gprof_data.buf, gprof_data.size);
     } else {
-        hexdumpbuf((char*) hdr, sizeof *hdr);
-        hexdumpbuf((char *)p->kcount, (unsigned long)p->kcountsize);
+        gprof_write_gmon(&stream, NULL, hdr, p->kcount);
+        prof_stream_close(&stream);
+        if (interface == PROF_STREAM_FILE) {
+            printf("Write %s done!\n", gmon_out);
+        }
+#if defined(NUCLEI_GPROF_TASK) && (NUCLEI_GPROF_TASK == 1)
+        gprof_write_tasks(interface, hdr);
+#endif
+        if (interface == PROF_STREAM_CONSOLE) {
+            printf("\nDump profiling data finished\n");
+        }
     }
+    return 0;
+}
 
-#ifdef DEBUG
-    len = sprintf(dbuf, "[mcleanup1] lowpc 0x%lx highpc 0x%lx ncnt %d\n",
-                hdr->lpc, hdr->hpc, hdr->ncnt);
-    write(STDOUT_FILENO, dbuf, len);
-#endif
-    endfrom = p->fromssize / sizeof(*p->froms);
-    for (fromindex = 0; fromindex < endfrom; fromindex++) {
-        if (p->froms[fromindex] == 0) {
-            continue;
+#if defined(NUCLEI_GPROF_TASK) && (NUCLEI_GPROF_TASK == 1)
+/* histogram of the task running on current hart, a free slot is taken when it is first sampled */
+static unsigned short *gprof_task_histogram(void)
+{
+    const char *name = NULL;
+    const void *id = gprof_current_task(&name);
+    struct gproftask *slot;
+    int i, n;
+
+    if ((id == NULL) || (gprof_task_kcount == NULL)) {
+        return NULL;
+    }
+    for (i = 0; i < GPROF_TASK_SLOTS; i++) {
+        slot = &gprof_tasks[i];
+        if (slot->id == id) {
+            return slot->kcount;
         }
-        frompc = p->lowpc;
-        frompc += fromindex * HASHFRACTION * sizeof(*p->froms);
-        for (toindex = p->froms[fromindex]; toindex != 0; toindex =
-                p->tos[toindex].link) {
-#ifdef DEBUG
-            len = sprintf(dbuf,
-            "[mcleanup2] frompc 0x%x selfpc 0x%x count %d\n" ,
-                frompc, p->tos[toindex].selfpc,
-                p->tos[toindex].count);
-            write(STDOUT_FILENO, dbuf, len);
-#endif
-            rawarc.raw_frompc = frompc;
-            rawarc.raw_selfpc = p->tos[toindex].selfpc;
-            rawarc.raw_count = p->tos[toindex].count;
-            if (interface == 0) {
-                memcpy(bufptr, (void*) &rawarc, sizeof rawarc);
-                bufptr += sizeof rawarc;
-            } else if (interface == 1) {
-                write(fd, (const char*)&rawarc, sizeof rawarc);
+        if (slot->id == NULL) {
+            for (n = 0; (name != NULL) && (name[n] != '\0') && (n < GPROF_TASK_NAME_LEN - 1); n++) {
+                char c = name[n];
+                slot->name[n] = ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || \
+                                 (c == '-')) ? c : '_';
+            }
+            if (n == 0) {
+                snprintf(slot->name, sizeof(slot->name), "task%d", i);
             } else {
-                hexdumpbuf((char *)(&rawarc), (unsigned long)(sizeof rawarc));
+                slot->name[n] = '\0';
             }
+            slot->kcount = gprof_task_kcount + i * (GMONPARAM->kcountsize / sizeof(HISTCOUNTER));
+            slot->id = id;
+            return slot->kcount;
         }
     }
-    if (interface == 0) {
-        gprof_data.size = bufptr - gprof_data.buf;
-        printf("Collected gprof data @0x%lx, size %lu bytes\n", gprof_data.buf, gprof_data.size);
-    } else if (interface == 1) {
-        close(fd);
-        printf("Write %s done!\n", gmon_out);
-    } else {
-        printf("\nCREATE: %s\n", gmon_out);
-        printf("\nDump profiling data finished\n");
-    }
-    return 0;
+    return NULL;
 }
+#endif
 
 /* sample the current program counter */
 void gprof_sample(unsigned long pc)
 {
     size_t idx;
     struct gmonparam *p = GMONPARAM;
+#if defined(NUCLEI_GPROF_TASK) && (NUCLEI_GPROF_TASK == 1)
+    unsigned short *kcount;
+#endif
 
     if (p->state == GMON_PROF_ON) {
         if (pc >= p->lowpc && pc < p->highpc) {
             idx = PROFIDX(pc, p->lowpc, p->scale);
             p->kcount[idx]++;
+#if defined(NUCLEI_GPROF_TASK) && (NUCLEI_GPROF_TASK == 1)
+            kcount = gprof_task_histogram();
+            if (kcount != NULL) {
+                kcount[idx]++;
+            }
+#endif
         }
     }
 }
@@ -48,15 +48,38 @@ extern char __etext; /* end of text/code symbol, defined by linker */
 #define PROGRAM_LOWPC       (&_text)
 #define PROGRAM_HIGHPC      (&__etext)
 
+/*
+ * Per-task histogram, enabled by NUCLEI_GPROF_TASK=1 such as COMMON_FLAGS += -DNUCLEI_GPROF_TASK=1
+ * - each sample is also counted into the histogram of the task it interrupted, which is found by
+ *   gprof_current_task() implemented in the FreeRTOS, RT-Thread, ThreadX and uC/OS-II ports
+ * - at most GPROF_TASK_SLOTS tasks get a histogram, in the order they are first sampled, and each
+ *   costs the same ram as the global histogram, samples of other tasks are only in gmon.out
+ * - except interface 0, gprof_collect writes gmon_<task>.out for each task after gmon.out, they have
+ *   the call graph arcs of all tasks, since _mcount doesn't know the task, parse.py splits them from log
+ */
+#ifndef GPROF_TASK_SLOTS
+#define GPROF_TASK_SLOTS    4
+#endif
+#define GPROF_TASK_NAME_LEN 16
+
 /* - if interface == 0, it will dump gprof data in buffer called gprof_data
  * - if interface == 1, it will write gmon.out file using open/write api
+ * - if interface == 3, it will send gmon.out to debugger via prof_mailbox, see dump_mailbox.gdb
+ * - if interface == 4, it will send gmon.out in rtt data channel with rtt middleware, see parse_rtt.py
  * - otherwise it will dump gprof data in console
+ * Except interface 0, gprof data is streamed using a PROF_STREAM_CHUNK_SIZE bytes buffer
  */
 long gprof_collect(unsigned long interface);
 
 /* Do gprof sample, you can place it in a PROF_HZ period timer interrupt called, the pc should be sampled program pc */
 void gprof_sample(unsigned long pc);
 
+/*
+ * Return handle of the task running on current hart, and its name in name, called in the sample
+ * interrupt when NUCLEI_GPROF_TASK=1, the weak default returns NULL, which means no task
+ */
+const void *gprof_current_task(const char **name);
+
 void gprof_off(void);
 void gprof_on(void);
 
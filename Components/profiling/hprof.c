@@ -0,0 +1,190 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "hprof_api.h"
+
+#if defined(__ECLIC_PRESENT) && (__ECLIC_PRESENT == 1)
+
+/*
+ * hprof.out layout, all fields are in cpu native little-endian
+ * - header: struct hprofhdr
+ * - samples: count samples, each one is pc, or pc + ra if HPROF_FLAG_RA set, xlen bytes each
+ */
+struct hprofhdr {
+    char magic[4];      /* "NHPF" */
+    uint16_t version;   /* version number */
+    uint16_t xlenbytes; /* size of each pc/ra in bytes */
+    uint32_t flags;     /* HPROF_FLAG_xxx */
+    uint32_t count;     /* recorded sample count */
+    uint32_t dropped;   /* samples dropped due to buffer full */
+    uint32_t event;     /* hpm event value */
+    uint32_t period;    /* sample period in events */
+    uint32_t spare;     /* reserved */
+};
+
+#define HPROFVERSION        1
+
+/* hprof data structure */
+struct hprofdata {
+    char *buf;
+    uint32_t size;
+};
+
+/* Where the hprof data stored after execute hprof_collect(0) */
+struct hprofdata hprof_data = {NULL, 0};
+
+static struct {
+    struct hprofhdr hdr;
+    unsigned long samples[HPROF_MAX_SAMPLES * 2];
+} hprof_buf;
+
+static volatile unsigned long hprof_active = 0;
+
+#define __HPROF_CONCAT(a, b)        a##b
+#define __HPROF_CSR(a, b)           __HPROF_CONCAT(a, b)
+#define HPROF_CSR_EVENT             __HPROF_CSR(CSR_MHPMEVENT, HPROF_HPM_IDX)
+
+#if __RISCV_XLEN == 32
+#define HPROF_CSR_EVENTH            __HPROF_CSR(__HPROF_CSR(CSR_MHPMEVENT, HPROF_HPM_IDX), H)
+/* overflow flag located in mhpmeventh[31] */
+#define HPROF_CLEAR_OVERFLOW()      __RV_CSR_WRITE(HPROF_CSR_EVENTH, 0)
+#else
+/* overflow flag located in mhpmevent[63] */
+#define HPROF_CLEAR_OVERFLOW()      __RV_CSR_WRITE(HPROF_CSR_EVENT, hprof_buf.hdr.event)
+#endif
+
+/* preload counter to overflow after period events */
+static inline void hprof_arm(void)
+{
+    __set_hpm_counter(HPROF_HPM_IDX, (uint64_t)0 - hprof_buf.hdr.period);
+    HPROF_CLEAR_OVERFLOW();
+}
+
+/* hpm counter overflow interrupt handler, vector mode interrupt */
+__INTERRUPT static void hprof_overflow_handler(void)
+{
+    unsigned long ra;
+
+    /* ra is not changed by interrupt entry, it is the return address of interrupted function */
+    __ASM volatile("mv %0, ra" : "=r"(ra));
+    hprof_sample(__RV_CSR_READ(CSR_MEPC), ra);
+    if (hprof_active) {
+        hprof_arm();
+    }
+}
+
+void hprof_sample(unsigned long pc, unsigned long ra)
+{
+    struct hprofhdr *hdr = &hprof_buf.hdr;
+    uint32_t width = (hdr->flags & HPROF_FLAG_RA) ? 2 : 1;
+
+    if (hdr->count >= HPROF_MAX_SAMPLES) {
+        hdr->dropped++;
+        return;
+    }
+    hprof_buf.samples[hdr->count * width] = pc;
+    if (width == 2) {
+        hprof_buf.samples[hdr->count * width + 1] = ra;
+    }
+    hdr->count++;
+}
+
+long hprof_start(unsigned long event, unsigned long period, unsigned long flags)
+{
+    struct hprofhdr *hdr = &hprof_buf.hdr;
+
+    if (period == 0) {
+        return -1;
+    }
+    hdr->magic[0] = 'N';
+    hdr->magic[1] = 'H';
+    hdr->magic[2] = 'P';
+    hdr->magic[3] = 'F';
+    hdr->version = HPROFVERSION;
+    hdr->xlenbytes = sizeof(unsigned long);
+    hdr->flags = flags;
+    hdr->count = 0;
+    hdr->dropped = 0;
+    hdr->event = event;
+    hdr->period = period;
+    hdr->spare = 0;
+
+    __disable_mhpm_counter(HPROF_HPM_IDX);
+    __set_hpm_event(HPROF_HPM_IDX, event);
+    hprof_arm();
+    if (ECLIC_Register_IRQ(HPROF_IRQn, ECLIC_VECTOR_INTERRUPT, ECLIC_LEVEL_TRIGGER,
+                           HPROF_IRQ_LEVEL, 0, (void *)hprof_overflow_handler) != 0) {
+        printf("hprof_start: unable to register hpm overflow interrupt %d\n", HPROF_IRQn);
+        return -1;
+    }
+    hprof_active = 1;
+    __enable_mhpm_counter(HPROF_HPM_IDX);
+    __enable_irq();
+    return 0;
+}
+
+void hprof_stop(void)
+{
+    hprof_active = 0;
+    __disable_mhpm_counter(HPROF_HPM_IDX);
+    ECLIC_DisableIRQ(HPROF_IRQn);
+    HPROF_CLEAR_OVERFLOW();
+}
+
+#define NUM_OCTETS_PER_LINE 20
+#define FLUSH_OUTPUT()      fflush(stdout)
+static void hexdumpbuf(char *buf, unsigned long sz)
+{
+    unsigned long rem, cur = 0, i = 0;
+
+    FLUSH_OUTPUT();
+
+    while (cur < sz) {
+        rem = ((sz - cur) < NUM_OCTETS_PER_LINE) ? (sz - cur) : NUM_OCTETS_PER_LINE;
+        for (i = 0; i < rem; i++) {
+            printf("%02x", (uint8_t)buf[cur + i]);
+        }
+        printf("\n");
+        FLUSH_OUTPUT();
+        cur += rem;
+    }
+}
+
+long hprof_collect(unsigned long interface)
+{
+    static const char hprof_out[] = "hprof.out";
+    struct hprofhdr *hdr = &hprof_buf.hdr;
+    uint32_t width = (hdr->flags & HPROF_FLAG_RA) ? 2 : 1;
+    unsigned long size;
+    int fd;
+
+    hprof_stop();
+    size = sizeof(struct hprofhdr) + hdr->count * width * sizeof(unsigned long);
+    if (hdr->dropped) {
+        printf("hprof_collect: %lu samples dropped, please increase HPROF_MAX_SAMPLES\n", (unsigned long)hdr->dropped);
+    }
+    if (interface == 0) {
+        hprof_data.buf = (char *)&hprof_buf;
+        hprof_data.size = size;
+        printf("Collected hprof data @0x%lx, size %lu bytes\n", (unsigned long)hprof_data.buf, (unsigned long)hprof_data.size);
+    } else if (interface == 1) {
+        fd = open(hprof_out, O_CREAT | O_TRUNC | O_WRONLY, 0666);
+        if (fd < 0) {
+            printf("Unable to open %s\n", hprof_out);
+            return -1;
+        }
+        write(fd, (const char *)&hprof_buf, size);
+        close(fd);
+        printf("Write %s done!\n", hprof_out);
+    } else {
+        printf("\nDump hprof data start\n");
+        hexdumpbuf((char *)&hprof_buf, size);
+        printf("\nCREATE: %s\n", hprof_out);
+        printf("\nDump hprof data finished\n");
+    }
+    return 0;
+}
+
+#endif
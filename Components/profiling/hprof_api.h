@@ -0,0 +1,72 @@
+#ifndef _HPROF_API_H_
+#define _HPROF_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Event based sampling profiler using hpm counter overflow interrupt.
+ *
+ * A hpm counter is programmed with the selected event (eg. dcache miss, branch mispredict)
+ * and preloaded to overflow after every `period` events, the overflow interrupt records the
+ * interrupted pc, and optionally the return address, so the hotspot of this event can be
+ * found like `perf record -e <event> -c <period>` on Linux.
+ *
+ * It requires the cpu to support hpm counter overflow interrupt(Sscofpmf like), and it should
+ * not use the same hpm counter as other code such as NMSIS_BENCH_HPM mode of nmsis_bench.h
+ */
+
+// TODO please customize the hpm counter used to do sampling, must be a decimal number 3 - 31
+#ifndef HPROF_HPM_IDX
+#define HPROF_HPM_IDX       10
+#endif
+
+// TODO please customize the interrupt number of hpm counter overflow interrupt of your cpu
+#ifndef HPROF_IRQn
+#define HPROF_IRQn          13
+#endif
+
+/* interrupt level of hpm counter overflow interrupt */
+#ifndef HPROF_IRQ_LEVEL
+#define HPROF_IRQ_LEVEL     1
+#endif
+
+/* max samples can be recorded, each sample is 1 or 2 unsigned long */
+#ifndef HPROF_MAX_SAMPLES
+#define HPROF_MAX_SAMPLES   1024
+#endif
+
+/* record return address of interrupted function together with pc */
+#define HPROF_FLAG_RA       0x1
+
+/*
+ * Start event based sampling
+ * - event: hpm event value, eg. HPM_EVENT(EVENT_SEL_MEMORY_ACCESS, EVENT_MEMORY_ACCESS_DCACHE_MISS, MSU_EVENT_ENABLE)
+ * - period: sample once every period events, must not be 0
+ * - flags: HPROF_FLAG_xxx
+ * return 0 if started, otherwise -1
+ */
+long hprof_start(unsigned long event, unsigned long period, unsigned long flags);
+
+/* Stop event based sampling, recorded samples are kept until next hprof_start */
+void hprof_stop(void);
+
+/* Record a sample, called in hpm counter overflow interrupt */
+void hprof_sample(unsigned long pc, unsigned long ra);
+
+/* - if interface == 0, it will dump hprof data in buffer called hprof_data
+ * - if interface == 1, it will write hprof.out file using open/write api
+ * - otherwise it will dump hprof data in console, use parse.py to convert it into hprof.out
+ * hprof.out can be analyzed by parse_hprof.py
+ */
+long hprof_collect(unsigned long interface);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_HPROF_API_H_ */
@@ -0,0 +1,153 @@
+#!/bin/env python3
+
+import os
+import re
+import sys
+import json
+import struct
+import argparse
+
+BENCH_MAGIC = b"NBRD"
+BENCH_HEADER = struct.Struct("<4sHHII")
+BENCH_RECORD = struct.Struct("<BBHIQQQ")
+BENCH_RECORD_TYPES = {1: "csv", 2: "sum", 3: "stat", 4: "slot"}
+
+
+def extract_bench_data_from_log(logfile):
+    """
+    Extract the hex dumped benchmark data sections from a console log file.
+
+    Args:
+        logfile (str): Path to the log file which contains "Dump benchmark data start" ... "Dump benchmark data finished"
+
+    Returns:
+        list: binary data of each benchmark data section
+    """
+    datastart_pattern = r"Dump\s+benchmark\s+data\s+start"
+    dataend_pattern = r"Dump\s+benchmark\s+data\s+finish"
+
+    sections = []
+    hexstr = None
+    with open(logfile, "r", errors="ignore") as lf:
+        for line in lf.readlines():
+            line = line.strip()
+            if not line:
+                continue
+            if re.search(datastart_pattern, line):
+                hexstr = ""
+                continue
+            if hexstr is None:
+                continue
+            if re.search(dataend_pattern, line) or line.startswith("CREATE"):
+                try:
+                    sections.append(bytes.fromhex(hexstr))
+                except ValueError:
+                    print(f"Error: Invalid hex data in {logfile}")
+                hexstr = None
+                continue
+            hexstr += line
+    return sections
+
+
+def decode_bench_data(data):
+    """
+    Decode benchmark records written by BENCH_FLUSH in nmsis_bench.h
+
+    Args:
+        data (bytes): binary benchmark data
+
+    Returns:
+        dict: decoded header information and records, None if data is invalid
+    """
+    if len(data) < BENCH_HEADER.size:
+        return None
+    magic, version, _, count, dropped = BENCH_HEADER.unpack_from(data, 0)
+    if magic != BENCH_MAGIC:
+        return None
+    offset = BENCH_HEADER.size
+    records = []
+    for _ in range(count):
+        if offset + BENCH_RECORD.size > len(data):
+            print("Error: Truncated benchmark data")
+            break
+        rtype, namelen, hartid, lpcnt, cycle, mincyc, maxcyc = BENCH_RECORD.unpack_from(data, offset)
+        offset += BENCH_RECORD.size
+        name = data[offset:offset + namelen].decode("utf-8", errors="replace")
+        offset += namelen
+        record = {"type": BENCH_RECORD_TYPES.get(rtype, str(rtype)), "name": name, "hartid": hartid,
+                  "loopcnt": lpcnt, "cycle": cycle}
+        if rtype == 4:
+            record["mincyc"] = mincyc
+            record["maxcyc"] = maxcyc
+            record["avgcyc"] = cycle // lpcnt if lpcnt else 0
+        records.append(record)
+    return {"version": version, "dropped": dropped, "records": records}
+
+
+def load_bench_file(benchfile):
+    """
+    Load benchmark data from a binary file generated by BENCH_FLUSH or a console log file
+
+    Args:
+        benchfile (str): Path to bench.bin file or console log file
+
+    Returns:
+        list: decoded benchmark data sections
+    """
+    if not os.path.isfile(benchfile):
+        print(f"{benchfile} does not exist. Please check!")
+        return []
+    with open(benchfile, "rb") as bf:
+        data = bf.read()
+    if data.startswith(BENCH_MAGIC):
+        sections = [data]
+    else:
+        sections = extract_bench_data_from_log(benchfile)
+    decoded = []
+    for section in sections:
+        result = decode_bench_data(section)
+        if result is None:
+            print("Error: Invalid benchmark data, please check!")
+            continue
+        if result["dropped"] > 0:
+            print(f"Warning: {result['dropped']} benchmark records dropped, please increase BENCH_RECORD_NUM", file=sys.stderr)
+        decoded.append(result)
+    return decoded
+
+
+def format_csv(decoded):
+    """ Format decoded benchmark records in the same format as printf output of nmsis_bench.h """
+    lines = []
+    for result in decoded:
+        for rec in result["records"]:
+            if rec["type"] in ("csv", "sum"):
+                lines.append(f"CSV, {rec['name']}, {rec['cycle']}")
+            elif rec["type"] == "stat":
+                lines.append(f"STAT, {rec['name']}, {rec['loopcnt']}, {rec['cycle']}")
+            elif rec["type"] == "slot":
+                lines.append(f"SLOT, {rec['name']}, {rec['loopcnt']}, {rec['cycle']}, {rec['mincyc']}, {rec['maxcyc']}, {rec['avgcyc']}")
+    return "\n".join(lines)
+
+
+# Call in a Project Directory like this
+# NOTE: bench.log is the console log which contains Dump benchmark data start ... Dump benchmark data finished
+# python nuclei_sdk/Components/profiling/parse_bench.py bench.log
+# python nuclei_sdk/Components/profiling/parse_bench.py --format csv bench.bin
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Decode benchmark records dumped by BENCH_FLUSH of nmsis_bench.h")
+    parser.add_argument("benchfile", help="bench.bin file or console log file")
+    parser.add_argument("--format", choices=["json", "csv"], default="json", help="output format")
+    parser.add_argument("--output", help="output file, default print in console")
+    args = parser.parse_args()
+
+    decoded = load_bench_file(args.benchfile)
+    if args.format == "json":
+        content = json.dumps(decoded, indent=2)
+    else:
+        content = format_csv(decoded)
+    if args.output:
+        with open(args.output, "w") as of:
+            of.write(content + "\n")
+        print(f"Generating {args.output}")
+    else:
+        print(content)
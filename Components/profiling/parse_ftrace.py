@@ -0,0 +1,146 @@
+#!/bin/env python3
+
+import os
+import sys
+import json
+import struct
+import bisect
+import argparse
+import subprocess
+
+FTRACE_MAGIC = b"NFTR"
+FTRACE_HEADER = struct.Struct("<4sHHII")
+FTRACE_EXIT_FLAG = 0x1
+
+
+def decode_ftrace_data(data):
+    """
+    Decode ring buffers written by ftrace_collect in ftrace.c
+
+    Args:
+        data (bytes): binary ftrace data
+
+    Returns:
+        list: per hart dict with hartid and records as (pc, is_exit, cycle) tuples in time order,
+              cycle is relative to the oldest record, None if data is invalid
+    """
+    if len(data) < FTRACE_HEADER.size:
+        return None
+    magic, _, xlenbytes, harts, size = FTRACE_HEADER.unpack_from(data, 0)
+    if magic != FTRACE_MAGIC or xlenbytes not in (4, 8):
+        return None
+    wordfmt = "I" if xlenbytes == 4 else "Q"
+    ringhdr = struct.Struct("<II" + wordfmt)
+    record = struct.Struct("<" + wordfmt * 2)
+    offset = FTRACE_HEADER.size
+    rings = []
+    for _ in range(harts):
+        if offset + ringhdr.size + record.size * size > len(data):
+            print("Error: Truncated ftrace data")
+            break
+        hartid, head, _ = ringhdr.unpack_from(data, offset)
+        recbase = offset + ringhdr.size
+        valid = min(head, size)
+        records = []
+        cycle = 0
+        for i in range(head - valid, head):
+            pc, delta = record.unpack_from(data, recbase + (i % size) * record.size)
+            # delta of the oldest record refers to an overwritten one
+            if records:
+                cycle += delta
+            records.append((pc & ~FTRACE_EXIT_FLAG, bool(pc & FTRACE_EXIT_FLAG), cycle))
+        if head > size:
+            print(f"Warning: hart {hartid} overwritten {head - size} records, please increase FTRACE_RING_SIZE", file=sys.stderr)
+        rings.append({"hartid": hartid, "records": records})
+        offset = recbase + record.size * size
+    return rings
+
+
+def load_symbols(elffile, nm):
+    """
+    Load function symbols of elf file using nm tool
+
+    Returns:
+        dict: function address to name
+    """
+    try:
+        output = subprocess.check_output([nm, "-n", "-C", elffile], universal_newlines=True)
+    except (OSError, subprocess.CalledProcessError) as exc:
+        print(f"Error: Unable to run {nm} on {elffile}: {exc}")
+        return {}
+    symbols = {}
+    for line in output.splitlines():
+        parts = line.split(None, 2)
+        if len(parts) == 3 and parts[1] in ("T", "t", "W", "w"):
+            symbols.setdefault(int(parts[0], 16), parts[2])
+    return symbols
+
+
+def symbol_name(symbols, pc):
+    return symbols.get(pc, f"0x{pc:x}")
+
+
+def format_chrome(rings, symbols, freq):
+    """ Convert records into chrome trace event format, open it in chrome://tracing or https://ui.perfetto.dev """
+    events = []
+    scale = 1000000.0 / freq if freq else 1.0
+    for ring in rings:
+        for pc, is_exit, cycle in ring["records"]:
+            events.append({"name": symbol_name(symbols, pc), "ph": "E" if is_exit else "B",
+                           "ts": cycle * scale, "pid": 0, "tid": ring["hartid"]})
+    return json.dumps({"traceEvents": events, "displayTimeUnit": "ns"}, indent=1)
+
+
+def format_folded(rings, symbols):
+    """ Convert records into folded stacks with self cycles, used by flamegraph.pl or speedscope """
+    folded = {}
+    for ring in rings:
+        stack = []
+        lastcyc = 0
+        for pc, is_exit, cycle in ring["records"]:
+            if stack:
+                key = ";".join(stack)
+                folded[key] = folded.get(key, 0) + cycle - lastcyc
+            lastcyc = cycle
+            name = symbol_name(symbols, pc)
+            if not is_exit:
+                stack.append(name)
+            elif name in stack:
+                # unwind to the exited function, stack may start in the middle of a call chain
+                del stack[len(stack) - 1 - stack[::-1].index(name):]
+    return "\n".join(f"{key} {value}" for key, value in folded.items() if value > 0)
+
+
+# Call in a Project Directory like this
+# NOTE: ftrace.out is generated by ftrace_collect(1) or by parse.py from console log of ftrace_collect(2)
+# python nuclei_sdk/Components/profiling/parse_ftrace.py --elf build/app.elf --freq 16000000 ftrace.out > trace.json
+# python nuclei_sdk/Components/profiling/parse_ftrace.py --elf build/app.elf --format folded ftrace.out > ftrace.folded
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Convert ftrace.out generated by ftrace.c into chrome trace or flame graph format")
+    parser.add_argument("ftracefile", help="ftrace.out file")
+    parser.add_argument("--elf", help="elf file of the traced program, used to map pc to function")
+    parser.add_argument("--nm", default="riscv64-unknown-elf-nm", help="nm tool used to read symbols of elf file")
+    parser.add_argument("--format", choices=["chrome", "folded"], default="chrome", help="output format")
+    parser.add_argument("--freq", type=int, default=0, help="cpu frequency in Hz, used to convert cycles to us in chrome trace, default use cycles")
+    parser.add_argument("--output", help="output file, default print in console")
+    args = parser.parse_args()
+
+    if not os.path.isfile(args.ftracefile):
+        print(f"{args.ftracefile} does not exist. Please check!")
+        sys.exit(1)
+    with open(args.ftracefile, "rb") as ff:
+        rings = decode_ftrace_data(ff.read())
+    if rings is None:
+        print("Error: Invalid ftrace data, please check!")
+        sys.exit(1)
+    symbols = load_symbols(args.elf, args.nm) if args.elf else {}
+    if args.format == "chrome":
+        content = format_chrome(rings, symbols, args.freq)
+    else:
+        content = format_folded(rings, symbols)
+    if args.output:
+        with open(args.output, "w") as of:
+            of.write(content + "\n")
+        print(f"Generating {args.output}")
+    else:
+        print(content)
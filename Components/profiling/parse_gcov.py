@@ -0,0 +1,221 @@
+#!/bin/env python3
+
+import os
+import re
+import sys
+import glob
+import struct
+import argparse
+
+GCOV_DATA_MAGIC = 0x67636461
+GCOV_TAG_FUNCTION = 0x01000000
+GCOV_TAG_COUNTER_BASE = 0x01a10000
+GCOV_DELTA_MAGIC = b"NGCD"
+
+
+def read_varint(data, offset):
+    """ Read a LEB128 varint, return value and next offset """
+    value = 0
+    shift = 0
+    while True:
+        if offset >= len(data):
+            raise ValueError("Truncated varint")
+        byte = data[offset]
+        offset += 1
+        value |= (byte & 0x7f) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, offset
+
+
+def extract_delta_from_log(logfile):
+    """
+    Extract the hex dumped coverage delta sections from a console log file.
+
+    Returns:
+        list: binary data of each delta snapshot
+    """
+    sections = []
+    hexstr = None
+    with open(logfile, "r", errors="ignore") as lf:
+        for line in lf.readlines():
+            line = line.strip()
+            if not line:
+                continue
+            if re.search(r"Dump\s+coverage\s+delta\s+start", line):
+                hexstr = ""
+                continue
+            if hexstr is None:
+                continue
+            if re.search(r"Dump\s+coverage\s+delta\s+finish", line) or line.startswith("CREATE"):
+                try:
+                    sections.append(bytes.fromhex(hexstr))
+                except ValueError:
+                    print(f"Error: Invalid hex data in {logfile}")
+                hexstr = None
+                continue
+            hexstr += line
+    return sections
+
+
+def decode_delta(data):
+    """
+    Decode a coverage delta snapshot emitted by gcov_delta_dump in gcov.c
+
+    Returns:
+        dict: snapshot information and per file functions, None if data is invalid
+    """
+    if not data.startswith(GCOV_DELTA_MAGIC):
+        return None
+    off = len(GCOV_DELTA_MAGIC)
+    snapshot = {}
+    for key in ("version", "seq", "unitsize", "checksum", "counters"):
+        snapshot[key], off = read_varint(data, off)
+    files = []
+    while True:
+        marker, off = read_varint(data, off)
+        if marker == 0:
+            break
+        namelen, off = read_varint(data, off)
+        name = data[off:off + namelen].decode("utf-8", errors="replace")
+        off += namelen
+        gcdafile = {"filename": name, "functions": []}
+        for key in ("version", "stamp", "additive", "active"):
+            gcdafile[key], off = read_varint(data, off)
+        types = [t for t in range(snapshot["counters"]) if gcdafile["active"] & (1 << t)]
+        while True:
+            fnidx, off = read_varint(data, off)
+            if fnidx == 0:
+                break
+            func = {"counters": {}}
+            for key in ("ident", "lineno_checksum", "cfg_checksum"):
+                func[key], off = read_varint(data, off)
+            for ctype in types:
+                num, off = read_varint(data, off)
+                values = [0] * num
+                pos = 0
+                while pos < num:
+                    zeros, off = read_varint(data, off)
+                    run, off = read_varint(data, off)
+                    pos += zeros
+                    for _ in range(run):
+                        values[pos], off = read_varint(data, off)
+                        pos += 1
+                func["counters"][ctype] = values
+            gcdafile["functions"].append(func)
+        files.append(gcdafile)
+    snapshot["files"] = files
+    return snapshot
+
+
+def read_gcda(gcdafile, unitsize, checksum):
+    """ Read an existing gcda file, return header and functions keyed by ident """
+    with open(gcdafile, "rb") as gf:
+        data = gf.read()
+    words = struct.unpack_from(f"<{len(data) // 4}I", data, 0)
+    if not words or words[0] != GCOV_DATA_MAGIC:
+        return None
+    pos = 4 if checksum else 3
+    header = {"version": words[1], "stamp": words[2]}
+    functions = {}
+    func = None
+    while pos + 1 < len(words):
+        tag, length = words[pos], words[pos + 1]
+        # length is in bytes since gcc 12, otherwise in words
+        nwords = length // 4 if unitsize == 4 else length
+        body = words[pos + 2:pos + 2 + nwords]
+        pos += 2 + nwords
+        if tag == GCOV_TAG_FUNCTION and len(body) >= 3:
+            func = {"ident": body[0], "lineno_checksum": body[1], "cfg_checksum": body[2], "counters": {}}
+            functions[body[0]] = func
+        elif func is not None and tag >= GCOV_TAG_COUNTER_BASE and (tag - GCOV_TAG_COUNTER_BASE) % (1 << 17) == 0:
+            ctype = (tag - GCOV_TAG_COUNTER_BASE) >> 17
+            func["counters"][ctype] = [body[i] | (body[i + 1] << 32) for i in range(0, len(body) - 1, 2)]
+    return header, functions
+
+
+def write_gcda(gcdafile, header, functions, unitsize, checksum):
+    """ Write functions into gcda file in the same format as convert_to_gcda in gcov.c """
+    words = [GCOV_DATA_MAGIC, header["version"], header["stamp"]]
+    if checksum:
+        words.append(0)
+    for func in functions.values():
+        words += [GCOV_TAG_FUNCTION, 3 * unitsize, func["ident"], func["lineno_checksum"], func["cfg_checksum"]]
+        for ctype in sorted(func["counters"]):
+            values = func["counters"][ctype]
+            words += [GCOV_TAG_COUNTER_BASE + (ctype << 17), len(values) * 2 * unitsize]
+            for value in values:
+                value &= 0xffffffffffffffff
+                words += [value & 0xffffffff, value >> 32]
+    dirname = os.path.dirname(gcdafile)
+    if dirname and not os.path.isdir(dirname):
+        os.makedirs(dirname)
+    with open(gcdafile, "wb") as gf:
+        gf.write(struct.pack(f"<{len(words)}I", *words))
+
+
+def merge_snapshots(snapshots, outdir, reset):
+    """ Merge delta snapshots in sequence order into gcda files, additive counters are summed """
+    merged = {}
+    for snapshot in sorted(snapshots, key=lambda s: s["seq"]):
+        for gcdafile in snapshot["files"]:
+            path = gcdafile["filename"]
+            if outdir:
+                path = os.path.join(outdir, os.path.basename(path))
+            if path not in merged:
+                existing = None
+                if not reset and os.path.isfile(path):
+                    existing = read_gcda(path, snapshot["unitsize"], snapshot["checksum"])
+                    if existing and existing[0]["stamp"] != gcdafile["stamp"]:
+                        print(f"Warning: {path} is generated by a different build, ignore it", file=sys.stderr)
+                        existing = None
+                header = {"version": gcdafile["version"], "stamp": gcdafile["stamp"]}
+                merged[path] = {"header": header, "functions": existing[1] if existing else {},
+                                "unitsize": snapshot["unitsize"], "checksum": snapshot["checksum"]}
+            functions = merged[path]["functions"]
+            for func in gcdafile["functions"]:
+                old = functions.get(func["ident"])
+                if old is None or old["cfg_checksum"] != func["cfg_checksum"]:
+                    functions[func["ident"]] = func
+                    continue
+                for ctype, values in func["counters"].items():
+                    oldvalues = old["counters"].get(ctype)
+                    if (gcdafile["additive"] & (1 << ctype)) and oldvalues and len(oldvalues) == len(values):
+                        old["counters"][ctype] = [a + b for a, b in zip(oldvalues, values)]
+                    else:
+                        old["counters"][ctype] = values
+    for path, gcda in merged.items():
+        write_gcda(path, gcda["header"], gcda["functions"], gcda["unitsize"], gcda["checksum"])
+        print(f"Generating {path}, {len(gcda['functions'])} functions")
+
+
+# Call in a Project Directory like this
+# NOTE: soak.log is the console log which contains Dump coverage delta start ... Dump coverage delta finish
+# python nuclei_sdk/Components/profiling/parse_gcov.py soak.log
+# python nuclei_sdk/Components/profiling/parse_gcov.py gcov_delta_*.bin
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Merge coverage delta snapshots dumped by gcov_delta_dump of gcov.c into gcda files")
+    parser.add_argument("files", nargs="+", help="console log files or gcov_delta_<seq>.bin files")
+    parser.add_argument("--outdir", help="directory to store gcda files, default use the path recorded in snapshot")
+    parser.add_argument("--reset", action="store_true", help="do not merge into existing gcda files")
+    args = parser.parse_args()
+
+    snapshots = []
+    for pattern in args.files:
+        for deltafile in (glob.glob(pattern) or [pattern]):
+            if not os.path.isfile(deltafile):
+                print(f"{deltafile} does not exist. Please check!")
+                continue
+            with open(deltafile, "rb") as df:
+                data = df.read()
+            sections = [data] if data.startswith(GCOV_DELTA_MAGIC) else extract_delta_from_log(deltafile)
+            for section in sections:
+                try:
+                    snapshot = decode_delta(section)
+                except ValueError:
+                    snapshot = None
+                if snapshot is None:
+                    print(f"Error: Invalid coverage delta data in {deltafile}, please check!")
+                    continue
+                snapshots.append(snapshot)
+    merge_snapshots(snapshots, args.outdir, args.reset)
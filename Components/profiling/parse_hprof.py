@@ -0,0 +1,122 @@
+#!/bin/env python3
+
+import os
+import sys
+import struct
+import bisect
+import argparse
+import subprocess
+
+HPROF_MAGIC = b"NHPF"
+HPROF_HEADER = struct.Struct("<4sHHIIIIII")
+HPROF_FLAG_RA = 0x1
+
+
+def decode_hprof_data(data):
+    """
+    Decode samples written by hprof_collect in hprof.c
+
+    Args:
+        data (bytes): binary hprof data
+
+    Returns:
+        dict: decoded header information and samples as (pc, ra) tuples, None if data is invalid
+    """
+    if len(data) < HPROF_HEADER.size:
+        return None
+    magic, version, xlenbytes, flags, count, dropped, event, period, _ = HPROF_HEADER.unpack_from(data, 0)
+    if magic != HPROF_MAGIC or xlenbytes not in (4, 8):
+        return None
+    word = struct.Struct("<I" if xlenbytes == 4 else "<Q")
+    width = 2 if flags & HPROF_FLAG_RA else 1
+    offset = HPROF_HEADER.size
+    samples = []
+    for _ in range(count):
+        if offset + word.size * width > len(data):
+            print("Error: Truncated hprof data")
+            break
+        pc = word.unpack_from(data, offset)[0]
+        ra = word.unpack_from(data, offset + word.size)[0] if width == 2 else None
+        offset += word.size * width
+        samples.append((pc, ra))
+    return {"version": version, "xlenbytes": xlenbytes, "flags": flags, "dropped": dropped,
+            "event": event, "period": period, "samples": samples}
+
+
+def load_symbols(elffile, nm):
+    """
+    Load function symbols of elf file using nm tool
+
+    Returns:
+        tuple: sorted symbol addresses and names
+    """
+    try:
+        output = subprocess.check_output([nm, "-n", "-C", elffile], universal_newlines=True)
+    except (OSError, subprocess.CalledProcessError) as exc:
+        print(f"Error: Unable to run {nm} on {elffile}: {exc}")
+        return [], []
+    addrs = []
+    names = []
+    for line in output.splitlines():
+        parts = line.split(None, 2)
+        if len(parts) != 3 or parts[1] not in ("T", "t", "W", "w"):
+            continue
+        addrs.append(int(parts[0], 16))
+        names.append(parts[2])
+    return addrs, names
+
+
+def lookup_symbol(symbols, addr):
+    """ Find the function which contains addr, return hex address if not found """
+    addrs, names = symbols
+    idx = bisect.bisect_right(addrs, addr) - 1
+    if idx < 0:
+        return f"0x{addr:x}"
+    return names[idx]
+
+
+def report_hprof(result, symbols, top):
+    """ Format hotspot report of decoded hprof samples, sorted by sample count """
+    samples = result["samples"]
+    total = len(samples)
+    lines = [f"Event 0x{result['event']:x}, period {result['period']}, samples {total}, dropped {result['dropped']}"]
+    if total == 0:
+        return "\n".join(lines)
+    hits = {}
+    callers = {}
+    for pc, ra in samples:
+        func = lookup_symbol(symbols, pc)
+        hits[func] = hits.get(func, 0) + 1
+        if ra is not None:
+            caller = lookup_symbol(symbols, ra)
+            callers.setdefault(func, {})
+            callers[func][caller] = callers[func].get(caller, 0) + 1
+    lines.append("HPROF, percent, samples, events, function")
+    for func, cnt in sorted(hits.items(), key=lambda item: item[1], reverse=True)[:top]:
+        lines.append(f"HPROF, {cnt * 100.0 / total:.2f}%, {cnt}, {cnt * result['period']}, {func}")
+        for caller, ccnt in sorted(callers.get(func, {}).items(), key=lambda item: item[1], reverse=True):
+            lines.append(f"    {ccnt * 100.0 / cnt:.2f}% <- {caller}")
+    return "\n".join(lines)
+
+
+# Call in a Project Directory like this
+# NOTE: hprof.out is generated by hprof_collect(1) or by parse.py from console log of hprof_collect(2)
+# python nuclei_sdk/Components/profiling/parse_hprof.py --elf build/app.elf hprof.out
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Report hotspots of hprof.out generated by hprof.c")
+    parser.add_argument("hproffile", help="hprof.out file")
+    parser.add_argument("--elf", help="elf file of the profiled program, used to map pc to function")
+    parser.add_argument("--nm", default="riscv64-unknown-elf-nm", help="nm tool used to read symbols of elf file")
+    parser.add_argument("--top", type=int, default=20, help="show top N functions")
+    args = parser.parse_args()
+
+    if not os.path.isfile(args.hproffile):
+        print(f"{args.hproffile} does not exist. Please check!")
+        sys.exit(1)
+    with open(args.hproffile, "rb") as hf:
+        result = decode_hprof_data(hf.read())
+    if result is None:
+        print("Error: Invalid hprof data, please check!")
+        sys.exit(1)
+    symbols = load_symbols(args.elf, args.nm) if args.elf else ([], [])
+    print(report_hprof(result, symbols, args.top))
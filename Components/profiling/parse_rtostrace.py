@@ -0,0 +1,250 @@
+#!/bin/env python3
+
+import os
+import sys
+import json
+import struct
+import argparse
+
+RTOSTRACE_MAGIC = b"NRTR"
+RTOSTRACE_HEADER = struct.Struct("<4sHHIIIIII")
+
+# event ids, same as rtostrace_api.h
+TASK_SWITCHED_IN = 1
+TASK_SWITCHED_OUT = 2
+TASK_READY = 3
+TASK_PRIO_INHERIT = 4
+TASK_PRIO_DISINHERIT = 5
+ISR_ENTER = 6
+ISR_EXIT = 7
+TICK = 8
+QUEUE_CREATE = 9
+QUEUE_SEND = 10
+QUEUE_SEND_FAILED = 11
+QUEUE_BLOCK_SEND = 12
+QUEUE_RECEIVE = 13
+QUEUE_RECEIVE_FAILED = 14
+QUEUE_BLOCK_RECEIVE = 15
+USER = 0x100
+
+QUEUE_EVENTS = {
+    QUEUE_SEND: "send", QUEUE_SEND_FAILED: "send failed", QUEUE_BLOCK_SEND: "block on send",
+    QUEUE_RECEIVE: "receive", QUEUE_RECEIVE_FAILED: "receive failed", QUEUE_BLOCK_RECEIVE: "block on receive",
+}
+# queueQUEUE_TYPE_* of FreeRTOS queue.h
+QUEUE_TYPES = {0: "queue", 1: "mutex", 2: "counting semaphore", 3: "binary semaphore", 4: "recursive mutex", 5: "queue set"}
+
+
+def decode_rtostrace_data(data):
+    """
+    Decode name table and ring buffers written by rtostrace_collect in rtostrace.c
+
+    Args:
+        data (bytes): binary rtostrace data
+
+    Returns:
+        tuple: (freq, names, rings), names is a dict of object to name, rings is a list of
+               per hart dict with hartid and records as (cycle, event, arg, obj) tuples in time order,
+               cycle is unwrapped from the low 32 bits, None if data is invalid
+    """
+    if len(data) < RTOSTRACE_HEADER.size:
+        return None
+    magic, _, xlenbytes, harts, size, namecnt, namelen, freq, _ = RTOSTRACE_HEADER.unpack_from(data, 0)
+    if magic != RTOSTRACE_MAGIC or xlenbytes not in (4, 8):
+        return None
+    wordfmt = "I" if xlenbytes == 4 else "Q"
+    nameent = struct.Struct(f"<{wordfmt}{namelen}s")
+    ringhdr = struct.Struct("<II")
+    record = struct.Struct("<IHH" + wordfmt)
+    offset = RTOSTRACE_HEADER.size
+    names = {}
+    for _ in range(namecnt):
+        obj, name = nameent.unpack_from(data, offset)
+        if obj != 0:
+            names[obj] = name.split(b"\0", 1)[0].decode("utf-8", "replace")
+        offset += nameent.size
+    rings = []
+    for _ in range(harts):
+        if offset + ringhdr.size + record.size * size > len(data):
+            print("Error: Truncated rtostrace data", file=sys.stderr)
+            break
+        hartid, head = ringhdr.unpack_from(data, offset)
+        recbase = offset + ringhdr.size
+        valid = min(head, size)
+        records = []
+        cycle = None
+        last = 0
+        for i in range(head - valid, head):
+            low, event, arg, obj = record.unpack_from(data, recbase + (i % size) * record.size)
+            # keep the low 32 bits of the oldest record, so harts are still aligned
+            cycle = low if cycle is None else cycle + ((low - last) & 0xFFFFFFFF)
+            last = low
+            records.append((cycle, event, arg, obj))
+        if head > size:
+            print(f"Warning: oldest {head - size} records of hart {hartid} are overwritten, increase RTOSTRACE_RING_SIZE to keep more", file=sys.stderr)
+        rings.append({"hartid": hartid, "records": records})
+        offset = recbase + record.size * size
+    return freq, names, rings
+
+
+def object_name(names, obj, kind):
+    return names.get(obj, f"{kind}@0x{obj:x}")
+
+
+def format_chrome(rings, names, freq):
+    """ Convert records into chrome trace event format, open it in https://ui.perfetto.dev or chrome://tracing """
+    events = []
+    scale = 1000000.0 / freq if freq else 1.0
+    queuetypes = {}
+    starts = [ring["records"][0][0] for ring in rings if ring["records"]]
+    base = min(starts) if starts else 0
+
+    def ts(cycle):
+        return (cycle - base) * scale
+
+    for ring in rings:
+        pid = ring["hartid"]
+        events.append({"name": "process_name", "ph": "M", "pid": pid, "args": {"name": f"hart {pid}"}})
+        for tid, name in ((0, "tasks"), (1, "interrupts"), (2, "events")):
+            events.append({"name": "thread_name", "ph": "M", "pid": pid, "tid": tid, "args": {"name": name}})
+        records = ring["records"]
+        if not records:
+            continue
+        running = None
+        isrstack = []
+        for cycle, event, arg, obj in records:
+            if event in (TASK_SWITCHED_IN, TASK_SWITCHED_OUT):
+                # task running before the oldest record is shown from the oldest record
+                if running is None and event == TASK_SWITCHED_OUT:
+                    running = (records[0][0], obj, arg)
+                if running is not None:
+                    start, task, prio = running
+                    events.append({"name": object_name(names, task, "task"), "ph": "X", "ts": ts(start),
+                                   "dur": (cycle - start) * scale, "pid": pid, "tid": 0, "args": {"priority": prio}})
+                running = (cycle, obj, arg) if event == TASK_SWITCHED_IN else None
+            elif event == ISR_ENTER:
+                isrstack.append((cycle, arg))
+            elif event == ISR_EXIT:
+                start, irq = isrstack.pop() if isrstack else (records[0][0], arg)
+                events.append({"name": f"irq {irq}", "ph": "X", "ts": ts(start), "dur": (cycle - start) * scale,
+                               "pid": pid, "tid": 1})
+            elif event == QUEUE_CREATE:
+                queuetypes[obj] = QUEUE_TYPES.get(arg, "queue")
+            elif event in QUEUE_EVENTS:
+                kind = queuetypes.get(obj, "queue")
+                events.append({"name": f"{QUEUE_EVENTS[event]} {object_name(names, obj, kind)}", "ph": "i", "s": "t",
+                               "ts": ts(cycle), "pid": pid, "tid": 2, "args": {"waiting": arg, "type": kind}})
+            elif event in (TASK_READY, TASK_PRIO_INHERIT, TASK_PRIO_DISINHERIT):
+                label = {TASK_READY: "ready", TASK_PRIO_INHERIT: "inherit", TASK_PRIO_DISINHERIT: "disinherit"}[event]
+                events.append({"name": f"{label} {object_name(names, obj, 'task')}", "ph": "i", "s": "t",
+                               "ts": ts(cycle), "pid": pid, "tid": 2, "args": {"priority": arg}})
+            elif event >= USER:
+                events.append({"name": f"user {event - USER}", "ph": "i", "s": "t", "ts": ts(cycle),
+                               "pid": pid, "tid": 2, "args": {"arg": arg, "obj": f"0x{obj:x}"}})
+        last = records[-1][0]
+        if running is not None:
+            start, task, prio = running
+            events.append({"name": object_name(names, task, "task"), "ph": "X", "ts": ts(start),
+                           "dur": (last - start) * scale, "pid": pid, "tid": 0, "args": {"priority": prio}})
+        for start, irq in isrstack:
+            events.append({"name": f"irq {irq}", "ph": "X", "ts": ts(start), "dur": (last - start) * scale, "pid": pid, "tid": 1})
+    return json.dumps({"traceEvents": events, "displayTimeUnit": "ns"}, indent=1)
+
+
+def format_report(rings, names, freq, top):
+    """ Report cpu usage of tasks, interrupt durations, the longest ready to running latencies and priority inheritances """
+    def fmt(cycles):
+        return f"{cycles} cycles ({cycles * 1000000.0 / freq:.2f} us)" if freq else f"{cycles} cycles"
+
+    # tasks can migrate between harts in SMP, so ready and running are matched in the merged timeline
+    merged = sorted((rec + (ring["hartid"],) for ring in rings for rec in ring["records"]), key=lambda rec: rec[0])
+    if not merged:
+        return "No records"
+    span = merged[-1][0] - merged[0][0]
+    runtime = {}
+    irqtime = {}
+    readysince = {}
+    latencies = []
+    inherits = {}
+    inversions = []
+    running = {}
+    isrstacks = {}
+    for cycle, event, arg, obj, hart in merged:
+        if event == TASK_SWITCHED_IN:
+            running[hart] = (cycle, obj)
+            if obj in readysince:
+                latencies.append((cycle - readysince[obj][0], obj, readysince[obj][1], readysince[obj][0]))
+                del readysince[obj]
+        elif event == TASK_SWITCHED_OUT:
+            if hart in running:
+                start, task = running.pop(hart)
+                entry = runtime.setdefault(task, [0, 0, 0])
+                entry[0] += 1
+                entry[1] += cycle - start
+                entry[2] = max(entry[2], cycle - start)
+        elif event == TASK_READY:
+            readysince.setdefault(obj, (cycle, arg))
+        elif event == ISR_ENTER:
+            isrstacks.setdefault(hart, []).append((cycle, arg))
+        elif event == ISR_EXIT and isrstacks.get(hart):
+            start, irq = isrstacks[hart].pop()
+            entry = irqtime.setdefault(irq, [0, 0, 0])
+            entry[0] += 1
+            entry[1] += cycle - start
+            entry[2] = max(entry[2], cycle - start)
+        elif event == TASK_PRIO_INHERIT:
+            inherits.setdefault(obj, (cycle, arg))
+        elif event == TASK_PRIO_DISINHERIT and obj in inherits:
+            start, prio = inherits.pop(obj)
+            inversions.append((cycle - start, obj, prio, start))
+
+    base = merged[0][0]
+    lines = [f"Trace span: {fmt(span)}, {len(merged)} records", "", "Tasks:"]
+    for task, (count, total, longest) in sorted(runtime.items(), key=lambda item: -item[1][1]):
+        usage = 100.0 * total / span if span else 0
+        lines.append(f"  {object_name(names, task, 'task'):<24} runs {count:<8} cpu {usage:6.2f}%  longest run {fmt(longest)}")
+    lines += ["", "Interrupts:"]
+    for irq, (count, total, longest) in sorted(irqtime.items()):
+        lines.append(f"  irq {irq:<20} count {count:<7} total {fmt(total)}  longest {fmt(longest)}")
+    lines += ["", f"Top {top} ready to running latencies:"]
+    for latency, task, prio, start in sorted(latencies, reverse=True)[:top]:
+        lines.append(f"  {object_name(names, task, 'task'):<24} priority {prio:<3} at {fmt(start - base)}: {fmt(latency)}")
+    lines += ["", "Priority inheritances, mutex holder running with inherited priority:"]
+    for duration, task, prio, start in sorted(inversions, reverse=True)[:top]:
+        lines.append(f"  {object_name(names, task, 'task'):<24} priority {prio:<3} at {fmt(start - base)}: {fmt(duration)}")
+    return "\n".join(lines)
+
+
+# Call in a Project Directory like this
+# NOTE: rtostrace.out is generated by rtostrace_collect(1) or by parse.py from console log of rtostrace_collect(2)
+# python nuclei_sdk/Components/profiling/parse_rtostrace.py rtostrace.out > trace.json
+# python nuclei_sdk/Components/profiling/parse_rtostrace.py --format report rtostrace.out
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Convert rtostrace.out generated by rtostrace.c into chrome trace or latency report")
+    parser.add_argument("tracefile", help="rtostrace.out file")
+    parser.add_argument("--format", choices=["chrome", "report"], default="chrome", help="output format")
+    parser.add_argument("--freq", type=int, default=0, help="cpu frequency in Hz, default use the one recorded in trace data")
+    parser.add_argument("--top", type=int, default=10, help="count of the longest latencies listed in report")
+    parser.add_argument("--output", help="output file, default print in console")
+    args = parser.parse_args()
+
+    if not os.path.isfile(args.tracefile):
+        print(f"{args.tracefile} does not exist. Please check!")
+        sys.exit(1)
+    with open(args.tracefile, "rb") as tf:
+        decoded = decode_rtostrace_data(tf.read())
+    if decoded is None:
+        print("Error: Invalid rtostrace data, please check!")
+        sys.exit(1)
+    freq, names, rings = decoded
+    freq = args.freq if args.freq else freq
+    if args.format == "chrome":
+        content = format_chrome(rings, names, freq)
+    else:
+        content = format_report(rings, names, freq, args.top)
+    if args.output:
+        with open(args.output, "w") as of:
+            of.write(content + "\n")
+        print(f"Generating {args.output}")
+    else:
+        print(content)
@@ -0,0 +1,123 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <string.h>
+#include "prof_stream.h"
+#if defined(NUCLEI_RTT) && (NUCLEI_RTT == 1)
+#include "rtt_api.h"
+#endif
+
+/* Mailbox used by PROF_STREAM_MAILBOX interface */
+prof_mailbox_t prof_mailbox = {0, 0, 0, NULL, NULL};
+
+/* Keep this function not inlined, debugger set breakpoint here */
+__attribute__((noinline)) void prof_mailbox_flush(void)
+{
+    __asm volatile("" ::: "memory");
+}
+
+#define NUM_OCTETS_PER_LINE 20
+#define FLUSH_OUTPUT()      fflush(stdout)
+static void hexdumpbuf(const uint8_t *buf, unsigned long sz)
+{
+    unsigned long rem, cur = 0, i = 0;
+
+    FLUSH_OUTPUT();
+
+    while (cur < sz) {
+        rem = ((sz - cur) < NUM_OCTETS_PER_LINE) ? (sz - cur) : NUM_OCTETS_PER_LINE;
+        for (i = 0; i < rem; i++) {
+            printf("%02x", buf[cur + i]);
+        }
+        printf("\n");
+        FLUSH_OUTPUT();
+        cur += rem;
+    }
+}
+
+static void prof_stream_flush(prof_stream_t *stream)
+{
+    if (stream->pos == 0) {
+        return;
+    }
+    if (stream->interface == PROF_STREAM_FILE) {
+        write(stream->fd, (const char *)stream->chunk, stream->pos);
+    } else if (stream->interface == PROF_STREAM_MAILBOX) {
+        prof_mailbox.filename = stream->filename;
+        prof_mailbox.offset = stream->offset;
+        prof_mailbox.size = stream->pos;
+        prof_mailbox.buf = stream->chunk;
+        prof_mailbox.state = 1;
+        prof_mailbox_flush();
+        // wait for debugger to take the chunk
+        while (prof_mailbox.state != 0);
+#if defined(NUCLEI_RTT) && (NUCLEI_RTT == 1)
+    } else if (stream->interface == PROF_STREAM_RTT) {
+        rtt_file_write(stream->filename, stream->offset, stream->chunk, stream->pos);
+#endif
+    } else {
+        hexdumpbuf(stream->chunk, stream->pos);
+    }
+    stream->offset += stream->pos;
+    stream->pos = 0;
+}
+
+int prof_stream_open(prof_stream_t *stream, unsigned long interface, const char *filename)
+{
+    stream->interface = interface;
+    stream->filename = filename;
+    stream->fd = -1;
+    stream->offset = 0;
+    stream->pos = 0;
+    if (interface == PROF_STREAM_FILE) {
+        stream->fd = open(filename, O_CREAT | O_TRUNC | O_WRONLY, 0666);
+        if (stream->fd < 0) {
+            printf("Unable to open %s\n", filename);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void prof_stream_write(prof_stream_t *stream, const void *data, size_t len)
+{
+    const uint8_t *ptr = (const uint8_t *)data;
+    size_t rem;
+
+    while (len > 0) {
+        rem = PROF_STREAM_CHUNK_SIZE - stream->pos;
+        if (rem > len) {
+            rem = len;
+        }
+        memcpy(stream->chunk + stream->pos, ptr, rem);
+        stream->pos += rem;
+        ptr += rem;
+        len -= rem;
+        if (stream->pos == PROF_STREAM_CHUNK_SIZE) {
+            prof_stream_flush(stream);
+        }
+    }
+}
+
+int prof_stream_close(prof_stream_t *stream)
+{
+    prof_stream_flush(stream);
+    if (stream->interface == PROF_STREAM_FILE) {
+        if (stream->fd >= 0) {
+            close(stream->fd);
+        }
+        stream->fd = -1;
+    } else if (stream->interface == PROF_STREAM_MAILBOX) {
+        printf("Send %s done, %lu bytes!\n", stream->filename, (unsigned long)stream->offset);
+#if defined(NUCLEI_RTT) && (NUCLEI_RTT == 1)
+    } else if (stream->interface == PROF_STREAM_RTT) {
+        // empty record marks end of file
+        rtt_file_write(stream->filename, stream->offset, NULL, 0);
+        printf("Send %s done, %lu bytes!\n", stream->filename, (unsigned long)stream->offset);
+#endif
+    } else {
+        printf("\nCREATE: %s\n", stream->filename);
+    }
+    return 0;
+}
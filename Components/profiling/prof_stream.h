@@ -0,0 +1,77 @@
+#ifndef _PROF_STREAM_H_
+#define _PROF_STREAM_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Streaming emitter used by gprof_collect and gcov_collect
+ *
+ * Profiling and coverage data are serialized into a fixed size chunk buffer, and each full
+ * chunk is flushed to the selected interface directly, so no buffer of the whole gmon.out or
+ * gcda image is required, the ram cost is bounded by PROF_STREAM_CHUNK_SIZE.
+ */
+
+/* chunk buffer size in bytes */
+#ifndef PROF_STREAM_CHUNK_SIZE
+#define PROF_STREAM_CHUNK_SIZE      256
+#endif
+
+/* Interfaces supported by streaming emitter, interface 0 stores whole image in heap buffer */
+#define PROF_STREAM_FILE            1   /* write file using open/write api, eg. semihosting */
+#define PROF_STREAM_CONSOLE         2   /* hex dump in console, use parse.py to convert it */
+#define PROF_STREAM_MAILBOX         3   /* poll by debugger, use dump_mailbox.gdb to receive it */
+#define PROF_STREAM_RTT             4   /* read by debugger in background through rtt middleware, use parse_rtt.py to split it */
+
+/* Last streaming interface supported, PROF_STREAM_RTT requires rtt middleware */
+#if defined(NUCLEI_RTT) && (NUCLEI_RTT == 1)
+#define PROF_STREAM_MAX             PROF_STREAM_RTT
+#else
+#define PROF_STREAM_MAX             PROF_STREAM_MAILBOX
+#endif
+
+typedef struct prof_stream {
+    unsigned long interface;
+    const char *filename;
+    int fd;
+    uint32_t offset;    /* bytes flushed of this file */
+    uint32_t pos;       /* bytes in chunk buffer */
+    uint8_t chunk[PROF_STREAM_CHUNK_SIZE];
+} prof_stream_t;
+
+/*
+ * Mailbox polled by debugger, when a chunk is ready, state is set to 1 and prof_mailbox_flush
+ * is called, the debugger need to save size bytes at buf into filename at offset,
+ * and then clear state to 0 to continue the program
+ */
+typedef struct prof_mailbox {
+    volatile uint32_t state;
+    uint32_t offset;
+    uint32_t size;
+    const char *filename;
+    const uint8_t *buf;
+} prof_mailbox_t;
+
+extern prof_mailbox_t prof_mailbox;
+
+/* Debugger breakpoint location when a mailbox chunk is ready */
+void prof_mailbox_flush(void);
+
+/* Open a stream to emit filename via interface, return 0 if success */
+int prof_stream_open(prof_stream_t *stream, unsigned long interface, const char *filename);
+
+/* Append len bytes of data to stream, flush chunk when full */
+void prof_stream_write(prof_stream_t *stream, const void *data, size_t len);
+
+/* Flush remaining data and close stream, return 0 if success */
+int prof_stream_close(prof_stream_t *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_PROF_STREAM_H_ */
@@ -0,0 +1,212 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "rtostrace_api.h"
+
+#if (RTOSTRACE_RING_SIZE & (RTOSTRACE_RING_SIZE - 1)) != 0
+#error "RTOSTRACE_RING_SIZE must be power of 2"
+#endif
+
+#if (RTOSTRACE_NAME_LEN % 4) != 0
+#error "RTOSTRACE_NAME_LEN must be multiple of 4"
+#endif
+
+/*
+ * rtostrace.out layout, all fields are in cpu native little-endian
+ * - header: struct rtostracehdr
+ * - RTOSTRACE_MAX_NAMES names: struct rtostracename, unused entries have obj 0
+ * - RTOSTRACE_HART_NUM rings: struct rtostracering, only the latest min(head, size) records are valid,
+ *   the oldest one is located at records[(head - valid) % size]
+ */
+struct rtostracehdr {
+    char magic[4];      /* "NRTR" */
+    uint16_t version;   /* version number */
+    uint16_t xlenbytes; /* size of object handle in bytes */
+    uint32_t harts;     /* ring count */
+    uint32_t size;      /* record count of each ring */
+    uint32_t names;     /* name count */
+    uint32_t namelen;   /* size of each name */
+    uint32_t freq;      /* cpu frequency in Hz */
+    uint32_t reserved;
+};
+
+struct rtostracename {
+    unsigned long obj;
+    char name[RTOSTRACE_NAME_LEN];
+};
+
+/* cycle is the low 32 bits of cycle counter when the event is recorded */
+struct rtostracerec {
+    uint32_t cycle;
+    uint16_t event;
+    uint16_t arg;
+    unsigned long obj;
+};
+
+struct rtostracering {
+    uint32_t hartid;            /* hart id of this ring */
+    volatile uint32_t head;     /* total records written */
+    struct rtostracerec records[RTOSTRACE_RING_SIZE];
+};
+
+#define RTOSTRACEVERSION    1
+
+/* rtostrace data structure */
+struct rtostracedata {
+    char *buf;
+    uint32_t size;
+};
+
+/* Where the rtostrace data stored after execute rtostrace_collect(0) */
+struct rtostracedata rtostrace_data = {NULL, 0};
+
+static struct {
+    struct rtostracehdr hdr;
+    struct rtostracename names[RTOSTRACE_MAX_NAMES];
+    struct rtostracering rings[RTOSTRACE_HART_NUM];
+} rtostrace_buf;
+
+static volatile unsigned long rtostrace_active = 0;
+static uint32_t rtostrace_nextname = 0;
+
+void rtostrace_event(uint16_t event, uint16_t arg, const void *obj)
+{
+    unsigned long hartidx = __get_hart_index();
+    struct rtostracering *ring;
+    struct rtostracerec *rec;
+    uint32_t idx;
+
+    if ((rtostrace_active == 0) || (hartidx >= RTOSTRACE_HART_NUM)) {
+        return;
+    }
+    ring = &rtostrace_buf.rings[hartidx];
+#if defined(__riscv_atomic)
+    // reserve a record, atomic to interrupts on the same hart
+    idx = __atomic_fetch_add(&ring->head, 1, __ATOMIC_RELAXED);
+    rec = &ring->records[idx & (RTOSTRACE_RING_SIZE - 1)];
+    rec->cycle = (uint32_t)__get_rv_cycle();
+    rec->event = event;
+    rec->arg = arg;
+    rec->obj = (unsigned long)obj;
+#else
+    // no amo instruction, disable interrupt to reserve and fill the record
+    unsigned long mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    idx = ring->head;
+    ring->head = idx + 1;
+    rec = &ring->records[idx & (RTOSTRACE_RING_SIZE - 1)];
+    rec->cycle = (uint32_t)__get_rv_cycle();
+    rec->event = event;
+    rec->arg = arg;
+    rec->obj = (unsigned long)obj;
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+#endif
+}
+
+void rtostrace_name(const void *obj, const char *name)
+{
+    struct rtostracename *entry = NULL;
+    uint32_t i;
+
+    if ((obj == NULL) || (name == NULL)) {
+        return;
+    }
+    // reuse the entry of the same object, such as a task created at the address of a deleted one
+    for (i = 0; i < RTOSTRACE_MAX_NAMES; i++) {
+        if (rtostrace_buf.names[i].obj == (unsigned long)obj) {
+            entry = &rtostrace_buf.names[i];
+            break;
+        }
+    }
+    if (entry == NULL) {
+        entry = &rtostrace_buf.names[rtostrace_nextname];
+        rtostrace_nextname = (rtostrace_nextname + 1) % RTOSTRACE_MAX_NAMES;
+    }
+    for (i = 0; (i < RTOSTRACE_NAME_LEN - 1) && (name[i] != '\0'); i++) {
+        entry->name[i] = name[i];
+    }
+    for (; i < RTOSTRACE_NAME_LEN; i++) {
+        entry->name[i] = '\0';
+    }
+    entry->obj = (unsigned long)obj;
+}
+
+void rtostrace_start(void)
+{
+    rtostrace_active = 0;
+    rtostrace_buf.hdr.magic[0] = 'N';
+    rtostrace_buf.hdr.magic[1] = 'R';
+    rtostrace_buf.hdr.magic[2] = 'T';
+    rtostrace_buf.hdr.magic[3] = 'R';
+    rtostrace_buf.hdr.version = RTOSTRACEVERSION;
+    rtostrace_buf.hdr.xlenbytes = sizeof(unsigned long);
+    rtostrace_buf.hdr.harts = RTOSTRACE_HART_NUM;
+    rtostrace_buf.hdr.size = RTOSTRACE_RING_SIZE;
+    rtostrace_buf.hdr.names = RTOSTRACE_MAX_NAMES;
+    rtostrace_buf.hdr.namelen = RTOSTRACE_NAME_LEN;
+    rtostrace_buf.hdr.freq = SystemCoreClock;
+    for (int i = 0; i < RTOSTRACE_HART_NUM; i ++) {
+#ifdef __HARTID_OFFSET
+        rtostrace_buf.rings[i].hartid = i + __HARTID_OFFSET;
+#else
+        rtostrace_buf.rings[i].hartid = i;
+#endif
+        rtostrace_buf.rings[i].head = 0;
+    }
+    __RWMB();
+    rtostrace_active = 1;
+}
+
+void rtostrace_stop(void)
+{
+    rtostrace_active = 0;
+    __RWMB();
+}
+
+#define NUM_OCTETS_PER_LINE 20
+#define FLUSH_OUTPUT()      fflush(stdout)
+static void hexdumpbuf(char *buf, unsigned long sz)
+{
+    unsigned long rem, cur = 0, i = 0;
+
+    FLUSH_OUTPUT();
+
+    while (cur < sz) {
+        rem = ((sz - cur) < NUM_OCTETS_PER_LINE) ? (sz - cur) : NUM_OCTETS_PER_LINE;
+        for (i = 0; i < rem; i++) {
+            printf("%02x", (uint8_t)buf[cur + i]);
+        }
+        printf("\n");
+        FLUSH_OUTPUT();
+        cur += rem;
+    }
+}
+
+long rtostrace_collect(unsigned long interface)
+{
+    static const char rtostrace_out[] = "rtostrace.out";
+    int fd;
+
+    rtostrace_stop();
+    if (interface == 0) {
+        rtostrace_data.buf = (char *)&rtostrace_buf;
+        rtostrace_data.size = sizeof(rtostrace_buf);
+        printf("Collected rtostrace data @0x%lx, size %lu bytes\n", (unsigned long)rtostrace_data.buf, (unsigned long)rtostrace_data.size);
+    } else if (interface == 1) {
+        fd = open(rtostrace_out, O_CREAT | O_TRUNC | O_WRONLY, 0666);
+        if (fd < 0) {
+            printf("Unable to open %s\n", rtostrace_out);
+            return -1;
+        }
+        write(fd, (const char *)&rtostrace_buf, sizeof(rtostrace_buf));
+        close(fd);
+        printf("Write %s done!\n", rtostrace_out);
+    } else {
+        printf("\nDump rtostrace data start\n");
+        hexdumpbuf((char *)&rtostrace_buf, sizeof(rtostrace_buf));
+        printf("\nCREATE: %s\n", rtostrace_out);
+        printf("\nDump rtostrace data finished\n");
+    }
+    return 0;
+}
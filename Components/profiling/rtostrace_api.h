@@ -0,0 +1,91 @@
+#ifndef _RTOSTRACE_API_H_
+#define _RTOSTRACE_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Binary event recorder for RTOS kernel trace hooks
+ *
+ * When NUCLEI_RTOS_TRACE=1 is defined, the FreeRTOS port maps the kernel trace macros, such as
+ * traceTASK_SWITCHED_IN, traceISR_ENTER and traceQUEUE_SEND, to rtostrace_event(), each event is
+ * recorded as a compact (cycle, event, arg, object) record into a per-hart ring buffer, the
+ * oldest records are overwritten when ring buffer is full, so the latest timeline is kept.
+ *
+ * The cycle is the low 32 bits of __get_rv_cycle(), the converter expects at least one event
+ * each 2^32 cycles on each hart, which the tick event ensures unless tickless idle is used.
+ *
+ * Task and queue names are kept in a small name table, tasks are added when created, and
+ * queues when added to the queue registry, so they are named in the timeline.
+ */
+
+/* record count of each hart ring buffer, must be power of 2 */
+#ifndef RTOSTRACE_RING_SIZE
+#define RTOSTRACE_RING_SIZE     2048
+#endif
+
+/* max hart count can be traced, harts with hart index larger than it are not traced */
+#ifndef RTOSTRACE_HART_NUM
+#if defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1)
+#define RTOSTRACE_HART_NUM      SMP_CPU_CNT
+#else
+#define RTOSTRACE_HART_NUM      1
+#endif
+#endif
+
+/* max task and queue names kept, the oldest name is replaced when it is full */
+#ifndef RTOSTRACE_MAX_NAMES
+#define RTOSTRACE_MAX_NAMES     32
+#endif
+
+/* max length of each name including terminating null, must be multiple of 4 */
+#ifndef RTOSTRACE_NAME_LEN
+#define RTOSTRACE_NAME_LEN      16
+#endif
+
+/* event ids, the meaning of arg of each event is in the comment */
+#define RTOSTRACE_TASK_SWITCHED_IN      1   /* task is switched in, arg: priority */
+#define RTOSTRACE_TASK_SWITCHED_OUT     2   /* task is switched out, arg: priority */
+#define RTOSTRACE_TASK_READY            3   /* task is moved to ready list, arg: priority */
+#define RTOSTRACE_TASK_PRIO_INHERIT     4   /* mutex holder inherits priority, arg: inherited priority */
+#define RTOSTRACE_TASK_PRIO_DISINHERIT  5   /* mutex holder priority restored, arg: original priority */
+#define RTOSTRACE_ISR_ENTER             6   /* interrupt handler entered, arg: interrupt id */
+#define RTOSTRACE_ISR_EXIT              7   /* interrupt handler exited, arg: interrupt id */
+#define RTOSTRACE_TICK                  8   /* tick count incremented, arg: low 16 bits of tick count */
+#define RTOSTRACE_QUEUE_CREATE          9   /* queue or semaphore created, arg: queue type */
+#define RTOSTRACE_QUEUE_SEND            10  /* item sent or semaphore given, arg: items waiting before */
+#define RTOSTRACE_QUEUE_SEND_FAILED     11  /* send or give failed, arg: items waiting */
+#define RTOSTRACE_QUEUE_BLOCK_SEND      12  /* current task blocked on full queue, arg: items waiting */
+#define RTOSTRACE_QUEUE_RECEIVE         13  /* item received or semaphore taken, arg: items waiting before */
+#define RTOSTRACE_QUEUE_RECEIVE_FAILED  14  /* receive or take failed, arg: items waiting */
+#define RTOSTRACE_QUEUE_BLOCK_RECEIVE   15  /* current task blocked on empty queue, arg: items waiting */
+#define RTOSTRACE_USER                  0x100   /* application events start from here */
+
+/* Start tracing, previous recorded records are cleared, names are kept */
+void rtostrace_start(void);
+
+/* Stop tracing, recorded records are kept until next rtostrace_start */
+void rtostrace_stop(void);
+
+/* Record an event of current hart, can be called in interrupt handlers, obj can be NULL */
+void rtostrace_event(uint16_t event, uint16_t arg, const void *obj);
+
+/* Set the name of a task or queue object, which is shown in the timeline */
+void rtostrace_name(const void *obj, const char *name);
+
+/* - if interface == 0, it will dump trace data in buffer called rtostrace_data, use dump_rtostrace.gdb to dump it
+ * - if interface == 1, it will write rtostrace.out file using open/write api
+ * - otherwise it will dump trace data in console, use parse.py to convert it into rtostrace.out
+ * rtostrace.out can be converted into chrome trace format or a latency report by parse_rtostrace.py
+ */
+long rtostrace_collect(unsigned long interface);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_RTOSTRACE_API_H_ */
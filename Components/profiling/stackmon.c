@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "stackmon_api.h"
+
+static stackmon_task_t stackmon_tasks[STACKMON_MAX_TASKS];
+
+/* next task to be checked by stackmon_scan */
+static uint32_t stackmon_cur = 0;
+
+/* task stacks can be registered in critical section or interrupt, so only mie is used here */
+__STATIC_FORCEINLINE unsigned long stackmon_lock(void)
+{
+    return __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+}
+
+__STATIC_FORCEINLINE void stackmon_unlock(unsigned long flags)
+{
+    __RV_CSR_SET(CSR_MSTATUS, flags & MSTATUS_MIE);
+}
+
+/*
+ * Check at most budget words from scan position of the task,
+ * the first overwritten word from base gives the high water mark,
+ * return 1 if a complete check of this task is done
+ */
+static int stackmon_check(stackmon_task_t *task, uint32_t budget)
+{
+    while ((task->pos < task->intact) && (budget > 0)) {
+        if (task->base[task->pos] != task->pattern) {
+            task->intact = task->pos;
+            break;
+        }
+        task->pos++;
+        budget--;
+    }
+    if (task->pos >= task->intact) {
+        task->pos = 0;
+        return 1;
+    }
+    return 0;
+}
+
+long stackmon_register(const void *id, const char *name, void *base, unsigned long size, void *sp, uint32_t pattern)
+{
+    uintptr_t start = ((uintptr_t)base + sizeof(uint32_t) - 1) & ~(uintptr_t)(sizeof(uint32_t) - 1);
+    uintptr_t end = (uintptr_t)base + size;
+    uint32_t i, painted;
+    stackmon_task_t *task = NULL;
+    unsigned long flags;
+
+    if ((id == NULL) || (end < start + sizeof(uint32_t)) || ((uintptr_t)sp < start) || ((uintptr_t)sp > end)) {
+        return -1;
+    }
+    painted = ((uintptr_t)sp - start) / sizeof(uint32_t);
+    // the task is not running yet, paint it before it is visible to stackmon_scan
+    for (i = 0; i < painted; i++) {
+        ((uint32_t *)start)[i] = pattern;
+    }
+
+    flags = stackmon_lock();
+    for (i = 0; i < STACKMON_MAX_TASKS; i++) {
+        if (stackmon_tasks[i].id == id) {
+            task = &stackmon_tasks[i];
+            break;
+        }
+        if ((task == NULL) && (stackmon_tasks[i].id == NULL)) {
+            task = &stackmon_tasks[i];
+        }
+    }
+    if (task != NULL) {
+        task->id = id;
+        task->name = name;
+        task->base = (uint32_t *)start;
+        task->words = (end - start) / sizeof(uint32_t);
+        task->intact = painted;
+        task->pos = 0;
+        task->pattern = pattern;
+    }
+    stackmon_unlock(flags);
+    return (task != NULL) ? 0 : -1;
+}
+
+void stackmon_unregister(const void *id)
+{
+    unsigned long flags;
+
+    flags = stackmon_lock();
+    for (uint32_t i = 0; i < STACKMON_MAX_TASKS; i++) {
+        if (stackmon_tasks[i].id == id) {
+            stackmon_tasks[i].id = NULL;
+            break;
+        }
+    }
+    stackmon_unlock(flags);
+}
+
+void stackmon_scan(void)
+{
+    stackmon_task_t *task;
+    unsigned long flags;
+
+    flags = stackmon_lock();
+    for (uint32_t i = 0; i < STACKMON_MAX_TASKS; i++) {
+        task = &stackmon_tasks[stackmon_cur];
+        if (task->id != NULL) {
+            if (stackmon_check(task, STACKMON_SCAN_WORDS)) {
+                stackmon_cur = (stackmon_cur + 1) % STACKMON_MAX_TASKS;
+            }
+            break;
+        }
+        stackmon_cur = (stackmon_cur + 1) % STACKMON_MAX_TASKS;
+    }
+    stackmon_unlock(flags);
+}
+
+/* complete check of a task in slot idx, return max used bytes */
+static unsigned long stackmon_update(uint32_t idx, const void *id)
+{
+    stackmon_task_t *task = &stackmon_tasks[idx];
+    unsigned long flags, used = 0;
+    int done = 0;
+
+    while (!done) {
+        flags = stackmon_lock();
+        if (task->id != id) {
+            stackmon_unlock(flags);
+            return 0;
+        }
+        done = stackmon_check(task, STACKMON_SCAN_WORDS);
+        used = (unsigned long)(task->words - task->intact) * sizeof(uint32_t);
+        stackmon_unlock(flags);
+    }
+    return used;
+}
+
+unsigned long stackmon_used(const void *id)
+{
+    for (uint32_t i = 0; i < STACKMON_MAX_TASKS; i++) {
+        if ((id != NULL) && (stackmon_tasks[i].id == id)) {
+            return stackmon_update(i, id);
+        }
+    }
+    return 0;
+}
+
+void stackmon_report(void)
+{
+    stackmon_task_t *task;
+    unsigned long used, size;
+
+    printf("Stack usage, task, size, used, percent\n");
+    for (uint32_t i = 0; i < STACKMON_MAX_TASKS; i++) {
+        task = &stackmon_tasks[i];
+        if (task->id == NULL) {
+            continue;
+        }
+        size = (unsigned long)task->words * sizeof(uint32_t);
+        used = stackmon_update(i, task->id);
+        if (task->name != NULL) {
+            printf("STACK, %s, %lu, %lu, %lu%%\n", task->name, size, used, used * 100 / size);
+        } else {
+            printf("STACK, 0x%lx, %lu, %lu, %lu%%\n", (unsigned long)(uintptr_t)task->id, size, used, used * 100 / size);
+        }
+    }
+}
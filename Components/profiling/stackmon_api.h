@@ -0,0 +1,77 @@
+#ifndef _STACKMON_API_H_
+#define _STACKMON_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Stack high-water-mark monitor for RTOS tasks.
+ *
+ * When NUCLEI_STACK_MONITOR=1 is defined, the FreeRTOS, RT-Thread, ThreadX and uC/OS-II
+ * ports of Nuclei SDK register each task stack when the task is created, the unused part
+ * of the stack below the initial context frame is painted with the stack fill pattern of
+ * each RTOS, so the stack check tools of the RTOS itself still work.
+ *
+ * stackmon_scan() checks at most STACKMON_SCAN_WORDS words each time, it should be called
+ * repeatedly from the idle task, and stackmon_report() prints the max used stack size
+ * of each task, which can be used to shrink over-provisioned task stacks.
+ */
+
+/* max tasks can be monitored at the same time */
+#ifndef STACKMON_MAX_TASKS
+#define STACKMON_MAX_TASKS      32
+#endif
+
+/* max words checked by each stackmon_scan call, interrupt is disabled while checking */
+#ifndef STACKMON_SCAN_WORDS
+#define STACKMON_SCAN_WORDS     64
+#endif
+
+/* default pattern used to paint unused stack, same as FreeRTOS tskSTACK_FILL_BYTE */
+#ifndef STACKMON_PATTERN
+#define STACKMON_PATTERN        0xA5A5A5A5UL
+#endif
+
+/* stack usage of one task */
+typedef struct stackmon_task {
+    const void *id;         /* task handle, NULL means this slot is free */
+    const char *name;       /* task name, can be NULL */
+    uint32_t *base;         /* lowest address of stack */
+    uint32_t words;         /* stack size in words */
+    uint32_t intact;        /* words from base which are still painted */
+    uint32_t pos;           /* scan position from base */
+    uint32_t pattern;       /* pattern used to paint the stack */
+} stackmon_task_t;
+
+/*
+ * Register a task stack and paint it from base to sp
+ * - id: task handle used to unregister it
+ * - name: task name, must be valid until unregistered
+ * - base & size: stack memory area, stack grows from base + size to base
+ * - sp: current stack pointer of the task, the initial context frame above it is not painted
+ * - pattern: word used to paint the stack, such as STACKMON_PATTERN
+ * return 0 if registered, otherwise -1
+ */
+long stackmon_register(const void *id, const char *name, void *base, unsigned long size, void *sp, uint32_t pattern);
+
+/* Unregister a task stack, should be called before the stack is freed */
+void stackmon_unregister(const void *id);
+
+/* Check part of the registered stacks, call it repeatedly in idle task */
+void stackmon_scan(void);
+
+/* Get max used stack size in bytes of a task after a complete check, return 0 if not registered */
+unsigned long stackmon_used(const void *id);
+
+/* Print stack size and max used stack size of all the registered tasks */
+void stackmon_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_STACKMON_API_H_ */
@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# qspiflash middleware runs external SPI NOR flash on gd32vw55x QSPI with quad I/O XIP,
+# DMA bulk reads over dmaq and program/erase from .ilm_text, add dmaq to MIDDLEWARE too
+MIDDLEWARE_QSPIFLASH := $(NUCLEI_SDK_MIDDLEWARE)/qspiflash
+
+C_SRCDIRS += $(MIDDLEWARE_QSPIFLASH)
+
+INCDIRS += $(MIDDLEWARE_QSPIFLASH)
@@ -0,0 +1,524 @@
+#include <stdint.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "qspiflash_api.h"
+
+#if !defined(GD32VW55x_H)
+#error "qspiflash middleware only supports gd32vw55x"
+#endif
+
+/* SPI NOR commands */
+#define QF_CMD_WREN                 0x06
+#define QF_CMD_RDSR                 0x05
+#define QF_CMD_RDSR2                0x35
+#define QF_CMD_WRSR2                0x31
+#define QF_CMD_QPP                  0x32    /* quad page program */
+#define QF_CMD_SE                   0x20    /* 4KB sector erase */
+#define QF_CMD_SUSPEND              0x75
+#define QF_CMD_RESUME               0x7A
+#define QF_CMD_QIOREAD              0xEB    /* quad I/O fast read */
+
+#define QF_SR_WIP                   0x01
+#define QF_SR2_QE                   0x02
+
+#define QF_TCFG_DUMMY(n)            (((uint32_t)(n) << 18) & QSPI_TCFG_DUMYC)
+#define QF_TCFG_CMD(ins)            (QSPI_INSTRUCTION_1_LINE | (ins))
+#define QF_TCFG_ADDR                (QSPI_ADDR_1_LINE | QSPI_ADDR_24_BITS)
+/* quad I/O read, address and mode byte on four lines, two mode and four dummy cycles */
+#define QF_TCFG_QIOREAD             (QF_TCFG_CMD(QF_CMD_QIOREAD) | QSPI_ADDR_4_LINES | QSPI_ADDR_24_BITS | \
+                                     QSPI_ALTE_BYTES_4_LINES | QSPI_ALTE_BYTES_8_BITS | QF_TCFG_DUMMY(4) | \
+                                     QSPI_DATA_4_LINES)
+#if QSPIFLASH_XIP_MODE == 0xFF
+#define QF_TCFG_XIP                 (QF_TCFG_QIOREAD | QSPI_SIOO_INST_EVERY_CMD | QSPI_MEMORY_MAPPED)
+#else
+#define QF_TCFG_XIP                 (QF_TCFG_QIOREAD | QSPI_SIOO_INST_ONLY_FIRST_CMD | QSPI_MEMORY_MAPPED)
+#endif
+
+/* DMA transfers up to 65535 data, word aligned so a chunk is also usable by byte requests */
+#define QF_DMA_CHUNK                0xFFFCUL
+
+/* stream buffer state */
+#define QF_BUF_FREE                 0
+#define QF_BUF_FILLING              1
+#define QF_BUF_FULL                 2
+#define QF_BUF_ERROR                3
+#define QF_BUF_NONE                 2       /* index of no buffer */
+
+static qspiflash_config_t qspiflash_cfg;
+static qspiflash_stream_t *qspiflash_stream;
+static qspiflash_job_t *qspiflash_job;
+
+/* a stream or background read owns QSPI */
+#define QF_BUSY()                   ((qspiflash_stream != NULL) || (qspiflash_job != NULL))
+
+/*
+ * Helpers below are inlined into the __HOT_ILM functions, which run with XIP off,
+ * so they only touch registers and RAM
+ */
+__STATIC_FORCEINLINE void qf_wait_tc(void)
+{
+    while ((QSPI_STAT & QSPI_STAT_TC) == 0) {
+    }
+    QSPI_STATC = QSPI_STATC_TCC;
+}
+
+/* instruction only, started by writing TCFG */
+__STATIC_FORCEINLINE void qf_cmd(uint32_t ins)
+{
+    QSPI_TCFG = QF_TCFG_CMD(ins) | QSPI_NORMAL_WRITE;
+    qf_wait_tc();
+}
+
+/* instruction and address, started by writing ADDR */
+__STATIC_FORCEINLINE void qf_cmd_addr(uint32_t ins, uint32_t addr)
+{
+    QSPI_TCFG = QF_TCFG_CMD(ins) | QF_TCFG_ADDR | QSPI_NORMAL_WRITE;
+    QSPI_ADDR = addr;
+    qf_wait_tc();
+}
+
+__STATIC_FORCEINLINE uint8_t qf_read_reg(uint32_t ins)
+{
+    QSPI_DTLEN = 0;
+    QSPI_TCFG = QF_TCFG_CMD(ins) | QSPI_DATA_1_LINE | QSPI_NORMAL_READ;
+    qf_wait_tc();
+    return *(volatile uint8_t *)&QSPI_DATA;
+}
+
+__STATIC_FORCEINLINE void qf_write_reg(uint32_t ins, uint8_t val)
+{
+    QSPI_DTLEN = 0;
+    QSPI_TCFG = QF_TCFG_CMD(ins) | QSPI_DATA_1_LINE | QSPI_NORMAL_WRITE;
+    *(volatile uint8_t *)&QSPI_DATA = val;
+    qf_wait_tc();
+}
+
+__STATIC_FORCEINLINE void qf_wait_wip(void)
+{
+    while (qf_read_reg(QF_CMD_RDSR) & QF_SR_WIP) {
+    }
+}
+
+__STATIC_FORCEINLINE void qf_xip_enter(void)
+{
+    QSPI_ALTE = QSPIFLASH_XIP_MODE;
+    QSPI_TCFG = QF_TCFG_XIP;
+}
+
+/* stop memory-mapped mode and take the flash out of continuous read mode */
+__STATIC_FORCEINLINE void qf_xip_exit(void)
+{
+    QSPI_CTL |= QSPI_CTL_ABORT;
+    while (QSPI_CTL & QSPI_CTL_ABORT) {
+    }
+    while (QSPI_STAT & QSPI_STAT_BUSY) {
+    }
+#if QSPIFLASH_XIP_MODE != 0xFF
+    // all ones on four lines in address and mode phase ends continuous read mode
+    QSPI_ALTE = 0xFFFFFFFFUL;
+    QSPI_TCFG = QSPI_INSTRUCTION_4_LINES | 0xFF | QSPI_ALTE_BYTES_4_LINES | QSPI_ALTE_BYTES_32_BITS | QSPI_NORMAL_WRITE;
+    qf_wait_tc();
+#endif
+}
+
+__WEAK void qspiflash_port_init(void)
+{
+}
+
+__WEAK __HOT_ILM void qspiflash_port_quad_enable(void)
+{
+    uint8_t sr2 = qf_read_reg(QF_CMD_RDSR2);
+
+    if ((sr2 & QF_SR2_QE) == 0) {
+        qf_cmd(QF_CMD_WREN);
+        qf_write_reg(QF_CMD_WRSR2, sr2 | QF_SR2_QE);
+        qf_wait_wip();
+    }
+}
+
+/* runs from RAM, code of caller may be in the window which is off here */
+static __HOT_ILM void qf_setup(uint32_t prescaler, uint32_t fmsz)
+{
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+
+    if (QSPI_CTL & QSPI_CTL_QSPIEN) {
+        qf_xip_exit();
+        QSPI_CTL &= ~QSPI_CTL_QSPIEN;
+    }
+    QSPI_CTL = ((prescaler << 24) & QSPI_CTL_PSC) | ((4U - 1U) << 8);
+    QSPI_DCFG = ((fmsz << 16) & QSPI_DCFG_FMSZ) | QSPI_CS_HIGH_TIME_2_CYCLE | QSPI_CLOCK_MODE_0;
+    QSPI_CTL |= QSPI_CTL_QSPIEN;
+    qspiflash_port_quad_enable();
+    qf_xip_enter();
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
+
+int32_t qspiflash_init(const qspiflash_config_t *cfg)
+{
+    // memory-mapped window is 128MB
+    if ((cfg->size_log2 < 12) || (cfg->size_log2 > 27) || (cfg->prescaler > 255)) {
+        return -1;
+    }
+    qspiflash_cfg = *cfg;
+    qspiflash_stream = NULL;
+    qspiflash_job = NULL;
+    qspiflash_port_init();
+    rcu_periph_clock_enable(RCU_QSPI);
+    qf_setup(cfg->prescaler, cfg->size_log2 - 1);
+    return 0;
+}
+
+/* start indirect quad read of len bytes by DMA, XIP is off and QSPI is idle */
+static int32_t qf_read_start(uint32_t addr, void *buf, uint32_t len, dmaq_req_t *req, dmaq_cb_t cb, void *arg)
+{
+    uint32_t width = ((((unsigned long)buf) | len) & 3) ? 1 : 4;
+
+    // FIFO threshold matches DMA width, so each request has one full data
+    QSPI_CTL = (QSPI_CTL & ~QSPI_CTL_FTL) | ((width - 1) << 8) | QSPI_CTL_DMAEN;
+    req->periph_addr = (uint32_t)(unsigned long)&QSPI_DATA;
+    req->mem = buf;
+    req->count = len / width;
+    req->dir = DMAQ_DIR_P2M;
+    req->width = width;
+    req->periph_inc = 0;
+    req->mem_inc = 1;
+    req->cb = cb;
+    req->arg = arg;
+    if (dmaq_submit(qspiflash_cfg.dma_chan, req) != 0) {
+        return -1;
+    }
+    QSPI_DTLEN = len - 1;
+    QSPI_ALTE = 0xFF;
+    QSPI_TCFG = QF_TCFG_QIOREAD | QSPI_NORMAL_READ;
+    QSPI_ADDR = addr;
+    return 0;
+}
+
+/* DMA has read all data, TC is set before the last data leaves FIFO, abort on DMA error */
+static void qf_read_end(uint32_t ok)
+{
+    if (ok) {
+        qf_wait_tc();
+    } else {
+        QSPI_CTL |= QSPI_CTL_ABORT;
+        while (QSPI_CTL & QSPI_CTL_ABORT) {
+        }
+    }
+    QSPI_CTL &= ~QSPI_CTL_DMAEN;
+    while (QSPI_STAT & QSPI_STAT_BUSY) {
+    }
+}
+
+static __HOT_ILM void qf_xip(uint32_t on)
+{
+    if (on) {
+        qf_xip_enter();
+    } else {
+        qf_xip_exit();
+    }
+}
+
+int32_t qspiflash_read(uint32_t addr, void *buf, uint32_t len)
+{
+    dmaq_req_t req;
+    uint8_t *dst = (uint8_t *)buf;
+    uint32_t n;
+    int32_t ret = 0;
+
+    if ((addr + len > (1UL << qspiflash_cfg.size_log2)) || (addr + len < addr) || QF_BUSY()) {
+        return -1;
+    }
+    if ((qspiflash_cfg.xip_code != 0) || (qspiflash_cfg.dma_chan == QSPIFLASH_NO_DMA)) {
+        // memory-mapped read, the window has to stay readable for code
+        memcpy(dst, (const void *)(unsigned long)(QSPI_FLASH + addr), len);
+        return 0;
+    }
+    qf_xip(0);
+    while ((len > 0) && (ret == 0)) {
+        n = (len > QF_DMA_CHUNK) ? QF_DMA_CHUNK : len;
+        if (qf_read_start(addr, dst, n, &req, NULL, NULL) != 0) {
+            ret = -1;
+            break;
+        }
+        ret = (dmaq_wait(&req) == DMAQ_DONE) ? 0 : -1;
+        qf_read_end(ret == 0);
+        addr += n;
+        dst += n;
+        len -= n;
+    }
+    qf_xip(1);
+    return ret;
+}
+
+static void qf_job_done(dmaq_req_t *req, void *arg);
+
+/* start next chunk of job, called with interrupts disabled, XIP off and QSPI idle */
+static int32_t qf_job_next(qspiflash_job_t *job)
+{
+    job->chunk = (job->len > QF_DMA_CHUNK) ? QF_DMA_CHUNK : job->len;
+    return qf_read_start(job->addr, job->dst, job->chunk, &job->req, qf_job_done, job);
+}
+
+/* one chunk read, read the next one, or enter XIP again and complete the job */
+static void qf_job_done(dmaq_req_t *req, void *arg)
+{
+    qspiflash_job_t *job = (qspiflash_job_t *)arg;
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    uint32_t ok = (req->status == DMAQ_DONE);
+
+    qf_read_end(ok);
+    if (ok) {
+        job->addr += job->chunk;
+        job->dst += job->chunk;
+        job->len -= job->chunk;
+        if ((job->len > 0) && (qf_job_next(job) == 0)) {
+            __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+            return;
+        }
+    }
+    qspiflash_job = NULL;
+    qf_xip(1);
+    job->status = (ok && (job->len == 0)) ? 0 : -1;
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    if (job->cb != NULL) {
+        job->cb(job, job->status, job->arg);
+    }
+}
+
+int32_t qspiflash_read_start(qspiflash_job_t *job, uint32_t addr, void *buf, uint32_t len,
+                             qspiflash_job_cb_t cb, void *arg)
+{
+    rv_csr_t mstatus;
+
+    if ((qspiflash_cfg.xip_code != 0) || (qspiflash_cfg.dma_chan == QSPIFLASH_NO_DMA) || (len == 0) ||
+        (addr + len > (1UL << qspiflash_cfg.size_log2)) || (addr + len < addr)) {
+        return -1;
+    }
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if (QF_BUSY()) {
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+        return -1;
+    }
+    qspiflash_job = job;
+    job->addr = addr;
+    job->dst = (uint8_t *)buf;
+    job->len = len;
+    job->cb = cb;
+    job->arg = arg;
+    job->status = 1;
+    qf_xip(0);
+    if (qf_job_next(job) != 0) {
+        qspiflash_job = NULL;
+        qf_xip(1);
+        job->status = -1;
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+        return -1;
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return 0;
+}
+
+int32_t qspiflash_read_wait(qspiflash_job_t *job)
+{
+    return __wfi_while_pending(&job->status, 1);
+}
+
+static void qf_stream_done(dmaq_req_t *req, void *arg);
+
+/* fill buffer idx with next data, called with interrupts disabled and QSPI idle */
+static void qf_stream_fill(qspiflash_stream_t *stream, uint32_t idx)
+{
+    uint32_t len = stream->end - stream->next;
+
+    if (len == 0) {
+        return;
+    }
+    if (len > stream->chunk) {
+        len = stream->chunk;
+    }
+    stream->len[idx] = len;
+    stream->fill = idx;
+    stream->state[idx] = QF_BUF_FILLING;
+    if (qf_read_start(stream->next, stream->buf[idx], len, &stream->req, qf_stream_done, stream) != 0) {
+        stream->state[idx] = QF_BUF_ERROR;
+        stream->fill = QF_BUF_NONE;
+        return;
+    }
+    stream->next += len;
+}
+
+/* one buffer filled, read ahead into the other one if caller gave it back */
+static void qf_stream_done(dmaq_req_t *req, void *arg)
+{
+    qspiflash_stream_t *stream = (qspiflash_stream_t *)arg;
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    uint32_t idx = stream->fill;
+
+    qf_read_end(req->status == DMAQ_DONE);
+    stream->fill = QF_BUF_NONE;
+    if (req->status == DMAQ_DONE) {
+        stream->state[idx] = QF_BUF_FULL;
+        if (stream->state[idx ^ 1] == QF_BUF_FREE) {
+            qf_stream_fill(stream, idx ^ 1);
+        }
+    } else {
+        stream->state[idx] = QF_BUF_ERROR;
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
+
+int32_t qspiflash_stream_open(qspiflash_stream_t *stream, uint32_t addr, uint32_t len)
+{
+    rv_csr_t mstatus;
+
+    if ((qspiflash_cfg.xip_code != 0) || (qspiflash_cfg.dma_chan == QSPIFLASH_NO_DMA) ||
+        (stream->chunk < 4) || (stream->chunk > QF_DMA_CHUNK) || ((stream->chunk & 3) != 0) ||
+        ((((unsigned long)stream->buf[0]) | ((unsigned long)stream->buf[1])) & 3) ||
+        (addr + len > (1UL << qspiflash_cfg.size_log2)) || (addr + len < addr)) {
+        return -1;
+    }
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if (QF_BUSY()) {
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+        return -1;
+    }
+    qspiflash_stream = stream;
+    stream->next = addr;
+    stream->end = addr + len;
+    stream->state[0] = QF_BUF_FREE;
+    stream->state[1] = QF_BUF_FREE;
+    stream->fill = QF_BUF_NONE;
+    stream->cur = QF_BUF_NONE;
+    qf_xip(0);
+    qf_stream_fill(stream, 0);
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return 0;
+}
+
+int32_t qspiflash_stream_get(qspiflash_stream_t *stream, const uint8_t **data)
+{
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    uint32_t next = (stream->cur == QF_BUF_NONE) ? 0 : (stream->cur ^ 1);
+    int32_t ret;
+
+    if (stream->cur != QF_BUF_NONE) {
+        stream->state[stream->cur] = QF_BUF_FREE;
+    }
+    if (stream->fill == QF_BUF_NONE) {
+        if (stream->state[next] == QF_BUF_FREE) {
+            qf_stream_fill(stream, next);
+        } else if ((stream->cur != QF_BUF_NONE) && (stream->state[stream->cur] == QF_BUF_FREE)) {
+            qf_stream_fill(stream, stream->cur);
+        }
+    }
+    // the fill of next completes in interrupt, once it is no longer filling it stays full or error
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    __wfi_while_pending(&stream->state[next], QF_BUF_FILLING);
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if (stream->state[next] == QF_BUF_FULL) {
+        stream->cur = next;
+        *data = stream->buf[next];
+        ret = stream->len[next];
+    } else {
+        // end of stream, or error
+        stream->cur = QF_BUF_NONE;
+        ret = (stream->state[next] == QF_BUF_ERROR) ? -1 : 0;
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return ret;
+}
+
+void qspiflash_stream_close(qspiflash_stream_t *stream)
+{
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+
+    if (qspiflash_stream != stream) {
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+        return;
+    }
+    // no more read ahead, let the running one finish
+    stream->end = stream->next;
+    while (stream->fill != QF_BUF_NONE) {
+        __WFI();
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+        mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    }
+    qspiflash_stream = NULL;
+    qf_xip(1);
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
+
+__HOT_ILM int32_t qspiflash_erase(uint32_t addr, uint32_t len)
+{
+    uint32_t end = addr + len;
+    uint32_t start;
+    rv_csr_t mstatus;
+
+    if (((addr & (QSPIFLASH_SECTOR_SIZE - 1)) != 0) || (end > (1UL << qspiflash_cfg.size_log2)) ||
+        (end < addr) || QF_BUSY()) {
+        return -1;
+    }
+    for (; addr < end; addr += QSPIFLASH_SECTOR_SIZE) {
+        mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+        qf_xip_exit();
+        qf_cmd(QF_CMD_WREN);
+        qf_cmd_addr(QF_CMD_SE, addr);
+        start = __RV_CSR_READ(CSR_MCYCLE);
+        while (qf_read_reg(QF_CMD_RDSR) & QF_SR_WIP) {
+            if ((QSPIFLASH_SUSPEND_CYCLES == 0) || ((mstatus & MSTATUS_MIE) == 0) ||
+                ((uint32_t)(__RV_CSR_READ(CSR_MCYCLE) - start) < (uint32_t)QSPIFLASH_SUSPEND_CYCLES)) {
+                continue;
+            }
+            // suspend erase and open a window for pending interrupts, handlers may run from XIP
+            qf_cmd(QF_CMD_SUSPEND);
+            qf_wait_wip();
+            qf_xip_enter();
+            __RV_CSR_SET(CSR_MSTATUS, MSTATUS_MIE);
+            __NOP();
+            __RV_CSR_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+            qf_xip_exit();
+            qf_cmd(QF_CMD_RESUME);
+            start = __RV_CSR_READ(CSR_MCYCLE);
+        }
+        qf_xip_enter();
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    }
+    return 0;
+}
+
+__HOT_ILM int32_t qspiflash_program(uint32_t addr, const void *buf, uint32_t len)
+{
+    const uint8_t *src = (const uint8_t *)buf;
+    rv_csr_t mstatus;
+    uint32_t n, i;
+
+    if ((addr + len > (1UL << qspiflash_cfg.size_log2)) || (addr + len < addr) || QF_BUSY()) {
+        return -1;
+    }
+    while (len > 0) {
+        // one page program does not cross page boundary
+        n = QSPIFLASH_PAGE_SIZE - (addr & (QSPIFLASH_PAGE_SIZE - 1));
+        if (n > len) {
+            n = len;
+        }
+        mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+        qf_xip_exit();
+        qf_cmd(QF_CMD_WREN);
+        QSPI_DTLEN = n - 1;
+        QSPI_TCFG = QF_TCFG_CMD(QF_CMD_QPP) | QF_TCFG_ADDR | QSPI_DATA_4_LINES | QSPI_NORMAL_WRITE;
+        QSPI_ADDR = addr;
+        for (i = 0; i < n; i++) {
+            while ((QSPI_STAT & QSPI_STAT_FT) == 0) {
+            }
+            *(volatile uint8_t *)&QSPI_DATA = src[i];
+        }
+        qf_wait_tc();
+        qf_wait_wip();
+        qf_xip_enter();
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+        addr += n;
+        src += n;
+        len -= n;
+    }
+    return 0;
+}
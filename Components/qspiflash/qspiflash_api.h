@@ -0,0 +1,134 @@
+#ifndef _QSPIFLASH_API_H_
+#define _QSPIFLASH_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "dmaq_api.h"
+
+/*
+ * SPI NOR flash on the gd32vw55x QSPI, for code and assets in external flash.
+ *
+ * - XIP: the flash is memory-mapped at QSPI_FLASH with quad I/O fast read (0xEB), by default
+ *   in continuous read mode with the instruction sent once, so each miss only costs address,
+ *   mode and dummy cycles, and QSPI prefetches the following data while the bus is idle
+ * - Bulk read: qspiflash_read() and the read-ahead stream use indirect quad reads by dmaq on
+ *   the QSPI DMA channel, the stream fills one buffer while the caller uses the other one,
+ *   qspiflash_read_start() reads into any buffer in background and calls back when done
+ * - Program and erase: run from .ilm_text (__HOT_ILM) with interrupts disabled, since the
+ *   memory-mapped window is not readable while the flash is busy, erase is suspended every
+ *   QSPIFLASH_SUSPEND_CYCLES to re-enable XIP and take pending interrupts, then resumed,
+ *   so a 4KB sector erase does not block interrupts for its whole erase time
+ *
+ * The memory-mapped window is not readable while a DMA read or a stream is running, so with
+ * xip_code set, bulk reads copy from the window instead and streams are not allowed.
+ * Data programmed must be in RAM, not in the QSPI window.
+ *
+ * Commands are those common to GD25Q and W25Q series, the quad enable bit is set by the weak
+ * qspiflash_port_quad_enable(), override it for other flashes, it runs with XIP off, so it
+ * must be __HOT_ILM when code runs from the window. Pins and clock of QSPI are set up by
+ * qspiflash_port_init() of board code, the weak one does nothing.
+ */
+
+/* mode byte of XIP read, 0x20 enters continuous read mode, 0xFF sends instruction every read */
+#ifndef QSPIFLASH_XIP_MODE
+#define QSPIFLASH_XIP_MODE          0x20
+#endif
+
+/* mcycle between erase suspends, 0 to never suspend */
+#ifndef QSPIFLASH_SUSPEND_CYCLES
+#define QSPIFLASH_SUSPEND_CYCLES    (SystemCoreClock / 1000)
+#endif
+
+#define QSPIFLASH_SECTOR_SIZE       4096
+#define QSPIFLASH_PAGE_SIZE         256
+
+/* no DMA channel, read by CPU from memory-mapped window */
+#define QSPIFLASH_NO_DMA            0xFFFFFFFFUL
+
+typedef struct qspiflash_config {
+    uint32_t prescaler;             /* QSPI clock is AHB clock / (prescaler + 1), 0 ~ 255 */
+    uint32_t size_log2;             /* flash size is 2 ^ size_log2 bytes */
+    uint32_t dma_chan;              /* dmaq channel initialized with QSPI request, or QSPIFLASH_NO_DMA */
+    uint32_t xip_code;              /* 1 if code or interrupt handlers run from the window */
+} qspiflash_config_t;
+
+/* read-ahead stream, see qspiflash_stream_open() */
+typedef struct qspiflash_stream {
+    uint8_t *buf[2];                /* two buffers of chunk bytes, 4 bytes aligned */
+    uint32_t chunk;                 /* bytes of each buffer, multiple of 4, 4 ~ 65532 */
+    /* private */
+    uint32_t next;                  /* flash address to fill next */
+    uint32_t end;
+    uint32_t len[2];                /* bytes filled of each buffer */
+    volatile int32_t state[2];      /* buffer state */
+    uint8_t fill;                   /* buffer DMA is filling, or 2 if idle */
+    uint8_t cur;                    /* buffer returned to caller, or 2 if none */
+    dmaq_req_t req;
+} qspiflash_stream_t;
+
+struct qspiflash_job;
+/* completion callback of background read, called in interrupt, status is 0 or -1 */
+typedef void (*qspiflash_job_cb_t)(struct qspiflash_job *job, int32_t status, void *arg);
+
+/* background read, see qspiflash_read_start() */
+typedef struct qspiflash_job {
+    /* private */
+    uint32_t addr;                  /* flash address of running chunk */
+    uint8_t *dst;
+    uint32_t len;                   /* bytes from running chunk on */
+    uint32_t chunk;                 /* bytes of running chunk */
+    volatile int32_t status;        /* 1 while running, then 0 or -1 */
+    qspiflash_job_cb_t cb;
+    void *arg;
+    dmaq_req_t req;
+} qspiflash_job_t;
+
+/* Set up QSPI, enable quad I/O and enter XIP, return 0 on success, -1 on error */
+int32_t qspiflash_init(const qspiflash_config_t *cfg);
+
+/* Read len bytes from flash address addr, return 0 on success, -1 on error */
+int32_t qspiflash_read(uint32_t addr, void *buf, uint32_t len);
+
+/*
+ * Open stream reading len bytes from addr and start filling buf[0], return 0 on success,
+ * -1 if DMA is not usable or another stream is open, XIP is off until the stream is closed
+ */
+int32_t qspiflash_stream_open(qspiflash_stream_t *stream, uint32_t addr, uint32_t len);
+
+/*
+ * Get next chunk of stream, wait for it if not filled yet, the chunk returned before is given back
+ * to read ahead, return bytes at *data, 0 at end of stream or -1 on error
+ */
+int32_t qspiflash_stream_get(qspiflash_stream_t *stream, const uint8_t **data);
+
+/* Stop stream and enter XIP again */
+void qspiflash_stream_close(qspiflash_stream_t *stream);
+
+/*
+ * Start reading len bytes from addr into buf by DMA and return, cb is called when all is read
+ * or on error, XIP is off until then, return 0 on success, -1 if DMA is not usable or a
+ * stream or another background read is running
+ */
+int32_t qspiflash_read_start(qspiflash_job_t *job, uint32_t addr, void *buf, uint32_t len,
+                             qspiflash_job_cb_t cb, void *arg);
+
+/* Wait for background read of job, return 0 if all data was read, -1 on error */
+int32_t qspiflash_read_wait(qspiflash_job_t *job);
+
+/* Erase the 4KB sectors in addr ~ addr + len - 1, addr is sector aligned, return 0 on success */
+int32_t qspiflash_erase(uint32_t addr, uint32_t len);
+
+/* Program len bytes of buf in RAM to addr, the range must be erased, return 0 on success */
+int32_t qspiflash_program(uint32_t addr, const void *buf, uint32_t len);
+
+/* Port functions, weak default implementations can be overridden */
+void qspiflash_port_init(void);
+void qspiflash_port_quad_enable(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _QSPIFLASH_API_H_ */
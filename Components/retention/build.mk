@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# retention middleware saves core, ECLIC and SysTimer state and sleeps with a fast wake path,
+# powerdown mode needs startup code calling retention_resume and a NOLOAD .retention section
+MIDDLEWARE_RETENTION := $(NUCLEI_SDK_MIDDLEWARE)/retention
+
+C_SRCDIRS += $(MIDDLEWARE_RETENTION)
+
+INCDIRS += $(MIDDLEWARE_RETENTION)
@@ -0,0 +1,238 @@
+#include <stdint.h>
+#include <setjmp.h>
+#include "nuclei_sdk_soc.h"
+#include "retention_api.h"
+
+#define RETENTION_MAGIC         0x5254454EUL    /* "RTEN" */
+
+/* state lost in powerdown mode, sleep_* fields are sampled around the sleep instruction */
+typedef struct retention_ctx {
+    unsigned long magic;            /* RETENTION_MAGIC when stat is valid */
+    volatile unsigned long armed;   /* RETENTION_MAGIC from powerdown entry to wake */
+    uint32_t mode;
+    jmp_buf jmp;
+    rv_csr_t mstatus;
+    rv_csr_t mie;
+    rv_csr_t mtvec;
+    rv_csr_t mscratch;
+#if defined(__ECLIC_PRESENT) && (__ECLIC_PRESENT == 1)
+    rv_csr_t mtvt;
+    rv_csr_t mtvt2;
+#endif
+#if (defined(__ICACHE_PRESENT) && (__ICACHE_PRESENT == 1)) || (defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1))
+    rv_csr_t mcache_ctl;
+#endif
+#if defined(__riscv_flen)
+    rv_csr_t fcsr;
+#endif
+#if defined(__ECLIC_PRESENT) && (__ECLIC_PRESENT == 1)
+    uint8_t cliccfg;
+    uint8_t mth;
+    uint8_t intie[RETENTION_ECLIC_IRQS];
+    uint8_t intattr[RETENTION_ECLIC_IRQS];
+    uint8_t intctrl[RETENTION_ECLIC_IRQS];
+#endif
+#if defined(__SYSTIMER_PRESENT) && (__SYSTIMER_PRESENT == 1)
+    uint64_t mtimecmp;
+    uint32_t mtimectl;
+#endif
+    uint64_t deadline;
+    uint64_t sleep_mtime;
+    uint64_t wake_mtime;
+    uint32_t wake_cycle;
+    retention_stat_t stat;
+} retention_ctx_t;
+
+/*
+ * Kept in powerdown mode and not cleared by startup, place section .retention as NOLOAD
+ * in retained RAM, like:
+ *   .retention (NOLOAD) : ALIGN(8) { KEEP(*(.retention)) } >ram
+ */
+static retention_ctx_t retention_ctx __attribute__((section(".retention"), aligned(8)));
+
+static void retention_save(retention_ctx_t *ctx)
+{
+    uint32_t i;
+
+    ctx->mie = __RV_CSR_READ(CSR_MIE);
+    ctx->mtvec = __RV_CSR_READ(CSR_MTVEC);
+    ctx->mscratch = __RV_CSR_READ(CSR_MSCRATCH);
+#if defined(__ECLIC_PRESENT) && (__ECLIC_PRESENT == 1)
+    ctx->mtvt = __RV_CSR_READ(CSR_MTVT);
+    ctx->mtvt2 = __RV_CSR_READ(CSR_MTVT2);
+#endif
+#if (defined(__ICACHE_PRESENT) && (__ICACHE_PRESENT == 1)) || (defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1))
+    ctx->mcache_ctl = __RV_CSR_READ(CSR_MCACHE_CTL);
+#endif
+#if defined(__riscv_flen)
+    ctx->fcsr = __RV_CSR_READ(CSR_FCSR);
+#endif
+#if defined(__ECLIC_PRESENT) && (__ECLIC_PRESENT == 1)
+    ctx->cliccfg = ECLIC->CFG;
+    ctx->mth = ECLIC->MTH;
+    for (i = 0; i < RETENTION_ECLIC_IRQS; i++) {
+        ctx->intie[i] = ECLIC->CTRL[i].INTIE;
+        ctx->intattr[i] = ECLIC->CTRL[i].INTATTR;
+        ctx->intctrl[i] = ECLIC->CTRL[i].INTCTRL;
+    }
+#endif
+#if defined(__SYSTIMER_PRESENT) && (__SYSTIMER_PRESENT == 1)
+    ctx->mtimecmp = SysTimer_GetCompareValue();
+    ctx->mtimectl = SysTimer_GetControlValue();
+#endif
+}
+
+/* Run before .data/.bss init in powerdown wake, only touch ctx and registers */
+static void retention_restore(retention_ctx_t *ctx)
+{
+    uint32_t i;
+
+#if (defined(__ICACHE_PRESENT) && (__ICACHE_PRESENT == 1)) || (defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1))
+    __RV_CSR_WRITE(CSR_MCACHE_CTL, ctx->mcache_ctl);
+#endif
+#if defined(__SYSTIMER_PRESENT) && (__SYSTIMER_PRESENT == 1)
+    SysTimer_SetControlValue(ctx->mtimectl);
+    SysTimer_SetCompareValue(ctx->mtimecmp);
+#endif
+#if defined(__ECLIC_PRESENT) && (__ECLIC_PRESENT == 1)
+    ECLIC->CFG = ctx->cliccfg;
+    ECLIC->MTH = ctx->mth;
+    // attributes and levels first, so an interrupt enabled here is taken with its saved setting
+    for (i = 0; i < RETENTION_ECLIC_IRQS; i++) {
+        ECLIC->CTRL[i].INTATTR = ctx->intattr[i];
+        ECLIC->CTRL[i].INTCTRL = ctx->intctrl[i];
+    }
+    for (i = 0; i < RETENTION_ECLIC_IRQS; i++) {
+        ECLIC->CTRL[i].INTIE = ctx->intie[i];
+    }
+    __RV_CSR_WRITE(CSR_MTVT, ctx->mtvt);
+    __RV_CSR_WRITE(CSR_MTVT2, ctx->mtvt2);
+#endif
+    __RV_CSR_WRITE(CSR_MTVEC, ctx->mtvec);
+    __RV_CSR_WRITE(CSR_MSCRATCH, ctx->mscratch);
+    __RV_CSR_WRITE(CSR_MIE, ctx->mie);
+    // mstatus is restored at return of retention_suspend, FS must be on to write fcsr
+#if defined(__riscv_flen)
+    __RV_CSR_SET(CSR_MSTATUS, MSTATUS_FS);
+    __RV_CSR_WRITE(CSR_FCSR, ctx->fcsr);
+#endif
+    __RWMB();
+}
+
+#if defined(__GD32VF103_H__) || defined(GD32VW55x_H)
+/* deep-sleep mode of PMU, the system clock is IRC8M/IRC16M after wake, PLL and HXTAL are off */
+__WEAK int32_t retention_port_enter(uint32_t mode)
+{
+    if (mode != RETENTION_MODE_DEEPSLEEP) {
+        // standby mode loses SRAM
+        return -1;
+    }
+    rcu_periph_clock_enable(RCU_PMU);
+#if defined(__GD32VF103_H__)
+    pmu_to_deepsleepmode(PMU_LDO_LOWPOWER, WFI_CMD);
+#else
+    pmu_to_deepsleepmode(PMU_LDO_LOWPOWER, PMU_LOWDRIVER_ENABLE, WFI_CMD);
+#endif
+    return 0;
+}
+
+/* restart the clock tree only, the RCU reset done by SystemInit is not needed */
+__WEAK void retention_port_exit(uint32_t mode)
+{
+    system_clock_config();
+}
+#else
+__WEAK int32_t retention_port_enter(uint32_t mode)
+{
+    if (mode != RETENTION_MODE_DEEPSLEEP) {
+        return -1;
+    }
+    __set_wfi_sleepmode(WFI_DEEP_SLEEP);
+    __WFI();
+    __set_wfi_sleepmode(WFI_SHALLOW_SLEEP);
+    return 0;
+}
+
+__WEAK void retention_port_exit(uint32_t mode)
+{
+}
+#endif
+
+__WEAK int32_t retention_port_woke(void)
+{
+    return 0;
+}
+
+int32_t retention_suspend(uint32_t mode, uint64_t deadline)
+{
+    retention_ctx_t *ctx = &retention_ctx;
+    volatile int32_t ret = RETENTION_WAKE;
+    uint32_t cycle;
+
+    ctx->mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if (ctx->magic != RETENTION_MAGIC) {
+        ctx->stat = (retention_stat_t){0};
+        ctx->magic = RETENTION_MAGIC;
+    }
+    ctx->mode = mode;
+    ctx->deadline = deadline;
+    if (mode == RETENTION_MODE_POWERDOWN) {
+        retention_save(ctx);
+        if (setjmp(ctx->jmp) != 0) {
+            ret = RETENTION_WAKE_RESUME;
+            goto woke;
+        }
+        ctx->armed = RETENTION_MAGIC;
+    }
+    ctx->stat.suspends++;
+    ctx->sleep_mtime = SysTimer_GetLoadValue();
+    __RWMB();
+    if (retention_port_enter(ctx->mode) != 0) {
+        ctx->armed = 0;
+        ctx->stat.suspends--;
+        __RV_CSR_SET(CSR_MSTATUS, ctx->mstatus & MSTATUS_MIE);
+        return -1;
+    }
+    // first instruction after wake
+    ctx->wake_mtime = SysTimer_GetLoadValue();
+    ctx->wake_cycle = __RV_CSR_READ(CSR_MCYCLE);
+    ctx->armed = 0;
+woke:
+    // locals except ret are not valid here after longjmp
+    retention_port_exit(ctx->mode);
+    cycle = __RV_CSR_READ(CSR_MCYCLE);
+    ctx->stat.sleep_ticks = ctx->wake_mtime - ctx->sleep_mtime;
+    if ((ctx->deadline != RETENTION_NO_DEADLINE) && (ctx->wake_mtime > ctx->deadline)) {
+        ctx->stat.wake_latency = ctx->wake_mtime - ctx->deadline;
+    } else {
+        ctx->stat.wake_latency = 0;
+    }
+    ctx->stat.restore_cycles = cycle - ctx->wake_cycle;
+    __RV_CSR_WRITE(CSR_MSTATUS, ctx->mstatus);
+    return ret;
+}
+
+void retention_resume(void)
+{
+    retention_ctx_t *ctx = &retention_ctx;
+
+    if ((ctx->armed != RETENTION_MAGIC) || (retention_port_woke() == 0)) {
+        return;
+    }
+    // sampled before any restore, so restore_cycles covers this path
+    ctx->wake_mtime = SysTimer_GetLoadValue();
+    ctx->wake_cycle = __RV_CSR_READ(CSR_MCYCLE);
+    ctx->armed = 0;
+    ctx->stat.resumes++;
+    retention_restore(ctx);
+    longjmp(ctx->jmp, 1);
+}
+
+void retention_get_stat(retention_stat_t *stat)
+{
+    if (retention_ctx.magic == RETENTION_MAGIC) {
+        *stat = retention_ctx.stat;
+    } else {
+        *stat = (retention_stat_t){0};
+    }
+}
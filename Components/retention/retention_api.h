@@ -0,0 +1,93 @@
+#ifndef _RETENTION_API_H_
+#define _RETENTION_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include <setjmp.h>
+
+/*
+ * Sleep with state retention, for duty-cycled applications which sleep most of the time.
+ *
+ * retention_suspend() saves the core CSRs, ECLIC configuration and SysTimer state into
+ * the retention context, enters the sleep mode through the SoC port, and on wake takes
+ * the fast path: it restores only the state lost in that mode and returns to caller,
+ * SystemInit, _premain_init and .data/.bss init are not run again.
+ *
+ * - RETENTION_MODE_DEEPSLEEP: core clock is off and all the state is kept, execution
+ *   continues after wfi, the port restores the clock tree which the SoC switched to the
+ *   internal oscillator, on gd32vf103 and gd32vw55x it is the PMU deep-sleep mode
+ * - RETENTION_MODE_POWERDOWN: core state is lost and wake is a reset, the SRAM holding
+ *   the stack and the retention context must be kept. Startup code must call
+ *   retention_resume() right after sp and gp are set, before .data/.bss init, it returns
+ *   at once on a cold boot, or restores the saved state and jumps back into
+ *   retention_suspend(). The retention context is in section .retention, which must be
+ *   placed NOLOAD in the retained RAM by the linker script, so it is not cleared by
+ *   startup. The port tells a wake from a cold boot by retention_port_woke().
+ *
+ * Wake latency: mtime and mcycle are sampled at the first instruction after the sleep
+ * instruction returns, mtime minus the deadline passed to retention_suspend() is the
+ * wake-to-first-instruction latency when the SysTimer keeps counting during sleep and
+ * the wake source is the SysTimer interrupt at that deadline.
+ *
+ * Port: the weak retention_port_*() functions do plain deep-sleep wfi on other SoCs,
+ * gd32vf103 and gd32vw55x ports are built in, powerdown is not supported by them, their
+ * standby mode loses SRAM.
+ */
+
+/* ECLIC interrupts saved in context */
+#ifndef RETENTION_ECLIC_IRQS
+#define RETENTION_ECLIC_IRQS        SOC_INT_MAX
+#endif
+
+/* sleep modes */
+#define RETENTION_MODE_DEEPSLEEP    0
+#define RETENTION_MODE_POWERDOWN    1
+
+/* return value of retention_suspend() */
+#define RETENTION_WAKE              0       /* woke from sleep with state kept */
+#define RETENTION_WAKE_RESUME       1       /* woke from reset by retention_resume() */
+
+/* no deadline passed to retention_suspend() */
+#define RETENTION_NO_DEADLINE       UINT64_MAX
+
+/* statistics of last wake */
+typedef struct retention_stat {
+    uint32_t suspends;              /* times of sleep entered */
+    uint32_t resumes;               /* times of wake from reset */
+    uint64_t sleep_ticks;           /* mtime ticks from sleep to wake */
+    uint64_t wake_latency;          /* mtime ticks from deadline to first instruction, 0 without deadline */
+    uint32_t restore_cycles;        /* cycles from first instruction to retention_suspend() return */
+} retention_stat_t;
+
+/*
+ * Save state and sleep in mode until an enabled interrupt wakes the core, deadline is the
+ * mtime value of the programmed wakeup, or RETENTION_NO_DEADLINE.
+ * Return RETENTION_WAKE or RETENTION_WAKE_RESUME after wake, -1 if mode is not supported.
+ * Interrupts are disabled during sleep, the wakeup interrupt is taken when mstatus of caller is
+ * restored at return, so call it with interrupts enabled to run the handler.
+ */
+int32_t retention_suspend(uint32_t mode, uint64_t deadline);
+
+/* Called by startup code before .data/.bss init, return on cold boot, see above */
+void retention_resume(void);
+
+/* Get statistics */
+void retention_get_stat(retention_stat_t *stat);
+
+/*
+ * Port functions, weak default implementations can be overridden
+ * - retention_port_enter: enter mode, return after wake, or -1 if not supported
+ * - retention_port_exit: restore the SoC state lost in mode, such as clocks
+ * - retention_port_woke: return 1 if current reset is a wake from powerdown
+ */
+int32_t retention_port_enter(uint32_t mode);
+void retention_port_exit(uint32_t mode);
+int32_t retention_port_woke(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _RETENTION_API_H_ */
@@ -0,0 +1,14 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# rtt middleware provides ring buffer channels in ram read by debug probe in background,
+# RTT_STDOUT=1 sends printf output to its terminal channel instead of uart
+MIDDLEWARE_RTT := $(NUCLEI_SDK_MIDDLEWARE)/rtt
+
+C_SRCDIRS += $(MIDDLEWARE_RTT)
+
+INCDIRS += $(MIDDLEWARE_RTT)
+
+COMMON_FLAGS += -DNUCLEI_RTT=1
+
+ifeq ($(RTT_STDOUT),1)
+COMMON_FLAGS += -DNUCLEI_RTT_STDOUT=1
+endif
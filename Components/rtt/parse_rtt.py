@@ -0,0 +1,74 @@
+#!/bin/env python3
+
+import os
+import sys
+import struct
+import argparse
+
+RTT_FILE_MAGIC = 0x46545452
+RTT_FILE_REC = struct.Struct("<IIII")
+
+
+def split_rtt_files(data, outdir):
+    """
+    Split file records written by rtt_file_write() in rtt data channel into files
+
+    Args:
+        data (bytes): raw bytes received from rtt data channel
+        outdir (str): directory to store the files
+
+    Returns:
+        dict: file name and its size of each file completed
+    """
+    files = {}
+    opened = {}
+    pos = 0
+    while pos + RTT_FILE_REC.size <= len(data):
+        magic, offset, size, namelen = RTT_FILE_REC.unpack_from(data, pos)
+        if magic != RTT_FILE_MAGIC:
+            print(f"Error: Invalid record at byte {pos}, stop parsing", file=sys.stderr)
+            break
+        end = pos + RTT_FILE_REC.size + namelen + size
+        if end > len(data):
+            print(f"Warning: Record at byte {pos} is truncated, capture stopped too early?", file=sys.stderr)
+            break
+        name = data[pos + RTT_FILE_REC.size:pos + RTT_FILE_REC.size + namelen].decode(errors="replace")
+        chunk = data[pos + RTT_FILE_REC.size + namelen:end]
+        pos = end
+        path = os.path.join(outdir, name)
+        if size == 0:
+            # end of file
+            if name in opened:
+                opened.pop(name).close()
+                files[name] = os.path.getsize(path)
+            continue
+        if name not in opened:
+            if os.path.dirname(path):
+                os.makedirs(os.path.dirname(path), exist_ok=True)
+            opened[name] = open(path, "wb")
+        opened[name].seek(offset)
+        opened[name].write(chunk)
+    for name, fh in opened.items():
+        print(f"Warning: {name} is not completed", file=sys.stderr)
+        fh.close()
+    return files
+
+
+# Call in a Project Directory like this
+# NOTE: rtt_data.bin is the raw data of rtt channel 1, such as received by OpenOCD commands below
+#   rtt setup 0x90000000 0x10000 "SEGGER RTT"; rtt start; rtt server start 9091 1
+#   nc localhost 9091 > rtt_data.bin
+# python nuclei_sdk/Components/rtt/parse_rtt.py rtt_data.bin
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Split files sent through rtt data channel, such as gmon.out and gcda files")
+    parser.add_argument("datafile", help="raw data file of rtt data channel")
+    parser.add_argument("--outdir", default=".", help="output directory, file names sent by target are relative to it")
+    args = parser.parse_args()
+
+    if not os.path.isfile(args.datafile):
+        print(f"{args.datafile} does not exist. Please check!")
+        sys.exit(1)
+    with open(args.datafile, "rb") as df:
+        rawdata = df.read()
+    for fname, fsize in split_rtt_files(rawdata, args.outdir).items():
+        print(f"Generating {fname}, {fsize} bytes")
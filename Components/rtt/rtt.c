@@ -0,0 +1,266 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+#include "nuclei_sdk_soc.h"
+#include "rtt_api.h"
+
+#if RTT_UP_CHANNELS < 2
+#error "RTT_UP_CHANNELS must be at least 2 for the terminal and data channels"
+#endif
+#if RTT_DOWN_CHANNELS < 1
+#error "RTT_DOWN_CHANNELS must be at least 1 for the terminal channel"
+#endif
+
+/* mode of terminal up channel, printf output is dropped when host doesn't read in time */
+#ifndef RTT_TERMINAL_MODE
+#define RTT_TERMINAL_MODE           RTT_MODE_NO_BLOCK_SKIP
+#endif
+
+static uint8_t rtt_terminal_up[RTT_TERMINAL_UP_SIZE];
+static uint8_t rtt_terminal_down[RTT_TERMINAL_DOWN_SIZE];
+static uint8_t rtt_data_up[RTT_DATA_UP_SIZE];
+
+rtt_cb_t rtt_cb;
+
+#if defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1)
+static TicketLock_Type rtt_lock = TICKETLOCK_INIT;
+
+#define RTT_LOCK()                  rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE); \
+                                    TicketLock_Lock(&rtt_lock)
+#define RTT_UNLOCK()                TicketLock_Unlock(&rtt_lock); \
+                                    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE)
+#else
+#define RTT_LOCK()                  rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE)
+#define RTT_UNLOCK()                __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE)
+#endif
+
+#define RTT_CHECK_INIT()            do { if (rtt_cb.id[0] == 0) { rtt_init(); } } while (0)
+
+static void rtt_buffer_set(rtt_buffer_t *rb, const char *name, void *buf, uint32_t size, uint32_t mode)
+{
+    rb->name = name;
+    rb->buf = (uint8_t *)buf;
+    rb->size = size;
+    rb->wroff = 0;
+    rb->rdoff = 0;
+    rb->flags = mode & RTT_MODE_MASK;
+}
+
+void rtt_init(void)
+{
+    /* stored reversed, so only the initialized control block has the id in memory */
+    static const char id_rev[] = "TTR REGGES";
+    uint32_t i;
+
+    RTT_LOCK();
+    if (rtt_cb.id[0] == 0) {
+        memset(&rtt_cb, 0, sizeof(rtt_cb));
+        rtt_cb.max_up = RTT_UP_CHANNELS;
+        rtt_cb.max_down = RTT_DOWN_CHANNELS;
+        rtt_buffer_set(&rtt_cb.up[RTT_CHAN_TERMINAL], "Terminal", rtt_terminal_up, sizeof(rtt_terminal_up), RTT_TERMINAL_MODE);
+        rtt_buffer_set(&rtt_cb.up[RTT_CHAN_DATA], "Data", rtt_data_up, sizeof(rtt_data_up), RTT_MODE_BLOCK_IF_FULL);
+        rtt_buffer_set(&rtt_cb.down[RTT_CHAN_TERMINAL], "Terminal", rtt_terminal_down, sizeof(rtt_terminal_down),
+                       RTT_MODE_NO_BLOCK_SKIP);
+        // id is the last, the probe takes the channels once it finds the id
+        for (i = 1; i < sizeof(id_rev) - 1; i++) {
+            rtt_cb.id[i] = id_rev[sizeof(id_rev) - 2 - i];
+        }
+        __RWMB();
+        rtt_cb.id[0] = id_rev[sizeof(id_rev) - 2];
+        __RWMB();
+    }
+    RTT_UNLOCK();
+}
+
+static int32_t rtt_config(rtt_buffer_t *rb, const char *name, void *buf, uint32_t size, uint32_t mode)
+{
+    if ((buf == NULL) || (size < 2)) {
+        return RTT_EINVAL;
+    }
+    RTT_LOCK();
+    rtt_buffer_set(rb, name, buf, size, mode);
+    RTT_UNLOCK();
+    return 0;
+}
+
+int32_t rtt_config_up(uint32_t ch, const char *name, void *buf, uint32_t size, uint32_t mode)
+{
+    RTT_CHECK_INIT();
+    if (ch >= RTT_UP_CHANNELS) {
+        return RTT_EINVAL;
+    }
+    return rtt_config(&rtt_cb.up[ch], name, buf, size, mode);
+}
+
+int32_t rtt_config_down(uint32_t ch, const char *name, void *buf, uint32_t size, uint32_t mode)
+{
+    RTT_CHECK_INIT();
+    if (ch >= RTT_DOWN_CHANNELS) {
+        return RTT_EINVAL;
+    }
+    return rtt_config(&rtt_cb.down[ch], name, buf, size, mode);
+}
+
+/* bytes can be written to up ring, one byte is kept unused to tell full from empty */
+static uint32_t rtt_ring_free(const rtt_buffer_t *rb)
+{
+    uint32_t rd = rb->rdoff, wr = rb->wroff;
+
+    return (rd > wr) ? (rd - wr - 1) : (rb->size - wr + rd - 1);
+}
+
+/* Copy data into up ring, called with lock held, return bytes written */
+static size_t rtt_ring_write(rtt_buffer_t *rb, const uint8_t *data, size_t len, uint32_t mode)
+{
+    uint32_t wr = rb->wroff, avail, run;
+    size_t done = 0;
+
+    if (mode == RTT_MODE_NO_BLOCK_SKIP) {
+        if (rtt_ring_free(rb) < len) {
+            return 0;
+        }
+    } else if (mode == RTT_MODE_NO_BLOCK_TRIM) {
+        avail = rtt_ring_free(rb);
+        if (len > avail) {
+            len = avail;
+        }
+    }
+    while (done < len) {
+        avail = rtt_ring_free(rb);
+        if (avail == 0) {
+            // only RTT_MODE_BLOCK_IF_FULL gets here, wait for host to move rdoff
+            __CPU_RELAX();
+            continue;
+        }
+        run = rb->size - wr;
+        if (run > avail) {
+            run = avail;
+        }
+        if (run > len - done) {
+            run = len - done;
+        }
+        memcpy(rb->buf + wr, data + done, run);
+        done += run;
+        wr += run;
+        if (wr == rb->size) {
+            wr = 0;
+        }
+        // data must be visible before the offset telling host about it
+        __RWMB();
+        rb->wroff = wr;
+    }
+    return done;
+}
+
+size_t rtt_write(uint32_t ch, const void *data, size_t len)
+{
+    rtt_buffer_t *rb;
+    size_t done;
+
+    RTT_CHECK_INIT();
+    if ((ch >= RTT_UP_CHANNELS) || (rtt_cb.up[ch].buf == NULL)) {
+        return 0;
+    }
+    rb = &rtt_cb.up[ch];
+    RTT_LOCK();
+    done = rtt_ring_write(rb, (const uint8_t *)data, len, rb->flags & RTT_MODE_MASK);
+    RTT_UNLOCK();
+    return done;
+}
+
+uint32_t rtt_pending(uint32_t ch)
+{
+    const rtt_buffer_t *rb;
+
+    RTT_CHECK_INIT();
+    if ((ch >= RTT_UP_CHANNELS) || (rtt_cb.up[ch].buf == NULL)) {
+        return 0;
+    }
+    rb = &rtt_cb.up[ch];
+    return rb->size - 1 - rtt_ring_free(rb);
+}
+
+uint32_t rtt_has_data(uint32_t ch)
+{
+    const rtt_buffer_t *rb;
+    uint32_t rd, wr;
+
+    RTT_CHECK_INIT();
+    if ((ch >= RTT_DOWN_CHANNELS) || (rtt_cb.down[ch].buf == NULL)) {
+        return 0;
+    }
+    rb = &rtt_cb.down[ch];
+    rd = rb->rdoff;
+    wr = rb->wroff;
+    return (wr >= rd) ? (wr - rd) : (rb->size - rd + wr);
+}
+
+size_t rtt_read(uint32_t ch, void *buf, size_t len)
+{
+    rtt_buffer_t *rb;
+    uint8_t *ptr = (uint8_t *)buf;
+    uint32_t rd, wr, run;
+    size_t done = 0;
+
+    RTT_CHECK_INIT();
+    if ((ch >= RTT_DOWN_CHANNELS) || (rtt_cb.down[ch].buf == NULL)) {
+        return 0;
+    }
+    rb = &rtt_cb.down[ch];
+    RTT_LOCK();
+    rd = rb->rdoff;
+    while (done < len) {
+        wr = rb->wroff;
+        if (wr == rd) {
+            break;
+        }
+        // data written by host is read after its offset
+        __RWMB();
+        run = ((wr > rd) ? wr : rb->size) - rd;
+        if (run > len - done) {
+            run = len - done;
+        }
+        memcpy(ptr + done, rb->buf + rd, run);
+        done += run;
+        rd += run;
+        if (rd == rb->size) {
+            rd = 0;
+        }
+    }
+    __RWMB();
+    rb->rdoff = rd;
+    RTT_UNLOCK();
+    return done;
+}
+
+void rtt_file_write(const char *name, uint32_t offset, const void *data, uint32_t size)
+{
+    rtt_buffer_t *rb = &rtt_cb.up[RTT_CHAN_DATA];
+    rtt_file_rec_t rec;
+
+    RTT_CHECK_INIT();
+    rec.magic = RTT_FILE_MAGIC;
+    rec.offset = offset;
+    rec.size = size;
+    rec.namelen = strlen(name);
+    // a record is never dropped or split by other writers, or host loses the file boundary
+    RTT_LOCK();
+    rtt_ring_write(rb, (const uint8_t *)&rec, sizeof(rec), RTT_MODE_BLOCK_IF_FULL);
+    rtt_ring_write(rb, (const uint8_t *)name, rec.namelen, RTT_MODE_BLOCK_IF_FULL);
+    rtt_ring_write(rb, (const uint8_t *)data, size, RTT_MODE_BLOCK_IF_FULL);
+    RTT_UNLOCK();
+}
+
+#if defined(NUCLEI_RTT_STDOUT) && (NUCLEI_RTT_STDOUT == 1)
+/* Override weak _write of newlib stub, printf output goes to terminal channel */
+ssize_t _write(int fd, const void *ptr, size_t len)
+{
+    if (!isatty(fd)) {
+        return -1;
+    }
+    // the dropped part is not reported, or libc retries it forever when no host reads
+    rtt_write(RTT_CHAN_TERMINAL, ptr, len);
+    return len;
+}
+#endif
@@ -0,0 +1,129 @@
+#ifndef _RTT_API_H_
+#define _RTT_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Debugger memory transport of RTT(Real Time Transfer) style
+ *
+ * A control block in ram holds up channels(target to host) and down channels(host to target),
+ * each is a ring buffer with write and read offsets, the target only copies data into or out of
+ * ram, and a debug probe reads and writes the rings in background by memory access while the
+ * program runs, so output costs a memcpy instead of waiting for uart.
+ *
+ * - The control block layout and its "SEGGER RTT" id are the same as SEGGER RTT, so it is found
+ *   and served by OpenOCD `rtt setup`, `rtt start` and `rtt server start <port> <channel>` and
+ *   by J-Link RTT tools, pointers are 32 bits on rv32, a host tool must use 64 bits on rv64
+ * - Up channel RTT_CHAN_TERMINAL carries printf output when built with RTT_STDOUT=1, which
+ *   overrides _write of newlib stub, so BENCH results and NSDK_DEBUG logs go through it too
+ * - Up channel RTT_CHAN_DATA carries files, such as gprof_collect(4) and gcov_collect(4), or
+ *   dlog_collect and other raw dumps by rtt_file_write(), in records split into files by
+ *   parse_rtt.py on host, the channel blocks when full so no data is lost
+ * - Writes are serialized by disabling interrupts, and by a ticket lock in SMP, the probe must
+ *   access memory through the core, or the rings must be placed in non-cacheable memory
+ */
+
+/* up and down channel count, the 2 up channels below are always configured */
+#ifndef RTT_UP_CHANNELS
+#define RTT_UP_CHANNELS             3
+#endif
+#ifndef RTT_DOWN_CHANNELS
+#define RTT_DOWN_CHANNELS           1
+#endif
+
+/* ring size in bytes of default channels */
+#ifndef RTT_TERMINAL_UP_SIZE
+#define RTT_TERMINAL_UP_SIZE        1024
+#endif
+#ifndef RTT_TERMINAL_DOWN_SIZE
+#define RTT_TERMINAL_DOWN_SIZE      16
+#endif
+#ifndef RTT_DATA_UP_SIZE
+#define RTT_DATA_UP_SIZE            4096
+#endif
+
+/* default up channels */
+#define RTT_CHAN_TERMINAL           0       /* console, both up and down */
+#define RTT_CHAN_DATA               1       /* file records of rtt_file_write() */
+
+/* channel modes when ring is full, same values as SEGGER RTT flags */
+#define RTT_MODE_NO_BLOCK_SKIP      0       /* drop the whole write */
+#define RTT_MODE_NO_BLOCK_TRIM      1       /* write what fits, drop the rest */
+#define RTT_MODE_BLOCK_IF_FULL      2       /* wait for host to read */
+#define RTT_MODE_MASK               3
+
+/* errors of rtt_config_up() and rtt_config_down() */
+#define RTT_EINVAL                  -1
+
+/* magic of file records in RTT_CHAN_DATA */
+#define RTT_FILE_MAGIC              0x46545452UL    /* "RTTF" */
+
+/* one ring buffer, layout is shared with debug probe */
+typedef struct rtt_buffer {
+    const char *name;               /* channel name shown by host tools */
+    uint8_t *buf;                   /* ring buffer */
+    uint32_t size;                  /* ring size in bytes, one byte is kept unused */
+    volatile uint32_t wroff;        /* written by target for up, by host for down */
+    volatile uint32_t rdoff;        /* written by host for up, by target for down */
+    uint32_t flags;                 /* RTT_MODE_xxx */
+} rtt_buffer_t;
+
+/* control block, found by probe with its id */
+typedef struct rtt_cb {
+    char id[16];                    /* "SEGGER RTT", written last by rtt_init() */
+    int32_t max_up;
+    int32_t max_down;
+    rtt_buffer_t up[RTT_UP_CHANNELS];
+    rtt_buffer_t down[RTT_DOWN_CHANNELS];
+} rtt_cb_t;
+
+/*
+ * Header of file record in RTT_CHAN_DATA, followed by name of namelen bytes and size bytes of
+ * data, data is stored at offset of file name, size 0 marks end of the file
+ */
+typedef struct rtt_file_rec {
+    uint32_t magic;                 /* RTT_FILE_MAGIC */
+    uint32_t offset;
+    uint32_t size;
+    uint32_t namelen;
+} rtt_file_rec_t;
+
+extern rtt_cb_t rtt_cb;
+
+/* Init control block and default channels, called by the first rtt function if not called */
+void rtt_init(void);
+
+/*
+ * Config up channel ch of a ring of size bytes at buf, in mode RTT_MODE_xxx
+ * Return 0, or RTT_EINVAL if ch or the ring is invalid
+ */
+int32_t rtt_config_up(uint32_t ch, const char *name, void *buf, uint32_t size, uint32_t mode);
+
+/* Config down channel ch, see rtt_config_up() */
+int32_t rtt_config_down(uint32_t ch, const char *name, void *buf, uint32_t size, uint32_t mode);
+
+/* Write len bytes of data to up channel ch, return bytes written, which depends on mode when full */
+size_t rtt_write(uint32_t ch, const void *data, size_t len);
+
+/* Read at most len bytes from down channel ch into buf, return bytes read */
+size_t rtt_read(uint32_t ch, void *buf, size_t len);
+
+/* Return bytes available to read in down channel ch */
+uint32_t rtt_has_data(uint32_t ch);
+
+/* Return bytes written to up channel ch but not read by host yet */
+uint32_t rtt_pending(uint32_t ch);
+
+/* Write a record of size bytes of data at offset of file name to RTT_CHAN_DATA, size 0 ends the file */
+void rtt_file_write(const char *name, uint32_t offset, const void *data, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_RTT_API_H_ */
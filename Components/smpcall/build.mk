@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# smpcall middleware runs functions on other harts by inter-processor interrupts,
+# it requires SMP_CPU_CNT > 1 and atomic extension
+MIDDLEWARE_SMPCALL := $(NUCLEI_SDK_MIDDLEWARE)/smpcall
+
+C_SRCDIRS += $(MIDDLEWARE_SMPCALL)
+
+INCDIRS += $(MIDDLEWARE_SMPCALL)
@@ -0,0 +1,191 @@
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "smpcall_api.h"
+
+#if !defined(__riscv_atomic)
+#error "RVA(atomic) extension is required for smpcall"
+#endif
+
+#if (SMPCALL_MAX_HARTS > __RISCV_XLEN)
+#error "SMPCALL_MAX_HARTS must not be larger than bits of hart_mask"
+#endif
+
+/* queued calls of one hart in LIFO order, reversed when run */
+typedef struct smpcall_queue {
+    smpcall_req_t *volatile head;
+    smpcall_stat_t stat;
+    smpcall_req_t slots[SMPCALL_ASYNC_SLOTS];   /* asynchronous calls from the hart */
+} __ALIGNED(__SMP_CACHELINE_SIZE) smpcall_queue_t;
+
+static smpcall_queue_t smpcall_queues[SMPCALL_MAX_HARTS];
+/* harts taking calls */
+static volatile unsigned long smpcall_online = 0;
+
+#define SMPCALL_STAT_INC(q, member)     __atomic_fetch_add(&(q)->stat.member, 1, __ATOMIC_RELAXED)
+
+/* push req to queue, return 1 if queue was empty, then the target needs an IPI */
+static inline int smpcall_push(smpcall_queue_t *q, smpcall_req_t *req)
+{
+    smpcall_req_t *head = q->head;
+
+    do {
+        req->next = head;
+    } while (__atomic_compare_exchange_n(&q->head, &head, req, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED) == 0);
+    return head == NULL;
+}
+
+static inline void smpcall_send_ipi(unsigned long self, unsigned long target)
+{
+#if SMPCALL_USE_CIDU
+    CIDU_TriggerInterCoreInt(self, target);
+#else
+    SysTimer_SendIPI(target);
+#endif
+}
+
+/* take a free asynchronous slot of hart self, run own calls while all are in use */
+static smpcall_req_t *smpcall_alloc(unsigned long self)
+{
+    smpcall_req_t *slots = smpcall_queues[self].slots;
+    uint32_t i;
+
+    while (1) {
+        for (i = 0; i < SMPCALL_ASYNC_SLOTS; i++) {
+            if ((slots[i].busy == 0) && (__atomic_exchange_n(&slots[i].busy, 1, __ATOMIC_ACQUIRE) == 0)) {
+                return &slots[i];
+            }
+        }
+        smpcall_handle();
+        __CPU_RELAX();
+    }
+}
+
+int32_t smp_call_on(unsigned long hart_mask, smpcall_fn_t fn, void *arg, int wait)
+{
+    unsigned long self = __get_hart_index();
+    unsigned long others = hart_mask & ~(1UL << self);
+    unsigned long mask, target;
+    smpcall_req_t reqs[SMPCALL_MAX_HARTS];
+    smpcall_req_t *req;
+    volatile int32_t pending = 0;
+    int32_t cnt = 0;
+
+    if ((fn == NULL) || (self >= SMPCALL_MAX_HARTS) || (others & ~smpcall_online)) {
+        return SMPCALL_EINVAL;
+    }
+    SMPCALL_STAT_INC(&smpcall_queues[self], calls);
+    for (mask = others; mask != 0; mask &= mask - 1) {
+        cnt++;
+    }
+    pending = cnt;
+    __SMP_RWMB();
+    for (mask = others; mask != 0; mask &= mask - 1) {
+        target = __CTZL(mask);
+        if (wait == SMPCALL_WAIT) {
+            req = &reqs[target];
+            req->pending = &pending;
+        } else {
+            req = smpcall_alloc(self);
+            req->pending = NULL;
+        }
+        req->fn = fn;
+        req->arg = arg;
+        // a non-empty queue is already signaled and not taken yet
+        if (smpcall_push(&smpcall_queues[target], req)) {
+            smpcall_send_ipi(self, target);
+            SMPCALL_STAT_INC(&smpcall_queues[self], ipis);
+        }
+    }
+    if (hart_mask & (1UL << self)) {
+        fn(arg);
+        cnt++;
+    }
+    if (wait == SMPCALL_WAIT) {
+        while (pending != 0) {
+            smpcall_handle();
+            __CPU_RELAX();
+        }
+        __SMP_RWMB();
+    }
+    return cnt;
+}
+
+void smpcall_handle(void)
+{
+    smpcall_queue_t *q = &smpcall_queues[__get_hart_index()];
+    smpcall_req_t *req, *next, *prev = NULL;
+    volatile int32_t *pending;
+    smpcall_fn_t fn;
+    void *arg;
+
+    req = __atomic_exchange_n(&q->head, NULL, __ATOMIC_ACQUIRE);
+    while (req != NULL) {
+        next = req->next;
+        req->next = prev;
+        prev = req;
+        req = next;
+    }
+    for (req = prev; req != NULL; req = next) {
+        // req is freed by its caller once it is done, so read it out first
+        next = req->next;
+        fn = req->fn;
+        arg = req->arg;
+        pending = req->pending;
+        if (pending == NULL) {
+            __atomic_store_n(&req->busy, 0, __ATOMIC_RELEASE);
+        }
+        fn(arg);
+        SMPCALL_STAT_INC(q, runs);
+        if (pending != NULL) {
+            // make results of fn visible before the caller returns
+            __atomic_fetch_add(pending, -1, __ATOMIC_RELEASE);
+        }
+    }
+}
+
+/* IPI handler, it is non-vector so higher level interrupts can preempt calls */
+static void smpcall_ipi_handler(void)
+{
+    unsigned long self = __get_hart_index();
+#if SMPCALL_USE_CIDU
+    uint32_t senders = CIDU_QueryCoreIntSenderMask(self);
+
+    // cleared before calls are taken, so calls queued later raise it again
+    while (senders != 0) {
+        CIDU_ClearInterCoreIntReq(__CTZL(senders), self);
+        senders &= senders - 1;
+    }
+#else
+    SysTimer_ClearIPI(self);
+#endif
+    __RWMB();
+    smpcall_handle();
+}
+
+int32_t smpcall_init(uint8_t lvl)
+{
+    unsigned long self = __get_hart_index();
+    int32_t ret;
+
+    if (self >= SMPCALL_MAX_HARTS) {
+        return SMPCALL_EINVAL;
+    }
+#if SMPCALL_USE_CIDU
+    ret = ECLIC_Register_IRQ(InterCore_IRQn, ECLIC_NON_VECTOR_INTERRUPT, ECLIC_LEVEL_TRIGGER, lvl, 0,
+                             (void *)smpcall_ipi_handler);
+#else
+    ret = ECLIC_Register_IRQ(SysTimerSW_IRQn, ECLIC_NON_VECTOR_INTERRUPT, ECLIC_LEVEL_TRIGGER, lvl, 0,
+                             (void *)smpcall_ipi_handler);
+#endif
+    if (ret == 0) {
+        __atomic_fetch_or(&smpcall_online, 1UL << self, __ATOMIC_RELEASE);
+    }
+    return ret;
+}
+
+void smpcall_get_stat(unsigned long hartidx, smpcall_stat_t *stat)
+{
+    if (hartidx < SMPCALL_MAX_HARTS) {
+        *stat = smpcall_queues[hartidx].stat;
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef _SMPCALL_API_H_
+#define _SMPCALL_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+
+/*
+ * Cross-hart function call for SMP cores, like smp_call_function of linux.
+ *
+ * smp_call_on() queues fn(arg) to each hart in hart_mask and sends it an inter-processor
+ * interrupt, whose handler runs the calls queued to the hart in the order they are queued,
+ * so remote cache flushes, PMP updates or load balancing need no polling in the targets.
+ *
+ * - Queue: one lock-free queue of each hart, any hart can push calls to it, calls of a
+ *   synchronous call are on the stack of caller, and asynchronous ones take a free slot of
+ *   the SMPCALL_ASYNC_SLOTS slots of calling hart, which is freed before fn runs
+ * - IPI: the CIDU inter core interrupt when CIDU is present, otherwise the SysTimer software
+ *   interrupt, which is also used by softirq and task switch of RTOS ports, so build with
+ *   SMPCALL_USE_CIDU=1 in the cases, set it to 0 to use the SysTimer one anyway
+ * - The calling hart in hart_mask runs fn directly, after the IPIs of others are sent
+ * - A hart waiting for calls to finish or for a free slot runs the calls queued to itself,
+ *   so harts calling each other with interrupts disabled don't dead lock
+ * - RVA(atomic) extension is required
+ *
+ * Usage: call smpcall_init() on each hart taking calls, then smp_call_on() any hart
+ */
+
+/* number of harts using smpcall, hart index must be less than it */
+#ifndef SMPCALL_MAX_HARTS
+#if defined(SMP_CPU_CNT)
+#define SMPCALL_MAX_HARTS       SMP_CPU_CNT
+#else
+#define SMPCALL_MAX_HARTS       1
+#endif
+#endif
+
+/* asynchronous calls of one hart not run yet at most */
+#ifndef SMPCALL_ASYNC_SLOTS
+#define SMPCALL_ASYNC_SLOTS     8
+#endif
+
+/* IPI by CIDU inter core interrupt, or by SysTimer software interrupt */
+#ifndef SMPCALL_USE_CIDU
+#if defined(__CIDU_PRESENT) && (__CIDU_PRESENT == 1)
+#define SMPCALL_USE_CIDU        1
+#else
+#define SMPCALL_USE_CIDU        0
+#endif
+#endif
+
+/* wait argument of smp_call_on() */
+#define SMPCALL_NOWAIT          0   /* fire and forget, return after calls are queued */
+#define SMPCALL_WAIT            1   /* return after fn returns in all harts */
+
+/* errors of smp_call_on() */
+#define SMPCALL_EINVAL          -1  /* fn is NULL, or hart not initialized by smpcall_init() in hart_mask */
+
+/* function called on other harts, it runs in interrupt handler */
+typedef void (*smpcall_fn_t)(void *arg);
+
+/* one call queued to a hart */
+typedef struct smpcall_req {
+    struct smpcall_req *next;
+    smpcall_fn_t fn;
+    void *arg;
+    volatile int32_t *pending;      /* decreased when done for synchronous call, else NULL */
+    volatile uint32_t busy;         /* 1 when asynchronous slot is queued and not run */
+} smpcall_req_t;
+
+/* statistics of one hart */
+typedef struct smpcall_stat {
+    uint32_t calls;                 /* times of smp_call_on() called on the hart */
+    uint32_t ipis;                  /* IPIs sent by the hart */
+    uint32_t runs;                  /* calls from any hart run on the hart */
+} smpcall_stat_t;
+
+/* Install IPI handler at lvl and take calls on current hart, called on each hart */
+int32_t smpcall_init(uint8_t lvl);
+
+/*
+ * Call fn(arg) on each hart whose index bit is set in hart_mask, and wait for them to
+ * return when wait is SMPCALL_WAIT, it can be called in tasks and interrupt handlers
+ * Return number of harts called, or SMPCALL_EINVAL
+ */
+int32_t smp_call_on(unsigned long hart_mask, smpcall_fn_t fn, void *arg, int wait);
+
+/* Run calls queued to current hart, called by IPI handler, or by RTOS port sharing the interrupt */
+void smpcall_handle(void);
+
+/* Get statistics of hart */
+void smpcall_get_stat(unsigned long hartidx, smpcall_stat_t *stat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_SMPCALL_API_H_ */
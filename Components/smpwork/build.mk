@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# smpwork middleware is a bare-metal work-stealing task pool for SMP cores,
+# it requires SMP_CPU_CNT > 1 and atomic extension
+MIDDLEWARE_SMPWORK := $(NUCLEI_SDK_MIDDLEWARE)/smpwork
+
+C_SRCDIRS += $(MIDDLEWARE_SMPWORK)
+
+INCDIRS += $(MIDDLEWARE_SMPWORK)
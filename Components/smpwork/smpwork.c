@@ -0,0 +1,166 @@
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "smpwork_api.h"
+
+#if !defined(__riscv_atomic)
+#error "RVA(atomic) extension is required for smpwork"
+#endif
+
+/* range task, pending is decreased by size of range when it is done */
+typedef struct smpwork_task {
+    smpwork_fn_t fn;
+    void *arg;
+    unsigned long begin;
+    unsigned long end;
+    unsigned long grain;
+    volatile int32_t *pending;
+} smpwork_task_t;
+
+/* task deque of one hart, top is stolen by other harts, bottom is used by owner */
+typedef struct smpwork_deque {
+    TicketLock_Type lock;
+    volatile uint32_t top;
+    volatile uint32_t bottom;
+    smpwork_task_t tasks[SMPWORK_DEQUE_SIZE];
+} __ALIGNED(__SMP_CACHELINE_SIZE) smpwork_deque_t;
+
+static smpwork_deque_t smpwork_deques[SMPWORK_MAX_HARTS];
+static SpinBarrier_Type smpwork_bar = SPINBARRIER_INIT(SMPWORK_MAX_HARTS);
+static volatile uint32_t smpwork_stopped = 0;
+
+/* push task to bottom of deque, return -1 if deque is full */
+static int smpwork_push(smpwork_deque_t *dq, const smpwork_task_t *task)
+{
+    int ret = -1;
+
+    TicketLock_Lock(&dq->lock);
+    if (dq->bottom - dq->top < SMPWORK_DEQUE_SIZE) {
+        dq->tasks[dq->bottom % SMPWORK_DEQUE_SIZE] = *task;
+        dq->bottom++;
+        ret = 0;
+    }
+    TicketLock_Unlock(&dq->lock);
+    return ret;
+}
+
+/* pop task from bottom of own deque, or top of other deque when steal is 1 */
+static int smpwork_pop(smpwork_deque_t *dq, smpwork_task_t *task, int steal)
+{
+    int ret = -1;
+
+    // check without lock first, so idle harts don't keep taking the lock of empty deques
+    if (dq->bottom == dq->top) {
+        return -1;
+    }
+    TicketLock_Lock(&dq->lock);
+    if (dq->bottom != dq->top) {
+        if (steal) {
+            *task = dq->tasks[dq->top % SMPWORK_DEQUE_SIZE];
+            dq->top++;
+        } else {
+            dq->bottom--;
+            *task = dq->tasks[dq->bottom % SMPWORK_DEQUE_SIZE];
+        }
+        ret = 0;
+    }
+    TicketLock_Unlock(&dq->lock);
+    return ret;
+}
+
+/* split off upper halves until range fits grain or deque is full, then run it */
+static void smpwork_execute(smpwork_deque_t *dq, smpwork_task_t *task)
+{
+    smpwork_task_t upper = *task;
+    unsigned long mid;
+
+    while (task->end - task->begin > task->grain) {
+        mid = task->begin + (task->end - task->begin) / 2;
+        upper.begin = mid;
+        upper.end = task->end;
+        if (smpwork_push(dq, &upper) != 0) {
+            break;
+        }
+        task->end = mid;
+    }
+    task->fn(task->arg, task->begin, task->end);
+    // make results visible before the range is reported done
+    __SMP_RWMB();
+    __AMOADD_W(task->pending, -(int32_t)(task->end - task->begin));
+}
+
+/* run one task from own deque or stolen from others, return 0 if no task found */
+static int smpwork_run_one(unsigned long self)
+{
+    smpwork_task_t task;
+
+    if (smpwork_pop(&smpwork_deques[self], &task, 0) == 0) {
+        smpwork_execute(&smpwork_deques[self], &task);
+        return 1;
+    }
+    for (unsigned long i = 1; i < SMPWORK_MAX_HARTS; i++) {
+        unsigned long victim = (self + i) % SMPWORK_MAX_HARTS;
+        if (smpwork_pop(&smpwork_deques[victim], &task, 1) == 0) {
+            smpwork_execute(&smpwork_deques[self], &task);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void smpwork_idle(void)
+{
+    for (volatile uint32_t i = 0; i < SMPWORK_IDLE_BACKOFF; i++) {
+        __NOP();
+    }
+}
+
+void smpwork_parallel_for(unsigned long begin, unsigned long end, unsigned long grain, smpwork_fn_t fn, void *arg)
+{
+    unsigned long self = __get_hart_index();
+    volatile int32_t pending;
+    smpwork_task_t task;
+
+    if ((end <= begin) || (fn == NULL)) {
+        return;
+    }
+    pending = (int32_t)(end - begin);
+    task.fn = fn;
+    task.arg = arg;
+    task.begin = begin;
+    task.end = end;
+    task.grain = (grain == 0) ? 1 : grain;
+    task.pending = &pending;
+    __SMP_RWMB();
+    // run it directly when own deque is full, such as in deeply nested loops
+    if (smpwork_push(&smpwork_deques[self], &task) != 0) {
+        smpwork_execute(&smpwork_deques[self], &task);
+    }
+    while (pending != 0) {
+        if (smpwork_run_one(self) == 0) {
+            smpwork_idle();
+        }
+    }
+    __SMP_RWMB();
+}
+
+void smpwork_worker(void)
+{
+    unsigned long self = __get_hart_index();
+
+    while (smpwork_stopped == 0) {
+        if (smpwork_run_one(self) == 0) {
+            smpwork_idle();
+        }
+    }
+}
+
+void smpwork_stop(void)
+{
+    smpwork_stopped = 1;
+    __SMP_RWMB();
+}
+
+void smpwork_barrier(void)
+{
+    SpinBarrier_Wait(&smpwork_bar);
+}
@@ -0,0 +1,69 @@
+#ifndef _SMPWORK_API_H_
+#define _SMPWORK_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*
+ * Bare-metal work-stealing task pool for SMP cores.
+ *
+ * Each hart owns a task deque, the hart pushes and pops tasks at the bottom of its own
+ * deque, and steals tasks from the top of other harts' deques when its own deque is empty.
+ *
+ * smpwork_parallel_for() splits a range lazily: a hart running a range larger than grain
+ * pushes the upper half back to its deque, so idle harts can steal it, and runs the lower
+ * half by itself, so only the big ranges are moved between harts.
+ *
+ * Usage in smp_main:
+ * - boot hart: call smpwork_parallel_for() as many times as needed, then smpwork_stop()
+ * - other harts: call smpwork_worker(), it returns after smpwork_stop() is called
+ */
+
+/* number of harts join the task pool, hart index must be less than it */
+#ifndef SMPWORK_MAX_HARTS
+#if defined(SMP_CPU_CNT)
+#define SMPWORK_MAX_HARTS       SMP_CPU_CNT
+#else
+#define SMPWORK_MAX_HARTS       1
+#endif
+#endif
+
+/* max tasks in deque of each hart, range is not split when deque is full */
+#ifndef SMPWORK_DEQUE_SIZE
+#define SMPWORK_DEQUE_SIZE      32
+#endif
+
+/* spin loops waited when no task can be found */
+#ifndef SMPWORK_IDLE_BACKOFF
+#define SMPWORK_IDLE_BACKOFF    64
+#endif
+
+/* function to process range [begin, end) */
+typedef void (*smpwork_fn_t)(void *arg, unsigned long begin, unsigned long end);
+
+/*
+ * Run fn on range [begin, end) in all the harts join the task pool, and return after
+ * the whole range is done, the calling hart also runs tasks while waiting
+ * - grain: max size of range passed to fn, 0 is the same as 1
+ * - range size must be less than 2^31
+ * It can be called in any hart, and can be called in fn for nested parallel loops
+ */
+void smpwork_parallel_for(unsigned long begin, unsigned long end, unsigned long grain, smpwork_fn_t fn, void *arg);
+
+/* Run tasks of the pool until smpwork_stop() is called, called by harts other than the one calling smpwork_parallel_for */
+void smpwork_worker(void);
+
+/* Make smpwork_worker() return in all the harts */
+void smpwork_stop(void);
+
+/* Wait until all the SMPWORK_MAX_HARTS harts call it */
+void smpwork_barrier(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_SMPWORK_API_H_ */
@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# softirq middleware defers interrupt work to SysTimer software interrupt,
+# in RTOS builds, define NUCLEI_SOFTIRQ=1 to let the port run it in task switch
+MIDDLEWARE_SOFTIRQ := $(NUCLEI_SDK_MIDDLEWARE)/softirq
+
+C_SRCDIRS += $(MIDDLEWARE_SOFTIRQ)
+
+INCDIRS += $(MIDDLEWARE_SOFTIRQ)
@@ -0,0 +1,154 @@
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "softirq_api.h"
+
+/* queued works of one hart in LIFO order, reversed when run */
+typedef struct softirq_queue {
+    softirq_work_t *volatile head;
+    softirq_stat_t stat;
+} softirq_queue_t;
+
+static softirq_queue_t softirq_queues[SOFTIRQ_MAX_HARTS];
+
+#if defined(__riscv_atomic)
+/* set pending of work, return the old value */
+#define SOFTIRQ_SET_PENDING(work)       __atomic_exchange_n(&(work)->pending, 1, __ATOMIC_ACQUIRE)
+#define SOFTIRQ_STAT_INC(q, member)     __atomic_fetch_add(&(q)->stat.member, 1, __ATOMIC_RELAXED)
+
+static inline void softirq_push(softirq_queue_t *q, softirq_work_t *work)
+{
+    softirq_work_t *head = q->head;
+
+    do {
+        work->next = head;
+    } while (__atomic_compare_exchange_n(&q->head, &head, work, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED) == 0);
+}
+
+static inline softirq_work_t *softirq_take(softirq_queue_t *q)
+{
+    return __atomic_exchange_n(&q->head, NULL, __ATOMIC_ACQUIRE);
+}
+#else
+/* only interrupt handlers of the same hart access the queue without atomic extension */
+static inline uint32_t softirq_set_pending(softirq_work_t *work)
+{
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    uint32_t old = work->pending;
+
+    work->pending = 1;
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return old;
+}
+#define SOFTIRQ_SET_PENDING(work)       softirq_set_pending(work)
+#define SOFTIRQ_STAT_INC(q, member)     ((q)->stat.member++)
+
+static inline void softirq_push(softirq_queue_t *q, softirq_work_t *work)
+{
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+
+    work->next = q->head;
+    q->head = work;
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
+
+static inline softirq_work_t *softirq_take(softirq_queue_t *q)
+{
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    softirq_work_t *head = q->head;
+
+    q->head = NULL;
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return head;
+}
+#endif
+
+void softirq_work_init(softirq_work_t *work, softirq_fn_t fn, void *arg)
+{
+    work->next = NULL;
+    work->fn = fn;
+    work->arg = arg;
+    work->pending = 0;
+    work->runs = 0;
+}
+
+int softirq_raise(softirq_work_t *work)
+{
+    softirq_queue_t *q = &softirq_queues[__get_hart_index()];
+
+    SOFTIRQ_STAT_INC(q, raises);
+    // coalesced into the queued one
+    if (SOFTIRQ_SET_PENDING(work) != 0) {
+        return 0;
+    }
+    softirq_push(q, work);
+    SysTimer_SetSWIRQ();
+    return 1;
+}
+
+void softirq_run(void)
+{
+    softirq_queue_t *q = &softirq_queues[__get_hart_index()];
+    softirq_work_t *work, *next, *prev = NULL;
+    unsigned long cnt = 0;
+    rv_csr_t mstatus;
+
+    // take the works and push back the ones over batch before any new work is raised,
+    // so works run in raised order, the queue only holds each work once so it is short
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    work = softirq_take(q);
+    while (work != NULL) {
+        next = work->next;
+        work->next = prev;
+        prev = work;
+        work = next;
+    }
+    for (work = prev; work != NULL; work = work->next) {
+        if (++cnt == SOFTIRQ_BATCH) {
+            for (next = work->next, work->next = NULL; next != NULL; next = work) {
+                work = next->next;
+                softirq_push(q, next);
+            }
+            break;
+        }
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    if (prev == NULL) {
+        return;
+    }
+
+    cnt = 0;
+    for (work = prev; work != NULL; work = next) {
+        next = work->next;
+        // cleared before the device data is read, so the data coming later raises it again
+        work->pending = 0;
+        __RWMB();
+        work->fn(work->arg);
+        work->runs++;
+        cnt++;
+    }
+    q->stat.runs += cnt;
+    q->stat.batches++;
+    if (q->head != NULL) {
+        SysTimer_SetSWIRQ();
+    }
+}
+
+/* bare-metal software interrupt handler, it is non-vector so higher level interrupts can preempt works */
+static void softirq_swi_handler(void)
+{
+    SysTimer_ClearSWIRQ();
+    softirq_run();
+}
+
+int32_t softirq_init(uint8_t lvl)
+{
+    return ECLIC_Register_IRQ(SysTimerSW_IRQn, ECLIC_NON_VECTOR_INTERRUPT, ECLIC_LEVEL_TRIGGER, lvl, 0,
+                              (void *)softirq_swi_handler);
+}
+
+void softirq_get_stat(unsigned long hartidx, softirq_stat_t *stat)
+{
+    if (hartidx < SOFTIRQ_MAX_HARTS) {
+        *stat = softirq_queues[hartidx].stat;
+    }
+}
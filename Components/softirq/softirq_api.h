@@ -0,0 +1,91 @@
+#ifndef _SOFTIRQ_API_H_
+#define _SOFTIRQ_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*
+ * Deferred interrupt work, like tasklets of linux.
+ *
+ * Top half interrupt handlers call softirq_raise() to queue a work into the queue of
+ * current hart, and pend the SysTimer software interrupt, which runs all the queued
+ * works in batches by softirq_run() at the lowest interrupt level, so the high rate
+ * interrupts just do the minimal work and the expensive part is done once for many
+ * of them.
+ *
+ * - A work raised again before it runs is queued only once, so the raises are coalesced,
+ *   the work should process all the data pending in its device
+ * - Works of one hart run in the order they are raised, a work clears its pending state
+ *   before it runs, so it can be raised again by itself or by interrupts during it runs
+ * - Queue is lock-free with atomic extension, and protected by disabling interrupts without it
+ *
+ * Usage:
+ * - bare-metal: call softirq_init() on each hart using it, it installs the SysTimer
+ *   software interrupt handler, which requires a writable vector table, so build with
+ *   NUCLEI_VECTOR_RAM=1 in flashxip download mode
+ * - RTOS: the software interrupt is used for task switch, compile with NUCLEI_SOFTIRQ=1,
+ *   the FreeRTOS and RT-Thread ports run softirq_run() in task switch before selecting
+ *   next task, so tasks woken by works are switched to at once, don't call softirq_init()
+ */
+
+/* number of harts using softirq, hart index must be less than it */
+#ifndef SOFTIRQ_MAX_HARTS
+#if defined(SMP_CPU_CNT)
+#define SOFTIRQ_MAX_HARTS       SMP_CPU_CNT
+#else
+#define SOFTIRQ_MAX_HARTS       1
+#endif
+#endif
+
+/* max works run in one software interrupt, others run in next software interrupt */
+#ifndef SOFTIRQ_BATCH
+#define SOFTIRQ_BATCH           16
+#endif
+
+/* function of deferred work */
+typedef void (*softirq_fn_t)(void *arg);
+
+/* deferred work, initialize it by softirq_work_init() or SOFTIRQ_WORK_INIT */
+typedef struct softirq_work {
+    struct softirq_work *next;
+    softirq_fn_t fn;
+    void *arg;
+    volatile uint32_t pending;      /* 1 when queued and not run yet */
+    uint32_t runs;                  /* times of work run */
+} softirq_work_t;
+
+#define SOFTIRQ_WORK_INIT(fn, arg)      { 0, (fn), (arg), 0, 0 }
+
+/* statistics of one hart */
+typedef struct softirq_stat {
+    uint32_t raises;                /* times of softirq_raise() called */
+    uint32_t runs;                  /* times of works run, raises - runs are coalesced */
+    uint32_t batches;               /* times of softirq_run() run at least one work */
+} softirq_stat_t;
+
+/* Initialize work to run fn(arg) */
+void softirq_work_init(softirq_work_t *work, softirq_fn_t fn, void *arg);
+
+/*
+ * Queue work to current hart and pend software interrupt, it can be called in interrupt
+ * handlers and tasks, return 1 if work is queued, 0 if it is already pending
+ */
+int softirq_raise(softirq_work_t *work);
+
+/* Run queued works of current hart, called by software interrupt handler */
+void softirq_run(void);
+
+/* Install SysTimer software interrupt handler at lvl for bare-metal, called on each hart */
+int32_t softirq_init(uint8_t lvl);
+
+/* Get statistics of hart */
+void softirq_get_stat(unsigned long hartidx, softirq_stat_t *stat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_SOFTIRQ_API_H_ */
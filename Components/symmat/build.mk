@@ -0,0 +1,8 @@
+# Should alway define variable MIDDLEWARE_$(MID_UPPER) to path to the middleware,
+# symmat middleware provides packed symmetric and band matrices, band multiplication, rank k
+# updates and in-place LDLT with triangular solves for Kalman filters, add nmsis_dsp to NMSIS_LIB too
+MIDDLEWARE_SYMMAT := $(NUCLEI_SDK_MIDDLEWARE)/symmat
+
+C_SRCDIRS += $(MIDDLEWARE_SYMMAT)
+
+INCDIRS += $(MIDDLEWARE_SYMMAT)
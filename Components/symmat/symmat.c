@@ -0,0 +1,314 @@
+#include <stdint.h>
+#include <math.h>
+#include "riscv_math.h"
+#include "symmat_api.h"
+
+/* element (i, j) of packed a, any order of i and j */
+static inline float32_t symmat_packed_at(const symmat_packed_f32 *a, uint32_t i, uint32_t j)
+{
+    return (j <= i) ? a->pData[SYMMAT_PACKED_IDX(i, j)] : a->pData[SYMMAT_PACKED_IDX(j, i)];
+}
+
+/* first and last column kept in row i of band a */
+static inline void symmat_band_cols(const symmat_band_f32 *a, uint32_t i, uint32_t *first, uint32_t *last)
+{
+    *first = (i > a->lower) ? (i - a->lower) : 0;
+    *last = i + a->upper;
+    if (*last >= a->numCols) {
+        *last = a->numCols - 1U;
+    }
+}
+
+/* pointer to element (i, j) of band a */
+static inline float32_t *symmat_band_ptr(const symmat_band_f32 *a, uint32_t i, uint32_t j)
+{
+    return a->pData + i * ((uint32_t)a->lower + a->upper + 1U) + j + a->lower - i;
+}
+
+riscv_status symmat_pack_f32(const riscv_matrix_instance_f32 *src, symmat_packed_f32 *dst)
+{
+    float32_t *out = dst->pData;
+    uint32_t i, j;
+
+    if ((src->numRows != src->numCols) || (src->numRows != dst->n)) {
+        return RISCV_MATH_SIZE_MISMATCH;
+    }
+    for (i = 0; i < dst->n; i++) {
+        for (j = 0; j <= i; j++) {
+            *out++ = src->pData[i * src->numCols + j];
+        }
+    }
+    return RISCV_MATH_SUCCESS;
+}
+
+riscv_status symmat_unpack_f32(const symmat_packed_f32 *src, riscv_matrix_instance_f32 *dst)
+{
+    const float32_t *in = src->pData;
+    uint32_t n = src->n;
+    uint32_t i, j;
+
+    if ((dst->numRows != n) || (dst->numCols != n)) {
+        return RISCV_MATH_SIZE_MISMATCH;
+    }
+    for (i = 0; i < n; i++) {
+        for (j = 0; j <= i; j++) {
+            dst->pData[i * n + j] = *in;
+            dst->pData[j * n + i] = *in++;
+        }
+    }
+    return RISCV_MATH_SUCCESS;
+}
+
+riscv_status symmat_band_from_dense_f32(const riscv_matrix_instance_f32 *src, symmat_band_f32 *dst)
+{
+    uint32_t i, j, first, last;
+
+    if ((src->numRows != dst->numRows) || (src->numCols != dst->numCols)) {
+        return RISCV_MATH_SIZE_MISMATCH;
+    }
+    for (i = 0; i < dst->numRows; i++) {
+        symmat_band_cols(dst, i, &first, &last);
+        for (j = first; j <= last; j++) {
+            *symmat_band_ptr(dst, i, j) = src->pData[i * src->numCols + j];
+        }
+    }
+    return RISCV_MATH_SUCCESS;
+}
+
+riscv_status symmat_band_mult_f32(const symmat_band_f32 *a, const riscv_matrix_instance_f32 *b,
+                                  riscv_matrix_instance_f32 *dst)
+{
+    uint32_t cols = b->numCols;
+    uint32_t i, j, k, first, last;
+    const float32_t *pa;
+    float32_t *out;
+
+    if ((a->numCols != b->numRows) || (a->numRows != dst->numRows) || (cols != dst->numCols)) {
+        return RISCV_MATH_SIZE_MISMATCH;
+    }
+    for (i = 0; i < a->numRows; i++) {
+        out = dst->pData + i * cols;
+        for (j = 0; j < cols; j++) {
+            out[j] = 0.0f;
+        }
+        symmat_band_cols(a, i, &first, &last);
+        pa = symmat_band_ptr(a, i, first);
+        // row i of dst accumulates the rows of b in the band only
+        for (k = first; k <= last; k++) {
+            const float32_t *pb = b->pData + k * cols;
+            float32_t aik = *pa++;
+
+            for (j = 0; j < cols; j++) {
+                out[j] += aik * pb[j];
+            }
+        }
+    }
+    return RISCV_MATH_SUCCESS;
+}
+
+riscv_status symmat_packed_mult_f32(const symmat_packed_f32 *a, const riscv_matrix_instance_f32 *b,
+                                    riscv_matrix_instance_f32 *dst)
+{
+    uint32_t n = a->n;
+    uint32_t cols = b->numCols;
+    uint32_t i, j, k;
+    const float32_t *row;
+    float32_t aik;
+
+    if ((b->numRows != n) || (dst->numRows != n) || (dst->numCols != cols)) {
+        return RISCV_MATH_SIZE_MISMATCH;
+    }
+    for (i = 0; i < n * cols; i++) {
+        dst->pData[i] = 0.0f;
+    }
+    // each stored element (i, k) below the diagonal is used for both (i, k) and (k, i)
+    for (i = 0; i < n; i++) {
+        row = a->pData + SYMMAT_PACKED_IDX(i, 0);
+        for (k = 0; k < i; k++) {
+            aik = row[k];
+            for (j = 0; j < cols; j++) {
+                dst->pData[i * cols + j] += aik * b->pData[k * cols + j];
+                dst->pData[k * cols + j] += aik * b->pData[i * cols + j];
+            }
+        }
+        aik = row[i];
+        for (j = 0; j < cols; j++) {
+            dst->pData[i * cols + j] += aik * b->pData[i * cols + j];
+        }
+    }
+    return RISCV_MATH_SUCCESS;
+}
+
+riscv_status symmat_band_sandwich_f32(const symmat_band_f32 *f, const symmat_packed_f32 *p,
+                                      const symmat_packed_f32 *q, symmat_packed_f32 *dst,
+                                      float32_t *pScratch)
+{
+    uint32_t n = p->n;
+    uint32_t i, j, k, first, last;
+    const float32_t *pf;
+    float32_t sum;
+
+    if ((f->numRows != n) || (f->numCols != n) || (dst->n != n) || ((q != NULL) && (q->n != n))) {
+        return RISCV_MATH_SIZE_MISMATCH;
+    }
+    for (j = 0; j < n; j++) {
+        // pScratch = p * f(j, :)', only the band of row j of f is not zero
+        symmat_band_cols(f, j, &first, &last);
+        for (i = 0; i < n; i++) {
+            pf = symmat_band_ptr(f, j, first);
+            sum = 0.0f;
+            for (k = first; k <= last; k++) {
+                sum += symmat_packed_at(p, i, k) * *pf++;
+            }
+            pScratch[i] = sum;
+        }
+        // dst(i, j) = f(i, :) * pScratch for the lower triangle
+        for (i = j; i < n; i++) {
+            symmat_band_cols(f, i, &first, &last);
+            pf = symmat_band_ptr(f, i, first);
+            sum = (q != NULL) ? q->pData[SYMMAT_PACKED_IDX(i, j)] : 0.0f;
+            for (k = first; k <= last; k++) {
+                sum += *pf++ * pScratch[k];
+            }
+            dst->pData[SYMMAT_PACKED_IDX(i, j)] = sum;
+        }
+    }
+    return RISCV_MATH_SUCCESS;
+}
+
+riscv_status symmat_syrk_f32(symmat_packed_f32 *c, const riscv_matrix_instance_f32 *a,
+                             const float32_t *d, float32_t alpha, float32_t beta)
+{
+    uint32_t n = c->n;
+    uint32_t k = a->numCols;
+    uint32_t i, j, l;
+    const float32_t *ai, *aj;
+    float32_t *out = c->pData;
+    float32_t sum;
+
+    if (a->numRows != n) {
+        return RISCV_MATH_SIZE_MISMATCH;
+    }
+    for (i = 0; i < n; i++) {
+        ai = a->pData + i * k;
+        for (j = 0; j <= i; j++) {
+            aj = a->pData + j * k;
+            sum = 0.0f;
+            if (d != NULL) {
+                for (l = 0; l < k; l++) {
+                    sum += ai[l] * d[l] * aj[l];
+                }
+            } else {
+                for (l = 0; l < k; l++) {
+                    sum += ai[l] * aj[l];
+                }
+            }
+            *out = beta * *out + alpha * sum;
+            out++;
+        }
+    }
+    return RISCV_MATH_SUCCESS;
+}
+
+riscv_status symmat_ldlt_f32(symmat_packed_f32 *a)
+{
+    uint32_t n = a->n;
+    uint32_t i, j, k;
+    float32_t *ri, *rj;
+    float32_t sum, dj;
+
+    // row by row, L(i, j) * D(j) is kept in row i until D(i) is known
+    for (i = 0; i < n; i++) {
+        ri = a->pData + SYMMAT_PACKED_IDX(i, 0);
+        for (j = 0; j < i; j++) {
+            rj = a->pData + SYMMAT_PACKED_IDX(j, 0);
+            sum = ri[j];
+            for (k = 0; k < j; k++) {
+                sum -= ri[k] * rj[k];
+            }
+            ri[j] = sum;
+        }
+        sum = ri[i];
+        for (j = 0; j < i; j++) {
+            dj = a->pData[SYMMAT_PACKED_IDX(j, j)];
+            // ri[j] is L(i, j) * D(j), rj[k] above already holds L(j, k) without D(k)
+            sum -= ri[j] * ri[j] / dj;
+            ri[j] = ri[j] / dj;
+        }
+        if ((sum == 0.0f) || !isfinite(sum)) {
+            return RISCV_MATH_DECOMPOSITION_FAILURE;
+        }
+        ri[i] = sum;
+    }
+    return RISCV_MATH_SUCCESS;
+}
+
+riscv_status symmat_solve_unit_lower_f32(const symmat_packed_f32 *ldl, const riscv_matrix_instance_f32 *b,
+                                         riscv_matrix_instance_f32 *x)
+{
+    uint32_t n = ldl->n;
+    uint32_t cols = b->numCols;
+    uint32_t i, j, k;
+    const float32_t *row;
+    float32_t sum;
+
+    if ((b->numRows != n) || (x->numRows != n) || (x->numCols != cols)) {
+        return RISCV_MATH_SIZE_MISMATCH;
+    }
+    for (i = 0; i < n; i++) {
+        row = ldl->pData + SYMMAT_PACKED_IDX(i, 0);
+        for (j = 0; j < cols; j++) {
+            sum = b->pData[i * cols + j];
+            for (k = 0; k < i; k++) {
+                sum -= row[k] * x->pData[k * cols + j];
+            }
+            x->pData[i * cols + j] = sum;
+        }
+    }
+    return RISCV_MATH_SUCCESS;
+}
+
+riscv_status symmat_solve_unit_upper_f32(const symmat_packed_f32 *ldl, const riscv_matrix_instance_f32 *b,
+                                         riscv_matrix_instance_f32 *x)
+{
+    uint32_t n = ldl->n;
+    uint32_t cols = b->numCols;
+    uint32_t i, j, k;
+    float32_t sum;
+
+    if ((b->numRows != n) || (x->numRows != n) || (x->numCols != cols)) {
+        return RISCV_MATH_SIZE_MISMATCH;
+    }
+    // L'(i, k) is L(k, i), read down column i of the packed rows
+    for (i = n; i-- > 0;) {
+        for (j = 0; j < cols; j++) {
+            sum = b->pData[i * cols + j];
+            for (k = i + 1; k < n; k++) {
+                sum -= ldl->pData[SYMMAT_PACKED_IDX(k, i)] * x->pData[k * cols + j];
+            }
+            x->pData[i * cols + j] = sum;
+        }
+    }
+    return RISCV_MATH_SUCCESS;
+}
+
+riscv_status symmat_ldlt_solve_f32(const symmat_packed_f32 *ldl, const riscv_matrix_instance_f32 *b,
+                                   riscv_matrix_instance_f32 *x)
+{
+    uint32_t cols = b->numCols;
+    uint32_t i, j;
+    float32_t invd;
+    riscv_status ret;
+
+    ret = symmat_solve_unit_lower_f32(ldl, b, x);
+    if (ret != RISCV_MATH_SUCCESS) {
+        return ret;
+    }
+    for (i = 0; i < ldl->n; i++) {
+        invd = 1.0f / ldl->pData[SYMMAT_PACKED_IDX(i, i)];
+        for (j = 0; j < cols; j++) {
+            x->pData[i * cols + j] *= invd;
+        }
+    }
+    return symmat_solve_unit_upper_f32(ldl, x, x);
+}
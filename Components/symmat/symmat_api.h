@@ -0,0 +1,104 @@
+#ifndef _SYMMAT_API_H_
+#define _SYMMAT_API_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "riscv_math.h"
+
+/*
+ * Symmetric packed and banded matrices for Kalman filter updates over NMSIS DSP types.
+ *
+ * - Packed: a symmetric n x n matrix keeps only its lower triangle, row by row, so element
+ *   (i, j) with j <= i is pData[i * (i + 1) / 2 + j], with n * (n + 1) / 2 elements
+ * - Band: a numRows x numCols matrix keeps lower subdiagonals and upper superdiagonals, each
+ *   row in lower + upper + 1 elements, so element (i, j) is pData[i * (lower + upper + 1) +
+ *   j - i + lower], elements of a row out of the matrix are kept but never read
+ * - LDLT: symmat_ldlt_f32() factorizes a packed matrix in place without pivoting, the unit
+ *   lower L is in the strict lower triangle and D on the diagonal, the solvers take it as is
+ *
+ * For P = F * P * F' + Q with a banded F, symmat_band_sandwich_f32() costs about n * n *
+ * (lower + upper + 1) MACs instead of 2 * n * n * n of dense multiplications, and for
+ * P = P - K * S * K' with S = L * D * L', symmat_syrk_f32() takes A = K * L and d = D.
+ * Dense matrices are riscv_matrix_instance_f32, all functions return RISCV_MATH_SIZE_MISMATCH
+ * if the dimensions do not match.
+ */
+
+/* symmetric matrix in packed lower triangle */
+typedef struct {
+    uint16_t n;                     /* rows and columns */
+    float32_t *pData;               /* SYMMAT_PACKED_SIZE(n) elements */
+} symmat_packed_f32;
+
+/* band matrix */
+typedef struct {
+    uint16_t numRows;
+    uint16_t numCols;
+    uint16_t lower;                 /* subdiagonals kept */
+    uint16_t upper;                 /* superdiagonals kept */
+    float32_t *pData;               /* SYMMAT_BAND_SIZE(numRows, lower, upper) elements */
+} symmat_band_f32;
+
+/* elements of packed n x n matrix */
+#define SYMMAT_PACKED_SIZE(n)               ((uint32_t)(n) * ((n) + 1) / 2)
+/* index of element (i, j) of packed matrix, j <= i */
+#define SYMMAT_PACKED_IDX(i, j)             ((uint32_t)(i) * ((i) + 1) / 2 + (j))
+/* elements of band matrix */
+#define SYMMAT_BAND_SIZE(rows, lower, upper) ((uint32_t)(rows) * ((lower) + (upper) + 1))
+
+/* Keep the lower triangle of square src into dst */
+riscv_status symmat_pack_f32(const riscv_matrix_instance_f32 *src, symmat_packed_f32 *dst);
+
+/* Expand src into both triangles of dst */
+riscv_status symmat_unpack_f32(const symmat_packed_f32 *src, riscv_matrix_instance_f32 *dst);
+
+/* Keep the band of src into dst, elements out of the band of dst are dropped */
+riscv_status symmat_band_from_dense_f32(const riscv_matrix_instance_f32 *src, symmat_band_f32 *dst);
+
+/* dst = a * b of band a and dense b, dst must not be b */
+riscv_status symmat_band_mult_f32(const symmat_band_f32 *a, const riscv_matrix_instance_f32 *b,
+                                  riscv_matrix_instance_f32 *dst);
+
+/* dst = a * b of packed a and dense b, dst must not be b */
+riscv_status symmat_packed_mult_f32(const symmat_packed_f32 *a, const riscv_matrix_instance_f32 *b,
+                                    riscv_matrix_instance_f32 *dst);
+
+/*
+ * dst = f * p * f' + q of square band f and packed p, q can be NULL, dst must not be p,
+ * pScratch holds n elements
+ */
+riscv_status symmat_band_sandwich_f32(const symmat_band_f32 *f, const symmat_packed_f32 *p,
+                                      const symmat_packed_f32 *q, symmat_packed_f32 *dst,
+                                      float32_t *pScratch);
+
+/*
+ * c = beta * c + alpha * a * diag(d) * a' of n x k a, so a rank k update of packed c, d of
+ * k elements can be NULL for the identity
+ */
+riscv_status symmat_syrk_f32(symmat_packed_f32 *c, const riscv_matrix_instance_f32 *a,
+                             const float32_t *d, float32_t alpha, float32_t beta);
+
+/*
+ * Factorize a = L * D * L' in place, return RISCV_MATH_DECOMPOSITION_FAILURE if a pivot
+ * of D is 0 or not finite, then a is left partly factorized
+ */
+riscv_status symmat_ldlt_f32(symmat_packed_f32 *a);
+
+/* Solve L * x = b of unit lower L in ldl, x can be b */
+riscv_status symmat_solve_unit_lower_f32(const symmat_packed_f32 *ldl, const riscv_matrix_instance_f32 *b,
+                                         riscv_matrix_instance_f32 *x);
+
+/* Solve L' * x = b of unit lower L in ldl, x can be b */
+riscv_status symmat_solve_unit_upper_f32(const symmat_packed_f32 *ldl, const riscv_matrix_instance_f32 *b,
+                                         riscv_matrix_instance_f32 *x);
+
+/* Solve L * D * L' * x = b of ldl factorized by symmat_ldlt_f32(), x can be b */
+riscv_status symmat_ldlt_solve_f32(const symmat_packed_f32 *ldl, const riscv_matrix_instance_f32 *b,
+                                   riscv_matrix_instance_f32 *x);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _SYMMAT_API_H_ */
@@ -26,6 +26,7 @@
 #endif
 
 #include "core_feature_base.h"
+#include "core_feature_bitmanip.h"
 
 /* ===== ARM Compatiable Functions ===== */
 /**
@@ -121,6 +122,9 @@ __STATIC_FORCEINLINE uint32_t __USAT(int32_t val, uint32_t sat)
  */
 __STATIC_FORCEINLINE uint32_t __REV(uint32_t value)
 {
+#if defined(__riscv_zbb) || defined(__riscv_zbkb)
+    return (uint32_t)(__REV8L((unsigned long)value) >> (__RISCV_XLEN - 32));
+#else
     uint32_t result;
 
     result =  ((value & 0xff000000) >> 24)
@@ -128,6 +132,7 @@ __STATIC_FORCEINLINE uint32_t __REV(uint32_t value)
         | ((value & 0x0000ff00) << 8 )
         | ((value & 0x000000ff) << 24);
     return result;
+#endif
 }
 
 /**
@@ -236,13 +241,7 @@ __STATIC_FORCEINLINE uint32_t __RBIT(uint32_t value)
 #else
 __STATIC_FORCEINLINE uint8_t __CLZ(uint32_t data)
 {
-    uint8_t ret = 0;
-    uint32_t temp = ~data;
-    while (temp & 0x80000000) {
-          temp <<= 1;
-          ret++;
-    }
-    return ret;
+    return (uint8_t)(__CLZL((unsigned long)data) - (__RISCV_XLEN - 32));
 }
 #endif /* defined(__DSP_PRESENT) && (__DSP_PRESENT == 1) */
 
@@ -250,18 +249,11 @@ __STATIC_FORCEINLINE uint8_t __CLZ(uint32_t data)
  * \brief   Count tailing zero
  * \details Return the count of least-significant bit zero.for example, return 3 if x=0bxxx1000
  * \param [in] data   Value to count the tailing zeros
- * \return            number of tailing zeros in value
+ * \return            number of tailing zeros in value, return \ref __RISCV_XLEN when data is 0
  */
 __STATIC_FORCEINLINE unsigned long __CTZ(unsigned long data)
 {
-    unsigned long ret = 0;
-
-    while (!(data & 1UL)) {
-        ret++;
-        data = data >> 1;
-    }
-
-    return ret;
+    return __CTZL(data);
 }
 
 /**
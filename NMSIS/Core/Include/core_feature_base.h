@@ -920,6 +920,37 @@ __STATIC_FORCEINLINE void __WFE(void)
     __RV_CSR_CLEAR(CSR_WFE, WFE_WFE);
 }
 
+/**
+ * \brief   Wait For Interrupt while a status word is pending
+ * \details
+ * Sleep in WFI until an interrupt handler changes *status from pending.
+ * The status is tested with mstatus.MIE cleared and WFI is executed before MIE
+ * is restored, so an interrupt which comes after the test still wakes the core,
+ * its handler runs when MIE is restored, then the status is tested again.
+ * \param[in] status    address of the status word written by interrupt handler
+ * \param[in] pending   value of the status word while waiting
+ * \return    the status value which ended the wait
+ * \remarks
+ * - It must be called with interrupts enabled, otherwise the handler which
+ *   changes the status never runs
+ */
+__STATIC_FORCEINLINE int32_t __wfi_while_pending(volatile int32_t *status, int32_t pending)
+{
+    rv_csr_t mstatus;
+    int32_t val;
+
+    while (1) {
+        mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+        val = *status;
+        if (val != pending) {
+            __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+            return val;
+        }
+        __WFI();
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    }
+}
+
 /**
  * \brief   Breakpoint Instruction
  * \details
@@ -1728,7 +1759,7 @@ __STATIC_FORCEINLINE int32_t __AMOADD_W(volatile int32_t *addr, int32_t value)
 
     __ASM volatile ("amoadd.w %0, %2, %1" : \
             "=r"(result), "+A"(*addr) : "r"(value) : "memory");
-    return *addr;
+    return result + value;
 }
 
 /**
@@ -1901,7 +1932,7 @@ __STATIC_FORCEINLINE int64_t __AMOADD_D(volatile int64_t *addr, int64_t value)
 
     __ASM volatile ("amoadd.d %0, %2, %1" : \
             "=r"(result), "+A"(*addr) : "r"(value) : "memory");
-    return *addr;
+    return result + value;
 }
 
 /**
@@ -62,6 +62,251 @@
 
 #endif /* defined(__BITMANIP_PRESENT) && (__BITMANIP_PRESENT == 1) */
 
+/* ###########################  CPU Bit Count Functions ########################### */
+/**
+ * \defgroup NMSIS_Core_Bitmanip_Count   Bit Count Functions
+ * \ingroup  NMSIS_Core
+ * \brief    Functions that count leading or trailing zeros of register width values.
+ * \details
+ *
+ * When Zbb extension is enabled by compiler -march option, single clz instruction is used,
+ * otherwise a de Bruijn sequence multiply and table lookup is used, so the cost doesn't
+ * depend on the position of highest set bit, which is preferred by RTOS task selection.
+ *
+ *   @{
+ */
+/**
+ * \brief   Count leading zeros of unsigned long value
+ * \details Counts the number of leading zeros of a register width value, using
+ *          Zbb clz instruction when available, else using de Bruijn sequence.
+ * \param [in]  data  Value to count the leading zeros
+ * \return             number of leading zeros in value, return \ref __RISCV_XLEN when data is 0
+ */
+__STATIC_FORCEINLINE unsigned long __CLZL(unsigned long data)
+{
+#if defined(__riscv_zbb)
+    unsigned long result;
+
+    __ASM("clz %0, %1" : "=r"(result) : "r"(data));
+    return result;
+#else
+    /* index of highest set bit from smeared value multiplied by de Bruijn sequence */
+#if __RISCV_XLEN == 32
+    static const uint8_t debruijn_tbl[32] = {
+        0, 9, 1, 10, 13, 21, 2, 29, 11, 14, 16, 18, 22, 25, 3, 30,
+        8, 12, 20, 28, 15, 17, 24, 7, 19, 27, 23, 6, 26, 5, 4, 31
+    };
+#else
+    static const uint8_t debruijn_tbl[64] = {
+        0, 47, 1, 56, 48, 27, 2, 60, 57, 49, 41, 37, 28, 16, 3, 61,
+        54, 58, 35, 52, 50, 42, 21, 44, 38, 32, 29, 23, 17, 11, 4, 62,
+        46, 55, 26, 59, 40, 36, 15, 53, 34, 51, 20, 43, 31, 22, 10, 45,
+        25, 39, 14, 33, 19, 30, 9, 24, 13, 18, 8, 12, 7, 6, 5, 63
+    };
+#endif
+
+    if (data == 0) {
+        return __RISCV_XLEN;
+    }
+    /* smear highest set bit to all lower bits */
+    data |= data >> 1;
+    data |= data >> 2;
+    data |= data >> 4;
+    data |= data >> 8;
+    data |= data >> 16;
+#if __RISCV_XLEN == 32
+    return 31 - debruijn_tbl[(uint32_t)(data * 0x07C4ACDDUL) >> 27];
+#else
+    data |= data >> 32;
+    return 63 - debruijn_tbl[(uint64_t)(data * 0x03F79D71B4CB0A89ULL) >> 58];
+#endif
+#endif
+}
+
+/**
+ * \brief   Get index of highest set bit of unsigned long value
+ * \details Return the bit index of most significant set bit, for example return 3 if x=0b1xxx.
+ * \param [in]  data  Value to find the highest set bit, it must not be 0
+ * \return             index of highest set bit
+ */
+__STATIC_FORCEINLINE unsigned long __FLSL(unsigned long data)
+{
+    return (__RISCV_XLEN - 1) - __CLZL(data);
+}
+
+/**
+ * \brief   Count trailing zeros of unsigned long value
+ * \details Counts the number of trailing zeros of a register width value, which is the
+ *          index of lowest set bit, using Zbb ctz instruction when available, else
+ *          isolating the lowest set bit and using \ref __CLZL.
+ * \param [in]  data  Value to count the trailing zeros
+ * \return             number of trailing zeros in value, return \ref __RISCV_XLEN when data is 0
+ */
+__STATIC_FORCEINLINE unsigned long __CTZL(unsigned long data)
+{
+#if defined(__riscv_zbb)
+    unsigned long result;
+
+    __ASM("ctz %0, %1" : "=r"(result) : "r"(data));
+    return result;
+#else
+    if (data == 0) {
+        return __RISCV_XLEN;
+    }
+    return (__RISCV_XLEN - 1) - __CLZL(data & (~data + 1));
+#endif
+}
+/** @} */ /* End of Doxygen Group NMSIS_Core_Bitmanip_Count */
+
+/* ###########################  CPU Bit Utility Functions ########################### */
+/**
+ * \defgroup NMSIS_Core_Bitmanip_Util   Bit Utility Functions
+ * \ingroup  NMSIS_Core
+ * \brief    Functions of population count, byte reverse, byte OR-combine and carry-less multiply.
+ * \details
+ *
+ * Each function is a single Zbb, Zbkb or Zbc/Zbkc instruction when the extension is
+ * enabled by compiler -march option, otherwise a branch free C fallback is used,
+ * except \ref __CLMULL and \ref __CLMULHL, whose fallback loops on the set bits of b.
+ *
+ * | Function      | Instruction | Extension   | Fallback                          |
+ * |---------------|-------------|-------------|-----------------------------------|
+ * | \ref __CPOPL  | cpop        | Zbb         | SWAR bit count                    |
+ * | \ref __REV8L  | rev8        | Zbb, Zbkb   | shift and mask swap               |
+ * | \ref __ORCBL  | orc.b       | Zbb         | SWAR zero byte detection          |
+ * | \ref __CLMULL | clmul       | Zbc, Zbkc   | shift and xor of set bits of b    |
+ * | \ref __CLMULHL| clmulh      | Zbc, Zbkc   | shift and xor of set bits of b    |
+ *
+ *   @{
+ */
+#if __RISCV_XLEN == 32
+#define __BITMANIP_ONES_B       0x01010101UL
+#else
+#define __BITMANIP_ONES_B       0x0101010101010101UL
+#endif
+
+/**
+ * \brief   Count set bits of unsigned long value
+ * \details Counts the number of bits set to 1 in a register width value.
+ * \param [in]  data  Value to count the set bits
+ * \return             number of set bits in value
+ */
+__STATIC_FORCEINLINE unsigned long __CPOPL(unsigned long data)
+{
+#if defined(__riscv_zbb)
+    unsigned long result;
+
+    __ASM("cpop %0, %1" : "=r"(result) : "r"(data));
+    return result;
+#else
+    data = data - ((data >> 1) & (__BITMANIP_ONES_B * 0x55));
+    data = (data & (__BITMANIP_ONES_B * 0x33)) + ((data >> 2) & (__BITMANIP_ONES_B * 0x33));
+    data = (data + (data >> 4)) & (__BITMANIP_ONES_B * 0x0F);
+    return (data * __BITMANIP_ONES_B) >> (__RISCV_XLEN - 8);
+#endif
+}
+
+/**
+ * \brief   Reverse byte order of unsigned long value
+ * \details Reverses the byte order of a register width value,
+ *          for example 0x12345678 becomes 0x78563412 for RV32.
+ * \param [in]  data  Value to reverse
+ * \return             value with byte order reversed
+ */
+__STATIC_FORCEINLINE unsigned long __REV8L(unsigned long data)
+{
+#if defined(__riscv_zbb) || defined(__riscv_zbkb)
+    unsigned long result;
+
+    __ASM("rev8 %0, %1" : "=r"(result) : "r"(data));
+    return result;
+#else
+    data = ((data >> 8) & (~0UL / 0x101UL)) | ((data & (~0UL / 0x101UL)) << 8);
+    data = ((data >> 16) & (~0UL / 0x10001UL)) | ((data & (~0UL / 0x10001UL)) << 16);
+#if __RISCV_XLEN == 64
+    data = (data >> 32) | (data << 32);
+#endif
+    return data;
+#endif
+}
+
+/**
+ * \brief   OR-combine bits of each byte of unsigned long value
+ * \details Sets each byte of result to 0xFF when the corresponding byte of data is not zero,
+ *          and to 0 otherwise, so ~result marks the zero bytes, used to find the end of string.
+ * \param [in]  data  Value to combine
+ * \return             value with each non-zero byte set to 0xFF
+ */
+__STATIC_FORCEINLINE unsigned long __ORCBL(unsigned long data)
+{
+#if defined(__riscv_zbb)
+    unsigned long result;
+
+    __ASM("orc.b %0, %1" : "=r"(result) : "r"(data));
+    return result;
+#else
+    /* high bit of each byte is set when the byte isn't zero, no carry crosses bytes */
+    data |= (data & (__BITMANIP_ONES_B * 0x7F)) + (__BITMANIP_ONES_B * 0x7F);
+    return ((data >> 7) & __BITMANIP_ONES_B) * 0xFF;
+#endif
+}
+
+/**
+ * \brief   Carry-less multiply of unsigned long values, low half
+ * \details Returns the low register width bits of the carry-less product of a and b,
+ *          which is the polynomial product over GF(2), used by CRC and GHASH.
+ * \param [in]  a  First operand
+ * \param [in]  b  Second operand
+ * \return         low half of carry-less product
+ */
+__STATIC_FORCEINLINE unsigned long __CLMULL(unsigned long a, unsigned long b)
+{
+#if defined(__riscv_zbc) || defined(__riscv_zbkc)
+    unsigned long result;
+
+    __ASM("clmul %0, %1, %2" : "=r"(result) : "r"(a), "r"(b));
+    return result;
+#else
+    unsigned long result = 0;
+
+    while (b != 0) {
+        result ^= a << __CTZL(b);
+        b &= b - 1;
+    }
+    return result;
+#endif
+}
+
+/**
+ * \brief   Carry-less multiply of unsigned long values, high half
+ * \details Returns the high register width bits of the carry-less product of a and b.
+ * \param [in]  a  First operand
+ * \param [in]  b  Second operand
+ * \return         high half of carry-less product
+ */
+__STATIC_FORCEINLINE unsigned long __CLMULHL(unsigned long a, unsigned long b)
+{
+#if defined(__riscv_zbc) || defined(__riscv_zbkc)
+    unsigned long result;
+
+    __ASM("clmulh %0, %1, %2" : "=r"(result) : "r"(a), "r"(b));
+    return result;
+#else
+    unsigned long result = 0;
+    unsigned long i;
+
+    /* bit 0 of b shifts nothing into the high half */
+    b &= ~1UL;
+    while (b != 0) {
+        i = __CTZL(b);
+        result ^= a >> (__RISCV_XLEN - i);
+        b &= b - 1;
+    }
+    return result;
+#endif
+}
+/** @} */ /* End of Doxygen Group NMSIS_Core_Bitmanip_Util */
+
 #ifdef __cplusplus
 }
 #endif
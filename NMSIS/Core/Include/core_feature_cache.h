@@ -101,8 +101,31 @@ typedef struct CacheInfo {
     uint32_t ways;                      /*!< Cache ways */
     uint32_t setperway;                 /*!< Cache set per way */
     uint32_t size;                      /*!< Cache total size in bytes */
+    uint32_t lineshift;                 /*!< Cache Line size in log2, linesize is 1 << lineshift if linesize is not 0 */
+    uint32_t lockways;                  /*!< Cache lockable ways, N-Way cache can lock N-1 ways */
 } CacheInfo_Type;
 
+/** \brief log2 of cache line size, cache line size must be power of 2 between 8 and 1024 bytes */
+#define __CCM_LINESHIFT(linesize)       (((linesize) >= 1024) ? 10 : ((linesize) >= 512) ? 9 : \
+                                         ((linesize) >= 256) ? 8 : ((linesize) >= 128) ? 7 : \
+                                         ((linesize) >= 64) ? 6 : ((linesize) >= 32) ? 5 : \
+                                         ((linesize) >= 16) ? 4 : 3)
+
+/*
+ * If cache geometry is known when compiling, such as from the generated cpufeature.h,
+ * __ICACHE_LINESIZE/__ICACHE_WAYS/__ICACHE_SETS and __DCACHE_LINESIZE/__DCACHE_WAYS/__DCACHE_SETS
+ * can be defined in <Device>.h, then the cache line operations on a range will use these
+ * constants instead of probing CSR MICFG_INFO/MDCFG_INFO at runtime
+ */
+#if defined(__ICACHE_LINESIZE) && defined(__ICACHE_WAYS) && defined(__ICACHE_SETS)
+#define __ICACHE_LINESHIFT              __CCM_LINESHIFT(__ICACHE_LINESIZE)          /*!< I-Cache line size in log2 */
+#define __ICACHE_SIZE                   ((__ICACHE_LINESIZE) * (__ICACHE_WAYS) * (__ICACHE_SETS))  /*!< I-Cache size in bytes */
+#endif
+#if defined(__DCACHE_LINESIZE) && defined(__DCACHE_WAYS) && defined(__DCACHE_SETS)
+#define __DCACHE_LINESHIFT              __CCM_LINESHIFT(__DCACHE_LINESIZE)          /*!< D-Cache line size in log2 */
+#define __DCACHE_SIZE                   ((__DCACHE_LINESIZE) * (__DCACHE_WAYS) * (__DCACHE_SETS))  /*!< D-Cache size in bytes */
+#endif
+
 #if __riscv_xlen == 32
 #define CCM_SUEN_SUEN_Msk               (0xFFFFFFFFUL)              /*!< CSR CCM_SUEN: SUEN Mask */
 #else
@@ -262,10 +285,13 @@ __STATIC_FORCEINLINE int32_t GetICacheInfo(CacheInfo_Type *info)
     CSR_MICFGINFO_Type csr_ccfg = (CSR_MICFGINFO_Type)__RV_CSR_READ(CSR_MICFG_INFO);
     info->setperway = (1 << csr_ccfg.b.set) << 3;
     info->ways = (1 + csr_ccfg.b.way);
+    info->lockways = csr_ccfg.b.way;
     if (csr_ccfg.b.lsize == 0) {
         info->linesize = 0;
+        info->lineshift = 0;
     } else {
-        info->linesize = (1 << (csr_ccfg.b.lsize - 1)) << 3;
+        info->lineshift = csr_ccfg.b.lsize + 2;
+        info->linesize = 1 << info->lineshift;
     }
     info->size = info->setperway * info->ways * info->linesize;
     return 0;
@@ -783,10 +809,13 @@ __STATIC_FORCEINLINE int32_t GetDCacheInfo(CacheInfo_Type *info)
     CSR_MDCFGINFO_Type csr_ccfg = (CSR_MDCFGINFO_Type)__RV_CSR_READ(CSR_MDCFG_INFO);
     info->setperway = (1 << csr_ccfg.b.set) << 3;
     info->ways = (1 + csr_ccfg.b.way);
+    info->lockways = csr_ccfg.b.way;
     if (csr_ccfg.b.lsize == 0) {
         info->linesize = 0;
+        info->lineshift = 0;
     } else {
-        info->linesize = (1 << (csr_ccfg.b.lsize - 1)) << 3;
+        info->lineshift = csr_ccfg.b.lsize + 2;
+        info->linesize = 1 << info->lineshift;
     }
     info->size = info->setperway * info->ways * info->linesize;
     return 0;
@@ -1377,6 +1406,127 @@ __STATIC_FORCEINLINE void UUnlockDCacheLines(unsigned long addr, unsigned long c
     }
 }
 
+#ifndef CCM_DCACHE_RANGE_ALL_PERCENT
+/**
+ * \brief Threshold of D-Cache range operations, in percent of D-Cache size
+ * \details
+ * If the size of range is equal or larger than this percent of D-Cache size,
+ * D-Cache range operations such as \ref MFlushDCacheRange will operate on
+ * the whole D-Cache, which is faster than operating line by line.
+ */
+#define CCM_DCACHE_RANGE_ALL_PERCENT    100
+#endif
+
+/**
+ * \brief  Do D-Cache line operations on lines covering an address range in M-Mode
+ * \details
+ * This function do \ref CCM_CMD_Type operation cmd on the D-Cache lines covering
+ * address range [addr, addr + size), the first and last line which are not fully
+ * covered by the range use operation edgecmd, and if the range is large enough,
+ * operation allcmd is done for the whole D-Cache instead.
+ * \remarks
+ * This function must be executed in M-Mode only.
+ * \param [in]    addr      start address of the range
+ * \param [in]    size      size of the range in bytes
+ * \param [in]    cmd       operation to the lines fully covered by the range
+ * \param [in]    edgecmd   operation to the partial covered head and tail lines
+ * \param [in]    allcmd    operation to the whole D-Cache
+ */
+__STATIC_FORCEINLINE void __MDCacheRangeOp(unsigned long addr, unsigned long size, CCM_CMD_Type cmd,
+                                           CCM_CMD_Type edgecmd, CCM_CMD_Type allcmd)
+{
+    unsigned long lineshift, linesize, dcsize, start, end, cnt, i;
+
+    if (size == 0) {
+        return;
+    }
+#if defined(__DCACHE_LINESHIFT)
+    lineshift = __DCACHE_LINESHIFT;
+    dcsize = __DCACHE_SIZE;
+#else
+    CSR_MDCFGINFO_Type csr_ccfg = (CSR_MDCFGINFO_Type)__RV_CSR_READ(CSR_MDCFG_INFO);
+    if (csr_ccfg.b.lsize == 0) {
+        return;
+    }
+    lineshift = csr_ccfg.b.lsize + 2;
+    dcsize = ((1UL << csr_ccfg.b.set) << 3) * (1 + csr_ccfg.b.way) << lineshift;
+#endif
+    linesize = 1UL << lineshift;
+    if ((uint64_t)size * 100 >= (uint64_t)dcsize * CCM_DCACHE_RANGE_ALL_PERCENT) {
+        __RV_CSR_WRITE(CSR_CCM_MCOMMAND, allcmd);
+        return;
+    }
+    start = addr & ~(linesize - 1);
+    end = (addr + size + linesize - 1) & ~(linesize - 1);
+    cnt = (end - start) >> lineshift;
+    /* CSR CCM_MBEGINADDR is increased by line size after each operation */
+    __RV_CSR_WRITE(CSR_CCM_MBEGINADDR, start);
+    for (i = 0; i < cnt; i++) {
+        if (((i == 0) && (start != addr)) || ((i == cnt - 1) && (end != addr + size))) {
+            __RV_CSR_WRITE(CSR_CCM_MCOMMAND, edgecmd);
+        } else {
+            __RV_CSR_WRITE(CSR_CCM_MCOMMAND, cmd);
+        }
+    }
+}
+
+/**
+ * \brief  Flush D-Cache lines covering an address range in M-Mode
+ * \details
+ * This function flush the D-Cache lines covering range [addr, addr + size),
+ * address and size need not be aligned to cache line size, if size is larger than
+ * \ref CCM_DCACHE_RANGE_ALL_PERCENT of D-Cache size, whole D-Cache is flushed.
+ * Command \ref CCM_DC_WB or \ref CCM_DC_WB_ALL is written to CSR \ref CSR_CCM_MCOMMAND.
+ * \remarks
+ * - This function must be executed in M-Mode only.
+ * - Call it before a DMA reads the memory written by cpu.
+ * \param [in]    addr    start address to be flushed
+ * \param [in]    size    size in bytes to be flushed
+ */
+__STATIC_FORCEINLINE void MFlushDCacheRange(void *addr, unsigned long size)
+{
+    __MDCacheRangeOp((unsigned long)addr, size, CCM_DC_WB, CCM_DC_WB, CCM_DC_WB_ALL);
+}
+
+/**
+ * \brief  Invalidate D-Cache lines covering an address range in M-Mode
+ * \details
+ * This function invalidate the D-Cache lines covering range [addr, addr + size),
+ * address and size need not be aligned to cache line size, the partial covered
+ * head and tail lines are flushed and invalidated, so data out of the range sharing
+ * these lines will not be lost, if size is larger than \ref CCM_DCACHE_RANGE_ALL_PERCENT
+ * of D-Cache size, whole D-Cache is flushed and invalidated.
+ * Command \ref CCM_DC_INVAL, \ref CCM_DC_WBINVAL or \ref CCM_DC_WBINVAL_ALL is written
+ * to CSR \ref CSR_CCM_MCOMMAND.
+ * \remarks
+ * - This function must be executed in M-Mode only.
+ * - Call it after a DMA writes the memory which will be read by cpu, cpu should not
+ *   write the partial covered lines during the DMA transfer.
+ * \param [in]    addr    start address to be invalidated
+ * \param [in]    size    size in bytes to be invalidated
+ */
+__STATIC_FORCEINLINE void MInvalDCacheRange(void *addr, unsigned long size)
+{
+    __MDCacheRangeOp((unsigned long)addr, size, CCM_DC_INVAL, CCM_DC_WBINVAL, CCM_DC_WBINVAL_ALL);
+}
+
+/**
+ * \brief  Flush and invalidate D-Cache lines covering an address range in M-Mode
+ * \details
+ * This function flush and invalidate the D-Cache lines covering range [addr, addr + size),
+ * address and size need not be aligned to cache line size, if size is larger than
+ * \ref CCM_DCACHE_RANGE_ALL_PERCENT of D-Cache size, whole D-Cache is flushed and invalidated.
+ * Command \ref CCM_DC_WBINVAL or \ref CCM_DC_WBINVAL_ALL is written to CSR \ref CSR_CCM_MCOMMAND.
+ * \remarks
+ * This function must be executed in M-Mode only.
+ * \param [in]    addr    start address to be flushed and invalidated
+ * \param [in]    size    size in bytes to be flushed and invalidated
+ */
+__STATIC_FORCEINLINE void MFlushInvalDCacheRange(void *addr, unsigned long size)
+{
+    __MDCacheRangeOp((unsigned long)addr, size, CCM_DC_WBINVAL, CCM_DC_WBINVAL, CCM_DC_WBINVAL_ALL);
+}
+
 /**
  * \brief  Invalidate all D-Cache lines in M-Mode
  * \details
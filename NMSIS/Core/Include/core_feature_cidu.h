@@ -431,6 +431,123 @@ __STATIC_FORCEINLINE void CIDU_ReleaseSemaphore(uint32_t semph_n)
     __SW(addr, 0xFFFFFFFF);
 }
 /** @} */ /* End of Doxygen Group NMSIS_Core_Semaphore */
+
+/**
+ * \defgroup NMSIS_Core_Semaphore_Mutex      Semaphore Mutex Functions
+ * \ingroup  NMSIS_Core_CIDU
+ * \brief    Functions that implement a sleeping mutex with semaphore and inter core interrupt
+ * @{
+ * The mutex owns a CIDU semaphore, a core which failed to acquire it sleeps in WFI instead of
+ * polling the semaphore, and the owner wakes up one waiting core by ICI when releasing it, so no
+ * atomic memory operation is needed.
+ *
+ * * \ref CIDU_Mutex_Type must be placed in memory shared by all the cores and not cached, or cache coherent.
+ * * ICI interrupt must be enabled in ECLIC of the waiting cores, such as ECLIC_EnableIRQ(InterCore_IRQn),
+ *   it will not enter ICI ISR since it is masked by mstatus.MIE while waiting.
+ */
+#ifndef CIDU_MAX_CORES
+#define CIDU_MAX_CORES                16        /*!< Max cores in a cluster supported by CIDU */
+#endif
+
+/** \brief Mutex based on CIDU semaphore */
+typedef struct CIDU_Mutex {
+    uint32_t semph;                             /*!< Semaphore id owned by this mutex */
+    volatile uint8_t waiting[CIDU_MAX_CORES];   /*!< Waiting flag of each core, only written by the core itself */
+} CIDU_Mutex_Type;
+
+/**
+ * \brief  Initialize the mutex
+ * \details
+ * Initialize the mutex and release its semaphore, it should be called by only one core
+ * before any core use the mutex.
+ * \param [in]    mutex      the mutex to be initialized
+ * \param [in]    semph_n    the semaphore id used by this mutex
+ */
+__STATIC_FORCEINLINE void CIDU_Mutex_Init(CIDU_Mutex_Type *mutex, uint32_t semph_n)
+{
+    mutex->semph = semph_n;
+    for (uint32_t i = 0; i < CIDU_MAX_CORES; i++) {
+        mutex->waiting[i] = 0;
+    }
+    CIDU_ReleaseSemaphore(semph_n);
+    __RWMB();
+}
+
+/**
+ * \brief  Try to lock the mutex
+ * \param [in]    mutex      the mutex to be locked
+ * \param [in]    core_id    the core id that wants to lock the mutex
+ * \return 0 if the mutex is locked by core_id, or else -1 if failed
+ */
+__STATIC_FORCEINLINE long CIDU_Mutex_TryLock(CIDU_Mutex_Type *mutex, uint32_t core_id)
+{
+    return CIDU_AcquireSemaphore(mutex->semph, core_id);
+}
+
+/**
+ * \brief  Lock the mutex, sleep until it is released if it is locked by other core
+ * \details
+ * The waiting core sets its waiting flag before its last try, so a release between that can't
+ * be missed. After waked up by ICI, the ICI requests of the core are cleared and try again.
+ * \param [in]    mutex      the mutex to be locked
+ * \param [in]    core_id    the core id that wants to lock the mutex
+ * \remarks
+ * - All the pending ICI requests of core_id are cleared while waiting, so ICI should not be used
+ *   for other purpose in the same time.
+ * - If the mutex is released just before the last try, a wakeup ICI may still be pending after
+ *   the mutex is locked, it only makes the next wait return from WFI once more.
+ * \sa
+ * - \ref CIDU_Mutex_Unlock
+ */
+__STATIC_FORCEINLINE void CIDU_Mutex_Lock(CIDU_Mutex_Type *mutex, uint32_t core_id)
+{
+    unsigned long mstatus;
+    uint32_t senders;
+
+    if (CIDU_AcquireSemaphore(mutex->semph, core_id) == 0) {
+        return;
+    }
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    mutex->waiting[core_id] = 1;
+    __RWMB();
+    while (CIDU_AcquireSemaphore(mutex->semph, core_id) != 0) {
+        __WFI();
+        senders = CIDU_QueryCoreIntSenderMask(core_id);
+        if (senders) {
+            __SW((void *)CIDU_CORE_INT_STATUS_ADDR(core_id), senders);
+        }
+    }
+    mutex->waiting[core_id] = 0;
+    __RWMB();
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
+
+/**
+ * \brief  Unlock the mutex and wake up a waiting core
+ * \details
+ * Release the semaphore, then send ICI to the first waiting core after core_id in round robin
+ * order, so the waiting cores get the mutex in turn.
+ * \param [in]    mutex      the mutex to be unlocked
+ * \param [in]    core_id    the core id that owns the mutex
+ * \sa
+ * - \ref CIDU_Mutex_Lock
+ */
+__STATIC_FORCEINLINE void CIDU_Mutex_Unlock(CIDU_Mutex_Type *mutex, uint32_t core_id)
+{
+    uint32_t target;
+
+    __RWMB();
+    CIDU_ReleaseSemaphore(mutex->semph);
+    __RWMB();
+    for (uint32_t i = 1; i < CIDU_MAX_CORES; i++) {
+        target = (core_id + i) % CIDU_MAX_CORES;
+        if (mutex->waiting[target]) {
+            CIDU_TriggerInterCoreInt(core_id, target);
+            break;
+        }
+    }
+}
+/** @} */ /* End of Doxygen Group NMSIS_Core_Semaphore_Mutex */
 #endif /* defined(__CIDU_PRESENT) && (__CIDU_PRESENT == 1) */
 
 #ifdef __cplusplus
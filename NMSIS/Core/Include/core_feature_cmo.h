@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __CORE_FEATURE_CMO_H__
+#define __CORE_FEATURE_CMO_H__
+/*!
+ * @file     core_feature_cmo.h
+ * @brief    Cache management operation(CMO) and cache hint API header file for Nuclei N/NX Core
+ */
+/*
+ * CMO Feature Configuration Macro:
+ * 1. __riscv_zicbop / __riscv_zicbom / __riscv_zicboz / __riscv_zihintntl:
+ *    Defined by compiler when the extension is enabled in -march, such as rv32imac_zicbom_zicbop
+ * 2. __CMO_BLOCK_SIZE: Cache block size in bytes used by cbo.* instructions,
+ *    default to __DCACHE_LINESIZE if defined, otherwise 64
+ */
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "core_feature_base.h"
+#include "core_feature_cache.h"
+
+/* ##########################  CMO functions  #################################### */
+/**
+ * \defgroup NMSIS_Core_CMO         Cache Management Operation and Hint Functions
+ * \ingroup  NMSIS_Core
+ * \brief    Functions that generate RISC-V Zicbop/Zicbom/Zicboz/Zihintntl instructions.
+ * @{
+ *
+ * These APIs are used to prefetch input buffers and zero or clean output buffers of the
+ * streaming kernels such as the DSP and NN functions.
+ *
+ * * When the extension is not enabled, the prefetch and non-temporal hint APIs do nothing.
+ * * When Zicbom is not enabled, the clean/flush/invalidate APIs fall back to the Nuclei CCM
+ *   D-Cache operations, such as \ref MFlushDCacheLine, which must be called in M-Mode only,
+ *   and they do nothing when no D-Cache or CCM present.
+ * * When Zicboz is not enabled, the zero APIs fall back to normal stores.
+ */
+
+#ifndef __CMO_BLOCK_SIZE
+#if defined(__DCACHE_LINESIZE)
+#define __CMO_BLOCK_SIZE                __DCACHE_LINESIZE   /*!< Cache block size of cbo.* instructions */
+#else
+#define __CMO_BLOCK_SIZE                64                  /*!< Cache block size of cbo.* instructions */
+#endif
+#endif
+
+/** \brief Align address down to cache block of cbo.* instructions */
+#define __CMO_BLOCK_ALIGN(addr)         ((unsigned long)(addr) & ~((unsigned long)__CMO_BLOCK_SIZE - 1))
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1) && defined(__CCM_PRESENT) && (__CCM_PRESENT == 1)
+#define __CMO_CCM_FALLBACK              1
+#else
+#define __CMO_CCM_FALLBACK              0
+#endif
+
+/**
+ * \brief   Prefetch cache block for data read
+ * \details
+ * Generate `prefetch.r` instruction when Zicbop is enabled, otherwise do nothing.
+ * \param [in]    addr    address in the cache block to be prefetched
+ */
+__STATIC_FORCEINLINE void __PREFETCH_R(const void *addr)
+{
+#if defined(__riscv_zicbop)
+    __ASM volatile("prefetch.r 0(%0)" : : "r"(addr));
+#else
+    (void)addr;
+#endif
+}
+
+/**
+ * \brief   Prefetch cache block for data write
+ * \details
+ * Generate `prefetch.w` instruction when Zicbop is enabled, otherwise do nothing.
+ * \param [in]    addr    address in the cache block to be prefetched
+ */
+__STATIC_FORCEINLINE void __PREFETCH_W(const void *addr)
+{
+#if defined(__riscv_zicbop)
+    __ASM volatile("prefetch.w 0(%0)" : : "r"(addr));
+#else
+    (void)addr;
+#endif
+}
+
+/**
+ * \brief   Prefetch cache block for instruction fetch
+ * \details
+ * Generate `prefetch.i` instruction when Zicbop is enabled, otherwise do nothing.
+ * \param [in]    addr    address in the cache block to be prefetched
+ */
+__STATIC_FORCEINLINE void __PREFETCH_I(const void *addr)
+{
+#if defined(__riscv_zicbop)
+    __ASM volatile("prefetch.i 0(%0)" : : "r"(addr));
+#else
+    (void)addr;
+#endif
+}
+
+/**
+ * \brief   Clean cache block
+ * \details
+ * Write back the cache block if dirty, and keep it valid in cache.
+ * Generate `cbo.clean` instruction when Zicbom is enabled, otherwise use \ref MFlushDCacheLine.
+ * \param [in]    addr    address in the cache block to be cleaned
+ */
+__STATIC_FORCEINLINE void __CBO_CLEAN(void *addr)
+{
+#if defined(__riscv_zicbom)
+    __ASM volatile("cbo.clean (%0)" : : "r"(addr) : "memory");
+#elif __CMO_CCM_FALLBACK == 1
+    MFlushDCacheLine((unsigned long)addr);
+#else
+    (void)addr;
+#endif
+}
+
+/**
+ * \brief   Clean and invalidate cache block
+ * \details
+ * Write back the cache block if dirty, and invalidate it.
+ * Generate `cbo.flush` instruction when Zicbom is enabled, otherwise use \ref MFlushInvalDCacheLine.
+ * \param [in]    addr    address in the cache block to be flushed
+ */
+__STATIC_FORCEINLINE void __CBO_FLUSH(void *addr)
+{
+#if defined(__riscv_zicbom)
+    __ASM volatile("cbo.flush (%0)" : : "r"(addr) : "memory");
+#elif __CMO_CCM_FALLBACK == 1
+    MFlushInvalDCacheLine((unsigned long)addr);
+#else
+    (void)addr;
+#endif
+}
+
+/**
+ * \brief   Invalidate cache block
+ * \details
+ * Invalidate the cache block, dirty data in it is discarded.
+ * Generate `cbo.inval` instruction when Zicbom is enabled, otherwise use \ref MInvalDCacheLine.
+ * \param [in]    addr    address in the cache block to be invalidated
+ */
+__STATIC_FORCEINLINE void __CBO_INVAL(void *addr)
+{
+#if defined(__riscv_zicbom)
+    __ASM volatile("cbo.inval (%0)" : : "r"(addr) : "memory");
+#elif __CMO_CCM_FALLBACK == 1
+    MInvalDCacheLine((unsigned long)addr);
+#else
+    (void)addr;
+#endif
+}
+
+/**
+ * \brief   Zero cache block
+ * \details
+ * Zero the whole cache block without reading it from memory.
+ * Generate `cbo.zero` instruction when Zicboz is enabled, otherwise zero it by stores.
+ * \param [in]    addr    address in the cache block to be zeroed
+ */
+__STATIC_FORCEINLINE void __CBO_ZERO(void *addr)
+{
+#if defined(__riscv_zicboz)
+    __ASM volatile("cbo.zero (%0)" : : "r"(addr) : "memory");
+#else
+    volatile unsigned long *blk = (volatile unsigned long *)__CMO_BLOCK_ALIGN(addr);
+
+    for (unsigned long i = 0; i < __CMO_BLOCK_SIZE / sizeof(unsigned long); i++) {
+        blk[i] = 0;
+    }
+#endif
+}
+
+/**
+ * \brief   Non-temporal hint of the next memory access, not reused in innermost private cache
+ * \details Generate `ntl.p1` instruction when Zihintntl is enabled, otherwise do nothing.
+ */
+__STATIC_FORCEINLINE void __NTL_P1(void)
+{
+#if defined(__riscv_zihintntl)
+    __ASM volatile("ntl.p1");
+#endif
+}
+
+/**
+ * \brief   Non-temporal hint of the next memory access, not reused in any private cache
+ * \details Generate `ntl.pall` instruction when Zihintntl is enabled, otherwise do nothing.
+ */
+__STATIC_FORCEINLINE void __NTL_PALL(void)
+{
+#if defined(__riscv_zihintntl)
+    __ASM volatile("ntl.pall");
+#endif
+}
+
+/**
+ * \brief   Non-temporal hint of the next memory access, not reused in innermost shared cache
+ * \details Generate `ntl.s1` instruction when Zihintntl is enabled, otherwise do nothing.
+ */
+__STATIC_FORCEINLINE void __NTL_S1(void)
+{
+#if defined(__riscv_zihintntl)
+    __ASM volatile("ntl.s1");
+#endif
+}
+
+/**
+ * \brief   Non-temporal hint of the next memory access, not reused in any cache
+ * \details Generate `ntl.all` instruction when Zihintntl is enabled, otherwise do nothing.
+ */
+__STATIC_FORCEINLINE void __NTL_ALL(void)
+{
+#if defined(__riscv_zihintntl)
+    __ASM volatile("ntl.all");
+#endif
+}
+
+/**
+ * \brief   Prefetch an address range
+ * \details
+ * Prefetch all the cache blocks cover the range, it is used before a streaming kernel
+ * to avoid cold misses on the large input or output buffer.
+ * \param [in]    addr    start address of the range
+ * \param [in]    size    size of the range in bytes
+ * \param [in]    write   0 to prefetch for read, otherwise for write
+ */
+__STATIC_FORCEINLINE void CMOPrefetchRange(const void *addr, unsigned long size, int32_t write)
+{
+#if defined(__riscv_zicbop)
+    unsigned long start = __CMO_BLOCK_ALIGN(addr);
+    unsigned long end = (unsigned long)addr + size;
+
+    if (size == 0) {
+        return;
+    }
+    for (; start < end; start += __CMO_BLOCK_SIZE) {
+        if (write) {
+            __PREFETCH_W((const void *)start);
+        } else {
+            __PREFETCH_R((const void *)start);
+        }
+    }
+#else
+    (void)addr;
+    (void)size;
+    (void)write;
+#endif
+}
+
+/**
+ * \brief   Clean an address range
+ * \details
+ * Write back all the dirty cache blocks cover the range, such as before the output
+ * buffer is used by DMA.
+ * \param [in]    addr    start address of the range
+ * \param [in]    size    size of the range in bytes
+ */
+__STATIC_FORCEINLINE void CMOCleanRange(void *addr, unsigned long size)
+{
+#if defined(__riscv_zicbom)
+    unsigned long start = __CMO_BLOCK_ALIGN(addr);
+    unsigned long end = (unsigned long)addr + size;
+
+    if (size == 0) {
+        return;
+    }
+    for (; start < end; start += __CMO_BLOCK_SIZE) {
+        __CBO_CLEAN((void *)start);
+    }
+#elif __CMO_CCM_FALLBACK == 1
+    MFlushDCacheRange(addr, size);
+#else
+    (void)addr;
+    (void)size;
+#endif
+}
+
+/**
+ * \brief   Clean and invalidate an address range
+ * \param [in]    addr    start address of the range
+ * \param [in]    size    size of the range in bytes
+ */
+__STATIC_FORCEINLINE void CMOFlushRange(void *addr, unsigned long size)
+{
+#if defined(__riscv_zicbom)
+    unsigned long start = __CMO_BLOCK_ALIGN(addr);
+    unsigned long end = (unsigned long)addr + size;
+
+    if (size == 0) {
+        return;
+    }
+    for (; start < end; start += __CMO_BLOCK_SIZE) {
+        __CBO_FLUSH((void *)start);
+    }
+#elif __CMO_CCM_FALLBACK == 1
+    MFlushInvalDCacheRange(addr, size);
+#else
+    (void)addr;
+    (void)size;
+#endif
+}
+
+/**
+ * \brief   Invalidate an address range
+ * \details
+ * Invalidate all the cache blocks cover the range, such as before the input buffer
+ * written by DMA is read. The partial cache blocks at the head and tail of the range
+ * are cleaned and invalidated, so the data out of the range is not lost.
+ * \param [in]    addr    start address of the range
+ * \param [in]    size    size of the range in bytes
+ */
+__STATIC_FORCEINLINE void CMOInvalRange(void *addr, unsigned long size)
+{
+#if defined(__riscv_zicbom)
+    unsigned long start = __CMO_BLOCK_ALIGN(addr);
+    unsigned long end = (unsigned long)addr + size;
+
+    if (size == 0) {
+        return;
+    }
+    for (; start < end; start += __CMO_BLOCK_SIZE) {
+        if ((start < (unsigned long)addr) || (start + __CMO_BLOCK_SIZE > end)) {
+            __CBO_FLUSH((void *)start);
+        } else {
+            __CBO_INVAL((void *)start);
+        }
+    }
+#elif __CMO_CCM_FALLBACK == 1
+    MInvalDCacheRange(addr, size);
+#else
+    (void)addr;
+    (void)size;
+#endif
+}
+
+/**
+ * \brief   Zero an address range
+ * \details
+ * Zero the whole cache blocks in the range by \ref __CBO_ZERO without write-allocate
+ * reading them from memory, the partial head and tail are zeroed by stores, it is used
+ * to clear the output buffer of a streaming kernel.
+ * \param [in]    addr    start address of the range
+ * \param [in]    size    size of the range in bytes
+ */
+__STATIC_FORCEINLINE void CMOZeroRange(void *addr, unsigned long size)
+{
+    unsigned long ptr = (unsigned long)addr;
+    unsigned long end = ptr + size;
+#if defined(__riscv_zicboz)
+    unsigned long blk = __CMO_BLOCK_ALIGN(ptr + __CMO_BLOCK_SIZE - 1);
+    unsigned long blkend = __CMO_BLOCK_ALIGN(end);
+
+    if (blk < blkend) {
+        for (; ptr < blk; ptr++) {
+            *(uint8_t *)ptr = 0;
+        }
+        for (; ptr < blkend; ptr += __CMO_BLOCK_SIZE) {
+            __CBO_ZERO((void *)ptr);
+        }
+    }
+#endif
+    for (; (ptr < end) && (ptr & (sizeof(unsigned long) - 1)); ptr++) {
+        *(uint8_t *)ptr = 0;
+    }
+    for (; ptr + sizeof(unsigned long) <= end; ptr += sizeof(unsigned long)) {
+        *(unsigned long *)ptr = 0;
+    }
+    for (; ptr < end; ptr++) {
+        *(uint8_t *)ptr = 0;
+    }
+}
+/** @} */ /* End of Doxygen Group NMSIS_Core_CMO */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __CORE_FEATURE_CMO_H__ */
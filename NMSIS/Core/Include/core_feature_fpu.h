@@ -296,9 +296,307 @@ typedef uint64_t rv_fpu_t;
         __RV_FLOAD(FREG(29), __fpu_context, 17 << LOG_FPREGBYTES);          \
         __RV_FLOAD(FREG(30), __fpu_context, 18 << LOG_FPREGBYTES);          \
         __RV_FLOAD(FREG(31), __fpu_context, 19 << LOG_FPREGBYTES);
+
+/**
+ * \brief   Whole FPU context of a task
+ * \details
+ * All 32 floating point registers and fcsr, used by \ref __FPU_LazySave
+ * and \ref __FPU_LazyRestore in RTOS context switch.
+ */
+typedef struct {
+    rv_fpu_t freg[32];          /*!< f0 - f31 */
+    rv_csr_t fcsr;              /*!< fcsr */
+} rv_fpu_context_t;
+
+/**
+ * \brief   Save whole FPU context
+ * \param [out]   ctx   FPU context to save f0-f31 and fcsr into
+ */
+__STATIC_FORCEINLINE void __FPU_SaveContext(rv_fpu_context_t *ctx)
+{
+    __RV_FSTORE(FREG(0), ctx->freg, 0 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(1), ctx->freg, 1 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(2), ctx->freg, 2 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(3), ctx->freg, 3 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(4), ctx->freg, 4 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(5), ctx->freg, 5 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(6), ctx->freg, 6 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(7), ctx->freg, 7 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(8), ctx->freg, 8 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(9), ctx->freg, 9 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(10), ctx->freg, 10 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(11), ctx->freg, 11 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(12), ctx->freg, 12 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(13), ctx->freg, 13 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(14), ctx->freg, 14 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(15), ctx->freg, 15 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(16), ctx->freg, 16 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(17), ctx->freg, 17 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(18), ctx->freg, 18 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(19), ctx->freg, 19 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(20), ctx->freg, 20 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(21), ctx->freg, 21 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(22), ctx->freg, 22 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(23), ctx->freg, 23 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(24), ctx->freg, 24 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(25), ctx->freg, 25 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(26), ctx->freg, 26 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(27), ctx->freg, 27 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(28), ctx->freg, 28 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(29), ctx->freg, 29 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(30), ctx->freg, 30 << LOG_FPREGBYTES);
+    __RV_FSTORE(FREG(31), ctx->freg, 31 << LOG_FPREGBYTES);
+    ctx->fcsr = __get_FCSR();
+}
+
+/**
+ * \brief   Restore whole FPU context
+ * \param [in]    ctx   FPU context saved by \ref __FPU_SaveContext
+ */
+__STATIC_FORCEINLINE void __FPU_RestoreContext(const rv_fpu_context_t *ctx)
+{
+    __RV_FLOAD(FREG(0), ctx->freg, 0 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(1), ctx->freg, 1 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(2), ctx->freg, 2 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(3), ctx->freg, 3 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(4), ctx->freg, 4 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(5), ctx->freg, 5 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(6), ctx->freg, 6 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(7), ctx->freg, 7 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(8), ctx->freg, 8 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(9), ctx->freg, 9 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(10), ctx->freg, 10 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(11), ctx->freg, 11 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(12), ctx->freg, 12 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(13), ctx->freg, 13 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(14), ctx->freg, 14 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(15), ctx->freg, 15 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(16), ctx->freg, 16 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(17), ctx->freg, 17 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(18), ctx->freg, 18 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(19), ctx->freg, 19 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(20), ctx->freg, 20 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(21), ctx->freg, 21 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(22), ctx->freg, 22 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(23), ctx->freg, 23 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(24), ctx->freg, 24 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(25), ctx->freg, 25 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(26), ctx->freg, 26 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(27), ctx->freg, 27 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(28), ctx->freg, 28 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(29), ctx->freg, 29 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(30), ctx->freg, 30 << LOG_FPREGBYTES);
+    __RV_FLOAD(FREG(31), ctx->freg, 31 << LOG_FPREGBYTES);
+    __set_FCSR(ctx->fcsr);
+}
+
+/**
+ * \brief   Lazy save FPU context of the task being switched out
+ * \details
+ * Save FPU registers only when mstatus.FS of the task is Dirty, which means
+ * the task modified FPU state since it was switched in, and then mark the state
+ * Clean. An integer only task keeps its FS in Initial state and never pays for
+ * the FPU context save.
+ * \param [out]   ctx       FPU context of the task being switched out
+ * \param [in]    mstatus   mstatus value of the task being switched out
+ * \return        mstatus value to be saved in the task context
+ * \remarks
+ * - It must be paired with \ref __FPU_LazyRestore when the task is switched in
+ */
+__STATIC_FORCEINLINE rv_csr_t __FPU_LazySave(rv_fpu_context_t *ctx, rv_csr_t mstatus)
+{
+    if ((mstatus & MSTATUS_FS) == MSTATUS_FS_DIRTY) {
+        __FPU_SaveContext(ctx);
+        mstatus = (mstatus & ~MSTATUS_FS) | MSTATUS_FS_CLEAN;
+    }
+    return mstatus;
+}
+
+/**
+ * \brief   Lazy restore FPU context of the task being switched in
+ * \details
+ * Restore FPU registers only when the task has used FPU, which means mstatus.FS
+ * of the task is Clean or Dirty. Nothing is restored for task in Initial or Off state.
+ * \param [in]    ctx       FPU context of the task being switched in
+ * \param [in]    mstatus   saved mstatus value of the task being switched in
+ * \remarks
+ * - mstatus.FS of current hart must not be Off when calling this function
+ */
+__STATIC_FORCEINLINE void __FPU_LazyRestore(const rv_fpu_context_t *ctx, rv_csr_t mstatus)
+{
+    rv_csr_t fs = mstatus & MSTATUS_FS;
+
+    if ((fs == MSTATUS_FS_CLEAN) || (fs == MSTATUS_FS_DIRTY)) {
+        __FPU_RestoreContext(ctx);
+    }
+}
+
+/**
+ * \brief   FPU context of an interrupted context, saved by \ref __FPU_ISR_Enter
+ * \details
+ * The caller saved floating point registers f0-f7, f10-f17, f28-f31 and fcsr,
+ * the same registers as \ref SAVE_FPU_CONTEXT, and mstatus.FS on entry.
+ */
+typedef struct {
+    rv_fpu_t freg[20];          /*!< f0-f7, f10-f17, f28-f31 */
+    rv_csr_t fcsr;              /*!< fcsr */
+    rv_csr_t fs;                /*!< mstatus.FS of interrupted context */
+} rv_fpu_isr_context_t;
+
+/**
+ * \brief   Lazy save FPU state of the interrupted context in an interrupt handler
+ * \details
+ * Check mstatus.FS of the interrupted context:
+ * - Off: enable FPU in Initial state for the handler, nothing to save
+ * - Initial: the interrupted context has no FPU state, nothing to save
+ * - Clean or Dirty: save the caller saved registers and fcsr, then mark the state Clean,
+ *   so \ref __FPU_ISR_Exit knows whether the handler really modified FPU state
+ *
+ * Clean is saved as well, since a task switched in by \ref __FPU_LazyRestore is Clean
+ * with its values live in the registers.
+ * \param [out]   ctx   context of the interrupted code, on the stack of the handler
+ * \remarks
+ * - It must be paired with \ref __FPU_ISR_Exit
+ * - No floating point code of the handler may run before it, see \ref FPU_ISR_HANDLER
+ */
+__STATIC_FORCEINLINE void __FPU_ISR_Enter(rv_fpu_isr_context_t *ctx)
+{
+    rv_csr_t fs = __RV_CSR_READ(CSR_MSTATUS) & MSTATUS_FS;
+
+    ctx->fs = fs;
+    if (fs == 0) {
+        __RV_CSR_SET(CSR_MSTATUS, MSTATUS_FS_INITIAL);
+    } else if (fs != MSTATUS_FS_INITIAL) {
+        __RV_FSTORE(FREG(0),  ctx->freg, 0  << LOG_FPREGBYTES);
+        __RV_FSTORE(FREG(1),  ctx->freg, 1  << LOG_FPREGBYTES);
+        __RV_FSTORE(FREG(2),  ctx->freg, 2  << LOG_FPREGBYTES);
+        __RV_FSTORE(FREG(3),  ctx->freg, 3  << LOG_FPREGBYTES);
+        __RV_FSTORE(FREG(4),  ctx->freg, 4  << LOG_FPREGBYTES);
+        __RV_FSTORE(FREG(5),  ctx->freg, 5  << LOG_FPREGBYTES);
+        __RV_FSTORE(FREG(6),  ctx->freg, 6  << LOG_FPREGBYTES);
+        __RV_FSTORE(FREG(7),  ctx->freg, 7  << LOG_FPREGBYTES);
+        __RV_FSTORE(FREG(10), ctx->freg, 8  << LOG_FPREGBYTES);
+        __RV_FSTORE(FREG(11), ctx->freg, 9  << LOG_FPREGBYTES);
+        __RV_FSTORE(FREG(12), ctx->freg, 10 << LOG_FPREGBYTES);
+        __RV_FSTORE(FREG(13), ctx->freg, 11 << LOG_FPREGBYTES);
+        __RV_FSTORE(FREG(14), ctx->freg, 12 << LOG_FPREGBYTES);
+        __RV_FSTORE(FREG(15), ctx->freg, 13 << LOG_FPREGBYTES);
+        __RV_FSTORE(FREG(16), ctx->freg, 14 << LOG_FPREGBYTES);
+        __RV_FSTORE(FREG(17), ctx->freg, 15 << LOG_FPREGBYTES);
+        __RV_FSTORE(FREG(28), ctx->freg, 16 << LOG_FPREGBYTES);
+        __RV_FSTORE(FREG(29), ctx->freg, 17 << LOG_FPREGBYTES);
+        __RV_FSTORE(FREG(30), ctx->freg, 18 << LOG_FPREGBYTES);
+        __RV_FSTORE(FREG(31), ctx->freg, 19 << LOG_FPREGBYTES);
+        ctx->fcsr = __get_FCSR();
+        // Dirty to Clean in one write, a nested handler sees either of them
+        __RV_CSR_CLEAR(CSR_MSTATUS, MSTATUS_FS_INITIAL);
+    }
+}
+
+/**
+ * \brief   Lazy restore FPU state of the interrupted context in an interrupt handler
+ * \details
+ * Nothing is restored when mstatus.FS is not Dirty, which means the handler did not
+ * modify FPU state after \ref __FPU_ISR_Enter. Otherwise the saved registers and fcsr
+ * are restored, or fcsr is reset for an interrupted context in Initial state. Then
+ * mstatus.FS is set back to its value on entry by one CSR write.
+ * \param [in]    ctx   context saved by \ref __FPU_ISR_Enter
+ */
+__STATIC_FORCEINLINE void __FPU_ISR_Exit(const rv_fpu_isr_context_t *ctx)
+{
+    rv_csr_t fs = __RV_CSR_READ(CSR_MSTATUS) & MSTATUS_FS;
+
+    if (fs == MSTATUS_FS_DIRTY) {
+        if ((ctx->fs == MSTATUS_FS_CLEAN) || (ctx->fs == MSTATUS_FS_DIRTY)) {
+            __RV_FLOAD(FREG(0),  ctx->freg, 0  << LOG_FPREGBYTES);
+            __RV_FLOAD(FREG(1),  ctx->freg, 1  << LOG_FPREGBYTES);
+            __RV_FLOAD(FREG(2),  ctx->freg, 2  << LOG_FPREGBYTES);
+            __RV_FLOAD(FREG(3),  ctx->freg, 3  << LOG_FPREGBYTES);
+            __RV_FLOAD(FREG(4),  ctx->freg, 4  << LOG_FPREGBYTES);
+            __RV_FLOAD(FREG(5),  ctx->freg, 5  << LOG_FPREGBYTES);
+            __RV_FLOAD(FREG(6),  ctx->freg, 6  << LOG_FPREGBYTES);
+            __RV_FLOAD(FREG(7),  ctx->freg, 7  << LOG_FPREGBYTES);
+            __RV_FLOAD(FREG(10), ctx->freg, 8  << LOG_FPREGBYTES);
+            __RV_FLOAD(FREG(11), ctx->freg, 9  << LOG_FPREGBYTES);
+            __RV_FLOAD(FREG(12), ctx->freg, 10 << LOG_FPREGBYTES);
+            __RV_FLOAD(FREG(13), ctx->freg, 11 << LOG_FPREGBYTES);
+            __RV_FLOAD(FREG(14), ctx->freg, 12 << LOG_FPREGBYTES);
+            __RV_FLOAD(FREG(15), ctx->freg, 13 << LOG_FPREGBYTES);
+            __RV_FLOAD(FREG(16), ctx->freg, 14 << LOG_FPREGBYTES);
+            __RV_FLOAD(FREG(17), ctx->freg, 15 << LOG_FPREGBYTES);
+            __RV_FLOAD(FREG(28), ctx->freg, 16 << LOG_FPREGBYTES);
+            __RV_FLOAD(FREG(29), ctx->freg, 17 << LOG_FPREGBYTES);
+            __RV_FLOAD(FREG(30), ctx->freg, 18 << LOG_FPREGBYTES);
+            __RV_FLOAD(FREG(31), ctx->freg, 19 << LOG_FPREGBYTES);
+            __set_FCSR(ctx->fcsr);
+        } else {
+            __set_FCSR(0);
+        }
+    }
+    // FS only moves to Dirty or drops bits on the way back, so one set or clear does it
+    if (ctx->fs == MSTATUS_FS_DIRTY) {
+        __RV_CSR_SET(CSR_MSTATUS, MSTATUS_FS_DIRTY);
+    } else if ((fs & ~ctx->fs) != 0) {
+        __RV_CSR_CLEAR(CSR_MSTATUS, __RV_CSR_READ(CSR_MSTATUS) & MSTATUS_FS & ~ctx->fs);
+    }
+}
+
+/**
+ * \brief   Lazy save FPU state in an interrupt handler into variables
+ * \details
+ * Like \ref SAVE_FPU_CONTEXT, but registers are only saved when the interrupted context
+ * has FPU state, see \ref __FPU_ISR_Enter.
+ * \remarks
+ * - It need to be used together with \ref RESTORE_FPU_CONTEXT_LAZY
+ * - Don't use variable names __fpu_isr_context in your ISR code
+ */
+#define SAVE_FPU_CONTEXT_LAZY()                                             \
+        rv_fpu_isr_context_t __fpu_isr_context;                             \
+        __FPU_ISR_Enter(&__fpu_isr_context);
+
+/**
+ * \brief   Lazy restore FPU state saved by \ref SAVE_FPU_CONTEXT_LAZY
+ * \details
+ * Registers are only restored when the handler modified FPU state, see \ref __FPU_ISR_Exit.
+ */
+#define RESTORE_FPU_CONTEXT_LAZY()                                          \
+        __FPU_ISR_Exit(&__fpu_isr_context);
+
+/**
+ * \brief   Define an interrupt handler which runs a floating point function
+ * \details
+ * The handler brackets body with \ref __FPU_ISR_Enter and \ref __FPU_ISR_Exit. body
+ * is a separate function, so the compiler can not move floating point code of it
+ * outside of the bracket, declare it with \c __attribute__((noinline)).
+ * \param     handler   name of interrupt handler
+ * \param     body      void function without arguments doing the work of the handler
+ * \remarks
+ * - It is meant for non-vector interrupt handlers called by the common interrupt entry,
+ *   a handler with __INTERRUPT calling a function makes the compiler save all caller
+ *   saved floating point registers in its prologue anyway
+ * \code
+ * __attribute__((noinline)) static void mtip_work(void)
+ * {
+ *     // floating point code
+ * }
+ *
+ * FPU_ISR_HANDLER(eclic_mtip_handler, mtip_work)
+ * \endcode
+ */
+#define FPU_ISR_HANDLER(handler, body)                                      \
+    void handler(void)                                                      \
+    {                                                                       \
+        rv_fpu_isr_context_t __fpu_isr_context;                             \
+        __FPU_ISR_Enter(&__fpu_isr_context);                                \
+        body();                                                             \
+        __FPU_ISR_Exit(&__fpu_isr_context);                                 \
+    }
 #else
 #define SAVE_FPU_CONTEXT()
 #define RESTORE_FPU_CONTEXT()
+#define SAVE_FPU_CONTEXT_LAZY()
+#define RESTORE_FPU_CONTEXT_LAZY()
+#define FPU_ISR_HANDLER(handler, body)      void handler(void) { body(); }
 #endif /* __FPU_PRESENT > 0 */
 /** @} */ /* End of Doxygen Group NMSIS_Core_FPU_Functions */
 
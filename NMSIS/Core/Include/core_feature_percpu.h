@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __CORE_FEATURE_PERCPU_H__
+#define __CORE_FEATURE_PERCPU_H__
+/*!
+ * @file     core_feature_percpu.h
+ * @brief    Per-CPU variable API header file for Nuclei N/NX Core
+ */
+/*
+ * Per-CPU Feature Configuration Macro:
+ * 1. SMP_CPU_CNT: Number of harts, per-cpu variables are plain variables when it is not larger than 1
+ * 2. __PERCPU_TLS: 1 to place per-cpu variables in thread local sections and reach the copy
+ *    of current hart by tp register, default 1 for GCC and Clang, 0 for others, then they are
+ *    arrays indexed by hart index
+ * 3. __PERCPU_AREA_SIZE: Size in bytes of per-cpu area of each hart, default 256,
+ *    rounded up to __SMP_CACHELINE_SIZE by the SoC which allocates the areas
+ */
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "core_feature_base.h"
+
+/* ##########################  Per-CPU variable functions  #################################### */
+/**
+ * \defgroup NMSIS_Core_PerCPU      Per-CPU Variable Functions
+ * \ingroup  NMSIS_Core
+ * \brief    Functions and macros to define and access variables which have one copy for each hart.
+ * @{
+ *
+ * With \ref __PERCPU_TLS, per-cpu variables are thread local variables, the SoC startup copies
+ * the thread local template (.tdata and .tbss) to a cache line aligned area of each hart, and
+ * sets tp of the hart to its area, so \ref PER_CPU of current hart compiles to one tp-relative
+ * load or store, without reading mhartid, and the copies of harts never share a cache line.
+ *
+ * The linker script must provide `__tdata_start`, `__tdata_end` and `__tbss_end` around the
+ * .tdata and .tbss output sections, .tdata must be in the initialized data, and tp must not be
+ * changed by others, such as the libc or a RTOS port.
+ *
+ * Per-cpu variables are zero initialized, defined at file scope by \ref PER_CPU_DEFINE, and
+ * only valid after the per-cpu area of hart is set up, which is done before main.
+ * When the SoC places the area in local memory of hart, such as DLM by SMP_LOCAL_STACK=1
+ * of evalsoc, \ref PER_CPU_OF works only if the local memory is accessible by other harts.
+ */
+
+#ifndef __PERCPU_TLS
+#if defined(__GNUC__) && defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1)
+#define __PERCPU_TLS                    1       /*!< Per-cpu variables are reached by tp */
+#else
+#define __PERCPU_TLS                    0       /*!< Per-cpu variables are arrays indexed by hart index */
+#endif
+#endif
+
+#ifndef __PERCPU_AREA_SIZE
+#define __PERCPU_AREA_SIZE              256     /*!< Size in bytes of per-cpu area of each hart */
+#endif
+
+#if defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1)
+#if __PERCPU_TLS
+/** \brief Per-cpu area base of each hart, set by SoC startup, used by \ref PER_CPU_OF */
+extern unsigned long PerCPU_Base[SMP_CPU_CNT];
+
+/** \brief Define per-cpu variable name of type */
+#define PER_CPU_DEFINE(type, name)      __thread type name
+/** \brief Declare per-cpu variable name of type defined in other file */
+#define PER_CPU_DECLARE(type, name)     extern __thread type name
+/** \brief Copy of per-cpu variable name of current hart, it is a lvalue */
+#define PER_CPU(name)                   (name)
+/** \brief Copy of per-cpu variable name of hart hartidx, it is a lvalue */
+#define PER_CPU_OF(name, hartidx)       (*(__typeof__(&(name)))((unsigned long)&(name) - \
+                                            __get_percpu_base() + PerCPU_Base[(hartidx)]))
+#else
+#define PER_CPU_DEFINE(type, name)      type name##_percpu[SMP_CPU_CNT]
+#define PER_CPU_DECLARE(type, name)     extern type name##_percpu[SMP_CPU_CNT]
+#define PER_CPU(name)                   (name##_percpu[__get_hart_index()])
+#define PER_CPU_OF(name, hartidx)       (name##_percpu[(hartidx)])
+#endif
+#else
+#define PER_CPU_DEFINE(type, name)      type name
+#define PER_CPU_DECLARE(type, name)     extern type name
+#define PER_CPU(name)                   (name)
+#define PER_CPU_OF(name, hartidx)       (name)
+#endif
+
+/**
+ * \brief   Get per-cpu area base of current hart
+ * \details Read tp register, which points to the per-cpu area of current hart when
+ *          \ref __PERCPU_TLS is 1.
+ * \return  Per-cpu area base
+ */
+__STATIC_FORCEINLINE unsigned long __get_percpu_base(void)
+{
+    unsigned long base;
+
+    __ASM volatile("mv %0, tp" : "=r"(base));
+    return base;
+}
+
+/**
+ * \brief   Set per-cpu area base of current hart
+ * \details Write tp register, done once by SoC startup of each hart before per-cpu
+ *          variables are used.
+ * \param [in]    base    Per-cpu area base
+ */
+__STATIC_FORCEINLINE void __set_percpu_base(unsigned long base)
+{
+    __ASM volatile("mv tp, %0" : : "r"(base) : "memory");
+}
+/** @} */ /* End of Doxygen Group NMSIS_Core_PerCPU */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __CORE_FEATURE_PERCPU_H__ */
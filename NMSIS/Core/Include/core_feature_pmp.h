@@ -154,7 +154,7 @@ __STATIC_INLINE uint8_t __get_PMPxCFG(uint32_t entry_idx)
     cfg_shift = (entry_idx & (csr_cfg_num - 1)) << 3;
 
     /* read specific pmpxcfg register value */
-    return (uint8_t)(__RV_EXTRACT_FIELD(pmpcfgx, 0xFF << cfg_shift));
+    return (uint8_t)(pmpcfgx >> cfg_shift);
 }
 
 /**
@@ -193,7 +193,7 @@ __STATIC_INLINE void __set_PMPxCFG(uint32_t entry_idx, uint8_t pmpxcfg)
      */
     cfg_shift = (entry_idx & (csr_cfg_num - 1)) << 3;
 
-    pmpcfgx = __RV_INSERT_FIELD(pmpcfgx, 0xFFUL << cfg_shift, pmpxcfg);
+    pmpcfgx = (pmpcfgx & ~(0xFFUL << cfg_shift)) | ((rv_csr_t)pmpxcfg << cfg_shift);
     __set_PMPCFGx(csr_idx, pmpcfgx);
 }
 
@@ -160,7 +160,7 @@ __STATIC_INLINE uint8_t __get_sPMPxCFG(uint32_t entry_idx)
     cfg_shift = (entry_idx & (csr_cfg_num - 1)) << 3;
 
     /* read specific spmpxcfg register value */
-    return (uint8_t)(__RV_EXTRACT_FIELD(spmpcfgx, 0xFF << cfg_shift));
+    return (uint8_t)(spmpcfgx >> cfg_shift);
 }
 
 /**
@@ -199,7 +199,7 @@ __STATIC_INLINE void __set_sPMPxCFG(uint32_t entry_idx, uint8_t spmpxcfg)
      */
     cfg_shift = (entry_idx & (csr_cfg_num - 1)) << 3;
 
-    spmpcfgx = __RV_INSERT_FIELD(spmpcfgx, 0xFFUL << cfg_shift, spmpxcfg);
+    spmpcfgx = (spmpcfgx & ~(0xFFUL << cfg_shift)) | ((rv_csr_t)spmpxcfg << cfg_shift);
     __set_sPMPCFGx(csr_idx, spmpcfgx);
 }
 
@@ -0,0 +1,563 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __CORE_FEATURE_SYNC_H__
+#define __CORE_FEATURE_SYNC_H__
+/*!
+ * @file     core_feature_sync.h
+ * @brief    SMP synchronization API header file for Nuclei N/NX Core
+ */
+/*
+ * SMP Synchronization Feature Configuration Macro:
+ * 1. __riscv_atomic: Defined by compiler when A extension is enabled, required by this feature
+ * 2. __SMP_CACHELINE_SIZE: Size in bytes each lock/barrier object is aligned and padded to,
+ *    default to __DCACHE_LINESIZE if defined, otherwise 64
+ * 3. __SMP_SPIN_BACKOFF: Spin loop count waited for each ticket ahead in ticket lock, default 16
+ */
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "core_feature_base.h"
+
+#if defined(__riscv_atomic)
+
+/* ##########################  SMP synchronization functions  #################################### */
+/**
+ * \defgroup NMSIS_Core_Sync        SMP Synchronization Functions
+ * \ingroup  NMSIS_Core
+ * \brief    Functions that provide spinlocks, barriers and seqlocks for SMP harts.
+ * @{
+ *
+ * All the lock objects are aligned and padded to \ref __SMP_CACHELINE_SIZE, so two locks
+ * never share a cache line.
+ *
+ * * \ref TicketLock_Type is a fair FIFO spinlock, harts get the lock in the order they request.
+ * * \ref MCSLock_Type is a fair queue spinlock, each waiting hart spins on its own
+ *   \ref MCSNode_Type, so there is no cache line ping-pong when many harts are waiting.
+ * * \ref SpinBarrier_Type is a sense-reversing barrier, which can be used repeatedly.
+ * * \ref SeqLock_Type allows lock free readers of data which is rarely updated.
+ */
+
+#ifndef __SMP_CACHELINE_SIZE
+#if defined(__DCACHE_LINESIZE)
+#define __SMP_CACHELINE_SIZE            __DCACHE_LINESIZE   /*!< Alignment and padding size of sync objects */
+#else
+#define __SMP_CACHELINE_SIZE            64                  /*!< Alignment and padding size of sync objects */
+#endif
+#endif
+
+#ifndef __SMP_SPIN_BACKOFF
+#define __SMP_SPIN_BACKOFF              16                  /*!< Spin loops waited for each ticket ahead */
+#endif
+
+/** \brief Fair ticket spinlock */
+typedef struct {
+    volatile uint32_t next;             /*!< Next ticket to be taken */
+    volatile uint32_t owner;            /*!< Ticket which owns the lock */
+} __ALIGNED(__SMP_CACHELINE_SIZE) TicketLock_Type;
+
+/** \brief Queue node of MCS lock, one for each hart waiting for or holding the lock */
+typedef struct MCSNode {
+    struct MCSNode * volatile next;     /*!< Next waiting node */
+    volatile uint32_t locked;           /*!< 1 while waiting for the lock */
+} __ALIGNED(__SMP_CACHELINE_SIZE) MCSNode_Type;
+
+/** \brief MCS queue spinlock */
+typedef struct {
+    MCSNode_Type * volatile tail;       /*!< Last node in queue, NULL if unlocked */
+} __ALIGNED(__SMP_CACHELINE_SIZE) MCSLock_Type;
+
+/** \brief Sense-reversing barrier */
+typedef struct {
+    volatile uint32_t count;            /*!< Harts arrived in current round */
+    volatile uint32_t sense;            /*!< Flipped when all harts arrived */
+    uint32_t total;                     /*!< Harts to wait for */
+} __ALIGNED(__SMP_CACHELINE_SIZE) SpinBarrier_Type;
+
+/** \brief Sequence lock, odd sequence means writer is updating */
+typedef struct {
+    volatile uint32_t seq;              /*!< Sequence number */
+} __ALIGNED(__SMP_CACHELINE_SIZE) SeqLock_Type;
+
+/** \brief Static initializer of \ref TicketLock_Type */
+#define TICKETLOCK_INIT                 { 0, 0 }
+/** \brief Static initializer of \ref MCSLock_Type */
+#define MCSLOCK_INIT                    { NULL }
+/** \brief Static initializer of \ref SpinBarrier_Type for n harts */
+#define SPINBARRIER_INIT(n)             { 0, 0, (n) }
+/** \brief Static initializer of \ref SeqLock_Type */
+#define SEQLOCK_INIT                    { 0 }
+
+/**
+ * \brief  Atomic swap pointer sized value
+ * \param [in]    addr      address of the pointer
+ * \param [in]    newval    new pointer to be stored
+ * \return the original pointer
+ */
+__STATIC_FORCEINLINE void *__SYNC_SWAP_PTR(void * volatile *addr, void *newval)
+{
+#if __RISCV_XLEN == 32
+    return (void *)(unsigned long)__AMOSWAP_W((volatile uint32_t *)addr, (uint32_t)(unsigned long)newval);
+#else
+    return (void *)(unsigned long)__AMOSWAP_D((volatile uint64_t *)addr, (uint64_t)(unsigned long)newval);
+#endif
+}
+
+/**
+ * \brief  Compare and swap pointer sized value
+ * \param [in]    addr      address of the pointer
+ * \param [in]    oldval    expected pointer
+ * \param [in]    newval    new pointer to be stored
+ * \return the original pointer, swapped only if it equals to oldval
+ */
+__STATIC_FORCEINLINE void *__SYNC_CAS_PTR(void * volatile *addr, void *oldval, void *newval)
+{
+#if __RISCV_XLEN == 32
+    return (void *)(unsigned long)__CAS_W((volatile uint32_t *)addr, (uint32_t)(unsigned long)oldval, (uint32_t)(unsigned long)newval);
+#else
+    return (void *)(unsigned long)__CAS_D((volatile uint64_t *)addr, (uint64_t)(unsigned long)oldval, (uint64_t)(unsigned long)newval);
+#endif
+}
+
+/**
+ * \brief  Initialize ticket lock
+ * \param [in]    lock    ticket lock to be initialized
+ */
+__STATIC_FORCEINLINE void TicketLock_Init(TicketLock_Type *lock)
+{
+    lock->next = 0;
+    lock->owner = 0;
+    __SMP_RWMB();
+}
+
+/**
+ * \brief  Acquire ticket lock
+ * \details
+ * Take a ticket and wait until it is served, the wait time is proportional to the
+ * tickets ahead, so the lock word is not polled heavily by many harts.
+ * \param [in]    lock    ticket lock
+ */
+__STATIC_FORCEINLINE void TicketLock_Lock(TicketLock_Type *lock)
+{
+    uint32_t ticket = (uint32_t)__AMOADD_W((volatile int32_t *)&lock->next, 1) - 1;
+    uint32_t ahead;
+
+    while ((ahead = ticket - lock->owner) != 0) {
+        for (volatile uint32_t i = 0; i < ahead * __SMP_SPIN_BACKOFF; i++) {
+            __NOP();
+        }
+    }
+    __FENCE(r, rw);
+}
+
+/**
+ * \brief  Try to acquire ticket lock
+ * \param [in]    lock    ticket lock
+ * \return 1 if lock is acquired, otherwise 0
+ */
+__STATIC_FORCEINLINE int32_t TicketLock_TryLock(TicketLock_Type *lock)
+{
+    uint32_t owner = lock->owner;
+
+    if (__CAS_W(&lock->next, owner, owner + 1) != owner) {
+        return 0;
+    }
+    __FENCE(r, rw);
+    return 1;
+}
+
+/**
+ * \brief  Release ticket lock
+ * \param [in]    lock    ticket lock
+ */
+__STATIC_FORCEINLINE void TicketLock_Unlock(TicketLock_Type *lock)
+{
+    __FENCE(rw, w);
+    lock->owner = lock->owner + 1;
+}
+
+/**
+ * \brief  Initialize MCS lock
+ * \param [in]    lock    MCS lock to be initialized
+ */
+__STATIC_FORCEINLINE void MCSLock_Init(MCSLock_Type *lock)
+{
+    lock->tail = NULL;
+    __SMP_RWMB();
+}
+
+/**
+ * \brief  Acquire MCS lock
+ * \details
+ * The hart enqueues its own node and spins only on the node, which is handed over
+ * by the previous lock owner.
+ * \param [in]    lock    MCS lock
+ * \param [in]    node    queue node of current hart, must be kept until \ref MCSLock_Unlock
+ */
+__STATIC_FORCEINLINE void MCSLock_Lock(MCSLock_Type *lock, MCSNode_Type *node)
+{
+    MCSNode_Type *pred;
+
+    node->next = NULL;
+    node->locked = 1;
+    __SMP_RWMB();
+    pred = (MCSNode_Type *)__SYNC_SWAP_PTR((void * volatile *)&lock->tail, node);
+    if (pred != NULL) {
+        pred->next = node;
+        while (node->locked) {
+            __CPU_RELAX();
+        }
+    }
+    __FENCE(r, rw);
+}
+
+/**
+ * \brief  Try to acquire MCS lock
+ * \param [in]    lock    MCS lock
+ * \param [in]    node    queue node of current hart
+ * \return 1 if lock is acquired, otherwise 0
+ */
+__STATIC_FORCEINLINE int32_t MCSLock_TryLock(MCSLock_Type *lock, MCSNode_Type *node)
+{
+    node->next = NULL;
+    node->locked = 0;
+    __SMP_RWMB();
+    if (__SYNC_CAS_PTR((void * volatile *)&lock->tail, NULL, node) != NULL) {
+        return 0;
+    }
+    __FENCE(r, rw);
+    return 1;
+}
+
+/**
+ * \brief  Release MCS lock
+ * \param [in]    lock    MCS lock
+ * \param [in]    node    queue node passed to \ref MCSLock_Lock
+ */
+__STATIC_FORCEINLINE void MCSLock_Unlock(MCSLock_Type *lock, MCSNode_Type *node)
+{
+    MCSNode_Type *next;
+
+    __FENCE(rw, rw);
+    next = node->next;
+    if (next == NULL) {
+        if (__SYNC_CAS_PTR((void * volatile *)&lock->tail, node, NULL) == node) {
+            return;
+        }
+        // a new waiter swapped the tail, wait for it to link itself
+        while ((next = node->next) == NULL) {
+            __CPU_RELAX();
+        }
+    }
+    next->locked = 0;
+}
+
+/**
+ * \brief  Initialize barrier
+ * \param [in]    bar     barrier to be initialized
+ * \param [in]    total   number of harts wait on this barrier
+ */
+__STATIC_FORCEINLINE void SpinBarrier_Init(SpinBarrier_Type *bar, uint32_t total)
+{
+    bar->count = 0;
+    bar->sense = 0;
+    bar->total = total;
+    __SMP_RWMB();
+}
+
+/**
+ * \brief  Wait on barrier until all harts arrived
+ * \details
+ * The last arrived hart resets the count and flips the sense to release the others,
+ * so the barrier can be waited on again immediately.
+ * \param [in]    bar     barrier
+ */
+__STATIC_FORCEINLINE void SpinBarrier_Wait(SpinBarrier_Type *bar)
+{
+    uint32_t sense = bar->sense;
+
+    __SMP_RWMB();
+    if ((uint32_t)__AMOADD_W((volatile int32_t *)&bar->count, 1) == bar->total) {
+        bar->count = 0;
+        __SMP_RWMB();
+        bar->sense = !sense;
+    } else {
+        while (bar->sense == sense) {
+            __CPU_RELAX();
+        }
+    }
+    __SMP_RWMB();
+}
+
+/**
+ * \brief  Initialize seqlock
+ * \param [in]    sl      seqlock to be initialized
+ */
+__STATIC_FORCEINLINE void SeqLock_Init(SeqLock_Type *sl)
+{
+    sl->seq = 0;
+    __SMP_RWMB();
+}
+
+/**
+ * \brief  Begin to update data protected by seqlock
+ * \details
+ * Writers are serialized by this function, readers retry while it is updating.
+ * \param [in]    sl      seqlock
+ */
+__STATIC_FORCEINLINE void SeqLock_WriteBegin(SeqLock_Type *sl)
+{
+    uint32_t seq;
+
+    do {
+        seq = sl->seq;
+    } while ((seq & 1) || (__CAS_W(&sl->seq, seq, seq + 1) != seq));
+    __SMP_WMB();
+}
+
+/**
+ * \brief  End to update data protected by seqlock
+ * \param [in]    sl      seqlock
+ */
+__STATIC_FORCEINLINE void SeqLock_WriteEnd(SeqLock_Type *sl)
+{
+    __SMP_WMB();
+    sl->seq = sl->seq + 1;
+}
+
+/**
+ * \brief  Begin to read data protected by seqlock
+ * \param [in]    sl      seqlock
+ * \return sequence number to be passed to \ref SeqLock_ReadRetry
+ */
+__STATIC_FORCEINLINE uint32_t SeqLock_ReadBegin(SeqLock_Type *sl)
+{
+    uint32_t seq;
+
+    while ((seq = sl->seq) & 1) {
+        __CPU_RELAX();
+    }
+    __SMP_RMB();
+    return seq;
+}
+
+/**
+ * \brief  Check whether data read need to be retried
+ * \param [in]    sl      seqlock
+ * \param [in]    seq     sequence number returned by \ref SeqLock_ReadBegin
+ * \return 1 if data is updated while reading and need to read again, otherwise 0
+ */
+__STATIC_FORCEINLINE int32_t SeqLock_ReadRetry(SeqLock_Type *sl, uint32_t seq)
+{
+    __SMP_RMB();
+    return (sl->seq != seq) ? 1 : 0;
+}
+/** @} */ /* End of Doxygen Group NMSIS_Core_Sync */
+
+/**
+ * \defgroup NMSIS_Core_MsgQ        Inter Hart Message Queue Functions
+ * \ingroup  NMSIS_Core
+ * \brief    Functions that pass messages between harts by lock free ring buffer.
+ * @{
+ *
+ * \ref MsgQueue_Type is a lock free ring of pointer sized messages with one consumer hart,
+ * and one or many producer harts.
+ *
+ * * The producer and consumer indexes are placed in different cache lines to avoid false sharing.
+ * * Burst enqueue and dequeue only update the shared indexes once for many messages.
+ * * The optional doorbell is called when messages are put into an empty queue, such as a
+ *   function which calls \ref SysTimer_SendIPI(target) or \ref CIDU_TriggerInterCoreInt,
+ *   so the consumer can sleep in WFI after the queue is drained. The producer decides after
+ *   its messages are published, by whether the consumer had already read everything before
+ *   them, so the doorbell can be rung when the consumer is still awake, but is never missed.
+ *   Before WFI the consumer must arm its wakeup, such as clear and enable the IPI, then
+ *   \ref __SMP_RWMB and check \ref MsgQ_Count again, and only sleep when it is still 0,
+ *   otherwise messages published between the last dequeue and the arming are left in queue.
+ */
+
+/** \brief Doorbell function called to notify the consumer hart with the target passed to \ref MsgQ_Init */
+typedef void (*MsgQ_Doorbell_Type)(unsigned long target);
+
+/** \brief Lock free message queue */
+typedef struct {
+    struct {
+        volatile uint32_t head;         /*!< Next position to be reserved by producers */
+        volatile uint32_t tail;         /*!< Messages before this position are ready */
+    } __ALIGNED(__SMP_CACHELINE_SIZE) prod;
+    struct {
+        volatile uint32_t head;         /*!< Next position to be read by consumer */
+    } __ALIGNED(__SMP_CACHELINE_SIZE) cons;
+    void **ring;                        /*!< Message buffer */
+    uint32_t size;                      /*!< Message buffer size, must be power of 2 */
+    uint32_t multi_prod;                /*!< 1 if multiple harts can enqueue at the same time */
+    MsgQ_Doorbell_Type doorbell;        /*!< Called after enqueued into an empty queue, can be NULL */
+    unsigned long target;               /*!< Argument passed to doorbell, such as consumer hart id */
+} __ALIGNED(__SMP_CACHELINE_SIZE) MsgQueue_Type;
+
+/**
+ * \brief  Initialize message queue
+ * \param [in]    q           message queue to be initialized
+ * \param [in]    ring        buffer of size messages
+ * \param [in]    size        number of messages in buffer, must be power of 2
+ * \param [in]    multi_prod  0 for single producer, 1 for multiple producers
+ * \param [in]    doorbell    function to notify consumer, can be NULL
+ * \param [in]    target      argument passed to doorbell
+ * \return 0 if initialized, -1 if size is invalid
+ */
+__STATIC_FORCEINLINE int32_t MsgQ_Init(MsgQueue_Type *q, void **ring, uint32_t size, uint32_t multi_prod,
+                                       MsgQ_Doorbell_Type doorbell, unsigned long target)
+{
+    if ((size == 0) || ((size & (size - 1)) != 0) || (size > 0x80000000UL)) {
+        return -1;
+    }
+    q->prod.head = 0;
+    q->prod.tail = 0;
+    q->cons.head = 0;
+    q->ring = ring;
+    q->size = size;
+    q->multi_prod = multi_prod;
+    q->doorbell = doorbell;
+    q->target = target;
+    __SMP_RWMB();
+    return 0;
+}
+
+/**
+ * \brief  Get number of messages in queue
+ * \param [in]    q       message queue
+ * \return number of messages ready to be dequeued
+ */
+__STATIC_FORCEINLINE uint32_t MsgQ_Count(MsgQueue_Type *q)
+{
+    return q->prod.tail - q->cons.head;
+}
+
+/**
+ * \brief  Enqueue at most n messages
+ * \details
+ * The messages are enqueued in order, and only the messages which can be put into the
+ * free space are enqueued.
+ * \param [in]    q       message queue
+ * \param [in]    msgs    messages to be enqueued
+ * \param [in]    n       number of messages
+ * \return number of messages enqueued
+ */
+__STATIC_FORCEINLINE uint32_t MsgQ_EnqueueBurst(MsgQueue_Type *q, void * const *msgs, uint32_t n)
+{
+    uint32_t head, next, used, mask = q->size - 1;
+
+    do {
+        head = q->prod.head;
+        used = head - q->cons.head;
+        if (n > q->size - used) {
+            n = q->size - used;
+        }
+        if (n == 0) {
+            return 0;
+        }
+        next = head + n;
+        if (q->multi_prod == 0) {
+            q->prod.head = next;
+            break;
+        }
+    } while (__CAS_W(&q->prod.head, head, next) != head);
+    // slots must not be written before consumer finished reading them
+    __FENCE(r, rw);
+    for (uint32_t i = 0; i < n; i++) {
+        q->ring[(head + i) & mask] = msgs[i];
+    }
+    __FENCE(rw, w);
+    if (q->multi_prod) {
+        // publish in the order reserved
+        while (q->prod.tail != head) {
+            __CPU_RELAX();
+        }
+    }
+    q->prod.tail = next;
+    if (q->doorbell != NULL) {
+        /*
+         * The used count read before reservation is stale, the consumer may drain the older
+         * messages and go to sleep before prod.tail is published, so read its position again
+         * after publishing, the queue was empty for it when it had read everything before head
+         */
+        __SMP_RWMB();
+        if (q->cons.head == head) {
+            q->doorbell(q->target);
+        }
+    }
+    return n;
+}
+
+/**
+ * \brief  Enqueue one message
+ * \param [in]    q       message queue
+ * \param [in]    msg     message to be enqueued
+ * \return 0 if enqueued, -1 if queue is full
+ */
+__STATIC_FORCEINLINE int32_t MsgQ_Enqueue(MsgQueue_Type *q, void *msg)
+{
+    return (MsgQ_EnqueueBurst(q, &msg, 1) == 1) ? 0 : -1;
+}
+
+/**
+ * \brief  Dequeue at most n messages
+ * \details
+ * This function must be called by the only consumer hart of the queue.
+ * \param [in]    q       message queue
+ * \param [out]   msgs    buffer to store dequeued messages
+ * \param [in]    n       max number of messages to be dequeued
+ * \return number of messages dequeued
+ */
+__STATIC_FORCEINLINE uint32_t MsgQ_DequeueBurst(MsgQueue_Type *q, void **msgs, uint32_t n)
+{
+    uint32_t head = q->cons.head, mask = q->size - 1;
+    uint32_t avail = q->prod.tail - head;
+
+    if (n > avail) {
+        n = avail;
+    }
+    if (n == 0) {
+        return 0;
+    }
+    __FENCE(r, rw);
+    for (uint32_t i = 0; i < n; i++) {
+        msgs[i] = q->ring[(head + i) & mask];
+    }
+    __FENCE(rw, w);
+    q->cons.head = head + n;
+    return n;
+}
+
+/**
+ * \brief  Dequeue one message
+ * \param [in]    q       message queue
+ * \param [out]   msg     dequeued message
+ * \return 0 if dequeued, -1 if queue is empty
+ */
+__STATIC_FORCEINLINE int32_t MsgQ_Dequeue(MsgQueue_Type *q, void **msg)
+{
+    return (MsgQ_DequeueBurst(q, msg, 1) == 1) ? 0 : -1;
+}
+/** @} */ /* End of Doxygen Group NMSIS_Core_MsgQ */
+
+#endif /* defined(__riscv_atomic) */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __CORE_FEATURE_SYNC_H__ */
@@ -83,7 +83,335 @@ __STATIC_FORCEINLINE void __disable_vector(void)
     __RV_CSR_CLEAR(CSR_MSTATUS, MSTATUS_VS);
 }
 
+/**
+ * \brief   Whole vector context of a task
+ * \details
+ * Vector CSRs and pointer to the buffer of 32 vector registers, the buffer
+ * size must be at least 32 * vlenb bytes, which can be got by \ref __VECTOR_ContextSize.
+ */
+typedef struct {
+    rv_csr_t vstart;            /*!< vstart */
+    rv_csr_t vcsr;              /*!< vcsr, vxrm and vxsat */
+    rv_csr_t vl;                /*!< vl */
+    rv_csr_t vtype;             /*!< vtype */
+    uint8_t *vreg;              /*!< buffer for v0 - v31 */
+} rv_vector_context_t;
+
+/**
+ * \brief   Get buffer size required by vector registers
+ * \return  32 * vlenb in bytes
+ */
+__STATIC_FORCEINLINE unsigned long __VECTOR_ContextSize(void)
+{
+    return __RV_CSR_READ(CSR_VLENB) * 32;
+}
+
+/**
+ * \brief   Save whole vector context
+ * \param [out]   ctx   vector context, ctx->vreg must point to a buffer of \ref __VECTOR_ContextSize bytes
+ */
+__STATIC_FORCEINLINE void __VECTOR_SaveContext(rv_vector_context_t *ctx)
+{
+    unsigned long grp = __RV_CSR_READ(CSR_VLENB) * 8;
+    uint8_t *p = ctx->vreg;
+
+    ctx->vstart = __RV_CSR_READ(CSR_VSTART);
+    ctx->vcsr = __RV_CSR_READ(CSR_VCSR);
+    ctx->vl = __RV_CSR_READ(CSR_VL);
+    ctx->vtype = __RV_CSR_READ(CSR_VTYPE);
+    __ASM volatile("vs8r.v v0, (%0)" : : "r"(p) : "memory");
+    p += grp;
+    __ASM volatile("vs8r.v v8, (%0)" : : "r"(p) : "memory");
+    p += grp;
+    __ASM volatile("vs8r.v v16, (%0)" : : "r"(p) : "memory");
+    p += grp;
+    __ASM volatile("vs8r.v v24, (%0)" : : "r"(p) : "memory");
+}
+
+/**
+ * \brief   Restore whole vector context
+ * \param [in]    ctx   vector context saved by \ref __VECTOR_SaveContext
+ */
+__STATIC_FORCEINLINE void __VECTOR_RestoreContext(const rv_vector_context_t *ctx)
+{
+    unsigned long grp = __RV_CSR_READ(CSR_VLENB) * 8;
+    uint8_t *p = ctx->vreg;
+
+    __ASM volatile("vl8re8.v v0, (%0)" : : "r"(p) : "memory");
+    p += grp;
+    __ASM volatile("vl8re8.v v8, (%0)" : : "r"(p) : "memory");
+    p += grp;
+    __ASM volatile("vl8re8.v v16, (%0)" : : "r"(p) : "memory");
+    p += grp;
+    __ASM volatile("vl8re8.v v24, (%0)" : : "r"(p) : "memory");
+    /* vl and vtype can only be restored by vsetvl, saved vl never exceeds VLMAX of saved vtype */
+    __ASM volatile("vsetvl x0, %0, %1" : : "r"(ctx->vl), "r"(ctx->vtype));
+    __RV_CSR_WRITE(CSR_VCSR, ctx->vcsr);
+    __RV_CSR_WRITE(CSR_VSTART, ctx->vstart);
+}
+
+/**
+ * \brief   Lazy save vector context of the task being switched out
+ * \details
+ * Save vector registers only when mstatus.VS of the task is Dirty, and then
+ * mark the state Clean, see \ref __FPU_LazySave.
+ * \param [out]   ctx       vector context of the task being switched out
+ * \param [in]    mstatus   mstatus value of the task being switched out
+ * \return        mstatus value to be saved in the task context
+ */
+__STATIC_FORCEINLINE rv_csr_t __VECTOR_LazySave(rv_vector_context_t *ctx, rv_csr_t mstatus)
+{
+    if ((mstatus & MSTATUS_VS) == MSTATUS_VS_DIRTY) {
+        __VECTOR_SaveContext(ctx);
+        mstatus = (mstatus & ~MSTATUS_VS) | MSTATUS_VS_CLEAN;
+    }
+    return mstatus;
+}
+
+/**
+ * \brief   Lazy restore vector context of the task being switched in
+ * \details
+ * Restore vector registers only when mstatus.VS of the task is Clean or Dirty.
+ * \param [in]    ctx       vector context of the task being switched in
+ * \param [in]    mstatus   saved mstatus value of the task being switched in
+ * \remarks
+ * - mstatus.VS of current hart must not be Off when calling this function
+ */
+__STATIC_FORCEINLINE void __VECTOR_LazyRestore(const rv_vector_context_t *ctx, rv_csr_t mstatus)
+{
+    rv_csr_t vs = mstatus & MSTATUS_VS;
+
+    if ((vs == MSTATUS_VS_CLEAN) || (vs == MSTATUS_VS_DIRTY)) {
+        __VECTOR_RestoreContext(ctx);
+    }
+}
+
 /** @} */ /* End of Doxygen Group NMSIS_Core_Vector_Intrinsic */
+
+/* ###########################  CPU Vector Helper Functions ########################### */
+/**
+ * \defgroup NMSIS_Core_Vector_Helper   Vector Length Agnostic Helper Functions
+ * \ingroup  NMSIS_Core
+ * \brief    Functions and macros shared by vector kernels of any VLEN.
+ * \details
+ *
+ * - VLEN: \ref __VECTOR_VLENB reads vlenb, a read-only CSR of one instruction, so it is
+ *   read when needed instead of cached, \ref __VECTOR_VLMAX gives VLMAX of a vtype from it
+ * - vtype: VTYPE_* fields and \ref __VECTOR_SetVL set any SEW, LMUL and tail and mask policy
+ *   for vector assembly, which the intrinsic API selects by the _tu, _tum and _mu suffixes
+ * - Strip mining: \ref __VECTOR_FOREACH loops over n elements in strips of vl, the last
+ *   strip is shorter, kernels advance their pointers by vl in the body
+ * - Reductions: sum, max and dot product of arrays accumulate whole strips with tail
+ *   undisturbed adds, so lanes past vl of the last strip keep their sums, and reduce the
+ *   accumulator once at the end, they need the intrinsic API, see __INC_INTRINSIC_API
+ *
+ *   @{
+ */
+/** vtype.vlmul of LMUL */
+#define VTYPE_VLMUL_MF8             0x5UL
+#define VTYPE_VLMUL_MF4             0x6UL
+#define VTYPE_VLMUL_MF2             0x7UL
+#define VTYPE_VLMUL_M1              0x0UL
+#define VTYPE_VLMUL_M2              0x1UL
+#define VTYPE_VLMUL_M4              0x2UL
+#define VTYPE_VLMUL_M8              0x3UL
+/** vtype.vsew of SEW */
+#define VTYPE_VSEW_E8               (0x0UL << 3)
+#define VTYPE_VSEW_E16              (0x1UL << 3)
+#define VTYPE_VSEW_E32              (0x2UL << 3)
+#define VTYPE_VSEW_E64              (0x3UL << 3)
+/** vtype.vta, tail agnostic, tail elements may be overwritten by 1s, else they are undisturbed */
+#define VTYPE_VTA                   (0x1UL << 6)
+/** vtype.vma, mask agnostic, masked-off elements may be overwritten by 1s, else they are undisturbed */
+#define VTYPE_VMA                   (0x1UL << 7)
+/** vtype of SEW sew and LMUL lmul, eg. VTYPE(E32, M4) | VTYPE_VTA | VTYPE_VMA */
+#define VTYPE(sew, lmul)            (VTYPE_VSEW_##sew | VTYPE_VLMUL_##lmul)
+
+/**
+ * \brief   Get VLEN in bytes
+ * \return  vlenb CSR
+ */
+__STATIC_FORCEINLINE unsigned long __VECTOR_VLENB(void)
+{
+    return __RV_CSR_READ(CSR_VLENB);
+}
+
+/**
+ * \brief   Get VLMAX of vtype
+ * \param [in]    vtype   SEW and LMUL, see \ref VTYPE
+ * \return  VLEN / SEW * LMUL, elements of one register group
+ */
+__STATIC_FORCEINLINE unsigned long __VECTOR_VLMAX(unsigned long vtype)
+{
+    unsigned long bits = __VECTOR_VLENB() * 8 >> (((vtype >> 3) & 0x7UL) + 3);
+    unsigned long lmul = vtype & 0x7UL;
+
+    return (lmul & 0x4UL) ? (bits >> (8 - lmul)) : (bits << lmul);
+}
+
+/**
+ * \brief   Set vl and vtype
+ * \details
+ * vsetvl of avl elements of vtype, with its tail and mask policy, vl and vtype also select
+ * the vector instructions of inline assembly after it, intrinsics set their own.
+ * \param [in]    avl     elements requested
+ * \param [in]    vtype   see \ref VTYPE, \ref VTYPE_VTA and \ref VTYPE_VMA
+ * \return  vl, min(avl, VLMAX) for the avl used by strip mining
+ */
+__STATIC_FORCEINLINE unsigned long __VECTOR_SetVL(unsigned long avl, unsigned long vtype)
+{
+    unsigned long vl;
+
+    __ASM volatile("vsetvl %0, %1, %2" : "=r"(vl) : "r"(avl), "r"(vtype));
+    return vl;
+}
+
+/**
+ * \brief   Strip mining loop over n elements
+ * \details
+ * Run the body following it with vl of e<sew>m<lmul> for each strip of n elements, eg.
+ * \code
+ * __VECTOR_FOREACH(vl, n, 32, 8) {
+ *     __riscv_vse32_v_i32m8(dst, __riscv_vle32_v_i32m8(src, vl), vl);
+ *     src += vl;
+ *     dst += vl;
+ * }
+ * \endcode
+ * vl is a size_t visible in the body only, the body must not change it.
+ */
+#define __VECTOR_FOREACH(vl, n, sew, lmul)                                                  \
+    for (size_t __vrem_##vl = (n), vl; (__vrem_##vl > 0) &&                                 \
+         ((vl = __riscv_vsetvl_e##sew##m##lmul(__vrem_##vl)) != 0); __vrem_##vl -= vl)
+
+#if defined(__INC_INTRINSIC_API) && (__INC_INTRINSIC_API == 1)
+/**
+ * \brief   Sum of int32_t array
+ * \param [in]    src   n elements
+ * \param [in]    n     number of elements
+ * \return  sum modulo 2^32, 0 if n is 0
+ */
+__STATIC_INLINE int32_t __VECTOR_ReduceSum_i32(const int32_t *src, size_t n)
+{
+    size_t vlmax = __riscv_vsetvlmax_e32m8();
+    vint32m8_t acc = __riscv_vmv_v_x_i32m8(0, vlmax);
+
+    __VECTOR_FOREACH(vl, n, 32, 8) {
+        acc = __riscv_vadd_vv_i32m8_tu(acc, acc, __riscv_vle32_v_i32m8(src, vl), vl);
+        src += vl;
+    }
+    return __riscv_vmv_x_s_i32m1_i32(__riscv_vredsum_vs_i32m8_i32m1(acc, __riscv_vmv_s_x_i32m1(0, 1), vlmax));
+}
+
+/**
+ * \brief   Max of int32_t array
+ * \param [in]    src   n elements
+ * \param [in]    n     number of elements
+ * \return  max element, INT32_MIN if n is 0
+ */
+__STATIC_INLINE int32_t __VECTOR_ReduceMax_i32(const int32_t *src, size_t n)
+{
+    size_t vlmax = __riscv_vsetvlmax_e32m8();
+    vint32m8_t acc = __riscv_vmv_v_x_i32m8(INT32_MIN, vlmax);
+
+    __VECTOR_FOREACH(vl, n, 32, 8) {
+        acc = __riscv_vmax_vv_i32m8_tu(acc, acc, __riscv_vle32_v_i32m8(src, vl), vl);
+        src += vl;
+    }
+    return __riscv_vmv_x_s_i32m1_i32(__riscv_vredmax_vs_i32m8_i32m1(acc, __riscv_vmv_s_x_i32m1(INT32_MIN, 1), vlmax));
+}
+
+#if defined(__riscv_v_elen) && (__riscv_v_elen >= 64)
+/**
+ * \brief   Dot product of int16_t arrays
+ * \details
+ * Products are widened to int32_t and each strip is summed into int64_t, so no length
+ * overflows, needs ELEN 64.
+ * \param [in]    a     n elements
+ * \param [in]    b     n elements
+ * \param [in]    n     number of elements
+ * \return  exact dot product
+ */
+__STATIC_INLINE int64_t __VECTOR_DotProd_i16(const int16_t *a, const int16_t *b, size_t n)
+{
+    vint64m1_t sum = __riscv_vmv_s_x_i64m1(0, 1);
+    vint32m8_t prod;
+
+    __VECTOR_FOREACH(vl, n, 16, 4) {
+        prod = __riscv_vwmul_vv_i32m8(__riscv_vle16_v_i16m4(a, vl), __riscv_vle16_v_i16m4(b, vl), vl);
+        sum = __riscv_vwredsum_vs_i32m8_i64m1(prod, sum, vl);
+        a += vl;
+        b += vl;
+    }
+    return __riscv_vmv_x_s_i64m1_i64(sum);
+}
+#endif
+
+#if defined(__riscv_v_elen_fp) && (__riscv_v_elen_fp >= 32)
+/**
+ * \brief   Sum of float array
+ * \details
+ * Lanes are summed in an unspecified order, so the result may differ from a sequential
+ * sum in rounding.
+ * \param [in]    src   n elements
+ * \param [in]    n     number of elements
+ * \return  sum, 0 if n is 0
+ */
+__STATIC_INLINE float __VECTOR_ReduceSum_f32(const float *src, size_t n)
+{
+    size_t vlmax = __riscv_vsetvlmax_e32m8();
+    vfloat32m8_t acc = __riscv_vfmv_v_f_f32m8(0.0f, vlmax);
+
+    __VECTOR_FOREACH(vl, n, 32, 8) {
+        acc = __riscv_vfadd_vv_f32m8_tu(acc, acc, __riscv_vle32_v_f32m8(src, vl), vl);
+        src += vl;
+    }
+    return __riscv_vfmv_f_s_f32m1_f32(__riscv_vfredusum_vs_f32m8_f32m1(acc, __riscv_vfmv_s_f_f32m1(0.0f, 1), vlmax));
+}
+
+/**
+ * \brief   Max of float array
+ * \param [in]    src   n elements
+ * \param [in]    n     number of elements
+ * \return  max element, -infinity if n is 0
+ */
+__STATIC_INLINE float __VECTOR_ReduceMax_f32(const float *src, size_t n)
+{
+    size_t vlmax = __riscv_vsetvlmax_e32m8();
+    vfloat32m8_t acc = __riscv_vfmv_v_f_f32m8(-__builtin_inff(), vlmax);
+
+    __VECTOR_FOREACH(vl, n, 32, 8) {
+        acc = __riscv_vfmax_vv_f32m8_tu(acc, acc, __riscv_vle32_v_f32m8(src, vl), vl);
+        src += vl;
+    }
+    return __riscv_vfmv_f_s_f32m1_f32(__riscv_vfredmax_vs_f32m8_f32m1(acc, __riscv_vfmv_s_f_f32m1(-__builtin_inff(), 1), vlmax));
+}
+
+/**
+ * \brief   Dot product of float arrays
+ * \details
+ * Products are accumulated per lane by fused multiply-add, then the lanes are summed in
+ * an unspecified order.
+ * \param [in]    a     n elements
+ * \param [in]    b     n elements
+ * \param [in]    n     number of elements
+ * \return  dot product, 0 if n is 0
+ */
+__STATIC_INLINE float __VECTOR_DotProd_f32(const float *a, const float *b, size_t n)
+{
+    size_t vlmax = __riscv_vsetvlmax_e32m8();
+    vfloat32m8_t acc = __riscv_vfmv_v_f_f32m8(0.0f, vlmax);
+
+    __VECTOR_FOREACH(vl, n, 32, 8) {
+        acc = __riscv_vfmacc_vv_f32m8_tu(acc, __riscv_vle32_v_f32m8(a, vl), __riscv_vle32_v_f32m8(b, vl), vl);
+        a += vl;
+        b += vl;
+    }
+    return __riscv_vfmv_f_s_f32m1_f32(__riscv_vfredusum_vs_f32m8_f32m1(acc, __riscv_vfmv_s_f_f32m1(0.0f, 1), vlmax));
+}
+#endif
+#endif /* defined(__INC_INTRINSIC_API) && (__INC_INTRINSIC_API == 1) */
+
+/** @} */ /* End of Doxygen Group NMSIS_Core_Vector_Helper */
 #endif /* defined(__VECTOR_PRESENT) && (__VECTOR_PRESENT == 1) */
 
 #ifdef __cplusplus
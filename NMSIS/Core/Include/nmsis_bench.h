@@ -49,6 +49,36 @@
  * and after the process you want to measure. You can refer to `<nuclei-sdk>/application/baremetal/demo_dsp`
  * for how to use it.
  *
+ * If you want to measure several nested or interleaved processes in the same c source file, you can use
+ * the named benchmark slot macros instead, place `BENCH_SLOT_DECLARE(proc_name);` at file scope for each process,
+ * and use `BENCH_SLOT_START(proc_name);` and `BENCH_SLOT_SAMPLE(proc_name);` around it, each slot will record
+ * its own min/max/sum cycles and sample count, and `BENCH_SLOT_DUMP();` will print all the used slots in one pass.
+ *
+ * If you want to know why a process is slow, you can place `#define NMSIS_BENCH_HPM` before include
+ * `nmsis_bench.h`, then `BENCH_INIT();` will program a set of hpm counters, and BENCH_END/STOP/STAT will
+ * also print the retired instructions, IPC, I/D-Cache miss and branch mispredict rate of the process,
+ * see `BENCH_HPM_EVENTn` for how to change the hpm events.
+ *
+ * `BENCH_INIT();` will measure an empty region `BENCH_CALIB_LOOPS` times, and the median overhead will be subtracted
+ * from every sample, you can place `#define DISABLE_NMSIS_BENCH_CALIB` before include `nmsis_bench.h` to disable it.
+ * If you want to make sure out-of-order execution will not cross the region boundary, you can place
+ * `#define NMSIS_BENCH_SERIALIZE` before include `nmsis_bench.h` to insert fences around cycle read.
+ *
+ * If you care about tail latency such as interrupt entry or context switch, you can use cycle histogram,
+ * place `BENCH_HIST_DECLARE(proc_name, bucket_width, bucket_count);` at file scope, and add samples with
+ * `BENCH_HIST_START/BENCH_HIST_SAMPLE` or `BENCH_HIST_ADD`, and `BENCH_HIST_STAT(proc_name);` will report
+ * p50/p90/p99/max of the samples, you can refer to `<nuclei-sdk>/application/baremetal/benchmark/irqlatency`.
+ *
+ * If you don't want the printf of benchmark result to perturb next measurement, you can place
+ * `#define NMSIS_BENCH_RECORD` before include `nmsis_bench.h`, then benchmark results are only buffered
+ * in RAM, and `BENCH_FLUSH(BENCH_FLUSH_CONSOLE);` will dump them in a compact binary format after measurement,
+ * which can be decoded by `<nuclei-sdk>/Components/profiling/parse_bench.py`.
+ *
+ * In a SMP build which `SMP_CPU_CNT` is larger than 1, BENCH_START/BENCH_SAMPLE/BENCH_END cycles are stored per hart
+ * indexed by `__get_hart_index()`, `BENCH_SMP_START(proc_name);` will synchronize all harts before start,
+ * and `BENCH_SMP_STAT(proc_name);` will print one aggregated report of all harts from the boot hart,
+ * you can place `#define DISABLE_NMSIS_BENCH_SMP` before include `nmsis_bench.h` to disable it.
+ *
  * If you want to disable the benchmark calculation, you can place `#define DISABLE_NMSIS_BENCH`
  * before include `nmsis_bench.h`
  *
@@ -72,60 +102,1064 @@ __STATIC_FORCEINLINE void __prepare_bench_env(void)
     __enable_all_counter();
 }
 
+// High performance monitor event definitions
+/* Events type select */
+#define EVENT_SEL_INSTRUCTION_COMMIT                                               0
+#define EVENT_SEL_MEMORY_ACCESS                                                    1
+
+/* Instruction commit events idx define*/
+#define EVENT_INSTRUCTION_COMMIT_CYCLE_COUNT                                       1
+#define EVENT_INSTRUCTION_COMMIT_RETIRED_COUNT                                     2
+/* Integer load instruction (includes LR) */
+#define EVENT_INSTRUCTION_COMMIT_INTEGER_LOAD                                      3
+/* Integer store instruction (includes SC) */
+#define EVENT_INSTRUCTION_COMMIT_INTEGER_STORE                                     4
+/* Atomic memory operation (do not include LR and SC) */
+#define EVENT_INSTRUCTION_COMMIT_ATOMIC_MEMORY_OPERATION                           5
+/* System instruction */
+#define EVENT_INSTRUCTION_COMMIT_SYSTEM                                            6
+/* Integer computational instruction (excluding multiplication/division/remainder) */
+#define EVENT_INSTRUCTION_COMMIT_INTEGER_COMPUTATIONAL                             7
+#define EVENT_INSTRUCTION_COMMIT_CONDITIONAL_BRANCH                                8
+#define EVENT_INSTRUCTION_COMMIT_TAKEN_CONDITIONAL_BRANCH                          9
+#define EVENT_INSTRUCTION_COMMIT_JAL                                               10
+#define EVENT_INSTRUCTION_COMMIT_JALR                                              11
+#define EVENT_INSTRUCTION_COMMIT_RETURN                                            12
+/* Control transfer instruction (CBR+JAL+JALR) */
+#define EVENT_INSTRUCTION_COMMIT_CONTROL_TRANSFER                                  13
+/* 14 Reseved */
+#define EVENT_INSTRUCTION_COMMIT_INTEGER_MULTIPLICATION                            15
+/* Integer division/remainder instruction */
+#define EVENT_INSTRUCTION_COMMIT_INTEGER_DIVISION_REMAINDER                        16
+#define EVENT_INSTRUCTION_COMMIT_FLOATING_POINT_LOAD                               17
+#define EVENT_INSTRUCTION_COMMIT_FLOATING_POINT_STORE                              18
+/* Floating-point addition/subtraction */
+#define EVENT_INSTRUCTION_COMMIT_FLOATING_POINT_ADDITION_SUBTRACTION               19
+#define EVENT_INSTRUCTION_COMMIT_FLOATING_POINT_MULTIPLICATION                     20
+/* Floating-point fused multiply-add (FMADD, FMSUB, FNMSUB, FNMADD) */
+#define EVENT_INSTRUCTION_COMMIT_FLOATING_POINT_FUSED_MULTIPLY_ADD_SUB             21
+#define EVENT_INSTRUCTION_COMMIT_FLOATING_POINT_DIVISION_OR_SQUARE_ROOT            22
+#define EVENT_INSTRUCTION_COMMIT_OTHER_FLOATING_POINT_INSTRUCTION                  23
+#define EVENT_INSTRUCTION_COMMIT_CONDITIONAL_BRANCH_PREDICTION_FAIL                24
+#define EVENT_INSTRUCTION_COMMIT_JAL_PREDICTION_FAIL                               25
+#define EVENT_INSTRUCTION_COMMIT_JALR_PREDICTION_FAIL                              26
+
+/* Memory access events idx define*/
+#define EVENT_MEMORY_ACCESS_ICACHE_MISS                                            1
+#define EVENT_MEMORY_ACCESS_DCACHE_MISS                                            2
+#define EVENT_MEMORY_ACCESS_ITLB_MISS                                              3
+#define EVENT_MEMORY_ACCESS_DTLB_MISS                                              4
+#define EVENT_MEMORY_ACCESS_MAIN_DTLB_MISS                                         5
+
+/* Enable the corresponding performance monitor counter increment for events in Machine/Supervisor/User Mode */
+#define MSU_EVENT_ENABLE                                                           0x0F
+#define MEVENT_EN                                                                  0x08
+#define SEVENT_EN                                                                  0x02
+#define UEVENT_EN                                                                  0x01
+
 #ifndef READ_CYCLE
 /** Read run cycle of cpu */
 #define READ_CYCLE              __get_rv_cycle
 #endif
 
+#ifndef BENCH_CALIB_LOOPS
+/** Loop count of empty region measured in BENCH_INIT to calibrate benchmark overhead */
+#define BENCH_CALIB_LOOPS       15
+#endif
+
+#ifdef NMSIS_BENCH_SERIALIZE
+/** Serialize benchmark region boundary, so out-of-order execution will not cross it */
+#define __BENCH_SERIALIZE()     __RWMB()
+#else
+#define __BENCH_SERIALIZE()
+#endif
+
+/**
+ * \brief   Get median value of benchmark samples
+ * \details
+ * Samples will be sorted in place, it is only used for small sample count such
+ * as overhead calibration, so a simple insertion sort is used.
+ * \param [inout]  samples   benchmark samples
+ * \param [in]     cnt       sample count, must be larger than 0
+ * \return  median value of the samples
+ */
+__STATIC_INLINE uint64_t __bench_median(uint64_t *samples, unsigned long cnt)
+{
+    for (unsigned long i = 1; i < cnt; i ++) {
+        uint64_t val = samples[i];
+        unsigned long j = i;
+        while (j > 0 && samples[j - 1] > val) {
+            samples[j] = samples[j - 1];
+            j --;
+        }
+        samples[j] = val;
+    }
+    return samples[cnt / 2];
+}
+
+/**
+ * \brief   Remove calibrated overhead from a benchmark sample
+ * \param [in]  usecyc     measured cycle cost
+ * \param [in]  ovhcyc     calibrated overhead cycle
+ * \return  cycle cost without overhead, never below 0
+ */
+__STATIC_FORCEINLINE uint64_t __bench_remove_overhead(uint64_t usecyc, uint64_t ovhcyc)
+{
+    return (usecyc > ovhcyc) ? (usecyc - ovhcyc) : 0;
+}
+
+#if defined(NMSIS_BENCH_HPM) && !defined(DISABLE_NMSIS_BENCH)
+/*
+ * HPM aware benchmark mode, define NMSIS_BENCH_HPM before include nmsis_bench.h to enable it.
+ * BENCH_INIT will program mhpmcounter(BENCH_HPM_IDX_BASE + n) with BENCH_HPM_EVENTn, and
+ * BENCH_END/BENCH_STOP/BENCH_STAT will also print the retired instructions and hpm counter
+ * deltas of the region, the default event set is icache miss, dcache miss, conditional branch
+ * and conditional branch prediction fail, you can define BENCH_HPM_EVENTn to other events,
+ * but the IPC/MPKI/rate columns are calculated with the default event meaning.
+ */
+#ifndef BENCH_HPM_IDX_BASE
+/** First mhpmcounter index used by HPM aware benchmark, BENCH_HPM_IDX_BASE ~ BENCH_HPM_IDX_BASE + 3 will be used */
+#define BENCH_HPM_IDX_BASE      3
+#endif
+
+/** Number of mhpmcounters used by HPM aware benchmark */
+#define BENCH_HPM_NUM           4
+
+#ifndef BENCH_HPM_EVENT0
+/** Event of mhpmcounter(BENCH_HPM_IDX_BASE), default icache miss */
+#define BENCH_HPM_EVENT0        ((MSU_EVENT_ENABLE << 28) | (EVENT_MEMORY_ACCESS_ICACHE_MISS << 4) | EVENT_SEL_MEMORY_ACCESS)
+#endif
+#ifndef BENCH_HPM_EVENT1
+/** Event of mhpmcounter(BENCH_HPM_IDX_BASE + 1), default dcache miss */
+#define BENCH_HPM_EVENT1        ((MSU_EVENT_ENABLE << 28) | (EVENT_MEMORY_ACCESS_DCACHE_MISS << 4) | EVENT_SEL_MEMORY_ACCESS)
+#endif
+#ifndef BENCH_HPM_EVENT2
+/** Event of mhpmcounter(BENCH_HPM_IDX_BASE + 2), default conditional branch */
+#define BENCH_HPM_EVENT2        ((MSU_EVENT_ENABLE << 28) | (EVENT_INSTRUCTION_COMMIT_CONDITIONAL_BRANCH << 4) | EVENT_SEL_INSTRUCTION_COMMIT)
+#endif
+#ifndef BENCH_HPM_EVENT3
+/** Event of mhpmcounter(BENCH_HPM_IDX_BASE + 3), default conditional branch prediction fail */
+#define BENCH_HPM_EVENT3        ((MSU_EVENT_ENABLE << 28) | (EVENT_INSTRUCTION_COMMIT_CONDITIONAL_BRANCH_PREDICTION_FAIL << 4) | EVENT_SEL_INSTRUCTION_COMMIT)
+#endif
+
+/** Retired instructions and hpm counter values used by HPM aware benchmark */
+typedef struct {
+    uint64_t instret;                       /*!< retired instructions */
+    uint64_t hpm[BENCH_HPM_NUM];            /*!< hpm counter values */
+} NMSIS_BENCH_HPM_Type;
+
+/**
+ * \brief   Program hpm events used by HPM aware benchmark
+ * \details
+ * Set BENCH_HPM_EVENTn to mhpmevent(BENCH_HPM_IDX_BASE + n) and clear the counters
+ */
+__STATIC_INLINE void __bench_hpm_init(void)
+{
+    const unsigned long events[BENCH_HPM_NUM] = {BENCH_HPM_EVENT0, BENCH_HPM_EVENT1, BENCH_HPM_EVENT2, BENCH_HPM_EVENT3};
+
+    for (unsigned long i = 0; i < BENCH_HPM_NUM; i ++) {
+        __set_hpm_event(BENCH_HPM_IDX_BASE + i, events[i]);
+        __set_hpm_counter(BENCH_HPM_IDX_BASE + i, 0);
+    }
+}
+
+/**
+ * \brief   Clear counter values of HPM aware benchmark
+ * \param [out]  val     counter values to be cleared
+ */
+__STATIC_FORCEINLINE void __bench_hpm_clear(NMSIS_BENCH_HPM_Type *val)
+{
+    val->instret = 0;
+    for (int i = 0; i < BENCH_HPM_NUM; i ++) {
+        val->hpm[i] = 0;
+    }
+}
+
+/**
+ * \brief   Read retired instructions and hpm counters used by HPM aware benchmark
+ * \param [out]  val     where to store the counter values
+ */
+__STATIC_FORCEINLINE void __bench_hpm_read(NMSIS_BENCH_HPM_Type *val)
+{
+    val->instret = __get_rv_instret();
+    val->hpm[0] = __get_hpm_counter(BENCH_HPM_IDX_BASE);
+    val->hpm[1] = __get_hpm_counter(BENCH_HPM_IDX_BASE + 1);
+    val->hpm[2] = __get_hpm_counter(BENCH_HPM_IDX_BASE + 2);
+    val->hpm[3] = __get_hpm_counter(BENCH_HPM_IDX_BASE + 3);
+}
+
+/**
+ * \brief   Calculate counter deltas of a region and accumulate them
+ * \param [in]     stt     counter values at region start
+ * \param [out]    use     counter deltas of this region
+ * \param [inout]  sum     accumulated counter deltas
+ */
+__STATIC_FORCEINLINE void __bench_hpm_sample(const NMSIS_BENCH_HPM_Type *stt, NMSIS_BENCH_HPM_Type *use, NMSIS_BENCH_HPM_Type *sum)
+{
+    NMSIS_BENCH_HPM_Type end;
+
+    __bench_hpm_read(&end);
+    use->instret = end.instret - stt->instret;
+    sum->instret += use->instret;
+    for (int i = 0; i < BENCH_HPM_NUM; i ++) {
+        /* hpm counter may only return low xlen bits */
+        use->hpm[i] = (unsigned long)(end.hpm[i] - stt->hpm[i]);
+        sum->hpm[i] += use->hpm[i];
+    }
+}
+
+/**
+ * \brief   Print counter deltas of a region
+ * \details
+ * Print format: HPMCSV, proc, cycle, instret, ipc, hpm0, hpm1, hpm2, hpm3, icache mpki, dcache mpki, branch miss rate%
+ * For STAT output, the prefix is HPMSTAT and a loop count column is inserted after proc.
+ * \param [in]  tag     line prefix
+ * \param [in]  proc    name of the region
+ * \param [in]  lpcnt   loop count, only printed when it is not 0
+ * \param [in]  cycle   cycle cost of the region
+ * \param [in]  val     counter deltas of the region
+ */
+__STATIC_INLINE void __bench_hpm_print(const char *tag, const char *proc, uint64_t lpcnt, uint64_t cycle, const NMSIS_BENCH_HPM_Type *val)
+{
+    /* all ratios are printed in fixed point to avoid float printf requirement */
+    unsigned long ipc = (cycle == 0) ? 0 : (unsigned long)(val->instret * 1000 / cycle);
+    unsigned long icmpki = (val->instret == 0) ? 0 : (unsigned long)(val->hpm[0] * 1000000 / val->instret);
+    unsigned long dcmpki = (val->instret == 0) ? 0 : (unsigned long)(val->hpm[1] * 1000000 / val->instret);
+    unsigned long brrate = (val->hpm[2] == 0) ? 0 : (unsigned long)(val->hpm[3] * 10000 / val->hpm[2]);
+
+    printf("%s, %s, ", tag, proc);
+    if (lpcnt) {
+        printf("%lu, ", (unsigned long)lpcnt);
+    }
+    printf("%lu, %lu, %lu.%03lu, %lu, %lu, %lu, %lu, %lu.%03lu, %lu.%03lu, %lu.%02lu%%\n", \
+           (unsigned long)cycle, (unsigned long)val->instret, ipc / 1000, ipc % 1000, \
+           (unsigned long)val->hpm[0], (unsigned long)val->hpm[1], (unsigned long)val->hpm[2], (unsigned long)val->hpm[3], \
+           icmpki / 1000, icmpki % 1000, dcmpki / 1000, dcmpki % 1000, brrate / 100, brrate % 100);
+}
+
+#define __BENCH_HPM_DECLARE_VAR()       static NMSIS_BENCH_HPM_Type _bc_hpmstt, _bc_hpmuse, _bc_hpmsum;
+#define __BENCH_HPM_INIT()              __bench_hpm_init(); __bench_hpm_clear(&_bc_hpmsum);
+#define __BENCH_HPM_RESET()             __bench_hpm_clear(&_bc_hpmsum);
+#define __BENCH_HPM_START()             __bench_hpm_read(&_bc_hpmstt);
+#define __BENCH_HPM_SAMPLE()            __bench_hpm_sample(&_bc_hpmstt, &_bc_hpmuse, &_bc_hpmsum);
+/* cycles and loop count by __BC_VAR(), which is the per-hart storage in SMP build */
+#define __BENCH_HPM_END(proc)           __bench_hpm_print("HPMCSV", #proc, 0, __BC_VAR(usecyc), &_bc_hpmuse);
+#define __BENCH_HPM_STOP(proc)          __bench_hpm_print("HPMCSV", #proc, 0, __BC_VAR(sumcyc), &_bc_hpmsum);
+#define __BENCH_HPM_STAT(proc)          __bench_hpm_print("HPMSTAT", #proc, __BC_VAR(lpcnt), __BC_VAR(sumcyc), &_bc_hpmsum);
+
+/** Get retired instructions of last benchmark sample */
+#define BENCH_GET_USEINSTRET()          (_bc_hpmuse.instret)
+/** Get hpm counter n delta of last benchmark sample */
+#define BENCH_GET_USEHPM(n)             (_bc_hpmuse.hpm[n])
+/** Get accumulated retired instructions of benchmark */
+#define BENCH_GET_SUMINSTRET()          (_bc_hpmsum.instret)
+/** Get accumulated hpm counter n delta of benchmark */
+#define BENCH_GET_SUMHPM(n)             (_bc_hpmsum.hpm[n])
+#else
+#define __BENCH_HPM_DECLARE_VAR()
+#define __BENCH_HPM_INIT()
+#define __BENCH_HPM_RESET()
+#define __BENCH_HPM_START()
+#define __BENCH_HPM_SAMPLE()
+#define __BENCH_HPM_END(proc)
+#define __BENCH_HPM_STOP(proc)
+#define __BENCH_HPM_STAT(proc)
+#define BENCH_GET_USEINSTRET()          (0)
+#define BENCH_GET_USEHPM(n)             (0)
+#define BENCH_GET_SUMINSTRET()          (0)
+#define BENCH_GET_SUMHPM(n)             (0)
+#endif
+
+/**
+ * \brief  Named benchmark slot
+ * \details
+ * A benchmark slot holds the cycle statistics of one named proc, it is declared by
+ * \ref BENCH_SLOT_DECLARE, and linked into the slot registry of current c source file
+ * when it is started for the first time, so all the used slots can be dumped by \ref BENCH_SLOT_DUMP.
+ */
+typedef struct NMSIS_BENCH_SLOT {
+    const char *name;                       /*!< name of the proc measured by this slot */
+    uint64_t sttcyc;                        /*!< start cycle of current sample */
+    uint64_t usecyc;                        /*!< cycle cost of last sample */
+    uint64_t sumcyc;                        /*!< sum cycle cost of all samples */
+    uint64_t mincyc;                        /*!< minimum cycle cost of all samples */
+    uint64_t maxcyc;                        /*!< maximum cycle cost of all samples */
+    uint64_t lpcnt;                         /*!< sample count */
+    struct NMSIS_BENCH_SLOT *next;          /*!< next slot in the registry */
+    uint32_t registered;                    /*!< whether this slot is already in the registry */
+} NMSIS_BENCH_SLOT_Type;
+
+/** Initial value of a benchmark slot named proc */
+#define BENCH_SLOT_INITVAL(proc)    { #proc, 0, 0, 0, UINT64_MAX, 0, 0, NULL, 0 }
+
+/**
+ * \brief   Reset a benchmark slot
+ * \details
+ * Clear all the cycle statistics of the slot, the slot is kept in the registry.
+ * \param [in]  slot     benchmark slot to be reset
+ */
+__STATIC_FORCEINLINE void __bench_slot_reset(NMSIS_BENCH_SLOT_Type *slot)
+{
+    slot->usecyc = 0;
+    slot->sumcyc = 0;
+    slot->mincyc = UINT64_MAX;
+    slot->maxcyc = 0;
+    slot->lpcnt = 0;
+}
+
+/**
+ * \brief   Register a benchmark slot into registry
+ * \details
+ * Append the slot to the tail of the registry if it is not registered yet,
+ * so the slots will be dumped in the order they are first used.
+ * \param [in]  head     pointer to the head of benchmark slot registry
+ * \param [in]  slot     benchmark slot to be registered
+ */
+__STATIC_INLINE void __bench_slot_register(NMSIS_BENCH_SLOT_Type **head, NMSIS_BENCH_SLOT_Type *slot)
+{
+    NMSIS_BENCH_SLOT_Type **pnext = head;
+
+    if (slot->registered) {
+        return;
+    }
+    while (*pnext != NULL) {
+        pnext = &((*pnext)->next);
+    }
+    slot->next = NULL;
+    *pnext = slot;
+    slot->registered = 1;
+}
+
+/**
+ * \brief   Start a sample of benchmark slot
+ * \details
+ * Register the slot if required and record the start cycle of this sample.
+ * \param [in]  head     pointer to the head of benchmark slot registry
+ * \param [in]  slot     benchmark slot to be started
+ */
+__STATIC_FORCEINLINE void __bench_slot_start(NMSIS_BENCH_SLOT_Type **head, NMSIS_BENCH_SLOT_Type *slot)
+{
+    if (slot->registered == 0) {
+        __bench_slot_register(head, slot);
+    }
+    __BENCH_SERIALIZE();
+    slot->sttcyc = READ_CYCLE();
+    __BENCH_SERIALIZE();
+}
+
+/**
+ * \brief   Sample a benchmark slot
+ * \details
+ * Calculate start -> sample cost cycle, remove the calibrated overhead, and accumulate it
+ * into the slot statistics.
+ * \param [in]  slot     benchmark slot to be sampled
+ * \param [in]  ovhcyc   calibrated overhead of an empty slot region
+ */
+__STATIC_FORCEINLINE void __bench_slot_sample(NMSIS_BENCH_SLOT_Type *slot, uint64_t ovhcyc)
+{
+    uint64_t usecyc;
+
+    __BENCH_SERIALIZE();
+    usecyc = __bench_remove_overhead(READ_CYCLE() - slot->sttcyc, ovhcyc);
+
+    slot->usecyc = usecyc;
+    slot->sumcyc += usecyc;
+    slot->lpcnt += 1;
+    if (usecyc < slot->mincyc) {
+        slot->mincyc = usecyc;
+    }
+    if (usecyc > slot->maxcyc) {
+        slot->maxcyc = usecyc;
+    }
+}
+
+/**
+ * \brief   Calibrate overhead of benchmark slot
+ * \details
+ * Measure an empty slot region BENCH_CALIB_LOOPS times, and return the median.
+ * \return  overhead cycle of an empty slot region
+ */
+__STATIC_INLINE uint64_t __bench_slot_calibrate(void)
+{
+    NMSIS_BENCH_SLOT_Type slot = BENCH_SLOT_INITVAL(calib);
+    uint64_t samples[BENCH_CALIB_LOOPS];
+
+    /* mark it registered, so it will never be linked into registry */
+    slot.registered = 1;
+    for (unsigned long i = 0; i < BENCH_CALIB_LOOPS; i ++) {
+        __bench_slot_start(NULL, &slot);
+        __bench_slot_sample(&slot, 0);
+        samples[i] = slot.usecyc;
+    }
+    return __bench_median(samples, BENCH_CALIB_LOOPS);
+}
+
+/**
+ * \brief   Get average sample cycle of a benchmark slot
+ * \param [in]  slot     benchmark slot
+ * \return  average cycle cost of all samples, 0 if no sample recorded
+ */
+__STATIC_INLINE uint64_t __bench_slot_avgcyc(const NMSIS_BENCH_SLOT_Type *slot)
+{
+    return (slot->lpcnt == 0) ? 0 : (slot->sumcyc / slot->lpcnt);
+}
+
+/**
+ * \brief   Show statistics of a benchmark slot
+ * \details
+ * Print format: SLOT, proc, loopcnt, sumcyc, mincyc, maxcyc, avgcyc
+ * \param [in]  slot     benchmark slot
+ */
+__STATIC_INLINE void __bench_slot_stat(const NMSIS_BENCH_SLOT_Type *slot)
+{
+    printf("SLOT, %s, %lu, %lu, %lu, %lu, %lu\n", slot->name, (unsigned long)slot->lpcnt, (unsigned long)slot->sumcyc, \
+           (unsigned long)((slot->lpcnt == 0) ? 0 : slot->mincyc), (unsigned long)slot->maxcyc, (unsigned long)__bench_slot_avgcyc(slot));
+}
+
+/**
+ * \brief   Dump statistics of all registered benchmark slots
+ * \details
+ * Print a header line and then the statistics of each slot in the order they are first used
+ * \param [in]  head     head of benchmark slot registry
+ */
+__STATIC_INLINE void __bench_slot_dump(const NMSIS_BENCH_SLOT_Type *head)
+{
+    printf("SLOT, proc, loopcnt, sumcyc, mincyc, maxcyc, avgcyc\n");
+    for (; head != NULL; head = head->next) {
+        __bench_slot_stat(head);
+    }
+}
+
+/**
+ * \brief  Cycle histogram
+ * \details
+ * A cycle histogram counts samples into nbkt buckets of width cycles, bucket n counts
+ * samples in range [n * width, (n + 1) * width), samples larger than nbkt * width are
+ * counted as overflow, its RAM footprint is fixed, and it is used to report percentile
+ * of samples such as interrupt latency, see \ref BENCH_HIST_DECLARE.
+ */
+typedef struct {
+    const char *name;                       /*!< name of the proc measured by this histogram */
+    uint32_t width;                         /*!< cycle width of each bucket */
+    uint32_t nbkt;                          /*!< bucket count */
+    uint32_t *bkt;                          /*!< bucket counters */
+    uint64_t sttcyc;                        /*!< start cycle of current sample */
+    uint64_t cnt;                           /*!< sample count */
+    uint64_t overflow;                      /*!< sample count larger than nbkt * width */
+    uint64_t mincyc;                        /*!< minimum sample */
+    uint64_t maxcyc;                        /*!< maximum sample */
+    uint64_t sumcyc;                        /*!< sum of all samples */
+} NMSIS_BENCH_HIST_Type;
+
+/**
+ * \brief   Reset a cycle histogram
+ * \param [in]  hist     cycle histogram to be reset
+ */
+__STATIC_INLINE void __bench_hist_reset(NMSIS_BENCH_HIST_Type *hist)
+{
+    for (uint32_t i = 0; i < hist->nbkt; i ++) {
+        hist->bkt[i] = 0;
+    }
+    hist->cnt = 0;
+    hist->overflow = 0;
+    hist->mincyc = UINT64_MAX;
+    hist->maxcyc = 0;
+    hist->sumcyc = 0;
+}
+
+/**
+ * \brief   Add a sample into cycle histogram
+ * \param [in]  hist     cycle histogram
+ * \param [in]  cycle    sample cycle to be added
+ */
+__STATIC_FORCEINLINE void __bench_hist_add(NMSIS_BENCH_HIST_Type *hist, uint64_t cycle)
+{
+    uint64_t idx = cycle / hist->width;
+
+    if (idx < hist->nbkt) {
+        hist->bkt[idx] ++;
+    } else {
+        hist->overflow ++;
+    }
+    hist->cnt ++;
+    hist->sumcyc += cycle;
+    if (cycle < hist->mincyc) {
+        hist->mincyc = cycle;
+    }
+    if (cycle > hist->maxcyc) {
+        hist->maxcyc = cycle;
+    }
+}
+
+/**
+ * \brief   Get percentile of cycle histogram
+ * \details
+ * Return the upper bound of the bucket which contains the pct percentile sample,
+ * it will not be larger than the maximum sample, so the precision is bucket width.
+ * \param [in]  hist     cycle histogram
+ * \param [in]  pct      percentile, 0 - 100
+ * \return  percentile cycle, 0 if no sample recorded
+ */
+__STATIC_INLINE uint64_t __bench_hist_percentile(const NMSIS_BENCH_HIST_Type *hist, uint32_t pct)
+{
+    uint64_t target, sum = 0, upper;
+
+    if (hist->cnt == 0) {
+        return 0;
+    }
+    target = (hist->cnt * pct + 99) / 100;
+    target = (target == 0) ? 1 : target;
+    for (uint32_t i = 0; i < hist->nbkt; i ++) {
+        sum += hist->bkt[i];
+        if (sum >= target) {
+            upper = (uint64_t)(i + 1) * hist->width - 1;
+            return (upper > hist->maxcyc) ? hist->maxcyc : upper;
+        }
+    }
+    return hist->maxcyc;
+}
+
+/**
+ * \brief   Show statistics of a cycle histogram
+ * \details
+ * Print format: HIST, proc, cnt, mincyc, avgcyc, p50, p90, p99, maxcyc, overflow
+ * \param [in]  hist     cycle histogram
+ */
+__STATIC_INLINE void __bench_hist_stat(const NMSIS_BENCH_HIST_Type *hist)
+{
+    printf("HIST, %s, %lu, %lu, %lu, %lu, %lu, %lu, %lu, %lu\n", hist->name, (unsigned long)hist->cnt, \
+           (unsigned long)((hist->cnt == 0) ? 0 : hist->mincyc), (unsigned long)((hist->cnt == 0) ? 0 : hist->sumcyc / hist->cnt), \
+           (unsigned long)__bench_hist_percentile(hist, 50), (unsigned long)__bench_hist_percentile(hist, 90), \
+           (unsigned long)__bench_hist_percentile(hist, 99), (unsigned long)hist->maxcyc, (unsigned long)hist->overflow);
+}
+
+/**
+ * \brief   Dump buckets of a cycle histogram
+ * \details
+ * Print format: HISTBKT, proc, bucket lower cycle, count, only none-empty buckets are printed
+ * \param [in]  hist     cycle histogram
+ */
+__STATIC_INLINE void __bench_hist_dump(const NMSIS_BENCH_HIST_Type *hist)
+{
+    for (uint32_t i = 0; i < hist->nbkt; i ++) {
+        if (hist->bkt[i]) {
+            printf("HISTBKT, %s, %lu, %lu\n", hist->name, (unsigned long)i * hist->width, (unsigned long)hist->bkt[i]);
+        }
+    }
+    if (hist->overflow) {
+        printf("HISTBKT, %s, %lu+, %lu\n", hist->name, (unsigned long)hist->nbkt * hist->width, (unsigned long)hist->overflow);
+    }
+}
+
+#if defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1) && !defined(DISABLE_NMSIS_BENCH_SMP) && !defined(DISABLE_NMSIS_BENCH)
+#ifndef NMSIS_BENCH_SMP
+/** Per-hart benchmark mode, enabled by default in SMP build, define DISABLE_NMSIS_BENCH_SMP to disable it */
+#define NMSIS_BENCH_SMP
+#endif
+#endif
+
+#if defined(NMSIS_BENCH_SMP) && !defined(DISABLE_NMSIS_BENCH)
+/*
+ * Per-hart benchmark mode, BENCH_START/BENCH_SAMPLE/BENCH_END/BENCH_STOP/BENCH_STAT
+ * store their cycles and loop count in a per-hart storage indexed by __get_hart_index(),
+ * so harts running benchmark at the same time will not corrupt each other.
+ * BENCH_SMP_START(proc) will synchronize all harts before start, and BENCH_SMP_STAT(proc)
+ * will synchronize all harts and print a single aggregated report from the boot hart.
+ * Benchmark slots, cycle histograms and hpm counters are still shared by all harts.
+ */
+#ifndef BENCH_SMP_NUM
+/** Count of harts which do benchmark, each one need to call BENCH_SMP_START/BENCH_SMP_STAT */
+#define BENCH_SMP_NUM           SMP_CPU_CNT
+#endif
+
+#ifndef BENCH_SMP_BOOT_HART
+#ifdef BOOT_HARTID
+/** Hart id of the hart which print aggregated report */
+#define BENCH_SMP_BOOT_HART     BOOT_HARTID
+#else
+#define BENCH_SMP_BOOT_HART     0
+#endif
+#endif
+
+/** Per-hart benchmark storage, cache line aligned to avoid false sharing */
+typedef struct {
+    volatile uint64_t sttcyc;               /*!< start cycle */
+    volatile uint64_t endcyc;               /*!< end cycle */
+    volatile uint64_t usecyc;               /*!< use cycle of last sample */
+    volatile uint64_t sumcyc;               /*!< sum cycle of all samples */
+    volatile uint64_t lpcnt;                /*!< sample count */
+    volatile uint64_t ercd;                 /*!< error code */
+} __attribute__((aligned(64))) NMSIS_BENCH_HART_Type;
+
+/** Sense reversing barrier used to synchronize harts */
+typedef struct {
+    volatile uint32_t count;                /*!< arrived hart count */
+    volatile uint32_t sense;                /*!< flipped when all harts arrived */
+} NMSIS_BENCH_BARRIER_Type;
+
+/**
+ * \brief   Wait until all harts arrive at this barrier
+ * \details
+ * The last arrived hart reset the count and flip the sense to release the others,
+ * so the barrier can be reused without reinitialization.
+ * \param [in]  bar         barrier
+ * \param [in]  nharts      count of harts to synchronize
+ */
+__STATIC_INLINE void __bench_smp_sync(NMSIS_BENCH_BARRIER_Type *bar, uint32_t nharts)
+{
+    uint32_t sense = bar->sense;
+
+    __SMP_RWMB();
+    /* __AMOADD_W returns the new count, the last hart to arrive sees nharts */
+    if ((uint32_t)__AMOADD_W((volatile int32_t *)&bar->count, 1) == nharts) {
+        bar->count = 0;
+        __SMP_RWMB();
+        bar->sense = !sense;
+    } else {
+        while (bar->sense == sense);
+    }
+    __SMP_RWMB();
+}
+
+/**
+ * \brief   Show aggregated per-hart benchmark statistics
+ * \details
+ * Print format: HART, proc, hartidx, loopcnt, sumcyc for each hart, then
+ * SMP, proc, harts, loopcnt, mincyc, maxcyc, avgcyc, in which min/max/avg are sum cycles
+ * of harts, maxcyc is the wall cycle of the slowest hart.
+ * \param [in]  proc        name of the proc
+ * \param [in]  harts       per-hart benchmark storage
+ * \param [in]  nharts      count of harts
+ */
+__STATIC_INLINE void __bench_smp_stat(const char *proc, const NMSIS_BENCH_HART_Type *harts, uint32_t nharts)
+{
+    uint64_t lpcnt = 0, sumcyc = 0, mincyc = UINT64_MAX, maxcyc = 0;
+
+    for (uint32_t i = 0; i < nharts; i ++) {
+        printf("HART, %s, %lu, %lu, %lu\n", proc, (unsigned long)i, (unsigned long)harts[i].lpcnt, (unsigned long)harts[i].sumcyc);
+        lpcnt += harts[i].lpcnt;
+        sumcyc += harts[i].sumcyc;
+        mincyc = (harts[i].sumcyc < mincyc) ? harts[i].sumcyc : mincyc;
+        maxcyc = (harts[i].sumcyc > maxcyc) ? harts[i].sumcyc : maxcyc;
+    }
+    printf("SMP, %s, %lu, %lu, %lu, %lu, %lu\n", proc, (unsigned long)nharts, (unsigned long)lpcnt, \
+           (unsigned long)mincyc, (unsigned long)maxcyc, (unsigned long)(sumcyc / nharts));
+}
+
+/* Per-hart variable accessor of benchmark */
+#if __PERCPU_TLS
+/* storage of current hart is cached in a per-cpu pointer by BENCH_INIT, so no mhartid read in measured code */
+#define __BC_VAR(var)                   (PER_CPU(_bc_hart)->var)
+#define __BENCH_HART_INIT()             PER_CPU(_bc_hart) = &_bc_harts[__get_hart_index()];
+#define __BENCH_CORE_DECLARE_VAR()      static NMSIS_BENCH_HART_Type _bc_harts[BENCH_SMP_NUM]; \
+                                        static PER_CPU_DEFINE(NMSIS_BENCH_HART_Type *, _bc_hart); \
+                                        static NMSIS_BENCH_BARRIER_Type _bc_smpbar;
+#else
+#define __BC_VAR(var)                   (_bc_harts[__get_hart_index()].var)
+#define __BENCH_HART_INIT()
+#define __BENCH_CORE_DECLARE_VAR()      static NMSIS_BENCH_HART_Type _bc_harts[BENCH_SMP_NUM]; \
+                                        static NMSIS_BENCH_BARRIER_Type _bc_smpbar;
+#endif
+#define __BENCH_HARTIDX()               __get_hart_index()
+#define __BENCH_IS_BOOT_HART()          (__get_hart_id() == BENCH_SMP_BOOT_HART)
+#else
+#define __BC_VAR(var)                   (_bc_##var)
+#define __BENCH_HART_INIT()
+#define __BENCH_HARTIDX()               0
+#define __BENCH_CORE_DECLARE_VAR()      static volatile uint64_t _bc_sttcyc, _bc_endcyc, _bc_usecyc, _bc_sumcyc, _bc_lpcnt, _bc_ercd;
+#endif
+
+#if defined(NMSIS_BENCH_RECORD) && !defined(DISABLE_NMSIS_BENCH)
+/*
+ * Benchmark record mode, define NMSIS_BENCH_RECORD before include nmsis_bench.h to enable it.
+ * BENCH_END/BENCH_STOP/BENCH_STAT/BENCH_SLOT_END/BENCH_SLOT_STAT/BENCH_SLOT_DUMP will not
+ * printf CSV/STAT/SLOT lines, but only append a record into a RAM buffer, and the records
+ * are written out in a compact binary format when BENCH_FLUSH(interface) is called, which
+ * can be decoded by <nuclei-sdk>/Components/profiling/parse_bench.py
+ *
+ * Binary format, all fields are little-endian:
+ * - header: "NBRD" magic, u16 version, u16 reserved, u32 record count, u32 dropped record count
+ * - record: u8 type, u8 name length, u16 hart index, u32 loop count, u64 cycle, u64 min cycle,
+ *   u64 max cycle, name (not NUL terminated)
+ */
+#include <string.h>
+
+#ifndef BENCH_RECORD_NUM
+/** Max benchmark records can be buffered in each c source file */
+#define BENCH_RECORD_NUM        64
+#endif
+
+#ifndef BENCH_RECORD_FILE
+/** Name of the file written by BENCH_FLUSH(BENCH_FLUSH_FILE) */
+#define BENCH_RECORD_FILE       "bench.bin"
+#endif
+
+/** Version of benchmark record binary format */
+#define BENCH_RECORD_VERSION    1
+
+/** Record type of a single sample, same as CSV line of BENCH_END */
+#define BENCH_RECORD_CSV        1
+/** Record type of sum cycle, same as CSV line of BENCH_STOP */
+#define BENCH_RECORD_SUM        2
+/** Record type of statistics, same as STAT line of BENCH_STAT */
+#define BENCH_RECORD_STAT       3
+/** Record type of slot statistics, same as SLOT line of BENCH_SLOT_STAT */
+#define BENCH_RECORD_SLOT       4
+
+/** Benchmark record */
+typedef struct {
+    const char *name;                       /*!< name of the proc */
+    uint32_t type;                          /*!< record type, BENCH_RECORD_xxx */
+    uint32_t hartid;                        /*!< hart index which produce this record */
+    uint32_t lpcnt;                         /*!< loop count */
+    uint64_t cycle;                         /*!< use cycle or sum cycle */
+    uint64_t mincyc;                        /*!< minimum cycle */
+    uint64_t maxcyc;                        /*!< maximum cycle */
+} NMSIS_BENCH_RECORD_Type;
+
+/** Benchmark record buffer */
+typedef struct {
+    uint32_t cnt;                           /*!< buffered record count */
+    uint32_t dropped;                       /*!< dropped record count due to buffer full */
+    NMSIS_BENCH_RECORD_Type rec[BENCH_RECORD_NUM];  /*!< records */
+} NMSIS_BENCH_RECBUF_Type;
+
+/**
+ * \brief   Append a benchmark record into buffer
+ * \details
+ * Only store the record, no output is done, if buffer is full, record is dropped and counted.
+ */
+__STATIC_INLINE void __bench_record_add(NMSIS_BENCH_RECBUF_Type *buf, uint32_t type, const char *name, uint32_t hartid, \
+                                        uint64_t lpcnt, uint64_t cycle, uint64_t mincyc, uint64_t maxcyc)
+{
+    NMSIS_BENCH_RECORD_Type *rec;
+
+    if (buf->cnt >= BENCH_RECORD_NUM) {
+        buf->dropped ++;
+        return;
+    }
+    rec = &buf->rec[buf->cnt];
+    rec->name = name;
+    rec->type = type;
+    rec->hartid = hartid;
+    rec->lpcnt = (uint32_t)lpcnt;
+    rec->cycle = cycle;
+    rec->mincyc = mincyc;
+    rec->maxcyc = maxcyc;
+    buf->cnt ++;
+}
+
+/** Append the statistics of one benchmark slot into buffer */
+__STATIC_INLINE void __bench_record_slot(NMSIS_BENCH_RECBUF_Type *buf, const NMSIS_BENCH_SLOT_Type *slot)
+{
+    __bench_record_add(buf, BENCH_RECORD_SLOT, slot->name, __BENCH_HARTIDX(), slot->lpcnt, slot->sumcyc, \
+                       (slot->lpcnt == 0) ? 0 : slot->mincyc, slot->maxcyc);
+}
+
+/** Append the statistics of all registered benchmark slots into buffer */
+__STATIC_INLINE void __bench_record_slots(NMSIS_BENCH_RECBUF_Type *buf, const NMSIS_BENCH_SLOT_Type *head)
+{
+    for (; head != NULL; head = head->next) {
+        __bench_record_slot(buf, head);
+    }
+}
+
+/** Write out bytes of benchmark records, fp is used for BENCH_FLUSH_FILE, otherwise hex dump in console */
+__STATIC_INLINE void __bench_record_write(FILE *fp, const uint8_t *data, unsigned long len)
+{
+    if (fp != NULL) {
+        fwrite(data, 1, len, fp);
+        return;
+    }
+    for (unsigned long i = 0; i < len; i ++) {
+        printf("%02x", data[i]);
+    }
+    printf("\n");
+}
+
+/** Store little-endian value of nbytes into out */
+__STATIC_FORCEINLINE uint8_t *__bench_record_putle(uint8_t *out, uint64_t val, unsigned long nbytes)
+{
+    for (unsigned long i = 0; i < nbytes; i ++) {
+        *out++ = (uint8_t)(val >> (i * 8));
+    }
+    return out;
+}
+
+/** Flush benchmark records into a file */
+#define BENCH_FLUSH_FILE        1
+/** Flush benchmark records as hex dump in console, use parse.py or parse_bench.py to decode it */
+#define BENCH_FLUSH_CONSOLE     2
+
+/**
+ * \brief   Flush all buffered benchmark records
+ * \details
+ * Write all buffered records in binary format and then clear the buffer.
+ * \param [in]  buf         benchmark record buffer
+ * \param [in]  interface   BENCH_FLUSH_FILE to write BENCH_RECORD_FILE using fopen/fwrite, semihosting is required,
+ *                          otherwise dump them in console, the same format as gprof_collect/gcov_collect console dump
+ */
+__STATIC_INLINE void __bench_record_flush(NMSIS_BENCH_RECBUF_Type *buf, unsigned long interface)
+{
+    FILE *fp = NULL;
+    uint8_t data[32];
+    uint8_t *ptr;
+    unsigned long namelen;
+
+    if (interface == BENCH_FLUSH_FILE) {
+        fp = fopen(BENCH_RECORD_FILE, "wb");
+        if (fp == NULL) {
+            printf("Unable to open %s\n", BENCH_RECORD_FILE);
+            return;
+        }
+    } else {
+        printf("\nDump benchmark data start\n");
+    }
+    ptr = data;
+    *ptr++ = 'N'; *ptr++ = 'B'; *ptr++ = 'R'; *ptr++ = 'D';
+    ptr = __bench_record_putle(ptr, BENCH_RECORD_VERSION, 2);
+    ptr = __bench_record_putle(ptr, 0, 2);
+    ptr = __bench_record_putle(ptr, buf->cnt, 4);
+    ptr = __bench_record_putle(ptr, buf->dropped, 4);
+    __bench_record_write(fp, data, ptr - data);
+    for (uint32_t i = 0; i < buf->cnt; i ++) {
+        const NMSIS_BENCH_RECORD_Type *rec = &buf->rec[i];
+        namelen = strlen(rec->name);
+        namelen = (namelen > 255) ? 255 : namelen;
+        ptr = data;
+        ptr = __bench_record_putle(ptr, rec->type, 1);
+        ptr = __bench_record_putle(ptr, namelen, 1);
+        ptr = __bench_record_putle(ptr, rec->hartid, 2);
+        ptr = __bench_record_putle(ptr, rec->lpcnt, 4);
+        ptr = __bench_record_putle(ptr, rec->cycle, 8);
+        ptr = __bench_record_putle(ptr, rec->mincyc, 8);
+        ptr = __bench_record_putle(ptr, rec->maxcyc, 8);
+        __bench_record_write(fp, data, ptr - data);
+        __bench_record_write(fp, (const uint8_t *)rec->name, namelen);
+    }
+    if (fp != NULL) {
+        fclose(fp);
+        printf("Write %s done!\n", BENCH_RECORD_FILE);
+    } else {
+        printf("\nCREATE: %s\n", BENCH_RECORD_FILE);
+        printf("\nDump benchmark data finished\n");
+    }
+    buf->cnt = 0;
+    buf->dropped = 0;
+}
+
+#define __BENCH_RECORD_DECLARE_VAR()    static NMSIS_BENCH_RECBUF_Type _bc_recbuf;
+#define __BENCH_REPORT_CSV(name, cyc)   __bench_record_add(&_bc_recbuf, BENCH_RECORD_CSV, name, __BENCH_HARTIDX(), 1, cyc, cyc, cyc);
+#define __BENCH_REPORT_SUM(name, lpcnt, cyc)    __bench_record_add(&_bc_recbuf, BENCH_RECORD_SUM, name, __BENCH_HARTIDX(), lpcnt, cyc, 0, 0);
+#define __BENCH_REPORT_STAT(name, lpcnt, cyc)   __bench_record_add(&_bc_recbuf, BENCH_RECORD_STAT, name, __BENCH_HARTIDX(), lpcnt, cyc, 0, 0);
+#define __BENCH_REPORT_SMP(name, harts, nharts) for (uint32_t _bc_h = 0; _bc_h < (nharts); _bc_h ++) { \
+                                            __bench_record_add(&_bc_recbuf, BENCH_RECORD_STAT, name, _bc_h, (harts)[_bc_h].lpcnt, (harts)[_bc_h].sumcyc, 0, 0); \
+                                        }
+#define __BENCH_REPORT_SLOT(slot)       __bench_record_slot(&_bc_recbuf, slot);
+#define __BENCH_REPORT_SLOTS(head)      __bench_record_slots(&_bc_recbuf, head);
+/** Flush all buffered benchmark records, interface can be BENCH_FLUSH_FILE or BENCH_FLUSH_CONSOLE */
+#define BENCH_FLUSH(interface)          __bench_record_flush(&_bc_recbuf, interface);
+#else
+#define __BENCH_RECORD_DECLARE_VAR()
+#define __BENCH_REPORT_CSV(name, cyc)   printf("CSV, %s, %lu\n", name, (unsigned long)(cyc));
+#define __BENCH_REPORT_SUM(name, lpcnt, cyc)    printf("CSV, %s, %lu\n", name, (unsigned long)(cyc));
+#define __BENCH_REPORT_STAT(name, lpcnt, cyc)   printf("STAT, %s, %lu, %lu\n", name, (unsigned long)(lpcnt), (unsigned long)(cyc));
+#define __BENCH_REPORT_SLOT(slot)       __bench_slot_stat(slot);
+#define __BENCH_REPORT_SLOTS(head)      __bench_slot_dump(head);
+#define __BENCH_REPORT_SMP(name, harts, nharts) __bench_smp_stat(name, harts, nharts);
+#define BENCH_FLUSH_FILE        1
+#define BENCH_FLUSH_CONSOLE     2
+#define BENCH_FLUSH(interface)
+#endif
+
 #ifndef DISABLE_NMSIS_BENCH
 
 /** Declare benchmark required variables, need to be placed above all BENCH_xxx macros in each c source code if BENCH_xxx used */
-#define BENCH_DECLARE_VAR()     static volatile uint64_t _bc_sttcyc, _bc_endcyc, _bc_usecyc, _bc_sumcyc, _bc_lpcnt, _bc_ercd;
+#define BENCH_DECLARE_VAR()     __BENCH_CORE_DECLARE_VAR() \
+                                static volatile uint64_t _bc_ovhcyc, _bc_sltovh;  \
+                                static NMSIS_BENCH_SLOT_Type *_bc_slthead __USED = NULL; \
+                                __BENCH_HPM_DECLARE_VAR() \
+                                __BENCH_RECORD_DECLARE_VAR()
 
 /** Initialize benchmark environment, need to called in before other BENCH_xxx macros are called */
 #define BENCH_INIT()            printf("Benchmark initialized\n"); \
                                 __prepare_bench_env(); \
-                                _bc_ercd = 0; _bc_sumcyc = 0;
+                                __BENCH_HART_INIT() \
+                                __BENCH_HPM_INIT(); \
+                                __BC_VAR(ercd) = 0; __BC_VAR(sumcyc) = 0; \
+                                __BENCH_CALIBRATE();
+
+#ifndef DISABLE_NMSIS_BENCH_CALIB
+/*
+ * Measure an empty BENCH_START/BENCH_SAMPLE region BENCH_CALIB_LOOPS times, the median
+ * is subtracted from every sample, the same is done for benchmark slot
+ */
+#define __BENCH_CALIBRATE()     { \
+                                    uint64_t _bc_ovhsmp[BENCH_CALIB_LOOPS]; \
+                                    for (unsigned long _bc_i = 0; _bc_i < BENCH_CALIB_LOOPS; _bc_i ++) { \
+                                        __BENCH_SERIALIZE(); \
+                                        __BC_VAR(sttcyc) = READ_CYCLE(); \
+                                        __BENCH_SERIALIZE(); \
+                                        __BENCH_SERIALIZE(); \
+                                        __BC_VAR(endcyc) = READ_CYCLE(); \
+                                        _bc_ovhsmp[_bc_i] = __BC_VAR(endcyc) - __BC_VAR(sttcyc); \
+                                    } \
+                                    _bc_ovhcyc = __bench_median(_bc_ovhsmp, BENCH_CALIB_LOOPS); \
+                                    _bc_sltovh = __bench_slot_calibrate(); \
+                                    printf("Benchmark overhead calibrated, %lu, %lu\n", (unsigned long)_bc_ovhcyc, (unsigned long)_bc_sltovh); \
+                                }
+#else
+#define __BENCH_CALIBRATE()     _bc_ovhcyc = 0; _bc_sltovh = 0;
+#endif
 
 /** Reset benchmark sum cycle and use cycle for proc */
-#define BENCH_RESET(proc)       _bc_sumcyc = 0; _bc_usecyc = 0; _bc_lpcnt = 0; _bc_ercd = 0;
+#define BENCH_RESET(proc)       __BC_VAR(sumcyc) = 0; __BC_VAR(usecyc) = 0; __BC_VAR(lpcnt) = 0; __BC_VAR(ercd) = 0; \
+                                __BENCH_HPM_RESET();
 
 /** Start to do benchmark for proc, and record start cycle, and reset error code */
-#define BENCH_START(proc)       _bc_ercd = 0; \
-                                _bc_sttcyc = READ_CYCLE();
+#define BENCH_START(proc)       __BC_VAR(ercd) = 0; \
+                                __BENCH_HPM_START(); \
+                                __BENCH_SERIALIZE(); \
+                                __BC_VAR(sttcyc) = READ_CYCLE(); \
+                                __BENCH_SERIALIZE();
 
 /** Sample a benchmark for proc, and record this start -> sample cost cycle, and accumulate it to sum cycle */
-#define BENCH_SAMPLE(proc)      _bc_endcyc = READ_CYCLE(); \
-                                _bc_usecyc = _bc_endcyc - _bc_sttcyc; \
-                                _bc_sumcyc += _bc_usecyc; _bc_lpcnt += 1;
+#define BENCH_SAMPLE(proc)      __BENCH_SERIALIZE(); \
+                                __BC_VAR(endcyc) = READ_CYCLE(); \
+                                __BENCH_HPM_SAMPLE(); \
+                                __BC_VAR(usecyc) = __bench_remove_overhead(__BC_VAR(endcyc) - __BC_VAR(sttcyc), _bc_ovhcyc); \
+                                __BC_VAR(sumcyc) += __BC_VAR(usecyc); __BC_VAR(lpcnt) += 1;
 
 /** Mark end of benchmark for proc, and calc used cycle, and print it */
 #define BENCH_END(proc)         BENCH_SAMPLE(proc); \
-                                printf("CSV, %s, %lu\n", #proc, (unsigned long)_bc_usecyc);
+                                __BENCH_REPORT_CSV(#proc, __BC_VAR(usecyc)); \
+                                __BENCH_HPM_END(proc);
 
 /** Mark stop of benchmark, start -> sample -> sample -> stop, and print the sum cycle of a proc */
-#define BENCH_STOP(proc)        printf("CSV, %s, %lu\n", #proc, (unsigned long)_bc_sumcyc);
+#define BENCH_STOP(proc)        __BENCH_REPORT_SUM(#proc, __BC_VAR(lpcnt), __BC_VAR(sumcyc)); \
+                                __BENCH_HPM_STOP(proc);
 
 /** Show statistics of benchmark, format: STAT, proc, loopcnt, sumcyc */
-#define BENCH_STAT(proc)        printf("STAT, %s, %lu, %lu\n", #proc, (unsigned long)_bc_lpcnt, (unsigned long)_bc_sumcyc);
+#define BENCH_STAT(proc)        __BENCH_REPORT_STAT(#proc, __BC_VAR(lpcnt), __BC_VAR(sumcyc)); \
+                                __BENCH_HPM_STAT(proc);
 
 /** Get benchmark use cycle */
-#define BENCH_GET_USECYC()      (_bc_usecyc)
+#define BENCH_GET_USECYC()      (__BC_VAR(usecyc))
 
 /** Get benchmark sum cycle */
-#define BENCH_GET_SUMCYC()      (_bc_sumcyc)
+#define BENCH_GET_SUMCYC()      (__BC_VAR(sumcyc))
 
 /** Get benchmark loop count */
-#define BENCH_GET_LPCNT()       (_bc_lpcnt)
+#define BENCH_GET_LPCNT()       (__BC_VAR(lpcnt))
+
+/** Get calibrated overhead cycle which is subtracted from every benchmark sample */
+#define BENCH_GET_OVHCYC()      (_bc_ovhcyc)
 
 /** Mark benchmark for proc is errored */
-#define BENCH_ERROR(proc)       _bc_ercd = 1;
+#define BENCH_ERROR(proc)       __BC_VAR(ercd) = 1;
 /** Show the status of the benchmark */
-#define BENCH_STATUS(proc)      if (_bc_ercd) { \
+#define BENCH_STATUS(proc)      if (__BC_VAR(ercd)) { \
                                     printf("ERROR, %s\n", #proc); \
                                 } else { \
                                     printf("SUCCESS, %s\n", #proc); \
                                 }
+
+#ifdef NMSIS_BENCH_SMP
+/** Wait until all BENCH_SMP_NUM harts call BENCH_SMP_SYNC */
+#define BENCH_SMP_SYNC()        __bench_smp_sync(&_bc_smpbar, BENCH_SMP_NUM);
+
+/** Synchronize all harts and then start to do benchmark for proc on each hart */
+#define BENCH_SMP_START(proc)   BENCH_SMP_SYNC(); \
+                                BENCH_START(proc);
+
+/** Synchronize all harts and show aggregated per-hart statistics of proc from boot hart, format: HART/SMP lines */
+#define BENCH_SMP_STAT(proc)    BENCH_SMP_SYNC(); \
+                                if (__BENCH_IS_BOOT_HART()) { \
+                                    __BENCH_REPORT_SMP(#proc, _bc_harts, BENCH_SMP_NUM); \
+                                } \
+                                BENCH_SMP_SYNC();
+#else
+#define BENCH_SMP_SYNC()
+#define BENCH_SMP_START(proc)   BENCH_START(proc);
+#define BENCH_SMP_STAT(proc)    BENCH_STAT(proc);
+#endif
+
+/** Declare a named benchmark slot for proc, need to be placed at file scope after BENCH_DECLARE_VAR */
+#define BENCH_SLOT_DECLARE(proc)    static NMSIS_BENCH_SLOT_Type _bc_slot_##proc = BENCH_SLOT_INITVAL(proc);
+
+/** Reset the statistics of benchmark slot for proc */
+#define BENCH_SLOT_RESET(proc)      __bench_slot_reset(&_bc_slot_##proc);
+
+/** Start a sample of benchmark slot for proc, and record start cycle */
+#define BENCH_SLOT_START(proc)      __bench_slot_start(&_bc_slthead, &_bc_slot_##proc);
+
+/** Sample benchmark slot for proc, and accumulate start -> sample cost cycle into its statistics */
+#define BENCH_SLOT_SAMPLE(proc)     __bench_slot_sample(&_bc_slot_##proc, _bc_sltovh);
+
+/** Mark end of benchmark slot for proc, sample it and print the cost cycle */
+#define BENCH_SLOT_END(proc)        __bench_slot_sample(&_bc_slot_##proc, _bc_sltovh); \
+                                    __BENCH_REPORT_CSV(#proc, _bc_slot_##proc.usecyc);
+
+/** Show statistics of benchmark slot for proc, format: SLOT, proc, loopcnt, sumcyc, mincyc, maxcyc, avgcyc */
+#define BENCH_SLOT_STAT(proc)       __BENCH_REPORT_SLOT(&_bc_slot_##proc);
+
+/** Show statistics of all the benchmark slots used in current c source file */
+#define BENCH_SLOT_DUMP()           __BENCH_REPORT_SLOTS(_bc_slthead);
+
+/** Get benchmark slot use cycle of last sample */
+#define BENCH_SLOT_GET_USECYC(proc) (_bc_slot_##proc.usecyc)
+
+/** Get benchmark slot sum cycle */
+#define BENCH_SLOT_GET_SUMCYC(proc) (_bc_slot_##proc.sumcyc)
+
+/** Get benchmark slot minimum cycle */
+#define BENCH_SLOT_GET_MINCYC(proc) ((_bc_slot_##proc.lpcnt == 0) ? 0 : _bc_slot_##proc.mincyc)
+
+/** Get benchmark slot maximum cycle */
+#define BENCH_SLOT_GET_MAXCYC(proc) (_bc_slot_##proc.maxcyc)
+
+/** Get benchmark slot average cycle */
+#define BENCH_SLOT_GET_AVGCYC(proc) __bench_slot_avgcyc(&_bc_slot_##proc)
+
+/** Get benchmark slot loop count */
+#define BENCH_SLOT_GET_LPCNT(proc)  (_bc_slot_##proc.lpcnt)
+
+/**
+ * Declare a cycle histogram for proc with nbkt buckets of width cycles, need to be placed at file scope,
+ * the RAM footprint is fixed to nbkt * 4 bytes plus the histogram structure
+ */
+#define BENCH_HIST_DECLARE(proc, width, nbkt)   static uint32_t _bc_histbkt_##proc[(nbkt)]; \
+                                    static NMSIS_BENCH_HIST_Type _bc_hist_##proc = { #proc, (width), (nbkt), _bc_histbkt_##proc, 0, 0, 0, UINT64_MAX, 0, 0 };
+
+/** Reset cycle histogram of proc */
+#define BENCH_HIST_RESET(proc)      __bench_hist_reset(&_bc_hist_##proc);
+
+/** Start a sample of cycle histogram for proc, and record start cycle */
+#define BENCH_HIST_START(proc)      __BENCH_SERIALIZE(); \
+                                    _bc_hist_##proc.sttcyc = READ_CYCLE(); \
+                                    __BENCH_SERIALIZE();
+
+/** Sample cycle histogram for proc, and add start -> sample cost cycle into it */
+#define BENCH_HIST_SAMPLE(proc)     __BENCH_SERIALIZE(); \
+                                    __bench_hist_add(&_bc_hist_##proc, __bench_remove_overhead(READ_CYCLE() - _bc_hist_##proc.sttcyc, _bc_ovhcyc));
+
+/** Add a sample cycle measured by yourself into cycle histogram of proc, such as latency between two timestamps */
+#define BENCH_HIST_ADD(proc, cycle) __bench_hist_add(&_bc_hist_##proc, (cycle));
+
+/** Show percentile statistics of cycle histogram for proc, format: HIST, proc, cnt, mincyc, avgcyc, p50, p90, p99, maxcyc, overflow */
+#define BENCH_HIST_STAT(proc)       __bench_hist_stat(&_bc_hist_##proc);
+
+/** Dump none-empty buckets of cycle histogram for proc, format: HISTBKT, proc, bucket lower cycle, count */
+#define BENCH_HIST_DUMP(proc)       __bench_hist_dump(&_bc_hist_##proc);
+
+/** Get pct percentile cycle of cycle histogram for proc */
+#define BENCH_HIST_GET_PCT(proc, pct)   __bench_hist_percentile(&_bc_hist_##proc, (pct))
+
+/** Get maximum cycle of cycle histogram for proc */
+#define BENCH_HIST_GET_MAXCYC(proc) (_bc_hist_##proc.maxcyc)
+
+/** Get sample count of cycle histogram for proc */
+#define BENCH_HIST_GET_CNT(proc)    (_bc_hist_##proc.cnt)
 #else
 #define BENCH_DECLARE_VAR()     static volatile uint64_t _bc_ercd, _bc_lpcnt;
 #define BENCH_INIT()            _bc_ercd = 0; __prepare_bench_env();
@@ -138,72 +1172,45 @@ __STATIC_FORCEINLINE void __prepare_bench_env(void)
 #define BENCH_GET_USECYC()      (0)
 #define BENCH_GET_SUMCYC()      (0)
 #define BENCH_GET_LPCNT()       (_bc_lpcnt)
+#define BENCH_GET_OVHCYC()      (0)
 #define BENCH_ERROR(proc)       _bc_ercd = 1;
 #define BENCH_STATUS(proc)      if (_bc_ercd) { \
                                     printf("ERROR, %s\n", #proc); \
                                 } else { \
                                     printf("SUCCESS, %s\n", #proc); \
                                 }
+#define BENCH_SMP_SYNC()
+#define BENCH_SMP_START(proc)   _bc_ercd = 0;
+#define BENCH_SMP_STAT(proc)
+#define BENCH_SLOT_DECLARE(proc)
+#define BENCH_SLOT_RESET(proc)
+#define BENCH_SLOT_START(proc)
+#define BENCH_SLOT_SAMPLE(proc)
+#define BENCH_SLOT_END(proc)
+#define BENCH_SLOT_STAT(proc)
+#define BENCH_SLOT_DUMP()
+#define BENCH_SLOT_GET_USECYC(proc) (0)
+#define BENCH_SLOT_GET_SUMCYC(proc) (0)
+#define BENCH_SLOT_GET_MINCYC(proc) (0)
+#define BENCH_SLOT_GET_MAXCYC(proc) (0)
+#define BENCH_SLOT_GET_AVGCYC(proc) (0)
+#define BENCH_SLOT_GET_LPCNT(proc)  (0)
+#define BENCH_HIST_DECLARE(proc, width, nbkt)
+#define BENCH_HIST_RESET(proc)
+#define BENCH_HIST_START(proc)
+#define BENCH_HIST_SAMPLE(proc)
+#define BENCH_HIST_ADD(proc, cycle)
+#define BENCH_HIST_STAT(proc)
+#define BENCH_HIST_DUMP(proc)
+#define BENCH_HIST_GET_PCT(proc, pct)   (0)
+#define BENCH_HIST_GET_MAXCYC(proc) (0)
+#define BENCH_HIST_GET_CNT(proc)    (0)
 
 #endif
 
 // High performance monitor bench helpers
 #ifndef DISABLE_NMSIS_HPM
 
-/* Events type select */
-#define EVENT_SEL_INSTRUCTION_COMMIT                                               0
-#define EVENT_SEL_MEMORY_ACCESS                                                    1
-
-/* Instruction commit events idx define*/
-#define EVENT_INSTRUCTION_COMMIT_CYCLE_COUNT                                       1
-#define EVENT_INSTRUCTION_COMMIT_RETIRED_COUNT                                     2
-/* Integer load instruction (includes LR) */
-#define EVENT_INSTRUCTION_COMMIT_INTEGER_LOAD                                      3
-/* Integer store instruction (includes SC) */
-#define EVENT_INSTRUCTION_COMMIT_INTEGER_STORE                                     4
-/* Atomic memory operation (do not include LR and SC) */
-#define EVENT_INSTRUCTION_COMMIT_ATOMIC_MEMORY_OPERATION                           5
-/* System instruction */
-#define EVENT_INSTRUCTION_COMMIT_SYSTEM                                            6
-/* Integer computational instruction (excluding multiplication/division/remainder) */
-#define EVENT_INSTRUCTION_COMMIT_INTEGER_COMPUTATIONAL                             7
-#define EVENT_INSTRUCTION_COMMIT_CONDITIONAL_BRANCH                                8
-#define EVENT_INSTRUCTION_COMMIT_TAKEN_CONDITIONAL_BRANCH                          9
-#define EVENT_INSTRUCTION_COMMIT_JAL                                               10
-#define EVENT_INSTRUCTION_COMMIT_JALR                                              11
-#define EVENT_INSTRUCTION_COMMIT_RETURN                                            12
-/* Control transfer instruction (CBR+JAL+JALR) */
-#define EVENT_INSTRUCTION_COMMIT_CONTROL_TRANSFER                                  13
-/* 14 Reseved */
-#define EVENT_INSTRUCTION_COMMIT_INTEGER_MULTIPLICATION                            15
-/* Integer division/remainder instruction */
-#define EVENT_INSTRUCTION_COMMIT_INTEGER_DIVISION_REMAINDER                        16
-#define EVENT_INSTRUCTION_COMMIT_FLOATING_POINT_LOAD                               17
-#define EVENT_INSTRUCTION_COMMIT_FLOATING_POINT_STORE                              18
-/* Floating-point addition/subtraction */
-#define EVENT_INSTRUCTION_COMMIT_FLOATING_POINT_ADDITION_SUBTRACTION               19
-#define EVENT_INSTRUCTION_COMMIT_FLOATING_POINT_MULTIPLICATION                     20
-/* Floating-point fused multiply-add (FMADD, FMSUB, FNMSUB, FNMADD) */
-#define EVENT_INSTRUCTION_COMMIT_FLOATING_POINT_FUSED_MULTIPLY_ADD_SUB             21
-#define EVENT_INSTRUCTION_COMMIT_FLOATING_POINT_DIVISION_OR_SQUARE_ROOT            22
-#define EVENT_INSTRUCTION_COMMIT_OTHER_FLOATING_POINT_INSTRUCTION                  23
-#define EVENT_INSTRUCTION_COMMIT_CONDITIONAL_BRANCH_PREDICTION_FAIL                24
-#define EVENT_INSTRUCTION_COMMIT_JAL_PREDICTION_FAIL                               25
-#define EVENT_INSTRUCTION_COMMIT_JALR_PREDICTION_FAIL                              26
-
-/* Memory access events idx define*/
-#define EVENT_MEMORY_ACCESS_ICACHE_MISS                                            1
-#define EVENT_MEMORY_ACCESS_DCACHE_MISS                                            2
-#define EVENT_MEMORY_ACCESS_ITLB_MISS                                              3
-#define EVENT_MEMORY_ACCESS_DTLB_MISS                                              4
-#define EVENT_MEMORY_ACCESS_MAIN_DTLB_MISS                                         5
-
-/* Enable the corresponding performance monitor counter increment for events in Machine/Supervisor/User Mode */
-#define MSU_EVENT_ENABLE                                                           0x0F
-#define MEVENT_EN                                                                  0x08
-#define SEVENT_EN                                                                  0x02
-#define UEVENT_EN                                                                  0x01
-
 /** Declare high performance monitor counter idx benchmark required variables, need to be placed above all HPM_xxx macros in each c source code if HPM_xxx used */
 #define HPM_DECLARE_VAR(idx)    static volatile uint64_t __hpm_sttcyc##idx, __hpm_endcyc##idx, __hpm_usecyc##idx, __hpm_sumcyc##idx, __hpm_lpcnt##idx, __hpm_val##idx;
 
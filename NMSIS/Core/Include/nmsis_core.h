@@ -91,6 +91,12 @@
  #include "core_feature_spmp.h"
 /* Include core cache feature header file */
 #include "core_feature_cache.h"
+/* Include core cache management operation feature header file */
+#include "core_feature_cmo.h"
+/* Include core smp synchronization feature header file */
+#include "core_feature_sync.h"
+/* Include core per-cpu variable feature header file */
+#include "core_feature_percpu.h"
 /* Include core cidu feature header file */
  #include "core_feature_cidu.h"
 
@@ -85,6 +85,42 @@
   #define __WEAK                                 __attribute__((weak))
 #endif
 
+/**
+ * \brief Place a function into section locked into I-Cache at boot
+ * \details
+ * Functions with this attribute are placed in section .text.cache_locked, if the linker
+ * script collects this section between __cache_locked_text_start and __cache_locked_text_end,
+ * the SoC startup code will preload and lock it into I-Cache when CCM is present.
+ */
+#ifndef   __CACHE_LOCKED
+  #define __CACHE_LOCKED                         __attribute__((section(".text.cache_locked"), noinline))
+#endif
+
+/**
+ * \brief Place a initialized variable into section locked into D-Cache at boot
+ * \details
+ * Variables with this attribute are placed in section .data.cache_locked, if the linker
+ * script collects this section between __cache_locked_data_start and __cache_locked_data_end,
+ * the SoC startup code will preload and lock it into D-Cache when CCM is present.
+ */
+#ifndef   __CACHE_LOCKED_DATA
+  #define __CACHE_LOCKED_DATA                    __attribute__((section(".data.cache_locked")))
+#endif
+
+/**
+ * \brief Place a function into section copied to ILM at boot
+ * \details
+ * Functions with this attribute are placed in section .ilm_text, if the linker script
+ * collects this section into an output section located in ILM and loaded from flash,
+ * between __ilm_text_start and __ilm_text_end with load address __ilm_text_lma, the SoC
+ * startup code will copy it to ILM before main, so it runs without flash wait states.
+ * Hot functions found by profiling can be collected by linker patterns generated by
+ * tools/scripts/hotilm.py instead of tagging them one by one.
+ */
+#ifndef   __HOT_ILM
+  #define __HOT_ILM                              __attribute__((section(".ilm_text"), noinline))
+#endif
+
 /** \brief specified the vector size of the variable, measured in bytes */
 #ifndef   __VECTOR_SIZE
   #define __VECTOR_SIZE(x)                       __attribute__((vector_size(x)))
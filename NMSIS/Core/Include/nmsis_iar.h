@@ -85,6 +85,16 @@
   #define __WEAK                                 __attribute__((weak))
 #endif
 
+/** \brief Place a function into section locked into I-Cache at boot, not supported in IAR */
+#ifndef   __CACHE_LOCKED
+  #define __CACHE_LOCKED
+#endif
+
+/** \brief Place a initialized variable into section locked into D-Cache at boot, not supported in IAR */
+#ifndef   __CACHE_LOCKED_DATA
+  #define __CACHE_LOCKED_DATA
+#endif
+
 /** \brief specified the vector size of the variable, measured in bytes, not supported in IAR */
 #ifndef   __VECTOR_SIZE
   #define __VECTOR_SIZE(x)
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __NMSIS_RTOS__
+#define __NMSIS_RTOS__
+
+/*!
+ * @file     nmsis_rtos.h
+ * @brief    RTOS task context frame shared by RTOS ports for Nuclei N/NX Core
+ */
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "riscv_encoding.h"
+
+/**
+ * \defgroup NMSIS_Core_RTOS_Frame   NMSIS RTOS Task Context Frame
+ * \ingroup  NMSIS_Core
+ * \brief    Task context frame layout shared by FreeRTOS, UCOSII, RT-Thread and ThreadX ports.
+ * \details
+ *
+ * All the RTOS ports switch task in the SysTimer software interrupt(MSIP), the handler
+ * saves the interrupted task registers into a frame on its stack, and restores the frame
+ * of the next task, the same frame is built in C when a task is created. This header
+ * defines the frame layout once, so the stack initialization code and the assembly context
+ * switch code of every port agree on it, and it can be included by assembly source files.
+ *
+ * The frame is `RV_FRAME_REGNUM` registers of `REGBYTES` bytes, `RV_FRAME_xxx` are the
+ * register indexes from the frame base(the saved stack pointer):
+ * - only x1, x5-x15 are saved for RVE(`__riscv_32e`), x16-x31 are also saved for RVI
+ * - gp and tp are constant so they are not saved
+ * - mstatus is saved in the frame, so FS/VS of each task are kept, which are used by
+ *   \ref __FPU_LazySave and \ref __VECTOR_LazySave to skip FPU/Vector context of tasks
+ *   never using them, new tasks start with \ref RV_FRAME_INITIAL_MSTATUS
+ * - when `RV_FRAME_ZCMP` is defined by a port whose context switch code uses Zcmp
+ *   `cm.push {ra, s0-sN}` and `cm.pop`, ra and s-registers are placed at the top of
+ *   the frame in the order cm.push stores them, the padding cm.push adds for 16 byte
+ *   stack alignment is counted in `RV_FRAME_REGNUM`
+ *   @{
+ */
+
+/** Initial mstatus of new task, return to machine mode with interrupt enabled, FPU/Vector unused */
+#define RV_FRAME_INITIAL_MSTATUS        (MSTATUS_MPP | MSTATUS_MPIE | MSTATUS_FS_INITIAL | MSTATUS_VS_INITIAL)
+
+#if defined(RV_FRAME_ZCMP)
+#if !defined(__riscv_zcmp)
+#error "RV_FRAME_ZCMP requires Zcmp extension, please use a march with zcmp extension"
+#endif
+#define RV_FRAME_EPC                    0
+#define RV_FRAME_MSTATUS                1
+#define RV_FRAME_T0                     2
+#define RV_FRAME_T1                     3
+#define RV_FRAME_T2                     4
+#define RV_FRAME_A0                     5
+#define RV_FRAME_A1                     6
+#define RV_FRAME_A2                     7
+#define RV_FRAME_A3                     8
+#define RV_FRAME_A4                     9
+#define RV_FRAME_A5                     10
+#ifndef __riscv_32e
+#define RV_FRAME_A6                     11
+#define RV_FRAME_A7                     12
+#define RV_FRAME_T3                     13
+#define RV_FRAME_T4                     14
+#define RV_FRAME_T5                     15
+#define RV_FRAME_T6                     16
+/** Registers saved by the handler besides cm.push */
+#define RV_FRAME_LOWER_REGNUM           (RV_FRAME_T6 + 1)
+/** Registers saved by cm.push {ra, s0-s11} */
+#define RV_FRAME_PUSH_REGNUM            13
+#else
+#define RV_FRAME_LOWER_REGNUM           (RV_FRAME_A5 + 1)
+/** Registers saved by cm.push {ra, s0-s1} */
+#define RV_FRAME_PUSH_REGNUM            3
+#endif
+/** cm.push area is rounded up to 16 bytes */
+#define RV_FRAME_PUSH_AREA              ((RV_FRAME_PUSH_REGNUM * REGBYTES + 15) / 16 * 16 / REGBYTES)
+#define RV_FRAME_REGNUM                 (RV_FRAME_LOWER_REGNUM + RV_FRAME_PUSH_AREA)
+/** cm.push stores ra at the highest address, then s0, s1 ... downwards */
+#define RV_FRAME_RA                     (RV_FRAME_REGNUM - 1)
+#define RV_FRAME_S0                     (RV_FRAME_REGNUM - 2)
+#define RV_FRAME_S1                     (RV_FRAME_REGNUM - 3)
+#else
+#define RV_FRAME_EPC                    0
+#define RV_FRAME_RA                     1
+#define RV_FRAME_T0                     2
+#define RV_FRAME_T1                     3
+#define RV_FRAME_T2                     4
+#define RV_FRAME_S0                     5
+#define RV_FRAME_S1                     6
+#define RV_FRAME_A0                     7
+#define RV_FRAME_A1                     8
+#define RV_FRAME_A2                     9
+#define RV_FRAME_A3                     10
+#define RV_FRAME_A4                     11
+#define RV_FRAME_A5                     12
+#ifndef __riscv_32e
+#define RV_FRAME_A6                     13
+#define RV_FRAME_A7                     14
+#define RV_FRAME_S2                     15
+#define RV_FRAME_T3                     25
+#define RV_FRAME_T4                     26
+#define RV_FRAME_T5                     27
+#define RV_FRAME_T6                     28
+#define RV_FRAME_MSTATUS                29
+#else
+#define RV_FRAME_MSTATUS                13
+#endif
+#define RV_FRAME_REGNUM                 (RV_FRAME_MSTATUS + 1)
+#endif
+
+/** Size of task context frame in bytes */
+#define RV_FRAME_SIZE                   (RV_FRAME_REGNUM * REGBYTES)
+
+#ifndef __ASSEMBLY__
+#include "nmsis_compiler.h"
+
+/**
+ * \brief   Build the initial context frame of a new task
+ * \details
+ * Build a frame at the top of task stack as if the task is switched out by the context
+ * switch interrupt just before its entry, so the first switch to it will start the entry
+ * with arg in a0 and return to exit when entry returns.
+ * \param [in]    top       task stack top, the frame is placed below it, must be REGBYTES aligned
+ * \param [in]    entry     task entry address, restored to mepc
+ * \param [in]    arg       argument of task entry, restored to a0
+ * \param [in]    exit      return address of task entry, restored to ra
+ * \param [in]    fill      fill pattern of other registers, to help debug stack usage
+ * \return        frame base, which is the initial saved stack pointer of the task
+ * \remarks
+ * - mstatus of the frame is \ref RV_FRAME_INITIAL_MSTATUS
+ */
+__STATIC_FORCEINLINE unsigned long *__RV_FrameInit(unsigned long *top, unsigned long entry,
+                                                   unsigned long arg, unsigned long exit, unsigned long fill)
+{
+    unsigned long *frame = top - RV_FRAME_REGNUM;
+    unsigned long i;
+
+    for (i = 0; i < RV_FRAME_REGNUM; i++) {
+        frame[i] = fill;
+    }
+    frame[RV_FRAME_EPC] = entry;
+    frame[RV_FRAME_RA] = exit;
+    frame[RV_FRAME_A0] = arg;
+    frame[RV_FRAME_MSTATUS] = RV_FRAME_INITIAL_MSTATUS;
+    return frame;
+}
+
+#endif /* __ASSEMBLY__ */
+
+/** @} */ /* End of Doxygen Group NMSIS_Core_RTOS_Frame */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NMSIS_RTOS__ */
@@ -397,6 +397,11 @@
 #define PMP_SHIFT            2
 #define PMP_COUNT            16
 
+/* === MSECCFG Bits of Smepmp === */
+#define MSECCFG_MML          0x01
+#define MSECCFG_MMWP         0x02
+#define MSECCFG_RLB          0x04
+
 /* === sPMP CFG Bits === */
 #define SPMP_R               PMP_R
 #define SPMP_W               PMP_W
@@ -997,6 +997,855 @@ const float64_t * pSrc,
       float64_t * pResult);
 
 
+/**
+ * @defgroup OnlineStats Online Statistics
+ *
+ * Statistics updated sample by sample, each update costs O(1) instead of processing the
+ * whole block again as riscv_mean_f32(), riscv_var_f32() and riscv_std_f32() do.
+ *
+ * - Running: riscv_running_stats_* objects count all the samples added since init, mean and
+ *   variance of f32 are updated by the Welford method, minimum and maximum are kept.
+ * - Sliding: riscv_sliding_stats_* objects cover the last windowSize samples, each update
+ *   adds in and removes out, the sample leaving the window, which the caller still has in
+ *   its own signal buffer, so the object keeps no copy of the window. out is ignored until
+ *   windowSize samples are added. f32 removal is done by the Welford method too, which
+ *   drifts by rounding over very long runs, init the object again to start over.
+ * - Sliding minimum and maximum: riscv_sliding_minmax_* objects keep monotonic deques of
+ *   the candidates in pVal and pIdx of 2 * windowSize elements each, amortized O(1) per sample.
+ *
+ * q15 and q31 keep 64 bits sums, so they don't drift, the results have the formats of
+ * riscv_mean_q15(), riscv_var_q15(), riscv_mean_q31() and riscv_var_q31(), and q31 keeps
+ * the squares of 1.23 samples as riscv_var_q31() does, so at most 65536 samples are covered.
+ * A q31 sliding window is limited to that, a q31 running object halves its count and sums
+ * when the count reaches \ref RISCV_RUNNING_STATS_Q31_MAX_COUNT, so it can run for ever,
+ * with the older samples weighing less in mean and variance from then on.
+ * Variance is the one of a sample, divided by count - 1, it is 0 for less than 2 samples.
+ */
+
+/**
+ * @ingroup OnlineStats
+ * @brief Count of Q31 running statistics at which count and sums are halved, a full scale
+ * square of 1.23 sample is 2^46, so the sums stay within q63 up to 2^17 samples.
+ */
+#define RISCV_RUNNING_STATS_Q31_MAX_COUNT      65536U
+
+/**
+ * @ingroup OnlineStats
+ * @brief Instance structure for the floating-point running statistics.
+ */
+typedef struct
+{
+        uint32_t count;        /**< number of samples added. */
+        float32_t mean;        /**< mean of samples. */
+        float32_t m2;          /**< sum of squared distances to mean. */
+        float32_t min;         /**< minimum of samples. */
+        float32_t max;         /**< maximum of samples. */
+} riscv_running_stats_instance_f32;
+
+/**
+ * @ingroup OnlineStats
+ * @brief Instance structure for the Q31 running statistics.
+ */
+typedef struct
+{
+        uint32_t count;        /**< number of samples added, up to RISCV_RUNNING_STATS_Q31_MAX_COUNT. */
+        q63_t sum;             /**< sum of samples. */
+        q63_t sumOfSquares;    /**< sum of squares of samples in 1.23 format. */
+        q31_t min;             /**< minimum of samples. */
+        q31_t max;             /**< maximum of samples. */
+} riscv_running_stats_instance_q31;
+
+/**
+ * @ingroup OnlineStats
+ * @brief Instance structure for the Q15 running statistics.
+ */
+typedef struct
+{
+        uint32_t count;        /**< number of samples added. */
+        q63_t sum;             /**< sum of samples. */
+        q63_t sumOfSquares;    /**< sum of squares of samples. */
+        q15_t min;             /**< minimum of samples. */
+        q15_t max;             /**< maximum of samples. */
+} riscv_running_stats_instance_q15;
+
+/**
+ * @ingroup OnlineStats
+ * @brief Instance structure for the floating-point sliding window statistics.
+ */
+typedef struct
+{
+        uint32_t windowSize;   /**< number of samples in window. */
+        uint32_t count;        /**< number of samples in window, up to windowSize. */
+        float32_t mean;        /**< mean of window. */
+        float32_t m2;          /**< sum of squared distances to mean. */
+} riscv_sliding_stats_instance_f32;
+
+/**
+ * @ingroup OnlineStats
+ * @brief Instance structure for the Q31 sliding window statistics.
+ */
+typedef struct
+{
+        uint32_t windowSize;   /**< number of samples in window, up to 65536. */
+        uint32_t count;        /**< number of samples in window, up to windowSize. */
+        q63_t sum;             /**< sum of window. */
+        q63_t sumOfSquares;    /**< sum of squares of window in 1.23 format. */
+} riscv_sliding_stats_instance_q31;
+
+/**
+ * @ingroup OnlineStats
+ * @brief Instance structure for the Q15 sliding window statistics.
+ */
+typedef struct
+{
+        uint32_t windowSize;   /**< number of samples in window. */
+        uint32_t count;        /**< number of samples in window, up to windowSize. */
+        q63_t sum;             /**< sum of window. */
+        q63_t sumOfSquares;    /**< sum of squares of window. */
+} riscv_sliding_stats_instance_q15;
+
+/**
+ * @ingroup OnlineStats
+ * @brief Monotonic deque of sliding minimum or maximum.
+ */
+typedef struct
+{
+        uint32_t head;         /**< position of oldest candidate. */
+        uint32_t len;          /**< number of candidates. */
+} riscv_sliding_deque;
+
+/**
+ * @ingroup OnlineStats
+ * @brief Instance structure for the floating-point sliding window minimum and maximum.
+ */
+typedef struct
+{
+        uint32_t windowSize;   /**< number of samples in window. */
+        uint32_t count;        /**< number of samples added. */
+        float32_t *pVal;       /**< candidates, windowSize of minimum then windowSize of maximum. */
+        uint32_t *pIdx;        /**< sample numbers of candidates, laid out as pVal. */
+        riscv_sliding_deque dmin;  /**< deque of minimum. */
+        riscv_sliding_deque dmax;  /**< deque of maximum. */
+} riscv_sliding_minmax_instance_f32;
+
+/**
+ * @ingroup OnlineStats
+ * @brief Instance structure for the Q31 sliding window minimum and maximum.
+ */
+typedef struct
+{
+        uint32_t windowSize;   /**< number of samples in window. */
+        uint32_t count;        /**< number of samples added. */
+        q31_t *pVal;           /**< candidates, windowSize of minimum then windowSize of maximum. */
+        uint32_t *pIdx;        /**< sample numbers of candidates, laid out as pVal. */
+        riscv_sliding_deque dmin;  /**< deque of minimum. */
+        riscv_sliding_deque dmax;  /**< deque of maximum. */
+} riscv_sliding_minmax_instance_q31;
+
+/**
+ * @ingroup OnlineStats
+ * @brief Instance structure for the Q15 sliding window minimum and maximum.
+ */
+typedef struct
+{
+        uint32_t windowSize;   /**< number of samples in window. */
+        uint32_t count;        /**< number of samples added. */
+        q15_t *pVal;           /**< candidates, windowSize of minimum then windowSize of maximum. */
+        uint32_t *pIdx;        /**< sample numbers of candidates, laid out as pVal. */
+        riscv_sliding_deque dmin;  /**< deque of minimum. */
+        riscv_sliding_deque dmax;  /**< deque of maximum. */
+} riscv_sliding_minmax_instance_q15;
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Initialization function for the floating-point running statistics.
+ * @param[out] S  points to an instance of the running statistics structure.
+ */
+__STATIC_INLINE void riscv_running_stats_init_f32(
+  riscv_running_stats_instance_f32 * S)
+{
+  S->count = 0U;
+  S->mean = 0.0f;
+  S->m2 = 0.0f;
+  S->min = F32_MAX;
+  S->max = F32_MIN;
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Add a sample to the floating-point running statistics.
+ * @param[in,out] S   points to an instance of the running statistics structure.
+ * @param[in]     in  sample to add.
+ */
+__STATIC_FORCEINLINE void riscv_running_stats_add_f32(
+  riscv_running_stats_instance_f32 * S,
+  float32_t in)
+{
+  float32_t delta = in - S->mean;
+
+  S->count++;
+  S->mean += delta / (float32_t)S->count;
+  S->m2 += delta * (in - S->mean);
+  S->min = (in < S->min) ? in : S->min;
+  S->max = (in > S->max) ? in : S->max;
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Variance of the floating-point running statistics.
+ * @param[in] S  points to an instance of the running statistics structure.
+ * @return variance of samples added.
+ */
+__STATIC_FORCEINLINE float32_t riscv_running_stats_var_f32(
+  const riscv_running_stats_instance_f32 * S)
+{
+  return (S->count < 2U) ? 0.0f : (S->m2 / (float32_t)(S->count - 1U));
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Standard deviation of the floating-point running statistics.
+ * @param[in] S  points to an instance of the running statistics structure.
+ * @return standard deviation of samples added.
+ */
+__STATIC_FORCEINLINE float32_t riscv_running_stats_std_f32(
+  const riscv_running_stats_instance_f32 * S)
+{
+  float32_t out;
+
+  riscv_sqrt_f32(riscv_running_stats_var_f32(S), &out);
+  return out;
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Mean of 64 bits sum of count fixed point samples.
+ */
+__STATIC_FORCEINLINE q63_t riscv_online_stats_mean(
+  q63_t sum,
+  uint32_t count)
+{
+  return (count == 0U) ? 0 : (sum / (q63_t)count);
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Variance of count samples of sum and sum of squares, before the shift of result.
+ * @details The square of mean is computed as mean * sum, so the sum is never squared,
+ * mean * sum is not larger than sumOfSquares, so it fits q63 whenever sumOfSquares does.
+ */
+__STATIC_FORCEINLINE q63_t riscv_online_stats_var(
+  q63_t sum,
+  q63_t sumOfSquares,
+  uint32_t count)
+{
+  q63_t meanOfSquares, squareOfMean;
+
+  if (count < 2U)
+  {
+    return 0;
+  }
+  meanOfSquares = sumOfSquares / (q63_t)(count - 1U);
+  squareOfMean = (sum / (q63_t)count) * sum / (q63_t)(count - 1U);
+  return meanOfSquares - squareOfMean;
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Initialization function for the Q31 running statistics.
+ * @param[out] S  points to an instance of the running statistics structure.
+ */
+__STATIC_INLINE void riscv_running_stats_init_q31(
+  riscv_running_stats_instance_q31 * S)
+{
+  S->count = 0U;
+  S->sum = 0;
+  S->sumOfSquares = 0;
+  S->min = Q31_MAX;
+  S->max = Q31_MIN;
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Add a sample to the Q31 running statistics.
+ * @param[in,out] S   points to an instance of the running statistics structure.
+ * @param[in]     in  sample to add.
+ * @details When count reaches \ref RISCV_RUNNING_STATS_Q31_MAX_COUNT, count and sums are
+ * halved before in is added, which keeps mean and variance but halves the weight of the
+ * samples added so far.
+ */
+__STATIC_FORCEINLINE void riscv_running_stats_add_q31(
+  riscv_running_stats_instance_q31 * S,
+  q31_t in)
+{
+  if (S->count >= RISCV_RUNNING_STATS_Q31_MAX_COUNT)
+  {
+    S->count >>= 1;
+    S->sum >>= 1;
+    S->sumOfSquares >>= 1;
+  }
+  S->count++;
+  S->sum += in;
+  S->sumOfSquares += (q63_t)(in >> 8) * (in >> 8);
+  S->min = (in < S->min) ? in : S->min;
+  S->max = (in > S->max) ? in : S->max;
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Mean of the Q31 running statistics.
+ * @param[in] S  points to an instance of the running statistics structure.
+ * @return mean of samples added, in 1.31 format.
+ */
+__STATIC_FORCEINLINE q31_t riscv_running_stats_mean_q31(
+  const riscv_running_stats_instance_q31 * S)
+{
+  return (q31_t)riscv_online_stats_mean(S->sum, S->count);
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Variance of the Q31 running statistics.
+ * @param[in] S  points to an instance of the running statistics structure.
+ * @return variance of samples added, in 1.31 format.
+ */
+__STATIC_FORCEINLINE q31_t riscv_running_stats_var_q31(
+  const riscv_running_stats_instance_q31 * S)
+{
+  return (q31_t)(riscv_online_stats_var(S->sum >> 8, S->sumOfSquares, S->count) >> 15);
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Initialization function for the Q15 running statistics.
+ * @param[out] S  points to an instance of the running statistics structure.
+ */
+__STATIC_INLINE void riscv_running_stats_init_q15(
+  riscv_running_stats_instance_q15 * S)
+{
+  S->count = 0U;
+  S->sum = 0;
+  S->sumOfSquares = 0;
+  S->min = Q15_MAX;
+  S->max = Q15_MIN;
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Add a sample to the Q15 running statistics.
+ * @param[in,out] S   points to an instance of the running statistics structure.
+ * @param[in]     in  sample to add.
+ */
+__STATIC_FORCEINLINE void riscv_running_stats_add_q15(
+  riscv_running_stats_instance_q15 * S,
+  q15_t in)
+{
+  S->count++;
+  S->sum += in;
+  S->sumOfSquares += (q31_t)in * in;
+  S->min = (in < S->min) ? in : S->min;
+  S->max = (in > S->max) ? in : S->max;
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Mean of the Q15 running statistics.
+ * @param[in] S  points to an instance of the running statistics structure.
+ * @return mean of samples added, in 1.15 format.
+ */
+__STATIC_FORCEINLINE q15_t riscv_running_stats_mean_q15(
+  const riscv_running_stats_instance_q15 * S)
+{
+  return (q15_t)riscv_online_stats_mean(S->sum, S->count);
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Variance of the Q15 running statistics.
+ * @param[in] S  points to an instance of the running statistics structure.
+ * @return variance of samples added, in 1.15 format.
+ */
+__STATIC_FORCEINLINE q15_t riscv_running_stats_var_q15(
+  const riscv_running_stats_instance_q15 * S)
+{
+  return (q15_t)(riscv_online_stats_var(S->sum, S->sumOfSquares, S->count) >> 15);
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Initialization function for the floating-point sliding window statistics.
+ * @param[out] S           points to an instance of the sliding window statistics structure.
+ * @param[in]  windowSize  number of samples in window, at least 1.
+ */
+__STATIC_INLINE void riscv_sliding_stats_init_f32(
+  riscv_sliding_stats_instance_f32 * S,
+  uint32_t windowSize)
+{
+  S->windowSize = windowSize;
+  S->count = 0U;
+  S->mean = 0.0f;
+  S->m2 = 0.0f;
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Slide the floating-point window by one sample.
+ * @param[in,out] S    points to an instance of the sliding window statistics structure.
+ * @param[in]     in   sample entering the window.
+ * @param[in]     out  sample leaving the window, ignored until the window is full.
+ */
+__STATIC_FORCEINLINE void riscv_sliding_stats_update_f32(
+  riscv_sliding_stats_instance_f32 * S,
+  float32_t in,
+  float32_t out)
+{
+  float32_t mean = S->mean;
+
+  if (S->count < S->windowSize)
+  {
+    S->count++;
+    S->mean += (in - mean) / (float32_t)S->count;
+    S->m2 += (in - mean) * (in - S->mean);
+  }
+  else
+  {
+    S->mean += (in - out) / (float32_t)S->count;
+    S->m2 += (in - out) * (in - S->mean + out - mean);
+    S->m2 = (S->m2 < 0.0f) ? 0.0f : S->m2;
+  }
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Variance of the floating-point sliding window.
+ * @param[in] S  points to an instance of the sliding window statistics structure.
+ * @return variance of samples in window.
+ */
+__STATIC_FORCEINLINE float32_t riscv_sliding_stats_var_f32(
+  const riscv_sliding_stats_instance_f32 * S)
+{
+  return (S->count < 2U) ? 0.0f : (S->m2 / (float32_t)(S->count - 1U));
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Standard deviation of the floating-point sliding window.
+ * @param[in] S  points to an instance of the sliding window statistics structure.
+ * @return standard deviation of samples in window.
+ */
+__STATIC_FORCEINLINE float32_t riscv_sliding_stats_std_f32(
+  const riscv_sliding_stats_instance_f32 * S)
+{
+  float32_t out;
+
+  riscv_sqrt_f32(riscv_sliding_stats_var_f32(S), &out);
+  return out;
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Initialization function for the Q31 sliding window statistics.
+ * @param[out] S           points to an instance of the sliding window statistics structure.
+ * @param[in]  windowSize  number of samples in window, 1 ~ 65536.
+ */
+__STATIC_INLINE void riscv_sliding_stats_init_q31(
+  riscv_sliding_stats_instance_q31 * S,
+  uint32_t windowSize)
+{
+  S->windowSize = windowSize;
+  S->count = 0U;
+  S->sum = 0;
+  S->sumOfSquares = 0;
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Slide the Q31 window by one sample.
+ * @param[in,out] S    points to an instance of the sliding window statistics structure.
+ * @param[in]     in   sample entering the window.
+ * @param[in]     out  sample leaving the window, ignored until the window is full.
+ */
+__STATIC_FORCEINLINE void riscv_sliding_stats_update_q31(
+  riscv_sliding_stats_instance_q31 * S,
+  q31_t in,
+  q31_t out)
+{
+  if (S->count < S->windowSize)
+  {
+    S->count++;
+  }
+  else
+  {
+    S->sum -= out;
+    S->sumOfSquares -= (q63_t)(out >> 8) * (out >> 8);
+  }
+  S->sum += in;
+  S->sumOfSquares += (q63_t)(in >> 8) * (in >> 8);
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Mean of the Q31 sliding window.
+ * @param[in] S  points to an instance of the sliding window statistics structure.
+ * @return mean of samples in window, in 1.31 format.
+ */
+__STATIC_FORCEINLINE q31_t riscv_sliding_stats_mean_q31(
+  const riscv_sliding_stats_instance_q31 * S)
+{
+  return (q31_t)riscv_online_stats_mean(S->sum, S->count);
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Variance of the Q31 sliding window.
+ * @param[in] S  points to an instance of the sliding window statistics structure.
+ * @return variance of samples in window, in 1.31 format.
+ */
+__STATIC_FORCEINLINE q31_t riscv_sliding_stats_var_q31(
+  const riscv_sliding_stats_instance_q31 * S)
+{
+  return (q31_t)(riscv_online_stats_var(S->sum >> 8, S->sumOfSquares, S->count) >> 15);
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Initialization function for the Q15 sliding window statistics.
+ * @param[out] S           points to an instance of the sliding window statistics structure.
+ * @param[in]  windowSize  number of samples in window, at least 1.
+ */
+__STATIC_INLINE void riscv_sliding_stats_init_q15(
+  riscv_sliding_stats_instance_q15 * S,
+  uint32_t windowSize)
+{
+  S->windowSize = windowSize;
+  S->count = 0U;
+  S->sum = 0;
+  S->sumOfSquares = 0;
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Slide the Q15 window by one sample.
+ * @param[in,out] S    points to an instance of the sliding window statistics structure.
+ * @param[in]     in   sample entering the window.
+ * @param[in]     out  sample leaving the window, ignored until the window is full.
+ */
+__STATIC_FORCEINLINE void riscv_sliding_stats_update_q15(
+  riscv_sliding_stats_instance_q15 * S,
+  q15_t in,
+  q15_t out)
+{
+  if (S->count < S->windowSize)
+  {
+    S->count++;
+  }
+  else
+  {
+    S->sum -= out;
+    S->sumOfSquares -= (q31_t)out * out;
+  }
+  S->sum += in;
+  S->sumOfSquares += (q31_t)in * in;
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Mean of the Q15 sliding window.
+ * @param[in] S  points to an instance of the sliding window statistics structure.
+ * @return mean of samples in window, in 1.15 format.
+ */
+__STATIC_FORCEINLINE q15_t riscv_sliding_stats_mean_q15(
+  const riscv_sliding_stats_instance_q15 * S)
+{
+  return (q15_t)riscv_online_stats_mean(S->sum, S->count);
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Variance of the Q15 sliding window.
+ * @param[in] S  points to an instance of the sliding window statistics structure.
+ * @return variance of samples in window, in 1.15 format.
+ */
+__STATIC_FORCEINLINE q15_t riscv_sliding_stats_var_q15(
+  const riscv_sliding_stats_instance_q15 * S)
+{
+  return (q15_t)(riscv_online_stats_var(S->sum, S->sumOfSquares, S->count) >> 15);
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Drop the oldest candidate of deque d if it left the window, before sample idx is pushed.
+ * @return position of the back of deque for the compare with sample idx, valid if d->len != 0.
+ */
+__STATIC_FORCEINLINE uint32_t riscv_sliding_deque_expire(
+  riscv_sliding_deque * d,
+  const uint32_t * pIdx,
+  uint32_t windowSize,
+  uint32_t idx)
+{
+  if ((d->len != 0U) && ((idx - pIdx[d->head]) >= windowSize))
+  {
+    d->head = (d->head + 1U == windowSize) ? 0U : (d->head + 1U);
+    d->len--;
+  }
+  return (d->head + d->len - 1U) % windowSize;
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Position to push a candidate at the back of deque d.
+ */
+__STATIC_FORCEINLINE uint32_t riscv_sliding_deque_push(
+  riscv_sliding_deque * d,
+  uint32_t windowSize)
+{
+  return (d->head + d->len++) % windowSize;
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Initialization function for the floating-point sliding window minimum and maximum.
+ * @param[out] S           points to an instance of the sliding window minimum and maximum structure.
+ * @param[in]  windowSize  number of samples in window, at least 1.
+ * @param[in]  pVal        points to 2 * windowSize values of candidates.
+ * @param[in]  pIdx        points to 2 * windowSize sample numbers of candidates.
+ */
+__STATIC_INLINE void riscv_sliding_minmax_init_f32(
+  riscv_sliding_minmax_instance_f32 * S,
+  uint32_t windowSize,
+  float32_t * pVal,
+  uint32_t * pIdx)
+{
+  S->windowSize = windowSize;
+  S->count = 0U;
+  S->pVal = pVal;
+  S->pIdx = pIdx;
+  S->dmin.head = 0U;
+  S->dmin.len = 0U;
+  S->dmax.head = 0U;
+  S->dmax.len = 0U;
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Add a sample to the floating-point sliding window minimum and maximum.
+ * @param[in,out] S   points to an instance of the sliding window minimum and maximum structure.
+ * @param[in]     in  sample entering the window, the oldest one leaves it once the window is full.
+ */
+__STATIC_INLINE void riscv_sliding_minmax_add_f32(
+  riscv_sliding_minmax_instance_f32 * S,
+  float32_t in)
+{
+  uint32_t size = S->windowSize;
+  float32_t *pMax = S->pVal + size;
+  uint32_t *pMaxIdx = S->pIdx + size;
+  uint32_t idx = S->count++;
+  uint32_t back;
+
+  /* candidates not smaller or larger than in can never be the result again */
+  back = riscv_sliding_deque_expire(&S->dmin, S->pIdx, size, idx);
+  while ((S->dmin.len != 0U) && (S->pVal[back] >= in))
+  {
+    S->dmin.len--;
+    back = (back == 0U) ? (size - 1U) : (back - 1U);
+  }
+  back = riscv_sliding_deque_push(&S->dmin, size);
+  S->pVal[back] = in;
+  S->pIdx[back] = idx;
+
+  back = riscv_sliding_deque_expire(&S->dmax, pMaxIdx, size, idx);
+  while ((S->dmax.len != 0U) && (pMax[back] <= in))
+  {
+    S->dmax.len--;
+    back = (back == 0U) ? (size - 1U) : (back - 1U);
+  }
+  back = riscv_sliding_deque_push(&S->dmax, size);
+  pMax[back] = in;
+  pMaxIdx[back] = idx;
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Minimum of the floating-point sliding window, after at least one sample is added.
+ */
+__STATIC_FORCEINLINE float32_t riscv_sliding_min_f32(
+  const riscv_sliding_minmax_instance_f32 * S)
+{
+  return S->pVal[S->dmin.head];
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Maximum of the floating-point sliding window, after at least one sample is added.
+ */
+__STATIC_FORCEINLINE float32_t riscv_sliding_max_f32(
+  const riscv_sliding_minmax_instance_f32 * S)
+{
+  return S->pVal[S->windowSize + S->dmax.head];
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Initialization function for the Q31 sliding window minimum and maximum.
+ * @param[out] S           points to an instance of the sliding window minimum and maximum structure.
+ * @param[in]  windowSize  number of samples in window, at least 1.
+ * @param[in]  pVal        points to 2 * windowSize values of candidates.
+ * @param[in]  pIdx        points to 2 * windowSize sample numbers of candidates.
+ */
+__STATIC_INLINE void riscv_sliding_minmax_init_q31(
+  riscv_sliding_minmax_instance_q31 * S,
+  uint32_t windowSize,
+  q31_t * pVal,
+  uint32_t * pIdx)
+{
+  S->windowSize = windowSize;
+  S->count = 0U;
+  S->pVal = pVal;
+  S->pIdx = pIdx;
+  S->dmin.head = 0U;
+  S->dmin.len = 0U;
+  S->dmax.head = 0U;
+  S->dmax.len = 0U;
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Add a sample to the Q31 sliding window minimum and maximum.
+ * @param[in,out] S   points to an instance of the sliding window minimum and maximum structure.
+ * @param[in]     in  sample entering the window, the oldest one leaves it once the window is full.
+ */
+__STATIC_INLINE void riscv_sliding_minmax_add_q31(
+  riscv_sliding_minmax_instance_q31 * S,
+  q31_t in)
+{
+  uint32_t size = S->windowSize;
+  q31_t *pMax = S->pVal + size;
+  uint32_t *pMaxIdx = S->pIdx + size;
+  uint32_t idx = S->count++;
+  uint32_t back;
+
+  back = riscv_sliding_deque_expire(&S->dmin, S->pIdx, size, idx);
+  while ((S->dmin.len != 0U) && (S->pVal[back] >= in))
+  {
+    S->dmin.len--;
+    back = (back == 0U) ? (size - 1U) : (back - 1U);
+  }
+  back = riscv_sliding_deque_push(&S->dmin, size);
+  S->pVal[back] = in;
+  S->pIdx[back] = idx;
+
+  back = riscv_sliding_deque_expire(&S->dmax, pMaxIdx, size, idx);
+  while ((S->dmax.len != 0U) && (pMax[back] <= in))
+  {
+    S->dmax.len--;
+    back = (back == 0U) ? (size - 1U) : (back - 1U);
+  }
+  back = riscv_sliding_deque_push(&S->dmax, size);
+  pMax[back] = in;
+  pMaxIdx[back] = idx;
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Minimum of the Q31 sliding window, after at least one sample is added.
+ */
+__STATIC_FORCEINLINE q31_t riscv_sliding_min_q31(
+  const riscv_sliding_minmax_instance_q31 * S)
+{
+  return S->pVal[S->dmin.head];
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Maximum of the Q31 sliding window, after at least one sample is added.
+ */
+__STATIC_FORCEINLINE q31_t riscv_sliding_max_q31(
+  const riscv_sliding_minmax_instance_q31 * S)
+{
+  return S->pVal[S->windowSize + S->dmax.head];
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Initialization function for the Q15 sliding window minimum and maximum.
+ * @param[out] S           points to an instance of the sliding window minimum and maximum structure.
+ * @param[in]  windowSize  number of samples in window, at least 1.
+ * @param[in]  pVal        points to 2 * windowSize values of candidates.
+ * @param[in]  pIdx        points to 2 * windowSize sample numbers of candidates.
+ */
+__STATIC_INLINE void riscv_sliding_minmax_init_q15(
+  riscv_sliding_minmax_instance_q15 * S,
+  uint32_t windowSize,
+  q15_t * pVal,
+  uint32_t * pIdx)
+{
+  S->windowSize = windowSize;
+  S->count = 0U;
+  S->pVal = pVal;
+  S->pIdx = pIdx;
+  S->dmin.head = 0U;
+  S->dmin.len = 0U;
+  S->dmax.head = 0U;
+  S->dmax.len = 0U;
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Add a sample to the Q15 sliding window minimum and maximum.
+ * @param[in,out] S   points to an instance of the sliding window minimum and maximum structure.
+ * @param[in]     in  sample entering the window, the oldest one leaves it once the window is full.
+ */
+__STATIC_INLINE void riscv_sliding_minmax_add_q15(
+  riscv_sliding_minmax_instance_q15 * S,
+  q15_t in)
+{
+  uint32_t size = S->windowSize;
+  q15_t *pMax = S->pVal + size;
+  uint32_t *pMaxIdx = S->pIdx + size;
+  uint32_t idx = S->count++;
+  uint32_t back;
+
+  back = riscv_sliding_deque_expire(&S->dmin, S->pIdx, size, idx);
+  while ((S->dmin.len != 0U) && (S->pVal[back] >= in))
+  {
+    S->dmin.len--;
+    back = (back == 0U) ? (size - 1U) : (back - 1U);
+  }
+  back = riscv_sliding_deque_push(&S->dmin, size);
+  S->pVal[back] = in;
+  S->pIdx[back] = idx;
+
+  back = riscv_sliding_deque_expire(&S->dmax, pMaxIdx, size, idx);
+  while ((S->dmax.len != 0U) && (pMax[back] <= in))
+  {
+    S->dmax.len--;
+    back = (back == 0U) ? (size - 1U) : (back - 1U);
+  }
+  back = riscv_sliding_deque_push(&S->dmax, size);
+  pMax[back] = in;
+  pMaxIdx[back] = idx;
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Minimum of the Q15 sliding window, after at least one sample is added.
+ */
+__STATIC_FORCEINLINE q15_t riscv_sliding_min_q15(
+  const riscv_sliding_minmax_instance_q15 * S)
+{
+  return S->pVal[S->dmin.head];
+}
+
+/**
+ * @ingroup OnlineStats
+ * @brief  Maximum of the Q15 sliding window, after at least one sample is added.
+ */
+__STATIC_FORCEINLINE q15_t riscv_sliding_max_q15(
+  const riscv_sliding_minmax_instance_q15 * S)
+{
+  return S->pVal[S->windowSize + S->dmax.head];
+}
+
 #ifdef   __cplusplus
 }
 #endif
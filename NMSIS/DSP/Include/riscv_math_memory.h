@@ -497,6 +497,238 @@ __STATIC_FORCEINLINE void write_q7x8_ia (
 }
 
 
+
+/* Scratch arena */
+
+/*
+ * Buffers of the DSP kernels are taken from memory that the caller gives once per region, as
+ * DLM for the hot buffers and SRAM for the large ones, with the alignment the kernel needs:
+ * RISCV_DSP_ALIGN_WORD for the 64-bit loads of read_q15x4() and the like,
+ * RISCV_DSP_ALIGN_VECTOR for whole vector registers, RISCV_DSP_ALIGN_CACHE so a buffer does not
+ * share a cache line. Allocation only moves an offset, riscv_dsp_arena_mark() and
+ * riscv_dsp_arena_release() free all buffers allocated after the mark, so scratch of a kernel
+ * call is released in one step. A kernel given a buffer of the arena can state its alignment by
+ * RISCV_DSP_ASSUME_ALIGNED() instead of checking it at run time.
+ */
+
+/**
+  @brief alignment of 64-bit loads and stores
+ */
+#define RISCV_DSP_ALIGN_WORD        8U
+
+/**
+  @brief alignment of a vector register
+ */
+#ifndef RISCV_DSP_ALIGN_VECTOR
+#if defined(__riscv_v_min_vlen)
+#define RISCV_DSP_ALIGN_VECTOR      (__riscv_v_min_vlen / 8U)
+#else
+#define RISCV_DSP_ALIGN_VECTOR      16U
+#endif
+#endif
+
+/**
+  @brief alignment of a data cache line
+ */
+#ifndef RISCV_DSP_ALIGN_CACHE
+#if defined(__DCACHE_LINESIZE)
+#define RISCV_DSP_ALIGN_CACHE       __DCACHE_LINESIZE
+#else
+#define RISCV_DSP_ALIGN_CACHE       64U
+#endif
+#endif
+
+/**
+  @brief true when p is a multiple of align, align is a power of 2
+ */
+#define RISCV_DSP_IS_ALIGNED(p, align)      ((((uintptr_t)(p)) & ((uintptr_t)(align) - 1U)) == 0U)
+
+/**
+  @brief p with the compiler told it is a multiple of align, align is a constant power of 2
+ */
+#if defined ( __GNUC__ )
+  #define RISCV_DSP_ASSUME_ALIGNED(p, align)  __builtin_assume_aligned((p), (align))
+#else
+  #define RISCV_DSP_ASSUME_ALIGNED(p, align)  ((void *)(p))
+#endif
+
+/**
+  @brief memory regions of the arena
+ */
+typedef enum
+{
+  RISCV_DSP_REGION_DLM = 0,         /**< data local memory, one cycle access */
+  RISCV_DSP_REGION_SRAM,            /**< system memory, behind the cache if there is one */
+  RISCV_DSP_REGION_NUM
+} riscv_dsp_region;
+
+/**
+  @brief buffer of the arena
+ */
+typedef struct
+{
+  void *pData;                      /**< start of the buffer */
+  uint32_t size;                    /**< size in bytes */
+  uint16_t align;                   /**< alignment of pData */
+  uint16_t region;                  /**< riscv_dsp_region that holds the buffer */
+} riscv_dsp_buffer;
+
+/**
+  @brief arena of the memory of each region
+ */
+typedef struct
+{
+  uintptr_t base[RISCV_DSP_REGION_NUM];   /**< start of the memory of each region */
+  uint32_t size[RISCV_DSP_REGION_NUM];    /**< size of the memory of each region */
+  uint32_t used[RISCV_DSP_REGION_NUM];    /**< bytes allocated in each region */
+  uint32_t peak[RISCV_DSP_REGION_NUM];    /**< most bytes allocated in each region */
+} riscv_dsp_arena;
+
+/**
+  @brief position of the arena for riscv_dsp_arena_release()
+ */
+typedef struct
+{
+  uint32_t used[RISCV_DSP_REGION_NUM];
+} riscv_dsp_arena_mark_t;
+
+/**
+  @brief         Initialize an arena without memory.
+  @param[out]    A         points to the arena
+  @return        none
+ */
+__STATIC_INLINE void riscv_dsp_arena_init (
+  riscv_dsp_arena * A)
+{
+  memset(A, 0, sizeof(*A));
+}
+
+/**
+  @brief         Give the memory of a region to an arena, replacing the one it had before.
+  @param[in,out] A         points to the arena
+  @param[in]     region    region of the memory
+  @param[in]     pMem      start of the memory
+  @param[in]     size      size of the memory in bytes
+  @return        RISCV_MATH_ARGUMENT_ERROR for an unknown region, else RISCV_MATH_SUCCESS
+ */
+__STATIC_INLINE riscv_status riscv_dsp_arena_add (
+  riscv_dsp_arena * A,
+  riscv_dsp_region region,
+  void * pMem,
+  uint32_t size)
+{
+  if ((uint32_t)region >= (uint32_t)RISCV_DSP_REGION_NUM)
+  {
+    return RISCV_MATH_ARGUMENT_ERROR;
+  }
+  A->base[region] = (uintptr_t)pMem;
+  A->size[region] = (pMem == NULL) ? 0U : size;
+  A->used[region] = 0U;
+  A->peak[region] = 0U;
+  return RISCV_MATH_SUCCESS;
+}
+
+/**
+  @brief         Allocate an aligned buffer, in the region of the hint when it has room, else in
+                 the first region with room.
+  @param[in,out] A         points to the arena
+  @param[out]    pBuf      the buffer, pBuf->pData is NULL when no region has room
+  @param[in]     size      size in bytes
+  @param[in]     align     alignment, a power of 2, 0 gives RISCV_DSP_ALIGN_WORD
+  @param[in]     hint      preferred region
+  @return        RISCV_MATH_ARGUMENT_ERROR for an alignment that is not a power of 2,
+                 RISCV_MATH_LENGTH_ERROR when no region has room, else RISCV_MATH_SUCCESS
+ */
+__STATIC_INLINE riscv_status riscv_dsp_arena_alloc_buffer (
+  riscv_dsp_arena * A,
+  riscv_dsp_buffer * pBuf,
+  uint32_t size,
+  uint32_t align,
+  riscv_dsp_region hint)
+{
+  uint32_t k, r, offset;
+  uintptr_t start;
+
+  align = (align == 0U) ? RISCV_DSP_ALIGN_WORD : align;
+  pBuf->pData = NULL;
+  pBuf->size = size;
+  pBuf->align = (uint16_t)align;
+  if (((align & (align - 1U)) != 0U) || (align > 0x8000U))
+  {
+    return RISCV_MATH_ARGUMENT_ERROR;
+  }
+  for (k = 0U; k <= (uint32_t)RISCV_DSP_REGION_NUM; k++)
+  {
+    /* the hint first, then the regions in order */
+    r = (k == 0U) ? (uint32_t)hint : (k - 1U);
+    if ((r >= (uint32_t)RISCV_DSP_REGION_NUM) || ((k != 0U) && (r == (uint32_t)hint)))
+    {
+      continue;
+    }
+    start = (A->base[r] + A->used[r] + align - 1U) & ~((uintptr_t)align - 1U);
+    offset = (uint32_t)(start - A->base[r]);
+    if ((offset < A->used[r]) || (offset > A->size[r]) || (size > A->size[r] - offset))
+    {
+      continue;
+    }
+    A->used[r] = offset + size;
+    A->peak[r] = (A->used[r] > A->peak[r]) ? A->used[r] : A->peak[r];
+    pBuf->pData = (void *)start;
+    pBuf->region = (uint16_t)r;
+    return RISCV_MATH_SUCCESS;
+  }
+  return RISCV_MATH_LENGTH_ERROR;
+}
+
+/**
+  @brief         Allocate an aligned buffer, as riscv_dsp_arena_alloc_buffer().
+  @param[in,out] A         points to the arena
+  @param[in]     size      size in bytes
+  @param[in]     align     alignment, a power of 2, 0 gives RISCV_DSP_ALIGN_WORD
+  @param[in]     hint      preferred region
+  @return        start of the buffer, NULL when no region has room
+ */
+__STATIC_INLINE void * riscv_dsp_arena_alloc (
+  riscv_dsp_arena * A,
+  uint32_t size,
+  uint32_t align,
+  riscv_dsp_region hint)
+{
+  riscv_dsp_buffer buf;
+
+  (void)riscv_dsp_arena_alloc_buffer(A, &buf, size, align, hint);
+  return buf.pData;
+}
+
+/**
+  @brief         Position of an arena, the buffers allocated after it are freed by
+                 riscv_dsp_arena_release().
+  @param[in]     A         points to the arena
+  @return        the position
+ */
+__STATIC_INLINE riscv_dsp_arena_mark_t riscv_dsp_arena_mark (
+  const riscv_dsp_arena * A)
+{
+  riscv_dsp_arena_mark_t m;
+
+  memcpy(m.used, A->used, sizeof(m.used));
+  return m;
+}
+
+/**
+  @brief         Free the buffers allocated after a position of riscv_dsp_arena_mark().
+  @param[in,out] A         points to the arena
+  @param[in]     m         the position
+  @return        none
+ */
+__STATIC_INLINE void riscv_dsp_arena_release (
+  riscv_dsp_arena * A,
+  riscv_dsp_arena_mark_t m)
+{
+  memcpy(A->used, m.used, sizeof(A->used));
+}
+
+
 #ifdef   __cplusplus
 }
 #endif
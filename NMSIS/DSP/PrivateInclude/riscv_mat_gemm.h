@@ -0,0 +1,740 @@
+/******************************************************************************
+ * @file     riscv_mat_gemm.h
+ * @brief    Private header file for NMSIS DSP Library
+ * @version  V1.7.0
+ * @date     07. January 2020
+ ******************************************************************************/
+/*
+ * Copyright (c) 2010-2020 Arm Limited or its affiliates. All rights reserved.
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _RISCV_MAT_GEMM_H_
+#define _RISCV_MAT_GEMM_H_
+
+#include "riscv_math.h"
+
+#ifdef   __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Cache blocked matrix multiplication
+ *
+ * C = A * B (or A * B^T) is computed as in GotoBLAS: B is split into blocks of kc x nc and
+ * A into blocks of mc x kc, each block is packed once into a work buffer, B into panels of
+ * nr columns and A into slivers of RISCV_MAT_GEMM_MR rows, so a microkernel reads both
+ * with unit stride, and keeps a RISCV_MAT_GEMM_MR x nr tile of C in registers for kc steps.
+ * kc is chosen so that a sliver and a panel stay in half of the L1 data cache, mc and nc so
+ * that a packed block stays in half of the L2 cache. A transposed B is read transposed by
+ * its packing, so A * B^T costs no extra pass.
+ *
+ * With vector extension, a panel is as wide as a vector of LMUL=2 for 32-bit elements, q15
+ * and q7 are packed as 16-bit elements and widened in the microkernel. Fixed point sums are
+ * kept in a work accumulator of 64 bits (32 bits for q7) over all of K and are shifted and
+ * saturated once at the end, as riscv_mat_mult_q31/q15/q7. Floating point sums run over
+ * blocks of kc, so they may differ from riscv_mat_mult_f32() by rounding.
+ */
+
+/* rows of a microkernel tile */
+#define RISCV_MAT_GEMM_MR           4U
+
+/* L1 data cache bytes when it cannot be probed */
+#ifndef RISCV_MAT_GEMM_L1_SIZE
+#define RISCV_MAT_GEMM_L1_SIZE      (32U * 1024U)
+#endif
+
+/* L2 cache bytes, there is no register to probe it */
+#ifndef RISCV_MAT_GEMM_L2_SIZE
+#define RISCV_MAT_GEMM_L2_SIZE      (256U * 1024U)
+#endif
+
+#if defined(RISCV_MATH_VECTOR) && defined(__riscv_v_elen) && (__riscv_v_elen >= 64)
+#define RISCV_MAT_GEMM_VECTOR64     1
+#endif
+
+/* blocking of one element type */
+typedef struct
+{
+    uint32_t mc;                    /**< rows of a packed block of A, multiple of RISCV_MAT_GEMM_MR */
+    uint32_t kc;                    /**< depth of packed blocks */
+    uint32_t nc;                    /**< columns of a packed block of B, multiple of nr */
+    uint32_t nr;                    /**< columns of a microkernel tile */
+    uint32_t elemSize;              /**< bytes of a packed element */
+    uint32_t accSize;               /**< bytes of an accumulator, 0 when C accumulates itself */
+} riscv_mat_gemm_blocking;
+
+/* return bytes of L1 data cache, probed when the CCM unit can tell it */
+__STATIC_INLINE uint32_t riscv_mat_gemm_l1_size(void)
+{
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1) && defined(__CCM_PRESENT) && (__CCM_PRESENT == 1)
+    CacheInfo_Type info;
+
+    if ((GetDCacheInfo(&info) == 0) && (info.size != 0)) {
+        return info.size;
+    }
+#endif
+    return RISCV_MAT_GEMM_L1_SIZE;
+}
+
+/* fill blocking of elements of elemSize bytes, tiles of nr columns and accumulators of accSize bytes */
+__STATIC_INLINE void riscv_mat_gemm_blocking_init(riscv_mat_gemm_blocking *blk, uint32_t elemSize,
+                                                  uint32_t accSize, uint32_t nr)
+{
+    uint32_t kc, mc, nc;
+
+    kc = (riscv_mat_gemm_l1_size() / 2) / ((RISCV_MAT_GEMM_MR + nr) * elemSize);
+    kc = (kc < 16) ? 16 : (kc > 1024) ? 1024 : (kc & ~3U);
+    mc = (RISCV_MAT_GEMM_L2_SIZE / 2) / (kc * elemSize);
+    mc = (mc < RISCV_MAT_GEMM_MR) ? RISCV_MAT_GEMM_MR : (mc > 256) ? 256 : (mc - mc % RISCV_MAT_GEMM_MR);
+    nc = (RISCV_MAT_GEMM_L2_SIZE / 2) / (kc * elemSize);
+    nc = (nc < nr) ? nr : (nc > 4096) ? 4096 : (nc - nc % nr);
+    blk->mc = mc;
+    blk->kc = kc;
+    blk->nc = nc;
+    blk->nr = nr;
+    blk->elemSize = elemSize;
+    blk->accSize = accSize;
+}
+
+/* return bytes of work buffer needed with blk, it must be 8 bytes aligned */
+__STATIC_INLINE uint32_t riscv_mat_gemm_work_size(const riscv_mat_gemm_blocking *blk)
+{
+    uint32_t acc = (blk->mc * blk->nc * blk->accSize + 7) & ~7U;
+
+    return acc + ((blk->mc * blk->kc + blk->kc * blk->nc) * blk->elemSize + 7) / 8 * 8;
+}
+
+/* ---------------------------------------- f32 ---------------------------------------- */
+
+/* fill blocking of riscv_mat_gemm_f32() */
+__STATIC_INLINE void riscv_mat_gemm_blocking_init_f32(riscv_mat_gemm_blocking *blk)
+{
+#if defined(RISCV_MATH_VECTOR)
+    riscv_mat_gemm_blocking_init(blk, sizeof(float32_t), 0, (uint32_t)__riscv_vsetvlmax_e32m2());
+#else
+    riscv_mat_gemm_blocking_init(blk, sizeof(float32_t), 0, 4);
+#endif
+}
+
+/* pack m x k of A from pA into slivers of RISCV_MAT_GEMM_MR rows, zero padded */
+__STATIC_INLINE void riscv_mat_gemm_pack_a_f32(float32_t *pDst, const float32_t *pA, uint32_t lda, uint32_t m, uint32_t k)
+{
+    uint32_t i, j, r;
+
+    for (i = 0; i < m; i += RISCV_MAT_GEMM_MR) {
+        for (j = 0; j < k; j++) {
+            for (r = 0; r < RISCV_MAT_GEMM_MR; r++) {
+                *pDst++ = (i + r < m) ? pA[(i + r) * lda + j] : 0.0f;
+            }
+        }
+    }
+}
+
+/* pack k x n of B, or of B^T when transB, from pB into panels of nr columns, zero padded */
+__STATIC_INLINE void riscv_mat_gemm_pack_b_f32(float32_t *pDst, const float32_t *pB, uint32_t ldb, uint32_t k,
+                                               uint32_t n, uint32_t nr, uint32_t transB)
+{
+    uint32_t i, j, c;
+
+    for (j = 0; j < n; j += nr) {
+        for (i = 0; i < k; i++) {
+            for (c = 0; c < nr; c++) {
+                if (j + c >= n) {
+                    *pDst++ = 0.0f;
+                } else {
+                    *pDst++ = transB ? pB[(j + c) * ldb + i] : pB[i * ldb + j + c];
+                }
+            }
+        }
+    }
+}
+
+#if defined(RISCV_MATH_VECTOR)
+/* store row of tile into C, adding it to C if accumulate */
+__STATIC_INLINE void riscv_mat_gemm_store_f32(float32_t *pC, vfloat32m2_t c, size_t nv, uint32_t accumulate)
+{
+    if (accumulate) {
+        c = __riscv_vfadd_vv_f32m2(c, __riscv_vle32_v_f32m2(pC, nv), nv);
+    }
+    __riscv_vse32_v_f32m2(pC, c, nv);
+}
+#endif
+
+/* C tile of mv x nv at pC = sliver pA * panel pB over kc, added to C if accumulate */
+__STATIC_INLINE void riscv_mat_gemm_ukr_f32(uint32_t kc, const float32_t *pA, const float32_t *pB, uint32_t nr,
+                                            float32_t *pC, uint32_t ldc, uint32_t mv, uint32_t nv, uint32_t accumulate)
+{
+    uint32_t k;
+#if defined(RISCV_MATH_VECTOR)
+    vfloat32m2_t b, c0, c1, c2, c3;
+
+    c0 = __riscv_vfmv_v_f_f32m2(0.0f, nr);
+    c1 = c0;
+    c2 = c0;
+    c3 = c0;
+    for (k = 0; k < kc; k++) {
+        b = __riscv_vle32_v_f32m2(pB, nr);
+        c0 = __riscv_vfmacc_vf_f32m2(c0, pA[0], b, nr);
+        c1 = __riscv_vfmacc_vf_f32m2(c1, pA[1], b, nr);
+        c2 = __riscv_vfmacc_vf_f32m2(c2, pA[2], b, nr);
+        c3 = __riscv_vfmacc_vf_f32m2(c3, pA[3], b, nr);
+        pA += RISCV_MAT_GEMM_MR;
+        pB += nr;
+    }
+    riscv_mat_gemm_store_f32(pC, c0, nv, accumulate);
+    if (mv > 1) {
+        riscv_mat_gemm_store_f32(pC + ldc, c1, nv, accumulate);
+    }
+    if (mv > 2) {
+        riscv_mat_gemm_store_f32(pC + 2 * ldc, c2, nv, accumulate);
+    }
+    if (mv > 3) {
+        riscv_mat_gemm_store_f32(pC + 3 * ldc, c3, nv, accumulate);
+    }
+#else
+    float32_t c[RISCV_MAT_GEMM_MR][4] = { { 0.0f } };
+    uint32_t r, j;
+
+    for (k = 0; k < kc; k++) {
+        for (r = 0; r < RISCV_MAT_GEMM_MR; r++) {
+            for (j = 0; j < 4; j++) {
+                c[r][j] += pA[r] * pB[j];
+            }
+        }
+        pA += RISCV_MAT_GEMM_MR;
+        pB += nr;
+    }
+    for (r = 0; r < mv; r++) {
+        for (j = 0; j < nv; j++) {
+            pC[r * ldc + j] = accumulate ? (pC[r * ldc + j] + c[r][j]) : c[r][j];
+        }
+    }
+#endif
+}
+
+/*
+ * Same as riscv_mat_mult_f32(), or A * B^T when transB and pSrcB holds B^T, blk is filled by
+ * riscv_mat_gemm_blocking_init_f32(), pWork of riscv_mat_gemm_work_size(blk) bytes
+ */
+__STATIC_INLINE riscv_status riscv_mat_gemm_f32(const riscv_mat_gemm_blocking *blk,
+                                                const riscv_matrix_instance_f32 *pSrcA,
+                                                const riscv_matrix_instance_f32 *pSrcB,
+                                                riscv_matrix_instance_f32 *pDst, uint8_t transB, void *pWork)
+{
+    uint32_t M = pDst->numRows, N = pDst->numCols, K = pSrcA->numCols, nr = blk->nr;
+    uint32_t ldb = pSrcB->numCols, jc, pc, ic, jr, ir, nc, kc, mc;
+    float32_t *pPackA = (float32_t *)pWork, *pPackB = pPackA + blk->mc * blk->kc;
+    float32_t *pC;
+
+    if ((pSrcA->numRows != M) || ((transB ? pSrcB->numCols : pSrcB->numRows) != K) ||
+        ((transB ? pSrcB->numRows : pSrcB->numCols) != N)) {
+        return RISCV_MATH_SIZE_MISMATCH;
+    }
+    // a single pass of zero depth still has to clear C
+    if (K == 0) {
+        memset(pDst->pData, 0, M * N * sizeof(float32_t));
+        return RISCV_MATH_SUCCESS;
+    }
+    for (jc = 0; jc < N; jc += nc) {
+        nc = (N - jc < blk->nc) ? (N - jc) : blk->nc;
+        for (pc = 0; pc < K; pc += kc) {
+            kc = (K - pc < blk->kc) ? (K - pc) : blk->kc;
+            riscv_mat_gemm_pack_b_f32(pPackB, transB ? (pSrcB->pData + jc * ldb + pc) : (pSrcB->pData + pc * ldb + jc),
+                                      ldb, kc, nc, nr, transB);
+            for (ic = 0; ic < M; ic += mc) {
+                mc = (M - ic < blk->mc) ? (M - ic) : blk->mc;
+                riscv_mat_gemm_pack_a_f32(pPackA, pSrcA->pData + ic * K + pc, K, mc, kc);
+                for (jr = 0; jr < nc; jr += nr) {
+                    for (ir = 0; ir < mc; ir += RISCV_MAT_GEMM_MR) {
+                        pC = pDst->pData + (ic + ir) * N + jc + jr;
+                        riscv_mat_gemm_ukr_f32(kc, pPackA + ir * kc, pPackB + jr * kc, nr, pC, N,
+                                               (mc - ir < RISCV_MAT_GEMM_MR) ? (mc - ir) : RISCV_MAT_GEMM_MR,
+                                               (nc - jr < nr) ? (nc - jr) : nr, pc != 0);
+                    }
+                }
+            }
+        }
+    }
+    return RISCV_MATH_SUCCESS;
+}
+
+/* ---------------------------------------- q31 ---------------------------------------- */
+
+/* fill blocking of riscv_mat_gemm_q31() */
+__STATIC_INLINE void riscv_mat_gemm_blocking_init_q31(riscv_mat_gemm_blocking *blk)
+{
+#if defined(RISCV_MAT_GEMM_VECTOR64)
+    riscv_mat_gemm_blocking_init(blk, sizeof(q31_t), sizeof(q63_t), (uint32_t)__riscv_vsetvlmax_e32m2());
+#else
+    riscv_mat_gemm_blocking_init(blk, sizeof(q31_t), sizeof(q63_t), 4);
+#endif
+}
+
+/* pack m x k of A from pA into slivers of RISCV_MAT_GEMM_MR rows, zero padded */
+__STATIC_INLINE void riscv_mat_gemm_pack_a_q31(q31_t *pDst, const q31_t *pA, uint32_t lda, uint32_t m, uint32_t k)
+{
+    uint32_t i, j, r;
+
+    for (i = 0; i < m; i += RISCV_MAT_GEMM_MR) {
+        for (j = 0; j < k; j++) {
+            for (r = 0; r < RISCV_MAT_GEMM_MR; r++) {
+                *pDst++ = (i + r < m) ? pA[(i + r) * lda + j] : 0;
+            }
+        }
+    }
+}
+
+/* pack k x n of B, or of B^T when transB, from pB into panels of nr columns, zero padded */
+__STATIC_INLINE void riscv_mat_gemm_pack_b_q31(q31_t *pDst, const q31_t *pB, uint32_t ldb, uint32_t k,
+                                               uint32_t n, uint32_t nr, uint32_t transB)
+{
+    uint32_t i, j, c;
+
+    for (j = 0; j < n; j += nr) {
+        for (i = 0; i < k; i++) {
+            for (c = 0; c < nr; c++) {
+                if (j + c >= n) {
+                    *pDst++ = 0;
+                } else {
+                    *pDst++ = transB ? pB[(j + c) * ldb + i] : pB[i * ldb + j + c];
+                }
+            }
+        }
+    }
+}
+
+/* accumulator tile of RISCV_MAT_GEMM_MR x nr at pAcc += sliver pA * panel pB over kc, set if first */
+__STATIC_INLINE void riscv_mat_gemm_ukr_q31(uint32_t kc, const q31_t *pA, const q31_t *pB, uint32_t nr,
+                                            q63_t *pAcc, uint32_t ldacc, uint32_t first)
+{
+    uint32_t k;
+#if defined(RISCV_MAT_GEMM_VECTOR64)
+    vint32m2_t b;
+    vint64m4_t c0, c1, c2, c3;
+
+    if (first) {
+        c0 = __riscv_vmv_v_x_i64m4(0, nr);
+        c1 = c0;
+        c2 = c0;
+        c3 = c0;
+    } else {
+        c0 = __riscv_vle64_v_i64m4(pAcc, nr);
+        c1 = __riscv_vle64_v_i64m4(pAcc + ldacc, nr);
+        c2 = __riscv_vle64_v_i64m4(pAcc + 2 * ldacc, nr);
+        c3 = __riscv_vle64_v_i64m4(pAcc + 3 * ldacc, nr);
+    }
+    for (k = 0; k < kc; k++) {
+        b = __riscv_vle32_v_i32m2(pB, nr);
+        c0 = __riscv_vwmacc_vx_i64m4(c0, pA[0], b, nr);
+        c1 = __riscv_vwmacc_vx_i64m4(c1, pA[1], b, nr);
+        c2 = __riscv_vwmacc_vx_i64m4(c2, pA[2], b, nr);
+        c3 = __riscv_vwmacc_vx_i64m4(c3, pA[3], b, nr);
+        pA += RISCV_MAT_GEMM_MR;
+        pB += nr;
+    }
+    __riscv_vse64_v_i64m4(pAcc, c0, nr);
+    __riscv_vse64_v_i64m4(pAcc + ldacc, c1, nr);
+    __riscv_vse64_v_i64m4(pAcc + 2 * ldacc, c2, nr);
+    __riscv_vse64_v_i64m4(pAcc + 3 * ldacc, c3, nr);
+#else
+    q63_t c[RISCV_MAT_GEMM_MR][4];
+    uint32_t r, j;
+
+    for (r = 0; r < RISCV_MAT_GEMM_MR; r++) {
+        for (j = 0; j < 4; j++) {
+            c[r][j] = first ? 0 : pAcc[r * ldacc + j];
+        }
+    }
+    for (k = 0; k < kc; k++) {
+        for (r = 0; r < RISCV_MAT_GEMM_MR; r++) {
+            for (j = 0; j < 4; j++) {
+                c[r][j] += (q63_t)pA[r] * pB[j];
+            }
+        }
+        pA += RISCV_MAT_GEMM_MR;
+        pB += nr;
+    }
+    for (r = 0; r < RISCV_MAT_GEMM_MR; r++) {
+        for (j = 0; j < 4; j++) {
+            pAcc[r * ldacc + j] = c[r][j];
+        }
+    }
+#endif
+}
+
+/*
+ * Same as riscv_mat_mult_q31(), or A * B^T when transB and pSrcB holds B^T, blk is filled by
+ * riscv_mat_gemm_blocking_init_q31(), pWork of riscv_mat_gemm_work_size(blk) bytes
+ */
+__STATIC_INLINE riscv_status riscv_mat_gemm_q31(const riscv_mat_gemm_blocking *blk,
+                                                const riscv_matrix_instance_q31 *pSrcA,
+                                                const riscv_matrix_instance_q31 *pSrcB,
+                                                riscv_matrix_instance_q31 *pDst, uint8_t transB, void *pWork)
+{
+    uint32_t M = pDst->numRows, N = pDst->numCols, K = pSrcA->numCols, nr = blk->nr;
+    uint32_t ldb = pSrcB->numCols, jc, pc, ic, jr, ir, nc, kc, mc, r, j;
+    q63_t *pAcc = (q63_t *)pWork;
+    q31_t *pPackA = (q31_t *)(pAcc + blk->mc * blk->nc), *pPackB = pPackA + blk->mc * blk->kc;
+
+    if ((pSrcA->numRows != M) || ((transB ? pSrcB->numCols : pSrcB->numRows) != K) ||
+        ((transB ? pSrcB->numRows : pSrcB->numCols) != N)) {
+        return RISCV_MATH_SIZE_MISMATCH;
+    }
+    if (K == 0) {
+        memset(pDst->pData, 0, M * N * sizeof(q31_t));
+        return RISCV_MATH_SUCCESS;
+    }
+    // sums over all of K stay in the accumulators, blocks of B are packed again for each block of A
+    for (jc = 0; jc < N; jc += nc) {
+        nc = (N - jc < blk->nc) ? (N - jc) : blk->nc;
+        for (ic = 0; ic < M; ic += mc) {
+            mc = (M - ic < blk->mc) ? (M - ic) : blk->mc;
+            for (pc = 0; pc < K; pc += kc) {
+                kc = (K - pc < blk->kc) ? (K - pc) : blk->kc;
+                riscv_mat_gemm_pack_b_q31(pPackB, transB ? (pSrcB->pData + jc * ldb + pc) : (pSrcB->pData + pc * ldb + jc),
+                                          ldb, kc, nc, nr, transB);
+                riscv_mat_gemm_pack_a_q31(pPackA, pSrcA->pData + ic * K + pc, K, mc, kc);
+                for (jr = 0; jr < nc; jr += nr) {
+                    for (ir = 0; ir < mc; ir += RISCV_MAT_GEMM_MR) {
+                        riscv_mat_gemm_ukr_q31(kc, pPackA + ir * kc, pPackB + jr * kc, nr,
+                                               pAcc + ir * blk->nc + jr, blk->nc, pc == 0);
+                    }
+                }
+            }
+            for (r = 0; r < mc; r++) {
+                for (j = 0; j < nc; j++) {
+                    pDst->pData[(ic + r) * N + jc + j] = clip_q63_to_q31(pAcc[r * blk->nc + j] >> 31);
+                }
+            }
+        }
+    }
+    return RISCV_MATH_SUCCESS;
+}
+
+/* ---------------------------------------- q15 ---------------------------------------- */
+
+/* fill blocking of riscv_mat_gemm_q15() */
+__STATIC_INLINE void riscv_mat_gemm_blocking_init_q15(riscv_mat_gemm_blocking *blk)
+{
+#if defined(RISCV_MAT_GEMM_VECTOR64)
+    riscv_mat_gemm_blocking_init(blk, sizeof(q15_t), sizeof(q63_t), (uint32_t)__riscv_vsetvlmax_e16m1());
+#else
+    riscv_mat_gemm_blocking_init(blk, sizeof(q15_t), sizeof(q63_t), 4);
+#endif
+}
+
+/* pack m x k of A from pA into slivers of RISCV_MAT_GEMM_MR rows, zero padded */
+__STATIC_INLINE void riscv_mat_gemm_pack_a_q15(q15_t *pDst, const q15_t *pA, uint32_t lda, uint32_t m, uint32_t k)
+{
+    uint32_t i, j, r;
+
+    for (i = 0; i < m; i += RISCV_MAT_GEMM_MR) {
+        for (j = 0; j < k; j++) {
+            for (r = 0; r < RISCV_MAT_GEMM_MR; r++) {
+                *pDst++ = (i + r < m) ? pA[(i + r) * lda + j] : 0;
+            }
+        }
+    }
+}
+
+/* pack k x n of B, or of B^T when transB, from pB into panels of nr columns, zero padded */
+__STATIC_INLINE void riscv_mat_gemm_pack_b_q15(q15_t *pDst, const q15_t *pB, uint32_t ldb, uint32_t k,
+                                               uint32_t n, uint32_t nr, uint32_t transB)
+{
+    uint32_t i, j, c;
+
+    for (j = 0; j < n; j += nr) {
+        for (i = 0; i < k; i++) {
+            for (c = 0; c < nr; c++) {
+                if (j + c >= n) {
+                    *pDst++ = 0;
+                } else {
+                    *pDst++ = transB ? pB[(j + c) * ldb + i] : pB[i * ldb + j + c];
+                }
+            }
+        }
+    }
+}
+
+/* accumulator tile of RISCV_MAT_GEMM_MR x nr at pAcc += sliver pA * panel pB over kc, set if first */
+__STATIC_INLINE void riscv_mat_gemm_ukr_q15(uint32_t kc, const q15_t *pA, const q15_t *pB, uint32_t nr,
+                                            q63_t *pAcc, uint32_t ldacc, uint32_t first)
+{
+    uint32_t k;
+#if defined(RISCV_MAT_GEMM_VECTOR64)
+    vint16m1_t b;
+    vint64m4_t c0, c1, c2, c3;
+
+    if (first) {
+        c0 = __riscv_vmv_v_x_i64m4(0, nr);
+        c1 = c0;
+        c2 = c0;
+        c3 = c0;
+    } else {
+        c0 = __riscv_vle64_v_i64m4(pAcc, nr);
+        c1 = __riscv_vle64_v_i64m4(pAcc + ldacc, nr);
+        c2 = __riscv_vle64_v_i64m4(pAcc + 2 * ldacc, nr);
+        c3 = __riscv_vle64_v_i64m4(pAcc + 3 * ldacc, nr);
+    }
+    for (k = 0; k < kc; k++) {
+        b = __riscv_vle16_v_i16m1(pB, nr);
+        c0 = __riscv_vwadd_wv_i64m4(c0, __riscv_vwmul_vx_i32m2(b, pA[0], nr), nr);
+        c1 = __riscv_vwadd_wv_i64m4(c1, __riscv_vwmul_vx_i32m2(b, pA[1], nr), nr);
+        c2 = __riscv_vwadd_wv_i64m4(c2, __riscv_vwmul_vx_i32m2(b, pA[2], nr), nr);
+        c3 = __riscv_vwadd_wv_i64m4(c3, __riscv_vwmul_vx_i32m2(b, pA[3], nr), nr);
+        pA += RISCV_MAT_GEMM_MR;
+        pB += nr;
+    }
+    __riscv_vse64_v_i64m4(pAcc, c0, nr);
+    __riscv_vse64_v_i64m4(pAcc + ldacc, c1, nr);
+    __riscv_vse64_v_i64m4(pAcc + 2 * ldacc, c2, nr);
+    __riscv_vse64_v_i64m4(pAcc + 3 * ldacc, c3, nr);
+#else
+    q63_t c[RISCV_MAT_GEMM_MR][4];
+    uint32_t r, j;
+
+    for (r = 0; r < RISCV_MAT_GEMM_MR; r++) {
+        for (j = 0; j < 4; j++) {
+            c[r][j] = first ? 0 : pAcc[r * ldacc + j];
+        }
+    }
+    for (k = 0; k < kc; k++) {
+        for (r = 0; r < RISCV_MAT_GEMM_MR; r++) {
+            for (j = 0; j < 4; j++) {
+                c[r][j] += (q63_t)pA[r] * pB[j];
+            }
+        }
+        pA += RISCV_MAT_GEMM_MR;
+        pB += nr;
+    }
+    for (r = 0; r < RISCV_MAT_GEMM_MR; r++) {
+        for (j = 0; j < 4; j++) {
+            pAcc[r * ldacc + j] = c[r][j];
+        }
+    }
+#endif
+}
+
+/*
+ * Same as riscv_mat_mult_q15(), or A * B^T when transB and pSrcB holds B^T, blk is filled by
+ * riscv_mat_gemm_blocking_init_q15(), pWork of riscv_mat_gemm_work_size(blk) bytes
+ */
+__STATIC_INLINE riscv_status riscv_mat_gemm_q15(const riscv_mat_gemm_blocking *blk,
+                                                const riscv_matrix_instance_q15 *pSrcA,
+                                                const riscv_matrix_instance_q15 *pSrcB,
+                                                riscv_matrix_instance_q15 *pDst, uint8_t transB, void *pWork)
+{
+    uint32_t M = pDst->numRows, N = pDst->numCols, K = pSrcA->numCols, nr = blk->nr;
+    uint32_t ldb = pSrcB->numCols, jc, pc, ic, jr, ir, nc, kc, mc, r, j;
+    q63_t *pAcc = (q63_t *)pWork;
+    q15_t *pPackA = (q15_t *)(pAcc + blk->mc * blk->nc), *pPackB = pPackA + blk->mc * blk->kc;
+
+    if ((pSrcA->numRows != M) || ((transB ? pSrcB->numCols : pSrcB->numRows) != K) ||
+        ((transB ? pSrcB->numRows : pSrcB->numCols) != N)) {
+        return RISCV_MATH_SIZE_MISMATCH;
+    }
+    if (K == 0) {
+        memset(pDst->pData, 0, M * N * sizeof(q15_t));
+        return RISCV_MATH_SUCCESS;
+    }
+    // sums over all of K stay in the accumulators, blocks of B are packed again for each block of A
+    for (jc = 0; jc < N; jc += nc) {
+        nc = (N - jc < blk->nc) ? (N - jc) : blk->nc;
+        for (ic = 0; ic < M; ic += mc) {
+            mc = (M - ic < blk->mc) ? (M - ic) : blk->mc;
+            for (pc = 0; pc < K; pc += kc) {
+                kc = (K - pc < blk->kc) ? (K - pc) : blk->kc;
+                riscv_mat_gemm_pack_b_q15(pPackB, transB ? (pSrcB->pData + jc * ldb + pc) : (pSrcB->pData + pc * ldb + jc),
+                                          ldb, kc, nc, nr, transB);
+                riscv_mat_gemm_pack_a_q15(pPackA, pSrcA->pData + ic * K + pc, K, mc, kc);
+                for (jr = 0; jr < nc; jr += nr) {
+                    for (ir = 0; ir < mc; ir += RISCV_MAT_GEMM_MR) {
+                        riscv_mat_gemm_ukr_q15(kc, pPackA + ir * kc, pPackB + jr * kc, nr,
+                                               pAcc + ir * blk->nc + jr, blk->nc, pc == 0);
+                    }
+                }
+            }
+            for (r = 0; r < mc; r++) {
+                for (j = 0; j < nc; j++) {
+                    pDst->pData[(ic + r) * N + jc + j] = (q15_t)__SSAT(clip_q63_to_q31(pAcc[r * blk->nc + j] >> 15), 16);
+                }
+            }
+        }
+    }
+    return RISCV_MATH_SUCCESS;
+}
+
+/* ---------------------------------------- q7 ----------------------------------------- */
+
+/* fill blocking of riscv_mat_gemm_q7() */
+__STATIC_INLINE void riscv_mat_gemm_blocking_init_q7(riscv_mat_gemm_blocking *blk)
+{
+#if defined(RISCV_MATH_VECTOR)
+    riscv_mat_gemm_blocking_init(blk, sizeof(q15_t), sizeof(q31_t), (uint32_t)__riscv_vsetvlmax_e16m1());
+#else
+    riscv_mat_gemm_blocking_init(blk, sizeof(q15_t), sizeof(q31_t), 4);
+#endif
+}
+
+/* pack m x k of A from pA into slivers of RISCV_MAT_GEMM_MR rows, zero padded */
+__STATIC_INLINE void riscv_mat_gemm_pack_a_q7(q15_t *pDst, const q7_t *pA, uint32_t lda, uint32_t m, uint32_t k)
+{
+    uint32_t i, j, r;
+
+    for (i = 0; i < m; i += RISCV_MAT_GEMM_MR) {
+        for (j = 0; j < k; j++) {
+            for (r = 0; r < RISCV_MAT_GEMM_MR; r++) {
+                *pDst++ = (i + r < m) ? pA[(i + r) * lda + j] : 0;
+            }
+        }
+    }
+}
+
+/* pack k x n of B, or of B^T when transB, from pB into panels of nr columns, zero padded */
+__STATIC_INLINE void riscv_mat_gemm_pack_b_q7(q15_t *pDst, const q7_t *pB, uint32_t ldb, uint32_t k,
+                                               uint32_t n, uint32_t nr, uint32_t transB)
+{
+    uint32_t i, j, c;
+
+    for (j = 0; j < n; j += nr) {
+        for (i = 0; i < k; i++) {
+            for (c = 0; c < nr; c++) {
+                if (j + c >= n) {
+                    *pDst++ = 0;
+                } else {
+                    *pDst++ = transB ? pB[(j + c) * ldb + i] : pB[i * ldb + j + c];
+                }
+            }
+        }
+    }
+}
+
+/* accumulator tile of RISCV_MAT_GEMM_MR x nr at pAcc += sliver pA * panel pB over kc, set if first */
+__STATIC_INLINE void riscv_mat_gemm_ukr_q7(uint32_t kc, const q15_t *pA, const q15_t *pB, uint32_t nr,
+                                           q31_t *pAcc, uint32_t ldacc, uint32_t first)
+{
+    uint32_t k;
+#if defined(RISCV_MATH_VECTOR)
+    vint16m1_t b;
+    vint32m2_t c0, c1, c2, c3;
+
+    if (first) {
+        c0 = __riscv_vmv_v_x_i32m2(0, nr);
+        c1 = c0;
+        c2 = c0;
+        c3 = c0;
+    } else {
+        c0 = __riscv_vle32_v_i32m2(pAcc, nr);
+        c1 = __riscv_vle32_v_i32m2(pAcc + ldacc, nr);
+        c2 = __riscv_vle32_v_i32m2(pAcc + 2 * ldacc, nr);
+        c3 = __riscv_vle32_v_i32m2(pAcc + 3 * ldacc, nr);
+    }
+    for (k = 0; k < kc; k++) {
+        b = __riscv_vle16_v_i16m1(pB, nr);
+        c0 = __riscv_vwmacc_vx_i32m2(c0, pA[0], b, nr);
+        c1 = __riscv_vwmacc_vx_i32m2(c1, pA[1], b, nr);
+        c2 = __riscv_vwmacc_vx_i32m2(c2, pA[2], b, nr);
+        c3 = __riscv_vwmacc_vx_i32m2(c3, pA[3], b, nr);
+        pA += RISCV_MAT_GEMM_MR;
+        pB += nr;
+    }
+    __riscv_vse32_v_i32m2(pAcc, c0, nr);
+    __riscv_vse32_v_i32m2(pAcc + ldacc, c1, nr);
+    __riscv_vse32_v_i32m2(pAcc + 2 * ldacc, c2, nr);
+    __riscv_vse32_v_i32m2(pAcc + 3 * ldacc, c3, nr);
+#else
+    q31_t c[RISCV_MAT_GEMM_MR][4];
+    uint32_t r, j;
+
+    for (r = 0; r < RISCV_MAT_GEMM_MR; r++) {
+        for (j = 0; j < 4; j++) {
+            c[r][j] = first ? 0 : pAcc[r * ldacc + j];
+        }
+    }
+    for (k = 0; k < kc; k++) {
+        for (r = 0; r < RISCV_MAT_GEMM_MR; r++) {
+            for (j = 0; j < 4; j++) {
+                c[r][j] += (q31_t)pA[r] * pB[j];
+            }
+        }
+        pA += RISCV_MAT_GEMM_MR;
+        pB += nr;
+    }
+    for (r = 0; r < RISCV_MAT_GEMM_MR; r++) {
+        for (j = 0; j < 4; j++) {
+            pAcc[r * ldacc + j] = c[r][j];
+        }
+    }
+#endif
+}
+
+/*
+ * Same as riscv_mat_mult_q7(), or A * B^T when transB and pSrcB holds B^T, blk is filled by
+ * riscv_mat_gemm_blocking_init_q7(), pWork of riscv_mat_gemm_work_size(blk) bytes
+ */
+__STATIC_INLINE riscv_status riscv_mat_gemm_q7(const riscv_mat_gemm_blocking *blk,
+                                                const riscv_matrix_instance_q7 *pSrcA,
+                                                const riscv_matrix_instance_q7 *pSrcB,
+                                                riscv_matrix_instance_q7 *pDst, uint8_t transB, void *pWork)
+{
+    uint32_t M = pDst->numRows, N = pDst->numCols, K = pSrcA->numCols, nr = blk->nr;
+    uint32_t ldb = pSrcB->numCols, jc, pc, ic, jr, ir, nc, kc, mc, r, j;
+    q31_t *pAcc = (q31_t *)pWork;
+    q15_t *pPackA = (q15_t *)(pAcc + blk->mc * blk->nc), *pPackB = pPackA + blk->mc * blk->kc;
+
+    if ((pSrcA->numRows != M) || ((transB ? pSrcB->numCols : pSrcB->numRows) != K) ||
+        ((transB ? pSrcB->numRows : pSrcB->numCols) != N)) {
+        return RISCV_MATH_SIZE_MISMATCH;
+    }
+    if (K == 0) {
+        memset(pDst->pData, 0, M * N * sizeof(q7_t));
+        return RISCV_MATH_SUCCESS;
+    }
+    // sums over all of K stay in the accumulators, blocks of B are packed again for each block of A
+    for (jc = 0; jc < N; jc += nc) {
+        nc = (N - jc < blk->nc) ? (N - jc) : blk->nc;
+        for (ic = 0; ic < M; ic += mc) {
+            mc = (M - ic < blk->mc) ? (M - ic) : blk->mc;
+            for (pc = 0; pc < K; pc += kc) {
+                kc = (K - pc < blk->kc) ? (K - pc) : blk->kc;
+                riscv_mat_gemm_pack_b_q7(pPackB, transB ? (pSrcB->pData + jc * ldb + pc) : (pSrcB->pData + pc * ldb + jc),
+                                          ldb, kc, nc, nr, transB);
+                riscv_mat_gemm_pack_a_q7(pPackA, pSrcA->pData + ic * K + pc, K, mc, kc);
+                for (jr = 0; jr < nc; jr += nr) {
+                    for (ir = 0; ir < mc; ir += RISCV_MAT_GEMM_MR) {
+                        riscv_mat_gemm_ukr_q7(kc, pPackA + ir * kc, pPackB + jr * kc, nr,
+                                               pAcc + ir * blk->nc + jr, blk->nc, pc == 0);
+                    }
+                }
+            }
+            for (r = 0; r < mc; r++) {
+                for (j = 0; j < nc; j++) {
+                    pDst->pData[(ic + r) * N + jc + j] = (q7_t)__SSAT(pAcc[r * blk->nc + j] >> 7, 8);
+                }
+            }
+        }
+    }
+    return RISCV_MATH_SUCCESS;
+}
+
+#ifdef   __cplusplus
+}
+#endif
+
+#endif /* _RISCV_MAT_GEMM_H_ */
@@ -0,0 +1,503 @@
+/******************************************************************************
+ * @file     riscv_pext_math.h
+ * @brief    Private header file for NMSIS DSP Library
+ * @version  V1.10.0
+ * @date     08 July 2021
+ ******************************************************************************/
+/*
+ * Copyright (c) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _RISCV_PEXT_MATH_H_
+#define _RISCV_PEXT_MATH_H_
+
+#include "riscv_math.h"
+
+#ifdef   __cplusplus
+extern "C"
+{
+#endif
+
+#if defined(RISCV_MATH_DSP)
+
+#define RISCV_PEXT_MATH         1
+
+/*
+ * P extension kernels of the q7 and q15 basic math and the q15 complex math
+ *
+ * Each riscv_pext_<name>() has the arguments and the result of riscv_<name>() and gives the
+ * same bits as the scalar code of it, so the two can be swapped and compared. The packed
+ * instructions used are:
+ *
+ * | function          | q15                    | q7                            |
+ * |-------------------|------------------------|-------------------------------|
+ * | add, offset       | KADD16                 | KADD8                         |
+ * | sub, negate       | KSUB16                 | KSUB8                         |
+ * | mult              | KHM16                  | KHM8                          |
+ * | abs               | KABS16                 | KABS8                         |
+ * | shift             | KSLRA16                | KSLRA8                        |
+ * | scale             | KHM16, SMBB16, SMTT16  | SUNPKD810/832, KHM16, SCLIP16 |
+ * | clip              | SMAX16, SMIN16         | SMAX8, SMIN8                  |
+ * | dot_prod          | SMALDA                 | SMAQA                         |
+ * | cmplx_conj        | KSUB16, PKTB16         |                               |
+ * | cmplx_mag_squared | SMALDA                 |                               |
+ * | cmplx_dot_prod    | SMALDRS, SMALXDA       |                               |
+ * | cmplx_mult_real   | KHM16, PKBB16, PKTT16  |                               |
+ * | cmplx_mult_cmplx  | SMBB16, SMTT16, SMBT16 |                               |
+ *
+ * Vectors are read and written 32 bits at a time by riscv_math_memory.h, so they need 32 bit
+ * alignment unless __RISCV_FEATURE_UNALIGNED is defined, and the remainder is done by the
+ * scalar code. On RV64 the loaded words are zero extended, so the upper lanes of SIMD
+ * accumulators stay zero. Shifts outside the lane width fall back to the scalar code too,
+ * and riscv_pext_clip_*() needs low <= high.
+ */
+
+/* load 2 q15 or 4 q7 zero extended to a register, store the low 32 bits of one */
+#define RISCV_PEXT_LD_Q15X2(p)  ((unsigned long)(uint32_t)read_q15x2(p))
+#define RISCV_PEXT_LD_Q7X4(p)   ((unsigned long)(uint32_t)read_q7x4(p))
+#define RISCV_PEXT_ST_Q15X2(p, v) write_q15x2((p), (q31_t)(v))
+#define RISCV_PEXT_ST_Q7X4(p, v) write_q7x4((p), (q31_t)(v))
+
+/* both halfwords set to v */
+#define RISCV_PEXT_DUP16(v)     ((unsigned long)(((uint32_t)(uint16_t)(v) << 16) | (uint16_t)(v)))
+/* all bytes set to v */
+#define RISCV_PEXT_DUP8(v)      ((unsigned long)((uint32_t)(uint8_t)(v) * 0x01010101UL))
+
+/* pDst = pSrcA + pSrcB, saturating */
+__STATIC_INLINE void riscv_pext_add_q15(const q15_t *pSrcA, const q15_t *pSrcB, q15_t *pDst, uint32_t blockSize)
+{
+    for (; blockSize >= 2U; blockSize -= 2U) {
+        RISCV_PEXT_ST_Q15X2(pDst, __RV_KADD16(RISCV_PEXT_LD_Q15X2(pSrcA), RISCV_PEXT_LD_Q15X2(pSrcB)));
+        pSrcA += 2;
+        pSrcB += 2;
+        pDst += 2;
+    }
+    if (blockSize > 0U) {
+        *pDst = (q15_t)__SSAT((q31_t)*pSrcA + *pSrcB, 16);
+    }
+}
+
+__STATIC_INLINE void riscv_pext_add_q7(const q7_t *pSrcA, const q7_t *pSrcB, q7_t *pDst, uint32_t blockSize)
+{
+    for (; blockSize >= 4U; blockSize -= 4U) {
+        RISCV_PEXT_ST_Q7X4(pDst, __RV_KADD8(RISCV_PEXT_LD_Q7X4(pSrcA), RISCV_PEXT_LD_Q7X4(pSrcB)));
+        pSrcA += 4;
+        pSrcB += 4;
+        pDst += 4;
+    }
+    for (; blockSize > 0U; blockSize--) {
+        *pDst++ = (q7_t)__SSAT((q15_t)*pSrcA++ + *pSrcB++, 8);
+    }
+}
+
+/* pDst = pSrcA - pSrcB, saturating */
+__STATIC_INLINE void riscv_pext_sub_q15(const q15_t *pSrcA, const q15_t *pSrcB, q15_t *pDst, uint32_t blockSize)
+{
+    for (; blockSize >= 2U; blockSize -= 2U) {
+        RISCV_PEXT_ST_Q15X2(pDst, __RV_KSUB16(RISCV_PEXT_LD_Q15X2(pSrcA), RISCV_PEXT_LD_Q15X2(pSrcB)));
+        pSrcA += 2;
+        pSrcB += 2;
+        pDst += 2;
+    }
+    if (blockSize > 0U) {
+        *pDst = (q15_t)__SSAT((q31_t)*pSrcA - *pSrcB, 16);
+    }
+}
+
+__STATIC_INLINE void riscv_pext_sub_q7(const q7_t *pSrcA, const q7_t *pSrcB, q7_t *pDst, uint32_t blockSize)
+{
+    for (; blockSize >= 4U; blockSize -= 4U) {
+        RISCV_PEXT_ST_Q7X4(pDst, __RV_KSUB8(RISCV_PEXT_LD_Q7X4(pSrcA), RISCV_PEXT_LD_Q7X4(pSrcB)));
+        pSrcA += 4;
+        pSrcB += 4;
+        pDst += 4;
+    }
+    for (; blockSize > 0U; blockSize--) {
+        *pDst++ = (q7_t)__SSAT((q15_t)*pSrcA++ - *pSrcB++, 8);
+    }
+}
+
+/* pDst = (pSrcA * pSrcB) >> 15 or >> 7, saturating */
+__STATIC_INLINE void riscv_pext_mult_q15(const q15_t *pSrcA, const q15_t *pSrcB, q15_t *pDst, uint32_t blockSize)
+{
+    for (; blockSize >= 2U; blockSize -= 2U) {
+        RISCV_PEXT_ST_Q15X2(pDst, __RV_KHM16(RISCV_PEXT_LD_Q15X2(pSrcA), RISCV_PEXT_LD_Q15X2(pSrcB)));
+        pSrcA += 2;
+        pSrcB += 2;
+        pDst += 2;
+    }
+    if (blockSize > 0U) {
+        *pDst = (q15_t)__SSAT(((q31_t)*pSrcA * *pSrcB) >> 15, 16);
+    }
+}
+
+__STATIC_INLINE void riscv_pext_mult_q7(const q7_t *pSrcA, const q7_t *pSrcB, q7_t *pDst, uint32_t blockSize)
+{
+    for (; blockSize >= 4U; blockSize -= 4U) {
+        RISCV_PEXT_ST_Q7X4(pDst, __RV_KHM8(RISCV_PEXT_LD_Q7X4(pSrcA), RISCV_PEXT_LD_Q7X4(pSrcB)));
+        pSrcA += 4;
+        pSrcB += 4;
+        pDst += 4;
+    }
+    for (; blockSize > 0U; blockSize--) {
+        *pDst++ = (q7_t)__SSAT(((q15_t)*pSrcA++ * *pSrcB++) >> 7, 8);
+    }
+}
+
+/* pDst = |pSrc|, the most negative value gives the most positive one */
+__STATIC_INLINE void riscv_pext_abs_q15(const q15_t *pSrc, q15_t *pDst, uint32_t blockSize)
+{
+    for (; blockSize >= 2U; blockSize -= 2U) {
+        RISCV_PEXT_ST_Q15X2(pDst, __RV_KABS16(RISCV_PEXT_LD_Q15X2(pSrc)));
+        pSrc += 2;
+        pDst += 2;
+    }
+    if (blockSize > 0U) {
+        *pDst = (*pSrc > 0) ? *pSrc : ((*pSrc == (q15_t)0x8000) ? 0x7fff : -*pSrc);
+    }
+}
+
+__STATIC_INLINE void riscv_pext_abs_q7(const q7_t *pSrc, q7_t *pDst, uint32_t blockSize)
+{
+    for (; blockSize >= 4U; blockSize -= 4U) {
+        RISCV_PEXT_ST_Q7X4(pDst, __RV_KABS8(RISCV_PEXT_LD_Q7X4(pSrc)));
+        pSrc += 4;
+        pDst += 4;
+    }
+    for (; blockSize > 0U; blockSize--, pSrc++) {
+        *pDst++ = (*pSrc > 0) ? *pSrc : ((*pSrc == (q7_t)0x80) ? 0x7f : -*pSrc);
+    }
+}
+
+/* pDst = -pSrc, saturating */
+__STATIC_INLINE void riscv_pext_negate_q15(const q15_t *pSrc, q15_t *pDst, uint32_t blockSize)
+{
+    for (; blockSize >= 2U; blockSize -= 2U) {
+        RISCV_PEXT_ST_Q15X2(pDst, __RV_KSUB16(0, RISCV_PEXT_LD_Q15X2(pSrc)));
+        pSrc += 2;
+        pDst += 2;
+    }
+    if (blockSize > 0U) {
+        *pDst = (*pSrc == (q15_t)0x8000) ? 0x7fff : -*pSrc;
+    }
+}
+
+__STATIC_INLINE void riscv_pext_negate_q7(const q7_t *pSrc, q7_t *pDst, uint32_t blockSize)
+{
+    for (; blockSize >= 4U; blockSize -= 4U) {
+        RISCV_PEXT_ST_Q7X4(pDst, __RV_KSUB8(0, RISCV_PEXT_LD_Q7X4(pSrc)));
+        pSrc += 4;
+        pDst += 4;
+    }
+    for (; blockSize > 0U; blockSize--, pSrc++) {
+        *pDst++ = (*pSrc == (q7_t)0x80) ? 0x7f : -*pSrc;
+    }
+}
+
+/* pDst = pSrc + offset, saturating */
+__STATIC_INLINE void riscv_pext_offset_q15(const q15_t *pSrc, q15_t offset, q15_t *pDst, uint32_t blockSize)
+{
+    unsigned long off = RISCV_PEXT_DUP16(offset);
+
+    for (; blockSize >= 2U; blockSize -= 2U) {
+        RISCV_PEXT_ST_Q15X2(pDst, __RV_KADD16(RISCV_PEXT_LD_Q15X2(pSrc), off));
+        pSrc += 2;
+        pDst += 2;
+    }
+    if (blockSize > 0U) {
+        *pDst = (q15_t)__SSAT((q31_t)*pSrc + offset, 16);
+    }
+}
+
+__STATIC_INLINE void riscv_pext_offset_q7(const q7_t *pSrc, q7_t offset, q7_t *pDst, uint32_t blockSize)
+{
+    unsigned long off = RISCV_PEXT_DUP8(offset);
+
+    for (; blockSize >= 4U; blockSize -= 4U) {
+        RISCV_PEXT_ST_Q7X4(pDst, __RV_KADD8(RISCV_PEXT_LD_Q7X4(pSrc), off));
+        pSrc += 4;
+        pDst += 4;
+    }
+    for (; blockSize > 0U; blockSize--) {
+        *pDst++ = (q7_t)__SSAT((q15_t)*pSrc++ + offset, 8);
+    }
+}
+
+/* pDst = pSrc << shiftBits saturating, or >> -shiftBits arithmetic */
+__STATIC_INLINE void riscv_pext_shift_q15(const q15_t *pSrc, int8_t shiftBits, q15_t *pDst, uint32_t blockSize)
+{
+    // KSLRA16 takes [-16, 15], -16 shifts by 15 which is the same for 16 bit lanes
+    if ((shiftBits >= -16) && (shiftBits <= 15)) {
+        for (; blockSize >= 2U; blockSize -= 2U) {
+            RISCV_PEXT_ST_Q15X2(pDst, __RV_KSLRA16(RISCV_PEXT_LD_Q15X2(pSrc), shiftBits));
+            pSrc += 2;
+            pDst += 2;
+        }
+    }
+    for (; blockSize > 0U; blockSize--) {
+        *pDst++ = (shiftBits >= 0) ? (q15_t)__SSAT((q31_t)*pSrc++ << shiftBits, 16) : (q15_t)(*pSrc++ >> -shiftBits);
+    }
+}
+
+__STATIC_INLINE void riscv_pext_shift_q7(const q7_t *pSrc, int8_t shiftBits, q7_t *pDst, uint32_t blockSize)
+{
+    if ((shiftBits >= -8) && (shiftBits <= 7)) {
+        for (; blockSize >= 4U; blockSize -= 4U) {
+            RISCV_PEXT_ST_Q7X4(pDst, __RV_KSLRA8(RISCV_PEXT_LD_Q7X4(pSrc), shiftBits));
+            pSrc += 4;
+            pDst += 4;
+        }
+    }
+    for (; blockSize > 0U; blockSize--) {
+        *pDst++ = (shiftBits >= 0) ? (q7_t)__SSAT((q15_t)*pSrc++ << shiftBits, 8) : (q7_t)(*pSrc++ >> -shiftBits);
+    }
+}
+
+/* pDst = (pSrc * scaleFract) >> (15 - shift), saturating */
+__STATIC_INLINE void riscv_pext_scale_q15(const q15_t *pSrc, q15_t scaleFract, int8_t shift, q15_t *pDst,
+                                          uint32_t blockSize)
+{
+    int8_t kShift = 15 - shift;
+    unsigned long scale = RISCV_PEXT_DUP16(scaleFract);
+    unsigned long in;
+
+    if (kShift == 15) {
+        // (a * b) >> 15 saturating is one KHM16
+        for (; blockSize >= 2U; blockSize -= 2U) {
+            RISCV_PEXT_ST_Q15X2(pDst, __RV_KHM16(RISCV_PEXT_LD_Q15X2(pSrc), scale));
+            pSrc += 2;
+            pDst += 2;
+        }
+    } else if ((kShift >= 0) && (kShift < 32)) {
+        for (; blockSize >= 2U; blockSize -= 2U) {
+            in = RISCV_PEXT_LD_Q15X2(pSrc);
+            RISCV_PEXT_ST_Q15X2(pDst, __RV_PKBB16(__SSAT((q31_t)__RV_SMTT16(in, scale) >> kShift, 16),
+                                                  __SSAT((q31_t)__RV_SMBB16(in, scale) >> kShift, 16)));
+            pSrc += 2;
+            pDst += 2;
+        }
+    }
+    for (; blockSize > 0U; blockSize--) {
+        *pDst++ = (q15_t)__SSAT(((q31_t)*pSrc++ * scaleFract) >> kShift, 16);
+    }
+}
+
+/* pack the low bytes of the halfwords of lo and hi to 4 q7 */
+__STATIC_FORCEINLINE unsigned long riscv_pext_pack_q7x4(unsigned long lo, unsigned long hi)
+{
+    return (lo & 0xFFUL) | ((lo >> 8) & 0xFF00UL) | ((hi & 0xFFUL) << 16) | ((hi << 8) & 0xFF000000UL);
+}
+
+__STATIC_INLINE void riscv_pext_scale_q7(const q7_t *pSrc, q7_t scaleFract, int8_t shift, q7_t *pDst,
+                                         uint32_t blockSize)
+{
+    int8_t kShift = 7 - shift;
+    unsigned long scale = RISCV_PEXT_DUP16((q15_t)scaleFract << 8);
+    unsigned long in, lo, hi;
+
+    /*
+     * bytes widen to halfwords and KHM16(x << shift, s << 8) is (x * s) >> (7 - shift) for
+     * shift in [0, 7], x << shift is above -2^15 so KHM16 never saturates, SCLIP16 does the
+     * q7 saturation, a negative shift is an arithmetic shift of (x * s) >> 7
+     */
+    if ((kShift >= 0) && (kShift <= 7)) {
+        for (; blockSize >= 4U; blockSize -= 4U) {
+            in = RISCV_PEXT_LD_Q7X4(pSrc);
+            lo = __RV_KHM16(__RV_SLL16(__RV_SUNPKD810(in), shift), scale);
+            hi = __RV_KHM16(__RV_SLL16(__RV_SUNPKD832(in), shift), scale);
+            RISCV_PEXT_ST_Q7X4(pDst, riscv_pext_pack_q7x4(__RV_SCLIP16(lo, 7), __RV_SCLIP16(hi, 7)));
+            pSrc += 4;
+            pDst += 4;
+        }
+    } else if ((kShift > 7) && (kShift < 23)) {
+        for (; blockSize >= 4U; blockSize -= 4U) {
+            in = RISCV_PEXT_LD_Q7X4(pSrc);
+            lo = __RV_SRA16(__RV_KHM16(__RV_SUNPKD810(in), scale), kShift - 7);
+            hi = __RV_SRA16(__RV_KHM16(__RV_SUNPKD832(in), scale), kShift - 7);
+            RISCV_PEXT_ST_Q7X4(pDst, riscv_pext_pack_q7x4(lo, hi));
+            pSrc += 4;
+            pDst += 4;
+        }
+    }
+    for (; blockSize > 0U; blockSize--) {
+        *pDst++ = (q7_t)__SSAT(((q15_t)*pSrc++ * scaleFract) >> kShift, 8);
+    }
+}
+
+/* pDst = pSrc clipped to [low, high] */
+__STATIC_INLINE void riscv_pext_clip_q15(const q15_t *pSrc, q15_t *pDst, q15_t low, q15_t high, uint32_t numSamples)
+{
+    unsigned long lo = RISCV_PEXT_DUP16(low), hi = RISCV_PEXT_DUP16(high);
+
+    for (; numSamples >= 2U; numSamples -= 2U) {
+        RISCV_PEXT_ST_Q15X2(pDst, __RV_SMAX16(__RV_SMIN16(RISCV_PEXT_LD_Q15X2(pSrc), hi), lo));
+        pSrc += 2;
+        pDst += 2;
+    }
+    if (numSamples > 0U) {
+        *pDst = (*pSrc > high) ? high : ((*pSrc < low) ? low : *pSrc);
+    }
+}
+
+__STATIC_INLINE void riscv_pext_clip_q7(const q7_t *pSrc, q7_t *pDst, q7_t low, q7_t high, uint32_t numSamples)
+{
+    unsigned long lo = RISCV_PEXT_DUP8(low), hi = RISCV_PEXT_DUP8(high);
+
+    for (; numSamples >= 4U; numSamples -= 4U) {
+        RISCV_PEXT_ST_Q7X4(pDst, __RV_SMAX8(__RV_SMIN8(RISCV_PEXT_LD_Q7X4(pSrc), hi), lo));
+        pSrc += 4;
+        pDst += 4;
+    }
+    for (; numSamples > 0U; numSamples--, pSrc++) {
+        *pDst++ = (*pSrc > high) ? high : ((*pSrc < low) ? low : *pSrc);
+    }
+}
+
+/* result = sum of pSrcA * pSrcB, q30 products in a q63 accumulator */
+__STATIC_INLINE void riscv_pext_dot_prod_q15(const q15_t *pSrcA, const q15_t *pSrcB, uint32_t blockSize,
+                                             q63_t *result)
+{
+    q63_t sum = 0;
+
+    for (; blockSize >= 2U; blockSize -= 2U) {
+        sum = __RV_SMALDA(sum, RISCV_PEXT_LD_Q15X2(pSrcA), RISCV_PEXT_LD_Q15X2(pSrcB));
+        pSrcA += 2;
+        pSrcB += 2;
+    }
+    if (blockSize > 0U) {
+        sum += (q31_t)*pSrcA * *pSrcB;
+    }
+    *result = sum;
+}
+
+/* result = sum of pSrcA * pSrcB, q14 products in a q31 accumulator which wraps */
+__STATIC_INLINE void riscv_pext_dot_prod_q7(const q7_t *pSrcA, const q7_t *pSrcB, uint32_t blockSize, q31_t *result)
+{
+    long acc = 0;
+    q31_t sum;
+
+    for (; blockSize >= 4U; blockSize -= 4U) {
+        acc = __RV_SMAQA(acc, RISCV_PEXT_LD_Q7X4(pSrcA), RISCV_PEXT_LD_Q7X4(pSrcB));
+        pSrcA += 4;
+        pSrcB += 4;
+    }
+#if __RISCV_XLEN == 64
+    // SMAQA keeps one sum per word, the upper one is zero from the zero extended loads
+    sum = (q31_t)((uint32_t)acc + (uint32_t)((unsigned long)acc >> 32));
+#else
+    sum = (q31_t)acc;
+#endif
+    for (; blockSize > 0U; blockSize--) {
+        sum += (q15_t)*pSrcA++ * *pSrcB++;
+    }
+    *result = sum;
+}
+
+/* pDst = conj(pSrc), the imaginary parts negate saturating */
+__STATIC_INLINE void riscv_pext_cmplx_conj_q15(const q15_t *pSrc, q15_t *pDst, uint32_t numSamples)
+{
+    unsigned long in;
+
+    for (; numSamples > 0U; numSamples--) {
+        in = RISCV_PEXT_LD_Q15X2(pSrc);
+        RISCV_PEXT_ST_Q15X2(pDst, __RV_PKTB16(__RV_KSUB16(0, in), in));
+        pSrc += 2;
+        pDst += 2;
+    }
+}
+
+/* pDst = (re * re + im * im) >> 17, as q2.14 */
+__STATIC_INLINE void riscv_pext_cmplx_mag_squared_q15(const q15_t *pSrc, q15_t *pDst, uint32_t numSamples)
+{
+    unsigned long in;
+
+    for (; numSamples > 0U; numSamples--) {
+        // the sum is up to 2^31, so it is summed in 64 bits
+        in = RISCV_PEXT_LD_Q15X2(pSrc);
+        *pDst++ = (q15_t)(__RV_SMALDA(0, in, in) >> 17);
+        pSrc += 2;
+    }
+}
+
+/* realResult and imagResult = sum of pSrcA * pSrcB as q16.16, summed in q63 */
+__STATIC_INLINE void riscv_pext_cmplx_dot_prod_q15(const q15_t *pSrcA, const q15_t *pSrcB, uint32_t numSamples,
+                                                   q31_t *realResult, q31_t *imagResult)
+{
+    q63_t real_sum = 0, imag_sum = 0;
+    unsigned long a, b;
+
+    for (; numSamples > 0U; numSamples--) {
+        a = RISCV_PEXT_LD_Q15X2(pSrcA);
+        b = RISCV_PEXT_LD_Q15X2(pSrcB);
+        real_sum = __RV_SMALDRS(real_sum, a, b);
+        imag_sum = __RV_SMALXDA(imag_sum, a, b);
+        pSrcA += 2;
+        pSrcB += 2;
+    }
+    *realResult = (q31_t)(real_sum >> 6);
+    *imagResult = (q31_t)(imag_sum >> 6);
+}
+
+/* pDst = pSrcCmplx * pSrcReal, (x * r) >> 15 saturating */
+__STATIC_INLINE void riscv_pext_cmplx_mult_real_q15(const q15_t *pSrcCmplx, const q15_t *pSrcReal, q15_t *pCmplxDst,
+                                                    uint32_t numSamples)
+{
+    unsigned long r;
+
+    for (; numSamples >= 2U; numSamples -= 2U) {
+        r = RISCV_PEXT_LD_Q15X2(pSrcReal);
+        RISCV_PEXT_ST_Q15X2(pCmplxDst, __RV_KHM16(RISCV_PEXT_LD_Q15X2(pSrcCmplx), __RV_PKBB16(r, r)));
+        RISCV_PEXT_ST_Q15X2(pCmplxDst + 2, __RV_KHM16(RISCV_PEXT_LD_Q15X2(pSrcCmplx + 2), __RV_PKTT16(r, r)));
+        pSrcReal += 2;
+        pSrcCmplx += 4;
+        pCmplxDst += 4;
+    }
+    if (numSamples > 0U) {
+        RISCV_PEXT_ST_Q15X2(pCmplxDst, __RV_KHM16(RISCV_PEXT_LD_Q15X2(pSrcCmplx), RISCV_PEXT_DUP16(*pSrcReal)));
+    }
+}
+
+/*
+ * pDst = pSrcA * pSrcB as q3.13, each product is shifted by 17 before the sum like the
+ * scalar code, so the four products are separate SMxx16 rather than one SMDRS and SMXDS
+ */
+__STATIC_INLINE void riscv_pext_cmplx_mult_cmplx_q15(const q15_t *pSrcA, const q15_t *pSrcB, q15_t *pDst,
+                                                     uint32_t numSamples)
+{
+    unsigned long a, b;
+    q31_t re, im;
+
+    for (; numSamples > 0U; numSamples--) {
+        a = RISCV_PEXT_LD_Q15X2(pSrcA);
+        b = RISCV_PEXT_LD_Q15X2(pSrcB);
+        re = ((q31_t)__RV_SMBB16(a, b) >> 17) - ((q31_t)__RV_SMTT16(a, b) >> 17);
+        im = ((q31_t)__RV_SMBT16(a, b) >> 17) + ((q31_t)__RV_SMBT16(b, a) >> 17);
+        RISCV_PEXT_ST_Q15X2(pDst, __RV_PKBB16(im, re));
+        pSrcA += 2;
+        pSrcB += 2;
+        pDst += 2;
+    }
+}
+
+#endif /* defined(RISCV_MATH_DSP) */
+
+#ifdef   __cplusplus
+}
+#endif
+
+#endif /* _RISCV_PEXT_MATH_H_ */
@@ -105,6 +105,174 @@ extern "C"
           float32_t * pDst,
           uint32_t blockSize);
 
+#if defined(RISCV_MATH_VECTOR)
+
+/*
+ * Vector bitonic sort and selection
+ *
+ * riscv_vec_sort_f32() runs the bitonic network in memory, each compare exchange step is a
+ * vfmin and a vfmax of 2 vectors. A step pairs element i with i + j, those pairs are taken
+ * either as contiguous runs of j elements or, for small j, by strided loads across the
+ * whole array, whichever gives longer vectors. Non power of 2 sizes are padded to the next
+ * power of 2 by infinities in pBuf. riscv_vec_select_f32() is a quickselect whose partition
+ * counts and compresses by vector compares, so its cost is linear on average. Inputs must
+ * not hold NaN.
+ */
+
+/* below this size selection ends by insertion sort */
+#ifndef RISCV_VEC_SELECT_MIN
+#define RISCV_VEC_SELECT_MIN        16U
+#endif
+
+/* return samples of pBuf needed by riscv_vec_sort_f32() for blockSize, 0 for powers of 2 */
+__STATIC_INLINE uint32_t riscv_vec_sort_buf_size(uint32_t blockSize)
+{
+    uint32_t n = 1;
+
+    while (n < blockSize) {
+        n <<= 1;
+    }
+    return (n == blockSize) ? 0 : n;
+}
+
+/*
+ * Compare exchange count pairs of pA[t * stride] and pB[t * stride], stride in bytes, the
+ * smaller one goes to pA, except on pairs whose t & desc is set, or is clear when inv,
+ * where the larger one goes to pA
+ */
+__STATIC_INLINE void riscv_vec_bitonic_cmpx_f32(float32_t *pA, float32_t *pB, ptrdiff_t stride, uint32_t count,
+                                                uint32_t desc, uint8_t inv)
+{
+    uint32_t t;
+    size_t vl;
+    vfloat32m2_t a, b, lo, hi;
+    vbool16_t m;
+
+    for (t = 0; t < count; t += vl) {
+        vl = __riscv_vsetvl_e32m2(count - t);
+        a = __riscv_vlse32_v_f32m2(pA, stride, vl);
+        b = __riscv_vlse32_v_f32m2(pB, stride, vl);
+        lo = __riscv_vfmin_vv_f32m2(a, b, vl);
+        hi = __riscv_vfmax_vv_f32m2(a, b, vl);
+        m = __riscv_vmsne_vx_u32m2_b16(__riscv_vand_vx_u32m2(__riscv_vadd_vx_u32m2(__riscv_vid_v_u32m2(vl), t, vl),
+                                                            desc, vl), 0, vl);
+        if (inv) {
+            m = __riscv_vmnot_m_b16(m, vl);
+        }
+        __riscv_vsse32_v_f32m2(pA, stride, __riscv_vmerge_vvm_f32m2(lo, hi, m, vl), vl);
+        __riscv_vsse32_v_f32m2(pB, stride, __riscv_vmerge_vvm_f32m2(hi, lo, m, vl), vl);
+        pA += vl * (stride / 4);
+        pB += vl * (stride / 4);
+    }
+}
+
+/* bitonic sort of n samples of p in place, n a power of 2 */
+__STATIC_INLINE void riscv_vec_bitonic_f32(float32_t *p, uint32_t n, uint8_t ascending)
+{
+    uint32_t vlmax = __riscv_vsetvlmax_e32m2(), k, j, g, o;
+
+    for (k = 2; k <= n; k <<= 1) {
+        for (j = k >> 1; j > 0; j >>= 1) {
+            if ((j >= vlmax) || (2U * j * j >= n)) {
+                // runs of j, one direction per block of k, block of group g is g / k
+                for (g = 0; g < n; g += 2U * j) {
+                    riscv_vec_bitonic_cmpx_f32(p + g, p + g + j, 4, j, 0, (g & k) ? ascending : !ascending);
+                }
+            } else {
+                // pair t of offset o is at o + 2 * j * t, its block of k is t / (k / (2 * j))
+                for (o = 0; o < j; o++) {
+                    riscv_vec_bitonic_cmpx_f32(p + o, p + o + j, 8 * (ptrdiff_t)j, n / (2U * j), k / (2U * j), !ascending);
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Sort blockSize samples of pSrc into pDst in direction dir, pSrc and pDst can be the same,
+ * pBuf holds riscv_vec_sort_buf_size(blockSize) samples, NULL for powers of 2
+ */
+__STATIC_INLINE void riscv_vec_sort_f32(riscv_sort_dir dir, const float32_t *pSrc, float32_t *pDst,
+                                        uint32_t blockSize, float32_t *pBuf)
+{
+    uint32_t n = riscv_vec_sort_buf_size(blockSize), i;
+    uint8_t ascending = (dir == RISCV_SORT_ASCENDING);
+
+    if (n == 0) {
+        if (pDst != pSrc) {
+            memcpy(pDst, pSrc, blockSize * sizeof(float32_t));
+        }
+        riscv_vec_bitonic_f32(pDst, blockSize, ascending);
+        return;
+    }
+    // padding sorts after all samples in both directions
+    memcpy(pBuf, pSrc, blockSize * sizeof(float32_t));
+    for (i = blockSize; i < n; i++) {
+        pBuf[i] = ascending ? INFINITY : -INFINITY;
+    }
+    riscv_vec_bitonic_f32(pBuf, n, ascending);
+    memcpy(pDst, pBuf, blockSize * sizeof(float32_t));
+}
+
+/*
+ * Return the sample of rank k, from 0, of blockSize samples of pSrc, the one at index k once
+ * sorted ascending, pSrc is left untouched and pBuf holds blockSize samples
+ */
+__STATIC_INLINE float32_t riscv_vec_select_f32(const float32_t *pSrc, uint32_t blockSize, uint32_t k, float32_t *pBuf)
+{
+    const float32_t *p = pSrc;
+    uint32_t n = blockSize, lt, eq, i, j, w;
+    float32_t a, b, c, pivot, v;
+    size_t vl;
+    vfloat32m4_t x;
+    vbool8_t m;
+
+    while (n > RISCV_VEC_SELECT_MIN) {
+        // median of 3 pivot
+        a = p[0];
+        b = p[n >> 1];
+        c = p[n - 1U];
+        pivot = (a < b) ? ((b < c) ? b : ((a < c) ? c : a)) : ((a < c) ? a : ((b < c) ? c : b));
+        lt = 0;
+        eq = 0;
+        for (i = 0; i < n; i += vl) {
+            vl = __riscv_vsetvl_e32m4(n - i);
+            x = __riscv_vle32_v_f32m4(p + i, vl);
+            lt += __riscv_vcpop_m_b8(__riscv_vmflt_vf_f32m4_b8(x, pivot, vl), vl);
+            eq += __riscv_vcpop_m_b8(__riscv_vmfeq_vf_f32m4_b8(x, pivot, vl), vl);
+        }
+        if ((k >= lt) && (k < lt + eq)) {
+            return pivot;
+        }
+        // keep the side of rank k, compressed to the front of pBuf, writes never pass reads
+        for (i = 0, w = 0; i < n; i += vl) {
+            vl = __riscv_vsetvl_e32m4(n - i);
+            x = __riscv_vle32_v_f32m4(p + i, vl);
+            m = (k < lt) ? __riscv_vmflt_vf_f32m4_b8(x, pivot, vl) : __riscv_vmfgt_vf_f32m4_b8(x, pivot, vl);
+            j = __riscv_vcpop_m_b8(m, vl);
+            __riscv_vse32_v_f32m4(pBuf + w, __riscv_vcompress_vm_f32m4(x, m, vl), j);
+            w += j;
+        }
+        if (k >= lt) {
+            k -= lt + eq;
+        }
+        n = w;
+        p = pBuf;
+    }
+    if (p != pBuf) {
+        memcpy(pBuf, p, n * sizeof(float32_t));
+    }
+    for (i = 1; i < n; i++) {
+        v = pBuf[i];
+        for (j = i; (j > 0) && (pBuf[j - 1U] > v); j--) {
+            pBuf[j] = pBuf[j - 1U];
+        }
+        pBuf[j] = v;
+    }
+    return pBuf[k];
+}
+
+#endif /* defined(RISCV_MATH_VECTOR) */
 
 #ifdef   __cplusplus
 }
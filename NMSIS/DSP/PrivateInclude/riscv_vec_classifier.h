@@ -0,0 +1,360 @@
+/******************************************************************************
+ * @file     riscv_vec_classifier.h
+ * @brief    Private header file for NMSIS DSP Library
+ * @version  V1.10.0
+ * @date     08 July 2021
+ ******************************************************************************/
+/*
+ * Copyright (c) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _RISCV_VEC_CLASSIFIER_H_
+#define _RISCV_VEC_CLASSIFIER_H_
+
+#include "riscv_math.h"
+#include "riscv_vec_fast_math.h"
+
+#ifdef   __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Batch SVM and Gaussian naive Bayes prediction
+ *
+ * The samples of a batch are the rows of pIn, numSamples rows of vectorDimension values, as
+ * the windows of all channels of a sensor, and each prediction gives the class of the
+ * single sample functions of svm_functions.h and bayes_functions.h.
+ *
+ * - SVM: lanes are samples, a chunk of RISCV_VEC_SVM_CHUNK samples keeps its decision sums
+ *   on the stack, the support vectors are walked in blocks of RISCV_VEC_SVM_BLOCK for all
+ *   samples of the chunk, so a block stays in cache while it is used by the chunk. Each
+ *   support vector value is a scalar operand of the vector instructions, the samples are
+ *   read by strided loads. The RBF and sigmoid kernels use riscv_fm_vexp_f32m4(), the
+ *   decision sums can differ from the library in the last bits, so a sample right on the
+ *   boundary can get the other class.
+ * - Bayes: riscv_gaussian_naive_bayes_batch_init_f32() computes once what the single sample
+ *   function computes per sample, log(prior) - sum(log(2 * pi * var)) / 2 of each class and
+ *   1 / var of each class and dimension, with var = sigma + epsilon, so a prediction is one
+ *   multiply add per class and dimension, without log.
+ *
+ * Cores without the vector unit call the single sample SVM functions per sample and run
+ * the precomputed Bayes terms in scalar code.
+ */
+
+/* samples of a chunk, their sums are on the stack */
+#ifndef RISCV_VEC_SVM_CHUNK
+#define RISCV_VEC_SVM_CHUNK             64U
+#endif
+
+/* support vectors of a block */
+#ifndef RISCV_VEC_SVM_BLOCK
+#define RISCV_VEC_SVM_BLOCK             16U
+#endif
+
+#if defined(RISCV_MATH_VECTOR) && defined(__riscv_v_elen_fp) && (__riscv_v_elen_fp >= 32)
+#define RISCV_VEC_CLS_VECTORF           1
+#endif
+
+/* ---------------------------------------- SVM ---------------------------------------- */
+
+#if defined(RISCV_VEC_CLS_VECTORF)
+
+#define RISCV_VEC_SVM_LINEAR            0
+#define RISCV_VEC_SVM_POLYNOMIAL        1
+#define RISCV_VEC_SVM_RBF               2
+#define RISCV_VEC_SVM_SIGMOID           3
+
+typedef struct
+{
+    uint32_t kernel;                /**< RISCV_VEC_SVM_LINEAR ~ RISCV_VEC_SVM_SIGMOID */
+    uint32_t nbOfSupportVectors;
+    uint32_t vectorDimension;
+    float32_t intercept;
+    const float32_t *dualCoefficients;
+    const float32_t *supportVectors;
+    const int32_t *classes;
+    int32_t degree;
+    float32_t coef0;
+    float32_t gamma;
+} riscv_vec_svm_params_f32;
+
+/* kernel of support vector sv and the samples of the lanes, pX is the first of them */
+__STATIC_FORCEINLINE vfloat32m4_t riscv_vec_svm_kernel_f32(const riscv_vec_svm_params_f32 *P, const float32_t *pX,
+                                                           const float32_t *sv, size_t vl)
+{
+    uint32_t dim = P->vectorDimension, j;
+    ptrdiff_t stride = (ptrdiff_t)dim * sizeof(float32_t);
+    vfloat32m4_t acc = __riscv_vfmv_v_f_f32m4(0.0f, vl), x, p;
+    int32_t k;
+
+    if (P->kernel == RISCV_VEC_SVM_RBF) {
+        for (j = 0; j < dim; j++) {
+            x = __riscv_vfsub_vf_f32m4(__riscv_vlse32_v_f32m4(pX + j, stride, vl), sv[j], vl);
+            acc = __riscv_vfmacc_vv_f32m4(acc, x, x, vl);
+        }
+        return riscv_fm_vexp_f32m4(__riscv_vfmul_vf_f32m4(acc, -P->gamma, vl), vl);
+    }
+    for (j = 0; j < dim; j++) {
+        acc = __riscv_vfmacc_vf_f32m4(acc, sv[j], __riscv_vlse32_v_f32m4(pX + j, stride, vl), vl);
+    }
+    if (P->kernel == RISCV_VEC_SVM_POLYNOMIAL) {
+        acc = __riscv_vfadd_vf_f32m4(__riscv_vfmul_vf_f32m4(acc, P->gamma, vl), P->coef0, vl);
+        p = __riscv_vfmv_v_f_f32m4(1.0f, vl);
+        for (k = 0; k < P->degree; k++) {
+            p = __riscv_vfmul_vv_f32m4(p, acc, vl);
+        }
+        return p;
+    }
+    if (P->kernel == RISCV_VEC_SVM_SIGMOID) {
+        // tanh(a) = 1 - 2 / (exp(2 * a) + 1)
+        acc = __riscv_vfadd_vf_f32m4(__riscv_vfmul_vf_f32m4(acc, 2.0f * P->gamma, vl), 2.0f * P->coef0, vl);
+        p = __riscv_vfadd_vf_f32m4(riscv_fm_vexp_f32m4(acc, vl), 1.0f, vl);
+        return __riscv_vfrsub_vf_f32m4(__riscv_vfrdiv_vf_f32m4(p, 2.0f, vl), 1.0f, vl);
+    }
+    return acc;
+}
+
+/* class of each of numSamples rows of pIn by the support vectors of P */
+__STATIC_FORCEINLINE void riscv_vec_svm_predict_batch_f32(const riscv_vec_svm_params_f32 *P, const float32_t *pIn,
+                                                          uint32_t numSamples, int32_t *pResult)
+{
+    float32_t sum[RISCV_VEC_SVM_CHUNK];
+    uint32_t dim = P->vectorDimension, nsv = P->nbOfSupportVectors;
+    uint32_t s0, ns, b, nb, i, k;
+    size_t vl;
+    vfloat32m4_t acc;
+
+    for (s0 = 0; s0 < numSamples; s0 += ns) {
+        ns = numSamples - s0;
+        ns = (ns > RISCV_VEC_SVM_CHUNK) ? RISCV_VEC_SVM_CHUNK : ns;
+        for (k = 0; k < ns; k++) {
+            sum[k] = P->intercept;
+        }
+        for (b = 0; b < nsv; b += nb) {
+            nb = nsv - b;
+            nb = (nb > RISCV_VEC_SVM_BLOCK) ? RISCV_VEC_SVM_BLOCK : nb;
+            for (k = 0; k < ns; k += vl) {
+                vl = __riscv_vsetvl_e32m4(ns - k);
+                acc = __riscv_vle32_v_f32m4(sum + k, vl);
+                for (i = b; i < b + nb; i++) {
+                    acc = __riscv_vfmacc_vf_f32m4(acc, P->dualCoefficients[i],
+                                                  riscv_vec_svm_kernel_f32(P, pIn + (size_t)(s0 + k) * dim,
+                                                                           P->supportVectors + (size_t)i * dim, vl),
+                                                  vl);
+                }
+                __riscv_vse32_v_f32m4(sum + k, acc, vl);
+            }
+        }
+        for (k = 0; k < ns; k++) {
+            pResult[s0 + k] = P->classes[(sum[k] <= 0.0f) ? 0 : 1];
+        }
+    }
+}
+
+#endif /* defined(RISCV_VEC_CLS_VECTORF) */
+
+/**
+ * @brief  Linear SVM prediction of a batch of samples
+ * @param[in]  S           linear SVM of riscv_svm_linear_init_f32()
+ * @param[in]  pIn         numSamples rows of S->vectorDimension values
+ * @param[in]  numSamples  number of samples
+ * @param[out] pResult     class of each sample
+ */
+__STATIC_INLINE void riscv_svm_linear_predict_batch_f32(const riscv_svm_linear_instance_f32 *S, const float32_t *pIn,
+                                                        uint32_t numSamples, int32_t *pResult)
+{
+#if defined(RISCV_VEC_CLS_VECTORF)
+    riscv_vec_svm_params_f32 P = {RISCV_VEC_SVM_LINEAR, S->nbOfSupportVectors, S->vectorDimension, S->intercept,
+                                  S->dualCoefficients, S->supportVectors, S->classes, 0, 0.0f, 0.0f};
+
+    riscv_vec_svm_predict_batch_f32(&P, pIn, numSamples, pResult);
+#else
+    uint32_t k;
+
+    for (k = 0; k < numSamples; k++) {
+        riscv_svm_linear_predict_f32(S, pIn + (size_t)k * S->vectorDimension, pResult + k);
+    }
+#endif /* defined(RISCV_VEC_CLS_VECTORF) */
+}
+
+/* Polynomial SVM prediction of a batch of samples, as riscv_svm_linear_predict_batch_f32() */
+__STATIC_INLINE void riscv_svm_polynomial_predict_batch_f32(const riscv_svm_polynomial_instance_f32 *S,
+                                                            const float32_t *pIn, uint32_t numSamples,
+                                                            int32_t *pResult)
+{
+#if defined(RISCV_VEC_CLS_VECTORF)
+    riscv_vec_svm_params_f32 P = {RISCV_VEC_SVM_POLYNOMIAL, S->nbOfSupportVectors, S->vectorDimension, S->intercept,
+                                  S->dualCoefficients, S->supportVectors, S->classes, S->degree, S->coef0, S->gamma};
+
+    riscv_vec_svm_predict_batch_f32(&P, pIn, numSamples, pResult);
+#else
+    uint32_t k;
+
+    for (k = 0; k < numSamples; k++) {
+        riscv_svm_polynomial_predict_f32(S, pIn + (size_t)k * S->vectorDimension, pResult + k);
+    }
+#endif /* defined(RISCV_VEC_CLS_VECTORF) */
+}
+
+/* RBF SVM prediction of a batch of samples, as riscv_svm_linear_predict_batch_f32() */
+__STATIC_INLINE void riscv_svm_rbf_predict_batch_f32(const riscv_svm_rbf_instance_f32 *S, const float32_t *pIn,
+                                                     uint32_t numSamples, int32_t *pResult)
+{
+#if defined(RISCV_VEC_CLS_VECTORF)
+    riscv_vec_svm_params_f32 P = {RISCV_VEC_SVM_RBF, S->nbOfSupportVectors, S->vectorDimension, S->intercept,
+                                  S->dualCoefficients, S->supportVectors, S->classes, 0, 0.0f, S->gamma};
+
+    riscv_vec_svm_predict_batch_f32(&P, pIn, numSamples, pResult);
+#else
+    uint32_t k;
+
+    for (k = 0; k < numSamples; k++) {
+        riscv_svm_rbf_predict_f32(S, pIn + (size_t)k * S->vectorDimension, pResult + k);
+    }
+#endif /* defined(RISCV_VEC_CLS_VECTORF) */
+}
+
+/* Sigmoid SVM prediction of a batch of samples, as riscv_svm_linear_predict_batch_f32() */
+__STATIC_INLINE void riscv_svm_sigmoid_predict_batch_f32(const riscv_svm_sigmoid_instance_f32 *S, const float32_t *pIn,
+                                                         uint32_t numSamples, int32_t *pResult)
+{
+#if defined(RISCV_VEC_CLS_VECTORF)
+    riscv_vec_svm_params_f32 P = {RISCV_VEC_SVM_SIGMOID, S->nbOfSupportVectors, S->vectorDimension, S->intercept,
+                                  S->dualCoefficients, S->supportVectors, S->classes, 0, S->coef0, S->gamma};
+
+    riscv_vec_svm_predict_batch_f32(&P, pIn, numSamples, pResult);
+#else
+    uint32_t k;
+
+    for (k = 0; k < numSamples; k++) {
+        riscv_svm_sigmoid_predict_f32(S, pIn + (size_t)k * S->vectorDimension, pResult + k);
+    }
+#endif /* defined(RISCV_VEC_CLS_VECTORF) */
+}
+
+/* --------------------------------------- Bayes --------------------------------------- */
+
+typedef struct
+{
+    uint32_t vectorDimension;       /**< dimension of vector space */
+    uint32_t numberOfClasses;       /**< number of classes */
+    const float32_t *theta;         /**< numberOfClasses rows of means */
+    const float32_t *invVar;        /**< numberOfClasses rows of 1 / (sigma + epsilon) */
+    const float32_t *logConst;      /**< log(prior) - sum(log(2 * pi * var)) / 2 of each class */
+} riscv_gaussian_naive_bayes_batch_f32;
+
+/*
+ * Set up B from S, pInvVar holds numberOfClasses * vectorDimension values and pLogConst
+ * numberOfClasses values, S is still used for the means
+ */
+__STATIC_INLINE void riscv_gaussian_naive_bayes_batch_init_f32(riscv_gaussian_naive_bayes_batch_f32 *B,
+                                                               const riscv_gaussian_naive_bayes_instance_f32 *S,
+                                                               float32_t *pInvVar, float32_t *pLogConst)
+{
+    uint32_t dim = S->vectorDimension, c, j;
+    float32_t var, acc;
+
+    for (c = 0; c < S->numberOfClasses; c++) {
+        acc = 0.0f;
+        for (j = 0; j < dim; j++) {
+            var = S->sigma[c * dim + j] + S->epsilon;
+            acc += logf(2.0f * PI * var);
+            pInvVar[c * dim + j] = 1.0f / var;
+        }
+        pLogConst[c] = logf(S->classPriors[c]) - 0.5f * acc;
+    }
+    B->vectorDimension = dim;
+    B->numberOfClasses = S->numberOfClasses;
+    B->theta = S->theta;
+    B->invVar = pInvVar;
+    B->logConst = pLogConst;
+}
+
+/**
+ * @brief  Gaussian naive Bayes prediction of a batch of samples
+ * @param[in]  B           terms of riscv_gaussian_naive_bayes_batch_init_f32()
+ * @param[in]  pIn         numSamples rows of B->vectorDimension values
+ * @param[in]  numSamples  number of samples
+ * @param[out] pResult     class of each sample, the first of the most likely
+ */
+__STATIC_INLINE void riscv_gaussian_naive_bayes_predict_batch_f32(const riscv_gaussian_naive_bayes_batch_f32 *B,
+                                                                  const float32_t *pIn, uint32_t numSamples,
+                                                                  uint32_t *pResult)
+{
+    uint32_t dim = B->vectorDimension, c, j, k;
+    const float32_t *pTheta, *pInv;
+
+#if defined(RISCV_VEC_CLS_VECTORF)
+    ptrdiff_t stride = (ptrdiff_t)dim * sizeof(float32_t);
+    size_t vl;
+    vfloat32m4_t acc, x, best;
+    vuint32m4_t cls;
+    vbool8_t gt;
+
+    // lanes are samples, the log likelihood of each class is compared to the best one so far
+    for (k = 0; k < numSamples; k += vl) {
+        vl = __riscv_vsetvl_e32m4(numSamples - k);
+        best = __riscv_vfmv_v_f_f32m4(-INFINITY, vl);
+        cls = __riscv_vmv_v_x_u32m4(0, vl);
+        for (c = 0; c < B->numberOfClasses; c++) {
+            pTheta = B->theta + c * dim;
+            pInv = B->invVar + c * dim;
+            acc = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            for (j = 0; j < dim; j++) {
+                x = __riscv_vfsub_vf_f32m4(__riscv_vlse32_v_f32m4(pIn + (size_t)k * dim + j, stride, vl), pTheta[j], vl);
+                acc = __riscv_vfmacc_vv_f32m4(acc, __riscv_vfmul_vf_f32m4(x, pInv[j], vl), x, vl);
+            }
+            acc = __riscv_vfadd_vf_f32m4(__riscv_vfmul_vf_f32m4(acc, -0.5f, vl), B->logConst[c], vl);
+            gt = __riscv_vmfgt_vv_f32m4_b8(acc, best, vl);
+            best = __riscv_vmerge_vvm_f32m4(best, acc, gt, vl);
+            cls = __riscv_vmerge_vxm_u32m4(cls, c, gt, vl);
+        }
+        __riscv_vse32_v_u32m4(pResult + k, cls, vl);
+    }
+#else
+    const float32_t *pX;
+    float32_t acc, d, best;
+
+    for (k = 0; k < numSamples; k++) {
+        pX = pIn + (size_t)k * dim;
+        best = -INFINITY;
+        pResult[k] = 0;
+        for (c = 0; c < B->numberOfClasses; c++) {
+            pTheta = B->theta + c * dim;
+            pInv = B->invVar + c * dim;
+            acc = 0.0f;
+            for (j = 0; j < dim; j++) {
+                d = pX[j] - pTheta[j];
+                acc += d * d * pInv[j];
+            }
+            acc = B->logConst[c] - 0.5f * acc;
+            if (acc > best) {
+                best = acc;
+                pResult[k] = c;
+            }
+        }
+    }
+#endif /* defined(RISCV_VEC_CLS_VECTORF) */
+}
+
+#ifdef   __cplusplus
+}
+#endif
+
+#endif /* _RISCV_VEC_CLASSIFIER_H_ */
@@ -0,0 +1,552 @@
+/******************************************************************************
+ * @file     riscv_vec_controller.h
+ * @brief    Private header file for NMSIS DSP Library
+ * @version  V1.10.0
+ * @date     08 July 2021
+ ******************************************************************************/
+/*
+ * Copyright (c) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _RISCV_VEC_CONTROLLER_H_
+#define _RISCV_VEC_CONTROLLER_H_
+
+#include "riscv_math.h"
+
+#ifdef   __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Batch controllers, one call for all axes of a control period
+ *
+ * The PID instances of a batch are a structure of arrays, each gain and each state is a
+ * plane of numInst values, so lane i of a vector is instance i:
+ *   pCoefs:  A0[numInst], A1[numInst], A2[numInst]
+ *   pState:  x[n-1][numInst], x[n-2][numInst], y[n-1][numInst]
+ * The Clarke and Park transforms take one array per coordinate with one value per axis, the
+ * sin and cos of riscv_park_batch_q31() can come from riscv_sin_cos_array_q31().
+ *
+ * The q31 and q15 kernels give the same bits as riscv_pid_q31(), riscv_pid_q15() without
+ * the P extension, riscv_clarke_q31() and the others, which keep 64 bit products, so RVV
+ * runs them when the vector unit has 64 bit elements, other cores call the single sample
+ * functions per axis. RVV runs the f32 kernels by fused multiply add, which can differ from
+ * the single sample functions in the last bit. Each kernel has no branch on the data, so its
+ * cycles only depend on the number of instances.
+ */
+
+#if defined(RISCV_MATH_VECTOR) && defined(__riscv_v_elen) && (__riscv_v_elen >= 64)
+#define RISCV_VEC_CTL_VECTOR64          1
+#endif
+#if defined(RISCV_MATH_VECTOR) && defined(__riscv_v_elen_fp) && (__riscv_v_elen_fp >= 32)
+#define RISCV_VEC_CTL_VECTORF           1
+#endif
+
+/* ---------------------------------------- PID ---------------------------------------- */
+
+typedef struct
+{
+    uint32_t numInst;               /**< number of PID instances */
+    float32_t *pCoefs;              /**< 3 * numInst derived gains */
+    float32_t *pState;              /**< 3 * numInst states */
+} riscv_pid_batch_instance_f32;
+
+typedef struct
+{
+    uint32_t numInst;               /**< number of PID instances */
+    q31_t *pCoefs;                  /**< 3 * numInst derived gains */
+    q31_t *pState;                  /**< 3 * numInst states */
+} riscv_pid_batch_instance_q31;
+
+typedef struct
+{
+    uint32_t numInst;               /**< number of PID instances */
+    q15_t *pCoefs;                  /**< 3 * numInst derived gains */
+    q15_t *pState;                  /**< 3 * numInst states */
+} riscv_pid_batch_instance_q15;
+
+/* Clear the states of all instances of S */
+__STATIC_INLINE void riscv_pid_batch_reset_f32(riscv_pid_batch_instance_f32 *S)
+{
+    memset(S->pState, 0, 3 * S->numInst * sizeof(float32_t));
+}
+
+__STATIC_INLINE void riscv_pid_batch_reset_q31(riscv_pid_batch_instance_q31 *S)
+{
+    memset(S->pState, 0, 3 * S->numInst * sizeof(q31_t));
+}
+
+__STATIC_INLINE void riscv_pid_batch_reset_q15(riscv_pid_batch_instance_q15 *S)
+{
+    memset(S->pState, 0, 3 * S->numInst * sizeof(q15_t));
+}
+
+/*
+ * Set up S of numInst instances with gains pKp, pKi and pKd of numInst values, the derived
+ * gains are computed as riscv_pid_init_f32() into pCoefs, pState is cleared
+ */
+__STATIC_INLINE void riscv_pid_batch_init_f32(riscv_pid_batch_instance_f32 *S, uint32_t numInst,
+                                              const float32_t *pKp, const float32_t *pKi, const float32_t *pKd,
+                                              float32_t *pCoefs, float32_t *pState)
+{
+    uint32_t i;
+
+    for (i = 0; i < numInst; i++) {
+        pCoefs[i] = pKp[i] + pKi[i] + pKd[i];
+        pCoefs[numInst + i] = -pKp[i] - 2.0f * pKd[i];
+        pCoefs[2 * numInst + i] = pKd[i];
+    }
+    S->numInst = numInst;
+    S->pCoefs = pCoefs;
+    S->pState = pState;
+    riscv_pid_batch_reset_f32(S);
+}
+
+/* riscv_pid_batch_init_f32() of q31 gains, saturated as riscv_pid_init_q31() */
+__STATIC_INLINE void riscv_pid_batch_init_q31(riscv_pid_batch_instance_q31 *S, uint32_t numInst,
+                                              const q31_t *pKp, const q31_t *pKi, const q31_t *pKd,
+                                              q31_t *pCoefs, q31_t *pState)
+{
+    uint32_t i;
+
+    for (i = 0; i < numInst; i++) {
+        pCoefs[i] = __QADD(__QADD(pKp[i], pKi[i]), pKd[i]);
+        pCoefs[numInst + i] = -__QADD(__QADD(pKd[i], pKd[i]), pKp[i]);
+        pCoefs[2 * numInst + i] = pKd[i];
+    }
+    S->numInst = numInst;
+    S->pCoefs = pCoefs;
+    S->pState = pState;
+    riscv_pid_batch_reset_q31(S);
+}
+
+/* riscv_pid_batch_init_f32() of q15 gains, saturated as riscv_pid_init_q15() */
+__STATIC_INLINE void riscv_pid_batch_init_q15(riscv_pid_batch_instance_q15 *S, uint32_t numInst,
+                                              const q15_t *pKp, const q15_t *pKi, const q15_t *pKd,
+                                              q15_t *pCoefs, q15_t *pState)
+{
+    uint32_t i;
+
+    for (i = 0; i < numInst; i++) {
+        pCoefs[i] = (q15_t)__SSAT((q31_t)pKp[i] + pKi[i] + pKd[i], 16);
+        pCoefs[numInst + i] = (q15_t)__SSAT(-((q31_t)pKd[i] + pKd[i] + pKp[i]), 16);
+        pCoefs[2 * numInst + i] = pKd[i];
+    }
+    S->numInst = numInst;
+    S->pCoefs = pCoefs;
+    S->pState = pState;
+    riscv_pid_batch_reset_q15(S);
+}
+
+/**
+ * @brief  Run all PID instances of S for one sample each
+ * @param[in,out] S     batch of PID instances
+ * @param[in]     pIn   S->numInst inputs, pIn[i] of instance i
+ * @param[out]    pOut  S->numInst outputs, can be pIn
+ */
+__STATIC_INLINE void riscv_pid_batch_f32(const riscv_pid_batch_instance_f32 *S, const float32_t *pIn,
+                                         float32_t *pOut)
+{
+    uint32_t n = S->numInst, i;
+    const float32_t *pA0 = S->pCoefs, *pA1 = pA0 + n, *pA2 = pA1 + n;
+    float32_t *pX1 = S->pState, *pX2 = pX1 + n, *pY1 = pX2 + n;
+
+#if defined(RISCV_VEC_CTL_VECTORF)
+    size_t vl;
+    vfloat32m4_t in, x1, out;
+
+    for (i = 0; i < n; i += vl) {
+        vl = __riscv_vsetvl_e32m4(n - i);
+        in = __riscv_vle32_v_f32m4(pIn + i, vl);
+        x1 = __riscv_vle32_v_f32m4(pX1 + i, vl);
+        out = __riscv_vfmul_vv_f32m4(__riscv_vle32_v_f32m4(pA0 + i, vl), in, vl);
+        out = __riscv_vfmacc_vv_f32m4(out, __riscv_vle32_v_f32m4(pA1 + i, vl), x1, vl);
+        out = __riscv_vfmacc_vv_f32m4(out, __riscv_vle32_v_f32m4(pA2 + i, vl), __riscv_vle32_v_f32m4(pX2 + i, vl), vl);
+        out = __riscv_vfadd_vv_f32m4(out, __riscv_vle32_v_f32m4(pY1 + i, vl), vl);
+        __riscv_vse32_v_f32m4(pX2 + i, x1, vl);
+        __riscv_vse32_v_f32m4(pX1 + i, in, vl);
+        __riscv_vse32_v_f32m4(pY1 + i, out, vl);
+        __riscv_vse32_v_f32m4(pOut + i, out, vl);
+    }
+#else
+    float32_t in, out;
+
+    for (i = 0; i < n; i++) {
+        in = pIn[i];
+        /* y[n] = y[n-1] + A0 * x[n] + A1 * x[n-1] + A2 * x[n-2]  */
+        out = (pA0[i] * in) + (pA1[i] * pX1[i]) + (pA2[i] * pX2[i]) + pY1[i];
+        pX2[i] = pX1[i];
+        pX1[i] = in;
+        pY1[i] = out;
+        pOut[i] = out;
+    }
+#endif /* defined(RISCV_VEC_CTL_VECTORF) */
+}
+
+/* riscv_pid_batch_f32() of q31, each instance as riscv_pid_q31() */
+__STATIC_INLINE void riscv_pid_batch_q31(const riscv_pid_batch_instance_q31 *S, const q31_t *pIn, q31_t *pOut)
+{
+    uint32_t n = S->numInst, i;
+    const q31_t *pA0 = S->pCoefs, *pA1 = pA0 + n, *pA2 = pA1 + n;
+    q31_t *pX1 = S->pState, *pX2 = pX1 + n, *pY1 = pX2 + n;
+
+#if defined(RISCV_VEC_CTL_VECTOR64)
+    size_t vl;
+    vint32m2_t in, x1, out;
+    vint64m4_t acc;
+
+    for (i = 0; i < n; i += vl) {
+        vl = __riscv_vsetvl_e32m2(n - i);
+        in = __riscv_vle32_v_i32m2(pIn + i, vl);
+        x1 = __riscv_vle32_v_i32m2(pX1 + i, vl);
+        acc = __riscv_vwmul_vv_i64m4(__riscv_vle32_v_i32m2(pA0 + i, vl), in, vl);
+        acc = __riscv_vwmacc_vv_i64m4(acc, __riscv_vle32_v_i32m2(pA1 + i, vl), x1, vl);
+        acc = __riscv_vwmacc_vv_i64m4(acc, __riscv_vle32_v_i32m2(pA2 + i, vl), __riscv_vle32_v_i32m2(pX2 + i, vl), vl);
+        // 2.62 accumulator truncated to 1.31, y[n-1] added with wrap around
+        out = __riscv_vadd_vv_i32m2(__riscv_vnsra_wx_i32m2(acc, 31, vl), __riscv_vle32_v_i32m2(pY1 + i, vl), vl);
+        __riscv_vse32_v_i32m2(pX2 + i, x1, vl);
+        __riscv_vse32_v_i32m2(pX1 + i, in, vl);
+        __riscv_vse32_v_i32m2(pY1 + i, out, vl);
+        __riscv_vse32_v_i32m2(pOut + i, out, vl);
+    }
+#else
+    q63_t acc;
+    q31_t in, out;
+
+    for (i = 0; i < n; i++) {
+        in = pIn[i];
+        acc = (q63_t)pA0[i] * in + (q63_t)pA1[i] * pX1[i] + (q63_t)pA2[i] * pX2[i];
+        out = (q31_t)(acc >> 31U) + pY1[i];
+        pX2[i] = pX1[i];
+        pX1[i] = in;
+        pY1[i] = out;
+        pOut[i] = out;
+    }
+#endif /* defined(RISCV_VEC_CTL_VECTOR64) */
+}
+
+/* riscv_pid_batch_f32() of q15, each instance as riscv_pid_q15() */
+__STATIC_INLINE void riscv_pid_batch_q15(const riscv_pid_batch_instance_q15 *S, const q15_t *pIn, q15_t *pOut)
+{
+    uint32_t n = S->numInst, i;
+    const q15_t *pA0 = S->pCoefs, *pA1 = pA0 + n, *pA2 = pA1 + n;
+    q15_t *pX1 = S->pState, *pX2 = pX1 + n, *pY1 = pX2 + n;
+
+#if defined(RISCV_VEC_CTL_VECTOR64)
+    size_t vl;
+    vint16m1_t in, x1, out;
+    vint64m4_t acc;
+
+    for (i = 0; i < n; i += vl) {
+        vl = __riscv_vsetvl_e16m1(n - i);
+        in = __riscv_vle16_v_i16m1(pIn + i, vl);
+        x1 = __riscv_vle16_v_i16m1(pX1 + i, vl);
+        // three 2.30 products and y[n-1] in 34.30 do not fit 32 bits
+        acc = __riscv_vwadd_vv_i64m4(__riscv_vwmul_vv_i32m2(__riscv_vle16_v_i16m1(pA0 + i, vl), in, vl),
+                                     __riscv_vwmul_vv_i32m2(__riscv_vle16_v_i16m1(pA1 + i, vl), x1, vl), vl);
+        acc = __riscv_vwadd_wv_i64m4(acc, __riscv_vwmul_vv_i32m2(__riscv_vle16_v_i16m1(pA2 + i, vl),
+                                                                 __riscv_vle16_v_i16m1(pX2 + i, vl), vl), vl);
+        acc = __riscv_vwadd_wv_i64m4(acc, __riscv_vsll_vx_i32m2(__riscv_vsext_vf2_i32m2(
+                                         __riscv_vle16_v_i16m1(pY1 + i, vl), vl), 15, vl), vl);
+        out = __riscv_vnclip_wx_i16m1(__riscv_vnsra_wx_i32m2(acc, 15, vl), 0, __RISCV_VXRM_RNU, vl);
+        __riscv_vse16_v_i16m1(pX2 + i, x1, vl);
+        __riscv_vse16_v_i16m1(pX1 + i, in, vl);
+        __riscv_vse16_v_i16m1(pY1 + i, out, vl);
+        __riscv_vse16_v_i16m1(pOut + i, out, vl);
+    }
+#else
+    q63_t acc;
+    q15_t in, out;
+
+    for (i = 0; i < n; i++) {
+        in = pIn[i];
+        acc = (q31_t)pA0[i] * in;
+        acc += (q31_t)pA1[i] * pX1[i];
+        acc += (q31_t)pA2[i] * pX2[i];
+        acc += (q31_t)pY1[i] << 15;
+        out = (q15_t)__SSAT((q31_t)(acc >> 15), 16);
+        pX2[i] = pX1[i];
+        pX1[i] = in;
+        pY1[i] = out;
+        pOut[i] = out;
+    }
+#endif /* defined(RISCV_VEC_CTL_VECTOR64) */
+}
+
+/* ------------------------------------ Clarke, Park ------------------------------------ */
+
+/**
+ * @brief  Clarke transform of numAxes axes, as riscv_clarke_f32() of each
+ * @param[in]  pIa       phase a of each axis
+ * @param[in]  pIb       phase b of each axis
+ * @param[out] pIalpha   alpha of each axis
+ * @param[out] pIbeta    beta of each axis
+ * @param[in]  numAxes   number of axes
+ */
+__STATIC_INLINE void riscv_clarke_batch_f32(const float32_t *pIa, const float32_t *pIb, float32_t *pIalpha,
+                                            float32_t *pIbeta, uint32_t numAxes)
+{
+#if defined(RISCV_VEC_CTL_VECTORF)
+    size_t vl;
+    vfloat32m4_t a;
+
+    for (; numAxes > 0; numAxes -= vl) {
+        vl = __riscv_vsetvl_e32m4(numAxes);
+        a = __riscv_vle32_v_f32m4(pIa, vl);
+        __riscv_vse32_v_f32m4(pIbeta, __riscv_vfmacc_vf_f32m4(__riscv_vfmul_vf_f32m4(a, 0.57735026919f, vl),
+                                                              1.15470053838f, __riscv_vle32_v_f32m4(pIb, vl), vl), vl);
+        __riscv_vse32_v_f32m4(pIalpha, a, vl);
+        pIa += vl;
+        pIb += vl;
+        pIalpha += vl;
+        pIbeta += vl;
+    }
+#else
+    for (; numAxes > 0; numAxes--) {
+        riscv_clarke_f32(*pIa++, *pIb++, pIalpha++, pIbeta++);
+    }
+#endif /* defined(RISCV_VEC_CTL_VECTORF) */
+}
+
+/* Inverse Clarke transform of numAxes axes, as riscv_inv_clarke_f32() of each */
+__STATIC_INLINE void riscv_inv_clarke_batch_f32(const float32_t *pIalpha, const float32_t *pIbeta, float32_t *pIa,
+                                                float32_t *pIb, uint32_t numAxes)
+{
+#if defined(RISCV_VEC_CTL_VECTORF)
+    size_t vl;
+    vfloat32m4_t a;
+
+    for (; numAxes > 0; numAxes -= vl) {
+        vl = __riscv_vsetvl_e32m4(numAxes);
+        a = __riscv_vle32_v_f32m4(pIalpha, vl);
+        __riscv_vse32_v_f32m4(pIb, __riscv_vfmacc_vf_f32m4(__riscv_vfmul_vf_f32m4(a, -0.5f, vl),
+                                                           0.8660254039f, __riscv_vle32_v_f32m4(pIbeta, vl), vl), vl);
+        __riscv_vse32_v_f32m4(pIa, a, vl);
+        pIalpha += vl;
+        pIbeta += vl;
+        pIa += vl;
+        pIb += vl;
+    }
+#else
+    for (; numAxes > 0; numAxes--) {
+        riscv_inv_clarke_f32(*pIalpha++, *pIbeta++, pIa++, pIb++);
+    }
+#endif /* defined(RISCV_VEC_CTL_VECTORF) */
+}
+
+/**
+ * @brief  Park transform of numAxes axes, as riscv_park_f32() of each
+ * @param[in]  pIalpha   alpha of each axis
+ * @param[in]  pIbeta    beta of each axis
+ * @param[out] pId       d of each axis
+ * @param[out] pIq       q of each axis
+ * @param[in]  pSinVal   sin of the angle of each axis
+ * @param[in]  pCosVal   cos of the angle of each axis
+ * @param[in]  numAxes   number of axes
+ */
+__STATIC_INLINE void riscv_park_batch_f32(const float32_t *pIalpha, const float32_t *pIbeta, float32_t *pId,
+                                          float32_t *pIq, const float32_t *pSinVal, const float32_t *pCosVal,
+                                          uint32_t numAxes)
+{
+#if defined(RISCV_VEC_CTL_VECTORF)
+    size_t vl;
+    vfloat32m4_t a, b, s, c;
+
+    for (; numAxes > 0; numAxes -= vl) {
+        vl = __riscv_vsetvl_e32m4(numAxes);
+        a = __riscv_vle32_v_f32m4(pIalpha, vl);
+        b = __riscv_vle32_v_f32m4(pIbeta, vl);
+        s = __riscv_vle32_v_f32m4(pSinVal, vl);
+        c = __riscv_vle32_v_f32m4(pCosVal, vl);
+        __riscv_vse32_v_f32m4(pId, __riscv_vfmacc_vv_f32m4(__riscv_vfmul_vv_f32m4(a, c, vl), b, s, vl), vl);
+        __riscv_vse32_v_f32m4(pIq, __riscv_vfnmsac_vv_f32m4(__riscv_vfmul_vv_f32m4(b, c, vl), a, s, vl), vl);
+        pIalpha += vl;
+        pIbeta += vl;
+        pId += vl;
+        pIq += vl;
+        pSinVal += vl;
+        pCosVal += vl;
+    }
+#else
+    for (; numAxes > 0; numAxes--) {
+        riscv_park_f32(*pIalpha++, *pIbeta++, pId++, pIq++, *pSinVal++, *pCosVal++);
+    }
+#endif /* defined(RISCV_VEC_CTL_VECTORF) */
+}
+
+/* Inverse Park transform of numAxes axes, as riscv_inv_park_f32() of each */
+__STATIC_INLINE void riscv_inv_park_batch_f32(const float32_t *pId, const float32_t *pIq, float32_t *pIalpha,
+                                              float32_t *pIbeta, const float32_t *pSinVal, const float32_t *pCosVal,
+                                              uint32_t numAxes)
+{
+#if defined(RISCV_VEC_CTL_VECTORF)
+    size_t vl;
+    vfloat32m4_t d, q, s, c;
+
+    for (; numAxes > 0; numAxes -= vl) {
+        vl = __riscv_vsetvl_e32m4(numAxes);
+        d = __riscv_vle32_v_f32m4(pId, vl);
+        q = __riscv_vle32_v_f32m4(pIq, vl);
+        s = __riscv_vle32_v_f32m4(pSinVal, vl);
+        c = __riscv_vle32_v_f32m4(pCosVal, vl);
+        __riscv_vse32_v_f32m4(pIalpha, __riscv_vfnmsac_vv_f32m4(__riscv_vfmul_vv_f32m4(d, c, vl), q, s, vl), vl);
+        __riscv_vse32_v_f32m4(pIbeta, __riscv_vfmacc_vv_f32m4(__riscv_vfmul_vv_f32m4(q, c, vl), d, s, vl), vl);
+        pId += vl;
+        pIq += vl;
+        pIalpha += vl;
+        pIbeta += vl;
+        pSinVal += vl;
+        pCosVal += vl;
+    }
+#else
+    for (; numAxes > 0; numAxes--) {
+        riscv_inv_park_f32(*pId++, *pIq++, pIalpha++, pIbeta++, *pSinVal++, *pCosVal++);
+    }
+#endif /* defined(RISCV_VEC_CTL_VECTORF) */
+}
+
+#if defined(RISCV_VEC_CTL_VECTOR64)
+/* (a * b) >> shift of 64 bit products, truncated to 32 bits */
+#define RISCV_VEC_CTL_MULSH_VV(a, b, shift, vl)  __riscv_vnsra_wx_i32m2(__riscv_vwmul_vv_i64m4(a, b, vl), shift, vl)
+#define RISCV_VEC_CTL_MULSH_VX(a, b, shift, vl)  __riscv_vnsra_wx_i32m2(__riscv_vwmul_vx_i64m4(a, b, vl), shift, vl)
+#endif
+
+/* Clarke transform of numAxes axes, as riscv_clarke_q31() of each */
+__STATIC_INLINE void riscv_clarke_batch_q31(const q31_t *pIa, const q31_t *pIb, q31_t *pIalpha, q31_t *pIbeta,
+                                            uint32_t numAxes)
+{
+#if defined(RISCV_VEC_CTL_VECTOR64)
+    size_t vl;
+    vint32m2_t a;
+
+    for (; numAxes > 0; numAxes -= vl) {
+        vl = __riscv_vsetvl_e32m2(numAxes);
+        a = __riscv_vle32_v_i32m2(pIa, vl);
+        __riscv_vse32_v_i32m2(pIbeta, __riscv_vsadd_vv_i32m2(RISCV_VEC_CTL_MULSH_VX(a, 0x24F34E8B, 30, vl),
+                                                             RISCV_VEC_CTL_MULSH_VX(__riscv_vle32_v_i32m2(pIb, vl),
+                                                                                    0x49E69D16, 30, vl), vl), vl);
+        __riscv_vse32_v_i32m2(pIalpha, a, vl);
+        pIa += vl;
+        pIb += vl;
+        pIalpha += vl;
+        pIbeta += vl;
+    }
+#else
+    for (; numAxes > 0; numAxes--) {
+        riscv_clarke_q31(*pIa++, *pIb++, pIalpha++, pIbeta++);
+    }
+#endif /* defined(RISCV_VEC_CTL_VECTOR64) */
+}
+
+/* Inverse Clarke transform of numAxes axes, as riscv_inv_clarke_q31() of each */
+__STATIC_INLINE void riscv_inv_clarke_batch_q31(const q31_t *pIalpha, const q31_t *pIbeta, q31_t *pIa, q31_t *pIb,
+                                                uint32_t numAxes)
+{
+#if defined(RISCV_VEC_CTL_VECTOR64)
+    size_t vl;
+    vint32m2_t a;
+
+    for (; numAxes > 0; numAxes -= vl) {
+        vl = __riscv_vsetvl_e32m2(numAxes);
+        a = __riscv_vle32_v_i32m2(pIalpha, vl);
+        __riscv_vse32_v_i32m2(pIb, __riscv_vssub_vv_i32m2(RISCV_VEC_CTL_MULSH_VX(__riscv_vle32_v_i32m2(pIbeta, vl),
+                                                                                 0x6ED9EBA1, 31, vl),
+                                                          RISCV_VEC_CTL_MULSH_VX(a, 0x40000000, 31, vl), vl), vl);
+        __riscv_vse32_v_i32m2(pIa, a, vl);
+        pIalpha += vl;
+        pIbeta += vl;
+        pIa += vl;
+        pIb += vl;
+    }
+#else
+    for (; numAxes > 0; numAxes--) {
+        riscv_inv_clarke_q31(*pIalpha++, *pIbeta++, pIa++, pIb++);
+    }
+#endif /* defined(RISCV_VEC_CTL_VECTOR64) */
+}
+
+/* Park transform of numAxes axes, as riscv_park_q31() of each */
+__STATIC_INLINE void riscv_park_batch_q31(const q31_t *pIalpha, const q31_t *pIbeta, q31_t *pId, q31_t *pIq,
+                                          const q31_t *pSinVal, const q31_t *pCosVal, uint32_t numAxes)
+{
+#if defined(RISCV_VEC_CTL_VECTOR64)
+    size_t vl;
+    vint32m2_t a, b, s, c;
+
+    for (; numAxes > 0; numAxes -= vl) {
+        vl = __riscv_vsetvl_e32m2(numAxes);
+        a = __riscv_vle32_v_i32m2(pIalpha, vl);
+        b = __riscv_vle32_v_i32m2(pIbeta, vl);
+        s = __riscv_vle32_v_i32m2(pSinVal, vl);
+        c = __riscv_vle32_v_i32m2(pCosVal, vl);
+        __riscv_vse32_v_i32m2(pId, __riscv_vsadd_vv_i32m2(RISCV_VEC_CTL_MULSH_VV(a, c, 31, vl),
+                                                          RISCV_VEC_CTL_MULSH_VV(b, s, 31, vl), vl), vl);
+        __riscv_vse32_v_i32m2(pIq, __riscv_vssub_vv_i32m2(RISCV_VEC_CTL_MULSH_VV(b, c, 31, vl),
+                                                          RISCV_VEC_CTL_MULSH_VV(a, s, 31, vl), vl), vl);
+        pIalpha += vl;
+        pIbeta += vl;
+        pId += vl;
+        pIq += vl;
+        pSinVal += vl;
+        pCosVal += vl;
+    }
+#else
+    for (; numAxes > 0; numAxes--) {
+        riscv_park_q31(*pIalpha++, *pIbeta++, pId++, pIq++, *pSinVal++, *pCosVal++);
+    }
+#endif /* defined(RISCV_VEC_CTL_VECTOR64) */
+}
+
+/* Inverse Park transform of numAxes axes, as riscv_inv_park_q31() of each */
+__STATIC_INLINE void riscv_inv_park_batch_q31(const q31_t *pId, const q31_t *pIq, q31_t *pIalpha, q31_t *pIbeta,
+                                              const q31_t *pSinVal, const q31_t *pCosVal, uint32_t numAxes)
+{
+#if defined(RISCV_VEC_CTL_VECTOR64)
+    size_t vl;
+    vint32m2_t d, q, s, c;
+
+    for (; numAxes > 0; numAxes -= vl) {
+        vl = __riscv_vsetvl_e32m2(numAxes);
+        d = __riscv_vle32_v_i32m2(pId, vl);
+        q = __riscv_vle32_v_i32m2(pIq, vl);
+        s = __riscv_vle32_v_i32m2(pSinVal, vl);
+        c = __riscv_vle32_v_i32m2(pCosVal, vl);
+        __riscv_vse32_v_i32m2(pIalpha, __riscv_vssub_vv_i32m2(RISCV_VEC_CTL_MULSH_VV(d, c, 31, vl),
+                                                              RISCV_VEC_CTL_MULSH_VV(q, s, 31, vl), vl), vl);
+        __riscv_vse32_v_i32m2(pIbeta, __riscv_vsadd_vv_i32m2(RISCV_VEC_CTL_MULSH_VV(q, c, 31, vl),
+                                                             RISCV_VEC_CTL_MULSH_VV(d, s, 31, vl), vl), vl);
+        pId += vl;
+        pIq += vl;
+        pIalpha += vl;
+        pIbeta += vl;
+        pSinVal += vl;
+        pCosVal += vl;
+    }
+#else
+    for (; numAxes > 0; numAxes--) {
+        riscv_inv_park_q31(*pId++, *pIq++, pIalpha++, pIbeta++, *pSinVal++, *pCosVal++);
+    }
+#endif /* defined(RISCV_VEC_CTL_VECTOR64) */
+}
+
+#ifdef   __cplusplus
+}
+#endif
+
+#endif /* _RISCV_VEC_CONTROLLER_H_ */
@@ -0,0 +1,301 @@
+/******************************************************************************
+ * @file     riscv_vec_convert.h
+ * @brief    Private header file for NMSIS DSP Library
+ * @version  V1.10.0
+ * @date     08 July 2021
+ ******************************************************************************/
+/*
+ * Copyright (c) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _RISCV_VEC_CONVERT_H_
+#define _RISCV_VEC_CONVERT_H_
+
+#include "riscv_math.h"
+#if defined(RISCV_MATH_DSP)
+#include "riscv_pext_math.h"
+#endif
+
+#ifdef   __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Fused format conversion, one pass for a convert followed by riscv_scale_*(), riscv_offset_*()
+ * and riscv_clip_*()
+ *
+ * - riscv_float_to_q15_scaled(): x * scale + offset to q15, rounded half away from zero
+ * - riscv_q15_to_float_scaled(): q15 x as float times scale plus offset
+ * - riscv_q7_to_q15_scaled(): riscv_q7_to_q15() then riscv_scale_q15() then riscv_offset_q15()
+ * - riscv_float_to_s8_zp(): x / scale + zero point to the s8 of NMSIS NN, rounded half away
+ *   from zero like the quantization of TensorFlow Lite, clamped to the activation range
+ * - riscv_q15_to_s8_zp(): q15 x times a q15 multiplier plus zero point to s8, clamped
+ *
+ * The result is saturated once, after the offset or zero point, where the separate passes
+ * saturate after each of them, so the two differ only when the scaled value is out of range.
+ * Float inputs are scaled by one fused multiply add, and NaN goes to the largest value.
+ *
+ * | function                   | RVV                        | P extension              |
+ * |----------------------------|----------------------------|--------------------------|
+ * | riscv_float_to_q15_scaled  | vfmadd, vfncvt.rtz         | scalar                   |
+ * | riscv_q15_to_float_scaled  | vfwcvt, vfmadd             | scalar                   |
+ * | riscv_q7_to_q15_scaled     | vsext, vwmul, vnclip       | SUNPKD810/832, SMBB16    |
+ * | riscv_float_to_s8_zp       | vfncvt.rtz, vsadd, vmax    | scalar                   |
+ * | riscv_q15_to_s8_zp         | vwmul, vnclip, vncvt       | SMBB16, SMTT16, SMAX16   |
+ *
+ * The float kernels run on RVV when the vector unit has f32, all paths give the same bits.
+ * The shift of the fixed point kernels is in [-16, 15] as for riscv_scale_q15(), and the
+ * zero point and activation range of s8 are in [-128, 127].
+ */
+
+/* round half away from zero and truncate to q15, NaN is 32767 */
+__STATIC_FORCEINLINE q31_t riscv_cv_round_q15(float32_t t)
+{
+    t += copysignf(0.5f, t);
+    if (!(t < 32767.0f)) {
+        return 32767;
+    }
+    if (t <= -32768.0f) {
+        return -32768;
+    }
+    return (q31_t)t;
+}
+
+/* v clamped to [lo, hi] */
+__STATIC_FORCEINLINE q31_t riscv_cv_clamp(q31_t v, q31_t lo, q31_t hi)
+{
+    return (v < lo) ? lo : ((v > hi) ? hi : v);
+}
+
+/**
+ * @brief  Convert float to q15 with scale and offset
+ * @param[in]  pSrc        input vector
+ * @param[in]  scale       scale of each input
+ * @param[in]  offset      added after scaling
+ * @param[out] pDst        output vector, saturated q15 of pSrc * scale + offset
+ * @param[in]  blockSize   number of samples
+ */
+__STATIC_INLINE void riscv_float_to_q15_scaled(const float32_t *pSrc, float32_t scale, float32_t offset,
+                                               q15_t *pDst, uint32_t blockSize)
+{
+    float32_t k = scale * 32768.0f;
+    float32_t b = offset * 32768.0f;
+
+#if defined(RISCV_MATH_VECTOR) && defined(__riscv_v_elen_fp) && (__riscv_v_elen_fp >= 32)
+    size_t vl;
+    vfloat32m4_t t;
+
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e32m4(blockSize);
+        t = __riscv_vfmadd_vf_f32m4(__riscv_vle32_v_f32m4(pSrc, vl), k, __riscv_vfmv_v_f_f32m4(b, vl), vl);
+        t = __riscv_vfadd_vv_f32m4(t, __riscv_vfsgnj_vv_f32m4(__riscv_vfmv_v_f_f32m4(0.5f, vl), t, vl), vl);
+        // narrowing converts saturate, out of range and NaN like riscv_cv_round_q15()
+        __riscv_vse16_v_i16m2(pDst, __riscv_vfncvt_rtz_x_f_w_i16m2(t, vl), vl);
+        pSrc += vl;
+        pDst += vl;
+    }
+#else
+    for (; blockSize > 0; blockSize--) {
+        *pDst++ = (q15_t)riscv_cv_round_q15(fmaf(*pSrc++, k, b));
+    }
+#endif /* defined(RISCV_MATH_VECTOR) && defined(__riscv_v_elen_fp) && (__riscv_v_elen_fp >= 32) */
+}
+
+/**
+ * @brief  Convert q15 to float with scale and offset
+ * @param[in]  pSrc        input vector
+ * @param[in]  scale       scale of each input, 1 for riscv_q15_to_float()
+ * @param[in]  offset      added after scaling
+ * @param[out] pDst        output vector, pSrc / 32768 * scale + offset
+ * @param[in]  blockSize   number of samples
+ */
+__STATIC_INLINE void riscv_q15_to_float_scaled(const q15_t *pSrc, float32_t scale, float32_t offset,
+                                               float32_t *pDst, uint32_t blockSize)
+{
+    float32_t k = scale / 32768.0f;
+
+#if defined(RISCV_MATH_VECTOR) && defined(__riscv_v_elen_fp) && (__riscv_v_elen_fp >= 32)
+    size_t vl;
+    vfloat32m4_t x;
+
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e32m4(blockSize);
+        x = __riscv_vfwcvt_f_x_v_f32m4(__riscv_vle16_v_i16m2(pSrc, vl), vl);
+        __riscv_vse32_v_f32m4(pDst, __riscv_vfmadd_vf_f32m4(x, k, __riscv_vfmv_v_f_f32m4(offset, vl), vl), vl);
+        pSrc += vl;
+        pDst += vl;
+    }
+#else
+    for (; blockSize > 0; blockSize--) {
+        *pDst++ = fmaf((float32_t)*pSrc++, k, offset);
+    }
+#endif /* defined(RISCV_MATH_VECTOR) && defined(__riscv_v_elen_fp) && (__riscv_v_elen_fp >= 32) */
+}
+
+/**
+ * @brief  Convert q7 to q15 with scale and offset
+ * @param[in]  pSrc        input vector
+ * @param[in]  scaleFract  fractional part of scale
+ * @param[in]  shift       bits to shift the scaled q15, in [-16, 15]
+ * @param[in]  offset      added after scaling
+ * @param[out] pDst        output vector, saturated ((pSrc << 8) * scaleFract >> (15 - shift)) + offset
+ * @param[in]  blockSize   number of samples
+ */
+__STATIC_INLINE void riscv_q7_to_q15_scaled(const q7_t *pSrc, q15_t scaleFract, int8_t shift, q15_t offset,
+                                            q15_t *pDst, uint32_t blockSize)
+{
+    int8_t kShift = 15 - shift;
+
+#if defined(RISCV_MATH_VECTOR)
+    size_t vl;
+    vint16m2_t x;
+    vint32m4_t v;
+
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e32m4(blockSize);
+        x = __riscv_vsll_vx_i16m2(__riscv_vsext_vf2_i16m2(__riscv_vle8_v_i8m1(pSrc, vl), vl), 8, vl);
+        v = __riscv_vsra_vx_i32m4(__riscv_vwmul_vx_i32m4(x, scaleFract, vl), kShift, vl);
+        v = __riscv_vadd_vx_i32m4(v, offset, vl);
+        __riscv_vse16_v_i16m2(pDst, __riscv_vnclip_wx_i16m2(v, 0, __RISCV_VXRM_RNU, vl), vl);
+        pSrc += vl;
+        pDst += vl;
+    }
+#else
+#if defined(RISCV_MATH_DSP)
+    unsigned long scale = RISCV_PEXT_DUP16(scaleFract);
+    unsigned long in, lo, hi;
+
+    // bytes widen to halfwords and x << 8 is the exact q15 of riscv_q7_to_q15()
+    for (; blockSize >= 4U; blockSize -= 4U) {
+        in = RISCV_PEXT_LD_Q7X4(pSrc);
+        lo = __RV_SLL16(__RV_SUNPKD810(in), 8);
+        hi = __RV_SLL16(__RV_SUNPKD832(in), 8);
+        RISCV_PEXT_ST_Q15X2(pDst, __RV_PKBB16(__SSAT(((q31_t)__RV_SMTT16(lo, scale) >> kShift) + offset, 16),
+                                              __SSAT(((q31_t)__RV_SMBB16(lo, scale) >> kShift) + offset, 16)));
+        RISCV_PEXT_ST_Q15X2(pDst + 2, __RV_PKBB16(__SSAT(((q31_t)__RV_SMTT16(hi, scale) >> kShift) + offset, 16),
+                                                  __SSAT(((q31_t)__RV_SMBB16(hi, scale) >> kShift) + offset, 16)));
+        pSrc += 4;
+        pDst += 4;
+    }
+#endif /* defined(RISCV_MATH_DSP) */
+    for (; blockSize > 0; blockSize--) {
+        *pDst++ = (q15_t)__SSAT(((((q31_t)*pSrc++ << 8) * scaleFract) >> kShift) + offset, 16);
+    }
+#endif /* defined(RISCV_MATH_VECTOR) */
+}
+
+/**
+ * @brief  Quantize float to s8 with zero point
+ * @param[in]  pSrc        input vector
+ * @param[in]  invScale    1 / quantization scale
+ * @param[in]  zeroPoint   added after rounding
+ * @param[in]  actMin      min of output
+ * @param[in]  actMax      max of output
+ * @param[out] pDst        output vector, round(pSrc * invScale) + zeroPoint clamped to [actMin, actMax]
+ * @param[in]  blockSize   number of samples
+ */
+__STATIC_INLINE void riscv_float_to_s8_zp(const float32_t *pSrc, float32_t invScale, int32_t zeroPoint,
+                                          int32_t actMin, int32_t actMax, q7_t *pDst, uint32_t blockSize)
+{
+#if defined(RISCV_MATH_VECTOR) && defined(__riscv_v_elen_fp) && (__riscv_v_elen_fp >= 32)
+    size_t vl;
+    vfloat32m4_t t;
+    vint16m2_t v;
+
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e32m4(blockSize);
+        t = __riscv_vfmul_vf_f32m4(__riscv_vle32_v_f32m4(pSrc, vl), invScale, vl);
+        t = __riscv_vfadd_vv_f32m4(t, __riscv_vfsgnj_vv_f32m4(__riscv_vfmv_v_f_f32m4(0.5f, vl), t, vl), vl);
+        // a value saturated to q15 is still out of the activation range after the zero point
+        v = __riscv_vsadd_vx_i16m2(__riscv_vfncvt_rtz_x_f_w_i16m2(t, vl), (int16_t)zeroPoint, vl);
+        v = __riscv_vmin_vx_i16m2(__riscv_vmax_vx_i16m2(v, (int16_t)actMin, vl), (int16_t)actMax, vl);
+        __riscv_vse8_v_i8m1(pDst, __riscv_vncvt_x_x_w_i8m1(v, vl), vl);
+        pSrc += vl;
+        pDst += vl;
+    }
+#else
+    for (; blockSize > 0; blockSize--) {
+        *pDst++ = (q7_t)riscv_cv_clamp(riscv_cv_round_q15(*pSrc++ * invScale) + zeroPoint, actMin, actMax);
+    }
+#endif /* defined(RISCV_MATH_VECTOR) && defined(__riscv_v_elen_fp) && (__riscv_v_elen_fp >= 32) */
+}
+
+/**
+ * @brief  Requantize q15 to s8 with zero point
+ * @param[in]  pSrc        input vector
+ * @param[in]  scaleFract  fractional part of scale
+ * @param[in]  shift       bits to shift the scaled value, in [-16, 15]
+ * @param[in]  zeroPoint   added after scaling
+ * @param[in]  actMin      min of output
+ * @param[in]  actMax      max of output
+ * @param[out] pDst        output vector, (pSrc * scaleFract >> (15 - shift)) + zeroPoint clamped to
+ *                         [actMin, actMax]
+ * @param[in]  blockSize   number of samples
+ */
+__STATIC_INLINE void riscv_q15_to_s8_zp(const q15_t *pSrc, q15_t scaleFract, int8_t shift, int32_t zeroPoint,
+                                        int32_t actMin, int32_t actMax, q7_t *pDst, uint32_t blockSize)
+{
+    int8_t kShift = 15 - shift;
+
+#if defined(RISCV_MATH_VECTOR)
+    size_t vl;
+    vint32m4_t v;
+    vint16m2_t y;
+
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e32m4(blockSize);
+        v = __riscv_vwmul_vx_i32m4(__riscv_vle16_v_i16m2(pSrc, vl), scaleFract, vl);
+        v = __riscv_vadd_vx_i32m4(__riscv_vsra_vx_i32m4(v, kShift, vl), zeroPoint, vl);
+        y = __riscv_vnclip_wx_i16m2(v, 0, __RISCV_VXRM_RNU, vl);
+        y = __riscv_vmin_vx_i16m2(__riscv_vmax_vx_i16m2(y, (int16_t)actMin, vl), (int16_t)actMax, vl);
+        __riscv_vse8_v_i8m1(pDst, __riscv_vncvt_x_x_w_i8m1(y, vl), vl);
+        pSrc += vl;
+        pDst += vl;
+    }
+#else
+#if defined(RISCV_MATH_DSP)
+    unsigned long scale = RISCV_PEXT_DUP16(scaleFract);
+    unsigned long lo = RISCV_PEXT_DUP16(actMin), hi = RISCV_PEXT_DUP16(actMax);
+    unsigned long in, out[2];
+    uint32_t i;
+
+    // saturated to q15 first, the activation range inside q7 then makes it the same as one clamp
+    for (; blockSize >= 4U; blockSize -= 4U) {
+        for (i = 0; i < 2U; i++) {
+            in = RISCV_PEXT_LD_Q15X2(pSrc);
+            out[i] = __RV_PKBB16(__SSAT(((q31_t)__RV_SMTT16(in, scale) >> kShift) + zeroPoint, 16),
+                                 __SSAT(((q31_t)__RV_SMBB16(in, scale) >> kShift) + zeroPoint, 16));
+            out[i] = __RV_SMIN16(__RV_SMAX16(out[i], lo), hi);
+            pSrc += 2;
+        }
+        RISCV_PEXT_ST_Q7X4(pDst, riscv_pext_pack_q7x4(out[0], out[1]));
+        pDst += 4;
+    }
+#endif /* defined(RISCV_MATH_DSP) */
+    for (; blockSize > 0; blockSize--) {
+        *pDst++ = (q7_t)riscv_cv_clamp((((q31_t)*pSrc++ * scaleFract) >> kShift) + zeroPoint, actMin, actMax);
+    }
+#endif /* defined(RISCV_MATH_VECTOR) */
+}
+
+#ifdef   __cplusplus
+}
+#endif
+
+#endif /* _RISCV_VEC_CONVERT_H_ */
@@ -0,0 +1,283 @@
+/******************************************************************************
+ * @file     riscv_vec_distance.h
+ * @brief    Private header file for NMSIS DSP Library
+ * @version  V1.10.0
+ * @date     08 July 2021
+ ******************************************************************************/
+/*
+ * Copyright (c) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _RISCV_VEC_DISTANCE_H_
+#define _RISCV_VEC_DISTANCE_H_
+
+#include "riscv_math.h"
+
+#ifdef   __cplusplus
+extern "C"
+{
+#endif
+
+#if defined(RISCV_MATH_VECTOR)
+
+/*
+ * Batch distances and k nearest neighbours
+ *
+ * A query of dim values is compared to count rows of dim values stored one after the other
+ * in pDb. The batch functions write the distance to each row, the knn functions keep only
+ * the k smallest ones while the database streams by, sorted from the nearest, with the row
+ * indexes, so no distance array of count entries is needed.
+ *
+ * Euclidean distances are squared, they sort as riscv_euclidean_distance_f32() does without
+ * a square root per row. Cosine distances are the ones of riscv_cosine_distance_f32(), the
+ * norm of each row is accumulated in the same pass as its dot product. Quantized databases
+ * of q7 or q15 take a quarter or a half of the f32 bandwidth, their squared distances are
+ * exact integers: q7 ones are accumulated in 32 bits, q15 ones need 64 bit elements.
+ */
+
+#define RISCV_VEC_DIST_EUCLIDEAN_SQ     0U      /**< squared euclidean distance */
+#define RISCV_VEC_DIST_COSINE           1U      /**< 1 - cosine similarity */
+
+/* q15 squared distances accumulate products of 32 bits into 64 bit elements */
+#if defined(__riscv_v_elen) && (__riscv_v_elen >= 64)
+#define RISCV_VEC_DIST_VECTOR64         1
+#endif
+
+/*
+ * Insert distance d of row idx in the k sorted nearest ones of pIdx and pDist, filled holds
+ * the entries already there, return the new number of entries
+ */
+__STATIC_INLINE uint32_t riscv_vec_knn_insert_f32(uint32_t *pIdx, float32_t *pDist, uint32_t k, uint32_t filled,
+                                                  uint32_t idx, float32_t d)
+{
+    uint32_t i;
+
+    if ((filled == k) && (d >= pDist[k - 1U])) {
+        return filled;
+    }
+    i = (filled < k) ? filled++ : (k - 1U);
+    for (; (i > 0) && (pDist[i - 1U] > d); i--) {
+        pIdx[i] = pIdx[i - 1U];
+        pDist[i] = pDist[i - 1U];
+    }
+    pIdx[i] = idx;
+    pDist[i] = d;
+    return filled;
+}
+
+/* same as riscv_vec_knn_insert_f32() for integer distances */
+__STATIC_INLINE uint32_t riscv_vec_knn_insert_q63(uint32_t *pIdx, q63_t *pDist, uint32_t k, uint32_t filled,
+                                                  uint32_t idx, q63_t d)
+{
+    uint32_t i;
+
+    if ((filled == k) && (d >= pDist[k - 1U])) {
+        return filled;
+    }
+    i = (filled < k) ? filled++ : (k - 1U);
+    for (; (i > 0) && (pDist[i - 1U] > d); i--) {
+        pIdx[i] = pIdx[i - 1U];
+        pDist[i] = pDist[i - 1U];
+    }
+    pIdx[i] = idx;
+    pDist[i] = d;
+    return filled;
+}
+
+/* ---------------------------------------- f32 ---------------------------------------- */
+
+/* metric distance of query of dim values, its squared norm is qq, to row pRow */
+__STATIC_INLINE float32_t riscv_vec_dist_row_f32(uint32_t metric, const float32_t *pQuery, float32_t qq,
+                                                 const float32_t *pRow, uint32_t dim)
+{
+    size_t vl;
+    vfloat32m4_t q, r;
+    vfloat32m1_t acc = __riscv_vfmv_v_f_f32m1(0.0f, 1), rr = __riscv_vfmv_v_f_f32m1(0.0f, 1);
+    float32_t nr;
+
+    for (; dim > 0; dim -= vl) {
+        vl = __riscv_vsetvl_e32m4(dim);
+        q = __riscv_vle32_v_f32m4(pQuery, vl);
+        r = __riscv_vle32_v_f32m4(pRow, vl);
+        if (metric == RISCV_VEC_DIST_EUCLIDEAN_SQ) {
+            q = __riscv_vfsub_vv_f32m4(q, r, vl);
+            acc = __riscv_vfredusum_vs_f32m4_f32m1(__riscv_vfmul_vv_f32m4(q, q, vl), acc, vl);
+        } else {
+            acc = __riscv_vfredusum_vs_f32m4_f32m1(__riscv_vfmul_vv_f32m4(q, r, vl), acc, vl);
+            rr = __riscv_vfredusum_vs_f32m4_f32m1(__riscv_vfmul_vv_f32m4(r, r, vl), rr, vl);
+        }
+        pQuery += vl;
+        pRow += vl;
+    }
+    if (metric == RISCV_VEC_DIST_EUCLIDEAN_SQ) {
+        return __riscv_vfmv_f_s_f32m1_f32(acc);
+    }
+    nr = __riscv_vfmv_f_s_f32m1_f32(rr);
+    return 1.0f - __riscv_vfmv_f_s_f32m1_f32(acc) / (sqrtf(qq) * sqrtf(nr));
+}
+
+/* squared norm of dim values of p, needed once per query by cosine distances */
+__STATIC_INLINE float32_t riscv_vec_dist_norm_sq_f32(const float32_t *p, uint32_t dim)
+{
+    size_t vl;
+    vfloat32m4_t v;
+    vfloat32m1_t acc = __riscv_vfmv_v_f_f32m1(0.0f, 1);
+
+    for (; dim > 0; dim -= vl) {
+        vl = __riscv_vsetvl_e32m4(dim);
+        v = __riscv_vle32_v_f32m4(p, vl);
+        acc = __riscv_vfredusum_vs_f32m4_f32m1(__riscv_vfmul_vv_f32m4(v, v, vl), acc, vl);
+        p += vl;
+    }
+    return __riscv_vfmv_f_s_f32m1_f32(acc);
+}
+
+/* pDist[i] = metric distance of pQuery to row i of pDb, count rows of dim values */
+__STATIC_INLINE void riscv_vec_dist_batch_f32(uint32_t metric, const float32_t *pQuery, const float32_t *pDb,
+                                              uint32_t dim, uint32_t count, float32_t *pDist)
+{
+    float32_t qq = (metric == RISCV_VEC_DIST_COSINE) ? riscv_vec_dist_norm_sq_f32(pQuery, dim) : 0.0f;
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        pDist[i] = riscv_vec_dist_row_f32(metric, pQuery, qq, pDb + i * dim, dim);
+    }
+}
+
+/*
+ * k rows of pDb nearest to pQuery by metric, their indexes to pIdx and distances to pDist
+ * from the nearest, return the number found, less than k if count is smaller
+ */
+__STATIC_INLINE uint32_t riscv_vec_knn_f32(uint32_t metric, const float32_t *pQuery, const float32_t *pDb,
+                                           uint32_t dim, uint32_t count, uint32_t k, uint32_t *pIdx,
+                                           float32_t *pDist)
+{
+    float32_t qq = (metric == RISCV_VEC_DIST_COSINE) ? riscv_vec_dist_norm_sq_f32(pQuery, dim) : 0.0f;
+    uint32_t i, filled = 0;
+
+    if (k == 0U) {
+        return 0;
+    }
+    for (i = 0; i < count; i++) {
+        filled = riscv_vec_knn_insert_f32(pIdx, pDist, k, filled, i,
+                                          riscv_vec_dist_row_f32(metric, pQuery, qq, pDb + i * dim, dim));
+    }
+    return filled;
+}
+
+/* ---------------------------------------- q7 ---------------------------------------- */
+
+/* squared euclidean distance of q7 query to q7 row, differences are 16 bits, squares 32 */
+__STATIC_INLINE q31_t riscv_vec_dist_row_q7(const q7_t *pQuery, const q7_t *pRow, uint32_t dim)
+{
+    size_t vl;
+    vint16m2_t d;
+    vint32m1_t acc = __riscv_vmv_v_x_i32m1(0, 1);
+
+    for (; dim > 0; dim -= vl) {
+        vl = __riscv_vsetvl_e8m1(dim);
+        d = __riscv_vwsub_vv_i16m2(__riscv_vle8_v_i8m1(pQuery, vl), __riscv_vle8_v_i8m1(pRow, vl), vl);
+        acc = __riscv_vredsum_vs_i32m4_i32m1(__riscv_vwmul_vv_i32m4(d, d, vl), acc, vl);
+        pQuery += vl;
+        pRow += vl;
+    }
+    return __riscv_vmv_x_s_i32m1_i32(acc);
+}
+
+/* pDist[i] = squared euclidean distance of pQuery to row i of pDb, count rows of dim q7 */
+__STATIC_INLINE void riscv_vec_dist_batch_q7(const q7_t *pQuery, const q7_t *pDb, uint32_t dim, uint32_t count,
+                                             q31_t *pDist)
+{
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        pDist[i] = riscv_vec_dist_row_q7(pQuery, pDb + i * dim, dim);
+    }
+}
+
+/* same as riscv_vec_knn_f32() with squared euclidean distances of q7 rows */
+__STATIC_INLINE uint32_t riscv_vec_knn_q7(const q7_t *pQuery, const q7_t *pDb, uint32_t dim, uint32_t count,
+                                          uint32_t k, uint32_t *pIdx, q63_t *pDist)
+{
+    uint32_t i, filled = 0;
+
+    if (k == 0U) {
+        return 0;
+    }
+    for (i = 0; i < count; i++) {
+        filled = riscv_vec_knn_insert_q63(pIdx, pDist, k, filled, i, riscv_vec_dist_row_q7(pQuery, pDb + i * dim, dim));
+    }
+    return filled;
+}
+
+/* ---------------------------------------- q15 ---------------------------------------- */
+
+#if defined(RISCV_VEC_DIST_VECTOR64)
+
+/* squared euclidean distance of q15 query to q15 row, differences are 32 bits, squares 64 */
+__STATIC_INLINE q63_t riscv_vec_dist_row_q15(const q15_t *pQuery, const q15_t *pRow, uint32_t dim)
+{
+    size_t vl;
+    vint32m4_t d;
+    vint64m1_t acc = __riscv_vmv_v_x_i64m1(0, 1);
+
+    for (; dim > 0; dim -= vl) {
+        vl = __riscv_vsetvl_e16m2(dim);
+        d = __riscv_vwsub_vv_i32m4(__riscv_vle16_v_i16m2(pQuery, vl), __riscv_vle16_v_i16m2(pRow, vl), vl);
+        acc = __riscv_vredsum_vs_i64m8_i64m1(__riscv_vwmul_vv_i64m8(d, d, vl), acc, vl);
+        pQuery += vl;
+        pRow += vl;
+    }
+    return __riscv_vmv_x_s_i64m1_i64(acc);
+}
+
+/* pDist[i] = squared euclidean distance of pQuery to row i of pDb, count rows of dim q15 */
+__STATIC_INLINE void riscv_vec_dist_batch_q15(const q15_t *pQuery, const q15_t *pDb, uint32_t dim, uint32_t count,
+                                              q63_t *pDist)
+{
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        pDist[i] = riscv_vec_dist_row_q15(pQuery, pDb + i * dim, dim);
+    }
+}
+
+/* same as riscv_vec_knn_f32() with squared euclidean distances of q15 rows */
+__STATIC_INLINE uint32_t riscv_vec_knn_q15(const q15_t *pQuery, const q15_t *pDb, uint32_t dim, uint32_t count,
+                                           uint32_t k, uint32_t *pIdx, q63_t *pDist)
+{
+    uint32_t i, filled = 0;
+
+    if (k == 0U) {
+        return 0;
+    }
+    for (i = 0; i < count; i++) {
+        filled = riscv_vec_knn_insert_q63(pIdx, pDist, k, filled, i, riscv_vec_dist_row_q15(pQuery, pDb + i * dim, dim));
+    }
+    return filled;
+}
+
+#endif /* defined(RISCV_VEC_DIST_VECTOR64) */
+
+#endif /* defined(RISCV_MATH_VECTOR) */
+
+#ifdef   __cplusplus
+}
+#endif
+
+#endif /* _RISCV_VEC_DISTANCE_H_ */
@@ -0,0 +1,238 @@
+/******************************************************************************
+ * @file     riscv_vec_f16.h
+ * @brief    Private header file for NMSIS DSP Library
+ * @version  V1.10.0
+ * @date     08 July 2021
+ ******************************************************************************/
+/*
+ * Copyright (c) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _RISCV_VEC_F16_H_
+#define _RISCV_VEC_F16_H_
+
+#include "riscv_math.h"
+#include "riscv_math_f16.h"
+
+#ifdef   __cplusplus
+extern "C"
+{
+#endif
+
+#if defined(RISCV_MATH_VECTOR) && defined(RISCV_FLOAT16_SUPPORTED) && defined(__riscv_zvfh)
+
+/*
+ * Zvfh kernels of the _f16 API
+ *
+ * Each riscv_vec_<name>_f16() has the arguments and the result of riscv_<name>_f16(). Element
+ * wise functions run on 16 bit lanes, twice as many per vector as f32. Sums of products,
+ * dot products and FIR, widen the products to f32 by vfwmacc and round to f16 once at the
+ * end, so their error does not grow with the length as an f16 accumulator would, at the
+ * cost of f32m8 accumulators.
+ */
+
+/* pDst = pSrcA + pSrcB */
+__STATIC_INLINE void riscv_vec_add_f16(const float16_t *pSrcA, const float16_t *pSrcB, float16_t *pDst,
+                                       uint32_t blockSize)
+{
+    size_t vl;
+
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e16m4(blockSize);
+        __riscv_vse16_v_f16m4(pDst, __riscv_vfadd_vv_f16m4(__riscv_vle16_v_f16m4(pSrcA, vl),
+                                                           __riscv_vle16_v_f16m4(pSrcB, vl), vl), vl);
+        pSrcA += vl;
+        pSrcB += vl;
+        pDst += vl;
+    }
+}
+
+/* pDst = pSrcA - pSrcB */
+__STATIC_INLINE void riscv_vec_sub_f16(const float16_t *pSrcA, const float16_t *pSrcB, float16_t *pDst,
+                                       uint32_t blockSize)
+{
+    size_t vl;
+
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e16m4(blockSize);
+        __riscv_vse16_v_f16m4(pDst, __riscv_vfsub_vv_f16m4(__riscv_vle16_v_f16m4(pSrcA, vl),
+                                                           __riscv_vle16_v_f16m4(pSrcB, vl), vl), vl);
+        pSrcA += vl;
+        pSrcB += vl;
+        pDst += vl;
+    }
+}
+
+/* pDst = pSrcA * pSrcB */
+__STATIC_INLINE void riscv_vec_mult_f16(const float16_t *pSrcA, const float16_t *pSrcB, float16_t *pDst,
+                                        uint32_t blockSize)
+{
+    size_t vl;
+
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e16m4(blockSize);
+        __riscv_vse16_v_f16m4(pDst, __riscv_vfmul_vv_f16m4(__riscv_vle16_v_f16m4(pSrcA, vl),
+                                                           __riscv_vle16_v_f16m4(pSrcB, vl), vl), vl);
+        pSrcA += vl;
+        pSrcB += vl;
+        pDst += vl;
+    }
+}
+
+/* pDst = pSrc * scale */
+__STATIC_INLINE void riscv_vec_scale_f16(const float16_t *pSrc, float16_t scale, float16_t *pDst, uint32_t blockSize)
+{
+    size_t vl;
+
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e16m4(blockSize);
+        __riscv_vse16_v_f16m4(pDst, __riscv_vfmul_vf_f16m4(__riscv_vle16_v_f16m4(pSrc, vl), scale, vl), vl);
+        pSrc += vl;
+        pDst += vl;
+    }
+}
+
+/* pDst = pSrc + offset */
+__STATIC_INLINE void riscv_vec_offset_f16(const float16_t *pSrc, float16_t offset, float16_t *pDst, uint32_t blockSize)
+{
+    size_t vl;
+
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e16m4(blockSize);
+        __riscv_vse16_v_f16m4(pDst, __riscv_vfadd_vf_f16m4(__riscv_vle16_v_f16m4(pSrc, vl), offset, vl), vl);
+        pSrc += vl;
+        pDst += vl;
+    }
+}
+
+/* pDst = |pSrc| */
+__STATIC_INLINE void riscv_vec_abs_f16(const float16_t *pSrc, float16_t *pDst, uint32_t blockSize)
+{
+    size_t vl;
+
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e16m4(blockSize);
+        __riscv_vse16_v_f16m4(pDst, __riscv_vfabs_v_f16m4(__riscv_vle16_v_f16m4(pSrc, vl), vl), vl);
+        pSrc += vl;
+        pDst += vl;
+    }
+}
+
+/* pDst = -pSrc */
+__STATIC_INLINE void riscv_vec_negate_f16(const float16_t *pSrc, float16_t *pDst, uint32_t blockSize)
+{
+    size_t vl;
+
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e16m4(blockSize);
+        __riscv_vse16_v_f16m4(pDst, __riscv_vfneg_v_f16m4(__riscv_vle16_v_f16m4(pSrc, vl), vl), vl);
+        pSrc += vl;
+        pDst += vl;
+    }
+}
+
+/* *result = sum of pSrcA * pSrcB, accumulated in f32 */
+__STATIC_INLINE void riscv_vec_dot_prod_f16(const float16_t *pSrcA, const float16_t *pSrcB, uint32_t blockSize,
+                                            float16_t *result)
+{
+    size_t vlmax = __riscv_vsetvlmax_e32m8(), vl;
+    vfloat32m8_t acc = __riscv_vfmv_v_f_f32m8(0.0f, vlmax);
+
+    // tail undisturbed, lanes beyond the last vl keep their partial sums
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e16m4(blockSize);
+        acc = __riscv_vfwmacc_vv_f32m8_tu(acc, __riscv_vle16_v_f16m4(pSrcA, vl), __riscv_vle16_v_f16m4(pSrcB, vl), vl);
+        pSrcA += vl;
+        pSrcB += vl;
+    }
+    *result = (float16_t)__riscv_vfmv_f_s_f32m1_f32(
+        __riscv_vfredusum_vs_f32m8_f32m1(acc, __riscv_vfmv_v_f_f32m1(0.0f, 1), vlmax));
+}
+
+/* pDst = pSrcA * pSrcB of numSamples complex samples */
+__STATIC_INLINE void riscv_vec_cmplx_mult_cmplx_f16(const float16_t *pSrcA, const float16_t *pSrcB, float16_t *pDst,
+                                                    uint32_t numSamples)
+{
+    size_t vl;
+    vfloat16m4_t ar, ai, br, bi, yr, yi;
+
+    for (; numSamples > 0; numSamples -= vl) {
+        vl = __riscv_vsetvl_e16m4(numSamples);
+        ar = __riscv_vlse16_v_f16m4(pSrcA, 4, vl);
+        ai = __riscv_vlse16_v_f16m4(pSrcA + 1, 4, vl);
+        br = __riscv_vlse16_v_f16m4(pSrcB, 4, vl);
+        bi = __riscv_vlse16_v_f16m4(pSrcB + 1, 4, vl);
+        yr = __riscv_vfnmsac_vv_f16m4(__riscv_vfmul_vv_f16m4(ar, br, vl), ai, bi, vl);
+        yi = __riscv_vfmacc_vv_f16m4(__riscv_vfmul_vv_f16m4(ar, bi, vl), ai, br, vl);
+        __riscv_vsse16_v_f16m4(pDst, 4, yr, vl);
+        __riscv_vsse16_v_f16m4(pDst + 1, 4, yi, vl);
+        pSrcA += 2 * vl;
+        pSrcB += 2 * vl;
+        pDst += 2 * vl;
+    }
+}
+
+/* pDst = |pSrc| ^ 2 of numSamples complex samples */
+__STATIC_INLINE void riscv_vec_cmplx_mag_squared_f16(const float16_t *pSrc, float16_t *pDst, uint32_t numSamples)
+{
+    size_t vl;
+    vfloat16m4_t re, im;
+
+    for (; numSamples > 0; numSamples -= vl) {
+        vl = __riscv_vsetvl_e16m4(numSamples);
+        re = __riscv_vlse16_v_f16m4(pSrc, 4, vl);
+        im = __riscv_vlse16_v_f16m4(pSrc + 1, 4, vl);
+        __riscv_vse16_v_f16m4(pDst, __riscv_vfmacc_vv_f16m4(__riscv_vfmul_vv_f16m4(re, re, vl), im, im, vl), vl);
+        pSrc += 2 * vl;
+        pDst += vl;
+    }
+}
+
+/*
+ * Same as riscv_fir_f16() on S set up by riscv_fir_init_f16(), the lanes are output samples,
+ * each tap adds coefficient times the state shifted by the tap, accumulated in f32
+ */
+__STATIC_INLINE void riscv_vec_fir_f16(const riscv_fir_instance_f16 *S, const float16_t *pSrc, float16_t *pDst,
+                                       uint32_t blockSize)
+{
+    uint32_t numTaps = S->numTaps, n, k;
+    float16_t *pState = S->pState;
+    const float16_t *pCoeffs = S->pCoeffs, *px;
+    size_t vl;
+    vfloat32m8_t acc;
+
+    memcpy(pState + numTaps - 1U, pSrc, blockSize * sizeof(float16_t));
+    for (n = 0; n < blockSize; n += vl) {
+        vl = __riscv_vsetvl_e16m4(blockSize - n);
+        px = pState + n;
+        acc = __riscv_vfwmul_vf_f32m8(__riscv_vle16_v_f16m4(px, vl), pCoeffs[0], vl);
+        for (k = 1; k < numTaps; k++) {
+            acc = __riscv_vfwmacc_vf_f32m8(acc, pCoeffs[k], __riscv_vle16_v_f16m4(px + k, vl), vl);
+        }
+        __riscv_vse16_v_f16m4(pDst + n, __riscv_vfncvt_f_f_w_f16m4(acc, vl), vl);
+    }
+    memmove(pState, pState + blockSize, (numTaps - 1U) * sizeof(float16_t));
+}
+
+#endif /* defined(RISCV_MATH_VECTOR) && defined(RISCV_FLOAT16_SUPPORTED) && defined(__riscv_zvfh) */
+
+#ifdef   __cplusplus
+}
+#endif
+
+#endif /* _RISCV_VEC_F16_H_ */
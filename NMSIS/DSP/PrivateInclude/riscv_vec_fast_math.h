@@ -0,0 +1,331 @@
+/******************************************************************************
+ * @file     riscv_vec_fast_math.h
+ * @brief    Private header file for NMSIS DSP Library
+ * @version  V1.10.0
+ * @date     08 July 2021
+ ******************************************************************************/
+/*
+ * Copyright (c) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _RISCV_VEC_FAST_MATH_H_
+#define _RISCV_VEC_FAST_MATH_H_
+
+#include "riscv_math.h"
+
+#ifdef   __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Array fast math, one call for a batch of samples, eg. all axes of a control loop
+ *
+ * - riscv_sin_cos_array_q31(): theta scaled like riscv_sin_cos_q31(), [-1, 1) is [-180, 180)
+ *   degrees, the angle folds to [-90, 90] degrees and sin(pi * u) is u times a degree 5
+ *   minimax polynomial of 4 * u^2 in fixed point, max error 3.7e-9 (8 LSB of q31), the cos
+ *   is the sin of theta + 90 degrees
+ * - riscv_vatan2_f32(): the ratio of the smaller to the larger of |y| and |x| in [0, 1] and
+ *   a degree 15 odd minimax polynomial of it, then the octant from the signs and the
+ *   order of |y| and |x|, max error 3e-7 radian for finite y and x, most of it the f32
+ *   rounding of angles near pi, 0 for y and x both zero, and -0 of x is taken as +0
+ * - riscv_vsqrt_q15(): sqrt of q15 rounded down, exact, 0 for negative inputs, each is
+ *   one f32 sqrt of the input in q30 corrected by one integer compare
+ * - riscv_fm_vexp_f32m4(): exp of a vector for other kernels, x = n * ln2 + r with
+ *   |r| <= ln2 / 2, the degree 7 polynomial of exp(r) of cephes times 2^n built in the
+ *   exponent bits, max relative error 2 ulp, inputs above 88 give exp(88) and below -87.3
+ *   give 0
+ *
+ * RVV runs the q31 polynomial by vsmul and the f32 ones when the vector unit has f32,
+ * other cores run the same arithmetic per sample, so riscv_sin_cos_array_q31() and
+ * riscv_vsqrt_q15() give the same bits on both. The q31 polynomial is a chain of 32x32
+ * products, which the 16 and 8 bit lanes of the P extension do not speed up.
+ */
+
+/* degree 5 minimax of sin(pi * u) / u in v = 4 * u^2, q29 */
+#define RISCV_FM_SIN_C0         1686629713
+#define RISCV_FM_SIN_C1         (-693598663)
+#define RISCV_FM_SIN_C2         85569263
+#define RISCV_FM_SIN_C3         (-5026849)
+#define RISCV_FM_SIN_C4         172030
+#define RISCV_FM_SIN_C5         (-3669)
+
+/* degree 7 minimax of atan(a) / a in s = a^2 */
+#define RISCV_FM_ATAN_C0        9.999993339e-01f
+#define RISCV_FM_ATAN_C1        (-3.332985466e-01f)
+#define RISCV_FM_ATAN_C2        1.994650019e-01f
+#define RISCV_FM_ATAN_C3        (-1.390832035e-01f)
+#define RISCV_FM_ATAN_C4        9.641446374e-02f
+#define RISCV_FM_ATAN_C5        (-5.590254789e-02f)
+#define RISCV_FM_ATAN_C6        2.185646723e-02f
+#define RISCV_FM_ATAN_C7        (-4.052842798e-03f)
+
+#define RISCV_FM_PI_F32         3.14159265f
+#define RISCV_FM_PI_2_F32       1.57079633f
+
+/* exp(r) = 1 + r + r^2 * (C0 + C1 * r + ... + C5 * r^5) of cephes expf */
+#define RISCV_FM_EXP_C0         5.0000001201e-01f
+#define RISCV_FM_EXP_C1         1.6666665459e-01f
+#define RISCV_FM_EXP_C2         4.1665795894e-02f
+#define RISCV_FM_EXP_C3         8.3334519073e-03f
+#define RISCV_FM_EXP_C4         1.3981999507e-03f
+#define RISCV_FM_EXP_C5         1.9875691500e-04f
+#define RISCV_FM_EXP_MAX        88.0f
+#define RISCV_FM_EXP_MIN        (-87.33654475f)
+#define RISCV_FM_LOG2E_F32      1.44269504f
+/* ln2 split so n * ln2 is exact for the n of exp */
+#define RISCV_FM_LN2_HI         0.693359375f
+#define RISCV_FM_LN2_LO         (-2.12194440e-4f)
+
+/* q31 product rounded to nearest, vsmul with vxrm RNU, the operands are never both INT32_MIN */
+__STATIC_FORCEINLINE q31_t riscv_fm_smul_q31(q31_t a, q31_t b)
+{
+    return (q31_t)(((((q63_t)a * b) >> 30) + 1) >> 1);
+}
+
+/* t within [-0.5, 0.5] with the same sin, 1 - t and -1 - t are both INT32_MIN - t modulo 2^32 */
+__STATIC_FORCEINLINE q31_t riscv_fm_fold_q31(q31_t t)
+{
+    return ((t > 0x40000000) || (t < -0x40000000)) ? (q31_t)(0x80000000U - (uint32_t)t) : t;
+}
+
+/* sin(pi * u) for u in [-0.5, 0.5] */
+__STATIC_FORCEINLINE q31_t riscv_fm_sin_pi_q31(q31_t u)
+{
+    q31_t v, acc, r;
+
+    // 4 * u^2 in q31, 1.0 clamps to the largest q31
+    v = riscv_fm_smul_q31(u, u);
+    v = (q31_t)((uint32_t)((v > 0x1FFFFFFF) ? 0x1FFFFFFF : v) << 2);
+    acc = RISCV_FM_SIN_C5;
+    acc = RISCV_FM_SIN_C4 + riscv_fm_smul_q31(acc, v);
+    acc = RISCV_FM_SIN_C3 + riscv_fm_smul_q31(acc, v);
+    acc = RISCV_FM_SIN_C2 + riscv_fm_smul_q31(acc, v);
+    acc = RISCV_FM_SIN_C1 + riscv_fm_smul_q31(acc, v);
+    acc = RISCV_FM_SIN_C0 + riscv_fm_smul_q31(acc, v);
+    // q31 * q29 is q29, saturated to q31
+    r = riscv_fm_smul_q31(u, acc);
+    r = (r > 0x1FFFFFFF) ? 0x1FFFFFFF : ((r < -0x20000000) ? -0x20000000 : r);
+    return (q31_t)((uint32_t)r << 2);
+}
+
+__STATIC_FORCEINLINE float32_t riscv_fm_atan2_f32(float32_t y, float32_t x)
+{
+    float32_t ax = fabsf(x), ay = fabsf(y);
+    float32_t mx = (ay > ax) ? ay : ax, mn = (ay > ax) ? ax : ay;
+    float32_t a = (mx > 0.0f) ? (mn / mx) : 0.0f;
+    float32_t s = a * a, p;
+
+    p = RISCV_FM_ATAN_C7;
+    p = p * s + RISCV_FM_ATAN_C6;
+    p = p * s + RISCV_FM_ATAN_C5;
+    p = p * s + RISCV_FM_ATAN_C4;
+    p = p * s + RISCV_FM_ATAN_C3;
+    p = p * s + RISCV_FM_ATAN_C2;
+    p = p * s + RISCV_FM_ATAN_C1;
+    p = p * s + RISCV_FM_ATAN_C0;
+    p = p * a;
+    p = (ay > ax) ? (RISCV_FM_PI_2_F32 - p) : p;
+    p = (x < 0.0f) ? (RISCV_FM_PI_F32 - p) : p;
+    return copysignf(p, y);
+}
+
+/* floor(sqrt(n)) of n below 2^30 */
+__STATIC_FORCEINLINE q15_t riscv_fm_isqrt_q15(uint32_t n)
+{
+    uint32_t res = 0, bit = 1UL << 28;
+
+    while (bit > n) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (n >= res + bit) {
+            n -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (q15_t)res;
+}
+
+#if defined(RISCV_MATH_VECTOR) && defined(__riscv_v_elen_fp) && (__riscv_v_elen_fp >= 32)
+/* exp of each element of x */
+__STATIC_FORCEINLINE vfloat32m4_t riscv_fm_vexp_f32m4(vfloat32m4_t x, size_t vl)
+{
+    vfloat32m4_t nf, r, p;
+    vint32m4_t n;
+    vbool8_t under = __riscv_vmflt_vf_f32m4_b8(x, RISCV_FM_EXP_MIN, vl);
+
+    x = __riscv_vfmin_vf_f32m4(__riscv_vfmax_vf_f32m4(x, RISCV_FM_EXP_MIN, vl), RISCV_FM_EXP_MAX, vl);
+    // n = round(x / ln2) by the default rounding mode, n in [-126, 127]
+    n = __riscv_vfcvt_x_f_v_i32m4(__riscv_vfmul_vf_f32m4(x, RISCV_FM_LOG2E_F32, vl), vl);
+    nf = __riscv_vfcvt_f_x_v_f32m4(n, vl);
+    r = __riscv_vfnmsac_vf_f32m4(x, RISCV_FM_LN2_HI, nf, vl);
+    r = __riscv_vfnmsac_vf_f32m4(r, RISCV_FM_LN2_LO, nf, vl);
+    p = __riscv_vfmv_v_f_f32m4(RISCV_FM_EXP_C5, vl);
+    p = __riscv_vfmadd_vv_f32m4(p, r, __riscv_vfmv_v_f_f32m4(RISCV_FM_EXP_C4, vl), vl);
+    p = __riscv_vfmadd_vv_f32m4(p, r, __riscv_vfmv_v_f_f32m4(RISCV_FM_EXP_C3, vl), vl);
+    p = __riscv_vfmadd_vv_f32m4(p, r, __riscv_vfmv_v_f_f32m4(RISCV_FM_EXP_C2, vl), vl);
+    p = __riscv_vfmadd_vv_f32m4(p, r, __riscv_vfmv_v_f_f32m4(RISCV_FM_EXP_C1, vl), vl);
+    p = __riscv_vfmadd_vv_f32m4(p, r, __riscv_vfmv_v_f_f32m4(RISCV_FM_EXP_C0, vl), vl);
+    p = __riscv_vfmadd_vv_f32m4(p, __riscv_vfmul_vv_f32m4(r, r, vl), __riscv_vfadd_vf_f32m4(r, 1.0f, vl), vl);
+    // times 2^n, the biased exponent of 2^n is n + 127
+    p = __riscv_vfmul_vv_f32m4(p, __riscv_vreinterpret_v_i32m4_f32m4(
+                                      __riscv_vsll_vx_i32m4(__riscv_vadd_vx_i32m4(n, 127, vl), 23, vl)), vl);
+    return __riscv_vfmerge_vfm_f32m4(p, 0.0f, under, vl);
+}
+#endif /* defined(RISCV_MATH_VECTOR) && defined(__riscv_v_elen_fp) && (__riscv_v_elen_fp >= 32) */
+
+/**
+ * @brief  sin and cos of an array of q31 angles
+ * @param[in]  pTheta      angles, [-1, 1) is [-180, 180) degrees
+ * @param[out] pSinVal     sin of each angle
+ * @param[out] pCosVal     cos of each angle
+ * @param[in]  blockSize   number of angles
+ */
+__STATIC_INLINE void riscv_sin_cos_array_q31(const q31_t *pTheta, q31_t *pSinVal, q31_t *pCosVal, uint32_t blockSize)
+{
+#if defined(RISCV_MATH_VECTOR)
+    size_t vl;
+    vint32m4_t t, u, v, acc;
+    vbool8_t fold;
+    int32_t k;
+    static const int32_t coef[6] = {RISCV_FM_SIN_C0, RISCV_FM_SIN_C1, RISCV_FM_SIN_C2,
+                                    RISCV_FM_SIN_C3, RISCV_FM_SIN_C4, RISCV_FM_SIN_C5};
+
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e32m4(blockSize);
+        t = __riscv_vle32_v_i32m4(pTheta, vl);
+        // sin of theta, then cos as sin of theta + 0.5
+        for (int32_t i = 0; i < 2; i++) {
+            fold = __riscv_vmor_mm_b8(__riscv_vmsgt_vx_i32m4_b8(t, 0x40000000, vl),
+                                      __riscv_vmslt_vx_i32m4_b8(t, -0x40000000, vl), vl);
+            u = __riscv_vmerge_vvm_i32m4(t, __riscv_vrsub_vx_i32m4(t, INT32_MIN, vl), fold, vl);
+            v = __riscv_vsmul_vv_i32m4(u, u, __RISCV_VXRM_RNU, vl);
+            v = __riscv_vsll_vx_i32m4(__riscv_vmin_vx_i32m4(v, 0x1FFFFFFF, vl), 2, vl);
+            acc = __riscv_vmv_v_x_i32m4(coef[5], vl);
+            for (k = 4; k >= 0; k--) {
+                acc = __riscv_vadd_vx_i32m4(__riscv_vsmul_vv_i32m4(acc, v, __RISCV_VXRM_RNU, vl), coef[k], vl);
+            }
+            acc = __riscv_vsmul_vv_i32m4(u, acc, __RISCV_VXRM_RNU, vl);
+            acc = __riscv_vmax_vx_i32m4(__riscv_vmin_vx_i32m4(acc, 0x1FFFFFFF, vl), -0x20000000, vl);
+            __riscv_vse32_v_i32m4((i == 0) ? pSinVal : pCosVal, __riscv_vsll_vx_i32m4(acc, 2, vl), vl);
+            t = __riscv_vadd_vx_i32m4(t, 0x40000000, vl);
+        }
+        pTheta += vl;
+        pSinVal += vl;
+        pCosVal += vl;
+    }
+#else
+    q31_t t;
+
+    for (; blockSize > 0; blockSize--) {
+        t = *pTheta++;
+        *pSinVal++ = riscv_fm_sin_pi_q31(riscv_fm_fold_q31(t));
+        *pCosVal++ = riscv_fm_sin_pi_q31(riscv_fm_fold_q31((q31_t)((uint32_t)t + 0x40000000U)));
+    }
+#endif /* defined(RISCV_MATH_VECTOR) */
+}
+
+/**
+ * @brief  atan2 of arrays of f32
+ * @param[in]  pY          y of each point
+ * @param[in]  pX          x of each point
+ * @param[out] pDst        angle of each point in (-pi, pi]
+ * @param[in]  blockSize   number of points
+ */
+__STATIC_INLINE void riscv_vatan2_f32(const float32_t *pY, const float32_t *pX, float32_t *pDst, uint32_t blockSize)
+{
+#if defined(RISCV_MATH_VECTOR) && defined(__riscv_v_elen_fp) && (__riscv_v_elen_fp >= 32)
+    size_t vl;
+    vfloat32m4_t y, x, ax, ay, a, s, p;
+    vbool8_t swap;
+    int32_t k;
+    static const float32_t coef[8] = {RISCV_FM_ATAN_C0, RISCV_FM_ATAN_C1, RISCV_FM_ATAN_C2, RISCV_FM_ATAN_C3,
+                                      RISCV_FM_ATAN_C4, RISCV_FM_ATAN_C5, RISCV_FM_ATAN_C6, RISCV_FM_ATAN_C7};
+
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e32m4(blockSize);
+        y = __riscv_vle32_v_f32m4(pY, vl);
+        x = __riscv_vle32_v_f32m4(pX, vl);
+        ax = __riscv_vfabs_v_f32m4(x, vl);
+        ay = __riscv_vfabs_v_f32m4(y, vl);
+        swap = __riscv_vmfgt_vv_f32m4_b8(ay, ax, vl);
+        a = __riscv_vfdiv_vv_f32m4(__riscv_vfmin_vv_f32m4(ax, ay, vl), __riscv_vfmax_vv_f32m4(ax, ay, vl), vl);
+        // 0 / 0 of the origin
+        a = __riscv_vfmerge_vfm_f32m4(a, 0.0f, __riscv_vmfeq_vf_f32m4_b8(__riscv_vfmax_vv_f32m4(ax, ay, vl), 0.0f, vl), vl);
+        s = __riscv_vfmul_vv_f32m4(a, a, vl);
+        p = __riscv_vfmv_v_f_f32m4(coef[7], vl);
+        for (k = 6; k >= 0; k--) {
+            p = __riscv_vfmadd_vv_f32m4(p, s, __riscv_vfmv_v_f_f32m4(coef[k], vl), vl);
+        }
+        p = __riscv_vfmul_vv_f32m4(p, a, vl);
+        p = __riscv_vmerge_vvm_f32m4(p, __riscv_vfrsub_vf_f32m4(p, RISCV_FM_PI_2_F32, vl), swap, vl);
+        p = __riscv_vmerge_vvm_f32m4(p, __riscv_vfrsub_vf_f32m4(p, RISCV_FM_PI_F32, vl),
+                                     __riscv_vmflt_vf_f32m4_b8(x, 0.0f, vl), vl);
+        __riscv_vse32_v_f32m4(pDst, __riscv_vfsgnj_vv_f32m4(p, y, vl), vl);
+        pY += vl;
+        pX += vl;
+        pDst += vl;
+    }
+#else
+    for (; blockSize > 0; blockSize--) {
+        *pDst++ = riscv_fm_atan2_f32(*pY++, *pX++);
+    }
+#endif /* defined(RISCV_MATH_VECTOR) && defined(__riscv_v_elen_fp) && (__riscv_v_elen_fp >= 32) */
+}
+
+/**
+ * @brief  sqrt of an array of q15
+ * @param[in]  pIn         inputs
+ * @param[out] pOut        sqrt of each input rounded down, 0 for negative inputs
+ * @param[in]  blockSize   number of inputs
+ */
+__STATIC_INLINE void riscv_vsqrt_q15(const q15_t *pIn, q15_t *pOut, uint32_t blockSize)
+{
+#if defined(RISCV_MATH_VECTOR) && defined(__riscv_v_elen_fp) && (__riscv_v_elen_fp >= 32)
+    size_t vl;
+    vint32m4_t n, r;
+
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e16m2(blockSize);
+        // sqrt(x / 2^15) * 2^15 is sqrt(x * 2^15), exact in f32 below 2^30
+        n = __riscv_vsll_vx_i32m4(__riscv_vsext_vf2_i32m4(__riscv_vmax_vx_i16m2(__riscv_vle16_v_i16m2(pIn, vl), 0, vl),
+                                                          vl), 15, vl);
+        r = __riscv_vfcvt_rtz_x_f_v_i32m4(__riscv_vfsqrt_v_f32m4(__riscv_vfcvt_f_x_v_f32m4(n, vl), vl), vl);
+        // the rounded sqrt can be one above the floor just below a square
+        r = __riscv_vmerge_vvm_i32m4(r, __riscv_vsub_vx_i32m4(r, 1, vl),
+                                     __riscv_vmsgt_vv_i32m4_b8(__riscv_vmul_vv_i32m4(r, r, vl), n, vl), vl);
+        __riscv_vse16_v_i16m2(pOut, __riscv_vncvt_x_x_w_i16m2(r, vl), vl);
+        pIn += vl;
+        pOut += vl;
+    }
+#else
+    for (; blockSize > 0; blockSize--, pIn++) {
+        *pOut++ = (*pIn > 0) ? riscv_fm_isqrt_q15((uint32_t)*pIn << 15) : 0;
+    }
+#endif /* defined(RISCV_MATH_VECTOR) && defined(__riscv_v_elen_fp) && (__riscv_v_elen_fp >= 32) */
+}
+
+#ifdef   __cplusplus
+}
+#endif
+
+#endif /* _RISCV_VEC_FAST_MATH_H_ */
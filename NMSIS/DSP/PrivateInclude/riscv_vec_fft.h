@@ -34,7 +34,1717 @@ extern "C"
 {
 #endif
 
+/*
+ * Window plan
+ *
+ * The coefficients of a window of window_functions.h are generated once into the buffer of
+ * the plan, with a gain folded in, as 1 / sum of the window for amplitude spectra. The real
+ * FFT takes the frame and the plan, riscv_rfft_fast_window_f32() windows the frame in place
+ * before riscv_rfft_fast_f32(), which does not keep its input either, and on RVV
+ * riscv_vec_rfft_window_f32() applies it in the first butterfly stage instead.
+ */
+
+/* window generator of window_functions.h, as riscv_hanning_f32() */
+typedef void (*riscv_window_gen_f32)(float32_t *pDst, uint32_t blockSize);
+
+typedef struct
+{
+    uint32_t winLen;                /**< samples of the window, the FFT length */
+    const float32_t *pCoefs;        /**< winLen coefficients */
+} riscv_window_plan_f32;
+
+/*
+ * Generate winLen coefficients of gen times gain into pCoefs for W, return
+ * RISCV_MATH_ARGUMENT_ERROR if gen is NULL or winLen is 0
+ */
+__STATIC_INLINE riscv_status riscv_window_plan_init_f32(riscv_window_plan_f32 *W, float32_t *pCoefs, uint32_t winLen,
+                                                        riscv_window_gen_f32 gen, float32_t gain)
+{
+    if ((gen == NULL) || (winLen == 0)) {
+        return RISCV_MATH_ARGUMENT_ERROR;
+    }
+    gen(pCoefs, winLen);
+    if (gain != 1.0f) {
+        riscv_scale_f32(pCoefs, gain, pCoefs, winLen);
+    }
+    W->winLen = winLen;
+    W->pCoefs = pCoefs;
+    return RISCV_MATH_SUCCESS;
+}
+
+/*
+ * Forward riscv_rfft_fast_f32() of p times the window of W, W->winLen is S->fftLenRFFT,
+ * p is windowed in place and its content is lost as by riscv_rfft_fast_f32()
+ */
+__STATIC_INLINE void riscv_rfft_fast_window_f32(const riscv_rfft_fast_instance_f32 *S, const riscv_window_plan_f32 *W,
+                                                float32_t *p, float32_t *pOut)
+{
+    riscv_mult_f32(p, W->pCoefs, p, W->winLen);
+    riscv_rfft_fast_f32(S, p, pOut, 0);
+}
+
+#if defined(RISCV_MATH_VECTOR)
+
+/*
+ * Vector mixed-radix FFT
+ *
+ * The complex FFT runs in place as radix-4 decimation in frequency stages, with one radix-2
+ * stage first when log2(fftLen) is odd, the digit reversed output is reordered into the
+ * destination by indexed loads of a precomputed permutation. Sizes are powers of 2 from 4
+ * to 65536 (from 8 to 65536 for the real FFT).
+ *
+ * Real and imaginary parts are split into separate vectors by strided loads, so the
+ * butterflies are plain vector arithmetic. The twiddles of a stage are stored in the order
+ * they are used, as unit stride planes:
+ *   radix-2 stage of length N:  re[N/2], im[N/2]
+ *   radix-4 stage of length L:  w1re[L/4], w1im[L/4], w2re[L/4], w2im[L/4], w3re[L/4], w3im[L/4]
+ * with wm[j] = cos(2*pi*m*j/L) - i*sin(2*pi*m*j/L), stages follow each other from the first
+ * down to L = 16, the last stage of L = 4 needs no twiddle and is vectorized across groups.
+ *
+ * The inverse transform swaps real and imaginary parts on input and output, which turns the
+ * forward transform into the inverse one without any negation. Floating point inverse is
+ * scaled by 1/fftLen, fixed point transforms scale down by 1/2 at each radix-2 stage and
+ * by 1/4 at each radix-4 stage, by 1/fftLen in total, the same as riscv_cfft_q31/q15.
+ */
+
+#define RISCV_VEC_CFFT_MIN_LEN      4U
+#define RISCV_VEC_CFFT_MAX_LEN      65536U
+#define RISCV_VEC_CFFT_2PI          6.28318530717958647692
+
+typedef struct
+{
+    uint32_t fftLen;                /**< length of the FFT */
+    const float32_t *pTwiddle;      /**< riscv_vec_cfft_twiddle_size(fftLen) twiddles */
+    const uint32_t *pPerm;          /**< fftLen entries of output permutation */
+} riscv_vec_cfft_instance_f32;
+
+typedef struct
+{
+    uint32_t fftLen;                /**< length of the FFT */
+    const q31_t *pTwiddle;          /**< riscv_vec_cfft_twiddle_size(fftLen) twiddles */
+    const uint32_t *pPerm;          /**< fftLen entries of output permutation */
+} riscv_vec_cfft_instance_q31;
+
+typedef struct
+{
+    uint32_t fftLen;                /**< length of the FFT */
+    const q15_t *pTwiddle;          /**< riscv_vec_cfft_twiddle_size(fftLen) twiddles */
+    const uint32_t *pPerm;          /**< fftLen entries of output permutation */
+} riscv_vec_cfft_instance_q15;
+
+typedef struct
+{
+    riscv_vec_cfft_instance_f32 Sint;   /**< complex FFT of fftLenRFFT / 2 */
+    uint32_t fftLenRFFT;                /**< length of the real FFT */
+    const float32_t *pTwiddleRFFT;      /**< split twiddles, re[fftLenRFFT/4], im[fftLenRFFT/4] */
+} riscv_vec_rfft_instance_f32;
+
+/* return 1 if fftLen is a power of 2 supported by the vector FFT */
+__STATIC_INLINE uint32_t riscv_vec_cfft_len_valid(uint32_t fftLen)
+{
+    return ((fftLen >= RISCV_VEC_CFFT_MIN_LEN) && (fftLen <= RISCV_VEC_CFFT_MAX_LEN) &&
+            ((fftLen & (fftLen - 1)) == 0)) ? 1 : 0;
+}
+
+/* return 1 if log2(fftLen) is odd, so the first stage is radix-2 */
+__STATIC_INLINE uint32_t riscv_vec_cfft_has_radix2(uint32_t fftLen)
+{
+    return ((fftLen & 0x55555555UL) == 0) ? 1 : 0;
+}
+
+/* return number of twiddle elements of the stages of fftLen */
+__STATIC_INLINE uint32_t riscv_vec_cfft_twiddle_size(uint32_t fftLen)
+{
+    uint32_t L = fftLen, size = 0;
+
+    if (riscv_vec_cfft_has_radix2(fftLen)) {
+        size = fftLen;
+        L = fftLen >> 1;
+    }
+    for (; L > 4; L >>= 2) {
+        size += 6 * (L >> 2);
+    }
+    return size;
+}
+
+/* return element idx of the twiddle layout of fftLen */
+__STATIC_INLINE double riscv_vec_cfft_twiddle_value(uint32_t fftLen, uint32_t idx)
+{
+    uint32_t L = fftLen, q, plane;
+    double angle;
+
+    if (riscv_vec_cfft_has_radix2(fftLen)) {
+        q = fftLen >> 1;
+        if (idx < fftLen) {
+            angle = RISCV_VEC_CFFT_2PI * (double)(idx % q) / (double)fftLen;
+            return (idx < q) ? cos(angle) : -sin(angle);
+        }
+        idx -= fftLen;
+        L = q;
+    }
+    for (; L > 4; L >>= 2) {
+        q = L >> 2;
+        if (idx < 6 * q) {
+            plane = idx / q;
+            angle = RISCV_VEC_CFFT_2PI * (double)((plane >> 1) + 1) * (double)(idx % q) / (double)L;
+            return ((plane & 1) == 0) ? cos(angle) : -sin(angle);
+        }
+        idx -= 6 * q;
+    }
+    return 0.0;
+}
+
+/* fill pPerm so that output k of the transform is element pPerm[k] after the stages */
+__STATIC_INLINE void riscv_vec_cfft_perm_init(uint32_t *pPerm, uint32_t fftLen)
+{
+    uint32_t p, rem, size, mul, k;
+
+    for (p = 0; p < fftLen; p++) {
+        rem = p;
+        size = fftLen;
+        mul = 1;
+        k = 0;
+        // digit of each stage is the index of its sub-block, least significant for the first
+        if (riscv_vec_cfft_has_radix2(fftLen)) {
+            size >>= 1;
+            k = rem / size;
+            rem %= size;
+            mul = 2;
+        }
+        while (size > 1) {
+            size >>= 2;
+            k += (rem / size) * mul;
+            rem %= size;
+            mul <<= 2;
+        }
+        pPerm[k] = p;
+    }
+}
+
+/* gather 64-bit complex values of pSrc into natural order in pDst, swapping re/im if swap */
+__STATIC_INLINE void riscv_vec_cfft_reorder_64(const uint32_t *pSrc, uint32_t *pDst,
+                                               const uint32_t *pPerm, uint32_t fftLen, uint32_t swap)
+{
+    const uint32_t *pRe = pSrc + (swap ? 1 : 0);
+    const uint32_t *pIm = pSrc + (swap ? 0 : 1);
+    uint32_t k;
+    size_t vl;
+    vuint32m4_t off, re, im;
+
+    for (k = 0; k < fftLen; k += vl) {
+        vl = __riscv_vsetvl_e32m4(fftLen - k);
+        off = __riscv_vsll_vx_u32m4(__riscv_vle32_v_u32m4(pPerm + k, vl), 3, vl);
+        re = __riscv_vluxei32_v_u32m4(pRe, off, vl);
+        im = __riscv_vluxei32_v_u32m4(pIm, off, vl);
+        __riscv_vsse32_v_u32m4(pDst + 2 * k, 8, re, vl);
+        __riscv_vsse32_v_u32m4(pDst + 2 * k + 1, 8, im, vl);
+    }
+}
+
+/* gather 32-bit complex values of pSrc into natural order in pDst, swapping re/im if swap */
+__STATIC_INLINE void riscv_vec_cfft_reorder_32(const uint32_t *pSrc, uint32_t *pDst,
+                                               const uint32_t *pPerm, uint32_t fftLen, uint32_t swap)
+{
+    uint32_t k;
+    size_t vl;
+    vuint32m4_t w;
+
+    for (k = 0; k < fftLen; k += vl) {
+        vl = __riscv_vsetvl_e32m4(fftLen - k);
+        w = __riscv_vluxei32_v_u32m4(pSrc, __riscv_vsll_vx_u32m4(__riscv_vle32_v_u32m4(pPerm + k, vl), 2, vl), vl);
+        if (swap) {
+            w = __riscv_vor_vv_u32m4(__riscv_vsrl_vx_u32m4(w, 16, vl), __riscv_vsll_vx_u32m4(w, 16, vl), vl);
+        }
+        __riscv_vse32_v_u32m4(pDst + k, w, vl);
+    }
+}
+
+/* swap re/im of fftLen 64-bit complex values in place */
+__STATIC_INLINE void riscv_vec_cfft_swap_64(uint32_t *p, uint32_t fftLen)
+{
+    uint32_t k;
+    size_t vl;
+    vuint32m4_t re, im;
+
+    for (k = 0; k < fftLen; k += vl) {
+        vl = __riscv_vsetvl_e32m4(fftLen - k);
+        re = __riscv_vlse32_v_u32m4(p + 2 * k, 8, vl);
+        im = __riscv_vlse32_v_u32m4(p + 2 * k + 1, 8, vl);
+        __riscv_vsse32_v_u32m4(p + 2 * k, 8, im, vl);
+        __riscv_vsse32_v_u32m4(p + 2 * k + 1, 8, re, vl);
+    }
+}
+
+/* swap re/im of fftLen 32-bit complex values in place */
+__STATIC_INLINE void riscv_vec_cfft_swap_32(uint32_t *p, uint32_t fftLen)
+{
+    uint32_t k;
+    size_t vl;
+    vuint32m4_t w;
+
+    for (k = 0; k < fftLen; k += vl) {
+        vl = __riscv_vsetvl_e32m4(fftLen - k);
+        w = __riscv_vle32_v_u32m4(p + k, vl);
+        w = __riscv_vor_vv_u32m4(__riscv_vsrl_vx_u32m4(w, 16, vl), __riscv_vsll_vx_u32m4(w, 16, vl), vl);
+        __riscv_vse32_v_u32m4(p + k, w, vl);
+    }
+}
+
+/* ---------------------------------------- f32 ---------------------------------------- */
+
+/* y = x * w */
+#define RISCV_VEC_CMUL_F32(yr, yi, xr, xi, wr, wi, vl)             \
+    do {                                                            \
+        yr = __riscv_vfmul_vv_f32m2(xr, wr, vl);                    \
+        yr = __riscv_vfnmsac_vv_f32m2(yr, xi, wi, vl);              \
+        yi = __riscv_vfmul_vv_f32m2(xr, wi, vl);                    \
+        yi = __riscv_vfmacc_vv_f32m2(yi, xi, wr, vl);               \
+    } while (0)
+
+/* fill twiddles and permutation of S, return RISCV_MATH_ARGUMENT_ERROR for unsupported fftLen */
+__STATIC_INLINE riscv_status riscv_vec_cfft_init_f32(riscv_vec_cfft_instance_f32 *S, uint32_t fftLen,
+                                                     float32_t *pTwiddle, uint32_t *pPerm)
+{
+    uint32_t i, size;
+
+    if (!riscv_vec_cfft_len_valid(fftLen)) {
+        return RISCV_MATH_ARGUMENT_ERROR;
+    }
+    size = riscv_vec_cfft_twiddle_size(fftLen);
+    for (i = 0; i < size; i++) {
+        pTwiddle[i] = (float32_t)riscv_vec_cfft_twiddle_value(fftLen, i);
+    }
+    riscv_vec_cfft_perm_init(pPerm, fftLen);
+    S->fftLen = fftLen;
+    S->pTwiddle = pTwiddle;
+    S->pPerm = pPerm;
+    return RISCV_MATH_SUCCESS;
+}
+
+/*
+ * strided load of p + off, times the window at the same offset when pWin is not NULL, so the
+ * first stage windows the real samples packed as complex without a pass of its own
+ */
+__STATIC_FORCEINLINE vfloat32m2_t riscv_vec_cfft_load_f32(const float32_t *p, const float32_t *pWin, uint32_t off,
+                                                          ptrdiff_t stride, size_t vl)
+{
+    vfloat32m2_t x = __riscv_vlse32_v_f32m2(p + off, stride, vl);
+
+    if (pWin != NULL) {
+        x = __riscv_vfmul_vv_f32m2(x, __riscv_vlse32_v_f32m2(pWin + off, stride, vl), vl);
+    }
+    return x;
+}
+
+/* radix-2 stage over the whole of p, inputs times pWin if not NULL */
+__STATIC_INLINE void riscv_vec_cfft_radix2_f32(float32_t *p, uint32_t fftLen, const float32_t *pTw,
+                                               const float32_t *pWin)
+{
+    uint32_t h = fftLen >> 1, j;
+    size_t vl;
+    vfloat32m2_t ar, ai, br, bi, tr, ti, yr, yi, wr, wi;
+
+    for (j = 0; j < h; j += vl) {
+        vl = __riscv_vsetvl_e32m2(h - j);
+        ar = riscv_vec_cfft_load_f32(p, pWin, 2 * j, 8, vl);
+        ai = riscv_vec_cfft_load_f32(p, pWin, 2 * j + 1, 8, vl);
+        br = riscv_vec_cfft_load_f32(p, pWin, 2 * (j + h), 8, vl);
+        bi = riscv_vec_cfft_load_f32(p, pWin, 2 * (j + h) + 1, 8, vl);
+        __riscv_vsse32_v_f32m2(p + 2 * j, 8, __riscv_vfadd_vv_f32m2(ar, br, vl), vl);
+        __riscv_vsse32_v_f32m2(p + 2 * j + 1, 8, __riscv_vfadd_vv_f32m2(ai, bi, vl), vl);
+        tr = __riscv_vfsub_vv_f32m2(ar, br, vl);
+        ti = __riscv_vfsub_vv_f32m2(ai, bi, vl);
+        wr = __riscv_vle32_v_f32m2(pTw + j, vl);
+        wi = __riscv_vle32_v_f32m2(pTw + h + j, vl);
+        RISCV_VEC_CMUL_F32(yr, yi, tr, ti, wr, wi, vl);
+        __riscv_vsse32_v_f32m2(p + 2 * (j + h), 8, yr, vl);
+        __riscv_vsse32_v_f32m2(p + 2 * (j + h) + 1, 8, yi, vl);
+    }
+}
+
+/* radix-4 stage of groups of length L > 4, inputs times pWin if not NULL */
+__STATIC_INLINE void riscv_vec_cfft_radix4_f32(float32_t *p, uint32_t fftLen, uint32_t L, const float32_t *pTw,
+                                               const float32_t *pWin)
+{
+    uint32_t q = L >> 2, g, j;
+    size_t vl;
+    float32_t *pa, *pb, *pc, *pd;
+    vfloat32m2_t ar, ai, br, bi, cr, ci, dr, di, yr, yi, wr, wi;
+    vfloat32m2_t t0r, t0i, t1r, t1i, t2r, t2i, t3r, t3i;
+
+    for (g = 0; g < fftLen; g += L) {
+        for (j = 0; j < q; j += vl) {
+            vl = __riscv_vsetvl_e32m2(q - j);
+            pa = p + 2 * (g + j);
+            pb = pa + 2 * q;
+            pc = pb + 2 * q;
+            pd = pc + 2 * q;
+            ar = riscv_vec_cfft_load_f32(p, pWin, 2 * (g + j), 8, vl);
+            ai = riscv_vec_cfft_load_f32(p, pWin, 2 * (g + j) + 1, 8, vl);
+            br = riscv_vec_cfft_load_f32(p, pWin, 2 * (g + j + q), 8, vl);
+            bi = riscv_vec_cfft_load_f32(p, pWin, 2 * (g + j + q) + 1, 8, vl);
+            cr = riscv_vec_cfft_load_f32(p, pWin, 2 * (g + j + 2 * q), 8, vl);
+            ci = riscv_vec_cfft_load_f32(p, pWin, 2 * (g + j + 2 * q) + 1, 8, vl);
+            dr = riscv_vec_cfft_load_f32(p, pWin, 2 * (g + j + 3 * q), 8, vl);
+            di = riscv_vec_cfft_load_f32(p, pWin, 2 * (g + j + 3 * q) + 1, 8, vl);
+            t0r = __riscv_vfadd_vv_f32m2(ar, cr, vl);
+            t0i = __riscv_vfadd_vv_f32m2(ai, ci, vl);
+            t1r = __riscv_vfsub_vv_f32m2(ar, cr, vl);
+            t1i = __riscv_vfsub_vv_f32m2(ai, ci, vl);
+            t2r = __riscv_vfadd_vv_f32m2(br, dr, vl);
+            t2i = __riscv_vfadd_vv_f32m2(bi, di, vl);
+            t3r = __riscv_vfsub_vv_f32m2(br, dr, vl);
+            t3i = __riscv_vfsub_vv_f32m2(bi, di, vl);
+            // y0 = t0 + t2
+            __riscv_vsse32_v_f32m2(pa, 8, __riscv_vfadd_vv_f32m2(t0r, t2r, vl), vl);
+            __riscv_vsse32_v_f32m2(pa + 1, 8, __riscv_vfadd_vv_f32m2(t0i, t2i, vl), vl);
+            // y1 = (t1 - i * t3) * w1
+            ar = __riscv_vfadd_vv_f32m2(t1r, t3i, vl);
+            ai = __riscv_vfsub_vv_f32m2(t1i, t3r, vl);
+            wr = __riscv_vle32_v_f32m2(pTw + j, vl);
+            wi = __riscv_vle32_v_f32m2(pTw + q + j, vl);
+            RISCV_VEC_CMUL_F32(yr, yi, ar, ai, wr, wi, vl);
+            __riscv_vsse32_v_f32m2(pb, 8, yr, vl);
+            __riscv_vsse32_v_f32m2(pb + 1, 8, yi, vl);
+            // y2 = (t0 - t2) * w2
+            ar = __riscv_vfsub_vv_f32m2(t0r, t2r, vl);
+            ai = __riscv_vfsub_vv_f32m2(t0i, t2i, vl);
+            wr = __riscv_vle32_v_f32m2(pTw + 2 * q + j, vl);
+            wi = __riscv_vle32_v_f32m2(pTw + 3 * q + j, vl);
+            RISCV_VEC_CMUL_F32(yr, yi, ar, ai, wr, wi, vl);
+            __riscv_vsse32_v_f32m2(pc, 8, yr, vl);
+            __riscv_vsse32_v_f32m2(pc + 1, 8, yi, vl);
+            // y3 = (t1 + i * t3) * w3
+            ar = __riscv_vfsub_vv_f32m2(t1r, t3i, vl);
+            ai = __riscv_vfadd_vv_f32m2(t1i, t3r, vl);
+            wr = __riscv_vle32_v_f32m2(pTw + 4 * q + j, vl);
+            wi = __riscv_vle32_v_f32m2(pTw + 5 * q + j, vl);
+            RISCV_VEC_CMUL_F32(yr, yi, ar, ai, wr, wi, vl);
+            __riscv_vsse32_v_f32m2(pd, 8, yr, vl);
+            __riscv_vsse32_v_f32m2(pd + 1, 8, yi, vl);
+        }
+    }
+}
+
+/* last radix-4 stage, one group of 4 per vector element, inputs times pWin if not NULL */
+__STATIC_INLINE void riscv_vec_cfft_radix4_last_f32(float32_t *p, uint32_t fftLen, const float32_t *pWin)
+{
+    uint32_t n = fftLen >> 2, g;
+    size_t vl;
+    float32_t *pa;
+    vfloat32m2_t ar, ai, br, bi, cr, ci, dr, di;
+    vfloat32m2_t t0r, t0i, t1r, t1i, t2r, t2i, t3r, t3i;
+
+    for (g = 0; g < n; g += vl) {
+        vl = __riscv_vsetvl_e32m2(n - g);
+        pa = p + 8 * g;
+        ar = riscv_vec_cfft_load_f32(p, pWin, 8 * g, 32, vl);
+        ai = riscv_vec_cfft_load_f32(p, pWin, 8 * g + 1, 32, vl);
+        br = riscv_vec_cfft_load_f32(p, pWin, 8 * g + 2, 32, vl);
+        bi = riscv_vec_cfft_load_f32(p, pWin, 8 * g + 3, 32, vl);
+        cr = riscv_vec_cfft_load_f32(p, pWin, 8 * g + 4, 32, vl);
+        ci = riscv_vec_cfft_load_f32(p, pWin, 8 * g + 5, 32, vl);
+        dr = riscv_vec_cfft_load_f32(p, pWin, 8 * g + 6, 32, vl);
+        di = riscv_vec_cfft_load_f32(p, pWin, 8 * g + 7, 32, vl);
+        t0r = __riscv_vfadd_vv_f32m2(ar, cr, vl);
+        t0i = __riscv_vfadd_vv_f32m2(ai, ci, vl);
+        t1r = __riscv_vfsub_vv_f32m2(ar, cr, vl);
+        t1i = __riscv_vfsub_vv_f32m2(ai, ci, vl);
+        t2r = __riscv_vfadd_vv_f32m2(br, dr, vl);
+        t2i = __riscv_vfadd_vv_f32m2(bi, di, vl);
+        t3r = __riscv_vfsub_vv_f32m2(br, dr, vl);
+        t3i = __riscv_vfsub_vv_f32m2(bi, di, vl);
+        __riscv_vsse32_v_f32m2(pa, 32, __riscv_vfadd_vv_f32m2(t0r, t2r, vl), vl);
+        __riscv_vsse32_v_f32m2(pa + 1, 32, __riscv_vfadd_vv_f32m2(t0i, t2i, vl), vl);
+        __riscv_vsse32_v_f32m2(pa + 2, 32, __riscv_vfadd_vv_f32m2(t1r, t3i, vl), vl);
+        __riscv_vsse32_v_f32m2(pa + 3, 32, __riscv_vfsub_vv_f32m2(t1i, t3r, vl), vl);
+        __riscv_vsse32_v_f32m2(pa + 4, 32, __riscv_vfsub_vv_f32m2(t0r, t2r, vl), vl);
+        __riscv_vsse32_v_f32m2(pa + 5, 32, __riscv_vfsub_vv_f32m2(t0i, t2i, vl), vl);
+        __riscv_vsse32_v_f32m2(pa + 6, 32, __riscv_vfsub_vv_f32m2(t1r, t3i, vl), vl);
+        __riscv_vsse32_v_f32m2(pa + 7, 32, __riscv_vfadd_vv_f32m2(t1i, t3r, vl), vl);
+    }
+}
+
+/*
+ * riscv_vec_cfft_f32() with pSrc times pWin of 2 * S->fftLen samples when pWin is not NULL,
+ * the window is applied by the loads of the first stage, pWin is NULL for the inverse
+ */
+__STATIC_INLINE void riscv_vec_cfft_run_f32(const riscv_vec_cfft_instance_f32 *S, float32_t *pSrc,
+                                            float32_t *pDst, uint8_t ifftFlag, const float32_t *pWin)
+{
+    uint32_t fftLen = S->fftLen, L = fftLen, k;
+    const float32_t *pTw = S->pTwiddle;
+    float32_t scale = 1.0f / (float32_t)fftLen;
+    size_t vl;
+
+    if (ifftFlag) {
+        riscv_vec_cfft_swap_64((uint32_t *)pSrc, fftLen);
+    }
+    if (riscv_vec_cfft_has_radix2(fftLen)) {
+        riscv_vec_cfft_radix2_f32(pSrc, fftLen, pTw, pWin);
+        pTw += fftLen;
+        L >>= 1;
+        pWin = NULL;
+    }
+    for (; L > 4; L >>= 2) {
+        riscv_vec_cfft_radix4_f32(pSrc, fftLen, L, pTw, pWin);
+        pTw += 6 * (L >> 2);
+        pWin = NULL;
+    }
+    riscv_vec_cfft_radix4_last_f32(pSrc, fftLen, pWin);
+    riscv_vec_cfft_reorder_64((const uint32_t *)pSrc, (uint32_t *)pDst, S->pPerm, fftLen, ifftFlag);
+    if (ifftFlag) {
+        for (k = 0; k < 2 * fftLen; k += vl) {
+            vl = __riscv_vsetvl_e32m8(2 * fftLen - k);
+            __riscv_vse32_v_f32m8(pDst + k, __riscv_vfmul_vf_f32m8(__riscv_vle32_v_f32m8(pDst + k, vl), scale, vl), vl);
+        }
+    }
+}
+
+/*
+ * Complex FFT of S->fftLen points of pSrc into pDst in natural order, pSrc is used as work
+ * buffer and its content is lost, pSrc and pDst must not overlap
+ */
+__STATIC_INLINE void riscv_vec_cfft_f32(const riscv_vec_cfft_instance_f32 *S, float32_t *pSrc,
+                                        float32_t *pDst, uint8_t ifftFlag)
+{
+    riscv_vec_cfft_run_f32(S, pSrc, pDst, ifftFlag, NULL);
+}
+
+/* return number of twiddle elements of the real FFT of fftLen */
+__STATIC_INLINE uint32_t riscv_vec_rfft_twiddle_size(uint32_t fftLen)
+{
+    return riscv_vec_cfft_twiddle_size(fftLen >> 1) + (fftLen >> 1);
+}
+
+/*
+ * Fill twiddles of riscv_vec_rfft_twiddle_size(fftLen) elements and permutation of fftLen / 2
+ * entries of S, return RISCV_MATH_ARGUMENT_ERROR for unsupported fftLen
+ */
+__STATIC_INLINE riscv_status riscv_vec_rfft_init_f32(riscv_vec_rfft_instance_f32 *S, uint32_t fftLen,
+                                                     float32_t *pTwiddle, uint32_t *pPerm)
+{
+    uint32_t h = fftLen >> 2, k;
+    float32_t *pSplit;
+    double angle;
+
+    if ((fftLen > 2 * RISCV_VEC_CFFT_MAX_LEN) ||
+        (riscv_vec_cfft_init_f32(&S->Sint, fftLen >> 1, pTwiddle, pPerm) != RISCV_MATH_SUCCESS)) {
+        return RISCV_MATH_ARGUMENT_ERROR;
+    }
+    // split twiddles W^k of k = 1 ~ fftLen / 4, the mirrored half is derived from them
+    pSplit = pTwiddle + riscv_vec_cfft_twiddle_size(fftLen >> 1);
+    for (k = 0; k < h; k++) {
+        angle = RISCV_VEC_CFFT_2PI * (double)(k + 1) / (double)fftLen;
+        pSplit[k] = (float32_t)cos(angle);
+        pSplit[h + k] = (float32_t)-sin(angle);
+    }
+    S->fftLenRFFT = fftLen;
+    S->pTwiddleRFFT = pSplit;
+    return RISCV_MATH_SUCCESS;
+}
+
+/* riscv_vec_rfft_f32() with pSrc times pWin of S->fftLenRFFT samples when pWin is not NULL */
+__STATIC_INLINE void riscv_vec_rfft_run_f32(const riscv_vec_rfft_instance_f32 *S, float32_t *pSrc,
+                                            float32_t *pDst, uint8_t ifftFlag, const float32_t *pWin)
+{
+    uint32_t m = S->fftLenRFFT >> 1, h = m >> 1, j;
+    const float32_t *pWr = S->pTwiddleRFFT, *pWi = S->pTwiddleRFFT + h;
+    float32_t *p = ifftFlag ? pSrc : pDst, *pk, *pm;
+    float32_t x0, x1;
+    size_t vl;
+    vfloat32m2_t ar, ai, cr, ci, er, ei, dr, di, pr, pi, wr, wi;
+
+    if (!ifftFlag) {
+        riscv_vec_cfft_run_f32(&S->Sint, pSrc, pDst, 0, pWin);
+    }
+    // pairs k and m - k are computed together, so the split runs in place
+    x0 = p[0];
+    x1 = p[1];
+    for (j = 0; j < h; j += vl) {
+        vl = __riscv_vsetvl_e32m2(h - j);
+        pk = p + 2 * (j + 1);
+        pm = p + 2 * (m - j - 1);
+        ar = __riscv_vlse32_v_f32m2(pk, 8, vl);
+        ai = __riscv_vlse32_v_f32m2(pk + 1, 8, vl);
+        cr = __riscv_vlse32_v_f32m2(pm, -8, vl);
+        ci = __riscv_vlse32_v_f32m2(pm + 1, -8, vl);
+        wr = __riscv_vle32_v_f32m2(pWr + j, vl);
+        wi = __riscv_vle32_v_f32m2(pWi + j, vl);
+        er = __riscv_vfmul_vf_f32m2(__riscv_vfadd_vv_f32m2(ar, cr, vl), 0.5f, vl);
+        ei = __riscv_vfmul_vf_f32m2(__riscv_vfsub_vv_f32m2(ai, ci, vl), 0.5f, vl);
+        dr = __riscv_vfmul_vf_f32m2(__riscv_vfsub_vv_f32m2(ar, cr, vl), 0.5f, vl);
+        di = __riscv_vfmul_vf_f32m2(__riscv_vfadd_vv_f32m2(ai, ci, vl), 0.5f, vl);
+        if (!ifftFlag) {
+            // X[k] = E + P, X[m - k] = conj(E - P), P = -i * W^k * D
+            pr = __riscv_vfmul_vv_f32m2(di, wr, vl);
+            pr = __riscv_vfmacc_vv_f32m2(pr, dr, wi, vl);
+            pi = __riscv_vfmul_vv_f32m2(di, wi, vl);
+            pi = __riscv_vfnmsac_vv_f32m2(pi, dr, wr, vl);
+            __riscv_vsse32_v_f32m2(pk, 8, __riscv_vfadd_vv_f32m2(er, pr, vl), vl);
+            __riscv_vsse32_v_f32m2(pk + 1, 8, __riscv_vfadd_vv_f32m2(ei, pi, vl), vl);
+            __riscv_vsse32_v_f32m2(pm, -8, __riscv_vfsub_vv_f32m2(er, pr, vl), vl);
+            __riscv_vsse32_v_f32m2(pm + 1, -8, __riscv_vfsub_vv_f32m2(pi, ei, vl), vl);
+        } else {
+            // Z[k] = E + i * O, Z[m - k] = conj(E) + i * conj(O), O = conj(W^k) * D
+            pr = __riscv_vfmul_vv_f32m2(dr, wr, vl);
+            pr = __riscv_vfmacc_vv_f32m2(pr, di, wi, vl);
+            pi = __riscv_vfmul_vv_f32m2(di, wr, vl);
+            pi = __riscv_vfnmsac_vv_f32m2(pi, dr, wi, vl);
+            __riscv_vsse32_v_f32m2(pk, 8, __riscv_vfsub_vv_f32m2(er, pi, vl), vl);
+            __riscv_vsse32_v_f32m2(pk + 1, 8, __riscv_vfadd_vv_f32m2(ei, pr, vl), vl);
+            __riscv_vsse32_v_f32m2(pm, -8, __riscv_vfadd_vv_f32m2(er, pi, vl), vl);
+            __riscv_vsse32_v_f32m2(pm + 1, -8, __riscv_vfsub_vv_f32m2(pr, ei, vl), vl);
+        }
+    }
+    if (!ifftFlag) {
+        p[0] = x0 + x1;
+        p[1] = x0 - x1;
+    } else {
+        p[0] = 0.5f * (x0 + x1);
+        p[1] = 0.5f * (x0 - x1);
+        riscv_vec_cfft_f32(&S->Sint, pSrc, pDst, 1);
+    }
+}
+
+/*
+ * Real FFT of S->fftLenRFFT points, the forward output is packed as riscv_rfft_fast_f32,
+ * X[0] and X[N/2] real parts first, then X[1] ~ X[N/2-1], the inverse takes this format.
+ * pSrc is used as work buffer and its content is lost, pSrc and pDst must not overlap.
+ */
+__STATIC_INLINE void riscv_vec_rfft_f32(const riscv_vec_rfft_instance_f32 *S, float32_t *pSrc,
+                                        float32_t *pDst, uint8_t ifftFlag)
+{
+    riscv_vec_rfft_run_f32(S, pSrc, pDst, ifftFlag, NULL);
+}
+
+/*
+ * Forward real FFT of pSrc times the window of W, as riscv_vec_rfft_f32() of the windowed
+ * frame, W->winLen is S->fftLenRFFT. The window is applied by the loads of the first
+ * butterfly stage, so there is no pass over the frame and no buffer for the windowed copy.
+ */
+__STATIC_INLINE void riscv_vec_rfft_window_f32(const riscv_vec_rfft_instance_f32 *S, const riscv_window_plan_f32 *W,
+                                               float32_t *pSrc, float32_t *pDst)
+{
+    riscv_vec_rfft_run_f32(S, pSrc, pDst, 0, W->pCoefs);
+}
+
+/* ---------------------------------------- q31 ---------------------------------------- */
+
+/* y = x * w in q31, products of q31 keep 31 fractional bits */
+#define RISCV_VEC_CMUL_Q31(yr, yi, xr, xi, wr, wi, vl)                                         \
+    do {                                                                                        \
+        yr = __riscv_vsub_vv_i32m2(__riscv_vmulh_vv_i32m2(xr, wr, vl), __riscv_vmulh_vv_i32m2(xi, wi, vl), vl); \
+        yi = __riscv_vadd_vv_i32m2(__riscv_vmulh_vv_i32m2(xr, wi, vl), __riscv_vmulh_vv_i32m2(xi, wr, vl), vl); \
+        yr = __riscv_vsll_vx_i32m2(yr, 1, vl);                                                  \
+        yi = __riscv_vsll_vx_i32m2(yi, 1, vl);                                                  \
+    } while (0)
+
+/* fill twiddles and permutation of S, return RISCV_MATH_ARGUMENT_ERROR for unsupported fftLen */
+__STATIC_INLINE riscv_status riscv_vec_cfft_init_q31(riscv_vec_cfft_instance_q31 *S, uint32_t fftLen,
+                                                     q31_t *pTwiddle, uint32_t *pPerm)
+{
+    uint32_t i, size;
+    double v;
+
+    if (!riscv_vec_cfft_len_valid(fftLen)) {
+        return RISCV_MATH_ARGUMENT_ERROR;
+    }
+    size = riscv_vec_cfft_twiddle_size(fftLen);
+    for (i = 0; i < size; i++) {
+        v = riscv_vec_cfft_twiddle_value(fftLen, i) * 2147483648.0;
+        pTwiddle[i] = (v >= 2147483647.0) ? INT32_MAX : (q31_t)((v >= 0.0) ? (v + 0.5) : (v - 0.5));
+    }
+    riscv_vec_cfft_perm_init(pPerm, fftLen);
+    S->fftLen = fftLen;
+    S->pTwiddle = pTwiddle;
+    S->pPerm = pPerm;
+    return RISCV_MATH_SUCCESS;
+}
+
+/* radix-2 stage over the whole of p, scaled by 1/2 */
+__STATIC_INLINE void riscv_vec_cfft_radix2_q31(q31_t *p, uint32_t fftLen, const q31_t *pTw)
+{
+    uint32_t h = fftLen >> 1, j;
+    size_t vl;
+    vint32m2_t ar, ai, br, bi, tr, ti, yr, yi, wr, wi;
+
+    for (j = 0; j < h; j += vl) {
+        vl = __riscv_vsetvl_e32m2(h - j);
+        ar = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(p + 2 * j, 8, vl), 1, vl);
+        ai = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(p + 2 * j + 1, 8, vl), 1, vl);
+        br = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(p + 2 * (j + h), 8, vl), 1, vl);
+        bi = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(p + 2 * (j + h) + 1, 8, vl), 1, vl);
+        __riscv_vsse32_v_i32m2(p + 2 * j, 8, __riscv_vadd_vv_i32m2(ar, br, vl), vl);
+        __riscv_vsse32_v_i32m2(p + 2 * j + 1, 8, __riscv_vadd_vv_i32m2(ai, bi, vl), vl);
+        tr = __riscv_vsub_vv_i32m2(ar, br, vl);
+        ti = __riscv_vsub_vv_i32m2(ai, bi, vl);
+        wr = __riscv_vle32_v_i32m2(pTw + j, vl);
+        wi = __riscv_vle32_v_i32m2(pTw + h + j, vl);
+        RISCV_VEC_CMUL_Q31(yr, yi, tr, ti, wr, wi, vl);
+        __riscv_vsse32_v_i32m2(p + 2 * (j + h), 8, yr, vl);
+        __riscv_vsse32_v_i32m2(p + 2 * (j + h) + 1, 8, yi, vl);
+    }
+}
+
+/* radix-4 stage of groups of length L > 4, scaled by 1/4 */
+__STATIC_INLINE void riscv_vec_cfft_radix4_q31(q31_t *p, uint32_t fftLen, uint32_t L, const q31_t *pTw)
+{
+    uint32_t q = L >> 2, g, j;
+    size_t vl;
+    q31_t *pa, *pb, *pc, *pd;
+    vint32m2_t ar, ai, br, bi, cr, ci, dr, di, yr, yi, wr, wi;
+    vint32m2_t t0r, t0i, t1r, t1i, t2r, t2i, t3r, t3i;
+
+    for (g = 0; g < fftLen; g += L) {
+        for (j = 0; j < q; j += vl) {
+            vl = __riscv_vsetvl_e32m2(q - j);
+            pa = p + 2 * (g + j);
+            pb = pa + 2 * q;
+            pc = pb + 2 * q;
+            pd = pc + 2 * q;
+            ar = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pa, 8, vl), 2, vl);
+            ai = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pa + 1, 8, vl), 2, vl);
+            br = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pb, 8, vl), 2, vl);
+            bi = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pb + 1, 8, vl), 2, vl);
+            cr = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pc, 8, vl), 2, vl);
+            ci = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pc + 1, 8, vl), 2, vl);
+            dr = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pd, 8, vl), 2, vl);
+            di = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pd + 1, 8, vl), 2, vl);
+            t0r = __riscv_vadd_vv_i32m2(ar, cr, vl);
+            t0i = __riscv_vadd_vv_i32m2(ai, ci, vl);
+            t1r = __riscv_vsub_vv_i32m2(ar, cr, vl);
+            t1i = __riscv_vsub_vv_i32m2(ai, ci, vl);
+            t2r = __riscv_vadd_vv_i32m2(br, dr, vl);
+            t2i = __riscv_vadd_vv_i32m2(bi, di, vl);
+            t3r = __riscv_vsub_vv_i32m2(br, dr, vl);
+            t3i = __riscv_vsub_vv_i32m2(bi, di, vl);
+            // y0 = t0 + t2
+            __riscv_vsse32_v_i32m2(pa, 8, __riscv_vadd_vv_i32m2(t0r, t2r, vl), vl);
+            __riscv_vsse32_v_i32m2(pa + 1, 8, __riscv_vadd_vv_i32m2(t0i, t2i, vl), vl);
+            // y1 = (t1 - i * t3) * w1
+            ar = __riscv_vadd_vv_i32m2(t1r, t3i, vl);
+            ai = __riscv_vsub_vv_i32m2(t1i, t3r, vl);
+            wr = __riscv_vle32_v_i32m2(pTw + j, vl);
+            wi = __riscv_vle32_v_i32m2(pTw + q + j, vl);
+            RISCV_VEC_CMUL_Q31(yr, yi, ar, ai, wr, wi, vl);
+            __riscv_vsse32_v_i32m2(pb, 8, yr, vl);
+            __riscv_vsse32_v_i32m2(pb + 1, 8, yi, vl);
+            // y2 = (t0 - t2) * w2
+            ar = __riscv_vsub_vv_i32m2(t0r, t2r, vl);
+            ai = __riscv_vsub_vv_i32m2(t0i, t2i, vl);
+            wr = __riscv_vle32_v_i32m2(pTw + 2 * q + j, vl);
+            wi = __riscv_vle32_v_i32m2(pTw + 3 * q + j, vl);
+            RISCV_VEC_CMUL_Q31(yr, yi, ar, ai, wr, wi, vl);
+            __riscv_vsse32_v_i32m2(pc, 8, yr, vl);
+            __riscv_vsse32_v_i32m2(pc + 1, 8, yi, vl);
+            // y3 = (t1 + i * t3) * w3
+            ar = __riscv_vsub_vv_i32m2(t1r, t3i, vl);
+            ai = __riscv_vadd_vv_i32m2(t1i, t3r, vl);
+            wr = __riscv_vle32_v_i32m2(pTw + 4 * q + j, vl);
+            wi = __riscv_vle32_v_i32m2(pTw + 5 * q + j, vl);
+            RISCV_VEC_CMUL_Q31(yr, yi, ar, ai, wr, wi, vl);
+            __riscv_vsse32_v_i32m2(pd, 8, yr, vl);
+            __riscv_vsse32_v_i32m2(pd + 1, 8, yi, vl);
+        }
+    }
+}
+
+/* last radix-4 stage, one group of 4 per vector element, scaled by 1/4 */
+__STATIC_INLINE void riscv_vec_cfft_radix4_last_q31(q31_t *p, uint32_t fftLen)
+{
+    uint32_t n = fftLen >> 2, g;
+    size_t vl;
+    q31_t *pa;
+    vint32m2_t ar, ai, br, bi, cr, ci, dr, di;
+    vint32m2_t t0r, t0i, t1r, t1i, t2r, t2i, t3r, t3i;
+
+    for (g = 0; g < n; g += vl) {
+        vl = __riscv_vsetvl_e32m2(n - g);
+        pa = p + 8 * g;
+        ar = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pa, 32, vl), 2, vl);
+        ai = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pa + 1, 32, vl), 2, vl);
+        br = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pa + 2, 32, vl), 2, vl);
+        bi = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pa + 3, 32, vl), 2, vl);
+        cr = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pa + 4, 32, vl), 2, vl);
+        ci = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pa + 5, 32, vl), 2, vl);
+        dr = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pa + 6, 32, vl), 2, vl);
+        di = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pa + 7, 32, vl), 2, vl);
+        t0r = __riscv_vadd_vv_i32m2(ar, cr, vl);
+        t0i = __riscv_vadd_vv_i32m2(ai, ci, vl);
+        t1r = __riscv_vsub_vv_i32m2(ar, cr, vl);
+        t1i = __riscv_vsub_vv_i32m2(ai, ci, vl);
+        t2r = __riscv_vadd_vv_i32m2(br, dr, vl);
+        t2i = __riscv_vadd_vv_i32m2(bi, di, vl);
+        t3r = __riscv_vsub_vv_i32m2(br, dr, vl);
+        t3i = __riscv_vsub_vv_i32m2(bi, di, vl);
+        __riscv_vsse32_v_i32m2(pa, 32, __riscv_vadd_vv_i32m2(t0r, t2r, vl), vl);
+        __riscv_vsse32_v_i32m2(pa + 1, 32, __riscv_vadd_vv_i32m2(t0i, t2i, vl), vl);
+        __riscv_vsse32_v_i32m2(pa + 2, 32, __riscv_vadd_vv_i32m2(t1r, t3i, vl), vl);
+        __riscv_vsse32_v_i32m2(pa + 3, 32, __riscv_vsub_vv_i32m2(t1i, t3r, vl), vl);
+        __riscv_vsse32_v_i32m2(pa + 4, 32, __riscv_vsub_vv_i32m2(t0r, t2r, vl), vl);
+        __riscv_vsse32_v_i32m2(pa + 5, 32, __riscv_vsub_vv_i32m2(t0i, t2i, vl), vl);
+        __riscv_vsse32_v_i32m2(pa + 6, 32, __riscv_vsub_vv_i32m2(t1r, t3i, vl), vl);
+        __riscv_vsse32_v_i32m2(pa + 7, 32, __riscv_vadd_vv_i32m2(t1i, t3r, vl), vl);
+    }
+}
+
+/*
+ * Complex FFT of S->fftLen points of pSrc into pDst in natural order, scaled by 1/fftLen,
+ * pSrc is used as work buffer and its content is lost, pSrc and pDst must not overlap
+ */
+__STATIC_INLINE void riscv_vec_cfft_q31(const riscv_vec_cfft_instance_q31 *S, q31_t *pSrc,
+                                        q31_t *pDst, uint8_t ifftFlag)
+{
+    uint32_t fftLen = S->fftLen, L = fftLen;
+    const q31_t *pTw = S->pTwiddle;
+
+    if (ifftFlag) {
+        riscv_vec_cfft_swap_64((uint32_t *)pSrc, fftLen);
+    }
+    if (riscv_vec_cfft_has_radix2(fftLen)) {
+        riscv_vec_cfft_radix2_q31(pSrc, fftLen, pTw);
+        pTw += fftLen;
+        L >>= 1;
+    }
+    for (; L > 4; L >>= 2) {
+        riscv_vec_cfft_radix4_q31(pSrc, fftLen, L, pTw);
+        pTw += 6 * (L >> 2);
+    }
+    riscv_vec_cfft_radix4_last_q31(pSrc, fftLen);
+    riscv_vec_cfft_reorder_64((const uint32_t *)pSrc, (uint32_t *)pDst, S->pPerm, fftLen, ifftFlag);
+}
+
+/* ---------------------------------------- q15 ---------------------------------------- */
+
+/* y = x * w in q15, products of q15 keep 15 fractional bits */
+#define RISCV_VEC_CMUL_Q15(yr, yi, xr, xi, wr, wi, vl)                                         \
+    do {                                                                                        \
+        yr = __riscv_vsub_vv_i16m2(__riscv_vmulh_vv_i16m2(xr, wr, vl), __riscv_vmulh_vv_i16m2(xi, wi, vl), vl); \
+        yi = __riscv_vadd_vv_i16m2(__riscv_vmulh_vv_i16m2(xr, wi, vl), __riscv_vmulh_vv_i16m2(xi, wr, vl), vl); \
+        yr = __riscv_vsll_vx_i16m2(yr, 1, vl);                                                  \
+        yi = __riscv_vsll_vx_i16m2(yi, 1, vl);                                                  \
+    } while (0)
+
+/* fill twiddles and permutation of S, return RISCV_MATH_ARGUMENT_ERROR for unsupported fftLen */
+__STATIC_INLINE riscv_status riscv_vec_cfft_init_q15(riscv_vec_cfft_instance_q15 *S, uint32_t fftLen,
+                                                     q15_t *pTwiddle, uint32_t *pPerm)
+{
+    uint32_t i, size;
+    double v;
+
+    if (!riscv_vec_cfft_len_valid(fftLen)) {
+        return RISCV_MATH_ARGUMENT_ERROR;
+    }
+    size = riscv_vec_cfft_twiddle_size(fftLen);
+    for (i = 0; i < size; i++) {
+        v = riscv_vec_cfft_twiddle_value(fftLen, i) * 32768.0;
+        pTwiddle[i] = (v >= 32767.0) ? INT16_MAX : (q15_t)((v >= 0.0) ? (v + 0.5) : (v - 0.5));
+    }
+    riscv_vec_cfft_perm_init(pPerm, fftLen);
+    S->fftLen = fftLen;
+    S->pTwiddle = pTwiddle;
+    S->pPerm = pPerm;
+    return RISCV_MATH_SUCCESS;
+}
+
+/* radix-2 stage over the whole of p, scaled by 1/2 */
+__STATIC_INLINE void riscv_vec_cfft_radix2_q15(q15_t *p, uint32_t fftLen, const q15_t *pTw)
+{
+    uint32_t h = fftLen >> 1, j;
+    size_t vl;
+    vint16m2_t ar, ai, br, bi, tr, ti, yr, yi, wr, wi;
+
+    for (j = 0; j < h; j += vl) {
+        vl = __riscv_vsetvl_e16m2(h - j);
+        ar = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(p + 2 * j, 4, vl), 1, vl);
+        ai = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(p + 2 * j + 1, 4, vl), 1, vl);
+        br = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(p + 2 * (j + h), 4, vl), 1, vl);
+        bi = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(p + 2 * (j + h) + 1, 4, vl), 1, vl);
+        __riscv_vsse16_v_i16m2(p + 2 * j, 4, __riscv_vadd_vv_i16m2(ar, br, vl), vl);
+        __riscv_vsse16_v_i16m2(p + 2 * j + 1, 4, __riscv_vadd_vv_i16m2(ai, bi, vl), vl);
+        tr = __riscv_vsub_vv_i16m2(ar, br, vl);
+        ti = __riscv_vsub_vv_i16m2(ai, bi, vl);
+        wr = __riscv_vle16_v_i16m2(pTw + j, vl);
+        wi = __riscv_vle16_v_i16m2(pTw + h + j, vl);
+        RISCV_VEC_CMUL_Q15(yr, yi, tr, ti, wr, wi, vl);
+        __riscv_vsse16_v_i16m2(p + 2 * (j + h), 4, yr, vl);
+        __riscv_vsse16_v_i16m2(p + 2 * (j + h) + 1, 4, yi, vl);
+    }
+}
+
+/* radix-4 stage of groups of length L > 4, scaled by 1/4 */
+__STATIC_INLINE void riscv_vec_cfft_radix4_q15(q15_t *p, uint32_t fftLen, uint32_t L, const q15_t *pTw)
+{
+    uint32_t q = L >> 2, g, j;
+    size_t vl;
+    q15_t *pa, *pb, *pc, *pd;
+    vint16m2_t ar, ai, br, bi, cr, ci, dr, di, yr, yi, wr, wi;
+    vint16m2_t t0r, t0i, t1r, t1i, t2r, t2i, t3r, t3i;
+
+    for (g = 0; g < fftLen; g += L) {
+        for (j = 0; j < q; j += vl) {
+            vl = __riscv_vsetvl_e16m2(q - j);
+            pa = p + 2 * (g + j);
+            pb = pa + 2 * q;
+            pc = pb + 2 * q;
+            pd = pc + 2 * q;
+            ar = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pa, 4, vl), 2, vl);
+            ai = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pa + 1, 4, vl), 2, vl);
+            br = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pb, 4, vl), 2, vl);
+            bi = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pb + 1, 4, vl), 2, vl);
+            cr = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pc, 4, vl), 2, vl);
+            ci = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pc + 1, 4, vl), 2, vl);
+            dr = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pd, 4, vl), 2, vl);
+            di = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pd + 1, 4, vl), 2, vl);
+            t0r = __riscv_vadd_vv_i16m2(ar, cr, vl);
+            t0i = __riscv_vadd_vv_i16m2(ai, ci, vl);
+            t1r = __riscv_vsub_vv_i16m2(ar, cr, vl);
+            t1i = __riscv_vsub_vv_i16m2(ai, ci, vl);
+            t2r = __riscv_vadd_vv_i16m2(br, dr, vl);
+            t2i = __riscv_vadd_vv_i16m2(bi, di, vl);
+            t3r = __riscv_vsub_vv_i16m2(br, dr, vl);
+            t3i = __riscv_vsub_vv_i16m2(bi, di, vl);
+            // y0 = t0 + t2
+            __riscv_vsse16_v_i16m2(pa, 4, __riscv_vadd_vv_i16m2(t0r, t2r, vl), vl);
+            __riscv_vsse16_v_i16m2(pa + 1, 4, __riscv_vadd_vv_i16m2(t0i, t2i, vl), vl);
+            // y1 = (t1 - i * t3) * w1
+            ar = __riscv_vadd_vv_i16m2(t1r, t3i, vl);
+            ai = __riscv_vsub_vv_i16m2(t1i, t3r, vl);
+            wr = __riscv_vle16_v_i16m2(pTw + j, vl);
+            wi = __riscv_vle16_v_i16m2(pTw + q + j, vl);
+            RISCV_VEC_CMUL_Q15(yr, yi, ar, ai, wr, wi, vl);
+            __riscv_vsse16_v_i16m2(pb, 4, yr, vl);
+            __riscv_vsse16_v_i16m2(pb + 1, 4, yi, vl);
+            // y2 = (t0 - t2) * w2
+            ar = __riscv_vsub_vv_i16m2(t0r, t2r, vl);
+            ai = __riscv_vsub_vv_i16m2(t0i, t2i, vl);
+            wr = __riscv_vle16_v_i16m2(pTw + 2 * q + j, vl);
+            wi = __riscv_vle16_v_i16m2(pTw + 3 * q + j, vl);
+            RISCV_VEC_CMUL_Q15(yr, yi, ar, ai, wr, wi, vl);
+            __riscv_vsse16_v_i16m2(pc, 4, yr, vl);
+            __riscv_vsse16_v_i16m2(pc + 1, 4, yi, vl);
+            // y3 = (t1 + i * t3) * w3
+            ar = __riscv_vsub_vv_i16m2(t1r, t3i, vl);
+            ai = __riscv_vadd_vv_i16m2(t1i, t3r, vl);
+            wr = __riscv_vle16_v_i16m2(pTw + 4 * q + j, vl);
+            wi = __riscv_vle16_v_i16m2(pTw + 5 * q + j, vl);
+            RISCV_VEC_CMUL_Q15(yr, yi, ar, ai, wr, wi, vl);
+            __riscv_vsse16_v_i16m2(pd, 4, yr, vl);
+            __riscv_vsse16_v_i16m2(pd + 1, 4, yi, vl);
+        }
+    }
+}
+
+/* last radix-4 stage, one group of 4 per vector element, scaled by 1/4 */
+__STATIC_INLINE void riscv_vec_cfft_radix4_last_q15(q15_t *p, uint32_t fftLen)
+{
+    uint32_t n = fftLen >> 2, g;
+    size_t vl;
+    q15_t *pa;
+    vint16m2_t ar, ai, br, bi, cr, ci, dr, di;
+    vint16m2_t t0r, t0i, t1r, t1i, t2r, t2i, t3r, t3i;
+
+    for (g = 0; g < n; g += vl) {
+        vl = __riscv_vsetvl_e16m2(n - g);
+        pa = p + 8 * g;
+        ar = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pa, 16, vl), 2, vl);
+        ai = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pa + 1, 16, vl), 2, vl);
+        br = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pa + 2, 16, vl), 2, vl);
+        bi = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pa + 3, 16, vl), 2, vl);
+        cr = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pa + 4, 16, vl), 2, vl);
+        ci = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pa + 5, 16, vl), 2, vl);
+        dr = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pa + 6, 16, vl), 2, vl);
+        di = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pa + 7, 16, vl), 2, vl);
+        t0r = __riscv_vadd_vv_i16m2(ar, cr, vl);
+        t0i = __riscv_vadd_vv_i16m2(ai, ci, vl);
+        t1r = __riscv_vsub_vv_i16m2(ar, cr, vl);
+        t1i = __riscv_vsub_vv_i16m2(ai, ci, vl);
+        t2r = __riscv_vadd_vv_i16m2(br, dr, vl);
+        t2i = __riscv_vadd_vv_i16m2(bi, di, vl);
+        t3r = __riscv_vsub_vv_i16m2(br, dr, vl);
+        t3i = __riscv_vsub_vv_i16m2(bi, di, vl);
+        __riscv_vsse16_v_i16m2(pa, 16, __riscv_vadd_vv_i16m2(t0r, t2r, vl), vl);
+        __riscv_vsse16_v_i16m2(pa + 1, 16, __riscv_vadd_vv_i16m2(t0i, t2i, vl), vl);
+        __riscv_vsse16_v_i16m2(pa + 2, 16, __riscv_vadd_vv_i16m2(t1r, t3i, vl), vl);
+        __riscv_vsse16_v_i16m2(pa + 3, 16, __riscv_vsub_vv_i16m2(t1i, t3r, vl), vl);
+        __riscv_vsse16_v_i16m2(pa + 4, 16, __riscv_vsub_vv_i16m2(t0r, t2r, vl), vl);
+        __riscv_vsse16_v_i16m2(pa + 5, 16, __riscv_vsub_vv_i16m2(t0i, t2i, vl), vl);
+        __riscv_vsse16_v_i16m2(pa + 6, 16, __riscv_vsub_vv_i16m2(t1r, t3i, vl), vl);
+        __riscv_vsse16_v_i16m2(pa + 7, 16, __riscv_vadd_vv_i16m2(t1i, t3r, vl), vl);
+    }
+}
+
+/*
+ * Complex FFT of S->fftLen points of pSrc into pDst in natural order, scaled by 1/fftLen,
+ * pSrc is used as work buffer and its content is lost, pSrc and pDst must not overlap
+ */
+__STATIC_INLINE void riscv_vec_cfft_q15(const riscv_vec_cfft_instance_q15 *S, q15_t *pSrc,
+                                        q15_t *pDst, uint8_t ifftFlag)
+{
+    uint32_t fftLen = S->fftLen, L = fftLen;
+    const q15_t *pTw = S->pTwiddle;
+
+    if (ifftFlag) {
+        riscv_vec_cfft_swap_32((uint32_t *)pSrc, fftLen);
+    }
+    if (riscv_vec_cfft_has_radix2(fftLen)) {
+        riscv_vec_cfft_radix2_q15(pSrc, fftLen, pTw);
+        pTw += fftLen;
+        L >>= 1;
+    }
+    for (; L > 4; L >>= 2) {
+        riscv_vec_cfft_radix4_q15(pSrc, fftLen, L, pTw);
+        pTw += 6 * (L >> 2);
+    }
+    riscv_vec_cfft_radix4_last_q15(pSrc, fftLen);
+    riscv_vec_cfft_reorder_32((const uint32_t *)pSrc, (uint32_t *)pDst, S->pPerm, fftLen, ifftFlag);
+}
+
+/* ---------------------------------------- f16 ---------------------------------------- */
+
+#if defined(RISCV_FLOAT16_SUPPORTED) && defined(__riscv_zvfh)
+
+typedef struct
+{
+    uint32_t fftLen;                /**< length of the FFT */
+    const float16_t *pTwiddle;      /**< riscv_vec_cfft_twiddle_size(fftLen) twiddles */
+    const uint32_t *pPerm;          /**< fftLen entries of output permutation */
+} riscv_vec_cfft_instance_f16;
+
+/* y = x * w */
+#define RISCV_VEC_CMUL_F16(yr, yi, xr, xi, wr, wi, vl)             \
+    do {                                                            \
+        yr = __riscv_vfmul_vv_f16m2(xr, wr, vl);                    \
+        yr = __riscv_vfnmsac_vv_f16m2(yr, xi, wi, vl);              \
+        yi = __riscv_vfmul_vv_f16m2(xr, wi, vl);                    \
+        yi = __riscv_vfmacc_vv_f16m2(yi, xi, wr, vl);               \
+    } while (0)
+
+/* fill twiddles and permutation of S, return RISCV_MATH_ARGUMENT_ERROR for unsupported fftLen */
+__STATIC_INLINE riscv_status riscv_vec_cfft_init_f16(riscv_vec_cfft_instance_f16 *S, uint32_t fftLen,
+                                                     float16_t *pTwiddle, uint32_t *pPerm)
+{
+    uint32_t i, size;
+
+    if (!riscv_vec_cfft_len_valid(fftLen)) {
+        return RISCV_MATH_ARGUMENT_ERROR;
+    }
+    size = riscv_vec_cfft_twiddle_size(fftLen);
+    for (i = 0; i < size; i++) {
+        pTwiddle[i] = (float16_t)riscv_vec_cfft_twiddle_value(fftLen, i);
+    }
+    riscv_vec_cfft_perm_init(pPerm, fftLen);
+    S->fftLen = fftLen;
+    S->pTwiddle = pTwiddle;
+    S->pPerm = pPerm;
+    return RISCV_MATH_SUCCESS;
+}
+
+/* radix-2 stage over the whole of p */
+__STATIC_INLINE void riscv_vec_cfft_radix2_f16(float16_t *p, uint32_t fftLen, const float16_t *pTw)
+{
+    uint32_t h = fftLen >> 1, j;
+    size_t vl;
+    vfloat16m2_t ar, ai, br, bi, tr, ti, yr, yi, wr, wi;
+
+    for (j = 0; j < h; j += vl) {
+        vl = __riscv_vsetvl_e16m2(h - j);
+        ar = __riscv_vlse16_v_f16m2(p + 2 * j, 4, vl);
+        ai = __riscv_vlse16_v_f16m2(p + 2 * j + 1, 4, vl);
+        br = __riscv_vlse16_v_f16m2(p + 2 * (j + h), 4, vl);
+        bi = __riscv_vlse16_v_f16m2(p + 2 * (j + h) + 1, 4, vl);
+        __riscv_vsse16_v_f16m2(p + 2 * j, 4, __riscv_vfadd_vv_f16m2(ar, br, vl), vl);
+        __riscv_vsse16_v_f16m2(p + 2 * j + 1, 4, __riscv_vfadd_vv_f16m2(ai, bi, vl), vl);
+        tr = __riscv_vfsub_vv_f16m2(ar, br, vl);
+        ti = __riscv_vfsub_vv_f16m2(ai, bi, vl);
+        wr = __riscv_vle16_v_f16m2(pTw + j, vl);
+        wi = __riscv_vle16_v_f16m2(pTw + h + j, vl);
+        RISCV_VEC_CMUL_F16(yr, yi, tr, ti, wr, wi, vl);
+        __riscv_vsse16_v_f16m2(p + 2 * (j + h), 4, yr, vl);
+        __riscv_vsse16_v_f16m2(p + 2 * (j + h) + 1, 4, yi, vl);
+    }
+}
+
+/* radix-4 stage of groups of length L > 4 */
+__STATIC_INLINE void riscv_vec_cfft_radix4_f16(float16_t *p, uint32_t fftLen, uint32_t L, const float16_t *pTw)
+{
+    uint32_t q = L >> 2, g, j;
+    size_t vl;
+    float16_t *pa, *pb, *pc, *pd;
+    vfloat16m2_t ar, ai, br, bi, cr, ci, dr, di, yr, yi, wr, wi;
+    vfloat16m2_t t0r, t0i, t1r, t1i, t2r, t2i, t3r, t3i;
+
+    for (g = 0; g < fftLen; g += L) {
+        for (j = 0; j < q; j += vl) {
+            vl = __riscv_vsetvl_e16m2(q - j);
+            pa = p + 2 * (g + j);
+            pb = pa + 2 * q;
+            pc = pb + 2 * q;
+            pd = pc + 2 * q;
+            ar = __riscv_vlse16_v_f16m2(pa, 4, vl);
+            ai = __riscv_vlse16_v_f16m2(pa + 1, 4, vl);
+            br = __riscv_vlse16_v_f16m2(pb, 4, vl);
+            bi = __riscv_vlse16_v_f16m2(pb + 1, 4, vl);
+            cr = __riscv_vlse16_v_f16m2(pc, 4, vl);
+            ci = __riscv_vlse16_v_f16m2(pc + 1, 4, vl);
+            dr = __riscv_vlse16_v_f16m2(pd, 4, vl);
+            di = __riscv_vlse16_v_f16m2(pd + 1, 4, vl);
+            t0r = __riscv_vfadd_vv_f16m2(ar, cr, vl);
+            t0i = __riscv_vfadd_vv_f16m2(ai, ci, vl);
+            t1r = __riscv_vfsub_vv_f16m2(ar, cr, vl);
+            t1i = __riscv_vfsub_vv_f16m2(ai, ci, vl);
+            t2r = __riscv_vfadd_vv_f16m2(br, dr, vl);
+            t2i = __riscv_vfadd_vv_f16m2(bi, di, vl);
+            t3r = __riscv_vfsub_vv_f16m2(br, dr, vl);
+            t3i = __riscv_vfsub_vv_f16m2(bi, di, vl);
+            // y0 = t0 + t2
+            __riscv_vsse16_v_f16m2(pa, 4, __riscv_vfadd_vv_f16m2(t0r, t2r, vl), vl);
+            __riscv_vsse16_v_f16m2(pa + 1, 4, __riscv_vfadd_vv_f16m2(t0i, t2i, vl), vl);
+            // y1 = (t1 - i * t3) * w1
+            ar = __riscv_vfadd_vv_f16m2(t1r, t3i, vl);
+            ai = __riscv_vfsub_vv_f16m2(t1i, t3r, vl);
+            wr = __riscv_vle16_v_f16m2(pTw + j, vl);
+            wi = __riscv_vle16_v_f16m2(pTw + q + j, vl);
+            RISCV_VEC_CMUL_F16(yr, yi, ar, ai, wr, wi, vl);
+            __riscv_vsse16_v_f16m2(pb, 4, yr, vl);
+            __riscv_vsse16_v_f16m2(pb + 1, 4, yi, vl);
+            // y2 = (t0 - t2) * w2
+            ar = __riscv_vfsub_vv_f16m2(t0r, t2r, vl);
+            ai = __riscv_vfsub_vv_f16m2(t0i, t2i, vl);
+            wr = __riscv_vle16_v_f16m2(pTw + 2 * q + j, vl);
+            wi = __riscv_vle16_v_f16m2(pTw + 3 * q + j, vl);
+            RISCV_VEC_CMUL_F16(yr, yi, ar, ai, wr, wi, vl);
+            __riscv_vsse16_v_f16m2(pc, 4, yr, vl);
+            __riscv_vsse16_v_f16m2(pc + 1, 4, yi, vl);
+            // y3 = (t1 + i * t3) * w3
+            ar = __riscv_vfsub_vv_f16m2(t1r, t3i, vl);
+            ai = __riscv_vfadd_vv_f16m2(t1i, t3r, vl);
+            wr = __riscv_vle16_v_f16m2(pTw + 4 * q + j, vl);
+            wi = __riscv_vle16_v_f16m2(pTw + 5 * q + j, vl);
+            RISCV_VEC_CMUL_F16(yr, yi, ar, ai, wr, wi, vl);
+            __riscv_vsse16_v_f16m2(pd, 4, yr, vl);
+            __riscv_vsse16_v_f16m2(pd + 1, 4, yi, vl);
+        }
+    }
+}
+
+/* last radix-4 stage, one group of 4 per vector element */
+__STATIC_INLINE void riscv_vec_cfft_radix4_last_f16(float16_t *p, uint32_t fftLen)
+{
+    uint32_t n = fftLen >> 2, g;
+    size_t vl;
+    float16_t *pa;
+    vfloat16m2_t ar, ai, br, bi, cr, ci, dr, di;
+    vfloat16m2_t t0r, t0i, t1r, t1i, t2r, t2i, t3r, t3i;
+
+    for (g = 0; g < n; g += vl) {
+        vl = __riscv_vsetvl_e16m2(n - g);
+        pa = p + 8 * g;
+        ar = __riscv_vlse16_v_f16m2(pa, 16, vl);
+        ai = __riscv_vlse16_v_f16m2(pa + 1, 16, vl);
+        br = __riscv_vlse16_v_f16m2(pa + 2, 16, vl);
+        bi = __riscv_vlse16_v_f16m2(pa + 3, 16, vl);
+        cr = __riscv_vlse16_v_f16m2(pa + 4, 16, vl);
+        ci = __riscv_vlse16_v_f16m2(pa + 5, 16, vl);
+        dr = __riscv_vlse16_v_f16m2(pa + 6, 16, vl);
+        di = __riscv_vlse16_v_f16m2(pa + 7, 16, vl);
+        t0r = __riscv_vfadd_vv_f16m2(ar, cr, vl);
+        t0i = __riscv_vfadd_vv_f16m2(ai, ci, vl);
+        t1r = __riscv_vfsub_vv_f16m2(ar, cr, vl);
+        t1i = __riscv_vfsub_vv_f16m2(ai, ci, vl);
+        t2r = __riscv_vfadd_vv_f16m2(br, dr, vl);
+        t2i = __riscv_vfadd_vv_f16m2(bi, di, vl);
+        t3r = __riscv_vfsub_vv_f16m2(br, dr, vl);
+        t3i = __riscv_vfsub_vv_f16m2(bi, di, vl);
+        __riscv_vsse16_v_f16m2(pa, 16, __riscv_vfadd_vv_f16m2(t0r, t2r, vl), vl);
+        __riscv_vsse16_v_f16m2(pa + 1, 16, __riscv_vfadd_vv_f16m2(t0i, t2i, vl), vl);
+        __riscv_vsse16_v_f16m2(pa + 2, 16, __riscv_vfadd_vv_f16m2(t1r, t3i, vl), vl);
+        __riscv_vsse16_v_f16m2(pa + 3, 16, __riscv_vfsub_vv_f16m2(t1i, t3r, vl), vl);
+        __riscv_vsse16_v_f16m2(pa + 4, 16, __riscv_vfsub_vv_f16m2(t0r, t2r, vl), vl);
+        __riscv_vsse16_v_f16m2(pa + 5, 16, __riscv_vfsub_vv_f16m2(t0i, t2i, vl), vl);
+        __riscv_vsse16_v_f16m2(pa + 6, 16, __riscv_vfsub_vv_f16m2(t1r, t3i, vl), vl);
+        __riscv_vsse16_v_f16m2(pa + 7, 16, __riscv_vfadd_vv_f16m2(t1i, t3r, vl), vl);
+    }
+}
+
+/*
+ * Complex FFT of S->fftLen points of pSrc into pDst in natural order, pSrc is used as work
+ * buffer and its content is lost, pSrc and pDst must not overlap
+ */
+__STATIC_INLINE void riscv_vec_cfft_f16(const riscv_vec_cfft_instance_f16 *S, float16_t *pSrc,
+                                        float16_t *pDst, uint8_t ifftFlag)
+{
+    uint32_t fftLen = S->fftLen, L = fftLen, k;
+    const float16_t *pTw = S->pTwiddle;
+    float16_t scale = (float16_t)(1.0f / (float32_t)fftLen);
+    size_t vl;
+
+    if (ifftFlag) {
+        riscv_vec_cfft_swap_32((uint32_t *)pSrc, fftLen);
+    }
+    if (riscv_vec_cfft_has_radix2(fftLen)) {
+        riscv_vec_cfft_radix2_f16(pSrc, fftLen, pTw);
+        pTw += fftLen;
+        L >>= 1;
+    }
+    for (; L > 4; L >>= 2) {
+        riscv_vec_cfft_radix4_f16(pSrc, fftLen, L, pTw);
+        pTw += 6 * (L >> 2);
+    }
+    riscv_vec_cfft_radix4_last_f16(pSrc, fftLen);
+    riscv_vec_cfft_reorder_32((const uint32_t *)pSrc, (uint32_t *)pDst, S->pPerm, fftLen, ifftFlag);
+    if (ifftFlag) {
+        for (k = 0; k < 2 * fftLen; k += vl) {
+            vl = __riscv_vsetvl_e16m8(2 * fftLen - k);
+            __riscv_vse16_v_f16m8(pDst + k, __riscv_vfmul_vf_f16m8(__riscv_vle16_v_f16m8(pDst + k, vl), scale, vl), vl);
+        }
+    }
+}
+
+#endif /* defined(RISCV_FLOAT16_SUPPORTED) && defined(__riscv_zvfh) */
+
+/* ---------------------------------------- batch ---------------------------------------- */
+
+/*
+ * Batched FFT of frames of equal length, stored one after the other. Up to
+ * RISCV_VEC_CFFT_BATCH_MAX_LEN points, each vector lane transforms its own frame, so the
+ * vector length is the number of frames instead of the butterflies of one small stage, and
+ * the twiddles of the shared instance are scalars read once per butterfly for all lanes.
+ * Longer frames are transformed one by one.
+ *
+ * riscv_vec_cfft_batch_task_*() have the signature of smpwork_fn_t, with a batch job as arg
+ * they transform frames [begin, end), so smpwork_parallel_for() splits a batch across harts.
+ */
+
+/* longest frame transformed across vector lanes */
+#ifndef RISCV_VEC_CFFT_BATCH_MAX_LEN
+#define RISCV_VEC_CFFT_BATCH_MAX_LEN    256U
+#endif
+
+/* gather frames of 64-bit complex values into natural order, lane of vector is frame */
+__STATIC_INLINE void riscv_vec_cfft_batch_reorder_64(const uint32_t *pSrc, uint32_t *pDst, const uint32_t *pPerm,
+                                                     uint32_t fftLen, uint32_t nFrames, uint32_t swap)
+{
+    ptrdiff_t stride = (ptrdiff_t)fftLen * 8;
+    uint32_t f, k;
+    size_t vl;
+    const uint32_t *ps;
+    uint32_t *pd;
+
+    for (f = 0; f < nFrames; f += vl) {
+        vl = __riscv_vsetvl_e32m4(nFrames - f);
+        ps = pSrc + 2 * (size_t)f * fftLen;
+        pd = pDst + 2 * (size_t)f * fftLen;
+        for (k = 0; k < fftLen; k++) {
+            __riscv_vsse32_v_u32m4(pd + 2 * k, stride,
+                                   __riscv_vlse32_v_u32m4(ps + 2 * pPerm[k] + (swap ? 1 : 0), stride, vl), vl);
+            __riscv_vsse32_v_u32m4(pd + 2 * k + 1, stride,
+                                   __riscv_vlse32_v_u32m4(ps + 2 * pPerm[k] + (swap ? 0 : 1), stride, vl), vl);
+        }
+    }
+}
+
+/* gather frames of 32-bit complex values into natural order, lane of vector is frame */
+__STATIC_INLINE void riscv_vec_cfft_batch_reorder_32(const uint32_t *pSrc, uint32_t *pDst, const uint32_t *pPerm,
+                                                     uint32_t fftLen, uint32_t nFrames, uint32_t swap)
+{
+    ptrdiff_t stride = (ptrdiff_t)fftLen * 4;
+    uint32_t f, k;
+    size_t vl;
+    vuint32m4_t w;
+
+    for (f = 0; f < nFrames; f += vl) {
+        vl = __riscv_vsetvl_e32m4(nFrames - f);
+        for (k = 0; k < fftLen; k++) {
+            w = __riscv_vlse32_v_u32m4(pSrc + (size_t)f * fftLen + pPerm[k], stride, vl);
+            if (swap) {
+                w = __riscv_vor_vv_u32m4(__riscv_vsrl_vx_u32m4(w, 16, vl), __riscv_vsll_vx_u32m4(w, 16, vl), vl);
+            }
+            __riscv_vsse32_v_u32m4(pDst + (size_t)f * fftLen + k, stride, w, vl);
+        }
+    }
+}
+
+/* y = x * (wr + i * wi) of scalar twiddle */
+#define RISCV_VEC_CMUL_VF_F32(yr, yi, xr, xi, wr, wi, vl)          \
+    do {                                                            \
+        yr = __riscv_vfmul_vf_f32m2(xr, wr, vl);                    \
+        yr = __riscv_vfnmsac_vf_f32m2(yr, wi, xi, vl);              \
+        yi = __riscv_vfmul_vf_f32m2(xr, wi, vl);                    \
+        yi = __riscv_vfmacc_vf_f32m2(yi, wr, xi, vl);               \
+    } while (0)
+
+/* batch job of riscv_vec_cfft_batch_task_f32() */
+typedef struct
+{
+    const riscv_vec_cfft_instance_f32 *S;   /**< instance shared by all frames */
+    float32_t *pSrc;                        /**< frames of input, used as work buffer */
+    float32_t *pDst;                        /**< frames of output */
+    uint8_t ifftFlag;                       /**< 1 for inverse transform */
+} riscv_vec_cfft_batch_job_f32;
+
+/* radix-2 stage of vl frames from p, frames are stride bytes apart */
+__STATIC_INLINE void riscv_vec_cfft_batch_radix2_f32(float32_t *p, ptrdiff_t stride, uint32_t fftLen,
+                                                     const float32_t *pTw, size_t vl)
+{
+    uint32_t h = fftLen >> 1, j;
+    float32_t *pa, *pb;
+    vfloat32m2_t ar, ai, br, bi, tr, ti, yr, yi;
+
+    for (j = 0; j < h; j++) {
+        pa = p + 2 * j;
+        pb = pa + 2 * h;
+        ar = __riscv_vlse32_v_f32m2(pa, stride, vl);
+        ai = __riscv_vlse32_v_f32m2(pa + 1, stride, vl);
+        br = __riscv_vlse32_v_f32m2(pb, stride, vl);
+        bi = __riscv_vlse32_v_f32m2(pb + 1, stride, vl);
+        __riscv_vsse32_v_f32m2(pa, stride, __riscv_vfadd_vv_f32m2(ar, br, vl), vl);
+        __riscv_vsse32_v_f32m2(pa + 1, stride, __riscv_vfadd_vv_f32m2(ai, bi, vl), vl);
+        tr = __riscv_vfsub_vv_f32m2(ar, br, vl);
+        ti = __riscv_vfsub_vv_f32m2(ai, bi, vl);
+        if (j != 0) {
+            RISCV_VEC_CMUL_VF_F32(yr, yi, tr, ti, pTw[j], pTw[h + j], vl);
+            tr = yr;
+            ti = yi;
+        }
+        __riscv_vsse32_v_f32m2(pb, stride, tr, vl);
+        __riscv_vsse32_v_f32m2(pb + 1, stride, ti, vl);
+    }
+}
+
+/* radix-4 stage of groups of length L of vl frames from p, the twiddles of j = 0 are 1 */
+__STATIC_INLINE void riscv_vec_cfft_batch_radix4_f32(float32_t *p, ptrdiff_t stride, uint32_t fftLen,
+                                                     uint32_t L, const float32_t *pTw, size_t vl)
+{
+    uint32_t q = L >> 2, g, j;
+    float32_t *pa, *pb, *pc, *pd;
+    vfloat32m2_t ar, ai, br, bi, cr, ci, dr, di, yr, yi;
+    vfloat32m2_t t0r, t0i, t1r, t1i, t2r, t2i, t3r, t3i;
+
+    for (g = 0; g < fftLen; g += L) {
+        for (j = 0; j < q; j++) {
+            pa = p + 2 * (g + j);
+            pb = pa + 2 * q;
+            pc = pb + 2 * q;
+            pd = pc + 2 * q;
+            ar = __riscv_vlse32_v_f32m2(pa, stride, vl);
+            ai = __riscv_vlse32_v_f32m2(pa + 1, stride, vl);
+            br = __riscv_vlse32_v_f32m2(pb, stride, vl);
+            bi = __riscv_vlse32_v_f32m2(pb + 1, stride, vl);
+            cr = __riscv_vlse32_v_f32m2(pc, stride, vl);
+            ci = __riscv_vlse32_v_f32m2(pc + 1, stride, vl);
+            dr = __riscv_vlse32_v_f32m2(pd, stride, vl);
+            di = __riscv_vlse32_v_f32m2(pd + 1, stride, vl);
+            t0r = __riscv_vfadd_vv_f32m2(ar, cr, vl);
+            t0i = __riscv_vfadd_vv_f32m2(ai, ci, vl);
+            t1r = __riscv_vfsub_vv_f32m2(ar, cr, vl);
+            t1i = __riscv_vfsub_vv_f32m2(ai, ci, vl);
+            t2r = __riscv_vfadd_vv_f32m2(br, dr, vl);
+            t2i = __riscv_vfadd_vv_f32m2(bi, di, vl);
+            t3r = __riscv_vfsub_vv_f32m2(br, dr, vl);
+            t3i = __riscv_vfsub_vv_f32m2(bi, di, vl);
+            __riscv_vsse32_v_f32m2(pa, stride, __riscv_vfadd_vv_f32m2(t0r, t2r, vl), vl);
+            __riscv_vsse32_v_f32m2(pa + 1, stride, __riscv_vfadd_vv_f32m2(t0i, t2i, vl), vl);
+            ar = __riscv_vfadd_vv_f32m2(t1r, t3i, vl);
+            ai = __riscv_vfsub_vv_f32m2(t1i, t3r, vl);
+            br = __riscv_vfsub_vv_f32m2(t0r, t2r, vl);
+            bi = __riscv_vfsub_vv_f32m2(t0i, t2i, vl);
+            cr = __riscv_vfsub_vv_f32m2(t1r, t3i, vl);
+            ci = __riscv_vfadd_vv_f32m2(t1i, t3r, vl);
+            if (j != 0) {
+                RISCV_VEC_CMUL_VF_F32(yr, yi, ar, ai, pTw[j], pTw[q + j], vl);
+                ar = yr;
+                ai = yi;
+                RISCV_VEC_CMUL_VF_F32(yr, yi, br, bi, pTw[2 * q + j], pTw[3 * q + j], vl);
+                br = yr;
+                bi = yi;
+                RISCV_VEC_CMUL_VF_F32(yr, yi, cr, ci, pTw[4 * q + j], pTw[5 * q + j], vl);
+                cr = yr;
+                ci = yi;
+            }
+            __riscv_vsse32_v_f32m2(pb, stride, ar, vl);
+            __riscv_vsse32_v_f32m2(pb + 1, stride, ai, vl);
+            __riscv_vsse32_v_f32m2(pc, stride, br, vl);
+            __riscv_vsse32_v_f32m2(pc + 1, stride, bi, vl);
+            __riscv_vsse32_v_f32m2(pd, stride, cr, vl);
+            __riscv_vsse32_v_f32m2(pd + 1, stride, ci, vl);
+        }
+    }
+}
+
+/*
+ * Complex FFT of nFrames frames of S->fftLen points from pSrc into pDst in natural order,
+ * pSrc is used as work buffer and its content is lost, pSrc and pDst must not overlap
+ */
+__STATIC_INLINE void riscv_vec_cfft_batch_f32(const riscv_vec_cfft_instance_f32 *S, float32_t *pSrc,
+                                              float32_t *pDst, uint32_t nFrames, uint8_t ifftFlag)
+{
+    uint32_t fftLen = S->fftLen, L, f, k, total = 2 * nFrames * fftLen;
+    ptrdiff_t stride = (ptrdiff_t)fftLen * 8;
+    const float32_t *pTw;
+    float32_t scale = 1.0f / (float32_t)fftLen;
+    float32_t *p;
+    size_t vl;
+
+    if (fftLen > RISCV_VEC_CFFT_BATCH_MAX_LEN) {
+        for (f = 0; f < nFrames; f++) {
+            riscv_vec_cfft_f32(S, pSrc + 2 * (size_t)f * fftLen, pDst + 2 * (size_t)f * fftLen, ifftFlag);
+        }
+        return;
+    }
+    if (ifftFlag) {
+        riscv_vec_cfft_swap_64((uint32_t *)pSrc, nFrames * fftLen);
+    }
+    // all the stages run on one chunk of frames while it is in cache
+    for (f = 0; f < nFrames; f += vl) {
+        vl = __riscv_vsetvl_e32m2(nFrames - f);
+        p = pSrc + 2 * (size_t)f * fftLen;
+        pTw = S->pTwiddle;
+        L = fftLen;
+        if (riscv_vec_cfft_has_radix2(fftLen)) {
+            riscv_vec_cfft_batch_radix2_f32(p, stride, fftLen, pTw, vl);
+            pTw += fftLen;
+            L >>= 1;
+        }
+        for (; L >= 4; L >>= 2) {
+            riscv_vec_cfft_batch_radix4_f32(p, stride, fftLen, L, pTw, vl);
+            pTw += 6 * (L >> 2);
+        }
+    }
+    riscv_vec_cfft_batch_reorder_64((const uint32_t *)pSrc, (uint32_t *)pDst, S->pPerm, fftLen, nFrames, ifftFlag);
+    if (ifftFlag) {
+        for (k = 0; k < total; k += vl) {
+            vl = __riscv_vsetvl_e32m8(total - k);
+            __riscv_vse32_v_f32m8(pDst + k, __riscv_vfmul_vf_f32m8(__riscv_vle32_v_f32m8(pDst + k, vl), scale, vl), vl);
+        }
+    }
+}
+
+/* transform frames [begin, end) of the riscv_vec_cfft_batch_job_f32 arg, as smpwork_fn_t */
+__STATIC_INLINE void riscv_vec_cfft_batch_task_f32(void *arg, unsigned long begin, unsigned long end)
+{
+    const riscv_vec_cfft_batch_job_f32 *job = (const riscv_vec_cfft_batch_job_f32 *)arg;
+    size_t off = 2 * (size_t)begin * job->S->fftLen;
+
+    riscv_vec_cfft_batch_f32(job->S, job->pSrc + off, job->pDst + off, (uint32_t)(end - begin), job->ifftFlag);
+}
+
+/* y = x * (wr + i * wi) of scalar q31 twiddle */
+#define RISCV_VEC_CMUL_VX_Q31(yr, yi, xr, xi, wr, wi, vl)                                      \
+    do {                                                                                        \
+        yr = __riscv_vsub_vv_i32m2(__riscv_vmulh_vx_i32m2(xr, wr, vl), __riscv_vmulh_vx_i32m2(xi, wi, vl), vl); \
+        yi = __riscv_vadd_vv_i32m2(__riscv_vmulh_vx_i32m2(xr, wi, vl), __riscv_vmulh_vx_i32m2(xi, wr, vl), vl); \
+        yr = __riscv_vsll_vx_i32m2(yr, 1, vl);                                                  \
+        yi = __riscv_vsll_vx_i32m2(yi, 1, vl);                                                  \
+    } while (0)
+
+/* batch job of riscv_vec_cfft_batch_task_q31() */
+typedef struct
+{
+    const riscv_vec_cfft_instance_q31 *S;   /**< instance shared by all frames */
+    q31_t *pSrc;                            /**< frames of input, used as work buffer */
+    q31_t *pDst;                            /**< frames of output */
+    uint8_t ifftFlag;                       /**< 1 for inverse transform */
+} riscv_vec_cfft_batch_job_q31;
+
+/* radix-2 stage of vl frames from p, frames are stride bytes apart, scaled by 1/2 */
+__STATIC_INLINE void riscv_vec_cfft_batch_radix2_q31(q31_t *p, ptrdiff_t stride, uint32_t fftLen,
+                                                     const q31_t *pTw, size_t vl)
+{
+    uint32_t h = fftLen >> 1, j;
+    q31_t *pa, *pb;
+    vint32m2_t ar, ai, br, bi, tr, ti, yr, yi;
+
+    for (j = 0; j < h; j++) {
+        pa = p + 2 * j;
+        pb = pa + 2 * h;
+        ar = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pa, stride, vl), 1, vl);
+        ai = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pa + 1, stride, vl), 1, vl);
+        br = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pb, stride, vl), 1, vl);
+        bi = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pb + 1, stride, vl), 1, vl);
+        __riscv_vsse32_v_i32m2(pa, stride, __riscv_vadd_vv_i32m2(ar, br, vl), vl);
+        __riscv_vsse32_v_i32m2(pa + 1, stride, __riscv_vadd_vv_i32m2(ai, bi, vl), vl);
+        tr = __riscv_vsub_vv_i32m2(ar, br, vl);
+        ti = __riscv_vsub_vv_i32m2(ai, bi, vl);
+        if (j != 0) {
+            RISCV_VEC_CMUL_VX_Q31(yr, yi, tr, ti, pTw[j], pTw[h + j], vl);
+            tr = yr;
+            ti = yi;
+        }
+        __riscv_vsse32_v_i32m2(pb, stride, tr, vl);
+        __riscv_vsse32_v_i32m2(pb + 1, stride, ti, vl);
+    }
+}
+
+/* radix-4 stage of groups of length L of vl frames from p, scaled by 1/4 */
+__STATIC_INLINE void riscv_vec_cfft_batch_radix4_q31(q31_t *p, ptrdiff_t stride, uint32_t fftLen,
+                                                     uint32_t L, const q31_t *pTw, size_t vl)
+{
+    uint32_t q = L >> 2, g, j;
+    q31_t *pa, *pb, *pc, *pd;
+    vint32m2_t ar, ai, br, bi, cr, ci, dr, di, yr, yi;
+    vint32m2_t t0r, t0i, t1r, t1i, t2r, t2i, t3r, t3i;
+
+    for (g = 0; g < fftLen; g += L) {
+        for (j = 0; j < q; j++) {
+            pa = p + 2 * (g + j);
+            pb = pa + 2 * q;
+            pc = pb + 2 * q;
+            pd = pc + 2 * q;
+            ar = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pa, stride, vl), 2, vl);
+            ai = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pa + 1, stride, vl), 2, vl);
+            br = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pb, stride, vl), 2, vl);
+            bi = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pb + 1, stride, vl), 2, vl);
+            cr = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pc, stride, vl), 2, vl);
+            ci = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pc + 1, stride, vl), 2, vl);
+            dr = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pd, stride, vl), 2, vl);
+            di = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pd + 1, stride, vl), 2, vl);
+            t0r = __riscv_vadd_vv_i32m2(ar, cr, vl);
+            t0i = __riscv_vadd_vv_i32m2(ai, ci, vl);
+            t1r = __riscv_vsub_vv_i32m2(ar, cr, vl);
+            t1i = __riscv_vsub_vv_i32m2(ai, ci, vl);
+            t2r = __riscv_vadd_vv_i32m2(br, dr, vl);
+            t2i = __riscv_vadd_vv_i32m2(bi, di, vl);
+            t3r = __riscv_vsub_vv_i32m2(br, dr, vl);
+            t3i = __riscv_vsub_vv_i32m2(bi, di, vl);
+            __riscv_vsse32_v_i32m2(pa, stride, __riscv_vadd_vv_i32m2(t0r, t2r, vl), vl);
+            __riscv_vsse32_v_i32m2(pa + 1, stride, __riscv_vadd_vv_i32m2(t0i, t2i, vl), vl);
+            ar = __riscv_vadd_vv_i32m2(t1r, t3i, vl);
+            ai = __riscv_vsub_vv_i32m2(t1i, t3r, vl);
+            br = __riscv_vsub_vv_i32m2(t0r, t2r, vl);
+            bi = __riscv_vsub_vv_i32m2(t0i, t2i, vl);
+            cr = __riscv_vsub_vv_i32m2(t1r, t3i, vl);
+            ci = __riscv_vadd_vv_i32m2(t1i, t3r, vl);
+            if (j != 0) {
+                RISCV_VEC_CMUL_VX_Q31(yr, yi, ar, ai, pTw[j], pTw[q + j], vl);
+                ar = yr;
+                ai = yi;
+                RISCV_VEC_CMUL_VX_Q31(yr, yi, br, bi, pTw[2 * q + j], pTw[3 * q + j], vl);
+                br = yr;
+                bi = yi;
+                RISCV_VEC_CMUL_VX_Q31(yr, yi, cr, ci, pTw[4 * q + j], pTw[5 * q + j], vl);
+                cr = yr;
+                ci = yi;
+            }
+            __riscv_vsse32_v_i32m2(pb, stride, ar, vl);
+            __riscv_vsse32_v_i32m2(pb + 1, stride, ai, vl);
+            __riscv_vsse32_v_i32m2(pc, stride, br, vl);
+            __riscv_vsse32_v_i32m2(pc + 1, stride, bi, vl);
+            __riscv_vsse32_v_i32m2(pd, stride, cr, vl);
+            __riscv_vsse32_v_i32m2(pd + 1, stride, ci, vl);
+        }
+    }
+}
+
+/*
+ * Complex FFT of nFrames frames of S->fftLen points from pSrc into pDst in natural order,
+ * scaled by 1/fftLen, pSrc is used as work buffer and its content is lost, pSrc and pDst
+ * must not overlap
+ */
+__STATIC_INLINE void riscv_vec_cfft_batch_q31(const riscv_vec_cfft_instance_q31 *S, q31_t *pSrc,
+                                              q31_t *pDst, uint32_t nFrames, uint8_t ifftFlag)
+{
+    uint32_t fftLen = S->fftLen, L, f;
+    ptrdiff_t stride = (ptrdiff_t)fftLen * 8;
+    const q31_t *pTw;
+    q31_t *p;
+    size_t vl;
+
+    if (fftLen > RISCV_VEC_CFFT_BATCH_MAX_LEN) {
+        for (f = 0; f < nFrames; f++) {
+            riscv_vec_cfft_q31(S, pSrc + 2 * (size_t)f * fftLen, pDst + 2 * (size_t)f * fftLen, ifftFlag);
+        }
+        return;
+    }
+    if (ifftFlag) {
+        riscv_vec_cfft_swap_64((uint32_t *)pSrc, nFrames * fftLen);
+    }
+    for (f = 0; f < nFrames; f += vl) {
+        vl = __riscv_vsetvl_e32m2(nFrames - f);
+        p = pSrc + 2 * (size_t)f * fftLen;
+        pTw = S->pTwiddle;
+        L = fftLen;
+        if (riscv_vec_cfft_has_radix2(fftLen)) {
+            riscv_vec_cfft_batch_radix2_q31(p, stride, fftLen, pTw, vl);
+            pTw += fftLen;
+            L >>= 1;
+        }
+        for (; L >= 4; L >>= 2) {
+            riscv_vec_cfft_batch_radix4_q31(p, stride, fftLen, L, pTw, vl);
+            pTw += 6 * (L >> 2);
+        }
+    }
+    riscv_vec_cfft_batch_reorder_64((const uint32_t *)pSrc, (uint32_t *)pDst, S->pPerm, fftLen, nFrames, ifftFlag);
+}
+
+/* transform frames [begin, end) of the riscv_vec_cfft_batch_job_q31 arg, as smpwork_fn_t */
+__STATIC_INLINE void riscv_vec_cfft_batch_task_q31(void *arg, unsigned long begin, unsigned long end)
+{
+    const riscv_vec_cfft_batch_job_q31 *job = (const riscv_vec_cfft_batch_job_q31 *)arg;
+    size_t off = 2 * (size_t)begin * job->S->fftLen;
+
+    riscv_vec_cfft_batch_q31(job->S, job->pSrc + off, job->pDst + off, (uint32_t)(end - begin), job->ifftFlag);
+}
+
+/* y = x * (wr + i * wi) of scalar q15 twiddle */
+#define RISCV_VEC_CMUL_VX_Q15(yr, yi, xr, xi, wr, wi, vl)                                      \
+    do {                                                                                        \
+        yr = __riscv_vsub_vv_i16m2(__riscv_vmulh_vx_i16m2(xr, wr, vl), __riscv_vmulh_vx_i16m2(xi, wi, vl), vl); \
+        yi = __riscv_vadd_vv_i16m2(__riscv_vmulh_vx_i16m2(xr, wi, vl), __riscv_vmulh_vx_i16m2(xi, wr, vl), vl); \
+        yr = __riscv_vsll_vx_i16m2(yr, 1, vl);                                                  \
+        yi = __riscv_vsll_vx_i16m2(yi, 1, vl);                                                  \
+    } while (0)
+
+/* batch job of riscv_vec_cfft_batch_task_q15() */
+typedef struct
+{
+    const riscv_vec_cfft_instance_q15 *S;   /**< instance shared by all frames */
+    q15_t *pSrc;                            /**< frames of input, used as work buffer */
+    q15_t *pDst;                            /**< frames of output */
+    uint8_t ifftFlag;                       /**< 1 for inverse transform */
+} riscv_vec_cfft_batch_job_q15;
+
+/* radix-2 stage of vl frames from p, frames are stride bytes apart, scaled by 1/2 */
+__STATIC_INLINE void riscv_vec_cfft_batch_radix2_q15(q15_t *p, ptrdiff_t stride, uint32_t fftLen,
+                                                     const q15_t *pTw, size_t vl)
+{
+    uint32_t h = fftLen >> 1, j;
+    q15_t *pa, *pb;
+    vint16m2_t ar, ai, br, bi, tr, ti, yr, yi;
+
+    for (j = 0; j < h; j++) {
+        pa = p + 2 * j;
+        pb = pa + 2 * h;
+        ar = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pa, stride, vl), 1, vl);
+        ai = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pa + 1, stride, vl), 1, vl);
+        br = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pb, stride, vl), 1, vl);
+        bi = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pb + 1, stride, vl), 1, vl);
+        __riscv_vsse16_v_i16m2(pa, stride, __riscv_vadd_vv_i16m2(ar, br, vl), vl);
+        __riscv_vsse16_v_i16m2(pa + 1, stride, __riscv_vadd_vv_i16m2(ai, bi, vl), vl);
+        tr = __riscv_vsub_vv_i16m2(ar, br, vl);
+        ti = __riscv_vsub_vv_i16m2(ai, bi, vl);
+        if (j != 0) {
+            RISCV_VEC_CMUL_VX_Q15(yr, yi, tr, ti, pTw[j], pTw[h + j], vl);
+            tr = yr;
+            ti = yi;
+        }
+        __riscv_vsse16_v_i16m2(pb, stride, tr, vl);
+        __riscv_vsse16_v_i16m2(pb + 1, stride, ti, vl);
+    }
+}
+
+/* radix-4 stage of groups of length L of vl frames from p, scaled by 1/4 */
+__STATIC_INLINE void riscv_vec_cfft_batch_radix4_q15(q15_t *p, ptrdiff_t stride, uint32_t fftLen,
+                                                     uint32_t L, const q15_t *pTw, size_t vl)
+{
+    uint32_t q = L >> 2, g, j;
+    q15_t *pa, *pb, *pc, *pd;
+    vint16m2_t ar, ai, br, bi, cr, ci, dr, di, yr, yi;
+    vint16m2_t t0r, t0i, t1r, t1i, t2r, t2i, t3r, t3i;
+
+    for (g = 0; g < fftLen; g += L) {
+        for (j = 0; j < q; j++) {
+            pa = p + 2 * (g + j);
+            pb = pa + 2 * q;
+            pc = pb + 2 * q;
+            pd = pc + 2 * q;
+            ar = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pa, stride, vl), 2, vl);
+            ai = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pa + 1, stride, vl), 2, vl);
+            br = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pb, stride, vl), 2, vl);
+            bi = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pb + 1, stride, vl), 2, vl);
+            cr = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pc, stride, vl), 2, vl);
+            ci = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pc + 1, stride, vl), 2, vl);
+            dr = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pd, stride, vl), 2, vl);
+            di = __riscv_vsra_vx_i16m2(__riscv_vlse16_v_i16m2(pd + 1, stride, vl), 2, vl);
+            t0r = __riscv_vadd_vv_i16m2(ar, cr, vl);
+            t0i = __riscv_vadd_vv_i16m2(ai, ci, vl);
+            t1r = __riscv_vsub_vv_i16m2(ar, cr, vl);
+            t1i = __riscv_vsub_vv_i16m2(ai, ci, vl);
+            t2r = __riscv_vadd_vv_i16m2(br, dr, vl);
+            t2i = __riscv_vadd_vv_i16m2(bi, di, vl);
+            t3r = __riscv_vsub_vv_i16m2(br, dr, vl);
+            t3i = __riscv_vsub_vv_i16m2(bi, di, vl);
+            __riscv_vsse16_v_i16m2(pa, stride, __riscv_vadd_vv_i16m2(t0r, t2r, vl), vl);
+            __riscv_vsse16_v_i16m2(pa + 1, stride, __riscv_vadd_vv_i16m2(t0i, t2i, vl), vl);
+            ar = __riscv_vadd_vv_i16m2(t1r, t3i, vl);
+            ai = __riscv_vsub_vv_i16m2(t1i, t3r, vl);
+            br = __riscv_vsub_vv_i16m2(t0r, t2r, vl);
+            bi = __riscv_vsub_vv_i16m2(t0i, t2i, vl);
+            cr = __riscv_vsub_vv_i16m2(t1r, t3i, vl);
+            ci = __riscv_vadd_vv_i16m2(t1i, t3r, vl);
+            if (j != 0) {
+                RISCV_VEC_CMUL_VX_Q15(yr, yi, ar, ai, pTw[j], pTw[q + j], vl);
+                ar = yr;
+                ai = yi;
+                RISCV_VEC_CMUL_VX_Q15(yr, yi, br, bi, pTw[2 * q + j], pTw[3 * q + j], vl);
+                br = yr;
+                bi = yi;
+                RISCV_VEC_CMUL_VX_Q15(yr, yi, cr, ci, pTw[4 * q + j], pTw[5 * q + j], vl);
+                cr = yr;
+                ci = yi;
+            }
+            __riscv_vsse16_v_i16m2(pb, stride, ar, vl);
+            __riscv_vsse16_v_i16m2(pb + 1, stride, ai, vl);
+            __riscv_vsse16_v_i16m2(pc, stride, br, vl);
+            __riscv_vsse16_v_i16m2(pc + 1, stride, bi, vl);
+            __riscv_vsse16_v_i16m2(pd, stride, cr, vl);
+            __riscv_vsse16_v_i16m2(pd + 1, stride, ci, vl);
+        }
+    }
+}
+
+/*
+ * Complex FFT of nFrames frames of S->fftLen points from pSrc into pDst in natural order,
+ * scaled by 1/fftLen, pSrc is used as work buffer and its content is lost, pSrc and pDst
+ * must not overlap
+ */
+__STATIC_INLINE void riscv_vec_cfft_batch_q15(const riscv_vec_cfft_instance_q15 *S, q15_t *pSrc,
+                                              q15_t *pDst, uint32_t nFrames, uint8_t ifftFlag)
+{
+    uint32_t fftLen = S->fftLen, L, f;
+    ptrdiff_t stride = (ptrdiff_t)fftLen * 4;
+    const q15_t *pTw;
+    q15_t *p;
+    size_t vl;
+
+    if (fftLen > RISCV_VEC_CFFT_BATCH_MAX_LEN) {
+        for (f = 0; f < nFrames; f++) {
+            riscv_vec_cfft_q15(S, pSrc + 2 * (size_t)f * fftLen, pDst + 2 * (size_t)f * fftLen, ifftFlag);
+        }
+        return;
+    }
+    if (ifftFlag) {
+        riscv_vec_cfft_swap_32((uint32_t *)pSrc, nFrames * fftLen);
+    }
+    for (f = 0; f < nFrames; f += vl) {
+        vl = __riscv_vsetvl_e16m2(nFrames - f);
+        p = pSrc + 2 * (size_t)f * fftLen;
+        pTw = S->pTwiddle;
+        L = fftLen;
+        if (riscv_vec_cfft_has_radix2(fftLen)) {
+            riscv_vec_cfft_batch_radix2_q15(p, stride, fftLen, pTw, vl);
+            pTw += fftLen;
+            L >>= 1;
+        }
+        for (; L >= 4; L >>= 2) {
+            riscv_vec_cfft_batch_radix4_q15(p, stride, fftLen, L, pTw, vl);
+            pTw += 6 * (L >> 2);
+        }
+    }
+    riscv_vec_cfft_batch_reorder_32((const uint32_t *)pSrc, (uint32_t *)pDst, S->pPerm, fftLen, nFrames, ifftFlag);
+}
+
+/* transform frames [begin, end) of the riscv_vec_cfft_batch_job_q15 arg, as smpwork_fn_t */
+__STATIC_INLINE void riscv_vec_cfft_batch_task_q15(void *arg, unsigned long begin, unsigned long end)
+{
+    const riscv_vec_cfft_batch_job_q15 *job = (const riscv_vec_cfft_batch_job_q15 *)arg;
+    size_t off = 2 * (size_t)begin * job->S->fftLen;
+
+    riscv_vec_cfft_batch_q15(job->S, job->pSrc + off, job->pDst + off, (uint32_t)(end - begin), job->ifftFlag);
+}
 
+#endif /* defined(RISCV_MATH_VECTOR) */
 
 #ifdef   __cplusplus
 }
@@ -28,13 +28,365 @@
 
 #include "riscv_math.h"
 #include "riscv_helium_utils.h"
+#include "riscv_vec_fft.h"
 
 #ifdef   __cplusplus
 extern "C"
 {
 #endif
 
+#if defined(RISCV_MATH_VECTOR)
 
+/*
+ * Multi-channel filters
+ *
+ * The same filter runs on numChannels channels of a block, the vector lanes are channels,
+ * so the recursion of biquads, which cannot be vectorized along time, is vectorized too.
+ * A block of blockSize samples per channel is either interleaved, sample n of channel c at
+ * [n * numChannels + c], or planar, at [c * blockSize + n]. Interleaved blocks are read with
+ * unit stride, planar ones with a stride of blockSize samples. States are interleaved by
+ * channel, so they are read with unit stride in both layouts.
+ *
+ * Coefficients follow the single channel functions: FIR coefficients are time reversed as
+ * for riscv_fir_f32(), biquad stages are {b0, b1, b2, a1, a2} with a1 and a2 negated as for
+ * riscv_biquad_cascade_df1_f32() and riscv_biquad_cascade_df2T_f32().
+ */
+
+#define RISCV_VEC_MC_INTERLEAVED    0U      /**< sample n of channel c at [n * numChannels + c] */
+#define RISCV_VEC_MC_PLANAR         1U      /**< sample n of channel c at [c * blockSize + n] */
+
+typedef struct
+{
+    uint16_t numChannels;           /**< number of channels */
+    uint16_t numTaps;               /**< number of filter coefficients */
+    float32_t *pState;              /**< (numTaps + blockSize - 1) * numChannels samples */
+    const float32_t *pCoeffs;       /**< numTaps coefficients, time reversed */
+} riscv_vec_fir_mc_instance_f32;
+
+typedef struct
+{
+    uint16_t numChannels;           /**< number of channels */
+    uint16_t numStages;             /**< number of 2nd order stages */
+    float32_t *pState;              /**< 4 * numStages * numChannels, x[n-1], x[n-2], y[n-1], y[n-2] of each stage */
+    const float32_t *pCoeffs;       /**< 5 * numStages coefficients */
+} riscv_vec_biquad_mc_df1_instance_f32;
+
+typedef struct
+{
+    uint16_t numChannels;           /**< number of channels */
+    uint16_t numStages;             /**< number of 2nd order stages */
+    float32_t *pState;              /**< 2 * numStages * numChannels, d1 and d2 of each stage */
+    const float32_t *pCoeffs;       /**< 5 * numStages coefficients */
+} riscv_vec_biquad_mc_df2T_instance_f32;
+
+/* load sample n of channels [c, c + vl) of a block */
+__STATIC_INLINE vfloat32m2_t riscv_vec_mc_load_f32(const float32_t *p, uint32_t n, uint32_t c, uint32_t numChannels,
+                                                   uint32_t blockSize, uint32_t layout, size_t vl)
+{
+    if (layout == RISCV_VEC_MC_PLANAR) {
+        return __riscv_vlse32_v_f32m2(p + c * blockSize + n, (ptrdiff_t)blockSize * 4, vl);
+    }
+    return __riscv_vle32_v_f32m2(p + n * numChannels + c, vl);
+}
+
+/* store sample n of channels [c, c + vl) of a block */
+__STATIC_INLINE void riscv_vec_mc_store_f32(float32_t *p, uint32_t n, uint32_t c, uint32_t numChannels,
+                                            uint32_t blockSize, uint32_t layout, vfloat32m2_t v, size_t vl)
+{
+    if (layout == RISCV_VEC_MC_PLANAR) {
+        __riscv_vsse32_v_f32m2(p + c * blockSize + n, (ptrdiff_t)blockSize * 4, v, vl);
+    } else {
+        __riscv_vse32_v_f32m2(p + n * numChannels + c, v, vl);
+    }
+}
+
+/* set up S, pState of (numTaps + blockSize - 1) * numChannels samples is cleared */
+__STATIC_INLINE void riscv_vec_fir_mc_init_f32(riscv_vec_fir_mc_instance_f32 *S, uint16_t numChannels,
+                                               uint16_t numTaps, const float32_t *pCoeffs, float32_t *pState,
+                                               uint32_t blockSize)
+{
+    S->numChannels = numChannels;
+    S->numTaps = numTaps;
+    S->pCoeffs = pCoeffs;
+    S->pState = pState;
+    memset(pState, 0, (numTaps + blockSize - 1U) * numChannels * sizeof(float32_t));
+}
+
+/* FIR of blockSize samples of all channels, blockSize up to the one given to init */
+__STATIC_INLINE void riscv_vec_fir_mc_f32(const riscv_vec_fir_mc_instance_f32 *S, const float32_t *pSrc,
+                                          float32_t *pDst, uint32_t blockSize, uint32_t layout)
+{
+    uint32_t C = S->numChannels, T = S->numTaps, n, k, c;
+    float32_t *pState = S->pState, *pNew = pState + (T - 1U) * C;
+    const float32_t *pCoeffs = S->pCoeffs, *px;
+    size_t vl;
+    vfloat32m2_t acc;
+
+    // new samples go after the history of numTaps - 1 samples, interleaved
+    for (c = 0; c < C; c += vl) {
+        vl = __riscv_vsetvl_e32m2(C - c);
+        for (n = 0; n < blockSize; n++) {
+            __riscv_vse32_v_f32m2(pNew + n * C + c, riscv_vec_mc_load_f32(pSrc, n, c, C, blockSize, layout, vl), vl);
+        }
+    }
+    for (c = 0; c < C; c += vl) {
+        vl = __riscv_vsetvl_e32m2(C - c);
+        for (n = 0; n < blockSize; n++) {
+            px = pState + n * C + c;
+            acc = __riscv_vfmul_vf_f32m2(__riscv_vle32_v_f32m2(px, vl), pCoeffs[0], vl);
+            for (k = 1; k < T; k++) {
+                acc = __riscv_vfmacc_vf_f32m2(acc, pCoeffs[k], __riscv_vle32_v_f32m2(px + k * C, vl), vl);
+            }
+            riscv_vec_mc_store_f32(pDst, n, c, C, blockSize, layout, acc, vl);
+        }
+    }
+    memmove(pState, pState + blockSize * C, (T - 1U) * C * sizeof(float32_t));
+}
+
+/* set up S, pState of 4 * numStages * numChannels samples is cleared */
+__STATIC_INLINE void riscv_vec_biquad_mc_df1_init_f32(riscv_vec_biquad_mc_df1_instance_f32 *S, uint16_t numChannels,
+                                                      uint16_t numStages, const float32_t *pCoeffs, float32_t *pState)
+{
+    S->numChannels = numChannels;
+    S->numStages = numStages;
+    S->pCoeffs = pCoeffs;
+    S->pState = pState;
+    memset(pState, 0, 4U * numStages * numChannels * sizeof(float32_t));
+}
+
+/* cascade of biquads in direct form I on blockSize samples of all channels, pSrc and pDst can be the same */
+__STATIC_INLINE void riscv_vec_biquad_mc_df1_f32(const riscv_vec_biquad_mc_df1_instance_f32 *S, const float32_t *pSrc,
+                                                 float32_t *pDst, uint32_t blockSize, uint32_t layout)
+{
+    uint32_t C = S->numChannels, n, s, c;
+    const float32_t *pCoeffs, *pIn;
+    float32_t *pState, b0, b1, b2, a1, a2;
+    size_t vl;
+    vfloat32m2_t x, x1, x2, y, y1, y2;
+
+    for (c = 0; c < C; c += vl) {
+        vl = __riscv_vsetvl_e32m2(C - c);
+        pCoeffs = S->pCoeffs;
+        pState = S->pState + c;
+        pIn = pSrc;
+        // whole block runs through a stage before the next one, in place in pDst
+        for (s = 0; s < S->numStages; s++) {
+            b0 = pCoeffs[0];
+            b1 = pCoeffs[1];
+            b2 = pCoeffs[2];
+            a1 = pCoeffs[3];
+            a2 = pCoeffs[4];
+            x1 = __riscv_vle32_v_f32m2(pState, vl);
+            x2 = __riscv_vle32_v_f32m2(pState + C, vl);
+            y1 = __riscv_vle32_v_f32m2(pState + 2 * C, vl);
+            y2 = __riscv_vle32_v_f32m2(pState + 3 * C, vl);
+            for (n = 0; n < blockSize; n++) {
+                x = riscv_vec_mc_load_f32(pIn, n, c, C, blockSize, layout, vl);
+                y = __riscv_vfmul_vf_f32m2(x, b0, vl);
+                y = __riscv_vfmacc_vf_f32m2(y, b1, x1, vl);
+                y = __riscv_vfmacc_vf_f32m2(y, b2, x2, vl);
+                y = __riscv_vfmacc_vf_f32m2(y, a1, y1, vl);
+                y = __riscv_vfmacc_vf_f32m2(y, a2, y2, vl);
+                x2 = x1;
+                x1 = x;
+                y2 = y1;
+                y1 = y;
+                riscv_vec_mc_store_f32(pDst, n, c, C, blockSize, layout, y, vl);
+            }
+            __riscv_vse32_v_f32m2(pState, x1, vl);
+            __riscv_vse32_v_f32m2(pState + C, x2, vl);
+            __riscv_vse32_v_f32m2(pState + 2 * C, y1, vl);
+            __riscv_vse32_v_f32m2(pState + 3 * C, y2, vl);
+            pState += 4 * C;
+            pCoeffs += 5;
+            pIn = pDst;
+        }
+    }
+}
+
+/* set up S, pState of 2 * numStages * numChannels samples is cleared */
+__STATIC_INLINE void riscv_vec_biquad_mc_df2T_init_f32(riscv_vec_biquad_mc_df2T_instance_f32 *S, uint16_t numChannels,
+                                                       uint16_t numStages, const float32_t *pCoeffs, float32_t *pState)
+{
+    S->numChannels = numChannels;
+    S->numStages = numStages;
+    S->pCoeffs = pCoeffs;
+    S->pState = pState;
+    memset(pState, 0, 2U * numStages * numChannels * sizeof(float32_t));
+}
+
+/*
+ * Cascade of biquads in transposed direct form II on blockSize samples of all channels,
+ * pSrc and pDst can be the same. DF2T keeps 2 states per stage instead of 4, and the new
+ * states depend on y by one multiply-add, so its chain is shorter than DF1
+ */
+__STATIC_INLINE void riscv_vec_biquad_mc_df2T_f32(const riscv_vec_biquad_mc_df2T_instance_f32 *S, const float32_t *pSrc,
+                                                  float32_t *pDst, uint32_t blockSize, uint32_t layout)
+{
+    uint32_t C = S->numChannels, n, s, c;
+    const float32_t *pCoeffs, *pIn;
+    float32_t *pState, b0, b1, b2, a1, a2;
+    size_t vl;
+    vfloat32m2_t x, y, d1, d2;
+
+    for (c = 0; c < C; c += vl) {
+        vl = __riscv_vsetvl_e32m2(C - c);
+        pCoeffs = S->pCoeffs;
+        pState = S->pState + c;
+        pIn = pSrc;
+        for (s = 0; s < S->numStages; s++) {
+            b0 = pCoeffs[0];
+            b1 = pCoeffs[1];
+            b2 = pCoeffs[2];
+            a1 = pCoeffs[3];
+            a2 = pCoeffs[4];
+            d1 = __riscv_vle32_v_f32m2(pState, vl);
+            d2 = __riscv_vle32_v_f32m2(pState + C, vl);
+            for (n = 0; n < blockSize; n++) {
+                x = riscv_vec_mc_load_f32(pIn, n, c, C, blockSize, layout, vl);
+                // y = b0 * x + d1, d1 = b1 * x + a1 * y + d2, d2 = b2 * x + a2 * y
+                y = __riscv_vfmacc_vf_f32m2(d1, b0, x, vl);
+                d1 = __riscv_vfmacc_vf_f32m2(__riscv_vfmacc_vf_f32m2(d2, b1, x, vl), a1, y, vl);
+                d2 = __riscv_vfmacc_vf_f32m2(__riscv_vfmul_vf_f32m2(x, b2, vl), a2, y, vl);
+                riscv_vec_mc_store_f32(pDst, n, c, C, blockSize, layout, y, vl);
+            }
+            __riscv_vse32_v_f32m2(pState, d1, vl);
+            __riscv_vse32_v_f32m2(pState + C, d2, vl);
+            pState += 2 * C;
+            pCoeffs += 5;
+            pIn = pDst;
+        }
+    }
+}
+
+/*
+ * Long FIR by uniformly partitioned overlap-save convolution
+ *
+ * The numTaps coefficients are cut into numParts partitions of blockSize taps, the spectrum
+ * of each one, zero padded to fftLen = 2 * blockSize, is computed once by init. Each call
+ * takes blockSize new samples, the real FFT of the last fftLen input samples enters a
+ * frequency delay line of numParts spectra, and the output is the second half of the inverse
+ * FFT of sum of partition p times the spectrum of p blocks ago. A block costs 2 real FFTs of
+ * fftLen and numParts complex products of blockSize bins instead of numTaps MACs per sample,
+ * while the latency stays blockSize samples.
+ *
+ * Buffers given to init:
+ * - pTwiddle of riscv_vec_rfft_twiddle_size(fftLen) and pPerm of blockSize entries
+ * - pFilter and pFdl of RISCV_VEC_FIR_FFT_SPECTRA_SIZE(numTaps, blockSize) samples
+ * - pBuf of 3 * fftLen samples: last fftLen input samples then 2 work buffers
+ */
+
+#define RISCV_VEC_FIR_FFT_PARTS(numTaps, blockSize)         (((numTaps) + (blockSize) - 1U) / (blockSize))
+#define RISCV_VEC_FIR_FFT_SPECTRA_SIZE(numTaps, blockSize)  (RISCV_VEC_FIR_FFT_PARTS(numTaps, blockSize) * 2U * (blockSize))
+
+typedef struct
+{
+    uint32_t blockSize;                     /**< samples of one call, half of fftLen */
+    uint32_t numParts;                      /**< number of partitions of the filter */
+    uint32_t pos;                           /**< slot of pFdl holding the newest spectrum */
+    riscv_vec_rfft_instance_f32 rfft;       /**< real FFT of fftLen */
+    float32_t *pFilter;                     /**< numParts spectra of partitions */
+    float32_t *pFdl;                        /**< numParts spectra of past input blocks */
+    float32_t *pBuf;                        /**< input history and work buffers, 3 * fftLen */
+} riscv_vec_fir_fft_instance_f32;
+
+/* acc = acc + x * h on spectra of fftLen packed as riscv_rfft_fast_f32(), acc = x * h if clear */
+__STATIC_INLINE void riscv_vec_fir_fft_cmac_f32(float32_t *acc, const float32_t *x, const float32_t *h,
+                                                uint32_t fftLen, uint8_t clear)
+{
+    uint32_t m = (fftLen >> 1) - 1U, k;
+    float32_t *pa;
+    const float32_t *px, *ph;
+    size_t vl;
+    vfloat32m2_t xr, xi, hr, hi, yr, yi;
+
+    // X[0] and X[N/2] are real, packed in the first 2 samples
+    acc[0] = (clear ? 0.0f : acc[0]) + x[0] * h[0];
+    acc[1] = (clear ? 0.0f : acc[1]) + x[1] * h[1];
+    for (k = 0; k < m; k += vl) {
+        vl = __riscv_vsetvl_e32m2(m - k);
+        pa = acc + 2 * (k + 1);
+        px = x + 2 * (k + 1);
+        ph = h + 2 * (k + 1);
+        xr = __riscv_vlse32_v_f32m2(px, 8, vl);
+        xi = __riscv_vlse32_v_f32m2(px + 1, 8, vl);
+        hr = __riscv_vlse32_v_f32m2(ph, 8, vl);
+        hi = __riscv_vlse32_v_f32m2(ph + 1, 8, vl);
+        if (clear) {
+            yr = __riscv_vfmul_vv_f32m2(xr, hr, vl);
+            yi = __riscv_vfmul_vv_f32m2(xr, hi, vl);
+        } else {
+            yr = __riscv_vfmacc_vv_f32m2(__riscv_vlse32_v_f32m2(pa, 8, vl), xr, hr, vl);
+            yi = __riscv_vfmacc_vv_f32m2(__riscv_vlse32_v_f32m2(pa + 1, 8, vl), xr, hi, vl);
+        }
+        yr = __riscv_vfnmsac_vv_f32m2(yr, xi, hi, vl);
+        yi = __riscv_vfmacc_vv_f32m2(yi, xi, hr, vl);
+        __riscv_vsse32_v_f32m2(pa, 8, yr, vl);
+        __riscv_vsse32_v_f32m2(pa + 1, 8, yi, vl);
+    }
+}
+
+/*
+ * Set up S for numTaps coefficients, time reversed as for riscv_fir_f32(), processed in calls
+ * of blockSize samples, blockSize is a power of 2 from 4 to RISCV_VEC_CFFT_MAX_LEN, input
+ * history and delay line are cleared, return RISCV_MATH_ARGUMENT_ERROR for unsupported sizes
+ */
+__STATIC_INLINE riscv_status riscv_vec_fir_fft_init_f32(riscv_vec_fir_fft_instance_f32 *S, uint32_t numTaps,
+                                                        const float32_t *pCoeffs, uint32_t blockSize,
+                                                        float32_t *pTwiddle, uint32_t *pPerm, float32_t *pFilter,
+                                                        float32_t *pFdl, float32_t *pBuf)
+{
+    uint32_t fftLen = 2U * blockSize, p, k, n;
+    float32_t *pTmp = pBuf + fftLen;
+
+    if ((numTaps == 0U) || (blockSize < 4U) ||
+        (riscv_vec_rfft_init_f32(&S->rfft, fftLen, pTwiddle, pPerm) != RISCV_MATH_SUCCESS)) {
+        return RISCV_MATH_ARGUMENT_ERROR;
+    }
+    S->blockSize = blockSize;
+    S->numParts = RISCV_VEC_FIR_FFT_PARTS(numTaps, blockSize);
+    S->pos = 0;
+    S->pFilter = pFilter;
+    S->pFdl = pFdl;
+    S->pBuf = pBuf;
+    for (p = 0; p < S->numParts; p++) {
+        memset(pTmp, 0, fftLen * sizeof(float32_t));
+        for (k = 0; k < blockSize; k++) {
+            n = p * blockSize + k;
+            if (n < numTaps) {
+                pTmp[k] = pCoeffs[numTaps - 1U - n];
+            }
+        }
+        riscv_vec_rfft_f32(&S->rfft, pTmp, pFilter + p * fftLen, 0);
+    }
+    memset(pFdl, 0, S->numParts * fftLen * sizeof(float32_t));
+    memset(pBuf, 0, fftLen * sizeof(float32_t));
+    return RISCV_MATH_SUCCESS;
+}
+
+/* filter S->blockSize samples of pSrc into pDst, same result as riscv_fir_f32() on the stream */
+__STATIC_INLINE void riscv_vec_fir_fft_f32(riscv_vec_fir_fft_instance_f32 *S, const float32_t *pSrc, float32_t *pDst)
+{
+    uint32_t B = S->blockSize, fftLen = 2U * B, P = S->numParts, p, slot;
+    float32_t *pIn = S->pBuf, *pAcc = pIn + fftLen, *pOut = pAcc + fftLen;
+
+    // slide input by one block, its spectrum takes the slot of the oldest one
+    memcpy(pIn, pIn + B, B * sizeof(float32_t));
+    memcpy(pIn + B, pSrc, B * sizeof(float32_t));
+    memcpy(pAcc, pIn, fftLen * sizeof(float32_t));
+    S->pos = (S->pos == 0U) ? (P - 1U) : (S->pos - 1U);
+    riscv_vec_rfft_f32(&S->rfft, pAcc, S->pFdl + S->pos * fftLen, 0);
+
+    for (p = 0, slot = S->pos; p < P; p++) {
+        riscv_vec_fir_fft_cmac_f32(pAcc, S->pFdl + slot * fftLen, S->pFilter + p * fftLen, fftLen, p == 0U);
+        slot = (slot + 1U == P) ? 0U : (slot + 1U);
+    }
+    // first half of the circular convolution is aliased, the second half is the output
+    riscv_vec_rfft_f32(&S->rfft, pAcc, pOut, 1);
+    memcpy(pDst, pOut + B, B * sizeof(float32_t));
+}
+
+#endif /* defined(RISCV_MATH_VECTOR) */
 
 #ifdef   __cplusplus
 }
@@ -0,0 +1,346 @@
+/******************************************************************************
+ * @file     riscv_vec_interp.h
+ * @brief    Private header file for NMSIS DSP Library
+ * @version  V1.10.0
+ * @date     08 July 2021
+ ******************************************************************************/
+/*
+ * Copyright (c) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _RISCV_VEC_INTERP_H_
+#define _RISCV_VEC_INTERP_H_
+
+#include "riscv_math.h"
+
+#ifdef   __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Batch interpolation against fixed tables
+ *
+ * Each function interpolates an array of points against one table, as the single point
+ * functions of interpolation_functions.h do for each point. Lanes are points, the table
+ * values around each point are gathered by indexed loads.
+ *
+ * - riscv_linear_interp_batch_f32(): the plan of riscv_linear_interp_plan_init_f32() keeps
+ *   1 / xSpacing, so a point is t = (x - x1) / xSpacing by one multiply, then
+ *   y[i] + (t - i) * (y[i + 1] - y[i]), points out of the table give its first or last value,
+ *   the results can differ from riscv_linear_interp_f32() in the last bits
+ * - riscv_linear_interp_batch_q31() / riscv_linear_interp_batch_q15(): x in 12.20, the same
+ *   bits as riscv_linear_interp_q31() and riscv_linear_interp_q15()
+ * - riscv_bilinear_interp_batch_f32(): as riscv_bilinear_interp_f32(), 0 for points out of
+ *   the table, the results can differ in the last bit by fused multiply add
+ *
+ * Tables have at least 2 values in each dimension. The q15 vector path needs 64-bit
+ * elements, other cores run the same arithmetic per point.
+ */
+
+#if defined(RISCV_MATH_VECTOR) && defined(__riscv_v_elen_fp) && (__riscv_v_elen_fp >= 32)
+#define RISCV_VEC_INTERP_VECTORF        1
+#endif
+
+#if defined(RISCV_MATH_VECTOR) && defined(__riscv_v_elen) && (__riscv_v_elen >= 64)
+#define RISCV_VEC_INTERP_VECTOR64       1
+#endif
+
+/* ---------------------------------------- f32 ---------------------------------------- */
+
+typedef struct
+{
+    uint32_t nValues;               /**< number of table values */
+    float32_t x1;                   /**< x of the first value */
+    float32_t invSpacing;           /**< 1 / xSpacing */
+    const float32_t *pYData;        /**< table of y values */
+} riscv_linear_interp_plan_f32;
+
+/* Set up P from the table of S */
+__STATIC_INLINE void riscv_linear_interp_plan_init_f32(riscv_linear_interp_plan_f32 *P,
+                                                       const riscv_linear_interp_instance_f32 *S)
+{
+    P->nValues = S->nValues;
+    P->x1 = S->x1;
+    P->invSpacing = 1.0f / S->xSpacing;
+    P->pYData = S->pYData;
+}
+
+/**
+ * @brief  Linear interpolation of an array of points
+ * @param[in]  P           plan of riscv_linear_interp_plan_init_f32()
+ * @param[in]  pX          points
+ * @param[out] pDst        interpolated values, can be pX
+ * @param[in]  blockSize   number of points
+ */
+__STATIC_INLINE void riscv_linear_interp_batch_f32(const riscv_linear_interp_plan_f32 *P, const float32_t *pX,
+                                                   float32_t *pDst, uint32_t blockSize)
+{
+    const float32_t *pY = P->pYData;
+    float32_t tMax = (float32_t)(P->nValues - 1);
+    uint32_t iMax = P->nValues - 2;
+
+#if defined(RISCV_VEC_INTERP_VECTORF)
+    size_t vl;
+    vfloat32m4_t t, y0, y1;
+    vuint32m4_t i, off;
+    vbool8_t last;
+
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e32m4(blockSize);
+        t = __riscv_vfmul_vf_f32m4(__riscv_vfsub_vf_f32m4(__riscv_vle32_v_f32m4(pX, vl), P->x1, vl),
+                                   P->invSpacing, vl);
+        t = __riscv_vfmin_vf_f32m4(__riscv_vfmax_vf_f32m4(t, 0.0f, vl), tMax, vl);
+        last = __riscv_vmfge_vf_f32m4_b8(t, tMax, vl);
+        i = __riscv_vminu_vx_u32m4(__riscv_vfcvt_rtz_xu_f_v_u32m4(t, vl), iMax, vl);
+        t = __riscv_vfsub_vv_f32m4(t, __riscv_vfcvt_f_xu_v_f32m4(i, vl), vl);
+        off = __riscv_vsll_vx_u32m4(i, 2, vl);
+        y0 = __riscv_vluxei32_v_f32m4(pY, off, vl);
+        y1 = __riscv_vluxei32_v_f32m4(pY + 1, off, vl);
+        y0 = __riscv_vfmacc_vv_f32m4(y0, t, __riscv_vfsub_vv_f32m4(y1, y0, vl), vl);
+        __riscv_vse32_v_f32m4(pDst, __riscv_vfmerge_vfm_f32m4(y0, pY[iMax + 1], last, vl), vl);
+        pX += vl;
+        pDst += vl;
+    }
+#else
+    float32_t t;
+    uint32_t i;
+
+    for (; blockSize > 0; blockSize--) {
+        t = (*pX++ - P->x1) * P->invSpacing;
+        if (t <= 0.0f) {
+            *pDst++ = pY[0];
+        } else if (t >= tMax) {
+            *pDst++ = pY[iMax + 1];
+        } else {
+            i = (uint32_t)t;
+            i = (i > iMax) ? iMax : i;
+            t -= (float32_t)i;
+            *pDst++ = pY[i] + t * (pY[i + 1] - pY[i]);
+        }
+    }
+#endif /* defined(RISCV_VEC_INTERP_VECTORF) */
+}
+
+/**
+ * @brief  Bilinear interpolation of an array of points
+ * @param[in]  S           table
+ * @param[in]  pX          column coordinates
+ * @param[in]  pY          row coordinates
+ * @param[out] pDst        interpolated values
+ * @param[in]  blockSize   number of points
+ */
+__STATIC_INLINE void riscv_bilinear_interp_batch_f32(const riscv_bilinear_interp_instance_f32 *S, const float32_t *pX,
+                                                     const float32_t *pY, float32_t *pDst, uint32_t blockSize)
+{
+    const float32_t *pData = S->pData;
+    int32_t nCols = S->numCols, colMax = S->numCols - 2, rowMax = S->numRows - 2;
+
+#if defined(RISCV_VEC_INTERP_VECTORF)
+    size_t vl;
+    vfloat32m4_t x, y, f00, f01, f10, f11, out;
+    vint32m4_t xi, yi;
+    vuint32m4_t off;
+    vbool8_t ok;
+
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e32m4(blockSize);
+        x = __riscv_vle32_v_f32m4(pX, vl);
+        y = __riscv_vle32_v_f32m4(pY, vl);
+        // indexes truncated toward zero as the single point function, the ones out of the table give 0
+        xi = __riscv_vfcvt_rtz_x_f_v_i32m4(x, vl);
+        yi = __riscv_vfcvt_rtz_x_f_v_i32m4(y, vl);
+        ok = __riscv_vmand_mm_b8(__riscv_vmsge_vx_i32m4_b8(xi, 0, vl), __riscv_vmsle_vx_i32m4_b8(xi, colMax, vl), vl);
+        ok = __riscv_vmand_mm_b8(ok, __riscv_vmsge_vx_i32m4_b8(yi, 0, vl), vl);
+        ok = __riscv_vmand_mm_b8(ok, __riscv_vmsle_vx_i32m4_b8(yi, rowMax, vl), vl);
+        xi = __riscv_vmin_vx_i32m4(__riscv_vmax_vx_i32m4(xi, 0, vl), colMax, vl);
+        yi = __riscv_vmin_vx_i32m4(__riscv_vmax_vx_i32m4(yi, 0, vl), rowMax, vl);
+        x = __riscv_vfsub_vv_f32m4(x, __riscv_vfcvt_f_x_v_f32m4(xi, vl), vl);
+        y = __riscv_vfsub_vv_f32m4(y, __riscv_vfcvt_f_x_v_f32m4(yi, vl), vl);
+        off = __riscv_vsll_vx_u32m4(__riscv_vreinterpret_v_i32m4_u32m4(__riscv_vmacc_vx_i32m4(xi, nCols, yi, vl)),
+                                    2, vl);
+        f00 = __riscv_vluxei32_v_f32m4(pData, off, vl);
+        f01 = __riscv_vluxei32_v_f32m4(pData + 1, off, vl);
+        f10 = __riscv_vluxei32_v_f32m4(pData + nCols, off, vl);
+        f11 = __riscv_vluxei32_v_f32m4(pData + nCols + 1, off, vl);
+        // f00 + (f01 - f00) * x + (f10 - f00) * y + (f00 - f01 - f10 + f11) * x * y
+        f11 = __riscv_vfsub_vv_f32m4(__riscv_vfadd_vv_f32m4(f00, f11, vl), __riscv_vfadd_vv_f32m4(f01, f10, vl), vl);
+        out = __riscv_vfmacc_vv_f32m4(f00, x, __riscv_vfsub_vv_f32m4(f01, f00, vl), vl);
+        out = __riscv_vfmacc_vv_f32m4(out, y, __riscv_vfsub_vv_f32m4(f10, f00, vl), vl);
+        out = __riscv_vfmacc_vv_f32m4(out, __riscv_vfmul_vv_f32m4(x, y, vl), f11, vl);
+        __riscv_vse32_v_f32m4(pDst, __riscv_vfmerge_vfm_f32m4(out, 0.0f, __riscv_vmnot_m_b8(ok, vl), vl), vl);
+        pX += vl;
+        pY += vl;
+        pDst += vl;
+    }
+#else
+    const float32_t *p;
+    float32_t x, y, f00, f01, f10, f11;
+    int32_t xi, yi;
+
+    for (; blockSize > 0; blockSize--) {
+        x = *pX++;
+        y = *pY++;
+        xi = (int32_t)x;
+        yi = (int32_t)y;
+        if ((xi < 0) || (xi > colMax) || (yi < 0) || (yi > rowMax)) {
+            *pDst++ = 0.0f;
+            continue;
+        }
+        p = pData + xi + yi * nCols;
+        f00 = p[0];
+        f01 = p[1];
+        f10 = p[nCols];
+        f11 = p[nCols + 1];
+        x -= (float32_t)xi;
+        y -= (float32_t)yi;
+        *pDst++ = f00 + (f01 - f00) * x + (f10 - f00) * y + (f00 - f01 - f10 + f11) * x * y;
+    }
+#endif /* defined(RISCV_VEC_INTERP_VECTORF) */
+}
+
+/* ------------------------------------- fixed point ------------------------------------ */
+
+/**
+ * @brief  Q31 linear interpolation of an array of points
+ * @param[in]  pYData      table of nValues values
+ * @param[in]  nValues     number of table values, at most 2^12
+ * @param[in]  pX          points in 12.20
+ * @param[out] pDst        interpolated values
+ * @param[in]  blockSize   number of points
+ */
+__STATIC_INLINE void riscv_linear_interp_batch_q31(const q31_t *pYData, uint32_t nValues, const q31_t *pX,
+                                                   q31_t *pDst, uint32_t blockSize)
+{
+    int32_t iMax = (int32_t)nValues - 2;
+
+#if defined(RISCV_MATH_VECTOR)
+    size_t vl;
+    vint32m4_t x, i, fract, y;
+    vuint32m4_t off;
+    vbool8_t lo, hi;
+
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e32m4(blockSize);
+        x = __riscv_vle32_v_i32m4(pX, vl);
+        i = __riscv_vsra_vx_i32m4(x, 20, vl);
+        lo = __riscv_vmslt_vx_i32m4_b8(i, 0, vl);
+        hi = __riscv_vmsgt_vx_i32m4_b8(i, iMax, vl);
+        i = __riscv_vmin_vx_i32m4(__riscv_vmax_vx_i32m4(i, 0, vl), iMax, vl);
+        off = __riscv_vsll_vx_u32m4(__riscv_vreinterpret_v_i32m4_u32m4(i), 2, vl);
+        fract = __riscv_vsll_vx_i32m4(__riscv_vand_vx_i32m4(x, 0x000FFFFF, vl), 11, vl);
+        // high words of y0 * (1 - fract) and y1 * fract, as the q63 products >> 32
+        y = __riscv_vmulh_vv_i32m4(__riscv_vluxei32_v_i32m4(pYData, off, vl),
+                                   __riscv_vrsub_vx_i32m4(fract, 0x7FFFFFFF, vl), vl);
+        y = __riscv_vadd_vv_i32m4(y, __riscv_vmulh_vv_i32m4(__riscv_vluxei32_v_i32m4(pYData + 1, off, vl),
+                                                            fract, vl), vl);
+        y = __riscv_vsll_vx_i32m4(y, 1, vl);
+        y = __riscv_vmerge_vxm_i32m4(y, pYData[0], lo, vl);
+        __riscv_vse32_v_i32m4(pDst, __riscv_vmerge_vxm_i32m4(y, pYData[iMax + 1], hi, vl), vl);
+        pX += vl;
+        pDst += vl;
+    }
+#else
+    q31_t x, fract, y;
+    int32_t i;
+
+    for (; blockSize > 0; blockSize--) {
+        x = *pX++;
+        i = x >> 20;
+        if (i > iMax) {
+            *pDst++ = pYData[iMax + 1];
+        } else if (i < 0) {
+            *pDst++ = pYData[0];
+        } else {
+            fract = (x & 0x000FFFFF) << 11;
+            y = (q31_t)(((q63_t)pYData[i] * (0x7FFFFFFF - fract)) >> 32);
+            y += (q31_t)(((q63_t)pYData[i + 1] * fract) >> 32);
+            *pDst++ = (q31_t)((uint32_t)y << 1U);
+        }
+    }
+#endif /* defined(RISCV_MATH_VECTOR) */
+}
+
+/**
+ * @brief  Q15 linear interpolation of an array of points
+ * @param[in]  pYData      table of nValues values
+ * @param[in]  nValues     number of table values, at most 2^12
+ * @param[in]  pX          points in 12.20
+ * @param[out] pDst        interpolated values
+ * @param[in]  blockSize   number of points
+ */
+__STATIC_INLINE void riscv_linear_interp_batch_q15(const q15_t *pYData, uint32_t nValues, const q31_t *pX,
+                                                   q15_t *pDst, uint32_t blockSize)
+{
+    int32_t iMax = (int32_t)nValues - 2;
+
+#if defined(RISCV_VEC_INTERP_VECTOR64)
+    size_t vl;
+    vint32m2_t x, i, fract;
+    vuint32m2_t off;
+    vint64m4_t acc;
+    vint16m1_t y;
+    vbool16_t lo, hi;
+
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e32m2(blockSize);
+        x = __riscv_vle32_v_i32m2(pX, vl);
+        i = __riscv_vsra_vx_i32m2(x, 20, vl);
+        lo = __riscv_vmslt_vx_i32m2_b16(i, 0, vl);
+        hi = __riscv_vmsgt_vx_i32m2_b16(i, iMax, vl);
+        i = __riscv_vmin_vx_i32m2(__riscv_vmax_vx_i32m2(i, 0, vl), iMax, vl);
+        off = __riscv_vsll_vx_u32m2(__riscv_vreinterpret_v_i32m2_u32m2(i), 1, vl);
+        fract = __riscv_vand_vx_i32m2(x, 0x000FFFFF, vl);
+        // y0 * (1 - fract) + y1 * fract in q35, the products need 64 bits
+        acc = __riscv_vwmul_vv_i64m4(__riscv_vsext_vf2_i32m2(__riscv_vluxei32_v_i16m1(pYData, off, vl), vl),
+                                     __riscv_vrsub_vx_i32m2(fract, 0x000FFFFF, vl), vl);
+        acc = __riscv_vwmacc_vv_i64m4(acc, __riscv_vsext_vf2_i32m2(__riscv_vluxei32_v_i16m1(pYData + 1, off, vl), vl),
+                                      fract, vl);
+        y = __riscv_vncvt_x_x_w_i16m1(__riscv_vnsra_wx_i32m2(acc, 20, vl), vl);
+        y = __riscv_vmerge_vxm_i16m1(y, pYData[0], lo, vl);
+        __riscv_vse16_v_i16m1(pDst, __riscv_vmerge_vxm_i16m1(y, pYData[iMax + 1], hi, vl), vl);
+        pX += vl;
+        pDst += vl;
+    }
+#else
+    q31_t x, fract;
+    q63_t y;
+    int32_t i;
+
+    for (; blockSize > 0; blockSize--) {
+        x = *pX++;
+        i = x >> 20;
+        if (i > iMax) {
+            *pDst++ = pYData[iMax + 1];
+        } else if (i < 0) {
+            *pDst++ = pYData[0];
+        } else {
+            fract = x & 0x000FFFFF;
+            y = (q63_t)pYData[i] * (0x000FFFFF - fract);
+            y += (q63_t)pYData[i + 1] * fract;
+            *pDst++ = (q15_t)(y >> 20);
+        }
+    }
+#endif /* defined(RISCV_VEC_INTERP_VECTOR64) */
+}
+
+#ifdef   __cplusplus
+}
+#endif
+
+#endif /* _RISCV_VEC_INTERP_H_ */
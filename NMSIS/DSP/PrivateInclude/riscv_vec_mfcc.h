@@ -0,0 +1,478 @@
+/******************************************************************************
+ * @file     riscv_vec_mfcc.h
+ * @brief    Private header file for NMSIS DSP Library
+ * @version  V1.10.0
+ * @date     08 July 2021
+ ******************************************************************************/
+/*
+ * Copyright (c) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _RISCV_VEC_MFCC_H_
+#define _RISCV_VEC_MFCC_H_
+
+#include "riscv_math.h"
+#include "riscv_vec_fft.h"
+
+#ifdef   __cplusplus
+extern "C"
+{
+#endif
+
+#if defined(RISCV_MATH_VECTOR)
+
+/*
+ * Fused MFCC and log mel spectrogram
+ *
+ * A frame of fftLen samples goes through window, real FFT, power spectrum, mel filter bank,
+ * log and DCT. The power of each bin is computed from the FFT output while the filter bank
+ * accumulates it, so the power spectrum is never stored, and each stage works in the
+ * buffer of the previous one: the frame is windowed in place, the FFT writes the scratch
+ * buffer, the mel energies go back to the frame buffer.
+ *
+ * The filter bank is sparse as for riscv_mfcc_f32(): filter i covers filterLengths[i] bins
+ * from bin filterPos[i], its coefficients follow the ones of filter i - 1 in filterCoefs,
+ * bins run from 0 to fftLen / 2. The DCT matrix is nbDctOutputs rows of nbMelFilters, with
+ * nbDctOutputs 0 the log mel energies are the output. Unlike riscv_mfcc_f32(), which filters
+ * the magnitude, filters take the power |X[k]| ^ 2, as riscv_cmplx_mag_squared_f32() does.
+ *
+ * riscv_vec_mfcc_mel_filters() and riscv_vec_mfcc_dct_f32() build the tables at run time,
+ * windows come from dsp/window_functions.h.
+ */
+
+/* mel scale of HTK, mel = 2595 * log10(1 + f / 700) */
+#define RISCV_VEC_MFCC_MEL(f)           (2595.0 * log10(1.0 + (f) / 700.0))
+#define RISCV_VEC_MFCC_MEL_INV(m)       (700.0 * (pow(10.0, (m) / 2595.0) - 1.0))
+
+/*
+ * Fill triangular mel filters of nbMelFilters bands from fMin to fMax Hz for an FFT of fftLen
+ * at sampleRate, return number of coefficients, with filterCoefs NULL only the number is
+ * returned, so the caller can size the buffer
+ */
+__STATIC_INLINE uint32_t riscv_vec_mfcc_mel_filters(uint32_t fftLen, float32_t sampleRate, uint32_t nbMelFilters,
+                                                    float32_t fMin, float32_t fMax, uint32_t *filterPos,
+                                                    uint32_t *filterLengths, float32_t *filterCoefs)
+{
+    double melMin = RISCV_VEC_MFCC_MEL(fMin), step = (RISCV_VEC_MFCC_MEL(fMax) - melMin) / (nbMelFilters + 1);
+    double left, center, right, f, w;
+    uint32_t i, k, first, count = 0, len;
+
+    for (i = 0; i < nbMelFilters; i++) {
+        left = RISCV_VEC_MFCC_MEL_INV(melMin + step * i);
+        center = RISCV_VEC_MFCC_MEL_INV(melMin + step * (i + 1));
+        right = RISCV_VEC_MFCC_MEL_INV(melMin + step * (i + 2));
+        first = 0;
+        len = 0;
+        for (k = 0; k <= fftLen / 2; k++) {
+            f = (double)k * sampleRate / fftLen;
+            w = (f <= center) ? ((f - left) / (center - left)) : ((right - f) / (right - center));
+            if (w <= 0.0) {
+                continue;
+            }
+            // a triangle covers contiguous bins, those above zero
+            if (len == 0) {
+                first = k;
+            }
+            if (filterCoefs != NULL) {
+                filterCoefs[count + len] = (float32_t)w;
+            }
+            len++;
+        }
+        if (filterCoefs != NULL) {
+            filterPos[i] = first;
+            filterLengths[i] = len;
+        }
+        count += len;
+    }
+    return count;
+}
+
+/* fill orthonormal DCT-II matrix of nbDctOutputs rows of nbMelFilters coefficients */
+__STATIC_INLINE void riscv_vec_mfcc_dct_f32(uint32_t nbDctOutputs, uint32_t nbMelFilters, float32_t *dctCoefs)
+{
+    double scale, step = RISCV_VEC_CFFT_2PI / (2.0 * nbMelFilters);
+    uint32_t i, j;
+
+    for (i = 0; i < nbDctOutputs; i++) {
+        scale = sqrt(((i == 0) ? 1.0 : 2.0) / nbMelFilters);
+        for (j = 0; j < nbMelFilters; j++) {
+            dctCoefs[i * nbMelFilters + j] = (float32_t)(scale * cos(step * (j + 0.5) * i));
+        }
+    }
+}
+
+/* ---------------------------------------- f32 ---------------------------------------- */
+
+typedef struct
+{
+    riscv_vec_rfft_instance_f32 rfft;       /**< real FFT of fftLen */
+    const float32_t *windowCoefs;           /**< fftLen window coefficients */
+    const uint32_t *filterPos;              /**< first bin of each mel filter */
+    const uint32_t *filterLengths;          /**< bins of each mel filter */
+    const float32_t *filterCoefs;           /**< coefficients of all mel filters */
+    const float32_t *dctCoefs;              /**< nbDctOutputs * nbMelFilters DCT matrix */
+    uint32_t fftLen;                        /**< samples of one frame */
+    uint32_t nbMelFilters;                  /**< number of mel filters */
+    uint32_t nbDctOutputs;                  /**< number of outputs, 0 for log mel energies */
+} riscv_vec_mfcc_instance_f32;
+
+/*
+ * Set up S, pTwiddle of riscv_vec_rfft_twiddle_size(fftLen) and pPerm of fftLen / 2 entries
+ * are filled, return RISCV_MATH_ARGUMENT_ERROR for unsupported fftLen
+ */
+__STATIC_INLINE riscv_status riscv_vec_mfcc_init_f32(riscv_vec_mfcc_instance_f32 *S, uint32_t fftLen,
+                                                     uint32_t nbMelFilters, uint32_t nbDctOutputs,
+                                                     const float32_t *dctCoefs, const uint32_t *filterPos,
+                                                     const uint32_t *filterLengths, const float32_t *filterCoefs,
+                                                     const float32_t *windowCoefs, float32_t *pTwiddle,
+                                                     uint32_t *pPerm)
+{
+    if (riscv_vec_rfft_init_f32(&S->rfft, fftLen, pTwiddle, pPerm) != RISCV_MATH_SUCCESS) {
+        return RISCV_MATH_ARGUMENT_ERROR;
+    }
+    S->windowCoefs = windowCoefs;
+    S->filterPos = filterPos;
+    S->filterLengths = filterLengths;
+    S->filterCoefs = filterCoefs;
+    S->dctCoefs = dctCoefs;
+    S->fftLen = fftLen;
+    S->nbMelFilters = nbMelFilters;
+    S->nbDctOutputs = nbDctOutputs;
+    return RISCV_MATH_SUCCESS;
+}
+
+/* sum of pCoeffs times power of len bins from bin pos of spectrum p packed as riscv_rfft_fast_f32() */
+__STATIC_INLINE float32_t riscv_vec_mfcc_mel_f32(const float32_t *p, uint32_t m, uint32_t pos, uint32_t len,
+                                                 const float32_t *pCoeffs)
+{
+    float32_t sum = 0.0f;
+    uint32_t j = 0, end = len;
+    const float32_t *pb;
+    size_t vl;
+    vfloat32m2_t re, im;
+    vfloat32m1_t acc;
+
+    // bins 0 and m are real, packed as the first 2 samples
+    if ((pos == 0) && (len > 0)) {
+        sum = pCoeffs[0] * p[0] * p[0];
+        j = 1;
+    }
+    if (pos + len > m) {
+        end = m - pos;
+        sum += pCoeffs[end] * p[1] * p[1];
+    }
+    acc = __riscv_vfmv_v_f_f32m1(sum, 1);
+    for (; j < end; j += vl) {
+        vl = __riscv_vsetvl_e32m2(end - j);
+        pb = p + 2 * (pos + j);
+        re = __riscv_vlse32_v_f32m2(pb, 8, vl);
+        im = __riscv_vlse32_v_f32m2(pb + 1, 8, vl);
+        re = __riscv_vfmacc_vv_f32m2(__riscv_vfmul_vv_f32m2(re, re, vl), im, im, vl);
+        acc = __riscv_vfredusum_vs_f32m2_f32m1(__riscv_vfmul_vv_f32m2(re, __riscv_vle32_v_f32m2(pCoeffs + j, vl), vl),
+                                               acc, vl);
+    }
+    return __riscv_vfmv_f_s_f32m1_f32(acc);
+}
+
+/*
+ * MFCC of fftLen samples of pSrc into nbDctOutputs samples of pDst, or log mel energies
+ * into nbMelFilters samples with nbDctOutputs 0. pSrc is used as work buffer and its content
+ * is lost, pTmp holds fftLen samples.
+ */
+__STATIC_INLINE void riscv_vec_mfcc_f32(const riscv_vec_mfcc_instance_f32 *S, float32_t *pSrc, float32_t *pDst,
+                                        float32_t *pTmp)
+{
+    uint32_t N = S->fftLen, M = S->nbMelFilters, i, j, pos = 0;
+    float32_t *pMel = pSrc;
+    size_t vl;
+    vfloat32m2_t acc;
+
+    // the window is applied by the first stage of the FFT
+    riscv_vec_rfft_run_f32(&S->rfft, pSrc, pTmp, 0, S->windowCoefs);
+    // the frame is not needed any more, mel energies take its place
+    for (i = 0; i < M; i++) {
+        pMel[i] = logf(riscv_vec_mfcc_mel_f32(pTmp, N >> 1, S->filterPos[i], S->filterLengths[i],
+                                              S->filterCoefs + pos) + 1.0e-6f);
+        pos += S->filterLengths[i];
+    }
+    if (S->nbDctOutputs == 0) {
+        memcpy(pDst, pMel, M * sizeof(float32_t));
+        return;
+    }
+    // lanes are DCT outputs, a column of the matrix is read with a stride of one row
+    for (i = 0; i < S->nbDctOutputs; i += vl) {
+        vl = __riscv_vsetvl_e32m2(S->nbDctOutputs - i);
+        acc = __riscv_vfmul_vf_f32m2(__riscv_vlse32_v_f32m2(S->dctCoefs + i * M, M * 4, vl), pMel[0], vl);
+        for (j = 1; j < M; j++) {
+            acc = __riscv_vfmacc_vf_f32m2(acc, pMel[j], __riscv_vlse32_v_f32m2(S->dctCoefs + i * M + j, M * 4, vl), vl);
+        }
+        __riscv_vse32_v_f32m2(pDst + i, acc, vl);
+    }
+}
+
+/*
+ * Quantize blockSize samples of pSrc to q7 for NMSIS NN, pDst = pSrc * scale rounded and
+ * saturated, scale is 2 ^ fractional bits of the input of the network
+ */
+__STATIC_INLINE void riscv_vec_mfcc_to_q7_f32(const float32_t *pSrc, q7_t *pDst, uint32_t blockSize, float32_t scale)
+{
+    size_t vl;
+    vint16m1_t v;
+
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e32m2(blockSize);
+        v = __riscv_vnclip_wx_i16m1(__riscv_vfcvt_x_f_v_i32m2(__riscv_vfmul_vf_f32m2(__riscv_vle32_v_f32m2(pSrc, vl),
+                                                                                       scale, vl), vl),
+                                    0, __RISCV_VXRM_RNU, vl);
+        __riscv_vse8_v_i8mf2(pDst, __riscv_vnclip_wx_i8mf2(v, 0, __RISCV_VXRM_RNU, vl), vl);
+        pSrc += vl;
+        pDst += vl;
+    }
+}
+
+/* ---------------------------------------- q15 ---------------------------------------- */
+
+typedef struct
+{
+    riscv_vec_cfft_instance_q31 cfft;       /**< complex FFT of fftLen / 2 */
+    const q31_t *pSplit;                    /**< fftLen / 2 twiddles of real FFT split */
+    const q15_t *windowCoefs;               /**< fftLen window coefficients */
+    const uint32_t *filterPos;              /**< first bin of each mel filter */
+    const uint32_t *filterLengths;          /**< bins of each mel filter */
+    const q15_t *filterCoefs;               /**< coefficients of all mel filters */
+    const q15_t *dctCoefs;                  /**< nbDctOutputs * nbMelFilters DCT matrix */
+    uint32_t fftLen;                        /**< samples of one frame */
+    uint32_t nbMelFilters;                  /**< number of mel filters */
+    uint32_t nbDctOutputs;                  /**< number of outputs, 0 for log mel energies */
+} riscv_vec_mfcc_instance_q15;
+
+/*
+ * Set up S, pTwiddle of riscv_vec_rfft_twiddle_size(fftLen) and pPerm of fftLen / 2 entries
+ * are filled, return RISCV_MATH_ARGUMENT_ERROR for unsupported fftLen. Tables are the f32
+ * ones converted by riscv_float_to_q15().
+ */
+__STATIC_INLINE riscv_status riscv_vec_mfcc_init_q15(riscv_vec_mfcc_instance_q15 *S, uint32_t fftLen,
+                                                     uint32_t nbMelFilters, uint32_t nbDctOutputs,
+                                                     const q15_t *dctCoefs, const uint32_t *filterPos,
+                                                     const uint32_t *filterLengths, const q15_t *filterCoefs,
+                                                     const q15_t *windowCoefs, q31_t *pTwiddle, uint32_t *pPerm)
+{
+    uint32_t h = fftLen >> 2, k;
+    q31_t *pSplit;
+    double v;
+
+    if ((fftLen > 2 * RISCV_VEC_CFFT_MAX_LEN) ||
+        (riscv_vec_cfft_init_q31(&S->cfft, fftLen >> 1, pTwiddle, pPerm) != RISCV_MATH_SUCCESS)) {
+        return RISCV_MATH_ARGUMENT_ERROR;
+    }
+    // W^k of k = 1 ~ fftLen / 4 as riscv_vec_rfft_init_f32(), cos then -sin
+    pSplit = pTwiddle + riscv_vec_cfft_twiddle_size(fftLen >> 1);
+    for (k = 0; k < h; k++) {
+        v = cos(RISCV_VEC_CFFT_2PI * (k + 1) / fftLen) * 2147483648.0;
+        pSplit[k] = (v >= 2147483647.0) ? INT32_MAX : (q31_t)((v >= 0.0) ? (v + 0.5) : (v - 0.5));
+        v = -sin(RISCV_VEC_CFFT_2PI * (k + 1) / fftLen) * 2147483648.0;
+        pSplit[h + k] = (q31_t)((v >= 0.0) ? (v + 0.5) : (v - 0.5));
+    }
+    S->pSplit = pSplit;
+    S->windowCoefs = windowCoefs;
+    S->filterPos = filterPos;
+    S->filterLengths = filterLengths;
+    S->filterCoefs = filterCoefs;
+    S->dctCoefs = dctCoefs;
+    S->fftLen = fftLen;
+    S->nbMelFilters = nbMelFilters;
+    S->nbDctOutputs = nbDctOutputs;
+    return RISCV_MATH_SUCCESS;
+}
+
+/*
+ * Split the complex FFT of m points of even and odd samples in p into the real spectrum of
+ * 2 * m points, packed as riscv_rfft_fast_f32(), each halving keeps the bins below 1, so the
+ * result is DFT / (2 * m)
+ */
+__STATIC_INLINE void riscv_vec_mfcc_split_q31(q31_t *p, uint32_t m, const q31_t *pSplit)
+{
+    uint32_t h = m >> 1, j;
+    const q31_t *pWr = pSplit, *pWi = pSplit + h;
+    q31_t *pk, *pm, x0 = p[0] >> 1, x1 = p[1] >> 1;
+    size_t vl;
+    vint32m2_t ar, ai, cr, ci, er, ei, dr, di, pr, pi, wr, wi;
+
+    for (j = 0; j < h; j += vl) {
+        vl = __riscv_vsetvl_e32m2(h - j);
+        pk = p + 2 * (j + 1);
+        pm = p + 2 * (m - j - 1);
+        ar = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pk, 8, vl), 1, vl);
+        ai = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pk + 1, 8, vl), 1, vl);
+        cr = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pm, -8, vl), 1, vl);
+        ci = __riscv_vsra_vx_i32m2(__riscv_vlse32_v_i32m2(pm + 1, -8, vl), 1, vl);
+        wr = __riscv_vle32_v_i32m2(pWr + j, vl);
+        wi = __riscv_vle32_v_i32m2(pWi + j, vl);
+        // E and D as riscv_vec_rfft_f32(), halved once more below, P = -i * W^k * D halved by vmulh
+        er = __riscv_vsra_vx_i32m2(__riscv_vadd_vv_i32m2(ar, cr, vl), 1, vl);
+        ei = __riscv_vsra_vx_i32m2(__riscv_vsub_vv_i32m2(ai, ci, vl), 1, vl);
+        dr = __riscv_vsub_vv_i32m2(ar, cr, vl);
+        di = __riscv_vadd_vv_i32m2(ai, ci, vl);
+        pr = __riscv_vadd_vv_i32m2(__riscv_vmulh_vv_i32m2(di, wr, vl), __riscv_vmulh_vv_i32m2(dr, wi, vl), vl);
+        pi = __riscv_vsub_vv_i32m2(__riscv_vmulh_vv_i32m2(di, wi, vl), __riscv_vmulh_vv_i32m2(dr, wr, vl), vl);
+        __riscv_vsse32_v_i32m2(pk, 8, __riscv_vadd_vv_i32m2(er, pr, vl), vl);
+        __riscv_vsse32_v_i32m2(pk + 1, 8, __riscv_vadd_vv_i32m2(ei, pi, vl), vl);
+        __riscv_vsse32_v_i32m2(pm, -8, __riscv_vsub_vv_i32m2(er, pr, vl), vl);
+        __riscv_vsse32_v_i32m2(pm + 1, -8, __riscv_vsub_vv_i32m2(pi, ei, vl), vl);
+    }
+    p[0] = x0 + x1;
+    p[1] = x0 - x1;
+}
+
+/*
+ * sum of pCoeffs times power of len bins from bin pos of spectrum p of riscv_vec_mfcc_split_q31(),
+ * the power is q30 and the sum q29, by Parseval it stays below 1
+ */
+__STATIC_INLINE q31_t riscv_vec_mfcc_mel_q15(const q31_t *p, uint32_t m, uint32_t pos, uint32_t len,
+                                             const q15_t *pCoeffs)
+{
+    q31_t sum = 0;
+    uint32_t j = 0, end = len;
+    const q31_t *pb;
+    size_t vl;
+    vint32m2_t re, im;
+    vint32m1_t acc;
+
+    if ((pos == 0) && (len > 0)) {
+        sum = (q31_t)(((q63_t)(q31_t)(((q63_t)p[0] * p[0]) >> 32) * ((q31_t)pCoeffs[0] << 16)) >> 32);
+        j = 1;
+    }
+    if (pos + len > m) {
+        end = m - pos;
+        sum += (q31_t)(((q63_t)(q31_t)(((q63_t)p[1] * p[1]) >> 32) * ((q31_t)pCoeffs[end] << 16)) >> 32);
+    }
+    acc = __riscv_vmv_v_x_i32m1(sum, 1);
+    for (; j < end; j += vl) {
+        vl = __riscv_vsetvl_e32m2(end - j);
+        pb = p + 2 * (pos + j);
+        re = __riscv_vlse32_v_i32m2(pb, 8, vl);
+        im = __riscv_vlse32_v_i32m2(pb + 1, 8, vl);
+        re = __riscv_vadd_vv_i32m2(__riscv_vmulh_vv_i32m2(re, re, vl), __riscv_vmulh_vv_i32m2(im, im, vl), vl);
+        im = __riscv_vsll_vx_i32m2(__riscv_vsext_vf2_i32m2(__riscv_vle16_v_i16m1(pCoeffs + j, vl), vl), 16, vl);
+        acc = __riscv_vredsum_vs_i32m2_i32m1(__riscv_vmulh_vv_i32m2(re, im, vl), acc, vl);
+    }
+    return __riscv_vmv_x_s_i32m1_i32(acc);
+}
+
+/* natural log of x * 2 ^ exp in q20, x > 0, the fraction of log2 is found by 16 squarings */
+__STATIC_INLINE q31_t riscv_vec_mfcc_log_q20(q31_t x, int32_t exp)
+{
+    uint32_t e = 31U - __CLZ((uint32_t)x), b;
+    q63_t f = (q63_t)x << (30U - e), l2 = (q63_t)((int32_t)e + exp) << 30;
+
+    for (b = 1; b <= 16; b++) {
+        f = (f * f) >> 30;
+        if (f >= ((q63_t)2 << 30)) {
+            f >>= 1;
+            l2 += (q63_t)1 << (30 - b);
+        }
+    }
+    // ln(2) in q24
+    return (q31_t)((l2 * 11629080) >> 34);
+}
+
+/*
+ * MFCC of fftLen samples of pSrc into nbDctOutputs samples of pDst in q8.7 as riscv_mfcc_q15(),
+ * or log mel energies into nbMelFilters samples with nbDctOutputs 0. pSrc is left untouched,
+ * pTmp holds 2 * fftLen samples. The frame is normalized to full scale before the FFT and
+ * the log removes the normalization again, so quiet frames keep their resolution, and no
+ * 1e-6 is added before the log as the f32 version does, empty bands take the smallest energy.
+ */
+__STATIC_INLINE void riscv_vec_mfcc_q15(const riscv_vec_mfcc_instance_q15 *S, const q15_t *pSrc, q15_t *pDst,
+                                        q31_t *pTmp)
+{
+    uint32_t N = S->fftLen, M = S->nbMelFilters, i, j, pos = 0, sh = 0, log2N = 31U - __CLZ(N);
+    q31_t *pSpec = pTmp + N, *pMel = pTmp, absmax;
+    q63_t acc;
+    size_t vl;
+    vint16m1_t x, vmax = __riscv_vmv_v_x_i16m1(0, 1), vmin = __riscv_vmv_v_x_i16m1(0, 1);
+
+    for (i = 0; i < N; i += vl) {
+        vl = __riscv_vsetvl_e16m1(N - i);
+        x = __riscv_vle16_v_i16m1(pSrc + i, vl);
+        vmax = __riscv_vredmax_vs_i16m1_i16m1(x, vmax, vl);
+        vmin = __riscv_vredmin_vs_i16m1_i16m1(x, vmin, vl);
+    }
+    absmax = __riscv_vmv_x_s_i16m1_i16(vmax);
+    if (-(q31_t)__riscv_vmv_x_s_i16m1_i16(vmin) > absmax) {
+        absmax = -(q31_t)__riscv_vmv_x_s_i16m1_i16(vmin);
+    }
+    while ((sh < 15U) && (absmax != 0) && ((absmax << (sh + 1U)) <= 0x7FFF)) {
+        sh++;
+    }
+    // even and odd samples are the real and imaginary parts of a complex FFT of N / 2
+    for (i = 0; i < N; i += vl) {
+        vl = __riscv_vsetvl_e16m1(N - i);
+        x = __riscv_vsll_vx_i16m1(__riscv_vle16_v_i16m1(pSrc + i, vl), sh, vl);
+        __riscv_vse32_v_i32m2(pTmp + i, __riscv_vsll_vx_i32m2(
+            __riscv_vwmul_vv_i32m2(x, __riscv_vle16_v_i16m1(S->windowCoefs + i, vl), vl), 1, vl), vl);
+    }
+    riscv_vec_cfft_q31(&S->cfft, pTmp, pSpec, 0);
+    riscv_vec_mfcc_split_q31(pSpec, N >> 1, S->pSplit);
+    // energies in q29 of the spectrum scaled by 1 / N of x * 2 ^ sh, the log scales them back
+    for (i = 0; i < M; i++) {
+        acc = riscv_vec_mfcc_mel_q15(pSpec, N >> 1, S->filterPos[i], S->filterLengths[i], S->filterCoefs + pos);
+        pMel[i] = riscv_vec_mfcc_log_q20((acc > 0) ? (q31_t)acc : 1, (int32_t)(2U * log2N) - 29 - (int32_t)(2U * sh));
+        pos += S->filterLengths[i];
+    }
+    if (S->nbDctOutputs == 0) {
+        for (j = 0; j < M; j++) {
+            pDst[j] = (q15_t)__SSAT(pMel[j] >> 13, 16);
+        }
+        return;
+    }
+    // q15 coefficients times q20 energies are q35, the products need 64 bit sums
+    for (i = 0; i < S->nbDctOutputs; i++) {
+        acc = 0;
+        for (j = 0; j < M; j++) {
+            acc += (q63_t)S->dctCoefs[i * M + j] * pMel[j];
+        }
+        acc >>= 28;
+        pDst[i] = (q15_t)((acc > 32767) ? 32767 : ((acc < -32768) ? -32768 : acc));
+    }
+}
+
+/*
+ * Convert blockSize samples of pSrc by an arithmetic shift right of shift, rounded and
+ * saturated to q7, q8.7 MFCC of riscv_vec_mfcc_q15() becomes q4.3 with shift 4
+ */
+__STATIC_INLINE void riscv_vec_mfcc_to_q7_q15(const q15_t *pSrc, q7_t *pDst, uint32_t blockSize, uint32_t shift)
+{
+    size_t vl;
+
+    for (; blockSize > 0; blockSize -= vl) {
+        vl = __riscv_vsetvl_e16m1(blockSize);
+        __riscv_vse8_v_i8mf2(pDst, __riscv_vnclip_wx_i8mf2(__riscv_vle16_v_i16m1(pSrc, vl), shift, __RISCV_VXRM_RNU, vl),
+                             vl);
+        pSrc += vl;
+        pDst += vl;
+    }
+}
+
+#endif /* defined(RISCV_MATH_VECTOR) */
+
+#ifdef   __cplusplus
+}
+#endif
+
+#endif /* _RISCV_VEC_MFCC_H_ */
@@ -0,0 +1,359 @@
+/******************************************************************************
+ * @file     riscv_vec_quaternion.h
+ * @brief    Private header file for NMSIS DSP Library
+ * @version  V1.10.0
+ * @date     08 July 2021
+ ******************************************************************************/
+/*
+ * Copyright (c) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _RISCV_VEC_QUATERNION_H_
+#define _RISCV_VEC_QUATERNION_H_
+
+#include "riscv_math.h"
+
+#ifdef   __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Quaternion batches in structure of arrays
+ *
+ * n quaternions are 4 planes of n values, w[n], x[n], y[n], z[n], and n 3D vectors are 3
+ * planes x[n], y[n], z[n], so lane i of a vector is quaternion i and every operation is plain
+ * vector arithmetic. riscv_quaternion_to_soa_f32() and riscv_quaternion_from_soa_f32()
+ * convert from and to the w, x, y, z quaternions of quaternion_math_functions.h.
+ *
+ * - riscv_quaternion_product_soa_f32(): qa * qb, as riscv_quaternion_product_f32()
+ * - riscv_quaternion_normalize_soa_f32(): q / |q|, as riscv_quaternion_normalize_f32()
+ * - riscv_quaternion_rotate_soa_f32(): q * v * conj(q) of unit q, by t = 2 * (u x v) and
+ *   v + w * t + u x t with u the vector part of q, 15 multiplies per vector
+ * - riscv_quaternion_gyro_update_soa_f32(): q + dt / 2 * q * (0, gyro) then normalized, one
+ *   first order step of the attitude from the angular rates in rad/s, in one pass instead of
+ *   a product, a scale, an add and a normalization over intermediate buffers
+ *
+ * RVV runs the kernels when the vector unit has f32, by fused multiply add, other cores run
+ * the same formulas per quaternion, so the two can differ in the last bit. Output planes can
+ * be the input planes.
+ */
+
+/* -------------------------------------- layout -------------------------------------- */
+
+/* Split n quaternions of w, x, y, z into the 4 planes of pDst */
+__STATIC_INLINE void riscv_quaternion_to_soa_f32(const float32_t *pSrc, float32_t *pDst, uint32_t n)
+{
+    uint32_t i, c;
+
+#if defined(RISCV_MATH_VECTOR)
+    size_t vl;
+
+    for (i = 0; i < n; i += vl) {
+        vl = __riscv_vsetvl_e32m8(n - i);
+        for (c = 0; c < 4; c++) {
+            __riscv_vse32_v_f32m8(pDst + c * n + i, __riscv_vlse32_v_f32m8(pSrc + 4 * i + c, 16, vl), vl);
+        }
+    }
+#else
+    for (i = 0; i < n; i++) {
+        for (c = 0; c < 4; c++) {
+            pDst[c * n + i] = pSrc[4 * i + c];
+        }
+    }
+#endif /* defined(RISCV_MATH_VECTOR) */
+}
+
+/* Merge the 4 planes of pSrc into n quaternions of w, x, y, z */
+__STATIC_INLINE void riscv_quaternion_from_soa_f32(const float32_t *pSrc, float32_t *pDst, uint32_t n)
+{
+    uint32_t i, c;
+
+#if defined(RISCV_MATH_VECTOR)
+    size_t vl;
+
+    for (i = 0; i < n; i += vl) {
+        vl = __riscv_vsetvl_e32m8(n - i);
+        for (c = 0; c < 4; c++) {
+            __riscv_vsse32_v_f32m8(pDst + 4 * i + c, 16, __riscv_vle32_v_f32m8(pSrc + c * n + i, vl), vl);
+        }
+    }
+#else
+    for (i = 0; i < n; i++) {
+        for (c = 0; c < 4; c++) {
+            pDst[4 * i + c] = pSrc[c * n + i];
+        }
+    }
+#endif /* defined(RISCV_MATH_VECTOR) */
+}
+
+/* ------------------------------------- kernels ------------------------------------- */
+
+#if defined(RISCV_MATH_VECTOR) && defined(__riscv_v_elen_fp) && (__riscv_v_elen_fp >= 32)
+#define RISCV_VEC_QUAT_VECTORF          1
+#endif
+
+/**
+ * @brief  Elementwise product of quaternion planes
+ * @param[in]  pA   4 planes of n quaternions
+ * @param[in]  pB   4 planes of n quaternions
+ * @param[out] pDst 4 planes of n products pA * pB
+ * @param[in]  n    number of quaternions
+ */
+__STATIC_INLINE void riscv_quaternion_product_soa_f32(const float32_t *pA, const float32_t *pB, float32_t *pDst,
+                                                      uint32_t n)
+{
+    uint32_t i;
+
+#if defined(RISCV_VEC_QUAT_VECTORF)
+    size_t vl;
+    vfloat32m2_t aw, ax, ay, az, bw, bx, by, bz, r;
+
+    for (i = 0; i < n; i += vl) {
+        vl = __riscv_vsetvl_e32m2(n - i);
+        aw = __riscv_vle32_v_f32m2(pA + i, vl);
+        ax = __riscv_vle32_v_f32m2(pA + n + i, vl);
+        ay = __riscv_vle32_v_f32m2(pA + 2 * n + i, vl);
+        az = __riscv_vle32_v_f32m2(pA + 3 * n + i, vl);
+        bw = __riscv_vle32_v_f32m2(pB + i, vl);
+        bx = __riscv_vle32_v_f32m2(pB + n + i, vl);
+        by = __riscv_vle32_v_f32m2(pB + 2 * n + i, vl);
+        bz = __riscv_vle32_v_f32m2(pB + 3 * n + i, vl);
+        r = __riscv_vfmul_vv_f32m2(aw, bw, vl);
+        r = __riscv_vfnmsac_vv_f32m2(r, ax, bx, vl);
+        r = __riscv_vfnmsac_vv_f32m2(r, ay, by, vl);
+        __riscv_vse32_v_f32m2(pDst + i, __riscv_vfnmsac_vv_f32m2(r, az, bz, vl), vl);
+        r = __riscv_vfmul_vv_f32m2(aw, bx, vl);
+        r = __riscv_vfmacc_vv_f32m2(r, ax, bw, vl);
+        r = __riscv_vfmacc_vv_f32m2(r, ay, bz, vl);
+        __riscv_vse32_v_f32m2(pDst + n + i, __riscv_vfnmsac_vv_f32m2(r, az, by, vl), vl);
+        r = __riscv_vfmul_vv_f32m2(aw, by, vl);
+        r = __riscv_vfnmsac_vv_f32m2(r, ax, bz, vl);
+        r = __riscv_vfmacc_vv_f32m2(r, ay, bw, vl);
+        __riscv_vse32_v_f32m2(pDst + 2 * n + i, __riscv_vfmacc_vv_f32m2(r, az, bx, vl), vl);
+        r = __riscv_vfmul_vv_f32m2(aw, bz, vl);
+        r = __riscv_vfmacc_vv_f32m2(r, ax, by, vl);
+        r = __riscv_vfnmsac_vv_f32m2(r, ay, bx, vl);
+        __riscv_vse32_v_f32m2(pDst + 3 * n + i, __riscv_vfmacc_vv_f32m2(r, az, bw, vl), vl);
+    }
+#else
+    float32_t aw, ax, ay, az, bw, bx, by, bz;
+
+    for (i = 0; i < n; i++) {
+        aw = pA[i];
+        ax = pA[n + i];
+        ay = pA[2 * n + i];
+        az = pA[3 * n + i];
+        bw = pB[i];
+        bx = pB[n + i];
+        by = pB[2 * n + i];
+        bz = pB[3 * n + i];
+        pDst[i] = aw * bw - ax * bx - ay * by - az * bz;
+        pDst[n + i] = aw * bx + ax * bw + ay * bz - az * by;
+        pDst[2 * n + i] = aw * by - ax * bz + ay * bw + az * bx;
+        pDst[3 * n + i] = aw * bz + ax * by - ay * bx + az * bw;
+    }
+#endif /* defined(RISCV_VEC_QUAT_VECTORF) */
+}
+
+/**
+ * @brief  Normalize quaternion planes
+ * @param[in]  pSrc  4 planes of n quaternions
+ * @param[out] pDst  4 planes of n unit quaternions
+ * @param[in]  n     number of quaternions
+ */
+__STATIC_INLINE void riscv_quaternion_normalize_soa_f32(const float32_t *pSrc, float32_t *pDst, uint32_t n)
+{
+    uint32_t i, c;
+
+#if defined(RISCV_VEC_QUAT_VECTORF)
+    size_t vl;
+    vfloat32m4_t q[4], s;
+
+    for (i = 0; i < n; i += vl) {
+        vl = __riscv_vsetvl_e32m4(n - i);
+        for (c = 0; c < 4; c++) {
+            q[c] = __riscv_vle32_v_f32m4(pSrc + c * n + i, vl);
+        }
+        s = __riscv_vfmul_vv_f32m4(q[0], q[0], vl);
+        for (c = 1; c < 4; c++) {
+            s = __riscv_vfmacc_vv_f32m4(s, q[c], q[c], vl);
+        }
+        s = __riscv_vfsqrt_v_f32m4(s, vl);
+        for (c = 0; c < 4; c++) {
+            __riscv_vse32_v_f32m4(pDst + c * n + i, __riscv_vfdiv_vv_f32m4(q[c], s, vl), vl);
+        }
+    }
+#else
+    float32_t s;
+
+    for (i = 0; i < n; i++) {
+        s = 0.0f;
+        for (c = 0; c < 4; c++) {
+            s += pSrc[c * n + i] * pSrc[c * n + i];
+        }
+        s = sqrtf(s);
+        for (c = 0; c < 4; c++) {
+            pDst[c * n + i] = pSrc[c * n + i] / s;
+        }
+    }
+#endif /* defined(RISCV_VEC_QUAT_VECTORF) */
+}
+
+/**
+ * @brief  Rotate 3D vectors by unit quaternions
+ * @param[in]  pQ    4 planes of n unit quaternions
+ * @param[in]  pV    3 planes of n vectors
+ * @param[out] pDst  3 planes of n vectors, pQ[i] * pV[i] * conj(pQ[i])
+ * @param[in]  n     number of vectors
+ */
+__STATIC_INLINE void riscv_quaternion_rotate_soa_f32(const float32_t *pQ, const float32_t *pV, float32_t *pDst,
+                                                     uint32_t n)
+{
+    uint32_t i;
+
+#if defined(RISCV_VEC_QUAT_VECTORF)
+    size_t vl;
+    vfloat32m2_t w, ux, uy, uz, vx, vy, vz, tx, ty, tz, r;
+
+    for (i = 0; i < n; i += vl) {
+        vl = __riscv_vsetvl_e32m2(n - i);
+        w = __riscv_vle32_v_f32m2(pQ + i, vl);
+        ux = __riscv_vle32_v_f32m2(pQ + n + i, vl);
+        uy = __riscv_vle32_v_f32m2(pQ + 2 * n + i, vl);
+        uz = __riscv_vle32_v_f32m2(pQ + 3 * n + i, vl);
+        vx = __riscv_vle32_v_f32m2(pV + i, vl);
+        vy = __riscv_vle32_v_f32m2(pV + n + i, vl);
+        vz = __riscv_vle32_v_f32m2(pV + 2 * n + i, vl);
+        // t = 2 * (u x v)
+        tx = __riscv_vfnmsac_vv_f32m2(__riscv_vfmul_vv_f32m2(uy, vz, vl), uz, vy, vl);
+        ty = __riscv_vfnmsac_vv_f32m2(__riscv_vfmul_vv_f32m2(uz, vx, vl), ux, vz, vl);
+        tz = __riscv_vfnmsac_vv_f32m2(__riscv_vfmul_vv_f32m2(ux, vy, vl), uy, vx, vl);
+        tx = __riscv_vfadd_vv_f32m2(tx, tx, vl);
+        ty = __riscv_vfadd_vv_f32m2(ty, ty, vl);
+        tz = __riscv_vfadd_vv_f32m2(tz, tz, vl);
+        // v + w * t + u x t
+        r = __riscv_vfmacc_vv_f32m2(vx, w, tx, vl);
+        r = __riscv_vfmacc_vv_f32m2(r, uy, tz, vl);
+        __riscv_vse32_v_f32m2(pDst + i, __riscv_vfnmsac_vv_f32m2(r, uz, ty, vl), vl);
+        r = __riscv_vfmacc_vv_f32m2(vy, w, ty, vl);
+        r = __riscv_vfmacc_vv_f32m2(r, uz, tx, vl);
+        __riscv_vse32_v_f32m2(pDst + n + i, __riscv_vfnmsac_vv_f32m2(r, ux, tz, vl), vl);
+        r = __riscv_vfmacc_vv_f32m2(vz, w, tz, vl);
+        r = __riscv_vfmacc_vv_f32m2(r, ux, ty, vl);
+        __riscv_vse32_v_f32m2(pDst + 2 * n + i, __riscv_vfnmsac_vv_f32m2(r, uy, tx, vl), vl);
+    }
+#else
+    float32_t w, ux, uy, uz, vx, vy, vz, tx, ty, tz;
+
+    for (i = 0; i < n; i++) {
+        w = pQ[i];
+        ux = pQ[n + i];
+        uy = pQ[2 * n + i];
+        uz = pQ[3 * n + i];
+        vx = pV[i];
+        vy = pV[n + i];
+        vz = pV[2 * n + i];
+        tx = 2.0f * (uy * vz - uz * vy);
+        ty = 2.0f * (uz * vx - ux * vz);
+        tz = 2.0f * (ux * vy - uy * vx);
+        pDst[i] = vx + w * tx + uy * tz - uz * ty;
+        pDst[n + i] = vy + w * ty + uz * tx - ux * tz;
+        pDst[2 * n + i] = vz + w * tz + ux * ty - uy * tx;
+    }
+#endif /* defined(RISCV_VEC_QUAT_VECTORF) */
+}
+
+/**
+ * @brief  Integrate angular rates into attitude quaternions and normalize them
+ * @param[in,out] pQ     4 planes of n unit quaternions, updated in place
+ * @param[in]     pGyro  3 planes of n angular rates in rad/s, in the body frame
+ * @param[in]     dt     time step in s
+ * @param[in]     n      number of quaternions
+ */
+__STATIC_INLINE void riscv_quaternion_gyro_update_soa_f32(float32_t *pQ, const float32_t *pGyro, float32_t dt,
+                                                          uint32_t n)
+{
+    float32_t h = 0.5f * dt;
+    uint32_t i;
+
+#if defined(RISCV_VEC_QUAT_VECTORF)
+    size_t vl;
+    vfloat32m2_t w, x, y, z, gx, gy, gz, rw, rx, ry, rz, s;
+
+    for (i = 0; i < n; i += vl) {
+        vl = __riscv_vsetvl_e32m2(n - i);
+        w = __riscv_vle32_v_f32m2(pQ + i, vl);
+        x = __riscv_vle32_v_f32m2(pQ + n + i, vl);
+        y = __riscv_vle32_v_f32m2(pQ + 2 * n + i, vl);
+        z = __riscv_vle32_v_f32m2(pQ + 3 * n + i, vl);
+        gx = __riscv_vfmul_vf_f32m2(__riscv_vle32_v_f32m2(pGyro + i, vl), h, vl);
+        gy = __riscv_vfmul_vf_f32m2(__riscv_vle32_v_f32m2(pGyro + n + i, vl), h, vl);
+        gz = __riscv_vfmul_vf_f32m2(__riscv_vle32_v_f32m2(pGyro + 2 * n + i, vl), h, vl);
+        // q + q * (0, g * dt / 2)
+        rw = __riscv_vfnmsac_vv_f32m2(w, x, gx, vl);
+        rw = __riscv_vfnmsac_vv_f32m2(rw, y, gy, vl);
+        rw = __riscv_vfnmsac_vv_f32m2(rw, z, gz, vl);
+        rx = __riscv_vfmacc_vv_f32m2(x, w, gx, vl);
+        rx = __riscv_vfmacc_vv_f32m2(rx, y, gz, vl);
+        rx = __riscv_vfnmsac_vv_f32m2(rx, z, gy, vl);
+        ry = __riscv_vfmacc_vv_f32m2(y, w, gy, vl);
+        ry = __riscv_vfnmsac_vv_f32m2(ry, x, gz, vl);
+        ry = __riscv_vfmacc_vv_f32m2(ry, z, gx, vl);
+        rz = __riscv_vfmacc_vv_f32m2(z, w, gz, vl);
+        rz = __riscv_vfmacc_vv_f32m2(rz, x, gy, vl);
+        rz = __riscv_vfnmsac_vv_f32m2(rz, y, gx, vl);
+        s = __riscv_vfmul_vv_f32m2(rw, rw, vl);
+        s = __riscv_vfmacc_vv_f32m2(s, rx, rx, vl);
+        s = __riscv_vfmacc_vv_f32m2(s, ry, ry, vl);
+        s = __riscv_vfmacc_vv_f32m2(s, rz, rz, vl);
+        s = __riscv_vfrdiv_vf_f32m2(__riscv_vfsqrt_v_f32m2(s, vl), 1.0f, vl);
+        __riscv_vse32_v_f32m2(pQ + i, __riscv_vfmul_vv_f32m2(rw, s, vl), vl);
+        __riscv_vse32_v_f32m2(pQ + n + i, __riscv_vfmul_vv_f32m2(rx, s, vl), vl);
+        __riscv_vse32_v_f32m2(pQ + 2 * n + i, __riscv_vfmul_vv_f32m2(ry, s, vl), vl);
+        __riscv_vse32_v_f32m2(pQ + 3 * n + i, __riscv_vfmul_vv_f32m2(rz, s, vl), vl);
+    }
+#else
+    float32_t w, x, y, z, gx, gy, gz, rw, rx, ry, rz, s;
+
+    for (i = 0; i < n; i++) {
+        w = pQ[i];
+        x = pQ[n + i];
+        y = pQ[2 * n + i];
+        z = pQ[3 * n + i];
+        gx = pGyro[i] * h;
+        gy = pGyro[n + i] * h;
+        gz = pGyro[2 * n + i] * h;
+        rw = w - x * gx - y * gy - z * gz;
+        rx = x + w * gx + y * gz - z * gy;
+        ry = y + w * gy - x * gz + z * gx;
+        rz = z + w * gz + x * gy - y * gx;
+        s = 1.0f / sqrtf(rw * rw + rx * rx + ry * ry + rz * rz);
+        pQ[i] = rw * s;
+        pQ[n + i] = rx * s;
+        pQ[2 * n + i] = ry * s;
+        pQ[3 * n + i] = rz * s;
+    }
+#endif /* defined(RISCV_VEC_QUAT_VECTORF) */
+}
+
+#ifdef   __cplusplus
+}
+#endif
+
+#endif /* _RISCV_VEC_QUATERNION_H_ */
@@ -0,0 +1,123 @@
+/******************************************************************************
+ * @file     riscv_vec_statistics.h
+ * @brief    Private header file for NMSIS DSP Library
+ * @version  V1.10.0
+ * @date     08 July 2021
+ ******************************************************************************/
+/*
+ * Copyright (c) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ * Copyright (c) 2019 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _RISCV_VEC_STATISTICS_H_
+#define _RISCV_VEC_STATISTICS_H_
+
+#include "riscv_math.h"
+#include "riscv_sorting.h"
+
+#ifdef   __cplusplus
+extern "C"
+{
+#endif
+
+#if defined(RISCV_MATH_VECTOR)
+
+/*
+ * Robust and fused statistics
+ *
+ * Median and percentiles select ranks by riscv_vec_select_f32(), so the window is never
+ * sorted. riscv_vec_stats_f32() gives mean, variance, min and max in one pass: sums are
+ * taken of x - x[0], which keeps the single pass variance accurate when the mean is large
+ * against the spread, as for sensor offsets.
+ */
+
+typedef struct
+{
+    float32_t mean;                 /**< same as riscv_mean_f32() */
+    float32_t var;                  /**< same as riscv_var_f32(), over blockSize - 1 */
+    float32_t min;                  /**< same value as riscv_min_f32() */
+    float32_t max;                  /**< same value as riscv_max_f32() */
+} riscv_vec_stats_result_f32;
+
+/* *pResult = median of blockSize samples of pSrc, pBuf holds blockSize samples */
+__STATIC_INLINE void riscv_vec_median_f32(const float32_t *pSrc, uint32_t blockSize, float32_t *pBuf,
+                                          float32_t *pResult)
+{
+    float32_t hi = riscv_vec_select_f32(pSrc, blockSize, blockSize >> 1, pBuf);
+
+    if (blockSize & 1U) {
+        *pResult = hi;
+    } else {
+        *pResult = 0.5f * (hi + riscv_vec_select_f32(pSrc, blockSize, (blockSize >> 1) - 1U, pBuf));
+    }
+}
+
+/*
+ * *pResult = percentile of 0 to 100 of blockSize samples of pSrc, linearly interpolated
+ * between ranks, pBuf holds blockSize samples
+ */
+__STATIC_INLINE void riscv_vec_percentile_f32(const float32_t *pSrc, uint32_t blockSize, float32_t percentile,
+                                              float32_t *pBuf, float32_t *pResult)
+{
+    float32_t pos = percentile / 100.0f * (float32_t)(blockSize - 1U), frac, lo;
+    uint32_t k;
+
+    pos = (pos < 0.0f) ? 0.0f : ((pos > (float32_t)(blockSize - 1U)) ? (float32_t)(blockSize - 1U) : pos);
+    k = (uint32_t)pos;
+    frac = pos - (float32_t)k;
+    lo = riscv_vec_select_f32(pSrc, blockSize, k, pBuf);
+    if ((frac > 0.0f) && (k + 1U < blockSize)) {
+        lo += frac * (riscv_vec_select_f32(pSrc, blockSize, k + 1U, pBuf) - lo);
+    }
+    *pResult = lo;
+}
+
+/* mean, variance, min and max of blockSize samples of pSrc in one pass, blockSize > 0 */
+__STATIC_INLINE void riscv_vec_stats_f32(const float32_t *pSrc, uint32_t blockSize, riscv_vec_stats_result_f32 *pStats)
+{
+    float32_t x0 = pSrc[0], s1, s2;
+    size_t vlmax = __riscv_vsetvlmax_e32m4(), vl;
+    vfloat32m4_t x, d, sum = __riscv_vfmv_v_f_f32m4(0.0f, vlmax), sq = __riscv_vfmv_v_f_f32m4(0.0f, vlmax);
+    vfloat32m4_t lo = __riscv_vfmv_v_f_f32m4(x0, vlmax), hi = __riscv_vfmv_v_f_f32m4(x0, vlmax);
+    vfloat32m1_t init = __riscv_vfmv_v_f_f32m1(0.0f, 1);
+    uint32_t i;
+
+    // tail undisturbed, lanes beyond the last vl keep their partial results
+    for (i = 0; i < blockSize; i += vl) {
+        vl = __riscv_vsetvl_e32m4(blockSize - i);
+        x = __riscv_vle32_v_f32m4(pSrc + i, vl);
+        d = __riscv_vfsub_vf_f32m4(x, x0, vl);
+        sum = __riscv_vfadd_vv_f32m4_tu(sum, sum, d, vl);
+        sq = __riscv_vfmacc_vv_f32m4_tu(sq, d, d, vl);
+        lo = __riscv_vfmin_vv_f32m4_tu(lo, lo, x, vl);
+        hi = __riscv_vfmax_vv_f32m4_tu(hi, hi, x, vl);
+    }
+    s1 = __riscv_vfmv_f_s_f32m1_f32(__riscv_vfredusum_vs_f32m4_f32m1(sum, init, vlmax));
+    s2 = __riscv_vfmv_f_s_f32m1_f32(__riscv_vfredusum_vs_f32m4_f32m1(sq, init, vlmax));
+    pStats->mean = x0 + s1 / (float32_t)blockSize;
+    pStats->var = (blockSize > 1U) ? ((s2 - s1 * s1 / (float32_t)blockSize) / (float32_t)(blockSize - 1U)) : 0.0f;
+    pStats->min = __riscv_vfmv_f_s_f32m1_f32(__riscv_vfredmin_vs_f32m4_f32m1(lo, __riscv_vfmv_v_f_f32m1(x0, 1), vlmax));
+    pStats->max = __riscv_vfmv_f_s_f32m1_f32(__riscv_vfredmax_vs_f32m4_f32m1(hi, __riscv_vfmv_v_f_f32m1(x0, 1), vlmax));
+}
+
+#endif /* defined(RISCV_MATH_VECTOR) */
+
+#ifdef   __cplusplus
+}
+#endif
+
+#endif /* _RISCV_VEC_STATISTICS_H_ */
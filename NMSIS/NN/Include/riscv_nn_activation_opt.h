@@ -0,0 +1,562 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2010-2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * Copyright (c) 2022 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* ----------------------------------------------------------------------
+ * Project:      NMSIS NN Library
+ * Title:        riscv_nn_activation_opt.h
+ * Description:  Softmax and table activation kernels with vector exp and LUT gathers
+ *
+ * $Date:        13 November 2023
+ * $Revision:    V.17.6.0
+ *
+ * Target Processor: RISC-V Cores
+ * -------------------------------------------------------------------- */
+
+#ifndef _RISCV_NN_ACTIVATION_OPT_H_
+#define _RISCV_NN_ACTIVATION_OPT_H_
+
+#include "riscv_nnfunctions.h"
+#include "riscv_nnsupportfunctions.h"
+#include "riscv_nn_tables.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * - riscv_softmax_s8_opt(), riscv_softmax_s8_s16_opt(): bit exact to riscv_softmax_s8() and
+ *   riscv_softmax_s8_s16(). With RVV the fixed point exp runs on whole vectors. Rows of at
+ *   least RISCV_NN_SOFTMAX_S8_LUT_MIN values instead take the exp once per input value of
+ *   the row into a 1 KB table on stack, the sum and the outputs are then table lookups,
+ *   without RVV the first pass also counts the values, so the row is read twice and not
+ *   three times, and the exp is done at most 256 times and not twice per value.
+ * - riscv_softmax_s16_opt(): bit exact to riscv_softmax_s16(), with RVV the LUT lookups of
+ *   the exp and of the interpolation neighbour are indexed gathers. With
+ *   RISCV_NN_SOFTMAX_S16_POLY defined it is riscv_softmax_s16_poly() instead.
+ * - riscv_softmax_s16_poly(): same arguments but no LUTs, the exp and the reciprocal are
+ *   the fixed point polynomials of riscv_softmax_s8(), for targets where the 2 KB of the
+ *   two LUTs cost more than the cycles, outputs are within 3 of riscv_softmax_s16().
+ * - riscv_nn_activations_direct_q15_opt(): bit exact to riscv_nn_activations_direct_q15(),
+ *   with RVV the two table entries of each value are gathers.
+ *
+ * Functions without a vector path call the library for the rows they don't speed up.
+ */
+
+/* values in a row from which riscv_softmax_s8_opt() uses the exp table, 0 never does */
+#ifndef RISCV_NN_SOFTMAX_S8_LUT_MIN
+#define RISCV_NN_SOFTMAX_S8_LUT_MIN     256
+#endif
+
+/* integer bits of the sum of exps of riscv_softmax_s8() */
+#define RISCV_NN_SOFTMAX_ACCUM_BITS     12
+
+/* LUT index and interpolation of riscv_softmax_s16(), value is -32768 - 32767 */
+__STATIC_FORCEINLINE int16_t riscv_nn_lut_s16(const int16_t *lut, const int32_t value)
+{
+    const int32_t index = 256 + (value >> 7);
+    const int32_t offset = value & 0x7f;
+    const int16_t base = lut[index];
+    const int16_t slope = lut[index + 1] - lut[index];
+    const int16_t delta = (slope * offset + 64) >> 7;
+
+    return (int16_t)(base + delta);
+}
+
+/* exp of diff to max of riscv_softmax_s8() in Q0.31 */
+__STATIC_FORCEINLINE int32_t riscv_nn_softmax_exp_s8(const int32_t diff, const int32_t mult, const int32_t shift)
+{
+    return EXP_ON_NEG(MUL_SAT(diff * (1 << shift), mult));
+}
+
+#if defined(RISCV_MATH_VECTOR)
+/* riscv_nn_doubling_high_mult() of each, vsmul rounding up the half is the same for both signs */
+__STATIC_FORCEINLINE vint32m4_t riscv_nn_doubling_high_mult_m4_rvv(vint32m4_t a, vint32m4_t b, size_t l)
+{
+    return __riscv_vsmul_vv_i32m4(a, b, __RISCV_VXRM_RNU, l);
+}
+
+/* riscv_nn_divide_by_power_of_two() of each */
+__STATIC_FORCEINLINE vint32m4_t riscv_nn_divide_by_power_of_two_m4_rvv(vint32m4_t val, const int32_t exponent,
+                                                                       size_t l)
+{
+    const int32_t remainder_mask = (1 << exponent) - 1;
+    vint32m4_t res = __riscv_vsra_vx_i32m4(val, exponent, l);
+    vint32m4_t threshold = __riscv_vmv_v_x_i32m4(remainder_mask >> 1, l);
+    vbool8_t mask = __riscv_vmslt_vx_i32m4_b8(res, 0, l);
+
+    threshold = __riscv_vadd_vx_i32m4_mu(mask, threshold, threshold, 1, l);
+    mask = __riscv_vmsgt_vv_i32m4_b8(__riscv_vand_vx_i32m4(val, remainder_mask, l), threshold, l);
+    return __riscv_vadd_vx_i32m4_mu(mask, res, res, 1, l);
+}
+
+/* riscv_nn_exp_on_negative_values() of each */
+__STATIC_FORCEINLINE vint32m4_t riscv_nn_exp_on_negative_values_m4_rvv(vint32m4_t val, size_t l)
+{
+    static const int32_t mults[7] = {1672461947, 1302514674, 790015084, 290630308, 39332535, 720401, 242};
+    vint32m4_t val_mod_minus_quarter = __riscv_vsub_vx_i32m4(__riscv_vand_vx_i32m4(val, (1 << 24) - 1, l), 1 << 24, l);
+    vint32m4_t remainder = __riscv_vsub_vv_i32m4(val_mod_minus_quarter, val, l);
+    vint32m4_t x = __riscv_vadd_vx_i32m4(__riscv_vsll_vx_i32m4(val_mod_minus_quarter, 5, l), 1 << 28, l);
+    vint32m4_t x2 = riscv_nn_doubling_high_mult_m4_rvv(x, x, l);
+    vint32m4_t t, result;
+    vbool8_t mask;
+    int32_t k;
+
+    t = __riscv_vadd_vv_i32m4(riscv_nn_divide_by_power_of_two_m4_rvv(riscv_nn_doubling_high_mult_m4_rvv(x2, x2, l), 2, l),
+                              riscv_nn_doubling_high_mult_m4_rvv(x2, x, l), l);
+    t = __riscv_vadd_vv_i32m4(__riscv_vsmul_vx_i32m4(t, 715827883, __RISCV_VXRM_RNU, l), x2, l);
+    t = __riscv_vadd_vv_i32m4(x, riscv_nn_divide_by_power_of_two_m4_rvv(t, 1, l), l);
+    result = __riscv_vadd_vx_i32m4(__riscv_vsmul_vx_i32m4(t, 1895147668, __RISCV_VXRM_RNU, l), 1895147668, l);
+    for (k = 0; k < 7; k++) {
+        mask = __riscv_vmsne_vx_i32m4_b8(__riscv_vand_vx_i32m4(remainder, 1 << (24 + k), l), 0, l);
+        result = __riscv_vsmul_vx_i32m4_mu(mask, result, result, mults[k], __RISCV_VXRM_RNU, l);
+    }
+    mask = __riscv_vmseq_vx_i32m4_b8(val, 0, l);
+    return __riscv_vmerge_vxm_i32m4(result, NN_Q31_MAX, mask, l);
+}
+
+/* riscv_nn_softmax_exp_s8() of each */
+__STATIC_FORCEINLINE vint32m4_t riscv_nn_softmax_exp_s8_m4_rvv(vint32m4_t diff, const int32_t mult, const int32_t shift,
+                                                               size_t l)
+{
+    diff = __riscv_vsmul_vx_i32m4(__riscv_vsll_vx_i32m4(diff, shift, l), mult, __RISCV_VXRM_RNU, l);
+    return riscv_nn_exp_on_negative_values_m4_rvv(diff, l);
+}
+
+/* riscv_nn_lut_s16() of each, the two entries are gathers of byte offsets */
+__STATIC_FORCEINLINE vint32m4_t riscv_nn_lut_s16_m4_rvv(const int16_t *lut, vint32m4_t value, size_t l)
+{
+    vint32m4_t offset = __riscv_vand_vx_i32m4(value, 0x7f, l);
+    vuint32m4_t index = __riscv_vreinterpret_v_i32m4_u32m4(
+        __riscv_vsll_vx_i32m4(__riscv_vadd_vx_i32m4(__riscv_vsra_vx_i32m4(value, 7, l), 256, l), 1, l));
+    vint16m2_t base = __riscv_vluxei32_v_i16m2(lut, index, l);
+    vint16m2_t slope = __riscv_vsub_vv_i16m2(__riscv_vluxei32_v_i16m2(lut + 1, index, l), base, l);
+    vint32m4_t delta = __riscv_vmul_vv_i32m4(__riscv_vsext_vf2_i32m4(slope, l), offset, l);
+
+    delta = __riscv_vsra_vx_i32m4(__riscv_vadd_vx_i32m4(delta, 64, l), 7, l);
+    return __riscv_vadd_vv_i32m4(__riscv_vsext_vf2_i32m4(base, l), delta, l);
+}
+
+/* byte offsets of the int32 table entries of int8 values, the table starts at value -128 */
+__STATIC_FORCEINLINE vuint32m4_t riscv_nn_s8_table_index_rvv(vint8m1_t v, size_t l)
+{
+    return __riscv_vreinterpret_v_i32m4_u32m4(
+        __riscv_vsll_vx_i32m4(__riscv_vadd_vx_i32m4(__riscv_vsext_vf4_i32m4(v, l), 128, l), 2, l));
+}
+#endif /* defined(RISCV_MATH_VECTOR) */
+
+/* outputs of riscv_nn_softmax_common_s8() of exp in Q0.31 */
+__STATIC_FORCEINLINE int32_t riscv_nn_softmax_out_s8(const int32_t exp, const int32_t shifted_scale,
+                                                     const int32_t bits_over_unit, const bool int16_output)
+{
+    int32_t res = DIV_POW2(MUL_SAT(shifted_scale, exp), bits_over_unit);
+
+    if (int16_output) {
+        return CLAMP(res + NN_Q15_MIN, (int32_t)NN_Q15_MAX, (int32_t)NN_Q15_MIN);
+    }
+    return CLAMP(res + NN_Q7_MIN, (int32_t)NN_Q7_MAX, (int32_t)NN_Q7_MIN);
+}
+
+/*
+ * One row of riscv_nn_softmax_common_s8() on a table of the 256 int8 values, the row is
+ * read twice, the first pass finds the max with RVV and counts the values without.
+ */
+__STATIC_INLINE void riscv_nn_softmax_row_lut_s8(const int8_t *input, const int32_t row_size, const int32_t mult,
+                                                 const int32_t shift, const int32_t diff_min,
+                                                 const bool int16_output, void *output)
+{
+    int32_t table[256];
+    int32_t col, v, lo, max, sum = 0, headroom, shifted_scale, bits_over_unit;
+
+#if defined(RISCV_MATH_VECTOR)
+    size_t l;
+    vint8m1_t in;
+    vint32m4_t e, acc;
+    vint32m1_t red;
+
+    red = __riscv_vmv_v_x_i32m1(0, 1);
+    max = NN_Q7_MIN;
+    for (col = 0; col < row_size; col += l) {
+        l = __riscv_vsetvl_e8m1(row_size - col);
+        in = __riscv_vle8_v_i8m1(input + col, l);
+        max = __riscv_vmv_x_s_i8m1_i8(__riscv_vredmax_vs_i8m1_i8m1(in, __riscv_vmv_s_x_i8m1((int8_t)max, l), l));
+    }
+    lo = MAX(max + diff_min, NN_Q7_MIN);
+    memset(table, 0, (size_t)(lo + 128) * sizeof(int32_t));
+    for (v = lo; v <= max; v += l) {
+        l = __riscv_vsetvl_e32m4(max + 1 - v);
+        e = __riscv_vsub_vx_i32m4(__riscv_vreinterpret_v_u32m4_i32m4(__riscv_vid_v_u32m4(l)), max - v, l);
+        __riscv_vse32_v_i32m4(table + v + 128, riscv_nn_softmax_exp_s8_m4_rvv(e, mult, shift, l), l);
+    }
+    acc = __riscv_vmv_v_x_i32m4(0, __riscv_vsetvlmax_e32m4());
+    for (col = 0; col < row_size; col += l) {
+        l = __riscv_vsetvl_e8m1(row_size - col);
+        e = __riscv_vluxei32_v_i32m4(table, riscv_nn_s8_table_index_rvv(__riscv_vle8_v_i8m1(input + col, l), l), l);
+        acc = __riscv_vadd_vv_i32m4_tu(acc, acc, riscv_nn_divide_by_power_of_two_m4_rvv(e, RISCV_NN_SOFTMAX_ACCUM_BITS, l), l);
+    }
+    sum = __riscv_vmv_x_s_i32m1_i32(__riscv_vredsum_vs_i32m4_i32m1(acc, red, __riscv_vsetvlmax_e32m4()));
+#else
+    // table holds the count of each value until its exp is known
+    memset(table, 0, sizeof(table));
+    max = NN_Q7_MIN;
+    for (col = 0; col < row_size; col++) {
+        table[input[col] + 128]++;
+        max = MAX(max, input[col]);
+    }
+    lo = MAX(max + diff_min, NN_Q7_MIN);
+    memset(table, 0, (size_t)(lo + 128) * sizeof(int32_t));
+    for (v = lo; v <= max; v++) {
+        int32_t e = riscv_nn_softmax_exp_s8(v - max, mult, shift);
+
+        sum += table[v + 128] * DIV_POW2(e, RISCV_NN_SOFTMAX_ACCUM_BITS);
+        table[v + 128] = e;
+    }
+#endif
+    headroom = __CLZ(sum);
+    shifted_scale = ONE_OVER1((int32_t)((uint32_t)(sum > 0 ? sum << headroom : 0) - 0x80000000UL));
+    bits_over_unit = RISCV_NN_SOFTMAX_ACCUM_BITS - headroom + (int16_output ? 15 : 23);
+
+    // outputs of values below diff_min are the min, same as an exp of 0
+    for (v = -128; v < lo; v++) {
+        table[v + 128] = int16_output ? NN_Q15_MIN : NN_Q7_MIN;
+    }
+    for (v = lo; v <= max; v++) {
+        table[v + 128] = riscv_nn_softmax_out_s8(table[v + 128], shifted_scale, bits_over_unit, int16_output);
+    }
+#if defined(RISCV_MATH_VECTOR)
+    for (col = 0; col < row_size; col += l) {
+        l = __riscv_vsetvl_e8m1(row_size - col);
+        e = __riscv_vluxei32_v_i32m4(table, riscv_nn_s8_table_index_rvv(__riscv_vle8_v_i8m1(input + col, l), l), l);
+        if (int16_output) {
+            __riscv_vse16_v_i16m2((int16_t *)output + col, __riscv_vncvt_x_x_w_i16m2(e, l), l);
+        } else {
+            __riscv_vse8_v_i8m1((int8_t *)output + col,
+                                __riscv_vncvt_x_x_w_i8m1(__riscv_vncvt_x_x_w_i16m2(e, l), l), l);
+        }
+    }
+#else
+    for (col = 0; col < row_size; col++) {
+        if (int16_output) {
+            ((int16_t *)output)[col] = (int16_t)table[input[col] + 128];
+        } else {
+            ((int8_t *)output)[col] = (int8_t)table[input[col] + 128];
+        }
+    }
+#endif
+}
+
+#if defined(RISCV_MATH_VECTOR)
+/* One row of riscv_nn_softmax_common_s8() with the exp on vectors */
+__STATIC_INLINE void riscv_nn_softmax_row_s8_rvv(const int8_t *input, const int32_t row_size, const int32_t mult,
+                                                 const int32_t shift, const int32_t diff_min,
+                                                 const bool int16_output, void *output)
+{
+    const int32_t vlmax = __riscv_vsetvlmax_e32m4();
+    int32_t col, max, sum, headroom, shifted_scale, bits_over_unit;
+    size_t l;
+    vint8m1_t in;
+    vint32m4_t d, e, acc;
+    vbool8_t valid;
+
+    max = NN_Q7_MIN;
+    for (col = 0; col < row_size; col += l) {
+        l = __riscv_vsetvl_e8m1(row_size - col);
+        in = __riscv_vle8_v_i8m1(input + col, l);
+        max = __riscv_vmv_x_s_i8m1_i8(__riscv_vredmax_vs_i8m1_i8m1(in, __riscv_vmv_s_x_i8m1((int8_t)max, l), l));
+    }
+    acc = __riscv_vmv_v_x_i32m4(0, vlmax);
+    for (col = 0; col < row_size; col += l) {
+        l = __riscv_vsetvl_e8m1(row_size - col);
+        d = __riscv_vsub_vx_i32m4(__riscv_vsext_vf4_i32m4(__riscv_vle8_v_i8m1(input + col, l), l), max, l);
+        valid = __riscv_vmsge_vx_i32m4_b8(d, diff_min, l);
+        e = riscv_nn_divide_by_power_of_two_m4_rvv(riscv_nn_softmax_exp_s8_m4_rvv(d, mult, shift, l),
+                                                   RISCV_NN_SOFTMAX_ACCUM_BITS, l);
+        acc = __riscv_vadd_vv_i32m4_tumu(valid, acc, acc, e, l);
+    }
+    sum = __riscv_vmv_x_s_i32m1_i32(__riscv_vredsum_vs_i32m4_i32m1(acc, __riscv_vmv_v_x_i32m1(0, 1), vlmax));
+    headroom = __CLZ(sum);
+    shifted_scale = ONE_OVER1((int32_t)((uint32_t)(sum > 0 ? sum << headroom : 0) - 0x80000000UL));
+    bits_over_unit = RISCV_NN_SOFTMAX_ACCUM_BITS - headroom + (int16_output ? 15 : 23);
+
+    for (col = 0; col < row_size; col += l) {
+        l = __riscv_vsetvl_e8m1(row_size - col);
+        d = __riscv_vsub_vx_i32m4(__riscv_vsext_vf4_i32m4(__riscv_vle8_v_i8m1(input + col, l), l), max, l);
+        valid = __riscv_vmsge_vx_i32m4_b8(d, diff_min, l);
+        e = __riscv_vsmul_vx_i32m4(riscv_nn_softmax_exp_s8_m4_rvv(d, mult, shift, l), shifted_scale,
+                                   __RISCV_VXRM_RNU, l);
+        e = riscv_nn_divide_by_power_of_two_m4_rvv(e, bits_over_unit, l);
+        if (int16_output) {
+            e = __riscv_vmin_vx_i32m4(__riscv_vmax_vx_i32m4(__riscv_vadd_vx_i32m4(e, NN_Q15_MIN, l), NN_Q15_MIN, l),
+                                      NN_Q15_MAX, l);
+            e = __riscv_vmerge_vvm_i32m4(__riscv_vmv_v_x_i32m4(NN_Q15_MIN, l), e, valid, l);
+            __riscv_vse16_v_i16m2((int16_t *)output + col, __riscv_vncvt_x_x_w_i16m2(e, l), l);
+        } else {
+            e = __riscv_vmin_vx_i32m4(__riscv_vmax_vx_i32m4(__riscv_vadd_vx_i32m4(e, NN_Q7_MIN, l), NN_Q7_MIN, l),
+                                      NN_Q7_MAX, l);
+            e = __riscv_vmerge_vvm_i32m4(__riscv_vmv_v_x_i32m4(NN_Q7_MIN, l), e, valid, l);
+            __riscv_vse8_v_i8m1((int8_t *)output + col,
+                                __riscv_vncvt_x_x_w_i8m1(__riscv_vncvt_x_x_w_i16m2(e, l), l), l);
+        }
+    }
+}
+#endif /* defined(RISCV_MATH_VECTOR) */
+
+/**
+ * @brief Same as riscv_nn_softmax_common_s8(), see it for the arguments
+ */
+__STATIC_INLINE void riscv_nn_softmax_common_s8_opt(const int8_t *input, const int32_t num_rows,
+                                                    const int32_t row_size, const int32_t mult, const int32_t shift,
+                                                    const int32_t diff_min, const bool int16_output, void *output)
+{
+    const int32_t out_bytes = int16_output ? (int32_t)sizeof(int16_t) : (int32_t)sizeof(int8_t);
+    int32_t row;
+
+    for (row = 0; row < num_rows; row++) {
+        void *out = (int8_t *)output + row * row_size * out_bytes;
+
+        if ((RISCV_NN_SOFTMAX_S8_LUT_MIN > 0) && (row_size >= RISCV_NN_SOFTMAX_S8_LUT_MIN)) {
+            riscv_nn_softmax_row_lut_s8(input, row_size, mult, shift, diff_min, int16_output, out);
+        } else {
+#if defined(RISCV_MATH_VECTOR)
+            riscv_nn_softmax_row_s8_rvv(input, row_size, mult, shift, diff_min, int16_output, out);
+#else
+            riscv_nn_softmax_common_s8(input, 1, row_size, mult, shift, diff_min, int16_output, out);
+#endif
+        }
+        input += row_size;
+    }
+}
+
+/**
+ * @brief Same as riscv_softmax_s8(), see it for the arguments
+ */
+__STATIC_INLINE void riscv_softmax_s8_opt(const int8_t *input, const int32_t num_rows, const int32_t row_size,
+                                          const int32_t mult, const int32_t shift, const int32_t diff_min,
+                                          int8_t *output)
+{
+    riscv_nn_softmax_common_s8_opt(input, num_rows, row_size, mult, shift, diff_min, false, output);
+}
+
+/**
+ * @brief Same as riscv_softmax_s8_s16(), see it for the arguments
+ */
+__STATIC_INLINE void riscv_softmax_s8_s16_opt(const int8_t *input, const int32_t num_rows, const int32_t row_size,
+                                              const int32_t mult, const int32_t shift, const int32_t diff_min,
+                                              int16_t *output)
+{
+    riscv_nn_softmax_common_s8_opt(input, num_rows, row_size, mult, shift, diff_min, true, output);
+}
+
+/**
+ * @brief riscv_softmax_s16() without the LUTs, exp and reciprocal are fixed point polynomials
+ * @param[in]  input     Pointer to the input tensor
+ * @param[in]  num_rows  Number of rows in the input tensor
+ * @param[in]  row_size  Number of elements in each input row
+ * @param[in]  mult      Input quantization multiplier, same as riscv_softmax_s16()
+ * @param[in]  shift     Input quantization shift, same as riscv_softmax_s16()
+ * @param[out] output    Pointer to the output tensor
+ *
+ * @details The scaled diff to the max of riscv_softmax_s16() is x of exp(x) in steps of
+ *          10 / 65536, times 10240 it is the Q5.26 input of riscv_nn_exp_on_negative_values(),
+ *          it stops at -10 as the exp LUT does.
+ *          The exps are rounded to Q0.15 in the output, their sum gets the reciprocal of
+ *          riscv_nn_one_over_one_plus_x_for_x_in_0_1(), outputs are exp / sum in Q0.15.
+ */
+__STATIC_INLINE void riscv_softmax_s16_poly(const int16_t *input, const int32_t num_rows, const int32_t row_size,
+                                            const int32_t mult, const int32_t shift, int16_t *output)
+{
+    int32_t row, col, max, sum, headroom, shifted_scale;
+
+    for (row = 0; row < num_rows; row++) {
+#if defined(RISCV_MATH_VECTOR)
+        size_t l;
+        vint16m2_t in;
+        vint32m4_t d;
+        vint32m1_t acc;
+
+        max = NN_Q15_MIN;
+        for (col = 0; col < row_size; col += l) {
+            l = __riscv_vsetvl_e16m2(row_size - col);
+            in = __riscv_vle16_v_i16m2(input + col, l);
+            max = __riscv_vmv_x_s_i16m1_i16(__riscv_vredmax_vs_i16m2_i16m1(in, __riscv_vmv_s_x_i16m1((int16_t)max, l), l));
+        }
+        acc = __riscv_vmv_v_x_i32m1(0, 1);
+        for (col = 0; col < row_size; col += l) {
+            l = __riscv_vsetvl_e16m2(row_size - col);
+            d = __riscv_vsub_vx_i32m4(__riscv_vsext_vf2_i32m4(__riscv_vle16_v_i16m2(input + col, l), l), max, l);
+            d = __riscv_vmax_vx_i32m4(riscv_nn_requantize_m4_rvv(d, l, mult, shift), -65535, l);
+            d = riscv_nn_exp_on_negative_values_m4_rvv(__riscv_vmul_vx_i32m4(d, 10240, l), l);
+            d = __riscv_vmin_vx_i32m4(__riscv_vssra_vx_i32m4(d, 16, __RISCV_VXRM_RNU, l), NN_Q15_MAX, l);
+            in = __riscv_vncvt_x_x_w_i16m2(d, l);
+            __riscv_vse16_v_i16m2(output + col, in, l);
+            acc = __riscv_vwredsum_vs_i16m2_i32m1(in, acc, l);
+        }
+        sum = __riscv_vmv_x_s_i32m1_i32(acc);
+#else
+        max = input[0];
+        for (col = 1; col < row_size; col++) {
+            max = MAX(max, input[col]);
+        }
+        sum = 0;
+        for (col = 0; col < row_size; col++) {
+            int32_t d = MAX(riscv_nn_requantize(input[col] - max, mult, shift), -65535);
+
+            d = EXP_ON_NEG(d * 10240);
+            d = MIN((d >> 16) + ((d >> 15) & 1), NN_Q15_MAX);
+            output[col] = (int16_t)d;
+            sum += d;
+        }
+#endif
+        // the exp of the max is 32767, so the sum is not 0
+        headroom = __CLZ(sum);
+        shifted_scale = MUL_SAT(ONE_OVER1((int32_t)((uint32_t)(sum << headroom) - 0x80000000UL)), NN_Q15_MAX << 16);
+#if defined(RISCV_MATH_VECTOR)
+        for (col = 0; col < row_size; col += l) {
+            l = __riscv_vsetvl_e16m2(row_size - col);
+            d = __riscv_vsll_vx_i32m4(__riscv_vsext_vf2_i32m4(__riscv_vle16_v_i16m2(output + col, l), l), 16, l);
+            d = __riscv_vsmul_vx_i32m4(d, shifted_scale, __RISCV_VXRM_RNU, l);
+            d = riscv_nn_divide_by_power_of_two_m4_rvv(d, 32 - headroom, l);
+            d = __riscv_vmin_vx_i32m4(__riscv_vmax_vx_i32m4(d, 0, l), NN_Q15_MAX, l);
+            __riscv_vse16_v_i16m2(output + col, __riscv_vncvt_x_x_w_i16m2(d, l), l);
+        }
+#else
+        for (col = 0; col < row_size; col++) {
+            int32_t d = DIV_POW2(MUL_SAT(output[col] * (1 << 16), shifted_scale), 32 - headroom);
+
+            output[col] = (int16_t)CLAMP(d, (int32_t)NN_Q15_MAX, 0);
+        }
+#endif
+        input += row_size;
+        output += row_size;
+    }
+}
+
+/**
+ * @brief Same as riscv_softmax_s16(), see it for the arguments, with
+ *        RISCV_NN_SOFTMAX_S16_POLY defined it is riscv_softmax_s16_poly() and the LUTs
+ *        of softmax_params are not used
+ * @return     <code>RISCV_NMSIS_NN_ARG_ERROR</code> if a LUT is NULL, else
+ *             <code>RISCV_NMSIS_NN_SUCCESS</code>
+ */
+__STATIC_INLINE riscv_nmsis_nn_status riscv_softmax_s16_opt(const int16_t *input, const int32_t num_rows,
+                                                            const int32_t row_size, const int32_t mult,
+                                                            const int32_t shift,
+                                                            const nmsis_nn_softmax_lut_s16 *softmax_params,
+                                                            int16_t *output)
+{
+#if defined(RISCV_NN_SOFTMAX_S16_POLY)
+    (void)softmax_params;
+    riscv_softmax_s16_poly(input, num_rows, row_size, mult, shift, output);
+    return RISCV_NMSIS_NN_SUCCESS;
+#elif defined(RISCV_MATH_VECTOR)
+    const int16_t *exp_lut = softmax_params->exp_lut;
+    int32_t row, col, max, sum, headroom, shifted_sum, right_shift;
+    int16_t one_by_one;
+    size_t l;
+    vint16m2_t in;
+    vint32m4_t d;
+    vint32m1_t acc;
+
+    if ((exp_lut == NULL) || (softmax_params->one_by_one_lut == NULL)) {
+        return RISCV_NMSIS_NN_ARG_ERROR;
+    }
+    for (row = 0; row < num_rows; row++) {
+        max = NN_Q15_MIN;
+        for (col = 0; col < row_size; col += l) {
+            l = __riscv_vsetvl_e16m2(row_size - col);
+            in = __riscv_vle16_v_i16m2(input + col, l);
+            max = __riscv_vmv_x_s_i16m1_i16(__riscv_vredmax_vs_i16m2_i16m1(in, __riscv_vmv_s_x_i16m1((int16_t)max, l), l));
+        }
+        // exps are cached in the output
+        acc = __riscv_vmv_v_x_i32m1(0, 1);
+        for (col = 0; col < row_size; col += l) {
+            l = __riscv_vsetvl_e16m2(row_size - col);
+            d = __riscv_vsub_vx_i32m4(__riscv_vsext_vf2_i32m4(__riscv_vle16_v_i16m2(input + col, l), l), max, l);
+            d = __riscv_vadd_vx_i32m4(riscv_nn_requantize_m4_rvv(d, l, mult, shift), NN_Q15_MAX, l);
+            d = __riscv_vmin_vx_i32m4(__riscv_vmax_vx_i32m4(d, NN_Q15_MIN, l), NN_Q15_MAX, l);
+            in = __riscv_vncvt_x_x_w_i16m2(riscv_nn_lut_s16_m4_rvv(exp_lut, d, l), l);
+            __riscv_vse16_v_i16m2(output + col, in, l);
+            acc = __riscv_vwredsum_vs_i16m2_i32m1(in, acc, l);
+        }
+        sum = __riscv_vmv_x_s_i32m1_i32(acc);
+        headroom = __CLZ(sum);
+        // 1 / (1 + x) of the sum scaled to 1 - 2, recentered to the symmetric LUT input
+        shifted_sum = (((sum) << (headroom - 1)) + (1 << 13)) >> 14;
+        one_by_one = riscv_nn_lut_s16(softmax_params->one_by_one_lut, shifted_sum + NN_Q15_MIN - (1 << 16));
+        right_shift = 30 - headroom;
+        for (col = 0; col < row_size; col += l) {
+            l = __riscv_vsetvl_e16m2(row_size - col);
+            d = __riscv_vwmul_vx_i32m4(__riscv_vle16_v_i16m2(output + col, l), one_by_one, l);
+            // (d >> right_shift + 1) >> 1
+            d = __riscv_vssra_vx_i32m4(d, right_shift + 1, __RISCV_VXRM_RNU, l);
+            __riscv_vse16_v_i16m2(output + col, __riscv_vncvt_x_x_w_i16m2(d, l), l);
+        }
+        input += row_size;
+        output += row_size;
+    }
+    return RISCV_NMSIS_NN_SUCCESS;
+#else
+    return riscv_softmax_s16(input, num_rows, row_size, mult, shift, softmax_params, output);
+#endif
+}
+
+/**
+ * @brief Same as riscv_nn_activations_direct_q15(), see it for the arguments
+ */
+__STATIC_INLINE void riscv_nn_activations_direct_q15_opt(q15_t *data, uint16_t size, uint16_t int_width,
+                                                         riscv_nn_activation_type type)
+{
+#if defined(RISCV_MATH_VECTOR)
+    const uint32_t shift_size = 8 + 3 - int_width;
+    const int32_t bit_mask = 0x7FF >> int_width;
+    const q15_t *lookup_table = (type == RISCV_SIGMOID) ? sigmoidTable_q15 : tanhTable_q15;
+    int32_t blk = size;
+    size_t l;
+    vint32m4_t in, idx, frac, value, value2;
+    vbool8_t last;
+
+    for (; blk > 0; blk -= l) {
+        l = __riscv_vsetvl_e16m2(blk);
+        in = __riscv_vsext_vf2_i32m4(__riscv_vle16_v_i16m2(data, l), l);
+        frac = __riscv_vand_vx_i32m4(in, bit_mask, l);
+        idx = __riscv_vsra_vx_i32m4(in, shift_size, l);
+        // the largest positive value has no right side to interpolate with
+        last = __riscv_vmseq_vx_i32m4_b8(idx, 0x7f, l);
+        idx = __riscv_vand_vx_i32m4(idx, 0xff, l);
+        value = __riscv_vsext_vf2_i32m4(__riscv_vluxei32_v_i16m2(lookup_table,
+                                        __riscv_vreinterpret_v_i32m4_u32m4(__riscv_vsll_vx_i32m4(idx, 1, l)), l), l);
+        idx = __riscv_vand_vx_i32m4(__riscv_vadd_vx_i32m4(idx, 1, l), 0xff, l);
+        value2 = __riscv_vsext_vf2_i32m4(__riscv_vluxei32_v_i16m2(lookup_table,
+                                         __riscv_vreinterpret_v_i32m4_u32m4(__riscv_vsll_vx_i32m4(idx, 1, l)), l), l);
+        value2 = __riscv_vmul_vv_i32m4(value2, frac, l);
+        frac = __riscv_vrsub_vx_i32m4(frac, bit_mask + 1, l);
+        value2 = __riscv_vsra_vx_i32m4(__riscv_vmacc_vv_i32m4(value2, frac, value, l), shift_size, l);
+        value = __riscv_vmerge_vvm_i32m4(value2, value, last, l);
+        __riscv_vse16_v_i16m2(data, __riscv_vncvt_x_x_w_i16m2(value, l), l);
+        data += l;
+    }
+#else
+    riscv_nn_activations_direct_q15(data, size, int_width, type);
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RISCV_NN_ACTIVATION_OPT_H_ */
@@ -0,0 +1,338 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2010-2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * Copyright (c) 2022 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* ----------------------------------------------------------------------
+ * Project:      NMSIS NN Library
+ * Title:        riscv_nn_gemm_rvv.h
+ * Description:  RVV int8 matrix multiplication kernels on pre-packed weights
+ *
+ * $Date:        13 November 2023
+ * $Revision:    V.17.6.0
+ *
+ * Target Processor: RISC-V Cores
+ * -------------------------------------------------------------------- */
+
+#ifndef _RISCV_NN_GEMM_RVV_H_
+#define _RISCV_NN_GEMM_RVV_H_
+
+#include "riscv_nnsupportfunctions.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The kernels of this file take the rhs, weights of one output channel per row, packed by
+ * riscv_nn_pack_rhs_s8_rvv() into blocks of RISCV_NN_PACK_COLS channels, stored k major,
+ * so one load of a k gives the weights of all the channels of a block. The packing is
+ * done once, at init or offline, and also folds lhs_offset times the kernel sums into
+ * the bias, so the inner loop is one vwmacc of a lhs value into the channel lanes.
+ *
+ * The lanes are output channels of one block, a vsetvl on e32m4 picks how many, so the
+ * same packed weights run on any VLEN, RISCV_NN_PACK_COLS of vlmax e32m4 fills a vector.
+ * The per channel requantization, offset and clamp are done on the accumulators before
+ * the narrowing store. Outputs are bit exact to the riscv_nn_* kernels on unpacked rhs.
+ */
+
+/** Output channels of one block of packed rhs, vlmax of e32m4 at VLEN 128 */
+#ifndef RISCV_NN_PACK_COLS
+#define RISCV_NN_PACK_COLS 16
+#endif
+
+/**
+ * @brief Bytes of packed rhs for riscv_nn_pack_rhs_s8_rvv()
+ * @param[in]  rhs_rows  Number of rhs rows, output channels
+ * @param[in]  rhs_cols  Number of rhs columns
+ * @return     Size of packed rhs, rows padded to a multiple of RISCV_NN_PACK_COLS
+ */
+__STATIC_INLINE int32_t riscv_nn_pack_rhs_s8_rvv_get_buffer_size(const int32_t rhs_rows, const int32_t rhs_cols)
+{
+    return ((rhs_rows + RISCV_NN_PACK_COLS - 1) / RISCV_NN_PACK_COLS) * RISCV_NN_PACK_COLS * rhs_cols;
+}
+
+/**
+ * @brief Pack rhs for the kernels of this file, channels of padding are zero
+ * @param[in]  rhs          Rhs matrix, rhs_rows rows of rhs_cols weights
+ * @param[in]  bias         Bias of rhs_rows channels, can be NULL
+ * @param[in]  rhs_rows     Number of rhs rows
+ * @param[in]  rhs_cols     Number of rhs columns
+ * @param[in]  lhs_offset   Offset added to the lhs values by the kernel it is packed for
+ * @param[out] packed_rhs   Packed rhs of riscv_nn_pack_rhs_s8_rvv_get_buffer_size() bytes
+ * @param[out] packed_bias  bias + lhs_offset * sum of rhs row, rhs_rows values, can be NULL
+ */
+__STATIC_INLINE void riscv_nn_pack_rhs_s8_rvv(const int8_t *rhs, const int32_t *bias, const int32_t rhs_rows,
+                                              const int32_t rhs_cols, const int32_t lhs_offset, int8_t *packed_rhs,
+                                              int32_t *packed_bias)
+{
+    int32_t blocks = (rhs_rows + RISCV_NN_PACK_COLS - 1) / RISCV_NN_PACK_COLS;
+    int32_t b, j, k, c, sum;
+
+    for (b = 0; b < blocks; b++) {
+        for (k = 0; k < rhs_cols; k++) {
+            for (j = 0; j < RISCV_NN_PACK_COLS; j++) {
+                c = b * RISCV_NN_PACK_COLS + j;
+                *packed_rhs++ = (c < rhs_rows) ? rhs[c * rhs_cols + k] : 0;
+            }
+        }
+    }
+    if (packed_bias != NULL) {
+        for (c = 0; c < rhs_rows; c++) {
+            sum = 0;
+            for (k = 0; k < rhs_cols; k++) {
+                sum += rhs[c * rhs_cols + k];
+            }
+            packed_bias[c] = ((bias != NULL) ? bias[c] : 0) + lhs_offset * sum;
+        }
+    }
+}
+
+#if defined(RISCV_MATH_VECTOR)
+
+/**
+ * @brief Requantize lanes with per lane multiplier and shift, same as riscv_nn_requantize()
+ */
+__STATIC_FORCEINLINE vint32m4_t riscv_nn_requantize_vv_m4_rvv(vint32m4_t val, vint32m4_t multiplier, vint32m4_t shift,
+                                                             size_t l)
+{
+    vuint32m4_t ls = __riscv_vreinterpret_v_i32m4_u32m4(__riscv_vmax_vx_i32m4(shift, 0, l));
+    vuint32m4_t rs = __riscv_vreinterpret_v_i32m4_u32m4(__riscv_vneg_v_i32m4(__riscv_vmin_vx_i32m4(shift, 0, l), l));
+    vint32m4_t mask, threshold, result;
+    vbool8_t m;
+
+    val = __riscv_vsmul_vv_i32m4(__riscv_vsll_vv_i32m4(val, ls, l), multiplier, __RISCV_VXRM_RNU, l);
+    // rounding divide by 2 ^ rs with mid point away from zero, as riscv_nn_divide_by_power_of_two()
+    mask = __riscv_vsub_vx_i32m4(__riscv_vsll_vv_i32m4(__riscv_vmv_v_x_i32m4(1, l), rs, l), 1, l);
+    result = __riscv_vsra_vv_i32m4(val, rs, l);
+    threshold = __riscv_vsra_vx_i32m4(mask, 1, l);
+    m = __riscv_vmslt_vx_i32m4_b8(result, 0, l);
+    threshold = __riscv_vadd_vx_i32m4_mu(m, threshold, threshold, 1, l);
+    m = __riscv_vmsgt_vv_i32m4_b8(__riscv_vand_vv_i32m4(val, mask, l), threshold, l);
+    return __riscv_vadd_vx_i32m4_mu(m, result, result, 1, l);
+}
+
+/* add dst_offset, clamp and narrow l lanes of requantized val to int8 */
+__STATIC_FORCEINLINE vint8m1_t riscv_nn_narrow_s8_rvv(vint32m4_t val, const int32_t dst_offset,
+                                                     const int32_t activation_min, const int32_t activation_max,
+                                                     size_t l)
+{
+    val = __riscv_vadd_vx_i32m4(val, dst_offset, l);
+    val = __riscv_vmin_vx_i32m4(__riscv_vmax_vx_i32m4(val, activation_min, l), activation_max, l);
+    return __riscv_vncvt_x_x_w_i8m1(__riscv_vncvt_x_x_w_i16m2(val, l), l);
+}
+
+/**
+ * @brief Same as riscv_nn_mat_mult_nt_t_s8() on rhs packed by riscv_nn_pack_rhs_s8_rvv()
+ *        with lhs_offset, 4 lhs rows share each load of packed weights
+ * @param[in]  lhs              Lhs matrix, lhs_rows rows of rhs_cols values
+ * @param[in]  packed_rhs       Packed rhs
+ * @param[in]  packed_bias      Packed bias, with lhs_offset folded in
+ * @param[out] dst              Output, lhs_rows rows of rhs_rows values
+ * @param[in]  dst_multipliers  Per channel multipliers
+ * @param[in]  dst_shifts       Per channel shifts
+ * @param[in]  lhs_rows         Number of lhs rows
+ * @param[in]  rhs_rows         Number of rhs rows
+ * @param[in]  rhs_cols         Number of lhs and rhs columns
+ * @param[in]  dst_offset       Offset added to the output
+ * @param[in]  activation_min   Min of output
+ * @param[in]  activation_max   Max of output
+ * @param[in]  lhs_cols_offset  Column offset between subsequent lhs rows
+ * @return     <code>RISCV_NMSIS_NN_SUCCESS</code>
+ */
+__STATIC_INLINE riscv_nmsis_nn_status riscv_nn_mat_mult_nt_t_s8_rvv(const int8_t *lhs, const int8_t *packed_rhs,
+                                                                    const int32_t *packed_bias, int8_t *dst,
+                                                                    const int32_t *dst_multipliers,
+                                                                    const int32_t *dst_shifts, const int32_t lhs_rows,
+                                                                    const int32_t rhs_rows, const int32_t rhs_cols,
+                                                                    const int32_t dst_offset,
+                                                                    const int32_t activation_min,
+                                                                    const int32_t activation_max,
+                                                                    const int32_t lhs_cols_offset)
+{
+    const int32_t lhs_step = rhs_cols + lhs_cols_offset;
+    const int8_t *a0, *a1, *a2, *a3, *w;
+    int32_t c0, cols, j, r, k;
+    size_t l;
+    vint32m4_t bias, mult, shift, acc0, acc1, acc2, acc3;
+    vint16m2_t w16;
+
+    for (c0 = 0; c0 < rhs_rows; c0 += RISCV_NN_PACK_COLS) {
+        cols = MIN(RISCV_NN_PACK_COLS, rhs_rows - c0);
+        for (j = 0; j < cols; j += l) {
+            l = __riscv_vsetvl_e32m4(cols - j);
+            bias = __riscv_vle32_v_i32m4(packed_bias + c0 + j, l);
+            mult = __riscv_vle32_v_i32m4(dst_multipliers + c0 + j, l);
+            shift = __riscv_vle32_v_i32m4(dst_shifts + c0 + j, l);
+            for (r = 0; r < lhs_rows; r += 4) {
+                // rows past the last one repeat it, their results are not stored
+                a0 = lhs + r * lhs_step;
+                a1 = (r + 1 < lhs_rows) ? (a0 + lhs_step) : a0;
+                a2 = (r + 2 < lhs_rows) ? (a1 + lhs_step) : a1;
+                a3 = (r + 3 < lhs_rows) ? (a2 + lhs_step) : a2;
+                acc0 = acc1 = acc2 = acc3 = bias;
+                w = packed_rhs + c0 * rhs_cols + j;
+                for (k = 0; k < rhs_cols; k++) {
+                    w16 = __riscv_vsext_vf2_i16m2(__riscv_vle8_v_i8m1(w, l), l);
+                    acc0 = __riscv_vwmacc_vx_i32m4(acc0, a0[k], w16, l);
+                    acc1 = __riscv_vwmacc_vx_i32m4(acc1, a1[k], w16, l);
+                    acc2 = __riscv_vwmacc_vx_i32m4(acc2, a2[k], w16, l);
+                    acc3 = __riscv_vwmacc_vx_i32m4(acc3, a3[k], w16, l);
+                    w += RISCV_NN_PACK_COLS;
+                }
+                __riscv_vse8_v_i8m1(dst + r * rhs_rows + c0 + j,
+                                    riscv_nn_narrow_s8_rvv(riscv_nn_requantize_vv_m4_rvv(acc0, mult, shift, l),
+                                                           dst_offset, activation_min, activation_max, l), l);
+                if (r + 1 < lhs_rows) {
+                    __riscv_vse8_v_i8m1(dst + (r + 1) * rhs_rows + c0 + j,
+                                        riscv_nn_narrow_s8_rvv(riscv_nn_requantize_vv_m4_rvv(acc1, mult, shift, l),
+                                                               dst_offset, activation_min, activation_max, l), l);
+                }
+                if (r + 2 < lhs_rows) {
+                    __riscv_vse8_v_i8m1(dst + (r + 2) * rhs_rows + c0 + j,
+                                        riscv_nn_narrow_s8_rvv(riscv_nn_requantize_vv_m4_rvv(acc2, mult, shift, l),
+                                                               dst_offset, activation_min, activation_max, l), l);
+                }
+                if (r + 3 < lhs_rows) {
+                    __riscv_vse8_v_i8m1(dst + (r + 3) * rhs_rows + c0 + j,
+                                        riscv_nn_narrow_s8_rvv(riscv_nn_requantize_vv_m4_rvv(acc3, mult, shift, l),
+                                                               dst_offset, activation_min, activation_max, l), l);
+                }
+            }
+        }
+    }
+    return RISCV_NMSIS_NN_SUCCESS;
+}
+
+/**
+ * @brief Same as riscv_nn_vec_mat_mult_t_s8() on rhs packed by riscv_nn_pack_rhs_s8_rvv()
+ *        with lhs_offset, the kernel sums are in packed_bias
+ * @param[in]  lhs             Lhs vector of rhs_cols values
+ * @param[in]  packed_rhs      Packed rhs
+ * @param[in]  packed_bias     Packed bias, with lhs_offset folded in
+ * @param[out] dst             Output of rhs_rows values
+ * @param[in]  dst_offset      Offset added to the output
+ * @param[in]  dst_multiplier  Output multiplier
+ * @param[in]  dst_shift       Output shift
+ * @param[in]  rhs_cols        Number of rhs columns
+ * @param[in]  rhs_rows        Number of rhs rows
+ * @param[in]  activation_min  Min of output
+ * @param[in]  activation_max  Max of output
+ * @param[in]  address_offset  Memory position offset between outputs
+ * @return     <code>RISCV_NMSIS_NN_SUCCESS</code>
+ */
+__STATIC_INLINE riscv_nmsis_nn_status riscv_nn_vec_mat_mult_t_s8_rvv(const int8_t *lhs, const int8_t *packed_rhs,
+                                                                     const int32_t *packed_bias, int8_t *dst,
+                                                                     const int32_t dst_offset,
+                                                                     const int32_t dst_multiplier,
+                                                                     const int32_t dst_shift, const int32_t rhs_cols,
+                                                                     const int32_t rhs_rows,
+                                                                     const int32_t activation_min,
+                                                                     const int32_t activation_max,
+                                                                     const int32_t address_offset)
+{
+    const int8_t *w;
+    int32_t c0, cols, j, k;
+    size_t l;
+    vint32m4_t acc0, acc1;
+    vint8m1_t out;
+
+    for (c0 = 0; c0 < rhs_rows; c0 += RISCV_NN_PACK_COLS) {
+        cols = MIN(RISCV_NN_PACK_COLS, rhs_rows - c0);
+        for (j = 0; j < cols; j += l) {
+            l = __riscv_vsetvl_e32m4(cols - j);
+            // two accumulators over even and odd k hide the latency of vwmacc
+            acc0 = __riscv_vle32_v_i32m4(packed_bias + c0 + j, l);
+            acc1 = __riscv_vmv_v_x_i32m4(0, l);
+            w = packed_rhs + c0 * rhs_cols + j;
+            for (k = 0; k + 1 < rhs_cols; k += 2) {
+                acc0 = __riscv_vwmacc_vx_i32m4(acc0, lhs[k], __riscv_vsext_vf2_i16m2(__riscv_vle8_v_i8m1(w, l), l), l);
+                acc1 = __riscv_vwmacc_vx_i32m4(acc1, lhs[k + 1],
+                                               __riscv_vsext_vf2_i16m2(__riscv_vle8_v_i8m1(w + RISCV_NN_PACK_COLS, l), l), l);
+                w += 2 * RISCV_NN_PACK_COLS;
+            }
+            if (k < rhs_cols) {
+                acc0 = __riscv_vwmacc_vx_i32m4(acc0, lhs[k], __riscv_vsext_vf2_i16m2(__riscv_vle8_v_i8m1(w, l), l), l);
+            }
+            acc0 = riscv_nn_requantize_m4_rvv(__riscv_vadd_vv_i32m4(acc0, acc1, l), l, dst_multiplier, dst_shift);
+            out = riscv_nn_narrow_s8_rvv(acc0, dst_offset, activation_min, activation_max, l);
+            if (address_offset == 1) {
+                __riscv_vse8_v_i8m1(dst + c0 + j, out, l);
+            } else {
+                __riscv_vsse8_v_i8m1(dst + (c0 + j) * address_offset, address_offset, out, l);
+            }
+        }
+    }
+    return RISCV_NMSIS_NN_SUCCESS;
+}
+
+/**
+ * @brief Same as riscv_nn_mat_mult_kernel_q7_q15() on pA packed by riscv_nn_pack_rhs_s8_rvv()
+ *        with lhs_offset 0, both im2col columns share each load of packed weights
+ * @param[in]  pA          Packed operand A, ch_im_out rows of numCol_A weights
+ * @param[in]  pInBuffer   Operand B, 2 columns of numCol_A values
+ * @param[in]  ch_im_out   numRow of A
+ * @param[in]  numCol_A    numCol of A
+ * @param[in]  bias_shift  Amount of left-shift for bias
+ * @param[in]  out_shift   Amount of right-shift for output
+ * @param[in]  bias        The bias
+ * @param[out] pOut        Output, 2 pixels of ch_im_out channels
+ * @return     The incremented output pointer
+ */
+__STATIC_INLINE q7_t *riscv_nn_mat_mult_kernel_q7_q15_rvv(const q7_t *pA, const q15_t *pInBuffer,
+                                                         const uint16_t ch_im_out, const uint16_t numCol_A,
+                                                         const uint16_t bias_shift, const uint16_t out_shift,
+                                                         const q7_t *bias, q7_t *pOut)
+{
+    const q15_t *pB2 = pInBuffer + numCol_A;
+    const q7_t *w;
+    int32_t c0, cols, j, k;
+    size_t l;
+    vint32m4_t acc0, acc1;
+    vint16m2_t w16;
+
+    for (c0 = 0; c0 < ch_im_out; c0 += RISCV_NN_PACK_COLS) {
+        cols = MIN(RISCV_NN_PACK_COLS, ch_im_out - c0);
+        for (j = 0; j < cols; j += l) {
+            l = __riscv_vsetvl_e32m4(cols - j);
+            acc0 = __riscv_vsll_vx_i32m4(__riscv_vsext_vf4_i32m4(__riscv_vle8_v_i8m1(bias + c0 + j, l), l),
+                                         bias_shift, l);
+            acc0 = __riscv_vadd_vx_i32m4(acc0, NN_ROUND(out_shift), l);
+            acc1 = acc0;
+            w = pA + c0 * numCol_A + j;
+            for (k = 0; k < numCol_A; k++) {
+                w16 = __riscv_vsext_vf2_i16m2(__riscv_vle8_v_i8m1(w, l), l);
+                acc0 = __riscv_vwmacc_vx_i32m4(acc0, pInBuffer[k], w16, l);
+                acc1 = __riscv_vwmacc_vx_i32m4(acc1, pB2[k], w16, l);
+                w += RISCV_NN_PACK_COLS;
+            }
+            __riscv_vse8_v_i8m1(pOut + c0 + j,
+                                riscv_nn_narrow_s8_rvv(__riscv_vsra_vx_i32m4(acc0, out_shift, l), 0, -128, 127, l), l);
+            __riscv_vse8_v_i8m1(pOut + ch_im_out + c0 + j,
+                                riscv_nn_narrow_s8_rvv(__riscv_vsra_vx_i32m4(acc1, out_shift, l), 0, -128, 127, l), l);
+        }
+    }
+    return pOut + 2 * ch_im_out;
+}
+
+#endif /* defined(RISCV_MATH_VECTOR) */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RISCV_NN_GEMM_RVV_H_ */
@@ -0,0 +1,303 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2010-2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * Copyright (c) 2022 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* ----------------------------------------------------------------------
+ * Project:      NMSIS NN Library
+ * Title:        riscv_nn_packed.h
+ * Description:  Offline packed int8 weights and the kernels running on them
+ *
+ * $Date:        13 November 2023
+ * $Revision:    V.17.6.0
+ *
+ * Target Processor: RISC-V Cores
+ * -------------------------------------------------------------------- */
+
+#ifndef _RISCV_NN_PACKED_H_
+#define _RISCV_NN_PACKED_H_
+
+#include "riscv_nn_gemm_rvv.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Packed weights are made once, by tools/scripts/nnpack.py on the host or by
+ * riscv_nn_pack_s8() at init, and the *_packed kernels read them in place, so const
+ * weights can stay in flash or XIP and no reorder pass runs before a layer.
+ *
+ * A packed weight set is a riscv_nn_packed_t, the weights are rows output channels of
+ * cols int8 values, the bias is rows int32 values, which are the bias of the layer plus
+ * lhs_offset times the sum of the weights of the channel, so the kernels don't add the
+ * input offset, and the weights are only valid for the lhs_offset they are packed with.
+ *
+ * Formats:
+ * - RISCV_NN_PACKED_ROWS, for P-ext and C targets: each channel is a row of cols
+ *   weights, zero padded to a multiple of RISCV_NN_PACKED_ROW_ALIGN bytes, so a row
+ *   starts word aligned and runs 4 weights per SMAQA, block is 1
+ * - RISCV_NN_PACKED_BLOCKS, for RVV targets: blocks of block channels, stored k major,
+ *   one k is block weights of the channels of the block, channels past rows are zero,
+ *   this is the layout of riscv_nn_pack_rhs_s8_rvv(), block is RISCV_NN_PACK_COLS, it
+ *   doesn't depend on VLEN, the kernels pick the lanes by vsetvl
+ *
+ * RISCV_NN_PACKED_NATIVE is the format of the target the library is built for, the
+ * kernels return RISCV_NMSIS_NN_ARG_ERROR for the other one, riscv_nn_packed_check()
+ * also checks the lhs_offset of a layer before it is run.
+ */
+
+/** Magic of riscv_nn_packed_t, "NNPK" */
+#define RISCV_NN_PACKED_MAGIC       0x4b504e4eUL
+
+/** Format of weights, one channel per row */
+#define RISCV_NN_PACKED_ROWS        1
+/** Format of weights, blocks of channels stored k major */
+#define RISCV_NN_PACKED_BLOCKS      2
+
+/** Row alignment of RISCV_NN_PACKED_ROWS in bytes */
+#define RISCV_NN_PACKED_ROW_ALIGN   4
+
+#if defined(RISCV_MATH_VECTOR)
+#define RISCV_NN_PACKED_NATIVE      RISCV_NN_PACKED_BLOCKS
+#else
+#define RISCV_NN_PACKED_NATIVE      RISCV_NN_PACKED_ROWS
+#endif
+
+/** Packed weights of one layer, all members are set by the packing and are read only */
+typedef struct {
+    uint32_t magic;             /**< RISCV_NN_PACKED_MAGIC */
+    uint16_t format;            /**< RISCV_NN_PACKED_ROWS or RISCV_NN_PACKED_BLOCKS */
+    uint16_t block;             /**< Channels of one block, 1 for RISCV_NN_PACKED_ROWS */
+    int32_t rows;               /**< Output channels */
+    int32_t cols;               /**< Weights of one output channel */
+    int32_t lhs_offset;         /**< Input offset folded in bias */
+    const int32_t *bias;        /**< rows values of bias + lhs_offset * sum of weights */
+    const int8_t *weights;      /**< Weights in format */
+} riscv_nn_packed_t;
+
+/* bytes of one row of RISCV_NN_PACKED_ROWS weights */
+__STATIC_FORCEINLINE int32_t riscv_nn_packed_row_size(const int32_t cols)
+{
+    return (cols + RISCV_NN_PACKED_ROW_ALIGN - 1) & ~(RISCV_NN_PACKED_ROW_ALIGN - 1);
+}
+
+/**
+ * @brief Bytes of weights for riscv_nn_pack_s8()
+ * @param[in]  format  RISCV_NN_PACKED_ROWS or RISCV_NN_PACKED_BLOCKS
+ * @param[in]  rows    Number of output channels
+ * @param[in]  cols    Number of weights of one output channel
+ * @return     Size of packed weights, 0 for an unknown format
+ */
+__STATIC_INLINE int32_t riscv_nn_pack_s8_get_buffer_size(const int32_t format, const int32_t rows,
+                                                         const int32_t cols)
+{
+    if (format == RISCV_NN_PACKED_ROWS) {
+        return rows * riscv_nn_packed_row_size(cols);
+    }
+    if (format == RISCV_NN_PACKED_BLOCKS) {
+        return riscv_nn_pack_rhs_s8_rvv_get_buffer_size(rows, cols);
+    }
+    return 0;
+}
+
+/**
+ * @brief Pack weights at run time, same bytes as tools/scripts/nnpack.py gives
+ * @param[in]  rhs         Weights, rows rows of cols values
+ * @param[in]  bias        Bias of rows channels, can be NULL
+ * @param[in]  rows        Number of output channels
+ * @param[in]  cols        Number of weights of one output channel
+ * @param[in]  lhs_offset  Input offset of the layer
+ * @param[in]  format      RISCV_NN_PACKED_ROWS or RISCV_NN_PACKED_BLOCKS
+ * @param[out] weights     Packed weights of riscv_nn_pack_s8_get_buffer_size() bytes, word aligned
+ * @param[out] packed_bias Packed bias of rows values
+ * @param[out] packed      Packed weight set, pointing to weights and packed_bias
+ * @return     <code>RISCV_NMSIS_NN_SUCCESS</code>, or <code>RISCV_NMSIS_NN_ARG_ERROR</code>
+ *             for an unknown format
+ */
+__STATIC_INLINE riscv_nmsis_nn_status riscv_nn_pack_s8(const int8_t *rhs, const int32_t *bias, const int32_t rows,
+                                                       const int32_t cols, const int32_t lhs_offset,
+                                                       const int32_t format, int8_t *weights, int32_t *packed_bias,
+                                                       riscv_nn_packed_t *packed)
+{
+    int32_t row_size = riscv_nn_packed_row_size(cols);
+    int32_t c, k;
+
+    if (format == RISCV_NN_PACKED_BLOCKS) {
+        riscv_nn_pack_rhs_s8_rvv(rhs, bias, rows, cols, lhs_offset, weights, packed_bias);
+        packed->block = RISCV_NN_PACK_COLS;
+    } else if (format == RISCV_NN_PACKED_ROWS) {
+        for (c = 0; c < rows; c++) {
+            for (k = 0; k < row_size; k++) {
+                weights[c * row_size + k] = (k < cols) ? rhs[c * cols + k] : 0;
+            }
+            packed_bias[c] = (bias != NULL) ? bias[c] : 0;
+            for (k = 0; k < cols; k++) {
+                packed_bias[c] += lhs_offset * rhs[c * cols + k];
+            }
+        }
+        packed->block = 1;
+    } else {
+        return RISCV_NMSIS_NN_ARG_ERROR;
+    }
+    packed->magic = RISCV_NN_PACKED_MAGIC;
+    packed->format = (uint16_t)format;
+    packed->rows = rows;
+    packed->cols = cols;
+    packed->lhs_offset = lhs_offset;
+    packed->bias = packed_bias;
+    packed->weights = weights;
+    return RISCV_NMSIS_NN_SUCCESS;
+}
+
+/**
+ * @brief Check packed weights can be run by this target for a layer of input offset lhs_offset
+ * @return     <code>RISCV_NMSIS_NN_SUCCESS</code>, or <code>RISCV_NMSIS_NN_ARG_ERROR</code> if
+ *             the magic, format, block or lhs_offset doesn't match
+ */
+__STATIC_INLINE riscv_nmsis_nn_status riscv_nn_packed_check(const riscv_nn_packed_t *packed, const int32_t lhs_offset)
+{
+    if ((packed == NULL) || (packed->magic != RISCV_NN_PACKED_MAGIC) ||
+        (packed->format != RISCV_NN_PACKED_NATIVE) || (packed->lhs_offset != lhs_offset)) {
+        return RISCV_NMSIS_NN_ARG_ERROR;
+    }
+    if (packed->block != ((RISCV_NN_PACKED_NATIVE == RISCV_NN_PACKED_BLOCKS) ? RISCV_NN_PACK_COLS : 1)) {
+        return RISCV_NMSIS_NN_ARG_ERROR;
+    }
+    return RISCV_NMSIS_NN_SUCCESS;
+}
+
+#if !defined(RISCV_MATH_VECTOR)
+/* sum of lhs times one row of RISCV_NN_PACKED_ROWS weights, w is word aligned */
+__STATIC_FORCEINLINE int32_t riscv_nn_packed_dot_s8(const int8_t *lhs, const int8_t *w, const int32_t cols, int32_t acc)
+{
+    int32_t k = 0;
+
+#if defined(RISCV_MATH_DSP)
+    for (; k + 4 <= cols; k += 4) {
+        acc = (int32_t)__RV_SMAQA(acc, (unsigned long)(uint32_t)riscv_nn_read_s8x4(lhs + k),
+                                  (unsigned long)*(const uint32_t *)(w + k));
+    }
+#endif
+    for (; k < cols; k++) {
+        acc += lhs[k] * w[k];
+    }
+    return acc;
+}
+#endif
+
+/**
+ * @brief Same as riscv_nn_vec_mat_mult_t_s8() on packed weights, the lhs_offset and
+ *        kernel sums are in the packed bias
+ * @param[in]  lhs             Lhs vector of packed->cols values
+ * @param[in]  packed          Packed weights in RISCV_NN_PACKED_NATIVE format
+ * @param[out] dst             Output of packed->rows values
+ * @param[in]  dst_offset      Offset added to the output
+ * @param[in]  dst_multiplier  Output multiplier
+ * @param[in]  dst_shift       Output shift
+ * @param[in]  activation_min  Min of output
+ * @param[in]  activation_max  Max of output
+ * @param[in]  address_offset  Memory position offset between outputs
+ * @return     <code>RISCV_NMSIS_NN_SUCCESS</code>, or <code>RISCV_NMSIS_NN_ARG_ERROR</code>
+ *             for weights of another format
+ */
+__STATIC_INLINE riscv_nmsis_nn_status riscv_nn_vec_mat_mult_t_s8_packed(const int8_t *lhs,
+                                                                        const riscv_nn_packed_t *packed, int8_t *dst,
+                                                                        const int32_t dst_offset,
+                                                                        const int32_t dst_multiplier,
+                                                                        const int32_t dst_shift,
+                                                                        const int32_t activation_min,
+                                                                        const int32_t activation_max,
+                                                                        const int32_t address_offset)
+{
+    if (packed->format != RISCV_NN_PACKED_NATIVE) {
+        return RISCV_NMSIS_NN_ARG_ERROR;
+    }
+#if defined(RISCV_MATH_VECTOR)
+    return riscv_nn_vec_mat_mult_t_s8_rvv(lhs, packed->weights, packed->bias, dst, dst_offset, dst_multiplier,
+                                          dst_shift, packed->cols, packed->rows, activation_min, activation_max,
+                                          address_offset);
+#else
+    const int32_t row_size = riscv_nn_packed_row_size(packed->cols);
+    int32_t c, acc;
+
+    for (c = 0; c < packed->rows; c++) {
+        acc = riscv_nn_packed_dot_s8(lhs, packed->weights + c * row_size, packed->cols, packed->bias[c]);
+        acc = riscv_nn_requantize(acc, dst_multiplier, dst_shift) + dst_offset;
+        acc = MAX(acc, activation_min);
+        dst[c * address_offset] = (int8_t)MIN(acc, activation_max);
+    }
+    return RISCV_NMSIS_NN_SUCCESS;
+#endif
+}
+
+/**
+ * @brief Same as riscv_nn_mat_mult_nt_t_s8() on packed weights, the lhs_offset and
+ *        kernel sums are in the packed bias
+ * @param[in]  lhs              Lhs matrix, lhs_rows rows of packed->cols values
+ * @param[in]  packed           Packed weights in RISCV_NN_PACKED_NATIVE format
+ * @param[out] dst              Output, lhs_rows rows of packed->rows values
+ * @param[in]  dst_multipliers  Per channel multipliers
+ * @param[in]  dst_shifts       Per channel shifts
+ * @param[in]  lhs_rows         Number of lhs rows
+ * @param[in]  dst_offset       Offset added to the output
+ * @param[in]  activation_min   Min of output
+ * @param[in]  activation_max   Max of output
+ * @param[in]  lhs_cols_offset  Column offset between subsequent lhs rows
+ * @return     <code>RISCV_NMSIS_NN_SUCCESS</code>, or <code>RISCV_NMSIS_NN_ARG_ERROR</code>
+ *             for weights of another format
+ */
+__STATIC_INLINE riscv_nmsis_nn_status riscv_nn_mat_mult_nt_t_s8_packed(const int8_t *lhs,
+                                                                       const riscv_nn_packed_t *packed, int8_t *dst,
+                                                                       const int32_t *dst_multipliers,
+                                                                       const int32_t *dst_shifts,
+                                                                       const int32_t lhs_rows,
+                                                                       const int32_t dst_offset,
+                                                                       const int32_t activation_min,
+                                                                       const int32_t activation_max,
+                                                                       const int32_t lhs_cols_offset)
+{
+    if (packed->format != RISCV_NN_PACKED_NATIVE) {
+        return RISCV_NMSIS_NN_ARG_ERROR;
+    }
+#if defined(RISCV_MATH_VECTOR)
+    return riscv_nn_mat_mult_nt_t_s8_rvv(lhs, packed->weights, packed->bias, dst, dst_multipliers, dst_shifts,
+                                         lhs_rows, packed->rows, packed->cols, dst_offset, activation_min,
+                                         activation_max, lhs_cols_offset);
+#else
+    const int32_t row_size = riscv_nn_packed_row_size(packed->cols);
+    const int32_t lhs_step = packed->cols + lhs_cols_offset;
+    int32_t r, c, acc;
+
+    for (r = 0; r < lhs_rows; r++) {
+        for (c = 0; c < packed->rows; c++) {
+            acc = riscv_nn_packed_dot_s8(lhs + r * lhs_step, packed->weights + c * row_size, packed->cols,
+                                         packed->bias[c]);
+            acc = riscv_nn_requantize(acc, dst_multipliers[c], dst_shifts[c]) + dst_offset;
+            acc = MAX(acc, activation_min);
+            dst[r * packed->rows + c] = (int8_t)MIN(acc, activation_max);
+        }
+    }
+    return RISCV_NMSIS_NN_SUCCESS;
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RISCV_NN_PACKED_H_ */
@@ -0,0 +1,227 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2010-2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * Copyright (c) 2022 Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* ----------------------------------------------------------------------
+ * Project:      NMSIS NN Library
+ * Title:        riscv_nn_s4_opt.h
+ * Description:  int4 weight kernels with the nibble unpack in the MAC loop
+ *
+ * $Date:        13 November 2023
+ * $Revision:    V.17.6.0
+ *
+ * Target Processor: RISC-V Cores
+ * -------------------------------------------------------------------- */
+
+#ifndef _RISCV_NN_S4_OPT_H_
+#define _RISCV_NN_S4_OPT_H_
+
+#include "riscv_nnfunctions.h"
+#include "riscv_nnsupportfunctions.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The rhs of the kernels of this file is the packed int4 of riscv_fully_connected_s4(),
+ * weight i of the matrix is the low nibble of byte i / 2 when i is even and the high one
+ * when i is odd, rows follow each other without padding, so a row starts in the middle
+ * of a byte when rhs_cols is odd. The weights are unpacked in registers as they are
+ * multiplied, they are never stored as int8, so the kernels read half the bytes of the
+ * s8 ones, which is what decides the speed of layers running from XIP flash.
+ *
+ * - RVV: one vector load of bytes gives the even and odd weights of vl pairs by vsll and
+ *   vsra, the matching lhs values are strided loads, lhs + lhs_offset times a weight fits
+ *   int16, so the MACs are on e16 and only the reduction widens to int32
+ * - P-ext: two bytes are spread to the four bytes of a word and sign extended by SRA8,
+ *   one SMAQA does the 4 MACs, a second one of the same word sums the weights for the
+ *   lhs_offset, which doesn't fit int8
+ *
+ * Outputs are bit exact to riscv_nn_vec_mat_mult_t_s4() and riscv_nn_mat_mult_nt_t_s4().
+ */
+
+/* weight i of s4 packed rhs */
+__STATIC_FORCEINLINE int32_t riscv_nn_s4_at(const int8_t *rhs, const int32_t i)
+{
+    int8_t b = rhs[i >> 1];
+
+    return (i & 1) ? (b >> 4) : ((int8_t)(b << 4) >> 4);
+}
+
+/**
+ * @brief Sum of (lhs + lhs_offset) times cols s4 weights of rhs from weight first on
+ * @param[in]  lhs         Lhs values
+ * @param[in]  rhs         s4 packed rhs
+ * @param[in]  first       Index of the first weight in rhs, which can be odd
+ * @param[in]  cols        Number of values
+ * @param[in]  lhs_offset  Offset added to the lhs values
+ * @return     The sum
+ */
+__STATIC_FORCEINLINE int32_t riscv_nn_dot_s4(const int8_t *lhs, const int8_t *rhs, int32_t first, int32_t cols,
+                                             const int32_t lhs_offset)
+{
+    int32_t sum = 0;
+
+    if ((first & 1) && (cols > 0)) {
+        sum += (*lhs++ + lhs_offset) * riscv_nn_s4_at(rhs, first++);
+        cols--;
+    }
+    rhs += first >> 1;
+#if defined(RISCV_MATH_VECTOR)
+    int32_t pairs = cols >> 1;
+    size_t l;
+    vint32m1_t acc = __riscv_vmv_v_x_i32m1(0, 1);
+    vint8m1_t w;
+    vint16m2_t a, p;
+
+    for (; pairs > 0; pairs -= l) {
+        l = __riscv_vsetvl_e8m1(pairs);
+        w = __riscv_vle8_v_i8m1(rhs, l);
+        // |lhs + lhs_offset| <= 255 and |weight| <= 8, the sum of two products fits int16
+        a = __riscv_vadd_vx_i16m2(__riscv_vsext_vf2_i16m2(__riscv_vlse8_v_i8m1(lhs, 2, l), l), lhs_offset, l);
+        p = __riscv_vmul_vv_i16m2(a, __riscv_vsext_vf2_i16m2(__riscv_vsra_vx_i8m1(__riscv_vsll_vx_i8m1(w, 4, l), 4, l), l), l);
+        a = __riscv_vadd_vx_i16m2(__riscv_vsext_vf2_i16m2(__riscv_vlse8_v_i8m1(lhs + 1, 2, l), l), lhs_offset, l);
+        p = __riscv_vmacc_vv_i16m2(p, a, __riscv_vsext_vf2_i16m2(__riscv_vsra_vx_i8m1(w, 4, l), l), l);
+        acc = __riscv_vwredsum_vs_i16m2_i32m1(p, acc, l);
+        rhs += l;
+        lhs += 2 * l;
+    }
+    sum += __riscv_vmv_x_s_i32m1_i32(acc);
+    cols &= 1;
+#elif defined(RISCV_MATH_DSP)
+    int32_t wsum = 0;
+    uint32_t v, w;
+
+    for (; cols >= 4; cols -= 4) {
+        // bytes b0, b1 to the nibbles lo0, hi0, lo1, hi1 at the top of the 4 bytes
+        v = (uint8_t)rhs[0] | ((uint32_t)(uint8_t)rhs[1] << 16);
+        w = (uint32_t)__RV_SRA8(((v << 4) & 0x00F000F0UL) | ((v << 8) & 0xF000F000UL), 4);
+        sum = (int32_t)__RV_SMAQA(sum, (unsigned long)(uint32_t)riscv_nn_read_s8x4(lhs), (unsigned long)w);
+        wsum = (int32_t)__RV_SMAQA(wsum, (unsigned long)w, 0x01010101UL);
+        rhs += 2;
+        lhs += 4;
+    }
+    sum += lhs_offset * wsum;
+#endif
+    for (int32_t k = 0; k < cols; k++) {
+        sum += (lhs[k] + lhs_offset) * riscv_nn_s4_at(rhs, k);
+    }
+    return sum;
+}
+
+/**
+ * @brief Same as riscv_nn_vec_mat_mult_t_s4(), see it for the arguments
+ * @return     <code>RISCV_NMSIS_NN_SUCCESS</code>
+ */
+__STATIC_INLINE riscv_nmsis_nn_status riscv_nn_vec_mat_mult_t_s4_opt(const int8_t *lhs, const int8_t *packed_rhs,
+                                                                     const int32_t *bias, int8_t *dst,
+                                                                     const int32_t lhs_offset,
+                                                                     const int32_t dst_offset,
+                                                                     const int32_t dst_multiplier,
+                                                                     const int32_t dst_shift, const int32_t rhs_cols,
+                                                                     const int32_t rhs_rows,
+                                                                     const int32_t activation_min,
+                                                                     const int32_t activation_max,
+                                                                     const int32_t address_offset)
+{
+    int32_t c, acc;
+
+    for (c = 0; c < rhs_rows; c++) {
+        acc = riscv_nn_dot_s4(lhs, packed_rhs, c * rhs_cols, rhs_cols, lhs_offset);
+        if (bias != NULL) {
+            acc += bias[c];
+        }
+        acc = riscv_nn_requantize(acc, dst_multiplier, dst_shift) + dst_offset;
+        acc = MAX(acc, activation_min);
+        dst[c * address_offset] = (int8_t)MIN(acc, activation_max);
+    }
+    return RISCV_NMSIS_NN_SUCCESS;
+}
+
+/**
+ * @brief Same as riscv_nn_mat_mult_nt_t_s4(), see it for the arguments, the weights of
+ *        a rhs row are used by all the lhs rows while they are in cache
+ * @return     <code>RISCV_NMSIS_NN_SUCCESS</code>
+ */
+__STATIC_INLINE riscv_nmsis_nn_status riscv_nn_mat_mult_nt_t_s4_opt(const int8_t *lhs, const int8_t *rhs,
+                                                                    const int32_t *bias, int8_t *dst,
+                                                                    const int32_t *dst_multipliers,
+                                                                    const int32_t *dst_shifts, const int32_t lhs_rows,
+                                                                    const int32_t rhs_rows, const int32_t rhs_cols,
+                                                                    const int32_t lhs_offset,
+                                                                    const int32_t dst_offset,
+                                                                    const int32_t activation_min,
+                                                                    const int32_t activation_max,
+                                                                    const int32_t lhs_cols_offset)
+{
+    const int32_t lhs_step = rhs_cols + lhs_cols_offset;
+    int32_t r, c, acc;
+
+    for (c = 0; c < rhs_rows; c++) {
+        for (r = 0; r < lhs_rows; r++) {
+            acc = riscv_nn_dot_s4(lhs + r * lhs_step, rhs, c * rhs_cols, rhs_cols, lhs_offset);
+            if (bias != NULL) {
+                acc += bias[c];
+            }
+            acc = riscv_nn_requantize(acc, dst_multipliers[c], dst_shifts[c]) + dst_offset;
+            acc = MAX(acc, activation_min);
+            dst[r * rhs_rows + c] = (int8_t)MIN(acc, activation_max);
+        }
+    }
+    return RISCV_NMSIS_NN_SUCCESS;
+}
+
+/**
+ * @brief Same as riscv_fully_connected_s4() on riscv_nn_vec_mat_mult_t_s4_opt(), see it
+ *        for the arguments, ctx is not used
+ * @return     <code>RISCV_NMSIS_NN_SUCCESS</code>
+ */
+__STATIC_INLINE riscv_nmsis_nn_status riscv_fully_connected_s4_opt(const nmsis_nn_context *ctx,
+                                                                   const nmsis_nn_fc_params *fc_params,
+                                                                   const nmsis_nn_per_tensor_quant_params *quant_params,
+                                                                   const nmsis_nn_dims *input_dims,
+                                                                   const int8_t *input_data,
+                                                                   const nmsis_nn_dims *filter_dims,
+                                                                   const int8_t *filter_data,
+                                                                   const nmsis_nn_dims *bias_dims,
+                                                                   const int32_t *bias_data,
+                                                                   const nmsis_nn_dims *output_dims,
+                                                                   int8_t *output_data)
+{
+    const int32_t accum_depth = filter_dims->n;
+    const int32_t out_ch = output_dims->c;
+    int32_t batch;
+
+    (void)ctx;
+    (void)bias_dims;
+    for (batch = 0; batch < input_dims->n; batch++) {
+        riscv_nn_vec_mat_mult_t_s4_opt(input_data, filter_data, bias_data, output_data, fc_params->input_offset,
+                                       fc_params->output_offset, quant_params->multiplier, quant_params->shift,
+                                       accum_depth, out_ch, fc_params->activation.min, fc_params->activation.max, 1);
+        input_data += accum_depth;
+        output_data += out_ch;
+    }
+    return RISCV_NMSIS_NN_SUCCESS;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RISCV_NN_S4_OPT_H_ */
@@ -63,8 +63,56 @@
         #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
             uint8_t ucStaticallyAllocated; /**< Set to pdTRUE if the event group is statically allocated to ensure no attempt is made to free the memory. */
         #endif
+
+        #if ( configEVENT_GROUP_ISR_MAX_WAKE > 0 )
+            UBaseType_t uxTaskAccess;     /**< Not zero while a task accesses the event bits and the waiting tasks with the scheduler suspended, xEventGroupSync() nests the access of xEventGroupSetBits(). */
+            UBaseType_t uxPendedFromISR;  /**< The number of set and clear commands pended from interrupts that the timer task has not executed yet. */
+        #endif
     } EventGroup_t;
 
+/* When configEVENT_GROUP_ISR_MAX_WAKE is not 0 xEventGroupSetBitsFromISR() and
+ * xEventGroupClearBitsFromISR() may access the event bits and the waiting tasks
+ * directly.  The task level accesses are still only protected by suspending the
+ * scheduler, so they mark the event group while they run and an interrupt that
+ * finds the mark pends its command to the timer task as before.  The mark is
+ * changed in a critical section, which takes the ISR lock in SMP.  Once a
+ * command is pended, the later ones from interrupts are pended too until the
+ * timer task has executed it, so the commands execute in the order they were
+ * made. */
+    #if ( configEVENT_GROUP_ISR_MAX_WAKE > 0 )
+        #define eventBEGIN_TASK_ACCESS( pxEventBits ) \
+    taskENTER_CRITICAL();                             \
+    {                                                 \
+        ( ( pxEventBits )->uxTaskAccess )++;          \
+    }                                                 \
+    taskEXIT_CRITICAL()
+
+        #define eventEND_TASK_ACCESS( pxEventBits ) \
+    taskENTER_CRITICAL();                           \
+    {                                               \
+        ( ( pxEventBits )->uxTaskAccess )--;        \
+    }                                               \
+    taskEXIT_CRITICAL()
+
+/* Can be used from a critical section in an interrupt to decide whether the
+ * event group can be accessed directly, rather than pending the command. */
+        #define eventCAN_ACCESS_FROM_ISR( pxEventBits ) \
+    ( ( ( pxEventBits )->uxTaskAccess == ( UBaseType_t ) 0 ) && ( ( pxEventBits )->uxPendedFromISR == ( UBaseType_t ) 0 ) )
+
+/* Called by the timer task once it has executed a pended command. */
+        #define eventPENDED_FROM_ISR_DONE( pxEventBits )                   \
+    taskENTER_CRITICAL();                                                   \
+    {                                                                       \
+        configASSERT( ( pxEventBits )->uxPendedFromISR > ( UBaseType_t ) 0 ); \
+        ( pxEventBits )->uxPendedFromISR--;                                 \
+    }                                                                       \
+    taskEXIT_CRITICAL()
+    #else
+        #define eventBEGIN_TASK_ACCESS( pxEventBits )
+        #define eventEND_TASK_ACCESS( pxEventBits )
+        #define eventPENDED_FROM_ISR_DONE( pxEventBits )
+    #endif
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -79,6 +127,30 @@
                                             const EventBits_t uxBitsToWaitFor,
                                             const BaseType_t xWaitForAllBits ) PRIVILEGED_FUNCTION;
 
+/*
+ * Set uxBitsToSet in the event group and unblock the tasks whose wait condition
+ * is then met.  It is called with the scheduler suspended, or from a critical
+ * section in xEventGroupSetBitsFromISR() if xFromISR is pdTRUE, in which case
+ * pdTRUE is returned if an unblocked task has a higher priority than the task
+ * that was interrupted.
+ */
+    static BaseType_t prvSetBitsAndUnblock( EventGroup_t * pxEventBits,
+                                            const EventBits_t uxBitsToSet,
+                                            const BaseType_t xFromISR ) PRIVILEGED_FUNCTION;
+
+/*
+ * Pend xFunctionToPend to the timer task for a command from an interrupt that
+ * could not access the event group directly.  The caller has already counted
+ * the command in uxPendedFromISR, the count is taken back if the timer command
+ * queue is full.
+ */
+    #if ( ( configEVENT_GROUP_ISR_MAX_WAKE > 0 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+        static BaseType_t prvPendFromISR( EventGroup_t * pxEventBits,
+                                          PendedFunction_t xFunctionToPend,
+                                          const EventBits_t uxBits,
+                                          BaseType_t * pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+    #endif
+
 /*-----------------------------------------------------------*/
 
     #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
@@ -122,6 +194,13 @@
                 }
                 #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
 
+                #if ( configEVENT_GROUP_ISR_MAX_WAKE > 0 )
+                {
+                    pxEventBits->uxTaskAccess = 0;
+                    pxEventBits->uxPendedFromISR = 0;
+                }
+                #endif
+
                 traceEVENT_GROUP_CREATE( pxEventBits );
             }
             else
@@ -167,6 +246,13 @@
                 }
                 #endif /* configSUPPORT_STATIC_ALLOCATION */
 
+                #if ( configEVENT_GROUP_ISR_MAX_WAKE > 0 )
+                {
+                    pxEventBits->uxTaskAccess = 0;
+                    pxEventBits->uxPendedFromISR = 0;
+                }
+                #endif
+
                 traceEVENT_GROUP_CREATE( pxEventBits );
             }
             else
@@ -203,6 +289,7 @@
         #endif
 
         vTaskSuspendAll();
+        eventBEGIN_TASK_ACCESS( pxEventBits );
         {
             uxOriginalBitValue = pxEventBits->uxEventBits;
 
@@ -245,6 +332,7 @@
                 }
             }
         }
+        eventEND_TASK_ACCESS( pxEventBits );
         xAlreadyYielded = xTaskResumeAll();
 
         if( xTicksToWait != ( TickType_t ) 0 )
@@ -334,6 +422,7 @@
         #endif
 
         vTaskSuspendAll();
+        eventBEGIN_TASK_ACCESS( pxEventBits );
         {
             const EventBits_t uxCurrentEventBits = pxEventBits->uxEventBits;
 
@@ -401,6 +490,7 @@
                 traceEVENT_GROUP_WAIT_BITS_BLOCK( xEventGroup, uxBitsToWaitFor );
             }
         }
+        eventEND_TASK_ACCESS( pxEventBits );
         xAlreadyYielded = xTaskResumeAll();
 
         if( xTicksToWait != ( TickType_t ) 0 )
@@ -501,24 +591,68 @@
     }
 /*-----------------------------------------------------------*/
 
-    #if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+    #if ( ( ( configUSE_TRACE_FACILITY == 1 ) || ( configEVENT_GROUP_ISR_MAX_WAKE > 0 ) ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
 
         BaseType_t xEventGroupClearBitsFromISR( EventGroupHandle_t xEventGroup,
                                                 const EventBits_t uxBitsToClear )
         {
             BaseType_t xReturn;
 
+            #if ( configEVENT_GROUP_ISR_MAX_WAKE > 0 )
+                EventGroup_t * pxEventBits = xEventGroup;
+                UBaseType_t uxSavedInterruptStatus;
+                BaseType_t xClearedInISR;
+            #endif
+
             traceENTER_xEventGroupClearBitsFromISR( xEventGroup, uxBitsToClear );
 
             traceEVENT_GROUP_CLEAR_BITS_FROM_ISR( xEventGroup, uxBitsToClear );
-            xReturn = xTimerPendFunctionCallFromISR( vEventGroupClearBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToClear, NULL );
+
+            #if ( configEVENT_GROUP_ISR_MAX_WAKE > 0 )
+            {
+                configASSERT( xEventGroup );
+                configASSERT( ( uxBitsToClear & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
+                portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+                /* Clearing bits does not unblock any task, so it is done here
+                 * whenever xEventGroupSetBitsFromISR() could set the bits here,
+                 * which keeps the sets and clears from interrupts in order. */
+                uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+                {
+                    if( eventCAN_ACCESS_FROM_ISR( pxEventBits ) )
+                    {
+                        xClearedInISR = pdTRUE;
+                        pxEventBits->uxEventBits &= ~uxBitsToClear;
+                    }
+                    else
+                    {
+                        xClearedInISR = pdFALSE;
+                        ( pxEventBits->uxPendedFromISR )++;
+                    }
+                }
+                taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+                if( xClearedInISR != pdFALSE )
+                {
+                    xReturn = pdPASS;
+                }
+                else
+                {
+                    xReturn = prvPendFromISR( pxEventBits, vEventGroupClearBitsCallback, uxBitsToClear, NULL );
+                }
+            }
+            #else /* if ( configEVENT_GROUP_ISR_MAX_WAKE > 0 ) */
+            {
+                xReturn = xTimerPendFunctionCallFromISR( vEventGroupClearBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToClear, NULL );
+            }
+            #endif /* if ( configEVENT_GROUP_ISR_MAX_WAKE > 0 ) */
 
             traceRETURN_xEventGroupClearBitsFromISR( xReturn );
 
             return xReturn;
         }
 
-    #endif /* if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) ) */
+    #endif /* if ( ( ( configUSE_TRACE_FACILITY == 1 ) || ( configEVENT_GROUP_ISR_MAX_WAKE > 0 ) ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) ) */
 /*-----------------------------------------------------------*/
 
     EventBits_t xEventGroupGetBitsFromISR( EventGroupHandle_t xEventGroup )
@@ -547,13 +681,7 @@
     EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup,
                                     const EventBits_t uxBitsToSet )
     {
-        ListItem_t * pxListItem;
-        ListItem_t * pxNext;
-        ListItem_t const * pxListEnd;
-        List_t const * pxList;
-        EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits;
         EventGroup_t * pxEventBits = xEventGroup;
-        BaseType_t xMatchFound = pdFALSE;
 
         traceENTER_xEventGroupSetBits( xEventGroup, uxBitsToSet );
 
@@ -562,85 +690,124 @@
         configASSERT( xEventGroup );
         configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
 
-        pxList = &( pxEventBits->xTasksWaitingForBits );
-        pxListEnd = listGET_END_MARKER( pxList );
         vTaskSuspendAll();
+        eventBEGIN_TASK_ACCESS( pxEventBits );
         {
             traceEVENT_GROUP_SET_BITS( xEventGroup, uxBitsToSet );
 
-            pxListItem = listGET_HEAD_ENTRY( pxList );
+            ( void ) prvSetBitsAndUnblock( pxEventBits, uxBitsToSet, pdFALSE );
+        }
+        eventEND_TASK_ACCESS( pxEventBits );
+        ( void ) xTaskResumeAll();
 
-            /* Set the bits. */
-            pxEventBits->uxEventBits |= uxBitsToSet;
+        traceRETURN_xEventGroupSetBits( pxEventBits->uxEventBits );
 
-            /* See if the new bit value should unblock any tasks. */
-            while( pxListItem != pxListEnd )
-            {
-                pxNext = listGET_NEXT( pxListItem );
-                uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxListItem );
-                xMatchFound = pdFALSE;
+        return pxEventBits->uxEventBits;
+    }
+/*-----------------------------------------------------------*/
 
-                /* Split the bits waited for from the control bits. */
-                uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
-                uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
+    static BaseType_t prvSetBitsAndUnblock( EventGroup_t * pxEventBits,
+                                            const EventBits_t uxBitsToSet,
+                                            const BaseType_t xFromISR )
+    {
+        ListItem_t * pxListItem;
+        ListItem_t * pxNext;
+        ListItem_t const * pxListEnd;
+        List_t const * pxList;
+        EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits;
+        BaseType_t xMatchFound = pdFALSE;
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
-                if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
-                {
-                    /* Just looking for single bit being set. */
-                    if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) != ( EventBits_t ) 0 )
-                    {
-                        xMatchFound = pdTRUE;
-                    }
-                    else
-                    {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
-                }
-                else if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) == uxBitsWaitedFor )
+        pxList = &( pxEventBits->xTasksWaitingForBits );
+        pxListEnd = listGET_END_MARKER( pxList );
+        pxListItem = listGET_HEAD_ENTRY( pxList );
+
+        /* Set the bits. */
+        pxEventBits->uxEventBits |= uxBitsToSet;
+
+        /* See if the new bit value should unblock any tasks. */
+        while( pxListItem != pxListEnd )
+        {
+            pxNext = listGET_NEXT( pxListItem );
+            uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxListItem );
+            xMatchFound = pdFALSE;
+
+            /* Split the bits waited for from the control bits. */
+            uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
+            uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
+
+            if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
+            {
+                /* Just looking for single bit being set. */
+                if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) != ( EventBits_t ) 0 )
                 {
-                    /* All bits are set. */
                     xMatchFound = pdTRUE;
                 }
                 else
                 {
-                    /* Need all bits to be set, but not all the bits were set. */
+                    mtCOVERAGE_TEST_MARKER();
                 }
+            }
+            else if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) == uxBitsWaitedFor )
+            {
+                /* All bits are set. */
+                xMatchFound = pdTRUE;
+            }
+            else
+            {
+                /* Need all bits to be set, but not all the bits were set. */
+            }
 
-                if( xMatchFound != pdFALSE )
+            if( xMatchFound != pdFALSE )
+            {
+                /* The bits match.  Should the bits be cleared on exit? */
+                if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
                 {
-                    /* The bits match.  Should the bits be cleared on exit? */
-                    if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
+                    uxBitsToClear |= uxBitsWaitedFor;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* Store the actual event flag value in the task's event list
+                 * item before removing the task from the event list.  The
+                 * eventUNBLOCKED_DUE_TO_BIT_SET bit is set so the task knows
+                 * that is was unblocked due to its required bits matching, rather
+                 * than because it timed out. */
+                #if ( configEVENT_GROUP_ISR_MAX_WAKE > 0 )
+                    if( xFromISR != pdFALSE )
                     {
-                        uxBitsToClear |= uxBitsWaitedFor;
+                        if( xTaskRemoveFromUnorderedEventListFromISR( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET ) != pdFALSE )
+                        {
+                            xHigherPriorityTaskWoken = pdTRUE;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
                     }
                     else
-                    {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
-
-                    /* Store the actual event flag value in the task's event list
-                     * item before removing the task from the event list.  The
-                     * eventUNBLOCKED_DUE_TO_BIT_SET bit is set so the task knows
-                     * that is was unblocked due to its required bits matching, rather
-                     * than because it timed out. */
+                #endif
+                {
                     vTaskRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
                 }
-
-                /* Move onto the next list item.  Note pxListItem->pxNext is not
-                 * used here as the list item may have been removed from the event list
-                 * and inserted into the ready/pending reading list. */
-                pxListItem = pxNext;
             }
 
-            /* Clear any bits that matched when the eventCLEAR_EVENTS_ON_EXIT_BIT
-             * bit was set in the control word. */
-            pxEventBits->uxEventBits &= ~uxBitsToClear;
+            /* Move onto the next list item.  Note pxListItem->pxNext is not
+             * used here as the list item may have been removed from the event list
+             * and inserted into the ready/pending reading list. */
+            pxListItem = pxNext;
         }
-        ( void ) xTaskResumeAll();
 
-        traceRETURN_xEventGroupSetBits( pxEventBits->uxEventBits );
+        /* Clear any bits that matched when the eventCLEAR_EVENTS_ON_EXIT_BIT
+         * bit was set in the control word. */
+        pxEventBits->uxEventBits &= ~uxBitsToClear;
 
-        return pxEventBits->uxEventBits;
+        /* Only used by the ISR version. */
+        ( void ) xFromISR;
+
+        return xHigherPriorityTaskWoken;
     }
 /*-----------------------------------------------------------*/
 
@@ -656,6 +823,7 @@
         pxTasksWaitingForBits = &( pxEventBits->xTasksWaitingForBits );
 
         vTaskSuspendAll();
+        eventBEGIN_TASK_ACCESS( pxEventBits );
         {
             traceEVENT_GROUP_DELETE( xEventGroup );
 
@@ -667,6 +835,7 @@
                 vTaskRemoveFromUnorderedEventList( pxTasksWaitingForBits->xListEnd.pxNext, eventUNBLOCKED_DUE_TO_BIT_SET );
             }
         }
+        eventEND_TASK_ACCESS( pxEventBits );
         ( void ) xTaskResumeAll();
 
         #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
@@ -752,6 +921,11 @@
         /* coverity[misra_c_2012_rule_11_5_violation] */
         ( void ) xEventGroupSetBits( pvEventGroup, ( EventBits_t ) ulBitsToSet );
 
+        /* MISRA Ref 11.5.4 [Callback function parameter] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+        /* coverity[misra_c_2012_rule_11_5_violation] */
+        eventPENDED_FROM_ISR_DONE( ( EventGroup_t * ) pvEventGroup );
+
         traceRETURN_vEventGroupSetBitsCallback();
     }
 /*-----------------------------------------------------------*/
@@ -768,6 +942,11 @@
         /* coverity[misra_c_2012_rule_11_5_violation] */
         ( void ) xEventGroupClearBits( pvEventGroup, ( EventBits_t ) ulBitsToClear );
 
+        /* MISRA Ref 11.5.4 [Callback function parameter] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+        /* coverity[misra_c_2012_rule_11_5_violation] */
+        eventPENDED_FROM_ISR_DONE( ( EventGroup_t * ) pvEventGroup );
+
         traceRETURN_vEventGroupClearBitsCallback();
     }
 /*-----------------------------------------------------------*/
@@ -809,7 +988,7 @@
     }
 /*-----------------------------------------------------------*/
 
-    #if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+    #if ( ( ( configUSE_TRACE_FACILITY == 1 ) || ( configEVENT_GROUP_ISR_MAX_WAKE > 0 ) ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
 
         BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup,
                                               const EventBits_t uxBitsToSet,
@@ -817,17 +996,112 @@
         {
             BaseType_t xReturn;
 
+            #if ( configEVENT_GROUP_ISR_MAX_WAKE > 0 )
+                EventGroup_t * pxEventBits = xEventGroup;
+                UBaseType_t uxSavedInterruptStatus;
+                BaseType_t xSetInISR;
+            #endif
+
             traceENTER_xEventGroupSetBitsFromISR( xEventGroup, uxBitsToSet, pxHigherPriorityTaskWoken );
 
             traceEVENT_GROUP_SET_BITS_FROM_ISR( xEventGroup, uxBitsToSet );
-            xReturn = xTimerPendFunctionCallFromISR( vEventGroupSetBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToSet, pxHigherPriorityTaskWoken );
+
+            #if ( configEVENT_GROUP_ISR_MAX_WAKE > 0 )
+            {
+                configASSERT( xEventGroup );
+                configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
+                portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+                uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+                {
+                    /* Only unblock the tasks here if there are few enough of
+                     * them and neither a task nor an earlier pended command is
+                     * accessing the event group, otherwise pend the whole set
+                     * as before so the semantics of clearing bits on exit and
+                     * the order of the commands are kept. */
+                    if( ( eventCAN_ACCESS_FROM_ISR( pxEventBits ) ) &&
+                        ( listCURRENT_LIST_LENGTH( &( pxEventBits->xTasksWaitingForBits ) ) <= ( UBaseType_t ) configEVENT_GROUP_ISR_MAX_WAKE ) )
+                    {
+                        xSetInISR = pdTRUE;
+
+                        if( prvSetBitsAndUnblock( pxEventBits, uxBitsToSet, pdTRUE ) != pdFALSE )
+                        {
+                            if( pxHigherPriorityTaskWoken != NULL )
+                            {
+                                *pxHigherPriorityTaskWoken = pdTRUE;
+                            }
+                            else
+                            {
+                                mtCOVERAGE_TEST_MARKER();
+                            }
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    else
+                    {
+                        xSetInISR = pdFALSE;
+                        ( pxEventBits->uxPendedFromISR )++;
+                    }
+                }
+                taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+                if( xSetInISR != pdFALSE )
+                {
+                    xReturn = pdPASS;
+                }
+                else
+                {
+                    xReturn = prvPendFromISR( pxEventBits, vEventGroupSetBitsCallback, uxBitsToSet, pxHigherPriorityTaskWoken );
+                }
+            }
+            #else /* if ( configEVENT_GROUP_ISR_MAX_WAKE > 0 ) */
+            {
+                xReturn = xTimerPendFunctionCallFromISR( vEventGroupSetBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToSet, pxHigherPriorityTaskWoken );
+            }
+            #endif /* if ( configEVENT_GROUP_ISR_MAX_WAKE > 0 ) */
 
             traceRETURN_xEventGroupSetBitsFromISR( xReturn );
 
             return xReturn;
         }
 
-    #endif /* if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) ) */
+    #endif /* if ( ( ( configUSE_TRACE_FACILITY == 1 ) || ( configEVENT_GROUP_ISR_MAX_WAKE > 0 ) ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+    #if ( ( configEVENT_GROUP_ISR_MAX_WAKE > 0 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+
+        static BaseType_t prvPendFromISR( EventGroup_t * pxEventBits,
+                                          PendedFunction_t xFunctionToPend,
+                                          const EventBits_t uxBits,
+                                          BaseType_t * pxHigherPriorityTaskWoken )
+        {
+            BaseType_t xReturn;
+            UBaseType_t uxSavedInterruptStatus;
+
+            xReturn = xTimerPendFunctionCallFromISR( xFunctionToPend, ( void * ) pxEventBits, ( uint32_t ) uxBits, pxHigherPriorityTaskWoken );
+
+            if( xReturn != pdPASS )
+            {
+                /* The command was lost, so the timer task will not count it
+                 * as executed. */
+                uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+                {
+                    ( pxEventBits->uxPendedFromISR )--;
+                }
+                taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return xReturn;
+        }
+
+    #endif /* if ( ( configEVENT_GROUP_ISR_MAX_WAKE > 0 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) ) */
 /*-----------------------------------------------------------*/
 
     #if ( configUSE_TRACE_FACILITY == 1 )
@@ -336,6 +336,55 @@
     #endif
 #endif
 
+/* Set configUSE_TIMER_WHEEL to 1 to keep active software timers in a
+ * hierarchical timing wheel instead of the two sorted timer lists, so starting,
+ * stopping and resetting a timer is O(1) however many timers are active.  The
+ * wheel has configTIMER_WHEEL_LEVELS levels of ( 1 << configTIMER_WHEEL_SLOT_BITS )
+ * slots, each slot being a List_t. */
+#ifndef configUSE_TIMER_WHEEL
+    #define configUSE_TIMER_WHEEL    0
+#endif
+
+#ifndef configTIMER_WHEEL_SLOT_BITS
+    #define configTIMER_WHEEL_SLOT_BITS    5
+#endif
+
+#ifndef configTIMER_WHEEL_LEVELS
+    #define configTIMER_WHEEL_LEVELS    4
+#endif
+
+#if ( configUSE_TIMER_WHEEL == 1 )
+    #if ( ( configTIMER_WHEEL_SLOT_BITS < 1 ) || ( configTIMER_WHEEL_SLOT_BITS > 5 ) )
+        #error configTIMER_WHEEL_SLOT_BITS must be between 1 and 5, the slots of one level are tracked in a 32-bit map.
+    #endif
+
+    #if ( ( configTIMER_WHEEL_LEVELS < 2 ) || ( ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_16_BITS ) && ( ( configTIMER_WHEEL_SLOT_BITS * configTIMER_WHEEL_LEVELS ) > 16 ) ) || ( ( configTIMER_WHEEL_SLOT_BITS * configTIMER_WHEEL_LEVELS ) > 32 ) )
+        #error configTIMER_WHEEL_LEVELS must be at least 2, and the wheel must not span more bits than TickType_t.
+    #endif
+#endif
+
+/* Set configUSE_DELAYED_TASK_HEAP to 1 to also keep the tasks of each delayed
+ * task list in an intrusive pairing heap ordered by wake time, so blocking a
+ * task with a timeout is O(1) instead of a sorted insertion walking the list,
+ * and unblocking the task with the earliest wake time is O(log n) amortized.
+ * The delayed lists are then unsorted, and each TCB grows by three pointers. */
+#ifndef configUSE_DELAYED_TASK_HEAP
+    #define configUSE_DELAYED_TASK_HEAP    0
+#endif
+
+/* Set configEVENT_GROUP_ISR_MAX_WAKE to K above 0 to let
+ * xEventGroupSetBitsFromISR() set the bits and unblock the waiting tasks in the
+ * interrupt when at most K tasks wait on the event group, instead of always
+ * pending the set to the timer service task.  Event groups with more waiting
+ * tasks are still pended, so the time spent in the interrupt stays bounded.
+ * xEventGroupClearBitsFromISR() then clears the bits in the interrupt too.  The
+ * task level event group functions still access the waiting tasks with the
+ * scheduler suspended, an interrupt that comes meanwhile, or while an earlier
+ * command from an interrupt is still pended, pends its command as before. */
+#ifndef configEVENT_GROUP_ISR_MAX_WAKE
+    #define configEVENT_GROUP_ISR_MAX_WAKE    0
+#endif
+
 #ifndef configUSE_COUNTING_SEMAPHORES
     #define configUSE_COUNTING_SEMAPHORES    0
 #endif
@@ -3194,6 +3243,9 @@ typedef struct xSTATIC_TCB
     #if ( configUSE_POSIX_ERRNO == 1 )
         int iDummy22;
     #endif
+    #if ( configUSE_DELAYED_TASK_HEAP == 1 )
+        void * pxDummy27[ 3 ];
+    #endif
 } StaticTask_t;
 
 /*
@@ -3265,6 +3317,11 @@ typedef struct xSTATIC_EVENT_GROUP
     #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
         uint8_t ucDummy4;
     #endif
+
+    #if ( configEVENT_GROUP_ISR_MAX_WAKE > 0 )
+        UBaseType_t uxDummy5;
+        UBaseType_t uxDummy6;
+    #endif
 } StaticEventGroup_t;
 
 /*
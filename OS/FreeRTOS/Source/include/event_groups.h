@@ -408,7 +408,9 @@ EventBits_t xEventGroupClearBits( EventGroupHandle_t xEventGroup,
  * a result event groups cannot be accessed directly from an interrupt service
  * routine.  Therefore xEventGroupClearBitsFromISR() sends a message to the
  * timer task to have the clear operation performed in the context of the timer
- * task.
+ * task.  If configEVENT_GROUP_ISR_MAX_WAKE is not 0 the bits are cleared in the
+ * interrupt instead, unless a task is accessing the event group or an earlier
+ * command from an interrupt is still pended.
  *
  * @note If this function returns pdPASS then the timer task is ready to run
  * and a portYIELD_FROM_ISR(pdTRUE) should be executed to perform the needed
@@ -452,7 +454,7 @@ EventBits_t xEventGroupClearBits( EventGroupHandle_t xEventGroup,
  * \defgroup xEventGroupClearBitsFromISR xEventGroupClearBitsFromISR
  * \ingroup EventGroup
  */
-#if ( configUSE_TRACE_FACILITY == 1 )
+#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( configEVENT_GROUP_ISR_MAX_WAKE > 0 ) )
     BaseType_t xEventGroupClearBitsFromISR( EventGroupHandle_t xEventGroup,
                                             const EventBits_t uxBitsToClear ) PRIVILEGED_FUNCTION;
 #else
@@ -552,7 +554,10 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup,
  * interrupts or from critical sections.  Therefore xEventGroupSetBitsFromISR()
  * sends a message to the timer task to have the set operation performed in the
  * context of the timer task - where a scheduler lock is used in place of a
- * critical section.
+ * critical section.  If configEVENT_GROUP_ISR_MAX_WAKE is not 0 the bits are set
+ * and at most that many waiting tasks unblocked in the interrupt instead, unless
+ * more tasks are waiting, a task is accessing the event group or an earlier
+ * command from an interrupt is still pended.
  *
  * @param xEventGroup The event group in which the bits are to be set.
  *
@@ -610,7 +615,7 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup,
  * \defgroup xEventGroupSetBitsFromISR xEventGroupSetBitsFromISR
  * \ingroup EventGroup
  */
-#if ( configUSE_TRACE_FACILITY == 1 )
+#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( configEVENT_GROUP_ISR_MAX_WAKE > 0 ) )
     BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup,
                                           const EventBits_t uxBitsToSet,
                                           BaseType_t * pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
@@ -958,6 +958,35 @@ typedef StreamBufferHandle_t MessageBufferHandle_t;
 #define xMessageBufferReceiveCompletedFromISR( xMessageBuffer, pxHigherPriorityTaskWoken ) \
     xStreamBufferReceiveCompletedFromISR( ( xMessageBuffer ), ( pxHigherPriorityTaskWoken ) )
 
+/**
+ * message_buffer.h
+ *
+ * Zero copy API of message buffers, see xStreamBufferReserve(),
+ * xStreamBufferCommit(), xStreamBufferAcquire() and xStreamBufferRelease().
+ * A message is reserved and committed as a whole, and acquired and released
+ * as a whole.
+ *
+ * \defgroup xMessageBufferReserve xMessageBufferReserve
+ * \ingroup StreamBufferManagement
+ */
+#define xMessageBufferReserve( xMessageBuffer, xMessageLengthBytes, pxSegments, xTicksToWait ) \
+    xStreamBufferReserve( ( xMessageBuffer ), ( xMessageLengthBytes ), ( pxSegments ), ( xTicksToWait ) )
+
+#define xMessageBufferCommit( xMessageBuffer, xMessageLengthBytes ) \
+    xStreamBufferCommit( ( xMessageBuffer ), ( xMessageLengthBytes ) )
+
+#define xMessageBufferCommitFromISR( xMessageBuffer, xMessageLengthBytes, pxHigherPriorityTaskWoken ) \
+    xStreamBufferCommitFromISR( ( xMessageBuffer ), ( xMessageLengthBytes ), ( pxHigherPriorityTaskWoken ) )
+
+#define xMessageBufferAcquire( xMessageBuffer, pxSegments, xTicksToWait ) \
+    xStreamBufferAcquire( ( xMessageBuffer ), ( pxSegments ), ( xTicksToWait ) )
+
+#define xMessageBufferRelease( xMessageBuffer, xMessageLengthBytes ) \
+    xStreamBufferRelease( ( xMessageBuffer ), ( xMessageLengthBytes ) )
+
+#define xMessageBufferReleaseFromISR( xMessageBuffer, xMessageLengthBytes, pxHigherPriorityTaskWoken ) \
+    xStreamBufferReleaseFromISR( ( xMessageBuffer ), ( xMessageLengthBytes ), ( pxHigherPriorityTaskWoken ) )
+
 /* *INDENT-OFF* */
 #if defined( __cplusplus )
     } /* extern "C" */
@@ -1456,6 +1456,107 @@ BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue,
                                  void * const pvBuffer,
                                  BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue.h
+ * @code{c}
+ * BaseType_t xQueueSendMultiple( QueueHandle_t xQueue,
+ *                                const void * const pvItemsToQueue,
+ *                                UBaseType_t uxItemCount,
+ *                                TickType_t xTicksToWait );
+ * BaseType_t xQueueSendMultipleFromISR( QueueHandle_t xQueue,
+ *                                       const void * const pvItemsToQueue,
+ *                                       UBaseType_t uxItemCount,
+ *                                       BaseType_t * const pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Post up to uxItemCount items, stored one after another in pvItemsToQueue,
+ * to the back of a queue.  All the items that fit are copied in one critical
+ * section, and at most one task waiting to receive is unblocked for them, so
+ * the locking cost of xQueueSend() is paid once per batch instead of once per
+ * item.
+ *
+ * If the queue is full xQueueSendMultiple() blocks for up to xTicksToWait for
+ * room for at least one item, it doesn't wait for room for the rest of the
+ * items.  The FromISR version never blocks.
+ *
+ * Items are copied in order, so the receiver gets them in the same order as
+ * sending them one by one with xQueueSendToBack().  The queue must not be a
+ * semaphore or mutex.
+ *
+ * @param xQueue The handle to the queue on which the items are to be posted.
+ *
+ * @param pvItemsToQueue A pointer to an array of uxItemCount items.
+ *
+ * @param uxItemCount The number of items to post.
+ *
+ * @param xTicksToWait The maximum amount of time to wait for room.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if sending unblocked a task
+ * of higher priority than the running task, the same as
+ * xQueueSendFromISR().
+ *
+ * @return The number of items posted, 0 if the queue is full.
+ *
+ * \defgroup xQueueSendMultiple xQueueSendMultiple
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueSendMultiple( QueueHandle_t xQueue,
+                               const void * const pvItemsToQueue,
+                               UBaseType_t uxItemCount,
+                               TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+BaseType_t xQueueSendMultipleFromISR( QueueHandle_t xQueue,
+                                      const void * const pvItemsToQueue,
+                                      UBaseType_t uxItemCount,
+                                      BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue.h
+ * @code{c}
+ * BaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue,
+ *                                   void * const pvBuffer,
+ *                                   UBaseType_t uxItemCount,
+ *                                   TickType_t xTicksToWait );
+ * BaseType_t xQueueReceiveMultipleFromISR( QueueHandle_t xQueue,
+ *                                          void * const pvBuffer,
+ *                                          UBaseType_t uxItemCount,
+ *                                          BaseType_t * const pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Receive up to uxItemCount items from a queue into pvBuffer, one after
+ * another.  All the items available are copied in one critical section, and
+ * at most one task waiting to send is unblocked for them.
+ *
+ * If the queue is empty xQueueReceiveMultiple() blocks for up to xTicksToWait
+ * for at least one item.  The FromISR version never blocks.
+ *
+ * @param xQueue The handle to the queue from which the items are received.
+ *
+ * @param pvBuffer Pointer to a buffer with room for uxItemCount items.
+ *
+ * @param uxItemCount The maximum number of items to receive.
+ *
+ * @param xTicksToWait The maximum amount of time to wait for an item.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if receiving unblocked a
+ * task of higher priority than the running task, the same as
+ * xQueueReceiveFromISR().
+ *
+ * @return The number of items received, 0 if the queue is empty.
+ *
+ * \defgroup xQueueReceiveMultiple xQueueReceiveMultiple
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue,
+                                  void * const pvBuffer,
+                                  UBaseType_t uxItemCount,
+                                  TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+BaseType_t xQueueReceiveMultipleFromISR( QueueHandle_t xQueue,
+                                         void * const pvBuffer,
+                                         UBaseType_t uxItemCount,
+                                         BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 /*
  * Utilities to query queues that are safe to use from an ISR.  These utilities
  * should be used only from within an ISR, or within a critical section.
@@ -85,6 +85,20 @@ typedef void (* StreamBufferCallbackFunction_t)( StreamBufferHandle_t xStreamBuf
                                                  BaseType_t xIsInsideISR,
                                                  BaseType_t * const pxHigherPriorityTaskWoken );
 
+/**
+ * Type used by the zero copy API to describe bytes in a stream buffer's
+ * storage area.  The bytes start at pucFirst, and continue at pucSecond when
+ * they wrap around to the start of the storage area, pucSecond is NULL and
+ * xSecondLength is 0 if they don't wrap.
+ */
+typedef struct StreamBufferSegments
+{
+    uint8_t * pucFirst;
+    size_t xFirstLength;
+    uint8_t * pucSecond;
+    size_t xSecondLength;
+} StreamBufferSegments_t;
+
 /**
  * stream_buffer.h
  *
@@ -1245,6 +1259,151 @@ UBaseType_t uxStreamBufferGetStreamBufferNotificationIndex( StreamBufferHandle_t
 void vStreamBufferSetStreamBufferNotificationIndex( StreamBufferHandle_t xStreamBuffer,
                                                     UBaseType_t uxNotificationIndex ) PRIVILEGED_FUNCTION;
 
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t xStreamBufferReserve( StreamBufferHandle_t xStreamBuffer,
+ *                              size_t xMaxLengthBytes,
+ *                              StreamBufferSegments_t * const pxSegments,
+ *                              TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Zero copy alternative to xStreamBufferSend().  Reserves free space in the
+ * buffer so the writer can write data in place, instead of copying it from
+ * another buffer.  The reserved space is described by *pxSegments, and is not
+ * visible to the reader until xStreamBufferCommit() is called.
+ *
+ * For a stream buffer up to xMaxLengthBytes bytes are reserved.  For a message
+ * buffer either exactly xMaxLengthBytes bytes are reserved, after the space
+ * for the message length, or nothing is.
+ *
+ * The same as xStreamBufferSend(), only one task or interrupt can write to a
+ * stream buffer, and the writer must not call xStreamBufferSend() between
+ * reserve and commit.  xTicksToWait must be 0 when called from an interrupt.
+ *
+ * @param xStreamBuffer The handle of the stream buffer to write to.
+ *
+ * @param xMaxLengthBytes The maximum number of bytes to reserve, must not be 0.
+ *
+ * @param pxSegments Receives one or two segments of the reserved space.
+ *
+ * @param xTicksToWait The maximum amount of time to wait for enough space.
+ *
+ * @return The number of bytes reserved, 0 if there isn't enough space.
+ *
+ * \defgroup xStreamBufferReserve xStreamBufferReserve
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferReserve( StreamBufferHandle_t xStreamBuffer,
+                             size_t xMaxLengthBytes,
+                             StreamBufferSegments_t * const pxSegments,
+                             TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t xStreamBufferCommit( StreamBufferHandle_t xStreamBuffer, size_t xBytesWritten );
+ * size_t xStreamBufferCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+ *                                    size_t xBytesWritten,
+ *                                    BaseType_t * const pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Makes the first xBytesWritten bytes of the space reserved by
+ * xStreamBufferReserve() visible to the reader, and unblocks a reader waiting
+ * for data the same as xStreamBufferSend().  For a message buffer they are
+ * sent as one message, and committing 0 bytes cancels the reservation.
+ *
+ * @param xStreamBuffer The handle of the stream buffer written to.
+ *
+ * @param xBytesWritten The number of bytes written, must not be larger than
+ * the number of bytes reserved.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if a higher priority task
+ * is unblocked, the same as xStreamBufferSendFromISR().
+ *
+ * @return The number of bytes committed.
+ *
+ * \defgroup xStreamBufferCommit xStreamBufferCommit
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferCommit( StreamBufferHandle_t xStreamBuffer,
+                            size_t xBytesWritten ) PRIVILEGED_FUNCTION;
+
+size_t xStreamBufferCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+                                   size_t xBytesWritten,
+                                   BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t xStreamBufferAcquire( StreamBufferHandle_t xStreamBuffer,
+ *                              StreamBufferSegments_t * const pxSegments,
+ *                              TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Zero copy alternative to xStreamBufferReceive().  Gets the data in the
+ * buffer so the reader can read it in place, instead of copying it to another
+ * buffer.  The data is described by *pxSegments, and stays in the buffer until
+ * xStreamBufferRelease() is called.
+ *
+ * For a stream buffer all the bytes in the buffer are acquired.  For a message
+ * buffer the next message is acquired.  The same as xStreamBufferReceive(),
+ * only one task or interrupt can read from a stream buffer, and xTicksToWait
+ * must be 0 when called from an interrupt.
+ *
+ * @param xStreamBuffer The handle of the stream buffer to read from.
+ *
+ * @param pxSegments Receives one or two segments of the data.
+ *
+ * @param xTicksToWait The maximum amount of time to wait for data.
+ *
+ * @return The number of bytes acquired, 0 if there is no data.
+ *
+ * \defgroup xStreamBufferAcquire xStreamBufferAcquire
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferAcquire( StreamBufferHandle_t xStreamBuffer,
+                             StreamBufferSegments_t * const pxSegments,
+                             TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t xStreamBufferRelease( StreamBufferHandle_t xStreamBuffer, size_t xBytesRead );
+ * size_t xStreamBufferReleaseFromISR( StreamBufferHandle_t xStreamBuffer,
+ *                                     size_t xBytesRead,
+ *                                     BaseType_t * const pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Removes the first xBytesRead bytes of the data acquired by
+ * xStreamBufferAcquire() from the buffer, and unblocks a writer waiting for
+ * space the same as xStreamBufferReceive().  For a message buffer the whole
+ * message is removed, and xBytesRead must be its length.
+ *
+ * @param xStreamBuffer The handle of the stream buffer read from.
+ *
+ * @param xBytesRead The number of bytes read, must not be larger than the
+ * number of bytes acquired.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if a higher priority task
+ * is unblocked, the same as xStreamBufferReceiveFromISR().
+ *
+ * @return The number of bytes released.
+ *
+ * \defgroup xStreamBufferRelease xStreamBufferRelease
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferRelease( StreamBufferHandle_t xStreamBuffer,
+                             size_t xBytesRead ) PRIVILEGED_FUNCTION;
+
+size_t xStreamBufferReleaseFromISR( StreamBufferHandle_t xStreamBuffer,
+                                    size_t xBytesRead,
+                                    BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 /* Functions below here are not part of the public API. */
 StreamBufferHandle_t xStreamBufferGenericCreate( size_t xBufferSizeBytes,
                                                  size_t xTriggerLevelBytes,
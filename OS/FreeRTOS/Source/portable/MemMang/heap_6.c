@@ -0,0 +1,830 @@
+/*
+ * FreeRTOS Kernel V11.1.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * A two level segregated fit (TLSF) implementation of pvPortMalloc() and
+ * vPortFree() for the Nuclei RISC-V port, both are O(1).
+ *
+ * Free blocks are kept in heapFL_COUNT x heapSL_COUNT segregated free lists,
+ * the first level splits the sizes by power of two, and the second level
+ * splits each power of two range linearly.  Two levels of bitmaps record
+ * which lists are not empty, so a suitable free list is found with two
+ * count leading zeros operations (__FLSL of NMSIS) instead of walking a list.
+ * Adjacent free blocks are merged immediately when a block is freed, the
+ * physically previous block is found by a back pointer in the block header.
+ *
+ * When configHEAP6_CORE_CACHE_DEPTH is not 0, each core also keeps a few
+ * freed small blocks of every power of two size class, small allocations
+ * and frees on the same core are served from the cache with only local
+ * interrupts masked, so they don't suspend the scheduler and don't contend
+ * other cores.
+ *
+ * See heap_1.c, heap_2.c, heap_3.c, heap_4.c and heap_5.c for alternative
+ * implementations, and the memory management pages of https://www.FreeRTOS.org
+ * for more information.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+    #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+#ifndef configHEAP_CLEAR_MEMORY_ON_FREE
+    #define configHEAP_CLEAR_MEMORY_ON_FREE    0
+#endif
+
+/* Log2 of the number of second level lists of each first level range. */
+#ifndef configHEAP6_SL_INDEX_LOG2
+    #define configHEAP6_SL_INDEX_LOG2    4
+#endif
+
+/* Log2 of the largest block size that can be managed, heap size must be less
+ * than ( 1 << configHEAP6_FL_INDEX_MAX ). */
+#ifndef configHEAP6_FL_INDEX_MAX
+    #define configHEAP6_FL_INDEX_MAX    24
+#endif
+
+/* Number of freed blocks cached per size class per core, 0 to disable. */
+#ifndef configHEAP6_CORE_CACHE_DEPTH
+    #define configHEAP6_CORE_CACHE_DEPTH    0
+#endif
+
+/* Number of power of two size classes of the core caches, the smallest class
+ * is heapMINIMUM_BLOCK_SIZE. */
+#ifndef configHEAP6_CORE_CACHE_CLASSES
+    #define configHEAP6_CORE_CACHE_CLASSES    4
+#endif
+
+/* Max value that fits in a size_t type. */
+#define heapSIZE_MAX                 ( ~( ( size_t ) 0 ) )
+
+/* Check if multiplying a and b will result in overflow. */
+#define heapMULTIPLY_WILL_OVERFLOW( a, b )     ( ( ( a ) > 0 ) && ( ( b ) > ( heapSIZE_MAX / ( a ) ) ) )
+
+/* Check if adding a and b will result in overflow. */
+#define heapADD_WILL_OVERFLOW( a, b )          ( ( a ) > ( heapSIZE_MAX - ( b ) ) )
+
+/* Bit 0 of xBlockSize is set when the block is free, block sizes are always
+ * multiple of portBYTE_ALIGNMENT so the low bits are not part of the size. */
+#define heapBLOCK_FREE_BIT           ( ( size_t ) 1 )
+#define heapBLOCK_SIZE( pxBlock )    ( ( pxBlock )->xBlockSize & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+#define heapBLOCK_IS_FREE( pxBlock ) ( ( ( pxBlock )->xBlockSize & heapBLOCK_FREE_BIT ) != 0 )
+
+/* Second level lists and the smallest size mapped by the first level, the
+ * sizes below it are mapped linearly by portBYTE_ALIGNMENT steps to list 0. */
+#define heapSL_COUNT                 ( 1UL << configHEAP6_SL_INDEX_LOG2 )
+#define heapFL_SHIFT                 ( configHEAP6_SL_INDEX_LOG2 + 3 )
+#define heapSMALL_BLOCK_SIZE         ( ( size_t ) 1 << heapFL_SHIFT )
+#define heapFL_COUNT                 ( configHEAP6_FL_INDEX_MAX - heapFL_SHIFT + 1 )
+
+#if ( portBYTE_ALIGNMENT < 8 )
+    #error heap_6.c requires portBYTE_ALIGNMENT to be at least 8
+#endif
+
+#if ( configHEAP6_SL_INDEX_LOG2 > 5 )
+    #error configHEAP6_SL_INDEX_LOG2 must not be larger than 5
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* Allocate the memory for the heap. */
+#if ( configAPPLICATION_ALLOCATED_HEAP == 1 )
+
+/* The application writer has already defined the array used for the RTOS
+* heap - probably so it can be placed in a special segment or address. */
+    extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#else
+    PRIVILEGED_DATA static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#endif /* configAPPLICATION_ALLOCATED_HEAP */
+
+/* Header of each block.  pxPrevPhysBlock and xBlockSize are always valid, the
+ * free list links are only used while the block is free, and are part of the
+ * memory returned to the application when the block is allocated. */
+typedef struct A_HEAP_BLOCK
+{
+    struct A_HEAP_BLOCK * pxPrevPhysBlock; /**< The block just before this one in memory. */
+    size_t xBlockSize;                     /**< The size of the block including header, bit 0 is the free flag. */
+    struct A_HEAP_BLOCK * pxNextFreeBlock; /**< The next block in the same free list. */
+    struct A_HEAP_BLOCK * pxPrevFreeBlock; /**< The previous block in the same free list. */
+} HeapBlock_t;
+
+/* Assert that a heap block pointer is within the heap bounds. */
+#define heapVALIDATE_BLOCK_POINTER( pxBlock )                          \
+    configASSERT( ( ( uint8_t * ) ( pxBlock ) >= &( ucHeap[ 0 ] ) ) && \
+                  ( ( uint8_t * ) ( pxBlock ) <= &( ucHeap[ configTOTAL_HEAP_SIZE - 1 ] ) ) )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Called automatically to setup the required heap structures the first time
+ * pvPortMalloc() is called.
+ */
+static void prvHeapInit( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Allocate a block of exactly xWantedSize bytes including the header from the
+ * segregated free lists, must be called with the scheduler suspended.
+ */
+static HeapBlock_t * prvAllocateBlock( size_t xWantedSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * Merge the block with its free neighbours and put it into the free lists,
+ * must be called with the scheduler suspended.
+ */
+static void prvReleaseBlock( HeapBlock_t * pxBlock ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+/* The size of the header placed at the beginning of each allocated memory
+ * block, the free list links are not included. */
+static const size_t xHeapStructSize = ( offsetof( HeapBlock_t, pxNextFreeBlock ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* Block sizes must be large enough to hold the free list links. */
+#define heapMINIMUM_BLOCK_SIZE    ( ( sizeof( HeapBlock_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/* Bitmap of first level ranges that have free blocks, and bitmaps of second
+ * level lists that have free blocks for each range. */
+PRIVILEGED_DATA static UBaseType_t uxFLBitmap = 0;
+PRIVILEGED_DATA static UBaseType_t uxSLBitmap[ heapFL_COUNT ];
+PRIVILEGED_DATA static HeapBlock_t * pxFreeLists[ heapFL_COUNT ][ heapSL_COUNT ];
+
+/* Marks the end of the heap, it is a zero sized allocated block. */
+PRIVILEGED_DATA static HeapBlock_t * pxEnd = NULL;
+
+/* Keeps track of the number of calls to allocate and free memory as well as the
+ * number of free bytes remaining, but says nothing about fragmentation. */
+PRIVILEGED_DATA static size_t xFreeBytesRemaining = ( size_t ) 0U;
+PRIVILEGED_DATA static size_t xMinimumEverFreeBytesRemaining = ( size_t ) 0U;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulAllocations = ( size_t ) 0U;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulFrees = ( size_t ) 0U;
+
+#if ( configHEAP6_CORE_CACHE_DEPTH > 0 )
+
+/* Freed blocks cached by one core, only accessed by the owner core with
+ * local interrupts masked.  Cached blocks are still allocated from the view
+ * of the free lists, but they are reported as free bytes. */
+    typedef struct A_HEAP_CORE_CACHE
+    {
+        HeapBlock_t * pxBlocks[ configHEAP6_CORE_CACHE_CLASSES ];
+        UBaseType_t uxCount[ configHEAP6_CORE_CACHE_CLASSES ];
+        size_t xCachedBytes;
+        size_t xAllocations;
+        size_t xFrees;
+    } HeapCoreCache_t;
+
+    PRIVILEGED_DATA static HeapCoreCache_t xCoreCaches[ configNUMBER_OF_CORES ];
+
+/*
+ * Return all blocks cached by current core to the free lists, must be called
+ * with the scheduler suspended.
+ */
+    static void prvDrainCoreCache( void ) PRIVILEGED_FUNCTION;
+#endif /* configHEAP6_CORE_CACHE_DEPTH */
+
+/*-----------------------------------------------------------*/
+
+/* Find first set bit */
+#define heapFFS( x )    __FLSL( ( x ) & ( ~( x ) + 1UL ) )
+
+/* Get the free list indexes of a block size, used when inserting a block. */
+static void prvMappingInsert( size_t xSize,
+                              UBaseType_t * puxFL,
+                              UBaseType_t * puxSL )
+{
+    UBaseType_t uxFL, uxSL;
+
+    if( xSize < heapSMALL_BLOCK_SIZE )
+    {
+        uxFL = 0;
+        uxSL = xSize / ( heapSMALL_BLOCK_SIZE / heapSL_COUNT );
+    }
+    else
+    {
+        uxFL = __FLSL( xSize );
+        uxSL = ( xSize >> ( uxFL - configHEAP6_SL_INDEX_LOG2 ) ) ^ heapSL_COUNT;
+        uxFL -= ( heapFL_SHIFT - 1 );
+    }
+
+    *puxFL = uxFL;
+    *puxSL = uxSL;
+}
+
+/* Get the free list indexes of a request size, rounded up so any block in the
+ * found list is large enough, used when searching a block. */
+static void prvMappingSearch( size_t xSize,
+                              UBaseType_t * puxFL,
+                              UBaseType_t * puxSL )
+{
+    if( xSize >= heapSMALL_BLOCK_SIZE )
+    {
+        xSize += ( ( size_t ) 1 << ( __FLSL( xSize ) - configHEAP6_SL_INDEX_LOG2 ) ) - 1;
+    }
+
+    prvMappingInsert( xSize, puxFL, puxSL );
+}
+
+static void prvInsertFreeBlock( HeapBlock_t * pxBlock )
+{
+    UBaseType_t uxFL, uxSL;
+
+    prvMappingInsert( heapBLOCK_SIZE( pxBlock ), &uxFL, &uxSL );
+    configASSERT( uxFL < heapFL_COUNT );
+
+    pxBlock->xBlockSize |= heapBLOCK_FREE_BIT;
+    pxBlock->pxPrevFreeBlock = NULL;
+    pxBlock->pxNextFreeBlock = pxFreeLists[ uxFL ][ uxSL ];
+
+    if( pxBlock->pxNextFreeBlock != NULL )
+    {
+        pxBlock->pxNextFreeBlock->pxPrevFreeBlock = pxBlock;
+    }
+
+    pxFreeLists[ uxFL ][ uxSL ] = pxBlock;
+    uxFLBitmap |= ( 1UL << uxFL );
+    uxSLBitmap[ uxFL ] |= ( 1UL << uxSL );
+}
+
+static void prvRemoveFreeBlock( HeapBlock_t * pxBlock )
+{
+    UBaseType_t uxFL, uxSL;
+
+    prvMappingInsert( heapBLOCK_SIZE( pxBlock ), &uxFL, &uxSL );
+
+    if( pxBlock->pxNextFreeBlock != NULL )
+    {
+        pxBlock->pxNextFreeBlock->pxPrevFreeBlock = pxBlock->pxPrevFreeBlock;
+    }
+
+    if( pxBlock->pxPrevFreeBlock != NULL )
+    {
+        pxBlock->pxPrevFreeBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+    }
+    else
+    {
+        /* It is the head of the list. */
+        pxFreeLists[ uxFL ][ uxSL ] = pxBlock->pxNextFreeBlock;
+
+        if( pxFreeLists[ uxFL ][ uxSL ] == NULL )
+        {
+            uxSLBitmap[ uxFL ] &= ~( 1UL << uxSL );
+
+            if( uxSLBitmap[ uxFL ] == 0 )
+            {
+                uxFLBitmap &= ~( 1UL << uxFL );
+            }
+        }
+    }
+
+    pxBlock->xBlockSize &= ~heapBLOCK_FREE_BIT;
+}
+
+/* Get the next block in memory. */
+static HeapBlock_t * prvNextPhysBlock( HeapBlock_t * pxBlock )
+{
+    return ( HeapBlock_t * ) ( ( ( uint8_t * ) pxBlock ) + heapBLOCK_SIZE( pxBlock ) );
+}
+/*-----------------------------------------------------------*/
+
+static HeapBlock_t * prvAllocateBlock( size_t xWantedSize ) /* PRIVILEGED_FUNCTION */
+{
+    HeapBlock_t * pxBlock = NULL;
+    HeapBlock_t * pxNewBlock;
+    UBaseType_t uxFL, uxSL, uxMap;
+
+    prvMappingSearch( xWantedSize, &uxFL, &uxSL );
+
+    if( uxFL < heapFL_COUNT )
+    {
+        /* Search the list of the request size and larger lists of the same
+         * first level range, then the larger first level ranges. */
+        uxMap = uxSLBitmap[ uxFL ] & ( ~( UBaseType_t ) 0 << uxSL );
+
+        if( uxMap == 0 )
+        {
+            uxMap = ( uxFL + 1 < heapFL_COUNT ) ? ( uxFLBitmap & ( ~( UBaseType_t ) 0 << ( uxFL + 1 ) ) ) : 0;
+
+            if( uxMap != 0 )
+            {
+                uxFL = heapFFS( uxMap );
+                uxMap = uxSLBitmap[ uxFL ];
+            }
+        }
+
+        if( uxMap != 0 )
+        {
+            uxSL = heapFFS( uxMap );
+            pxBlock = pxFreeLists[ uxFL ][ uxSL ];
+            heapVALIDATE_BLOCK_POINTER( pxBlock );
+            configASSERT( heapBLOCK_SIZE( pxBlock ) >= xWantedSize );
+            prvRemoveFreeBlock( pxBlock );
+
+            /* Split the remaining space off if it is large enough to be a block. */
+            if( ( heapBLOCK_SIZE( pxBlock ) - xWantedSize ) >= heapMINIMUM_BLOCK_SIZE )
+            {
+                pxNewBlock = ( HeapBlock_t * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+                pxNewBlock->xBlockSize = heapBLOCK_SIZE( pxBlock ) - xWantedSize;
+                pxNewBlock->pxPrevPhysBlock = pxBlock;
+                prvNextPhysBlock( pxNewBlock )->pxPrevPhysBlock = pxNewBlock;
+                pxBlock->xBlockSize = xWantedSize;
+                prvInsertFreeBlock( pxNewBlock );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            xFreeBytesRemaining -= heapBLOCK_SIZE( pxBlock );
+
+            if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+            {
+                xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
+static void prvReleaseBlock( HeapBlock_t * pxBlock ) /* PRIVILEGED_FUNCTION */
+{
+    HeapBlock_t * pxNeighbour;
+
+    xFreeBytesRemaining += heapBLOCK_SIZE( pxBlock );
+
+    /* Merge with the next block, the end marker is never free. */
+    pxNeighbour = prvNextPhysBlock( pxBlock );
+
+    if( heapBLOCK_IS_FREE( pxNeighbour ) )
+    {
+        prvRemoveFreeBlock( pxNeighbour );
+        pxBlock->xBlockSize += heapBLOCK_SIZE( pxNeighbour );
+        prvNextPhysBlock( pxBlock )->pxPrevPhysBlock = pxBlock;
+    }
+
+    /* Merge with the previous block, the first block has no previous block. */
+    pxNeighbour = pxBlock->pxPrevPhysBlock;
+
+    if( ( pxNeighbour != NULL ) && heapBLOCK_IS_FREE( pxNeighbour ) )
+    {
+        prvRemoveFreeBlock( pxNeighbour );
+        pxNeighbour->xBlockSize += heapBLOCK_SIZE( pxBlock );
+        pxBlock = pxNeighbour;
+        prvNextPhysBlock( pxBlock )->pxPrevPhysBlock = pxBlock;
+    }
+
+    prvInsertFreeBlock( pxBlock );
+}
+/*-----------------------------------------------------------*/
+
+#if ( configHEAP6_CORE_CACHE_DEPTH > 0 )
+
+/* Size class of core caches that can hold a block of xBlockSize bytes,
+ * classes are power of two multiples of heapMINIMUM_BLOCK_SIZE. */
+    static UBaseType_t prvCacheClass( size_t xBlockSize )
+    {
+        return __FLSL( xBlockSize / heapMINIMUM_BLOCK_SIZE );
+    }
+
+    static void prvDrainCoreCache( void ) /* PRIVILEGED_FUNCTION */
+    {
+        HeapCoreCache_t * pxCache;
+        HeapBlock_t * pxBlock;
+        UBaseType_t uxMask, uxClass;
+
+        uxMask = portSET_INTERRUPT_MASK_FROM_ISR();
+        pxCache = &xCoreCaches[ portGET_CORE_ID() ];
+
+        for( uxClass = 0; uxClass < configHEAP6_CORE_CACHE_CLASSES; uxClass++ )
+        {
+            while( pxCache->pxBlocks[ uxClass ] != NULL )
+            {
+                pxBlock = pxCache->pxBlocks[ uxClass ];
+                pxCache->pxBlocks[ uxClass ] = pxBlock->pxNextFreeBlock;
+                pxCache->uxCount[ uxClass ]--;
+                pxCache->xCachedBytes -= heapBLOCK_SIZE( pxBlock );
+                prvReleaseBlock( pxBlock );
+            }
+        }
+
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxMask );
+    }
+
+#endif /* configHEAP6_CORE_CACHE_DEPTH */
+/*-----------------------------------------------------------*/
+
+void * pvPortMalloc( size_t xWantedSize )
+{
+    HeapBlock_t * pxBlock = NULL;
+    void * pvReturn = NULL;
+
+    #if ( configHEAP6_CORE_CACHE_DEPTH > 0 )
+        HeapCoreCache_t * pxCache;
+        UBaseType_t uxMask, uxClass = configHEAP6_CORE_CACHE_CLASSES;
+    #endif
+
+    if( ( xWantedSize > 0 ) && ( heapADD_WILL_OVERFLOW( xWantedSize, xHeapStructSize + portBYTE_ALIGNMENT_MASK ) == 0 ) )
+    {
+        /* The wanted size must be increased so it can contain the header, and
+         * be aligned to the required number of bytes. */
+        xWantedSize = ( xWantedSize + xHeapStructSize + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+        if( xWantedSize < heapMINIMUM_BLOCK_SIZE )
+        {
+            xWantedSize = heapMINIMUM_BLOCK_SIZE;
+        }
+
+        #if ( configHEAP6_CORE_CACHE_DEPTH > 0 )
+        {
+            /* Small requests are rounded up to the size of their cache class,
+             * so any cached block of the class can serve it. */
+            uxClass = ( xWantedSize <= heapMINIMUM_BLOCK_SIZE ) ? 0 : ( prvCacheClass( xWantedSize - 1 ) + 1 );
+
+            if( uxClass < configHEAP6_CORE_CACHE_CLASSES )
+            {
+                xWantedSize = heapMINIMUM_BLOCK_SIZE << uxClass;
+                uxMask = portSET_INTERRUPT_MASK_FROM_ISR();
+                pxCache = &xCoreCaches[ portGET_CORE_ID() ];
+                pxBlock = pxCache->pxBlocks[ uxClass ];
+
+                if( pxBlock != NULL )
+                {
+                    pxCache->pxBlocks[ uxClass ] = pxBlock->pxNextFreeBlock;
+                    pxCache->uxCount[ uxClass ]--;
+                    pxCache->xCachedBytes -= heapBLOCK_SIZE( pxBlock );
+                    pxCache->xAllocations++;
+                }
+
+                portCLEAR_INTERRUPT_MASK_FROM_ISR( uxMask );
+            }
+        }
+        #endif /* configHEAP6_CORE_CACHE_DEPTH */
+    }
+    else
+    {
+        xWantedSize = 0;
+    }
+
+    if( ( pxBlock == NULL ) && ( xWantedSize > 0 ) )
+    {
+        vTaskSuspendAll();
+        {
+            /* If this is the first call to malloc then the heap will require
+             * initialisation to setup the free lists. */
+            if( pxEnd == NULL )
+            {
+                prvHeapInit();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            pxBlock = prvAllocateBlock( xWantedSize );
+
+            #if ( configHEAP6_CORE_CACHE_DEPTH > 0 )
+            {
+                /* Give the blocks cached by this core back and try again. */
+                if( pxBlock == NULL )
+                {
+                    prvDrainCoreCache();
+                    pxBlock = prvAllocateBlock( xWantedSize );
+                }
+            }
+            #endif
+
+            if( pxBlock != NULL )
+            {
+                xNumberOfSuccessfulAllocations++;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        ( void ) xTaskResumeAll();
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    if( pxBlock != NULL )
+    {
+        /* Return the memory space pointed to - jumping over the header. */
+        pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+        heapVALIDATE_BLOCK_POINTER( pvReturn );
+    }
+
+    traceMALLOC( pvReturn, xWantedSize );
+
+    #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+    {
+        if( pvReturn == NULL )
+        {
+            vApplicationMallocFailedHook();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif /* if ( configUSE_MALLOC_FAILED_HOOK == 1 ) */
+
+    configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void * pv )
+{
+    uint8_t * puc = ( uint8_t * ) pv;
+    HeapBlock_t * pxBlock;
+
+    #if ( configHEAP6_CORE_CACHE_DEPTH > 0 )
+        HeapCoreCache_t * pxCache;
+        UBaseType_t uxMask, uxClass;
+    #endif
+
+    if( pv != NULL )
+    {
+        /* The memory being freed will have a header immediately before it. */
+        puc -= xHeapStructSize;
+        pxBlock = ( void * ) puc;
+
+        heapVALIDATE_BLOCK_POINTER( pxBlock );
+        configASSERT( heapBLOCK_IS_FREE( pxBlock ) == 0 );
+        configASSERT( heapBLOCK_SIZE( pxBlock ) >= heapMINIMUM_BLOCK_SIZE );
+
+        if( heapBLOCK_IS_FREE( pxBlock ) == 0 )
+        {
+            #if ( configHEAP_CLEAR_MEMORY_ON_FREE == 1 )
+            {
+                ( void ) memset( puc + xHeapStructSize, 0, heapBLOCK_SIZE( pxBlock ) - xHeapStructSize );
+            }
+            #endif
+
+            traceFREE( pv, heapBLOCK_SIZE( pxBlock ) );
+
+            #if ( configHEAP6_CORE_CACHE_DEPTH > 0 )
+            {
+                uxClass = prvCacheClass( heapBLOCK_SIZE( pxBlock ) );
+
+                if( uxClass < configHEAP6_CORE_CACHE_CLASSES )
+                {
+                    uxMask = portSET_INTERRUPT_MASK_FROM_ISR();
+                    pxCache = &xCoreCaches[ portGET_CORE_ID() ];
+
+                    if( pxCache->uxCount[ uxClass ] < configHEAP6_CORE_CACHE_DEPTH )
+                    {
+                        pxBlock->pxNextFreeBlock = pxCache->pxBlocks[ uxClass ];
+                        pxCache->pxBlocks[ uxClass ] = pxBlock;
+                        pxCache->uxCount[ uxClass ]++;
+                        pxCache->xCachedBytes += heapBLOCK_SIZE( pxBlock );
+                        pxCache->xFrees++;
+                        pxBlock = NULL;
+                    }
+
+                    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxMask );
+                }
+            }
+            #endif /* configHEAP6_CORE_CACHE_DEPTH */
+
+            if( pxBlock != NULL )
+            {
+                vTaskSuspendAll();
+                {
+                    prvReleaseBlock( pxBlock );
+                    xNumberOfSuccessfulFrees++;
+                }
+                ( void ) xTaskResumeAll();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+    size_t xFreeBytes = xFreeBytesRemaining;
+
+    #if ( configHEAP6_CORE_CACHE_DEPTH > 0 )
+    {
+        UBaseType_t uxCore;
+
+        for( uxCore = 0; uxCore < configNUMBER_OF_CORES; uxCore++ )
+        {
+            xFreeBytes += xCoreCaches[ uxCore ].xCachedBytes;
+        }
+    }
+    #endif
+
+    return xFreeBytes;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+    return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+    /* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortCalloc( size_t xNum,
+                     size_t xSize )
+{
+    void * pv = NULL;
+
+    if( heapMULTIPLY_WILL_OVERFLOW( xNum, xSize ) == 0 )
+    {
+        pv = pvPortMalloc( xNum * xSize );
+
+        if( pv != NULL )
+        {
+            ( void ) memset( pv, 0, xNum * xSize );
+        }
+    }
+
+    return pv;
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void ) /* PRIVILEGED_FUNCTION */
+{
+    HeapBlock_t * pxFirstFreeBlock;
+    portPOINTER_SIZE_TYPE uxStartAddress, uxEndAddress;
+
+    /* Ensure the heap starts on a correctly aligned boundary. */
+    uxStartAddress = ( portPOINTER_SIZE_TYPE ) ucHeap;
+    uxStartAddress += ( portBYTE_ALIGNMENT - 1 );
+    uxStartAddress &= ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK );
+
+    /* pxEnd is an allocated zero sized block at the end of the heap space, so
+     * the last block never merges beyond the heap. */
+    uxEndAddress = ( portPOINTER_SIZE_TYPE ) ucHeap + ( portPOINTER_SIZE_TYPE ) configTOTAL_HEAP_SIZE;
+    uxEndAddress -= ( portPOINTER_SIZE_TYPE ) xHeapStructSize;
+    uxEndAddress &= ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK );
+
+    /* To start with there is a single free block that is sized to take up the
+     * entire heap space, minus the space taken by pxEnd. */
+    pxFirstFreeBlock = ( HeapBlock_t * ) uxStartAddress;
+    pxFirstFreeBlock->xBlockSize = ( size_t ) ( uxEndAddress - uxStartAddress );
+    pxFirstFreeBlock->pxPrevPhysBlock = NULL;
+    configASSERT( pxFirstFreeBlock->xBlockSize < ( ( size_t ) 1 << configHEAP6_FL_INDEX_MAX ) );
+
+    pxEnd = ( HeapBlock_t * ) uxEndAddress;
+    pxEnd->xBlockSize = 0;
+    pxEnd->pxPrevPhysBlock = pxFirstFreeBlock;
+
+    ( void ) memset( uxSLBitmap, 0, sizeof( uxSLBitmap ) );
+    ( void ) memset( pxFreeLists, 0, sizeof( pxFreeLists ) );
+    uxFLBitmap = 0;
+    prvInsertFreeBlock( pxFirstFreeBlock );
+
+    /* Only one block exists - and it covers the entire usable heap space. */
+    xMinimumEverFreeBytesRemaining = heapBLOCK_SIZE( pxFirstFreeBlock );
+    xFreeBytesRemaining = heapBLOCK_SIZE( pxFirstFreeBlock );
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t * pxHeapStats )
+{
+    HeapBlock_t * pxBlock;
+    UBaseType_t uxFL, uxSL;
+    size_t xBlocks = 0, xMaxSize = 0, xMinSize = ( size_t ) portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+    size_t xAllocations = 0, xFrees = 0, xCachedBytes = 0;
+
+    vTaskSuspendAll();
+    {
+        /* Free lists will be empty if the heap has not been initialised.  The
+         * heap is initialised automatically when the first allocation is made. */
+        for( uxFL = 0; uxFL < heapFL_COUNT; uxFL++ )
+        {
+            for( uxSL = 0; uxSL < heapSL_COUNT; uxSL++ )
+            {
+                for( pxBlock = pxFreeLists[ uxFL ][ uxSL ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFreeBlock )
+                {
+                    xBlocks++;
+
+                    if( heapBLOCK_SIZE( pxBlock ) > xMaxSize )
+                    {
+                        xMaxSize = heapBLOCK_SIZE( pxBlock );
+                    }
+
+                    if( heapBLOCK_SIZE( pxBlock ) < xMinSize )
+                    {
+                        xMinSize = heapBLOCK_SIZE( pxBlock );
+                    }
+                }
+            }
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+    pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+    pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+
+    #if ( configHEAP6_CORE_CACHE_DEPTH > 0 )
+    {
+        UBaseType_t uxCore;
+
+        /* Cached blocks are free bytes but not free blocks of the free lists. */
+        for( uxCore = 0; uxCore < configNUMBER_OF_CORES; uxCore++ )
+        {
+            xAllocations += xCoreCaches[ uxCore ].xAllocations;
+            xFrees += xCoreCaches[ uxCore ].xFrees;
+            xCachedBytes += xCoreCaches[ uxCore ].xCachedBytes;
+        }
+    }
+    #endif
+
+    taskENTER_CRITICAL();
+    {
+        pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining + xCachedBytes;
+        pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations + xAllocations;
+        pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees + xFrees;
+        pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Reset the state in this file. This state is normally initialized at start up.
+ * This function must be called by the application before restarting the
+ * scheduler.
+ */
+void vPortHeapResetState( void )
+{
+    pxEnd = NULL;
+
+    xFreeBytesRemaining = ( size_t ) 0U;
+    xMinimumEverFreeBytesRemaining = ( size_t ) 0U;
+    xNumberOfSuccessfulAllocations = ( size_t ) 0U;
+    xNumberOfSuccessfulFrees = ( size_t ) 0U;
+
+    #if ( configHEAP6_CORE_CACHE_DEPTH > 0 )
+    {
+        ( void ) memset( xCoreCaches, 0, sizeof( xCoreCaches ) );
+    }
+    #endif
+}
+/*-----------------------------------------------------------*/
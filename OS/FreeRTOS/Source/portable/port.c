@@ -33,6 +33,13 @@
 #include <stdio.h>
 #include "FreeRTOS.h"
 #include "task.h"
+#include "nmsis_rtos.h"
+#if defined(NUCLEI_SOFTIRQ) && (NUCLEI_SOFTIRQ == 1)
+#include "softirq_api.h"
+#endif
+#if defined(NUCLEI_GPROF_TASK) && (NUCLEI_GPROF_TASK == 1)
+#include "gprof_api.h"
+#endif
 
 // #define ENABLE_KERNEL_DEBUG
 
@@ -64,17 +71,11 @@
 #define portMTH_MASK                ( 0xFFUL )
 
 /* Constants required to set up the initial stack. */
-#define portINITIAL_MSTATUS         ( MSTATUS_MPP | MSTATUS_MPIE | MSTATUS_FS_INITIAL | MSTATUS_VS_INITIAL)
 #define portINITIAL_EXC_RETURN      ( 0xfffffffd )
 
 /* The systick is a 64-bit counter. */
 #define portMAX_BIT_NUMBER          ( SysTimer_MTIMER_Msk )
 
-/* A fiddle factor to estimate the number of SysTick counts that would have
-occurred while the SysTick counter is stopped during tickless idle
-calculations. */
-#define portMISSED_COUNTS_FACTOR    ( 45UL )
-
 /* Let the user override the pre-loading of the initial LR with the address of
 prvTaskExitError() in case it messes up unwinding of the stack in the
 debugger. */
@@ -115,7 +116,7 @@ variable. */
 #if ( configNUMBER_OF_CORES == 1 )
 UBaseType_t uxCriticalNesting = 0xaaaaaaaa;
 #else /* #if ( configNUMBER_OF_CORES == 1 ) */
-UBaseType_t uxCriticalNestings[ configNUMBER_OF_CORES ] = { 0 };
+PER_CPU_DEFINE( UBaseType_t, uxCriticalNestings );
 #endif /* #if ( configNUMBER_OF_CORES == 1 ) */
 
 
@@ -139,23 +140,26 @@ uint8_t uxMaxSysCallMTH = 255;
  * The number of SysTick increments that make up one tick period.
  */
 #if( configUSE_TICKLESS_IDLE == 1 )
-static TickType_t ulTimerCountsForOneTick = 0;
+static uint64_t ullTimerCountsForOneTick = 0;
 #endif /* configUSE_TICKLESS_IDLE */
 
 /*
  * The maximum number of tick periods that can be suppressed is limited by the
- * 24 bit resolution of the SysTick timer.
+ * 64 bit resolution of the SysTimer and the width of TickType_t.
  */
 #if( configUSE_TICKLESS_IDLE == 1 )
 static TickType_t xMaximumPossibleSuppressedTicks = 0;
 #endif /* configUSE_TICKLESS_IDLE */
 
 /*
- * Compensate for the CPU cycles that pass while the SysTick is stopped (low
- * power functionality only.
+ * The SysTimer value of next tick boundary. In tickless mode the tick interrupt
+ * is scheduled at absolute tick boundaries and the SysTimer is never stopped, so
+ * interrupt latency and sleep time never accumulate into tick drift, and a late
+ * tick interrupt is taken again at once instead of being lost.
  */
 #if( configUSE_TICKLESS_IDLE == 1 )
-static TickType_t ulStoppedTimerCompensation = 0;
+static uint64_t ullPortNextTickTime = 0;
+static PortTicklessStats_t xPortTicklessStats;
 #endif /* configUSE_TICKLESS_IDLE */
 
 /*
@@ -169,49 +173,59 @@ static uint8_t ucMaxSysCallPriority = 0;
 
 #if ( configNUMBER_OF_CORES > 1 )
 
-spin_lock_t hw_sync_locks[portRTOS_SPINLOCK_COUNT] = {0, 0};
+/* Task and ISR lock, each ticket lock is padded to its own cache line */
+TicketLock_Type xPortSpinLocks[portRTOS_SPINLOCK_COUNT];
+
+/* Recursion count of each lock held by one core, only accessed by the core itself,
+ * so it is a per-cpu variable instead of shared with the lock word */
+typedef struct {
+    uint8_t ucRecursion[portRTOS_SPINLOCK_COUNT];
+} __ALIGNED(__SMP_CACHELINE_SIZE) PortCoreLockState_t;
+
+static PER_CPU_DEFINE(PortCoreLockState_t, xPortCoreLockState);
+
+#if ( configPORT_STAGGER_TICK == 1 )
+/* Set by tick of boot core when the time slicing yield of the core is deferred,
+ * cleared by the core when it takes the yield */
+static volatile uint8_t ucPortSliceDue[configNUMBER_OF_CORES];
 
-/* Note this is a single method with uxAcquire parameter since we have
-* static vars, the method is always called with a compile time constant for
-* uxAcquire, and the compiler should do the right thing! */
-void vPortRecursiveLock(unsigned long ulLockNum, spin_lock_t *pxSpinLock, BaseType_t uxAcquire)
+/* Take the deferred time slicing yield of current core at once */
+static inline void prvPortTakeSliceDue(void)
 {
-    static uint8_t ucOwnedByCore[portMAX_CORE_COUNT];
-    static uint8_t ucRecursionCountByLock[portRTOS_SPINLOCK_COUNT];
+    BaseType_t xCoreID = portGET_CORE_ID();
+
+    if (ucPortSliceDue[xCoreID] != 0) {
+        ucPortSliceDue[xCoreID] = 0;
+        SysTimer_SetHartSWIRQ(xCoreID);
+        __RWMB();
+    }
+}
+#endif
 
+/* Note this is a single method with uxAcquire parameter since it is always
+* called with a compile time constant for uxAcquire, and the compiler should
+* do the right thing! Interrupts are already masked when it is called. */
+void vPortRecursiveLock(unsigned long ulLockNum, BaseType_t uxAcquire)
+{
     configASSERT(ulLockNum < portRTOS_SPINLOCK_COUNT);
-    unsigned long ulCoreNum = __get_hart_index();
-    unsigned long ulLockBit = 1u << ulLockNum;
-    configASSERT(ulLockBit < 256u);
+    uint8_t *pucRecursion = &PER_CPU(xPortCoreLockState).ucRecursion[ulLockNum];
 
     if (uxAcquire) {
-        if ((!*pxSpinLock == 0)) {
-            if (ucOwnedByCore[ulCoreNum] & ulLockBit) {
-                configASSERT(ucRecursionCountByLock[ulLockNum] != 255u);
-                ucRecursionCountByLock[ulLockNum]++;
-                return;
-            }
-
-            while ((!*pxSpinLock == 0)) {
-            }
+        if (*pucRecursion == 0) {
+#if ( configPORT_STAGGER_TICK == 1 )
+            /* The task of this core is already marked as yielding by the kernel, and
+            the kernel waits for the yield when the core enters critical section or
+            suspends scheduler, so it can't be deferred any more */
+            prvPortTakeSliceDue();
+#endif
+            TicketLock_Lock(&xPortSpinLocks[ulLockNum]);
         }
-
-        do {
-            if (__AMOSWAP_W(pxSpinLock, 1) == 0) {
-                break;
-            }
-        } while (1);
-
-        configASSERT(ucRecursionCountByLock[ulLockNum] == 0);
-        ucRecursionCountByLock[ulLockNum] = 1;
-        ucOwnedByCore[ulCoreNum] |= ulLockBit;
+        configASSERT(*pucRecursion != 255u);
+        (*pucRecursion)++;
     } else {
-        configASSERT((ucOwnedByCore[ulCoreNum] & ulLockBit) != 0);
-        configASSERT(ucRecursionCountByLock[ulLockNum] != 0);
-
-        if (!--ucRecursionCountByLock[ulLockNum]) {
-            ucOwnedByCore[ulCoreNum] &= ~ulLockBit;
-            *pxSpinLock = 0;
+        configASSERT(*pucRecursion != 0);
+        if (--(*pucRecursion) == 0) {
+            TicketLock_Unlock(&xPortSpinLocks[ulLockNum]);
         }
     }
 }
@@ -220,6 +234,56 @@ void vPortRecursiveLock(unsigned long ulLockNum, spin_lock_t *pxSpinLock, BaseTy
 static unsigned long ulSchedulerReady = 0;
 /*-----------------------------------------------------------*/
 
+#if ( configPORT_IDLE_SLEEP == 1 )
+/* Set while the core is sleeping in vPortIdleSleep(), only written by the core itself */
+static volatile uint8_t ucPortCoreSleeping[configNUMBER_OF_CORES];
+
+void vPortIdleSleep(void)
+{
+    BaseType_t xCoreID = portGET_CORE_ID();
+
+    ucPortCoreSleeping[xCoreID] = 1;
+    __RWMB();
+    /* Yield request of portYIELD_CORE is a pending software interrupt, so a
+    request sent before WFI will wake up the core at once and is never lost */
+    __WFI();
+    ucPortCoreSleeping[xCoreID] = 0;
+}
+#endif
+
+#if ( configPORT_IDLE_TICK_FILTER == 1 ) || ( configPORT_STAGGER_TICK == 1 )
+/* Set by tracePOST_MOVED_TASK_TO_READY_STATE, cleared when tick starts */
+volatile BaseType_t xPortTickReadied = pdFALSE;
+/* Set while xTaskIncrementTick() is running in tick interrupt of boot core */
+static volatile BaseType_t xPortInTick = pdFALSE;
+
+void vPortYieldCore(BaseType_t xCoreID)
+{
+    if ((xPortInTick != pdFALSE) && (xPortTickReadied == pdFALSE)) {
+#if ( configPORT_IDLE_TICK_FILTER == 1 )
+        /* When no task is made ready by this tick, the tick can only request a
+        sleeping idle core to yield for time slicing between idle tasks, which is
+        pointless and just contends the kernel locks, so let it keep sleeping */
+        if (ucPortCoreSleeping[xCoreID] != 0) {
+            return;
+        }
+#endif
+#if ( configPORT_STAGGER_TICK == 1 )
+        /* Only time slicing is requested, let the timer interrupt of the core
+        take it in its own slot of the tick period */
+        ucPortSliceDue[xCoreID] = 1;
+        SysTimer_SetHartCompareValue(SysTimer_GetLoadValue() + \
+                                     (SYSTICK_TICK_CONST / configNUMBER_OF_CORES) * xCoreID, xCoreID);
+        return;
+#endif
+    }
+    /* Set a software interrupt(SWI) to core x  to request a context switch. */
+    SysTimer_SetHartSWIRQ(xCoreID);
+    __RWMB();
+}
+#endif
+/*-----------------------------------------------------------*/
+
 /*
  * See header file for description.
  * As per the standard RISC-V ABI pxTopcOfStack is passed in in a0, pxCode in
@@ -282,27 +346,9 @@ static unsigned long ulSchedulerReady = 0;
 StackType_t* pxPortInitialiseStack(StackType_t* pxTopOfStack, TaskFunction_t pxCode, void* pvParameters)
 {
     /* Simulate the stack frame as it would be created by a context switch
-    interrupt. */
-
-    /* Offset added to account for the way the MCU uses the stack on entry/exit
-    of interrupts, and to ensure alignment. */
-    pxTopOfStack--;
-    *pxTopOfStack = portINITIAL_MSTATUS;    /* MSTATUS */
-
-    /* Save code space by skipping register initialisation. */
-#ifndef __riscv_32e
-    pxTopOfStack -= 22;    /* X11 - X31. */
-#else
-    pxTopOfStack -= 6;    /* X11 - X15. */
-#endif
-    *pxTopOfStack = (StackType_t) pvParameters;      /* X10/A0 */
-    pxTopOfStack -= 6; /* X5 - X9 */
-    *pxTopOfStack = (StackType_t) portTASK_RETURN_ADDRESS;      /* RA, X1 */
-
-    pxTopOfStack --;
-    *pxTopOfStack = ((StackType_t) pxCode) ;        /* PC */
-
-    return pxTopOfStack;
+    interrupt, frame layout is shared with other RTOS ports in nmsis_rtos.h. */
+    return (StackType_t *)__RV_FrameInit((unsigned long *)pxTopOfStack, (unsigned long)pxCode,
+                                         (unsigned long)pvParameters, (unsigned long)portTASK_RETURN_ADDRESS, 0);
 }
 /*-----------------------------------------------------------*/
 
@@ -377,6 +423,53 @@ static uint8_t prvCalcMaxSysCallMTH(uint8_t max_syscall_prio)
     return maxsyscallmth;
 }
 
+#if ( configPORT_STACK_GUARD == 1 )
+/* Provided by application, see configPORT_STACK_GUARD in portmacro.h */
+extern void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName);
+
+/* Load and store access fault handlers registered before the stack guard */
+static unsigned long ulPortAccessFaultHandlers[2];
+
+static void prvPortStackGuardFault(unsigned long mcause, unsigned long sp)
+{
+    unsigned long ulIndex = ((mcause & MCAUSE_CAUSE) == LdFault_EXCn) ? 0 : 1;
+    unsigned long ulGuard = __get_PMPADDRx(configPORT_STACK_GUARD_PMP_ENTRY);
+
+    ulGuard = (ulGuard & ~((unsigned long)(configPORT_STACK_GUARD_SIZE >> 3) - 1)) << PMP_SHIFT;
+    if ((__RV_CSR_READ(CSR_MTVAL) - ulGuard) < configPORT_STACK_GUARD_SIZE) {
+        /* Turn off the guard, so the hook can run on the overflowed stack */
+        __set_PMPxCFG(configPORT_STACK_GUARD_PMP_ENTRY, PMP_L);
+        vApplicationStackOverflowHook(xTaskGetCurrentTaskHandle(), pcTaskGetName(NULL));
+    } else if (ulPortAccessFaultHandlers[ulIndex] != 0) {
+        ((void (*)(unsigned long, unsigned long))ulPortAccessFaultHandlers[ulIndex])(mcause, sp);
+    }
+}
+
+/* Called by each core before its first task, pmpaddr of the guard is already
+set by traceTASK_SWITCHED_IN when vTaskStartScheduler selects the first task of
+boot core, other cores get the guard at their first task switch */
+static void prvPortSetupStackGuard(void)
+{
+    /* Rule locking bypass, it can only be set when no PMP entry is locked, and
+    mseccfg is an illegal CSR if Smepmp is not present */
+    __RV_CSR_SET(CSR_MSECCFG, MSECCFG_RLB);
+    configASSERT((__RV_CSR_READ(CSR_MSECCFG) & MSECCFG_RLB) != 0);
+    __set_PMPxCFG(configPORT_STACK_GUARD_PMP_ENTRY, PMP_L | PMP_A_NAPOT);
+
+#if ( configNUMBER_OF_CORES > 1 )
+    /* Exception handlers are shared by all cores */
+    if (__get_hart_index() != BOOT_HARTID) {
+        return;
+    }
+#endif
+    ulPortAccessFaultHandlers[0] = Exception_Get_EXC(LdFault_EXCn);
+    ulPortAccessFaultHandlers[1] = Exception_Get_EXC(StAccessFault_EXCn);
+    Exception_Register_EXC(LdFault_EXCn, (unsigned long)prvPortStackGuardFault);
+    Exception_Register_EXC(StAccessFault_EXCn, (unsigned long)prvPortStackGuardFault);
+}
+#endif
+/*-----------------------------------------------------------*/
+
 /*
  * See header file for description.
  */
@@ -418,6 +511,10 @@ BaseType_t xPortStartScheduler(void)
     /* Initialise base priority to zero. */
     vPortSetBASEPRI(0);
 
+#if ( configPORT_STACK_GUARD == 1 )
+    prvPortSetupStackGuard();
+#endif
+
     /* Start the first task. */
     prvPortStartFirstTask();
 
@@ -492,12 +589,36 @@ void vPortAssert(int32_t x)
 }
 /*-----------------------------------------------------------*/
 
+#if defined(NUCLEI_GPROF_TASK) && (NUCLEI_GPROF_TASK == 1)
+/* Task interrupted by gprof sample interrupt, see gprof_api.h of profiling
+middleware, samples taken before the scheduler starts belong to no task */
+const void *gprof_current_task(const char **name)
+{
+    TaskHandle_t xTask;
+
+    if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) {
+        return NULL;
+    }
+    xTask = xTaskGetCurrentTaskHandle();
+    if (xTask != NULL) {
+        *name = pcTaskGetName(xTask);
+    }
+    return xTask;
+}
+#endif
+/*-----------------------------------------------------------*/
+
 
 void xPortTaskSwitch(void)
 {
     portDISABLE_INTERRUPTS();
     /* Clear Software IRQ, A MUST */
     SysTimer_ClearSWIRQ();
+#if defined(NUCLEI_SOFTIRQ) && (NUCLEI_SOFTIRQ == 1)
+    /* Run deferred interrupt works sharing the software interrupt, they can
+    use FromISR APIs, and tasks woken by them are selected below directly. */
+    softirq_run();
+#endif
 #if ( configNUMBER_OF_CORES > 1 )
     vTaskSwitchContext( portGET_CORE_ID() );
 #else
@@ -507,16 +628,38 @@ void xPortTaskSwitch(void)
 }
 /*-----------------------------------------------------------*/
 
+/* Reload SysTimer for next tick interrupt */
+static inline void prvPortReloadTick(void)
+{
+#if( configUSE_TICKLESS_IDLE == 1 )
+    ullPortNextTickTime += ullTimerCountsForOneTick;
+    SysTimer_SetCompareValue(ullPortNextTickTime);
+#else
+    SysTick_Reload(SYSTICK_TICK_CONST);
+#endif
+}
+/*-----------------------------------------------------------*/
+
 void xPortSysTickHandler(void)
 {
     /* The SysTick runs at the lowest interrupt priority, so when this interrupt
     executes all interrupts must be unmasked.  There is therefore no need to
     save and then restore the interrupt mask value as its value is already
     known. */
+    traceISR_ENTER();
+#if ( configPORT_STAGGER_TICK == 1 )
+    /* Timer interrupt of secondary cores is the slot of deferred time slicing */
+    if (portGET_CORE_ID() != BOOT_HARTID) {
+        SysTimer_SetCompareValue(UINT64_MAX);
+        prvPortTakeSliceDue();
+        traceISR_EXIT();
+        return;
+    }
+#endif
 #if ( configNUMBER_OF_CORES == 1 )
     portDISABLE_INTERRUPTS();
     {
-        SysTick_Reload(SYSTICK_TICK_CONST);
+        prvPortReloadTick();
         /* Increment the RTOS tick. */
         if (xTaskIncrementTick() != pdFALSE) {
             /* A context switch is required.  Context switching is performed in
@@ -532,154 +675,144 @@ void xPortSysTickHandler(void)
      * critical section. */
     ulPreviousMask = taskENTER_CRITICAL_FROM_ISR();
     {
-        SysTick_Reload(SYSTICK_TICK_CONST);
+        prvPortReloadTick();
+#if ( configPORT_IDLE_TICK_FILTER == 1 ) || ( configPORT_STAGGER_TICK == 1 )
+        xPortTickReadied = pdFALSE;
+        xPortInTick = pdTRUE;
+#endif
         /* Increment the RTOS tick. */
         if (xTaskIncrementTick() != pdFALSE) {
             /* A context switch is required.  Context switching is performed in
             the SWI interrupt.  Pend the SWI interrupt. */
             portYIELD();
         }
+#if ( configPORT_IDLE_TICK_FILTER == 1 ) || ( configPORT_STAGGER_TICK == 1 )
+        xPortInTick = pdFALSE;
+#endif
     }
     taskEXIT_CRITICAL_FROM_ISR( ulPreviousMask );
 #endif
+    traceISR_EXIT();
 }
 /*-----------------------------------------------------------*/
 
 #if( configUSE_TICKLESS_IDLE == 1 )
 
+/*
+ * Called by configPRE_SLEEP_PROCESSING with interrupts disabled before sleep,
+ * application can override it to gate clocks and enter low power mode, for
+ * example on gd32vf103, disable unused peripheral clocks by rcu_periph_clock_disable,
+ * then call pmu_to_sleepmode(WFI_CMD) and set *pxExpectedIdleTime to 0 to tell
+ * the port that wfi is already executed.
+ */
+__attribute__((weak)) void vPortPreSleepProcessing(TickType_t *pxExpectedIdleTime)
+{
+    (void)pxExpectedIdleTime;
+}
+
+/*
+ * Called by configPOST_SLEEP_PROCESSING with interrupts disabled after wakeup,
+ * application can override it to restore the clocks gated in vPortPreSleepProcessing.
+ */
+__attribute__((weak)) void vPortPostSleepProcessing(TickType_t xExpectedIdleTime)
+{
+    (void)xExpectedIdleTime;
+}
+
+void vPortGetTicklessStats(PortTicklessStats_t *pxStats)
+{
+    __disable_irq();
+    *pxStats = xPortTicklessStats;
+    __enable_irq();
+}
+
 __attribute__((weak)) void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime)
 {
-    uint32_t ulReloadValue, ulCompleteTickPeriods, ulCompletedSysTickDecrements;
-    volatile TickType_t xModifiableIdleTime, xTickCountBeforeSleep, XLastLoadValue;
+    uint64_t ullSleepStart, ullNow;
+    TickType_t xModifiableIdleTime, xSleptTicks, xStepTicks;
+
+#if ( configNUMBER_OF_CORES > 1 )
+    /* The tick is only taken by boot core, other cores just sleep until interrupt */
+    if (__get_hart_index() != BOOT_HARTID) {
+        __WFI();
+        return;
+    }
+#endif
 
     FREERTOS_PORT_DEBUG("Enter TickLess %d\n", (uint32_t)xExpectedIdleTime);
 
-    /* Make sure the SysTick reload value does not overflow the counter. */
     if (xExpectedIdleTime > xMaximumPossibleSuppressedTicks) {
         xExpectedIdleTime = xMaximumPossibleSuppressedTicks;
     }
 
-    /* Stop the SysTick momentarily.  The time the SysTick is stopped for
-    is accounted for as best it can be, but using the tickless mode will
-    inevitably result in some tiny drift of the time maintained by the
-    kernel with respect to calendar time. */
-    SysTimer_Stop();
-
-    /* Calculate the reload value required to wait xExpectedIdleTime
-    tick periods.  -1 is used because this code will execute part way
-    through one of the tick periods. */
-    ulReloadValue = (ulTimerCountsForOneTick * (xExpectedIdleTime - 1UL));
-    if (ulReloadValue > ulStoppedTimerCompensation) {
-        ulReloadValue -= ulStoppedTimerCompensation;
-    }
-
     /* Enter a critical section but don't use the taskENTER_CRITICAL()
-    method as that will mask interrupts that should exit sleep mode. */
+    method as that will mask interrupts that should exit sleep mode,
+    wfi still wakes up on pending interrupt when interrupts are disabled. */
     __disable_irq();
 
     /* If a context switch is pending or a task is waiting for the scheduler
-    to be unsuspended then abandon the low power entry. */
+    to be unsuspended then abandon the low power entry, the tick interrupt
+    is untouched. */
     if (eTaskConfirmSleepModeStatus() == eAbortSleep) {
-        /* Restart from whatever is left in the count register to complete
-        this tick period. */
-        /* Restart SysTick. */
-        SysTimer_Start();
-
-        /* Reset the reload register to the value required for normal tick
-           periods. */
-        SysTick_Reload(ulTimerCountsForOneTick);
-
-        /* Re-enable interrupts - see comments above the cpsid instruction()
-           above. */
+        xPortTicklessStats.ulAborts++;
         __enable_irq();
-    } else {
-        xTickCountBeforeSleep = xTaskGetTickCount();
-
-        /* Set the new reload value. */
-        SysTick_Reload(ulReloadValue);
-
-        /* Get System timer load value before sleep */
-        XLastLoadValue = SysTimer_GetLoadValue();
-
-        /* Restart SysTick. */
-        SysTimer_Start();
-        ECLIC_EnableIRQ(SysTimer_IRQn);
-        __RWMB();
-
-        /* Sleep until something happens.  configPRE_SLEEP_PROCESSING() can
-        set its parameter to 0 to indicate that its implementation contains
-        its own wait for interrupt or wait for event instruction, and so wfi
-        should not be executed again.  However, the original expected idle
-        time variable must remain unmodified, so a copy is taken. */
-        xModifiableIdleTime = xExpectedIdleTime;
-        configPRE_SLEEP_PROCESSING(xModifiableIdleTime);
-        if (xModifiableIdleTime > 0) {
-            __WFI();
-        }
-        configPOST_SLEEP_PROCESSING(xExpectedIdleTime);
+        return;
+    }
 
-        /* Re-enable interrupts to allow the interrupt that brought the MCU
-        out of sleep mode to execute immediately. */
-        __enable_irq();
+    /* The pending tick boundary is the first idle tick, so wake up exactly at
+    the boundary of the last expected idle tick. */
+    SysTimer_SetCompareValue(ullPortNextTickTime + (uint64_t)(xExpectedIdleTime - 1UL) * ullTimerCountsForOneTick);
+    __RWMB();
+    ullSleepStart = SysTimer_GetLoadValue();
+
+    /* Sleep until something happens.  configPRE_SLEEP_PROCESSING() can
+    set its parameter to 0 to indicate that its implementation contains
+    its own wait for interrupt or wait for event instruction, and so wfi
+    should not be executed again.  However, the original expected idle
+    time variable must remain unmodified, so a copy is taken. */
+    xModifiableIdleTime = xExpectedIdleTime;
+    configPRE_SLEEP_PROCESSING(xModifiableIdleTime);
+    if (xModifiableIdleTime > 0) {
+        __WFI();
+    }
+    configPOST_SLEEP_PROCESSING(xExpectedIdleTime);
 
-        /* Make sure interrupt enable is executed */
-        __RWMB();
-        __FENCE_I();
-        __NOP();
-
-        /* Disable interrupts again because the clock is about to be stopped
-           and interrupts that execute while the clock is stopped will increase
-           any slippage between the time maintained by the RTOS and calendar
-           time. */
-        __disable_irq();
-
-        /* Disable the SysTick clock.  Again,
-           the time the SysTick is stopped for is accounted for as best it can
-           be, but using the tickless mode will inevitably result in some tiny
-           drift of the time maintained by the kernel with respect to calendar
-           time*/
-        ECLIC_DisableIRQ(SysTimer_IRQn);
+    /* SysTimer keeps counting during sleep, so the tick boundaries passed
+    are got from 64-bit mtime directly without any estimation. */
+    ullNow = SysTimer_GetLoadValue();
+    if (ullNow >= ullPortNextTickTime) {
+        xSleptTicks = (TickType_t)((ullNow - ullPortNextTickTime) / ullTimerCountsForOneTick) + 1;
+    } else {
+        xSleptTicks = 0;
+    }
 
-        /* Determine if SysTimer Interrupt is not yet happened,
-        (in which case an interrupt other than the SysTick
-        must have brought the system out of sleep mode). */
-        if (SysTimer_GetLoadValue() >= (XLastLoadValue + ulReloadValue)) {
-            /* As the pending tick will be processed as soon as this
-            function exits, the tick value maintained by the tick is stepped
-            forward by one less than the time spent waiting. */
-            ulCompleteTickPeriods = xExpectedIdleTime - 1UL;
-            FREERTOS_PORT_DEBUG("TickLess - SysTimer Interrupt Entered!\n");
-        } else {
-            /* Something other than the tick interrupt ended the sleep.
-            Work out how long the sleep lasted rounded to complete tick
-            periods (not the ulReload value which accounted for part
-            ticks). */
-            xModifiableIdleTime = SysTimer_GetLoadValue();
-            if (xModifiableIdleTime > XLastLoadValue) {
-                ulCompletedSysTickDecrements = (xModifiableIdleTime - XLastLoadValue);
-            } else {
-                ulCompletedSysTickDecrements = (xModifiableIdleTime + portMAX_BIT_NUMBER - XLastLoadValue);
-            }
-
-            /* How many complete tick periods passed while the processor
-            was waiting? */
-            ulCompleteTickPeriods = ulCompletedSysTickDecrements / ulTimerCountsForOneTick;
-
-            /* The reload value is set to whatever fraction of a single tick
-            period remains. */
-            SysTick_Reload(ulTimerCountsForOneTick);
-            FREERTOS_PORT_DEBUG("TickLess - External Interrupt Happened!\n");
+    /* The last passed tick is processed by the pending tick interrupt, the
+    others are stepped forward. Never step beyond the expected idle time as the
+    kernel requires, the remaining passed ticks are caught up by the tick
+    interrupt one by one since the compare value is already passed. */
+    xStepTicks = 0;
+    if (xSleptTicks > 0) {
+        xStepTicks = xSleptTicks - 1;
+        if (xStepTicks > xExpectedIdleTime - 1UL) {
+            xStepTicks = xExpectedIdleTime - 1UL;
         }
+    }
+    ullPortNextTickTime += (uint64_t)xStepTicks * ullTimerCountsForOneTick;
+    SysTimer_SetCompareValue(ullPortNextTickTime);
+    vTaskStepTick(xStepTicks);
 
-        FREERTOS_PORT_DEBUG("End TickLess %d\n", (uint32_t)ulCompleteTickPeriods);
+    xPortTicklessStats.ulSleeps++;
+    if (xSleptTicks < xExpectedIdleTime) {
+        xPortTicklessStats.ulEarlyWakeups++;
+    }
+    xPortTicklessStats.ullSleptTicks += xSleptTicks;
+    xPortTicklessStats.ullCompensatedTicks += xStepTicks;
+    xPortTicklessStats.ullSleptCounts += ullNow - ullSleepStart;
 
-        /* Restart SysTick */
-        vTaskStepTick(ulCompleteTickPeriods);
+    FREERTOS_PORT_DEBUG("End TickLess %d\n", (uint32_t)xStepTicks);
 
-        /* Exit with interrupts enabled. */
-        ECLIC_EnableIRQ(SysTimer_IRQn);
-        __enable_irq();
-    }
+    /* Exit with interrupts enabled, pending tick interrupt is taken now. */
+    __enable_irq();
 }
 
 #endif /* #if configUSE_TICKLESS_IDLE */
@@ -694,11 +827,17 @@ __attribute__((weak)) void vPortSetupTimerInterrupt(void)
     /* Calculate the constants required to configure the tick interrupt. */
 #if( configUSE_TICKLESS_IDLE == 1 )
     {
-        ulTimerCountsForOneTick = (SYSTICK_TICK_CONST);
-        xMaximumPossibleSuppressedTicks = portMAX_BIT_NUMBER / ulTimerCountsForOneTick;
-        ulStoppedTimerCompensation = portMISSED_COUNTS_FACTOR / (configCPU_CLOCK_HZ / configSYSTICK_CLOCK_HZ);
-        FREERTOS_PORT_DEBUG("CountsForOneTick, SuppressedTicks and TimerCompensation: %u, %u, %u\n", \
-                            (uint32_t)ulTimerCountsForOneTick, (uint32_t)xMaximumPossibleSuppressedTicks, (uint32_t)ulStoppedTimerCompensation);
+        uint64_t ullMaxTicks;
+
+        ullTimerCountsForOneTick = (SYSTICK_TICK_CONST);
+        /* Limit it to half of TickType_t range to keep tick count compare sane */
+        ullMaxTicks = portMAX_BIT_NUMBER / ullTimerCountsForOneTick;
+        if (ullMaxTicks > (portMAX_DELAY >> 1)) {
+            ullMaxTicks = portMAX_DELAY >> 1;
+        }
+        xMaximumPossibleSuppressedTicks = (TickType_t)ullMaxTicks;
+        FREERTOS_PORT_DEBUG("CountsForOneTick and SuppressedTicks: %u, %u\n", \
+                            (uint32_t)ullTimerCountsForOneTick, (uint32_t)xMaximumPossibleSuppressedTicks);
     }
 #endif /* configUSE_TICKLESS_IDLE */
     TickType_t ticks = SYSTICK_TICK_CONST;
@@ -711,11 +850,24 @@ __attribute__((weak)) void vPortSetupTimerInterrupt(void)
     if (1) {
 #endif
         SysTick_Config(ticks);
+#if( configUSE_TICKLESS_IDLE == 1 )
+        ullPortNextTickTime = SysTimer_GetCompareValue();
+#endif
         ECLIC_DisableIRQ(SysTimer_IRQn);
         ECLIC_SetLevelIRQ(SysTimer_IRQn, configKERNEL_INTERRUPT_PRIORITY);
         ECLIC_SetShvIRQ(SysTimer_IRQn, ECLIC_NON_VECTOR_INTERRUPT);
         ECLIC_EnableIRQ(SysTimer_IRQn);
     }
+#if ( configPORT_STAGGER_TICK == 1 )
+    else {
+        /* Timer of secondary cores is only armed by deferred time slicing */
+        SysTimer_SetCompareValue(UINT64_MAX);
+        ECLIC_DisableIRQ(SysTimer_IRQn);
+        ECLIC_SetLevelIRQ(SysTimer_IRQn, configKERNEL_INTERRUPT_PRIORITY);
+        ECLIC_SetShvIRQ(SysTimer_IRQn, ECLIC_NON_VECTOR_INTERRUPT);
+        ECLIC_EnableIRQ(SysTimer_IRQn);
+    }
+#endif
 
     /* Set SWI interrupt level to lowest level/priority, SysTimerSW as Vector Interrupt */
     ECLIC_SetShvIRQ(SysTimerSW_IRQn, ECLIC_VECTOR_INTERRUPT);
@@ -724,6 +876,20 @@ __attribute__((weak)) void vPortSetupTimerInterrupt(void)
 }
 /*-----------------------------------------------------------*/
 
+BaseType_t xPortRegisterVectorISR(IRQn_Type IRQn, uint8_t ucLevel, ECLIC_TRIGGER_Type xTrigger, void (*pxHandler)(void))
+{
+    /* Interrupts above max syscall level are not masked in critical section,
+    so they can't call FreeRTOS APIs */
+    if ((pxHandler == NULL) || (ucLevel > prvCheckMaxSysCallPrio(configMAX_SYSCALL_INTERRUPT_PRIORITY))) {
+        return pdFAIL;
+    }
+    if (ECLIC_Register_IRQ(IRQn, ECLIC_VECTOR_INTERRUPT, xTrigger, ucLevel, 0, (void *)pxHandler) != 0) {
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
 /*-----------------------------------------------------------*/
 
 #if( configASSERT_DEFINED == 1 )
@@ -771,3 +937,126 @@ void vPortValidateInterruptPriority(void)
 }
 
 #endif /* configASSERT_DEFINED */
+/*-----------------------------------------------------------*/
+
+#define portMEMPOOL_INDEX_MASK                  0xFFFFUL
+#define portMEMPOOL_TAG_ONE                     0x10000UL
+
+#if defined(__riscv_atomic)
+#define prvMemPoolCAS(addr, oldval, newval)     __CAS_W((addr), (oldval), (newval))
+#define prvMemPoolAdd(addr, value)              ((uint32_t)__AMOADD_W((volatile int32_t *)(addr), (value)))
+#else
+/* Without atomic extension, it can only be single core, masking interrupts is enough */
+static uint32_t prvMemPoolCAS(volatile uint32_t *addr, uint32_t oldval, uint32_t newval)
+{
+    UBaseType_t uxSavedStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    uint32_t result = *addr;
+
+    if (result == oldval) {
+        *addr = newval;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedStatus);
+    return result;
+}
+
+static uint32_t prvMemPoolAdd(volatile uint32_t *addr, int32_t value)
+{
+    UBaseType_t uxSavedStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    uint32_t result = *addr + value;
+
+    *addr = result;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedStatus);
+    return result;
+}
+#endif
+
+BaseType_t xPortMemPoolCreate(PortMemPool_t *pxPool, void *pvBuffer, uint32_t ulBlocks, size_t xBlockSize)
+{
+    uint32_t i;
+
+    xBlockSize = portMEMPOOL_BLOCK_SIZE(xBlockSize);
+    if ((pxPool == NULL) || (pvBuffer == NULL) || (ulBlocks == 0) || (ulBlocks > portMEMPOOL_MAX_BLOCKS) || \
+        (xBlockSize < sizeof(uint32_t)) || (((unsigned long)pvBuffer & portBYTE_ALIGNMENT_MASK) != 0)) {
+        return pdFAIL;
+    }
+    pxPool->pucBase = (uint8_t *)pvBuffer;
+    pxPool->xBlockSize = xBlockSize;
+    pxPool->ulBlocks = ulBlocks;
+    /* Link of each free block is index + 1 of next free block in its first word, 0 is the end */
+    for (i = 0; i < ulBlocks; i++) {
+        *(uint32_t *)(pxPool->pucBase + i * xBlockSize) = (i + 1 < ulBlocks) ? (i + 2) : 0;
+    }
+    pxPool->ulFree = ulBlocks;
+    pxPool->ulMinFree = ulBlocks;
+    __RWMB();
+    pxPool->ulHead = 1;
+    return pdPASS;
+}
+
+void *pvPortMemPoolGet(PortMemPool_t *pxPool)
+{
+    uint32_t ulHead, ulNext, ulFree, ulMinFree;
+    uint8_t *pucBlock;
+
+    configASSERT(pxPool != NULL);
+    do {
+        ulHead = pxPool->ulHead;
+        if ((ulHead & portMEMPOOL_INDEX_MASK) == 0) {
+            return NULL;
+        }
+        pucBlock = pxPool->pucBase + ((ulHead & portMEMPOOL_INDEX_MASK) - 1) * pxPool->xBlockSize;
+        /* The link may be overwritten when another context gets the block
+        first, then the tag of head is changed and the swap below fails */
+        ulNext = *(volatile uint32_t *)pucBlock;
+    } while (prvMemPoolCAS(&pxPool->ulHead, ulHead, ((ulHead + portMEMPOOL_TAG_ONE) & ~portMEMPOOL_INDEX_MASK) | ulNext) != ulHead);
+    __RWMB();
+
+    ulFree = prvMemPoolAdd(&pxPool->ulFree, -1);
+    ulMinFree = pxPool->ulMinFree;
+    while ((ulFree < ulMinFree) && (prvMemPoolCAS(&pxPool->ulMinFree, ulMinFree, ulFree) != ulMinFree)) {
+        ulMinFree = pxPool->ulMinFree;
+    }
+    return pucBlock;
+}
+
+void vPortMemPoolPut(PortMemPool_t *pxPool, void *pvBlock)
+{
+    uint32_t ulHead, ulIndex;
+    uint8_t *pucBlock = (uint8_t *)pvBlock;
+
+    configASSERT(pxPool != NULL);
+    if (pucBlock == NULL) {
+        return;
+    }
+    configASSERT((pucBlock >= pxPool->pucBase) && (pucBlock < pxPool->pucBase + pxPool->ulBlocks * pxPool->xBlockSize));
+    configASSERT(((size_t)(pucBlock - pxPool->pucBase) % pxPool->xBlockSize) == 0);
+    ulIndex = (uint32_t)((size_t)(pucBlock - pxPool->pucBase) / pxPool->xBlockSize) + 1;
+
+    /* Count it before it can be got again, so the free count never wraps below 0 */
+    prvMemPoolAdd(&pxPool->ulFree, 1);
+    do {
+        ulHead = pxPool->ulHead;
+        *(volatile uint32_t *)pucBlock = ulHead & portMEMPOOL_INDEX_MASK;
+        /* The block content and link must be visible before it is published */
+        __RWMB();
+    } while (prvMemPoolCAS(&pxPool->ulHead, ulHead, ((ulHead + portMEMPOOL_TAG_ONE) & ~portMEMPOOL_INDEX_MASK) | ulIndex) != ulHead);
+}
+
+/*
+ * newlib malloc lock, scheduler is suspended instead of disabling interrupts like the
+ * default one in SoC stubs, so malloc can't be called in interrupt handlers, same as
+ * heap_3.c, vTaskSuspendAll nests so the lock is recursive
+ */
+struct _reent;
+
+void __malloc_lock(struct _reent *reent)
+{
+    (void)reent;
+    vTaskSuspendAll();
+}
+
+void __malloc_unlock(struct _reent *reent)
+{
+    (void)reent;
+    (void)xTaskResumeAll();
+}
@@ -89,6 +89,39 @@ typedef uint64_t TickType_t;
 #define portYIELD_FROM_ISR( x )                     portEND_SWITCHING_ISR( x )
 /*-----------------------------------------------------------*/
 
+/* Vector ISR fast path.
+Non-vector interrupts enter the common handler, which saves all the caller saved
+registers and CSRs before calling the registered handler.  A vector ISR defined
+by portVECTOR_ISR() is entered directly from the vector table, the interrupt
+attribute makes the compiler save only the registers used by the handler.
+Context switch is always deferred to SysTimerSW interrupt in kernel level, so
+portYIELD_FROM_ISR() in vector ISR only pends it, and the full task context is
+saved only when a switch is requested, after all the nested ISRs returned.
+
+Usage:
+portVECTOR_ISR(uart0_vector_handler)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    portVECTOR_ISR_ENTER();
+    xQueueSendFromISR(xRxQueue, &ucByte, &xHigherPriorityTaskWoken);
+    portVECTOR_ISR_EXIT();
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+xPortRegisterVectorISR(UART0_IRQn, 1, ECLIC_LEVEL_TRIGGER, uart0_vector_handler);
+*/
+#define portVECTOR_ISR( xHandler )                  __INTERRUPT void xHandler( void )
+/* Save CSRs and enable interrupt, so higher level interrupts can nest, optional
+when the ISR doesn't need to be preempted */
+#define portVECTOR_ISR_ENTER()                      traceISR_ENTER(); SAVE_IRQ_CSR_CONTEXT()
+/* Disable interrupt and restore CSRs saved by portVECTOR_ISR_ENTER() */
+#define portVECTOR_ISR_EXIT()                       RESTORE_IRQ_CSR_CONTEXT(); traceISR_EXIT()
+
+/* Register a vector ISR which calls FreeRTOS FromISR APIs, ucLevel must not be
+larger than configMAX_SYSCALL_INTERRUPT_PRIORITY, return pdFAIL if not */
+extern BaseType_t xPortRegisterVectorISR(IRQn_Type IRQn, uint8_t ucLevel, ECLIC_TRIGGER_Type xTrigger, void (*pxHandler)(void));
+/*-----------------------------------------------------------*/
+
 
 #define portSET_INTERRUPT_MASK_FROM_ISR()       ulPortRaiseBASEPRI()
 #define portCLEAR_INTERRUPT_MASK_FROM_ISR(x)    vPortSetBASEPRI(x)
@@ -104,13 +137,266 @@ not necessary for to use this port.  They are defined so the common demo files
 #define portTASK_FUNCTION( vFunction, pvParameters )            void vFunction( void *pvParameters )
 /*-----------------------------------------------------------*/
 
+/* Run time stats use cpu cycle counter mcycle of current core as time base,
+so task run time is accurate to cycles rather than ticks, 64-bit counter type
+is used by default to avoid wrap around, it can be overridden in FreeRTOSConfig.h */
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+#ifndef configRUN_TIME_COUNTER_TYPE
+#define configRUN_TIME_COUNTER_TYPE                             uint64_t
+#endif
+#ifndef portGET_RUN_TIME_COUNTER_VALUE
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()                        __get_rv_cycle()
+#endif
+#endif
+/*-----------------------------------------------------------*/
+
+/* PMP stack guard, PMP entry configPORT_STACK_GUARD_PMP_ENTRY is a locked no
+access NAPOT region of configPORT_STACK_GUARD_SIZE bytes at the bottom of stack
+of the running task, it is moved by one pmpaddr write when a task is switched
+in, so an overflow faults at once, and vApplicationStackOverflowHook is called
+by the access fault handler installed in xPortStartScheduler.
+- locked entry is required to check machine mode tasks, it is reprogrammed with
+  mseccfg.RLB of Smepmp, so no other PMP entry can be locked before scheduler
+- the guard is carved from the stack, it takes up to twice of the size
+- the running task can't read its own guard, so configCHECK_FOR_STACK_OVERFLOW
+  2 and uxTaskGetStackHighWaterMark( NULL ) are not usable, use 1 if needed */
+#ifndef configPORT_STACK_GUARD
+#define configPORT_STACK_GUARD                                  0
+#endif
+#if ( configPORT_STACK_GUARD == 1 )
+#ifndef configPORT_STACK_GUARD_PMP_ENTRY
+#define configPORT_STACK_GUARD_PMP_ENTRY                        0
+#endif
+/* Power of 2 and at least 8 */
+#ifndef configPORT_STACK_GUARD_SIZE
+#define configPORT_STACK_GUARD_SIZE                             32
+#endif
+#if ( configPORT_STACK_GUARD_SIZE < 8 ) || ( ( configPORT_STACK_GUARD_SIZE & ( configPORT_STACK_GUARD_SIZE - 1 ) ) != 0 )
+#error "configPORT_STACK_GUARD_SIZE must be power of 2 and at least 8"
+#endif
+#if ( configCHECK_FOR_STACK_OVERFLOW > 1 ) || ( defined(NUCLEI_STACK_MONITOR) && ( NUCLEI_STACK_MONITOR == 1 ) )
+#error "configPORT_STACK_GUARD can't be used with stack pattern check of configCHECK_FOR_STACK_OVERFLOW 2 or NUCLEI_STACK_MONITOR"
+#endif
+#ifdef traceTASK_SWITCHED_IN
+#error "configPORT_STACK_GUARD uses traceTASK_SWITCHED_IN, it can't be defined by application"
+#endif
+#ifndef INCLUDE_xTaskGetCurrentTaskHandle
+#define INCLUDE_xTaskGetCurrentTaskHandle                       1
+#endif
+/* NAPOT pmpaddr of the first guard size aligned block in stack */
+#define portSTACK_GUARD_PMPADDR( ulStack )                      \
+    ( ( ( ( ( ulStack ) + configPORT_STACK_GUARD_SIZE - 1 ) & ~( unsigned long )( configPORT_STACK_GUARD_SIZE - 1 ) ) >> PMP_SHIFT ) | \
+      ( ( configPORT_STACK_GUARD_SIZE >> 3 ) - 1 ) )
+#define portSTACK_GUARD_SWITCHED_IN( pxTCB )                    \
+    __set_PMPADDRx( configPORT_STACK_GUARD_PMP_ENTRY, portSTACK_GUARD_PMPADDR( ( unsigned long )( pxTCB )->pxStack ) )
+#else
+#define portSTACK_GUARD_SWITCHED_IN( pxTCB )
+#endif
+/*-----------------------------------------------------------*/
+
+/* Binary event recorder, see rtostrace_api.h of profiling middleware, task
+switches, ready and priority inheritance events, the tick, and queue and
+semaphore operations are recorded into per-core ring buffers, interrupts are
+recorded by traceISR_ENTER/traceISR_EXIT, which are called by the SysTimer
+tick handler and portVECTOR_ISR_ENTER/portVECTOR_ISR_EXIT, and can be called
+in other interrupt handlers too */
+#if defined(NUCLEI_RTOS_TRACE) && (NUCLEI_RTOS_TRACE == 1)
+#include "rtostrace_api.h"
+#define portRTOSTRACE_TASK( xEvent, pxTCB )                     \
+    rtostrace_event( ( xEvent ), ( uint16_t )( pxTCB )->uxPriority, ( pxTCB ) )
+#define portRTOSTRACE_QUEUE( xEvent, pxQueue )                  \
+    rtostrace_event( ( xEvent ), ( uint16_t )( pxQueue )->uxMessagesWaiting, ( pxQueue ) )
+#define portRTOSTRACE_ISR( xEvent )                             \
+    rtostrace_event( ( xEvent ), ( uint16_t )( __RV_CSR_READ(CSR_MCAUSE) & MCAUSE_CAUSE ), NULL )
+#define portRTOSTRACE_TASK_CREATE( pxNewTCB )                   rtostrace_name( ( pxNewTCB ), ( pxNewTCB )->pcTaskName )
+
+#define traceTASK_SWITCHED_IN()                                 \
+    portRTOSTRACE_TASK( RTOSTRACE_TASK_SWITCHED_IN, pxCurrentTCB ); portSTACK_GUARD_SWITCHED_IN( pxCurrentTCB )
+#define traceTASK_SWITCHED_OUT()                                portRTOSTRACE_TASK( RTOSTRACE_TASK_SWITCHED_OUT, pxCurrentTCB )
+#define traceMOVED_TASK_TO_READY_STATE( pxTCB )                 portRTOSTRACE_TASK( RTOSTRACE_TASK_READY, pxTCB )
+#define traceTASK_PRIORITY_INHERIT( pxTCB, uxPriority )         \
+    rtostrace_event( RTOSTRACE_TASK_PRIO_INHERIT, ( uint16_t )( uxPriority ), ( pxTCB ) )
+#define traceTASK_PRIORITY_DISINHERIT( pxTCB, uxPriority )      \
+    rtostrace_event( RTOSTRACE_TASK_PRIO_DISINHERIT, ( uint16_t )( uxPriority ), ( pxTCB ) )
+#define traceTASK_INCREMENT_TICK( xTickCount )                  \
+    rtostrace_event( RTOSTRACE_TICK, ( uint16_t )( xTickCount ), NULL )
+#define traceISR_ENTER()                                        portRTOSTRACE_ISR( RTOSTRACE_ISR_ENTER )
+#define traceISR_EXIT()                                         portRTOSTRACE_ISR( RTOSTRACE_ISR_EXIT )
+#define traceISR_EXIT_TO_SCHEDULER()                            portRTOSTRACE_ISR( RTOSTRACE_ISR_EXIT )
+/* ucQueueType is the argument of prvInitialiseNewQueue where it is called */
+#define traceQUEUE_CREATE( pxNewQueue )                         \
+    rtostrace_event( RTOSTRACE_QUEUE_CREATE, ( uint16_t )ucQueueType, ( pxNewQueue ) )
+#define traceQUEUE_REGISTRY_ADD( xQueue, pcQueueName )          rtostrace_name( ( xQueue ), ( pcQueueName ) )
+#define traceQUEUE_SEND( pxQueue )                              portRTOSTRACE_QUEUE( RTOSTRACE_QUEUE_SEND, pxQueue )
+#define traceQUEUE_SEND_FROM_ISR( pxQueue )                     portRTOSTRACE_QUEUE( RTOSTRACE_QUEUE_SEND, pxQueue )
+#define traceQUEUE_SEND_FAILED( pxQueue )                       portRTOSTRACE_QUEUE( RTOSTRACE_QUEUE_SEND_FAILED, pxQueue )
+#define traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue )              portRTOSTRACE_QUEUE( RTOSTRACE_QUEUE_SEND_FAILED, pxQueue )
+#define traceBLOCKING_ON_QUEUE_SEND( pxQueue )                  portRTOSTRACE_QUEUE( RTOSTRACE_QUEUE_BLOCK_SEND, pxQueue )
+#define traceQUEUE_RECEIVE( pxQueue )                           portRTOSTRACE_QUEUE( RTOSTRACE_QUEUE_RECEIVE, pxQueue )
+#define traceQUEUE_RECEIVE_FROM_ISR( pxQueue )                  portRTOSTRACE_QUEUE( RTOSTRACE_QUEUE_RECEIVE, pxQueue )
+#define traceQUEUE_RECEIVE_FAILED( pxQueue )                    portRTOSTRACE_QUEUE( RTOSTRACE_QUEUE_RECEIVE_FAILED, pxQueue )
+#define traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue )           portRTOSTRACE_QUEUE( RTOSTRACE_QUEUE_RECEIVE_FAILED, pxQueue )
+#define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue )               portRTOSTRACE_QUEUE( RTOSTRACE_QUEUE_BLOCK_RECEIVE, pxQueue )
+#else
+#define portRTOSTRACE_TASK_CREATE( pxNewTCB )
+#endif
+/*-----------------------------------------------------------*/
+
+/* Stack high water mark monitor, see stackmon_api.h of profiling middleware,
+task stack is registered when task created, and pxEndOfStack is required to
+get the stack size, call stackmon_scan() in vApplicationIdleHook */
+#if defined(NUCLEI_STACK_MONITOR) && (NUCLEI_STACK_MONITOR == 1)
+#include "stackmon_api.h"
+#ifndef configRECORD_STACK_HIGH_ADDRESS
+#define configRECORD_STACK_HIGH_ADDRESS                         1
+#elif configRECORD_STACK_HIGH_ADDRESS != 1
+#error "configRECORD_STACK_HIGH_ADDRESS must be 1 when NUCLEI_STACK_MONITOR is enabled"
+#endif
+#ifndef traceTASK_CREATE
+#define traceTASK_CREATE( pxNewTCB )                            \
+    stackmon_register( ( pxNewTCB ), ( pxNewTCB )->pcTaskName, ( pxNewTCB )->pxStack, \
+                       ( unsigned long )( ( pxNewTCB )->pxEndOfStack - ( pxNewTCB )->pxStack + 1 ) * sizeof( StackType_t ), \
+                       ( void * )( pxNewTCB )->pxTopOfStack, STACKMON_PATTERN ); \
+    portRTOSTRACE_TASK_CREATE( pxNewTCB )
+#endif
+#ifndef traceTASK_DELETE
+#define traceTASK_DELETE( pxTaskToDelete )                      stackmon_unregister( ( pxTaskToDelete ) )
+#endif
+#endif
+
+/* Task aware gprof sampling, see gprof_api.h of profiling middleware, the
+sample interrupt finds the task it interrupted by gprof_current_task in port.c,
+which requires the scheduler state and current task handle APIs */
+#if defined(NUCLEI_GPROF_TASK) && (NUCLEI_GPROF_TASK == 1)
+#ifndef INCLUDE_xTaskGetSchedulerState
+#define INCLUDE_xTaskGetSchedulerState                          1
+#elif ( INCLUDE_xTaskGetSchedulerState != 1 ) && ( configUSE_TIMERS != 1 )
+#error "INCLUDE_xTaskGetSchedulerState must be 1 when NUCLEI_GPROF_TASK is enabled"
+#endif
+#ifndef INCLUDE_xTaskGetCurrentTaskHandle
+#define INCLUDE_xTaskGetCurrentTaskHandle                       1
+#endif
+#endif
+
+#if defined(NUCLEI_RTOS_TRACE) && (NUCLEI_RTOS_TRACE == 1) && !defined(traceTASK_CREATE)
+#define traceTASK_CREATE( pxNewTCB )                            portRTOSTRACE_TASK_CREATE( pxNewTCB )
+#endif
+
+#if ( configPORT_STACK_GUARD == 1 ) && !defined(traceTASK_SWITCHED_IN)
+#define traceTASK_SWITCHED_IN()                                 portSTACK_GUARD_SWITCHED_IN( pxCurrentTCB )
+#endif
+/*-----------------------------------------------------------*/
+
+/* Architecture specific optimisations, ready priorities are recorded in a
+bitmap of UBaseType_t, and the highest one is found with count leading zeros,
+which is clz instruction of Zbb extension, or de Bruijn sequence without Zbb */
+#ifndef configUSE_PORT_OPTIMISED_TASK_SELECTION
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION                 0
+#endif
+
+#if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 )
+/* Check the configuration. */
+#if ( configMAX_PRIORITIES > __RISCV_XLEN )
+#error "configUSE_PORT_OPTIMISED_TASK_SELECTION can only be set to 1 when configMAX_PRIORITIES is less than or equal to XLEN"
+#endif
+
+/* Store/clear the ready priorities in a bit map. */
+#define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities )      ( uxReadyPriorities ) |= ( 1UL << ( uxPriority ) )
+#define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities )       ( uxReadyPriorities ) &= ~( 1UL << ( uxPriority ) )
+
+#define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities )    uxTopPriority = __FLSL( ( uxReadyPriorities ) )
+#endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
+/*-----------------------------------------------------------*/
+
 /* Tickless idle/low power functionality. */
 #ifndef portSUPPRESS_TICKS_AND_SLEEP
 extern void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime);
 #define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )       vPortSuppressTicksAndSleep( xExpectedIdleTime )
 #endif
+
+#if ( configUSE_TICKLESS_IDLE == 1 )
+/* Weak sleep hooks in port.c for clock gating, can be overridden by application */
+#ifndef configPRE_SLEEP_PROCESSING
+extern void vPortPreSleepProcessing(TickType_t *pxExpectedIdleTime);
+#define configPRE_SLEEP_PROCESSING( x )                         vPortPreSleepProcessing( &( x ) )
+#endif
+#ifndef configPOST_SLEEP_PROCESSING
+extern void vPortPostSleepProcessing(TickType_t xExpectedIdleTime);
+#define configPOST_SLEEP_PROCESSING( x )                        vPortPostSleepProcessing( ( x ) )
+#endif
+
+/* Tickless idle statistics, got by vPortGetTicklessStats() */
+typedef struct {
+    uint32_t ulSleeps;                  /* Times of entering sleep */
+    uint32_t ulAborts;                  /* Times of sleep abandoned before entering */
+    uint32_t ulEarlyWakeups;            /* Times of woken up by other interrupts before expected time */
+    uint64_t ullSleptTicks;             /* Tick periods passed in sleep */
+    uint64_t ullCompensatedTicks;       /* Tick periods stepped forward by vTaskStepTick */
+    uint64_t ullSleptCounts;            /* SysTimer counts spent in sleep */
+} PortTicklessStats_t;
+
+extern void vPortGetTicklessStats(PortTicklessStats_t *pxStats);
+#endif
+/*-----------------------------------------------------------*/
+
+/* Idle sleep, vPortIdleSleep() can be called in vApplicationIdleHook and
+vApplicationPassiveIdleHook to enter WFI until an interrupt or yield request
+of portYIELD_CORE arrives instead of busy looping in idle task */
+#ifndef configPORT_IDLE_SLEEP
+#define configPORT_IDLE_SLEEP                                   0
+#endif
+/* Don't wake up sleeping idle cores for time slicing between idle tasks in tick
+interrupt, the tick is only taken by boot core in SMP, so idle secondary cores
+stay in WFI until a task is ready for them */
+#ifndef configPORT_IDLE_TICK_FILTER
+#define configPORT_IDLE_TICK_FILTER                             0
+#endif
+/* Stagger the time slicing of secondary cores in SMP, the tick of boot core
+only requests time slicing to a core when the tick made no task ready, then
+it is deferred by SysTimer compare of the core to (tick period / cores) * core
+id later, so cores don't release the task lock and contend the kernel locks at
+the same moment after each tick, yields for tasks made ready are not deferred */
+#ifndef configPORT_STAGGER_TICK
+#define configPORT_STAGGER_TICK                                 0
+#endif
+#if ( configPORT_STAGGER_TICK == 1 ) && ( configNUMBER_OF_CORES == 1 )
+#error "configPORT_STAGGER_TICK is only for SMP"
+#endif
+#if ( configPORT_IDLE_SLEEP == 1 )
+extern void vPortIdleSleep(void);
+#endif
 /*-----------------------------------------------------------*/
 
+/* Fixed-block memory pool like OSMemCreate/OSMemGet/OSMemPut of uC/OS-II,
+blocks are got and put in O(1) with compare and swap instead of lock, so
+pvPortMemPoolGet() and vPortMemPoolPut() can be called in both tasks and
+ISRs, and in any core of SMP */
+#define portMEMPOOL_MAX_BLOCKS                                  0xFFFFUL
+/* Size of each block in pool, aligned to portBYTE_ALIGNMENT */
+#define portMEMPOOL_BLOCK_SIZE( xSize )                         ( ( ( xSize ) + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+/* Size of buffer passed to xPortMemPoolCreate() for ulBlocks blocks of xSize bytes */
+#define portMEMPOOL_BUFFER_SIZE( ulBlocks, xSize )              ( ( ulBlocks ) * portMEMPOOL_BLOCK_SIZE( xSize ) )
+
+typedef struct {
+    volatile uint32_t ulHead;           /* Change tag in upper 16 bits, index + 1 of first free block in lower 16 bits */
+    volatile uint32_t ulFree;           /* Number of free blocks */
+    volatile uint32_t ulMinFree;        /* Minimum number of free blocks ever */
+    uint32_t ulBlocks;                  /* Number of blocks */
+    size_t xBlockSize;                  /* Size of each block */
+    uint8_t *pucBase;                   /* Start of the first block */
+} PortMemPool_t;
+
+/* Create pool of ulBlocks blocks of xBlockSize bytes in pvBuffer, pvBuffer
+must be aligned to portBYTE_ALIGNMENT and have portMEMPOOL_BUFFER_SIZE bytes,
+return pdFAIL if parameter is invalid */
+extern BaseType_t xPortMemPoolCreate(PortMemPool_t *pxPool, void *pvBuffer, uint32_t ulBlocks, size_t xBlockSize);
+/* Get a block from pool, return NULL if no free block */
+extern void *pvPortMemPoolGet(PortMemPool_t *pxPool);
+/* Put a block got by pvPortMemPoolGet() back to the pool */
+extern void vPortMemPoolPut(PortMemPool_t *pxPool, void *pvBlock);
+#define portMEMPOOL_GET_FREE( pxPool )                          ( ( pxPool )->ulFree )
+#define portMEMPOOL_GET_MIN_FREE( pxPool )                      ( ( pxPool )->ulMinFree )
 /*-----------------------------------------------------------*/
 
 #ifdef configASSERT
@@ -186,6 +472,21 @@ portFORCE_INLINE static void vPortSetBASEPRI(uint8_t ulNewMaskValue)
     #define portCLEAR_INTERRUPT_MASK( x )               vPortSetBASEPRI(x)
 
     /* Request the core ID x to yield. */
+    #if ( configPORT_IDLE_TICK_FILTER == 1 ) || ( configPORT_STAGGER_TICK == 1 )
+        /* Tick yield requests to cores sleeping in vPortIdleSleep() are dropped, and
+        those to other cores are deferred by configPORT_STAGGER_TICK when the tick
+        made no task ready, see vPortYieldCore() in port.c */
+        #if ( configPORT_IDLE_TICK_FILTER == 1 ) && ( configPORT_IDLE_SLEEP != 1 )
+            #error "configPORT_IDLE_TICK_FILTER requires configPORT_IDLE_SLEEP to be 1"
+        #endif
+        #ifdef tracePOST_MOVED_TASK_TO_READY_STATE
+            #error "configPORT_IDLE_TICK_FILTER and configPORT_STAGGER_TICK use tracePOST_MOVED_TASK_TO_READY_STATE, it can't be defined by application"
+        #endif
+        extern volatile BaseType_t xPortTickReadied;
+        extern void vPortYieldCore(BaseType_t xCoreID);
+        #define tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB )    xPortTickReadied = pdTRUE
+        #define portYIELD_CORE( x )                             vPortYieldCore( x )
+    #else
     #define portYIELD_CORE( x )              \
     {                                                                               \
         /* Set a software interrupt(SWI) to core x  to request a context switch. */ \
@@ -194,30 +495,35 @@ portFORCE_INLINE static void vPortSetBASEPRI(uint8_t ulNewMaskValue)
         within the specified behaviour for the architecture. */                     \
         __RWMB();                                                                   \
     }
+    #endif
 
     #define portRTOS_SPINLOCK_COUNT                     2
     /* Multi-core */
     #define portMAX_CORE_COUNT                          16
 
-    typedef volatile uint32_t spin_lock_t;
-    extern spin_lock_t hw_sync_locks[portRTOS_SPINLOCK_COUNT];
-    extern void vPortRecursiveLock(unsigned long ulLockNum, spin_lock_t *pxSpinLock, BaseType_t uxAcquire);
+    #if !defined(__riscv_atomic)
+        #error "RVA(atomic) extension is required for FreeRTOS SMP"
+    #endif
+    /* Task and ISR locks are fair ticket locks padded to cache line,
+     * recursion counts are kept in per-core storage */
+    extern TicketLock_Type xPortSpinLocks[portRTOS_SPINLOCK_COUNT];
+    extern void vPortRecursiveLock(unsigned long ulLockNum, BaseType_t uxAcquire);
 
     /* Acquire the TASK lock. TASK lock is a recursive lock.
      * It should be able to be locked by the same core multiple times. */
-    #define portGET_TASK_LOCK()                         vPortRecursiveLock( 1, &hw_sync_locks[1], pdTRUE )
+    #define portGET_TASK_LOCK()                         vPortRecursiveLock( 1, pdTRUE )
 
     /* Release the TASK lock. If a TASK lock is locked by the same core multiple times,
      * it should be released as many times as it is locked. */
-    #define portRELEASE_TASK_LOCK()                     vPortRecursiveLock( 1, &hw_sync_locks[1], pdFALSE )
+    #define portRELEASE_TASK_LOCK()                     vPortRecursiveLock( 1, pdFALSE )
 
     /* Acquire the ISR lock. ISR lock is a recursive lock.
      * It should be able to be locked by the same core multiple times. */
-   #define portGET_ISR_LOCK()                           vPortRecursiveLock( 0, &hw_sync_locks[0], pdTRUE )
+   #define portGET_ISR_LOCK()                           vPortRecursiveLock( 0, pdTRUE )
 
     /* Release the ISR lock. If a ISR lock is locked by the same core multiple times, \
      * it should be released as many times as it is locked. */
-    #define portRELEASE_ISR_LOCK()                      vPortRecursiveLock( 0, &hw_sync_locks[0], pdFALSE )
+    #define portRELEASE_ISR_LOCK()                      vPortRecursiveLock( 0, pdFALSE )
 
     extern void vTaskEnterCritical( void );
     extern void vTaskExitCritical( void );
@@ -229,11 +535,12 @@ portFORCE_INLINE static void vPortSetBASEPRI(uint8_t ulNewMaskValue)
     #define portEXIT_CRITICAL_FROM_ISR( x )             vTaskExitCriticalFromISR( x )
 
     /* Critical nesting count management. */
-    extern UBaseType_t uxCriticalNestings[ configNUMBER_OF_CORES ];
-    #define portGET_CRITICAL_NESTING_COUNT()            ( uxCriticalNestings[ portGET_CORE_ID() ] )
-    #define portSET_CRITICAL_NESTING_COUNT( x )         ( uxCriticalNestings[ portGET_CORE_ID() ] = ( x ) )
-    #define portINCREMENT_CRITICAL_NESTING_COUNT()      ( uxCriticalNestings[ portGET_CORE_ID() ]++ )
-    #define portDECREMENT_CRITICAL_NESTING_COUNT()      ( uxCriticalNestings[ portGET_CORE_ID() ]-- )
+    /* Per-cpu variable, a single tp relative access when per-cpu variables are in tp area */
+    PER_CPU_DECLARE( UBaseType_t, uxCriticalNestings );
+    #define portGET_CRITICAL_NESTING_COUNT()            ( PER_CPU( uxCriticalNestings ) )
+    #define portSET_CRITICAL_NESTING_COUNT( x )         ( PER_CPU( uxCriticalNestings ) = ( x ) )
+    #define portINCREMENT_CRITICAL_NESTING_COUNT()      ( PER_CPU( uxCriticalNestings )++ )
+    #define portDECREMENT_CRITICAL_NESTING_COUNT()      ( PER_CPU( uxCriticalNestings )-- )
 
 #endif /* if ( configNUMBER_OF_CORES > 1 ) */
 
@@ -210,6 +210,26 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
 static void prvCopyDataFromQueue( Queue_t * const pxQueue,
                                   void * const pvBuffer ) PRIVILEGED_FUNCTION;
 
+/*
+ * Copies up to uxItemCount items to the back of the queue, or out of the
+ * queue, and returns the number of items copied.  Used by the batch API.
+ */
+static UBaseType_t prvCopyItemsToQueue( Queue_t * const pxQueue,
+                                        const uint8_t * pucItems,
+                                        UBaseType_t uxItemCount ) PRIVILEGED_FUNCTION;
+
+static UBaseType_t prvCopyItemsFromQueue( Queue_t * const pxQueue,
+                                          uint8_t * pucBuffer,
+                                          UBaseType_t uxItemCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblocks at most one task waiting to receive after uxItemCount items were
+ * sent, or notifies the queue set once per item.  Returns pdTRUE if a task
+ * of higher priority was unblocked.
+ */
+static BaseType_t prvItemsSent( Queue_t * const pxQueue,
+                                UBaseType_t uxItemCount ) PRIVILEGED_FUNCTION;
+
 #if ( configUSE_QUEUE_SETS == 1 )
 
 /*
@@ -2132,6 +2152,378 @@ BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue,
 }
 /*-----------------------------------------------------------*/
 
+BaseType_t xQueueSendMultiple( QueueHandle_t xQueue,
+                               const void * const pvItemsToQueue,
+                               UBaseType_t uxItemCount,
+                               TickType_t xTicksToWait )
+{
+    BaseType_t xEntryTimeSet = pdFALSE;
+    UBaseType_t uxSent;
+    TimeOut_t xTimeOut;
+    Queue_t * const pxQueue = xQueue;
+
+    configASSERT( pxQueue );
+    configASSERT( pvItemsToQueue );
+    /* Semaphores and mutexes have no items to move in batch. */
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+    #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+    {
+        configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+    }
+    #endif
+
+    if( uxItemCount == ( UBaseType_t ) 0 )
+    {
+        return 0;
+    }
+
+    for( ; ; )
+    {
+        taskENTER_CRITICAL();
+        {
+            /* As many items as there is room for are sent in one critical
+             * section, and only one waiting task is unblocked for them. */
+            uxSent = prvCopyItemsToQueue( pxQueue, ( const uint8_t * ) pvItemsToQueue, uxItemCount );
+
+            if( uxSent > ( UBaseType_t ) 0 )
+            {
+                traceQUEUE_SEND( pxQueue );
+
+                if( prvItemsSent( pxQueue, uxSent ) != pdFALSE )
+                {
+                    /* Yes it is ok to do this from within the critical
+                     * section - the kernel takes care of that. */
+                    queueYIELD_IF_USING_PREEMPTION();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                taskEXIT_CRITICAL();
+
+                return ( BaseType_t ) uxSent;
+            }
+            else
+            {
+                if( xTicksToWait == ( TickType_t ) 0 )
+                {
+                    taskEXIT_CRITICAL();
+                    traceQUEUE_SEND_FAILED( pxQueue );
+
+                    return 0;
+                }
+                else if( xEntryTimeSet == pdFALSE )
+                {
+                    vTaskInternalSetTimeOutState( &xTimeOut );
+                    xEntryTimeSet = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        /* The queue is full, wait for room the same as xQueueGenericSend(). */
+        vTaskSuspendAll();
+        prvLockQueue( pxQueue );
+
+        if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+        {
+            if( prvIsQueueFull( pxQueue ) != pdFALSE )
+            {
+                traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+                vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
+                prvUnlockQueue( pxQueue );
+
+                if( xTaskResumeAll() == pdFALSE )
+                {
+                    taskYIELD_WITHIN_API();
+                }
+            }
+            else
+            {
+                /* Try again. */
+                prvUnlockQueue( pxQueue );
+                ( void ) xTaskResumeAll();
+            }
+        }
+        else
+        {
+            /* The timeout has expired. */
+            prvUnlockQueue( pxQueue );
+            ( void ) xTaskResumeAll();
+            traceQUEUE_SEND_FAILED( pxQueue );
+
+            return 0;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueSendMultipleFromISR( QueueHandle_t xQueue,
+                                      const void * const pvItemsToQueue,
+                                      UBaseType_t uxItemCount,
+                                      BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    UBaseType_t uxSent, uxLockCount, uxSavedInterruptStatus;
+    Queue_t * const pxQueue = xQueue;
+
+    configASSERT( pxQueue );
+    configASSERT( pvItemsToQueue );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+    /* See the comments in xQueueGenericSendFromISR(). */
+    portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+    uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+    {
+        const BaseType_t xQueueLocked = ( pxQueue->cTxLock != queueUNLOCKED ) ? pdTRUE : pdFALSE;
+
+        uxSent = prvCopyItemsToQueue( pxQueue, ( const uint8_t * ) pvItemsToQueue, uxItemCount );
+
+        if( uxSent > ( UBaseType_t ) 0 )
+        {
+            traceQUEUE_SEND_FROM_ISR( pxQueue );
+
+            /* The event list is not altered if the queue is locked.  This will
+             * be done when the queue is unlocked later. */
+            if( xQueueLocked == pdFALSE )
+            {
+                if( ( prvItemsSent( pxQueue, uxSent ) != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+                {
+                    *pxHigherPriorityTaskWoken = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                /* One lock count, so at most one task is unblocked at unlock,
+                 * except that a queue set is notified once per lock count, and
+                 * it must hold one handle for each item. */
+                uxLockCount = 1;
+
+                #if ( configUSE_QUEUE_SETS == 1 )
+                {
+                    if( pxQueue->pxQueueSetContainer != NULL )
+                    {
+                        uxLockCount = uxSent;
+                    }
+                }
+                #endif /* configUSE_QUEUE_SETS */
+
+                while( uxLockCount > ( UBaseType_t ) 0 )
+                {
+                    const int8_t cTxLock = pxQueue->cTxLock;
+
+                    prvIncrementQueueTxLock( pxQueue, cTxLock );
+                    uxLockCount--;
+                }
+            }
+        }
+        else
+        {
+            traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue );
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    return ( BaseType_t ) uxSent;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue,
+                                  void * const pvBuffer,
+                                  UBaseType_t uxItemCount,
+                                  TickType_t xTicksToWait )
+{
+    BaseType_t xEntryTimeSet = pdFALSE;
+    UBaseType_t uxReceived;
+    TimeOut_t xTimeOut;
+    Queue_t * const pxQueue = xQueue;
+
+    configASSERT( pxQueue );
+    configASSERT( pvBuffer );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+    #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+    {
+        configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+    }
+    #endif
+
+    if( uxItemCount == ( UBaseType_t ) 0 )
+    {
+        return 0;
+    }
+
+    for( ; ; )
+    {
+        taskENTER_CRITICAL();
+        {
+            /* As many items as are available are received in one critical
+             * section, and only one task waiting to send is unblocked. */
+            uxReceived = prvCopyItemsFromQueue( pxQueue, ( uint8_t * ) pvBuffer, uxItemCount );
+
+            if( uxReceived > ( UBaseType_t ) 0 )
+            {
+                traceQUEUE_RECEIVE( pxQueue );
+
+                if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
+                {
+                    if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+                    {
+                        queueYIELD_IF_USING_PREEMPTION();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                taskEXIT_CRITICAL();
+
+                return ( BaseType_t ) uxReceived;
+            }
+            else
+            {
+                if( xTicksToWait == ( TickType_t ) 0 )
+                {
+                    taskEXIT_CRITICAL();
+                    traceQUEUE_RECEIVE_FAILED( pxQueue );
+
+                    return 0;
+                }
+                else if( xEntryTimeSet == pdFALSE )
+                {
+                    vTaskInternalSetTimeOutState( &xTimeOut );
+                    xEntryTimeSet = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        /* The queue is empty, wait for data the same as xQueueReceive(). */
+        vTaskSuspendAll();
+        prvLockQueue( pxQueue );
+
+        if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+        {
+            if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+            {
+                traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+                vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+                prvUnlockQueue( pxQueue );
+
+                if( xTaskResumeAll() == pdFALSE )
+                {
+                    taskYIELD_WITHIN_API();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                /* The queue contains data again. */
+                prvUnlockQueue( pxQueue );
+                ( void ) xTaskResumeAll();
+            }
+        }
+        else
+        {
+            /* Timed out, loop back to read the data if there is any. */
+            prvUnlockQueue( pxQueue );
+            ( void ) xTaskResumeAll();
+
+            if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+            {
+                traceQUEUE_RECEIVE_FAILED( pxQueue );
+
+                return 0;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueReceiveMultipleFromISR( QueueHandle_t xQueue,
+                                         void * const pvBuffer,
+                                         UBaseType_t uxItemCount,
+                                         BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    UBaseType_t uxReceived, uxSavedInterruptStatus;
+    Queue_t * const pxQueue = xQueue;
+
+    configASSERT( pxQueue );
+    configASSERT( pvBuffer );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+    /* See the comments in xQueueReceiveFromISR(). */
+    portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+    uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+    {
+        const int8_t cRxLock = pxQueue->cRxLock;
+
+        uxReceived = prvCopyItemsFromQueue( pxQueue, ( uint8_t * ) pvBuffer, uxItemCount );
+
+        if( uxReceived > ( UBaseType_t ) 0 )
+        {
+            traceQUEUE_RECEIVE_FROM_ISR( pxQueue );
+
+            if( cRxLock == queueUNLOCKED )
+            {
+                if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
+                {
+                    if( ( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+                    {
+                        *pxHigherPriorityTaskWoken = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                /* One lock count, so at most one task is unblocked at unlock. */
+                prvIncrementQueueRxLock( pxQueue, cRxLock );
+            }
+        }
+        else
+        {
+            traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue );
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    return ( BaseType_t ) uxReceived;
+}
+/*-----------------------------------------------------------*/
+
 BaseType_t xQueuePeekFromISR( QueueHandle_t xQueue,
                               void * const pvBuffer )
 {
@@ -2491,6 +2883,89 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue,
 }
 /*-----------------------------------------------------------*/
 
+static UBaseType_t prvCopyItemsToQueue( Queue_t * const pxQueue,
+                                        const uint8_t * pucItems,
+                                        UBaseType_t uxItemCount )
+{
+    UBaseType_t uxCount, x;
+
+    /* This function is called from a critical section. */
+    uxCount = configMIN( uxItemCount, pxQueue->uxLength - pxQueue->uxMessagesWaiting );
+
+    for( x = 0; x < uxCount; x++ )
+    {
+        /* Items are never mutexes, so no priority is disinherited here. */
+        ( void ) prvCopyDataToQueue( pxQueue, pucItems, queueSEND_TO_BACK );
+        pucItems += pxQueue->uxItemSize;
+    }
+
+    return uxCount;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvCopyItemsFromQueue( Queue_t * const pxQueue,
+                                          uint8_t * pucBuffer,
+                                          UBaseType_t uxItemCount )
+{
+    UBaseType_t uxCount, x;
+
+    /* This function is called from a critical section. */
+    uxCount = configMIN( uxItemCount, pxQueue->uxMessagesWaiting );
+
+    for( x = 0; x < uxCount; x++ )
+    {
+        prvCopyDataFromQueue( pxQueue, pucBuffer );
+        pucBuffer += pxQueue->uxItemSize;
+    }
+
+    pxQueue->uxMessagesWaiting = ( UBaseType_t ) ( pxQueue->uxMessagesWaiting - uxCount );
+
+    return uxCount;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvItemsSent( Queue_t * const pxQueue,
+                                UBaseType_t uxItemCount )
+{
+    BaseType_t xReturn = pdFALSE;
+
+    #if ( configUSE_QUEUE_SETS == 1 )
+        if( pxQueue->pxQueueSetContainer != NULL )
+        {
+            /* The queue set holds one handle for each item in the queue. */
+            while( uxItemCount > ( UBaseType_t ) 0 )
+            {
+                if( prvNotifyQueueSetContainer( pxQueue ) != pdFALSE )
+                {
+                    xReturn = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                uxItemCount--;
+            }
+        }
+        else
+    #endif /* configUSE_QUEUE_SETS */
+    {
+        ( void ) uxItemCount;
+
+        if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+        {
+            xReturn = xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
 static void prvUnlockQueue( Queue_t * const pxQueue )
 {
     /* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED. */
@@ -326,6 +326,42 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
                                           StreamBufferCallbackFunction_t pxSendCompletedCallback,
                                           StreamBufferCallbackFunction_t pxReceiveCompletedCallback ) PRIVILEGED_FUNCTION;
 
+/*
+ * Used by the zero copy API.  Blocks until xRequiredSpace bytes are free, or
+ * until more than xBytesToStoreMessageLength bytes are in the buffer, for at
+ * most xTicksToWait, then returns the free or available bytes.
+ */
+static size_t prvWaitForSpace( StreamBuffer_t * const pxStreamBuffer,
+                               size_t xRequiredSpace,
+                               TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+static size_t prvWaitForData( StreamBuffer_t * const pxStreamBuffer,
+                              size_t xBytesToStoreMessageLength,
+                              TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * Describes xCount bytes of the buffer storage area starting at xIndex as one
+ * or two segments, the second one is used when the bytes wrap around.
+ */
+static void prvGetSegments( const StreamBuffer_t * const pxStreamBuffer,
+                            size_t xIndex,
+                            size_t xCount,
+                            StreamBufferSegments_t * const pxSegments ) PRIVILEGED_FUNCTION;
+
+/*
+ * Moves xHead over xCount bytes written in place, and returns xCount.  For a
+ * message buffer the length of the message is written first.
+ */
+static size_t prvCommitBytes( StreamBuffer_t * const pxStreamBuffer,
+                              size_t xCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Moves xTail over xCount bytes read in place, and returns xCount.  For a
+ * message buffer the whole next message is removed.
+ */
+static size_t prvReleaseBytes( StreamBuffer_t * const pxStreamBuffer,
+                               size_t xCount ) PRIVILEGED_FUNCTION;
+
 /*-----------------------------------------------------------*/
     #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
     StreamBufferHandle_t xStreamBufferGenericCreate( size_t xBufferSizeBytes,
@@ -1473,6 +1509,477 @@ BaseType_t xStreamBufferReceiveCompletedFromISR( StreamBufferHandle_t xStreamBuf
 }
 /*-----------------------------------------------------------*/
 
+static size_t prvWaitForSpace( StreamBuffer_t * const pxStreamBuffer,
+                               size_t xRequiredSpace,
+                               TickType_t xTicksToWait )
+{
+    TimeOut_t xTimeOut;
+
+    if( xTicksToWait != ( TickType_t ) 0 )
+    {
+        vTaskSetTimeOutState( &xTimeOut );
+
+        do
+        {
+            /* Checking the space and clearing the notification state must be
+             * performed atomically, the same as xStreamBufferSend(). */
+            taskENTER_CRITICAL();
+            {
+                if( xStreamBufferSpacesAvailable( pxStreamBuffer ) < xRequiredSpace )
+                {
+                    ( void ) xTaskNotifyStateClearIndexed( NULL, pxStreamBuffer->uxNotificationIndex );
+
+                    /* Should only be one writer. */
+                    configASSERT( pxStreamBuffer->xTaskWaitingToSend == NULL );
+                    pxStreamBuffer->xTaskWaitingToSend = xTaskGetCurrentTaskHandle();
+                }
+                else
+                {
+                    taskEXIT_CRITICAL();
+                    break;
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            traceBLOCKING_ON_STREAM_BUFFER_SEND( pxStreamBuffer );
+            ( void ) xTaskNotifyWaitIndexed( pxStreamBuffer->uxNotificationIndex, ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+            pxStreamBuffer->xTaskWaitingToSend = NULL;
+        } while( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return xStreamBufferSpacesAvailable( pxStreamBuffer );
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvWaitForData( StreamBuffer_t * const pxStreamBuffer,
+                              size_t xBytesToStoreMessageLength,
+                              TickType_t xTicksToWait )
+{
+    size_t xBytesAvailable;
+
+    if( xTicksToWait != ( TickType_t ) 0 )
+    {
+        /* Checking if there is data and clearing the notification state must be
+         * performed atomically, the same as xStreamBufferReceive(). */
+        taskENTER_CRITICAL();
+        {
+            xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+
+            if( xBytesAvailable <= xBytesToStoreMessageLength )
+            {
+                ( void ) xTaskNotifyStateClearIndexed( NULL, pxStreamBuffer->uxNotificationIndex );
+
+                /* Should only be one reader. */
+                configASSERT( pxStreamBuffer->xTaskWaitingToReceive == NULL );
+                pxStreamBuffer->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( xBytesAvailable <= xBytesToStoreMessageLength )
+        {
+            traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( pxStreamBuffer );
+            ( void ) xTaskNotifyWaitIndexed( pxStreamBuffer->uxNotificationIndex, ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+            pxStreamBuffer->xTaskWaitingToReceive = NULL;
+
+            /* Recheck the data available after blocking. */
+            xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+    }
+
+    return xBytesAvailable;
+}
+/*-----------------------------------------------------------*/
+
+static void prvGetSegments( const StreamBuffer_t * const pxStreamBuffer,
+                            size_t xIndex,
+                            size_t xCount,
+                            StreamBufferSegments_t * const pxSegments )
+{
+    size_t xFirstLength;
+
+    configASSERT( xIndex < pxStreamBuffer->xLength );
+    configASSERT( xCount < pxStreamBuffer->xLength );
+
+    xFirstLength = configMIN( pxStreamBuffer->xLength - xIndex, xCount );
+
+    pxSegments->pucFirst = &( pxStreamBuffer->pucBuffer[ xIndex ] );
+    pxSegments->xFirstLength = xFirstLength;
+
+    if( xCount > xFirstLength )
+    {
+        /* The bytes wrap around to the start of the buffer. */
+        pxSegments->pucSecond = pxStreamBuffer->pucBuffer;
+        pxSegments->xSecondLength = xCount - xFirstLength;
+    }
+    else
+    {
+        pxSegments->pucSecond = NULL;
+        pxSegments->xSecondLength = 0;
+    }
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReserve( StreamBufferHandle_t xStreamBuffer,
+                             size_t xMaxLengthBytes,
+                             StreamBufferSegments_t * const pxSegments,
+                             TickType_t xTicksToWait )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    size_t xReturn = 0, xSpace, xHead;
+    size_t xRequiredSpace = xMaxLengthBytes;
+    size_t xMaxReportedSpace, xBytesToStoreMessageLength = 0;
+
+    configASSERT( pxStreamBuffer );
+    configASSERT( pxSegments );
+    configASSERT( xMaxLengthBytes > ( size_t ) 0 );
+
+    /* The maximum amount of space a stream buffer will ever report is its length
+     * minus 1. */
+    xMaxReportedSpace = pxStreamBuffer->xLength - ( size_t ) 1;
+
+    if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+    {
+        /* Space for the length of the message is reserved in front of the
+         * data, and the whole message must fit. */
+        xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+        xRequiredSpace += sbBYTES_TO_STORE_MESSAGE_LENGTH;
+
+        /* Overflow? */
+        configASSERT( xRequiredSpace > xMaxLengthBytes );
+
+        if( xRequiredSpace > xMaxReportedSpace )
+        {
+            /* The message would not fit even if the entire buffer was empty,
+             * so don't wait for space. */
+            xTicksToWait = ( TickType_t ) 0;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else if( xRequiredSpace > xMaxReportedSpace )
+    {
+        xRequiredSpace = xMaxReportedSpace;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    xSpace = prvWaitForSpace( pxStreamBuffer, xRequiredSpace, xTicksToWait );
+
+    if( xBytesToStoreMessageLength != ( size_t ) 0 )
+    {
+        if( xSpace >= xRequiredSpace )
+        {
+            xReturn = xMaxLengthBytes;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        xReturn = configMIN( xSpace, xMaxLengthBytes );
+    }
+
+    xHead = pxStreamBuffer->xHead + xBytesToStoreMessageLength;
+
+    if( xHead >= pxStreamBuffer->xLength )
+    {
+        xHead -= pxStreamBuffer->xLength;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    prvGetSegments( pxStreamBuffer, xHead, xReturn, pxSegments );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvCommitBytes( StreamBuffer_t * const pxStreamBuffer,
+                              size_t xCount )
+{
+    configMESSAGE_BUFFER_LENGTH_TYPE xMessageLength;
+    size_t xHead = pxStreamBuffer->xHead;
+
+    if( xCount != ( size_t ) 0 )
+    {
+        if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+        {
+            configASSERT( ( xCount + sbBYTES_TO_STORE_MESSAGE_LENGTH ) <= xStreamBufferSpacesAvailable( pxStreamBuffer ) );
+
+            /* The data is already in place, write the length in front of it. */
+            xMessageLength = ( configMESSAGE_BUFFER_LENGTH_TYPE ) xCount;
+            configASSERT( ( size_t ) xMessageLength == xCount );
+            xHead = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) &xMessageLength, sbBYTES_TO_STORE_MESSAGE_LENGTH, xHead );
+        }
+        else
+        {
+            configASSERT( xCount <= xStreamBufferSpacesAvailable( pxStreamBuffer ) );
+        }
+
+        xHead += xCount;
+
+        if( xHead >= pxStreamBuffer->xLength )
+        {
+            xHead -= pxStreamBuffer->xLength;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        /* The reader can see the data once xHead is updated. */
+        pxStreamBuffer->xHead = xHead;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return xCount;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferCommit( StreamBufferHandle_t xStreamBuffer,
+                            size_t xBytesWritten )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    size_t xReturn;
+
+    configASSERT( pxStreamBuffer );
+
+    xReturn = prvCommitBytes( pxStreamBuffer, xBytesWritten );
+
+    if( xReturn > ( size_t ) 0 )
+    {
+        traceSTREAM_BUFFER_SEND( xStreamBuffer, xReturn );
+
+        /* Was a task waiting for the data? */
+        if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+        {
+            prvSEND_COMPLETED( pxStreamBuffer );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+                                   size_t xBytesWritten,
+                                   BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    size_t xReturn;
+
+    configASSERT( pxStreamBuffer );
+
+    xReturn = prvCommitBytes( pxStreamBuffer, xBytesWritten );
+
+    if( xReturn > ( size_t ) 0 )
+    {
+        /* Was a task waiting for the data? */
+        if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+        {
+            prvSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xReturn );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferAcquire( StreamBufferHandle_t xStreamBuffer,
+                             StreamBufferSegments_t * const pxSegments,
+                             TickType_t xTicksToWait )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    size_t xReturn = 0, xBytesAvailable, xBytesToStoreMessageLength;
+    configMESSAGE_BUFFER_LENGTH_TYPE xMessageLength;
+    size_t xTail;
+
+    configASSERT( pxStreamBuffer );
+    configASSERT( pxSegments );
+
+    /* The same wait condition as xStreamBufferReceive(). */
+    if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+    {
+        xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+    }
+    else if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_BATCHING_BUFFER ) != ( uint8_t ) 0 )
+    {
+        xBytesToStoreMessageLength = pxStreamBuffer->xTriggerLevelBytes;
+    }
+    else
+    {
+        xBytesToStoreMessageLength = 0;
+    }
+
+    xBytesAvailable = prvWaitForData( pxStreamBuffer, xBytesToStoreMessageLength, xTicksToWait );
+    xTail = pxStreamBuffer->xTail;
+
+    if( xBytesAvailable > xBytesToStoreMessageLength )
+    {
+        if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+        {
+            /* Only the next message is acquired, it starts after its length. */
+            xTail = prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xMessageLength, sbBYTES_TO_STORE_MESSAGE_LENGTH, xTail );
+            xReturn = ( size_t ) xMessageLength;
+        }
+        else
+        {
+            xReturn = xBytesAvailable;
+        }
+    }
+    else
+    {
+        traceSTREAM_BUFFER_RECEIVE_FAILED( xStreamBuffer );
+    }
+
+    prvGetSegments( pxStreamBuffer, xTail, xReturn, pxSegments );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvReleaseBytes( StreamBuffer_t * const pxStreamBuffer,
+                               size_t xCount )
+{
+    configMESSAGE_BUFFER_LENGTH_TYPE xMessageLength;
+    size_t xTail = pxStreamBuffer->xTail;
+
+    if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+    {
+        if( prvBytesInBuffer( pxStreamBuffer ) > sbBYTES_TO_STORE_MESSAGE_LENGTH )
+        {
+            xTail = prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xMessageLength, sbBYTES_TO_STORE_MESSAGE_LENGTH, xTail );
+
+            /* A message is always released as a whole. */
+            configASSERT( xCount == ( size_t ) xMessageLength );
+            xCount = ( size_t ) xMessageLength;
+        }
+        else
+        {
+            xCount = 0;
+        }
+    }
+    else
+    {
+        configASSERT( xCount <= prvBytesInBuffer( pxStreamBuffer ) );
+    }
+
+    xTail += xCount;
+
+    if( xTail >= pxStreamBuffer->xLength )
+    {
+        xTail -= pxStreamBuffer->xLength;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    /* The writer can reuse the space once xTail is updated. */
+    pxStreamBuffer->xTail = xTail;
+
+    return xCount;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferRelease( StreamBufferHandle_t xStreamBuffer,
+                             size_t xBytesRead )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    size_t xReturn;
+
+    configASSERT( pxStreamBuffer );
+
+    xReturn = prvReleaseBytes( pxStreamBuffer, xBytesRead );
+
+    /* Was a task waiting for space in the buffer? */
+    if( xReturn != ( size_t ) 0 )
+    {
+        traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xReturn );
+        prvRECEIVE_COMPLETED( pxStreamBuffer );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReleaseFromISR( StreamBufferHandle_t xStreamBuffer,
+                                    size_t xBytesRead,
+                                    BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    size_t xReturn;
+
+    configASSERT( pxStreamBuffer );
+
+    xReturn = prvReleaseBytes( pxStreamBuffer, xBytesRead );
+
+    /* Was a task waiting for space in the buffer? */
+    if( xReturn != ( size_t ) 0 )
+    {
+        prvRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReturn );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
 static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer,
                                      const uint8_t * pucData,
                                      size_t xCount,
@@ -243,6 +243,20 @@
 
 /*-----------------------------------------------------------*/
 
+/* Add a task to a delayed list, remove it from its delayed list if it is in
+ * one, and get the task with the earliest wake time of a non empty delayed list. */
+#if ( configUSE_DELAYED_TASK_HEAP == 1 )
+    #define taskINSERT_DELAYED_LIST( pxList, pxTCB )    prvDelayedHeapInsert( ( pxList ), ( pxTCB ) )
+    #define taskDELAYED_HEAP_REMOVE( pxTCB )            prvDelayedHeapRemove( pxTCB )
+    #define taskGET_DELAYED_LIST_HEAD( pxList )         ( *taskDELAYED_HEAP_OF( pxList ) )
+#else
+    #define taskINSERT_DELAYED_LIST( pxList, pxTCB )    vListInsert( ( pxList ), &( ( pxTCB )->xStateListItem ) )
+    #define taskDELAYED_HEAP_REMOVE( pxTCB )
+    #define taskGET_DELAYED_LIST_HEAD( pxList )         listGET_OWNER_OF_HEAD_ENTRY( pxList )
+#endif
+
+/*-----------------------------------------------------------*/
+
 /* pxDelayedTaskList and pxOverflowDelayedTaskList are switched when the tick
  * count overflows. */
 #define taskSWITCH_DELAYED_LISTS()                                                \
@@ -433,6 +447,12 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
     #if ( configUSE_POSIX_ERRNO == 1 )
         int iTaskErrno;
     #endif
+
+    #if ( configUSE_DELAYED_TASK_HEAP == 1 )
+        struct tskTaskControlBlock * pxHeapChild; /**< First child of the task in the pairing heap of its delayed list. */
+        struct tskTaskControlBlock * pxHeapNext;  /**< Next sibling of the task in the pairing heap. */
+        struct tskTaskControlBlock * pxHeapPrev;  /**< Previous sibling of the task, or its parent if it is the first child. */
+    #endif
 } tskTCB;
 
 /* The old tskTCB name is maintained above then typedefed to the new TCB_t name
@@ -463,6 +483,19 @@ PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;              /**< Po
 PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;      /**< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
 PRIVILEGED_DATA static List_t xPendingReadyList;                         /**< Tasks that have been readied while the scheduler was suspended.  They will be moved to the ready list when the scheduler is resumed. */
 
+#if ( configUSE_DELAYED_TASK_HEAP == 1 )
+
+/* When configUSE_DELAYED_TASK_HEAP is 1 the delayed lists are unsorted, and the
+ * tasks of xDelayedTaskList1 and xDelayedTaskList2 are also linked through their
+ * TCBs in the pairing heaps pxDelayedTaskHeaps[ 0 ] and [ 1 ], whose root is the
+ * task with the earliest wake time.  The lists still tell the state of a task,
+ * the heaps only order them, so a task must leave its heap before its state list
+ * item leaves a delayed list. */
+    PRIVILEGED_DATA static TCB_t * pxDelayedTaskHeaps[ 2 ] = { NULL, NULL };
+
+    #define taskDELAYED_HEAP_OF( pxList )    ( &( pxDelayedTaskHeaps[ ( ( pxList ) == &xDelayedTaskList2 ) ? 1 : 0 ] ) )
+#endif
+
 #if ( INCLUDE_vTaskDelete == 1 )
 
     PRIVILEGED_DATA static List_t xTasksWaitingTermination; /**< Tasks that have been deleted - but their memory not yet freed. */
@@ -681,6 +714,29 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
  */
 static void prvResetNextTaskUnblockTime( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * Unblock a task removed from an event list, used by xTaskRemoveFromEventList()
+ * and xTaskRemoveFromUnorderedEventListFromISR().
+ */
+static BaseType_t prvUnblockFromEventList( TCB_t * const pxUnblockedTCB ) PRIVILEGED_FUNCTION;
+
+#if ( configUSE_DELAYED_TASK_HEAP == 1 )
+
+/*
+ * Insert the task into the delayed list and its heap, the wake time must
+ * already be set as the value of the state list item.
+ */
+    static void prvDelayedHeapInsert( List_t * const pxList,
+                                      TCB_t * const pxTCB ) PRIVILEGED_FUNCTION;
+
+/*
+ * Remove the task from the heap of its delayed list, nothing is done if the
+ * task is not in a delayed list.  The state list item is left in the list.
+ */
+    static void prvDelayedHeapRemove( TCB_t * const pxTCB ) PRIVILEGED_FUNCTION;
+
+#endif
+
 #if ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 )
 
 /*
@@ -2203,6 +2259,8 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
             pxTCB = prvGetTCBFromHandle( xTaskToDelete );
 
             /* Remove task from the ready/delayed list. */
+            taskDELAYED_HEAP_REMOVE( pxTCB );
+
             if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
             {
                 taskRESET_READY_PRIORITY( pxTCB->uxPriority );
@@ -3134,6 +3192,8 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
 
             /* Remove task from the ready/delayed list and place in the
              * suspended list. */
+            taskDELAYED_HEAP_REMOVE( pxTCB );
+
             if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
             {
                 taskRESET_READY_PRIORITY( pxTCB->uxPriority );
@@ -3995,6 +4055,7 @@ BaseType_t xTaskResumeAll( void )
                         pxTCB = listGET_OWNER_OF_HEAD_ENTRY( ( &xPendingReadyList ) );
                         listREMOVE_ITEM( &( pxTCB->xEventListItem ) );
                         portMEMORY_BARRIER();
+                        taskDELAYED_HEAP_REMOVE( pxTCB );
                         listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
                         prvAddTaskToReadyList( pxTCB );
 
@@ -4593,6 +4654,7 @@ BaseType_t xTaskCatchUpTicks( TickType_t xTicksToCatchUp )
                 /* Remove the reference to the task from the blocked list.  An
                  * interrupt won't touch the xStateListItem because the
                  * scheduler is suspended. */
+                taskDELAYED_HEAP_REMOVE( pxTCB );
                 ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
 
                 /* Is the task waiting on an event also?  If so remove it from
@@ -4734,7 +4796,7 @@ BaseType_t xTaskIncrementTick( void )
                     /* MISRA Ref 11.5.3 [Void pointer assignment] */
                     /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
                     /* coverity[misra_c_2012_rule_11_5_violation] */
-                    pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList );
+                    pxTCB = taskGET_DELAYED_LIST_HEAD( pxDelayedTaskList );
                     xItemValue = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
 
                     if( xConstTickCount < xItemValue )
@@ -4753,6 +4815,7 @@ BaseType_t xTaskIncrementTick( void )
                     }
 
                     /* It is time to remove the item from the Blocked state. */
+                    taskDELAYED_HEAP_REMOVE( pxTCB );
                     listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
 
                     /* Is the task waiting on an event also?  If so remove
@@ -5338,35 +5401,15 @@ void vTaskPlaceOnUnorderedEventList( List_t * pxEventList,
 #endif /* configUSE_TIMERS */
 /*-----------------------------------------------------------*/
 
-BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList )
+/* Move a task that has just been removed from its event list out of the
+ * Blocked state, called from a critical section. */
+static BaseType_t prvUnblockFromEventList( TCB_t * const pxUnblockedTCB )
 {
-    TCB_t * pxUnblockedTCB;
     BaseType_t xReturn;
 
-    traceENTER_xTaskRemoveFromEventList( pxEventList );
-
-    /* THIS FUNCTION MUST BE CALLED FROM A CRITICAL SECTION.  It can also be
-     * called from a critical section within an ISR. */
-
-    /* The event list is sorted in priority order, so the first in the list can
-     * be removed as it is known to be the highest priority.  Remove the TCB from
-     * the delayed list, and add it to the ready list.
-     *
-     * If an event is for a queue that is locked then this function will never
-     * get called - the lock count on the queue will get modified instead.  This
-     * means exclusive access to the event list is guaranteed here.
-     *
-     * This function assumes that a check has already been made to ensure that
-     * pxEventList is not empty. */
-    /* MISRA Ref 11.5.3 [Void pointer assignment] */
-    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
-    /* coverity[misra_c_2012_rule_11_5_violation] */
-    pxUnblockedTCB = listGET_OWNER_OF_HEAD_ENTRY( pxEventList );
-    configASSERT( pxUnblockedTCB );
-    listREMOVE_ITEM( &( pxUnblockedTCB->xEventListItem ) );
-
     if( uxSchedulerSuspended == ( UBaseType_t ) 0U )
     {
+        taskDELAYED_HEAP_REMOVE( pxUnblockedTCB );
         listREMOVE_ITEM( &( pxUnblockedTCB->xStateListItem ) );
         prvAddTaskToReadyList( pxUnblockedTCB );
 
@@ -5426,6 +5469,39 @@ BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList )
     }
     #endif /* #if ( configNUMBER_OF_CORES == 1 ) */
 
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList )
+{
+    TCB_t * pxUnblockedTCB;
+    BaseType_t xReturn;
+
+    traceENTER_xTaskRemoveFromEventList( pxEventList );
+
+    /* THIS FUNCTION MUST BE CALLED FROM A CRITICAL SECTION.  It can also be
+     * called from a critical section within an ISR. */
+
+    /* The event list is sorted in priority order, so the first in the list can
+     * be removed as it is known to be the highest priority.  Remove the TCB from
+     * the delayed list, and add it to the ready list.
+     *
+     * If an event is for a queue that is locked then this function will never
+     * get called - the lock count on the queue will get modified instead.  This
+     * means exclusive access to the event list is guaranteed here.
+     *
+     * This function assumes that a check has already been made to ensure that
+     * pxEventList is not empty. */
+    /* MISRA Ref 11.5.3 [Void pointer assignment] */
+    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+    /* coverity[misra_c_2012_rule_11_5_violation] */
+    pxUnblockedTCB = listGET_OWNER_OF_HEAD_ENTRY( pxEventList );
+    configASSERT( pxUnblockedTCB );
+    listREMOVE_ITEM( &( pxUnblockedTCB->xEventListItem ) );
+
+    xReturn = prvUnblockFromEventList( pxUnblockedTCB );
+
     traceRETURN_xTaskRemoveFromEventList( xReturn );
     return xReturn;
 }
@@ -5471,6 +5547,7 @@ void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem,
     /* Remove the task from the delayed list and add it to the ready list.  The
      * scheduler is suspended so interrupts will not be accessing the ready
      * lists. */
+    taskDELAYED_HEAP_REMOVE( pxUnblockedTCB );
     listREMOVE_ITEM( &( pxUnblockedTCB->xStateListItem ) );
     prvAddTaskToReadyList( pxUnblockedTCB );
 
@@ -5503,6 +5580,32 @@ void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem,
 }
 /*-----------------------------------------------------------*/
 
+#if ( configEVENT_GROUP_ISR_MAX_WAKE > 0 )
+
+    BaseType_t xTaskRemoveFromUnorderedEventListFromISR( ListItem_t * pxEventListItem,
+                                                         const TickType_t xItemValue )
+    {
+        TCB_t * pxUnblockedTCB;
+
+        /* THIS FUNCTION MUST BE CALLED FROM A CRITICAL SECTION WITHIN AN ISR.
+         * The event group only calls this when no task is accessing the event
+         * list with the scheduler suspended, so the event list can be accessed
+         * here. */
+        listSET_LIST_ITEM_VALUE( pxEventListItem, xItemValue | taskEVENT_LIST_ITEM_VALUE_IN_USE );
+
+        /* MISRA Ref 11.5.3 [Void pointer assignment] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+        /* coverity[misra_c_2012_rule_11_5_violation] */
+        pxUnblockedTCB = listGET_LIST_ITEM_OWNER( pxEventListItem );
+        configASSERT( pxUnblockedTCB );
+        listREMOVE_ITEM( pxEventListItem );
+
+        return prvUnblockFromEventList( pxUnblockedTCB );
+    }
+
+#endif /* configEVENT_GROUP_ISR_MAX_WAKE */
+/*-----------------------------------------------------------*/
+
 void vTaskSetTimeOutState( TimeOut_t * const pxTimeOut )
 {
     traceENTER_vTaskSetTimeOutState( pxTimeOut );
@@ -6037,6 +6140,13 @@ static void prvInitialiseTaskLists( void )
      * using list2. */
     pxDelayedTaskList = &xDelayedTaskList1;
     pxOverflowDelayedTaskList = &xDelayedTaskList2;
+
+    #if ( configUSE_DELAYED_TASK_HEAP == 1 )
+    {
+        pxDelayedTaskHeaps[ 0 ] = NULL;
+        pxDelayedTaskHeaps[ 1 ] = NULL;
+    }
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -6469,11 +6579,175 @@ static void prvResetNextTaskUnblockTime( void )
          * the item at the head of the delayed list.  This is the time at
          * which the task at the head of the delayed list should be removed
          * from the Blocked state. */
-        xNextTaskUnblockTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxDelayedTaskList );
+        #if ( configUSE_DELAYED_TASK_HEAP == 1 )
+        {
+            xNextTaskUnblockTime = listGET_LIST_ITEM_VALUE( &( taskGET_DELAYED_LIST_HEAD( pxDelayedTaskList )->xStateListItem ) );
+        }
+        #else
+        {
+            xNextTaskUnblockTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxDelayedTaskList );
+        }
+        #endif
     }
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_DELAYED_TASK_HEAP == 1 )
+
+/* Meld two heaps, the root with the later wake time becomes the first child of
+ * the other root. */
+    static TCB_t * prvDelayedHeapMeld( TCB_t * pxFirst,
+                                       TCB_t * pxSecond )
+    {
+        TCB_t * pxTemp;
+
+        if( pxFirst == NULL )
+        {
+            pxFirst = pxSecond;
+        }
+        else if( pxSecond != NULL )
+        {
+            if( listGET_LIST_ITEM_VALUE( &( pxSecond->xStateListItem ) ) < listGET_LIST_ITEM_VALUE( &( pxFirst->xStateListItem ) ) )
+            {
+                pxTemp = pxFirst;
+                pxFirst = pxSecond;
+                pxSecond = pxTemp;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            pxSecond->pxHeapPrev = pxFirst;
+            pxSecond->pxHeapNext = pxFirst->pxHeapChild;
+
+            if( pxFirst->pxHeapChild != NULL )
+            {
+                pxFirst->pxHeapChild->pxHeapPrev = pxSecond;
+            }
+
+            pxFirst->pxHeapChild = pxSecond;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pxFirst;
+    }
+/*-----------------------------------------------------------*/
+
+/* Meld a list of siblings into one heap with the usual two passes, which is
+ * what keeps the removal of the root O(log n) amortized. */
+    static TCB_t * prvDelayedHeapMergePairs( TCB_t * pxSiblings )
+    {
+        TCB_t * pxPairs = NULL;
+        TCB_t * pxRoot = NULL;
+        TCB_t * pxFirst;
+        TCB_t * pxSecond;
+
+        /* Meld the siblings in pairs from left to right, and push the melded
+         * pairs on a stack linked by pxHeapNext. */
+        while( pxSiblings != NULL )
+        {
+            pxFirst = pxSiblings;
+            pxSecond = pxFirst->pxHeapNext;
+            pxFirst->pxHeapNext = NULL;
+            pxFirst->pxHeapPrev = NULL;
+
+            if( pxSecond != NULL )
+            {
+                pxSiblings = pxSecond->pxHeapNext;
+                pxSecond->pxHeapNext = NULL;
+                pxSecond->pxHeapPrev = NULL;
+            }
+            else
+            {
+                pxSiblings = NULL;
+            }
+
+            pxFirst = prvDelayedHeapMeld( pxFirst, pxSecond );
+            pxFirst->pxHeapNext = pxPairs;
+            pxPairs = pxFirst;
+        }
+
+        /* Then meld the pairs from right to left into one heap. */
+        while( pxPairs != NULL )
+        {
+            pxFirst = pxPairs;
+            pxPairs = pxFirst->pxHeapNext;
+            pxFirst->pxHeapNext = NULL;
+            pxRoot = prvDelayedHeapMeld( pxRoot, pxFirst );
+        }
+
+        return pxRoot;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvDelayedHeapInsert( List_t * const pxList,
+                                      TCB_t * const pxTCB )
+    {
+        TCB_t ** const ppxRoot = taskDELAYED_HEAP_OF( pxList );
+
+        pxTCB->pxHeapChild = NULL;
+        pxTCB->pxHeapNext = NULL;
+        pxTCB->pxHeapPrev = NULL;
+
+        listINSERT_END( pxList, &( pxTCB->xStateListItem ) );
+        *ppxRoot = prvDelayedHeapMeld( *ppxRoot, pxTCB );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvDelayedHeapRemove( TCB_t * const pxTCB )
+    {
+        List_t * const pxList = listLIST_ITEM_CONTAINER( &( pxTCB->xStateListItem ) );
+        TCB_t ** ppxRoot;
+        TCB_t * pxChildren;
+
+        /* Only the tasks in a delayed list are in a heap. */
+        if( ( pxList == &xDelayedTaskList1 ) || ( pxList == &xDelayedTaskList2 ) )
+        {
+            ppxRoot = taskDELAYED_HEAP_OF( pxList );
+            pxChildren = prvDelayedHeapMergePairs( pxTCB->pxHeapChild );
+
+            if( *ppxRoot == pxTCB )
+            {
+                *ppxRoot = pxChildren;
+            }
+            else
+            {
+                /* Unlink the task from its siblings, then meld its children
+                 * back into the heap. */
+                if( pxTCB->pxHeapPrev->pxHeapChild == pxTCB )
+                {
+                    pxTCB->pxHeapPrev->pxHeapChild = pxTCB->pxHeapNext;
+                }
+                else
+                {
+                    pxTCB->pxHeapPrev->pxHeapNext = pxTCB->pxHeapNext;
+                }
+
+                if( pxTCB->pxHeapNext != NULL )
+                {
+                    pxTCB->pxHeapNext->pxHeapPrev = pxTCB->pxHeapPrev;
+                }
+
+                *ppxRoot = prvDelayedHeapMeld( *ppxRoot, pxChildren );
+            }
+
+            pxTCB->pxHeapChild = NULL;
+            pxTCB->pxHeapNext = NULL;
+            pxTCB->pxHeapPrev = NULL;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* configUSE_DELAYED_TASK_HEAP */
+/*-----------------------------------------------------------*/
+
 #if ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) ) || ( configNUMBER_OF_CORES > 1 )
 
     #if ( configNUMBER_OF_CORES == 1 )
@@ -7906,6 +8180,7 @@ TickType_t uxTaskResetEventItemValue( void )
              * notification then unblock it now. */
             if( ucOriginalNotifyState == taskWAITING_NOTIFICATION )
             {
+                taskDELAYED_HEAP_REMOVE( pxTCB );
                 listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
                 prvAddTaskToReadyList( pxTCB );
 
@@ -8053,6 +8328,7 @@ TickType_t uxTaskResetEventItemValue( void )
 
                 if( uxSchedulerSuspended == ( UBaseType_t ) 0U )
                 {
+                    taskDELAYED_HEAP_REMOVE( pxTCB );
                     listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
                     prvAddTaskToReadyList( pxTCB );
                 }
@@ -8171,6 +8447,7 @@ TickType_t uxTaskResetEventItemValue( void )
 
                 if( uxSchedulerSuspended == ( UBaseType_t ) 0U )
                 {
+                    taskDELAYED_HEAP_REMOVE( pxTCB );
                     listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
                     prvAddTaskToReadyList( pxTCB );
                 }
@@ -8466,14 +8743,14 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
                 /* Wake time has overflowed.  Place this item in the overflow
                  * list. */
                 traceMOVED_TASK_TO_OVERFLOW_DELAYED_LIST();
-                vListInsert( pxOverflowDelayedList, &( pxCurrentTCB->xStateListItem ) );
+                taskINSERT_DELAYED_LIST( pxOverflowDelayedList, pxCurrentTCB );
             }
             else
             {
                 /* The wake time has not overflowed, so the current block list
                  * is used. */
                 traceMOVED_TASK_TO_DELAYED_LIST();
-                vListInsert( pxDelayedList, &( pxCurrentTCB->xStateListItem ) );
+                taskINSERT_DELAYED_LIST( pxDelayedList, pxCurrentTCB );
 
                 /* If the task entering the blocked state was placed at the
                  * head of the list of blocked tasks then xNextTaskUnblockTime
@@ -8503,13 +8780,13 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
         {
             traceMOVED_TASK_TO_OVERFLOW_DELAYED_LIST();
             /* Wake time has overflowed.  Place this item in the overflow list. */
-            vListInsert( pxOverflowDelayedList, &( pxCurrentTCB->xStateListItem ) );
+            taskINSERT_DELAYED_LIST( pxOverflowDelayedList, pxCurrentTCB );
         }
         else
         {
             traceMOVED_TASK_TO_DELAYED_LIST();
             /* The wake time has not overflowed, so the current block list is used. */
-            vListInsert( pxDelayedList, &( pxCurrentTCB->xStateListItem ) );
+            taskINSERT_DELAYED_LIST( pxDelayedList, pxCurrentTCB );
 
             /* If the task entering the blocked state was placed at the head of the
              * list of blocked tasks then xNextTaskUnblockTime needs to be updated
@@ -8681,6 +8958,13 @@ void vTaskResetState( void )
     uxTaskNumber = ( UBaseType_t ) 0U;
     xNextTaskUnblockTime = ( TickType_t ) 0U;
 
+    #if ( configUSE_DELAYED_TASK_HEAP == 1 )
+    {
+        pxDelayedTaskHeaps[ 0 ] = NULL;
+        pxDelayedTaskHeaps[ 1 ] = NULL;
+    }
+    #endif
+
     uxSchedulerSuspended = ( UBaseType_t ) 0U;
 
     #if ( configGENERATE_RUN_TIME_STATS == 1 )
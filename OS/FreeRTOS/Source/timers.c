@@ -140,10 +140,36 @@
  * xActiveTimerList1 and xActiveTimerList2 could be at function scope but that
  * breaks some kernel aware debuggers, and debuggers that reply on removing the
  * static qualifier. */
-    PRIVILEGED_DATA static List_t xActiveTimerList1;
-    PRIVILEGED_DATA static List_t xActiveTimerList2;
-    PRIVILEGED_DATA static List_t * pxCurrentTimerList;
-    PRIVILEGED_DATA static List_t * pxOverflowTimerList;
+    #if ( configUSE_TIMER_WHEEL == 0 )
+        PRIVILEGED_DATA static List_t xActiveTimerList1;
+        PRIVILEGED_DATA static List_t xActiveTimerList2;
+        PRIVILEGED_DATA static List_t * pxCurrentTimerList;
+        PRIVILEGED_DATA static List_t * pxOverflowTimerList;
+    #else
+
+/* When configUSE_TIMER_WHEEL is 1 the active timers are held in a hierarchical
+ * timing wheel instead.  Level 0 has one slot per tick, a slot of level n
+ * covers ( tmrWHEEL_SLOTS ^ n ) ticks, and the timers in a slot of a higher
+ * level are cascaded down to the lower levels when the wheel time reaches the
+ * start of that slot.  Each slot is an unsorted list, so a timer is inserted
+ * or removed in O(1), and the bit of a slot in uxTimerWheelMaps[] is set while
+ * the slot is not empty so the next slot to process is found without walking
+ * the wheel.  Only the timer service task is allowed to access the wheel. */
+        #define tmrWHEEL_SLOTS               ( ( UBaseType_t ) 1U << configTIMER_WHEEL_SLOT_BITS )
+        #define tmrWHEEL_SLOT_MASK           ( tmrWHEEL_SLOTS - ( UBaseType_t ) 1U )
+        #define tmrWHEEL_SHIFT( uxLevel )    ( ( uxLevel ) * ( UBaseType_t ) configTIMER_WHEEL_SLOT_BITS )
+
+/* Timers further away than this are placed as if they expire at the end of the
+ * wheel, and are placed again when that slot is cascaded. */
+        #define tmrWHEEL_MAX_DELTA           ( ( ( TickType_t ) tmrWHEEL_SLOTS << tmrWHEEL_SHIFT( configTIMER_WHEEL_LEVELS - 1 ) ) - ( TickType_t ) 1U )
+
+/* Index of the lowest set bit of a slot map. */
+        #define tmrWHEEL_LOWEST_SLOT( uxMap )    ( ( UBaseType_t ) __FLSL( ( uxMap ) & ( ~( uxMap ) + 1U ) ) )
+
+        PRIVILEGED_DATA static List_t xTimerWheel[ configTIMER_WHEEL_LEVELS * ( 1U << configTIMER_WHEEL_SLOT_BITS ) ];
+        PRIVILEGED_DATA static UBaseType_t uxTimerWheelMaps[ configTIMER_WHEEL_LEVELS ];
+        PRIVILEGED_DATA static TickType_t xTimerWheelTime;
+    #endif /* configUSE_TIMER_WHEEL */
 
 /* A queue that is used to send commands to the timer service task. */
     PRIVILEGED_DATA static QueueHandle_t xTimerQueue = NULL;
@@ -195,11 +221,34 @@
     static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
                                         const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
 
+    #if ( configUSE_TIMER_WHEEL == 0 )
+
 /*
  * The tick count has overflowed.  Switch the timer lists after ensuring the
  * current timer list does not still reference some timers.
  */
-    static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+        static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+
+    #else
+
+/*
+ * Put the timer into the slot of the timing wheel for its expiry time, which
+ * has already been set as the value of its list item.
+ */
+        static void prvTimerWheelInsert( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+/*
+ * Take the timer out of the timing wheel.
+ */
+        static void prvTimerWheelRemove( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+/*
+ * Move the wheel time on to xTime, cascading the timers of the higher level
+ * slots that start at xTime to the lower levels.
+ */
+        static void prvTimerWheelAdvance( const TickType_t xTime ) PRIVILEGED_FUNCTION;
+
+    #endif /* configUSE_TIMER_WHEEL */
 
 /*
  * Obtain the current tick count, setting *pxTimerListsWereSwitched to pdTRUE
@@ -715,34 +764,38 @@
     }
 /*-----------------------------------------------------------*/
 
-    static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
-                                        const TickType_t xTimeNow )
-    {
-        /* MISRA Ref 11.5.3 [Void pointer assignment] */
-        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
-        /* coverity[misra_c_2012_rule_11_5_violation] */
-        Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList );
+    #if ( configUSE_TIMER_WHEEL == 0 )
 
-        /* Remove the timer from the list of active timers.  A check has already
-         * been performed to ensure the list is not empty. */
+        static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
+                                            const TickType_t xTimeNow )
+        {
+            /* MISRA Ref 11.5.3 [Void pointer assignment] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+            /* coverity[misra_c_2012_rule_11_5_violation] */
+            Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList );
 
-        ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+            /* Remove the timer from the list of active timers.  A check has already
+             * been performed to ensure the list is not empty. */
 
-        /* If the timer is an auto-reload timer then calculate the next
-         * expiry time and re-insert the timer in the list of active timers. */
-        if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0U )
-        {
-            prvReloadTimer( pxTimer, xNextExpireTime, xTimeNow );
-        }
-        else
-        {
-            pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+            ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+
+            /* If the timer is an auto-reload timer then calculate the next
+             * expiry time and re-insert the timer in the list of active timers. */
+            if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0U )
+            {
+                prvReloadTimer( pxTimer, xNextExpireTime, xTimeNow );
+            }
+            else
+            {
+                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+            }
+
+            /* Call the timer callback. */
+            traceTIMER_EXPIRED( pxTimer );
+            pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
         }
 
-        /* Call the timer callback. */
-        traceTIMER_EXPIRED( pxTimer );
-        pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
-    }
+    #endif /* configUSE_TIMER_WHEEL == 0 */
 /*-----------------------------------------------------------*/
 
     static portTASK_FUNCTION( prvTimerTask, pvParameters )
@@ -779,93 +832,101 @@
     }
 /*-----------------------------------------------------------*/
 
-    static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime,
-                                            BaseType_t xListWasEmpty )
-    {
-        TickType_t xTimeNow;
-        BaseType_t xTimerListsWereSwitched;
+    #if ( configUSE_TIMER_WHEEL == 0 )
 
-        vTaskSuspendAll();
+        static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime,
+                                                BaseType_t xListWasEmpty )
         {
-            /* Obtain the time now to make an assessment as to whether the timer
-             * has expired or not.  If obtaining the time causes the lists to switch
-             * then don't process this timer as any timers that remained in the list
-             * when the lists were switched will have been processed within the
-             * prvSampleTimeNow() function. */
-            xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
-
-            if( xTimerListsWereSwitched == pdFALSE )
-            {
-                /* The tick count has not overflowed, has the timer expired? */
-                if( ( xListWasEmpty == pdFALSE ) && ( xNextExpireTime <= xTimeNow ) )
-                {
-                    ( void ) xTaskResumeAll();
-                    prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
-                }
-                else
-                {
-                    /* The tick count has not overflowed, and the next expire
-                     * time has not been reached yet.  This task should therefore
-                     * block to wait for the next expire time or a command to be
-                     * received - whichever comes first.  The following line cannot
-                     * be reached unless xNextExpireTime > xTimeNow, except in the
-                     * case when the current timer list is empty. */
-                    if( xListWasEmpty != pdFALSE )
-                    {
-                        /* The current timer list is empty - is the overflow list
-                         * also empty? */
-                        xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
-                    }
+            TickType_t xTimeNow;
+            BaseType_t xTimerListsWereSwitched;
 
-                    vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
+            vTaskSuspendAll();
+            {
+                /* Obtain the time now to make an assessment as to whether the timer
+                 * has expired or not.  If obtaining the time causes the lists to switch
+                 * then don't process this timer as any timers that remained in the list
+                 * when the lists were switched will have been processed within the
+                 * prvSampleTimeNow() function. */
+                xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
 
-                    if( xTaskResumeAll() == pdFALSE )
+                if( xTimerListsWereSwitched == pdFALSE )
+                {
+                    /* The tick count has not overflowed, has the timer expired? */
+                    if( ( xListWasEmpty == pdFALSE ) && ( xNextExpireTime <= xTimeNow ) )
                     {
-                        /* Yield to wait for either a command to arrive, or the
-                         * block time to expire.  If a command arrived between the
-                         * critical section being exited and this yield then the yield
-                         * will not cause the task to block. */
-                        taskYIELD_WITHIN_API();
+                        ( void ) xTaskResumeAll();
+                        prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
                     }
                     else
                     {
-                        mtCOVERAGE_TEST_MARKER();
+                        /* The tick count has not overflowed, and the next expire
+                         * time has not been reached yet.  This task should therefore
+                         * block to wait for the next expire time or a command to be
+                         * received - whichever comes first.  The following line cannot
+                         * be reached unless xNextExpireTime > xTimeNow, except in the
+                         * case when the current timer list is empty. */
+                        if( xListWasEmpty != pdFALSE )
+                        {
+                            /* The current timer list is empty - is the overflow list
+                             * also empty? */
+                            xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
+                        }
+
+                        vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
+
+                        if( xTaskResumeAll() == pdFALSE )
+                        {
+                            /* Yield to wait for either a command to arrive, or the
+                             * block time to expire.  If a command arrived between the
+                             * critical section being exited and this yield then the yield
+                             * will not cause the task to block. */
+                            taskYIELD_WITHIN_API();
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
                     }
                 }
-            }
-            else
-            {
-                ( void ) xTaskResumeAll();
+                else
+                {
+                    ( void ) xTaskResumeAll();
+                }
             }
         }
-    }
-/*-----------------------------------------------------------*/
 
-    static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
-    {
-        TickType_t xNextExpireTime;
+    #endif /* configUSE_TIMER_WHEEL == 0 */
+/*-----------------------------------------------------------*/
 
-        /* Timers are listed in expiry time order, with the head of the list
-         * referencing the task that will expire first.  Obtain the time at which
-         * the timer with the nearest expiry time will expire.  If there are no
-         * active timers then just set the next expire time to 0.  That will cause
-         * this task to unblock when the tick count overflows, at which point the
-         * timer lists will be switched and the next expiry time can be
-         * re-assessed.  */
-        *pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
+    #if ( configUSE_TIMER_WHEEL == 0 )
 
-        if( *pxListWasEmpty == pdFALSE )
-        {
-            xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
-        }
-        else
+        static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
         {
-            /* Ensure the task unblocks when the tick count rolls over. */
-            xNextExpireTime = ( TickType_t ) 0U;
+            TickType_t xNextExpireTime;
+
+            /* Timers are listed in expiry time order, with the head of the list
+             * referencing the task that will expire first.  Obtain the time at which
+             * the timer with the nearest expiry time will expire.  If there are no
+             * active timers then just set the next expire time to 0.  That will cause
+             * this task to unblock when the tick count overflows, at which point the
+             * timer lists will be switched and the next expiry time can be
+             * re-assessed.  */
+            *pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
+
+            if( *pxListWasEmpty == pdFALSE )
+            {
+                xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+            }
+            else
+            {
+                /* Ensure the task unblocks when the tick count rolls over. */
+                xNextExpireTime = ( TickType_t ) 0U;
+            }
+
+            return xNextExpireTime;
         }
 
-        return xNextExpireTime;
-    }
+    #endif /* configUSE_TIMER_WHEEL == 0 */
 /*-----------------------------------------------------------*/
 
     static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched )
@@ -877,7 +938,13 @@
 
         if( xTimeNow < xLastTime )
         {
-            prvSwitchTimerLists();
+            /* The timing wheel works on tick differences, so it has no lists
+             * to switch when the tick count overflows. */
+            #if ( configUSE_TIMER_WHEEL == 0 )
+            {
+                prvSwitchTimerLists();
+            }
+            #endif
             *pxTimerListsWereSwitched = pdTRUE;
         }
         else
@@ -913,7 +980,15 @@
             }
             else
             {
-                vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+                #if ( configUSE_TIMER_WHEEL == 0 )
+                {
+                    vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+                }
+                #else
+                {
+                    prvTimerWheelInsert( pxTimer );
+                }
+                #endif
             }
         }
         else
@@ -927,7 +1002,15 @@
             }
             else
             {
-                vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+                #if ( configUSE_TIMER_WHEEL == 0 )
+                {
+                    vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+                }
+                #else
+                {
+                    prvTimerWheelInsert( pxTimer );
+                }
+                #endif
             }
         }
 
@@ -977,7 +1060,15 @@
                 if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE )
                 {
                     /* The timer is in a list, remove it. */
-                    ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                    #if ( configUSE_TIMER_WHEEL == 0 )
+                    {
+                        ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                    }
+                    #else
+                    {
+                        prvTimerWheelRemove( pxTimer );
+                    }
+                    #endif
                 }
                 else
                 {
@@ -1083,29 +1174,280 @@
     }
 /*-----------------------------------------------------------*/
 
-    static void prvSwitchTimerLists( void )
-    {
-        TickType_t xNextExpireTime;
-        List_t * pxTemp;
+    #if ( configUSE_TIMER_WHEEL == 0 )
 
-        /* The tick count has overflowed.  The timer lists must be switched.
-         * If there are any timers still referenced from the current timer list
-         * then they must have expired and should be processed before the lists
-         * are switched. */
-        while( listLIST_IS_EMPTY( pxCurrentTimerList ) == pdFALSE )
+        static void prvSwitchTimerLists( void )
         {
-            xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+            TickType_t xNextExpireTime;
+            List_t * pxTemp;
+
+            /* The tick count has overflowed.  The timer lists must be switched.
+             * If there are any timers still referenced from the current timer list
+             * then they must have expired and should be processed before the lists
+             * are switched. */
+            while( listLIST_IS_EMPTY( pxCurrentTimerList ) == pdFALSE )
+            {
+                xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
 
-            /* Process the expired timer.  For auto-reload timers, be careful to
-             * process only expirations that occur on the current list.  Further
-             * expirations must wait until after the lists are switched. */
-            prvProcessExpiredTimer( xNextExpireTime, tmrMAX_TIME_BEFORE_OVERFLOW );
+                /* Process the expired timer.  For auto-reload timers, be careful to
+                 * process only expirations that occur on the current list.  Further
+                 * expirations must wait until after the lists are switched. */
+                prvProcessExpiredTimer( xNextExpireTime, tmrMAX_TIME_BEFORE_OVERFLOW );
+            }
+
+            pxTemp = pxCurrentTimerList;
+            pxCurrentTimerList = pxOverflowTimerList;
+            pxOverflowTimerList = pxTemp;
         }
 
-        pxTemp = pxCurrentTimerList;
-        pxCurrentTimerList = pxOverflowTimerList;
-        pxOverflowTimerList = pxTemp;
-    }
+    #endif /* configUSE_TIMER_WHEEL == 0 */
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_TIMER_WHEEL == 1 )
+
+        static void prvTimerWheelInsert( Timer_t * const pxTimer )
+        {
+            TickType_t xExpiryTime = listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) );
+            TickType_t xDelta = xExpiryTime - xTimerWheelTime;
+            UBaseType_t uxLevel = ( UBaseType_t ) 0U;
+            UBaseType_t uxSlot;
+
+            if( xDelta > tmrWHEEL_MAX_DELTA )
+            {
+                /* Beyond the end of the wheel, the timer is placed again when its
+                 * slot is cascaded. */
+                xDelta = tmrWHEEL_MAX_DELTA;
+                xExpiryTime = xTimerWheelTime + tmrWHEEL_MAX_DELTA;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* The level is given by how far the timer is from the wheel time,
+             * the slot by the bits of the expiry time for that level. */
+            while( ( uxLevel < ( UBaseType_t ) ( configTIMER_WHEEL_LEVELS - 1 ) ) && ( ( xDelta >> tmrWHEEL_SHIFT( uxLevel + 1U ) ) != ( TickType_t ) 0U ) )
+            {
+                uxLevel++;
+            }
+
+            uxSlot = ( UBaseType_t ) ( xExpiryTime >> tmrWHEEL_SHIFT( uxLevel ) ) & tmrWHEEL_SLOT_MASK;
+
+            vListInsertEnd( &( xTimerWheel[ ( uxLevel << configTIMER_WHEEL_SLOT_BITS ) + uxSlot ] ), &( pxTimer->xTimerListItem ) );
+            uxTimerWheelMaps[ uxLevel ] |= ( ( UBaseType_t ) 1U << uxSlot );
+        }
+    /*-----------------------------------------------------------*/
+
+        static void prvTimerWheelRemove( Timer_t * const pxTimer )
+        {
+            List_t * const pxSlot = listLIST_ITEM_CONTAINER( &( pxTimer->xTimerListItem ) );
+            UBaseType_t uxIndex;
+
+            if( uxListRemove( &( pxTimer->xTimerListItem ) ) == ( UBaseType_t ) 0U )
+            {
+                uxIndex = ( UBaseType_t ) ( pxSlot - &( xTimerWheel[ 0 ] ) );
+                uxTimerWheelMaps[ uxIndex >> configTIMER_WHEEL_SLOT_BITS ] &= ~( ( UBaseType_t ) 1U << ( uxIndex & tmrWHEEL_SLOT_MASK ) );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+    /*-----------------------------------------------------------*/
+
+        static void prvTimerWheelAdvance( const TickType_t xTime )
+        {
+            UBaseType_t uxLevel;
+            UBaseType_t uxSlot;
+            List_t * pxSlot;
+            Timer_t * pxTimer;
+
+            if( xTime != xTimerWheelTime )
+            {
+                xTimerWheelTime = xTime;
+
+                /* A slot of level n starts when the bits of all the lower levels
+                 * of the wheel time are zero.  Slots that started while the wheel
+                 * time was skipped over them were empty. */
+                for( uxLevel = ( UBaseType_t ) 1U; uxLevel < ( UBaseType_t ) configTIMER_WHEEL_LEVELS; uxLevel++ )
+                {
+                    if( ( xTime & ( ( ( TickType_t ) 1U << tmrWHEEL_SHIFT( uxLevel ) ) - ( TickType_t ) 1U ) ) != ( TickType_t ) 0U )
+                    {
+                        break;
+                    }
+
+                    uxSlot = ( UBaseType_t ) ( xTime >> tmrWHEEL_SHIFT( uxLevel ) ) & tmrWHEEL_SLOT_MASK;
+
+                    if( ( uxTimerWheelMaps[ uxLevel ] & ( ( UBaseType_t ) 1U << uxSlot ) ) != ( UBaseType_t ) 0U )
+                    {
+                        /* None of the timers can go back into this slot, they are
+                         * now closer than the span of a slot of this level. */
+                        uxTimerWheelMaps[ uxLevel ] &= ~( ( UBaseType_t ) 1U << uxSlot );
+                        pxSlot = &( xTimerWheel[ ( uxLevel << configTIMER_WHEEL_SLOT_BITS ) + uxSlot ] );
+
+                        while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+                        {
+                            /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                            /* coverity[misra_c_2012_rule_11_5_violation] */
+                            pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSlot );
+                            ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                            prvTimerWheelInsert( pxTimer );
+                        }
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+    /*-----------------------------------------------------------*/
+
+        static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
+                                            const TickType_t xTimeNow )
+        {
+            List_t * pxSlot;
+            Timer_t * pxTimer;
+
+            /* The next expire time is either the expiry time of the timers in
+             * a level 0 slot, or the start of a higher level slot that has to
+             * be cascaded. */
+            prvTimerWheelAdvance( xNextExpireTime );
+
+            /* All the timers in the level 0 slot of the wheel time expire now,
+             * they are processed one at a time as for the timer lists. */
+            pxSlot = &( xTimerWheel[ ( UBaseType_t ) xTimerWheelTime & tmrWHEEL_SLOT_MASK ] );
+
+            if( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+            {
+                /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                /* coverity[misra_c_2012_rule_11_5_violation] */
+                pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSlot );
+
+                prvTimerWheelRemove( pxTimer );
+
+                if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0U )
+                {
+                    prvReloadTimer( pxTimer, xTimerWheelTime, xTimeNow );
+                }
+                else
+                {
+                    pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                }
+
+                /* Call the timer callback. */
+                traceTIMER_EXPIRED( pxTimer );
+                pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+    /*-----------------------------------------------------------*/
+
+        static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime,
+                                                BaseType_t xListWasEmpty )
+        {
+            TickType_t xTimeNow;
+            BaseType_t xTimerListsWereSwitched;
+
+            vTaskSuspendAll();
+            {
+                /* Times are compared as distances from the wheel time, so a tick
+                 * count overflow needs no special handling here. */
+                xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+                ( void ) xTimerListsWereSwitched;
+
+                if( ( xListWasEmpty == pdFALSE ) && ( ( TickType_t ) ( xNextExpireTime - xTimerWheelTime ) <= ( TickType_t ) ( xTimeNow - xTimerWheelTime ) ) )
+                {
+                    ( void ) xTaskResumeAll();
+                    prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
+                }
+                else
+                {
+                    /* Nothing in the wheel is due up to xTimeNow, so the wheel
+                     * time can be moved on to it without cascading any slot.  This
+                     * keeps the wheel time close to the tick count while the task
+                     * is blocked. */
+                    xTimerWheelTime = xTimeNow;
+
+                    vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
+
+                    if( xTaskResumeAll() == pdFALSE )
+                    {
+                        /* Yield to wait for either a command to arrive, or the
+                         * block time to expire. */
+                        taskYIELD_WITHIN_API();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
+        }
+    /*-----------------------------------------------------------*/
+
+        static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
+        {
+            TickType_t xDelta;
+            TickType_t xNextDelta = ( TickType_t ) 0U;
+            UBaseType_t uxLevel;
+            UBaseType_t uxFirst;
+            UBaseType_t uxMap;
+            const UBaseType_t uxAllSlots = ( ( ( UBaseType_t ) 2U << ( tmrWHEEL_SLOTS - 1U ) ) - ( UBaseType_t ) 1U );
+
+            *pxListWasEmpty = pdTRUE;
+
+            for( uxLevel = ( UBaseType_t ) 0U; uxLevel < ( UBaseType_t ) configTIMER_WHEEL_LEVELS; uxLevel++ )
+            {
+                uxMap = uxTimerWheelMaps[ uxLevel ];
+
+                if( uxMap != ( UBaseType_t ) 0U )
+                {
+                    /* Level 0 is searched from the slot of the wheel time, the
+                     * higher levels from the slot after it as the current slot
+                     * has already been cascaded. */
+                    uxFirst = ( UBaseType_t ) ( xTimerWheelTime >> tmrWHEEL_SHIFT( uxLevel ) );
+
+                    if( uxLevel != ( UBaseType_t ) 0U )
+                    {
+                        uxFirst++;
+                    }
+
+                    uxFirst &= tmrWHEEL_SLOT_MASK;
+
+                    if( uxFirst != ( UBaseType_t ) 0U )
+                    {
+                        uxMap = ( ( uxMap >> uxFirst ) | ( uxMap << ( tmrWHEEL_SLOTS - uxFirst ) ) ) & uxAllSlots;
+                    }
+
+                    xDelta = ( TickType_t ) tmrWHEEL_LOWEST_SLOT( uxMap );
+
+                    if( uxLevel != ( UBaseType_t ) 0U )
+                    {
+                        xDelta = ( ( ( xTimerWheelTime >> tmrWHEEL_SHIFT( uxLevel ) ) + xDelta + ( TickType_t ) 1U ) << tmrWHEEL_SHIFT( uxLevel ) ) - xTimerWheelTime;
+                    }
+
+                    if( ( *pxListWasEmpty != pdFALSE ) || ( xDelta < xNextDelta ) )
+                    {
+                        xNextDelta = xDelta;
+                        *pxListWasEmpty = pdFALSE;
+                    }
+                }
+            }
+
+            return ( *pxListWasEmpty == pdFALSE ) ? ( xTimerWheelTime + xNextDelta ) : ( TickType_t ) 0U;
+        }
+
+    #endif /* configUSE_TIMER_WHEEL == 1 */
 /*-----------------------------------------------------------*/
 
     static void prvCheckForValidListAndQueue( void )
@@ -1117,10 +1459,30 @@
         {
             if( xTimerQueue == NULL )
             {
-                vListInitialise( &xActiveTimerList1 );
-                vListInitialise( &xActiveTimerList2 );
-                pxCurrentTimerList = &xActiveTimerList1;
-                pxOverflowTimerList = &xActiveTimerList2;
+                #if ( configUSE_TIMER_WHEEL == 0 )
+                {
+                    vListInitialise( &xActiveTimerList1 );
+                    vListInitialise( &xActiveTimerList2 );
+                    pxCurrentTimerList = &xActiveTimerList1;
+                    pxOverflowTimerList = &xActiveTimerList2;
+                }
+                #else
+                {
+                    UBaseType_t uxSlot;
+
+                    for( uxSlot = ( UBaseType_t ) 0U; uxSlot < ( UBaseType_t ) ( sizeof( xTimerWheel ) / sizeof( xTimerWheel[ 0 ] ) ); uxSlot++ )
+                    {
+                        vListInitialise( &( xTimerWheel[ uxSlot ] ) );
+                    }
+
+                    for( uxSlot = ( UBaseType_t ) 0U; uxSlot < ( UBaseType_t ) configTIMER_WHEEL_LEVELS; uxSlot++ )
+                    {
+                        uxTimerWheelMaps[ uxSlot ] = ( UBaseType_t ) 0U;
+                    }
+
+                    xTimerWheelTime = xTaskGetTickCount();
+                }
+                #endif /* configUSE_TIMER_WHEEL */
 
                 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
                 {
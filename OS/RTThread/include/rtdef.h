@@ -333,6 +333,12 @@ typedef struct rt_slist_node rt_slist_t;                /**< Type for single lis
  * kernel object macros
  */
 
+#ifdef RT_USING_OBJECT_HASH
+#ifndef RT_OBJECT_HASH_BUCKETS
+#define RT_OBJECT_HASH_BUCKETS          16              /**< bucket count of object name hash table */
+#endif
+#endif
+
 /**
  * Base structure of Kernel object
  */
@@ -343,6 +349,9 @@ struct rt_object
     rt_uint8_t flag;                                    /**< flag of kernel object */
 
     rt_list_t  list;                                    /**< list node of kernel object */
+#ifdef RT_USING_OBJECT_HASH
+    struct rt_object *hash_next;                        /**< next object in the same name hash bucket */
+#endif
 };
 typedef struct rt_object *rt_object_t;                  /**< Type for kernel objects. */
 
@@ -387,6 +396,9 @@ struct rt_object_information
     enum rt_object_class_type type;                     /**< object class type */
     rt_list_t                 object_list;              /**< object list */
     rt_size_t                 object_size;              /**< object size */
+#ifdef RT_USING_OBJECT_HASH
+    struct rt_object         *hash_table[RT_OBJECT_HASH_BUCKETS]; /**< objects hashed by name */
+#endif
 };
 
 /**
@@ -471,7 +483,20 @@ typedef struct rt_timer *rt_timer_t;
 #define RT_THREAD_RUNNING               0x03                /**< Running status */
 #define RT_THREAD_BLOCK                 RT_THREAD_SUSPEND   /**< Blocked status */
 #define RT_THREAD_CLOSE                 0x04                /**< Closed status */
-#define RT_THREAD_STAT_MASK             0x0f
+#define RT_THREAD_STAT_MASK             0x07
+
+#define RT_THREAD_STAT_YIELD            0x08                /**< indicate whether remaining_tick has been reloaded since last schedule */
+#define RT_THREAD_STAT_YIELD_MASK       RT_THREAD_STAT_YIELD
+
+#ifdef RT_USING_THREAD_PERF
+/**
+ * thread perf counter definitions, the hpm events are selected by port
+ */
+#define RT_THREAD_PERF_INSTRET          0                   /**< Retired instructions */
+#define RT_THREAD_PERF_HPM0             1                   /**< First hpm event, default icache miss */
+#define RT_THREAD_PERF_HPM1             2                   /**< Second hpm event, default dcache miss */
+#define RT_THREAD_PERF_NUM              3
+#endif
 
 /**
  * thread control command definitions
@@ -480,6 +505,42 @@ typedef struct rt_timer *rt_timer_t;
 #define RT_THREAD_CTRL_CLOSE            0x01                /**< Close thread. */
 #define RT_THREAD_CTRL_CHANGE_PRIORITY  0x02                /**< Change thread priority. */
 #define RT_THREAD_CTRL_INFO             0x03                /**< Get thread information. */
+#define RT_THREAD_CTRL_BIND_CPU         0x04                /**< Set thread bind cpu. */
+
+#ifdef RT_USING_SMP
+
+#ifndef RT_CPUS_NR
+#error "RT_CPUS_NR must be defined in rtconfig.h when RT_USING_SMP is enabled"
+#endif
+
+#define RT_CPU_DETACHED                 RT_CPUS_NR          /**< The thread not running on cpu. */
+#define RT_CPU_MASK                     ((1 << RT_CPUS_NR) - 1) /**< All CPUs mask bit. */
+
+#ifndef RT_SCHEDULE_IPI
+#define RT_SCHEDULE_IPI                 0                   /**< IPI to request a schedule on target cpu */
+#endif
+
+/**
+ * CPUs definitions
+ *
+ */
+struct rt_cpu
+{
+    struct rt_thread *current_thread;                   /**< thread running on this cpu */
+
+    rt_uint16_t irq_nest;                               /**< interrupt nest of this cpu */
+    rt_uint16_t cpus_lock_nest;                         /**< nest of cpus lock taken by this cpu */
+    rt_uint16_t scheduler_lock_nest;                    /**< nest of rt_enter_critical on this cpu */
+
+    rt_uint8_t  current_priority;                       /**< priority of current thread */
+    rt_list_t   priority_table[RT_THREAD_PRIORITY_MAX]; /**< ready queue of threads bound to this cpu */
+    rt_uint32_t priority_group;                         /**< ready priority group of bound threads */
+#if RT_THREAD_PRIORITY_MAX > 32
+    rt_uint8_t  ready_table[32];                        /**< ready table of bound threads */
+#endif
+};
+
+#endif
 
 /**
  * Thread structure
@@ -492,6 +553,9 @@ struct rt_thread
     rt_uint8_t  flags;                                  /**< thread's flags */
 
     rt_list_t   list;                                   /**< the object list */
+#ifdef RT_USING_OBJECT_HASH
+    struct rt_object *hash_next;                        /**< next object in the same name hash bucket */
+#endif
     rt_list_t   tlist;                                  /**< the thread list */
 
     /* stack point and entry */
@@ -506,6 +570,11 @@ struct rt_thread
 
     rt_uint8_t  stat;                                   /**< thread status */
 
+#ifdef RT_USING_SMP
+    rt_uint8_t  bind_cpu;                               /**< thread is bind to cpu */
+    rt_uint8_t  oncpu;                                  /**< process on cpu */
+#endif
+
     /* priority */
     rt_uint8_t  current_priority;                       /**< current priority */
     rt_uint8_t  init_priority;                          /**< initialized priority */
@@ -529,6 +598,15 @@ struct rt_thread
     void (*cleanup)(struct rt_thread *tid);             /**< cleanup function when thread exit */
 
     rt_uint32_t user_data;                              /**< private user data beyond this thread */
+
+#ifdef RT_USING_THREAD_CYCLES
+    rt_uint64_t cycles_total;                           /**< cpu cycles this thread has been running */
+    rt_uint64_t cycles_start;                           /**< cpu cycle when this thread switched in */
+#ifdef RT_USING_THREAD_PERF
+    rt_uint64_t perf_total[RT_THREAD_PERF_NUM];         /**< perf counters accumulated when this thread running */
+    rt_uint64_t perf_start[RT_THREAD_PERF_NUM];         /**< perf counters when this thread switched in */
+#endif
+#endif
 };
 typedef struct rt_thread *rt_thread_t;
 
@@ -570,8 +648,12 @@ struct rt_semaphore
 {
     struct rt_ipc_object parent;                        /**< inherit from ipc_object */
 
+#ifdef RT_USING_IPC_FASTPATH
+    rt_uint32_t          value;                         /**< value of semaphore, updated by compare and swap */
+#else
     rt_uint16_t          value;                         /**< value of semaphore. */
     rt_uint16_t          reserved;                      /**< reserved field */
+#endif
 };
 typedef struct rt_semaphore *rt_sem_t;
 #endif
@@ -92,8 +92,16 @@ rt_isr_handler_t rt_hw_interrupt_install(int              vector,
                                          void            *param,
                                          const char      *name);
 
+#ifdef RT_USING_SMP
+rt_base_t rt_hw_local_irq_disable(void);
+void rt_hw_local_irq_enable(rt_base_t level);
+
+#define rt_hw_interrupt_disable rt_cpus_lock
+#define rt_hw_interrupt_enable rt_cpus_unlock
+#else
 rt_base_t rt_hw_interrupt_disable(void);
 void rt_hw_interrupt_enable(rt_base_t level);
+#endif /*RT_USING_SMP*/
 
 /*
  * Context interfaces
@@ -102,6 +110,17 @@ void rt_hw_context_switch(rt_ubase_t from, rt_ubase_t to);
 void rt_hw_context_switch_to(rt_ubase_t to);
 void rt_hw_context_switch_interrupt(rt_ubase_t from, rt_ubase_t to);
 
+#ifdef RT_USING_THREAD_CYCLES
+/*
+ * Thread cpu cycles interfaces, accumulated by port when thread switched
+ */
+rt_uint64_t rt_hw_cycles_get(void);
+rt_uint64_t rt_hw_thread_cycles_get(rt_thread_t thread);
+#ifdef RT_USING_THREAD_PERF
+void rt_hw_thread_perf_get(rt_thread_t thread, rt_uint64_t perf[RT_THREAD_PERF_NUM]);
+#endif
+#endif
+
 void rt_hw_console_output(const char *str);
 
 void rt_hw_backtrace(rt_uint32_t *fp, rt_ubase_t thread_entry);
@@ -117,12 +136,58 @@ void rt_hw_exception_install(rt_err_t (*exception_handle)(void *context));
  */
 void rt_hw_us_delay(rt_uint32_t us);
 
+#ifdef RT_USING_SMP
+/* ticket spinlock, cpus get the lock in the order they request */
+typedef struct
+{
+    volatile rt_uint32_t next;      /* ticket taken by next locker */
+    volatile rt_uint32_t owner;     /* ticket of current lock holder */
+} rt_hw_spinlock_t;
+
+#define __RT_HW_SPIN_LOCK_INITIALIZER(lockname) {0, 0}
+
+#define __RT_HW_SPIN_LOCK_UNLOCKED(lockname)    \
+    (rt_hw_spinlock_t) __RT_HW_SPIN_LOCK_INITIALIZER(lockname)
+
+#define RT_DEFINE_SPINLOCK(x)  rt_hw_spinlock_t x = __RT_HW_SPIN_LOCK_UNLOCKED(x)
+#define RT_DECLARE_SPINLOCK(x)
+
+/**
+ *  ipi function
+ */
+void rt_hw_ipi_send(int ipi_vector, unsigned int cpu_mask);
+
+/**
+ * boot secondary cpu
+ */
+void rt_hw_secondary_cpu_up(void);
+
+/**
+ * secondary cpu idle function
+ */
+void rt_hw_secondary_cpu_idle_exec(void);
+
+/*
+ * spinlock interfaces, implemented by port with atomic instructions
+ */
+void rt_hw_spin_lock_init(rt_hw_spinlock_t *lock);
+void rt_hw_spin_lock(rt_hw_spinlock_t *lock);
+void rt_hw_spin_unlock(rt_hw_spinlock_t *lock);
+
+int rt_hw_cpu_id(void);
+
+extern rt_hw_spinlock_t _cpus_lock;
+
+#else
+
 #define RT_DEFINE_SPINLOCK(x)
 #define RT_DECLARE_SPINLOCK(x)    rt_ubase_t x
 
 #define rt_hw_spin_lock(lock)     *(lock) = rt_hw_interrupt_disable()
 #define rt_hw_spin_unlock(lock)   rt_hw_interrupt_enable(*(lock))
 
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -12,8 +12,43 @@
 #include <rthw.h>
 #include <rtthread.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "cpuport.h"
+#include "nmsis_rtos.h"
+#if defined(NUCLEI_STACK_MONITOR) && (NUCLEI_STACK_MONITOR == 1)
+#include "stackmon_api.h"
+#endif
+#if defined(NUCLEI_SOFTIRQ) && (NUCLEI_SOFTIRQ == 1)
+#include "softirq_api.h"
+#endif
+#if defined(NUCLEI_DLOG) && (NUCLEI_DLOG == 1)
+#include "dlog_api.h"
+#endif
+#if defined(NUCLEI_GPROF_TASK) && (NUCLEI_GPROF_TASK == 1)
+#include "gprof_api.h"
+#endif
+#if defined(RT_USING_IPC_FASTPATH) && !defined(__riscv_atomic)
+#error "RT_USING_IPC_FASTPATH requires RISC-V A extension for compare and swap, please use a march with a extension"
+#endif
+
+#ifdef RT_USING_THREAD_PERF
+#ifndef RT_USING_THREAD_CYCLES
+#error "RT_USING_THREAD_PERF requires RT_USING_THREAD_CYCLES"
+#endif
+#include "nmsis_bench.h"
+
+#ifndef RT_PERF_HPM_IDX_BASE
+/* First mhpmcounter used by thread perf counters, RT_PERF_HPM_IDX_BASE ~ RT_PERF_HPM_IDX_BASE + 1 will be used */
+#define RT_PERF_HPM_IDX_BASE        3
+#endif
+#ifndef RT_PERF_HPM_EVENT0
+#define RT_PERF_HPM_EVENT0          ((MSU_EVENT_ENABLE << 28) | (EVENT_MEMORY_ACCESS_ICACHE_MISS << 4) | EVENT_SEL_MEMORY_ACCESS)
+#endif
+#ifndef RT_PERF_HPM_EVENT1
+#define RT_PERF_HPM_EVENT1          ((MSU_EVENT_ENABLE << 28) | (EVENT_MEMORY_ACCESS_DCACHE_MISS << 4) | EVENT_SEL_MEMORY_ACCESS)
+#endif
+#endif
 
 #define SYSTICK_TICK_CONST                          (SOC_TIMER_FREQ / RT_TICK_PER_SECOND)
 
@@ -26,46 +61,50 @@
 #define configMAX_SYSCALL_INTERRUPT_PRIORITY    255
 #endif
 
-#define portINITIAL_MSTATUS                         ( MSTATUS_MPP | MSTATUS_MPIE | MSTATUS_FS_INITIAL | MSTATUS_VS_INITIAL)
+#ifdef RT_USING_SMP
+#if !defined(__riscv_atomic)
+#error "RT_USING_SMP requires RISC-V A extension for cpus lock, please use a march with a extension"
+#endif
+
+/*
+ * Context switch pointers of each cpu, indexed by hart index in SWI handler,
+ * which saves the context to *rt_interrupt_from_thread[cpu], calls xPortTaskSwitch,
+ * then restores the context from *rt_interrupt_to_thread[cpu].
+ * rt_hw_context_switch_to sets both of them for the first thread of each cpu.
+ */
+volatile rt_ubase_t  rt_interrupt_from_thread[RT_CPUS_NR];
+volatile rt_ubase_t  rt_interrupt_to_thread[RT_CPUS_NR];
 
+/* set by boot cpu when kernel is ready for secondary cpus to start scheduler */
+static volatile rt_ubase_t rt_secondary_cpu_start = 0;
+#else
 volatile rt_ubase_t  rt_interrupt_from_thread = 0;
 volatile rt_ubase_t  rt_interrupt_to_thread   = 0;
 volatile rt_ubase_t rt_thread_switch_interrupt_flag = 0;
+#endif
 
-struct rt_hw_stack_frame {
-    rt_ubase_t epc;        /* epc - epc    - program counter                     */
-    rt_ubase_t ra;         /* x1  - ra     - return address for jumps            */
-    rt_ubase_t t0;         /* x5  - t0     - temporary register 0                */
-    rt_ubase_t t1;         /* x6  - t1     - temporary register 1                */
-    rt_ubase_t t2;         /* x7  - t2     - temporary register 2                */
-    rt_ubase_t s0_fp;      /* x8  - s0/fp  - saved register 0 or frame pointer   */
-    rt_ubase_t s1;         /* x9  - s1     - saved register 1                    */
-    rt_ubase_t a0;         /* x10 - a0     - return value or function argument 0 */
-    rt_ubase_t a1;         /* x11 - a1     - return value or function argument 1 */
-    rt_ubase_t a2;         /* x12 - a2     - function argument 2                 */
-    rt_ubase_t a3;         /* x13 - a3     - function argument 3                 */
-    rt_ubase_t a4;         /* x14 - a4     - function argument 4                 */
-    rt_ubase_t a5;         /* x15 - a5     - function argument 5                 */
-#ifndef __riscv_32e
-    rt_ubase_t a6;         /* x16 - a6     - function argument 6                 */
-    rt_ubase_t a7;         /* x17 - s7     - function argument 7                 */
-    rt_ubase_t s2;         /* x18 - s2     - saved register 2                    */
-    rt_ubase_t s3;         /* x19 - s3     - saved register 3                    */
-    rt_ubase_t s4;         /* x20 - s4     - saved register 4                    */
-    rt_ubase_t s5;         /* x21 - s5     - saved register 5                    */
-    rt_ubase_t s6;         /* x22 - s6     - saved register 6                    */
-    rt_ubase_t s7;         /* x23 - s7     - saved register 7                    */
-    rt_ubase_t s8;         /* x24 - s8     - saved register 8                    */
-    rt_ubase_t s9;         /* x25 - s9     - saved register 9                    */
-    rt_ubase_t s10;        /* x26 - s10    - saved register 10                   */
-    rt_ubase_t s11;        /* x27 - s11    - saved register 11                   */
-    rt_ubase_t t3;         /* x28 - t3     - temporary register 3                */
-    rt_ubase_t t4;         /* x29 - t4     - temporary register 4                */
-    rt_ubase_t t5;         /* x30 - t5     - temporary register 5                */
-    rt_ubase_t t6;         /* x31 - t6     - temporary register 6                */
-#endif
-    rt_ubase_t mstatus;    /*              - machine status register             */
-};
+#ifdef RT_USING_PM
+#ifndef RT_PM_TICKLESS_THRESHOLD
+/* Minimal idle ticks to suppress the tick interrupt, shorter idle just wfi */
+#define RT_PM_TICKLESS_THRESHOLD    2
+#endif
+
+#ifndef RT_PM_TICKLESS_MAX_TICKS
+/* Limit to half of rt_tick_t range to keep tick compare sane */
+#define RT_PM_TICKLESS_MAX_TICKS    (RT_TICK_MAX >> 1)
+#endif
+
+#ifndef RT_PM_WFI_SLEEPMODE
+/* SysTimer must keep counting in the selected sleep mode */
+#define RT_PM_WFI_SLEEPMODE         WFI_SHALLOW_SLEEP
+#endif
+
+#ifndef RT_USING_SMP
+/* Absolute SysTimer value of the next tick boundary */
+static uint64_t rt_hw_next_tick_time = 0;
+static struct rt_hw_pm_stats rt_hw_pm_stat;
+#endif
+#endif
 
 /**
  * This function will initialize thread stack
@@ -82,29 +121,32 @@ rt_uint8_t* rt_hw_stack_init(void*       tentry,
                              rt_uint8_t* stack_addr,
                              void*       texit)
 {
-    struct rt_hw_stack_frame* frame;
     rt_uint8_t*         stk;
-    int                i;
 
     stk  = stack_addr + sizeof(rt_ubase_t);
     stk  = (rt_uint8_t*)RT_ALIGN_DOWN((rt_ubase_t)stk, REGBYTES);
-    stk -= sizeof(struct rt_hw_stack_frame);
+    /* frame layout is shared with other RTOS ports in nmsis_rtos.h */
+    stk  = (rt_uint8_t*)__RV_FrameInit((unsigned long*)stk, (rt_ubase_t)tentry,
+                                       (rt_ubase_t)parameter, (rt_ubase_t)texit, 0xdeadbeef);
 
-    frame = (struct rt_hw_stack_frame*)stk;
+    return stk;
+}
 
-    for (i = 0; i < sizeof(struct rt_hw_stack_frame) / sizeof(rt_ubase_t); i++) {
-        ((rt_ubase_t*)frame)[i] = 0xdeadbeef;
+#ifdef RT_USING_CPU_FFS
+/*
+ * First set bit of value for lookups of the ready priority bitmaps, numbered from 1,
+ * single ctz with Zbb, else __CTZL takes a constant time de Bruijn lookup
+ */
+int __rt_ffs(int value)
+{
+    if (value == 0) {
+        return 0;
     }
-
-    frame->ra      = (rt_ubase_t)texit;
-    frame->a0      = (rt_ubase_t)parameter;
-    frame->epc     = (rt_ubase_t)tentry;
-
-    frame->mstatus = portINITIAL_MSTATUS;
-
-    return stk;
+    return (int)__CTZL((unsigned long)(unsigned int)value) + 1;
 }
+#endif
 
+#ifndef RT_USING_SMP
 /*
  * void rt_hw_context_switch_interrupt(rt_ubase_t from, rt_ubase_t to);
  */
@@ -123,6 +165,7 @@ void rt_hw_context_switch(rt_ubase_t from, rt_ubase_t to)
 {
     rt_hw_context_switch_interrupt(from, to);
 }
+#endif
 
 /** shutdown CPU */
 void rt_hw_cpu_shutdown()
@@ -136,10 +179,166 @@ void rt_hw_cpu_shutdown()
     }
 }
 
+#ifdef RT_USING_THREAD_CYCLES
+#define CONTEXT_TO_THREAD(ctx)      rt_container_of((rt_ubase_t *)(ctx), struct rt_thread, sp)
+
+rt_uint64_t rt_hw_cycles_get(void)
+{
+    return __get_rv_cycle();
+}
+
+/* cpu cycles the thread has been running, including the running part of current thread */
+rt_uint64_t rt_hw_thread_cycles_get(rt_thread_t thread)
+{
+    rt_base_t level;
+    rt_uint64_t cycles;
+
+    level = rt_hw_interrupt_disable();
+    cycles = thread->cycles_total;
+    if ((thread == rt_thread_self()) && (thread->cycles_start != 0)) {
+        cycles += __get_rv_cycle() - thread->cycles_start;
+    }
+    rt_hw_interrupt_enable(level);
+    return cycles;
+}
+
+#ifdef RT_USING_THREAD_PERF
+/* Program the hpm events of current hart, called by each hart before scheduler start */
+static void rt_hw_perf_init(void)
+{
+    __set_hpm_event(RT_PERF_HPM_IDX_BASE, RT_PERF_HPM_EVENT0);
+    __set_hpm_event(RT_PERF_HPM_IDX_BASE + 1, RT_PERF_HPM_EVENT1);
+    __set_hpm_counter(RT_PERF_HPM_IDX_BASE, 0);
+    __set_hpm_counter(RT_PERF_HPM_IDX_BASE + 1, 0);
+    __enable_minstret_counter();
+    __enable_mhpm_counters((1UL << RT_PERF_HPM_IDX_BASE) | (1UL << (RT_PERF_HPM_IDX_BASE + 1)));
+}
+
+/* hpm counters are only read in low 32 bits in rv32, so their deltas wrap in rt_ubase_t */
+rt_inline rt_uint64_t rt_hw_perf_delta(int idx, rt_uint64_t now, rt_uint64_t start)
+{
+    if (idx == RT_THREAD_PERF_INSTRET) {
+        return now - start;
+    }
+    return (rt_ubase_t)(now - start);
+}
+
+static void rt_hw_perf_read(rt_uint64_t perf[RT_THREAD_PERF_NUM])
+{
+    perf[RT_THREAD_PERF_INSTRET] = __get_rv_instret();
+    perf[RT_THREAD_PERF_HPM0] = __get_hpm_counter(RT_PERF_HPM_IDX_BASE);
+    perf[RT_THREAD_PERF_HPM1] = __get_hpm_counter(RT_PERF_HPM_IDX_BASE + 1);
+}
+
+/* perf counters of the thread, including the running part of current thread */
+void rt_hw_thread_perf_get(rt_thread_t thread, rt_uint64_t perf[RT_THREAD_PERF_NUM])
+{
+    rt_base_t level;
+    rt_uint64_t now[RT_THREAD_PERF_NUM];
+    int i;
+
+    level = rt_hw_interrupt_disable();
+    rt_hw_perf_read(now);
+    for (i = 0; i < RT_THREAD_PERF_NUM; i++) {
+        perf[i] = thread->perf_total[i];
+        if ((thread == rt_thread_self()) && (thread->cycles_start != 0)) {
+            perf[i] += rt_hw_perf_delta(i, now[i], thread->perf_start[i]);
+        }
+    }
+    rt_hw_interrupt_enable(level);
+}
+#endif
+
+/* from can be RT_NULL when switch to the first thread */
+static void rt_hw_thread_cycles_switch(struct rt_thread *from, struct rt_thread *to)
+{
+    rt_uint64_t now = __get_rv_cycle();
+#ifdef RT_USING_THREAD_PERF
+    rt_uint64_t perf[RT_THREAD_PERF_NUM];
+    int i;
+
+    rt_hw_perf_read(perf);
+    for (i = 0; i < RT_THREAD_PERF_NUM; i++) {
+        if ((from != RT_NULL) && (from->cycles_start != 0)) {
+            from->perf_total[i] += rt_hw_perf_delta(i, perf[i], from->perf_start[i]);
+        }
+        to->perf_start[i] = perf[i];
+    }
+#endif
+
+    if ((from != RT_NULL) && (from->cycles_start != 0)) {
+        from->cycles_total += now - from->cycles_start;
+    }
+    to->cycles_start = now;
+}
+#endif
+
+#ifdef __riscv_atomic
+static volatile rt_uint32_t rt_hw_sc_dummy;
+
+/*
+ * sc always invalidates the reservation of this hart, so the lr/sc sequence
+ * of the thread switched out is retried when it runs again, since the data
+ * may be changed by other threads on this hart without sc
+ */
+rt_inline void rt_hw_reservation_clear(void)
+{
+    rt_ubase_t rc;
+
+    __ASM volatile ("sc.w %0, zero, %1" : "=r"(rc), "+A"(rt_hw_sc_dummy) : : "memory");
+    (void)rc;
+}
+#endif
+
+#ifdef RT_USING_SMP
+void xPortTaskSwitch(void)
+{
+    int cpu = rt_hw_cpu_id();
+    rt_base_t level;
+    struct rt_thread *to;
+
+    /* Clear Software IRQ before checking, IPI sent after it will trigger another switch */
+    SysTimer_ClearSWIRQ();
+    rt_hw_reservation_clear();
+#if defined(NUCLEI_SOFTIRQ) && (NUCLEI_SOFTIRQ == 1)
+    /* Run deferred interrupt works before selecting the thread to run */
+    rt_interrupt_enter();
+    softirq_run();
+    rt_interrupt_leave();
+#endif
+
+    level = rt_hw_interrupt_disable();
+    /* select the thread to run, it is current thread if no switch is needed */
+    to = rt_schedule_switch();
+#ifdef RT_USING_THREAD_CYCLES
+    if ((rt_ubase_t)&to->sp != rt_interrupt_from_thread[cpu]) {
+        rt_hw_thread_cycles_switch(rt_interrupt_from_thread[cpu] ? CONTEXT_TO_THREAD(rt_interrupt_from_thread[cpu]) : RT_NULL, to);
+    }
+#endif
+    rt_interrupt_to_thread[cpu] = (rt_ubase_t)&to->sp;
+    rt_interrupt_from_thread[cpu] = (rt_ubase_t)&to->sp;
+    rt_hw_interrupt_enable(level);
+}
+#else
 void xPortTaskSwitch(void)
 {
     /* Clear Software IRQ, A MUST */
     SysTimer_ClearSWIRQ();
+#ifdef __riscv_atomic
+    rt_hw_reservation_clear();
+#endif
+#if defined(NUCLEI_SOFTIRQ) && (NUCLEI_SOFTIRQ == 1)
+    /* Run deferred interrupt works, a thread woken by them updates rt_interrupt_to_thread */
+    rt_interrupt_enter();
+    softirq_run();
+    rt_interrupt_leave();
+#endif
+#ifdef RT_USING_THREAD_CYCLES
+    if (rt_interrupt_to_thread != 0) {
+        rt_hw_thread_cycles_switch(rt_interrupt_from_thread ? CONTEXT_TO_THREAD(rt_interrupt_from_thread) : RT_NULL,
+                                   CONTEXT_TO_THREAD(rt_interrupt_to_thread));
+    }
+#endif
     rt_thread_switch_interrupt_flag = 0;
     // make from thread to be to thread
     // If there is another swi interrupt triggered by other harts
@@ -147,6 +346,7 @@ void xPortTaskSwitch(void)
     // the task switch should just do a same task save and restore
     rt_interrupt_from_thread = rt_interrupt_to_thread;
 }
+#endif
 
 void vPortSetupTimerInterrupt(void)
 {
@@ -155,6 +355,9 @@ void vPortSetupTimerInterrupt(void)
     /* Make SWI and SysTick the lowest priority interrupts. */
     /* Stop and clear the SysTimer. SysTimer as Non-Vector Interrupt */
     SysTick_Config(ticks);
+#if defined(RT_USING_PM) && !defined(RT_USING_SMP)
+    rt_hw_next_tick_time = SysTimer_GetCompareValue();
+#endif
     ECLIC_DisableIRQ(SysTimer_IRQn);
     ECLIC_SetLevelIRQ(SysTimer_IRQn, configKERNEL_INTERRUPT_PRIORITY);
     ECLIC_SetShvIRQ(SysTimer_IRQn, ECLIC_NON_VECTOR_INTERRUPT);
@@ -166,8 +369,123 @@ void vPortSetupTimerInterrupt(void)
     ECLIC_EnableIRQ(SysTimerSW_IRQn);
 }
 
+#ifdef RT_USING_PM
+/* Hooks around wfi, such as gating peripheral clocks, set *ticks to 0 if wfi is done by the hook */
+RT_WEAK void rt_hw_pm_pre_sleep(rt_tick_t* ticks)
+{
+}
+
+RT_WEAK void rt_hw_pm_post_sleep(rt_tick_t ticks)
+{
+}
+
+#ifdef RT_USING_SMP
+/* Tick is needed by time slices of other cpus, so just sleep until interrupt */
+RT_WEAK void rt_system_power_manager(void)
+{
+    __WFI();
+}
+#else
+/**
+ * Tickless idle, called by idle thread with RT_USING_PM.
+ *
+ * The tick interrupt is suppressed until the next timeout of the timer list,
+ * the ticks passed in sleep are got from mtime and caught up on wakeup.
+ */
+RT_WEAK void rt_system_power_manager(void)
+{
+    rt_base_t level;
+    rt_tick_t idle_ticks, sleep_ticks, slept_ticks, step_ticks;
+    uint64_t sleep_start, now;
+    struct rt_thread* thread;
+
+    /* wfi still wakes up on pending interrupt when interrupts are disabled */
+    level = rt_hw_interrupt_disable();
+
+    /* abandon when a context switch is pending or other threads share the idle priority */
+    thread = rt_thread_self();
+    if ((rt_thread_switch_interrupt_flag != 0) || (thread->tlist.next != thread->tlist.prev)) {
+        rt_hw_pm_stat.aborts++;
+        rt_hw_interrupt_enable(level);
+        return;
+    }
+
+    idle_ticks = rt_timer_next_timeout_tick();
+    if (idle_ticks == RT_TICK_MAX) {
+        idle_ticks = RT_PM_TICKLESS_MAX_TICKS;
+    } else {
+        idle_ticks -= rt_tick_get();
+        /* timeout already passed, processing by the pending tick */
+        if (idle_ticks > RT_PM_TICKLESS_MAX_TICKS) {
+            idle_ticks = 0;
+        }
+    }
+    if (idle_ticks < RT_PM_TICKLESS_THRESHOLD) {
+        __WFI();
+        rt_hw_interrupt_enable(level);
+        return;
+    }
+
+    /* The pending tick boundary is the first idle tick, so wake up exactly at
+     * the boundary of the last idle tick */
+    SysTimer_SetCompareValue(rt_hw_next_tick_time + (uint64_t)(idle_ticks - 1) * SYSTICK_TICK_CONST);
+    __RWMB();
+    sleep_start = SysTimer_GetLoadValue();
+
+    sleep_ticks = idle_ticks;
+    rt_hw_pm_pre_sleep(&sleep_ticks);
+    if (sleep_ticks > 0) {
+        __set_wfi_sleepmode(RT_PM_WFI_SLEEPMODE);
+        __WFI();
+        __set_wfi_sleepmode(WFI_SHALLOW_SLEEP);
+    }
+    rt_hw_pm_post_sleep(idle_ticks);
+
+    now = SysTimer_GetLoadValue();
+    slept_ticks = 0;
+    if (now >= rt_hw_next_tick_time) {
+        slept_ticks = (rt_tick_t)((now - rt_hw_next_tick_time) / SYSTICK_TICK_CONST) + 1;
+    }
+
+    /* The last passed tick is processed by the pending tick interrupt with the
+     * timer check, never step beyond the next timeout, the remaining ticks are
+     * caught up by tick interrupt one by one */
+    step_ticks = 0;
+    if (slept_ticks > 0) {
+        step_ticks = slept_ticks - 1;
+        if (step_ticks > idle_ticks - 1) {
+            step_ticks = idle_ticks - 1;
+        }
+    }
+    rt_hw_next_tick_time += (uint64_t)step_ticks * SYSTICK_TICK_CONST;
+    SysTimer_SetCompareValue(rt_hw_next_tick_time);
+    rt_tick_set(rt_tick_get() + step_ticks);
+
+    rt_hw_pm_stat.sleeps++;
+    if (slept_ticks < idle_ticks) {
+        rt_hw_pm_stat.early_wakeups++;
+    }
+    rt_hw_pm_stat.slept_ticks += slept_ticks;
+    rt_hw_pm_stat.compensated_ticks += step_ticks;
+    rt_hw_pm_stat.slept_counts += now - sleep_start;
+
+    /* pending tick interrupt is taken now */
+    rt_hw_interrupt_enable(level);
+}
+
+void rt_hw_pm_stats_get(struct rt_hw_pm_stats* stats)
+{
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    *stats = rt_hw_pm_stat;
+    rt_hw_interrupt_enable(level);
+}
+#endif
+#endif
 
 #if defined(RT_USING_USER_MAIN) && defined(RT_USING_HEAP)
+#if defined(RT_HEAP_SIZE) || defined(__ICCRISCV__)
 #ifndef RT_HEAP_SIZE
 #warning RT_HEAP_SIZE is not defined in rtconfig.h, using default 2048
 #define RT_HEAP_SIZE 2048
@@ -182,6 +500,193 @@ RT_WEAK void* rt_heap_end_get(void)
 {
     return rt_heap + RT_HEAP_SIZE;
 }
+#else
+/*
+ * When RT_HEAP_SIZE is not defined, the system heap is the free ram reserved
+ * by linker script for heap, from __heap_start to __heap_end, which is sized by
+ * HEAPSZ in Makefile. It is claimed by _sbrk, and RT_HEAP_LIBC_RESERVE bytes are
+ * left for malloc of libc, so the two heaps never overlap.
+ */
+#ifndef RT_HEAP_LIBC_RESERVE
+#define RT_HEAP_LIBC_RESERVE    1024
+#endif
+
+static rt_uint8_t* rt_heap_begin = RT_NULL;
+static rt_uint8_t* rt_heap_end = RT_NULL;
+
+static void rt_heap_claim(void)
+{
+    extern char __heap_end[];
+    extern void* _sbrk(ptrdiff_t incr);
+    rt_uint8_t* brk;
+    long size;
+
+    if (rt_heap_begin != RT_NULL) {
+        return;
+    }
+    brk = (rt_uint8_t*)_sbrk(0);
+    size = (long)((rt_uint8_t*)__heap_end - brk) - RT_HEAP_LIBC_RESERVE;
+    size = RT_ALIGN_DOWN(size, RT_ALIGN_SIZE);
+    if ((size <= 0) || (_sbrk(size) == (void*)(-1))) {
+        printf("No enough heap for RT-Thread, please increase HEAPSZ\n");
+        size = 0;
+    }
+    rt_heap_begin = brk;
+    rt_heap_end = brk + size;
+}
+
+RT_WEAK void* rt_heap_begin_get(void)
+{
+    rt_heap_claim();
+    return rt_heap_begin;
+}
+
+RT_WEAK void* rt_heap_end_get(void)
+{
+    rt_heap_claim();
+    return rt_heap_end;
+}
+#endif
+#endif
+
+#ifdef RT_USING_MEMHEAP
+/*
+ * Extra memory heaps placed in different memories, such as DLM for hot small
+ * objects and SRAM/DDR for bulk buffers. Define RT_MEMHEAP_REGIONS in rtconfig.h
+ * as a list of RT_MEMHEAP_REGION(name, start, end, hint), start and end are
+ * symbols provided by linker script for the free space of each section, eg.
+ *   #define RT_MEMHEAP_REGIONS \
+ *       RT_MEMHEAP_REGION(dlm, __dlm_heap_start, __dlm_heap_end, RT_HEAP_HINT_FAST) \
+ *       RT_MEMHEAP_REGION(ddr, __ddr_heap_start, __ddr_heap_end, RT_HEAP_HINT_BULK)
+ * Regions whose symbols are not provided by linker script are skipped.
+ */
+#ifndef RT_MEMHEAP_REGIONS
+#define RT_MEMHEAP_REGIONS
+#endif
+
+struct rt_hw_memheap_region {
+    struct rt_memheap heap;
+    const char* name;
+    rt_uint8_t* start;
+    rt_uint8_t* end;
+    rt_uint8_t hint;
+};
+
+#undef RT_MEMHEAP_REGION
+#define RT_MEMHEAP_REGION(name, start, end, hint)   extern char start[] RT_WEAK; extern char end[] RT_WEAK;
+RT_MEMHEAP_REGIONS
+#undef RT_MEMHEAP_REGION
+#define RT_MEMHEAP_REGION(name, start, end, hint)   { {{{0}}}, #name, (rt_uint8_t*)start, (rt_uint8_t*)end, hint },
+
+static struct rt_hw_memheap_region rt_hw_memheaps[] = {
+    RT_MEMHEAP_REGIONS
+    { {{{0}}}, RT_NULL, RT_NULL, RT_NULL, RT_HEAP_HINT_ANY }
+};
+
+#define RT_HW_MEMHEAP_NUM       (sizeof(rt_hw_memheaps) / sizeof(rt_hw_memheaps[0]) - 1)
+
+static void rt_hw_memheap_init(void)
+{
+    struct rt_hw_memheap_region* region;
+    rt_ubase_t i;
+
+    for (i = 0; i < RT_HW_MEMHEAP_NUM; i++) {
+        region = &rt_hw_memheaps[i];
+        if ((region->start == RT_NULL) || (region->end <= region->start)) {
+            continue;
+        }
+        rt_memheap_init(&region->heap, region->name, region->start, region->end - region->start);
+    }
+}
+
+static rt_bool_t rt_hw_memheap_valid(struct rt_hw_memheap_region* region)
+{
+    return (region->heap.start_addr != RT_NULL) ? RT_TRUE : RT_FALSE;
+}
+
+/**
+ * Allocate memory from the heap regions with the placement hint first, then
+ * from the other regions, and the system heap when it is memheap too.
+ * The memory must be freed by rt_hw_free_hint.
+ */
+void* rt_hw_malloc_hint(rt_size_t size, rt_uint8_t hint)
+{
+    void* ptr = RT_NULL;
+    rt_ubase_t i;
+
+    for (i = 0; (ptr == RT_NULL) && (i < RT_HW_MEMHEAP_NUM); i++) {
+        if (rt_hw_memheap_valid(&rt_hw_memheaps[i]) && ((hint == RT_HEAP_HINT_ANY) || (rt_hw_memheaps[i].hint == hint))) {
+            ptr = rt_memheap_alloc(&rt_hw_memheaps[i].heap, size);
+        }
+    }
+    for (i = 0; (ptr == RT_NULL) && (hint != RT_HEAP_HINT_ANY) && (i < RT_HW_MEMHEAP_NUM); i++) {
+        if (rt_hw_memheap_valid(&rt_hw_memheaps[i]) && (rt_hw_memheaps[i].hint != hint)) {
+            ptr = rt_memheap_alloc(&rt_hw_memheaps[i].heap, size);
+        }
+    }
+#ifdef RT_USING_MEMHEAP_AS_HEAP
+    if (ptr == RT_NULL) {
+        ptr = rt_malloc(size);
+    }
+#endif
+    return ptr;
+}
+
+void rt_hw_free_hint(void* ptr)
+{
+    if (ptr != RT_NULL) {
+        rt_memheap_free(ptr);
+    }
+}
+#endif
+
+#ifndef RT_USING_SMP
+/*
+ * newlib malloc lock, scheduler is locked instead of disabling interrupts like the
+ * default one in SoC stubs, so malloc can't be called in interrupt handlers,
+ * rt_enter_critical nests so the lock is recursive, SMP uses the default one since
+ * critical section only locks scheduler of current cpu
+ */
+struct _reent;
+
+void __malloc_lock(struct _reent *reent)
+{
+    (void)reent;
+    rt_enter_critical();
+}
+
+void __malloc_unlock(struct _reent *reent)
+{
+    (void)reent;
+    rt_exit_critical();
+}
+#endif
+
+#if defined(NUCLEI_GPROF_TASK) && (NUCLEI_GPROF_TASK == 1)
+/* Thread interrupted by gprof sample interrupt, see gprof_api.h of profiling middleware */
+const void *gprof_current_task(const char **name)
+{
+    rt_thread_t thread = rt_thread_self();
+
+    if (thread != RT_NULL) {
+        *name = thread->name;
+    }
+    return thread;
+}
+#endif
+
+#if defined(NUCLEI_DLOG) && (NUCLEI_DLOG == 1)
+static void rt_hw_dlog_flush(void)
+{
+    dlog_flush();
+}
+
+/* Emit deferred log records to the same console as rt_kprintf */
+void dlog_port_output(const char* str, size_t len)
+{
+    (void)len;
+    rt_hw_console_output(str);
+}
 #endif
 
 /**
@@ -191,6 +696,9 @@ void rt_hw_board_init()
 {
     /* OS Tick Configuration */
     vPortSetupTimerInterrupt();
+#ifdef RT_USING_THREAD_PERF
+    rt_hw_perf_init();
+#endif
 
     /* Call components board initial (use INIT_BOARD_EXPORT()) */
 #ifdef RT_USING_COMPONENTS_INIT
@@ -201,6 +709,19 @@ void rt_hw_board_init()
     rt_system_heap_init(rt_heap_begin_get(), rt_heap_end_get());
 #endif
 
+#ifdef RT_USING_MEMHEAP
+    rt_hw_memheap_init();
+#endif
+
+#if defined(NUCLEI_STACK_MONITOR) && (NUCLEI_STACK_MONITOR == 1) && (defined(RT_USING_HOOK) || defined(RT_USING_IDLE_HOOK))
+    /* check stack high water mark of threads incrementally in idle thread */
+    rt_thread_idle_sethook(stackmon_scan);
+#endif
+#if defined(NUCLEI_DLOG) && (NUCLEI_DLOG == 1) && (defined(RT_USING_HOOK) || defined(RT_USING_IDLE_HOOK))
+    /* format and emit deferred log records in idle thread */
+    rt_thread_idle_sethook(rt_hw_dlog_flush);
+#endif
+
     __disable_irq();
 }
 
@@ -210,7 +731,13 @@ void rt_hw_board_init()
 void SysTick_Handler(void)
 {
     // Reload timer
+#if defined(RT_USING_PM) && !defined(RT_USING_SMP)
+    /* Tick boundaries are kept absolute, so ticks skipped in sleep can be counted from mtime */
+    rt_hw_next_tick_time += SYSTICK_TICK_CONST;
+    SysTimer_SetCompareValue(rt_hw_next_tick_time);
+#else
     SysTick_Reload(SYSTICK_TICK_CONST);
+#endif
 
     /* enter interrupt */
     rt_interrupt_enter();
@@ -233,13 +760,127 @@ void rt_hw_console_output(const char* str)
     }
 }
 
+#ifndef RT_HW_CONSOLE_POLL_MS
+#define RT_HW_CONSOLE_POLL_MS       10
+#endif
+
 char rt_hw_console_getchar(void)
 {
     char ch = -1;
+#if defined(NUCLEI_UART_BUFFERED) && (NUCLEI_UART_BUFFERED == 1)
+    uint8_t val;
+
+    // input is received into rx ring by interrupt, so finsh thread sleeps instead of spinning on uart,
+    // it doesn't return -1 since char is unsigned and finsh would take it as input
+    if ((SystemDebugUART.uart != NULL) && (rt_thread_self() != RT_NULL) && (rt_interrupt_get_nest() == 0)) {
+        while (uart_buffered_read(&SystemDebugUART, &val, 1, 0) != 1) {
+            rt_thread_mdelay(RT_HW_CONSOLE_POLL_MS);
+        }
+        return (char)val;
+    }
+#endif
     ch = (char)getchar();
     return ch;
 }
 
+#ifdef RT_USING_SMP
+rt_base_t rt_hw_local_irq_disable(void)
+{
+    return __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+}
+
+void rt_hw_local_irq_enable(rt_base_t level)
+{
+    __RV_CSR_WRITE(CSR_MSTATUS, level);
+}
+
+int rt_hw_cpu_id(void)
+{
+    return (int)__get_hart_index();
+}
+
+void rt_hw_spin_lock_init(rt_hw_spinlock_t *lock)
+{
+    lock->next = 0;
+    lock->owner = 0;
+    __RWMB();
+}
+
+/* Ticket lock using amoadd, same algorithm as TicketLock_Lock in NMSIS */
+void rt_hw_spin_lock(rt_hw_spinlock_t *lock)
+{
+    rt_uint32_t ticket = (rt_uint32_t)__AMOADD_W((volatile int32_t *)&lock->next, 1) - 1;
+
+    while (ticket != lock->owner) {
+        __NOP();
+    }
+    __FENCE(r, rw);
+}
+
+void rt_hw_spin_unlock(rt_hw_spinlock_t *lock)
+{
+    __FENCE(rw, w);
+    lock->owner = lock->owner + 1;
+}
+
+/* Send IPI through CLINT MSIP, which is the same SWI used for thread switch */
+void rt_hw_ipi_send(int ipi_vector, unsigned int cpu_mask)
+{
+    int cpu;
+
+    (void)ipi_vector;
+    for (cpu = 0; cpu < RT_CPUS_NR; cpu++) {
+        if (cpu_mask & (1UL << cpu)) {
+            SysTimer_SendIPI(cpu);
+        }
+    }
+    __RWMB();
+}
+
+/*
+ * Called by boot cpu in main thread, secondary cpus are waiting in smp_main
+ * since they are synced in startup code by __sync_harts.
+ */
+void rt_hw_secondary_cpu_up(void)
+{
+    __RWMB();
+    rt_secondary_cpu_start = 1;
+    __RWMB();
+}
+
+void rt_hw_secondary_cpu_idle_exec(void)
+{
+    __WFI();
+}
+
+/* Entry of all harts after __sync_harts in startup code */
+int smp_main(void)
+{
+    extern int rtthread_startup(void);
+
+    if (__get_hart_id() == BOOT_HARTID) {
+        /* Directly jump to rtthread startup process, no longer return */
+        rtthread_startup();
+    } else if (__get_hart_index() < RT_CPUS_NR) {
+        /* ECLIC SWI is not enabled yet, so poll instead of wfi */
+        while (rt_secondary_cpu_start == 0);
+        __RWMB();
+
+        /* Tick and SWI Configuration of this hart */
+        vPortSetupTimerInterrupt();
+#ifdef RT_USING_THREAD_PERF
+        rt_hw_perf_init();
+#endif
+        SysTimer_ClearSWIRQ();
+        rt_system_scheduler_start();
+    }
+    /* harts not used by rt-thread */
+    while (1) {
+        __WFI();
+    }
+    return 0;
+}
+#else
 rt_base_t rt_hw_interrupt_disable(void)
 {
     return __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
@@ -249,3 +890,242 @@ void rt_hw_interrupt_enable(rt_base_t level)
 {
     __RV_CSR_WRITE(CSR_MSTATUS, level);
 }
+#endif
+
+#if defined(NUCLEI_IRQ_STAT) && (NUCLEI_IRQ_STAT == 1)
+/**
+ * \brief Print or reset interrupt statistics recorded by ECLIC_Register_IRQ dispatcher
+ * \details
+ * Usage: irqstat [reset]
+ */
+static void irqstat(int argc, char *argv[])
+{
+    if ((argc > 1) && (rt_strcmp(argv[1], "reset") == 0)) {
+        IRQStat_Reset();
+        return;
+    }
+    IRQStat_Print();
+}
+MSH_CMD_EXPORT(irqstat, show interrupt statistics or reset it with irqstat reset)
+#endif
+
+#if defined(RT_USING_HEAP) || defined(RT_USING_MEMHEAP)
+#ifdef RT_USING_MEMHEAP
+/* walk the free list of memheap to get the fragmentation of it */
+static void memheap_free_info(struct rt_memheap* heap, rt_uint32_t* blocks, rt_uint32_t* largest)
+{
+    struct rt_memheap_item* item;
+    rt_ubase_t hdrsize = RT_ALIGN(sizeof(struct rt_memheap_item), RT_ALIGN_SIZE);
+    rt_ubase_t size;
+
+    *blocks = 0;
+    *largest = 0;
+    rt_sem_take(&heap->lock, RT_WAITING_FOREVER);
+    for (item = heap->free_list->next_free; item != heap->free_list; item = item->next_free) {
+        size = (rt_ubase_t)item->next - (rt_ubase_t)item - hdrsize;
+        *blocks += 1;
+        if (size > *largest) {
+            *largest = size;
+        }
+    }
+    rt_sem_release(&heap->lock);
+}
+
+static const char* memheap_hint_name(rt_uint8_t hint)
+{
+    switch (hint) {
+        case RT_HEAP_HINT_FAST: return "fast";
+        case RT_HEAP_HINT_BULK: return "bulk";
+        default: return "any";
+    }
+}
+#endif
+
+/**
+ * \brief Print usage of system heap and each memory heap region
+ * \details
+ * Usage: heapinfo
+ */
+static void heapinfo(int argc, char *argv[])
+{
+#if defined(RT_USING_HEAP) && !defined(RT_USING_MEMHEAP_AS_HEAP)
+    rt_uint32_t total = 0, used = 0, max_used = 0;
+
+    rt_memory_info(&total, &used, &max_used);
+    rt_kprintf("system heap: total %u, used %u, max used %u\n", total, used, max_used);
+#endif
+#ifdef RT_USING_MEMHEAP
+    rt_uint32_t blocks, largest;
+    rt_ubase_t i;
+
+    rt_kprintf("%-*s hint start      size       available  max used   free blocks largest free\n", RT_NAME_MAX, "memheap");
+    for (i = 0; i < RT_HW_MEMHEAP_NUM; i++) {
+        struct rt_hw_memheap_region* region = &rt_hw_memheaps[i];
+
+        if (rt_hw_memheap_valid(region) == RT_FALSE) {
+            rt_kprintf("%-*s %-4s not provided by linker script\n", RT_NAME_MAX, region->name, memheap_hint_name(region->hint));
+            continue;
+        }
+        memheap_free_info(&region->heap, &blocks, &largest);
+        rt_kprintf("%-*.*s %-4s 0x%08lx %-10u %-10u %-10u %-11u %u\n", RT_NAME_MAX, RT_NAME_MAX, region->heap.parent.name,
+                   memheap_hint_name(region->hint), (unsigned long)region->heap.start_addr, region->heap.pool_size,
+                   region->heap.available_size, region->heap.max_used_size, blocks, largest);
+    }
+#endif
+}
+MSH_CMD_EXPORT(heapinfo, show usage of system heap and memheap regions)
+#endif
+
+#ifndef RT_PERF_MAX_THREADS
+/* Max threads sampled by perf stat */
+#define RT_PERF_MAX_THREADS         32
+#endif
+
+#ifdef RT_USING_THREAD_CYCLES
+#ifdef RT_USING_SMP
+#define PERF_CPUS_NR                RT_CPUS_NR
+#else
+#define PERF_CPUS_NR                1
+#endif
+
+struct rt_perf_sample {
+    rt_thread_t thread;
+    rt_uint64_t cycles;
+#ifdef RT_USING_THREAD_PERF
+    rt_uint64_t perf[RT_THREAD_PERF_NUM];
+#endif
+};
+
+/* static to keep the stack of finsh thread small, perf stat is not reentrant */
+static struct rt_perf_sample perf_samples[RT_PERF_MAX_THREADS];
+static rt_object_t perf_threads[RT_PERF_MAX_THREADS];
+
+static void perf_sample(struct rt_perf_sample* sample, rt_thread_t thread)
+{
+    sample->thread = thread;
+    sample->cycles = rt_hw_thread_cycles_get(thread);
+#ifdef RT_USING_THREAD_PERF
+    rt_hw_thread_perf_get(thread, sample->perf);
+#endif
+}
+
+/* print x / y with 2 decimals without floating point */
+static void perf_print_ratio(rt_uint64_t x, rt_uint64_t y)
+{
+    rt_uint64_t r = (y != 0) ? (x * 100 / y) : 0;
+
+    rt_kprintf(" %4lu.%02lu", (unsigned long)(r / 100), (unsigned long)(r % 100));
+}
+
+static void perf_stat(rt_uint32_t ms)
+{
+    rt_uint64_t start, elapsed, delta;
+    struct rt_perf_sample now;
+    int count, found, i, j;
+
+    /* threads created in the window are not counted, deleted ones are dropped */
+    count = rt_object_get_pointers(RT_Object_Class_Thread, perf_threads, RT_PERF_MAX_THREADS);
+    for (i = 0; i < count; i++) {
+        perf_sample(&perf_samples[i], (rt_thread_t)perf_threads[i]);
+    }
+    start = rt_hw_cycles_get();
+    rt_thread_mdelay(ms);
+    elapsed = (rt_hw_cycles_get() - start) * PERF_CPUS_NR;
+
+    found = rt_object_get_pointers(RT_Object_Class_Thread, perf_threads, RT_PERF_MAX_THREADS);
+    rt_kprintf("perf stat of %u ms, %lu cycles on %d cpus\n", ms, (unsigned long)elapsed, PERF_CPUS_NR);
+#ifdef RT_USING_THREAD_PERF
+    rt_kprintf("%-*.*s     cycles    cpu%%      instret   ipc      hpm0      hpm1\n", RT_NAME_MAX, RT_NAME_MAX, "thread");
+#else
+    rt_kprintf("%-*.*s     cycles    cpu%%\n", RT_NAME_MAX, RT_NAME_MAX, "thread");
+#endif
+    for (i = 0; i < count; i++) {
+        for (j = 0; j < found; j++) {
+            if ((rt_thread_t)perf_threads[j] == perf_samples[i].thread) {
+                break;
+            }
+        }
+        if (j == found) {
+            continue;
+        }
+        perf_sample(&now, perf_samples[i].thread);
+        delta = now.cycles - perf_samples[i].cycles;
+        rt_kprintf("%-*.*s %10lu", RT_NAME_MAX, RT_NAME_MAX, now.thread->name, (unsigned long)delta);
+        perf_print_ratio(delta * 100, elapsed);
+#ifdef RT_USING_THREAD_PERF
+        rt_kprintf(" %12lu", (unsigned long)(now.perf[RT_THREAD_PERF_INSTRET] - perf_samples[i].perf[RT_THREAD_PERF_INSTRET]));
+        perf_print_ratio(now.perf[RT_THREAD_PERF_INSTRET] - perf_samples[i].perf[RT_THREAD_PERF_INSTRET], delta);
+        rt_kprintf(" %9lu %9lu", (unsigned long)(now.perf[RT_THREAD_PERF_HPM0] - perf_samples[i].perf[RT_THREAD_PERF_HPM0]),
+                   (unsigned long)(now.perf[RT_THREAD_PERF_HPM1] - perf_samples[i].perf[RT_THREAD_PERF_HPM1]));
+#endif
+        rt_kprintf("\n");
+    }
+#ifdef RT_USING_THREAD_PERF
+    rt_kprintf("hpm0 event 0x%lx, hpm1 event 0x%lx\n", (unsigned long)RT_PERF_HPM_EVENT0, (unsigned long)RT_PERF_HPM_EVENT1);
+#endif
+}
+#endif
+
+/**
+ * \brief Performance diagnosis commands
+ * \details
+ * Usage:
+ * - perf stat [ms]: cycles, cpu usage, instret, IPC and hpm events of each thread in ms window, default 1000
+ * - perf irq [reset]: per IRQ counts and cycles
+ * - perf heap: usage and fragmentation of heaps
+ */
+static void perf(int argc, char *argv[])
+{
+    if ((argc > 1) && (rt_strcmp(argv[1], "stat") == 0)) {
+#ifdef RT_USING_THREAD_CYCLES
+        perf_stat((argc > 2) ? (rt_uint32_t)atoi(argv[2]) : 1000);
+#else
+        rt_kprintf("Please define RT_USING_THREAD_CYCLES and RT_USING_THREAD_PERF in rtconfig.h\n");
+#endif
+    } else if ((argc > 1) && (rt_strcmp(argv[1], "irq") == 0)) {
+#if defined(NUCLEI_IRQ_STAT) && (NUCLEI_IRQ_STAT == 1)
+        if ((argc > 2) && (rt_strcmp(argv[2], "reset") == 0)) {
+            IRQStat_Reset();
+        } else {
+            IRQStat_Print();
+        }
+#else
+        rt_kprintf("Please compile with -DNUCLEI_IRQ_STAT=1\n");
+#endif
+    } else if ((argc > 1) && (rt_strcmp(argv[1], "heap") == 0)) {
+#if defined(RT_USING_HEAP) || defined(RT_USING_MEMHEAP)
+        heapinfo(argc, argv);
+#else
+        rt_kprintf("Please define RT_USING_HEAP or RT_USING_MEMHEAP in rtconfig.h\n");
+#endif
+    } else {
+        rt_kprintf("Usage: perf stat [ms] | perf irq [reset] | perf heap\n");
+    }
+}
+MSH_CMD_EXPORT(perf, performance diagnosis: perf stat [ms] / irq [reset] / heap)
+
+#if defined(RT_USING_PM) && !defined(RT_USING_SMP)
+/**
+ * \brief Print tickless idle statistics
+ * \details
+ * Usage: tickless
+ */
+static void tickless(int argc, char *argv[])
+{
+    struct rt_hw_pm_stats stats;
+
+    rt_hw_pm_stats_get(&stats);
+    rt_kprintf("sleeps %u, aborts %u, early wakeups %u\n", stats.sleeps, stats.aborts, stats.early_wakeups);
+    rt_kprintf("slept ticks %lu, compensated ticks %lu, slept counts %lu\n", (unsigned long)stats.slept_ticks,
+               (unsigned long)stats.compensated_ticks, (unsigned long)stats.slept_counts);
+}
+MSH_CMD_EXPORT(tickless, show tickless idle statistics)
+#endif
+
+#if defined(NUCLEI_STACK_MONITOR) && (NUCLEI_STACK_MONITOR == 1)
+static void stackmon(int argc, char *argv[])
+{
+    stackmon_report();
+}
+MSH_CMD_EXPORT(stackmon, show max stack usage of threads)
+#endif
@@ -13,6 +13,7 @@
 #define __CPUPORT_H__
 
 #include <rtconfig.h>
+#include <rtthread.h>
 #include <nuclei_sdk_soc.h>
 
 #ifdef __cplusplus
@@ -29,6 +30,31 @@ extern "C" {
         __RWMB();                                                                   \
     }
 
+#ifdef RT_USING_PM
+/* Tickless idle statistics, got by rt_hw_pm_stats_get() */
+struct rt_hw_pm_stats {
+    rt_uint32_t sleeps;             /* times of entering sleep */
+    rt_uint32_t aborts;             /* times of sleep abandoned before entering */
+    rt_uint32_t early_wakeups;      /* times of woken up by other interrupts before next timeout */
+    rt_uint64_t slept_ticks;        /* tick periods passed in sleep */
+    rt_uint64_t compensated_ticks;  /* tick periods stepped forward by rt_tick_set */
+    rt_uint64_t slept_counts;       /* SysTimer counts spent in sleep */
+};
+
+void rt_hw_pm_pre_sleep(rt_tick_t *ticks);
+void rt_hw_pm_post_sleep(rt_tick_t ticks);
+void rt_hw_pm_stats_get(struct rt_hw_pm_stats *stats);
+#endif
+
+#ifdef RT_USING_MEMHEAP
+/* Placement hints of memory heap regions defined by RT_MEMHEAP_REGIONS */
+#define RT_HEAP_HINT_ANY        0   /* no preference */
+#define RT_HEAP_HINT_FAST       1   /* hot small objects, such as DLM */
+#define RT_HEAP_HINT_BULK       2   /* large buffers, such as SRAM or DDR */
+
+void *rt_hw_malloc_hint(rt_size_t size, rt_uint8_t hint);
+void rt_hw_free_hint(void *ptr);
+#endif
 
 #ifdef __cplusplus
 }
@@ -19,6 +19,10 @@
 #include <rtthread.h>
 
 static rt_tick_t rt_tick = 0;
+#ifdef RT_USING_SMP
+/* cpu which increases the global tick and checks the timer list */
+static rt_uint8_t rt_tick_cpu = 0;
+#endif
 
 /**
  * This function will initialize system tick and set it to zero.
@@ -26,9 +30,14 @@ static rt_tick_t rt_tick = 0;
  *
  * @deprecated since 1.1.0, this function does not need to be invoked
  * in the system initialization.
+ *
+ * @note in smp version, it must be invoked by the cpu owning the system tick.
  */
 void rt_system_tick_init(void)
 {
+#ifdef RT_USING_SMP
+    rt_tick_cpu = (rt_uint8_t)rt_hw_cpu_id();
+#endif
 }
 
 /**
@@ -63,13 +72,26 @@ void rt_tick_set(rt_tick_t tick)
 /**
  * This function will notify kernel there is one tick passed. Normally,
  * this function is invoked by clock ISR.
+ *
+ * @note in smp version, it is invoked by clock ISR of each cpu, the time
+ * slice is checked on every cpu, while only the tick cpu increases the
+ * global tick and checks timers.
  */
 void rt_tick_increase(void)
 {
     struct rt_thread *thread;
+#ifdef RT_USING_SMP
+    rt_bool_t is_tick_cpu = (rt_hw_cpu_id() == rt_tick_cpu) ? RT_TRUE : RT_FALSE;
 
+    /* increase the global tick */
+    if (is_tick_cpu == RT_TRUE)
+    {
+        ++ rt_tick;
+    }
+#else
     /* increase the global tick */
     ++ rt_tick;
+#endif
 
     /* check time slice */
     thread = rt_thread_self();
@@ -85,7 +107,14 @@ void rt_tick_increase(void)
     }
 
     /* check timer */
+#ifdef RT_USING_SMP
+    if (is_tick_cpu == RT_TRUE)
+    {
+        rt_timer_check();
+    }
+#else
     rt_timer_check();
+#endif
 }
 
 /**
@@ -179,6 +179,11 @@ void main_thread_entry(void *parameter)
     /* RT-Thread components initialization */
     rt_components_init();
 #endif
+
+#ifdef RT_USING_SMP
+    /* start the secondary cpus after components initialized */
+    rt_hw_secondary_cpu_up();
+#endif
     /* invoke system main function */
 #if defined(__CC_ARM) || defined(__CLANG_ARM)
     $Super$$main(); /* for ARMCC. */
@@ -222,6 +227,9 @@ int rtthread_startup(void)
     /* show RT-Thread version */
     rt_show_version();
 
+    /* tick system initialization, the boot cpu owns system tick in smp version */
+    rt_system_tick_init();
+
     /* timer system initialization */
     rt_system_timer_init();
 
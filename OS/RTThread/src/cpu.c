@@ -11,4 +11,72 @@
 #include <rtthread.h>
 #include <rthw.h>
 
-/* nothing on non-smp version */
+#ifdef RT_USING_SMP
+static struct rt_cpu rt_cpus[RT_CPUS_NR];
+rt_hw_spinlock_t _cpus_lock;
+
+/**
+ * This function will return current cpu.
+ */
+struct rt_cpu *rt_cpu_self(void)
+{
+    return &rt_cpus[rt_hw_cpu_id()];
+}
+
+/**
+ * This function will return the cpu of the index.
+ */
+struct rt_cpu *rt_cpu_index(int index)
+{
+    return &rt_cpus[index];
+}
+
+/**
+ * This function will lock all cpus's scheduler and disable local irq.
+ *
+ * The lock nest is counted per cpu, because the thread switch only happens
+ * in the software interrupt of cpu, which can't be taken while the lock is
+ * held by this cpu.
+ *
+ * @return the level of local irq before locked
+ */
+rt_base_t rt_cpus_lock(void)
+{
+    rt_base_t level;
+    struct rt_cpu *pcpu;
+
+    level = rt_hw_local_irq_disable();
+
+    pcpu = rt_cpu_self();
+    /* scheduler not started, only this cpu is running */
+    if (pcpu->current_thread != RT_NULL)
+    {
+        if (pcpu->cpus_lock_nest ++ == 0)
+        {
+            rt_hw_spin_lock(&_cpus_lock);
+        }
+    }
+
+    return level;
+}
+
+/**
+ * This function will restore all cpus's scheduler and restore local irq.
+ *
+ * @param level the level of local irq returned by rt_cpus_lock
+ */
+void rt_cpus_unlock(rt_base_t level)
+{
+    struct rt_cpu *pcpu = rt_cpu_self();
+
+    if (pcpu->current_thread != RT_NULL && pcpu->cpus_lock_nest > 0)
+    {
+        if (-- pcpu->cpus_lock_nest == 0)
+        {
+            rt_hw_spin_unlock(&_cpus_lock);
+        }
+    }
+
+    rt_hw_local_irq_enable(level);
+}
+#endif /*RT_USING_SMP*/
@@ -34,11 +34,22 @@
 #endif
 #endif
 
+#ifdef RT_USING_SMP
+#define _CPUS_NR                RT_CPUS_NR
+#else
+#define _CPUS_NR                1
+#endif
+
 extern rt_list_t rt_thread_defunct;
 
-static struct rt_thread idle;
+static struct rt_thread idle[_CPUS_NR];
 ALIGN(RT_ALIGN_SIZE)
-static rt_uint8_t rt_thread_stack[IDLE_THREAD_STACK_SIZE];
+static rt_uint8_t rt_thread_stack[_CPUS_NR][IDLE_THREAD_STACK_SIZE];
+
+#ifdef RT_USING_SMP
+/* the cpu doing system background job, which initialized the idle threads */
+static int rt_thread_idle_cpu = 0;
+#endif
 
 #ifdef RT_USING_IDLE_HOOK
 #ifndef RT_IDLE_HOOK_LIST_SIZE
@@ -164,6 +175,14 @@ void rt_thread_idle_excute(void)
         thread = rt_list_entry(rt_thread_defunct.next,
                 struct rt_thread,
                 tlist);
+#ifdef RT_USING_SMP
+        /* it is still running on other cpu, check it in next loop */
+        if (thread->oncpu != RT_CPU_DETACHED)
+        {
+            rt_hw_interrupt_enable(lock);
+            break;
+        }
+#endif
         /* remove defunct thread */
         rt_list_remove(&(thread->tlist));
         /* release thread's stack */
@@ -178,6 +197,16 @@ void rt_thread_idle_excute(void)
 extern void rt_system_power_manager(void);
 static void rt_thread_idle_entry(void *parameter)
 {
+#ifdef RT_USING_SMP
+    if (rt_hw_cpu_id() != rt_thread_idle_cpu)
+    {
+        while (1)
+        {
+            rt_hw_secondary_cpu_idle_exec();
+        }
+    }
+#endif
+
     while (1)
     {
 
@@ -209,18 +238,36 @@ static void rt_thread_idle_entry(void *parameter)
  */
 void rt_thread_idle_init(void)
 {
-    /* initialize thread */
-    rt_thread_init(&idle,
-                   "tidle",
-                   rt_thread_idle_entry,
-                   RT_NULL,
-                   &rt_thread_stack[0],
-                   sizeof(rt_thread_stack),
-                   RT_THREAD_PRIORITY_MAX - 1,
-                   32);
-
-    /* startup */
-    rt_thread_startup(&idle);
+    rt_ubase_t i;
+    char tidle_name[RT_NAME_MAX];
+
+#ifdef RT_USING_SMP
+    rt_thread_idle_cpu = rt_hw_cpu_id();
+#endif
+
+    for (i = 0; i < _CPUS_NR; i++)
+    {
+#ifdef RT_USING_SMP
+        rt_sprintf(tidle_name, "%s%d", "tidle", (int)i);
+#else
+        rt_sprintf(tidle_name, "%s", "tidle");
+#endif
+        /* initialize thread */
+        rt_thread_init(&idle[i],
+                       tidle_name,
+                       rt_thread_idle_entry,
+                       RT_NULL,
+                       &rt_thread_stack[i][0],
+                       sizeof(rt_thread_stack[i]),
+                       RT_THREAD_PRIORITY_MAX - 1,
+                       32);
+#ifdef RT_USING_SMP
+        /* each cpu runs its own idle thread */
+        rt_thread_control(&idle[i], RT_THREAD_CTRL_BIND_CPU, (void *)i);
+#endif
+        /* startup */
+        rt_thread_startup(&idle[i]);
+    }
 }
 
 /**
@@ -231,5 +278,11 @@ void rt_thread_idle_init(void)
  */
 rt_thread_t rt_thread_idle_gethandler(void)
 {
-    return (rt_thread_t)(&idle);
+#ifdef RT_USING_SMP
+    register int id = rt_hw_cpu_id();
+#else
+    register int id = 0;
+#endif
+
+    return (rt_thread_t)(&idle[id]);
 }
@@ -48,6 +48,76 @@ extern void (*rt_object_take_hook)(struct rt_object *object);
 extern void (*rt_object_put_hook)(struct rt_object *object);
 #endif
 
+/*
+ * With RT_USING_IPC_FASTPATH, the uncontended semaphore and mutex take is done
+ * by compare and swap on semaphore value and mutex owner without disabling
+ * interrupt. All the other updates of semaphore value are also done by compare
+ * and swap, so a take interrupted between load and store will retry, the port
+ * must clear the load reservation when switching thread.
+ */
+#ifdef RT_USING_SEMAPHORE
+rt_inline rt_bool_t _sem_value_take(struct rt_semaphore *sem)
+{
+#ifdef RT_USING_IPC_FASTPATH
+    rt_uint32_t value = __atomic_load_n(&sem->value, __ATOMIC_RELAXED);
+
+    while (value > 0)
+    {
+        if (__atomic_compare_exchange_n(&sem->value, &value, value - 1, RT_FALSE,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            return RT_TRUE;
+    }
+
+    return RT_FALSE;
+#else
+    if (sem->value > 0)
+    {
+        sem->value --;
+
+        return RT_TRUE;
+    }
+
+    return RT_FALSE;
+#endif
+}
+
+rt_inline void _sem_value_set(struct rt_semaphore *sem, rt_uint32_t value, rt_bool_t increase)
+{
+#ifdef RT_USING_IPC_FASTPATH
+    rt_uint32_t old = __atomic_load_n(&sem->value, __ATOMIC_RELAXED);
+
+    while (!__atomic_compare_exchange_n(&sem->value, &old, increase ? old + 1 : value, RT_FALSE,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+#else
+    if (increase)
+        sem->value ++;
+    else
+        sem->value = (rt_uint16_t)value;
+#endif
+}
+#endif
+
+#ifdef RT_USING_MUTEX
+rt_inline rt_bool_t _mutex_owner_claim(struct rt_mutex *mutex, struct rt_thread *thread)
+{
+#ifdef RT_USING_IPC_FASTPATH
+    struct rt_thread *owner = RT_NULL;
+
+    return __atomic_compare_exchange_n(&mutex->owner, &owner, thread, RT_FALSE,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+#else
+    if (mutex->value > 0)
+    {
+        mutex->owner = thread;
+
+        return RT_TRUE;
+    }
+
+    return RT_FALSE;
+#endif
+}
+#endif
+
 /**
  * @addtogroup IPC
  */
@@ -334,6 +404,16 @@ rt_err_t rt_sem_take(rt_sem_t sem, rt_int32_t time)
 
     RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(sem->parent.parent)));
 
+#ifdef RT_USING_IPC_FASTPATH
+    /* semaphore is available, take it without disabling interrupt */
+    if (_sem_value_take(sem))
+    {
+        RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(sem->parent.parent)));
+
+        return RT_EOK;
+    }
+#endif
+
     /* disable interrupt */
     temp = rt_hw_interrupt_disable();
 
@@ -342,10 +422,9 @@ rt_err_t rt_sem_take(rt_sem_t sem, rt_int32_t time)
                                 ((struct rt_object *)sem)->name,
                                 sem->value));
 
-    if (sem->value > 0)
+    if (_sem_value_take(sem))
     {
         /* semaphore is available */
-        sem->value --;
 
         /* enable interrupt */
         rt_hw_interrupt_enable(temp);
@@ -461,7 +540,7 @@ rt_err_t rt_sem_release(rt_sem_t sem)
     {
         if(sem->value < RT_SEM_VALUE_MAX)
         {
-            sem->value ++; /* increase value */
+            _sem_value_set(sem, 0, RT_TRUE); /* increase value */
         }
         else
         {
@@ -510,7 +589,7 @@ rt_err_t rt_sem_control(rt_sem_t sem, int cmd, void *arg)
         rt_ipc_list_resume_all(&sem->parent.suspend_thread);
 
         /* set new value */
-        sem->value = (rt_uint16_t)value;
+        _sem_value_set(sem, (rt_uint16_t)value, RT_FALSE);
 
         /* enable interrupt */
         rt_hw_interrupt_enable(level);
@@ -670,6 +749,29 @@ rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t time)
     /* get current thread */
     thread = rt_thread_self();
 
+#ifdef RT_USING_IPC_FASTPATH
+    /* mutex has no owner, claim it without disabling interrupt */
+    if (mutex->owner == RT_NULL)
+    {
+        /* read before claim, owner priority may be raised by others as soon as claimed */
+        rt_uint8_t priority = thread->current_priority;
+
+        if (_mutex_owner_claim(mutex, thread))
+        {
+            RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(mutex->parent.parent)));
+
+            thread->error            = RT_EOK;
+            mutex->value             = 0;
+            mutex->original_priority = priority;
+            mutex->hold              = 1;
+
+            RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(mutex->parent.parent)));
+
+            return RT_EOK;
+        }
+    }
+#endif
+
     /* disable interrupt */
     temp = rt_hw_interrupt_disable();
 
@@ -700,13 +802,12 @@ rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t time)
         /* The value of mutex is 1 in initial status. Therefore, if the
          * value is great than 0, it indicates the mutex is avaible.
          */
-        if (mutex->value > 0)
+        if (_mutex_owner_claim(mutex, thread))
         {
             /* mutex is available */
             mutex->value --;
 
-            /* set mutex owner and original priority */
-            mutex->owner             = thread;
+            /* set mutex original priority */
             mutex->original_priority = thread->current_priority;
             if(mutex->hold < RT_MUTEX_HOLD_MAX)
             {
@@ -895,9 +996,13 @@ rt_err_t rt_mutex_release(rt_mutex_t mutex)
                 return -RT_EFULL; /* value overflowed */
             }
 
-            /* clear owner */
-            mutex->owner             = RT_NULL;
+            /* clear owner at last, mutex may be claimed without lock */
             mutex->original_priority = 0xff;
+#ifdef RT_USING_IPC_FASTPATH
+            __atomic_store_n(&mutex->owner, RT_NULL, __ATOMIC_RELEASE);
+#else
+            mutex->owner             = RT_NULL;
+#endif
         }
     }
 
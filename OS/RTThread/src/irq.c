@@ -49,7 +49,16 @@ void rt_interrupt_leave_sethook(void (*hook)(void))
 
 /**@{*/
 
+#ifdef RT_USING_SMP
+/* interrupt nest is per cpu, so local interrupt disable is enough to protect it */
+#define rt_interrupt_nest               rt_cpu_self()->irq_nest
+#define _irq_nest_lock()                rt_hw_local_irq_disable()
+#define _irq_nest_unlock(level)         rt_hw_local_irq_enable(level)
+#else
 volatile rt_uint8_t rt_interrupt_nest;
+#define _irq_nest_lock()                rt_hw_interrupt_disable()
+#define _irq_nest_unlock(level)         rt_hw_interrupt_enable(level)
+#endif /*RT_USING_SMP*/
 
 /**
  * This function will be invoked by BSP, when enter interrupt service routine
@@ -65,10 +74,10 @@ void rt_interrupt_enter(void)
     RT_DEBUG_LOG(RT_DEBUG_IRQ, ("irq coming..., irq nest:%d\n",
                                 rt_interrupt_nest));
 
-    level = rt_hw_interrupt_disable();
+    level = _irq_nest_lock();
     rt_interrupt_nest ++;
     RT_OBJECT_HOOK_CALL(rt_interrupt_enter_hook,());
-    rt_hw_interrupt_enable(level);
+    _irq_nest_unlock(level);
 }
 
 /**
@@ -85,10 +94,10 @@ void rt_interrupt_leave(void)
     RT_DEBUG_LOG(RT_DEBUG_IRQ, ("irq leave, irq nest:%d\n",
                                 rt_interrupt_nest));
 
-    level = rt_hw_interrupt_disable();
+    level = _irq_nest_lock();
     rt_interrupt_nest --;
     RT_OBJECT_HOOK_CALL(rt_interrupt_leave_hook,());
-    rt_hw_interrupt_enable(level);
+    _irq_nest_unlock(level);
 }
 
 /**
@@ -104,9 +113,9 @@ RT_WEAK rt_uint8_t rt_interrupt_get_nest(void)
     rt_uint8_t ret;
     rt_base_t level;
 
-    level = rt_hw_interrupt_disable();
+    level = _irq_nest_lock();
     ret = rt_interrupt_nest;
-    rt_hw_interrupt_enable(level);
+    _irq_nest_unlock(level);
     return ret;
 }
 
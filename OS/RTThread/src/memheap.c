@@ -599,7 +599,7 @@ void rt_system_heap_init(void *begin_addr, void *end_addr)
     rt_memheap_init(&_heap,
                     "heap",
                     begin_addr,
-                    (rt_uint32_t)end_addr - (rt_uint32_t)begin_addr);
+                    (rt_ubase_t)end_addr - (rt_ubase_t)begin_addr);
 }
 
 void *rt_malloc(rt_size_t size)
@@ -54,46 +54,96 @@ enum rt_object_info_type
 
 #define _OBJ_CONTAINER_LIST_INIT(c)     \
     {&(rt_object_container[c].object_list), &(rt_object_container[c].object_list)}
+#ifdef RT_USING_OBJECT_HASH
+#define _OBJ_CONTAINER_HASH_INIT        , {RT_NULL}
+#else
+#define _OBJ_CONTAINER_HASH_INIT
+#endif
 static struct rt_object_information rt_object_container[RT_Object_Info_Unknown] =
 {
     /* initialize object container - thread */
-    {RT_Object_Class_Thread, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_Thread), sizeof(struct rt_thread)},
+    {RT_Object_Class_Thread, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_Thread), sizeof(struct rt_thread) _OBJ_CONTAINER_HASH_INIT},
 #ifdef RT_USING_SEMAPHORE
     /* initialize object container - semaphore */
-    {RT_Object_Class_Semaphore, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_Semaphore), sizeof(struct rt_semaphore)},
+    {RT_Object_Class_Semaphore, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_Semaphore), sizeof(struct rt_semaphore) _OBJ_CONTAINER_HASH_INIT},
 #endif
 #ifdef RT_USING_MUTEX
     /* initialize object container - mutex */
-    {RT_Object_Class_Mutex, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_Mutex), sizeof(struct rt_mutex)},
+    {RT_Object_Class_Mutex, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_Mutex), sizeof(struct rt_mutex) _OBJ_CONTAINER_HASH_INIT},
 #endif
 #ifdef RT_USING_EVENT
     /* initialize object container - event */
-    {RT_Object_Class_Event, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_Event), sizeof(struct rt_event)},
+    {RT_Object_Class_Event, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_Event), sizeof(struct rt_event) _OBJ_CONTAINER_HASH_INIT},
 #endif
 #ifdef RT_USING_MAILBOX
     /* initialize object container - mailbox */
-    {RT_Object_Class_MailBox, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_MailBox), sizeof(struct rt_mailbox)},
+    {RT_Object_Class_MailBox, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_MailBox), sizeof(struct rt_mailbox) _OBJ_CONTAINER_HASH_INIT},
 #endif
 #ifdef RT_USING_MESSAGEQUEUE
     /* initialize object container - message queue */
-    {RT_Object_Class_MessageQueue, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_MessageQueue), sizeof(struct rt_messagequeue)},
+    {RT_Object_Class_MessageQueue, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_MessageQueue), sizeof(struct rt_messagequeue) _OBJ_CONTAINER_HASH_INIT},
 #endif
 #ifdef RT_USING_MEMHEAP
     /* initialize object container - memory heap */
-    {RT_Object_Class_MemHeap, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_MemHeap), sizeof(struct rt_memheap)},
+    {RT_Object_Class_MemHeap, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_MemHeap), sizeof(struct rt_memheap) _OBJ_CONTAINER_HASH_INIT},
 #endif
 #ifdef RT_USING_MEMPOOL
     /* initialize object container - memory pool */
-    {RT_Object_Class_MemPool, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_MemPool), sizeof(struct rt_mempool)},
+    {RT_Object_Class_MemPool, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_MemPool), sizeof(struct rt_mempool) _OBJ_CONTAINER_HASH_INIT},
 #endif
 #ifdef RT_USING_DEVICE
     /* initialize object container - device */
-    {RT_Object_Class_Device, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_Device), sizeof(struct rt_device)},
+    {RT_Object_Class_Device, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_Device), sizeof(struct rt_device) _OBJ_CONTAINER_HASH_INIT},
 #endif
     /* initialize object container - timer */
-    {RT_Object_Class_Timer, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_Timer), sizeof(struct rt_timer)},
+    {RT_Object_Class_Timer, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_Timer), sizeof(struct rt_timer) _OBJ_CONTAINER_HASH_INIT},
 };
 
+#ifdef RT_USING_OBJECT_HASH
+/*
+ * The objects of each class are also chained by name hash in hash_table of
+ * their information, so rt_object_find only compares the names in one bucket.
+ * Names are hashed up to RT_NAME_MAX characters, as rt_strncmp compares them.
+ */
+static rt_uint32_t _object_name_hash(const char *name)
+{
+    rt_uint32_t hash = 2166136261u;
+    rt_size_t index;
+
+    /* FNV-1a */
+    for (index = 0; (index < RT_NAME_MAX) && (name[index] != '\0'); index ++)
+    {
+        hash = (hash ^ (rt_uint8_t)name[index]) * 16777619u;
+    }
+
+    return hash % RT_OBJECT_HASH_BUCKETS;
+}
+
+static void _object_hash_insert(struct rt_object_information *information, struct rt_object *object)
+{
+    struct rt_object **bucket = &(information->hash_table[_object_name_hash(object->name)]);
+
+    object->hash_next = *bucket;
+    *bucket = object;
+}
+
+static void _object_hash_remove(struct rt_object_information *information, struct rt_object *object)
+{
+    struct rt_object **prev = &(information->hash_table[_object_name_hash(object->name)]);
+
+    while (*prev != RT_NULL)
+    {
+        if (*prev == object)
+        {
+            *prev = object->hash_next;
+            break;
+        }
+        prev = &((*prev)->hash_next);
+    }
+    object->hash_next = RT_NULL;
+}
+#endif
+
 #ifdef RT_USING_HOOK
 static void (*rt_object_attach_hook)(struct rt_object *object);
 static void (*rt_object_detach_hook)(struct rt_object *object);
@@ -339,6 +389,9 @@ void rt_object_init(struct rt_object         *object,
 
     /* insert object into information object list */
     rt_list_insert_after(&(information->object_list), &(object->list));
+#ifdef RT_USING_OBJECT_HASH
+    _object_hash_insert(information, object);
+#endif
 
     /* unlock interrupt */
     rt_hw_interrupt_enable(temp);
@@ -353,10 +406,19 @@ void rt_object_init(struct rt_object         *object,
 void rt_object_detach(rt_object_t object)
 {
     register rt_base_t temp;
+#ifdef RT_USING_OBJECT_HASH
+    struct rt_object_information *information;
+#endif
 
     /* object check */
     RT_ASSERT(object != RT_NULL);
 
+#ifdef RT_USING_OBJECT_HASH
+    /* get object information before the type is reset */
+    information = rt_object_get_information((enum rt_object_class_type)(object->type & ~RT_Object_Class_Static));
+    RT_ASSERT(information != RT_NULL);
+#endif
+
     RT_OBJECT_HOOK_CALL(rt_object_detach_hook, (object));
 
     /* reset object type */
@@ -367,6 +429,9 @@ void rt_object_detach(rt_object_t object)
 
     /* remove from old list */
     rt_list_remove(&(object->list));
+#ifdef RT_USING_OBJECT_HASH
+    _object_hash_remove(information, object);
+#endif
 
     /* unlock interrupt */
     rt_hw_interrupt_enable(temp);
@@ -421,6 +486,9 @@ rt_object_t rt_object_allocate(enum rt_object_class_type type, const char *name)
 
     /* insert object into information object list */
     rt_list_insert_after(&(information->object_list), &(object->list));
+#ifdef RT_USING_OBJECT_HASH
+    _object_hash_insert(information, object);
+#endif
 
     /* unlock interrupt */
     rt_hw_interrupt_enable(temp);
@@ -437,11 +505,20 @@ rt_object_t rt_object_allocate(enum rt_object_class_type type, const char *name)
 void rt_object_delete(rt_object_t object)
 {
     register rt_base_t temp;
+#ifdef RT_USING_OBJECT_HASH
+    struct rt_object_information *information;
+#endif
 
     /* object check */
     RT_ASSERT(object != RT_NULL);
     RT_ASSERT(!(object->type & RT_Object_Class_Static));
 
+#ifdef RT_USING_OBJECT_HASH
+    /* get object information before the type is reset */
+    information = rt_object_get_information((enum rt_object_class_type)object->type);
+    RT_ASSERT(information != RT_NULL);
+#endif
+
     RT_OBJECT_HOOK_CALL(rt_object_detach_hook, (object));
 
     /* reset object type */
@@ -452,6 +529,9 @@ void rt_object_delete(rt_object_t object)
 
     /* remove from old list */
     rt_list_remove(&(object->list));
+#ifdef RT_USING_OBJECT_HASH
+    _object_hash_remove(information, object);
+#endif
 
     /* unlock interrupt */
     rt_hw_interrupt_enable(temp);
@@ -512,7 +592,9 @@ rt_uint8_t rt_object_get_type(rt_object_t object)
 rt_object_t rt_object_find(const char *name, rt_uint8_t type)
 {
     struct rt_object *object = RT_NULL;
+#ifndef RT_USING_OBJECT_HASH
     struct rt_list_node *node = RT_NULL;
+#endif
     struct rt_object_information *information = RT_NULL;
 
     information = rt_object_get_information((enum rt_object_class_type)type);
@@ -527,6 +609,20 @@ rt_object_t rt_object_find(const char *name, rt_uint8_t type)
     rt_enter_critical();
 
     /* try to find object */
+#ifdef RT_USING_OBJECT_HASH
+    for (object = information->hash_table[_object_name_hash(name)];
+            object != RT_NULL;
+            object = object->hash_next)
+    {
+        if (rt_strncmp(object->name, name, RT_NAME_MAX) == 0)
+        {
+            /* leave critical */
+            rt_exit_critical();
+
+            return object;
+        }
+    }
+#else
     rt_list_for_each(node, &(information->object_list))
     {
         object = rt_list_entry(node, struct rt_object, list);
@@ -538,6 +634,7 @@ rt_object_t rt_object_find(const char *name, rt_uint8_t type)
             return object;
         }
     }
+#endif
 
     /* leave critical */
     rt_exit_critical();
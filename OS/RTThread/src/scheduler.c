@@ -42,10 +42,12 @@ rt_uint8_t rt_thread_ready_table[32];
 #endif
 
 
+#ifndef RT_USING_SMP
 extern volatile rt_uint8_t rt_interrupt_nest;
 static rt_int16_t rt_scheduler_lock_nest;
 struct rt_thread *rt_current_thread = RT_NULL;
 rt_uint8_t rt_current_priority;
+#endif /*RT_USING_SMP*/
 
 
 rt_list_t rt_thread_defunct;
@@ -116,6 +118,199 @@ static void _rt_scheduler_stack_check(struct rt_thread *thread)
 }
 #endif
 
+#ifdef RT_USING_SMP
+/*
+ * Get the highest ready priority of a ready queue described by the priority
+ * group and ready table, RT_THREAD_PRIORITY_MAX is returned if it is empty.
+ */
+#if RT_THREAD_PRIORITY_MAX > 32
+static rt_ubase_t _get_highest_priority(rt_uint32_t group, rt_uint8_t *ready_table)
+{
+    register rt_ubase_t number;
+
+    if (group == 0)
+        return RT_THREAD_PRIORITY_MAX;
+
+    number = __rt_ffs(group) - 1;
+    return (number << 3) + __rt_ffs(ready_table[number]) - 1;
+}
+#define _HIGHEST_PRIORITY(group, table) _get_highest_priority(group, table)
+#else
+static rt_ubase_t _get_highest_priority(rt_uint32_t group)
+{
+    if (group == 0)
+        return RT_THREAD_PRIORITY_MAX;
+
+    return __rt_ffs(group) - 1;
+}
+#define _HIGHEST_PRIORITY(group, table) _get_highest_priority(group)
+#endif
+
+/*
+ * Find the highest priority ready thread which can run on the cpu, threads
+ * bound to this cpu win when they have the same priority as unbound ones.
+ *
+ * @return the thread found, RT_NULL if no thread is ready for this cpu
+ */
+static struct rt_thread *_get_highest_priority_thread(struct rt_cpu *pcpu,
+                                                      rt_ubase_t *highest_prio)
+{
+    register rt_ubase_t highest_ready_priority, local_highest_ready_priority;
+
+    highest_ready_priority = _HIGHEST_PRIORITY(rt_thread_ready_priority_group,
+                                               rt_thread_ready_table);
+    local_highest_ready_priority = _HIGHEST_PRIORITY(pcpu->priority_group,
+                                                     pcpu->ready_table);
+
+    if (local_highest_ready_priority <= highest_ready_priority)
+    {
+        *highest_prio = local_highest_ready_priority;
+        if (local_highest_ready_priority == RT_THREAD_PRIORITY_MAX)
+            return RT_NULL;
+
+        return rt_list_entry(pcpu->priority_table[local_highest_ready_priority].next,
+                             struct rt_thread,
+                             tlist);
+    }
+
+    *highest_prio = highest_ready_priority;
+    return rt_list_entry(rt_thread_priority_table[highest_ready_priority].next,
+                         struct rt_thread,
+                         tlist);
+}
+
+/*
+ * Insert a ready thread into the global ready queue, or the ready queue of
+ * the cpu it is bound to. The running threads are never in ready queue.
+ */
+static void _scheduler_enqueue(struct rt_thread *thread, rt_bool_t front)
+{
+    rt_list_t *priority_table = rt_thread_priority_table;
+    rt_uint32_t *priority_group = &rt_thread_ready_priority_group;
+#if RT_THREAD_PRIORITY_MAX > 32
+    rt_uint8_t *ready_table = rt_thread_ready_table;
+#endif
+
+    if (thread->bind_cpu != RT_CPUS_NR)
+    {
+        struct rt_cpu *pcpu = rt_cpu_index(thread->bind_cpu);
+
+        priority_table = pcpu->priority_table;
+        priority_group = &pcpu->priority_group;
+#if RT_THREAD_PRIORITY_MAX > 32
+        ready_table = pcpu->ready_table;
+#endif
+    }
+
+    if (front == RT_TRUE)
+    {
+        rt_list_insert_after(&(priority_table[thread->current_priority]),
+                             &(thread->tlist));
+    }
+    else
+    {
+        rt_list_insert_before(&(priority_table[thread->current_priority]),
+                              &(thread->tlist));
+    }
+
+#if RT_THREAD_PRIORITY_MAX > 32
+    ready_table[thread->number] |= thread->high_mask;
+#endif
+    *priority_group |= thread->number_mask;
+}
+
+/*
+ * Remove a thread from the ready queue it is inserted into.
+ */
+static void _scheduler_dequeue(struct rt_thread *thread)
+{
+    rt_list_t *priority_table = rt_thread_priority_table;
+    rt_uint32_t *priority_group = &rt_thread_ready_priority_group;
+#if RT_THREAD_PRIORITY_MAX > 32
+    rt_uint8_t *ready_table = rt_thread_ready_table;
+#endif
+
+    if (thread->bind_cpu != RT_CPUS_NR)
+    {
+        struct rt_cpu *pcpu = rt_cpu_index(thread->bind_cpu);
+
+        priority_table = pcpu->priority_table;
+        priority_group = &pcpu->priority_group;
+#if RT_THREAD_PRIORITY_MAX > 32
+        ready_table = pcpu->ready_table;
+#endif
+    }
+
+    rt_list_remove(&(thread->tlist));
+    if (rt_list_isempty(&(priority_table[thread->current_priority])))
+    {
+#if RT_THREAD_PRIORITY_MAX > 32
+        ready_table[thread->number] &= ~thread->high_mask;
+        if (ready_table[thread->number] == 0)
+        {
+            *priority_group &= ~thread->number_mask;
+        }
+#else
+        *priority_group &= ~thread->number_mask;
+#endif
+    }
+}
+
+/*
+ * Send schedule IPI to the other cpus which run a lower priority thread than
+ * the new ready thread, only the bound cpu is checked for a bound thread.
+ */
+static void _scheduler_notify(struct rt_thread *thread, int cpu_id)
+{
+    rt_uint32_t cpu_mask = 0;
+    int cpu;
+
+    for (cpu = 0; cpu < RT_CPUS_NR; cpu ++)
+    {
+        struct rt_thread *current_thread = rt_cpu_index(cpu)->current_thread;
+
+        if (cpu == cpu_id || current_thread == RT_NULL)
+            continue;
+        if (thread->bind_cpu != RT_CPUS_NR && thread->bind_cpu != cpu)
+            continue;
+        if (thread->current_priority < current_thread->current_priority)
+            cpu_mask |= 1 << cpu;
+    }
+
+    if (cpu_mask)
+    {
+        rt_hw_ipi_send(RT_SCHEDULE_IPI, cpu_mask);
+    }
+}
+
+/*
+ * Check whether current thread of the cpu should be switched out.
+ */
+static rt_bool_t _scheduler_need_switch(struct rt_cpu *pcpu, int cpu_id)
+{
+    struct rt_thread *current_thread = pcpu->current_thread;
+    rt_ubase_t highest_ready_priority;
+
+    if (pcpu->scheduler_lock_nest > 0)
+        return RT_FALSE;
+
+    /* suspended or closed, or bound to another cpu */
+    if ((current_thread->stat & RT_THREAD_STAT_MASK) != RT_THREAD_READY)
+        return RT_TRUE;
+    if (current_thread->bind_cpu != RT_CPUS_NR && current_thread->bind_cpu != cpu_id)
+        return RT_TRUE;
+
+    _get_highest_priority_thread(pcpu, &highest_ready_priority);
+    if (highest_ready_priority < current_thread->current_priority)
+        return RT_TRUE;
+    if (highest_ready_priority == current_thread->current_priority &&
+        (current_thread->stat & RT_THREAD_STAT_YIELD_MASK))
+        return RT_TRUE;
+
+    return RT_FALSE;
+}
+#endif /*RT_USING_SMP*/
+
 /**
  * @ingroup SystemInit
  * This function will initialize the system scheduler
@@ -123,8 +318,11 @@ static void _rt_scheduler_stack_check(struct rt_thread *thread)
 void rt_system_scheduler_init(void)
 {
     register rt_base_t offset;
-
+#ifdef RT_USING_SMP
+    int cpu;
+#else
     rt_scheduler_lock_nest = 0;
+#endif
 
     RT_DEBUG_LOG(RT_DEBUG_SCHEDULER, ("start scheduler: max priority 0x%02x\n",
                                       RT_THREAD_PRIORITY_MAX));
@@ -134,8 +332,31 @@ void rt_system_scheduler_init(void)
         rt_list_init(&rt_thread_priority_table[offset]);
     }
 
+#ifdef RT_USING_SMP
+    for (cpu = 0; cpu < RT_CPUS_NR; cpu ++)
+    {
+        struct rt_cpu *pcpu = rt_cpu_index(cpu);
+
+        for (offset = 0; offset < RT_THREAD_PRIORITY_MAX; offset ++)
+        {
+            rt_list_init(&pcpu->priority_table[offset]);
+        }
+
+        pcpu->irq_nest = 0;
+        pcpu->cpus_lock_nest = 0;
+        pcpu->scheduler_lock_nest = 0;
+        pcpu->current_priority = RT_THREAD_PRIORITY_MAX - 1;
+        pcpu->current_thread = RT_NULL;
+        pcpu->priority_group = 0;
+
+#if RT_THREAD_PRIORITY_MAX > 32
+        rt_memset(pcpu->ready_table, 0, sizeof(pcpu->ready_table));
+#endif
+    }
+#else
     rt_current_priority = RT_THREAD_PRIORITY_MAX - 1;
     rt_current_thread = RT_NULL;
+#endif /*RT_USING_SMP*/
 
     /* initialize ready priority group */
     rt_thread_ready_priority_group = 0;
@@ -153,7 +374,40 @@ void rt_system_scheduler_init(void)
  * @ingroup SystemInit
  * This function will startup scheduler. It will select one thread
  * with the highest priority level, then switch to it.
+ *
+ * @note in smp version, it is invoked by each cpu.
  */
+#ifdef RT_USING_SMP
+void rt_system_scheduler_start(void)
+{
+    register struct rt_thread *to_thread;
+    rt_ubase_t highest_ready_priority;
+    struct rt_cpu *pcpu;
+    int cpu_id;
+
+    rt_hw_local_irq_disable();
+    rt_hw_spin_lock(&_cpus_lock);
+
+    cpu_id = rt_hw_cpu_id();
+    pcpu = rt_cpu_index(cpu_id);
+
+    /* the idle thread bound to this cpu is always ready */
+    to_thread = _get_highest_priority_thread(pcpu, &highest_ready_priority);
+    RT_ASSERT(to_thread != RT_NULL);
+
+    _scheduler_dequeue(to_thread);
+    to_thread->oncpu = cpu_id;
+    pcpu->current_priority = (rt_uint8_t)highest_ready_priority;
+    pcpu->current_thread = to_thread;
+
+    rt_hw_spin_unlock(&_cpus_lock);
+
+    /* switch to new thread */
+    rt_hw_context_switch_to((rt_ubase_t)&to_thread->sp);
+
+    /* never come back */
+}
+#else
 void rt_system_scheduler_start(void)
 {
     register struct rt_thread *to_thread;
@@ -180,6 +434,7 @@ void rt_system_scheduler_start(void)
 
     /* never come back */
 }
+#endif /*RT_USING_SMP*/
 
 /**
  * @addtogroup Thread
@@ -187,6 +442,114 @@ void rt_system_scheduler_start(void)
 
 /**@{*/
 
+#ifdef RT_USING_SMP
+/**
+ * This function will perform one schedule. In smp version, the switch is
+ * deferred to the software interrupt of this cpu, which calls
+ * rt_schedule_switch to select the highest priority thread after the
+ * context of current thread is saved.
+ */
+void rt_schedule(void)
+{
+    rt_base_t level;
+    struct rt_cpu *pcpu;
+    int cpu_id;
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    cpu_id = rt_hw_cpu_id();
+    pcpu = rt_cpu_index(cpu_id);
+
+    if (pcpu->current_thread != RT_NULL)
+    {
+        if (_scheduler_need_switch(pcpu, cpu_id) == RT_TRUE)
+        {
+            RT_DEBUG_LOG(RT_DEBUG_SCHEDULER, ("cpu%d request switch\n", cpu_id));
+
+            /* pend a schedule on this cpu, taken when interrupt enabled */
+            rt_hw_ipi_send(RT_SCHEDULE_IPI, 1 << cpu_id);
+        }
+        else if (pcpu->scheduler_lock_nest == 0)
+        {
+            /* no same priority thread to yield to */
+            pcpu->current_thread->stat &= ~RT_THREAD_STAT_YIELD_MASK;
+        }
+    }
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * This function will select the thread to run on this cpu, it is invoked by
+ * the software interrupt handler of cpu port after the context of current
+ * thread is saved, and the context of returned thread is restored.
+ *
+ * @return the thread to run, which is current thread if no switch is needed
+ *
+ * @note Please do not invoke this function in user application.
+ */
+struct rt_thread *rt_schedule_switch(void)
+{
+    rt_base_t level;
+    rt_ubase_t highest_ready_priority;
+    struct rt_thread *to_thread;
+    struct rt_thread *from_thread;
+    struct rt_cpu *pcpu;
+    int cpu_id;
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    cpu_id = rt_hw_cpu_id();
+    pcpu = rt_cpu_index(cpu_id);
+    from_thread = pcpu->current_thread;
+    to_thread = from_thread;
+
+    if (_scheduler_need_switch(pcpu, cpu_id) == RT_TRUE)
+    {
+        to_thread = _get_highest_priority_thread(pcpu, &highest_ready_priority);
+        RT_ASSERT(to_thread != RT_NULL);
+
+        _scheduler_dequeue(to_thread);
+        to_thread->oncpu = cpu_id;
+        pcpu->current_priority = (rt_uint8_t)highest_ready_priority;
+        pcpu->current_thread = to_thread;
+
+        from_thread->oncpu = RT_CPU_DETACHED;
+        if ((from_thread->stat & RT_THREAD_STAT_MASK) == RT_THREAD_READY)
+        {
+            /* preempted thread keeps its place, yielded one goes to the end */
+            _scheduler_enqueue(from_thread, (from_thread->stat & RT_THREAD_STAT_YIELD_MASK) ?
+                               RT_FALSE : RT_TRUE);
+            /* it may run on a cpu with lower priority thread */
+            _scheduler_notify(from_thread, cpu_id);
+        }
+        from_thread->stat &= ~RT_THREAD_STAT_YIELD_MASK;
+
+        RT_OBJECT_HOOK_CALL(rt_scheduler_hook, (from_thread, to_thread));
+
+        RT_DEBUG_LOG(RT_DEBUG_SCHEDULER,
+                     ("[%d]cpu%d switch to priority#%d "
+                      "thread:%.*s(sp:0x%p), "
+                      "from thread:%.*s(sp: 0x%p)\n",
+                      pcpu->irq_nest, cpu_id, highest_ready_priority,
+                      RT_NAME_MAX, to_thread->name, to_thread->sp,
+                      RT_NAME_MAX, from_thread->name, from_thread->sp));
+
+#ifdef RT_USING_OVERFLOW_CHECK
+        _rt_scheduler_stack_check(to_thread);
+#endif
+    }
+    to_thread->stat &= ~RT_THREAD_STAT_YIELD_MASK;
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+
+    return to_thread;
+}
+#else
 /**
  * This function will perform one schedule. It will select one thread
  * with the highest priority level, then switch to it.
@@ -264,6 +627,7 @@ void rt_schedule(void)
     /* enable interrupt */
     rt_hw_interrupt_enable(level);
 }
+#endif /*RT_USING_SMP*/
 
 /*
  * This function will insert a thread to system ready queue. The state of
@@ -284,9 +648,24 @@ void rt_schedule_insert_thread(struct rt_thread *thread)
     /* change stat */
     thread->stat = RT_THREAD_READY | (thread->stat & ~RT_THREAD_STAT_MASK);
 
+#ifdef RT_USING_SMP
+    if (thread->oncpu != RT_CPU_DETACHED)
+    {
+        /* running thread is not in ready queue, let its cpu check priority */
+        if (thread->oncpu != rt_hw_cpu_id())
+        {
+            rt_hw_ipi_send(RT_SCHEDULE_IPI, 1 << thread->oncpu);
+        }
+        goto __exit;
+    }
+
+    /* insert thread to ready list of its cpu, or the global one */
+    _scheduler_enqueue(thread, RT_FALSE);
+#else
     /* insert thread to ready list */
     rt_list_insert_before(&(rt_thread_priority_table[thread->current_priority]),
                           &(thread->tlist));
+#endif /*RT_USING_SMP*/
 
     /* set priority mask */
 #if RT_THREAD_PRIORITY_MAX <= 32
@@ -302,10 +681,17 @@ void rt_schedule_insert_thread(struct rt_thread *thread)
                   thread->high_mask));
 #endif
 
+#ifdef RT_USING_SMP
+    /* preempt the other cpu running lower priority thread */
+    _scheduler_notify(thread, rt_hw_cpu_id());
+
+__exit:
+#else
 #if RT_THREAD_PRIORITY_MAX > 32
     rt_thread_ready_table[thread->number] |= thread->high_mask;
 #endif
     rt_thread_ready_priority_group |= thread->number_mask;
+#endif /*RT_USING_SMP*/
 
     /* enable interrupt */
     rt_hw_interrupt_enable(temp);
@@ -341,6 +727,18 @@ void rt_schedule_remove_thread(struct rt_thread *thread)
                   thread->high_mask));
 #endif
 
+#ifdef RT_USING_SMP
+    if (thread->oncpu == RT_CPU_DETACHED)
+    {
+        /* remove thread from ready list */
+        _scheduler_dequeue(thread);
+    }
+    else if (thread->oncpu != rt_hw_cpu_id())
+    {
+        /* let the cpu running it switch to another thread */
+        rt_hw_ipi_send(RT_SCHEDULE_IPI, 1 << thread->oncpu);
+    }
+#else
     /* remove thread from ready list */
     rt_list_remove(&(thread->tlist));
     if (rt_list_isempty(&(rt_thread_priority_table[thread->current_priority])))
@@ -355,11 +753,97 @@ void rt_schedule_remove_thread(struct rt_thread *thread)
         rt_thread_ready_priority_group &= ~thread->number_mask;
 #endif
     }
+#endif /*RT_USING_SMP*/
 
     /* enable interrupt */
     rt_hw_interrupt_enable(temp);
 }
 
+#ifdef RT_USING_SMP
+/**
+ * This function will lock the thread scheduler.
+ *
+ * @note in smp version, the cpus lock is held until the scheduler is
+ * unlocked, so the other cpus are excluded from kernel objects too.
+ */
+void rt_enter_critical(void)
+{
+    register rt_base_t level;
+    struct rt_cpu *pcpu;
+
+    /* disable local interrupt */
+    level = rt_hw_local_irq_disable();
+
+    pcpu = rt_cpu_self();
+    if (pcpu->current_thread != RT_NULL)
+    {
+        if (pcpu->cpus_lock_nest ++ == 0)
+        {
+            rt_hw_spin_lock(&_cpus_lock);
+        }
+    }
+
+    pcpu->scheduler_lock_nest ++;
+
+    /* enable local interrupt */
+    rt_hw_local_irq_enable(level);
+}
+
+/**
+ * This function will unlock the thread scheduler.
+ */
+void rt_exit_critical(void)
+{
+    register rt_base_t level;
+    struct rt_cpu *pcpu;
+
+    /* disable local interrupt */
+    level = rt_hw_local_irq_disable();
+
+    pcpu = rt_cpu_self();
+    if (pcpu->current_thread != RT_NULL && pcpu->cpus_lock_nest > 0)
+    {
+        if (-- pcpu->cpus_lock_nest == 0)
+        {
+            rt_hw_spin_unlock(&_cpus_lock);
+        }
+    }
+
+    if (pcpu->scheduler_lock_nest > 0)
+    {
+        pcpu->scheduler_lock_nest --;
+    }
+
+    if (pcpu->scheduler_lock_nest == 0)
+    {
+        struct rt_thread *current_thread = pcpu->current_thread;
+
+        /* enable local interrupt */
+        rt_hw_local_irq_enable(level);
+
+        if (current_thread)
+        {
+            /* if scheduler is started, do a schedule */
+            rt_schedule();
+        }
+    }
+    else
+    {
+        /* enable local interrupt */
+        rt_hw_local_irq_enable(level);
+    }
+}
+
+/**
+ * Get the scheduler lock level of current cpu
+ *
+ * @return the level of the scheduler lock. 0 means unlocked.
+ */
+rt_uint16_t rt_critical_level(void)
+{
+    return rt_cpu_self()->scheduler_lock_nest;
+}
+#else
 /**
  * This function will lock the thread scheduler.
  */
@@ -419,5 +903,6 @@ rt_uint16_t rt_critical_level(void)
 {
     return rt_scheduler_lock_nest;
 }
+#endif /*RT_USING_SMP*/
 /**@}*/
 
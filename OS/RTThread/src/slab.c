@@ -216,6 +216,10 @@ struct memusage
 static struct memusage *memusage = RT_NULL;
 #define btokup(addr)    \
     (&memusage[((rt_ubase_t)(addr) - heap_start) >> RT_MM_PAGE_BITS])
+/* zone of a small chunk, found by page offset in memusage */
+#define SLAB_ZONE_OF(addr)  \
+    ((slab_zone *)(((rt_ubase_t)(addr) & ~RT_MM_PAGE_MASK) - \
+                   btokup((rt_ubase_t)(addr) & ~RT_MM_PAGE_MASK)->size * RT_MM_PAGE_SIZE))
 
 static rt_ubase_t heap_start, heap_end;
 
@@ -456,84 +460,23 @@ rt_inline int zoneindex(rt_size_t *bytes)
     return 0;
 }
 
-/**
- * @addtogroup MM
- */
-
-/**@{*/
-
-/**
- * This function will allocate a block from system heap memory.
- * - If the nbytes is less than zero,
- * or
- * - If there is no nbytes sized memory valid in system,
- * the RT_NULL is returned.
- *
- * @param size the size of memory to be allocated
- *
- * @return the allocated memory
+/*
+ * Allocate a chunk of size bytes from the zones of index zi, a new zone is
+ * taken when all of them are exhausted. Called with heap_sem held, which is
+ * still held on return, RT_NULL is returned if no page is left for the zone.
  */
-void *rt_malloc(rt_size_t size)
+static slab_chunk *slab_zone_alloc(rt_int32_t zi, rt_size_t size)
 {
     slab_zone *z;
-    rt_int32_t zi;
     slab_chunk *chunk;
     struct memusage *kup;
 
-    /* zero size, return RT_NULL */
-    if (size == 0)
-        return RT_NULL;
-
-    /*
-     * Handle large allocations directly.  There should not be very many of
-     * these so performance is not a big issue.
-     */
-    if (size >= zone_limit)
-    {
-        size = RT_ALIGN(size, RT_MM_PAGE_SIZE);
-
-        chunk = rt_page_alloc(size >> RT_MM_PAGE_BITS);
-        if (chunk == RT_NULL)
-            return RT_NULL;
-
-        /* set kup */
-        kup = btokup(chunk);
-        kup->type = PAGE_TYPE_LARGE;
-        kup->size = size >> RT_MM_PAGE_BITS;
-
-        RT_DEBUG_LOG(RT_DEBUG_SLAB,
-                     ("malloc a large memory 0x%x, page cnt %d, kup %d\n",
-                      size,
-                      size >> RT_MM_PAGE_BITS,
-                      ((rt_ubase_t)chunk - heap_start) >> RT_MM_PAGE_BITS));
-
-        /* lock heap */
-        rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
-
-#ifdef RT_MEM_STATS
-        used_mem += size;
-        if (used_mem > max_mem)
-            max_mem = used_mem;
-#endif
-        goto done;
-    }
-
-    /* lock heap */
-    rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
-
     /*
      * Attempt to allocate out of an existing zone.  First try the free list,
      * then allocate out of unallocated space.  If we find a good zone move
      * it to the head of the list so later allocations find it quickly
      * (we might have thousands of zones in the list).
-     *
-     * Note: zoneindex() will panic of size is too large.
      */
-    zi = zoneindex(&size);
-    RT_ASSERT(zi < NZONES);
-
-    RT_DEBUG_LOG(RT_DEBUG_SLAB, ("try to malloc 0x%x on zone: %d\n", size, zi));
-
     if ((z = zone_array[zi]) != RT_NULL)
     {
         RT_ASSERT(z->z_nfree > 0);
@@ -570,8 +513,7 @@ void *rt_malloc(rt_size_t size)
         if (used_mem > max_mem)
             max_mem = used_mem;
 #endif
-
-        goto done;
+        return chunk;
     }
 
     /*
@@ -598,15 +540,13 @@ void *rt_malloc(rt_size_t size)
 
             /* allocate a zone from page */
             z = rt_page_alloc(zone_size / RT_MM_PAGE_SIZE);
-            if (z == RT_NULL)
-            {
-                chunk = RT_NULL;
-                goto __exit;
-            }
 
             /* lock heap */
             rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
 
+            if (z == RT_NULL)
+                return RT_NULL;
+
             RT_DEBUG_LOG(RT_DEBUG_SLAB, ("alloc a new zone: 0x%x\n",
                                          (rt_ubase_t)z));
 
@@ -656,11 +596,325 @@ void *rt_malloc(rt_size_t size)
 #endif
     }
 
-done:
+    return chunk;
+}
+
+/*
+ * Give the chunk ptr back to its zone z. Called with heap_sem held, which is
+ * still held on return, the zone goes back to the page allocator once it is
+ * totally free and enough free zones are kept.
+ */
+static void slab_zone_free(slab_zone *z, void *ptr)
+{
+    slab_chunk *chunk;
+    struct memusage *kup;
+
+    chunk          = (slab_chunk *)ptr;
+    chunk->c_next  = z->z_freechunk;
+    z->z_freechunk = chunk;
+
+#ifdef RT_MEM_STATS
+    used_mem -= z->z_chunksize;
+#endif
+
+    /*
+     * Bump the number of free chunks.  If it becomes non-zero the zone
+     * must be added back onto the appropriate list.
+     */
+    if (z->z_nfree++ == 0)
+    {
+        z->z_next = zone_array[z->z_zoneindex];
+        zone_array[z->z_zoneindex] = z;
+    }
+
+    /*
+     * If the zone becomes totally free, and there are other zones we
+     * can allocate from, move this zone to the FreeZones list.  Since
+     * this code can be called from an IPI callback, do *NOT* try to mess
+     * with kernel_map here.  Hysteresis will be performed at malloc() time.
+     */
+    if (z->z_nfree == z->z_nmax &&
+        (z->z_next || zone_array[z->z_zoneindex] != z))
+    {
+        slab_zone **pz;
+
+        RT_DEBUG_LOG(RT_DEBUG_SLAB, ("free zone 0x%x\n",
+                                     (rt_ubase_t)z, z->z_zoneindex));
+
+        /* remove zone from zone array list */
+        for (pz = &zone_array[z->z_zoneindex]; z != *pz; pz = &(*pz)->z_next)
+            ;
+        *pz = z->z_next;
+
+        /* reset zone */
+        z->z_magic = -1;
+
+        /* insert to free zone list */
+        z->z_next = zone_free;
+        zone_free = z;
+
+        ++ zone_free_cnt;
+
+        /* release zone to page allocator */
+        if (zone_free_cnt > ZONE_RELEASE_THRESH)
+        {
+            register rt_base_t i;
+
+            z         = zone_free;
+            zone_free = z->z_next;
+            -- zone_free_cnt;
+
+            /* set message usage */
+            for (i = 0, kup = btokup(z); i < zone_page_cnt; i ++)
+            {
+                kup->type = PAGE_TYPE_FREE;
+                kup->size = 0;
+                kup ++;
+            }
+
+            /* unlock heap, since page allocator will think about lock */
+            rt_sem_release(&heap_sem);
+
+            /* release pages */
+            rt_page_free(z, zone_size / RT_MM_PAGE_SIZE);
+
+            /* lock heap */
+            rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
+        }
+    }
+}
+
+#ifdef RT_USING_SLAB_MAGAZINE
+/*
+ * Per-cpu magazine caches
+ *
+ * Each cpu keeps a magazine of free chunks for each of the first
+ * RT_SLAB_MAGAZINE_ZONES zones (chunks up to 128 bytes with the default 16),
+ * rt_malloc pops and rt_free pushes it with only local interrupts disabled,
+ * so heap_sem is neither taken nor bounced between cpus on a hit.
+ *
+ * The zones act as the depot: an empty magazine is refilled with half of
+ * its depth under one heap_sem section and a full one drains half of it, so
+ * each exchange is bounded and alternating malloc/free at the edge doesn't
+ * take the lock every time. At most RT_CPUS_NR * RT_SLAB_MAGAZINE_ZONES *
+ * RT_SLAB_MAGAZINE_SIZE chunks are kept, they are counted as used memory and
+ * keep their zones from being released.
+ */
+#ifndef RT_SLAB_MAGAZINE_SIZE
+#define RT_SLAB_MAGAZINE_SIZE   8
+#endif
+#ifndef RT_SLAB_MAGAZINE_ZONES
+#define RT_SLAB_MAGAZINE_ZONES  16
+#endif
+
+#if RT_SLAB_MAGAZINE_SIZE < 2
+#error "RT_SLAB_MAGAZINE_SIZE must be at least 2"
+#endif
+#if RT_SLAB_MAGAZINE_ZONES > NZONES
+#error "RT_SLAB_MAGAZINE_ZONES must not exceed the number of zones"
+#endif
+
+/* chunks moved between a magazine and the zones at a time */
+#define SLAB_MAGAZINE_BATCH     (RT_SLAB_MAGAZINE_SIZE / 2)
+
+#ifdef RT_USING_SMP
+#define SLAB_MAGAZINE_CPUS      RT_CPUS_NR
+#define slab_magazine_lock()    rt_hw_local_irq_disable()
+#define slab_magazine_unlock(l) rt_hw_local_irq_enable(l)
+#define slab_magazine_cpu()     rt_hw_cpu_id()
+#else
+#define SLAB_MAGAZINE_CPUS      1
+#define slab_magazine_lock()    rt_hw_interrupt_disable()
+#define slab_magazine_unlock(l) rt_hw_interrupt_enable(l)
+#define slab_magazine_cpu()     0
+#endif
+
+struct slab_magazine
+{
+    rt_uint32_t count;                          /* cached chunks */
+    void *chunk[RT_SLAB_MAGAZINE_SIZE];
+};
+static struct slab_magazine slab_magazines[SLAB_MAGAZINE_CPUS][RT_SLAB_MAGAZINE_ZONES];
+
+/*
+ * Allocate a chunk of size bytes of zone index zi from the magazine of
+ * current cpu, refill it from the zones when it is empty.
+ */
+static void *slab_magazine_alloc(rt_int32_t zi, rt_size_t size)
+{
+    struct slab_magazine *mag;
+    void *batch[SLAB_MAGAZINE_BATCH];
+    void *chunk;
+    rt_base_t level;
+    int i, n;
+
+    level = slab_magazine_lock();
+    mag = &slab_magazines[slab_magazine_cpu()][zi];
+    if (mag->count > 0)
+    {
+        chunk = mag->chunk[--mag->count];
+        slab_magazine_unlock(level);
+
+        return chunk;
+    }
+    slab_magazine_unlock(level);
+
+    /* empty, take a batch from the zones, the first one is returned */
+    rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
+    for (n = 0; n < SLAB_MAGAZINE_BATCH; n ++)
+    {
+        batch[n] = slab_zone_alloc(zi, size);
+        if (batch[n] == RT_NULL)
+            break;
+    }
     rt_sem_release(&heap_sem);
+    if (n == 0)
+        return RT_NULL;
+
+    /* the thread may run on another cpu now, or the magazine got refilled */
+    level = slab_magazine_lock();
+    mag = &slab_magazines[slab_magazine_cpu()][zi];
+    for (i = 1; i < n && mag->count < RT_SLAB_MAGAZINE_SIZE; i ++)
+        mag->chunk[mag->count++] = batch[i];
+    slab_magazine_unlock(level);
+
+    if (i < n)
+    {
+        rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
+        for (; i < n; i ++)
+            slab_zone_free(SLAB_ZONE_OF(batch[i]), batch[i]);
+        rt_sem_release(&heap_sem);
+    }
+
+    return batch[0];
+}
+
+/*
+ * Put the chunk ptr of zone index zi into the magazine of current cpu, half
+ * of a full magazine is given back to the zones first.
+ */
+static void slab_magazine_free(rt_int32_t zi, void *ptr)
+{
+    struct slab_magazine *mag;
+    void *batch[SLAB_MAGAZINE_BATCH];
+    rt_base_t level;
+    int n = 0;
+
+    level = slab_magazine_lock();
+    mag = &slab_magazines[slab_magazine_cpu()][zi];
+    if (mag->count == RT_SLAB_MAGAZINE_SIZE)
+    {
+        /* full, the oldest chunks are drained, which are colder in cache */
+        for (n = 0; n < SLAB_MAGAZINE_BATCH; n ++)
+            batch[n] = mag->chunk[n];
+        for (; n < RT_SLAB_MAGAZINE_SIZE; n ++)
+            mag->chunk[n - SLAB_MAGAZINE_BATCH] = mag->chunk[n];
+        mag->count -= SLAB_MAGAZINE_BATCH;
+        n = SLAB_MAGAZINE_BATCH;
+    }
+    mag->chunk[mag->count++] = ptr;
+    slab_magazine_unlock(level);
+
+    if (n > 0)
+    {
+        int i;
+
+        rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
+        for (i = 0; i < n; i ++)
+            slab_zone_free(SLAB_ZONE_OF(batch[i]), batch[i]);
+        rt_sem_release(&heap_sem);
+    }
+}
+#endif /* RT_USING_SLAB_MAGAZINE */
+
+/**
+ * @addtogroup MM
+ */
+
+/**@{*/
+
+/**
+ * This function will allocate a block from system heap memory.
+ * - If the nbytes is less than zero,
+ * or
+ * - If there is no nbytes sized memory valid in system,
+ * the RT_NULL is returned.
+ *
+ * @param size the size of memory to be allocated
+ *
+ * @return the allocated memory
+ */
+void *rt_malloc(rt_size_t size)
+{
+    rt_int32_t zi;
+    slab_chunk *chunk;
+    struct memusage *kup;
+
+    /* zero size, return RT_NULL */
+    if (size == 0)
+        return RT_NULL;
+
+    /*
+     * Handle large allocations directly.  There should not be very many of
+     * these so performance is not a big issue.
+     */
+    if (size >= zone_limit)
+    {
+        size = RT_ALIGN(size, RT_MM_PAGE_SIZE);
+
+        chunk = rt_page_alloc(size >> RT_MM_PAGE_BITS);
+        if (chunk == RT_NULL)
+            return RT_NULL;
+
+        /* set kup */
+        kup = btokup(chunk);
+        kup->type = PAGE_TYPE_LARGE;
+        kup->size = size >> RT_MM_PAGE_BITS;
+
+        RT_DEBUG_LOG(RT_DEBUG_SLAB,
+                     ("malloc a large memory 0x%x, page cnt %d, kup %d\n",
+                      size,
+                      size >> RT_MM_PAGE_BITS,
+                      ((rt_ubase_t)chunk - heap_start) >> RT_MM_PAGE_BITS));
+
+        /* lock heap */
+        rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
+
+#ifdef RT_MEM_STATS
+        used_mem += size;
+        if (used_mem > max_mem)
+            max_mem = used_mem;
+#endif
+        rt_sem_release(&heap_sem);
+        RT_OBJECT_HOOK_CALL(rt_malloc_hook, ((char *)chunk, size));
+
+        return chunk;
+    }
+
+    /*
+     * Note: zoneindex() will panic of size is too large.
+     */
+    zi = zoneindex(&size);
+    RT_ASSERT(zi < NZONES);
+
+    RT_DEBUG_LOG(RT_DEBUG_SLAB, ("try to malloc 0x%x on zone: %d\n", size, zi));
+
+#ifdef RT_USING_SLAB_MAGAZINE
+    if (zi < RT_SLAB_MAGAZINE_ZONES)
+        chunk = slab_magazine_alloc(zi, size);
+    else
+#endif
+    {
+        /* lock heap */
+        rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
+        chunk = slab_zone_alloc(zi, size);
+        rt_sem_release(&heap_sem);
+    }
+    if (chunk == RT_NULL)
+        return RT_NULL;
+
     RT_OBJECT_HOOK_CALL(rt_malloc_hook, ((char *)chunk, size));
 
-__exit:
     return chunk;
 }
 
@@ -766,7 +1020,6 @@ void *rt_calloc(rt_size_t count, rt_size_t size)
 void rt_free(void *ptr)
 {
     slab_zone *z;
-    slab_chunk *chunk;
     struct memusage *kup;
 
     /* free a RT_NULL pointer */
@@ -814,86 +1067,23 @@ void rt_free(void *ptr)
         return;
     }
 
-    /* lock heap */
-    rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
-
     /* zone case. get out zone. */
-    z = (slab_zone *)(((rt_ubase_t)ptr & ~RT_MM_PAGE_MASK) -
-                      kup->size * RT_MM_PAGE_SIZE);
+    z = SLAB_ZONE_OF(ptr);
     RT_ASSERT(z->z_magic == ZALLOC_SLAB_MAGIC);
 
-    chunk          = (slab_chunk *)ptr;
-    chunk->c_next  = z->z_freechunk;
-    z->z_freechunk = chunk;
-
-#ifdef RT_MEM_STATS
-    used_mem -= z->z_chunksize;
-#endif
-
-    /*
-     * Bump the number of free chunks.  If it becomes non-zero the zone
-     * must be added back onto the appropriate list.
-     */
-    if (z->z_nfree++ == 0)
-    {
-        z->z_next = zone_array[z->z_zoneindex];
-        zone_array[z->z_zoneindex] = z;
-    }
-
-    /*
-     * If the zone becomes totally free, and there are other zones we
-     * can allocate from, move this zone to the FreeZones list.  Since
-     * this code can be called from an IPI callback, do *NOT* try to mess
-     * with kernel_map here.  Hysteresis will be performed at malloc() time.
-     */
-    if (z->z_nfree == z->z_nmax &&
-        (z->z_next || zone_array[z->z_zoneindex] != z))
+#ifdef RT_USING_SLAB_MAGAZINE
+    /* the zone index can't change while the chunk is allocated */
+    if (z->z_zoneindex < RT_SLAB_MAGAZINE_ZONES)
     {
-        slab_zone **pz;
+        slab_magazine_free(z->z_zoneindex, ptr);
 
-        RT_DEBUG_LOG(RT_DEBUG_SLAB, ("free zone 0x%x\n",
-                                     (rt_ubase_t)z, z->z_zoneindex));
-
-        /* remove zone from zone array list */
-        for (pz = &zone_array[z->z_zoneindex]; z != *pz; pz = &(*pz)->z_next)
-            ;
-        *pz = z->z_next;
-
-        /* reset zone */
-        z->z_magic = -1;
-
-        /* insert to free zone list */
-        z->z_next = zone_free;
-        zone_free = z;
-
-        ++ zone_free_cnt;
-
-        /* release zone to page allocator */
-        if (zone_free_cnt > ZONE_RELEASE_THRESH)
-        {
-            register rt_base_t i;
-
-            z         = zone_free;
-            zone_free = z->z_next;
-            -- zone_free_cnt;
-
-            /* set message usage */
-            for (i = 0, kup = btokup(z); i < zone_page_cnt; i ++)
-            {
-                kup->type = PAGE_TYPE_FREE;
-                kup->size = 0;
-                kup ++;
-            }
-
-            /* unlock heap */
-            rt_sem_release(&heap_sem);
-
-            /* release pages */
-            rt_page_free(z, zone_size / RT_MM_PAGE_SIZE);
-
-            return;
-        }
+        return;
     }
+#endif
+
+    /* lock heap */
+    rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
+    slab_zone_free(z, ptr);
     /* unlock heap */
     rt_sem_release(&heap_sem);
 }
@@ -30,9 +30,14 @@
 
 #include <rthw.h>
 #include <rtthread.h>
+#if defined(NUCLEI_STACK_MONITOR) && (NUCLEI_STACK_MONITOR == 1)
+#include "stackmon_api.h"
+#endif
 
+#ifndef RT_USING_SMP
 extern rt_list_t rt_thread_priority_table[RT_THREAD_PRIORITY_MAX];
 extern struct rt_thread *rt_current_thread;
+#endif
 extern rt_list_t rt_thread_defunct;
 
 #ifdef RT_USING_HOOK
@@ -91,6 +96,10 @@ static void _thread_cleanup_execute(rt_thread_t thread)
     if (thread->cleanup != RT_NULL)
         thread->cleanup(thread);
 
+#if defined(NUCLEI_STACK_MONITOR) && (NUCLEI_STACK_MONITOR == 1)
+    stackmon_unregister(thread);
+#endif
+
     rt_hw_interrupt_enable(level);
 }
 
@@ -100,7 +109,7 @@ void rt_thread_exit(void)
     register rt_base_t level;
 
     /* get current thread */
-    thread = rt_current_thread;
+    thread = rt_thread_self();
 
     /* disable interrupt */
     level = rt_hw_interrupt_disable();
@@ -161,6 +170,10 @@ static rt_err_t _rt_thread_init(struct rt_thread *thread,
     thread->sp = (void *)rt_hw_stack_init(thread->entry, thread->parameter,
                                           (rt_uint8_t *)((char *)thread->stack_addr + thread->stack_size - sizeof(rt_ubase_t)),
                                           (void *)rt_thread_exit);
+#if defined(NUCLEI_STACK_MONITOR) && (NUCLEI_STACK_MONITOR == 1)
+    /* register stack into high water mark monitor, keep the '#' fill of list_thread */
+    stackmon_register(thread, thread->name, thread->stack_addr, thread->stack_size, thread->sp, 0x23232323UL);
+#endif
 #endif
 
     /* priority init */
@@ -182,10 +195,25 @@ static rt_err_t _rt_thread_init(struct rt_thread *thread,
     thread->error = RT_EOK;
     thread->stat  = RT_THREAD_INIT;
 
+#ifdef RT_USING_SMP
+    /* not bind on any cpu */
+    thread->bind_cpu = RT_CPUS_NR;
+    thread->oncpu = RT_CPU_DETACHED;
+#endif
+
     /* initialize cleanup function and user data */
     thread->cleanup   = 0;
     thread->user_data = 0;
 
+#ifdef RT_USING_THREAD_CYCLES
+    thread->cycles_total = 0;
+    thread->cycles_start = 0;
+#ifdef RT_USING_THREAD_PERF
+    rt_memset(thread->perf_total, 0, sizeof(thread->perf_total));
+    rt_memset(thread->perf_start, 0, sizeof(thread->perf_start));
+#endif
+#endif
+
     /* initialize thread timer */
     rt_timer_init(&(thread->thread_timer),
                   thread->name,
@@ -253,7 +281,18 @@ rt_err_t rt_thread_init(struct rt_thread *thread,
  */
 rt_thread_t rt_thread_self(void)
 {
+#ifdef RT_USING_SMP
+    rt_base_t lock;
+    rt_thread_t self;
+
+    /* not migrated to another cpu while reading */
+    lock = rt_hw_local_irq_disable();
+    self = rt_cpu_self()->current_thread;
+    rt_hw_local_irq_enable(lock);
+    return self;
+#else
     return rt_current_thread;
+#endif
 }
 
 /**
@@ -308,6 +347,9 @@ rt_err_t rt_thread_startup(rt_thread_t thread)
 rt_err_t rt_thread_detach(rt_thread_t thread)
 {
     rt_base_t lock;
+#ifdef RT_USING_SMP
+    rt_base_t level;
+#endif
 
     /* thread check */
     RT_ASSERT(thread != RT_NULL);
@@ -317,6 +359,12 @@ rt_err_t rt_thread_detach(rt_thread_t thread)
     if ((thread->stat & RT_THREAD_STAT_MASK) == RT_THREAD_CLOSE)
         return RT_EOK;
 
+#ifdef RT_USING_SMP
+    /* hold cpus lock until it is closed, so the cpu running it won't put it
+     * back to ready queue when it is switched out */
+    level = rt_hw_interrupt_disable();
+#endif
+
     if ((thread->stat & RT_THREAD_STAT_MASK) != RT_THREAD_INIT)
     {
         /* remove from schedule */
@@ -345,6 +393,10 @@ rt_err_t rt_thread_detach(rt_thread_t thread)
         rt_hw_interrupt_enable(lock);
     }
 
+#ifdef RT_USING_SMP
+    rt_hw_interrupt_enable(level);
+#endif
+
     return RT_EOK;
 }
 
@@ -409,6 +461,9 @@ rt_thread_t rt_thread_create(const char *name,
 rt_err_t rt_thread_delete(rt_thread_t thread)
 {
     rt_base_t lock;
+#ifdef RT_USING_SMP
+    rt_base_t level;
+#endif
 
     /* thread check */
     RT_ASSERT(thread != RT_NULL);
@@ -418,6 +473,12 @@ rt_err_t rt_thread_delete(rt_thread_t thread)
     if ((thread->stat & RT_THREAD_STAT_MASK) == RT_THREAD_CLOSE)
         return RT_EOK;
 
+#ifdef RT_USING_SMP
+    /* hold cpus lock until it is closed, so the cpu running it won't put it
+     * back to ready queue when it is switched out */
+    level = rt_hw_interrupt_disable();
+#endif
+
     if ((thread->stat & RT_THREAD_STAT_MASK) != RT_THREAD_INIT)
     {
         /* remove from schedule */
@@ -441,6 +502,10 @@ rt_err_t rt_thread_delete(rt_thread_t thread)
     /* enable interrupt */
     rt_hw_interrupt_enable(lock);
 
+#ifdef RT_USING_SMP
+    rt_hw_interrupt_enable(level);
+#endif
+
     return RT_EOK;
 }
 #endif
@@ -457,6 +522,21 @@ rt_err_t rt_thread_yield(void)
     register rt_base_t level;
     struct rt_thread *thread;
 
+#ifdef RT_USING_SMP
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    /* running thread is not in ready queue, it is put to the end when switched out */
+    thread = rt_thread_self();
+    thread->stat |= RT_THREAD_STAT_YIELD;
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+
+    rt_schedule();
+
+    return RT_EOK;
+#else
     /* disable interrupt */
     level = rt_hw_interrupt_disable();
 
@@ -486,6 +566,7 @@ rt_err_t rt_thread_yield(void)
     rt_hw_interrupt_enable(level);
 
     return RT_EOK;
+#endif /*RT_USING_SMP*/
 }
 
 /**
@@ -503,7 +584,7 @@ rt_err_t rt_thread_sleep(rt_tick_t tick)
     /* disable interrupt */
     temp = rt_hw_interrupt_disable();
     /* set to current thread */
-    thread = rt_current_thread;
+    thread = rt_thread_self();
     RT_ASSERT(thread != RT_NULL);
     RT_ASSERT(rt_object_get_type((rt_object_t)thread) == RT_Object_Class_Thread);
 
@@ -679,6 +760,23 @@ rt_err_t rt_thread_control(rt_thread_t thread, int cmd, void *arg)
     case RT_THREAD_CTRL_STARTUP:
         return rt_thread_startup(thread);
 
+#ifdef RT_USING_SMP
+    case RT_THREAD_CTRL_BIND_CPU:
+    {
+        rt_uint8_t cpu;
+
+        if ((thread->stat & RT_THREAD_STAT_MASK) != RT_THREAD_INIT)
+        {
+            /* only support bind cpu before the thread is started */
+            return -RT_ERROR;
+        }
+
+        cpu = (rt_uint8_t)(rt_ubase_t)arg;
+        thread->bind_cpu = cpu > RT_CPUS_NR ? RT_CPUS_NR : cpu;
+        break;
+    }
+#endif /*RT_USING_SMP*/
+
     case RT_THREAD_CTRL_CLOSE:
 
         if (rt_object_is_systemobject((rt_object_t)thread) == RT_TRUE)
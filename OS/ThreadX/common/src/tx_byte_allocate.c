@@ -191,8 +191,20 @@ ULONG                       lower_tbu;
             if (pool_ptr -> tx_byte_pool_owner == thread_ptr)
             {
 
+#ifdef TX_BYTE_POOL_QUICK_LISTS
+
+                /* Give blocks on the quick lists back to the pool and search again before giving up.  */
+                if (_tx_byte_pool_quick_flush(pool_ptr) == TX_FALSE)
+                {
+
+                    /* Yes, then we have looked through the entire pool and haven't found the memory.  */
+                    finished =  TX_TRUE;
+                }
+#else
+
                 /* Yes, then we have looked through the entire pool and haven't found the memory.  */
                 finished =  TX_TRUE;
+#endif
             }
         }
 
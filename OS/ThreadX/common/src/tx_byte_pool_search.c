@@ -104,6 +104,21 @@ ULONG           total_theoretical_available;
     /* Disable interrupts.  */
     TX_DISABLE
 
+#ifdef TX_BYTE_POOL_QUICK_LISTS
+
+    /* Take a block of the size class from the quick lists of the pool first.  */
+    current_ptr =  _tx_byte_pool_quick_allocate(pool_ptr, memory_size);
+    if (current_ptr != TX_NULL)
+    {
+
+        /* Restore interrupts.  */
+        TX_RESTORE
+
+        /* Return the block memory.  */
+        return(current_ptr);
+    }
+#endif
+
     /* First, determine if there are enough bytes in the pool.  */
     /* Theoretical bytes available = free bytes + ((fragments-2) * overhead of each block) */
     total_theoretical_available = pool_ptr -> tx_byte_pool_available + ((pool_ptr -> tx_byte_pool_fragments - 2) * ((sizeof(UCHAR *)) + (sizeof(ALIGN_TYPE))));
@@ -192,6 +192,20 @@ UCHAR               **suspend_info_ptr;
         /* Log this kernel call.  */
         TX_EL_BYTE_RELEASE_INSERT
 
+#ifdef TX_BYTE_POOL_QUICK_LISTS
+
+        /* Keep a small block on a quick list of the pool when no thread waits for memory.  */
+        if (_tx_byte_pool_quick_release(pool_ptr, work_ptr) == TX_TRUE)
+        {
+
+            /* Restore interrupts.  */
+            TX_RESTORE
+
+            /* Return completion status.  */
+            return(status);
+        }
+#endif
+
         /* Release the memory.  */
         temp_ptr =   TX_UCHAR_POINTER_ADD(work_ptr, (sizeof(UCHAR *)));
         free_ptr =   TX_UCHAR_TO_ALIGN_TYPE_POINTER_CONVERT(temp_ptr);
@@ -4,60 +4,84 @@
 #include "tx_initialize.h"
 
 #include "nuclei_sdk_soc.h"
+#include "nmsis_rtos.h"
+#if defined(NUCLEI_GPROF_TASK) && (NUCLEI_GPROF_TASK == 1)
+#include "gprof_api.h"
+#endif
 
 // SOC_TIMER_FREQ should be provided in <Device>.h of NMSIS. eg. evalsoc.h
 // TX_TIMER_TICKS_PER_SECOND defined in tx_user.h which can overwrite the default one in tx_api.h if TX_INCLUDE_USER_DEFINE_FILE defined
 #define SYSTICK_TICK_CONST          (SOC_TIMER_FREQ / TX_TIMER_TICKS_PER_SECOND)
-#define THREAD_INITIAL_MSTATUS      (MSTATUS_MPP | MSTATUS_MPIE | MSTATUS_FS_INITIAL | MSTATUS_VS_INITIAL)
 #define KERNEL_INTERRUPT_PRIORITY   0
 
 // MUST define SysTick_Handler as eclic_mtip_handler, which is registered in vector table
 #define SysTick_Handler     eclic_mtip_handler
 
-struct thread_stack_frame {
-    unsigned long epc;        /* epc - epc    - program counter                     */
-    unsigned long ra;         /* x1  - ra     - return address for jumps            */
-    unsigned long t0;         /* x5  - t0     - temporary register 0                */
-    unsigned long t1;         /* x6  - t1     - temporary register 1                */
-    unsigned long t2;         /* x7  - t2     - temporary register 2                */
-    unsigned long s0_fp;      /* x8  - s0/fp  - saved register 0 or frame pointer   */
-    unsigned long s1;         /* x9  - s1     - saved register 1                    */
-    unsigned long a0;         /* x10 - a0     - return value or function argument 0 */
-    unsigned long a1;         /* x11 - a1     - return value or function argument 1 */
-    unsigned long a2;         /* x12 - a2     - function argument 2                 */
-    unsigned long a3;         /* x13 - a3     - function argument 3                 */
-    unsigned long a4;         /* x14 - a4     - function argument 4                 */
-    unsigned long a5;         /* x15 - a5     - function argument 5                 */
-#ifndef __riscv_32e
-    unsigned long a6;         /* x16 - a6     - function argument 6                 */
-    unsigned long a7;         /* x17 - s7     - function argument 7                 */
-    unsigned long s2;         /* x18 - s2     - saved register 2                    */
-    unsigned long s3;         /* x19 - s3     - saved register 3                    */
-    unsigned long s4;         /* x20 - s4     - saved register 4                    */
-    unsigned long s5;         /* x21 - s5     - saved register 5                    */
-    unsigned long s6;         /* x22 - s6     - saved register 6                    */
-    unsigned long s7;         /* x23 - s7     - saved register 7                    */
-    unsigned long s8;         /* x24 - s8     - saved register 8                    */
-    unsigned long s9;         /* x25 - s9     - saved register 9                    */
-    unsigned long s10;        /* x26 - s10    - saved register 10                   */
-    unsigned long s11;        /* x27 - s11    - saved register 11                   */
-    unsigned long t3;         /* x28 - t3     - temporary register 3                */
-    unsigned long t4;         /* x29 - t4     - temporary register 4                */
-    unsigned long t5;         /* x30 - t5     - temporary register 5                */
-    unsigned long t6;         /* x31 - t6     - temporary register 6                */
-#endif
-    unsigned long mstatus;    /*              - machine status register             */
-};
+#if defined(TX_THREAD_SMP) && (defined(TX_LOW_POWER) || defined(TX_ENABLE_EXECUTION_CHANGE_NOTIFY) || defined(TX_EXECUTION_PROFILE_ENABLE))
+#error "TX_LOW_POWER and execution profile are not supported in ThreadX SMP port"
+#endif
+
+#ifdef TX_LOW_POWER
+#ifndef TX_LOW_POWER_THRESHOLD
+// Minimal idle ticks to suppress the tick interrupt, shorter idle just wfi with tick running
+#define TX_LOW_POWER_THRESHOLD      2
+#endif
+
+#ifndef TX_LOW_POWER_MAX_TICKS
+// Limit of suppressed ticks, keep half of ULONG range for tick compare
+#define TX_LOW_POWER_MAX_TICKS      ((ULONG)0x7FFFFFFFUL)
+#endif
+
+#ifndef TX_LOW_POWER_WFI_SLEEPMODE
+// SysTimer must keep counting in the selected sleep mode
+#define TX_LOW_POWER_WFI_SLEEPMODE  WFI_SHALLOW_SLEEP
+#endif
+
+// Absolute SysTimer value of the next tick boundary
+static uint64_t port_next_tick_time = 0;
+// Idle ticks programmed by tx_low_power_enter, 0 if tick is not suppressed
+static ULONG port_idle_ticks = 0;
+static uint64_t port_sleep_start = 0;
+static TX_PORT_TICKLESS_STATS port_tickless_stats;
+#endif
 
 /* This is the timer interrupt service routine. */
 void SysTick_Handler(void)
 {
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+    TX_EXECUTION_ISR_ENTER
+#endif
     // Reload timer
+#ifdef TX_LOW_POWER
+    // Tick boundaries are kept absolute, so ticks skipped in sleep can be counted from mtime
+    port_next_tick_time += SYSTICK_TICK_CONST;
+    SysTimer_SetCompareValue(port_next_tick_time);
+#else
     SysTick_Reload(SYSTICK_TICK_CONST);
+#endif
+
+#ifdef TX_THREAD_SMP
+    TX_INTERRUPT_SAVE_AREA
+    UINT core;
+
+    /* Tick is only taken by core 0, timer list and time-slices of all cores are protected */
+    TX_DISABLE
+#endif
 
     /* Increment system clock. */
     _tx_timer_system_clock++;
 
+#ifdef TX_THREAD_SMP
+    /* Test for time-slice expiration of each core. */
+    for (core = 0; core < TX_THREAD_SMP_MAX_CORES; core++) {
+        if (_tx_timer_time_slice[core]) {
+            _tx_timer_time_slice[core]--;
+            if (_tx_timer_time_slice[core] == 0) {
+                _tx_timer_expired_time_slice =  TX_TRUE;
+            }
+        }
+    }
+#else
     /* Test for time-slice expiration. */
     if (_tx_timer_time_slice) {
         /* Decrement the time_slice.  */
@@ -68,6 +92,7 @@ void SysTick_Handler(void)
            _tx_timer_expired_time_slice =  TX_TRUE;
         }
     }
+#endif
 
     /* Test for timer expiration.  */
     if (*_tx_timer_current_ptr) {
@@ -96,12 +121,65 @@ void SysTick_Handler(void)
             _tx_thread_time_slice();
         }
     }
+#ifdef TX_THREAD_SMP
+    TX_RESTORE
+#endif
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+    TX_EXECUTION_ISR_EXIT
+#endif
 }
 
+#ifdef TX_THREAD_SMP
+/*
+ * Task Switch code called in eclic_msip_handler of each core, the handler saves context
+ * into _tx_thread_current_ptr[core] if it is not NULL, calls this function, then restores
+ * context from _tx_thread_current_ptr[core], or enters the idle loop of _tx_thread_schedule
+ * with interrupts enabled if it is NULL.
+ * A thread switched out is marked ready after its context is saved, and a core can only run
+ * the thread when it takes the ready bit, so a thread never runs on two cores.
+ */
+void PortThreadSwitch(void)
+{
+    UINT core = _tx_thread_smp_core_get();
+    TX_THREAD *thread_ptr;
+
+    /* Clear Software IRQ before checking, preemption requested after it will trigger another switch */
+    SysTimer_ClearSWIRQ();
+
+    thread_ptr = _tx_thread_current_ptr[core];
+    if (thread_ptr != TX_NULL) {
+        /* Preserve current remaining time-slice for the thread and clear the current time-slice.  */
+        if (_tx_timer_time_slice[core]) {
+            thread_ptr -> tx_thread_time_slice = _tx_timer_time_slice[core];
+            _tx_timer_time_slice[core] =  0;
+        }
+        _tx_thread_current_ptr[core] = TX_NULL;
+        __atomic_store_n(&thread_ptr -> tx_thread_smp_lock_ready_bit, TX_TRUE, __ATOMIC_RELEASE);
+    }
+
+    thread_ptr = _tx_thread_execute_ptr[core];
+    if (thread_ptr == TX_NULL) {
+        return;
+    }
+    if (__atomic_exchange_n(&thread_ptr -> tx_thread_smp_lock_ready_bit, TX_FALSE, __ATOMIC_ACQUIRE) == TX_FALSE) {
+        /* Still running on the core it is switched out from, idle and retry */
+        SysTimer_SetSWIRQ();
+        return;
+    }
+    if (thread_ptr != _tx_thread_execute_ptr[core]) {
+        /* Execute pointer changed by other core while taking it, give it back and retry */
+        __atomic_store_n(&thread_ptr -> tx_thread_smp_lock_ready_bit, TX_TRUE, __ATOMIC_RELEASE);
+        SysTimer_SetSWIRQ();
+        return;
+    }
+    _tx_thread_current_ptr[core] = thread_ptr;
+    _tx_timer_time_slice[core] = thread_ptr -> tx_thread_time_slice;
+}
+#else
 // Task Switch code called in eclic_msip_handler
 void PortThreadSwitch(void)
 {
-#ifdef TX_ENABLE_EXECUTION_CHANGE_NOTIFY
+#if defined(TX_ENABLE_EXECUTION_CHANGE_NOTIFY) || defined(TX_EXECUTION_PROFILE_ENABLE)
     _tx_execution_thread_exit();
 #endif
     /* Determine if the time-slice is active.  */
@@ -111,9 +189,13 @@ void PortThreadSwitch(void)
         _tx_timer_time_slice =  0;
     }
     _tx_thread_current_ptr = _tx_thread_execute_ptr;
+#if defined(TX_ENABLE_EXECUTION_CHANGE_NOTIFY) || defined(TX_EXECUTION_PROFILE_ENABLE)
+    _tx_execution_thread_enter();
+#endif
     /* Clear Software IRQ, A MUST */
     SysTimer_ClearSWIRQ();
 }
+#endif
 
 void SetupSysTickInterrupt(void)
 {
@@ -121,11 +203,21 @@ void SetupSysTickInterrupt(void)
 
     /* Make SWI and SysTick the lowest priority interrupts. */
     /* Stop and clear the SysTimer. SysTimer as Non-Vector Interrupt */
+#ifdef TX_THREAD_SMP
+    /* Only core 0 takes the tick in SMP, other cores only need the SWI for scheduling */
+    if (__get_hart_index() == 0) {
+#endif
     SysTick_Config(ticks);
+#ifdef TX_LOW_POWER
+    port_next_tick_time = SysTimer_GetCompareValue();
+#endif
     ECLIC_DisableIRQ(SysTimer_IRQn);
     ECLIC_SetLevelIRQ(SysTimer_IRQn, KERNEL_INTERRUPT_PRIORITY);
     ECLIC_SetShvIRQ(SysTimer_IRQn, ECLIC_NON_VECTOR_INTERRUPT);
     ECLIC_EnableIRQ(SysTimer_IRQn);
+#ifdef TX_THREAD_SMP
+    }
+#endif
 
     /* Set SWI interrupt level to lowest level/priority, SysTimerSW as Vector Interrupt */
     ECLIC_SetShvIRQ(SysTimerSW_IRQn, ECLIC_VECTOR_INTERRUPT);
@@ -133,6 +225,126 @@ void SetupSysTickInterrupt(void)
     ECLIC_EnableIRQ(SysTimerSW_IRQn);
 }
 
+#ifdef TX_LOW_POWER
+// Hooks around wfi, such as gating peripheral clocks
+__WEAK void PortPreSleepProcessing(ULONG ticks)
+{
+}
+
+__WEAK void PortPostSleepProcessing(ULONG ticks)
+{
+}
+
+// Ticks until the tick interrupt has work to do, the timer slot at offset n from
+// _tx_timer_current_ptr is processed by the (n + 1)th tick, including timers with
+// remaining ticks beyond TX_TIMER_ENTRIES which are only re-inserted there
+static ULONG PortNextEventTicks(void)
+{
+    TX_TIMER_INTERNAL **slot = _tx_timer_current_ptr;
+    ULONG ticks = TX_LOW_POWER_MAX_TICKS;
+    ULONG i;
+
+    for (i = 0; i < TX_TIMER_ENTRIES; i++) {
+        if (*slot) {
+            ticks = i + 1;
+            break;
+        }
+        slot++;
+        if (slot == _tx_timer_list_end) {
+            slot = _tx_timer_list_start;
+        }
+    }
+    if ((_tx_timer_time_slice) && (_tx_timer_time_slice < ticks)) {
+        ticks = _tx_timer_time_slice;
+    }
+    return ticks;
+}
+
+/*
+ * Tickless idle, called by _tx_thread_schedule in context.S with interrupts disabled
+ * when no thread is ready, as: tx_low_power_enter, wfi, tx_low_power_exit, then enable
+ * interrupts and check _tx_thread_execute_ptr again.
+ * The tick interrupt is moved to the tick which has timer or time-slice to process.
+ */
+VOID tx_low_power_enter(VOID)
+{
+    ULONG ticks;
+
+    port_idle_ticks = 0;
+    // A thread is readied by interrupt, or timer expiration is pending
+    if ((_tx_thread_execute_ptr != TX_NULL) || (_tx_timer_expired) || (_tx_timer_expired_time_slice)) {
+        return;
+    }
+    ticks = PortNextEventTicks();
+    if (ticks < TX_LOW_POWER_THRESHOLD) {
+        return;
+    }
+
+    // The pending tick boundary is the first idle tick, so wake up exactly at the last one
+    SysTimer_SetCompareValue(port_next_tick_time + (uint64_t)(ticks - 1) * SYSTICK_TICK_CONST);
+    __RWMB();
+    port_sleep_start = SysTimer_GetLoadValue();
+    port_idle_ticks = ticks;
+    PortPreSleepProcessing(ticks);
+    __set_wfi_sleepmode(TX_LOW_POWER_WFI_SLEEPMODE);
+}
+
+VOID tx_low_power_exit(VOID)
+{
+    ULONG slept, step;
+    uint64_t now;
+
+    if (port_idle_ticks == 0) {
+        return;
+    }
+    __set_wfi_sleepmode(WFI_SHALLOW_SLEEP);
+    PortPostSleepProcessing(port_idle_ticks);
+
+    now = SysTimer_GetLoadValue();
+    slept = 0;
+    if (now >= port_next_tick_time) {
+        slept = (ULONG)((now - port_next_tick_time) / SYSTICK_TICK_CONST) + 1;
+    }
+
+    // The last passed tick is processed by the pending tick interrupt, the others only
+    // passed empty timer slots, so advance clock and timer list pointer in one step
+    step = 0;
+    if (slept > 0) {
+        step = slept - 1;
+        if (step > port_idle_ticks - 1) {
+            step = port_idle_ticks - 1;
+        }
+    }
+    port_next_tick_time += (uint64_t)step * SYSTICK_TICK_CONST;
+    SysTimer_SetCompareValue(port_next_tick_time);
+
+    _tx_timer_system_clock += step;
+    if (_tx_timer_time_slice) {
+        _tx_timer_time_slice -= step;
+    }
+    _tx_timer_current_ptr = _tx_timer_list_start +
+                            ((ULONG)(_tx_timer_current_ptr - _tx_timer_list_start) + step) % TX_TIMER_ENTRIES;
+
+    port_tickless_stats.sleeps++;
+    if (slept < port_idle_ticks) {
+        port_tickless_stats.early_wakeups++;
+    }
+    port_tickless_stats.slept_ticks += slept;
+    port_tickless_stats.compensated_ticks += step;
+    port_tickless_stats.slept_counts += now - port_sleep_start;
+    port_idle_ticks = 0;
+}
+
+VOID PortGetTicklessStats(TX_PORT_TICKLESS_STATS *stats)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    TX_DISABLE
+    *stats = port_tickless_stats;
+    TX_RESTORE
+}
+#endif
+
 // TODO
 // No need to do it here, in void tx_application_define(void *first_unused_memory) function
 // You don't need to use this first_unused_memory since it is not available in our port
@@ -144,10 +356,37 @@ VOID _tx_initialize_low_level(VOID)
 {
 //    _tx_initialize_unused_memory = s_threadx_heap;
     _tx_initialize_unused_memory = NULL;
+#ifdef TX_THREAD_SMP
+    _tx_thread_smp_protection.tx_thread_smp_protect_core = TX_THREAD_SMP_INVALID_CORE;
+#endif
     SetupSysTickInterrupt();
     _tx_thread_interrupt_control(0);
 }
 
+#ifdef TX_THREAD_SMP
+extern int main(void);
+
+/*
+ * Overwrite the weak smp_main in startup code, the boot hart runs main and
+ * tx_kernel_enter, other harts used by ThreadX prepare its SWI and wait for
+ * the scheduler, harts out of TX_THREAD_SMP_MAX_CORES stay in wfi.
+ */
+int smp_main(void)
+{
+    if (__get_hart_id() == BOOT_HARTID) {
+        return main();
+    }
+    if (__get_hart_index() < TX_THREAD_SMP_MAX_CORES) {
+        SetupSysTickInterrupt();
+        _tx_thread_smp_initialize_wait();
+    }
+    while (1) {
+        __WFI();
+    }
+    return 0;
+}
+#endif
+
 UINT _tx_thread_interrupt_control(UINT new_posture)
 {
     ULONG temp;
@@ -167,23 +406,27 @@ UINT _tx_thread_interrupt_control(UINT new_posture)
 VOID _tx_thread_stack_build(TX_THREAD *thread_ptr, VOID (*function_ptr)(VOID))
 {
 
-    struct thread_stack_frame *frame;
     uint8_t *stk;
-    int i;
 
     stk  = thread_ptr -> tx_thread_stack_end;
     stk  = (uint8_t *)(((unsigned long)stk) & (~(unsigned long)(sizeof(ALIGN_TYPE) - 1)));
-    stk -= sizeof(struct thread_stack_frame);
-
-    frame = (struct thread_stack_frame*)stk;
-
-    for (i = 0; i < sizeof(struct thread_stack_frame) / sizeof(unsigned long); i++) {
-        ((unsigned long*)frame)[i] = 0xdeadbeef;
-    }
-
-    frame->epc     = (unsigned long)function_ptr;
-    frame->mstatus = THREAD_INITIAL_MSTATUS;
+    /* Frame layout is shared with other RTOS ports in nmsis_rtos.h, thread entry never returns */
+    stk  = (uint8_t *)__RV_FrameInit((unsigned long *)stk, (unsigned long)function_ptr, 0xdeadbeef, 0xdeadbeef, 0xdeadbeef);
 
     thread_ptr -> tx_thread_stack_ptr = stk;
 }
 
+#if defined(NUCLEI_GPROF_TASK) && (NUCLEI_GPROF_TASK == 1)
+// Thread interrupted by gprof sample interrupt, see gprof_api.h of profiling middleware,
+// no thread is current while scheduler waits for a ready thread
+const void *gprof_current_task(const char **name)
+{
+    TX_THREAD *thread_ptr;
+
+    TX_THREAD_GET_CURRENT(thread_ptr)
+    if (thread_ptr != TX_NULL) {
+        *name = thread_ptr -> tx_thread_name;
+    }
+    return thread_ptr;
+}
+#endif
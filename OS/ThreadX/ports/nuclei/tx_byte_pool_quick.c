@@ -0,0 +1,190 @@
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Byte Pool Quick Lists and Statistics for Nuclei RISC-V Port         */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define TX_SOURCE_CODE
+
+#include "tx_api.h"
+#include "tx_byte_pool.h"
+
+/* Size of the header in front of each block of a byte pool, the next block pointer
+   followed by TX_BYTE_BLOCK_FREE or the owning pool pointer */
+#define TX_BYTE_BLOCK_HEADER        ((sizeof(UCHAR *)) + (sizeof(ALIGN_TYPE)))
+
+#ifdef TX_BYTE_POOL_QUICK_LISTS
+
+/*
+ * Quick lists keep released small blocks in their allocated state, linked through the
+ * first word of the block memory, so tx_byte_allocate of the same size class pops them
+ * without the first-fit search, and TX_BYTE_POOL_QUICK_CLASSES * TX_BYTE_POOL_QUICK_DEPTH
+ * bounds the blocks kept out of the pool. The class of a block is rounded down from its
+ * size, the class of a request is rounded up, so any block of a class fits its requests.
+ * All functions here are called with interrupts disabled.
+ */
+
+/* Called by _tx_byte_pool_search, return the memory of a block for memory_size bytes or TX_NULL */
+UCHAR *_tx_byte_pool_quick_allocate(TX_BYTE_POOL *pool_ptr, ULONG memory_size)
+{
+    UCHAR *memory_ptr = TX_NULL;
+    UCHAR **link_ptr;
+    UINT index;
+
+    if ((memory_size != ((ULONG) 0)) &&
+        (memory_size <= ((ULONG) TX_BYTE_POOL_QUICK_CLASSES * TX_BYTE_POOL_QUICK_GRANULE))) {
+        index = (UINT) ((memory_size + TX_BYTE_POOL_QUICK_GRANULE - 1) / TX_BYTE_POOL_QUICK_GRANULE) - 1;
+        memory_ptr = pool_ptr -> tx_byte_pool_quick_list[index];
+        if (memory_ptr != TX_NULL) {
+            link_ptr = TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(memory_ptr);
+            pool_ptr -> tx_byte_pool_quick_list[index] = *link_ptr;
+            pool_ptr -> tx_byte_pool_quick_count[index]--;
+            pool_ptr -> tx_byte_pool_quick_hits++;
+        }
+    }
+    return memory_ptr;
+}
+
+/* Called by _tx_byte_release for the valid block at block_ptr, return TX_TRUE if it is kept on a quick list */
+UINT _tx_byte_pool_quick_release(TX_BYTE_POOL *pool_ptr, UCHAR *block_ptr)
+{
+    UCHAR **link_ptr;
+    UCHAR *memory_ptr;
+    ULONG block_size;
+    UINT index;
+
+    /* Memory must go to the suspended threads, which the normal release does */
+    if (pool_ptr -> tx_byte_pool_suspended_count != TX_NO_SUSPENSIONS) {
+        return TX_FALSE;
+    }
+    link_ptr = TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(block_ptr);
+    block_size = TX_UCHAR_POINTER_DIF(*link_ptr, block_ptr) - TX_BYTE_BLOCK_HEADER;
+    if ((block_size < ((ULONG) TX_BYTE_POOL_QUICK_GRANULE)) ||
+        (block_size >= ((ULONG) (TX_BYTE_POOL_QUICK_CLASSES + 1) * TX_BYTE_POOL_QUICK_GRANULE))) {
+        return TX_FALSE;
+    }
+    index = (UINT) (block_size / TX_BYTE_POOL_QUICK_GRANULE) - 1;
+    if (pool_ptr -> tx_byte_pool_quick_count[index] >= ((UINT) TX_BYTE_POOL_QUICK_DEPTH)) {
+        return TX_FALSE;
+    }
+    memory_ptr = TX_UCHAR_POINTER_ADD(block_ptr, TX_BYTE_BLOCK_HEADER);
+    link_ptr = TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(memory_ptr);
+    *link_ptr = pool_ptr -> tx_byte_pool_quick_list[index];
+    pool_ptr -> tx_byte_pool_quick_list[index] = memory_ptr;
+    pool_ptr -> tx_byte_pool_quick_count[index]++;
+    return TX_TRUE;
+}
+
+/* Called by _tx_byte_allocate when the search failed, give all quick list blocks back to the pool,
+   return TX_TRUE if any block is freed and the search is worth retrying */
+UINT _tx_byte_pool_quick_flush(TX_BYTE_POOL *pool_ptr)
+{
+    UCHAR *memory_ptr;
+    UCHAR *block_ptr;
+    UCHAR **link_ptr;
+    ALIGN_TYPE *free_ptr;
+    UINT index;
+    UINT flushed = TX_FALSE;
+
+    for (index = 0; index < ((UINT) TX_BYTE_POOL_QUICK_CLASSES); index++) {
+        while ((memory_ptr = pool_ptr -> tx_byte_pool_quick_list[index]) != TX_NULL) {
+            link_ptr = TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(memory_ptr);
+            pool_ptr -> tx_byte_pool_quick_list[index] = *link_ptr;
+
+            /* Same as _tx_byte_release does to a block */
+            block_ptr = TX_UCHAR_POINTER_SUB(memory_ptr, TX_BYTE_BLOCK_HEADER);
+            free_ptr = TX_UCHAR_TO_ALIGN_TYPE_POINTER_CONVERT(TX_UCHAR_POINTER_ADD(block_ptr, (sizeof(UCHAR *))));
+            *free_ptr = TX_BYTE_BLOCK_FREE;
+            link_ptr = TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(block_ptr);
+            pool_ptr -> tx_byte_pool_available += TX_UCHAR_POINTER_DIF(*link_ptr, block_ptr);
+            if (block_ptr < pool_ptr -> tx_byte_pool_search) {
+                pool_ptr -> tx_byte_pool_search = block_ptr;
+            }
+            flushed = TX_TRUE;
+        }
+        pool_ptr -> tx_byte_pool_quick_count[index] = 0;
+    }
+    if (flushed == TX_TRUE) {
+        pool_ptr -> tx_byte_pool_quick_flushes++;
+    }
+    return flushed;
+}
+
+#endif /* TX_BYTE_POOL_QUICK_LISTS */
+
+/*
+ * Get fragmentation statistics of byte pool pointed by pool_ptr into stats, the pool is
+ * walked with interrupts disabled, so it is for diagnostics only, not for a time critical
+ * path. Adjacent free blocks are counted apart since the search merges them only when it
+ * passes them, largest_free is the largest run of adjacent free blocks.
+ */
+UINT PortGetBytePoolStats(TX_BYTE_POOL *pool_ptr, TX_PORT_BYTE_POOL_STATS *stats)
+{
+    TX_INTERRUPT_SAVE_AREA
+    UCHAR *block_ptr;
+    UCHAR *next_ptr;
+    UCHAR **link_ptr;
+    ALIGN_TYPE *free_ptr;
+    ULONG run = 0;
+    ULONG size;
+    UINT fragments;
+#ifdef TX_BYTE_POOL_QUICK_LISTS
+    UINT index;
+#endif
+
+    if ((pool_ptr == TX_NULL) || (stats == TX_NULL)) {
+        return TX_PTR_ERROR;
+    }
+    if (pool_ptr -> tx_byte_pool_id != TX_BYTE_POOL_ID) {
+        return TX_POOL_ERROR;
+    }
+    TX_MEMSET(stats, 0, (sizeof(TX_PORT_BYTE_POOL_STATS)));
+
+    TX_DISABLE
+    block_ptr = pool_ptr -> tx_byte_pool_start;
+    fragments = pool_ptr -> tx_byte_pool_fragments;
+    while (fragments != ((UINT) 0)) {
+        link_ptr = TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(block_ptr);
+        next_ptr = *link_ptr;
+        free_ptr = TX_UCHAR_TO_ALIGN_TYPE_POINTER_CONVERT(TX_UCHAR_POINTER_ADD(block_ptr, (sizeof(UCHAR *))));
+        stats -> fragments++;
+        if ((*free_ptr) == TX_BYTE_BLOCK_FREE) {
+            size = TX_UCHAR_POINTER_DIF(next_ptr, block_ptr);
+            stats -> free_fragments++;
+            stats -> free_bytes += size - TX_BYTE_BLOCK_HEADER;
+            /* Merged blocks share one header */
+            run += size;
+            if ((run - TX_BYTE_BLOCK_HEADER) > stats -> largest_free) {
+                stats -> largest_free = run - TX_BYTE_BLOCK_HEADER;
+            }
+        } else {
+            run = 0;
+        }
+        /* The last block links back to the start */
+        if (next_ptr <= block_ptr) {
+            break;
+        }
+        block_ptr = next_ptr;
+        fragments--;
+    }
+#ifdef TX_BYTE_POOL_QUICK_LISTS
+    for (index = 0; index < ((UINT) TX_BYTE_POOL_QUICK_CLASSES); index++) {
+        for (block_ptr = pool_ptr -> tx_byte_pool_quick_list[index]; block_ptr != TX_NULL; block_ptr = *link_ptr) {
+            next_ptr = TX_UCHAR_POINTER_SUB(block_ptr, TX_BYTE_BLOCK_HEADER);
+            link_ptr = TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(next_ptr);
+            stats -> quick_blocks++;
+            stats -> quick_bytes += TX_UCHAR_POINTER_DIF(*link_ptr, next_ptr) - TX_BYTE_BLOCK_HEADER;
+            link_ptr = TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(block_ptr);
+        }
+    }
+    stats -> quick_hits = pool_ptr -> tx_byte_pool_quick_hits;
+    stats -> quick_flushes = pool_ptr -> tx_byte_pool_quick_flushes;
+#endif
+    TX_RESTORE
+
+    return TX_SUCCESS;
+}
@@ -0,0 +1,303 @@
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Execution Profile Kit for Nuclei RISC-V Port                        */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define TX_SOURCE_CODE
+
+#include "tx_api.h"
+#include "tx_thread.h"
+
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+
+/* Total cycles of all threads, interrupts and idle */
+EXECUTION_TIME  _tx_execution_thread_time_total;
+EXECUTION_TIME  _tx_execution_isr_time_total;
+EXECUTION_TIME  _tx_execution_idle_time_total;
+
+/* Start cycle of current interrupt and idle, 0 means not active */
+static EXECUTION_TIME_SOURCE_TYPE   _tx_execution_isr_time_last_start;
+static EXECUTION_TIME_SOURCE_TYPE   _tx_execution_idle_time_last_start;
+static ULONG                        _tx_execution_isr_nest_count;
+/* Start cycle of elapsed time and count of outermost interrupts, for PortGetExecutionProfile */
+static EXECUTION_TIME_SOURCE_TYPE   _tx_execution_profile_start;
+static ULONG                        _tx_execution_isr_count;
+
+VOID _tx_execution_initialize(VOID)
+{
+    _tx_execution_thread_time_total = 0;
+    _tx_execution_isr_time_total = 0;
+    _tx_execution_idle_time_total = 0;
+    _tx_execution_isr_time_last_start = 0;
+    _tx_execution_isr_nest_count = 0;
+    _tx_execution_isr_count = 0;
+    _tx_execution_idle_time_last_start = TX_EXECUTION_TIME_SOURCE;
+    _tx_execution_profile_start = _tx_execution_idle_time_last_start;
+}
+
+/* Called after _tx_thread_current_ptr is switched to the new thread */
+VOID _tx_execution_thread_enter(VOID)
+{
+    TX_THREAD *thread_ptr = _tx_thread_current_ptr;
+    EXECUTION_TIME_SOURCE_TYPE now = TX_EXECUTION_TIME_SOURCE;
+
+    if (thread_ptr == TX_NULL) {
+        /* No thread ready, system is idle until next thread enter */
+        return;
+    }
+    if (_tx_execution_idle_time_last_start != 0) {
+        _tx_execution_idle_time_total += now - _tx_execution_idle_time_last_start;
+        _tx_execution_idle_time_last_start = 0;
+    }
+    thread_ptr -> tx_thread_execution_time_last_start = now;
+}
+
+/* Called before _tx_thread_current_ptr is switched out */
+VOID _tx_execution_thread_exit(VOID)
+{
+    TX_THREAD *thread_ptr = _tx_thread_current_ptr;
+    EXECUTION_TIME_SOURCE_TYPE now = TX_EXECUTION_TIME_SOURCE;
+    EXECUTION_TIME delta;
+
+    if ((thread_ptr != TX_NULL) && (thread_ptr -> tx_thread_execution_time_last_start != 0)) {
+        delta = now - thread_ptr -> tx_thread_execution_time_last_start;
+        thread_ptr -> tx_thread_execution_time_total += delta;
+        thread_ptr -> tx_thread_execution_time_last_start = 0;
+        _tx_execution_thread_time_total += delta;
+    }
+    /* Idle until next thread enter */
+    if (_tx_execution_idle_time_last_start == 0) {
+        _tx_execution_idle_time_last_start = now;
+    }
+}
+
+VOID _tx_execution_isr_enter(VOID)
+{
+    TX_THREAD *thread_ptr = _tx_thread_current_ptr;
+    EXECUTION_TIME_SOURCE_TYPE now = TX_EXECUTION_TIME_SOURCE;
+    EXECUTION_TIME delta;
+
+    _tx_execution_isr_nest_count++;
+    if (_tx_execution_isr_nest_count != 1) {
+        return;
+    }
+    /* Pause the interrupted thread or idle */
+    if ((thread_ptr != TX_NULL) && (thread_ptr -> tx_thread_execution_time_last_start != 0)) {
+        delta = now - thread_ptr -> tx_thread_execution_time_last_start;
+        thread_ptr -> tx_thread_execution_time_total += delta;
+        thread_ptr -> tx_thread_execution_time_last_start = 0;
+        _tx_execution_thread_time_total += delta;
+    } else if (_tx_execution_idle_time_last_start != 0) {
+        _tx_execution_idle_time_total += now - _tx_execution_idle_time_last_start;
+        _tx_execution_idle_time_last_start = 0;
+    }
+    _tx_execution_isr_time_last_start = now;
+    _tx_execution_isr_count++;
+}
+
+VOID _tx_execution_isr_exit(VOID)
+{
+    TX_THREAD *thread_ptr = _tx_thread_current_ptr;
+    EXECUTION_TIME_SOURCE_TYPE now = TX_EXECUTION_TIME_SOURCE;
+
+    if (_tx_execution_isr_nest_count == 0) {
+        return;
+    }
+    _tx_execution_isr_nest_count--;
+    if (_tx_execution_isr_nest_count != 0) {
+        return;
+    }
+    _tx_execution_isr_time_total += now - _tx_execution_isr_time_last_start;
+    _tx_execution_isr_time_last_start = 0;
+    /* Resume the interrupted thread or idle */
+    if (thread_ptr != TX_NULL) {
+        thread_ptr -> tx_thread_execution_time_last_start = now;
+    } else {
+        _tx_execution_idle_time_last_start = now;
+    }
+}
+
+UINT _tx_execution_thread_time_reset(TX_THREAD *thread_ptr)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    if (thread_ptr == TX_NULL) {
+        return TX_PTR_ERROR;
+    }
+    TX_DISABLE
+    thread_ptr -> tx_thread_execution_time_total = 0;
+    TX_RESTORE
+    return TX_SUCCESS;
+}
+
+UINT _tx_execution_thread_total_time_reset(VOID)
+{
+    TX_INTERRUPT_SAVE_AREA
+    TX_THREAD *thread_ptr;
+    ULONG i;
+
+    TX_DISABLE
+    _tx_execution_thread_time_total = 0;
+    thread_ptr = _tx_thread_created_ptr;
+    for (i = 0; i < _tx_thread_created_count; i++) {
+        thread_ptr -> tx_thread_execution_time_total = 0;
+        thread_ptr = thread_ptr -> tx_thread_created_next;
+    }
+    TX_RESTORE
+    return TX_SUCCESS;
+}
+
+UINT _tx_execution_isr_time_reset(VOID)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    TX_DISABLE
+    _tx_execution_isr_time_total = 0;
+    TX_RESTORE
+    return TX_SUCCESS;
+}
+
+UINT _tx_execution_idle_time_reset(VOID)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    TX_DISABLE
+    _tx_execution_idle_time_total = 0;
+    TX_RESTORE
+    return TX_SUCCESS;
+}
+
+UINT _tx_execution_thread_time_get(TX_THREAD *thread_ptr, EXECUTION_TIME *total_time)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    if ((thread_ptr == TX_NULL) || (total_time == TX_NULL)) {
+        return TX_PTR_ERROR;
+    }
+    TX_DISABLE
+    *total_time = thread_ptr -> tx_thread_execution_time_total;
+    /* Add the running part of current thread */
+    if (thread_ptr -> tx_thread_execution_time_last_start != 0) {
+        *total_time += TX_EXECUTION_TIME_SOURCE - thread_ptr -> tx_thread_execution_time_last_start;
+    }
+    TX_RESTORE
+    return TX_SUCCESS;
+}
+
+UINT _tx_execution_thread_total_time_get(EXECUTION_TIME *total_time)
+{
+    TX_INTERRUPT_SAVE_AREA
+    TX_THREAD *thread_ptr;
+
+    if (total_time == TX_NULL) {
+        return TX_PTR_ERROR;
+    }
+    TX_DISABLE
+    *total_time = _tx_execution_thread_time_total;
+    thread_ptr = _tx_thread_current_ptr;
+    if ((thread_ptr != TX_NULL) && (thread_ptr -> tx_thread_execution_time_last_start != 0)) {
+        *total_time += TX_EXECUTION_TIME_SOURCE - thread_ptr -> tx_thread_execution_time_last_start;
+    }
+    TX_RESTORE
+    return TX_SUCCESS;
+}
+
+UINT _tx_execution_isr_time_get(EXECUTION_TIME *total_time)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    if (total_time == TX_NULL) {
+        return TX_PTR_ERROR;
+    }
+    TX_DISABLE
+    *total_time = _tx_execution_isr_time_total;
+    TX_RESTORE
+    return TX_SUCCESS;
+}
+
+UINT _tx_execution_idle_time_get(EXECUTION_TIME *total_time)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    if (total_time == TX_NULL) {
+        return TX_PTR_ERROR;
+    }
+    TX_DISABLE
+    *total_time = _tx_execution_idle_time_total;
+    if (_tx_execution_idle_time_last_start != 0) {
+        *total_time += TX_EXECUTION_TIME_SOURCE - _tx_execution_idle_time_last_start;
+    }
+    TX_RESTORE
+    return TX_SUCCESS;
+}
+
+UINT PortGetExecutionProfile(TX_PORT_EXECUTION_PROFILE *profile)
+{
+    TX_INTERRUPT_SAVE_AREA
+    TX_THREAD *thread_ptr;
+    EXECUTION_TIME_SOURCE_TYPE now;
+
+    if (profile == TX_NULL) {
+        return TX_PTR_ERROR;
+    }
+    TX_DISABLE
+    now = TX_EXECUTION_TIME_SOURCE;
+    profile -> thread_time = _tx_execution_thread_time_total;
+    profile -> isr_time = _tx_execution_isr_time_total;
+    profile -> idle_time = _tx_execution_idle_time_total;
+    /* Add the running part of current thread, interrupt or idle */
+    thread_ptr = _tx_thread_current_ptr;
+    if ((thread_ptr != TX_NULL) && (thread_ptr -> tx_thread_execution_time_last_start != 0)) {
+        profile -> thread_time += now - thread_ptr -> tx_thread_execution_time_last_start;
+    }
+    if (_tx_execution_isr_time_last_start != 0) {
+        profile -> isr_time += now - _tx_execution_isr_time_last_start;
+    }
+    if (_tx_execution_idle_time_last_start != 0) {
+        profile -> idle_time += now - _tx_execution_idle_time_last_start;
+    }
+    profile -> elapsed_time = now - _tx_execution_profile_start;
+    profile -> isr_count = _tx_execution_isr_count;
+    TX_RESTORE
+    return TX_SUCCESS;
+}
+
+/* Reset all totals including each thread, the running part restarts from now */
+UINT PortResetExecutionProfile(VOID)
+{
+    TX_INTERRUPT_SAVE_AREA
+    TX_THREAD *thread_ptr;
+    EXECUTION_TIME_SOURCE_TYPE now;
+    ULONG i;
+
+    TX_DISABLE
+    now = TX_EXECUTION_TIME_SOURCE;
+    _tx_execution_thread_time_total = 0;
+    _tx_execution_isr_time_total = 0;
+    _tx_execution_idle_time_total = 0;
+    _tx_execution_isr_count = 0;
+    thread_ptr = _tx_thread_created_ptr;
+    for (i = 0; i < _tx_thread_created_count; i++) {
+        thread_ptr -> tx_thread_execution_time_total = 0;
+        if (thread_ptr -> tx_thread_execution_time_last_start != 0) {
+            thread_ptr -> tx_thread_execution_time_last_start = now;
+        }
+        thread_ptr = thread_ptr -> tx_thread_created_next;
+    }
+    if (_tx_execution_isr_time_last_start != 0) {
+        _tx_execution_isr_time_last_start = now;
+    }
+    if (_tx_execution_idle_time_last_start != 0) {
+        _tx_execution_idle_time_last_start = now;
+    }
+    _tx_execution_profile_start = now;
+    TX_RESTORE
+    return TX_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,64 @@
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Execution Profile Kit for Nuclei RISC-V Port                        */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+/* This file is included by tx_api.h when TX_EXECUTION_PROFILE_ENABLE is defined,
+   it provides the same API as the ThreadX execution profile kit, thread execution
+   time is accumulated in PortThreadSwitch using cpu cycle counter mcycle.  */
+
+#ifndef TX_EXECUTION_PROFILE_H
+#define TX_EXECUTION_PROFILE_H
+
+/* Total execution time is accumulated in cpu cycles */
+#ifndef TX_EXECUTION_TIME_SOURCE
+#define TX_EXECUTION_TIME_SOURCE                (EXECUTION_TIME_SOURCE_TYPE) __get_rv_cycle()
+#endif
+
+typedef ULONG64                                 EXECUTION_TIME;
+typedef ULONG64                                 EXECUTION_TIME_SOURCE_TYPE;
+
+/* Called by ThreadX and port layer, user should not call them directly */
+VOID  _tx_execution_initialize(VOID);
+VOID  _tx_execution_thread_enter(VOID);
+VOID  _tx_execution_thread_exit(VOID);
+
+/* Called by SysTick_Handler of port layer, call them at the beginning and end of other
+   interrupt handlers which need to be excluded from thread execution time */
+VOID  _tx_execution_isr_enter(VOID);
+VOID  _tx_execution_isr_exit(VOID);
+
+#define TX_EXECUTION_ISR_ENTER                  _tx_execution_isr_enter();
+#define TX_EXECUTION_ISR_EXIT                   _tx_execution_isr_exit();
+
+/* Execution profile API, this file is included before TX_THREAD is defined */
+struct TX_THREAD_STRUCT;
+UINT  _tx_execution_thread_time_reset(struct TX_THREAD_STRUCT *thread_ptr);
+UINT  _tx_execution_thread_total_time_reset(VOID);
+UINT  _tx_execution_isr_time_reset(VOID);
+UINT  _tx_execution_idle_time_reset(VOID);
+UINT  _tx_execution_thread_time_get(struct TX_THREAD_STRUCT *thread_ptr, EXECUTION_TIME *total_time);
+UINT  _tx_execution_thread_total_time_get(EXECUTION_TIME *total_time);
+UINT  _tx_execution_isr_time_get(EXECUTION_TIME *total_time);
+UINT  _tx_execution_idle_time_get(EXECUTION_TIME *total_time);
+
+/* Snapshot of all execution time since initialization or last PortResetExecutionProfile,
+   thread, isr and idle time add up to elapsed time, so cpu load is 1 - idle / elapsed */
+typedef struct TX_PORT_EXECUTION_PROFILE_STRUCT
+{
+    EXECUTION_TIME              thread_time;        /* Cycles spent in all threads          */
+    EXECUTION_TIME              isr_time;           /* Cycles spent in profiled interrupts  */
+    EXECUTION_TIME              idle_time;          /* Cycles with no thread running        */
+    EXECUTION_TIME              elapsed_time;       /* Cycles since profile start           */
+    ULONG                       isr_count;          /* Count of profiled outermost interrupts */
+} TX_PORT_EXECUTION_PROFILE;
+
+UINT  PortGetExecutionProfile(TX_PORT_EXECUTION_PROFILE *profile);
+UINT  PortResetExecutionProfile(VOID);
+
+#endif
@@ -154,6 +154,79 @@ typedef unsigned short                          USHORT;
 #define TX_PORT_SPECIFIC_BUILD_OPTIONS          0
 
 
+/* Define the ThreadX SMP port definitions, TX_THREAD_SMP is defined when building with the
+   ThreadX SMP kernel sources (common_smp) instead of common, each hart index is a core.  */
+
+#ifdef TX_THREAD_SMP
+
+#ifndef TX_THREAD_SMP_MAX_CORES
+#if defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1)
+#define TX_THREAD_SMP_MAX_CORES                 SMP_CPU_CNT
+#else
+#define TX_THREAD_SMP_MAX_CORES                 2
+#endif
+#endif
+
+/* Define the mask of all cores, used by tx_thread_smp_core_exclude to exclude cores from running a thread.  */
+
+#ifndef TX_THREAD_SMP_CORE_MASK
+#define TX_THREAD_SMP_CORE_MASK                 ((ULONG)((1UL << TX_THREAD_SMP_MAX_CORES) - 1))
+#endif
+
+/* Preempt other cores by SysTimer software interrupt, see _tx_thread_smp_core_preempt.  */
+
+#define TX_THREAD_SMP_INTER_CORE_INTERRUPT
+
+/* Idle cores are sleeping in wfi, so they are woken up by the same software interrupt.  */
+
+#define TX_THREAD_SMP_WAKEUP_LOGIC
+#define TX_THREAD_SMP_WAKEUP(i)                 _tx_thread_smp_core_preempt(i)
+
+/* Thread resume and suspend can't be in-line in SMP.  */
+
+#ifdef TX_INLINE_THREAD_RESUME_SUSPEND
+#undef TX_INLINE_THREAD_RESUME_SUSPEND
+#endif
+
+/* Define the ThreadX SMP protection structure, the in force flag is taken by amoswap.  */
+
+typedef struct TX_THREAD_SMP_PROTECT_STRUCT
+{
+    volatile ULONG              tx_thread_smp_protect_in_force;
+    struct TX_THREAD_STRUCT     *tx_thread_smp_protect_thread;
+    volatile ULONG              tx_thread_smp_protect_core;
+    volatile ULONG              tx_thread_smp_protect_count;
+} TX_THREAD_SMP_PROTECT;
+
+/* Core id used in protection when no core holds it.  */
+
+#define TX_THREAD_SMP_INVALID_CORE              ((ULONG)0xFFFFFFFFUL)
+
+/* Define the get system state macro.  */
+
+#define TX_THREAD_GET_SYSTEM_STATE()            _tx_thread_smp_current_state_get()
+
+/* Define the check for whether or not to call the _tx_thread_system_return function.  A non-zero value
+   indicates that _tx_thread_system_return should not be called.  */
+
+#define TX_THREAD_SYSTEM_RETURN_CHECK(c)        (c) = (ULONG) _tx_thread_preempt_disable; (c) = (c) | TX_THREAD_GET_SYSTEM_STATE();
+
+/* Define the macro to get the core ID.  */
+
+#define TX_SMP_CORE_ID                          _tx_thread_smp_core_get()
+
+UINT    _tx_thread_smp_protect(VOID);
+VOID    _tx_thread_smp_unprotect(UINT interrupt_save);
+UINT    _tx_thread_smp_core_get(VOID);
+VOID    _tx_thread_smp_core_preempt(UINT core);
+ULONG   _tx_thread_smp_current_state_get(VOID);
+ULONG   _tx_thread_smp_time_get(VOID);
+VOID    _tx_thread_smp_initialize_wait(VOID);
+VOID    _tx_thread_smp_low_level_initialize(UINT number_of_cores);
+
+#endif
+
+
 /* Define the in-line initialization constant so that modules with in-line
    initialization capabilities can prevent their initialization from being
    a function call.  */
@@ -185,7 +258,14 @@ typedef unsigned short                          USHORT;
 /* Define the port extensions of the remaining ThreadX objects.  */
 
 #define TX_BLOCK_POOL_EXTENSION
+#ifdef TX_BYTE_POOL_QUICK_LISTS
+#define TX_BYTE_POOL_EXTENSION                  UCHAR   *tx_byte_pool_quick_list[TX_BYTE_POOL_QUICK_CLASSES];     \
+                                                UINT    tx_byte_pool_quick_count[TX_BYTE_POOL_QUICK_CLASSES];     \
+                                                ULONG   tx_byte_pool_quick_hits;                                  \
+                                                ULONG   tx_byte_pool_quick_flushes;
+#else
 #define TX_BYTE_POOL_EXTENSION
+#endif
 #define TX_EVENT_FLAGS_GROUP_EXTENSION
 #define TX_MUTEX_EXTENSION
 #define TX_QUEUE_EXTENSION
@@ -204,8 +284,20 @@ typedef unsigned short                          USHORT;
 /* Define the macros for processing extensions in tx_thread_create, tx_thread_delete,
    tx_thread_shell_entry, and tx_thread_terminate.  */
 
+#if defined(NUCLEI_STACK_MONITOR) && (NUCLEI_STACK_MONITOR == 1)
+/* Register thread stack into stack high water mark monitor, see stackmon_api.h of profiling middleware,
+   call stackmon_scan() in the lowest priority thread since there is no idle thread in ThreadX.  */
+#include "stackmon_api.h"
+#define TX_THREAD_CREATE_EXTENSION(thread_ptr)      stackmon_register((thread_ptr), (thread_ptr) -> tx_thread_name,   \
+                                                                      (thread_ptr) -> tx_thread_stack_start,        \
+                                                                      (thread_ptr) -> tx_thread_stack_size,         \
+                                                                      (thread_ptr) -> tx_thread_stack_ptr,          \
+                                                                      (uint32_t)TX_STACK_FILL);
+#define TX_THREAD_DELETE_EXTENSION(thread_ptr)      stackmon_unregister((thread_ptr));
+#else
 #define TX_THREAD_CREATE_EXTENSION(thread_ptr)
 #define TX_THREAD_DELETE_EXTENSION(thread_ptr)
+#endif
 #define TX_THREAD_COMPLETED_EXTENSION(thread_ptr)
 #define TX_THREAD_TERMINATED_EXTENSION(thread_ptr)
 
@@ -239,7 +331,15 @@ typedef unsigned short                          USHORT;
    is used to define a local function save area for the disable and restore
    macros.  */
 
-#ifdef TX_DISABLE_INLINE
+#if defined(TX_THREAD_SMP)
+
+/* Interrupts are disabled and the SMP protection is taken.  */
+#define TX_INTERRUPT_SAVE_AREA                  UINT interrupt_save;
+
+#define TX_DISABLE                              interrupt_save = _tx_thread_smp_protect();
+#define TX_RESTORE                              _tx_thread_smp_unprotect(interrupt_save);
+
+#elif defined(TX_DISABLE_INLINE)
 
 #define TX_INTERRUPT_SAVE_AREA                  register ULONG interrupt_save;
 
@@ -257,6 +357,11 @@ typedef unsigned short                          USHORT;
 
 #endif
 
+#ifdef TX_THREAD_SMP
+/* Request a context switch of this core, and release the SMP protection held by caller,
+   see tx_thread_smp.c  */
+VOID    _tx_thread_system_return(VOID);
+#else
 static inline void _tx_thread_system_return(void)
 {
         /* Set a software interrupt(SWI) request to request a context switch. */
@@ -265,6 +370,70 @@ static inline void _tx_thread_system_return(void)
         within the specified behaviour for the architecture. */
         __RWMB();
 }
+#endif
+
+/* Define the tickless idle interfaces, enabled by TX_LOW_POWER. tx_low_power_enter and
+   tx_low_power_exit are called around wfi in the idle loop of _tx_thread_schedule.  */
+
+#ifdef TX_LOW_POWER
+typedef struct TX_PORT_TICKLESS_STATS_STRUCT
+{
+    ULONG                       sleeps;             /* Times of tick suppressed sleep       */
+    ULONG                       early_wakeups;      /* Times of woken up before the deadline */
+    ULONG64                     slept_ticks;        /* Tick periods passed in sleep         */
+    ULONG64                     compensated_ticks;  /* Tick periods advanced in one step    */
+    ULONG64                     slept_counts;       /* SysTimer counts spent in sleep       */
+} TX_PORT_TICKLESS_STATS;
+
+VOID    tx_low_power_enter(VOID);
+VOID    tx_low_power_exit(VOID);
+VOID    PortGetTicklessStats(TX_PORT_TICKLESS_STATS *stats);
+VOID    PortPreSleepProcessing(ULONG ticks);
+VOID    PortPostSleepProcessing(ULONG ticks);
+#endif
+
+
+/* Define the byte pool quick lists, enabled by TX_BYTE_POOL_QUICK_LISTS. Released blocks of up to
+   TX_BYTE_POOL_QUICK_CLASSES * TX_BYTE_POOL_QUICK_GRANULE bytes are kept on size class lists of their
+   pool, at most TX_BYTE_POOL_QUICK_DEPTH blocks each, and tx_byte_allocate pops them without the
+   first-fit search. They are given back to the pool when a search fails, and blocks on the lists are
+   not counted as available by tx_byte_pool_info_get, see tx_byte_pool_quick.c.  */
+
+struct TX_BYTE_POOL_STRUCT;
+
+#ifdef TX_BYTE_POOL_QUICK_LISTS
+#ifndef TX_BYTE_POOL_QUICK_GRANULE
+#define TX_BYTE_POOL_QUICK_GRANULE              8           /* Bytes between size classes, multiple of ALIGN_TYPE */
+#endif
+#ifndef TX_BYTE_POOL_QUICK_CLASSES
+#define TX_BYTE_POOL_QUICK_CLASSES              8           /* Number of size classes   */
+#endif
+#ifndef TX_BYTE_POOL_QUICK_DEPTH
+#define TX_BYTE_POOL_QUICK_DEPTH                8           /* Max blocks of each class */
+#endif
+
+UCHAR   *_tx_byte_pool_quick_allocate(struct TX_BYTE_POOL_STRUCT *pool_ptr, ULONG memory_size);
+UINT    _tx_byte_pool_quick_release(struct TX_BYTE_POOL_STRUCT *pool_ptr, UCHAR *block_ptr);
+UINT    _tx_byte_pool_quick_flush(struct TX_BYTE_POOL_STRUCT *pool_ptr);
+#endif
+
+/* Define the byte pool statistics of PortGetBytePoolStats, quick list fields are 0 without
+   TX_BYTE_POOL_QUICK_LISTS.  */
+
+typedef struct TX_PORT_BYTE_POOL_STATS_STRUCT
+{
+    ULONG                       fragments;          /* Blocks in the pool, free or allocated    */
+    ULONG                       free_fragments;     /* Free blocks, adjacent ones counted apart */
+    ULONG                       free_bytes;         /* Bytes of free blocks, without headers    */
+    ULONG                       largest_free;       /* Largest run of adjacent free blocks      */
+    ULONG                       quick_blocks;       /* Blocks kept on quick lists               */
+    ULONG                       quick_bytes;        /* Bytes of blocks kept on quick lists      */
+    ULONG                       quick_hits;         /* Allocations served by quick lists        */
+    ULONG                       quick_flushes;      /* Quick lists given back for failed search */
+} TX_PORT_BYTE_POOL_STATS;
+
+UINT    PortGetBytePoolStats(struct TX_BYTE_POOL_STRUCT *pool_ptr, TX_PORT_BYTE_POOL_STATS *stats);
+
 
 /* Define the interrupt lockout macros for each ThreadX object.  */
 
@@ -0,0 +1,121 @@
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   SMP Low Level Functions for Nuclei RISC-V Port                      */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define TX_SOURCE_CODE
+
+#include "tx_api.h"
+#include "tx_thread.h"
+#include "tx_timer.h"
+
+#ifdef TX_THREAD_SMP
+
+#if !defined(__riscv_atomic)
+#error "TX_THREAD_SMP requires RISC-V A extension for SMP protection, please use a march with a extension"
+#endif
+
+/* Each hart index is a core, core 0 is the one running tx_kernel_enter */
+UINT _tx_thread_smp_core_get(VOID)
+{
+    return (UINT)__get_hart_index();
+}
+
+/* Take the SMP protection with interrupts of this core disabled, it is nested on the same core */
+UINT _tx_thread_smp_protect(VOID)
+{
+    UINT interrupt_save;
+    ULONG core;
+
+    interrupt_save = (UINT)__RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    core = _tx_thread_smp_core_get();
+
+    /* Only this core writes its id into protection, so it is safe to check without lock */
+    if (_tx_thread_smp_protection.tx_thread_smp_protect_core != core) {
+        while (__atomic_exchange_n(&_tx_thread_smp_protection.tx_thread_smp_protect_in_force, 1, __ATOMIC_ACQUIRE) != 0) {
+            while (_tx_thread_smp_protection.tx_thread_smp_protect_in_force != 0);
+        }
+        _tx_thread_smp_protection.tx_thread_smp_protect_core = core;
+        _tx_thread_smp_protection.tx_thread_smp_protect_thread = _tx_thread_current_ptr[core];
+    }
+    _tx_thread_smp_protection.tx_thread_smp_protect_count++;
+    return interrupt_save;
+}
+
+static inline VOID _tx_thread_smp_protect_release(VOID)
+{
+    _tx_thread_smp_protection.tx_thread_smp_protect_count = 0;
+    _tx_thread_smp_protection.tx_thread_smp_protect_thread = TX_NULL;
+    _tx_thread_smp_protection.tx_thread_smp_protect_core = TX_THREAD_SMP_INVALID_CORE;
+    __atomic_store_n(&_tx_thread_smp_protection.tx_thread_smp_protect_in_force, 0, __ATOMIC_RELEASE);
+}
+
+/* Release the outermost protection unless preemption is disabled, then restore interrupts */
+VOID _tx_thread_smp_unprotect(UINT interrupt_save)
+{
+    ULONG core = _tx_thread_smp_core_get();
+
+    if (_tx_thread_smp_protection.tx_thread_smp_protect_core == core) {
+        if (_tx_thread_smp_protection.tx_thread_smp_protect_count > 0) {
+            _tx_thread_smp_protection.tx_thread_smp_protect_count--;
+        }
+        if ((_tx_thread_smp_protection.tx_thread_smp_protect_count == 0) && (_tx_thread_preempt_disable == 0)) {
+            _tx_thread_smp_protect_release();
+        }
+    }
+    __RV_CSR_SET(CSR_MSTATUS, interrupt_save & MSTATUS_MIE);
+}
+
+/*
+ * Called with the protection held when the current thread of this core changed,
+ * interrupts are still disabled, the switch is done in PortThreadSwitch as soon
+ * as caller restores interrupts.
+ */
+VOID _tx_thread_system_return(VOID)
+{
+    SysTimer_SetSWIRQ();
+    __RWMB();
+    _tx_thread_smp_protect_release();
+}
+
+/* Request other core to reschedule by SysTimer software interrupt, it is also used to wake up idle core */
+VOID _tx_thread_smp_core_preempt(UINT core)
+{
+    __RWMB();
+    SysTimer_SendIPI(core);
+}
+
+/* Free running time source shared by all cores */
+ULONG _tx_thread_smp_time_get(VOID)
+{
+    return (ULONG)SysTimer_GetLoadValue();
+}
+
+/* Harts are already released by __sync_harts in startup code and waiting in _tx_thread_smp_initialize_wait */
+VOID _tx_thread_smp_low_level_initialize(UINT number_of_cores)
+{
+    (VOID)number_of_cores;
+}
+
+/* Entry of secondary cores, wait for core 0 finishing initialization then enter scheduler */
+VOID _tx_thread_smp_initialize_wait(VOID)
+{
+    UINT core = _tx_thread_smp_core_get();
+
+    if (core == 0) {
+        return;
+    }
+    while (_tx_thread_system_state[0] != 0);
+    while (_tx_thread_smp_release_cores_flag == 0);
+    __RWMB();
+
+    _tx_thread_system_state[core] = 0;
+    _tx_thread_schedule();
+}
+
+#endif
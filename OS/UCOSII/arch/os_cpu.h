@@ -115,9 +115,34 @@ typedef  uint32_t         OS_CPU_SR;        /* Define size of Machine status reg
 *             disable interrupts.  'cpu_sr' is allocated in all of uC/OS-II's functions that need to
 *             disable interrupts.  You would restore the interrupt disable state by copying back 'cpu_sr'
 *             into the CPU's status register.
+*
+*             When OS_CPU_MTH_CRITICAL_EN is set to 1 in os_cfg.h, 'cpu_sr' saves the ECLIC MTH instead of
+*             mstatus.MIE, and the critical section raises MTH to the level calculated from
+*             configMAX_SYSCALL_INTERRUPT_PRIORITY, interrupts with a higher level are never masked by the
+*             kernel, so they must not call any uC/OS-II service.
 *********************************************************************************************************
 */
 
+#ifndef  OS_CPU_MTH_CRITICAL_EN
+#define  OS_CPU_MTH_CRITICAL_EN   0u
+#endif
+
+/* Suppress tick interrupts in idle task and replay the elapsed ticks in one step on wakeup */
+#ifndef  OS_CPU_TICKLESS_EN
+#define  OS_CPU_TICKLESS_EN       0u
+#endif
+
+#if OS_CPU_TICKLESS_EN > 0u
+/* Minimum ticks of idle time to suppress tick interrupts, shorter idle time just executes wfi */
+#ifndef  OS_CPU_TICKLESS_THRESHOLD
+#define  OS_CPU_TICKLESS_THRESHOLD    2u
+#endif
+/* Maximum ticks suppressed in one sleep, when no task is delayed and no timer is running */
+#ifndef  OS_CPU_TICKLESS_MAX_TICKS
+#define  OS_CPU_TICKLESS_MAX_TICKS    0x7FFFFFFFu
+#endif
+#endif
+
 #define  OS_CRITICAL_METHOD   3u
 
 #if OS_CRITICAL_METHOD == 3u
@@ -139,6 +164,20 @@ typedef  uint32_t         OS_CPU_SR;        /* Define size of Machine status reg
 #define  OS_TASK_SW()           portYIELD()
 #define  OSIntCtxSw()           portYIELD()
 
+/* Find highest priority from a non-zero ready group or ready table entry, which is the
+   index of its lowest set bit, by a single ctz with Zbb instead of OSUnMapTbl lookups */
+#ifndef  OS_CPU_FIND_HIGHEST_PRIO_EN
+#if defined(__riscv_zbb)
+#define  OS_CPU_FIND_HIGHEST_PRIO_EN    1u
+#else
+#define  OS_CPU_FIND_HIGHEST_PRIO_EN    0u
+#endif
+#endif
+
+#if OS_CPU_FIND_HIGHEST_PRIO_EN > 0u
+#define  OS_CPU_FIND_HIGHEST_PRIO(bits) ((INT8U)__CTZL((unsigned long)(bits)))
+#endif
+
 #ifndef OS_TICKS_PER_SEC
 #warning "Use default OS_TICKS_PER_SEC=100"
 #define OS_TICKS_PER_SEC            100
@@ -155,20 +194,54 @@ typedef  uint32_t         OS_CPU_SR;        /* Define size of Machine status reg
 */
 
 #if OS_CRITICAL_METHOD == 3u                      /* See os_cpu_a.S   */
-portFORCE_INLINE OS_CPU_SR OS_CPU_SR_Save(void)
+#if OS_CPU_MTH_CRITICAL_EN > 0u
+/* Nested critical sections restore the MTH saved by the outer one, uxMaxSysCallMTH is 255 before
+   OSStartHighRdy calculates it, so all the interrupts are masked during initialization */
+portFORCE_INLINE static OS_CPU_SR OS_CPU_SR_Save(void)
+{
+    return (OS_CPU_SR)ulPortRaiseBASEPRI();
+}
+
+portFORCE_INLINE static void OS_CPU_SR_Restore(OS_CPU_SR cpu_sr)
+{
+    vPortSetBASEPRI((uint8_t)cpu_sr);
+}
+#else
+portFORCE_INLINE static OS_CPU_SR OS_CPU_SR_Save(void)
 {
     return __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
 }
 
-portFORCE_INLINE void OS_CPU_SR_Restore(OS_CPU_SR cpu_sr)
+portFORCE_INLINE static void OS_CPU_SR_Restore(OS_CPU_SR cpu_sr)
 {
     __RV_CSR_WRITE(CSR_MSTATUS, cpu_sr);
 }
 #endif
+#endif
 
 void       OSCtxSw(void);
 void       OSStartHighRdy(void);
 
+#if OS_CPU_TICKLESS_EN > 0u
+typedef struct {
+    INT32U     Sleeps;                            /* Times of tick suppressed sleep                     */
+    INT32U     Aborts;                            /* Times of sleep abandoned for pending task switch   */
+    INT32U     EarlyWakeups;                      /* Times of woken up before the deadline              */
+    INT64U     SleptTicks;                        /* Tick periods passed in sleep                       */
+    INT64U     CompensatedTicks;                  /* Tick periods advanced in one step                  */
+    INT64U     SleptCounts;                       /* SysTimer counts spent in sleep                     */
+} OS_CPU_TICKLESS_STATS;
+
+void       OS_CPU_TicklessIdle(void);
+void       OS_CPU_TicklessStatsGet(OS_CPU_TICKLESS_STATS *p_stats);
+void       OS_CPU_PreSleepHook(INT32U *p_ticks);
+void       OS_CPU_PostSleepHook(INT32U ticks);
+#if (OS_TMR_EN > 0u) && (OS_CPU_HOOKS_EN > 0u) && (OS_TIME_TICK_HOOK_EN > 0u)
+INT32U     OS_CPU_TmrNextSignal(void);
+void       OS_CPU_TmrStep(INT32U ticks);
+#endif
+#endif
+
 
 /*
 *********************************************************************************************************
@@ -39,6 +39,15 @@
 */
 
 #include  <ucos_ii.h>
+#if defined(NUCLEI_STACK_MONITOR) && (NUCLEI_STACK_MONITOR == 1)
+#include  "stackmon_api.h"
+#endif
+#if defined(NUCLEI_DLOG) && (NUCLEI_DLOG == 1)
+#include  "dlog_api.h"
+#endif
+#if defined(NUCLEI_GPROF_TASK) && (NUCLEI_GPROF_TASK == 1)
+#include  "gprof_api.h"
+#endif
 
 /*
 *********************************************************************************************************
@@ -110,6 +119,13 @@ void  OSInitHookEnd(void)
 #if OS_CPU_HOOKS_EN > 0u
 void  OSTaskCreateHook(OS_TCB*  p_tcb)
 {
+#if defined(NUCLEI_STACK_MONITOR) && (NUCLEI_STACK_MONITOR == 1) && (OS_TASK_CREATE_EXT_EN > 0u)
+    /* Only task created by OSTaskCreateExt() has stack bottom and size, paint with 0 as OS_TASK_OPT_STK_CLR */
+    if (p_tcb->OSTCBStkSize != 0u) {
+        stackmon_register(p_tcb, NULL, p_tcb->OSTCBStkBottom, p_tcb->OSTCBStkSize * sizeof(OS_STK),
+                          p_tcb->OSTCBStkPtr, 0u);
+    }
+#endif
 #if OS_APP_HOOKS_EN > 0u
     App_TaskCreateHook(p_tcb);
 #else
@@ -134,6 +150,9 @@ void  OSTaskCreateHook(OS_TCB*  p_tcb)
 #if OS_CPU_HOOKS_EN > 0u
 void  OSTaskDelHook(OS_TCB*  p_tcb)
 {
+#if defined(NUCLEI_STACK_MONITOR) && (NUCLEI_STACK_MONITOR == 1)
+    stackmon_unregister(p_tcb);
+#endif
 #if OS_APP_HOOKS_EN > 0u
     App_TaskDelHook(p_tcb);
 #else
@@ -159,9 +178,18 @@ void  OSTaskDelHook(OS_TCB*  p_tcb)
 #if OS_CPU_HOOKS_EN > 0u
 void  OSTaskIdleHook(void)
 {
+#if defined(NUCLEI_STACK_MONITOR) && (NUCLEI_STACK_MONITOR == 1)
+    stackmon_scan();
+#endif
+#if defined(NUCLEI_DLOG) && (NUCLEI_DLOG == 1)
+    (void)dlog_flush();
+#endif
 #if OS_APP_HOOKS_EN > 0u
     App_TaskIdleHook();
 #endif
+#if OS_CPU_TICKLESS_EN > 0u
+    OS_CPU_TicklessIdle();
+#endif
 }
 #endif
 
@@ -234,12 +262,26 @@ void  OSTaskStatHook(void)
 *              2) It is assumed that the global pointer 'OSTCBHighRdy' points to the TCB of the task that
 *                 will be 'switched in' (i.e. the highest priority task) and, 'OSTCBCur' points to the
 *                 task being switched out (i.e. the preempted task).
+*              3) When OS_TASK_PROFILE_EN is enabled, OSTCBCyclesTot of the task switched out is
+*                 accumulated using cpu cycle counter mcycle.
 *********************************************************************************************************
 */
 
 #if (OS_CPU_HOOKS_EN > 0u) && (OS_TASK_SW_HOOK_EN > 0u)
 void  OSTaskSwHook(void)
 {
+#if OS_TASK_PROFILE_EN > 0u
+    INT32U  cycles;
+
+    cycles = (INT32U)__get_rv_cycle();
+    if (OSTCBCur != OSTCBHighRdy) {
+        OSTCBCur->OSTCBCyclesTot += cycles - OSTCBCur->OSTCBCyclesStart;
+        OSTCBHighRdy->OSTCBCyclesStart = cycles;
+    } else if (OSTCBCur->OSTCBCyclesStart == 0u) {
+        OSTCBCur->OSTCBCyclesStart = cycles;   /* First task started by OSStartHighRdy()              */
+    }
+#endif
+
 #if OS_APP_HOOKS_EN > 0u
     App_TaskSwHook();
 #endif
@@ -303,6 +345,67 @@ void  OSTimeTickHook(void)
 #endif
 
 
+/*
+*********************************************************************************************************
+*                                      TIMER SIGNAL FOR TICKLESS IDLE
+*
+* Description: OS_CPU_TmrNextSignal() returns the number of ticks until OSTimeTickHook() signals the timer
+*              task, or 0 when no timer is running so the signals can be skipped.  OS_CPU_TmrStep() advances
+*              the signal counter by the ticks suppressed by tickless idle.
+*
+* Arguments  : ticks    is the number of suppressed ticks, which never passes a signal of running timers.
+*
+* Note(s)    : 1) Interrupts are disabled during these calls.
+*********************************************************************************************************
+*/
+
+#if (OS_CPU_TICKLESS_EN > 0u) && (OS_TMR_EN > 0u) && (OS_CPU_HOOKS_EN > 0u) && (OS_TIME_TICK_HOOK_EN > 0u)
+INT32U  OS_CPU_TmrNextSignal(void)
+{
+    INT16U  i;
+
+
+    for (i = 0u; i < OS_TMR_CFG_MAX; i++) {
+        if (OSTmrTbl[i].OSTmrState == OS_TMR_STATE_RUNNING) {
+            return ((INT32U)(OS_TICKS_PER_SEC / OS_TMR_CFG_TICKS_PER_SEC) - OSTmrCtr);
+        }
+    }
+    return (0u);
+}
+
+void  OS_CPU_TmrStep(INT32U ticks)
+{
+    OSTmrCtr = (INT16U)((OSTmrCtr + ticks) % (OS_TICKS_PER_SEC / OS_TMR_CFG_TICKS_PER_SEC));
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         GPROF CURRENT TASK
+*
+* Description: This function is called by gprof_sample() to count the sample into the histogram of the
+*              running task when NUCLEI_GPROF_TASK=1.
+*
+* Arguments  : name     is set to the task name when OS_TASK_NAME_EN is enabled.
+*
+* Note(s)    : 1) NULL is returned before OSStart(), so the samples are only in gmon.out.
+*********************************************************************************************************
+*/
+
+#if defined(NUCLEI_GPROF_TASK) && (NUCLEI_GPROF_TASK == 1)
+const void  *gprof_current_task(const char **name)
+{
+    if (OSRunning != OS_TRUE) {
+        return ((const void *)0);
+    }
+#if OS_TASK_NAME_EN > 0u
+    *name = (const char *)OSTCBCur->OSTCBTaskName;
+#endif
+    return ((const void *)OSTCBCur);
+}
+#endif
+
 /*
 *********************************************************************************************************
 *                                          SYS TICK HANDLER
@@ -2,6 +2,7 @@
 #include "ucos_ii.h"
 #include "nuclei_sdk_soc.h"
 #include "os_cpu_port.h"
+#include "nmsis_rtos.h"
 
 //#define ENABLE_KERNEL_DEBUG
 
@@ -37,7 +38,6 @@
 #define portMTH_MASK                ( 0xFFUL )
 
 /* Constants required to set up the initial stack. */
-#define portINITIAL_MSTATUS         ( MSTATUS_MPP | MSTATUS_MPIE | MSTATUS_FS_INITIAL | MSTATUS_VS_INITIAL)
 #define portINITIAL_EXC_RETURN      ( 0xfffffffd )
 
 /* Let the user override the pre-loading of the initial LR with the address of
@@ -96,6 +96,12 @@ static UBaseType_t uxCriticalNesting = 0xaaaaaaaa;
  */
 uint8_t uxMaxSysCallMTH = 255;
 
+#if OS_CPU_TICKLESS_EN > 0u
+/* Absolute SysTimer compare value of next tick, reloaded by adding one tick period */
+static uint64_t ullPortNextTickTime = 0;
+static OS_CPU_TICKLESS_STATS xPortTicklessStats;
+#endif
+
 /*-----------------------------------------------------------*/
 /*
  *********************************************************************************************************
@@ -202,25 +208,9 @@ OS_STK* OSTaskStkInit(void (*task)(void* pd), void* pdata, OS_STK* ptos, INT16U
     // Force stack 8byte align for double floating point case
     OS_STK* pxTopOfStack = (OS_STK*)(((unsigned long)ptos) & (~(unsigned long)(portBYTE_ALIGNMENT - 1)));
 
-    /* Offset added to account for the way the MCU uses the stack on entry/exit
-    of interrupts, and to ensure alignment. */
-    pxTopOfStack--;
-    *pxTopOfStack = portINITIAL_MSTATUS;    /* MSTATUS */
-
-    /* Save code space by skipping register initialisation. */
-#ifndef __riscv_32e
-    pxTopOfStack -= 22;    /* X11 - X31. */
-#else
-    pxTopOfStack -= 6;    /* X11 - X15. */
-#endif
-    *pxTopOfStack = (StackType_t) pdata;      /* X10/A0 */
-    pxTopOfStack -= 6; /* X5 - X9 */
-    *pxTopOfStack = (StackType_t) portTASK_RETURN_ADDRESS;      /* RA, X1 */
-
-    pxTopOfStack --;
-    *pxTopOfStack = ((StackType_t) task) ;        /* PC */
-
-    return pxTopOfStack;
+    /* Frame layout is shared with other RTOS ports in nmsis_rtos.h */
+    return (OS_STK*)__RV_FrameInit((unsigned long*)pxTopOfStack, (unsigned long)task,
+                                   (unsigned long)pdata, (unsigned long)portTASK_RETURN_ADDRESS, 0);
 }
 
 static void prvTaskExitError(void)
@@ -423,7 +413,14 @@ void xPortSysTickHandler(void)
     save and then restore the interrupt mask value as its value is already
     known. */
     OS_ENTER_CRITICAL();
+#if OS_CPU_TICKLESS_EN > 0u
+    /* Reload from the tick boundary instead of mtime, so tick period never drifts
+    and the boundaries passed in tickless sleep can be counted exactly */
+    ullPortNextTickTime += SYSTICK_TICK_CONST;
+    SysTimer_SetCompareValue(ullPortNextTickTime);
+#else
     SysTick_Reload(SYSTICK_TICK_CONST);
+#endif
     OSIntEnter();                              /* Tell uC/OS-II that we are starting an ISR            */
     OS_EXIT_CRITICAL();
 
@@ -445,6 +442,9 @@ __attribute__((weak)) void vPortSetupTimerInterrupt(void)
     /* Make SWI and SysTick the lowest priority interrupts. */
     /* Stop and clear the SysTimer. SysTimer as Non-Vector Interrupt */
     SysTick_Config(ticks);
+#if OS_CPU_TICKLESS_EN > 0u
+    ullPortNextTickTime = SysTimer_GetCompareValue();
+#endif
     ECLIC_DisableIRQ(SysTimer_IRQn);
     ECLIC_SetLevelIRQ(SysTimer_IRQn, configKERNEL_INTERRUPT_PRIORITY);
     ECLIC_SetShvIRQ(SysTimer_IRQn, ECLIC_NON_VECTOR_INTERRUPT);
@@ -456,3 +456,197 @@ __attribute__((weak)) void vPortSetupTimerInterrupt(void)
     ECLIC_EnableIRQ(SysTimerSW_IRQn);
 }
 /*-----------------------------------------------------------*/
+
+#if OS_CPU_TICKLESS_EN > 0u
+
+/*
+ * Called with interrupts disabled before sleep, application can override it
+ * to gate clocks and enter low power mode, set *p_ticks to 0 to tell the port
+ * that wfi is already executed.
+ */
+__attribute__((weak)) void OS_CPU_PreSleepHook(INT32U *p_ticks)
+{
+    (void)p_ticks;
+}
+
+/*
+ * Called with interrupts disabled after wakeup, application can override it
+ * to restore the clocks gated in OS_CPU_PreSleepHook.
+ */
+__attribute__((weak)) void OS_CPU_PostSleepHook(INT32U ticks)
+{
+    (void)ticks;
+}
+
+void OS_CPU_TicklessStatsGet(OS_CPU_TICKLESS_STATS *p_stats)
+{
+    __disable_irq();
+    *p_stats = xPortTicklessStats;
+    __enable_irq();
+}
+
+/*
+ * Ticks until the next event of kernel, it is the shortest delay or pend
+ * timeout of tasks, limited by the next signal of timer task when any
+ * timer is running.
+ */
+static INT32U prvNextEventTicks(void)
+{
+    OS_TCB *ptcb;
+    INT32U ticks = OS_CPU_TICKLESS_MAX_TICKS;
+#if (OS_TMR_EN > 0u) && (OS_CPU_HOOKS_EN > 0u) && (OS_TIME_TICK_HOOK_EN > 0u)
+    INT32U tmr_ticks;
+
+    tmr_ticks = OS_CPU_TmrNextSignal();
+    if ((tmr_ticks != 0u) && (tmr_ticks < ticks)) {
+        ticks = tmr_ticks;
+    }
+#endif
+
+    for (ptcb = OSTCBList; ptcb->OSTCBPrio != OS_TASK_IDLE_PRIO; ptcb = ptcb->OSTCBNext) {
+        if ((ptcb->OSTCBDly != 0u) && (ptcb->OSTCBDly < ticks)) {
+            ticks = ptcb->OSTCBDly;
+        }
+    }
+    return ticks;
+}
+
+/*
+ * Advance the ticks passed in sleep as OSTimeTick does, the step never
+ * reaches the next event, so no task becomes ready here.
+ */
+static void prvTicklessStep(INT32U step)
+{
+    OS_TCB *ptcb;
+
+    if (step == 0u) {
+        return;
+    }
+#if OS_TIME_GET_SET_EN > 0u
+    OSTime += step;
+#endif
+    for (ptcb = OSTCBList; ptcb->OSTCBPrio != OS_TASK_IDLE_PRIO; ptcb = ptcb->OSTCBNext) {
+        if (ptcb->OSTCBDly != 0u) {
+            ptcb->OSTCBDly -= step;
+        }
+    }
+#if (OS_TMR_EN > 0u) && (OS_CPU_HOOKS_EN > 0u) && (OS_TIME_TICK_HOOK_EN > 0u)
+    OS_CPU_TmrStep(step);
+#endif
+}
+
+/*
+ * Called by OSTaskIdleHook, suppress the tick interrupts until the next
+ * kernel event and sleep, then step the ticks passed in sleep in one go.
+ * Tick hooks are not called for the stepped ticks.
+ */
+__attribute__((weak)) void OS_CPU_TicklessIdle(void)
+{
+    uint64_t ullSleepStart, ullNow;
+    INT32U xExpectedIdleTime, xModifiableIdleTime, xSleptTicks, xStepTicks;
+    rv_csr_t mstatus;
+
+    /* Disable interrupts but not by OS_ENTER_CRITICAL as MTH would mask
+    interrupts that should exit sleep mode, wfi still wakes up on pending
+    interrupt when interrupts are disabled. */
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+
+    /* If a task switch is pending then abandon the low power entry, the
+    tick interrupt is untouched. */
+    if ((OSRunning != OS_TRUE) || (SysTimer_GetMsipValue() & SysTimer_MSIP_MSIP_Msk)) {
+        xPortTicklessStats.Aborts++;
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+        return;
+    }
+#if OS_TICK_STEP_EN > 0u
+    /* Ticks are processed one by one when uC/OS-View is stepping */
+    if (OSTickStepState != OS_TICK_STEP_DIS) {
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+        return;
+    }
+#endif
+
+    xExpectedIdleTime = prvNextEventTicks();
+    if (xExpectedIdleTime < OS_CPU_TICKLESS_THRESHOLD) {
+        __WFI();
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+        return;
+    }
+
+    UCOSII_PORT_DEBUG("Enter TickLess %u\n", (unsigned int)xExpectedIdleTime);
+
+    /* The pending tick boundary is the first idle tick, so wake up exactly at
+    the boundary of the last expected idle tick. */
+    SysTimer_SetCompareValue(ullPortNextTickTime + (uint64_t)(xExpectedIdleTime - 1u) * SYSTICK_TICK_CONST);
+    __RWMB();
+    ullSleepStart = SysTimer_GetLoadValue();
+
+    xModifiableIdleTime = xExpectedIdleTime;
+    OS_CPU_PreSleepHook(&xModifiableIdleTime);
+    if (xModifiableIdleTime > 0u) {
+        __WFI();
+    }
+    OS_CPU_PostSleepHook(xExpectedIdleTime);
+
+    /* SysTimer keeps counting during sleep, so the tick boundaries passed
+    are got from 64-bit mtime directly without any estimation. */
+    ullNow = SysTimer_GetLoadValue();
+    if (ullNow >= ullPortNextTickTime) {
+        xSleptTicks = (INT32U)((ullNow - ullPortNextTickTime) / SYSTICK_TICK_CONST) + 1u;
+    } else {
+        xSleptTicks = 0u;
+    }
+
+    /* The last passed tick is processed by the pending tick interrupt, the
+    others are stepped forward. Never step to the next event, the remaining
+    passed ticks are caught up by the tick interrupt one by one since the
+    compare value is already passed. */
+    xStepTicks = 0u;
+    if (xSleptTicks > 0u) {
+        xStepTicks = xSleptTicks - 1u;
+        if (xStepTicks > xExpectedIdleTime - 1u) {
+            xStepTicks = xExpectedIdleTime - 1u;
+        }
+    }
+    ullPortNextTickTime += (uint64_t)xStepTicks * SYSTICK_TICK_CONST;
+    SysTimer_SetCompareValue(ullPortNextTickTime);
+    prvTicklessStep(xStepTicks);
+
+    xPortTicklessStats.Sleeps++;
+    if (xSleptTicks < xExpectedIdleTime) {
+        xPortTicklessStats.EarlyWakeups++;
+    }
+    xPortTicklessStats.SleptTicks += xSleptTicks;
+    xPortTicklessStats.CompensatedTicks += xStepTicks;
+    xPortTicklessStats.SleptCounts += ullNow - ullSleepStart;
+
+    UCOSII_PORT_DEBUG("End TickLess %u\n", (unsigned int)xStepTicks);
+
+    /* Pending tick interrupt is taken when interrupts are restored */
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
+
+#endif /* OS_CPU_TICKLESS_EN */
+/*-----------------------------------------------------------*/
+
+/*
+ * newlib malloc lock, scheduler is locked instead of disabling interrupts like the
+ * default one in SoC stubs, so malloc can't be called in interrupt handlers,
+ * OSSchedLock nests so the lock is recursive, and nothing switches before OSStart
+ */
+#if OS_SCHED_LOCK_EN > 0u
+struct _reent;
+
+void __malloc_lock(struct _reent *reent)
+{
+    (void)reent;
+    OSSchedLock();
+}
+
+void __malloc_unlock(struct _reent *reent)
+{
+    (void)reent;
+    OSSchedUnlock();
+}
+#endif /* OS_SCHED_LOCK_EN */
+/*-----------------------------------------------------------*/
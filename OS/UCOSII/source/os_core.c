@@ -1084,12 +1084,20 @@ INT8U  OS_EventTaskRdy (OS_EVENT  *pevent,
     INT8U     y;
     INT8U     x;
     INT8U     prio;
-#if OS_LOWEST_PRIO > 63u
+#if (OS_LOWEST_PRIO > 63u) && !defined(OS_CPU_FIND_HIGHEST_PRIO)
     OS_PRIO  *ptbl;
 #endif
 
 
+#if defined(OS_CPU_FIND_HIGHEST_PRIO)                   /* Find HPT waiting for message by port hook   */
+    y    = OS_CPU_FIND_HIGHEST_PRIO(pevent->OSEventGrp);
+    x    = OS_CPU_FIND_HIGHEST_PRIO(pevent->OSEventTbl[y]);
 #if OS_LOWEST_PRIO <= 63u
+    prio = (INT8U)((y << 3u) + x);                      /* Find priority of task getting the msg       */
+#else
+    prio = (INT8U)((y << 4u) + x);                      /* Find priority of task getting the msg       */
+#endif
+#elif OS_LOWEST_PRIO <= 63u
     y    = OSUnMapTbl[pevent->OSEventGrp];              /* Find HPT waiting for message                */
     x    = OSUnMapTbl[pevent->OSEventTbl[y]];
     prio = (INT8U)((y << 3u) + x);                      /* Find priority of task getting the msg       */
@@ -1750,7 +1758,17 @@ void  OS_Sched (void)
 
 static  void  OS_SchedNew (void)
 {
-#if OS_LOWEST_PRIO <= 63u                        /* See if we support up to 64 tasks                   */
+#if defined(OS_CPU_FIND_HIGHEST_PRIO)            /* Port finds the lowest set bit, eg. by a ctz        */
+    INT8U   y;
+
+
+    y             = OS_CPU_FIND_HIGHEST_PRIO(OSRdyGrp);
+#if OS_LOWEST_PRIO <= 63u
+    OSPrioHighRdy = (INT8U)((y << 3u) + OS_CPU_FIND_HIGHEST_PRIO(OSRdyTbl[y]));
+#else
+    OSPrioHighRdy = (INT8U)((y << 4u) + OS_CPU_FIND_HIGHEST_PRIO(OSRdyTbl[y]));
+#endif
+#elif OS_LOWEST_PRIO <= 63u                      /* See if we support up to 64 tasks                   */
     INT8U   y;
 
 
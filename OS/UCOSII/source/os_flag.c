@@ -43,6 +43,7 @@
 
 static  void     OS_FlagBlock(OS_FLAG_GRP *pgrp, OS_FLAG_NODE *pnode, OS_FLAGS flags, INT8U wait_type, INT32U timeout);
 static  BOOLEAN  OS_FlagTaskRdy(OS_FLAG_NODE *pnode, OS_FLAGS flags_rdy, INT8U pend_stat);
+static  BOOLEAN  OS_FlagTaskRdyAll(OS_FLAG_NODE *pnode, OS_FLAGS flags_rdy);
 
 
 /*
@@ -391,7 +392,7 @@ OS_FLAG_GRP  *OSFlagDel (OS_FLAG_GRP  *pgrp,
              pnode = (OS_FLAG_NODE *)pgrp->OSFlagWaitList;
              while (pnode != (OS_FLAG_NODE *)0) {          /* Ready ALL tasks waiting for flags        */
                  (void)OS_FlagTaskRdy(pnode, (OS_FLAGS)0, OS_STAT_PEND_ABORT);
-                 pnode = (OS_FLAG_NODE *)pnode->OSFlagNodeNext;
+                 pnode = (OS_FLAG_NODE *)pgrp->OSFlagWaitList; /* Unlink may move a NODE to the head  */
              }
 #if OS_FLAG_NAME_EN > 0u
              pgrp->OSFlagName     = (INT8U *)(void *)"?";
@@ -880,6 +881,7 @@ OS_FLAGS  OSFlagPost (OS_FLAG_GRP  *pgrp,
                       INT8U        *perr)
 {
     OS_FLAG_NODE *pnode;
+    OS_FLAG_NODE *pnode_next;
     BOOLEAN       sched;
     OS_FLAGS      flags_cur;
     OS_FLAGS      flags_rdy;
@@ -930,11 +932,12 @@ OS_FLAGS  OSFlagPost (OS_FLAG_GRP  *pgrp,
     sched = OS_FALSE;                                /* Indicate that we don't need rescheduling       */
     pnode = (OS_FLAG_NODE *)pgrp->OSFlagWaitList;
     while (pnode != (OS_FLAG_NODE *)0) {             /* Go through all tasks waiting on event flag(s)  */
+        pnode_next = (OS_FLAG_NODE *)pnode->OSFlagNodeNext;
         switch (pnode->OSFlagNodeWaitType) {
             case OS_FLAG_WAIT_SET_ALL:               /* See if all req. flags are set for current node */
                  flags_rdy = (OS_FLAGS)(pgrp->OSFlagFlags & pnode->OSFlagNodeFlags);
                  if (flags_rdy == pnode->OSFlagNodeFlags) {   /* Make task RTR, event(s) Rx'd          */
-                     rdy = OS_FlagTaskRdy(pnode, flags_rdy, OS_STAT_PEND_OK);
+                     rdy = OS_FlagTaskRdyAll(pnode, flags_rdy);
                      if (rdy == OS_TRUE) {
                          sched = OS_TRUE;                     /* When done we will reschedule          */
                      }
@@ -944,7 +947,7 @@ OS_FLAGS  OSFlagPost (OS_FLAG_GRP  *pgrp,
             case OS_FLAG_WAIT_SET_ANY:               /* See if any flag set                            */
                  flags_rdy = (OS_FLAGS)(pgrp->OSFlagFlags & pnode->OSFlagNodeFlags);
                  if (flags_rdy != (OS_FLAGS)0) {              /* Make task RTR, event(s) Rx'd          */
-                     rdy = OS_FlagTaskRdy(pnode, flags_rdy, OS_STAT_PEND_OK);
+                     rdy = OS_FlagTaskRdyAll(pnode, flags_rdy);
                      if (rdy == OS_TRUE) {
                          sched = OS_TRUE;                     /* When done we will reschedule          */
                      }
@@ -955,7 +958,7 @@ OS_FLAGS  OSFlagPost (OS_FLAG_GRP  *pgrp,
             case OS_FLAG_WAIT_CLR_ALL:               /* See if all req. flags are set for current node */
                  flags_rdy = (OS_FLAGS)~pgrp->OSFlagFlags & pnode->OSFlagNodeFlags;
                  if (flags_rdy == pnode->OSFlagNodeFlags) {   /* Make task RTR, event(s) Rx'd          */
-                     rdy = OS_FlagTaskRdy(pnode, flags_rdy, OS_STAT_PEND_OK);
+                     rdy = OS_FlagTaskRdyAll(pnode, flags_rdy);
                      if (rdy == OS_TRUE) {
                          sched = OS_TRUE;                     /* When done we will reschedule          */
                      }
@@ -965,7 +968,7 @@ OS_FLAGS  OSFlagPost (OS_FLAG_GRP  *pgrp,
             case OS_FLAG_WAIT_CLR_ANY:               /* See if any flag set                            */
                  flags_rdy = (OS_FLAGS)~pgrp->OSFlagFlags & pnode->OSFlagNodeFlags;
                  if (flags_rdy != (OS_FLAGS)0) {              /* Make task RTR, event(s) Rx'd          */
-                     rdy = OS_FlagTaskRdy(pnode, flags_rdy, OS_STAT_PEND_OK);
+                     rdy = OS_FlagTaskRdyAll(pnode, flags_rdy);
                      if (rdy == OS_TRUE) {
                          sched = OS_TRUE;                     /* When done we will reschedule          */
                      }
@@ -978,7 +981,7 @@ OS_FLAGS  OSFlagPost (OS_FLAG_GRP  *pgrp,
                  OS_TRACE_FLAG_POST_EXIT(*perr);
                  return ((OS_FLAGS)0);
         }
-        pnode = (OS_FLAG_NODE *)pnode->OSFlagNodeNext; /* Point to next task waiting for event flag(s) */
+        pnode = pnode_next;                          /* Point to next task waiting for event flag(s)   */
     }
     OS_EXIT_CRITICAL();
     if (sched == OS_TRUE) {
@@ -1094,6 +1097,9 @@ static  void  OS_FlagBlock (OS_FLAG_GRP  *pgrp,
                             INT32U        timeout)
 {
     OS_FLAG_NODE  *pnode_next;
+#if OS_FLAG_INDEX_EN > 0u
+    OS_FLAG_NODE  *pnode_same;
+#endif
     INT8U          y;
 
 
@@ -1106,14 +1112,41 @@ static  void  OS_FlagBlock (OS_FLAG_GRP  *pgrp,
     pnode->OSFlagNodeFlags    = flags;                /* Save the flags that we need to wait for       */
     pnode->OSFlagNodeWaitType = wait_type;            /* Save the type of wait we are doing            */
     pnode->OSFlagNodeTCB      = (void *)OSTCBCur;     /* Link to task's TCB                            */
-    pnode->OSFlagNodeNext     = pgrp->OSFlagWaitList; /* Add node at beginning of event flag wait list */
-    pnode->OSFlagNodePrev     = (void *)0;
     pnode->OSFlagNodeFlagGrp  = (void *)pgrp;         /* Link to Event Flag Group                      */
-    pnode_next                = (OS_FLAG_NODE *)pgrp->OSFlagWaitList;
-    if (pnode_next != (void *)0) {                    /* Is this the first NODE to insert?             */
-        pnode_next->OSFlagNodePrev = pnode;           /* No, link in doubly linked list                */
+#if OS_FLAG_INDEX_EN > 0u
+    pnode_same                = (OS_FLAG_NODE *)pgrp->OSFlagWaitList;
+    while (pnode_same != (OS_FLAG_NODE *)0) {         /* Find a NODE waiting for the same condition    */
+        if ((pnode_same->OSFlagNodeFlags    == flags) &&
+            (pnode_same->OSFlagNodeWaitType == wait_type)) {
+            break;
+        }
+        pnode_same = (OS_FLAG_NODE *)pnode_same->OSFlagNodeNext;
+    }
+    if (pnode_same != (OS_FLAG_NODE *)0) {            /* Yes, chain behind it, out of the wait list    */
+        pnode->OSFlagNodeNext     = (void *)0;
+        pnode->OSFlagNodePrev     = (void *)0;
+        pnode->OSFlagNodeSamePrev = (void *)pnode_same;
+        pnode->OSFlagNodeSameNext = pnode_same->OSFlagNodeSameNext;
+        pnode_next                = (OS_FLAG_NODE *)pnode_same->OSFlagNodeSameNext;
+        if (pnode_next != (OS_FLAG_NODE *)0) {
+            pnode_next->OSFlagNodeSamePrev = pnode;
+        }
+        pnode_same->OSFlagNodeSameNext = pnode;
+    } else
+#endif
+    {
+#if OS_FLAG_INDEX_EN > 0u
+        pnode->OSFlagNodeSameNext = (void *)0;
+        pnode->OSFlagNodeSamePrev = (void *)0;
+#endif
+        pnode->OSFlagNodeNext     = pgrp->OSFlagWaitList; /* Add node at beginning of event flag wait list */
+        pnode->OSFlagNodePrev     = (void *)0;
+        pnode_next                = (OS_FLAG_NODE *)pgrp->OSFlagWaitList;
+        if (pnode_next != (void *)0) {                /* Is this the first NODE to insert?             */
+            pnode_next->OSFlagNodePrev = pnode;       /* No, link in doubly linked list                */
+        }
+        pgrp->OSFlagWaitList = (void *)pnode;
     }
-    pgrp->OSFlagWaitList = (void *)pnode;
 
     y            =  OSTCBCur->OSTCBY;                 /* Suspend current task until flag(s) received   */
     OSRdyTbl[y] &= (OS_PRIO)~OSTCBCur->OSTCBBitX;
@@ -1232,6 +1265,51 @@ static  BOOLEAN  OS_FlagTaskRdy (OS_FLAG_NODE *pnode,
 }
 
 
+/*
+*********************************************************************************************************
+*                         MAKE ALL TASKS WAITING FOR THE SAME FLAGS READY-TO-RUN
+*
+* Description: This function is internal to uC/OS-II and is used to make the task of a node in the wait list
+*              ready-to-run, with OS_FLAG_INDEX_EN the tasks chained to it waiting for the same flags with
+*              the same wait type are made ready-to-run too.
+*
+* Arguments  : pnode         is a pointer to the node in the wait list whose wait condition is met.
+*
+*              flags_rdy     contains the bit pattern of the event flags that cause the tasks to become
+*                            ready-to-run.
+*
+* Returns    : OS_TRUE       If any task has been placed in the ready list and thus needs scheduling
+*              OS_FALSE      No task is ready to run and thus scheduling is not necessary
+*
+* Called by  : OSFlagPost() OS_FLAG.C
+*
+* Note(s)    : 1) This function assumes that interrupts are disabled.
+*********************************************************************************************************
+*/
+
+static  BOOLEAN  OS_FlagTaskRdyAll (OS_FLAG_NODE *pnode,
+                                    OS_FLAGS      flags_rdy)
+{
+#if OS_FLAG_INDEX_EN > 0u
+    OS_FLAG_NODE *pnode_same;
+    BOOLEAN       sched;
+
+
+    sched = OS_FALSE;
+    while (pnode != (OS_FLAG_NODE *)0) {                   /* Unlinking moves the next of the same up  */
+        pnode_same = (OS_FLAG_NODE *)pnode->OSFlagNodeSameNext;
+        if (OS_FlagTaskRdy(pnode, flags_rdy, OS_STAT_PEND_OK) == OS_TRUE) {
+            sched = OS_TRUE;
+        }
+        pnode = pnode_same;
+    }
+    return (sched);
+#else
+    return (OS_FlagTaskRdy(pnode, flags_rdy, OS_STAT_PEND_OK));
+#endif
+}
+
+
 /*
 *********************************************************************************************************
 *                              UNLINK EVENT FLAG NODE FROM WAITING LIST
@@ -1261,10 +1339,41 @@ void  OS_FlagUnlink (OS_FLAG_NODE *pnode)
     OS_FLAG_GRP  *pgrp;
     OS_FLAG_NODE *pnode_prev;
     OS_FLAG_NODE *pnode_next;
+#if OS_FLAG_INDEX_EN > 0u
+    OS_FLAG_NODE *pnode_same;
+#endif
 
 
+#if OS_TASK_DEL_EN > 0u
+    ptcb       = (OS_TCB *)pnode->OSFlagNodeTCB;
+#endif
+#if OS_FLAG_INDEX_EN > 0u
+    pnode_same = (OS_FLAG_NODE *)pnode->OSFlagNodeSameNext;
+    pnode_prev = (OS_FLAG_NODE *)pnode->OSFlagNodeSamePrev;
+    if (pnode_prev != (OS_FLAG_NODE *)0) {                      /* Chained behind a node in wait list? */
+        pnode_prev->OSFlagNodeSameNext = pnode_same;            /*      Yes, only leave the chain      */
+        if (pnode_same != (OS_FLAG_NODE *)0) {
+            pnode_same->OSFlagNodeSamePrev = pnode_prev;
+        }
+#if OS_TASK_DEL_EN > 0u
+        ptcb->OSTCBFlagNode = (OS_FLAG_NODE *)0;
+#endif
+        return;
+    }
+#endif
     pnode_prev = (OS_FLAG_NODE *)pnode->OSFlagNodePrev;
     pnode_next = (OS_FLAG_NODE *)pnode->OSFlagNodeNext;
+#if OS_FLAG_INDEX_EN > 0u
+    if (pnode_same != (OS_FLAG_NODE *)0) {                      /* Next of the same takes its place?   */
+        pnode_same->OSFlagNodeSamePrev = (void *)0;
+        pnode_same->OSFlagNodePrev     = (void *)pnode_prev;
+        pnode_same->OSFlagNodeNext     = (void *)pnode_next;
+        if (pnode_next != (OS_FLAG_NODE *)0) {
+            pnode_next->OSFlagNodePrev = pnode_same;
+        }
+        pnode_next = pnode_same;                                /*      Link it in instead of the node */
+    }
+#endif
     if (pnode_prev == (OS_FLAG_NODE *)0) {                      /* Is it first node in wait list?      */
         pgrp                 = (OS_FLAG_GRP *)pnode->OSFlagNodeFlagGrp;
         pgrp->OSFlagWaitList = (void *)pnode_next;              /*      Update list for new 1st node   */
@@ -1278,7 +1387,6 @@ void  OS_FlagUnlink (OS_FLAG_NODE *pnode)
         }
     }
 #if OS_TASK_DEL_EN > 0u
-    ptcb                = (OS_TCB *)pnode->OSFlagNodeTCB;
     ptcb->OSTCBFlagNode = (OS_FLAG_NODE *)0;
 #endif
 }
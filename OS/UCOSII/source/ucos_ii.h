@@ -410,6 +410,16 @@ typedef  INT32U   OS_FLAGS;
 #endif
 
 
+/*
+* With OS_FLAG_INDEX_EN, only the first NODE of the tasks waiting for the same flags with the same wait type
+* is in the wait list, the others are chained to it, so OSFlagPost() evaluates each distinct wait condition
+* once instead of every waiting task, and the time spent with interrupts disabled is bounded by the number
+* of distinct conditions plus the number of tasks made ready.
+*/
+#ifndef OS_FLAG_INDEX_EN
+#define OS_FLAG_INDEX_EN          0u
+#endif
+
 typedef struct os_flag_grp {                /* Event Flag Group                                        */
     INT8U         OSFlagType;               /* Should be set to OS_EVENT_TYPE_FLAG                     */
     void         *OSFlagWaitList;           /* Pointer to first NODE of task waiting on event flag     */
@@ -424,6 +434,10 @@ typedef struct os_flag_grp {                /* Event Flag Group
 typedef struct os_flag_node {               /* Event Flag Wait List Node                               */
     void         *OSFlagNodeNext;           /* Pointer to next     NODE in wait list                   */
     void         *OSFlagNodePrev;           /* Pointer to previous NODE in wait list                   */
+#if OS_FLAG_INDEX_EN > 0u
+    void         *OSFlagNodeSameNext;       /* Pointer to next NODE waiting for same flags and type    */
+    void         *OSFlagNodeSamePrev;       /* Pointer to prev NODE of same wait, NULL if in wait list */
+#endif
     void         *OSFlagNodeTCB;            /* Pointer to TCB of waiting task                          */
     void         *OSFlagNodeFlagGrp;        /* Pointer to Event Flag Group                             */
     OS_FLAGS      OSFlagNodeFlags;          /* Event flag to wait on                                   */
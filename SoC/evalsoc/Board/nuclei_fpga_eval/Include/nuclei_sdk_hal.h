@@ -11,7 +11,13 @@ extern "C" {
 #define SOC_DEBUG_UART      UART0
 
 #ifndef DISABLE_NSDK_DEBUG
+#if defined(NUCLEI_DLOG) && (NUCLEI_DLOG == 1)
+/* record debug message into dlog, formatted later by dlog_flush */
+#include "dlog_api.h"
+#define NSDK_DEBUG(fmt, ...)    DLOG(fmt, ##__VA_ARGS__)
+#else
 #define NSDK_DEBUG(fmt, ...)    printf(fmt, ##__VA_ARGS__)
+#endif
 #else
 #define NSDK_DEBUG(fmt, ...)
 #endif
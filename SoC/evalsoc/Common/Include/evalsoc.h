@@ -636,8 +636,78 @@ typedef struct {
                                     while (UART0->TXFIFO & (1<<31));    \
                                     UART0->TXFIFO = 4; }
 
+/*
+ * Simulation summary mode, only used by Nuclei internally, define SIMULATION_SUMMARY=1 to enable it.
+ * Console output is dropped, and cycles, retired instructions and SIMU_SUMMARY_EVENTS hpm events
+ * of boot hart from end of _premain_init to simulation_exit are written in one SimuSummary_Type
+ * record at simulation_exit, to SimuSummary variable, or to SIMU_SUMMARY_ADDR if it is defined,
+ * which the simulation model dumps then, so printf never costs simulated time.
+ */
+#if defined(SIMULATION_SUMMARY) && (SIMULATION_SUMMARY == 1)
+#define SIMU_SUMMARY_MAGIC      0x4D55534EUL    /*!< "NSUM" */
+#define SIMU_SUMMARY_VERSION    1
+#define SIMU_SUMMARY_EVENTS     4               /*!< hpm events counted in summary */
+#ifndef SIMU_SUMMARY_HPM_BASE
+/* mhpmcounter3 ~ 6 are the default ones of NMSIS_BENCH_HPM, keep away from them */
+#define SIMU_SUMMARY_HPM_BASE   7               /*!< first mhpmcounter used by summary */
+#endif
+/* default events: icache miss, dcache miss, conditional branch, conditional branch prediction fail */
+#ifndef SIMU_SUMMARY_EVENT0
+#define SIMU_SUMMARY_EVENT0     0xF0000011UL
+#endif
+#ifndef SIMU_SUMMARY_EVENT1
+#define SIMU_SUMMARY_EVENT1     0xF0000021UL
+#endif
+#ifndef SIMU_SUMMARY_EVENT2
+#define SIMU_SUMMARY_EVENT2     0xF0000080UL
+#endif
+#ifndef SIMU_SUMMARY_EVENT3
+#define SIMU_SUMMARY_EVENT3     0xF0000180UL
+#endif
+
+typedef struct {
+    uint32_t magic;                             /*!< SIMU_SUMMARY_MAGIC, written last */
+    uint32_t version;                           /*!< SIMU_SUMMARY_VERSION */
+    int32_t status;                             /*!< exit status */
+    uint32_t nevents;                           /*!< SIMU_SUMMARY_EVENTS */
+    uint64_t cycles;                            /*!< cycles of boot hart */
+    uint64_t instret;                           /*!< retired instructions of boot hart */
+    uint32_t event[SIMU_SUMMARY_EVENTS];        /*!< mhpmevent value of each counter */
+    uint64_t count[SIMU_SUMMARY_EVENTS];        /*!< hpm counter value of each event */
+} SimuSummary_Type;
+
+extern volatile SimuSummary_Type SimuSummary;
+extern void SimuSummary_Start(void);
+#endif
+
 extern uint32_t get_cpu_freq(void);
+extern void clear_cpu_freq_cache(void);
 extern void delay_1ms(uint32_t count);
+extern void delay_us(uint32_t count);
+extern void delay_ns(uint32_t count);
+
+#ifndef CLOCK_MONOTONIC_RAW
+/** clock_gettime clock of cpu cycle counter, not defined by newlib */
+#define CLOCK_MONOTONIC_RAW     5
+#endif
+
+/**
+ * Heap regions used by \ref malloc_in, region except default one is defined by symbols
+ * `__heap_<region>_start` and `__heap_<region>_end` in linker script, such as
+ * `__heap_dlm_start` and `__heap_dlm_end`, region is empty when they are not defined
+ */
+typedef enum HEAP_REGION {
+    HEAP_REGION_DEFAULT = 0,        /*!< Heap of malloc, __heap_start ~ __heap_end */
+    HEAP_REGION_ILM,                /*!< Heap in ILM, __heap_ilm_start ~ __heap_ilm_end */
+    HEAP_REGION_DLM,                /*!< Heap in DLM, __heap_dlm_start ~ __heap_dlm_end */
+    HEAP_REGION_SRAM,               /*!< Heap in SRAM, __heap_sram_start ~ __heap_sram_end */
+    HEAP_REGION_DDR,                /*!< Heap in DDR, __heap_ddr_start ~ __heap_ddr_end */
+    HEAP_REGION_MAX
+} HeapRegion_Type;
+
+extern void *malloc_in(HeapRegion_Type region, size_t size);
+extern void free_in(void *ptr);
+extern size_t heap_region_avail(HeapRegion_Type region);
 
 /** @} */ /* End of group evalsoc */
 
@@ -70,6 +70,45 @@ int32_t uart_enable_rxint(UART_TypeDef* uart);
 int32_t uart_disable_rxint(UART_TypeDef* uart);
 int32_t uart_get_status(UART_TypeDef* uart);
 int32_t uart_clear_status(UART_TypeDef* uart, uint32_t mask);
+
+/* Ring buffer of buffered uart, size must be power of 2 */
+typedef struct uart_ring {
+    uint8_t *buf;
+    uint32_t size;
+    volatile uint32_t head;             /* next position to put, only changed by producer */
+    volatile uint32_t tail;             /* next position to get, only changed by consumer */
+} UART_RING_Type;
+
+/*
+ * Interrupt driven uart, writers copy data into tx ring and return, the uart interrupt
+ * fills tx fifo in bursts each time it drains under the tx watermark, and moves rx fifo
+ * data into rx ring, call uart_buffered_irq_handler in the interrupt handler of the uart
+ */
+typedef struct uart_buffered {
+    UART_TypeDef *uart;
+    UART_RING_Type tx;
+    UART_RING_Type rx;
+    uint32_t tx_dropped;                /* bytes dropped by non-blocking write as tx ring full */
+    uint32_t rx_overrun;                /* bytes dropped as rx ring full */
+} UART_BUFFERED_Type;
+
+/* tx interrupt is pending when tx fifo entries are less than it */
+#ifndef UART_BUFFERED_TX_WATERMARK
+#define UART_BUFFERED_TX_WATERMARK      4
+#endif
+
+int32_t uart_buffered_init(UART_BUFFERED_Type* ub, UART_TypeDef* uart, uint8_t* txbuf, uint32_t txsize,
+                           uint8_t* rxbuf, uint32_t rxsize);
+int32_t uart_buffered_write(UART_BUFFERED_Type* ub, const uint8_t* data, uint32_t len, uint32_t blocking);
+int32_t uart_buffered_read(UART_BUFFERED_Type* ub, uint8_t* data, uint32_t len, uint32_t blocking);
+void uart_buffered_flush(UART_BUFFERED_Type* ub);
+void uart_buffered_irq_handler(UART_BUFFERED_Type* ub);
+
+#if defined(NUCLEI_UART_BUFFERED) && (NUCLEI_UART_BUFFERED == 1)
+/* Buffered SOC_DEBUG_UART used by stdio stubs, its uart is NULL until SystemInit sets it up */
+extern UART_BUFFERED_Type SystemDebugUART;
+#endif
+
 #ifdef __cplusplus
 }
 #endif
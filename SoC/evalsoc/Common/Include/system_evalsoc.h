@@ -36,6 +36,10 @@ extern "C" {
 #include <stdint.h>
 
 extern volatile uint32_t SystemCoreClock;     /*!< System Clock Frequency (Core Clock) */
+extern volatile uint64_t SystemBootCycles;    /*!< Cycles from reset to main, recorded by boot hart */
+#if defined(NUCLEI_BOOT_FASTINIT) && (NUCLEI_BOOT_FASTINIT == 1)
+extern volatile unsigned long SystemBootSectionCycles; /*!< Cycles of .data and .bss initialization */
+#endif
 
 typedef struct EXC_Frame {
     unsigned long ra;                /* ra: x1, return address for jump */
@@ -62,6 +66,20 @@ typedef struct EXC_Frame {
 #endif
 } EXC_Frame_Type;
 
+#if defined(NUCLEI_BOOT_FASTINIT) && (NUCLEI_BOOT_FASTINIT == 1)
+/**
+ * \brief Initialize .data and .bss, called by startup code instead of its own loops
+ */
+extern void Boot_SectionInit(void);
+#endif
+
+#if defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1) && defined(SMP_LOCAL_STACK) && (SMP_LOCAL_STACK == 1)
+/**
+ * \brief Get top of DLM of current hart as its stack top, 0 if it has no DLM, called by startup code
+ */
+extern unsigned long SMP_LocalStackTop(void);
+#endif
+
 /**
  * \brief Setup the microcontroller system.
  * \details
@@ -91,11 +109,182 @@ extern void Exception_Register_EXC(uint32_t EXCn, unsigned long exc_handler);
  */
 extern unsigned long Exception_Get_EXC(uint32_t EXCn);
 
+#if defined(NUCLEI_FAST_EXC) && (NUCLEI_FAST_EXC == 1)
+/** \brief Exception codes 0 - 15 can have a fast path handler */
+#define MAX_FAST_EXCEPTION_NUM          16
+
+/**
+ * \brief Register a fast path exception handler for exception code EXCn
+ */
+extern void Exception_Register_Fast_EXC(uint32_t EXCn, unsigned long exc_handler);
+#endif
+
 /**
  * \brief Initialize Interrupt
  */
 extern void Interrupt_Init(void);
 
+#if defined(__CCM_PRESENT) && (__CCM_PRESENT == 1)
+#if defined(__ICACHE_PRESENT) && (__ICACHE_PRESENT == 1)
+/**
+ * \brief I-Cache geometry probed once in \ref _premain_init, read only for application
+ * \details
+ * It is initialized by constants if __ICACHE_LINESIZE/__ICACHE_WAYS/__ICACHE_SETS are defined,
+ * all fields are 0 if I-Cache is not present.
+ */
+extern CacheInfo_Type SystemICacheInfo;
+#endif
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1)
+/**
+ * \brief D-Cache geometry probed once in \ref _premain_init, read only for application
+ * \details
+ * It is initialized by constants if __DCACHE_LINESIZE/__DCACHE_WAYS/__DCACHE_SETS are defined,
+ * all fields are 0 if D-Cache is not present.
+ */
+extern CacheInfo_Type SystemDCacheInfo;
+#endif
+#endif
+
+/**
+ * \defgroup NMSIS_Core_SMPCC_L2  L2 Cache and Cluster Local Memory Configuration
+ * \brief L2 cache enable and L2 ways split into cluster local memory of SMP & Cluster Cache unit
+ * \details
+ * The L2 cache ways can be used as cluster local memory(CLM), each bit of CLM way mask selects
+ * one L2 way to be used as CLM, the other ways are used as L2 cache when L2 is enabled.
+ *
+ * The configuration used at boot is controlled by macros, so no startup code need to be changed,
+ * such as `COMMON_FLAGS += -DSMPCC_BOOT_L2_EN=1 -DSMPCC_BOOT_CLM_WAYMASK=0x3`.
+ * @{
+ */
+#define SMPCC_CFG_OFS               0x04        /*!< SMP & CC configuration info, bit 0 means L2 cache present */
+#define SMPCC_ENB_OFS               0x0C        /*!< SMP enable, bit n enables hart n */
+#define SMPCC_CC_CTRL_OFS           0x10        /*!< Cluster cache control, bit 0 enables L2 cache */
+#define SMPCC_CLM_WAYEN_OFS         0xD8        /*!< L2 ways used as cluster local memory, bit n for way n */
+
+#define SMPCC_CFG_L2_PRESENT        0x1         /*!< L2 cache present bit of SMPCC_CFG */
+#define SMPCC_CC_CTRL_L2_EN         0x1         /*!< L2 cache enable bit of SMPCC_CC_CTRL */
+
+#ifndef SMPCC_BOOT_L2_EN
+#define SMPCC_BOOT_L2_EN            1           /*!< Enable L2 cache at boot when L2 cache present */
+#endif
+
+#ifndef SMPCC_BOOT_CLM_WAYMASK
+#define SMPCC_BOOT_CLM_WAYMASK      0x0         /*!< L2 ways used as cluster local memory at boot */
+#endif
+
+/** \brief Access SMP & CC register at offset ofs of SMP & CC unit at base */
+#define SMPCC_REG(base, ofs)        (*(volatile uint32_t *)((uintptr_t)((base) + (ofs))))
+
+/**
+ * \brief  Check whether L2 cache present
+ * \param [in]  base    base address of SMP & CC unit, such as \ref __SMPCC_BASEADDR
+ * \return 1 if L2 cache present, otherwise 0
+ */
+__STATIC_FORCEINLINE int32_t SMPCC_L2Present(unsigned long base)
+{
+    return (SMPCC_REG(base, SMPCC_CFG_OFS) & SMPCC_CFG_L2_PRESENT) ? 1 : 0;
+}
+
+/**
+ * \brief  Configure L2 cache and cluster local memory split
+ * \details
+ * This function enable or disable L2 cache, and select the L2 ways used as cluster local
+ * memory, it should be called at boot before L2 cache is used, or after the L2 cache is
+ * flushed, since the data in L2 cache or cluster local memory is not kept.
+ * \param [in]  base        base address of SMP & CC unit, such as \ref __SMPCC_BASEADDR
+ * \param [in]  l2_en       1 to enable L2 cache, 0 to disable it
+ * \param [in]  clm_waymask bit n set means L2 way n is used as cluster local memory
+ * \return -1 if L2 cache not present, otherwise 0
+ * \remarks
+ * - This function can be called in M-Mode only, and it doesn't use any global variable,
+ *   so it can be called before data and bss sections are initialized.
+ */
+__STATIC_FORCEINLINE int32_t SMPCC_ConfigL2(unsigned long base, uint32_t l2_en, uint32_t clm_waymask)
+{
+    if (SMPCC_L2Present(base) == 0) {
+        return -1;
+    }
+    SMPCC_REG(base, SMPCC_CC_CTRL_OFS) = l2_en ? SMPCC_CC_CTRL_L2_EN : 0;
+    SMPCC_REG(base, SMPCC_CLM_WAYEN_OFS) = clm_waymask;
+    __SMP_RWMB();
+    return 0;
+}
+
+/**
+ * \brief  Get L2 cache enable state and cluster local memory way mask
+ * \param [in]  base        base address of SMP & CC unit, such as \ref __SMPCC_BASEADDR
+ * \param [out] clm_waymask L2 ways used as cluster local memory, can be NULL
+ * \return -1 if L2 cache not present, 1 if L2 cache enabled, otherwise 0
+ */
+__STATIC_FORCEINLINE int32_t SMPCC_GetL2Config(unsigned long base, uint32_t *clm_waymask)
+{
+    if (SMPCC_L2Present(base) == 0) {
+        return -1;
+    }
+    if (clm_waymask) {
+        *clm_waymask = SMPCC_REG(base, SMPCC_CLM_WAYEN_OFS);
+    }
+    return (SMPCC_REG(base, SMPCC_CC_CTRL_OFS) & SMPCC_CC_CTRL_L2_EN) ? 1 : 0;
+}
+/** @} */ /* End of Doxygen Group NMSIS_Core_SMPCC_L2 */
+
+/**
+ * \defgroup NMSIS_Core_Tuning  Micro-architecture Tuning Profiles
+ * \brief Runtime switch of branch prediction, load speculation and caches of current hart
+ * \details
+ * The `RUNMODE_*` macros select these features at build time, the functions here switch
+ * them at runtime, so different settings can be compared in one image:
+ * - each setting is a bit mask of `TUNING_xxx` features, \ref SystemTuning_Set enables or
+ *   disables the features in its mask and keeps the others
+ * - \ref SystemTuningProfiles are named settings applied by \ref SystemTuning_Apply
+ * - Components/autotune runs a workload under each combination and reports the fastest
+ * \remarks
+ * - ILM and DLM are not switched at runtime, since code and data may be located in them
+ * - L2 cache data is lost when it is disabled and it can't be flushed by software, so
+ *   \ref TUNING_L2 is only supported when `TUNING_L2_RUNTIME=1` is defined, which means
+ *   the caller knows no data is cached in L2, such as running from ILM/DLM only
+ * - DCache is flushed and invalidated before it is disabled, so no data is lost
+ * @{
+ */
+#define TUNING_BPU                  (1U << 0)   /*!< Branch prediction unit, MMISC_CTL_BPU */
+#define TUNING_LDSPEC               (1U << 1)   /*!< Load speculation, MMISC_CTL_LDSPEC_ENABLE */
+#define TUNING_ICACHE               (1U << 2)   /*!< L1 instruction cache */
+#define TUNING_DCACHE               (1U << 3)   /*!< L1 data cache */
+#define TUNING_L2                   (1U << 4)   /*!< L2 cache of SMP & CC unit */
+#define TUNING_ALL                  (TUNING_BPU | TUNING_LDSPEC | TUNING_ICACHE | TUNING_DCACHE | TUNING_L2)
+
+/** Named tuning setting */
+typedef struct SystemTuning {
+    const char *name;               /*!< Profile name */
+    uint32_t mask;                  /*!< Features changed by this profile */
+    uint32_t enable;                /*!< Features in mask to be enabled, others in mask are disabled */
+} SystemTuning_Type;
+
+/** Predefined profiles, terminated by an entry with NULL name */
+extern const SystemTuning_Type SystemTuningProfiles[];
+
+/**
+ * \brief Get features which can be switched at runtime on current hart
+ */
+extern uint32_t SystemTuning_Supported(void);
+
+/**
+ * \brief Get enabled features of current hart
+ */
+extern uint32_t SystemTuning_Get(void);
+
+/**
+ * \brief Enable or disable the supported features in mask, return the features changed
+ */
+extern uint32_t SystemTuning_Set(uint32_t mask, uint32_t enable);
+
+/**
+ * \brief Apply a profile of \ref SystemTuningProfiles by name, return -1 if not found
+ */
+extern int32_t SystemTuning_Apply(const char *name);
+
+/** @} */ /* End of Doxygen Group NMSIS_Core_Tuning */
+
 #if defined(__ECLIC_PRESENT) && (__ECLIC_PRESENT == 1)
 /**
  * \brief  Initialize a specific IRQ and register the handler
@@ -104,6 +293,172 @@ extern void Interrupt_Init(void);
  * assign handler for specific IRQn.
  */
 extern int32_t ECLIC_Register_IRQ(IRQn_Type IRQn, uint8_t shv, ECLIC_TRIGGER_Type trig_mode, uint8_t lvl, uint8_t priority, void* handler);
+
+/**
+ * \defgroup NMSIS_Core_IRQ_Plan  Interrupt Priority Plan
+ * \brief Declarative interrupt latency classes mapped to ECLIC level and priority
+ * \details
+ * Instead of picking ECLIC level and priority for each interrupt by hand, a plan table
+ * assigns each IRQn a latency class, the greater class is the more urgent one, and
+ * \ref IRQPlan_Apply computes them from the implemented ctlbits:
+ * - nlbits is set to the least bits giving each class its own level, if ctlbits are not
+ *   enough, adjacent classes share a level, so a class still never preempts a higher one
+ * - the remaining ctlbits are priority, the interrupts of the same class earlier in the
+ *   table get higher priority, which decides the pending one taken first
+ *
+ * \ref IRQPlan_Raise and \ref IRQPlan_Restore are a critical section masking only the
+ * interrupts of the classes less than or equal to a class by ECLIC MTH, so driver code
+ * sharing data with interrupts of a class doesn't delay the more urgent interrupts like
+ * \ref __disable_irq does.
+ * \remarks
+ * - Apply the plan before starting RTOS, since RTOS ports compute their syscall MTH from nlbits
+ * @{
+ */
+#ifndef IRQ_PLAN_MAX_CLASSES
+#define IRQ_PLAN_MAX_CLASSES        8       /*!< Max latency classes of a plan */
+#endif
+
+/** Interrupt entry of plan table */
+typedef struct IRQ_Plan {
+    IRQn_Type irqn;                 /*!< Interrupt number */
+    uint8_t cls;                    /*!< Latency class, 0 is the least urgent */
+    uint8_t shv;                    /*!< \ref ECLIC_NON_VECTOR_INTERRUPT or \ref ECLIC_VECTOR_INTERRUPT */
+    uint8_t trig_mode;              /*!< see \ref ECLIC_TRIGGER_Type */
+    void *handler;                  /*!< Interrupt handler, if NULL, handler will not be installed */
+} IRQ_Plan_Type;
+
+/** MTH masking each class and the lower ones, set by \ref IRQPlan_Apply */
+extern uint8_t SystemIRQPlanMth[IRQ_PLAN_MAX_CLASSES];
+
+/**
+ * \brief Compute ECLIC level and priority of interrupts in plan, register and enable them
+ */
+extern int32_t IRQPlan_Apply(const IRQ_Plan_Type *plan, uint32_t num, uint8_t classes);
+
+/**
+ * \brief  Mask interrupts of class cls and the lower classes
+ * \details
+ * Raise ECLIC MTH to mask the interrupts of class less than or equal to cls, MTH is never
+ * lowered if it is already higher, so it can be nested.
+ * \param [in]  cls     latency class, must be less than classes of applied plan
+ * \return      previous MTH, passed to \ref IRQPlan_Restore
+ */
+__STATIC_FORCEINLINE uint8_t IRQPlan_Raise(uint8_t cls)
+{
+    uint8_t mth = ECLIC_GetMth();
+
+    if (SystemIRQPlanMth[cls] > mth) {
+        ECLIC_SetMth(SystemIRQPlanMth[cls]);
+        __RWMB();
+    }
+    return mth;
+}
+
+/**
+ * \brief  Restore ECLIC MTH returned by \ref IRQPlan_Raise
+ * \param [in]  mth     MTH returned by \ref IRQPlan_Raise
+ */
+__STATIC_FORCEINLINE void IRQPlan_Restore(uint8_t mth)
+{
+    __RWMB();
+    ECLIC_SetMth(mth);
+}
+/** @} */ /* End of Doxygen Group NMSIS_Core_IRQ_Plan */
+
+#if defined(NUCLEI_IRQ_STAT) && (NUCLEI_IRQ_STAT == 1)
+/**
+ * \defgroup NMSIS_Core_IRQ_Stat  Interrupt Statistics
+ * \brief Per IRQn invocation count and cycle statistics for interrupt storm diagnosis
+ * \details
+ * Enabled by compiling with `-DNUCLEI_IRQ_STAT=1`, and compiled out completely by default.
+ * When enabled, non-vector interrupt handlers registered by \ref ECLIC_Register_IRQ are
+ * called through a dispatcher which counts invocations, inclusive and self cycles
+ * (excluding nested interrupts) and the deepest nesting level seen for each IRQn.
+ * Vector interrupts are not counted, since they are directly entered from vector table.
+ *
+ * Statistics are stored per hart in \ref SystemIRQStat, which can be read by debugger
+ * such as `print SystemIRQStat[0].irq[19]` in gdb, or printed by \ref IRQStat_Print.
+ * @{
+ */
+#ifndef IRQ_STAT_HART_NUM
+#if defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1)
+#define IRQ_STAT_HART_NUM       SMP_CPU_CNT     /*!< Number of harts statistics recorded */
+#else
+#define IRQ_STAT_HART_NUM       1               /*!< Number of harts statistics recorded */
+#endif
+#endif
+
+#ifndef IRQ_STAT_MAX_NEST
+#define IRQ_STAT_MAX_NEST       8               /*!< Max nesting depth tracked for self cycles */
+#endif
+
+/** Statistics of one IRQn */
+typedef struct IRQ_Stat {
+    uint32_t count;             /*!< Invocation count */
+    uint32_t maxnest;           /*!< Deepest nesting level seen, 1 means not nested */
+    unsigned long maxcycles;    /*!< Max inclusive cycles of one invocation */
+    uint64_t cycles;            /*!< Total inclusive cycles, including nested interrupts */
+    uint64_t selfcycles;        /*!< Total self cycles, excluding nested interrupts */
+} IRQ_Stat_Type;
+
+/** Statistics of one hart */
+typedef struct IRQ_Stat_Hart {
+    uint32_t nest;                              /*!< Current nesting level */
+    uint32_t maxnest;                           /*!< Deepest nesting level seen on this hart */
+    unsigned long child[IRQ_STAT_MAX_NEST];     /*!< Cycles of nested interrupts per level */
+    IRQ_Stat_Type irq[SOC_INT_MAX];             /*!< Per IRQn statistics */
+} IRQ_Stat_Hart_Type;
+
+/** Per hart interrupt statistics table, indexed by hart index */
+extern IRQ_Stat_Hart_Type SystemIRQStat[IRQ_STAT_HART_NUM];
+
+/**
+ * \brief Clear interrupt statistics of all harts
+ */
+extern void IRQStat_Reset(void);
+
+/**
+ * \brief Print interrupt statistics of IRQn which have been triggered
+ */
+extern void IRQStat_Print(void);
+/** @} */ /* End of Doxygen Group NMSIS_Core_IRQ_Stat */
+#endif
+
+#if defined(__CIDU_PRESENT) && (__CIDU_PRESENT == 1) && defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1)
+/**
+ * \defgroup NMSIS_Core_IRQ_Affinity  Interrupt Affinity
+ * \brief Route external interrupts to a set of harts in SMP system through CIDU
+ * \details
+ * ECLIC is private to each hart, and CIDU delivers an external interrupt to hart 0 only
+ * by default. \ref ECLIC_Register_IRQ_Affinity routes an external interrupt to the harts
+ * in a hart index mask by CIDU, configures ECLIC of the calling hart, and records the
+ * ECLIC configuration, then each other target hart applies it by calling
+ * \ref ECLIC_Sync_IRQ_Affinity on itself, such as when it starts or in an inter-hart
+ * interrupt handler of your system.
+ *
+ * - In \ref IRQ_AFFINITY_BROADCAST mode, every target hart handles each interrupt
+ * - In \ref IRQ_AFFINITY_FIRST_CLAIM mode, the handler is called through a dispatcher which
+ *   claims the interrupt in CIDU first, so only the first hart taking it calls the handler,
+ *   this balances interrupt load across idle harts, only non-vector interrupt is supported
+ * @{
+ */
+#define IRQ_AFFINITY_BROADCAST      0   /*!< All target harts handle the interrupt */
+#define IRQ_AFFINITY_FIRST_CLAIM    1   /*!< The first target hart claiming the interrupt handles it */
+
+/**
+ * \brief  Initialize an external IRQ, register the handler and route it to harts
+ * \details
+ * Same as \ref ECLIC_Register_IRQ, but the interrupt is routed to harts in hartmask.
+ */
+extern int32_t ECLIC_Register_IRQ_Affinity(IRQn_Type IRQn, uint8_t shv, ECLIC_TRIGGER_Type trig_mode, uint8_t lvl, \
+                                           uint8_t priority, void* handler, uint32_t hartmask, uint32_t mode);
+
+/**
+ * \brief Apply routed external IRQ configuration to ECLIC of the calling hart
+ */
+extern void ECLIC_Sync_IRQ_Affinity(void);
+/** @} */ /* End of Doxygen Group NMSIS_Core_IRQ_Affinity */
+#endif
 #endif
 
 #if defined(__TEE_PRESENT) && (__TEE_PRESENT == 1)
@@ -117,6 +472,42 @@ extern void Exception_Register_EXC_S(uint32_t EXCn, unsigned long exc_handler);
  */
 extern unsigned long Exception_Get_EXC_S(uint32_t EXCn);
 
+#if defined(NUCLEI_FAST_SYSCALL_S) && (NUCLEI_FAST_SYSCALL_S == 1) && !defined(__riscv_32e)
+/** \brief Syscall number 0 - 15 in a7 of user mode ecall can have a fast path syscall handler */
+#define MAX_SYSCALL_NUM_S               16
+
+/**
+ * \brief Fast path syscall handler of supervisor mode, called with a0 - a5 of the user mode ecall,
+ * and the return value is returned to user mode in a0
+ */
+typedef unsigned long (*SYSCALL_HANDLER_S)(unsigned long a0, unsigned long a1, unsigned long a2,
+                                           unsigned long a3, unsigned long a4, unsigned long a5);
+
+/**
+ * \brief Register a fast path syscall handler for syscall number num of supervisor mode
+ */
+extern void Syscall_Register_S(uint32_t num, unsigned long handler);
+
+/**
+ * \brief Make a fast path syscall num with three arguments from user mode
+ * \details
+ * The fast syscall is like a function call, ra, t0 - t6 and a1 - a7 are not preserved,
+ * so the syscall entry needn't save them, a0 is the return value of the handler.
+ */
+__STATIC_FORCEINLINE unsigned long __syscall_s(unsigned long num, unsigned long arg0,
+                                              unsigned long arg1, unsigned long arg2)
+{
+    register unsigned long a0 __ASM("a0") = arg0;
+    register unsigned long a1 __ASM("a1") = arg1;
+    register unsigned long a2 __ASM("a2") = arg2;
+    register unsigned long a7 __ASM("a7") = num;
+
+    __ASM volatile("ecall" : "+r"(a0), "+r"(a1), "+r"(a2), "+r"(a7) :
+                   : "ra", "t0", "t1", "t2", "t3", "t4", "t5", "t6", "a3", "a4", "a5", "a6", "memory");
+    return a0;
+}
+#endif
+
 #if defined(__ECLIC_PRESENT) && (__ECLIC_PRESENT == 1)
 /**
  * \brief  Initialize a specific IRQ and register the handler of supervisor mode
@@ -116,4 +116,155 @@ int32_t uart_clear_status(UART_TypeDef* uart, uint32_t mask)
     }
     uart->IP &= ~mask;
     return 0;
-}
\ No newline at end of file
+}
+
+#define UART_RING_COUNT(r)      ((r)->head - (r)->tail)
+
+/* Move tx ring into tx fifo until fifo full, called by the only consumer with interrupts disabled */
+static void uart_buffered_tx_fill(UART_BUFFERED_Type* ub)
+{
+    UART_RING_Type *tx = &ub->tx;
+    uint32_t tail = tx->tail;
+
+    while ((tail != tx->head) && ((ub->uart->TXFIFO & UART_TXFIFO_FULL) == 0)) {
+        ub->uart->TXFIFO = tx->buf[tail & (tx->size - 1)];
+        tail++;
+    }
+    tx->tail = tail;
+    // no more interrupts when nothing to send, next write kicks it again
+    if (tail == tx->head) {
+        ub->uart->IE &= ~UART_IE_TXIE_MASK;
+    } else {
+        ub->uart->IE |= UART_IE_TXIE_MASK;
+    }
+}
+
+int32_t uart_buffered_init(UART_BUFFERED_Type* ub, UART_TypeDef* uart, uint8_t* txbuf, uint32_t txsize,
+                           uint8_t* rxbuf, uint32_t rxsize)
+{
+    if (__RARELY((ub == NULL) || (uart == NULL) || (txsize & (txsize - 1)) || (rxsize & (rxsize - 1)))) {
+        return -1;
+    }
+    ub->tx.buf = txbuf;
+    ub->tx.size = txsize;
+    ub->tx.head = ub->tx.tail = 0;
+    ub->rx.buf = rxbuf;
+    ub->rx.size = rxsize;
+    ub->rx.head = ub->rx.tail = 0;
+    ub->tx_dropped = 0;
+    ub->rx_overrun = 0;
+    uart_set_tx_watermark(uart, UART_BUFFERED_TX_WATERMARK);
+    uart_set_rx_watermark(uart, 0);
+    uart->IE &= ~UART_IE_TXIE_MASK;
+    if ((rxbuf != NULL) && (rxsize != 0)) {
+        uart->IE |= UART_IE_RXIE_MASK;
+    }
+    ub->uart = uart;
+    return 0;
+}
+
+/*
+ * Copy data into tx ring, return bytes written, if the ring is full, blocking write
+ * waits for interrupt to drain it, or drains it by polling when interrupts are disabled,
+ * so it is also safe in exception and interrupt handlers, non-blocking write returns
+ * the bytes fitted in ring
+ */
+int32_t uart_buffered_write(UART_BUFFERED_Type* ub, const uint8_t* data, uint32_t len, uint32_t blocking)
+{
+    UART_RING_Type *tx = &ub->tx;
+    rv_csr_t mstatus;
+    uint32_t done = 0, head;
+
+    if (__RARELY(ub->uart == NULL)) {
+        return -1;
+    }
+    while (done < len) {
+        mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+        // pushed with interrupts disabled, so writers in different contexts don't interleave in a byte
+        for (head = tx->head; (done < len) && ((head - tx->tail) < tx->size); done++, head++) {
+            tx->buf[head & (tx->size - 1)] = data[done];
+        }
+        tx->head = head;
+        uart_buffered_tx_fill(ub);
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+        if ((done < len) && (blocking == 0)) {
+            ub->tx_dropped += len - done;
+            break;
+        }
+    }
+    return (int32_t)done;
+}
+
+/*
+ * Copy data from rx ring, return bytes read, blocking read waits for at least one byte,
+ * it sleeps in WFI until the rx interrupt when interrupts are enabled by caller
+ */
+int32_t uart_buffered_read(UART_BUFFERED_Type* ub, uint8_t* data, uint32_t len, uint32_t blocking)
+{
+    UART_RING_Type *rx = &ub->rx;
+    uint32_t done = 0, tail;
+    rv_csr_t mstatus;
+
+    if (__RARELY((ub->uart == NULL) || (rx->buf == NULL))) {
+        return -1;
+    }
+    do {
+        mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+        for (tail = rx->tail; (done < len) && (tail != rx->head); done++, tail++) {
+            data[done] = rx->buf[tail & (rx->size - 1)];
+        }
+        rx->tail = tail;
+        // poll rx fifo, so it also works with interrupts disabled by caller
+        if (done == 0) {
+            uart_buffered_irq_handler(ub);
+            // checked with interrupts disabled, so the rx interrupt can't be taken before WFI
+            if (blocking && (rx->tail == rx->head) && (mstatus & MSTATUS_MIE)) {
+                __WFI();
+            }
+        }
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    } while ((done == 0) && (len != 0) && blocking);
+    return (int32_t)done;
+}
+
+/* Wait until tx ring is moved into tx fifo */
+void uart_buffered_flush(UART_BUFFERED_Type* ub)
+{
+    rv_csr_t mstatus;
+
+    if (__RARELY(ub->uart == NULL)) {
+        return;
+    }
+    while (UART_RING_COUNT(&ub->tx) != 0) {
+        mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+        uart_buffered_tx_fill(ub);
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    }
+}
+
+/* Interrupt handler of buffered uart, refill tx fifo and drain rx fifo */
+void uart_buffered_irq_handler(UART_BUFFERED_Type* ub)
+{
+    UART_TypeDef *uart = ub->uart;
+    UART_RING_Type *rx = &ub->rx;
+    uint32_t head, reg;
+    // higher level interrupts may write uart too
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+
+    if (rx->buf != NULL) {
+        head = rx->head;
+        while (((reg = uart->RXFIFO) & UART_RXFIFO_EMPTY) == 0) {
+            if ((head - rx->tail) < rx->size) {
+                rx->buf[head & (rx->size - 1)] = (uint8_t)reg;
+                head++;
+            } else {
+                ub->rx_overrun++;
+            }
+        }
+        rx->head = head;
+    }
+    if (uart->IE & UART_IE_TXIE_MASK) {
+        uart_buffered_tx_fill(ub);
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
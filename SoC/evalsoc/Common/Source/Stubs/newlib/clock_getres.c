@@ -1,14 +1,25 @@
 /* See LICENSE of license details. */
-#include "nuclei_sdk_soc.h"
 #include <errno.h>
 #include <time.h>
+#include "nuclei_sdk_soc.h"
 #include <stdint.h>
 
 /* Get resolution of clock. */
 __WEAK int clock_getres(clockid_t clock_id, struct timespec* res)
 {
+    uint32_t freq = SystemCoreClock;
+
+#if defined(__SYSTIMER_PRESENT) && (__SYSTIMER_PRESENT == 1)
+    if (clock_id == CLOCK_REALTIME
+#ifdef CLOCK_MONOTONIC
+        || clock_id == CLOCK_MONOTONIC
+#endif
+       ) {
+        freq = SOC_TIMER_FREQ;
+    }
+#endif
     res->tv_sec = 0;
-    res->tv_nsec = 1000000000 / SystemCoreClock;
+    res->tv_nsec = (freq >= 1000000000UL) ? 1 : (1000000000UL + freq - 1) / freq;
 
     return 0;
 }
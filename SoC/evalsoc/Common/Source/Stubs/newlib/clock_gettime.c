@@ -1,21 +1,88 @@
 /* See LICENSE of license details. */
-#include "nuclei_sdk_soc.h"
 #include <errno.h>
 #include <time.h>
+#include "nuclei_sdk_soc.h"
+#include <stdint.h>
 #include <sys/time.h>
 
-extern int _gettimeofday(struct timeval* tp, void* tzp);
+/*
+ * Counters are scaled to nanoseconds by a multiply and shift instead of dividing by the
+ * frequency, ns = (count * mult) >> 32, mult = (1e9 << 32) / freq, seconds are split from
+ * nanoseconds by multiplying the reciprocal of 1e9, so no 64-bit division is done per call,
+ * which is a libgcc call on rv32
+ * - CLOCK_MONOTONIC and CLOCK_REALTIME: SysTimer mtime at SOC_TIMER_FREQ, mcycle if there
+ *   is no SysTimer
+ * - CLOCK_MONOTONIC_RAW and CLOCK_PROCESS_CPUTIME_ID: mcycle at SystemCoreClock, the mult
+ *   is recomputed when SystemCoreClock changes
+ */
+#define NSEC_PER_SEC            1000000000UL
+#define CLOCK_MULT(freq)        ((uint64_t)((1000000000ULL << 32) / (freq)))
+/* floor(2^64 / 1e9), estimated seconds is the real one or one less */
+#define CLOCK_SEC_RECIP         18446744073ULL
 
-/* Get current value of CLOCK and store it in tp.  */
-__WEAK int clock_gettime(clockid_t clock_id, struct timespec* tp)
+/* High 64 bits of 64 x 64 bits product */
+static inline uint64_t clock_mulhi(uint64_t a, uint64_t b)
+{
+#if __riscv_xlen == 64
+    return (uint64_t)(((unsigned __int128)a * b) >> 64);
+#else
+    uint64_t al = (uint32_t)a, ah = a >> 32;
+    uint64_t bl = (uint32_t)b, bh = b >> 32;
+    uint64_t ll = al * bl, lh = al * bh, hl = ah * bl, hh = ah * bh;
+    uint64_t mid = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+
+    return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+/* (count * mult) >> 32 split to timespec */
+static void clock_to_timespec(uint64_t count, uint64_t mult, struct timespec* tp)
+{
+    uint64_t ns = (clock_mulhi(count, mult) << 32) | ((count * mult) >> 32);
+    uint64_t sec = clock_mulhi(ns, CLOCK_SEC_RECIP);
+    uint32_t nsec = (uint32_t)(ns - sec * NSEC_PER_SEC);
+
+    if (nsec >= NSEC_PER_SEC) {
+        nsec -= NSEC_PER_SEC;
+        sec++;
+    }
+    tp->tv_sec = (time_t)sec;
+    tp->tv_nsec = (long)nsec;
+}
+
+static uint64_t clock_cycle_mult(void)
 {
-    struct timeval tv;
-    int retval = -1;
+    static uint32_t freq = 0;
+    static uint64_t mult = 0;
 
-    retval = _gettimeofday(&tv, NULL);
-    if (retval == 0) {
-        TIMEVAL_TO_TIMESPEC(&tv, tp);
+    if ((freq != SystemCoreClock) && (SystemCoreClock != 0)) {
+        mult = CLOCK_MULT(SystemCoreClock);
+        freq = SystemCoreClock;
     }
+    return mult;
+}
 
-    return retval;
+/* Get current value of CLOCK and store it in tp.  */
+__WEAK int clock_gettime(clockid_t clock_id, struct timespec* tp)
+{
+    switch (clock_id) {
+        case CLOCK_REALTIME:
+#ifdef CLOCK_MONOTONIC
+        case CLOCK_MONOTONIC:
+#endif
+#if defined(__SYSTIMER_PRESENT) && (__SYSTIMER_PRESENT == 1)
+            clock_to_timespec(SysTimer_GetLoadValue(), CLOCK_MULT(SOC_TIMER_FREQ), tp);
+            break;
+#endif
+        case CLOCK_MONOTONIC_RAW:
+#ifdef CLOCK_PROCESS_CPUTIME_ID
+        case CLOCK_PROCESS_CPUTIME_ID:
+#endif
+            clock_to_timespec(__get_rv_cycle(), clock_cycle_mult(), tp);
+            break;
+        default:
+            errno = EINVAL;
+            return -1;
+    }
+    return 0;
 }
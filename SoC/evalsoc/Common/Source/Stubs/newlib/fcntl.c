@@ -0,0 +1,26 @@
+/* See LICENSE of license details. */
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "nuclei_sdk_soc.h"
+
+extern int stdin_flags;
+
+/* Only F_GETFL and F_SETFL of O_NONBLOCK on stdin are supported */
+__WEAK int _fcntl(int fd, int cmd, int arg)
+{
+    if (fd != STDIN_FILENO) {
+        errno = EBADF;
+        return -1;
+    }
+    switch (cmd) {
+        case F_GETFL:
+            return stdin_flags;
+        case F_SETFL:
+            stdin_flags = (stdin_flags & ~O_NONBLOCK) | (arg & O_NONBLOCK);
+            return 0;
+        default:
+            errno = EINVAL;
+            return -1;
+    }
+}
@@ -1,15 +1,16 @@
 /* See LICENSE of license details. */
 #include <errno.h>
+#include <time.h>
 #include <sys/time.h>
 #include "nuclei_sdk_soc.h"
 
 __WEAK int _gettimeofday(struct timeval* tp, void* tzp)
 {
-    uint64_t cycles;
+    struct timespec ts;
 
-    cycles = __get_rv_cycle();
-
-    tp->tv_sec = cycles / SystemCoreClock;
-    tp->tv_usec = (cycles % SystemCoreClock) * 1000000 / SystemCoreClock;
+    // nanoseconds fit in 32 bits, so it is a cheap 32-bit division
+    clock_gettime(CLOCK_REALTIME, &ts);
+    tp->tv_sec = ts.tv_sec;
+    tp->tv_usec = (uint32_t)ts.tv_nsec / 1000;
     return 0;
 }
@@ -0,0 +1,200 @@
+/* See LICENSE of license details. */
+#include "nuclei_sdk_soc.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+/*
+ * Allocator of the heap regions besides the default one, malloc keeps using _sbrk on
+ * the default region, malloc_in allocates from the region by first fit on an address
+ * ordered free list, neighbour blocks are merged when freed.
+ *
+ * Linker script defines the regions it has, for example in DLM:
+ *   .heap_dlm (NOLOAD) : ALIGN(16) {
+ *       PROVIDE(__heap_dlm_start = .);
+ *       . = ORIGIN(dlm) + LENGTH(dlm) - __STACK_SIZE;
+ *       PROVIDE(__heap_dlm_end = .);
+ *   } >dlm
+ * The symbols are weak here, so a region without them has no memory.
+ */
+extern char __heap_ilm_start[] __attribute__((weak));
+extern char __heap_ilm_end[] __attribute__((weak));
+extern char __heap_dlm_start[] __attribute__((weak));
+extern char __heap_dlm_end[] __attribute__((weak));
+extern char __heap_sram_start[] __attribute__((weak));
+extern char __heap_sram_end[] __attribute__((weak));
+extern char __heap_ddr_start[] __attribute__((weak));
+extern char __heap_ddr_end[] __attribute__((weak));
+
+struct _reent;
+extern void __malloc_lock(struct _reent *reent);
+extern void __malloc_unlock(struct _reent *reent);
+extern void *_sbrk(ptrdiff_t incr);
+
+/* Header before each block, it keeps the same alignment as malloc */
+typedef struct HeapBlock {
+    size_t size;                    /* block size including header */
+    struct HeapBlock *next;         /* next free block, region magic when allocated */
+} HeapBlock_Type;
+
+typedef struct HeapRegionCtrl {
+    HeapBlock_Type *free;           /* free list ordered by address */
+    uint32_t inited;
+} HeapRegionCtrl_Type;
+
+#define HEAP_ALIGN              sizeof(HeapBlock_Type)
+#define HEAP_MAGIC(region)      ((HeapBlock_Type *)(0x48454150UL + (unsigned long)(region)))
+
+/* Addresses are taken by data relocations, so undefined weak symbols are just 0 */
+static char *const heap_bounds[HEAP_REGION_MAX][2] = {
+    {NULL, NULL},
+    {__heap_ilm_start, __heap_ilm_end},
+    {__heap_dlm_start, __heap_dlm_end},
+    {__heap_sram_start, __heap_sram_end},
+    {__heap_ddr_start, __heap_ddr_end},
+};
+
+static HeapRegionCtrl_Type heap_regions[HEAP_REGION_MAX];
+
+static HeapRegionCtrl_Type *heap_region_get(HeapRegion_Type region)
+{
+    HeapRegionCtrl_Type *ctrl = &heap_regions[region];
+    uintptr_t start, end;
+
+    if (ctrl->inited == 0) {
+        ctrl->inited = 1;
+        start = ((uintptr_t)heap_bounds[region][0] + HEAP_ALIGN - 1) & ~(uintptr_t)(HEAP_ALIGN - 1);
+        end = (uintptr_t)heap_bounds[region][1] & ~(uintptr_t)(HEAP_ALIGN - 1);
+        if ((heap_bounds[region][0] != NULL) && (end > start + HEAP_ALIGN)) {
+            ctrl->free = (HeapBlock_Type *)start;
+            ctrl->free->size = end - start;
+            ctrl->free->next = NULL;
+        }
+    }
+    return ctrl;
+}
+
+/**
+ * \brief  Allocate memory from heap region
+ * \param [in]  region      heap region
+ * \param [in]  size        bytes to allocate
+ * \return      allocated memory, NULL if region has no enough memory
+ * \remarks
+ * - Default region is allocated by malloc, others are freed by \ref free_in
+ */
+void *malloc_in(HeapRegion_Type region, size_t size)
+{
+    HeapRegionCtrl_Type *ctrl;
+    HeapBlock_Type *blk, *rest, **link;
+    void *ptr = NULL;
+
+    if (region == HEAP_REGION_DEFAULT) {
+        return malloc(size);
+    }
+    if (((unsigned)region >= HEAP_REGION_MAX) || (size == 0) || (size > ((size_t)-1 / 2))) {
+        return NULL;
+    }
+    size = (size + sizeof(HeapBlock_Type) + HEAP_ALIGN - 1) & ~(HEAP_ALIGN - 1);
+
+    __malloc_lock(NULL);
+    ctrl = heap_region_get(region);
+    for (link = &ctrl->free; (blk = *link) != NULL; link = &blk->next) {
+        if (blk->size < size) {
+            continue;
+        }
+        // split when the rest can hold a header and some data
+        if (blk->size - size >= 2 * sizeof(HeapBlock_Type)) {
+            rest = (HeapBlock_Type *)((char *)blk + size);
+            rest->size = blk->size - size;
+            rest->next = blk->next;
+            blk->size = size;
+            *link = rest;
+        } else {
+            *link = blk->next;
+        }
+        blk->next = HEAP_MAGIC(region);
+        ptr = blk + 1;
+        break;
+    }
+    __malloc_unlock(NULL);
+    return ptr;
+}
+
+/**
+ * \brief  Free memory allocated by \ref malloc_in
+ * \param [in]  ptr         memory to free, passed to free when it is not in any region
+ */
+void free_in(void *ptr)
+{
+    HeapBlock_Type *blk = (HeapBlock_Type *)ptr - 1;
+    HeapBlock_Type *prev = NULL, *cur;
+    HeapRegionCtrl_Type *ctrl;
+    uint32_t region;
+
+    if (ptr == NULL) {
+        return;
+    }
+    for (region = HEAP_REGION_DEFAULT + 1; region < HEAP_REGION_MAX; region++) {
+        if (((char *)ptr > heap_bounds[region][0]) && ((char *)ptr < heap_bounds[region][1])) {
+            break;
+        }
+    }
+    if (region == HEAP_REGION_MAX) {
+        free(ptr);
+        return;
+    }
+
+    __malloc_lock(NULL);
+    if (blk->next != HEAP_MAGIC(region)) {
+        // double free or not allocated by malloc_in
+        __malloc_unlock(NULL);
+        return;
+    }
+    ctrl = &heap_regions[region];
+    for (cur = ctrl->free; (cur != NULL) && (cur < blk); cur = cur->next) {
+        prev = cur;
+    }
+    blk->next = cur;
+    if ((cur != NULL) && ((char *)blk + blk->size == (char *)cur)) {
+        blk->size += cur->size;
+        blk->next = cur->next;
+    }
+    if (prev == NULL) {
+        ctrl->free = blk;
+    } else if ((char *)prev + prev->size == (char *)blk) {
+        prev->size += blk->size;
+        prev->next = blk->next;
+    } else {
+        prev->next = blk;
+    }
+    __malloc_unlock(NULL);
+}
+
+/**
+ * \brief  Get free bytes of heap region
+ * \param [in]  region      heap region, default region returns the bytes not used by _sbrk yet
+ * \return      total free bytes, including block headers
+ */
+size_t heap_region_avail(HeapRegion_Type region)
+{
+    extern char __heap_end[];
+    HeapRegionCtrl_Type *ctrl;
+    HeapBlock_Type *blk;
+    size_t avail = 0;
+    char *brk;
+
+    if (region == HEAP_REGION_DEFAULT) {
+        brk = (char *)_sbrk(0);
+        return (brk != (char *)-1) ? (size_t)(__heap_end - brk) : 0;
+    }
+    if ((unsigned)region >= HEAP_REGION_MAX) {
+        return 0;
+    }
+    __malloc_lock(NULL);
+    ctrl = heap_region_get(region);
+    for (blk = ctrl->free; blk != NULL; blk = blk->next) {
+        avail += blk->size;
+    }
+    __malloc_unlock(NULL);
+    return avail;
+}
@@ -0,0 +1,58 @@
+/* See LICENSE of license details. */
+#include "nuclei_sdk_soc.h"
+#include <stdint.h>
+
+struct _reent;
+
+/*
+ * Lock of newlib malloc state, it must be recursive since malloc may call itself when
+ * printing or in reentrant functions.
+ *
+ * The default one disables interrupts of current hart while it is held, so interrupt
+ * handlers can call malloc, and takes a ticket spinlock when there are more harts.
+ * RTOS ports override them to lock the scheduler instead, so interrupts are not
+ * disabled during malloc.
+ */
+#if defined(__riscv_atomic) && defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1)
+#define MALLOC_LOCK_SMP         1
+static TicketLock_Type malloc_spinlock = TICKETLOCK_INIT;
+#endif
+
+static volatile unsigned long malloc_owner = (unsigned long)-1;
+static uint32_t malloc_depth = 0;
+static rv_csr_t malloc_mstatus;
+
+__WEAK void __malloc_lock(struct _reent *reent)
+{
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    unsigned long hartidx = __get_hart_index();
+
+    (void)reent;
+    // only this hart sets owner to its index, so it can be checked without lock
+    if (malloc_owner == hartidx) {
+        malloc_depth++;
+        return;
+    }
+#if defined(MALLOC_LOCK_SMP)
+    TicketLock_Lock(&malloc_spinlock);
+#endif
+    malloc_owner = hartidx;
+    malloc_depth = 1;
+    malloc_mstatus = mstatus;
+}
+
+__WEAK void __malloc_unlock(struct _reent *reent)
+{
+    rv_csr_t mstatus;
+
+    (void)reent;
+    if (--malloc_depth != 0) {
+        return;
+    }
+    mstatus = malloc_mstatus;
+    malloc_owner = (unsigned long)-1;
+#if defined(MALLOC_LOCK_SMP)
+    TicketLock_Unlock(&malloc_spinlock);
+#endif
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
@@ -1,39 +1,131 @@
 /* See LICENSE of license details. */
 #include <stdint.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include "nuclei_sdk_hal.h"
 
 // #define UART_AUTO_ECHO
 
+/*
+ * Set to 1 to let _read do line editing like a terminal in canonical mode, input is echoed,
+ * '\r' is read as '\n', backspace and DEL erase last char, and _read returns only when a
+ * line is complete, leave it 0 for shells like finsh which do their own editing
+ */
+#ifndef STDIN_LINE_DISCIPLINE
+#define STDIN_LINE_DISCIPLINE       0
+#endif
+
+/* File status flags of stdin, O_NONBLOCK is set by fcntl, see fcntl.c */
+int stdin_flags = O_RDONLY;
+
 #undef getchar
 
-int getchar(void)
+/* Read one char, return -1 if there is none and blocking is 0 */
+static int stdin_getc(uint32_t blocking)
 {
     int dat;
 
-    dat = (int)uart_read(SOC_DEBUG_UART);
+#if defined(NUCLEI_UART_BUFFERED) && (NUCLEI_UART_BUFFERED == 1)
+    uint8_t val;
+
+    if (SystemDebugUART.uart != NULL) {
+        if (uart_buffered_read(&SystemDebugUART, &val, 1, blocking) != 1) {
+            return -1;
+        }
+        return (int)val;
+    }
+#endif
+    if (blocking == 0) {
+        dat = (int)SOC_DEBUG_UART->RXFIFO;
+        return (dat & UART_RXFIFO_EMPTY) ? -1 : (dat & 0xFF);
+    }
+    return (int)uart_read(SOC_DEBUG_UART);
+}
+
+int getchar(void)
+{
+    int dat = stdin_getc(1);
+
 #ifdef UART_AUTO_ECHO
     uart_write(SOC_DEBUG_UART, (uint8_t)dat);
 #endif
     return dat;
 }
 
+#if STDIN_LINE_DISCIPLINE
+static void stdin_echo(const char *str, size_t len)
+{
+    write(STDOUT_FILENO, str, len);
+}
+
+/* Edit a line in buf, return when it ends or buf is full */
+static ssize_t stdin_read_line(uint8_t* buf, size_t len, uint32_t blocking)
+{
+    static size_t pending = 0;      /* bytes of the unfinished line kept in buf by non-blocking read */
+    size_t cnt = pending;
+    int dat;
+
+    while (cnt < len) {
+        if ((dat = stdin_getc(blocking)) < 0) {
+            // caller must pass the same buffer again until a line is returned
+            pending = cnt;
+            errno = EAGAIN;
+            return -1;
+        }
+        if (dat == '\r') {
+            dat = '\n';
+        }
+        if ((dat == '\b') || (dat == 0x7F)) {
+            if (cnt > 0) {
+                cnt--;
+                stdin_echo("\b \b", 3);
+            }
+            continue;
+        }
+        buf[cnt++] = (uint8_t)dat;
+        stdin_echo((const char *)&buf[cnt - 1], 1);
+        if (dat == '\n') {
+            break;
+        }
+    }
+    pending = 0;
+    return (ssize_t)cnt;
+}
+#endif
+
+/*
+ * Block until there is input unless stdin is O_NONBLOCK, then return the input already
+ * received up to len without waiting more, a line end also returns, so bursts are read
+ * in one call instead of a char each
+ */
 __WEAK ssize_t _read(int fd, void* ptr, size_t len)
 {
+    uint8_t* readbuf = (uint8_t*)ptr;
+    uint32_t blocking = (stdin_flags & O_NONBLOCK) ? 0 : 1;
+
     if (fd != STDIN_FILENO) {
+        errno = EBADF;
         return -1;
     }
-    ssize_t cnt = 0;
-    uint8_t* readbuf = (uint8_t*)ptr;
-    for (cnt = 0; cnt < len; cnt ++) {
-        readbuf[cnt] = getchar();
-        /* Return partial buffer if we get EOL */
-        if (readbuf[cnt] == '\n') {
-            return cnt;
-        }
+    if (len == 0) {
+        return 0;
     }
+#if STDIN_LINE_DISCIPLINE
+    return stdin_read_line(readbuf, len, blocking);
+#else
+    ssize_t cnt = 0;
+    int dat;
 
+    if ((dat = stdin_getc(blocking)) < 0) {
+        errno = EAGAIN;
+        return -1;
+    }
+    readbuf[cnt++] = (uint8_t)dat;
+    while ((dat != '\n') && ((size_t)cnt < len) && ((dat = stdin_getc(0)) >= 0)) {
+        readbuf[cnt++] = (uint8_t)dat;
+    }
     return cnt;
+#endif
 }
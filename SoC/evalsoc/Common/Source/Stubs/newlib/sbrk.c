@@ -4,16 +4,37 @@
 #include <stddef.h>
 #include <unistd.h>
 
+/*
+ * Break is moved by compare and swap with atomic extension, so harts and interrupts
+ * can call it at the same time, newlib malloc also calls it with __malloc_lock held,
+ * see malloc_lock.c
+ */
 __WEAK void* _sbrk(ptrdiff_t incr)
 {
     extern char __heap_start[];
     extern char __heap_end[];
-    static char* curbrk = __heap_start;
+    static char* volatile curbrk = __heap_start;
+    char *oldbrk, *newbrk;
 
-    if ((curbrk + incr < __heap_start) || (curbrk + incr > __heap_end)) {
+#if defined(__riscv_atomic)
+    oldbrk = curbrk;
+    do {
+        newbrk = oldbrk + incr;
+        if ((newbrk < __heap_start) || (newbrk > __heap_end)) {
+            return (void*)(-1);
+        }
+    } while (__atomic_compare_exchange_n(&curbrk, &oldbrk, newbrk, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED) == 0);
+#else
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+
+    oldbrk = curbrk;
+    newbrk = oldbrk + incr;
+    if ((newbrk < __heap_start) || (newbrk > __heap_end)) {
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
         return (void*)(-1);
     }
-
-    curbrk += incr;
-    return (void*)(curbrk - incr);
+    curbrk = newbrk;
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+#endif
+    return (void*)oldbrk;
 }
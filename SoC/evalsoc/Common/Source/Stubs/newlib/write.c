@@ -7,8 +7,31 @@
 
 #undef putchar
 
+#if defined(NUCLEI_UART_BUFFERED) && (NUCLEI_UART_BUFFERED == 1)
+/* Set to 0 to drop output instead of waiting when uart tx ring is full */
+#ifndef UART_BUFFERED_BLOCKING
+#define UART_BUFFERED_BLOCKING      1
+#endif
+#endif
+
 int putchar(int dat)
 {
+#if defined(SIMULATION_SUMMARY) && (SIMULATION_SUMMARY == 1)
+    // console is muted, results are in the summary record of simulation_exit
+    return dat;
+#endif
+#if defined(NUCLEI_UART_BUFFERED) && (NUCLEI_UART_BUFFERED == 1)
+    uint8_t buf[2] = {'\r', (uint8_t)dat};
+
+    if (SystemDebugUART.uart != NULL) {
+        if (dat == '\n') {
+            uart_buffered_write(&SystemDebugUART, buf, 2, UART_BUFFERED_BLOCKING);
+        } else {
+            uart_buffered_write(&SystemDebugUART, buf + 1, 1, UART_BUFFERED_BLOCKING);
+        }
+        return dat;
+    }
+#endif
     if (dat == '\n') {
         uart_write(SOC_DEBUG_UART, '\r');
     }
@@ -21,8 +44,27 @@ __WEAK ssize_t _write(int fd, const void* ptr, size_t len)
     if (!isatty(fd)) {
         return -1;
     }
+#if defined(SIMULATION_SUMMARY) && (SIMULATION_SUMMARY == 1)
+    return len;
+#endif
 
     const uint8_t* writebuf = (const uint8_t*)ptr;
+#if defined(NUCLEI_UART_BUFFERED) && (NUCLEI_UART_BUFFERED == 1)
+    size_t start = 0;
+
+    // copy the runs between newlines at once, the ring is only locked once per run
+    if (SystemDebugUART.uart != NULL) {
+        for (size_t i = 0; i < len; i++) {
+            if (writebuf[i] == '\n') {
+                uart_buffered_write(&SystemDebugUART, writebuf + start, i - start, UART_BUFFERED_BLOCKING);
+                uart_buffered_write(&SystemDebugUART, (const uint8_t*)"\r", 1, UART_BUFFERED_BLOCKING);
+                start = i;
+            }
+        }
+        uart_buffered_write(&SystemDebugUART, writebuf + start, len - start, UART_BUFFERED_BLOCKING);
+        return len;
+    }
+#endif
     for (size_t i = 0; i < len; i++) {
         putchar((int)writebuf[i]);
     }
@@ -46,10 +46,44 @@ uint32_t measure_cpu_freq(uint32_t n)
 #elif defined ( __ICCRISCV__ )
 #endif
 
+#if !defined(SOC_CPU_FREQ)
+/*
+ * Measured cpu frequency is cached, so it is measured only once, define CPU_FREQ_CACHE_SECTION
+ * to a section in retention ram which is not cleared by startup code, such as ".noinit",
+ * then the cache is kept across warm resets and boot skips the measurement
+ */
+#define CPU_FREQ_CACHE_MAGIC        0x43465251UL
+
+typedef struct {
+    uint32_t magic;
+    uint32_t freq;
+    uint32_t check;                 /* ~freq, to detect the garbage of retention ram after power on */
+} CPU_FREQ_Cache_Type;
+
+#if defined(CPU_FREQ_CACHE_SECTION)
+static CPU_FREQ_Cache_Type cpu_freq_cache __attribute__((section(CPU_FREQ_CACHE_SECTION)));
+#else
+static CPU_FREQ_Cache_Type cpu_freq_cache;
+#endif
+#endif
+
+/**
+ * \brief      get cpu frequency in Hz
+ * \details
+ *             Return SOC_CPU_FREQ if it is defined at build time, otherwise measure cpu
+ *             frequency by system timer at the first call and return the cached value later
+ * \return     cpu frequency in Hz
+ */
 uint32_t get_cpu_freq(void)
 {
+#if defined(SOC_CPU_FREQ)
+    return (uint32_t)(SOC_CPU_FREQ);
+#else
     uint32_t cpu_freq;
 
+    if ((cpu_freq_cache.magic == CPU_FREQ_CACHE_MAGIC) && (cpu_freq_cache.check == ~cpu_freq_cache.freq)) {
+        return cpu_freq_cache.freq;
+    }
     // warm up
     measure_cpu_freq(1);
     // measure for real
@@ -58,35 +92,191 @@ uint32_t get_cpu_freq(void)
 #else
     cpu_freq = measure_cpu_freq(100);
 #endif
+    cpu_freq_cache.freq = cpu_freq;
+    cpu_freq_cache.check = ~cpu_freq;
+    cpu_freq_cache.magic = CPU_FREQ_CACHE_MAGIC;
 
     return cpu_freq;
+#endif
+}
+
+/**
+ * \brief      drop the cached cpu frequency
+ * \details
+ *             Call it after cpu clock is changed, the next \ref get_cpu_freq measures it again
+ */
+void clear_cpu_freq_cache(void)
+{
+#if !defined(SOC_CPU_FREQ)
+    cpu_freq_cache.magic = 0;
+#endif
+}
+
+/* Busy wait cycles on mcycle, for the delays shorter than system timer tick */
+static void delay_spin_cycles(uint64_t cycles)
+{
+    uint64_t start = __get_rv_cycle();
+
+    while ((__get_rv_cycle() - start) < cycles);
+}
+
+/*
+ * Wait ticks of system timer, sleep by WFI with the compare interrupt of
+ * current hart waking it up, the compare value and interrupt enable of other users such
+ * as RTOS tick are restored after each wakeup, and the pending interrupts are served
+ * before sleeping again if interrupts were enabled by caller
+ */
+static void delay_ticks(uint64_t ticks)
+{
+#if defined(__SYSTIMER_PRESENT) && (__SYSTIMER_PRESENT == 1)
+    uint64_t deadline = SysTimer_GetLoadValue() + ticks;
+    uint64_t now, owner_cmp;
+#if defined(__ECLIC_PRESENT) && (__ECLIC_PRESENT == 1)
+    rv_csr_t mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    uint32_t owner_ie;
+
+    while ((now = SysTimer_GetLoadValue()) < deadline) {
+        owner_cmp = SysTimer_GetCompareValue();
+        // compare interrupt of owner is due, wake is immediate, so only spin until it is served
+        if (owner_cmp > now) {
+            owner_ie = ECLIC_GetEnableIRQ(SysTimer_IRQn);
+            if (deadline < owner_cmp) {
+                SysTimer_SetCompareValue(deadline);
+            }
+            ECLIC_EnableIRQ(SysTimer_IRQn);
+            // wakes on any pending interrupt even with mstatus.MIE cleared
+            __WFI();
+            if (owner_ie == 0) {
+                ECLIC_DisableIRQ(SysTimer_IRQn);
+            }
+            if (deadline < owner_cmp) {
+                SysTimer_SetCompareValue(owner_cmp);
+            }
+        }
+        // serve the pending interrupts
+        __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+        __RV_CSR_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    }
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+#else
+    (void)owner_cmp;
+    while ((now = SysTimer_GetLoadValue()) < deadline);
+#endif
+#else
+    (void)ticks;
+    #warning "delay functions require system timer present, if you are using this, it will not work"
+#endif
+}
+
+/* Delays shorter than it spin, longer ones sleep until system timer deadline */
+#ifndef DELAY_SLEEP_MIN_US
+#define DELAY_SLEEP_MIN_US          100
+#endif
+
+/**
+ * \brief      delay a time in nanoseconds
+ * \details
+ *             Short delays spin on mcycle with \ref SystemCoreClock, the ones not shorter
+ *             than DELAY_SLEEP_MIN_US sleep by WFI until system timer compare interrupt
+ * \param[in]  count: count in nanoseconds
+ * \remarks
+ *             The precision is limited by instruction overhead for delays of a few cycles
+ */
+void delay_ns(uint32_t count)
+{
+    if (count < DELAY_SLEEP_MIN_US * 1000UL) {
+        delay_spin_cycles(((uint64_t)SystemCoreClock * count + 999999999UL) / 1000000000UL);
+    } else {
+        delay_ticks(((uint64_t)SOC_TIMER_FREQ * count + 999999999UL) / 1000000000UL);
+    }
+}
+
+/**
+ * \brief      delay a time in microseconds
+ * \details
+ *             Short delays spin on mcycle with \ref SystemCoreClock, the ones not shorter
+ *             than DELAY_SLEEP_MIN_US sleep by WFI until system timer compare interrupt
+ * \param[in]  count: count in microseconds
+ */
+void delay_us(uint32_t count)
+{
+    if (count < DELAY_SLEEP_MIN_US) {
+        delay_spin_cycles(((uint64_t)SystemCoreClock * count + 999999UL) / 1000000UL);
+    } else {
+        delay_ticks(((uint64_t)SOC_TIMER_FREQ * count + 999999UL) / 1000000UL);
+    }
 }
 
 /**
  * \brief      delay a time in milliseconds
  * \details
- *             provide API for delay
+ *             provide API for delay, it sleeps by WFI until system timer compare interrupt
  * \param[in]  count: count in milliseconds
  * \remarks
  */
 void delay_1ms(uint32_t count)
 {
-    uint64_t start_mtime, delta_mtime;
-    uint64_t delay_ticks = (SOC_TIMER_FREQ * (uint64_t)count) / 1000;
+    delay_ticks((SOC_TIMER_FREQ * (uint64_t)count) / 1000);
+}
 
-#if defined(__SYSTIMER_PRESENT) && (__SYSTIMER_PRESENT == 1)
-    start_mtime = SysTimer_GetLoadValue();
+#if defined(SIMULATION_SUMMARY) && (SIMULATION_SUMMARY == 1)
+/** Summary record of simulation, dumped by simulation model after exit */
+volatile SimuSummary_Type SimuSummary;
 
-    do {
-        delta_mtime = SysTimer_GetLoadValue() - start_mtime;
-    } while (delta_mtime < delay_ticks);
+static const uint32_t simu_summary_events[SIMU_SUMMARY_EVENTS] = {
+    SIMU_SUMMARY_EVENT0, SIMU_SUMMARY_EVENT1, SIMU_SUMMARY_EVENT2, SIMU_SUMMARY_EVENT3
+};
+
+static uint64_t simu_start_cycle, simu_start_instret;
+
+/**
+ * \brief      start counting of simulation summary
+ * \details
+ *             Called by boot hart at end of _premain_init, programs the hpm events and clears them
+ */
+void SimuSummary_Start(void)
+{
+    for (uint32_t i = 0; i < SIMU_SUMMARY_EVENTS; i++) {
+        __set_hpm_event(SIMU_SUMMARY_HPM_BASE + i, simu_summary_events[i]);
+        __set_hpm_counter(SIMU_SUMMARY_HPM_BASE + i, 0);
+    }
+    __enable_all_counter();
+    simu_start_instret = __get_rv_instret();
+    simu_start_cycle = __get_rv_cycle();
+}
+
+static void simu_summary_write(int status)
+{
+    uint64_t cycles = __get_rv_cycle() - simu_start_cycle;
+    uint64_t instret = __get_rv_instret() - simu_start_instret;
+#if defined(SIMU_SUMMARY_ADDR)
+    volatile SimuSummary_Type *rec = (volatile SimuSummary_Type *)(SIMU_SUMMARY_ADDR);
 #else
-    #warning "delay_1ms function require system timer present, if you are using this, it will not work"
+    volatile SimuSummary_Type *rec = &SimuSummary;
 #endif
+
+    for (uint32_t i = 0; i < SIMU_SUMMARY_EVENTS; i++) {
+        rec->event[i] = simu_summary_events[i];
+        rec->count[i] = __get_hpm_counter(SIMU_SUMMARY_HPM_BASE + i);
+    }
+    rec->version = SIMU_SUMMARY_VERSION;
+    rec->status = status;
+    rec->nevents = SIMU_SUMMARY_EVENTS;
+    rec->cycles = cycles;
+    rec->instret = instret;
+    // magic tells the record is complete
+    __RWMB();
+    rec->magic = SIMU_SUMMARY_MAGIC;
+    __RWMB();
 }
+#endif
 
 void simulation_exit(int status)
 {
+#if defined(SIMULATION_SUMMARY) && (SIMULATION_SUMMARY == 1)
+    // console is muted, so no message is left to flush out
+    simu_summary_write(status);
+#else
     // Both xlspike and qemu will write RXFIFO to make it works for xlspike even SIMU=qemu
     // workaround for fix cycle model exit with some message not print
     for (int i = 0; i < 10; i ++) {
@@ -94,6 +284,7 @@ void simulation_exit(int status)
         uart_write(UART0, '\0');
     }
     uart_write(UART0, '\n');
+#endif
     // pass exit status via rxfifo register
     SIMULATION_EXIT(status);
 #if defined(SIMULATION_MODE)
@@ -25,6 +25,7 @@
  ******************************************************************************/
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include "nuclei_sdk_hal.h"
 
 // TODO: This implementation contains many extra code controlled by macros
@@ -269,6 +270,160 @@ void SystemInit(void)
     SystemCoreClock = SYSTEM_CLOCK;
 }
 
+#if defined(__CCM_PRESENT) && (__CCM_PRESENT == 1)
+#if defined(__ICACHE_PRESENT) && (__ICACHE_PRESENT == 1)
+#if defined(__ICACHE_LINESHIFT)
+CacheInfo_Type SystemICacheInfo = {__ICACHE_LINESIZE, __ICACHE_WAYS, __ICACHE_SETS, __ICACHE_SIZE,
+                                   __ICACHE_LINESHIFT, (__ICACHE_WAYS) - 1};
+#else
+CacheInfo_Type SystemICacheInfo;
+#endif
+#endif
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1)
+#if defined(__DCACHE_LINESHIFT)
+CacheInfo_Type SystemDCacheInfo = {__DCACHE_LINESIZE, __DCACHE_WAYS, __DCACHE_SETS, __DCACHE_SIZE,
+                                   __DCACHE_LINESHIFT, (__DCACHE_WAYS) - 1};
+#else
+CacheInfo_Type SystemDCacheInfo;
+#endif
+#endif
+
+/* Probe cache geometry once, so cache maintenance code need not decode CSRs again */
+static void Cache_Info_Init(void)
+{
+#if defined(__ICACHE_PRESENT) && (__ICACHE_PRESENT == 1) && !defined(__ICACHE_LINESHIFT)
+    if (ICachePresent()) {
+        GetICacheInfo(&SystemICacheInfo);
+    }
+#endif
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1) && !defined(__DCACHE_LINESHIFT)
+    if (DCachePresent()) {
+        GetDCacheInfo(&SystemDCacheInfo);
+    }
+#endif
+}
+
+#ifndef __ICCRISCV__
+/*
+ * Boundary of code and data tagged with __CACHE_LOCKED and __CACHE_LOCKED_DATA,
+ * they are weak since they are only provided when the linker script collect
+ * .text.cache_locked and .data.cache_locked sections, such as
+ *
+ *   . = ALIGN(64);
+ *   PROVIDE( __cache_locked_text_start = . );
+ *   KEEP(*(.text.cache_locked))
+ *   PROVIDE( __cache_locked_text_end = . );
+ *
+ * in .text output section, and the same for .data.cache_locked in .data output section
+ */
+extern char __cache_locked_text_start[] __WEAK;
+extern char __cache_locked_text_end[] __WEAK;
+extern char __cache_locked_data_start[] __WEAK;
+extern char __cache_locked_data_end[] __WEAK;
+
+/*
+ * Get line count of range [start, end) aligned to cache line, return 0 if nothing to lock,
+ * and set status to CCM_OP_EXCEED_ERR if it can't fit into the lockable ways
+ */
+static unsigned long Cache_Lock_Lines(CacheInfo_Type *info, unsigned long *start, unsigned long end, unsigned long *status)
+{
+    unsigned long cnt;
+
+    *status = CCM_OP_SUCCESS;
+    if ((*start == 0) || (end <= *start) || (info->linesize == 0)) {
+        return 0;
+    }
+    *start &= ~((unsigned long)info->linesize - 1);
+    cnt = (end - *start + info->linesize - 1) >> info->lineshift;
+    /* N-Way cache can lock N-1 ways, a continuous range uses each set at most once per setperway lines */
+    if (cnt > (unsigned long)info->lockways * info->setperway) {
+        *status = CCM_OP_EXCEED_ERR;
+        return 0;
+    }
+    return cnt;
+}
+
+/*
+ * Preload and lock code and data tagged with __CACHE_LOCKED/__CACHE_LOCKED_DATA, done by each hart,
+ * status[0] and status[1] are the CCM_OP_FINFO_Type result of I-Cache and D-Cache
+ */
+static void Cache_Lock_Init(unsigned long status[2])
+{
+    unsigned long start, cnt;
+
+#if defined(__ICACHE_PRESENT) && (__ICACHE_PRESENT == 1)
+    start = (unsigned long)__cache_locked_text_start;
+    cnt = Cache_Lock_Lines(&SystemICacheInfo, &start, (unsigned long)__cache_locked_text_end, &status[0]);
+    if (cnt > 0) {
+        status[0] = MLockICacheLines(start, cnt);
+        if (status[0] != CCM_OP_SUCCESS) {
+            MUnlockICacheLines(start, cnt);
+        }
+    }
+#endif
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1)
+    start = (unsigned long)__cache_locked_data_start;
+    cnt = Cache_Lock_Lines(&SystemDCacheInfo, &start, (unsigned long)__cache_locked_data_end, &status[1]);
+    if (cnt > 0) {
+        status[1] = MLockDCacheLines(start, cnt);
+        if (status[1] != CCM_OP_SUCCESS) {
+            MUnlockDCacheLines(start, cnt);
+        }
+    }
+#endif
+}
+
+/* Report failure of Cache_Lock_Init */
+static void Cache_Lock_Report(const unsigned long status[2])
+{
+    static const char *names[2] = {"I-Cache", "D-Cache"};
+
+    for (int i = 0; i < 2; i++) {
+        if (status[i] != CCM_OP_SUCCESS) {
+            printf("Unable to lock __CACHE_LOCKED %s into %s, fail info %lu\r\n", \
+                   (i == 0) ? "code" : "data", names[i], status[i]);
+        }
+    }
+}
+#endif
+#endif
+
+#ifndef __ICCRISCV__
+/*
+ * Boundary of code tagged with __HOT_ILM or collected by patterns of tools/scripts/hotilm.py,
+ * they are weak since they are only provided when the linker script has an output section
+ * in ILM loaded from flash, such as
+ *
+ *   .ilm_text : ALIGN(8) {
+ *     PROVIDE( __ilm_text_start = . );
+ *     KEEP(*(.ilm_text))
+ *     INCLUDE hot_ilm.ld
+ *     . = ALIGN(8);
+ *     PROVIDE( __ilm_text_end = . );
+ *   } >ilm AT>flash
+ *   PROVIDE( __ilm_text_lma = LOADADDR(.ilm_text) );
+ */
+extern unsigned long __ilm_text_start[] __WEAK;
+extern unsigned long __ilm_text_end[] __WEAK;
+extern unsigned long __ilm_text_lma[] __WEAK;
+
+/* Copy hot code into ILM of current hart, each hart has its own ILM */
+static void HotILM_Init(void)
+{
+    unsigned long words = (unsigned long)(__ilm_text_end - __ilm_text_start);
+    unsigned long i;
+
+    if (((unsigned long)__ilm_text_lma == (unsigned long)__ilm_text_start) || (words == 0)) {
+        return;
+    }
+    for (i = 0; i < words; i++) {
+        __ilm_text_start[i] = __ilm_text_lma[i];
+    }
+    __RWMB();
+    __FENCE_I();
+}
+#endif
+
 /**
  * \defgroup  NMSIS_Core_IntExcNMI_Handling   Interrupt and Exception and NMI Handling
  * \brief Functions for interrupt, exception and nmi handle available in system_<device>.c.
@@ -301,6 +456,31 @@ static unsigned long SystemExceptionHandlers[MAX_SYSTEM_EXCEPTION_NUM + 1];
  */
 #if defined(__TEE_PRESENT) && (__TEE_PRESENT == 1)
 static unsigned long SystemExceptionHandlers_S[MAX_SYSTEM_EXCEPTION_NUM];
+
+#if defined(NUCLEI_FAST_SYSCALL_S) && (NUCLEI_FAST_SYSCALL_S == 1) && !defined(__riscv_32e)
+/**
+ * \brief      Store the fast path syscall handlers of supervisor mode for syscall number 0 - 15
+ * \note
+ * - A non-zero entry is called by exc_entry_s for the user mode ecall whose a7 is its syscall number,
+ *   before any register or CSR is saved, and \ref core_exception_handler_s is skipped
+ * - The handler must not enable interrupts or cause another exception
+ * - It is accessed by exc_entry_s in assembly, so it is not static
+ */
+unsigned long SystemSyscallTable_S[MAX_SYSCALL_NUM_S];
+#endif
+#endif
+
+#if defined(NUCLEI_FAST_EXC) && (NUCLEI_FAST_EXC == 1)
+/**
+ * \brief      Store the fast path exception handlers for exception code 0 - 15
+ * \note
+ * - A non-zero entry is called by exc_entry right after the caller saved registers are saved,
+ *   mcause, mepc and msubm are not saved, and \ref core_exception_handler is skipped,
+ *   so it is used for the frequent ones such as ecall and misaligned access emulation
+ * - The handler must not enable interrupts or cause another exception
+ * - It is accessed by exc_entry in assembly, so it is not static
+ */
+unsigned long SystemExceptionFastHandlers[MAX_FAST_EXCEPTION_NUM];
 #endif
 /**
  * \brief      Exception Handler Function Typedef
@@ -327,6 +507,10 @@ static void system_default_exception_handler(unsigned long mcause, unsigned long
     NSDK_DEBUG("MTVAL  : 0x%lx\r\n", __RV_CSR_READ(CSR_MTVAL));
     NSDK_DEBUG("HARTID : %u\r\n", (unsigned int)__get_hart_id());
     Exception_DumpFrame(sp, PRV_M);
+#if defined(NUCLEI_DLOG) && (NUCLEI_DLOG == 1) && !defined(DISABLE_NSDK_DEBUG)
+    // no later chance to emit the deferred messages before hang
+    dlog_flush();
+#endif
 #if defined(SIMULATION_MODE)
     // directly exit if in SIMULATION
     extern void simulation_exit(int status);
@@ -404,6 +588,27 @@ void Exception_Register_EXC(uint32_t EXCn, unsigned long exc_handler)
     }
 }
 
+#if defined(NUCLEI_FAST_EXC) && (NUCLEI_FAST_EXC == 1)
+/**
+ * \brief       Register a fast path exception handler for exception code EXCn
+ * \details
+ * The handler is called with the same arguments as the one registered by \ref Exception_Register_EXC,
+ * sp points to the frame in which only the caller saved registers are valid, and it takes precedence
+ * over the one registered by \ref Exception_Register_EXC, pass 0 to remove it.
+ * \param [in]  EXCn    See \ref EXCn_Type, must be less than \ref MAX_FAST_EXCEPTION_NUM
+ * \param [in]  exc_handler     The fast path exception handler for this exception code EXCn
+ * \remarks
+ * - The handler must not enable interrupts or cause another exception, since mcause, mepc and
+ *   msubm are not saved, it can update mepc such as skipping the ecall instruction
+ */
+void Exception_Register_Fast_EXC(uint32_t EXCn, unsigned long exc_handler)
+{
+    if (EXCn < MAX_FAST_EXCEPTION_NUM) {
+        SystemExceptionFastHandlers[EXCn] = exc_handler;
+    }
+}
+#endif
+
 /**
  * \brief       Get current exception handler for exception code EXCn
  * \details
@@ -441,6 +646,13 @@ uint32_t core_exception_handler(unsigned long mcause, unsigned long sp)
     uint32_t EXCn = (uint32_t)(mcause & 0X00000fff);
     EXC_HANDLER exc_handler;
 
+#if defined(NUCLEI_FAST_EXC) && (NUCLEI_FAST_EXC == 1)
+    /* Only reached by exc_entry without fast path dispatch */
+    if ((EXCn < MAX_FAST_EXCEPTION_NUM) && (SystemExceptionFastHandlers[EXCn] != 0)) {
+        ((EXC_HANDLER)SystemExceptionFastHandlers[EXCn])(mcause, sp);
+        return 0;
+    }
+#endif
     if (EXCn < MAX_SYSTEM_EXCEPTION_NUM) {
         exc_handler = (EXC_HANDLER)SystemExceptionHandlers[EXCn];
     } else if (EXCn == NMI_EXCn) {
@@ -512,6 +724,27 @@ unsigned long Exception_Get_EXC_S(uint32_t EXCn)
     }
 }
 
+#if defined(NUCLEI_FAST_SYSCALL_S) && (NUCLEI_FAST_SYSCALL_S == 1) && !defined(__riscv_32e)
+/**
+ * \brief       Register a fast path syscall handler for syscall number num of supervisor mode
+ * \details
+ * A user mode ecall with num in a7 calls handler with a0 - a5, its return value goes back to a0,
+ * and the ecall instruction is skipped, see \ref __syscall_s, pass 0 to remove it, then the ecall
+ * goes to the handler registered by \ref Exception_Register_EXC_S for \ref UmodeEcall_EXCn.
+ * \param [in]  num         Syscall number, must be less than \ref MAX_SYSCALL_NUM_S
+ * \param [in]  handler     The fast path syscall handler, see \ref SYSCALL_HANDLER_S
+ * \remarks
+ * - The user mode ecall must be delegated to supervisor mode by medeleg
+ * - The handler must not enable interrupts or cause another exception, since scause and sepc are not saved
+ */
+void Syscall_Register_S(uint32_t num, unsigned long handler)
+{
+    if (num < MAX_SYSCALL_NUM_S) {
+        SystemSyscallTable_S[num] = handler;
+    }
+}
+#endif
+
 /**
  * \brief      common Exception handler entry of supervisor mode
  * \details
@@ -530,6 +763,19 @@ uint32_t core_exception_handler_s(unsigned long scause, unsigned long sp)
     uint32_t EXCn = (uint32_t)(scause & 0X00000fff);
     EXC_HANDLER exc_handler;
 
+#if defined(NUCLEI_FAST_SYSCALL_S) && (NUCLEI_FAST_SYSCALL_S == 1) && !defined(__riscv_32e)
+    /* Only reached by exc_entry_s without fast path syscall dispatch */
+    if (EXCn == UmodeEcall_EXCn) {
+        EXC_Frame_Type *frame = (EXC_Frame_Type *)sp;
+
+        if ((frame->a7 < MAX_SYSCALL_NUM_S) && (SystemSyscallTable_S[frame->a7] != 0)) {
+            frame->a0 = ((SYSCALL_HANDLER_S)SystemSyscallTable_S[frame->a7])(frame->a0, frame->a1,
+                        frame->a2, frame->a3, frame->a4, frame->a5);
+            frame->epc += 4;
+            return 0;
+        }
+    }
+#endif
     if (EXCn < MAX_SYSTEM_EXCEPTION_NUM) {
         exc_handler = (EXC_HANDLER)SystemExceptionHandlers_S[EXCn];
     } else {
@@ -567,18 +813,72 @@ void ECLIC_Init(void)
 
 }
 
+#if defined(NUCLEI_VECTOR_RAM) && (NUCLEI_VECTOR_RAM == 1)
+/*
+ * mtvt must be aligned to the vector table size rounded up to power of 2,
+ * and at least 64 bytes
+ */
+#define VECTOR_TABLE_BYTES          (SOC_INT_MAX * sizeof(unsigned long))
+#ifndef VECTOR_RAM_ALIGN
+#define VECTOR_RAM_ALIGN            ((VECTOR_TABLE_BYTES <= 64) ? 64 : (VECTOR_TABLE_BYTES <= 128) ? 128 : \
+                                     (VECTOR_TABLE_BYTES <= 256) ? 256 : (VECTOR_TABLE_BYTES <= 512) ? 512 : \
+                                     (VECTOR_TABLE_BYTES <= 1024) ? 1024 : (VECTOR_TABLE_BYTES <= 2048) ? 2048 : \
+                                     (VECTOR_TABLE_BYTES <= 4096) ? 4096 : (VECTOR_TABLE_BYTES <= 8192) ? 8192 : 16384)
+#endif
+
+/*
+ * Writable copy of vector_base, placed in .data by default, define VECTOR_RAM_SECTION
+ * such as ".ilm_data" to place it in a faster memory described in your linker script
+ */
+#ifdef VECTOR_RAM_SECTION
+__attribute__((section(VECTOR_RAM_SECTION)))
+#endif
+__ALIGNED(VECTOR_RAM_ALIGN) unsigned long SystemVectorTable[SOC_INT_MAX];
+
+/*
+ * Copy vector table to SystemVectorTable by boot hart, the vector entries are
+ * fetched by hardware, so write back dcache and drop stale icache lines of it.
+ */
+static void Vector_Relocate(void)
+{
+    unsigned long i;
+
+    if (__get_hart_id() != BOOT_HARTID) {
+        return;
+    }
+    for (i = 0; i < SOC_INT_MAX; i++) {
+        SystemVectorTable[i] = vector_base[i];
+    }
+#if (defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1)) && (defined(__CCM_PRESENT) && (__CCM_PRESENT == 1))
+    MFlushDCacheRange(SystemVectorTable, VECTOR_TABLE_BYTES);
+#endif
+#if (defined(__ICACHE_PRESENT) && (__ICACHE_PRESENT == 1))
+    __FENCE_I();
+#endif
+}
+#endif
+
 /**
  * \brief initialize interrupt controller
  * \details
  * If ECLIC present, init it.
  * \remarks
- * This function previously was ECLIC_Init
+ * - This function previously was ECLIC_Init
+ * - If NUCLEI_VECTOR_RAM is 1, vector_base is copied to \ref SystemVectorTable and mtvt points to it,
+ *   so handlers can be registered when vector_base is in flash(FLASHXIP mode), and vectors are
+ *   fetched from ram instead of flash
  */
 void Interrupt_Init(void)
 {
     if (__RV_CSR_READ(CSR_MCFG_INFO) & MCFG_INFO_CLIC) {
+#if defined(NUCLEI_VECTOR_RAM) && (NUCLEI_VECTOR_RAM == 1)
+        Vector_Relocate();
+        /* Set ECLIC vector interrupt base address to the writable copy of vector_base */
+        __RV_CSR_WRITE(CSR_MTVT, (unsigned long)SystemVectorTable);
+#else
         /* Set ECLIC vector interrupt base address to vector_base */
         __RV_CSR_WRITE(CSR_MTVT, (unsigned long)vector_base);
+#endif
         /* Set ECLIC non-vector entry to irq_entry */
         __RV_CSR_WRITE(CSR_MTVT2, (unsigned long)irq_entry | 0x1);
         /* Set as CLIC interrupt mode */
@@ -623,6 +923,96 @@ void Interrupt_Init(void)
 }
 
 #if defined(__ECLIC_PRESENT) && (__ECLIC_PRESENT == 1)
+#if defined(NUCLEI_IRQ_STAT) && (NUCLEI_IRQ_STAT == 1)
+IRQ_Stat_Hart_Type SystemIRQStat[IRQ_STAT_HART_NUM];
+
+/* real non-vector interrupt handlers called by IRQStat_Dispatch */
+static void (*SystemIRQHandlers[SOC_INT_MAX])(void);
+
+/*
+ * Common non-vector interrupt handler installed in vector table by ECLIC_Register_IRQ,
+ * it is called from irq_entry with interrupt enabled, so it can be preempted by higher
+ * level interrupt, a nested interrupt always returns before the preempted one resumes,
+ * so per hart counters can be updated without lock.
+ */
+static void IRQStat_Dispatch(void)
+{
+    unsigned long irqn = __RV_CSR_READ(CSR_MCAUSE) & MCAUSE_CAUSE;
+    unsigned long hartidx = __get_hart_index();
+    IRQ_Stat_Hart_Type *hart;
+    IRQ_Stat_Type *stat;
+    unsigned long start, elapsed;
+    uint32_t depth;
+
+    if ((irqn >= SOC_INT_MAX) || (SystemIRQHandlers[irqn] == NULL)) {
+        return;
+    }
+    if (hartidx >= IRQ_STAT_HART_NUM) {
+        SystemIRQHandlers[irqn]();
+        return;
+    }
+    hart = &SystemIRQStat[hartidx];
+    stat = &hart->irq[irqn];
+    depth = hart->nest;
+    hart->nest = depth + 1;
+    if (depth < IRQ_STAT_MAX_NEST) {
+        hart->child[depth] = 0;
+    }
+
+    start = __RV_CSR_READ(CSR_MCYCLE);
+    SystemIRQHandlers[irqn]();
+    elapsed = __RV_CSR_READ(CSR_MCYCLE) - start;
+
+    hart->nest = depth;
+    stat->count++;
+    stat->cycles += elapsed;
+    stat->selfcycles += (depth < IRQ_STAT_MAX_NEST) ? (elapsed - hart->child[depth]) : elapsed;
+    if (elapsed > stat->maxcycles) {
+        stat->maxcycles = elapsed;
+    }
+    if (depth + 1 > stat->maxnest) {
+        stat->maxnest = depth + 1;
+    }
+    if (depth + 1 > hart->maxnest) {
+        hart->maxnest = depth + 1;
+    }
+    /* account elapsed cycles to the preempted interrupt */
+    if ((depth > 0) && (depth <= IRQ_STAT_MAX_NEST)) {
+        hart->child[depth - 1] += elapsed;
+    }
+}
+
+void IRQStat_Reset(void)
+{
+    unsigned long i;
+    uint8_t *p = (uint8_t *)SystemIRQStat;
+
+    for (i = 0; i < sizeof(SystemIRQStat); i++) {
+        p[i] = 0;
+    }
+}
+
+void IRQStat_Print(void)
+{
+    unsigned long i, j;
+    IRQ_Stat_Type *stat;
+
+    for (i = 0; i < IRQ_STAT_HART_NUM; i++) {
+        printf("Hart %lu IRQ statistics, max nest %lu\n", i, (unsigned long)SystemIRQStat[i].maxnest);
+        printf("IRQn, count, cycles, selfcycles, maxcycles, maxnest\n");
+        for (j = 0; j < SOC_INT_MAX; j++) {
+            stat = &SystemIRQStat[i].irq[j];
+            if (stat->count == 0) {
+                continue;
+            }
+            printf("%lu, %lu, %llu, %llu, %lu, %lu\n", j, (unsigned long)stat->count,
+                   (unsigned long long)stat->cycles, (unsigned long long)stat->selfcycles,
+                   (unsigned long)stat->maxcycles, (unsigned long)stat->maxnest);
+        }
+    }
+}
+#endif
+
 /**
  * \brief  Initialize a specific IRQ and register the handler
  * \details
@@ -637,7 +1027,9 @@ void Interrupt_Init(void)
  * \return       -1 means invalid input parameter. 0 means successful.
  * \remarks
  * - This function use to configure specific eclic interrupt and register its interrupt handler and enable its interrupt.
- * - If the vector table is placed in read-only section(FLASHXIP mode), handler could not be installed
+ * - If the vector table is placed in read-only section(FLASHXIP mode), handler could not be installed,
+ *   unless NUCLEI_VECTOR_RAM is 1, which relocates the vector table to \ref SystemVectorTable
+ * - If NUCLEI_IRQ_STAT is 1, non-vector handler is called through a dispatcher to record interrupt statistics
  */
 int32_t ECLIC_Register_IRQ(IRQn_Type IRQn, uint8_t shv, ECLIC_TRIGGER_Type trig_mode, uint8_t lvl, uint8_t priority, void* handler)
 {
@@ -655,6 +1047,12 @@ int32_t ECLIC_Register_IRQ(IRQn_Type IRQn, uint8_t shv, ECLIC_TRIGGER_Type trig_
     /* set interrupt priority */
     ECLIC_SetPriorityIRQ(IRQn, priority);
     if (handler != NULL) {
+#if defined(NUCLEI_IRQ_STAT) && (NUCLEI_IRQ_STAT == 1)
+        if ((shv == ECLIC_NON_VECTOR_INTERRUPT) && (IRQn < SOC_INT_MAX)) {
+            SystemIRQHandlers[IRQn] = (void (*)(void))handler;
+            handler = (void *)IRQStat_Dispatch;
+        }
+#endif
         /* set interrupt handler entry to vector table */
         ECLIC_SetVector(IRQn, (rv_csr_t)handler);
     }
@@ -664,6 +1062,187 @@ int32_t ECLIC_Register_IRQ(IRQn_Type IRQn, uint8_t shv, ECLIC_TRIGGER_Type trig_
 }
 #endif
 
+#if defined(__ECLIC_PRESENT) && (__ECLIC_PRESENT == 1)
+uint8_t SystemIRQPlanMth[IRQ_PLAN_MAX_CLASSES];
+
+/**
+ * \brief  Compute ECLIC level and priority of interrupts in plan, register and enable them
+ * \details
+ * This function sets nlbits to the least bits giving each class its own level, limited by
+ * implemented ctlbits, computes the MTH masking each class into \ref SystemIRQPlanMth, and
+ * registers each interrupt by \ref ECLIC_Register_IRQ at the level of its class, and the
+ * priority of its order among interrupts of the same class in the table.
+ * \param [in]  plan        plan table
+ * \param [in]  num         entries in plan table
+ * \param [in]  classes     number of latency classes, must be between 1 and \ref IRQ_PLAN_MAX_CLASSES
+ * \return       -1 means invalid plan and nothing is changed. 0 means successful.
+ * \remarks
+ * - It configures ECLIC of the calling hart, ECLIC MTH is not changed
+ */
+int32_t IRQPlan_Apply(const IRQ_Plan_Type *plan, uint32_t num, uint8_t classes)
+{
+    uint8_t intctlbits = (uint8_t)__ECLIC_INTCTLBITS;
+    uint8_t nlbits = 0, lfabits, maxpri, lvl[IRQ_PLAN_MAX_CLASSES], order[IRQ_PLAN_MAX_CLASSES];
+    uint32_t i;
+
+    if ((plan == NULL) || (classes == 0) || (classes > IRQ_PLAN_MAX_CLASSES)) {
+        return -1;
+    }
+    for (i = 0; i < num; i++) {
+        if ((plan[i].cls >= classes) || (plan[i].irqn >= SOC_INT_MAX) \
+            || (plan[i].shv > ECLIC_VECTOR_INTERRUPT) || (plan[i].trig_mode > ECLIC_NEGTIVE_EDGE_TRIGGER)) {
+            return -1;
+        }
+    }
+
+    while (((1UL << nlbits) < classes) && (nlbits < intctlbits)) {
+        nlbits++;
+    }
+    ECLIC_SetCfgNlbits(nlbits);
+    lfabits = 8 - nlbits;
+    maxpri = (uint8_t)((1UL << (intctlbits - nlbits)) - 1);
+    for (i = 0; i < classes; i++) {
+        // share levels in order when there are more classes than levels
+        lvl[i] = (uint8_t)((i << nlbits) / classes);
+        order[i] = 0;
+        SystemIRQPlanMth[i] = (uint8_t)((lvl[i] << lfabits) | ((1UL << lfabits) - 1));
+    }
+    for (i = 0; i < num; i++) {
+        uint8_t cls = plan[i].cls;
+        uint8_t pri = (order[cls] < maxpri) ? (maxpri - order[cls]) : 0;
+
+        order[cls]++;
+        ECLIC_Register_IRQ(plan[i].irqn, plan[i].shv, (ECLIC_TRIGGER_Type)plan[i].trig_mode, lvl[cls], pri, plan[i].handler);
+    }
+    return 0;
+}
+#endif
+
+#if (defined(__ECLIC_PRESENT) && (__ECLIC_PRESENT == 1)) && (defined(__CIDU_PRESENT) && (__CIDU_PRESENT == 1)) \
+    && defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1)
+#define IRQ_AFFINITY_NUM            (SOC_INT_MAX - SOC_EXTERNAL_MAP_TO_ECLIC_IRQn_OFFSET)
+
+/* ECLIC configuration of routed external interrupts, hartmask 0 means not routed */
+typedef struct IRQ_Affinity {
+    uint16_t hartmask;
+    uint8_t attr;
+    uint8_t ctrl;
+} IRQ_Affinity_Type;
+
+static volatile IRQ_Affinity_Type SystemIRQAffinity[IRQ_AFFINITY_NUM];
+
+/* bitmap of routed external interrupts, so harts syncing the affinity skip the others */
+#define IRQ_AFFINITY_MAP_WORDS      ((IRQ_AFFINITY_NUM + 31) / 32)
+static volatile uint32_t SystemIRQRoutedMap[IRQ_AFFINITY_MAP_WORDS];
+
+/* real handlers of first claim mode interrupts called by IRQAffinity_ClaimDispatch */
+static void (*SystemIRQClaimHandlers[IRQ_AFFINITY_NUM])(void);
+
+/*
+ * Non-vector handler of first claim mode interrupts, all target harts take the
+ * interrupt, the one claiming it in CIDU calls the real handler, others return
+ */
+static void IRQAffinity_ClaimDispatch(void)
+{
+    unsigned long irqn = __RV_CSR_READ(CSR_MCAUSE) & MCAUSE_CAUSE;
+    uint32_t extid = IRQn_MAP_TO_EXT_ID(irqn);
+
+    if (CIDU_SetFirstClaimMode(extid, __get_hart_index()) == 0) {
+        SystemIRQClaimHandlers[extid]();
+        CIDU_ResetFirstClaimMode(extid);
+    }
+}
+
+/**
+ * \brief  Initialize an external IRQ, register the handler and route it to harts
+ * \details
+ * This function configures and enables the external interrupt on the calling hart as
+ * \ref ECLIC_Register_IRQ, then routes it by CIDU to the harts in hartmask, other target
+ * harts must call \ref ECLIC_Sync_IRQ_Affinity to configure and enable it on themselves.
+ * \param [in]  IRQn        external interrupt number
+ * \param [in]  shv         \ref ECLIC_NON_VECTOR_INTERRUPT means non-vector mode, and \ref ECLIC_VECTOR_INTERRUPT is vector mode
+ * \param [in]  trig_mode   see \ref ECLIC_TRIGGER_Type
+ * \param [in]  lvl         interupt level
+ * \param [in]  priority    interrupt priority
+ * \param [in]  handler     interrupt handler, shared by all harts since the vector table is shared,
+ *                          if NULL, handler will not be installed
+ * \param [in]  hartmask    target harts, bit n means the hart which hart index is n
+ * \param [in]  mode        \ref IRQ_AFFINITY_BROADCAST or \ref IRQ_AFFINITY_FIRST_CLAIM
+ * \return       -1 means invalid input parameter. 0 means successful.
+ * \remarks
+ * - Only external interrupts can be routed, and first claim mode requires non-vector mode
+ * - If the calling hart is not in hartmask, the interrupt is disabled on it
+ */
+int32_t ECLIC_Register_IRQ_Affinity(IRQn_Type IRQn, uint8_t shv, ECLIC_TRIGGER_Type trig_mode, uint8_t lvl, \
+                                    uint8_t priority, void* handler, uint32_t hartmask, uint32_t mode)
+{
+    uint32_t extid;
+
+    if ((IRQn < SOC_EXTERNAL_MAP_TO_ECLIC_IRQn_OFFSET) || (IRQn >= SOC_INT_MAX) \
+        || (hartmask == 0) || (hartmask >= (1UL << SMP_CPU_CNT)) || (mode > IRQ_AFFINITY_FIRST_CLAIM) \
+        || ((mode == IRQ_AFFINITY_FIRST_CLAIM) && (shv != ECLIC_NON_VECTOR_INTERRUPT))) {
+        return -1;
+    }
+    extid = IRQn_MAP_TO_EXT_ID(IRQn);
+    if ((mode == IRQ_AFFINITY_FIRST_CLAIM) && (handler != NULL)) {
+        SystemIRQClaimHandlers[extid] = (void (*)(void))handler;
+        handler = (void *)IRQAffinity_ClaimDispatch;
+    }
+    if (ECLIC_Register_IRQ(IRQn, shv, trig_mode, lvl, priority, handler) != 0) {
+        return -1;
+    }
+    SystemIRQAffinity[extid].attr = ECLIC->CTRL[IRQn].INTATTR;
+    SystemIRQAffinity[extid].ctrl = ECLIC->CTRL[IRQn].INTCTRL;
+    __RWMB();
+    SystemIRQAffinity[extid].hartmask = (uint16_t)hartmask;
+    __RWMB();
+#if defined(__riscv_atomic)
+    __AMOOR_W((volatile int32_t *)&SystemIRQRoutedMap[extid / 32], (int32_t)(1UL << (extid % 32)));
+#else
+    SystemIRQRoutedMap[extid / 32] |= 1UL << (extid % 32);
+#endif
+    if ((hartmask & (1UL << __get_hart_index())) == 0) {
+        ECLIC_DisableIRQ(IRQn);
+    }
+    CIDU_ResetFirstClaimMode(extid);
+    CIDU_BroadcastExtInterrupt(extid, hartmask);
+    return 0;
+}
+
+/**
+ * \brief Apply routed external IRQ configuration to ECLIC of the calling hart
+ * \details
+ * ECLIC is private to each hart, so each target hart of \ref ECLIC_Register_IRQ_Affinity
+ * calls this function to configure and enable the routed interrupts on itself, and
+ * the routed interrupts not targeting it are disabled.
+ */
+void ECLIC_Sync_IRQ_Affinity(void)
+{
+    uint32_t extid, word;
+    uint32_t hartbit = 1UL << __get_hart_index();
+    uint32_t routed;
+    uint16_t hartmask;
+    IRQn_Type IRQn;
+
+    // visit the routed interrupts only, lowest first
+    for (word = 0; word < IRQ_AFFINITY_MAP_WORDS; word++) {
+        for (routed = SystemIRQRoutedMap[word]; routed != 0; routed &= routed - 1) {
+            extid = word * 32 + __CTZL(routed);
+            hartmask = SystemIRQAffinity[extid].hartmask;
+            __RWMB();
+            IRQn = (IRQn_Type)(extid + SOC_EXTERNAL_MAP_TO_ECLIC_IRQn_OFFSET);
+            if (hartmask & hartbit) {
+                ECLIC->CTRL[IRQn].INTATTR = SystemIRQAffinity[extid].attr;
+                ECLIC->CTRL[IRQn].INTCTRL = SystemIRQAffinity[extid].ctrl;
+                ECLIC_EnableIRQ(IRQn);
+            } else {
+                ECLIC_DisableIRQ(IRQn);
+            }
+        }
+    }
+}
+#endif
+
 #if (defined(__TEE_PRESENT) && (__TEE_PRESENT == 1)) && (defined(__ECLIC_PRESENT) && (__ECLIC_PRESENT == 1))
 /**
  * \brief  Initialize a specific IRQ and register the handler for supervisor mode
@@ -715,7 +1294,270 @@ volatile unsigned long CpuIRegionBase = 0xFFFFFFFF;
 #endif
 
 #define CLINT_MSIP(base, hartid)    (*(volatile uint32_t *)((uintptr_t)((base) + ((hartid) * 4))))
-#define SMP_CTRLREG(base, ofs)      (*(volatile uint32_t *)((uintptr_t)((base) + (ofs))))
+
+#if defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1) && defined(SMP_PARALLEL_BOOT) && (SMP_PARALLEL_BOOT == 1)
+#ifdef __ICCRISCV__
+#error "SMP_PARALLEL_BOOT is not supported by IAR, data is initialized by IAR runtime"
+#endif
+/*
+ * Section boundary of gcc linker script, in parallel boot mode the startup code
+ * skip .data and .bss initialization in boot hart, and each hart initialize a part
+ * of them in __sync_harts, boundary of these sections are aligned to 8 bytes
+ */
+extern unsigned long _data_lma[] __WEAK;
+extern unsigned long _data[] __WEAK;
+extern unsigned long _edata[] __WEAK;
+extern unsigned long __bss_start[] __WEAK;
+extern unsigned long _end[] __WEAK;
+
+/* Get part idx of total words split into SMP_CPU_CNT parts, the last part takes the remainder */
+#define SMP_BOOT_PART_START(words, idx)     (((words) / SMP_CPU_CNT) * (idx))
+#define SMP_BOOT_PART_END(words, idx)       (((idx) == (SMP_CPU_CNT - 1)) ? (words) : (((words) / SMP_CPU_CNT) * ((idx) + 1)))
+
+/*
+ * Copy part idx of .data and zero part idx of .bss, it is force inlined because
+ * __sync_harts must not call other functions
+ */
+__STATIC_FORCEINLINE void SMP_Boot_SectionInit(unsigned long idx)
+{
+    unsigned long words, i, end;
+
+    if ((unsigned long)_data_lma != (unsigned long)_data) {
+        words = (unsigned long)(_edata - _data);
+        end = SMP_BOOT_PART_END(words, idx);
+        for (i = SMP_BOOT_PART_START(words, idx); i < end; i++) {
+            _data[i] = _data_lma[i];
+        }
+    }
+    words = (unsigned long)(_end - __bss_start);
+    end = SMP_BOOT_PART_END(words, idx);
+    for (i = SMP_BOOT_PART_START(words, idx); i < end; i++) {
+        __bss_start[i] = 0;
+    }
+}
+#endif
+
+/*
+ * Resolve kernels dispatched by ISA, such as the isadisp middleware, weak as it is only
+ * defined when one is linked, it is called before main since SystemInit runs before
+ * .data and .bss are initialized
+ */
+extern void SystemDispatchInit(void) __WEAK;
+
+/** mcycle value when boot hart finished _premain_init, which is the cycles from reset to main */
+volatile uint64_t SystemBootCycles = 0;
+
+#if defined(NUCLEI_BOOT_FASTINIT) && (NUCLEI_BOOT_FASTINIT == 1)
+#if defined(SMP_PARALLEL_BOOT) && (SMP_PARALLEL_BOOT == 1)
+#error "NUCLEI_BOOT_FASTINIT and SMP_PARALLEL_BOOT can't be used together"
+#endif
+#ifdef __ICCRISCV__
+#error "NUCLEI_BOOT_FASTINIT is not supported by IAR, data is initialized by IAR runtime"
+#endif
+/*
+ * Section boundary of gcc linker script, boundary of these sections are aligned to 8 bytes,
+ * declared as bytes here, since compressed image and cache blocks are addressed in bytes
+ */
+extern uint8_t _data_lma[] __WEAK;
+extern uint8_t _data[] __WEAK;
+extern uint8_t _edata[] __WEAK;
+extern uint8_t __bss_start[] __WEAK;
+extern uint8_t _end[] __WEAK;
+
+/**
+ * Header of compressed .data load image, placed at _data_lma by tools/scripts/lz4data.py,
+ * followed by the lz4 block of .data, the load image is the plain .data when it is absent
+ */
+typedef struct BootLZ4Header {
+    uint32_t magic[2];                  /*!< "NLZ4DATA" */
+    uint32_t rawsize;                   /*!< Size of .data, must equal to _edata - _data */
+    uint32_t lz4size;                   /*!< Size of lz4 block following the header */
+} BootLZ4Header_Type;
+
+#define BOOT_LZ4_MAGIC0                 0x345A4C4EUL    /* "NLZ4" */
+#define BOOT_LZ4_MAGIC1                 0x41544144UL    /* "DATA" */
+
+#ifndef BOOT_CBO_BLOCK_SIZE
+#if defined(__DCACHE_LINESIZE)
+#define BOOT_CBO_BLOCK_SIZE             __DCACHE_LINESIZE   /*!< Cache block size zeroed by cbo.zero */
+#else
+#define BOOT_CBO_BLOCK_SIZE             64                  /*!< Cache block size zeroed by cbo.zero */
+#endif
+#endif
+
+/** Cycles taken by \ref Boot_SectionInit */
+volatile unsigned long SystemBootSectionCycles = 0;
+
+/* Decompress lz4 block src of srclen bytes into dst, stop at dstend, return end of output */
+__STATIC_FORCEINLINE uint8_t *Boot_LZ4Decompress(uint8_t *dst, uint8_t *dstend, const uint8_t *src, uint32_t srclen)
+{
+    const uint8_t *srcend = src + srclen;
+    const uint8_t *match;
+    uint32_t token, len, byte;
+
+    while (src < srcend) {
+        token = *src++;
+        len = token >> 4;
+        if (len == 15) {
+            do {
+                byte = *src++;
+                len += byte;
+            } while ((byte == 255) && (src < srcend));
+        }
+        if ((len > (uint32_t)(dstend - dst)) || (len > (uint32_t)(srcend - src))) {
+            break;
+        }
+        while (len-- != 0) {
+            *dst++ = *src++;
+        }
+        // last sequence has only literals
+        if (src + 2 > srcend) {
+            break;
+        }
+        match = dst - (src[0] | ((uint32_t)src[1] << 8));
+        src += 2;
+        len = token & 0xF;
+        if (len == 15) {
+            do {
+                byte = *src++;
+                len += byte;
+            } while ((byte == 255) && (src < srcend));
+        }
+        len += 4;
+        if ((match < _data) || (len > (uint32_t)(dstend - dst))) {
+            break;
+        }
+        // match may overlap output, so it is copied bytewise
+        while (len-- != 0) {
+            *dst++ = *match++;
+        }
+    }
+    return dst;
+}
+
+/* Zero [start, end) with the widest store available, start and end are aligned to 8 bytes */
+__STATIC_FORCEINLINE void Boot_Zero(uint8_t *start, uint8_t *end)
+{
+#if defined(__riscv_zicboz)
+    // cbo.zero allocates zero lines in cache without reading memory, data cache must be on
+    if (DCachePresent()) {
+        for (; (start < end) && (((unsigned long)start & (BOOT_CBO_BLOCK_SIZE - 1)) != 0); start += 8) {
+            *(volatile uint64_t *)start = 0;
+        }
+        for (; start + BOOT_CBO_BLOCK_SIZE <= end; start += BOOT_CBO_BLOCK_SIZE) {
+            __ASM volatile("cbo.zero (%0)" : : "r"(start) : "memory");
+        }
+    }
+#endif
+#if defined(__riscv_vector)
+    unsigned long vl, n = (unsigned long)(end - start);
+
+    __enable_vector();
+    while (n != 0) {
+        __ASM volatile("vsetvli %0, %1, e8, m8, ta, ma\n"
+                       "vmv.v.i v0, 0\n"
+                       "vse8.v v0, (%2)\n"
+                       : "=&r"(vl) : "r"(n), "r"(start) : "memory", "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7");
+        start += vl;
+        n -= vl;
+    }
+#else
+    for (; start + 32 <= end; start += 32) {
+        ((volatile uint64_t *)start)[0] = 0;
+        ((volatile uint64_t *)start)[1] = 0;
+        ((volatile uint64_t *)start)[2] = 0;
+        ((volatile uint64_t *)start)[3] = 0;
+    }
+    for (; start < end; start += 8) {
+        *(volatile uint64_t *)start = 0;
+    }
+#endif
+}
+
+void Boot_SectionInit(void) __attribute__((section(".text.init")));
+/**
+ * \brief Initialize .data and .bss sections fast
+ * \details
+ * When NUCLEI_BOOT_FASTINIT=1, the startup code must call this function instead of its
+ * own .data copy and .bss zero loops, before any C code using them, it
+ * - enables I/D cache first, they are enabled again in _premain_init
+ * - decompresses .data when the load image at _data_lma is compressed by
+ *   `tools/scripts/lz4data.py`, or copies it otherwise
+ * - zeroes .bss by cbo.zero with Zicboz, by vector stores with RVV, or by unrolled
+ *   64-bit stores
+ *
+ * Like \ref __sync_harts, it is placed in .text.init and must not call other functions.
+ */
+void Boot_SectionInit(void)
+{
+    uint64_t start = __get_rv_cycle();
+    const BootLZ4Header_Type *hdr = (const BootLZ4Header_Type *)_data_lma;
+    unsigned long size = (unsigned long)(_edata - _data);
+    unsigned long i;
+
+#if defined(__ICACHE_PRESENT) && (__ICACHE_PRESENT == 1)
+    if (ICachePresent()) {
+        EnableICache();
+    }
+#endif
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1)
+    if (DCachePresent()) {
+        EnableDCache();
+    }
+#endif
+    if ((unsigned long)_data_lma != (unsigned long)_data) {
+        if ((hdr->magic[0] == BOOT_LZ4_MAGIC0) && (hdr->magic[1] == BOOT_LZ4_MAGIC1) && (hdr->rawsize == size)) {
+            Boot_LZ4Decompress(_data, _edata, (const uint8_t *)(hdr + 1), hdr->lz4size);
+        } else {
+            for (i = 0; i < size / sizeof(unsigned long); i++) {
+                ((unsigned long *)_data)[i] = ((const unsigned long *)_data_lma)[i];
+            }
+        }
+    }
+    Boot_Zero(__bss_start, _end);
+    __RWMB();
+    __FENCE_I();
+    SystemBootSectionCycles = (unsigned long)(__get_rv_cycle() - start);
+}
+#endif
+
+#if defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1) && defined(SMP_LOCAL_STACK) && (SMP_LOCAL_STACK == 1)
+#if defined(RUNMODE_DLM_EN) && (RUNMODE_DLM_EN == 0)
+#error "SMP_LOCAL_STACK requires DLM, it can't be disabled by RUNMODE_DLM_EN=0"
+#endif
+unsigned long SMP_LocalStackTop(void) __attribute__((section(".text.init")));
+/**
+ * \brief Get stack top of current hart in its DLM
+ * \details
+ * When SMP_LOCAL_STACK=1, the startup code calls this function in each hart after sp is set
+ * to its stack in shared memory, and moves sp to the returned top if it is not 0, so stack
+ * and interrupt frames of each hart are in its own DLM, and not across the interconnect.
+ * The per-cpu area of the hart is placed at the bottom of DLM too, see \ref PER_CPU.
+ *
+ * - DOWNLOAD mode must not place sections in DLM, such as ddr or sram mode
+ * - DLM of a hart may not be accessible by other harts, so data on stack, such as buffers
+ *   and wait requests, must not be shared with them, unless each DLM has its own address
+ * - It falls back to the stack in shared memory when DLM is not present or not enabled
+ *
+ * Like \ref __sync_harts, it is placed in .text.init and must not call other functions.
+ * \return top of DLM, or 0 if DLM is not present or not enabled
+ */
+unsigned long SMP_LocalStackTop(void)
+{
+    unsigned long dlmctl, lmsize;
+
+    if ((__RV_CSR_READ(CSR_MCFG_INFO) & MCFG_INFO_DLM) == 0) {
+        return 0;
+    }
+    dlmctl = __RV_CSR_READ(CSR_MDLM_CTL);
+    // DLM size is 2^(lmsize - 1) KB
+    lmsize = (__RV_CSR_READ(CSR_MDCFG_INFO) & MDCFG_DLM_SIZE) >> 16;
+    if (((dlmctl & MDLM_CTL_DLM_EN) == 0) || (lmsize == 0)) {
+        return 0;
+    }
+    return (dlmctl & MDLM_CTL_DLM_BPA) + (1UL << (lmsize + 9));
+}
+#endif
 
 void __sync_harts(void) __attribute__((section(".text.init")));
 /**
@@ -728,6 +1570,11 @@ void __sync_harts(void) __attribute__((section(".text.init")));
  * section initialization is not ready, global variable
  * and static variable should be avoid to use in this function,
  * and avoid to call other functions
+ *
+ * When SMP_PARALLEL_BOOT=1, the startup code must call this function in all the harts
+ * without initializing .data and .bss sections, each hart enables its own I/D cache,
+ * then copy and zero its part of .data and .bss, the boot hart waits for all the
+ * other harts to finish their part, and release them all.
  */
 void __sync_harts(void)
 {
@@ -752,14 +1599,44 @@ void __sync_harts(void)
         while(1);
     }
     // Enable SMP
-    SMP_CTRLREG(smp_base, 0xc) = 0xFFFFFFFF;
-    // Enaable L2, disable cluster local memory
-    if (SMP_CTRLREG(smp_base, 0x4) & 0x1) {
-        SMP_CTRLREG(smp_base, 0x10) = 0x1;
-        SMP_CTRLREG(smp_base, 0xd8) = 0x0;
-    }
+    SMPCC_REG(smp_base, SMPCC_ENB_OFS) = 0xFFFFFFFF;
+    // Configure L2 and cluster local memory, default enable L2, disable cluster local memory
+    SMPCC_ConfigL2(smp_base, SMPCC_BOOT_L2_EN, SMPCC_BOOT_CLM_WAYMASK);
     __SMP_RWMB();
 
+#if defined(SMP_PARALLEL_BOOT) && (SMP_PARALLEL_BOOT == 1)
+    // Enable cache before initializing sections, it is enabled again in _premain_init
+#if defined(__ICACHE_PRESENT) && (__ICACHE_PRESENT == 1)
+    if (ICachePresent()) {
+        EnableICache();
+    }
+#endif
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1)
+    if (DCachePresent()) {
+        EnableDCache();
+    }
+#endif
+    SMP_Boot_SectionInit(tmr_hartid);
+    __SMP_RWMB();
+    if (hartid == BOOT_HARTID) { // boot hart
+        // wait for all the other harts to finish their part, msip is cleared after reset
+        for (unsigned long i = 0; i < SMP_CPU_CNT; i ++) {
+            if (i != tmr_hartid) {
+                while (CLINT_MSIP(clint_base, i) == 0);
+            }
+        }
+        for (int i = 0; i < SMP_CPU_CNT; i ++) {
+            CLINT_MSIP(clint_base, i) = 0;
+        }
+        __SMP_RWMB();
+        __FENCE_I();
+    } else {
+        CLINT_MSIP(clint_base, tmr_hartid) = 1;
+        __SMP_RWMB();
+        while (CLINT_MSIP(clint_base, tmr_hartid) == 1);
+        __FENCE_I();
+    }
+#else
     // pre-condition: interrupt must be disabled, this is done before calling this function
     // BOOT_HARTID is defined <Device.h>
     if (hartid == BOOT_HARTID) { // boot hart
@@ -776,6 +1653,184 @@ void __sync_harts(void)
         while (CLINT_MSIP(clint_base, tmr_hartid) == 1);
     }
 #endif
+#endif
+}
+
+/**
+ * \brief Predefined tuning profiles
+ * \details
+ * - performance: all supported features enabled
+ * - nospec: load speculation disabled, for workloads touching device memory or side channel sensitive code
+ * - nobpu: branch prediction disabled, for deterministic timing of branch heavy code
+ * - uncached: L1 caches disabled, for worst case timing analysis
+ */
+const SystemTuning_Type SystemTuningProfiles[] = {
+    {"performance", TUNING_ALL, TUNING_ALL},
+    {"nospec", TUNING_LDSPEC, 0},
+    {"nobpu", TUNING_BPU, 0},
+    {"uncached", TUNING_ICACHE | TUNING_DCACHE, 0},
+    {NULL, 0, 0},
+};
+
+/* Check whether mmisc_ctl bit is implemented by writing it and reading back */
+static uint32_t Tuning_MiscBitPresent(rv_csr_t bit)
+{
+    rv_csr_t old = __RV_CSR_READ(CSR_MMISC_CTL);
+    rv_csr_t val;
+
+    __RV_CSR_WRITE(CSR_MMISC_CTL, old ^ bit);
+    val = __RV_CSR_READ(CSR_MMISC_CTL);
+    __RV_CSR_WRITE(CSR_MMISC_CTL, old);
+    return ((val ^ old) & bit) ? 1 : 0;
+}
+
+/**
+ * \brief  Get features which can be switched at runtime on current hart
+ * \return bit mask of TUNING_xxx
+ */
+uint32_t SystemTuning_Supported(void)
+{
+    uint32_t supported = 0;
+
+    if (Tuning_MiscBitPresent(MMISC_CTL_BPU)) {
+        supported |= TUNING_BPU;
+    }
+    if (Tuning_MiscBitPresent(MMISC_CTL_LDSPEC_ENABLE)) {
+        supported |= TUNING_LDSPEC;
+    }
+#if defined(__ICACHE_PRESENT) && (__ICACHE_PRESENT == 1)
+    if (ICachePresent()) {
+        supported |= TUNING_ICACHE;
+    }
+#endif
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1) && defined(__CCM_PRESENT) && (__CCM_PRESENT == 1)
+    // dirty lines must be written back by CCM before data cache is disabled
+    if (DCachePresent()) {
+        supported |= TUNING_DCACHE;
+    }
+#endif
+#if defined(TUNING_L2_RUNTIME) && (TUNING_L2_RUNTIME == 1) && defined(__SMPCC_PRESENT) && (__SMPCC_PRESENT == 1)
+    if (SMPCC_L2Present(__SMPCC_BASEADDR)) {
+        supported |= TUNING_L2;
+    }
+#endif
+    return supported;
+}
+
+/**
+ * \brief  Get enabled features of current hart
+ * \return bit mask of TUNING_xxx
+ */
+uint32_t SystemTuning_Get(void)
+{
+    rv_csr_t misc = __RV_CSR_READ(CSR_MMISC_CTL);
+    uint32_t enabled = 0;
+
+    if (misc & MMISC_CTL_BPU) {
+        enabled |= TUNING_BPU;
+    }
+    if (misc & MMISC_CTL_LDSPEC_ENABLE) {
+        enabled |= TUNING_LDSPEC;
+    }
+#if (defined(__ICACHE_PRESENT) && (__ICACHE_PRESENT == 1)) || (defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1))
+    if (__RV_CSR_READ(CSR_MCACHE_CTL) & MCACHE_CTL_IC_EN) {
+        enabled |= TUNING_ICACHE;
+    }
+    if (__RV_CSR_READ(CSR_MCACHE_CTL) & MCACHE_CTL_DC_EN) {
+        enabled |= TUNING_DCACHE;
+    }
+#endif
+#if defined(__SMPCC_PRESENT) && (__SMPCC_PRESENT == 1)
+    if (SMPCC_GetL2Config(__SMPCC_BASEADDR, NULL) == 1) {
+        enabled |= TUNING_L2;
+    }
+#endif
+    return enabled;
+}
+
+/**
+ * \brief  Enable or disable features of current hart
+ * \details
+ * The features in mask are enabled if they are set in enable, otherwise disabled, the
+ * unsupported features in mask are ignored.
+ * \param [in]  mask        features to change, bit mask of TUNING_xxx
+ * \param [in]  enable      features to enable, bit mask of TUNING_xxx
+ * \return      features actually changed
+ * \remarks
+ * - BPU, load speculation and L1 caches are per hart, call it on each hart to tune all harts
+ */
+uint32_t SystemTuning_Set(uint32_t mask, uint32_t enable)
+{
+    uint32_t old = SystemTuning_Get();
+    uint32_t change = (old ^ enable) & mask & SystemTuning_Supported();
+    uint32_t on = change & enable;
+    uint32_t off = change & ~enable;
+
+    if (change == 0) {
+        return 0;
+    }
+    if (on & TUNING_BPU) {
+        __RV_CSR_SET(CSR_MMISC_CTL, MMISC_CTL_BPU);
+    } else if (off & TUNING_BPU) {
+        __RV_CSR_CLEAR(CSR_MMISC_CTL, MMISC_CTL_BPU);
+    }
+    if (on & TUNING_LDSPEC) {
+        __RV_CSR_SET(CSR_MMISC_CTL, MMISC_CTL_LDSPEC_ENABLE);
+    } else if (off & TUNING_LDSPEC) {
+        __RV_CSR_CLEAR(CSR_MMISC_CTL, MMISC_CTL_LDSPEC_ENABLE);
+    }
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1) && defined(__CCM_PRESENT) && (__CCM_PRESENT == 1)
+    // write back dirty lines before data cache or the L2 behind it is disabled
+    if (off & (TUNING_DCACHE | TUNING_L2)) {
+        MFlushInvalDCache();
+    }
+    if (off & TUNING_DCACHE) {
+        DisableDCache();
+    }
+#endif
+#if defined(__SMPCC_PRESENT) && (__SMPCC_PRESENT == 1)
+    if (change & TUNING_L2) {
+        uint32_t clm_waymask = 0;
+
+        SMPCC_GetL2Config(__SMPCC_BASEADDR, &clm_waymask);
+        SMPCC_ConfigL2(__SMPCC_BASEADDR, (on & TUNING_L2) ? 1 : 0, clm_waymask);
+    }
+#endif
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1) && defined(__CCM_PRESENT) && (__CCM_PRESENT == 1)
+    if (on & TUNING_DCACHE) {
+        // lines may be stale since they were not updated when data cache was disabled
+        MInvalDCache();
+        EnableDCache();
+    }
+#endif
+#if defined(__ICACHE_PRESENT) && (__ICACHE_PRESENT == 1)
+    if (on & TUNING_ICACHE) {
+        EnableICache();
+    } else if (off & TUNING_ICACHE) {
+        DisableICache();
+    }
+#endif
+    __RWMB();
+    __FENCE_I();
+    return change;
+}
+
+/**
+ * \brief  Apply a profile of \ref SystemTuningProfiles by name
+ * \param [in]  name        profile name
+ * \return      -1 if profile not found, otherwise 0
+ */
+int32_t SystemTuning_Apply(const char *name)
+{
+    const SystemTuning_Type *profile;
+
+    for (profile = SystemTuningProfiles; (name != NULL) && (profile->name != NULL); profile++) {
+        if (strcmp(profile->name, name) == 0) {
+            SystemTuning_Set(profile->mask, profile->enable);
+            return 0;
+        }
+    }
+    return -1;
 }
 
 /**
@@ -786,6 +1841,96 @@ static void Trap_Init(void)
 {
 }
 
+#if defined(NUCLEI_UART_BUFFERED) && (NUCLEI_UART_BUFFERED == 1)
+#ifndef SOC_DEBUG_UART_IRQn
+#define SOC_DEBUG_UART_IRQn         UART0_IRQn
+#endif
+/* Ring sizes of debug uart, must be power of 2 */
+#ifndef UART_BUFFERED_TX_SIZE
+#define UART_BUFFERED_TX_SIZE       1024
+#endif
+#ifndef UART_BUFFERED_RX_SIZE
+#define UART_BUFFERED_RX_SIZE       64
+#endif
+
+UART_BUFFERED_Type SystemDebugUART;
+static uint8_t SystemDebugUARTTxBuf[UART_BUFFERED_TX_SIZE];
+static uint8_t SystemDebugUARTRxBuf[UART_BUFFERED_RX_SIZE];
+
+static void SystemDebugUART_IRQHandler(void)
+{
+    uart_buffered_irq_handler(&SystemDebugUART);
+}
+
+/**
+ * \brief switch debug uart to interrupt driven mode
+ * \details
+ * printf only copies data into tx ring after it, the lowest level uart interrupt moves it
+ * into uart tx fifo, so global interrupt must be enabled to drain the ring, output written
+ * with interrupts disabled is drained by polling when the ring is full, and at exit
+ */
+static void SystemDebugUART_Init(void)
+{
+    uart_buffered_init(&SystemDebugUART, SOC_DEBUG_UART, SystemDebugUARTTxBuf, UART_BUFFERED_TX_SIZE,
+                       SystemDebugUARTRxBuf, UART_BUFFERED_RX_SIZE);
+    ECLIC_Register_IRQ(SOC_DEBUG_UART_IRQn, ECLIC_NON_VECTOR_INTERRUPT, ECLIC_LEVEL_TRIGGER, 0, 0,
+                       (void *)SystemDebugUART_IRQHandler);
+}
+#endif
+
+#if defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1) && __PERCPU_TLS
+/*
+ * Thread local template of gcc linker script, .tdata is initialized with .data,
+ * per-cpu variables of each hart are its copy in PerCPU_Area, reached by tp
+ */
+extern uint8_t __tdata_start[] __WEAK;
+extern uint8_t __tdata_end[] __WEAK;
+extern uint8_t __tbss_end[] __WEAK;
+
+#ifdef __SMP_CACHELINE_SIZE
+#define PERCPU_ALIGN                __SMP_CACHELINE_SIZE
+#else
+#define PERCPU_ALIGN                64
+#endif
+/* The areas of harts never share a cache line */
+#define PERCPU_AREA_STRIDE          ((__PERCPU_AREA_SIZE + PERCPU_ALIGN - 1) & ~(PERCPU_ALIGN - 1))
+
+static uint8_t PerCPU_Area[SMP_CPU_CNT][PERCPU_AREA_STRIDE] __attribute__((aligned(PERCPU_ALIGN)));
+unsigned long PerCPU_Base[SMP_CPU_CNT];
+/* Size of thread local template, larger than __PERCPU_AREA_SIZE is reported by boot hart */
+static unsigned long PerCPU_Size;
+
+/* Copy thread local template to per-cpu area of hart hartidx, and point tp to it */
+static void PerCPU_Init(unsigned long hartidx)
+{
+    unsigned long init = (unsigned long)(__tdata_end - __tdata_start);
+    unsigned long size = (unsigned long)(__tbss_end - __tdata_start);
+    uint8_t *area;
+    unsigned long i;
+
+    PerCPU_Size = size;
+    if ((hartidx >= SMP_CPU_CNT) || (size > PERCPU_AREA_STRIDE)) {
+        return;
+    }
+    area = PerCPU_Area[hartidx];
+#if defined(SMP_LOCAL_STACK) && (SMP_LOCAL_STACK == 1)
+    // bottom of DLM, below the stack at its top
+    if (SMP_LocalStackTop() != 0) {
+        area = (uint8_t *)(__RV_CSR_READ(CSR_MDLM_CTL) & MDLM_CTL_DLM_BPA);
+    }
+#endif
+    for (i = 0; i < init; i++) {
+        area[i] = __tdata_start[i];
+    }
+    for (; i < size; i++) {
+        area[i] = 0;
+    }
+    PerCPU_Base[hartidx] = (unsigned long)area;
+    __RWMB();
+    __set_percpu_base((unsigned long)area);
+}
+#endif
+
 /**
  * \brief early init function before main
  * \details
@@ -799,6 +1944,14 @@ void _premain_init(void)
     // TODO to make it possible for configurable boot hartid
     unsigned long hartid = __get_hart_id();
     unsigned long mcfginfo = __RV_CSR_READ(CSR_MCFG_INFO);
+#if defined(__CCM_PRESENT) && (__CCM_PRESENT == 1) && !defined(__ICCRISCV__)
+    unsigned long cachelock[2] = {CCM_OP_SUCCESS, CCM_OP_SUCCESS};
+#endif
+
+#if defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1) && __PERCPU_TLS
+    // first of all, any code after it may use per-cpu variables
+    PerCPU_Init(__get_hart_index());
+#endif
 
     /* TODO: Add your own initialization code here, called before main */
     // TODO This code controlled by macros RUNMODE_* are only used internally by Nuclei
@@ -826,6 +1979,11 @@ void _premain_init(void)
     }
 #endif
 
+#ifndef __ICCRISCV__
+    // done after ILM is enabled, functions called before here must not be hot ones in ILM
+    HotILM_Init();
+#endif
+
 #if defined(RUNMODE_LDSPEC_EN)
 #if RUNMODE_LDSPEC_EN == 1
     __RV_CSR_SET(CSR_MMISC_CTL, MMISC_CTL_LDSPEC_ENABLE);
@@ -854,6 +2012,14 @@ void _premain_init(void)
     __RWMB();
     __FENCE_I();
 
+#if defined(__CCM_PRESENT) && (__CCM_PRESENT == 1)
+    /* Cache geometry is the same for all the harts */
+    Cache_Info_Init();
+#ifndef __ICCRISCV__
+    Cache_Lock_Init(cachelock);
+#endif
+#endif
+
     // BOOT_HARTID is defined <Device.h> and also controlled by BOOT_HARTID in conf/evalsoc/build.mk
 #ifndef CFG_IREGION_BASE_ADDR       // Need to probe the cpu iregion base address
     if (hartid == BOOT_HARTID) { // only done in boot hart
@@ -866,42 +2032,43 @@ void _premain_init(void)
 #endif
 
 #if defined(RUNMODE_L2_EN)
-    if ((mcfginfo & (0x1 << 11)) && SMP_CTRLREG(__SMPCC_BASEADDR, 0x4) & 0x1 ) { // L2 Cache present
+    if (mcfginfo & (0x1 << 11)) { // L2 Cache present
 #if RUNMODE_L2_EN == 1
         // Enable L2, disable cluster local memory
-        SMP_CTRLREG(__SMPCC_BASEADDR, 0x10) = 0x1;
-        SMP_CTRLREG(__SMPCC_BASEADDR, 0xd8) = 0x0;
-        __SMP_RWMB();
+        SMPCC_ConfigL2(__SMPCC_BASEADDR, 1, 0);
 #else
-        // Disable L2, enable cluster local memory
-        SMP_CTRLREG(__SMPCC_BASEADDR, 0x10) = 0x0;
-        // use as clm or cache, when l2 disable, the affect to ddr is the same, l2 is really disabled
-        SMP_CTRLREG(__SMPCC_BASEADDR, 0xd8) = 0;//0xFFFFFFFF;
-        __SMP_RWMB();
+        // Disable L2, use as clm or cache, when l2 disable, the affect to ddr is the same, l2 is really disabled
+        SMPCC_ConfigL2(__SMPCC_BASEADDR, 0, 0);
 #endif
     }
 #endif
 
-#if defined(RUNMODE_BPU_EN)
-#if RUNMODE_BPU_EN == 1
-    __RV_CSR_SET(CSR_MMISC_CTL, MMISC_CTL_BPU);
-#else
-    __RV_CSR_CLEAR(CSR_MMISC_CTL, MMISC_CTL_BPU);
-#endif
-#endif
-
     if (hartid == BOOT_HARTID) { // only required for boot hartid
         // TODO implement get_cpu_freq function to get real cpu clock freq in HZ or directly give the real cpu HZ
         // TODO you can directly give the correct cpu frequency here, if you know it without call get_cpu_freq function
         SystemCoreClock = get_cpu_freq();
         uart_init(SOC_DEBUG_UART, 115200);
-        /* Display banner after UART initialized */
+        /* Display banner after UART initialized, console is muted in simulation summary mode */
+#if !defined(SIMULATION_SUMMARY) || (SIMULATION_SUMMARY != 1)
         SystemBannerPrint();
+#endif
+#if defined(SMP_CPU_CNT) && (SMP_CPU_CNT > 1) && __PERCPU_TLS
+        if (PerCPU_Size > PERCPU_AREA_STRIDE) {
+            printf("ERROR: per-cpu variables need %lu bytes, larger than __PERCPU_AREA_SIZE\n", PerCPU_Size);
+            while (1);
+        }
+#endif
+#if defined(__CCM_PRESENT) && (__CCM_PRESENT == 1) && !defined(__ICCRISCV__)
+        Cache_Lock_Report(cachelock);
+#endif
         /* Initialize exception default handlers */
         Exception_Init();
         /* Interrupt initialization */
         Interrupt_Init();
         Trap_Init();
+#if defined(NUCLEI_UART_BUFFERED) && (NUCLEI_UART_BUFFERED == 1)
+        SystemDebugUART_Init();
+#endif
         // TODO: internal usage for Nuclei
 #ifdef RUNMODE_CONTROL
         NSDK_DEBUG("Current RUNMODE=%s, ilm:%d, dlm %d, icache %d, dcache %d, ccm %d\n", \
@@ -917,6 +2084,14 @@ void _premain_init(void)
             NSDK_DEBUG("CSR: MCACHE_CTL 0x%x\n", __RV_CSR_READ(CSR_MCACHE_CTL));
         }
         NSDK_DEBUG("CSR: MMISC_CTL 0x%x\n", __RV_CSR_READ(CSR_MMISC_CTL));
+#endif
+        if (SystemDispatchInit != NULL) {
+            SystemDispatchInit();
+        }
+        // cycle counter runs from reset, unless it is inhibited by mcountinhibit
+        SystemBootCycles = __get_rv_cycle();
+#if defined(SIMULATION_SUMMARY) && (SIMULATION_SUMMARY == 1)
+        SimuSummary_Start();
 #endif
     } else {
         /* Interrupt initialization */
@@ -937,6 +2112,9 @@ void _postmain_fini(int status)
 {
     /* TODO: Add your own finishing code here, called after main */
     extern void simulation_exit(int status);
+#if defined(NUCLEI_UART_BUFFERED) && (NUCLEI_UART_BUFFERED == 1)
+    uart_buffered_flush(&SystemDebugUART);
+#endif
     simulation_exit(status);
 }
 
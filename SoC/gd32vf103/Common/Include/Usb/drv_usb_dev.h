@@ -96,6 +96,10 @@ typedef struct {
     uint32_t       remain_len;                                          /*!< remain packet lenth */
 
     uint32_t       dma_addr;                                            /*!< DMA address */
+
+    uint8_t*       dbuf[2];                                             /*!< OUT double buffers, NULL when not double buffered */
+    uint8_t        dbuf_idx;                                            /*!< double buffer being received */
+    uint32_t       dbuf_count;                                          /*!< received length of the other double buffer */
 } usb_transc;
 
 typedef struct _usb_core_driver usb_dev;
@@ -39,6 +39,7 @@ OF SUCH DAMAGE.
 
 typedef struct _usbh_int_cb {
     uint8_t (*SOF)(usb_core_driver* pudev);
+    uint8_t (*pipe_done)(usb_core_driver* pudev, uint8_t pp_num);
 } usbh_int_cb;
 
 extern usbh_int_cb* usbh_int_fop;
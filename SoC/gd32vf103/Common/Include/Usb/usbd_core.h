@@ -75,6 +75,12 @@ uint32_t usbd_ep_clear(usb_core_driver* udev, uint8_t ep_addr);
 /* endpoint prepare to receive data */
 uint32_t usbd_ep_recev(usb_core_driver* udev, uint8_t ep_addr, uint8_t* pbuf, uint16_t len);
 
+/* endpoint prepare to receive data to two buffers in turn */
+uint32_t usbd_ep_recev_dbuf(usb_core_driver* udev, uint8_t ep_addr, uint8_t* pbuf0, uint8_t* pbuf1, uint16_t len);
+
+/* get the buffer of the last received data of a double buffered endpoint */
+uint8_t* usbd_dbuf_get(usb_core_driver* udev, uint8_t ep_num);
+
 /* endpoint prepare to transmit data */
 uint32_t usbd_ep_send(usb_core_driver* udev, uint8_t ep_addr, uint8_t* pbuf, uint16_t len);
 
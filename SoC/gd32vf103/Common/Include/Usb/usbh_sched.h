@@ -0,0 +1,63 @@
+/*!
+    \file  usbh_sched.h
+    \brief USB host mode pipe scheduler header file
+*/
+
+#ifndef __USBH_SCHED_H
+#define __USBH_SCHED_H
+
+#include "usbh_core.h"
+
+/*
+    The pipe scheduler runs transfers of several pipes at the same time from the
+    channel and SOF interrupts, instead of one transfer at a time polled by the
+    class state machine.
+
+    - each pipe has a queue of URBs, an URB is started when the one before it ends
+      and its callback is called in interrupt when it ends
+    - an URB longer than one channel transfer is split into channel transfers of
+      up to HC_MAX_PACKET_COUNT packets, a short packet ends an IN URB
+    - pipes with an interval (interrupt and isochronous) start one transfer every
+      interval frames, and are started first at each SOF so they get the start of
+      the frame, NAKed non-periodic OUT transfers are retried at the next SOF
+
+    Control transfers of enumeration keep using usbh_ctl_handler(), a pipe must
+    be either used by the scheduler or by usbh_data_send()/usbh_data_recev().
+    IN URB buffers must hold len rounded up to the max packet size.
+*/
+
+struct _usbh_urb;
+
+/* completion callback of an URB, called in interrupt */
+typedef void (*usbh_urb_cb)(usb_core_driver* pudev, struct _usbh_urb* urb, void* arg);
+
+/* USB request block */
+typedef struct _usbh_urb {
+    struct _usbh_urb*    next;
+    uint8_t*             buf;                                   /*!< data buffer */
+    uint32_t             len;                                   /*!< bytes to transfer */
+    uint32_t             count;                                 /*!< bytes transferred */
+    usbh_urb_cb          cb;                                    /*!< completion callback, can be NULL */
+    void*                arg;
+    __IO usb_urb_state   state;                                 /*!< URB_IDLE until it ends, URB_DONE, URB_STALL or URB_ERROR */
+} usbh_urb;
+
+/* set the interval in frames of a pipe, 0 for control and bulk pipes */
+void usbh_sched_pipe_config(usb_core_driver* pudev, uint8_t pp_num, uint8_t interval);
+
+/* queue an URB on a pipe */
+usbh_status usbh_sched_submit(usb_core_driver* pudev, uint8_t pp_num, usbh_urb* urb);
+
+/* end all URBs of a pipe with URB_ERROR, callbacks must not submit again on URB_ERROR */
+void usbh_sched_cancel(usb_core_driver* pudev, uint8_t pp_num);
+
+/* end all URBs of all pipes with URB_ERROR */
+void usbh_sched_reset(usb_core_driver* pudev);
+
+/* start the transfers due in this frame, called from the SOF interrupt */
+void usbh_sched_sof(usb_core_driver* pudev);
+
+/* handle the end of a transfer, called from the channel interrupt */
+uint8_t usbh_sched_pipe_done(usb_core_driver* pudev, uint8_t pp_num);
+
+#endif /* __USBH_SCHED_H */
@@ -78,6 +78,55 @@ extern void SystemCoreClockUpdate(void);
  */
 extern void system_clock_config(void);
 
+/**
+ * \brief Performance point of system clock, see \ref SystemPerf_Set
+ */
+typedef enum SystemPerf {
+    SYSTEM_PERF_MAX = 0,            /*!< clock set up by SystemInit */
+    SYSTEM_PERF_HALF,               /*!< half of max clock */
+    SYSTEM_PERF_LOW,                /*!< 1/8 of max clock */
+    SYSTEM_PERF_IRC,                /*!< IRC8M */
+    SYSTEM_PERF_NUM
+} SystemPerf_Type;
+
+#define SYSTEM_CLOCK_PRE_CHANGE         0       /*!< notified before clock change, new_freq is 0 */
+#define SYSTEM_CLOCK_POST_CHANGE        1       /*!< notified after clock change */
+
+/* max number of clock change notifiers */
+#ifndef SYSTEM_CLOCK_NOTIFIER_MAX
+#define SYSTEM_CLOCK_NOTIFIER_MAX       8
+#endif
+
+/* baudrate of SOC_DEBUG_UART set again after clock change */
+#ifndef SYSTEM_DEBUG_UART_BAUDRATE
+#define SYSTEM_DEBUG_UART_BAUDRATE      115200U
+#endif
+
+/**
+ * \brief Clock change notifier, called with interrupts disabled
+ */
+typedef void (*SystemClock_Notifier_Type)(uint32_t event, uint32_t old_freq, uint32_t new_freq);
+
+/**
+ * \brief Register a clock change notifier
+ */
+extern int32_t SystemClock_RegisterNotifier(SystemClock_Notifier_Type notifier);
+
+/**
+ * \brief Unregister a clock change notifier
+ */
+extern void SystemClock_UnregisterNotifier(SystemClock_Notifier_Type notifier);
+
+/**
+ * \brief Switch system clock to a performance point
+ */
+extern uint32_t SystemPerf_Set(SystemPerf_Type perf);
+
+/**
+ * \brief Get current performance point
+ */
+extern SystemPerf_Type SystemPerf_Get(void);
+
 /**
  * \brief Dump Exception Frame
  */
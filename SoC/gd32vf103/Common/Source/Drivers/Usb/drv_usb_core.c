@@ -247,10 +247,31 @@ usb_status usb_txfifo_write(usb_core_regs* usb_regs,
 
     __IO uint32_t* fifo = usb_regs->DFIFO[fifo_num];
 
-    while (word_count-- > 0) {
-        *fifo = *((uint32_t*)src_buf);
+    if (0U == ((uint32_t)src_buf & 3U)) {
+        uint32_t* src = (uint32_t*)src_buf;
+
+        /* word aligned buffer, four words per loop */
+        while (word_count >= 4U) {
+            *fifo = src[0];
+            *fifo = src[1];
+            *fifo = src[2];
+            *fifo = src[3];
+
+            src += 4U;
+            word_count -= 4U;
+        }
 
-        src_buf += 4U;
+        while (word_count-- > 0) {
+            *fifo = *src++;
+        }
+    } else {
+        /* unaligned buffer, assemble the words from bytes, the core has no misaligned access */
+        while (word_count-- > 0) {
+            *fifo = (uint32_t)src_buf[0] | ((uint32_t)src_buf[1] << 8) | \
+                    ((uint32_t)src_buf[2] << 16) | ((uint32_t)src_buf[3] << 24);
+
+            src_buf += 4U;
+        }
     }
 
     return USB_OK;
@@ -266,14 +287,54 @@ usb_status usb_txfifo_write(usb_core_regs* usb_regs,
 */
 void* usb_rxfifo_read(usb_core_regs* usb_regs, uint8_t* dest_buf, uint16_t byte_count)
 {
-    uint32_t word_count = (byte_count + 3U) / 4U;
+    uint32_t word_count = byte_count / 4U;
+    uint32_t remain = byte_count & 3U;
+    uint32_t data = 0U;
 
     __IO uint32_t* fifo = usb_regs->DFIFO[0];
 
-    while (word_count-- > 0) {
-        *(uint32_t*)dest_buf = *fifo;
+    if (0U == ((uint32_t)dest_buf & 3U)) {
+        uint32_t* dest = (uint32_t*)dest_buf;
+
+        /* word aligned buffer, four words per loop */
+        while (word_count >= 4U) {
+            dest[0] = *fifo;
+            dest[1] = *fifo;
+            dest[2] = *fifo;
+            dest[3] = *fifo;
+
+            dest += 4U;
+            word_count -= 4U;
+        }
+
+        while (word_count-- > 0) {
+            *dest++ = *fifo;
+        }
+
+        dest_buf = (uint8_t*)dest;
+    } else {
+        /* unaligned buffer, store the words by bytes */
+        while (word_count-- > 0) {
+            data = *fifo;
+
+            dest_buf[0] = (uint8_t)data;
+            dest_buf[1] = (uint8_t)(data >> 8);
+            dest_buf[2] = (uint8_t)(data >> 16);
+            dest_buf[3] = (uint8_t)(data >> 24);
+
+            dest_buf += 4U;
+        }
+    }
+
+    /* last partial word, only byte_count bytes are written to the buffer */
+    if (remain > 0U) {
+        data = *fifo;
 
-        dest_buf += 4U;
+        while (remain-- > 0U) {
+            *dest_buf++ = (uint8_t)data;
+
+            data >>= 8;
+        }
     }
 
     return ((void*)dest_buf);
@@ -564,7 +564,8 @@ static uint32_t usbd_emptytxfifo_write(usb_core_driver* udev, uint32_t ep_num)
 
     word_count = (len + 3) / 4;
 
-    while (((udev->regs.er_in[ep_num]->DIEPTFSTAT & DIEPTFSTAT_IEPTFS) > word_count) && \
+    /* load as many packets of a multi-packet transfer as the FIFO can take */
+    while (((udev->regs.er_in[ep_num]->DIEPTFSTAT & DIEPTFSTAT_IEPTFS) >= word_count) && \
            (transc->xfer_count < transc->xfer_len)) {
         len = transc->xfer_len - transc->xfer_count;
 
@@ -284,6 +284,8 @@ uint32_t usbh_int_pipe_out(usb_core_driver* pudev, uint32_t pp_num)
 
     uint32_t intr_pp = pp_reg->HCHINTF & pp_reg->HCHINTEN;
 
+    uint8_t pp_done = 0U;
+
     if (intr_pp & HCHINTF_ACK) {
         pp_reg->HCHINTF = HCHINTF_ACK;
     } else if (intr_pp & HCHINTF_STALL) {
@@ -345,6 +347,13 @@ uint32_t usbh_int_pipe_out(usb_core_driver* pudev, uint32_t pp_num)
         }
 
         pp_reg->HCHINTF = HCHINTF_CH;
+
+        pp_done = 1U;
+    }
+
+    /* inform the pipe scheduler that the transfer ends */
+    if ((0U != pp_done) && (NULL != usbh_int_fop->pipe_done)) {
+        usbh_int_fop->pipe_done(pudev, pp_num);
     }
 
     return 1;
@@ -367,6 +376,8 @@ uint32_t usbh_int_pipe_in(usb_core_driver* pudev, uint32_t pp_num)
 
     uint8_t ep_type = (pp_reg->HCHCTL & HCHCTL_EPTYPE) >> 18U;
 
+    uint8_t pp_done = 0U;
+
     if (intr_pp & HCHINTF_ACK) {
         pp_reg->HCHINTF = HCHINTF_ACK;
     } else if (intr_pp & HCHINTF_STALL) {
@@ -405,6 +416,8 @@ uint32_t usbh_int_pipe_in(usb_core_driver* pudev, uint32_t pp_num)
             case USB_EPTYPE_INTR:
                 pp_reg->HCHCTL |= HCHCTL_ODDFRM;
                 pp->urb_state = URB_DONE;
+
+                pp_done = 1U;
                 break;
 
             default:
@@ -431,11 +444,17 @@ uint32_t usbh_int_pipe_in(usb_core_driver* pudev, uint32_t pp_num)
             default:
                 if (USB_EPTYPE_INTR == ep_type) {
                     pp->data_toggle_in ^= 1U;
+
+                    if (PIPE_NAK == pp->pp_status) {
+                        pp->urb_state = URB_NOTREADY;
+                    }
                 }
                 break;
         }
 
         pp_reg->HCHINTF = HCHINTF_CH;
+
+        pp_done = 1U;
     } else if (intr_pp & HCHINTF_BBER) {
         pp->err_count++;
         usb_pp_halt(pudev, pp_num, HCHINTF_BBER, PIPE_TRACERR);
@@ -462,6 +481,11 @@ uint32_t usbh_int_pipe_in(usb_core_driver* pudev, uint32_t pp_num)
         pp_reg->HCHINTF = HCHINTF_NAK;
     }
 
+    /* inform the pipe scheduler that the transfer ends */
+    if ((0U != pp_done) && (NULL != usbh_int_fop->pipe_done)) {
+        usbh_int_fop->pipe_done(pudev, pp_num);
+    }
+
     return 1;
 }
 
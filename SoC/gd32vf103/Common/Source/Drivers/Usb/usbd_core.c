@@ -156,6 +156,7 @@ uint32_t usbd_ep_recev(usb_core_driver* udev, uint8_t ep_addr, uint8_t* pbuf, ui
     transc->xfer_buf = pbuf;
     transc->xfer_len = len;
     transc->xfer_count = 0;
+    transc->dbuf[0] = NULL;
 
     if (USB_USE_DMA == udev->bp.transfer_mode) {
         transc->dma_addr = (uint32_t)pbuf;
@@ -167,6 +168,52 @@ uint32_t usbd_ep_recev(usb_core_driver* udev, uint8_t ep_addr, uint8_t* pbuf, ui
     return 0;
 }
 
+/*!
+    \brief      endpoint prepare to receive data to two buffers in turn
+    \param[in]  udev: pointer to usb core instance
+    \param[in]  ep_addr: endpoint address
+                  in this parameter:
+                    bit0..bit6: endpoint number (1..7)
+                    bit7: endpoint direction which can be IN(1) or OUT(0)
+    \param[in]  pbuf0: first user buffer address pointer
+    \param[in]  pbuf1: second user buffer address pointer
+    \param[in]  len: length of each buffer
+    \param[out] none
+    \retval     none
+    \note       when a transfer completes the endpoint is armed with the other buffer before
+                the class data_out handler is called, so the host is not NAKed while the class
+                handles the data, the handler gets the buffer by usbd_dbuf_get() and the length
+                by usbd_rxcount_get() and must be done with it before the next transfer
+                completes, usbd_ep_recev() ends double buffering
+*/
+uint32_t usbd_ep_recev_dbuf(usb_core_driver* udev, uint8_t ep_addr, uint8_t* pbuf0, uint8_t* pbuf1, uint16_t len)
+{
+    usb_transc* transc = &udev->dev.transc_out[EP_ID(ep_addr)];
+
+    usbd_ep_recev(udev, ep_addr, pbuf0, len);
+
+    transc->dbuf[0] = pbuf0;
+    transc->dbuf[1] = pbuf1;
+    transc->dbuf_idx = 0U;
+    transc->dbuf_count = 0U;
+
+    return 0;
+}
+
+/*!
+    \brief      get the buffer of the last received data of a double buffered endpoint
+    \param[in]  udev: pointer to usb core instance
+    \param[in]  ep_num: endpoint identifier which is in (1..7)
+    \param[out] none
+    \retval     buffer address pointer
+*/
+uint8_t* usbd_dbuf_get(usb_core_driver* udev, uint8_t ep_num)
+{
+    usb_transc* transc = &udev->dev.transc_out[ep_num];
+
+    return transc->dbuf[transc->dbuf_idx ^ 1U];
+}
+
 /*!
     \brief      endpoint prepare to transmit data
     \param[in]  udev: pointer to USB core instance
@@ -294,7 +341,13 @@ void  usbd_addr_set(usb_core_driver* udev, uint8_t addr)
 */
 uint16_t  usbd_rxcount_get(usb_core_driver* udev, uint8_t ep_num)
 {
-    return udev->dev.transc_out[ep_num].xfer_count;
+    usb_transc* transc = &udev->dev.transc_out[ep_num];
+
+    if (NULL != transc->dbuf[0]) {
+        return transc->dbuf_count;
+    }
+
+    return transc->xfer_count;
 }
 
 /*!
@@ -196,6 +196,23 @@ uint8_t usbd_out_transc(usb_core_driver* udev, uint8_t ep_num)
                 break;
         }
     } else if ((udev->dev.class_core->data_out != NULL) && (udev->dev.cur_status == USBD_CONFIGURED)) {
+        usb_transc* transc = &udev->dev.transc_out[ep_num];
+
+        if (NULL != transc->dbuf[0]) {
+            /* double buffered, receive to the other buffer while the class handles this one */
+            transc->dbuf_count = transc->xfer_count;
+            transc->dbuf_idx ^= 1U;
+
+            transc->xfer_buf = transc->dbuf[transc->dbuf_idx];
+            transc->xfer_count = 0U;
+
+            if (USB_USE_DMA == udev->bp.transfer_mode) {
+                transc->dma_addr = (uint32_t)transc->xfer_buf;
+            }
+
+            usb_transc_outxfer(udev, transc);
+        }
+
         udev->dev.class_core->data_out(udev, ep_num);
     }
 
@@ -37,11 +37,13 @@ OF SUCH DAMAGE.
 #include "usbh_enum.h"
 #include "usbh_core.h"
 #include "drv_usbh_int.h"
+#include "usbh_sched.h"
 
 uint8_t usbh_sof(usb_core_driver* pudev);
 
 usbh_int_cb usbh_int_op = {
-    usbh_sof
+    usbh_sof,
+    usbh_sched_pipe_done
 };
 
 usbh_int_cb* usbh_int_fop = &usbh_int_op;
@@ -56,7 +58,9 @@ static usbh_status usbh_enum_task(usb_core_driver* pudev, usbh_host* puhost);
 */
 uint8_t usbh_sof(usb_core_driver* pudev)
 {
-    /* this callback could be used to implement a scheduler process */
+    /* start the scheduled transfers due in this frame */
+    usbh_sched_sof(pudev);
+
     return 0U;
 }
 
@@ -122,6 +126,9 @@ usbh_status usbh_deinit(usb_core_driver* pudev, usbh_host* puhost)
     usbh_pipe_free(pudev, puhost->control.pipe_in_num);
     usbh_pipe_free(pudev, puhost->control.pipe_out_num);
 
+    /* end the transfers queued for the removed device */
+    usbh_sched_reset(pudev);
+
     return USBH_OK;
 }
 
@@ -0,0 +1,306 @@
+/*!
+    \file  usbh_sched.c
+    \brief USB host mode pipe scheduler
+*/
+
+#include "drv_usb_hw.h"
+#include "usbh_pipe.h"
+#include "usbh_transc.h"
+#include "usbh_sched.h"
+
+typedef struct {
+    usbh_urb*   head;
+    usbh_urb*   tail;
+    uint32_t    chunk;                                          /*!< bytes of the running channel transfer */
+    uint8_t     interval;                                       /*!< frames between periodic transfers, 0 for non-periodic */
+    uint8_t     frames;                                         /*!< frames until the next periodic transfer */
+    uint8_t     active;                                         /*!< channel transfer running */
+    uint8_t     retry;                                          /*!< start again at the next SOF */
+} usbh_sched_pipe;
+
+static usbh_sched_pipe sched_pipe[HC_MAX];
+
+/*!
+    \brief      start the next channel transfer of the first URB of a pipe
+    \param[in]  pudev: pointer to usb core instance
+    \param[in]  pp_num: pipe number
+    \param[out] none
+    \retval     none
+*/
+static void usbh_sched_start(usb_core_driver* pudev, uint8_t pp_num)
+{
+    usbh_sched_pipe* sp = &sched_pipe[pp_num];
+    usb_pipe* pp = &pudev->host.pipe[pp_num];
+    usbh_urb* urb = sp->head;
+
+    uint32_t len = urb->len - urb->count;
+    uint32_t max_len = HC_MAX_PACKET_COUNT * (uint32_t)pp->ep.mps;
+
+    if (len > max_len) {
+        len = max_len;
+    }
+
+    sp->chunk = len;
+    sp->active = 1U;
+    sp->retry = 0U;
+
+    if (pp->ep.dir) {
+        usbh_data_recev(pudev, urb->buf + urb->count, pp_num, (uint16_t)len);
+    } else {
+        usbh_data_send(pudev, urb->buf + urb->count, pp_num, (uint16_t)len);
+    }
+}
+
+/*!
+    \brief      end the first URB of a pipe and start the next one
+    \param[in]  pudev: pointer to usb core instance
+    \param[in]  pp_num: pipe number
+    \param[in]  state: end state of the URB
+    \param[out] none
+    \retval     none
+*/
+static void usbh_sched_end(usb_core_driver* pudev, uint8_t pp_num, usb_urb_state state)
+{
+    usbh_sched_pipe* sp = &sched_pipe[pp_num];
+    usbh_urb* urb = sp->head;
+
+    sp->head = urb->next;
+
+    if (NULL == sp->head) {
+        sp->tail = NULL;
+    }
+
+    urb->next = NULL;
+    urb->state = state;
+
+    if (NULL != urb->cb) {
+        urb->cb(pudev, urb, urb->arg);
+    }
+
+    /* the callback may have started an URB it submitted */
+    if ((NULL != sp->head) && (0U == sp->interval) && (0U == sp->active)) {
+        usbh_sched_start(pudev, pp_num);
+    }
+}
+
+/*!
+    \brief      set the interval of a pipe
+    \param[in]  pudev: pointer to usb core instance
+    \param[in]  pp_num: pipe number
+    \param[in]  interval: frames between transfers of interrupt and isochronous pipes, 0 for control and bulk pipes
+    \param[out] none
+    \retval     none
+*/
+void usbh_sched_pipe_config(usb_core_driver* pudev, uint8_t pp_num, uint8_t interval)
+{
+    if (pp_num < HC_MAX) {
+        sched_pipe[pp_num].interval = interval;
+        sched_pipe[pp_num].frames = 0U;
+    }
+}
+
+/*!
+    \brief      queue an URB on a pipe
+    \param[in]  pudev: pointer to usb core instance
+    \param[in]  pp_num: pipe number
+    \param[in]  urb: URB with buf, len, cb and arg set
+    \param[out] none
+    \retval     operation status
+*/
+usbh_status usbh_sched_submit(usb_core_driver* pudev, uint8_t pp_num, usbh_urb* urb)
+{
+    usbh_sched_pipe* sp = NULL;
+    unsigned long mstatus;
+
+    if (pp_num >= HC_MAX) {
+        return USBH_FAIL;
+    }
+
+    sp = &sched_pipe[pp_num];
+
+    urb->next = NULL;
+    urb->count = 0U;
+    urb->state = URB_IDLE;
+
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+
+    if (NULL == sp->tail) {
+        sp->head = urb;
+    } else {
+        sp->tail->next = urb;
+    }
+
+    sp->tail = urb;
+
+    /* non-periodic pipes start at once, periodic ones at their frame */
+    if ((sp->head == urb) && (0U == sp->interval) && (0U == sp->active)) {
+        usbh_sched_start(pudev, pp_num);
+    }
+
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+
+    return USBH_OK;
+}
+
+/*!
+    \brief      end all URBs of a pipe with URB_ERROR
+    \param[in]  pudev: pointer to usb core instance
+    \param[in]  pp_num: pipe number
+    \param[out] none
+    \retval     none
+*/
+void usbh_sched_cancel(usb_core_driver* pudev, uint8_t pp_num)
+{
+    usbh_sched_pipe* sp = NULL;
+    unsigned long mstatus;
+
+    if (pp_num >= HC_MAX) {
+        return;
+    }
+
+    sp = &sched_pipe[pp_num];
+
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+
+    if (0U != sp->active) {
+        sp->active = 0U;
+
+        usb_pipe_halt(pudev, pp_num);
+    }
+
+    /* no URB of the pipe is started again from the callbacks */
+    sp->interval = 0U;
+    sp->retry = 0U;
+    sp->active = 1U;
+
+    while (NULL != sp->head) {
+        usbh_sched_end(pudev, pp_num, URB_ERROR);
+    }
+
+    sp->active = 0U;
+
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
+
+/*!
+    \brief      end all URBs of all pipes with URB_ERROR
+    \param[in]  pudev: pointer to usb core instance
+    \param[out] none
+    \retval     none
+*/
+void usbh_sched_reset(usb_core_driver* pudev)
+{
+    uint8_t i = 0U;
+
+    for (i = 0U; i < HC_MAX; i++) {
+        usbh_sched_cancel(pudev, i);
+    }
+}
+
+/*!
+    \brief      start the transfers due in this frame
+    \param[in]  pudev: pointer to usb core instance
+    \param[out] none
+    \retval     none
+*/
+void usbh_sched_sof(usb_core_driver* pudev)
+{
+    usbh_sched_pipe* sp = NULL;
+    uint8_t i = 0U;
+
+    /* periodic pipes first, they are due at a frame */
+    for (i = 0U; i < HC_MAX; i++) {
+        sp = &sched_pipe[i];
+
+        if (0U == sp->interval) {
+            continue;
+        }
+
+        if (sp->frames > 0U) {
+            sp->frames--;
+        }
+
+        if ((0U == sp->frames) && (NULL != sp->head) && (0U == sp->active)) {
+            sp->frames = sp->interval;
+
+            usbh_sched_start(pudev, i);
+        }
+    }
+
+    /* then non-periodic pipes which were NAKed */
+    for (i = 0U; i < HC_MAX; i++) {
+        sp = &sched_pipe[i];
+
+        if ((0U != sp->retry) && (NULL != sp->head) && (0U == sp->active)) {
+            usbh_sched_start(pudev, i);
+        }
+    }
+}
+
+/*!
+    \brief      handle the end of a channel transfer
+    \param[in]  pudev: pointer to usb core instance
+    \param[in]  pp_num: pipe number
+    \param[out] none
+    \retval     operation status
+*/
+uint8_t usbh_sched_pipe_done(usb_core_driver* pudev, uint8_t pp_num)
+{
+    usbh_sched_pipe* sp = NULL;
+    usb_pipe* pp = &pudev->host.pipe[pp_num];
+    usbh_urb* urb = NULL;
+
+    uint32_t len = 0U;
+
+    if (pp_num >= HC_MAX) {
+        return 0U;
+    }
+
+    sp = &sched_pipe[pp_num];
+    urb = sp->head;
+
+    /* not a pipe of the scheduler, or the end of a halted transfer */
+    if ((0U == sp->active) || (NULL == urb)) {
+        return 0U;
+    }
+
+    sp->active = 0U;
+
+    switch (pp->urb_state) {
+        case URB_DONE:
+            len = sp->chunk;
+
+            if ((pp->ep.dir) && (pp->xfer_count < len)) {
+                len = pp->xfer_count;
+            }
+
+            urb->count += len;
+
+            if ((urb->count < urb->len) && (len == sp->chunk)) {
+                /* more data, periodic pipes go on at their next frame */
+                if (0U == sp->interval) {
+                    usbh_sched_start(pudev, pp_num);
+                }
+            } else {
+                usbh_sched_end(pudev, pp_num, URB_DONE);
+            }
+            break;
+
+        case URB_STALL:
+        case URB_ERROR:
+            usbh_sched_end(pudev, pp_num, pp->urb_state);
+            break;
+
+        default:
+            /* NAK or transaction error, try again later */
+            if ((USB_EPTYPE_INTR == pp->ep.type) && (0U == pp->ep.dir)) {
+                /* the data toggle was changed when the transfer was started */
+                pp->data_toggle_out ^= 1U;
+            }
+
+            sp->retry = 1U;
+            break;
+    }
+
+    return 0U;
+}
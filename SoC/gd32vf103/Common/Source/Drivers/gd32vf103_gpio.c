@@ -248,6 +248,39 @@ void gpio_port_write(uint32_t gpio_periph, uint16_t data)
     GPIO_OCTL(gpio_periph) = (uint32_t) data;
 }
 
+/*!
+    \brief      set and reset GPIO pins of a port at once
+    \param[in]  gpio_periph: GPIOx(x = A,B,C,D,E)
+    \param[in]  set_pin: GPIO pins to set
+                one or more parameters can be selected which are shown as below:
+      \arg        GPIO_PIN_x(x=0..15), GPIO_PIN_ALL
+    \param[in]  reset_pin: GPIO pins to reset, a pin also in set_pin is set
+                one or more parameters can be selected which are shown as below:
+      \arg        GPIO_PIN_x(x=0..15), GPIO_PIN_ALL
+    \param[out] none
+    \retval     none
+*/
+void gpio_port_bit_operate(uint32_t gpio_periph, uint32_t set_pin, uint32_t reset_pin)
+{
+    GPIO_BOP(gpio_periph) = GPIO_BOP_VALUE(set_pin, reset_pin);
+}
+
+/*!
+    \brief      write GPIO_BOP values of ports in order, one store for each port
+    \param[in]  batch: GPIO ports and their GPIO_BOP values, see GPIO_BOP_VALUE and GPIO_BUS_BOP
+    \param[in]  num: number of entries of batch
+    \param[out] none
+    \retval     none
+*/
+void gpio_batch_write(const gpio_batch_struct *batch, uint32_t num)
+{
+    uint32_t i;
+
+    for (i = 0U; i < num; i++) {
+        GPIO_BOP(batch[i].gpio_periph) = batch[i].bop;
+    }
+}
+
 /*!
     \brief      get GPIO pin input status
     \param[in]  gpio_periph: GPIOx(x = A,B,C,D,E)
@@ -306,6 +339,23 @@ uint16_t gpio_output_port_get(uint32_t gpio_periph)
     return ((uint16_t) GPIO_OCTL(gpio_periph));
 }
 
+/*!
+    \brief      toggle GPIO pin status
+    \param[in]  gpio_periph: GPIOx(x = A,B,C,D,E)
+    \param[in]  pin: GPIO pin
+                one or more parameters can be selected which are shown as below:
+      \arg        GPIO_PIN_x(x=0..15), GPIO_PIN_ALL
+    \param[out] none
+    \retval     none
+*/
+void gpio_bit_toggle(uint32_t gpio_periph, uint32_t pin)
+{
+    uint32_t octl = GPIO_OCTL(gpio_periph);
+
+    /* no toggle register, other pins are untouched by the one GPIO_BOP store */
+    GPIO_BOP(gpio_periph) = GPIO_BOP_VALUE(~octl & pin, octl & pin);
+}
+
 /*!
     \brief      configure GPIO pin remap
     \param[in]  gpio_remap: select the pin to remap
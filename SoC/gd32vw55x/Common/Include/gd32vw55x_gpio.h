@@ -289,6 +289,22 @@ typedef FlagStatus bit_status;
 #define GPIO_PUPD_PULLUP           PUD_PUPD(1)                      /*!< with pull-up resistor */
 #define GPIO_PUPD_PULLDOWN         PUD_PUPD(2)                      /*!< with pull-down resistor */
 
+/* GPIO port bit operation values, set_pin pins are set and reset_pin pins are cleared by one GPIO_BOP store */
+#define GPIO_BOP_VALUE(set_pin, reset_pin) \
+        ((((uint32_t)(reset_pin) & 0x0000FFFFU) << 16U) | ((uint32_t)(set_pin) & 0x0000FFFFU))
+/* mask of width pins from pin offset on, and GPIO_BOP value writing data to them, such as a parallel bus */
+#define GPIO_BUS_MASK(offset, width) \
+        ((uint32_t)(((1UL << (width)) - 1U) << (offset)))
+#define GPIO_BUS_BOP(data, offset, width) \
+        GPIO_BOP_VALUE(((uint32_t)(data) << (offset)) & GPIO_BUS_MASK(offset, width), \
+                       (~((uint32_t)(data) << (offset))) & GPIO_BUS_MASK(offset, width))
+
+/* GPIO port bit operation of gpio_batch_write */
+typedef struct {
+    uint32_t gpio_periph;                                       /*!< GPIOx(x = A,B,C) */
+    uint32_t bop;                                               /*!< GPIO_BOP value, see GPIO_BOP_VALUE */
+} gpio_batch_struct;
+
 /* GPIO pin definitions */
 #define GPIO_PIN_0                 BIT(0)                           /*!< GPIO pin 0 */
 #define GPIO_PIN_1                 BIT(1)                           /*!< GPIO pin 1 */
@@ -376,6 +392,10 @@ void gpio_bit_reset(uint32_t gpio_periph, uint32_t pin);
 void gpio_bit_write(uint32_t gpio_periph, uint32_t pin, bit_status bit_value);
 /* write data to the specified GPIO port */
 void gpio_port_write(uint32_t gpio_periph, uint16_t data);
+/* set and reset GPIO pins of a port at once */
+void gpio_port_bit_operate(uint32_t gpio_periph, uint32_t set_pin, uint32_t reset_pin);
+/* write GPIO_BOP values of ports in order */
+void gpio_batch_write(const gpio_batch_struct *batch, uint32_t num);
 
 /* get GPIO pin input status */
 FlagStatus gpio_input_bit_get(uint32_t gpio_periph, uint32_t pin);
@@ -157,7 +157,7 @@ static void system_clock_160m_hxtal(void);
 #endif /* __SYSTEM_CLOCK_IRC16M */
 
 /* configure the system clock */
-static void system_clock_config(void);
+void system_clock_config(void);
 
 /*!
     \brief      setup the microcontroller system, initialize the system
@@ -195,7 +195,7 @@ void SystemInit (void)
     \param[out] none
     \retval     none
 */
-static void system_clock_config(void)
+void system_clock_config(void)
 {
 #ifdef __SYSTEM_CLOCK_IRC16M
     system_clock_16m_irc16m();
@@ -605,6 +605,142 @@ void SystemCoreClockUpdate (void)
     SystemCoreClock = SystemCoreClock >> clk_exp;
 }
 
+/**
+ * \defgroup  NMSIS_Core_DVFS   Performance Point Switching
+ * \brief Functions to switch system clock between performance points at runtime.
+ * \details
+ * A performance point selects CK_SYS source and AHB prescaler, the PLL configured by
+ * \ref system_clock_config is kept running, so switching takes a few cycles and no PLL
+ * relocking. Peripheral clocks follow AHB clock, registered notifiers are called before
+ * and after the switch with interrupts disabled to re-derive their divisors, such as
+ * USART baudrate, SPI prescaler and TIMER prescaler. Built-in handling:
+ * - \ref SystemCoreClock is updated, so SOC_TIMER_FREQ, delay_1ms and RTOS tick reloads
+ *   computed from it follow the new clock
+ * - pending SysTimer compare value is rescaled, since mtime counts at AHB clock / 4,
+ *   so the current RTOS tick or timer deadline keeps its length in time
+ * - baudrate of SOC_DEBUG_UART is set again
+ * @{
+ */
+/* notifier table, NULL for free one */
+static SystemClock_Notifier_Type SystemClockNotifiers[SYSTEM_CLOCK_NOTIFIER_MAX];
+/* CK_SYS source of SYSTEM_PERF_MAX, 0xFFFFFFFF before first switch */
+static uint32_t SystemPerfMaxSource = 0xFFFFFFFFUL;
+static SystemPerf_Type SystemPerfCurrent = SYSTEM_PERF_MAX;
+
+/* AHB prescaler of each performance point */
+static const uint32_t SystemPerfAHBDiv[SYSTEM_PERF_NUM] = {
+    RCU_AHB_CKSYS_DIV1,         /* SYSTEM_PERF_MAX */
+    RCU_AHB_CKSYS_DIV2,         /* SYSTEM_PERF_HALF */
+    RCU_AHB_CKSYS_DIV8,         /* SYSTEM_PERF_LOW */
+    RCU_AHB_CKSYS_DIV1,         /* SYSTEM_PERF_IRC, CK_SYS is IRC16M */
+};
+
+/**
+ * \brief  Register a clock change notifier
+ * \param [in]  notifier     function called with SYSTEM_CLOCK_PRE_CHANGE and SYSTEM_CLOCK_POST_CHANGE
+ * \return 0 if registered, -1 if table is full
+ */
+int32_t SystemClock_RegisterNotifier(SystemClock_Notifier_Type notifier)
+{
+    uint32_t i;
+
+    for (i = 0; i < SYSTEM_CLOCK_NOTIFIER_MAX; i++) {
+        if (SystemClockNotifiers[i] == NULL) {
+            SystemClockNotifiers[i] = notifier;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/**
+ * \brief  Unregister a clock change notifier
+ * \param [in]  notifier     function registered by \ref SystemClock_RegisterNotifier
+ */
+void SystemClock_UnregisterNotifier(SystemClock_Notifier_Type notifier)
+{
+    uint32_t i;
+
+    for (i = 0; i < SYSTEM_CLOCK_NOTIFIER_MAX; i++) {
+        if (SystemClockNotifiers[i] == notifier) {
+            SystemClockNotifiers[i] = NULL;
+        }
+    }
+}
+
+static void SystemClock_Notify(uint32_t event, uint32_t old_freq, uint32_t new_freq)
+{
+    uint32_t i;
+
+    for (i = 0; i < SYSTEM_CLOCK_NOTIFIER_MAX; i++) {
+        if (SystemClockNotifiers[i] != NULL) {
+            SystemClockNotifiers[i](event, old_freq, new_freq);
+        }
+    }
+}
+
+/**
+ * \brief  Switch system clock to a performance point
+ * \details
+ * SYSTEM_PERF_MAX is the clock set up by \ref SystemInit, SYSTEM_PERF_HALF and SYSTEM_PERF_LOW
+ * divide it by 2 and 8, SYSTEM_PERF_IRC runs at IRC16M.
+ * \param [in]  perf     performance point
+ * \return new core clock frequency in Hz, 0 if perf is invalid
+ */
+uint32_t SystemPerf_Set(SystemPerf_Type perf)
+{
+    uint32_t old_freq, new_freq, src;
+    uint64_t now, cmp;
+    rv_csr_t mstatus;
+
+    if (perf >= SYSTEM_PERF_NUM) {
+        return 0;
+    }
+    mstatus = __RV_CSR_READ_CLEAR(CSR_MSTATUS, MSTATUS_MIE);
+    if (SystemPerfMaxSource == 0xFFFFFFFFUL) {
+        SystemPerfMaxSource = RCU_CFG0 & RCU_CFG0_SCS;
+    }
+    src = (perf == SYSTEM_PERF_IRC) ? RCU_CKSYSSRC_IRC16M : SystemPerfMaxSource;
+    old_freq = SystemCoreClock;
+    SystemClock_Notify(SYSTEM_CLOCK_PRE_CHANGE, old_freq, 0);
+    // last character of console is sent at old baudrate
+    while (usart_flag_get(SOC_DEBUG_UART, USART_FLAG_TC) == RESET);
+
+    // slow down AHB before switching to a faster source, so it never runs over the old clock
+    if (SystemPerfAHBDiv[perf] > (RCU_CFG0 & RCU_CFG0_AHBPSC)) {
+        rcu_ahb_clock_config(SystemPerfAHBDiv[perf]);
+    }
+    if ((RCU_CFG0 & RCU_CFG0_SCS) != src) {
+        rcu_system_clock_source_config(src);
+        while (((RCU_CFG0 & RCU_CFG0_SCSS) >> 2) != src);
+    }
+    rcu_ahb_clock_config(SystemPerfAHBDiv[perf]);
+    SystemCoreClockUpdate();
+    new_freq = SystemCoreClock;
+    SystemPerfCurrent = perf;
+
+    // keep remaining time of programmed deadline
+    now = SysTimer_GetLoadValue();
+    cmp = SysTimer_GetCompareValue();
+    if ((cmp != UINT64_MAX) && (cmp > now) && (old_freq != 0)) {
+        SysTimer_SetCompareValue(now + (cmp - now) * (new_freq >> 2) / (old_freq >> 2));
+    }
+    usart_baudrate_set(SOC_DEBUG_UART, SYSTEM_DEBUG_UART_BAUDRATE);
+    SystemClock_Notify(SYSTEM_CLOCK_POST_CHANGE, old_freq, new_freq);
+    __RV_CSR_SET(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+    return new_freq;
+}
+
+/**
+ * \brief  Get current performance point
+ * \return performance point set by \ref SystemPerf_Set, SYSTEM_PERF_MAX before any switch
+ */
+SystemPerf_Type SystemPerf_Get(void)
+{
+    return SystemPerfCurrent;
+}
+/** @} */ /* End of Doxygen Group NMSIS_Core_DVFS */
+
 /**
  * \defgroup  NMSIS_Core_IntExcNMI_Handling   Interrupt and Exception and NMI Handling
  * \brief Functions for interrupt, exception and nmi handle available in system_<device>.c.
@@ -822,6 +958,40 @@ int32_t ECLIC_Register_IRQ(IRQn_Type IRQn, uint8_t shv, ECLIC_TRIGGER_Type trig_
 }
 /** @} */ /* End of Doxygen Group NMSIS_Core_ExceptionAndNMI */
 
+/*
+ * Boundary of code tagged with __HOT_ILM or collected by patterns of tools/scripts/hotilm.py,
+ * this SoC has no ILM, so the linker script places it in SRAM to run without flash
+ * wait states, they are weak since they are only provided by such linker script
+ *
+ *   .ilm_text : ALIGN(8) {
+ *     PROVIDE( __ilm_text_start = . );
+ *     KEEP(*(.ilm_text))
+ *     INCLUDE hot_ilm.ld
+ *     . = ALIGN(8);
+ *     PROVIDE( __ilm_text_end = . );
+ *   } >ram AT>flash
+ *   PROVIDE( __ilm_text_lma = LOADADDR(.ilm_text) );
+ */
+extern unsigned long __ilm_text_start[] __WEAK;
+extern unsigned long __ilm_text_end[] __WEAK;
+extern unsigned long __ilm_text_lma[] __WEAK;
+
+/* Copy hot code into SRAM */
+static void HotILM_Init(void)
+{
+    unsigned long words = (unsigned long)(__ilm_text_end - __ilm_text_start);
+    unsigned long i;
+
+    if (((unsigned long)__ilm_text_lma == (unsigned long)__ilm_text_start) || (words == 0)) {
+        return;
+    }
+    for (i = 0; i < words; i++) {
+        __ilm_text_start[i] = __ilm_text_lma[i];
+    }
+    __RWMB();
+    __FENCE_I();
+}
+
 /**
  * \brief early init function before main
  * \details
@@ -833,6 +1003,8 @@ int32_t ECLIC_Register_IRQ(IRQn_Type IRQn, uint8_t shv, ECLIC_TRIGGER_Type trig_
 void _premain_init(void)
 {
     /* TODO: Add your own initialization code here, called before main */
+    // functions called before here must not be hot ones
+    HotILM_Init();
 #if defined(__ICACHE_PRESENT) && (__ICACHE_PRESENT == 1)
     if (ICachePresent()) { // Check whether icache real present or not
         EnableICache();
@@ -0,0 +1,300 @@
+// See LICENSE for license details.
+#include <stdio.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+
+#ifdef CFG_SIMULATION
+#define WORDS                   256
+#else
+#define WORDS                   4096
+#endif
+
+#define CRC_POLY                0x04C11DB7UL
+/* low 32 bits of x^64 / (x^32 + CRC_POLY), Barrett constant */
+#define CRC_MU                  0x04D101DFUL
+
+static unsigned long words[WORDS];
+
+static uint64_t start;
+
+#define BENCH_START()           (start = __get_rv_cycle())
+#define BENCH_END(cyc)          ((cyc) = __get_rv_cycle() - start)
+
+/* lowest set bit table of the generic RT-Thread __rt_ffs */
+static const uint8_t lowest_bit_tbl[256] = {
+    0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+    5, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+    6, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+    5, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+    7, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+    5, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+    6, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+    5, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0
+};
+
+/*
+ * Generic C replaced by the NMSIS bit utility functions, each run returns a checksum of
+ * its results over all words, so both sides are checked to give the same results
+ */
+static unsigned long gen_ctz(unsigned long x)
+{
+    unsigned long n = 0;
+
+    if (x == 0) {
+        return __RISCV_XLEN;
+    }
+    while ((x & 1) == 0) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+}
+
+static unsigned long gen_clz(unsigned long x)
+{
+    unsigned long n = 0;
+
+    if (x == 0) {
+        return __RISCV_XLEN;
+    }
+    while ((x & (1UL << (__RISCV_XLEN - 1))) == 0) {
+        x <<= 1;
+        n++;
+    }
+    return n;
+}
+
+static unsigned long gen_ffs(uint32_t x)
+{
+    if (x == 0) {
+        return 0;
+    }
+    if (x & 0xff) {
+        return lowest_bit_tbl[x & 0xff] + 1;
+    }
+    if (x & 0xff00) {
+        return lowest_bit_tbl[(x >> 8) & 0xff] + 9;
+    }
+    if (x & 0xff0000) {
+        return lowest_bit_tbl[(x >> 16) & 0xff] + 17;
+    }
+    return lowest_bit_tbl[x >> 24] + 25;
+}
+
+static unsigned long gen_cpop(unsigned long x)
+{
+    unsigned long n = 0;
+
+    while (x != 0) {
+        x &= x - 1;
+        n++;
+    }
+    return n;
+}
+
+static unsigned long gen_rev8(unsigned long x)
+{
+    unsigned long r = 0;
+    uint32_t i;
+
+    for (i = 0; i < sizeof(unsigned long); i++) {
+        r = (r << 8) | (x & 0xff);
+        x >>= 8;
+    }
+    return r;
+}
+
+/* index of first zero byte, sizeof(unsigned long) if none, as in word at a time strlen */
+static unsigned long gen_zbyte(unsigned long x)
+{
+    uint32_t i;
+
+    for (i = 0; i < sizeof(unsigned long); i++) {
+        if (((x >> (i * 8)) & 0xff) == 0) {
+            break;
+        }
+    }
+    return i;
+}
+
+static unsigned long gen_clmul(unsigned long a, unsigned long b)
+{
+    unsigned long r = 0;
+    uint32_t i;
+
+    for (i = 0; i < __RISCV_XLEN; i++) {
+        if (b & (1UL << i)) {
+            r ^= a << i;
+        }
+    }
+    return r;
+}
+
+static uint32_t gen_crc32(uint32_t crc, uint32_t w)
+{
+    uint32_t i;
+
+    crc ^= w;
+    for (i = 0; i < 32; i++) {
+        crc = (crc & 0x80000000UL) ? ((crc << 1) ^ CRC_POLY) : (crc << 1);
+    }
+    return crc;
+}
+
+static unsigned long nmsis_ffs(uint32_t x)
+{
+    return (x == 0) ? 0 : __CTZL(x) + 1;
+}
+
+static unsigned long nmsis_zbyte(unsigned long x)
+{
+    return __CTZL(~__ORCBL(x)) / 8;
+}
+
+static uint32_t nmsis_crc32(uint32_t crc, uint32_t w)
+{
+    unsigned long t = crc ^ w;
+    unsigned long q;
+
+    // q = t * x^32 / P by Barrett reduction, the remainder is the low half of q * P
+#if __RISCV_XLEN == 32
+    q = __CLMULHL(t, CRC_MU);
+#else
+    q = __CLMULL(t, CRC_MU) >> 32;
+#endif
+    q ^= t;
+    return (uint32_t)__CLMULL(q, CRC_POLY);
+}
+
+#define BENCH_UNARY(name, gen, nmsis)                                       \
+    static unsigned long run_gen_##name(void)                               \
+    {                                                                       \
+        unsigned long sum = 0;                                              \
+        for (uint32_t i = 0; i < WORDS; i++) {                              \
+            sum += gen(words[i]);                                           \
+        }                                                                   \
+        return sum;                                                         \
+    }                                                                       \
+    static unsigned long run_nmsis_##name(void)                             \
+    {                                                                       \
+        unsigned long sum = 0;                                              \
+        for (uint32_t i = 0; i < WORDS; i++) {                              \
+            sum += nmsis(words[i]);                                         \
+        }                                                                   \
+        return sum;                                                         \
+    }
+
+BENCH_UNARY(ctz, gen_ctz, __CTZL)
+BENCH_UNARY(clz, gen_clz, __CLZL)
+BENCH_UNARY(ffs, gen_ffs, nmsis_ffs)
+BENCH_UNARY(cpop, gen_cpop, __CPOPL)
+BENCH_UNARY(rev8, gen_rev8, __REV8L)
+BENCH_UNARY(zbyte, gen_zbyte, nmsis_zbyte)
+
+static unsigned long run_gen_clmul(void)
+{
+    unsigned long sum = 0;
+
+    for (uint32_t i = 0; i + 1 < WORDS; i++) {
+        sum ^= gen_clmul(words[i], words[i + 1]);
+    }
+    return sum;
+}
+
+static unsigned long run_nmsis_clmul(void)
+{
+    unsigned long sum = 0;
+
+    for (uint32_t i = 0; i + 1 < WORDS; i++) {
+        sum ^= __CLMULL(words[i], words[i + 1]);
+    }
+    return sum;
+}
+
+static unsigned long run_gen_crc32(void)
+{
+    uint32_t crc = 0xFFFFFFFFUL;
+
+    for (uint32_t i = 0; i < WORDS; i++) {
+        crc = gen_crc32(crc, (uint32_t)words[i]);
+    }
+    return crc;
+}
+
+static unsigned long run_nmsis_crc32(void)
+{
+    uint32_t crc = 0xFFFFFFFFUL;
+
+    for (uint32_t i = 0; i < WORDS; i++) {
+        crc = nmsis_crc32(crc, (uint32_t)words[i]);
+    }
+    return crc;
+}
+
+typedef struct bench_case {
+    const char *name;
+    unsigned long (*run[2])(void);  /* generic C, NMSIS */
+} bench_case_t;
+
+#define BENCH_CASE(name)            {#name, {run_gen_##name, run_nmsis_##name}}
+
+static const bench_case_t cases[] = {
+    BENCH_CASE(ctz),
+    BENCH_CASE(clz),
+    BENCH_CASE(ffs),
+    BENCH_CASE(cpop),
+    BENCH_CASE(rev8),
+    BENCH_CASE(zbyte),
+    BENCH_CASE(clmul),
+    BENCH_CASE(crc32),
+};
+
+/* random words with a spread of bit positions and zero bytes, some are 0 */
+static void fill(void)
+{
+    uint32_t seed = 0x12345678;
+    unsigned long w;
+    uint32_t i;
+
+    for (i = 0; i < WORDS; i++) {
+        seed = seed * 1664525UL + 1013904223UL;
+        w = seed;
+#if __RISCV_XLEN == 64
+        seed = seed * 1664525UL + 1013904223UL;
+        w = (w << 32) | seed;
+#endif
+        // shift out a random number of low and high bits, and clear a random byte
+        w = (w << (seed & (__RISCV_XLEN - 1))) >> ((seed >> 8) & (__RISCV_XLEN - 1));
+        w &= ~(0xFFUL << (((seed >> 16) % sizeof(unsigned long)) * 8));
+        words[i] = ((i % 61) == 0) ? 0 : w;
+    }
+}
+
+int main(void)
+{
+    uint64_t cyc[2];
+    unsigned long sum[2];
+    uint32_t failed = 0, i, v;
+
+    fill();
+    printf("NMSIS bit utility functions against generic C, %d words\n", WORDS);
+#if defined(__riscv_zbb)
+    printf("Zbb: ctz, clz, cpop, rev8 and orc.b instructions\n");
+#endif
+#if defined(__riscv_zbc) || defined(__riscv_zbkc)
+    printf("Zbc: clmul and clmulh instructions\n");
+#endif
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        for (v = 0; v < 2; v++) {
+            BENCH_START();
+            sum[v] = cases[i].run[v]();
+            BENCH_END(cyc[v]);
+        }
+        failed += (sum[0] != sum[1]);
+        printf("%-8s generic %8lu, nmsis %8lu cycles, %5lu%% %s\n", cases[i].name, (unsigned long)cyc[0],
+               (unsigned long)cyc[1], (unsigned long)((cyc[0] * 100) / (cyc[1] ? cyc[1] : 1)),
+               (sum[0] == sum[1]) ? "same" : "DIFF");
+    }
+    printf("bit benchmark finished, %s\n", (failed == 0) ? "PASS" : "FAIL");
+    return (failed == 0) ? 0 : 1;
+}
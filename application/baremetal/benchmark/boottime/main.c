@@ -0,0 +1,47 @@
+// See LICENSE for license details.
+#include <stdio.h>
+#include "nuclei_sdk_soc.h"
+
+/*
+ * Report cycles from reset to main, build with NUCLEI_BOOT_FASTINIT=1 to compare the fast
+ * .data and .bss initialization, and program the image made by tools/scripts/lz4data.py
+ * to compare compressed .data, the sections below make .data and .bss large enough to see
+ */
+#ifndef BOOT_DATA_SIZE
+#define BOOT_DATA_SIZE      (16 * 1024)
+#endif
+#ifndef BOOT_BSS_SIZE
+#define BOOT_BSS_SIZE       (64 * 1024)
+#endif
+
+extern uint8_t _data[], _edata[], __bss_start[], _end[];
+
+// repeated pattern like tables in real programs, so it compresses
+#define PATTERN8(x)         (x), (x) + 1, (x) + 2, (x) + 3, 0, 0, 0, 0
+volatile uint32_t boot_data[BOOT_DATA_SIZE / sizeof(uint32_t)] = {
+    PATTERN8(1), PATTERN8(2), PATTERN8(3), PATTERN8(4), PATTERN8(5), PATTERN8(6), PATTERN8(7), PATTERN8(8),
+};
+volatile uint32_t boot_bss[BOOT_BSS_SIZE / sizeof(uint32_t)];
+
+int main(void)
+{
+    uint64_t cycles = SystemBootCycles;
+    uint32_t freq = SystemCoreClock;
+
+    printf("Boot time benchmark\n");
+    printf(".data %lu bytes, .bss %lu bytes\n", (unsigned long)(_edata - _data), (unsigned long)(_end - __bss_start));
+    printf("Reset to main: %lu cycles", (unsigned long)cycles);
+    if (freq != 0) {
+        printf(", %lu us", (unsigned long)(cycles * 1000000 / freq));
+    }
+    printf("\n");
+#if defined(NUCLEI_BOOT_FASTINIT) && (NUCLEI_BOOT_FASTINIT == 1)
+    printf("Section init: %lu cycles\n", (unsigned long)SystemBootSectionCycles);
+#endif
+    // make sure the sections are initialized as expected
+    if ((boot_data[0] != 1) || (boot_data[8] != 2) || (boot_data[63] != 0) || (boot_bss[BOOT_BSS_SIZE / sizeof(uint32_t) - 1] != 0)) {
+        printf("Section initialization is wrong\n");
+        return 1;
+    }
+    return 0;
+}
@@ -103,6 +103,11 @@ char* mem_name[3] = {"Static", "Heap", "Stack"};
 
 */
 
+#if defined(COREMARK_RUNNER) && (COREMARK_RUNNER == 1)
+/* one run of core_runner.c, which provides main */
+#define main coremark_main
+#endif
+
 #if MAIN_HAS_NOARGC
 MAIN_RETURN_TYPE main(void)
 {
@@ -183,7 +188,11 @@ MAIN_RETURN_TYPE main(int argc, char* argv[])
     }
 #elif (MEM_METHOD==MEM_STACK)
     for (i = 0 ; i < MULTITHREAD; i++) {
+#if defined(COREMARK_RUNNER) && (COREMARK_RUNNER == 1)
+        results[i].memblock[0] = coremark_runner_memblock(stack_memblock) + i * TOTAL_DATA_SIZE;
+#else
         results[i].memblock[0] = stack_memblock + i * TOTAL_DATA_SIZE;
+#endif
         results[i].size = TOTAL_DATA_SIZE;
         results[i].seed1 = results[0].seed1;
         results[i].seed2 = results[0].seed2;
@@ -246,6 +255,9 @@ MAIN_RETURN_TYPE main(int argc, char* argv[])
         }
         results[0].iterations *= 1 + 10 / divisor;
     }
+#if defined(COREMARK_SMP) && (COREMARK_SMP == 1)
+    core_smp_solo(&results[0]);
+#endif
     /* perform actual benchmark */
     start_time();
     start_instret();
@@ -268,6 +280,9 @@ MAIN_RETURN_TYPE main(int argc, char* argv[])
     stop_instret();
     total_time = get_time();
     total_instret = get_instret();
+#if defined(COREMARK_SMP) && (COREMARK_SMP == 1)
+    core_smp_report(results, default_num_contexts);
+#endif
     /* get a function of the input to report */
     seedcrc = crc16(results[0].seed1, seedcrc);
     seedcrc = crc16(results[0].seed2, seedcrc);
@@ -321,6 +336,9 @@ MAIN_RETURN_TYPE main(int argc, char* argv[])
         }
     }
     total_errors += check_data_types();
+#if defined(COREMARK_RUNNER) && (COREMARK_RUNNER == 1)
+    coremark_runner_result(total_errors, results[0].iterations, total_time, total_instret);
+#endif
     /* and report results */
     ee_printf("CoreMark Size    : %u\n", (unsigned int)results[0].size);
     ee_printf("Total ticks      : %u\n", (unsigned int)total_time);
@@ -66,3 +66,110 @@ secs_ret time_in_secs(CORE_TICKS ticks)
     uint64_t freq = SystemCoreClock / scale;
     return delta / (double)freq;
 }
+
+#if defined(COREMARK_SMP) && (COREMARK_SMP == 1)
+/*
+ * Bare-metal SMP backend, built with COREMARK_SMP=1 and SMP=<harts>
+ *
+ * Context i runs on the hart of index i, the boot hart runs main and publishes the contexts
+ * in core_start_parallel(), then all harts pass a barrier together, run their context and
+ * meet at a second barrier, each hart measures its own cycles between the two barriers.
+ * Working data of all contexts is on the stack of boot hart, so DOWNLOAD mode must place
+ * it in memory shared by all harts, and the per-hart scores against the boot hart running
+ * alone show the contention of shared cache and interconnect.
+ */
+ee_u32 default_num_contexts = MULTITHREAD;
+
+int main(void);
+
+static SpinBarrier_Type smp_start_bar = SPINBARRIER_INIT(SMP_CPU_CNT);
+static SpinBarrier_Type smp_stop_bar = SPINBARRIER_INIT(SMP_CPU_CNT);
+static core_results* volatile smp_res[SMP_CPU_CNT];
+static volatile CORE_TICKS smp_ticks[SMP_CPU_CNT];
+static CORE_TICKS smp_solo_ticks;
+static ee_u32 smp_published = 0;
+static volatile uint32_t smp_ready = 0;
+
+static void smp_iterate(unsigned long hartidx)
+{
+    CORE_TICKS start;
+
+    SpinBarrier_Wait(&smp_start_bar);
+    start = __get_rv_cycle();
+    iterate(smp_res[hartidx]);
+    smp_ticks[hartidx] = __get_rv_cycle() - start;
+    SpinBarrier_Wait(&smp_stop_bar);
+}
+
+void core_smp_solo(core_results* res)
+{
+    CORE_TICKS start = __get_rv_cycle();
+
+    iterate(res);
+    smp_solo_ticks = __get_rv_cycle() - start;
+}
+
+ee_u8 core_start_parallel(core_results* res)
+{
+    smp_res[smp_published++] = res;
+    __SMP_RWMB();
+    // all contexts are published, release the other harts and run own context
+    if (smp_published == MULTITHREAD) {
+        smp_published = 0;
+        smp_iterate(__get_hart_index());
+    }
+    return 0;
+}
+
+ee_u8 core_stop_parallel(core_results* res)
+{
+    // all harts finished at the stop barrier of core_start_parallel()
+    return 0;
+}
+
+void core_smp_report(core_results* res, ee_u32 contexts)
+{
+    CORE_TICKS max = 0;
+    double solo, mhz, total = 0;
+    ee_u32 i;
+
+    // 64 bit integers are printed as double since printf of newlib nano has no %llu
+    solo = (smp_solo_ticks > 0) ? ((double)res[0].iterations * 1000000 / (double)smp_solo_ticks) : 0.0;
+    ee_printf("CMSMP, hart, iterations, ticks, coremark_mhz, of_solo\n");
+    ee_printf("CMSMP, solo, %u, %.0f, %.6f, 100.00%%\n", (unsigned int)res[0].iterations, (double)smp_solo_ticks, solo);
+    for (i = 0; i < contexts; i++) {
+        mhz = (smp_ticks[i] > 0) ? ((double)res[i].iterations * 1000000 / (double)smp_ticks[i]) : 0.0;
+        total += res[i].iterations;
+        if (smp_ticks[i] > max) {
+            max = smp_ticks[i];
+        }
+        ee_printf("CMSMP, %u, %u, %.0f, %.6f, %.2f%%\n", (unsigned int)i, (unsigned int)res[i].iterations,
+                  (double)smp_ticks[i], mhz, (solo > 0) ? (mhz * 100 / solo) : 0.0);
+    }
+    // aggregate is all iterations over the slowest hart, scaling is against one hart alone
+    mhz = (max > 0) ? (total * 1000000 / (double)max) : 0.0;
+    ee_printf("CMSMP, all, %u, %.0f, %.6f, %.2f%%\n", (unsigned int)total, (double)max, mhz,
+              (solo > 0) ? (mhz * 100 / solo) : 0.0);
+    ee_printf("SMP CoreMark/MHz : %f on %u harts, %.2fx of one hart\n", mhz, (unsigned int)contexts,
+              (solo > 0) ? (mhz / solo) : 0.0);
+}
+
+/* Reimplementation of smp_main, the other harts run the contexts published by boot hart */
+int smp_main(void)
+{
+    unsigned long hartidx = __get_hart_index();
+
+    if (__get_hart_id() == BOOT_HARTID) {
+        smp_ready = 1;
+        __SMP_RWMB();
+        exit(main());
+    } else {
+        // wait for boot hart finish c runtime initialization
+        while (smp_ready == 0);
+    }
+    while (1) {
+        smp_iterate(hartidx);
+    }
+    return 0;
+}
+#endif
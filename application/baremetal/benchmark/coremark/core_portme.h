@@ -63,17 +63,34 @@
 #define MAIN_HAS_NOARGC 0
 #define MAIN_HAS_NORETURN 0
 
+#if defined(COREMARK_SMP) && (COREMARK_SMP == 1)
+/* one context on each hart, run by the bare-metal SMP backend in core_portme.c */
+#define MULTITHREAD SMP_CPU_CNT
+#define PARALLEL_METHOD "SMP"
+#else
 #define MULTITHREAD 1
+#endif
 #define USE_PTHREAD 0
 #define USE_FORK 0
 #define USE_SOCKET 0
 
+#if (MULTITHREAD > 1)
+extern ee_u32 default_num_contexts;
+#else
 #define default_num_contexts MULTITHREAD
+#endif
 
 typedef int core_portable;
 static void portable_init(core_portable* p, int* argc, char* argv[]) {}
 static void portable_fini(core_portable* p) {}
 
+#if defined(COREMARK_RUNNER) && (COREMARK_RUNNER == 1)
+/* working data of a run of core_runner.c, stack_memblock when it runs on stack */
+ee_u8 *coremark_runner_memblock(ee_u8 *stack_memblock);
+/* result of a run of core_runner.c, errors is 0 when crcs are validated */
+void coremark_runner_result(ee_s16 errors, ee_u32 iterations, CORE_TICKS ticks, CORE_TICKS instret);
+#endif
+
 #if !defined(PROFILE_RUN) && !defined(PERFORMANCE_RUN) && !defined(VALIDATION_RUN)
 #if (TOTAL_DATA_SIZE==1200)
 #define PROFILE_RUN 1
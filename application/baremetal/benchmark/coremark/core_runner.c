@@ -0,0 +1,188 @@
+/*
+ * CoreMark runner, built with COREMARK_RUNNER=1
+ *
+ * CoreMark is run COREMARK_RUNS times under each micro-architecture setting and each
+ * region of its working data, and a matrix of min, max, mean and standard deviation of
+ * the ticks is printed, one "CMRUN," line per setting and region, and one "CMITER,"
+ * line per run, so the log can be parsed to pick the configuration of a product.
+ *
+ * - Settings switch BPU, load speculation and L1 caches by SystemTuning_Set() of evalsoc,
+ *   settings whose supported features are the same as a previous one are skipped, only
+ *   the default setting is run on SoCs without it
+ * - Region "stack" is the stack of CoreMark as in the normal build, the others are memory
+ *   areas not used by the linker script and passed by base address and size, eg.
+ *   -DCOREMARK_DLM_BASE=0x90010000 -DCOREMARK_DLM_SIZE=0x1000, the same for
+ *   COREMARK_ILM_*, COREMARK_SRAM_* and COREMARK_DDR_*
+ * - Code placement is not switched at runtime, it is selected by DOWNLOAD mode of build
+ */
+#if defined(COREMARK_RUNNER) && (COREMARK_RUNNER == 1)
+#include <stdio.h>
+#include <math.h>
+#include "coremark.h"
+
+#ifndef COREMARK_RUNS
+#define COREMARK_RUNS           3
+#endif
+
+typedef struct {
+    const char *name;
+    ee_u8 *base;
+    ee_u32 size;
+} runner_region_t;
+
+static const runner_region_t runner_regions[] = {
+    {"stack", NULL, 0},
+#if defined(COREMARK_ILM_BASE) && defined(COREMARK_ILM_SIZE)
+    {"ilm", (ee_u8 *)(COREMARK_ILM_BASE), COREMARK_ILM_SIZE},
+#endif
+#if defined(COREMARK_DLM_BASE) && defined(COREMARK_DLM_SIZE)
+    {"dlm", (ee_u8 *)(COREMARK_DLM_BASE), COREMARK_DLM_SIZE},
+#endif
+#if defined(COREMARK_SRAM_BASE) && defined(COREMARK_SRAM_SIZE)
+    {"sram", (ee_u8 *)(COREMARK_SRAM_BASE), COREMARK_SRAM_SIZE},
+#endif
+#if defined(COREMARK_DDR_BASE) && defined(COREMARK_DDR_SIZE)
+    {"ddr", (ee_u8 *)(COREMARK_DDR_BASE), COREMARK_DDR_SIZE},
+#endif
+};
+
+#define RUNNER_REGION_NUM       (sizeof(runner_regions) / sizeof(runner_regions[0]))
+
+#if defined(TUNING_ALL)
+#define RUNNER_FEATURES         (TUNING_BPU | TUNING_LDSPEC | TUNING_ICACHE | TUNING_DCACHE)
+
+typedef struct {
+    const char *name;
+    uint32_t enable;                /* features of RUNNER_FEATURES enabled */
+} runner_setting_t;
+
+static const runner_setting_t runner_settings[] = {
+    {"all", RUNNER_FEATURES},
+    {"nobpu", RUNNER_FEATURES & ~TUNING_BPU},
+    {"noldspec", RUNNER_FEATURES & ~TUNING_LDSPEC},
+    {"noicache", RUNNER_FEATURES & ~TUNING_ICACHE},
+    {"nodcache", RUNNER_FEATURES & ~TUNING_DCACHE},
+    {"nocache", RUNNER_FEATURES & ~(TUNING_ICACHE | TUNING_DCACHE)},
+    {"none", 0},
+};
+
+#define RUNNER_SETTING_NUM      (sizeof(runner_settings) / sizeof(runner_settings[0]))
+#endif
+
+int coremark_main(int argc, char *argv[]);
+
+static const runner_region_t *runner_region;
+
+/* result of current run, filled by coremark_runner_result */
+static struct {
+    ee_s16 errors;
+    ee_u32 iterations;
+    CORE_TICKS ticks;
+    CORE_TICKS instret;
+} runner_run;
+
+ee_u8 *coremark_runner_memblock(ee_u8 *stack_memblock)
+{
+    return (runner_region->base != NULL) ? runner_region->base : stack_memblock;
+}
+
+void coremark_runner_result(ee_s16 errors, ee_u32 iterations, CORE_TICKS ticks, CORE_TICKS instret)
+{
+    runner_run.errors = errors;
+    runner_run.iterations = iterations;
+    runner_run.ticks = ticks;
+    runner_run.instret = instret;
+}
+
+/* run CoreMark COREMARK_RUNS times and print its row of matrix, return runs failed */
+static uint32_t runner_measure(const char *setting, const runner_region_t *region)
+{
+    CORE_TICKS ticks[COREMARK_RUNS];
+    CORE_TICKS min = 0, max = 0;
+    double mean = 0, var = 0;
+    uint64_t instret = 0;
+    ee_u32 iterations = 0;
+    uint32_t run, failed = 0;
+
+    runner_region = region;
+    for (run = 0; run < COREMARK_RUNS; run++) {
+        runner_run.errors = -1;
+        runner_run.ticks = 0;
+        coremark_main(0, NULL);
+        ticks[run] = runner_run.ticks;
+        iterations = runner_run.iterations;
+        instret += runner_run.instret;
+        failed += (runner_run.errors != 0);
+        ee_printf("CMITER, %s, %s, %u, %.0f, %.0f, %s\n", setting, region->name, (unsigned int)run,
+                  (double)runner_run.ticks, (double)runner_run.instret, (runner_run.errors == 0) ? "valid" : "invalid");
+        if ((run == 0) || (ticks[run] < min)) {
+            min = ticks[run];
+        }
+        if ((run == 0) || (ticks[run] > max)) {
+            max = ticks[run];
+        }
+        mean += (double)ticks[run];
+    }
+    mean /= COREMARK_RUNS;
+    for (run = 0; run < COREMARK_RUNS; run++) {
+        var += ((double)ticks[run] - mean) * ((double)ticks[run] - mean);
+    }
+    var /= COREMARK_RUNS;
+    // 64 bit integers are printed as double since printf of newlib nano has no %llu,
+    // CoreMark/MHz is of the best run, and IPC is of all runs
+    ee_printf("CMRUN, %s, %s, %u, %u, %.0f, %.0f, %.0f, %.0f, %.4f%%, %.6f, %.4f, %s\n", setting, region->name,
+              (unsigned int)COREMARK_RUNS, (unsigned int)iterations, (double)min, (double)max, mean, sqrt(var),
+              (mean > 0) ? (sqrt(var) * 100 / mean) : 0.0, (min > 0) ? ((double)iterations * 1000000 / (double)min) : 0.0,
+              (mean > 0) ? ((double)instret / (mean * COREMARK_RUNS)) : 0.0, (failed == 0) ? "valid" : "invalid");
+    return failed;
+}
+
+static uint32_t runner_regions_measure(const char *setting)
+{
+    uint32_t i, failed = 0;
+
+    for (i = 0; i < RUNNER_REGION_NUM; i++) {
+        if ((runner_regions[i].base != NULL) && (runner_regions[i].size < TOTAL_DATA_SIZE * MULTITHREAD)) {
+            ee_printf("Region %s is smaller than %u bytes of working data, skipped\n", runner_regions[i].name,
+                      (unsigned int)(TOTAL_DATA_SIZE * MULTITHREAD));
+            continue;
+        }
+        failed += runner_measure(setting, &runner_regions[i]);
+    }
+    return failed;
+}
+
+int main(void)
+{
+    uint32_t failed = 0;
+#if defined(TUNING_ALL)
+    uint32_t supported = SystemTuning_Supported() & RUNNER_FEATURES;
+    uint32_t saved = SystemTuning_Get();
+    uint32_t i, j;
+#endif
+
+    ee_printf("CoreMark runner, %u runs of each setting and region\n", (unsigned int)COREMARK_RUNS);
+    ee_printf("CMITER, setting, region, run, ticks, instret, result\n");
+    ee_printf("CMRUN, setting, region, runs, iterations, min, max, mean, stddev, cv, coremark_mhz, ipc, result\n");
+#if defined(TUNING_ALL)
+    for (i = 0; i < RUNNER_SETTING_NUM; i++) {
+        // settings differing in unsupported features only give the same result
+        for (j = 0; j < i; j++) {
+            if (((runner_settings[i].enable ^ runner_settings[j].enable) & supported) == 0) {
+                break;
+            }
+        }
+        if (j < i) {
+            continue;
+        }
+        SystemTuning_Set(RUNNER_FEATURES, runner_settings[i].enable);
+        failed += runner_regions_measure(runner_settings[i].name);
+    }
+    SystemTuning_Set(RUNNER_FEATURES, saved);
+#else
+    failed += runner_regions_measure("default");
+#endif
+    ee_printf("CoreMark runner finished, %s\n", (failed == 0) ? "PASS" : "FAIL");
+    return (failed == 0) ? 0 : 1;
+}
+#endif
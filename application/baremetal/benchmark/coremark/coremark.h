@@ -164,6 +164,12 @@ typedef struct RESULTS_S {
 ee_u8 core_start_parallel(core_results* res);
 ee_u8 core_stop_parallel(core_results* res);
 #endif
+#if defined(COREMARK_SMP) && (COREMARK_SMP == 1)
+/* run res on boot hart alone, as the baseline of the per-hart scores */
+void core_smp_solo(core_results* res);
+/* print per-hart and aggregate scores of the last parallel run */
+void core_smp_report(core_results* res, ee_u32 contexts);
+#endif
 
 /* list benchmark functions */
 list_head* core_list_init(ee_u32 blksize, list_head* memblock, ee_s16 seed);
@@ -0,0 +1,148 @@
+// See LICENSE for license details.
+#include <stdio.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "riscv_math.h"
+#include "smpwork_api.h"
+#include "dsppar_api.h"
+
+#if !defined(SMP_CPU_CNT) || (SMP_CPU_CNT < 2)
+#error "SMP_CPU_CNT macro is not defined, please set SMP_CPU_CNT to integer value > 1"
+#endif
+
+#ifdef CFG_SIMULATION
+#define MAT_DIM                 24
+#define SIG_LEN                 512
+#define KER_LEN                 32
+#else
+#define MAT_DIM                 64
+#define SIG_LEN                 4096
+#define KER_LEN                 128
+#endif
+
+#define OUT_LEN                 (2 * SIG_LEN - 1)
+
+static float32_t mat_a[MAT_DIM * MAT_DIM];
+static float32_t mat_b[MAT_DIM * MAT_DIM];
+static float32_t mat_ser[MAT_DIM * MAT_DIM];
+static float32_t mat_par[MAT_DIM * MAT_DIM];
+static float32_t sig[SIG_LEN];
+static float32_t ker[KER_LEN];
+static float32_t ker_rev[KER_LEN];
+static float32_t out_ser[OUT_LEN];
+static float32_t out_par[OUT_LEN];
+
+static const uint32_t mat_grains[] = { 1, 4, 16 };
+static const uint32_t conv_grains[] = { 64, 256, 1024 };
+
+#define ARRAY_SIZE(a)           (sizeof(a) / sizeof((a)[0]))
+
+int smp_main(void);
+int main(void);
+
+/* Reimplementation of smp_main for multi-harts */
+int smp_main(void)
+{
+    return main();
+}
+
+static void fill(float32_t *buf, uint32_t len, uint32_t seed)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        seed = seed * 1103515245 + 12345;
+        buf[i] = (float32_t)((int32_t)(seed >> 16) & 0x7FFF) / 32768.0f - 0.5f;
+    }
+}
+
+/* print one row of result, the speedup is in percent of serial cycles */
+static int report(const char *name, uint32_t grain, uint64_t serial, uint64_t parallel,
+                  const float32_t *ref, const float32_t *out, uint32_t len)
+{
+    int same = (memcmp(ref, out, len * sizeof(float32_t)) == 0);
+
+    printf("%-10s grain %4u: serial %8lu, parallel %8lu cycles, speedup %3lu%%, %s\n", name, (unsigned int)grain,
+           (unsigned long)serial, (unsigned long)parallel, (unsigned long)((serial * 100) / (parallel ? parallel : 1)),
+           same ? "identical" : "MISMATCH");
+    return same ? 0 : -1;
+}
+
+static int bench_mat(void)
+{
+    riscv_matrix_instance_f32 a = { MAT_DIM, MAT_DIM, mat_a };
+    riscv_matrix_instance_f32 b = { MAT_DIM, MAT_DIM, mat_b };
+    riscv_matrix_instance_f32 ser = { MAT_DIM, MAT_DIM, mat_ser };
+    riscv_matrix_instance_f32 par = { MAT_DIM, MAT_DIM, mat_par };
+    uint64_t start, serial, parallel;
+    int ret = 0;
+
+    // first run warms up caches for both serial and parallel runs
+    riscv_mat_mult_f32(&a, &b, &ser);
+    start = __get_rv_cycle();
+    riscv_mat_mult_f32(&a, &b, &ser);
+    serial = __get_rv_cycle() - start;
+    for (uint32_t i = 0; i < ARRAY_SIZE(mat_grains); i++) {
+        memset(mat_par, 0, sizeof(mat_par));
+        start = __get_rv_cycle();
+        dsppar_mat_mult_f32(&a, &b, &par, mat_grains[i]);
+        parallel = __get_rv_cycle() - start;
+        ret |= report("mat_mult", mat_grains[i], serial, parallel, mat_ser, mat_par, MAT_DIM * MAT_DIM);
+    }
+    return ret;
+}
+
+static int bench_conv(int corr)
+{
+    uint32_t len = corr ? OUT_LEN : (SIG_LEN + KER_LEN - 1);
+    uint64_t start, serial, parallel;
+    int ret = 0;
+
+    // warm up caches, then clear output, the zero padding of correlation is left untouched
+    riscv_conv_f32(sig, SIG_LEN, ker, KER_LEN, out_ser);
+    memset(out_ser, 0, sizeof(out_ser));
+    start = __get_rv_cycle();
+    if (corr) {
+        riscv_correlate_f32(sig, SIG_LEN, ker, KER_LEN, out_ser);
+    } else {
+        riscv_conv_f32(sig, SIG_LEN, ker, KER_LEN, out_ser);
+    }
+    serial = __get_rv_cycle() - start;
+    for (uint32_t i = 0; i < ARRAY_SIZE(conv_grains); i++) {
+        memset(out_par, 0, sizeof(out_par));
+        start = __get_rv_cycle();
+        if (corr) {
+            dsppar_correlate_f32(sig, SIG_LEN, ker, KER_LEN, out_par, ker_rev, conv_grains[i]);
+        } else {
+            dsppar_conv_f32(sig, SIG_LEN, ker, KER_LEN, out_par, conv_grains[i]);
+        }
+        parallel = __get_rv_cycle() - start;
+        ret |= report(corr ? "correlate" : "conv", conv_grains[i], serial, parallel, out_ser, out_par, len);
+    }
+    return ret;
+}
+
+int main(void)
+{
+    unsigned long hartid = __get_hart_id();
+    int ret;
+
+    if (hartid != BOOT_HARTID) {
+        // other harts run tiles until boot hart stop the pool
+        smpwork_worker();
+        smpwork_barrier();
+        return 0;
+    }
+
+    fill(mat_a, MAT_DIM * MAT_DIM, 1);
+    fill(mat_b, MAT_DIM * MAT_DIM, 2);
+    fill(sig, SIG_LEN, 3);
+    fill(ker, KER_LEN, 4);
+    printf("DSP parallel benchmark on %d harts\n", SMP_CPU_CNT);
+    ret = bench_mat();
+    ret |= bench_conv(0);
+    ret |= bench_conv(1);
+    printf("DSP parallel benchmark %s\n", (ret == 0) ? "PASS" : "FAIL");
+
+    smpwork_stop();
+    smpwork_barrier();
+    return ret;
+}
@@ -0,0 +1,93 @@
+// See LICENSE for license details.
+#include <stdio.h>
+#include <math.h>
+#include "nuclei_sdk_soc.h"
+#include "nmsis_bench.h"
+#include "workloads.h"
+
+BENCH_DECLARE_VAR();
+
+/*
+ * Embench-IoT style suite of small embedded workloads, built with the flags of the
+ * toolchain_$(TOOLCHAIN).mk in use, like coremark, dhrystone and whetstone.
+ *
+ * Each workload runs once to warm the caches and check its result, then loops iterations
+ * in one timed run, and prints
+ *   EMBENCH, name, loops, cycles per iteration, PASS or FAIL
+ * The last line is the geometric mean of the cycles per iteration of all workloads, to
+ * compare cores and compilers.
+ *
+ * Code and data size of each workload are taken from the symbols of the elf by
+ *   python3 nuclei_sdk/tools/scripts/benchsize.py --elf build/app.elf crc32 chacha20 sha256 lzss matmult qsort lexfsm
+ */
+#ifdef CFG_SIMULATION
+#define EMBENCH_LOOPS(n)        1
+#else
+#define EMBENCH_LOOPS(n)        (n)
+#endif
+
+static const embench_workload_t workloads[] = {
+    { "crc32", crc32_init, crc32_run, 0x3ebeb964UL, EMBENCH_LOOPS(100) },
+    { "chacha20", chacha20_init, chacha20_run, 0x2fcab6a5UL, EMBENCH_LOOPS(100) },
+    { "sha256", sha256_init, sha256_run, 0xcb2c2e46UL, EMBENCH_LOOPS(100) },
+    { "lzss", lzss_init, lzss_run, 0x8afa9556UL, EMBENCH_LOOPS(50) },
+    { "matmult", matmult_init, matmult_run, 0xe306c151UL, EMBENCH_LOOPS(50) },
+    { "qsort", qsort_init, qsort_run, 0x6e3199e0UL, EMBENCH_LOOPS(50) },
+    { "lexfsm", lexfsm_init, lexfsm_run, 0x2421cc81UL, EMBENCH_LOOPS(100) },
+};
+
+#define EMBENCH_NUM             (sizeof(workloads) / sizeof(workloads[0]))
+
+static uint32_t embench_seed;
+
+/* checksums of timed runs are stored here, so the iterations are not optimized away */
+static volatile uint32_t embench_sink;
+
+void embench_srand(uint32_t seed)
+{
+    embench_seed = seed;
+}
+
+uint32_t embench_rand(void)
+{
+    embench_seed = embench_seed * 1664525UL + 1013904223UL;
+    return embench_seed;
+}
+
+int main(void)
+{
+    const embench_workload_t *w;
+    uint32_t i, n, res, fails = 0;
+    uint64_t cyc;
+    double logsum = 0.0;
+
+    BENCH_INIT();
+    for (i = 0; i < EMBENCH_NUM; i++) {
+        w = &workloads[i];
+        // same input whatever workloads run before
+        embench_srand(1);
+        w->init();
+        res = w->run();
+        BENCH_START(embench);
+        for (n = 0; n < w->loops; n++) {
+            embench_sink = w->run();
+        }
+        BENCH_SAMPLE(embench);
+        cyc = BENCH_GET_USECYC() / w->loops;
+        if ((res != w->check) || (embench_sink != w->check)) {
+            fails++;
+        }
+        printf("EMBENCH, %s, %lu, %lu, %s\n", w->name, (unsigned long)w->loops, (unsigned long)cyc,
+               (res == w->check) ? "PASS" : "FAIL");
+        if (res != w->check) {
+            printf("%s checksum 0x%08lx, expected 0x%08lx\n", w->name, (unsigned long)res, (unsigned long)w->check);
+        }
+        logsum += log((double)((cyc == 0) ? 1 : cyc));
+    }
+    printf("EMBENCH, geomean, %lu\n", (unsigned long)exp(logsum / EMBENCH_NUM));
+    if (fails) {
+        BENCH_ERROR(embench);
+    }
+    BENCH_STATUS(embench);
+    return 0;
+}
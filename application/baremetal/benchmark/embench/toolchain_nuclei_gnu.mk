@@ -0,0 +1 @@
+BENCH_FLAGS ?= -O2 -falign-functions=8 -falign-jumps=8 -falign-loops=8
@@ -0,0 +1 @@
+BENCH_FLAGS ?= -O2
@@ -0,0 +1,90 @@
+// See LICENSE for license details.
+#include "workloads.h"
+
+/* ChaCha20 of RFC 8439, encrypt a buffer in place with 64 byte key stream blocks */
+#define CHACHA20_WORDS          128
+
+static uint32_t chacha20_key[8];
+static uint32_t chacha20_nonce[3];
+static uint32_t chacha20_buf[CHACHA20_WORDS];
+
+#define CHACHA20_ROTL(x, n)     (((x) << (n)) | ((x) >> (32 - (n))))
+
+#define CHACHA20_QR(a, b, c, d) \
+    do { \
+        a += b; d ^= a; d = CHACHA20_ROTL(d, 16); \
+        c += d; b ^= c; b = CHACHA20_ROTL(b, 12); \
+        a += b; d ^= a; d = CHACHA20_ROTL(d, 8); \
+        c += d; b ^= c; b = CHACHA20_ROTL(b, 7); \
+    } while (0)
+
+void chacha20_init(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < 8; i++) {
+        chacha20_key[i] = embench_rand();
+    }
+    for (i = 0; i < 3; i++) {
+        chacha20_nonce[i] = embench_rand();
+    }
+    for (i = 0; i < CHACHA20_WORDS; i++) {
+        chacha20_buf[i] = embench_rand();
+    }
+}
+
+static void chacha20_block(uint32_t counter, uint32_t out[16])
+{
+    uint32_t x[16];
+    uint32_t i;
+
+    x[0] = 0x61707865UL;
+    x[1] = 0x3320646eUL;
+    x[2] = 0x79622d32UL;
+    x[3] = 0x6b206574UL;
+    for (i = 0; i < 8; i++) {
+        x[4 + i] = chacha20_key[i];
+    }
+    x[12] = counter;
+    x[13] = chacha20_nonce[0];
+    x[14] = chacha20_nonce[1];
+    x[15] = chacha20_nonce[2];
+    for (i = 0; i < 16; i++) {
+        out[i] = x[i];
+    }
+    for (i = 0; i < 10; i++) {
+        CHACHA20_QR(x[0], x[4], x[8], x[12]);
+        CHACHA20_QR(x[1], x[5], x[9], x[13]);
+        CHACHA20_QR(x[2], x[6], x[10], x[14]);
+        CHACHA20_QR(x[3], x[7], x[11], x[15]);
+        CHACHA20_QR(x[0], x[5], x[10], x[15]);
+        CHACHA20_QR(x[1], x[6], x[11], x[12]);
+        CHACHA20_QR(x[2], x[7], x[8], x[13]);
+        CHACHA20_QR(x[3], x[4], x[9], x[14]);
+    }
+    for (i = 0; i < 16; i++) {
+        out[i] += x[i];
+    }
+}
+
+uint32_t chacha20_run(void)
+{
+    uint32_t ks[16];
+    uint32_t i, j, sum = 0;
+
+    /* encrypt then decrypt, the buffer is unchanged across iterations */
+    for (i = 0; i < CHACHA20_WORDS; i += 16) {
+        chacha20_block(1 + i / 16, ks);
+        for (j = 0; j < 16; j++) {
+            chacha20_buf[i + j] ^= ks[j];
+            sum = CHACHA20_ROTL(sum, 5) ^ chacha20_buf[i + j];
+        }
+    }
+    for (i = 0; i < CHACHA20_WORDS; i += 16) {
+        chacha20_block(1 + i / 16, ks);
+        for (j = 0; j < 16; j++) {
+            chacha20_buf[i + j] ^= ks[j];
+        }
+    }
+    return sum;
+}
@@ -0,0 +1,42 @@
+// See LICENSE for license details.
+#include "workloads.h"
+
+/* CRC-32 of IEEE 802.3, reflected, one table lookup per byte */
+#define CRC32_POLY              0xEDB88320UL
+#define CRC32_LEN               1024
+
+static uint32_t crc32_table[256];
+static uint8_t crc32_data[CRC32_LEN];
+
+void crc32_init(void)
+{
+    uint32_t i, j, c;
+
+    for (i = 0; i < 256; i++) {
+        c = i;
+        for (j = 0; j < 8; j++) {
+            c = (c & 1) ? ((c >> 1) ^ CRC32_POLY) : (c >> 1);
+        }
+        crc32_table[i] = c;
+    }
+    for (i = 0; i < CRC32_LEN; i++) {
+        crc32_data[i] = (uint8_t)(embench_rand() >> 24);
+    }
+}
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *p, uint32_t len)
+{
+    while (len--) {
+        crc = crc32_table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+uint32_t crc32_run(void)
+{
+    uint32_t crc;
+
+    /* the whole buffer, then the first half again as a second message */
+    crc = crc32_update(0xFFFFFFFFUL, crc32_data, CRC32_LEN) ^ 0xFFFFFFFFUL;
+    return crc ^ crc32_update(0xFFFFFFFFUL, crc32_data, CRC32_LEN / 2) ^ 0xFFFFFFFFUL;
+}
@@ -0,0 +1,207 @@
+// See LICENSE for license details.
+#include "workloads.h"
+
+/*
+ * Lexer state machine over generated C like text, one state transition per character,
+ * classes of characters by table, counts of each token kind make the checksum
+ */
+#define LEXFSM_LEN              2048
+
+typedef enum {
+    LEXFSM_START = 0,
+    LEXFSM_IDENT,
+    LEXFSM_NUMBER,
+    LEXFSM_HEX,
+    LEXFSM_STRING,
+    LEXFSM_ESCAPE,
+    LEXFSM_SLASH,
+    LEXFSM_LINE_COMMENT,
+    LEXFSM_BLOCK_COMMENT,
+    LEXFSM_BLOCK_STAR,
+    LEXFSM_OPERATOR
+} lexfsm_state_t;
+
+typedef enum {
+    LEXFSM_TOK_IDENT = 0,
+    LEXFSM_TOK_NUMBER,
+    LEXFSM_TOK_STRING,
+    LEXFSM_TOK_COMMENT,
+    LEXFSM_TOK_OPERATOR,
+    LEXFSM_TOK_PUNCT,
+    LEXFSM_TOK_NUM
+} lexfsm_token_t;
+
+/* character classes */
+#define LEXFSM_C_OTHER          0
+#define LEXFSM_C_ALPHA          1
+#define LEXFSM_C_DIGIT          2
+#define LEXFSM_C_SPACE          3
+#define LEXFSM_C_QUOTE          4
+#define LEXFSM_C_SLASH          5
+#define LEXFSM_C_STAR           6
+#define LEXFSM_C_OP             7
+#define LEXFSM_C_PUNCT          8
+#define LEXFSM_C_NEWLINE        9
+#define LEXFSM_C_BACKSLASH      10
+
+static const char *const lexfsm_fragments[16] = {
+    "int ", "x1 ", "= ", "0x1F", " + ", "42", ";\n", "/* scale */",
+    "if (", "y >= ", "\"a\\\"b\"", ") {\n", "}\n", "// next\n", "count++", " * "
+};
+
+static uint8_t lexfsm_class[128];
+static char lexfsm_text[LEXFSM_LEN];
+
+void lexfsm_init(void)
+{
+    uint32_t c, n = 0;
+    const char *f;
+
+    for (c = 0; c < 128; c++) {
+        if (((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || (c == '_')) {
+            lexfsm_class[c] = LEXFSM_C_ALPHA;
+        } else if ((c >= '0') && (c <= '9')) {
+            lexfsm_class[c] = LEXFSM_C_DIGIT;
+        } else if ((c == ' ') || (c == '\t')) {
+            lexfsm_class[c] = LEXFSM_C_SPACE;
+        } else if (c == '\n') {
+            lexfsm_class[c] = LEXFSM_C_NEWLINE;
+        } else if (c == '"') {
+            lexfsm_class[c] = LEXFSM_C_QUOTE;
+        } else if (c == '/') {
+            lexfsm_class[c] = LEXFSM_C_SLASH;
+        } else if (c == '*') {
+            lexfsm_class[c] = LEXFSM_C_STAR;
+        } else if (c == '\\') {
+            lexfsm_class[c] = LEXFSM_C_BACKSLASH;
+        } else if ((c == '+') || (c == '-') || (c == '=') || (c == '<') || (c == '>') || (c == '!') ||
+                   (c == '&') || (c == '|')) {
+            lexfsm_class[c] = LEXFSM_C_OP;
+        } else if ((c == '(') || (c == ')') || (c == '{') || (c == '}') || (c == ';') || (c == ',')) {
+            lexfsm_class[c] = LEXFSM_C_PUNCT;
+        } else {
+            lexfsm_class[c] = LEXFSM_C_OTHER;
+        }
+    }
+    while (n < LEXFSM_LEN - 1) {
+        f = lexfsm_fragments[embench_rand() >> 28];
+        while ((*f != '\0') && (n < LEXFSM_LEN - 1)) {
+            lexfsm_text[n++] = *f++;
+        }
+    }
+    lexfsm_text[n] = '\0';
+}
+
+/* state after a token ended at character of class cls, which starts the next one */
+static lexfsm_state_t lexfsm_begin(uint32_t cls, uint32_t count[LEXFSM_TOK_NUM])
+{
+    switch (cls) {
+        case LEXFSM_C_ALPHA:
+            return LEXFSM_IDENT;
+        case LEXFSM_C_DIGIT:
+            return LEXFSM_NUMBER;
+        case LEXFSM_C_QUOTE:
+            return LEXFSM_STRING;
+        case LEXFSM_C_SLASH:
+            return LEXFSM_SLASH;
+        case LEXFSM_C_OP:
+        case LEXFSM_C_STAR:
+            return LEXFSM_OPERATOR;
+        case LEXFSM_C_PUNCT:
+            count[LEXFSM_TOK_PUNCT]++;
+            return LEXFSM_START;
+        default:
+            return LEXFSM_START;
+    }
+}
+
+uint32_t lexfsm_run(void)
+{
+    uint32_t count[LEXFSM_TOK_NUM] = { 0 };
+    lexfsm_state_t st = LEXFSM_START;
+    const char *p = lexfsm_text;
+    uint32_t c, cls, i, sum = 0;
+
+    for (; *p != '\0'; p++) {
+        c = (uint8_t)*p;
+        cls = (c < 128) ? lexfsm_class[c] : LEXFSM_C_OTHER;
+        switch (st) {
+            case LEXFSM_START:
+                st = lexfsm_begin(cls, count);
+                break;
+            case LEXFSM_IDENT:
+                if ((cls != LEXFSM_C_ALPHA) && (cls != LEXFSM_C_DIGIT)) {
+                    count[LEXFSM_TOK_IDENT]++;
+                    st = lexfsm_begin(cls, count);
+                }
+                break;
+            case LEXFSM_NUMBER:
+                if (((c == 'x') || (c == 'X')) && (p[-1] == '0')) {
+                    st = LEXFSM_HEX;
+                } else if (cls != LEXFSM_C_DIGIT) {
+                    count[LEXFSM_TOK_NUMBER]++;
+                    st = lexfsm_begin(cls, count);
+                }
+                break;
+            case LEXFSM_HEX:
+                if ((cls != LEXFSM_C_DIGIT) && !(((c | 0x20) >= 'a') && ((c | 0x20) <= 'f'))) {
+                    count[LEXFSM_TOK_NUMBER]++;
+                    st = lexfsm_begin(cls, count);
+                }
+                break;
+            case LEXFSM_STRING:
+                if (cls == LEXFSM_C_BACKSLASH) {
+                    st = LEXFSM_ESCAPE;
+                } else if (cls == LEXFSM_C_QUOTE) {
+                    count[LEXFSM_TOK_STRING]++;
+                    st = LEXFSM_START;
+                }
+                break;
+            case LEXFSM_ESCAPE:
+                st = LEXFSM_STRING;
+                break;
+            case LEXFSM_SLASH:
+                if (cls == LEXFSM_C_SLASH) {
+                    st = LEXFSM_LINE_COMMENT;
+                } else if (cls == LEXFSM_C_STAR) {
+                    st = LEXFSM_BLOCK_COMMENT;
+                } else {
+                    count[LEXFSM_TOK_OPERATOR]++;
+                    st = lexfsm_begin(cls, count);
+                }
+                break;
+            case LEXFSM_LINE_COMMENT:
+                if (cls == LEXFSM_C_NEWLINE) {
+                    count[LEXFSM_TOK_COMMENT]++;
+                    st = LEXFSM_START;
+                }
+                break;
+            case LEXFSM_BLOCK_COMMENT:
+                if (cls == LEXFSM_C_STAR) {
+                    st = LEXFSM_BLOCK_STAR;
+                }
+                break;
+            case LEXFSM_BLOCK_STAR:
+                if (cls == LEXFSM_C_SLASH) {
+                    count[LEXFSM_TOK_COMMENT]++;
+                    st = LEXFSM_START;
+                } else if (cls != LEXFSM_C_STAR) {
+                    st = LEXFSM_BLOCK_COMMENT;
+                }
+                break;
+            case LEXFSM_OPERATOR:
+                if ((cls != LEXFSM_C_OP) && (cls != LEXFSM_C_STAR)) {
+                    count[LEXFSM_TOK_OPERATOR]++;
+                    st = lexfsm_begin(cls, count);
+                }
+                break;
+            default:
+                st = LEXFSM_START;
+                break;
+        }
+    }
+    for (i = 0; i < LEXFSM_TOK_NUM; i++) {
+        sum = sum * 1021 + count[i];
+    }
+    return sum;
+}
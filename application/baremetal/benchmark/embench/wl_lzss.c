@@ -0,0 +1,126 @@
+// See LICENSE for license details.
+#include "workloads.h"
+
+/*
+ * LZSS compression and decompression of generated text, greedy matching by a hash of 3
+ * bytes. A flag byte leads each 8 items, bit set for a match of 2 bytes, 12 bit distance
+ * and 4 bit length - LZSS_MIN_MATCH, else a literal byte.
+ */
+#define LZSS_LEN                2048
+#define LZSS_MIN_MATCH          3
+#define LZSS_MAX_MATCH          (LZSS_MIN_MATCH + 15)
+#define LZSS_WINDOW             4096
+#define LZSS_HASH_BITS          10
+
+static const char *const lzss_words[16] = {
+    "the ", "sensor ", "value ", "is ", "read ", "every ", "tick ", "and ",
+    "stored ", "in ", "a ", "ring ", "buffer ", "of ", "samples ", ". "
+};
+
+static uint8_t lzss_text[LZSS_LEN];
+static uint8_t lzss_packed[LZSS_LEN + LZSS_LEN / 8 + 1];
+static uint8_t lzss_unpacked[LZSS_LEN];
+static uint16_t lzss_head[1 << LZSS_HASH_BITS];
+
+void lzss_init(void)
+{
+    uint32_t n = 0;
+    const char *w;
+
+    while (n < LZSS_LEN) {
+        w = lzss_words[embench_rand() >> 28];
+        while ((*w != '\0') && (n < LZSS_LEN)) {
+            lzss_text[n++] = (uint8_t)*w++;
+        }
+    }
+}
+
+static uint32_t lzss_hash(const uint8_t *p)
+{
+    uint32_t x = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+
+    return (uint32_t)(x * 2654435761UL) >> (32 - LZSS_HASH_BITS);
+}
+
+static uint32_t lzss_compress(const uint8_t *src, uint32_t len, uint8_t *dst)
+{
+    uint32_t i = 0, o = 0, flag = 0, bit = 0, h, cand, dist, m;
+
+    for (h = 0; h < (1U << LZSS_HASH_BITS); h++) {
+        lzss_head[h] = 0xFFFF;
+    }
+    while (i < len) {
+        if (bit == 0) {
+            flag = o++;
+            dst[flag] = 0;
+        }
+        m = 0;
+        if (i + LZSS_MIN_MATCH <= len) {
+            h = lzss_hash(src + i);
+            cand = lzss_head[h];
+            lzss_head[h] = (uint16_t)i;
+            if ((cand != 0xFFFF) && (i - cand <= LZSS_WINDOW)) {
+                while ((m < LZSS_MAX_MATCH) && (i + m < len) && (src[cand + m] == src[i + m])) {
+                    m++;
+                }
+            }
+        }
+        if (m >= LZSS_MIN_MATCH) {
+            dist = i - cand - 1;
+            dst[flag] |= (uint8_t)(1U << bit);
+            dst[o++] = (uint8_t)(dist >> 4);
+            dst[o++] = (uint8_t)(((dist & 0xF) << 4) | (m - LZSS_MIN_MATCH));
+            i += m;
+        } else {
+            dst[o++] = src[i++];
+        }
+        bit = (bit + 1) & 7;
+    }
+    return o;
+}
+
+static uint32_t lzss_decompress(const uint8_t *src, uint32_t len, uint8_t *dst)
+{
+    uint32_t i = 0, o = 0, flag = 0, bit = 0, dist, m;
+
+    while (i < len) {
+        if (bit == 0) {
+            flag = src[i++];
+            if (i >= len) {
+                break;
+            }
+        }
+        if (flag & (1U << bit)) {
+            dist = ((uint32_t)src[i] << 4) | (src[i + 1] >> 4);
+            m = (src[i + 1] & 0xF) + LZSS_MIN_MATCH;
+            i += 2;
+            while (m--) {
+                dst[o] = dst[o - dist - 1];
+                o++;
+            }
+        } else {
+            dst[o++] = src[i++];
+        }
+        bit = (bit + 1) & 7;
+    }
+    return o;
+}
+
+uint32_t lzss_run(void)
+{
+    uint32_t plen, ulen, i, sum;
+
+    plen = lzss_compress(lzss_text, LZSS_LEN, lzss_packed);
+    ulen = lzss_decompress(lzss_packed, plen, lzss_unpacked);
+    if (ulen != LZSS_LEN) {
+        return 0;
+    }
+    sum = plen;
+    for (i = 0; i < LZSS_LEN; i++) {
+        if (lzss_unpacked[i] != lzss_text[i]) {
+            return 0;
+        }
+        sum = sum * 31 + lzss_packed[i % plen];
+    }
+    return sum;
+}
@@ -0,0 +1,43 @@
+// See LICENSE for license details.
+#include "workloads.h"
+
+/* integer matrix product C = A * B of 20 x 20 matrices, as matmult-int of Embench */
+#define MATMULT_DIM             20
+
+static int32_t matmult_a[MATMULT_DIM][MATMULT_DIM];
+static int32_t matmult_b[MATMULT_DIM][MATMULT_DIM];
+static int32_t matmult_c[MATMULT_DIM][MATMULT_DIM];
+
+void matmult_init(void)
+{
+    uint32_t i, j;
+
+    for (i = 0; i < MATMULT_DIM; i++) {
+        for (j = 0; j < MATMULT_DIM; j++) {
+            matmult_a[i][j] = (int32_t)(embench_rand() >> 20) - 2048;
+            matmult_b[i][j] = (int32_t)(embench_rand() >> 20) - 2048;
+        }
+    }
+}
+
+uint32_t matmult_run(void)
+{
+    uint32_t i, j, k, sum = 0;
+    int32_t acc;
+
+    for (i = 0; i < MATMULT_DIM; i++) {
+        for (j = 0; j < MATMULT_DIM; j++) {
+            acc = 0;
+            for (k = 0; k < MATMULT_DIM; k++) {
+                acc += matmult_a[i][k] * matmult_b[k][j];
+            }
+            matmult_c[i][j] = acc;
+        }
+    }
+    for (i = 0; i < MATMULT_DIM; i++) {
+        for (j = 0; j < MATMULT_DIM; j++) {
+            sum = (sum << 1 | sum >> 31) ^ (uint32_t)matmult_c[i][j];
+        }
+    }
+    return sum;
+}
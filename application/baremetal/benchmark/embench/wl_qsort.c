@@ -0,0 +1,113 @@
+// See LICENSE for license details.
+#include "workloads.h"
+
+/*
+ * Sort of random keys, quicksort of median of three pivots with an explicit stack, the
+ * partitions below QSORT_SMALL keys are finished by insertion sort
+ */
+#define QSORT_LEN               1024
+#define QSORT_SMALL             12
+
+static uint32_t qsort_master[QSORT_LEN];
+static uint32_t qsort_keys[QSORT_LEN];
+
+void qsort_init(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < QSORT_LEN; i++) {
+        qsort_master[i] = embench_rand();
+    }
+}
+
+static void qsort_swap(uint32_t *a, uint32_t *b)
+{
+    uint32_t t = *a;
+
+    *a = *b;
+    *b = t;
+}
+
+static void qsort_insertion(uint32_t *a, int32_t lo, int32_t hi)
+{
+    int32_t i, j;
+    uint32_t v;
+
+    for (i = lo + 1; i <= hi; i++) {
+        v = a[i];
+        for (j = i - 1; (j >= lo) && (a[j] > v); j--) {
+            a[j + 1] = a[j];
+        }
+        a[j + 1] = v;
+    }
+}
+
+static void qsort_sort(uint32_t *a, int32_t n)
+{
+    /* the larger partition is pushed and the smaller one sorted first, so the depth is at most log2(n) */
+    int32_t stack[2 * 32];
+    int32_t sp = 0, lo, hi, mid, i, j;
+    uint32_t pivot;
+
+    stack[sp++] = 0;
+    stack[sp++] = n - 1;
+    while (sp > 0) {
+        hi = stack[--sp];
+        lo = stack[--sp];
+        while (hi - lo >= QSORT_SMALL) {
+            mid = lo + (hi - lo) / 2;
+            if (a[mid] < a[lo]) {
+                qsort_swap(&a[mid], &a[lo]);
+            }
+            if (a[hi] < a[lo]) {
+                qsort_swap(&a[hi], &a[lo]);
+            }
+            if (a[hi] < a[mid]) {
+                qsort_swap(&a[hi], &a[mid]);
+            }
+            pivot = a[mid];
+            i = lo;
+            j = hi;
+            while (i <= j) {
+                while (a[i] < pivot) {
+                    i++;
+                }
+                while (a[j] > pivot) {
+                    j--;
+                }
+                if (i <= j) {
+                    qsort_swap(&a[i], &a[j]);
+                    i++;
+                    j--;
+                }
+            }
+            if (j - lo < hi - i) {
+                stack[sp++] = i;
+                stack[sp++] = hi;
+                hi = j;
+            } else {
+                stack[sp++] = lo;
+                stack[sp++] = j;
+                lo = i;
+            }
+        }
+        qsort_insertion(a, lo, hi);
+    }
+}
+
+uint32_t qsort_run(void)
+{
+    uint32_t i, sum = 0;
+
+    for (i = 0; i < QSORT_LEN; i++) {
+        qsort_keys[i] = qsort_master[i];
+    }
+    qsort_sort(qsort_keys, QSORT_LEN);
+    for (i = 0; i < QSORT_LEN; i++) {
+        if ((i > 0) && (qsort_keys[i - 1] > qsort_keys[i])) {
+            return 0;
+        }
+        sum = sum * 33 + qsort_keys[i];
+    }
+    return sum;
+}
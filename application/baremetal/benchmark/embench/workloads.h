@@ -0,0 +1,46 @@
+// See LICENSE for license details.
+#ifndef __EMBENCH_WORKLOADS_H__
+#define __EMBENCH_WORKLOADS_H__
+
+#include <stdint.h>
+
+/*
+ * Each workload is one wl_<name>.c, all of its functions and data are named <name>_*, so
+ * tools/scripts/benchsize.py can sum its code and data size from the symbols of the elf.
+ * init() builds the input and is not timed, run() is one iteration and returns a checksum
+ * of its results, which is checked against the one of the host build.
+ */
+typedef struct {
+    const char *name;
+    void (*init)(void);
+    uint32_t (*run)(void);
+    uint32_t check;                 /* checksum of run() */
+    uint32_t loops;                 /* iterations of a timed run */
+} embench_workload_t;
+
+/* deterministic input generator of all workloads */
+uint32_t embench_rand(void);
+void embench_srand(uint32_t seed);
+
+void crc32_init(void);
+uint32_t crc32_run(void);
+
+void chacha20_init(void);
+uint32_t chacha20_run(void);
+
+void sha256_init(void);
+uint32_t sha256_run(void);
+
+void lzss_init(void);
+uint32_t lzss_run(void);
+
+void matmult_init(void);
+uint32_t matmult_run(void);
+
+void qsort_init(void);
+uint32_t qsort_run(void);
+
+void lexfsm_init(void);
+uint32_t lexfsm_run(void);
+
+#endif /* __EMBENCH_WORKLOADS_H__ */
@@ -0,0 +1,171 @@
+// See LICENSE for license details.
+#include <stdio.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "riscv_math.h"
+#include "riscv_vec_fft.h"
+#include "riscv_vec_f16.h"
+
+#if !defined(__riscv_zvfh) || !defined(RISCV_FLOAT16_SUPPORTED)
+#error "f16 vector kernels need Zfh and Zvfh, please build with ARCH_EXT=v_zfh_zvfh"
+#endif
+
+#ifdef CFG_SIMULATION
+#define VEC_LEN                 256
+#define FIR_TAPS                16
+#define FFT_LEN                 64
+#else
+#define VEC_LEN                 4096
+#define FIR_TAPS                64
+#define FFT_LEN                 1024
+#endif
+
+static float32_t a32[2 * VEC_LEN], b32[2 * VEC_LEN], o32[2 * VEC_LEN];
+static float16_t a16[2 * VEC_LEN], b16[2 * VEC_LEN], o16[2 * VEC_LEN];
+static float32_t coef32[FIR_TAPS], state32[FIR_TAPS + VEC_LEN - 1];
+static float16_t coef16[FIR_TAPS], state16[FIR_TAPS + VEC_LEN - 1];
+static float32_t tw32[2 * FFT_LEN];
+static float16_t tw16[2 * FFT_LEN];
+static uint32_t perm[FFT_LEN];
+
+static uint64_t start, cyc32, cyc16;
+
+#define BENCH_START()           (start = __get_rv_cycle())
+#define BENCH_END(cyc)          ((cyc) = __get_rv_cycle() - start)
+
+static void fill(float32_t *buf, float16_t *buf16, uint32_t len, uint32_t seed)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        seed = seed * 1103515245 + 12345;
+        buf[i] = (float32_t)((int32_t)(seed >> 16) & 0x7FFF) / 32768.0f - 0.5f;
+        // both sides start from the same values, so errors come from f16 arithmetic only
+        buf16[i] = (float16_t)buf[i];
+        buf[i] = (float32_t)buf16[i];
+    }
+}
+
+/*
+ * print one row of result, the error is the max difference of f16 to f32 in parts per
+ * million of the f32 peak, the speedup is in percent of f32 cycles
+ */
+static void report(const char *name, const float32_t *ref, const float16_t *out, uint32_t len)
+{
+    float32_t err = 0.0f, peak = 0.0f, d;
+
+    for (uint32_t i = 0; i < len; i++) {
+        d = ref[i] - (float32_t)out[i];
+        d = (d < 0.0f) ? -d : d;
+        err = (d > err) ? d : err;
+        d = (ref[i] < 0.0f) ? -ref[i] : ref[i];
+        peak = (d > peak) ? d : peak;
+    }
+    printf("%-16s f32 %8lu, f16 %8lu cycles, speedup %3lu%%, error %6lu ppm\n", name, (unsigned long)cyc32,
+           (unsigned long)cyc16, (unsigned long)((cyc32 * 100) / (cyc16 ? cyc16 : 1)),
+           (unsigned long)((peak > 0.0f) ? (err * 1000000.0f / peak) : 0.0f));
+}
+
+static void bench_basic(void)
+{
+    float32_t r32;
+    float16_t r16;
+
+    BENCH_START();
+    riscv_add_f32(a32, b32, o32, VEC_LEN);
+    BENCH_END(cyc32);
+    BENCH_START();
+    riscv_vec_add_f16(a16, b16, o16, VEC_LEN);
+    BENCH_END(cyc16);
+    report("add", o32, o16, VEC_LEN);
+
+    BENCH_START();
+    riscv_mult_f32(a32, b32, o32, VEC_LEN);
+    BENCH_END(cyc32);
+    BENCH_START();
+    riscv_vec_mult_f16(a16, b16, o16, VEC_LEN);
+    BENCH_END(cyc16);
+    report("mult", o32, o16, VEC_LEN);
+
+    BENCH_START();
+    riscv_scale_f32(a32, 0.75f, o32, VEC_LEN);
+    BENCH_END(cyc32);
+    BENCH_START();
+    riscv_vec_scale_f16(a16, (float16_t)0.75f, o16, VEC_LEN);
+    BENCH_END(cyc16);
+    report("scale", o32, o16, VEC_LEN);
+
+    BENCH_START();
+    riscv_dot_prod_f32(a32, b32, VEC_LEN, &r32);
+    BENCH_END(cyc32);
+    BENCH_START();
+    riscv_vec_dot_prod_f16(a16, b16, VEC_LEN, &r16);
+    BENCH_END(cyc16);
+    report("dot_prod", &r32, &r16, 1);
+
+    BENCH_START();
+    riscv_cmplx_mult_cmplx_f32(a32, b32, o32, VEC_LEN);
+    BENCH_END(cyc32);
+    BENCH_START();
+    riscv_vec_cmplx_mult_cmplx_f16(a16, b16, o16, VEC_LEN);
+    BENCH_END(cyc16);
+    report("cmplx_mult", o32, o16, 2 * VEC_LEN);
+
+    BENCH_START();
+    riscv_cmplx_mag_squared_f32(a32, o32, VEC_LEN);
+    BENCH_END(cyc32);
+    BENCH_START();
+    riscv_vec_cmplx_mag_squared_f16(a16, o16, VEC_LEN);
+    BENCH_END(cyc16);
+    report("cmplx_mag_sq", o32, o16, VEC_LEN);
+}
+
+static void bench_fir(void)
+{
+    riscv_fir_instance_f32 S32;
+    riscv_fir_instance_f16 S16;
+
+    fill(coef32, coef16, FIR_TAPS, 5);
+    riscv_fir_init_f32(&S32, FIR_TAPS, coef32, state32, VEC_LEN);
+    memset(state16, 0, sizeof(state16));
+    S16.numTaps = FIR_TAPS;
+    S16.pState = state16;
+    S16.pCoeffs = coef16;
+
+    BENCH_START();
+    riscv_fir_f32(&S32, a32, o32, VEC_LEN);
+    BENCH_END(cyc32);
+    BENCH_START();
+    riscv_vec_fir_f16(&S16, a16, o16, VEC_LEN);
+    BENCH_END(cyc16);
+    report("fir", o32, o16, VEC_LEN);
+}
+
+static void bench_fft(void)
+{
+    riscv_vec_cfft_instance_f32 S32;
+    riscv_vec_cfft_instance_f16 S16;
+
+    // the FFT works in place of its input, inputs are refilled and outputs go to b
+    riscv_vec_cfft_init_f32(&S32, FFT_LEN, tw32, perm);
+    riscv_vec_cfft_init_f16(&S16, FFT_LEN, tw16, perm);
+    fill(a32, a16, 2 * FFT_LEN, 6);
+
+    BENCH_START();
+    riscv_vec_cfft_f32(&S32, a32, b32, 0);
+    BENCH_END(cyc32);
+    BENCH_START();
+    riscv_vec_cfft_f16(&S16, a16, b16, 0);
+    BENCH_END(cyc16);
+    report("cfft", b32, b16, 2 * FFT_LEN);
+}
+
+int main(void)
+{
+    fill(a32, a16, 2 * VEC_LEN, 1);
+    fill(b32, b16, 2 * VEC_LEN, 2);
+    printf("f16 vector kernels against f32, %d samples\n", VEC_LEN);
+    bench_basic();
+    bench_fir();
+    bench_fft();
+    printf("f16 benchmark finished\n");
+    return 0;
+}
@@ -0,0 +1,219 @@
+// See LICENSE for license details.
+#include <stdio.h>
+#include "nuclei_sdk_soc.h"
+#include "nmsis_bench.h"
+
+#if defined(__ECLIC_PRESENT) && (__ECLIC_PRESENT == 1)
+#else
+#error "This example require CPU ECLIC feature"
+#endif
+
+#if defined(__SYSTIMER_PRESENT) && (__SYSTIMER_PRESENT == 1)
+#else
+#error "This example require CPU System Timer feature"
+#endif
+
+#ifdef CFG_SIMULATION
+#define RUN_LOOPS               20
+#else
+#define RUN_LOOPS               1000
+#endif
+
+// Cycle width and count of histogram buckets for interrupt entry latency
+#define ENTRY_HIST_WIDTH        4
+#define ENTRY_HIST_BUCKETS      64
+// Cycle width and count of histogram buckets for interrupt round-trip latency
+#define RTRIP_HIST_WIDTH        8
+#define RTRIP_HIST_BUCKETS      128
+
+#define SWIRQ_INTLEVEL          1
+
+// Cycle width and count of histogram buckets for ra/s0-s11 context save and restore
+#define CTXSAVE_HIST_WIDTH      2
+#define CTXSAVE_HIST_BUCKETS    64
+
+BENCH_DECLARE_VAR();
+
+BENCH_HIST_DECLARE(vector_entry, ENTRY_HIST_WIDTH, ENTRY_HIST_BUCKETS);
+BENCH_HIST_DECLARE(vector_roundtrip, RTRIP_HIST_WIDTH, RTRIP_HIST_BUCKETS);
+BENCH_HIST_DECLARE(nonvector_entry, ENTRY_HIST_WIDTH, ENTRY_HIST_BUCKETS);
+BENCH_HIST_DECLARE(nonvector_roundtrip, RTRIP_HIST_WIDTH, RTRIP_HIST_BUCKETS);
+#if defined(__riscv_zcmp)
+BENCH_HIST_DECLARE(ctxsave_store, CTXSAVE_HIST_WIDTH, CTXSAVE_HIST_BUCKETS);
+BENCH_HIST_DECLARE(ctxsave_zcmp, CTXSAVE_HIST_WIDTH, CTXSAVE_HIST_BUCKETS);
+#endif
+
+static volatile uint64_t irq_entry_cycle = 0;
+static volatile uint32_t irq_done = 0;
+
+// timer software interrupt handler
+// vector mode interrupt, no nested interrupt is allowed
+__INTERRUPT void eclic_msip_vector_handler(void)
+{
+    irq_entry_cycle = __get_rv_cycle();
+    SysTimer_ClearSWIRQ();
+    irq_done = 1;
+}
+
+// timer software interrupt handler
+// non-vector mode interrupt, entered through common interrupt entry
+void eclic_msip_nonvector_handler(void)
+{
+    irq_entry_cycle = __get_rv_cycle();
+    SysTimer_ClearSWIRQ();
+    irq_done = 1;
+}
+
+// trigger software interrupt and wait for it handled
+// entry: cycles from triggering to the first instruction of handler body
+// roundtrip: cycles from triggering to the interrupt returned
+static void measure_swirq(uint64_t *entry, uint64_t *roundtrip)
+{
+    uint64_t start, end;
+
+    irq_done = 0;
+    __RWMB();
+    start = __get_rv_cycle();
+    SysTimer_SetSWIRQ();
+    while (irq_done == 0);
+    end = __get_rv_cycle();
+    *entry = __bench_remove_overhead(irq_entry_cycle - start, BENCH_GET_OVHCYC());
+    *roundtrip = __bench_remove_overhead(end - start, BENCH_GET_OVHCYC());
+}
+
+#if defined(__riscv_zcmp)
+/*
+ * Save and restore ra and callee saved registers like a RTOS context switch does,
+ * using store/load sequence or Zcmp cm.push/cm.pop, interrupt entry only saves
+ * caller saved registers which can't be saved by cm.push.
+ * Stack adjustment is the minimal one of cm.push rlist, rounded up to 16 bytes.
+ */
+#ifndef __riscv_32e
+#define CTXSAVE_RLIST           "{ra, s0-s11}"
+#if __riscv_xlen == 64
+#define CTXSAVE_STACK           "112"
+#else
+#define CTXSAVE_STACK           "64"
+#endif
+#define CTXSAVE_STORE_SREGS     STRINGIFY(STORE) " s2, 3*" STRINGIFY(REGBYTES) "(sp)\n"  \
+                                STRINGIFY(STORE) " s3, 4*" STRINGIFY(REGBYTES) "(sp)\n"  \
+                                STRINGIFY(STORE) " s4, 5*" STRINGIFY(REGBYTES) "(sp)\n"  \
+                                STRINGIFY(STORE) " s5, 6*" STRINGIFY(REGBYTES) "(sp)\n"  \
+                                STRINGIFY(STORE) " s6, 7*" STRINGIFY(REGBYTES) "(sp)\n"  \
+                                STRINGIFY(STORE) " s7, 8*" STRINGIFY(REGBYTES) "(sp)\n"  \
+                                STRINGIFY(STORE) " s8, 9*" STRINGIFY(REGBYTES) "(sp)\n"  \
+                                STRINGIFY(STORE) " s9, 10*" STRINGIFY(REGBYTES) "(sp)\n" \
+                                STRINGIFY(STORE) " s10, 11*" STRINGIFY(REGBYTES) "(sp)\n" \
+                                STRINGIFY(STORE) " s11, 12*" STRINGIFY(REGBYTES) "(sp)\n"
+#define CTXSAVE_LOAD_SREGS      STRINGIFY(LOAD) " s2, 3*" STRINGIFY(REGBYTES) "(sp)\n"  \
+                                STRINGIFY(LOAD) " s3, 4*" STRINGIFY(REGBYTES) "(sp)\n"  \
+                                STRINGIFY(LOAD) " s4, 5*" STRINGIFY(REGBYTES) "(sp)\n"  \
+                                STRINGIFY(LOAD) " s5, 6*" STRINGIFY(REGBYTES) "(sp)\n"  \
+                                STRINGIFY(LOAD) " s6, 7*" STRINGIFY(REGBYTES) "(sp)\n"  \
+                                STRINGIFY(LOAD) " s7, 8*" STRINGIFY(REGBYTES) "(sp)\n"  \
+                                STRINGIFY(LOAD) " s8, 9*" STRINGIFY(REGBYTES) "(sp)\n"  \
+                                STRINGIFY(LOAD) " s9, 10*" STRINGIFY(REGBYTES) "(sp)\n" \
+                                STRINGIFY(LOAD) " s10, 11*" STRINGIFY(REGBYTES) "(sp)\n" \
+                                STRINGIFY(LOAD) " s11, 12*" STRINGIFY(REGBYTES) "(sp)\n"
+#else
+#define CTXSAVE_RLIST           "{ra, s0-s1}"
+#define CTXSAVE_STACK           "16"
+#define CTXSAVE_STORE_SREGS     ""
+#define CTXSAVE_LOAD_SREGS      ""
+#endif
+
+__attribute__((noinline)) static uint64_t measure_ctxsave_store(void)
+{
+    uint64_t start = __get_rv_cycle();
+
+    __ASM volatile("addi sp, sp, -" CTXSAVE_STACK "\n"
+                   STRINGIFY(STORE) " ra, 0(sp)\n"
+                   STRINGIFY(STORE) " s0, 1*" STRINGIFY(REGBYTES) "(sp)\n"
+                   STRINGIFY(STORE) " s1, 2*" STRINGIFY(REGBYTES) "(sp)\n"
+                   CTXSAVE_STORE_SREGS
+                   STRINGIFY(LOAD) " ra, 0(sp)\n"
+                   STRINGIFY(LOAD) " s0, 1*" STRINGIFY(REGBYTES) "(sp)\n"
+                   STRINGIFY(LOAD) " s1, 2*" STRINGIFY(REGBYTES) "(sp)\n"
+                   CTXSAVE_LOAD_SREGS
+                   "addi sp, sp, " CTXSAVE_STACK "\n" ::: "memory");
+    return __bench_remove_overhead(__get_rv_cycle() - start, BENCH_GET_OVHCYC());
+}
+
+__attribute__((noinline)) static uint64_t measure_ctxsave_zcmp(void)
+{
+    uint64_t start = __get_rv_cycle();
+
+    __ASM volatile("cm.push " CTXSAVE_RLIST ", -" CTXSAVE_STACK "\n"
+                   "cm.pop " CTXSAVE_RLIST ", " CTXSAVE_STACK "\n" ::: "memory");
+    return __bench_remove_overhead(__get_rv_cycle() - start, BENCH_GET_OVHCYC());
+}
+#endif
+
+int main(void)
+{
+    uint64_t entry, roundtrip;
+    int32_t returnCode;
+
+    BENCH_INIT();
+
+    // vector mode software interrupt
+    returnCode = ECLIC_Register_IRQ(SysTimerSW_IRQn, ECLIC_VECTOR_INTERRUPT,
+                                    ECLIC_LEVEL_TRIGGER, SWIRQ_INTLEVEL, 0, (void*)eclic_msip_vector_handler);
+    if (returnCode != 0) {
+        printf("Unable to register vector software interrupt\n");
+        return -1;
+    }
+    __enable_irq();
+    // warm up caches and branch predictors, not recorded
+    measure_swirq(&entry, &roundtrip);
+    for (int i = 0; i < RUN_LOOPS; i ++) {
+        measure_swirq(&entry, &roundtrip);
+        BENCH_HIST_ADD(vector_entry, entry);
+        BENCH_HIST_ADD(vector_roundtrip, roundtrip);
+    }
+    __disable_irq();
+
+    // non-vector mode software interrupt
+    returnCode = ECLIC_Register_IRQ(SysTimerSW_IRQn, ECLIC_NON_VECTOR_INTERRUPT,
+                                    ECLIC_LEVEL_TRIGGER, SWIRQ_INTLEVEL, 0, (void*)eclic_msip_nonvector_handler);
+    if (returnCode != 0) {
+        printf("Unable to register non-vector software interrupt\n");
+        return -1;
+    }
+    __enable_irq();
+    measure_swirq(&entry, &roundtrip);
+    for (int i = 0; i < RUN_LOOPS; i ++) {
+        measure_swirq(&entry, &roundtrip);
+        BENCH_HIST_ADD(nonvector_entry, entry);
+        BENCH_HIST_ADD(nonvector_roundtrip, roundtrip);
+    }
+    __disable_irq();
+    ECLIC_DisableIRQ(SysTimerSW_IRQn);
+
+#if defined(__riscv_zcmp)
+    measure_ctxsave_store();
+    measure_ctxsave_zcmp();
+    for (int i = 0; i < RUN_LOOPS; i ++) {
+        BENCH_HIST_ADD(ctxsave_store, measure_ctxsave_store());
+        BENCH_HIST_ADD(ctxsave_zcmp, measure_ctxsave_zcmp());
+    }
+#endif
+
+    printf("Interrupt latency in cycles, %d loops\n", RUN_LOOPS);
+    printf("HIST, proc, cnt, mincyc, avgcyc, p50, p90, p99, maxcyc, overflow\n");
+    BENCH_HIST_STAT(vector_entry);
+    BENCH_HIST_STAT(vector_roundtrip);
+    BENCH_HIST_STAT(nonvector_entry);
+    BENCH_HIST_STAT(nonvector_roundtrip);
+#if defined(__riscv_zcmp)
+    BENCH_HIST_STAT(ctxsave_store);
+    BENCH_HIST_STAT(ctxsave_zcmp);
+#else
+    printf("Zcmp is not enabled in -march, context save with cm.push/cm.pop is not measured\n");
+#endif
+
+    BENCH_HIST_DUMP(vector_entry);
+    BENCH_HIST_DUMP(nonvector_entry);
+    printf("Interrupt latency benchmark finished\n");
+    return 0;
+}
@@ -0,0 +1,464 @@
+// See LICENSE for license details.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "nuclei_sdk_soc.h"
+#include "riscv_math.h"
+#include "riscv_nnfunctions.h"
+#include "ref_kernels.h"
+
+#include "nmsis_bench.h"
+
+BENCH_DECLARE_VAR();
+
+/*
+ * Sizes swept for each kernel family, the simulation sweep stops earlier to keep the run short,
+ * every table is walked to its first zero entry
+ */
+#ifdef CFG_SIMULATION
+#define FFT_MAX_LEN             256
+#define FIR_BLOCK_SIZE          64
+#define MAT_MAX_DIM             16
+#else
+#define FFT_MAX_LEN             4096
+#define FIR_BLOCK_SIZE          256
+#define MAT_MAX_DIM             64
+#endif
+
+static const uint16_t fft_lens[] = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 0 };
+static const uint16_t fir_taps[] = { 8, 32, 128, 0 };
+static const uint16_t mat_dims[] = { 4, 8, 16, 32, 64, 0 };
+
+#define FIR_MAX_TAPS            128
+
+/* NN layer shapes, fully connected: depth, out_ch, conv: in h/w/ch, out_ch, kernel, stride, pad */
+typedef struct {
+    int32_t depth, out_ch;
+} fc_shape_t;
+
+typedef struct {
+    int32_t hw, in_ch, out_ch, k, stride, pad;
+} conv_shape_t;
+
+static const fc_shape_t fc_shapes[] = {
+    { 64, 32 }, { 256, 64 }, { 512, 64 },
+#ifndef CFG_SIMULATION
+    { 1024, 32 },
+#endif
+    { 0, 0 }
+};
+
+static const conv_shape_t conv_shapes[] = {
+    { 8, 16, 16, 1, 1, 0 }, { 8, 8, 16, 3, 1, 1 }, { 16, 3, 8, 3, 2, 1 },
+#ifndef CFG_SIMULATION
+    { 16, 16, 32, 3, 1, 1 }, { 16, 32, 32, 1, 1, 0 },
+#endif
+    { 0, 0, 0, 0, 0, 0 }
+};
+
+#define NN_MAX_INPUT            (16 * 16 * 32)
+#define NN_MAX_OUTPUT           (16 * 16 * 32)
+#define NN_MAX_FILTER           (1024 * 32)
+#define NN_MAX_CH               64
+#define NN_SCRATCH_SIZE         (8 * 1024)
+
+/* minimum signal to noise ratio in dB of float and fixed point kernels against reference */
+#define SNR_THRESHOLD_F32       100.0
+#define SNR_THRESHOLD_Q31       60.0
+/* largest difference in LSB of int8 NN kernels against reference */
+#define DELTA_S8                1
+
+#if defined(RISCV_MATH_VECTOR)
+#define LIB_PATH                "rvv"
+#elif defined(RISCV_MATH_DSP)
+#define LIB_PATH                "dsp"
+#else
+#define LIB_PATH                "c"
+#endif
+
+static union {
+    float32_t f32[2 * FFT_MAX_LEN];
+    q31_t q31[2 * FFT_MAX_LEN];
+} buf_in, buf_out;
+static float32_t buf_ref[2 * FFT_MAX_LEN];
+static float32_t buf_scratch[2 * FFT_MAX_LEN];
+
+static union {
+    float32_t f32[FIR_BLOCK_SIZE + FIR_MAX_TAPS - 1];
+    q31_t q31[FIR_BLOCK_SIZE + FIR_MAX_TAPS - 1];
+} fir_state;
+
+static int8_t nn_input[NN_MAX_INPUT];
+static int8_t nn_filter[NN_MAX_FILTER];
+static int8_t nn_out[NN_MAX_OUTPUT], nn_ref[NN_MAX_OUTPUT];
+static int32_t nn_bias[NN_MAX_CH], nn_mult[NN_MAX_CH], nn_shift[NN_MAX_CH];
+static int8_t nn_scratch[NN_SCRATCH_SIZE] __attribute__((aligned(8)));
+
+static uint32_t seed = 1;
+
+static int32_t rand16(void)
+{
+    seed = seed * 1103515245 + 12345;
+    return (int16_t)(seed >> 16);
+}
+
+static void fill_f32(float32_t *buf, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        buf[i] = (float32_t)rand16() / 65536.0f;
+    }
+}
+
+static void fill_q31(q31_t *buf, uint32_t len, uint32_t shift)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        buf[i] = (q31_t)(rand16() << (16 - shift));
+    }
+}
+
+static void fill_s8(int8_t *buf, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        buf[i] = (int8_t)rand16();
+    }
+}
+
+static double snr_f32(const float32_t *ref, const float32_t *out, uint32_t len)
+{
+    double sig = 0, err = 0;
+
+    for (uint32_t i = 0; i < len; i++) {
+        sig += (double)ref[i] * ref[i];
+        err += ((double)ref[i] - out[i]) * ((double)ref[i] - out[i]);
+    }
+    if (isnan(err)) {
+        return 0;
+    }
+    return (err == 0) ? 999.0 : 10 * log10(sig / err);
+}
+
+static void q31_to_f32(const q31_t *src, float32_t *dst, uint32_t len, float32_t scale)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        dst[i] = (float32_t)src[i] / 2147483648.0f * scale;
+    }
+}
+
+/*
+ * Print one row of result, format:
+ * KERNEL, name, size, cycles, cycles per unit x100, unit, status
+ */
+static int report(const char *name, const char *size, uint64_t cyc, uint64_t units, const char *unit, int pass)
+{
+    uint64_t per = (cyc * 100) / (units ? units : 1);
+
+    printf("KERNEL, %s, %s, %lu, %lu.%02lu, %s, %s\n", name, size, (unsigned long)cyc, (unsigned long)(per / 100),
+           (unsigned long)(per % 100), unit, pass ? "PASS" : "FAIL");
+    return pass ? 0 : -1;
+}
+
+static int bench_cfft(void)
+{
+    riscv_cfft_instance_f32 sf;
+    riscv_cfft_instance_q31 sq;
+    char size[16];
+    uint64_t cyc;
+    double snr;
+    int ret = 0;
+
+    for (uint32_t i = 0; fft_lens[i] && (fft_lens[i] <= FFT_MAX_LEN); i++) {
+        uint32_t n = fft_lens[i];
+
+        snprintf(size, sizeof(size), "%lu", (unsigned long)n);
+        fill_f32(buf_in.f32, 2 * n);
+        ref_cfft_f32(buf_in.f32, buf_ref, buf_scratch, n);
+        riscv_cfft_init_f32(&sf, n);
+        // first run warms up caches, the transform is in place so input is copied before each run
+        memcpy(buf_out.f32, buf_in.f32, 2 * n * sizeof(float32_t));
+        riscv_cfft_f32(&sf, buf_out.f32, 0, 1);
+        memcpy(buf_out.f32, buf_in.f32, 2 * n * sizeof(float32_t));
+        BENCH_START(riscv_cfft_f32);
+        riscv_cfft_f32(&sf, buf_out.f32, 0, 1);
+        BENCH_END(riscv_cfft_f32);
+        cyc = BENCH_GET_USECYC();
+        snr = snr_f32(buf_ref, buf_out.f32, 2 * n);
+        if (snr < SNR_THRESHOLD_F32) {
+            BENCH_ERROR(riscv_cfft_f32);
+            printf("cfft_f32 %lu points, snr %d dB\n", (unsigned long)n, (int)snr);
+        }
+        BENCH_STATUS(riscv_cfft_f32);
+        ret |= report("riscv_cfft_f32", size, cyc, n, "point", snr >= SNR_THRESHOLD_F32);
+
+        // q31 transform scales down by fftLen, so reference gets the same input and output is scaled up
+        fill_q31(buf_in.q31, 2 * n, 1);
+        q31_to_f32(buf_in.q31, buf_scratch, 2 * n, 1.0f);
+        memcpy(buf_out.f32, buf_scratch, 2 * n * sizeof(float32_t));
+        ref_cfft_f32(buf_out.f32, buf_ref, buf_scratch, n);
+        riscv_cfft_init_q31(&sq, n);
+        memcpy(buf_out.q31, buf_in.q31, 2 * n * sizeof(q31_t));
+        riscv_cfft_q31(&sq, buf_out.q31, 0, 1);
+        memcpy(buf_out.q31, buf_in.q31, 2 * n * sizeof(q31_t));
+        BENCH_START(riscv_cfft_q31);
+        riscv_cfft_q31(&sq, buf_out.q31, 0, 1);
+        BENCH_END(riscv_cfft_q31);
+        cyc = BENCH_GET_USECYC();
+        q31_to_f32(buf_out.q31, buf_scratch, 2 * n, (float32_t)n);
+        snr = snr_f32(buf_ref, buf_scratch, 2 * n);
+        if (snr < SNR_THRESHOLD_Q31) {
+            BENCH_ERROR(riscv_cfft_q31);
+            printf("cfft_q31 %lu points, snr %d dB\n", (unsigned long)n, (int)snr);
+        }
+        BENCH_STATUS(riscv_cfft_q31);
+        ret |= report("riscv_cfft_q31", size, cyc, n, "point", snr >= SNR_THRESHOLD_Q31);
+    }
+    return ret;
+}
+
+static int bench_fir(void)
+{
+    static float32_t coeffs_f32[FIR_MAX_TAPS];
+    static q31_t coeffs_q31[FIR_MAX_TAPS];
+    riscv_fir_instance_f32 sf;
+    riscv_fir_instance_q31 sq;
+    q31_t *ref_q31 = (q31_t *)buf_ref;
+    char size[16];
+    uint64_t cyc;
+    double snr;
+    int ret = 0;
+
+    for (uint32_t i = 0; fir_taps[i]; i++) {
+        uint32_t taps = fir_taps[i];
+        uint64_t macs = (uint64_t)taps * FIR_BLOCK_SIZE;
+
+        snprintf(size, sizeof(size), "%lux%lu", (unsigned long)taps, (unsigned long)FIR_BLOCK_SIZE);
+        fill_f32(buf_in.f32, FIR_BLOCK_SIZE);
+        fill_f32(coeffs_f32, taps);
+        ref_fir_f32(buf_in.f32, coeffs_f32, buf_ref, taps, FIR_BLOCK_SIZE);
+        // init clears the state, so both runs start without history as the reference
+        riscv_fir_init_f32(&sf, taps, coeffs_f32, fir_state.f32, FIR_BLOCK_SIZE);
+        riscv_fir_f32(&sf, buf_in.f32, buf_out.f32, FIR_BLOCK_SIZE);
+        riscv_fir_init_f32(&sf, taps, coeffs_f32, fir_state.f32, FIR_BLOCK_SIZE);
+        BENCH_START(riscv_fir_f32);
+        riscv_fir_f32(&sf, buf_in.f32, buf_out.f32, FIR_BLOCK_SIZE);
+        BENCH_END(riscv_fir_f32);
+        cyc = BENCH_GET_USECYC();
+        snr = snr_f32(buf_ref, buf_out.f32, FIR_BLOCK_SIZE);
+        if (snr < SNR_THRESHOLD_F32) {
+            BENCH_ERROR(riscv_fir_f32);
+            printf("fir_f32 %lu taps, snr %d dB\n", (unsigned long)taps, (int)snr);
+        }
+        BENCH_STATUS(riscv_fir_f32);
+        ret |= report("riscv_fir_f32", size, cyc, macs, "mac", snr >= SNR_THRESHOLD_F32);
+
+        // coefficients are scaled down by the tap count so the accumulator never saturates
+        fill_q31(buf_in.q31, FIR_BLOCK_SIZE, 0);
+        fill_q31(coeffs_q31, taps, 8);
+        ref_fir_q31(buf_in.q31, coeffs_q31, ref_q31, taps, FIR_BLOCK_SIZE);
+        riscv_fir_init_q31(&sq, taps, coeffs_q31, fir_state.q31, FIR_BLOCK_SIZE);
+        riscv_fir_q31(&sq, buf_in.q31, buf_out.q31, FIR_BLOCK_SIZE);
+        riscv_fir_init_q31(&sq, taps, coeffs_q31, fir_state.q31, FIR_BLOCK_SIZE);
+        BENCH_START(riscv_fir_q31);
+        riscv_fir_q31(&sq, buf_in.q31, buf_out.q31, FIR_BLOCK_SIZE);
+        BENCH_END(riscv_fir_q31);
+        cyc = BENCH_GET_USECYC();
+        q31_to_f32(ref_q31, buf_ref, FIR_BLOCK_SIZE, 1.0f);
+        q31_to_f32(buf_out.q31, buf_scratch, FIR_BLOCK_SIZE, 1.0f);
+        snr = snr_f32(buf_ref, buf_scratch, FIR_BLOCK_SIZE);
+        if (snr < SNR_THRESHOLD_Q31) {
+            BENCH_ERROR(riscv_fir_q31);
+            printf("fir_q31 %lu taps, snr %d dB\n", (unsigned long)taps, (int)snr);
+        }
+        BENCH_STATUS(riscv_fir_q31);
+        ret |= report("riscv_fir_q31", size, cyc, macs, "mac", snr >= SNR_THRESHOLD_Q31);
+    }
+    return ret;
+}
+
+static int bench_mat(void)
+{
+    // operands taken from the fft buffers, which are large enough for the largest matrix
+    float32_t *a = buf_in.f32, *b = buf_in.f32 + MAT_MAX_DIM * MAT_MAX_DIM;
+    q31_t *qa = buf_in.q31, *qb = buf_in.q31 + MAT_MAX_DIM * MAT_MAX_DIM;
+    q31_t *ref_q31 = (q31_t *)buf_ref;
+    char size[16];
+    uint64_t cyc;
+    double snr;
+    int ret = 0;
+
+    for (uint32_t i = 0; mat_dims[i] && (mat_dims[i] <= MAT_MAX_DIM); i++) {
+        uint32_t d = mat_dims[i];
+        uint64_t macs = (uint64_t)d * d * d;
+        riscv_matrix_instance_f32 ma = { d, d, a }, mb = { d, d, b }, mo = { d, d, buf_out.f32 };
+        riscv_matrix_instance_q31 qma = { d, d, qa }, qmb = { d, d, qb }, qmo = { d, d, buf_out.q31 };
+
+        snprintf(size, sizeof(size), "%lux%lux%lu", (unsigned long)d, (unsigned long)d, (unsigned long)d);
+        fill_f32(a, 2 * MAT_MAX_DIM * MAT_MAX_DIM);
+        ref_mat_mult_f32(a, b, buf_ref, d, d, d);
+        riscv_mat_mult_f32(&ma, &mb, &mo);
+        BENCH_START(riscv_mat_mult_f32);
+        riscv_mat_mult_f32(&ma, &mb, &mo);
+        BENCH_END(riscv_mat_mult_f32);
+        cyc = BENCH_GET_USECYC();
+        snr = snr_f32(buf_ref, buf_out.f32, d * d);
+        if (snr < SNR_THRESHOLD_F32) {
+            BENCH_ERROR(riscv_mat_mult_f32);
+            printf("mat_mult_f32 %lu, snr %d dB\n", (unsigned long)d, (int)snr);
+        }
+        BENCH_STATUS(riscv_mat_mult_f32);
+        ret |= report("riscv_mat_mult_f32", size, cyc, macs, "mac", snr >= SNR_THRESHOLD_F32);
+
+        // operands are scaled down by the inner dimension so the result never saturates
+        fill_q31(qa, 2 * MAT_MAX_DIM * MAT_MAX_DIM, 3);
+        ref_mat_mult_q31(qa, qb, ref_q31, d, d, d);
+        riscv_mat_mult_q31(&qma, &qmb, &qmo);
+        BENCH_START(riscv_mat_mult_q31);
+        riscv_mat_mult_q31(&qma, &qmb, &qmo);
+        BENCH_END(riscv_mat_mult_q31);
+        cyc = BENCH_GET_USECYC();
+        q31_to_f32(ref_q31, buf_ref, d * d, 1.0f);
+        q31_to_f32(buf_out.q31, buf_scratch, d * d, 1.0f);
+        snr = snr_f32(buf_ref, buf_scratch, d * d);
+        if (snr < SNR_THRESHOLD_Q31) {
+            BENCH_ERROR(riscv_mat_mult_q31);
+            printf("mat_mult_q31 %lu, snr %d dB\n", (unsigned long)d, (int)snr);
+        }
+        BENCH_STATUS(riscv_mat_mult_q31);
+        ret |= report("riscv_mat_mult_q31", size, cyc, macs, "mac", snr >= SNR_THRESHOLD_Q31);
+    }
+    return ret;
+}
+
+static int check_s8(const int8_t *ref, const int8_t *out, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        if (abs(ref[i] - out[i]) > DELTA_S8) {
+            printf("index: %lu, expect: %d, actual: %d\n", (unsigned long)i, ref[i], out[i]);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void fill_nn_quant(int32_t out_ch, int32_t depth)
+{
+    fill_s8(nn_filter, NN_MAX_FILTER);
+    fill_s8(nn_input, NN_MAX_INPUT);
+    for (int32_t c = 0; c < out_ch; c++) {
+        nn_bias[c] = rand16();
+        // multiplier in [0.5, 1) and shift by depth keep the outputs spread over int8 range
+        nn_mult[c] = 0x40000000 + (rand16() & 0x7FFF) * 0x4000;
+        nn_shift[c] = -7 - ((depth > 256) ? 2 : (depth > 64) ? 1 : 0);
+    }
+}
+
+static int bench_fc(void)
+{
+    nmsis_nn_context ctx = { nn_scratch, 0 };
+    nmsis_nn_fc_params params = { 7, 0, -3, { -128, 127 } };
+    nmsis_nn_per_tensor_quant_params quant;
+    char size[16];
+    uint64_t cyc;
+    int ret = 0, pass;
+
+    for (uint32_t i = 0; fc_shapes[i].depth; i++) {
+        int32_t depth = fc_shapes[i].depth, out_ch = fc_shapes[i].out_ch;
+        nmsis_nn_dims in_dims = { 1, 1, 1, depth }, filter_dims = { depth, 1, 1, out_ch };
+        nmsis_nn_dims bias_dims = { 1, 1, 1, out_ch }, out_dims = { 1, 1, 1, out_ch };
+
+        snprintf(size, sizeof(size), "%ldx%ld", (long)depth, (long)out_ch);
+        fill_nn_quant(out_ch, depth);
+        quant.multiplier = nn_mult[0];
+        quant.shift = nn_shift[0];
+        ctx.size = riscv_fully_connected_s8_get_buffer_size(&filter_dims);
+        if (ctx.size > NN_SCRATCH_SIZE) {
+            printf("fully_connected_s8 %s needs %ld bytes buffer, skipped\n", size, (long)ctx.size);
+            continue;
+        }
+        if (ctx.size > 0) {
+            riscv_vector_sum_s8(ctx.buf, depth, out_ch, nn_filter);
+        }
+        ref_fully_connected_s8(&params, &quant, &in_dims, nn_input, &filter_dims, nn_filter, nn_bias, &out_dims,
+                               nn_ref);
+        riscv_fully_connected_s8(&ctx, &params, &quant, &in_dims, nn_input, &filter_dims, nn_filter, &bias_dims,
+                                 nn_bias, &out_dims, nn_out);
+        BENCH_START(riscv_fully_connected_s8);
+        riscv_fully_connected_s8(&ctx, &params, &quant, &in_dims, nn_input, &filter_dims, nn_filter, &bias_dims,
+                                 nn_bias, &out_dims, nn_out);
+        BENCH_END(riscv_fully_connected_s8);
+        cyc = BENCH_GET_USECYC();
+        pass = check_s8(nn_ref, nn_out, out_ch);
+        if (!pass) {
+            BENCH_ERROR(riscv_fully_connected_s8);
+        }
+        BENCH_STATUS(riscv_fully_connected_s8);
+        ret |= report("riscv_fully_connected_s8", size, cyc, (uint64_t)depth * out_ch, "mac", pass);
+    }
+    return ret;
+}
+
+static int bench_conv(void)
+{
+    nmsis_nn_context ctx = { nn_scratch, 0 };
+    nmsis_nn_conv_params params = { 7, -3, { 1, 1 }, { 0, 0 }, { 1, 1 }, { -128, 127 } };
+    nmsis_nn_per_channel_quant_params quant = { nn_mult, nn_shift };
+    char size[24];
+    uint64_t cyc;
+    int ret = 0, pass;
+
+    for (uint32_t i = 0; conv_shapes[i].hw; i++) {
+        const conv_shape_t *s = &conv_shapes[i];
+        int32_t out_hw = (s->hw + 2 * s->pad - s->k) / s->stride + 1;
+        nmsis_nn_dims in_dims = { 1, s->hw, s->hw, s->in_ch }, filter_dims = { s->out_ch, s->k, s->k, s->in_ch };
+        nmsis_nn_dims bias_dims = { 1, 1, 1, s->out_ch }, out_dims = { 1, out_hw, out_hw, s->out_ch };
+        uint32_t out_len = out_hw * out_hw * s->out_ch;
+
+        snprintf(size, sizeof(size), "%ldx%ldx%ld-%ldk%lds%ld", (long)s->hw, (long)s->hw, (long)s->in_ch,
+                 (long)s->out_ch, (long)s->k, (long)s->stride);
+        params.stride.w = params.stride.h = s->stride;
+        params.padding.w = params.padding.h = s->pad;
+        fill_nn_quant(s->out_ch, s->k * s->k * s->in_ch);
+        ctx.size = riscv_convolve_s8_get_buffer_size(&in_dims, &filter_dims);
+        if (ctx.size > NN_SCRATCH_SIZE) {
+            printf("convolve_s8 %s needs %ld bytes buffer, skipped\n", size, (long)ctx.size);
+            continue;
+        }
+        ref_convolve_s8(&params, &quant, &in_dims, nn_input, &filter_dims, nn_filter, nn_bias, &out_dims, nn_ref);
+        riscv_convolve_s8(&ctx, &params, &quant, &in_dims, nn_input, &filter_dims, nn_filter, &bias_dims, nn_bias,
+                          &out_dims, nn_out);
+        BENCH_START(riscv_convolve_s8);
+        riscv_convolve_s8(&ctx, &params, &quant, &in_dims, nn_input, &filter_dims, nn_filter, &bias_dims, nn_bias,
+                          &out_dims, nn_out);
+        BENCH_END(riscv_convolve_s8);
+        cyc = BENCH_GET_USECYC();
+        pass = check_s8(nn_ref, nn_out, out_len);
+        if (!pass) {
+            BENCH_ERROR(riscv_convolve_s8);
+        }
+        BENCH_STATUS(riscv_convolve_s8);
+        ret |= report("riscv_convolve_s8", size, cyc, (uint64_t)out_len * s->k * s->k * s->in_ch, "mac", pass);
+    }
+    return ret;
+}
+
+int main(void)
+{
+    int ret = 0;
+
+    BENCH_INIT();
+    printf("NMSIS DSP/NN kernel benchmark, %s library\n", LIB_PATH);
+    printf("KERNEL, name, size, cycles, cycles per unit, unit, status\n");
+    ret |= bench_cfft();
+    ret |= bench_fir();
+    ret |= bench_mat();
+    ret |= bench_fc();
+    ret |= bench_conv();
+    if (ret) {
+        printf("kernel benchmark failed\n");
+        NMSIS_TEST_FAIL();
+        return 1;
+    }
+    printf("kernel benchmark finished, all kernels passed\n");
+    NMSIS_TEST_PASS();
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include <math.h>
+#include "ref_kernels.h"
+#include "riscv_nnsupportfunctions.h"
+
+void ref_cfft_f32(const float32_t *pSrc, float32_t *pDst, float32_t *pScratch, uint32_t fftLen)
+{
+    const double pi2 = 6.283185307179586;
+
+    for (uint32_t i = 0; i < fftLen; i++) {
+        pScratch[2 * i] = (float32_t)cos(pi2 * i / fftLen);
+        pScratch[2 * i + 1] = (float32_t)sin(pi2 * i / fftLen);
+    }
+    for (uint32_t k = 0; k < fftLen; k++) {
+        double re = 0, im = 0;
+        uint32_t idx = 0;
+
+        // twiddle of j * k is reached by stepping k through the table
+        for (uint32_t j = 0; j < fftLen; j++) {
+            double c = pScratch[2 * idx], s = pScratch[2 * idx + 1];
+
+            re += pSrc[2 * j] * c + pSrc[2 * j + 1] * s;
+            im += pSrc[2 * j + 1] * c - pSrc[2 * j] * s;
+            idx += k;
+            idx = (idx >= fftLen) ? (idx - fftLen) : idx;
+        }
+        pDst[2 * k] = (float32_t)re;
+        pDst[2 * k + 1] = (float32_t)im;
+    }
+}
+
+void ref_fir_f32(const float32_t *pSrc, const float32_t *pCoeffs, float32_t *pDst, uint32_t numTaps,
+                 uint32_t blockSize)
+{
+    for (uint32_t n = 0; n < blockSize; n++) {
+        float32_t acc = 0;
+
+        for (uint32_t k = 0; (k < numTaps) && (k <= n); k++) {
+            acc += pCoeffs[numTaps - 1 - k] * pSrc[n - k];
+        }
+        pDst[n] = acc;
+    }
+}
+
+void ref_fir_q31(const q31_t *pSrc, const q31_t *pCoeffs, q31_t *pDst, uint32_t numTaps, uint32_t blockSize)
+{
+    for (uint32_t n = 0; n < blockSize; n++) {
+        q63_t acc = 0;
+
+        for (uint32_t k = 0; (k < numTaps) && (k <= n); k++) {
+            acc += (q63_t)pCoeffs[numTaps - 1 - k] * pSrc[n - k];
+        }
+        pDst[n] = (q31_t)(acc >> 31);
+    }
+}
+
+void ref_mat_mult_f32(const float32_t *pSrcA, const float32_t *pSrcB, float32_t *pDst, uint32_t M, uint32_t K,
+                      uint32_t N)
+{
+    for (uint32_t i = 0; i < M; i++) {
+        for (uint32_t j = 0; j < N; j++) {
+            float32_t sum = 0;
+
+            for (uint32_t k = 0; k < K; k++) {
+                sum += pSrcA[i * K + k] * pSrcB[k * N + j];
+            }
+            pDst[i * N + j] = sum;
+        }
+    }
+}
+
+void ref_mat_mult_q31(const q31_t *pSrcA, const q31_t *pSrcB, q31_t *pDst, uint32_t M, uint32_t K, uint32_t N)
+{
+    for (uint32_t i = 0; i < M; i++) {
+        for (uint32_t j = 0; j < N; j++) {
+            q63_t sum = 0;
+
+            for (uint32_t k = 0; k < K; k++) {
+                sum += (q63_t)pSrcA[i * K + k] * pSrcB[k * N + j];
+            }
+            pDst[i * N + j] = (q31_t)(sum >> 31);
+        }
+    }
+}
+
+static int8_t ref_requantize_s8(int32_t acc, int32_t mult, int32_t shift, int32_t offset, int32_t min, int32_t max)
+{
+    acc = riscv_nn_requantize(acc, mult, shift) + offset;
+    acc = (acc < min) ? min : acc;
+    acc = (acc > max) ? max : acc;
+    return (int8_t)acc;
+}
+
+void ref_fully_connected_s8(const nmsis_nn_fc_params *fc_params, const nmsis_nn_per_tensor_quant_params *quant_params,
+                            const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                            const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                            const int32_t *bias_data, const nmsis_nn_dims *output_dims, int8_t *output_data)
+{
+    int32_t depth = filter_dims->n, out_ch = output_dims->c;
+
+    for (int32_t b = 0; b < input_dims->n; b++) {
+        for (int32_t c = 0; c < out_ch; c++) {
+            int32_t acc = bias_data ? bias_data[c] : 0;
+
+            for (int32_t k = 0; k < depth; k++) {
+                acc += (input_data[b * depth + k] + fc_params->input_offset) * filter_data[c * depth + k];
+            }
+            output_data[b * out_ch + c] = ref_requantize_s8(acc, quant_params->multiplier, quant_params->shift,
+                                                            fc_params->output_offset, fc_params->activation.min,
+                                                            fc_params->activation.max);
+        }
+    }
+}
+
+void ref_convolve_s8(const nmsis_nn_conv_params *conv_params, const nmsis_nn_per_channel_quant_params *quant_params,
+                     const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                     const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                     const int32_t *bias_data, const nmsis_nn_dims *output_dims, int8_t *output_data)
+{
+    int32_t in_h = input_dims->h, in_w = input_dims->w, in_ch = input_dims->c;
+    int32_t k_h = filter_dims->h, k_w = filter_dims->w;
+    int32_t out_h = output_dims->h, out_w = output_dims->w, out_ch = output_dims->c;
+
+    for (int32_t b = 0; b < input_dims->n; b++) {
+        const int8_t *in = input_data + b * in_h * in_w * in_ch;
+
+        for (int32_t y = 0; y < out_h; y++) {
+            for (int32_t x = 0; x < out_w; x++) {
+                for (int32_t c = 0; c < out_ch; c++) {
+                    int32_t acc = bias_data ? bias_data[c] : 0;
+
+                    for (int32_t ky = 0; ky < k_h; ky++) {
+                        int32_t iy = y * conv_params->stride.h - conv_params->padding.h + ky * conv_params->dilation.h;
+
+                        for (int32_t kx = 0; kx < k_w; kx++) {
+                            int32_t ix = x * conv_params->stride.w - conv_params->padding.w +
+                                         kx * conv_params->dilation.w;
+
+                            // padding is the zero point, which adds nothing once the offset is applied
+                            if ((iy < 0) || (iy >= in_h) || (ix < 0) || (ix >= in_w)) {
+                                continue;
+                            }
+                            for (int32_t ci = 0; ci < in_ch; ci++) {
+                                acc += (in[(iy * in_w + ix) * in_ch + ci] + conv_params->input_offset) *
+                                       filter_data[((c * k_h + ky) * k_w + kx) * in_ch + ci];
+                            }
+                        }
+                    }
+                    *output_data++ = ref_requantize_s8(acc, quant_params->multiplier[c], quant_params->shift[c],
+                                                       conv_params->output_offset, conv_params->activation.min,
+                                                       conv_params->activation.max);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef __REF_KERNELS_H__
+#define __REF_KERNELS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "riscv_math.h"
+#include "riscv_nnfunctions.h"
+
+/*
+ * Plain C reference of the kernels measured by kernelbench, written for clarity instead
+ * of speed, the library kernels are checked against them
+ */
+
+/* Complex DFT of fftLen points, pScratch holds 2 * fftLen twiddle values */
+void ref_cfft_f32(const float32_t *pSrc, float32_t *pDst, float32_t *pScratch, uint32_t fftLen);
+
+/* Direct form FIR, pCoeffs in time reversed order as riscv_fir_init_xxx takes them, no history */
+void ref_fir_f32(const float32_t *pSrc, const float32_t *pCoeffs, float32_t *pDst, uint32_t numTaps,
+                 uint32_t blockSize);
+void ref_fir_q31(const q31_t *pSrc, const q31_t *pCoeffs, q31_t *pDst, uint32_t numTaps, uint32_t blockSize);
+
+/* Row major M x K by K x N matrix multiplication */
+void ref_mat_mult_f32(const float32_t *pSrcA, const float32_t *pSrcB, float32_t *pDst, uint32_t M, uint32_t K,
+                      uint32_t N);
+void ref_mat_mult_q31(const q31_t *pSrcA, const q31_t *pSrcB, q31_t *pDst, uint32_t M, uint32_t K, uint32_t N);
+
+/* Same arguments as riscv_fully_connected_s8 and riscv_convolve_s8, without context */
+void ref_fully_connected_s8(const nmsis_nn_fc_params *fc_params, const nmsis_nn_per_tensor_quant_params *quant_params,
+                            const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                            const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                            const int32_t *bias_data, const nmsis_nn_dims *output_dims, int8_t *output_data);
+void ref_convolve_s8(const nmsis_nn_conv_params *conv_params, const nmsis_nn_per_channel_quant_params *quant_params,
+                     const nmsis_nn_dims *input_dims, const int8_t *input_data,
+                     const nmsis_nn_dims *filter_dims, const int8_t *filter_data,
+                     const int32_t *bias_data, const nmsis_nn_dims *output_dims, int8_t *output_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __REF_KERNELS_H__ */
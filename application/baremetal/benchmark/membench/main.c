@@ -0,0 +1,283 @@
+// See LICENSE for license details.
+#include <stdio.h>
+#include <stdint.h>
+#include "nuclei_sdk_soc.h"
+#include "nmsis_bench.h"
+
+/*
+ * Memory subsystem benchmark
+ *
+ * STREAM like copy/scale/add/triad kernels measure bandwidth in bytes/cycle,
+ * and a pointer chase over randomly linked cache lines measures load latency.
+ * Working set size is doubled from MEMBENCH_MIN_SIZE up to the size of each
+ * memory region, and each size is measured with cache on, cache off and
+ * dcache locked when the working set fits into dcache.
+ *
+ * Region "data" is a buffer in .bss, placed by the linker script of the
+ * selected DOWNLOAD mode, eg. DLM in ilm mode, DDR in ddr mode.
+ * Other regions can be benchmarked by passing base address and size of
+ * a memory area not used by the linker script, eg.
+ * -DMEMBENCH_SRAM_BASE=0xA0000000 -DMEMBENCH_SRAM_SIZE=0x10000
+ * the same for MEMBENCH_ILM_*, MEMBENCH_DLM_* and MEMBENCH_DDR_*
+ */
+
+#ifndef MEMBENCH_BUF_SIZE
+#define MEMBENCH_BUF_SIZE       (16 * 1024)
+#endif
+
+#ifndef MEMBENCH_MIN_SIZE
+#define MEMBENCH_MIN_SIZE       1024
+#endif
+
+#ifdef CFG_SIMULATION
+#define RUN_LOOPS               1
+#define CHASE_STEPS             256
+#else
+#define RUN_LOOPS               4
+#define CHASE_STEPS             4096
+#endif
+
+#define CACHELINE_SIZE          64
+#define SCALAR                  3
+
+typedef unsigned long mb_word_t;
+
+typedef struct {
+    const char *name;
+    uint8_t *base;
+    size_t size;
+} MB_REGION;
+
+typedef enum {
+    MB_CACHE_ON = 0,
+    MB_CACHE_OFF,
+    MB_CACHE_LOCK,
+    MB_CACHE_STATE_NUM
+} MB_CACHE_STATE;
+
+static const char *mb_cache_names[MB_CACHE_STATE_NUM] = {"on", "off", "lock"};
+
+BENCH_DECLARE_VAR();
+
+static uint8_t mb_data_buf[MEMBENCH_BUF_SIZE] __attribute__((aligned(CACHELINE_SIZE)));
+
+static MB_REGION mb_regions[] = {
+    {"data", mb_data_buf, sizeof(mb_data_buf)},
+#if defined(MEMBENCH_ILM_BASE) && defined(MEMBENCH_ILM_SIZE)
+    {"ilm", (uint8_t *)(MEMBENCH_ILM_BASE), MEMBENCH_ILM_SIZE},
+#endif
+#if defined(MEMBENCH_DLM_BASE) && defined(MEMBENCH_DLM_SIZE)
+    {"dlm", (uint8_t *)(MEMBENCH_DLM_BASE), MEMBENCH_DLM_SIZE},
+#endif
+#if defined(MEMBENCH_SRAM_BASE) && defined(MEMBENCH_SRAM_SIZE)
+    {"sram", (uint8_t *)(MEMBENCH_SRAM_BASE), MEMBENCH_SRAM_SIZE},
+#endif
+#if defined(MEMBENCH_DDR_BASE) && defined(MEMBENCH_DDR_SIZE)
+    {"ddr", (uint8_t *)(MEMBENCH_DDR_BASE), MEMBENCH_DDR_SIZE},
+#endif
+};
+
+#define MB_REGION_NUM           (sizeof(mb_regions) / sizeof(mb_regions[0]))
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1) && defined(__CCM_PRESENT) && (__CCM_PRESENT == 1)
+#define MB_CACHE_CTRL           1
+#else
+#define MB_CACHE_CTRL           0
+#endif
+
+// dcache size in bytes, 0 if dcache is not present
+static uint32_t mb_dcache_size = 0;
+
+// print bytes per cycle with two decimals
+static void mb_print_bw(const char *region, const char *cache, size_t size, const char *kernel,
+                        uint64_t bytes, uint64_t cycles)
+{
+    uint64_t bpc100 = (cycles == 0) ? 0 : (bytes * 100 / cycles);
+
+    printf("MEMBW, %s, %s, %lu, %s, %lu, %lu, %lu.%02lu\n", region, cache, (unsigned long)size, kernel,
+           (unsigned long)bytes, (unsigned long)cycles, (unsigned long)(bpc100 / 100), (unsigned long)(bpc100 % 100));
+}
+
+static void mb_stream(const char *region, const char *cache, uint8_t *base, size_t size)
+{
+    // three arrays share the working set
+    size_t n = size / (3 * sizeof(mb_word_t));
+    volatile mb_word_t *a = (volatile mb_word_t *)base;
+    volatile mb_word_t *b = a + n;
+    volatile mb_word_t *c = b + n;
+    uint64_t start, cyc[4] = {0};
+    size_t i;
+
+    for (i = 0; i < n; i ++) {
+        a[i] = 1;
+        b[i] = 2;
+        c[i] = 0;
+    }
+    for (int loop = 0; loop < RUN_LOOPS; loop ++) {
+        start = __get_rv_cycle();
+        for (i = 0; i < n; i ++) {
+            c[i] = a[i];
+        }
+        cyc[0] += __bench_remove_overhead(__get_rv_cycle() - start, BENCH_GET_OVHCYC());
+        start = __get_rv_cycle();
+        for (i = 0; i < n; i ++) {
+            b[i] = SCALAR * c[i];
+        }
+        cyc[1] += __bench_remove_overhead(__get_rv_cycle() - start, BENCH_GET_OVHCYC());
+        start = __get_rv_cycle();
+        for (i = 0; i < n; i ++) {
+            c[i] = a[i] + b[i];
+        }
+        cyc[2] += __bench_remove_overhead(__get_rv_cycle() - start, BENCH_GET_OVHCYC());
+        start = __get_rv_cycle();
+        for (i = 0; i < n; i ++) {
+            a[i] = b[i] + SCALAR * c[i];
+        }
+        cyc[3] += __bench_remove_overhead(__get_rv_cycle() - start, BENCH_GET_OVHCYC());
+    }
+    // bytes counted as STREAM does, read and write of each element
+    mb_print_bw(region, cache, size, "copy", 2 * sizeof(mb_word_t) * n * RUN_LOOPS, cyc[0]);
+    mb_print_bw(region, cache, size, "scale", 2 * sizeof(mb_word_t) * n * RUN_LOOPS, cyc[1]);
+    mb_print_bw(region, cache, size, "add", 3 * sizeof(mb_word_t) * n * RUN_LOOPS, cyc[2]);
+    mb_print_bw(region, cache, size, "triad", 3 * sizeof(mb_word_t) * n * RUN_LOOPS, cyc[3]);
+}
+
+// link each cache line of working set into one random cycle, Sattolo's algorithm
+static void mb_chase_init(uint8_t *base, size_t size)
+{
+    size_t nlines = size / CACHELINE_SIZE;
+    uint32_t seed = 0x12345678;
+    size_t i, j;
+
+    for (i = 0; i < nlines; i ++) {
+        *(uintptr_t *)(base + i * CACHELINE_SIZE) = i;
+    }
+    for (i = nlines - 1; i > 0; i --) {
+        seed = seed * 1664525 + 1013904223;
+        j = seed % i;
+        uintptr_t tmp = *(uintptr_t *)(base + i * CACHELINE_SIZE);
+        *(uintptr_t *)(base + i * CACHELINE_SIZE) = *(uintptr_t *)(base + j * CACHELINE_SIZE);
+        *(uintptr_t *)(base + j * CACHELINE_SIZE) = tmp;
+    }
+    // convert line index into address
+    for (i = 0; i < nlines; i ++) {
+        uintptr_t *p = (uintptr_t *)(base + i * CACHELINE_SIZE);
+        *p = (uintptr_t)(base + (*p) * CACHELINE_SIZE);
+    }
+}
+
+static void mb_chase(const char *region, const char *cache, uint8_t *base, size_t size)
+{
+    uintptr_t *p = (uintptr_t *)base;
+    uint64_t start, cycles;
+    uint64_t lat100;
+
+    mb_chase_init(base, size);
+    // walk once to warm up the cache
+    for (int i = 0; i < CHASE_STEPS; i ++) {
+        p = (uintptr_t *)(*p);
+    }
+    start = __get_rv_cycle();
+    for (int i = 0; i < CHASE_STEPS; i ++) {
+        p = (uintptr_t *)(*(volatile uintptr_t *)p);
+    }
+    cycles = __bench_remove_overhead(__get_rv_cycle() - start, BENCH_GET_OVHCYC());
+    lat100 = cycles * 100 / CHASE_STEPS;
+    printf("MEMLAT, %s, %s, %lu, %lu.%02lu\n", region, cache, (unsigned long)size,
+           (unsigned long)(lat100 / 100), (unsigned long)(lat100 % 100));
+}
+
+// set cache state for the working set, return 0 if state is not applicable
+static int mb_cache_set(MB_CACHE_STATE state, uint8_t *base, size_t size)
+{
+#if MB_CACHE_CTRL
+    if (mb_dcache_size == 0) {
+        return state == MB_CACHE_OFF;
+    }
+    MFlushInvalDCache();
+    switch (state) {
+        case MB_CACHE_ON:
+#if defined(__ICACHE_PRESENT) && (__ICACHE_PRESENT == 1)
+            EnableICache();
+#endif
+            EnableDCache();
+            return 1;
+        case MB_CACHE_OFF:
+#if defined(__ICACHE_PRESENT) && (__ICACHE_PRESENT == 1)
+            DisableICache();
+#endif
+            DisableDCache();
+            return 1;
+        case MB_CACHE_LOCK:
+            // keep some ways free for stack and code data
+            if (size > mb_dcache_size / 2) {
+                return 0;
+            }
+#if defined(__ICACHE_PRESENT) && (__ICACHE_PRESENT == 1)
+            EnableICache();
+#endif
+            EnableDCache();
+            if (MLockDCacheLines((unsigned long)base, size / CACHELINE_SIZE) != CCM_OP_SUCCESS) {
+                MUnlockDCacheLines((unsigned long)base, size / CACHELINE_SIZE);
+                return 0;
+            }
+            return 1;
+        default:
+            return 0;
+    }
+#else
+    return state == MB_CACHE_OFF;
+#endif
+}
+
+static void mb_cache_restore(MB_CACHE_STATE state, uint8_t *base, size_t size)
+{
+#if MB_CACHE_CTRL
+    if ((state == MB_CACHE_LOCK) && (mb_dcache_size != 0)) {
+        MUnlockDCacheLines((unsigned long)base, size / CACHELINE_SIZE);
+    }
+#endif
+}
+
+int main(void)
+{
+    BENCH_INIT();
+
+#if MB_CACHE_CTRL
+    CacheInfo_Type info;
+
+    if (DCachePresent()) {
+        GetDCacheInfo(&info);
+        mb_dcache_size = info.size;
+        printf("DCache Linesize is %d bytes, ways is %d, setperway is %d, total size is %d bytes\n",
+               (int)info.linesize, (int)info.ways, (int)info.setperway, (int)info.size);
+    }
+#endif
+
+    printf("Memory benchmark, bandwidth in bytes/cycle, latency in cycles/load\n");
+    printf("MEMBW, region, cache, size, kernel, bytes, cycles, bytes_per_cycle\n");
+    printf("MEMLAT, region, cache, size, cycles_per_load\n");
+    for (size_t r = 0; r < MB_REGION_NUM; r ++) {
+        MB_REGION *region = &mb_regions[r];
+
+        printf("Region %s: base 0x%lx, size %lu bytes\n", region->name,
+               (unsigned long)(uintptr_t)region->base, (unsigned long)region->size);
+        for (size_t size = MEMBENCH_MIN_SIZE; size <= region->size; size <<= 1) {
+            for (int state = 0; state < MB_CACHE_STATE_NUM; state ++) {
+                if (mb_cache_set((MB_CACHE_STATE)state, region->base, size) == 0) {
+                    continue;
+                }
+                mb_stream(region->name, mb_cache_names[state], region->base, size);
+                mb_chase(region->name, mb_cache_names[state], region->base, size);
+                mb_cache_restore((MB_CACHE_STATE)state, region->base, size);
+            }
+        }
+    }
+#if MB_CACHE_CTRL
+    if (mb_dcache_size != 0) {
+        mb_cache_set(MB_CACHE_ON, NULL, 0);
+    }
+#endif
+    printf("Memory benchmark finished\n");
+    return 0;
+}
@@ -0,0 +1,152 @@
+// See LICENSE for license details.
+#include <stdio.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "riscv_nnfunctions.h"
+#include "riscv_nnsupportfunctions.h"
+#include "riscv_nn_gemm_rvv.h"
+
+#ifdef CFG_SIMULATION
+#define LHS_ROWS                8
+#define RHS_ROWS                32
+#define RHS_COLS                72
+#else
+#define LHS_ROWS                64
+#define RHS_ROWS                64
+#define RHS_COLS                288
+#endif
+
+#define LHS_OFFSET              7
+#define DST_OFFSET              (-3)
+
+#if defined(RISCV_MATH_VECTOR)
+#define LIB_PATH                "rvv"
+#elif defined(RISCV_MATH_DSP)
+#define LIB_PATH                "dsp"
+#else
+#define LIB_PATH                "c"
+#endif
+
+static int8_t lhs[LHS_ROWS * RHS_COLS];
+static int8_t rhs[RHS_ROWS * RHS_COLS];
+static int32_t bias[RHS_ROWS], mult[RHS_ROWS], shift[RHS_ROWS];
+static int8_t dst_lib[LHS_ROWS * RHS_ROWS], dst_rvv[LHS_ROWS * RHS_ROWS];
+static q15_t im2col[2 * RHS_COLS];
+static q7_t bias7[RHS_ROWS];
+#if defined(RISCV_MATH_VECTOR)
+static int8_t packed[((RHS_ROWS + RISCV_NN_PACK_COLS - 1) / RISCV_NN_PACK_COLS) * RISCV_NN_PACK_COLS * RHS_COLS];
+static int32_t packed_bias[RHS_ROWS];
+#endif
+static int32_t kernel_sum[RHS_ROWS];
+
+static uint64_t start, cyc_lib, cyc_rvv;
+
+#define BENCH_START()           (start = __get_rv_cycle())
+#define BENCH_END(cyc)          ((cyc) = __get_rv_cycle() - start)
+
+static uint32_t seed = 1;
+
+static int8_t rand8(void)
+{
+    seed = seed * 1103515245 + 12345;
+    return (int8_t)(seed >> 16);
+}
+
+static void fill(void)
+{
+    for (uint32_t i = 0; i < sizeof(lhs); i++) {
+        lhs[i] = rand8();
+    }
+    for (uint32_t i = 0; i < sizeof(rhs); i++) {
+        rhs[i] = rand8();
+    }
+    for (uint32_t i = 0; i < RHS_ROWS; i++) {
+        bias[i] = rand8() * 64;
+        bias7[i] = rand8();
+        mult[i] = 0x40000000 + rand8() * 0x100000;
+        shift[i] = -8 + (rand8() & 3);
+    }
+    for (uint32_t i = 0; i < 2 * RHS_COLS; i++) {
+        im2col[i] = rand8();
+    }
+}
+
+/* print one row of result, the speedup is in percent of library cycles */
+static int report(const char *name, uint32_t len)
+{
+    int same = (memcmp(dst_lib, dst_rvv, len) == 0);
+
+    printf("%-16s %s %8lu, packed rvv %8lu cycles, speedup %3lu%%, %s\n", name, LIB_PATH, (unsigned long)cyc_lib,
+           (unsigned long)cyc_rvv, (unsigned long)((cyc_lib * 100) / (cyc_rvv ? cyc_rvv : 1)),
+           same ? "identical" : "MISMATCH");
+    return same ? 0 : -1;
+}
+
+static int bench_mat_mult(void)
+{
+    BENCH_START();
+    riscv_nn_mat_mult_nt_t_s8(lhs, rhs, bias, dst_lib, mult, shift, LHS_ROWS, RHS_ROWS, RHS_COLS, LHS_OFFSET,
+                              DST_OFFSET, -128, 127, 0);
+    BENCH_END(cyc_lib);
+#if defined(RISCV_MATH_VECTOR)
+    riscv_nn_pack_rhs_s8_rvv(rhs, bias, RHS_ROWS, RHS_COLS, LHS_OFFSET, packed, packed_bias);
+    BENCH_START();
+    riscv_nn_mat_mult_nt_t_s8_rvv(lhs, packed, packed_bias, dst_rvv, mult, shift, LHS_ROWS, RHS_ROWS, RHS_COLS,
+                                  DST_OFFSET, -128, 127, 0);
+    BENCH_END(cyc_rvv);
+    return report("mat_mult_nt_t", LHS_ROWS * RHS_ROWS);
+#else
+    printf("%-16s %s %8lu cycles\n", "mat_mult_nt_t", LIB_PATH, (unsigned long)cyc_lib);
+    return 0;
+#endif
+}
+
+static int bench_vec_mat_mult(void)
+{
+    // kernel sums as riscv_fully_connected_s8() gets them, the packing folds them into packed_bias
+    riscv_vector_sum_s8(kernel_sum, RHS_COLS, RHS_ROWS, rhs);
+    BENCH_START();
+    riscv_nn_vec_mat_mult_t_s8(lhs, rhs, kernel_sum, bias, dst_lib, LHS_OFFSET, DST_OFFSET, mult[0], shift[0],
+                               RHS_COLS, RHS_ROWS, -128, 127, 1);
+    BENCH_END(cyc_lib);
+#if defined(RISCV_MATH_VECTOR)
+    BENCH_START();
+    riscv_nn_vec_mat_mult_t_s8_rvv(lhs, packed, packed_bias, dst_rvv, DST_OFFSET, mult[0], shift[0], RHS_COLS,
+                                   RHS_ROWS, -128, 127, 1);
+    BENCH_END(cyc_rvv);
+    return report("vec_mat_mult_t", RHS_ROWS);
+#else
+    printf("%-16s %s %8lu cycles\n", "vec_mat_mult_t", LIB_PATH, (unsigned long)cyc_lib);
+    return 0;
+#endif
+}
+
+static int bench_q7_q15(void)
+{
+    BENCH_START();
+    riscv_nn_mat_mult_kernel_q7_q15(rhs, im2col, RHS_ROWS, RHS_COLS, 2, 9, bias7, dst_lib);
+    BENCH_END(cyc_lib);
+#if defined(RISCV_MATH_VECTOR)
+    riscv_nn_pack_rhs_s8_rvv(rhs, NULL, RHS_ROWS, RHS_COLS, 0, packed, NULL);
+    BENCH_START();
+    riscv_nn_mat_mult_kernel_q7_q15_rvv(packed, im2col, RHS_ROWS, RHS_COLS, 2, 9, bias7, dst_rvv);
+    BENCH_END(cyc_rvv);
+    return report("kernel_q7_q15", 2 * RHS_ROWS);
+#else
+    printf("%-16s %s %8lu cycles\n", "kernel_q7_q15", LIB_PATH, (unsigned long)cyc_lib);
+    return 0;
+#endif
+}
+
+int main(void)
+{
+    int ret = 0;
+
+    fill();
+    printf("NMSIS NN int8 matrix multiplication, %d x %d x %d\n", LHS_ROWS, RHS_ROWS, RHS_COLS);
+    ret |= bench_mat_mult();
+    ret |= bench_vec_mat_mult();
+    ret |= bench_q7_q15();
+    printf("nngemm benchmark %s\n", (ret == 0) ? "finished" : "failed");
+    return ret;
+}
@@ -0,0 +1,349 @@
+// See LICENSE for license details.
+#include <stdio.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "riscv_math.h"
+#include "riscv_pext_math.h"
+
+#if !defined(RISCV_PEXT_MATH)
+#error "P extension kernels need the DSP extension, please build with ARCH_EXT=_xxldsp"
+#endif
+
+#ifdef CFG_SIMULATION
+#define VEC_LEN                 128
+#else
+#define VEC_LEN                 2048
+#endif
+
+/* odd, so the scalar remainder of every kernel runs too */
+#define BLOCK                   (VEC_LEN - 3)
+
+#define SHIFT_Q15               3
+#define SHIFT_Q7                2
+#define SCALE_SHIFT             1
+
+static q15_t a15[2 * VEC_LEN], b15[2 * VEC_LEN];
+static q7_t a7[VEC_LEN], b7[VEC_LEN];
+/* outputs of the reference, the library and the pext kernel */
+static q15_t out[3][2 * VEC_LEN];
+
+static uint64_t start;
+
+#define BENCH_START()           (start = __get_rv_cycle())
+#define BENCH_END(cyc)          ((cyc) = __get_rv_cycle() - start)
+
+/*
+ * Scalar references, the plain C of the NMSIS DSP kernels, so the library and the pext
+ * kernels are checked to give the same bits
+ */
+static void ref_add_q15(const q15_t *a, const q15_t *b, q15_t *d, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[i] = (q15_t)__SSAT((q31_t)a[i] + b[i], 16);
+    }
+}
+
+static void ref_add_q7(const q7_t *a, const q7_t *b, q7_t *d, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[i] = (q7_t)__SSAT((q15_t)a[i] + b[i], 8);
+    }
+}
+
+static void ref_sub_q15(const q15_t *a, const q15_t *b, q15_t *d, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[i] = (q15_t)__SSAT((q31_t)a[i] - b[i], 16);
+    }
+}
+
+static void ref_sub_q7(const q7_t *a, const q7_t *b, q7_t *d, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[i] = (q7_t)__SSAT((q15_t)a[i] - b[i], 8);
+    }
+}
+
+static void ref_mult_q15(const q15_t *a, const q15_t *b, q15_t *d, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[i] = (q15_t)__SSAT(((q31_t)a[i] * b[i]) >> 15, 16);
+    }
+}
+
+static void ref_mult_q7(const q7_t *a, const q7_t *b, q7_t *d, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[i] = (q7_t)__SSAT(((q15_t)a[i] * b[i]) >> 7, 8);
+    }
+}
+
+static void ref_abs_q15(const q15_t *a, q15_t *d, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[i] = (a[i] > 0) ? a[i] : ((a[i] == (q15_t)0x8000) ? 0x7fff : -a[i]);
+    }
+}
+
+static void ref_abs_q7(const q7_t *a, q7_t *d, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[i] = (a[i] > 0) ? a[i] : ((a[i] == (q7_t)0x80) ? 0x7f : -a[i]);
+    }
+}
+
+static void ref_negate_q15(const q15_t *a, q15_t *d, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[i] = (a[i] == (q15_t)0x8000) ? 0x7fff : -a[i];
+    }
+}
+
+static void ref_negate_q7(const q7_t *a, q7_t *d, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[i] = (a[i] == (q7_t)0x80) ? 0x7f : -a[i];
+    }
+}
+
+static void ref_offset_q15(const q15_t *a, q15_t offset, q15_t *d, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[i] = (q15_t)__SSAT((q31_t)a[i] + offset, 16);
+    }
+}
+
+static void ref_offset_q7(const q7_t *a, q7_t offset, q7_t *d, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[i] = (q7_t)__SSAT((q15_t)a[i] + offset, 8);
+    }
+}
+
+static void ref_shift_q15(const q15_t *a, int8_t shift, q15_t *d, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[i] = (shift >= 0) ? (q15_t)__SSAT((q31_t)a[i] << shift, 16) : (q15_t)(a[i] >> -shift);
+    }
+}
+
+static void ref_shift_q7(const q7_t *a, int8_t shift, q7_t *d, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[i] = (shift >= 0) ? (q7_t)__SSAT((q15_t)a[i] << shift, 8) : (q7_t)(a[i] >> -shift);
+    }
+}
+
+static void ref_scale_q15(const q15_t *a, q15_t scale, int8_t shift, q15_t *d, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[i] = (q15_t)__SSAT(((q31_t)a[i] * scale) >> (15 - shift), 16);
+    }
+}
+
+static void ref_scale_q7(const q7_t *a, q7_t scale, int8_t shift, q7_t *d, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[i] = (q7_t)__SSAT(((q15_t)a[i] * scale) >> (7 - shift), 8);
+    }
+}
+
+static void ref_clip_q15(const q15_t *a, q15_t *d, q15_t low, q15_t high, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[i] = (a[i] > high) ? high : ((a[i] < low) ? low : a[i]);
+    }
+}
+
+static void ref_clip_q7(const q7_t *a, q7_t *d, q7_t low, q7_t high, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[i] = (a[i] > high) ? high : ((a[i] < low) ? low : a[i]);
+    }
+}
+
+static void ref_dot_prod_q15(const q15_t *a, const q15_t *b, uint32_t n, q63_t *result)
+{
+    q63_t sum = 0;
+
+    for (uint32_t i = 0; i < n; i++) {
+        sum += (q31_t)a[i] * b[i];
+    }
+    *result = sum;
+}
+
+static void ref_dot_prod_q7(const q7_t *a, const q7_t *b, uint32_t n, q31_t *result)
+{
+    q31_t sum = 0;
+
+    for (uint32_t i = 0; i < n; i++) {
+        sum += (q15_t)a[i] * b[i];
+    }
+    *result = sum;
+}
+
+static void ref_cmplx_conj_q15(const q15_t *a, q15_t *d, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[2 * i] = a[2 * i];
+        d[2 * i + 1] = (q15_t)__SSAT(-a[2 * i + 1], 16);
+    }
+}
+
+static void ref_cmplx_mag_squared_q15(const q15_t *a, q15_t *d, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[i] = (q15_t)(((q63_t)((q31_t)a[2 * i] * a[2 * i]) + (q31_t)a[2 * i + 1] * a[2 * i + 1]) >> 17);
+    }
+}
+
+static void ref_cmplx_dot_prod_q15(const q15_t *a, const q15_t *b, uint32_t n, q31_t *re, q31_t *im)
+{
+    q63_t real_sum = 0, imag_sum = 0;
+
+    for (uint32_t i = 0; i < n; i++) {
+        real_sum += (q31_t)a[2 * i] * b[2 * i];
+        real_sum -= (q31_t)a[2 * i + 1] * b[2 * i + 1];
+        imag_sum += (q31_t)a[2 * i] * b[2 * i + 1];
+        imag_sum += (q31_t)a[2 * i + 1] * b[2 * i];
+    }
+    *re = (q31_t)(real_sum >> 6);
+    *im = (q31_t)(imag_sum >> 6);
+}
+
+static void ref_cmplx_mult_real_q15(const q15_t *a, const q15_t *r, q15_t *d, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[2 * i] = (q15_t)__SSAT(((q31_t)a[2 * i] * r[i]) >> 15, 16);
+        d[2 * i + 1] = (q15_t)__SSAT(((q31_t)a[2 * i + 1] * r[i]) >> 15, 16);
+    }
+}
+
+static void ref_cmplx_mult_cmplx_q15(const q15_t *a, const q15_t *b, q15_t *d, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        d[2 * i] = (q15_t)((((q31_t)a[2 * i] * b[2 * i]) >> 17) - (((q31_t)a[2 * i + 1] * b[2 * i + 1]) >> 17));
+        d[2 * i + 1] = (q15_t)((((q31_t)a[2 * i] * b[2 * i + 1]) >> 17) + (((q31_t)a[2 * i + 1] * b[2 * i]) >> 17));
+    }
+}
+
+/* one runner of each of ref_, riscv_ and riscv_pext_ name, o is its output buffer */
+#define BENCH_RUNNERS(name, args)                                                   \
+    static void run_ref_##name(void *o) { ref_##name args; }                        \
+    static void run_lib_##name(void *o) { riscv_##name args; }                      \
+    static void run_pext_##name(void *o) { riscv_pext_##name args; }
+
+#define O15                     ((q15_t *)o)
+#define O7                      ((q7_t *)o)
+
+BENCH_RUNNERS(add_q15, (a15, b15, O15, BLOCK))
+BENCH_RUNNERS(add_q7, (a7, b7, O7, BLOCK))
+BENCH_RUNNERS(sub_q15, (a15, b15, O15, BLOCK))
+BENCH_RUNNERS(sub_q7, (a7, b7, O7, BLOCK))
+BENCH_RUNNERS(mult_q15, (a15, b15, O15, BLOCK))
+BENCH_RUNNERS(mult_q7, (a7, b7, O7, BLOCK))
+BENCH_RUNNERS(abs_q15, (a15, O15, BLOCK))
+BENCH_RUNNERS(abs_q7, (a7, O7, BLOCK))
+BENCH_RUNNERS(negate_q15, (a15, O15, BLOCK))
+BENCH_RUNNERS(negate_q7, (a7, O7, BLOCK))
+BENCH_RUNNERS(offset_q15, (a15, b15[0], O15, BLOCK))
+BENCH_RUNNERS(offset_q7, (a7, b7[0], O7, BLOCK))
+BENCH_RUNNERS(shift_q15, (a15, SHIFT_Q15, O15, BLOCK))
+BENCH_RUNNERS(shift_q7, (a7, -SHIFT_Q7, O7, BLOCK))
+BENCH_RUNNERS(scale_q15, (a15, b15[1], SCALE_SHIFT, O15, BLOCK))
+BENCH_RUNNERS(scale_q7, (a7, b7[1], SCALE_SHIFT, O7, BLOCK))
+BENCH_RUNNERS(clip_q15, (a15, O15, -0x4000, 0x3000, BLOCK))
+BENCH_RUNNERS(clip_q7, (a7, O7, -0x40, 0x30, BLOCK))
+BENCH_RUNNERS(dot_prod_q15, (a15, b15, BLOCK, (q63_t *)o))
+BENCH_RUNNERS(dot_prod_q7, (a7, b7, BLOCK, (q31_t *)o))
+BENCH_RUNNERS(cmplx_conj_q15, (a15, O15, BLOCK))
+BENCH_RUNNERS(cmplx_mag_squared_q15, (a15, O15, BLOCK))
+BENCH_RUNNERS(cmplx_dot_prod_q15, (a15, b15, BLOCK, (q31_t *)o, (q31_t *)o + 1))
+BENCH_RUNNERS(cmplx_mult_real_q15, (a15, b15, O15, BLOCK))
+BENCH_RUNNERS(cmplx_mult_cmplx_q15, (a15, b15, O15, BLOCK))
+
+typedef struct bench_case {
+    const char *name;
+    void (*run[3])(void *o);        /* reference, library, pext */
+    uint32_t bytes;                 /* size of output */
+} bench_case_t;
+
+#define BENCH_CASE(name, bytes)     {#name, {run_ref_##name, run_lib_##name, run_pext_##name}, (bytes)}
+
+static const bench_case_t cases[] = {
+    BENCH_CASE(add_q15, BLOCK * sizeof(q15_t)),
+    BENCH_CASE(add_q7, BLOCK * sizeof(q7_t)),
+    BENCH_CASE(sub_q15, BLOCK * sizeof(q15_t)),
+    BENCH_CASE(sub_q7, BLOCK * sizeof(q7_t)),
+    BENCH_CASE(mult_q15, BLOCK * sizeof(q15_t)),
+    BENCH_CASE(mult_q7, BLOCK * sizeof(q7_t)),
+    BENCH_CASE(abs_q15, BLOCK * sizeof(q15_t)),
+    BENCH_CASE(abs_q7, BLOCK * sizeof(q7_t)),
+    BENCH_CASE(negate_q15, BLOCK * sizeof(q15_t)),
+    BENCH_CASE(negate_q7, BLOCK * sizeof(q7_t)),
+    BENCH_CASE(offset_q15, BLOCK * sizeof(q15_t)),
+    BENCH_CASE(offset_q7, BLOCK * sizeof(q7_t)),
+    BENCH_CASE(shift_q15, BLOCK * sizeof(q15_t)),
+    BENCH_CASE(shift_q7, BLOCK * sizeof(q7_t)),
+    BENCH_CASE(scale_q15, BLOCK * sizeof(q15_t)),
+    BENCH_CASE(scale_q7, BLOCK * sizeof(q7_t)),
+    BENCH_CASE(clip_q15, BLOCK * sizeof(q15_t)),
+    BENCH_CASE(clip_q7, BLOCK * sizeof(q7_t)),
+    BENCH_CASE(dot_prod_q15, sizeof(q63_t)),
+    BENCH_CASE(dot_prod_q7, sizeof(q31_t)),
+    BENCH_CASE(cmplx_conj_q15, 2 * BLOCK * sizeof(q15_t)),
+    BENCH_CASE(cmplx_mag_squared_q15, BLOCK * sizeof(q15_t)),
+    BENCH_CASE(cmplx_dot_prod_q15, 2 * sizeof(q31_t)),
+    BENCH_CASE(cmplx_mult_real_q15, 2 * BLOCK * sizeof(q15_t)),
+    BENCH_CASE(cmplx_mult_cmplx_q15, 2 * BLOCK * sizeof(q15_t)),
+};
+
+static void fill(void)
+{
+    uint32_t seed = 1;
+
+    for (uint32_t i = 0; i < 2 * VEC_LEN; i++) {
+        seed = seed * 1103515245 + 12345;
+        a15[i] = (q15_t)(seed >> 16);
+        seed = seed * 1103515245 + 12345;
+        b15[i] = (q15_t)(seed >> 16);
+    }
+    for (uint32_t i = 0; i < VEC_LEN; i++) {
+        a7[i] = (q7_t)(a15[i] >> 8);
+        b7[i] = (q7_t)(b15[i] >> 8);
+    }
+    // the saturating corner cases, -1.0 * -1.0 and -(-1.0)
+    a15[0] = b15[0] = (q15_t)0x8000;
+    a7[0] = b7[0] = (q7_t)0x80;
+}
+
+/*
+ * print one row of each case, the speedups are in percent of reference cycles, a library
+ * call near 100% is not SIMD optimized, exact tells whether the output has the same bits
+ * as the reference
+ */
+int main(void)
+{
+    uint64_t cyc[3];
+    int32_t exact[3];
+    uint32_t failed = 0, i, v;
+
+    fill();
+    printf("P extension q7 and q15 kernels against scalar C, %d samples\n", BLOCK);
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        for (v = 0; v < 3; v++) {
+            memset(out[v], 0, sizeof(out[v]));
+            BENCH_START();
+            cases[i].run[v](out[v]);
+            BENCH_END(cyc[v]);
+            exact[v] = (memcmp(out[0], out[v], cases[i].bytes) == 0);
+        }
+        failed += (exact[2] == 0);
+        printf("%-22s ref %8lu, lib %8lu (%4lu%% %s), pext %8lu (%4lu%% %s) cycles\n", cases[i].name,
+               (unsigned long)cyc[0], (unsigned long)cyc[1], (unsigned long)((cyc[0] * 100) / (cyc[1] ? cyc[1] : 1)),
+               exact[1] ? "exact" : "DIFF", (unsigned long)cyc[2],
+               (unsigned long)((cyc[0] * 100) / (cyc[2] ? cyc[2] : 1)), exact[2] ? "exact" : "DIFF");
+    }
+    printf("pext benchmark finished, %s\n", (failed == 0) ? "PASS" : "FAIL");
+    return (failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+// See LICENSE for license details.
+#include <stdio.h>
+#include "nuclei_sdk_soc.h"
+#include "nmsis_bench.h"
+
+#if !defined(SMP_CPU_CNT) || (SMP_CPU_CNT < 2)
+#error "SMP_CPU_CNT macro is not defined, please set SMP_CPU_CNT to integer value > 1"
+#endif
+
+#ifdef CFG_SIMULATION
+#define RUN_LOOPS               2
+#define WORK_SIZE               256
+#else
+#define RUN_LOOPS               10
+#define WORK_SIZE               4096
+#endif
+
+BENCH_DECLARE_VAR();
+
+// each hart works on its own part of data
+static volatile uint32_t work_data[SMP_CPU_CNT][WORK_SIZE];
+static volatile uint32_t work_result[SMP_CPU_CNT];
+static volatile uint32_t bench_ready = 0;
+
+static void compute_kernel(unsigned long hartidx)
+{
+    volatile uint32_t *data = work_data[hartidx];
+    uint32_t sum = 0;
+
+    for (int i = 0; i < WORK_SIZE; i ++) {
+        data[i] = data[i] * 1103515245 + 12345;
+        sum += data[i] >> 16;
+    }
+    work_result[hartidx] = sum;
+}
+
+/* Reimplementation of smp_main for multi-harts */
+int smp_main(void)
+{
+    unsigned long hartid = __get_hart_id();
+    unsigned long hartidx = __get_hart_index();
+
+    if (hartid == BOOT_HARTID) {
+        bench_ready = 1;
+        __SMP_RWMB();
+    } else {
+        // wait for boot hart finish c runtime initialization
+        while (bench_ready == 0);
+    }
+    BENCH_INIT();
+    BENCH_RESET(compute);
+    for (int i = 0; i < RUN_LOOPS; i ++) {
+        // all harts start at the same time, measure scaling with shared memory bus
+        BENCH_SMP_START(compute);
+        compute_kernel(hartidx);
+        BENCH_SAMPLE(compute);
+    }
+    BENCH_SMP_STAT(compute);
+    if (hartid == BOOT_HARTID) {
+        printf("SMP benchmark finished\n");
+    }
+    return 0;
+}
@@ -0,0 +1,143 @@
+// See LICENSE for license details.
+#include <stdio.h>
+#include "nuclei_sdk_soc.h"
+#include "nmsis_bench.h"
+
+#if defined(__TEE_PRESENT) && (__TEE_PRESENT == 1) && defined(__PMP_PRESENT) && (__PMP_PRESENT == 1)
+#else
+#error "This example require CPU TEE and PMP feature"
+#endif
+
+#if defined(NUCLEI_FAST_SYSCALL_S) && (NUCLEI_FAST_SYSCALL_S == 1) && !defined(__riscv_32e)
+#else
+#error "This example require NUCLEI_FAST_SYSCALL_S=1 and none rv32e core"
+#endif
+
+#ifdef CFG_SIMULATION
+#define RUN_LOOPS               20
+#else
+#define RUN_LOOPS               1000
+#endif
+
+// Cycle width and count of histogram buckets for syscall round-trip latency
+#define SYSCALL_HIST_WIDTH      4
+#define SYSCALL_HIST_BUCKETS    128
+
+// Syscall number of fast path, registered by Syscall_Register_S
+#define SYS_ADD_FAST            0
+// Syscall number without fast path handler, handled through core_exception_handler_s
+#define SYS_ADD_GENERIC         MAX_SYSCALL_NUM_S
+
+// 2048 is enough
+#define UMODE_STACK_SIZE        2048
+
+BENCH_DECLARE_VAR();
+
+BENCH_HIST_DECLARE(fast_syscall, SYSCALL_HIST_WIDTH, SYSCALL_HIST_BUCKETS);
+BENCH_HIST_DECLARE(generic_syscall, SYSCALL_HIST_WIDTH, SYSCALL_HIST_BUCKETS);
+
+/* Create a stack for user mode execution */
+static uint8_t umode_stack[UMODE_STACK_SIZE] __attribute__((aligned(16)));
+
+static volatile uint32_t syscall_errors = 0;
+
+static unsigned long sys_add(unsigned long a0, unsigned long a1, unsigned long a2,
+                             unsigned long a3, unsigned long a4, unsigned long a5)
+{
+    return a0 + a1 + a2;
+}
+
+// user mode ecall without fast path handler, entered through the generic exception frame
+static void umode_ecall_handler(unsigned long scause, unsigned long sp)
+{
+    EXC_Frame_Type *frame = (EXC_Frame_Type *)sp;
+
+    if (frame->a7 == SYS_ADD_GENERIC) {
+        frame->a0 = sys_add(frame->a0, frame->a1, frame->a2, frame->a3, frame->a4, frame->a5);
+    } else {
+        syscall_errors++;
+    }
+    frame->epc += 4;
+}
+
+// user mode can't read mcycle, cycle is enabled by mcounteren and scounteren
+__STATIC_FORCEINLINE unsigned long read_ucycle(void)
+{
+    return __RV_CSR_READ(CSR_CYCLE);
+}
+
+// cycles from the instruction before ecall to the one after ecall returned
+__attribute__((noinline)) static unsigned long measure_syscall(unsigned long num, unsigned long ovhcyc)
+{
+    unsigned long start, end, ret;
+
+    start = read_ucycle();
+    ret = __syscall_s(num, 1, 2, 3);
+    end = read_ucycle();
+    if (ret != 6) {
+        syscall_errors++;
+    }
+    return (unsigned long)__bench_remove_overhead(end - start, ovhcyc);
+}
+
+static void user_mode_entry_point(void)
+{
+    unsigned long start, ovhcyc = (unsigned long)-1;
+
+    // overhead of reading cycle back to back
+    for (int i = 0; i < 16; i ++) {
+        start = read_ucycle();
+        start = read_ucycle() - start;
+        ovhcyc = (start < ovhcyc) ? start : ovhcyc;
+    }
+    // warm up caches and branch predictors, not recorded
+    measure_syscall(SYS_ADD_FAST, ovhcyc);
+    measure_syscall(SYS_ADD_GENERIC, ovhcyc);
+    for (int i = 0; i < RUN_LOOPS; i ++) {
+        BENCH_HIST_ADD(fast_syscall, measure_syscall(SYS_ADD_FAST, ovhcyc));
+        BENCH_HIST_ADD(generic_syscall, measure_syscall(SYS_ADD_GENERIC, ovhcyc));
+    }
+
+    printf("User mode syscall round-trip latency in cycles, %d loops\n", RUN_LOOPS);
+    printf("HIST, proc, cnt, mincyc, avgcyc, p50, p90, p99, maxcyc, overflow\n");
+    BENCH_HIST_STAT(fast_syscall);
+    BENCH_HIST_STAT(generic_syscall);
+    BENCH_HIST_DUMP(fast_syscall);
+    BENCH_HIST_DUMP(generic_syscall);
+    if (syscall_errors != 0) {
+        printf("Syscall latency benchmark failed with %u errors\n", (unsigned int)syscall_errors);
+    } else {
+        printf("Syscall latency benchmark finished\n");
+    }
+#ifdef CFG_SIMULATION
+    // directly exit if in nuclei internally simulation
+    SIMULATION_EXIT(syscall_errors);
+#endif
+    while (1);
+}
+
+int main(void)
+{
+    // set pmp, U mode can access all address range
+    pmp_config pmp_cfg = {
+        .protection = PMP_L | PMP_R | PMP_W | PMP_X,
+        .order = __RISCV_XLEN,
+        .base_addr = 0,
+    };
+
+    BENCH_INIT();
+
+    __set_PMPENTRYx(0, &pmp_cfg);
+    // let user mode read cycle
+    __RV_CSR_SET(CSR_MCOUNTEREN, 0x1);
+    __RV_CSR_SET(CSR_SCOUNTEREN, 0x1);
+    // user mode ecall is handled by exc_entry_s in supervisor mode
+    __set_medeleg(USER_ECALL);
+
+    Exception_Register_EXC_S(UmodeEcall_EXCn, (unsigned long)umode_ecall_handler);
+    Syscall_Register_S(SYS_ADD_FAST, (unsigned long)sys_add);
+
+    printf("Drop to U-Mode now\n\r");
+    __switch_mode(PRV_U, (uintptr_t)(umode_stack + sizeof(umode_stack)), user_mode_entry_point);
+    return 0;
+}
@@ -0,0 +1,57 @@
+// See LICENSE for license details.
+#include <stdio.h>
+#include "nuclei_sdk_soc.h"
+#include "autotune_api.h"
+
+#ifdef CFG_SIMULATION
+#define DATA_WORDS      256
+#else
+#define DATA_WORDS      4096
+#endif
+
+static uint32_t data[DATA_WORDS];
+static volatile uint32_t sink;
+
+/* branch heavy and memory bound workload, result is the same under all settings */
+static void workload(void *arg)
+{
+    uint32_t *buf = (uint32_t *)arg;
+    uint32_t i, sum = 0;
+
+    for (i = 0; i < DATA_WORDS; i++) {
+        if (buf[i] & 1) {
+            sum += buf[i] >> 1;
+        } else {
+            sum ^= buf[(buf[i] >> 4) % DATA_WORDS];
+        }
+    }
+    sink = sum;
+}
+
+int main(void)
+{
+    autotune_result_t best;
+    uint32_t i, seed = 1;
+    const SystemTuning_Type *profile;
+
+    for (i = 0; i < DATA_WORDS; i++) {
+        seed = seed * 1103515245 + 12345;
+        data[i] = seed >> 8;
+    }
+    printf("Tuning features supported 0x%lx, enabled 0x%lx\n",
+           (unsigned long)SystemTuning_Supported(), (unsigned long)SystemTuning_Get());
+    printf("Profiles:");
+    for (profile = SystemTuningProfiles; profile->name != NULL; profile++) {
+        printf(" %s", profile->name);
+    }
+    printf("\n");
+
+    if (autotune_run(workload, data, TUNING_BPU | TUNING_LDSPEC | TUNING_ICACHE | TUNING_DCACHE, 0, &best) == 0) {
+        printf("No tuning feature supported\n");
+        return 0;
+    }
+    SystemTuning_Set(best.mask, best.enable);
+    printf("Applied best setting 0x%lx, %lu cycles\n", (unsigned long)SystemTuning_Get(), (unsigned long)best.cycles);
+    SystemTuning_Apply("performance");
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include <stdio.h>
+#include "nuclei_sdk_soc.h"
+
+#if !defined(__CIDU_PRESENT) || (__CIDU_PRESENT != 1)
+#error "CIDU is required for this demo, please define CFG_HAS_IDU in cpufeature.h"
+#endif
+
+#if !defined(SMP_CPU_CNT)
+#error "SMP_CPU_CNT macro is not defined, please set SMP_CPU_CNT to integer value > 1"
+#endif
+
+// semaphore 0 is used to protect the uart and the counter
+#define DEMO_SEMAPHORE_ID       0
+#define DEMO_LOOPS              4
+
+CIDU_Mutex_Type mutex;
+volatile uint32_t mutex_ready = 0;
+volatile uint32_t lock_count = 0;
+
+int smp_main(void);
+int main(void);
+
+/* Reimplementation of smp_main for multi-harts */
+int smp_main(void)
+{
+    return main();
+}
+
+int main(void)
+{
+    // get hart id in current cluster
+    unsigned long hartid = __get_hart_id();
+
+    // waiting core is waked up by inter core interrupt
+    ECLIC_EnableIRQ(InterCore_IRQn);
+    if (hartid == BOOT_HARTID) { // boot hart
+        CIDU_Mutex_Init(&mutex, DEMO_SEMAPHORE_ID);
+        mutex_ready = 1;
+        __RWMB();
+    } else { // other harts
+        while (mutex_ready == 0);
+    }
+
+    for (int i = 0; i < DEMO_LOOPS; i++) {
+        CIDU_Mutex_Lock(&mutex, hartid);
+        lock_count += 1;
+        printf("Hart %lu locked the mutex, count %lu\n", hartid, (unsigned long)lock_count);
+        CIDU_Mutex_Unlock(&mutex, hartid);
+    }
+
+    if (hartid == BOOT_HARTID) {
+        while (lock_count < SMP_CPU_CNT * DEMO_LOOPS);
+        printf("CIDU mutex demo finished, %d harts locked it %d times each\n", SMP_CPU_CNT, DEMO_LOOPS);
+    }
+    return 0;
+}
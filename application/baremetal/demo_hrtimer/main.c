@@ -0,0 +1,66 @@
+// See LICENSE for license details.
+#include <stdio.h>
+#include "nuclei_sdk_soc.h"
+#include "hrtimer_api.h"
+
+#if defined(__ECLIC_PRESENT) && (__ECLIC_PRESENT == 1)
+#else
+#error "This example require CPU ECLIC feature"
+#endif
+
+#if defined(__SYSTIMER_PRESENT) && (__SYSTIMER_PRESENT == 1)
+#else
+#error "This example require CPU System Timer feature"
+#endif
+
+#ifdef CFG_SIMULATION
+#define RUN_MS          20
+#else
+#define RUN_MS          1000
+#endif
+
+static volatile uint32_t fast_cnt = 0;      /* 1ms periodic timer counter */
+static volatile uint32_t slow_cnt = 0;      /* 7ms periodic timer counter */
+static volatile uint32_t done = 0;          /* set by one-shot timer */
+
+static hrtimer_t fast_tmr, slow_tmr, once_tmr;
+
+static void count_cb(void *arg)
+{
+    (*(volatile uint32_t *)arg)++;
+}
+
+static void stop_cb(void *arg)
+{
+    (void)arg;
+    hrtimer_cancel(&fast_tmr);
+    hrtimer_cancel(&slow_tmr);
+    done = 1;
+}
+
+int main(void)
+{
+    hrtimer_stat_t stat;
+
+    hrtimer_service_init(1);
+    hrtimer_init(&fast_tmr, count_cb, (void *)&fast_cnt);
+    hrtimer_init(&slow_tmr, count_cb, (void *)&slow_cnt);
+    hrtimer_init(&once_tmr, stop_cb, NULL);
+
+    hrtimer_start_after(&fast_tmr, HRTIMER_MS(1), HRTIMER_MS(1));
+    hrtimer_start_after(&slow_tmr, HRTIMER_MS(7), HRTIMER_MS(7));
+    hrtimer_start_after(&once_tmr, HRTIMER_MS(RUN_MS), 0);
+    __enable_irq();
+
+    // sleep until the next deadline instead of polling the timer counter
+    while (done == 0) {
+        __WFI();
+    }
+
+    hrtimer_get_stat(__get_hart_index(), &stat);
+    printf("fast timer runs %u, slow timer runs %u in %u ms\r\n", (unsigned int)fast_cnt,
+           (unsigned int)slow_cnt, (unsigned int)RUN_MS);
+    printf("interrupts %u, callbacks %u, max latency %u ticks\r\n", (unsigned int)stat.irqs,
+           (unsigned int)stat.runs, (unsigned int)stat.max_latency);
+    return 0;
+}
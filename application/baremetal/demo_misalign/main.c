@@ -0,0 +1,48 @@
+// See LICENSE for license details.
+#include <stdio.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "misalign_api.h"
+
+#define LOOP_COUNT      8
+
+static uint8_t buffer[64] __attribute__((aligned(8)));
+
+/* access through plain pointers, so compiler emits word load/store to misaligned address */
+static __attribute__((noinline)) uint32_t read_u32(volatile uint32_t *p)
+{
+    return *p;
+}
+
+static __attribute__((noinline)) void write_u32(volatile uint32_t *p, uint32_t val)
+{
+    *p = val;
+}
+
+int main(void)
+{
+    volatile uint32_t *p32 = (volatile uint32_t *)(buffer + 1);
+    volatile int16_t *p16 = (volatile int16_t *)(buffer + 9);
+    uint32_t i, errors = 0;
+    uint32_t val;
+
+    // trap misaligned access even if cpu supports it in hardware
+    __RV_CSR_CLEAR(CSR_MMISC_CTL, MMISC_CTL_MISALIGN);
+    misalign_init();
+
+    for (i = 0; i < LOOP_COUNT; i++) {
+        write_u32(p32, 0x12345678 + i);
+        val = read_u32(p32);
+        if ((val != 0x12345678 + i) || (memcmp(buffer + 1, &val, sizeof(val)) != 0)) {
+            errors++;
+        }
+    }
+    *p16 = -2;
+    if (*p16 != -2) {
+        errors++;
+    }
+
+    misalign_dump();
+    printf("Misaligned emulation %s, errors %u\r\n", errors == 0 ? "PASS" : "FAIL", (unsigned int)errors);
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <string.h>
+#include "nuclei_sdk_soc.h"
+#include "niceq_api.h"
+
+#ifndef CFG_HAS_NICE
+#error "This example require CPU NICE Demo feature"
+#endif
+
+#define ROW_LEN     3
+#define COL_LEN     3
+
+/* instructions of the NICE demo, see demo_nice */
+NICEQ_INSN_S1(custom_lbuf, NICEQ_OPCODE_CUSTOM0, 1)
+NICEQ_INSN_S1(custom_sbuf, NICEQ_OPCODE_CUSTOM0, 2)
+NICEQ_INSN_D_S1(custom_rowsum, NICEQ_OPCODE_CUSTOM0, 6)
+
+typedef struct matrix_case {
+    unsigned int array[ROW_LEN][COL_LEN];
+    unsigned int col_sum_ref[COL_LEN];
+    unsigned int row_sum_ref[ROW_LEN];
+    unsigned int col_sum_nice[COL_LEN];
+    unsigned int row_sum_nice[ROW_LEN];
+} matrix_case_t;
+
+static matrix_case_t matrix = {
+    .array = {
+        {10, 30, 90},
+        {20, 40, 80},
+        {30, 90, 120}
+    }
+};
+
+static void matrix_prepare(void *arg)
+{
+    matrix_case_t *m = (matrix_case_t *)arg;
+
+    memset(m->col_sum_ref, 0, sizeof(m->col_sum_ref));
+    memset(m->row_sum_ref, 0, sizeof(m->row_sum_ref));
+    memset(m->col_sum_nice, 0, sizeof(m->col_sum_nice));
+    memset(m->row_sum_nice, 0, sizeof(m->row_sum_nice));
+}
+
+static void matrix_ref(void *arg)
+{
+    matrix_case_t *m = (matrix_case_t *)arg;
+    int i, j;
+
+    for (i = 0; i < ROW_LEN; i++) {
+        m->row_sum_ref[i] = 0;
+        for (j = 0; j < COL_LEN; j++) {
+            m->col_sum_ref[j] += m->array[i][j];
+            m->row_sum_ref[i] += m->array[i][j];
+        }
+    }
+}
+
+static void matrix_nice(void *arg)
+{
+    matrix_case_t *m = (matrix_case_t *)arg;
+    unsigned long init_buf[COL_LEN] = {0};
+    int i;
+
+    custom_lbuf((unsigned long)init_buf);
+    for (i = 0; i < ROW_LEN; i++) {
+        m->row_sum_nice[i] = (unsigned int)custom_rowsum((unsigned long)m->array[i]);
+    }
+    custom_sbuf((unsigned long)m->col_sum_nice);
+}
+
+static int32_t matrix_check(void *arg)
+{
+    matrix_case_t *m = (matrix_case_t *)arg;
+
+    return (memcmp(m->col_sum_ref, m->col_sum_nice, sizeof(m->col_sum_ref)) != 0) ||
+           (memcmp(m->row_sum_ref, m->row_sum_nice, sizeof(m->row_sum_ref)) != 0);
+}
+
+/*
+ * rowsum of the NICE demo as a queued unit, the demo accelerator writes rd when it is done,
+ * so poll() finds the command done, an accelerator of long latency returns at issue and
+ * reads a status by a NICEQ_INSN_D instruction in poll()
+ */
+static int32_t rowsum_issue(niceq_unit_t *unit, niceq_cmd_t *cmd)
+{
+    cmd->result = custom_rowsum(cmd->arg[0]);
+    return 0;
+}
+
+static int32_t rowsum_poll(niceq_unit_t *unit, niceq_cmd_t *cmd)
+{
+    return NICEQ_DONE;
+}
+
+static void rowsum_done(niceq_cmd_t *cmd, void *arg)
+{
+    unsigned int *row_sum = (unsigned int *)arg;
+
+    row_sum[cmd->op] = (unsigned int)cmd->result;
+}
+
+static niceq_unit_t rowsum_unit = {
+    .issue = rowsum_issue,
+    .poll = rowsum_poll,
+    .depth = 1,
+};
+
+static void matrix_queue(void *arg)
+{
+    matrix_case_t *m = (matrix_case_t *)arg;
+    unsigned long init_buf[COL_LEN] = {0};
+    niceq_cmd_t cmd[ROW_LEN];
+    int i;
+
+    custom_lbuf((unsigned long)init_buf);
+    for (i = 0; i < ROW_LEN; i++) {
+        cmd[i].op = i;
+        cmd[i].arg[0] = (unsigned long)m->array[i];
+        cmd[i].cb = rowsum_done;
+        cmd[i].cb_arg = m->row_sum_nice;
+        niceq_submit(&rowsum_unit, &cmd[i]);
+    }
+    niceq_flush(&rowsum_unit);
+    custom_sbuf((unsigned long)m->col_sum_nice);
+}
+
+static const niceq_bench_case_t cases[] = {
+    {"rowsum", matrix_prepare, matrix_ref, matrix_nice, matrix_check, &matrix},
+    {"rowsum queued", matrix_prepare, matrix_ref, matrix_queue, matrix_check, &matrix},
+};
+
+int main(void)
+{
+    uint32_t failed;
+
+    niceq_enable();
+    niceq_unit_init(&rowsum_unit);
+
+    printf("\r\nNuclei NICE offload with niceq\r\n");
+    printf("Warning: This demo required CPU to implement Nuclei provided NICE Demo instructions.\r\n");
+    printf("         Otherwise this example will trap to cpu core exception!\r\n\r\n");
+
+    failed = niceq_bench_run(cases, sizeof(cases) / sizeof(cases[0]), 4, NULL);
+    printf("%s\r\n", (failed == 0) ? "PASS" : "FAIL");
+    return (failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+#include <stdio.h>
+#include "nuclei_sdk_soc.h"
+#include "smpcall_api.h"
+
+#if !defined(__riscv_atomic)
+#error "RVA(atomic) extension is required for SMP"
+#endif
+
+#if !defined(SMP_CPU_CNT)
+#error "SMP_CPU_CNT macro is not defined, please set SMP_CPU_CNT to integer value > 1"
+#endif
+
+#define ASYNC_CALLS     32
+
+static SpinBarrier_Type demo_bar = SPINBARRIER_INIT(SMP_CPU_CNT);
+static volatile uint32_t demo_done = 0;
+/* times each hart runs the functions */
+static volatile uint32_t hart_runs[SMP_CPU_CNT];
+static volatile uint32_t hart_sum[SMP_CPU_CNT];
+
+int smp_main(void);
+int main(void);
+
+/* Reimplementation of smp_main for multi-harts */
+int smp_main(void)
+{
+    return main();
+}
+
+/* count the call on the hart running it */
+static void count_call(void *arg)
+{
+    hart_runs[__get_hart_index()]++;
+}
+
+/* add arg to sum of the hart running it */
+static void add_value(void *arg)
+{
+    hart_sum[__get_hart_index()] += (uint32_t)(unsigned long)arg;
+}
+
+/* flush dcache of the hart running it, as before a DMA transfer reading data of all harts */
+static void flush_dcache(void *arg)
+{
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1) && defined(__CCM_PRESENT) && (__CCM_PRESENT == 1)
+    MFlushDCache();
+#endif
+}
+
+int main(void)
+{
+    unsigned long hartidx = __get_hart_index();
+    unsigned long others = ((1UL << SMP_CPU_CNT) - 1) & ~(1UL << hartidx);
+    uint64_t start, sync_cycles, async_cycles;
+    uint32_t i, expect, failed = 0;
+
+    smpcall_init(1);
+    __enable_irq();
+    // all harts take calls before any call is made
+    SpinBarrier_Wait(&demo_bar);
+    if (__get_hart_id() != BOOT_HARTID) {
+        // calls are run in IPI handler, nothing to do here
+        while (demo_done == 0) {
+            __WFI();
+        }
+        return 0;
+    }
+
+    start = __get_rv_cycle();
+    smp_call_on(others, count_call, NULL, SMPCALL_WAIT);
+    sync_cycles = __get_rv_cycle() - start;
+
+    start = __get_rv_cycle();
+    for (i = 1; i <= ASYNC_CALLS; i++) {
+        smp_call_on(others, add_value, (void *)(unsigned long)i, SMPCALL_NOWAIT);
+    }
+    async_cycles = __get_rv_cycle() - start;
+    // calls of one hart run in order, so the last synchronous call waits for all before it
+    smp_call_on(others | (1UL << hartidx), flush_dcache, NULL, SMPCALL_WAIT);
+
+    expect = ASYNC_CALLS * (ASYNC_CALLS + 1) / 2;
+    for (i = 0; i < SMP_CPU_CNT; i++) {
+        if (i == hartidx) {
+            continue;
+        }
+        printf("hart %u: runs %u, sum %u\n", (unsigned int)i, (unsigned int)hart_runs[i], (unsigned int)hart_sum[i]);
+        if ((hart_runs[i] != 1) || (hart_sum[i] != expect)) {
+            failed++;
+        }
+    }
+    printf("Synchronous call cost %lu cycles, %u asynchronous calls cost %lu cycles\n",
+           (unsigned long)sync_cycles, (unsigned int)ASYNC_CALLS, (unsigned long)async_cycles);
+    printf("SMP call demo %s\n", (failed == 0) ? "PASS" : "FAIL");
+
+    demo_done = 1;
+    __SMP_RWMB();
+    // wake up the others waiting in wfi
+    smp_call_on(others, count_call, NULL, SMPCALL_NOWAIT);
+    return (failed == 0) ? 0 : 1;
+}
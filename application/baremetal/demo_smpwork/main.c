@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include "nuclei_sdk_soc.h"
+#include "smpwork_api.h"
+
+#if !defined(__riscv_atomic)
+#error "RVA(atomic) extension is required for SMP"
+#endif
+
+#if !defined(SMP_CPU_CNT)
+#error "SMP_CPU_CNT macro is not defined, please set SMP_CPU_CNT to integer value > 1"
+#endif
+
+#define MAT_DIM         32
+#define VEC_LEN         4096
+
+static int32_t mat_a[MAT_DIM][MAT_DIM];
+static int32_t mat_b[MAT_DIM][MAT_DIM];
+static int32_t mat_c[MAT_DIM][MAT_DIM];
+static int32_t vec_x[VEC_LEN];
+
+int smp_main(void);
+int main(void);
+
+/* Reimplementation of smp_main for multi-harts */
+int smp_main(void)
+{
+    return main();
+}
+
+/* scale vector elements in [begin, end) */
+static void vec_scale(void *arg, unsigned long begin, unsigned long end)
+{
+    int32_t scale = *(int32_t *)arg;
+
+    for (unsigned long i = begin; i < end; i++) {
+        vec_x[i] = (int32_t)i * scale;
+    }
+}
+
+/* compute rows [begin, end) of mat_c = mat_a * mat_b */
+static void mat_mult_rows(void *arg, unsigned long begin, unsigned long end)
+{
+    for (unsigned long i = begin; i < end; i++) {
+        for (unsigned long j = 0; j < MAT_DIM; j++) {
+            int32_t sum = 0;
+            for (unsigned long k = 0; k < MAT_DIM; k++) {
+                sum += mat_a[i][k] * mat_b[k][j];
+            }
+            mat_c[i][j] = sum;
+        }
+    }
+}
+
+static int check_result(int32_t scale)
+{
+    for (unsigned long i = 0; i < VEC_LEN; i++) {
+        if (vec_x[i] != (int32_t)i * scale) {
+            return -1;
+        }
+    }
+    for (unsigned long i = 0; i < MAT_DIM; i++) {
+        for (unsigned long j = 0; j < MAT_DIM; j++) {
+            // mat_a is all 1 and mat_b[k][j] is j, so mat_c[i][j] is MAT_DIM * j
+            if (mat_c[i][j] != (int32_t)(MAT_DIM * j)) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(void)
+{
+    unsigned long hartid = __get_hart_id();
+    int32_t scale = 3;
+    uint64_t start, end;
+    int ret;
+
+    if (hartid != BOOT_HARTID) {
+        // other harts run tasks until boot hart stop the pool
+        smpwork_worker();
+        smpwork_barrier();
+        return 0;
+    }
+
+    for (unsigned long i = 0; i < MAT_DIM; i++) {
+        for (unsigned long j = 0; j < MAT_DIM; j++) {
+            mat_a[i][j] = 1;
+            mat_b[i][j] = (int32_t)j;
+        }
+    }
+    start = __get_rv_cycle();
+    smpwork_parallel_for(0, VEC_LEN, 256, vec_scale, &scale);
+    smpwork_parallel_for(0, MAT_DIM, 2, mat_mult_rows, NULL);
+    end = __get_rv_cycle();
+    ret = check_result(scale);
+    printf("Parallel for on %d harts cost %lu cycles, result %s\n", SMP_CPU_CNT,
+           (unsigned long)(end - start), (ret == 0) ? "PASS" : "FAIL");
+
+    smpwork_stop();
+    smpwork_barrier();
+    return ret;
+}
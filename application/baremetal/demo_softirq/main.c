@@ -0,0 +1,80 @@
+// See LICENSE for license details.
+#include <stdio.h>
+#include "nuclei_sdk_soc.h"
+#include "softirq_api.h"
+
+#if defined(__ECLIC_PRESENT) && (__ECLIC_PRESENT == 1)
+#else
+#error "This example require CPU ECLIC feature"
+#endif
+
+#if defined(__SYSTIMER_PRESENT) && (__SYSTIMER_PRESENT == 1)
+#else
+#error "This example require CPU System Timer feature"
+#endif
+
+/* Top half interrupt rate and the time bottom half takes */
+#define TICK_HZ         1000
+#define WORK_MS         3
+
+#ifdef CFG_SIMULATION
+#define LOOP_COUNT      10
+#else
+#define LOOP_COUNT      100
+#endif
+
+/* Define the interrupt handler name same as vector table in case download mode is flashxip. */
+#define mtimer_irq_handler     eclic_mtip_handler
+
+static volatile uint32_t tick_pending = 0;  /* events produced by top half */
+static volatile uint32_t work_done = 0;     /* events consumed by bottom half */
+static uint32_t work_loops = 0;
+
+static void tick_work(void *arg);
+static softirq_work_t tick_softirq = SOFTIRQ_WORK_INIT(tick_work, NULL);
+
+/* Top half, just record the event and defer the processing */
+void mtimer_irq_handler(void)
+{
+    SysTimer_SetCompareValue(SysTimer_GetCompareValue() + SOC_TIMER_FREQ / TICK_HZ);
+    tick_pending++;
+    softirq_raise(&tick_softirq);
+}
+
+/* Bottom half, process all the pending events at once, preempted by timer interrupt */
+static void tick_work(void *arg)
+{
+    uint32_t events;
+
+    __disable_irq();
+    events = tick_pending;
+    tick_pending = 0;
+    __enable_irq();
+
+    delay_1ms(WORK_MS);
+    work_done += events;
+    work_loops++;
+}
+
+int main(void)
+{
+    softirq_stat_t stat;
+
+    /* bottom half runs at level 0, lower than the top half at level 1 */
+    softirq_init(0);
+    ECLIC_Register_IRQ(SysTimer_IRQn, ECLIC_NON_VECTOR_INTERRUPT, ECLIC_LEVEL_TRIGGER, 1, 0,
+                       (void *)mtimer_irq_handler);
+    SysTimer_SetCompareValue(SysTimer_GetLoadValue() + SOC_TIMER_FREQ / TICK_HZ);
+    __enable_irq();
+
+    while (work_loops < LOOP_COUNT) {
+        __WFI();
+    }
+    ECLIC_DisableIRQ(SysTimer_IRQn);
+
+    softirq_get_stat(__get_hart_index(), &stat);
+    printf("events %u handled by %u works\n", (unsigned int)work_done, (unsigned int)work_loops);
+    printf("softirq raises %u, runs %u, batches %u\n", (unsigned int)stat.raises,
+           (unsigned int)stat.runs, (unsigned int)stat.batches);
+    return 0;
+}
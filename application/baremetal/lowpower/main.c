@@ -2,6 +2,7 @@
 #include <stdint.h>
 
 #include "nuclei_sdk_soc.h"
+#include "retention_api.h"
 
 #if defined(__ECLIC_PRESENT) && (__ECLIC_PRESENT == 1)
 #else
@@ -21,6 +22,43 @@
 #define RECORD_END()
 #endif
 
+// SysTimer ticks to sleep in retention test
+#define SLEEP_TICKS             (SOC_TIMER_FREQ / 100)
+
+static void systimer_wakeup_handler(void)
+{
+    SysTimer_SetCompareValue(UINT64_MAX);
+}
+
+/*
+ * Deep sleep with retention and wake by SysTimer interrupt at deadline, it needs mtime
+ * counting in deep sleep, on SoCs which stop it use another wakeup source such as RTC alarm
+ */
+static void retention_test(void)
+{
+    retention_stat_t stat;
+    uint64_t deadline;
+    int32_t ret;
+
+    ECLIC_Register_IRQ(SysTimer_IRQn, ECLIC_NON_VECTOR_INTERRUPT, ECLIC_LEVEL_TRIGGER, 1, 0,
+                       (void *)systimer_wakeup_handler);
+    __enable_irq();
+    deadline = SysTimer_GetLoadValue() + SLEEP_TICKS;
+    SysTimer_SetCompareValue(deadline);
+    ret = retention_suspend(RETENTION_MODE_DEEPSLEEP, deadline);
+    retention_get_stat(&stat);
+    __disable_irq();
+    if (ret < 0) {
+        printf("Retention deep sleep is not supported\n");
+        return;
+    }
+    printf("CSV, Retention Sleep Ticks, %lu\n", (unsigned long)stat.sleep_ticks);
+    printf("CSV, Retention Wake Latency Ticks, %lu\n", (unsigned long)stat.wake_latency);
+    printf("CSV, Retention Wake Latency Cycles, %lu\n",
+           (unsigned long)(stat.wake_latency * SystemCoreClock / SOC_TIMER_FREQ));
+    printf("CSV, Retention Restore Cycles, %lu\n", (unsigned long)stat.restore_cycles);
+}
+
 int main(void)
 {
     volatile uint64_t start, end;
@@ -40,5 +78,7 @@ int main(void)
     printf("CSV, WFI Start/End, %lu/%lu\n", (unsigned long)start, (unsigned long)end);
     printf("CSV, WFI Cost, %lu\n", (unsigned long)(end - start));
 
+    retention_test();
+
     return 0;
 }
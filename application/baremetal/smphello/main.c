@@ -9,50 +9,11 @@
 #error "SMP_CPU_CNT macro is not defined, please set SMP_CPU_CNT to integer value > 1"
 #endif
 
-typedef struct {
-    uint32_t state;
-} spinlock;
-
-spinlock lock;
+TicketLock_Type lock;
 volatile uint32_t lock_ready = 0;
 volatile uint32_t cpu_count = 0;
 volatile uint32_t finished = 0;
 
-// comment SPINLOCK_CAS to use AMOSWAP as spinlock
-#define SPINLOCK_CAS
-
-__STATIC_FORCEINLINE void spinlock_init(spinlock *lock)
-{
-    lock->state = 0;
-}
-
-__STATIC_FORCEINLINE void spinlock_lock(spinlock *lock)
-{
-    uint32_t old;
-    uint32_t backoff = 10;
-    do {
-#ifndef SPINLOCK_CAS
-        // Use amoswap as spinlock
-        old = __AMOSWAP_W((&(lock->state)), 1);
-#else
-        // use lr.w & sc.w to do CAS as spinlock
-        old = __CAS_W((&(lock->state)), 0, 1);
-#endif
-        if (old == 0) {
-            break;
-        }
-        for (volatile int i = 0; i < backoff; i ++) {
-            __NOP();
-        }
-        backoff += 10;
-    } while (1);
-}
-
-__STATIC_FORCEINLINE void spinlock_unlock(spinlock *lock)
-{
-    lock->state = 0;
-}
-
 int boot_hart_main(unsigned long hartid);
 int other_harts_main(unsigned long hartid);
 int main(void);
@@ -69,7 +30,7 @@ int main(void)
     // get hart id in current cluster
     unsigned long hartid = __get_hart_id();
     if (hartid == BOOT_HARTID) { // boot hart
-        spinlock_init(&lock);
+        TicketLock_Init(&lock);
         lock_ready = 1;
         finished = 0;
         __SMP_RWMB();
@@ -85,10 +46,10 @@ int main(void)
 int boot_hart_main(unsigned long hartid)
 {
     volatile unsigned long waitcnt = 0;
-    spinlock_lock(&lock);
+    TicketLock_Lock(&lock);
     printf("Hello world from hart %lu\n", hartid);
     cpu_count += 1;
-    spinlock_unlock(&lock);
+    TicketLock_Unlock(&lock);
     // wait for all harts boot and print hello
     while (cpu_count < SMP_CPU_CNT) {
         waitcnt ++;
@@ -111,10 +72,10 @@ int boot_hart_main(unsigned long hartid)
 
 int other_harts_main(unsigned long hartid)
 {
-    spinlock_lock(&lock);
+    TicketLock_Lock(&lock);
     printf("Hello world from hart %lu\n", hartid);
     cpu_count += 1;
-    spinlock_unlock(&lock);
+    TicketLock_Unlock(&lock);
     // wait for all harts boot and print hello
     while (cpu_count < SMP_CPU_CNT);
     // wait for boot hart to set finished flag
@@ -0,0 +1,265 @@
+// See LICENSE for license details.
+#include <stdio.h>
+#include "nuclei_sdk_soc.h"
+#include "nmsis_bench.h"
+#include "rtos_bench.h"
+
+#if defined(__ECLIC_PRESENT) && (__ECLIC_PRESENT == 1)
+#else
+#error "This example require CPU ECLIC feature"
+#endif
+
+// Cycle width and count of histogram buckets for one way switch latency
+#define SWITCH_HIST_WIDTH       8
+#define SWITCH_HIST_BUCKETS     128
+// Cycle width and count of histogram buckets for round-trip latency
+#define RTRIP_HIST_WIDTH        16
+#define RTRIP_HIST_BUCKETS      128
+
+BENCH_DECLARE_VAR();
+
+// uncontended kernel api cost, no task switch happens
+BENCH_SLOT_DECLARE(sem_give_take);
+BENCH_SLOT_DECLARE(queue_send_recv);
+BENCH_SLOT_DECLARE(mutex_lock_unlock);
+
+// yield to a task with same priority
+BENCH_HIST_DECLARE(yield, SWITCH_HIST_WIDTH, SWITCH_HIST_BUCKETS);
+// give semaphore to a blocked higher priority task
+BENCH_HIST_DECLARE(sem_wake, SWITCH_HIST_WIDTH, SWITCH_HIST_BUCKETS);
+BENCH_HIST_DECLARE(sem_roundtrip, RTRIP_HIST_WIDTH, RTRIP_HIST_BUCKETS);
+// send message to a blocked higher priority task
+BENCH_HIST_DECLARE(queue_wake, SWITCH_HIST_WIDTH, SWITCH_HIST_BUCKETS);
+BENCH_HIST_DECLARE(queue_roundtrip, RTRIP_HIST_WIDTH, RTRIP_HIST_BUCKETS);
+// unlock mutex which a higher priority task is waiting for
+BENCH_HIST_DECLARE(mutex_handoff, SWITCH_HIST_WIDTH, SWITCH_HIST_BUCKETS);
+BENCH_HIST_DECLARE(mutex_roundtrip, RTRIP_HIST_WIDTH, RTRIP_HIST_BUCKETS);
+// interrupt handler give semaphore to a blocked task
+BENCH_HIST_DECLARE(isr_wake, SWITCH_HIST_WIDTH, SWITCH_HIST_BUCKETS);
+BENCH_HIST_DECLARE(isr_roundtrip, RTRIP_HIST_WIDTH, RTRIP_HIST_BUCKETS);
+
+// cycle stamped right before the operation which causes a task switch
+static volatile uint64_t rb_stamp;
+static volatile uint32_t rb_yield_stop;
+
+#define RB_ELAPSED(from)        __bench_remove_overhead(__get_rv_cycle() - (from), BENCH_GET_OVHCYC())
+
+static void rb_park(void)
+{
+    // finished task wait forever
+    while (1) {
+        rb_sem_take(RB_SEM_PARK);
+    }
+}
+
+static void yield_task(void *arg)
+{
+    uint64_t cycle;
+    int warmup = 1;
+
+    while (1) {
+        cycle = __get_rv_cycle();
+        if (rb_yield_stop) {
+            rb_park();
+        }
+        // the first switch in is the warm up yield of bench_yield, not recorded
+        if (warmup) {
+            warmup = 0;
+        } else {
+            BENCH_HIST_ADD(yield, __bench_remove_overhead(cycle - rb_stamp, BENCH_GET_OVHCYC()));
+        }
+        rb_stamp = __get_rv_cycle();
+        rb_yield();
+    }
+}
+
+static void sem_task(void *arg)
+{
+    uint64_t cycle;
+
+    while (1) {
+        rb_sem_take(RB_SEM_PING);
+        cycle = __get_rv_cycle();
+        BENCH_HIST_ADD(sem_wake, __bench_remove_overhead(cycle - rb_stamp, BENCH_GET_OVHCYC()));
+    }
+}
+
+static void queue_task(void *arg)
+{
+    uint32_t msg, cycle;
+
+    while (1) {
+        msg = rb_queue_recv();
+        cycle = (uint32_t)__get_rv_cycle();
+        // message is the low 32 bits of cycle when it is sent
+        BENCH_HIST_ADD(queue_wake, __bench_remove_overhead((uint32_t)(cycle - msg), BENCH_GET_OVHCYC()));
+    }
+}
+
+static void mutex_task(void *arg)
+{
+    uint64_t cycle;
+
+    while (1) {
+        rb_sem_take(RB_SEM_MUTEX_GO);
+        rb_mutex_lock();
+        cycle = __get_rv_cycle();
+        BENCH_HIST_ADD(mutex_handoff, __bench_remove_overhead(cycle - rb_stamp, BENCH_GET_OVHCYC()));
+        rb_mutex_unlock();
+    }
+}
+
+static void isr_task(void *arg)
+{
+    uint64_t cycle;
+
+    while (1) {
+        rb_sem_take(RB_SEM_ISR);
+        cycle = __get_rv_cycle();
+        BENCH_HIST_ADD(isr_wake, __bench_remove_overhead(cycle - rb_stamp, BENCH_GET_OVHCYC()));
+    }
+}
+
+void rtos_bench_isr(void)
+{
+    rb_sem_give_isr(RB_SEM_ISR);
+}
+
+static void bench_yield(void)
+{
+#ifndef RB_NO_YIELD
+    rb_yield_stop = 0;
+    rb_task_create(RB_TASK_YIELD, yield_task, RB_PRIO_LOW);
+    // first yield only start the partner task, not recorded by either task
+    rb_stamp = __get_rv_cycle();
+    rb_yield();
+    for (int i = 0; i < RB_RUN_LOOPS; i ++) {
+        rb_stamp = __get_rv_cycle();
+        rb_yield();
+        BENCH_HIST_ADD(yield, RB_ELAPSED(rb_stamp));
+    }
+    // let partner task see the stop flag and park itself
+    rb_yield_stop = 1;
+    rb_yield();
+#else
+    printf("Yield benchmark skipped, no same priority tasks supported\n");
+#endif
+}
+
+static void bench_sem(void)
+{
+    uint64_t start;
+
+    for (int i = 0; i < RB_RUN_LOOPS; i ++) {
+        BENCH_SLOT_START(sem_give_take);
+        rb_sem_give(RB_SEM_PING);
+        rb_sem_take(RB_SEM_PING);
+        BENCH_SLOT_SAMPLE(sem_give_take);
+    }
+    // worker preempts and blocks on RB_SEM_PING immediately
+    rb_task_create(RB_TASK_SEM, sem_task, RB_PRIO_HIGH);
+    for (int i = 0; i < RB_RUN_LOOPS; i ++) {
+        start = __get_rv_cycle();
+        rb_stamp = start;
+        rb_sem_give(RB_SEM_PING);
+        BENCH_HIST_ADD(sem_roundtrip, RB_ELAPSED(start));
+    }
+}
+
+static void bench_queue(void)
+{
+    uint64_t start;
+
+    for (int i = 0; i < RB_RUN_LOOPS; i ++) {
+        BENCH_SLOT_START(queue_send_recv);
+        rb_queue_send(i);
+        (void)rb_queue_recv();
+        BENCH_SLOT_SAMPLE(queue_send_recv);
+    }
+    rb_task_create(RB_TASK_QUEUE, queue_task, RB_PRIO_HIGH);
+    for (int i = 0; i < RB_RUN_LOOPS; i ++) {
+        start = __get_rv_cycle();
+        rb_queue_send((uint32_t)start);
+        BENCH_HIST_ADD(queue_roundtrip, RB_ELAPSED(start));
+    }
+}
+
+static void bench_mutex(void)
+{
+    uint64_t start;
+
+    for (int i = 0; i < RB_RUN_LOOPS; i ++) {
+        BENCH_SLOT_START(mutex_lock_unlock);
+        rb_mutex_lock();
+        rb_mutex_unlock();
+        BENCH_SLOT_SAMPLE(mutex_lock_unlock);
+    }
+    rb_task_create(RB_TASK_MUTEX, mutex_task, RB_PRIO_HIGH);
+    for (int i = 0; i < RB_RUN_LOOPS; i ++) {
+        rb_mutex_lock();
+        // contender preempts and blocks on the mutex held by us
+        rb_sem_give(RB_SEM_MUTEX_GO);
+        start = __get_rv_cycle();
+        rb_stamp = start;
+        rb_mutex_unlock();
+        BENCH_HIST_ADD(mutex_roundtrip, RB_ELAPSED(start));
+    }
+}
+
+static void bench_isr(void)
+{
+    uint64_t start;
+    int32_t returnCode;
+
+    // edge triggered, pending bit is cleared when interrupt is taken
+    returnCode = ECLIC_Register_IRQ(RB_IRQn, ECLIC_NON_VECTOR_INTERRUPT, ECLIC_POSTIVE_EDGE_TRIGGER,
+                                    RB_IRQ_LEVEL, 0, (void *)rb_irq_handler);
+    if (returnCode != 0) {
+        printf("Unable to register benchmark interrupt %d, isr benchmark skipped\n", (int)RB_IRQn);
+        return;
+    }
+    rb_task_create(RB_TASK_ISR, isr_task, RB_PRIO_HIGH);
+    for (int i = 0; i < RB_RUN_LOOPS; i ++) {
+        start = __get_rv_cycle();
+        rb_stamp = start;
+        ECLIC_SetPendingIRQ(RB_IRQn);
+        BENCH_HIST_ADD(isr_roundtrip, RB_ELAPSED(start));
+    }
+    ECLIC_DisableIRQ(RB_IRQn);
+}
+
+void rtos_bench_run(void *arg)
+{
+    BENCH_INIT();
+
+    printf("%s context switch and IPC latency benchmark, %d loops\n", rb_rtos_name, RB_RUN_LOOPS);
+    bench_yield();
+    bench_sem();
+    bench_queue();
+    bench_mutex();
+    bench_isr();
+
+    printf("Uncontended kernel api cost in cycles\n");
+    printf("SLOT, proc, loopcnt, sumcyc, mincyc, maxcyc, avgcyc\n");
+    BENCH_SLOT_DUMP();
+
+    printf("Task switch latency in cycles\n");
+    printf("HIST, proc, cnt, mincyc, avgcyc, p50, p90, p99, maxcyc, overflow\n");
+#ifndef RB_NO_YIELD
+    BENCH_HIST_STAT(yield);
+#endif
+    BENCH_HIST_STAT(sem_wake);
+    BENCH_HIST_STAT(sem_roundtrip);
+    BENCH_HIST_STAT(queue_wake);
+    BENCH_HIST_STAT(queue_roundtrip);
+    BENCH_HIST_STAT(mutex_handoff);
+    BENCH_HIST_STAT(mutex_roundtrip);
+    BENCH_HIST_STAT(isr_wake);
+    BENCH_HIST_STAT(isr_roundtrip);
+    printf("RTOS benchmark finished\n");
+#ifdef CFG_SIMULATION
+    // directly exit if in nuclei internally simulation
+    SIMULATION_EXIT(0);
+#endif
+    rb_park();
+}
@@ -0,0 +1,115 @@
+// See LICENSE for license details.
+#ifndef __RTOS_BENCH_H__
+#define __RTOS_BENCH_H__
+/*!
+ * \file     rtos_bench.h
+ * \brief    RTOS context switch and IPC latency benchmark shared by all RTOS ports
+ * \details
+ * The benchmark cases in rtos_bench.c only use the small kernel abstraction
+ * declared in this file, each application/<rtos>/benchmark implements it with
+ * the native kernel API, so the same cases are measured on every kernel.
+ *
+ * All the kernel objects are created by the port before rtos_bench_run is called,
+ * and they are addressed by the fixed ids below.
+ */
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef CFG_SIMULATION
+#define RB_RUN_LOOPS            20
+#else
+#define RB_RUN_LOOPS            1000
+#endif
+
+/** Spare external interrupt used to measure ISR to task wake up latency */
+#ifndef RB_IRQn
+#define RB_IRQn                 (SOC_INT_MAX - 1)
+#endif
+/** Interrupt level of RB_IRQn, must be a level allowed to call kernel API from ISR */
+#ifndef RB_IRQ_LEVEL
+#define RB_IRQ_LEVEL            1
+#endif
+
+/** Stack size in bytes of each benchmark task */
+#ifndef RB_STACK_SIZE
+#define RB_STACK_SIZE           2048
+#endif
+
+/** Benchmark task ids */
+typedef enum {
+    RB_TASK_MAIN = 0,           /*!< controller task running all benchmark cases */
+    RB_TASK_YIELD,              /*!< yield partner, same priority as RB_TASK_MAIN */
+    RB_TASK_SEM,                /*!< semaphore ping-pong worker */
+    RB_TASK_QUEUE,              /*!< queue receiver */
+    RB_TASK_MUTEX,              /*!< mutex contender */
+    RB_TASK_ISR,                /*!< task woken up by interrupt */
+    RB_TASK_NUM
+} RB_TASK_ID;
+
+/** Benchmark semaphore ids, all created with initial count 0 */
+typedef enum {
+    RB_SEM_PING = 0,            /*!< semaphore ping-pong */
+    RB_SEM_MUTEX_GO,            /*!< start mutex contender */
+    RB_SEM_ISR,                 /*!< given by interrupt handler */
+    RB_SEM_PARK,                /*!< never given, used to park finished tasks */
+    RB_SEM_NUM
+} RB_SEM_ID;
+
+/** Benchmark task priority level, mapped to native priority by port */
+typedef enum {
+    RB_PRIO_LOW = 0,            /*!< priority of controller and yield partner */
+    RB_PRIO_HIGH,               /*!< priority of workers, preempts controller */
+} RB_PRIO_LEVEL;
+
+/** Number of uint32_t entries of the benchmark queue */
+#define RB_QUEUE_LEN            1
+
+typedef void (*rb_task_func_t)(void *arg);
+
+/* Kernel abstraction implemented by each RTOS port */
+/** Name of the RTOS printed in benchmark report */
+extern const char *rb_rtos_name;
+/**
+ * \brief Create and start benchmark task \a id with priority level \a prio
+ * \details
+ * Port must support two tasks with same priority for RB_PRIO_LOW,
+ * if not, define RB_NO_YIELD in application Makefile and the yield case is skipped.
+ */
+extern void rb_task_create(uint32_t id, rb_task_func_t func, uint32_t prio);
+/** Yield cpu to the other ready task with same priority */
+extern void rb_yield(void);
+/** Take semaphore \a id, wait forever */
+extern void rb_sem_take(uint32_t id);
+/** Give semaphore \a id from task */
+extern void rb_sem_give(uint32_t id);
+/** Give semaphore \a id from RB_IRQn handler */
+extern void rb_sem_give_isr(uint32_t id);
+/** Send \a msg to benchmark queue, wait forever if full */
+extern void rb_queue_send(uint32_t msg);
+/** Receive a message from benchmark queue, wait forever if empty */
+extern uint32_t rb_queue_recv(void);
+/** Lock benchmark mutex, wait forever */
+extern void rb_mutex_lock(void);
+/** Unlock benchmark mutex */
+extern void rb_mutex_unlock(void);
+/**
+ * \brief Interrupt handler of RB_IRQn provided by port
+ * \details
+ * It must do the kernel interrupt enter/exit required by the RTOS
+ * and call rtos_bench_isr in between
+ */
+extern void rb_irq_handler(void);
+
+/* Provided by rtos_bench.c */
+/** Body of RB_IRQn handler, called by rb_irq_handler */
+extern void rtos_bench_isr(void);
+/** Entry of RB_TASK_MAIN, run all benchmark cases and print report */
+extern void rtos_bench_run(void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __RTOS_BENCH_H__ */
@@ -0,0 +1,113 @@
+// See LICENSE for license details.
+/* Kernel includes. */
+#include "FreeRTOS.h" /* Must come first. */
+#include "queue.h"    /* RTOS queue related API prototypes. */
+#include "semphr.h"   /* Semaphore related API prototypes. */
+#include "task.h"     /* RTOS task related API prototypes. */
+
+#include <stdio.h>
+
+#include "nuclei_sdk_soc.h"
+#include "rtos_bench.h"
+
+#define RB_PRIO_NATIVE(prio)    ((prio) == RB_PRIO_HIGH ? (tskIDLE_PRIORITY + 2) : (tskIDLE_PRIORITY + 1))
+
+const char *rb_rtos_name = "FreeRTOS";
+
+static TaskHandle_t rb_tasks[RB_TASK_NUM];
+static SemaphoreHandle_t rb_sems[RB_SEM_NUM];
+static SemaphoreHandle_t rb_mutex;
+static QueueHandle_t rb_queue;
+
+static const char *rb_task_names[RB_TASK_NUM] = {"main", "yield", "sem", "queue", "mutex", "isr"};
+
+void rb_task_create(uint32_t id, rb_task_func_t func, uint32_t prio)
+{
+    if (xTaskCreate(func, rb_task_names[id], RB_STACK_SIZE / sizeof(StackType_t), NULL,
+                    RB_PRIO_NATIVE(prio), &rb_tasks[id]) != pdPASS) {
+        printf("Unable to create task %s\n", rb_task_names[id]);
+        while (1);
+    }
+}
+
+void rb_yield(void)
+{
+    taskYIELD();
+}
+
+void rb_sem_take(uint32_t id)
+{
+    xSemaphoreTake(rb_sems[id], portMAX_DELAY);
+}
+
+void rb_sem_give(uint32_t id)
+{
+    xSemaphoreGive(rb_sems[id]);
+}
+
+void rb_sem_give_isr(uint32_t id)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    xSemaphoreGiveFromISR(rb_sems[id], &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+void rb_queue_send(uint32_t msg)
+{
+    xQueueSend(rb_queue, &msg, portMAX_DELAY);
+}
+
+uint32_t rb_queue_recv(void)
+{
+    uint32_t msg = 0;
+
+    xQueueReceive(rb_queue, &msg, portMAX_DELAY);
+    return msg;
+}
+
+void rb_mutex_lock(void)
+{
+    xSemaphoreTake(rb_mutex, portMAX_DELAY);
+}
+
+void rb_mutex_unlock(void)
+{
+    xSemaphoreGive(rb_mutex);
+}
+
+// non-vector interrupt, kernel api can be called directly
+void rb_irq_handler(void)
+{
+    rtos_bench_isr();
+}
+
+int main(void)
+{
+    for (int i = 0; i < RB_SEM_NUM; i ++) {
+        rb_sems[i] = xSemaphoreCreateBinary();
+    }
+    rb_mutex = xSemaphoreCreateMutex();
+    rb_queue = xQueueCreate(RB_QUEUE_LEN, sizeof(uint32_t));
+    if ((rb_mutex == NULL) || (rb_queue == NULL)) {
+        printf("Unable to create benchmark kernel objects\n");
+        return -1;
+    }
+    rb_task_create(RB_TASK_MAIN, rtos_bench_run, RB_PRIO_LOW);
+
+    vTaskStartScheduler();
+    printf("OS should never run to here\r\n");
+    while (1);
+}
+
+void vApplicationMallocFailedHook(void)
+{
+    printf("malloc failed\n");
+    while (1);
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char* pcTaskName)
+{
+    printf("Stack Overflow\n");
+    while (1);
+}
@@ -97,7 +97,8 @@
  * normally using a count leading zeros assembly instruction.  Set to 0 to select
  * the next task to run using a generic C algorithm that works for all FreeRTOS
  * ports.  Not all FreeRTOS ports have this option.  Defaults to 0 if left
- * undefined. */
+ * undefined.  It is not supported by SMP FreeRTOS, so it must be 0 when
+ * configNUMBER_OF_CORES is greater than one. */
 #define configUSE_PORT_OPTIMISED_TASK_SELECTION    0
 
 /* Set configUSE_TICKLESS_IDLE to 1 to use the low power tickless mode.  Set to
@@ -333,7 +334,7 @@
  * functionality in the build.  Set to 0 to exclude the hook functionality from the
  * build.  The application writer is responsible for providing the hook function
  * for any set to 1.  See https://www.freertos.org/a00016.html. */
-#define configUSE_IDLE_HOOK                   0
+#define configUSE_IDLE_HOOK                   1
 #define configUSE_TICK_HOOK                   0
 #define configUSE_MALLOC_FAILED_HOOK          0
 #define configUSE_DAEMON_TASK_STARTUP_HOOK    0
@@ -539,7 +540,18 @@
  * configUSE_PASSIVE_IDLE_HOOK to 1 to allow the application writer to use
  * the passive idle task hook to add background functionality without the overhead
  * of a separate task. Defaults to 0 if left undefined. */
-#define configUSE_PASSIVE_IDLE_HOOK               0
+#define configUSE_PASSIVE_IDLE_HOOK               1
+
+/* Nuclei port specific, idle cores call vPortIdleSleep() in idle hooks to
+ * sleep in WFI until woken up by interrupt or yield request from other cores.
+ * Set configPORT_IDLE_TICK_FILTER to 1 to also keep idle cores sleeping when
+ * the tick of boot core only requests time slicing between idle tasks, it is
+ * useful when configUSE_TIME_SLICING is 1. Set configPORT_STAGGER_TICK to 1 to
+ * defer the time slicing of each secondary core to its own slot of the tick
+ * period, so the cores don't contend the kernel locks at once after a tick. */
+#define configPORT_IDLE_SLEEP                     1
+#define configPORT_IDLE_TICK_FILTER               0
+#define configPORT_STAGGER_TICK                   0
 
 /* When using SMP (i.e. configNUMBER_OF_CORES is greater than one),
  * configTIMER_SERVICE_TASK_CORE_AFFINITY allows the application writer to set
@@ -111,6 +111,47 @@ void prvSetupHardware(void)
 
 void start_task(void* pvParameters);
 
+#if configNUMBER_OF_CORES > 1
+/* Iterations of critical section used to measure lock acquire time, set to 0 to disable benchmark */
+#ifndef LOCK_BENCH_LOOPS
+#define LOCK_BENCH_LOOPS                1000
+#endif
+
+static volatile uint32_t lock_bench_ready = 0;
+
+/* Measure average and max cycles of taskENTER_CRITICAL while all the cores contend for the kernel locks */
+static void lock_bench(unsigned long taskid)
+{
+    uint64_t start, cycles, total = 0, max = 0;
+
+    if (LOCK_BENCH_LOOPS == 0) {
+        return;
+    }
+    ENTER_CRITICAL();
+    lock_bench_ready += 1;
+    EXIT_CRITICAL();
+    // start together so the locks are really contended
+    while (lock_bench_ready < configNUMBER_OF_CORES) {
+        vTaskDelay(1);
+    }
+
+    for (int i = 0; i < LOCK_BENCH_LOOPS; i++) {
+        start = __get_rv_cycle();
+        ENTER_CRITICAL();
+        cycles = __get_rv_cycle() - start;
+        EXIT_CRITICAL();
+        total += cycles;
+        if (cycles > max) {
+            max = cycles;
+        }
+    }
+    ENTER_CRITICAL();
+    printf("LOCKBENCH, cores %d, task %lu, hart %lu, avg %lu, max %lu cycles\r\n", configNUMBER_OF_CORES, \
+        taskid, __get_hart_id(), (unsigned long)(total / LOCK_BENCH_LOOPS), (unsigned long)max);
+    EXIT_CRITICAL();
+}
+#endif
+
 long main(void)
 {
     TimerHandle_t xExampleSoftwareTimer = NULL;
@@ -178,6 +219,9 @@ void start_task(void* pvParameters)
     ENTER_CRITICAL();
     printf("Enter to task %u\r\n", (unsigned long)(pvParameters) >> 16);
     EXIT_CRITICAL();
+#if configNUMBER_OF_CORES > 1
+    lock_bench((unsigned long)(pvParameters) >> 16);
+#endif
 
     while (1) {
         ENTER_CRITICAL();
@@ -266,4 +310,12 @@ void vApplicationIdleHook(void)
     if there is a lot of heap remaining unallocated then
     the value of configTOTAL_HEAP_SIZE in FreeRTOSConfig.h can be
     reduced accordingly. */
+    vPortIdleSleep();
+}
+
+void vApplicationPassiveIdleHook(void)
+{
+    /* Passive idle tasks run on the other idle cores, sleep in WFI until a
+    task is ready for this core and portYIELD_CORE wakes it up */
+    vPortIdleSleep();
 }
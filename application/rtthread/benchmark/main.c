@@ -0,0 +1,90 @@
+// See LICENSE for license details.
+#include <stdio.h>
+#include "nuclei_sdk_soc.h"
+#include <rtthread.h>
+#include "rtos_bench.h"
+
+// smaller value means higher priority in RT-Thread, both lower than main thread
+#define RB_PRIO_NATIVE(prio)    ((prio) == RB_PRIO_HIGH ? (RT_THREAD_PRIORITY_MAX - 4) : (RT_THREAD_PRIORITY_MAX - 3))
+#define RB_THREAD_TIMESLICE     5
+
+const char *rb_rtos_name = "RT-Thread";
+
+/* Align stack when using static thread */
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t rb_stacks[RB_TASK_NUM][RB_STACK_SIZE];
+static struct rt_thread rb_tasks[RB_TASK_NUM];
+static struct rt_semaphore rb_sems[RB_SEM_NUM];
+static struct rt_mutex rb_mutex;
+static struct rt_messagequeue rb_queue;
+static rt_uint8_t rb_queue_pool[RB_QUEUE_LEN * (RT_ALIGN(sizeof(uint32_t), RT_ALIGN_SIZE) + sizeof(void *))];
+
+static const char *rb_task_names[RB_TASK_NUM] = {"main", "yield", "sem", "queue", "mutex", "isr"};
+
+void rb_task_create(uint32_t id, rb_task_func_t func, uint32_t prio)
+{
+    rt_thread_init(&rb_tasks[id], rb_task_names[id], func, RT_NULL, rb_stacks[id],
+                   RB_STACK_SIZE, RB_PRIO_NATIVE(prio), RB_THREAD_TIMESLICE);
+    rt_thread_startup(&rb_tasks[id]);
+}
+
+void rb_yield(void)
+{
+    rt_thread_yield();
+}
+
+void rb_sem_take(uint32_t id)
+{
+    rt_sem_take(&rb_sems[id], RT_WAITING_FOREVER);
+}
+
+void rb_sem_give(uint32_t id)
+{
+    rt_sem_release(&rb_sems[id]);
+}
+
+void rb_sem_give_isr(uint32_t id)
+{
+    rt_sem_release(&rb_sems[id]);
+}
+
+void rb_queue_send(uint32_t msg)
+{
+    rt_mq_send_wait(&rb_queue, &msg, sizeof(msg), RT_WAITING_FOREVER);
+}
+
+uint32_t rb_queue_recv(void)
+{
+    uint32_t msg = 0;
+
+    rt_mq_recv(&rb_queue, &msg, sizeof(msg), RT_WAITING_FOREVER);
+    return msg;
+}
+
+void rb_mutex_lock(void)
+{
+    rt_mutex_take(&rb_mutex, RT_WAITING_FOREVER);
+}
+
+void rb_mutex_unlock(void)
+{
+    rt_mutex_release(&rb_mutex);
+}
+
+void rb_irq_handler(void)
+{
+    rt_interrupt_enter();
+    rtos_bench_isr();
+    rt_interrupt_leave();
+}
+
+int main(void)
+{
+    for (int i = 0; i < RB_SEM_NUM; i ++) {
+        rt_sem_init(&rb_sems[i], "rbsem", 0, RT_IPC_FLAG_PRIO);
+    }
+    rt_mutex_init(&rb_mutex, "rbmtx", RT_IPC_FLAG_PRIO);
+    rt_mq_init(&rb_queue, "rbmq", rb_queue_pool, sizeof(uint32_t), sizeof(rb_queue_pool), RT_IPC_FLAG_PRIO);
+    rb_task_create(RB_TASK_MAIN, rtos_bench_run, RB_PRIO_LOW);
+    return 0;
+}
@@ -19,6 +19,10 @@
 // <o>Maximal level of thread priority <8-256>
 //  <i>Default: 32
 #define RT_THREAD_PRIORITY_MAX  8
+// <c1>Using CPU ffs of port
+//  <i>Find ready priority by ctz of NMSIS instead of a 256 bytes table
+#define RT_USING_CPU_FFS
+// </c>
 // <o>OS tick per second
 //  <i>Default: 1000   (1ms)
 #define RT_TICK_PER_SECOND  100
@@ -28,6 +32,13 @@
 // <o>the max length of object name<2-16>
 //  <i>Default: 8
 #define RT_NAME_MAX    8
+// <c1>Using object name hash
+//  <i>Find kernel objects by name in a per class hash table instead of walking the object list
+//#define RT_USING_OBJECT_HASH
+// </c>
+// <o>the bucket count of object name hash table
+//  <i>Default: 16
+//#define RT_OBJECT_HASH_BUCKETS    16
 // <c1>Using RT-Thread components initialization
 //  <i>Using RT-Thread components initialization
 #define RT_USING_COMPONENTS_INIT
@@ -59,6 +70,14 @@
 //  <i> Diable Thread stack over flow detect
 //#define RT_USING_OVERFLOW_CHECK
 // </c>
+// <c1>thread cpu cycles accounting
+//  <i> Accumulate cpu cycles of each thread using mcycle when thread switched
+//#define RT_USING_THREAD_CYCLES
+// </c>
+// <c1>thread hpm counters accounting
+//  <i> Accumulate instret and two hpm events of each thread when thread switched, shown by perf stat, requires RT_USING_THREAD_CYCLES
+//#define RT_USING_THREAD_PERF
+// </c>
 // </h>
 
 // <h>Hook Configuration
@@ -95,6 +114,10 @@
 //  <i>Using Mutex
 //#define RT_USING_MUTEX
 // </c>
+// <c1>Using IPC fast path
+//  <i>Take uncontended semaphore and mutex by compare and swap without disabling interrupt, requires A extension
+//#define RT_USING_IPC_FASTPATH
+// </c>
 // <c1>Using Event
 //  <i>Using Event
 //#define RT_USING_EVENT
@@ -118,6 +141,10 @@
 //  <i>using small memory
 #define RT_USING_SMALL_MEM
 // </c>
+// <c1>using per-cpu magazines in front of slab zones
+//  <i>Small rt_malloc/rt_free of RT_USING_SLAB hit a per-cpu cache without heap lock, see slab.c
+//#define RT_USING_SLAB_MAGAZINE
+// </c>
 // <c1>using tiny size of memory
 //  <i>using tiny size of memory
 //#define RT_USING_TINY_SIZE
@@ -21,6 +21,10 @@
 // <o>Maximal level of thread priority <8-256>
 //  <i>Default: 32
 #define RT_THREAD_PRIORITY_MAX  8
+// <c1>Using CPU ffs of port
+//  <i>Find ready priority by ctz of NMSIS instead of a 256 bytes table
+#define RT_USING_CPU_FFS
+// </c>
 // <o>OS tick per second
 //  <i>Default: 1000   (1ms)
 #define RT_TICK_PER_SECOND  100
@@ -30,6 +34,13 @@
 // <o>the max length of object name<2-16>
 //  <i>Default: 8
 #define RT_NAME_MAX    8
+// <c1>Using object name hash
+//  <i>Find kernel objects by name in a per class hash table instead of walking the object list
+//#define RT_USING_OBJECT_HASH
+// </c>
+// <o>the bucket count of object name hash table
+//  <i>Default: 16
+//#define RT_OBJECT_HASH_BUCKETS    16
 // <c1>Using RT-Thread components initialization
 //  <i>Using RT-Thread components initialization
 #define RT_USING_COMPONENTS_INIT
@@ -61,6 +72,14 @@
 //  <i> Diable Thread stack over flow detect
 //#define RT_USING_OVERFLOW_CHECK
 // </c>
+// <c1>thread cpu cycles accounting
+//  <i> Accumulate cpu cycles of each thread using mcycle when thread switched
+//#define RT_USING_THREAD_CYCLES
+// </c>
+// <c1>thread hpm counters accounting
+//  <i> Accumulate instret and two hpm events of each thread when thread switched, shown by perf stat, requires RT_USING_THREAD_CYCLES
+//#define RT_USING_THREAD_PERF
+// </c>
 // </h>
 
 // <h>Hook Configuration
@@ -97,6 +116,10 @@
 //  <i>Using Mutex
 //#define RT_USING_MUTEX
 // </c>
+// <c1>Using IPC fast path
+//  <i>Take uncontended semaphore and mutex by compare and swap without disabling interrupt, requires A extension
+//#define RT_USING_IPC_FASTPATH
+// </c>
 // <c1>Using Event
 //  <i>Using Event
 //#define RT_USING_EVENT
@@ -115,19 +138,37 @@
 // <c1>Dynamic Heap Management
 //  <i>Dynamic Heap Management
 //#define RT_USING_HEAP
-// Heap Size used by RT-Thread
+// Heap Size used by RT-Thread in words
+//  <i>Remove it to use heap section of linker script sized by HEAPSZ as system heap
 #define RT_HEAP_SIZE        2048
 // </c>
+// <c1>Using memory heap regions
+//  <i>Extra heaps in linker sections listed by RT_MEMHEAP_REGIONS, see cpuport.c
+//#define RT_USING_MEMHEAP
+//#define RT_MEMHEAP_REGIONS  RT_MEMHEAP_REGION(dlm, __dlm_heap_start, __dlm_heap_end, RT_HEAP_HINT_FAST)
+// </c>
 // <c1>using small memory
 //  <i>using small memory
 #define RT_USING_SMALL_MEM
 // </c>
+// <c1>using per-cpu magazines in front of slab zones
+//  <i>Small rt_malloc/rt_free of RT_USING_SLAB hit a per-cpu cache without heap lock, see slab.c
+//#define RT_USING_SLAB_MAGAZINE
+// </c>
 // <c1>using tiny size of memory
 //  <i>using tiny size of memory
 //#define RT_USING_TINY_SIZE
 // </c>
 // </h>
 
+// <h>Power Management Configuration
+// <c1>Using tickless idle
+//  <i>Suppress tick interrupt in idle thread until next timer timeout, see rt_system_power_manager in cpuport.c
+//#define RT_USING_PM
+//#define RT_PM_WFI_SLEEPMODE WFI_SHALLOW_SLEEP
+// </c>
+// </h>
+
 // <h>Console Configuration
 // <c1>Using console
 //  <i>Using console
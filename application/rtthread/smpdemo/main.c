@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ * Copyright (c) 2019-Present Nuclei Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "nuclei_sdk_soc.h"
+#include <rtthread.h>
+
+#ifndef RT_USING_SMP
+#error "This demo requires SMP, please build with SMP=2 or more"
+#endif
+
+#define THREAD_PRIORITY 2
+#define THREAD_STACK_SIZE 1024
+#define THREAD_TIMESLICE 5
+#define THREAD_NUM      4
+
+/* Align stack when using static thread */
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t thread_stack[THREAD_NUM][THREAD_STACK_SIZE];
+static struct rt_thread tid[THREAD_NUM];
+
+/* Thread entry function */
+static void thread_entry(void* parameter)
+{
+    rt_uint32_t count = 0;
+
+    while (1) {
+        rt_kprintf("thread %d count: %d on hart %d\n", (rt_uint32_t)(rt_ubase_t)parameter, count++, (int)__get_hart_id());
+        rt_thread_mdelay(250);
+    }
+}
+
+/* Thread demo, thread 0 is bound to the last cpu, others run on any cpu */
+int create_thread_demo(void)
+{
+    unsigned long i;
+    for (i = 0; i < THREAD_NUM; i ++) {
+        /* Create static threads */
+        rt_thread_init(&tid[i], "thread", thread_entry, (void*)i, thread_stack[i],
+                       THREAD_STACK_SIZE, THREAD_PRIORITY, THREAD_TIMESLICE);
+    }
+    rt_thread_control(&tid[0], RT_THREAD_CTRL_BIND_CPU, (void*)(RT_CPUS_NR - 1));
+
+    /* Startup threads  */
+    for (i = 0; i < THREAD_NUM; i ++) {
+        rt_thread_startup(&tid[i]);
+    }
+
+    return 0;
+}
+
+int main(void)
+{
+    rt_uint32_t count = 0;
+
+    rt_kprintf("RT-Thread SMP demo on %d harts\n", RT_CPUS_NR);
+    create_thread_demo();
+
+    while (1) {
+        rt_kprintf("Main thread count: %d on hart %d\n", count++, (int)__get_hart_id());
+        rt_thread_mdelay(500);
+#ifdef CFG_SIMULATION
+        if (count > 2) {
+            // directly exit if in nuclei internally simulation
+            SIMULATION_EXIT(0);
+        }
+#endif
+    }
+}
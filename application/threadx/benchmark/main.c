@@ -0,0 +1,106 @@
+// See LICENSE for license details.
+#include "tx_api.h"
+#include <stdio.h>
+#include "nuclei_sdk_soc.h"
+#include "rtos_bench.h"
+
+// smaller value means higher priority in ThreadX
+#define RB_PRIO_NATIVE(prio)    ((prio) == RB_PRIO_HIGH ? 2 : 3)
+
+const char *rb_rtos_name = "ThreadX";
+
+static TX_THREAD rb_tasks[RB_TASK_NUM];
+static UCHAR rb_stacks[RB_TASK_NUM][RB_STACK_SIZE];
+static rb_task_func_t rb_task_funcs[RB_TASK_NUM];
+static TX_SEMAPHORE rb_sems[RB_SEM_NUM];
+static TX_MUTEX rb_mutex;
+static TX_QUEUE rb_queue;
+static ULONG rb_queue_area[RB_QUEUE_LEN];
+
+static CHAR *rb_task_names[RB_TASK_NUM] = {"main", "yield", "sem", "queue", "mutex", "isr"};
+
+// ThreadX thread entry take an ULONG input, which is the benchmark task id
+static void rb_task_entry(ULONG id)
+{
+    rb_task_funcs[id](NULL);
+}
+
+void rb_task_create(uint32_t id, rb_task_func_t func, uint32_t prio)
+{
+    UINT native = RB_PRIO_NATIVE(prio);
+
+    rb_task_funcs[id] = func;
+    if (tx_thread_create(&rb_tasks[id], rb_task_names[id], rb_task_entry, id, rb_stacks[id],
+                         RB_STACK_SIZE, native, native, TX_NO_TIME_SLICE, TX_AUTO_START) != TX_SUCCESS) {
+        printf("Unable to create task %s\n", rb_task_names[id]);
+        while (1);
+    }
+}
+
+void rb_yield(void)
+{
+    tx_thread_relinquish();
+}
+
+void rb_sem_take(uint32_t id)
+{
+    tx_semaphore_get(&rb_sems[id], TX_WAIT_FOREVER);
+}
+
+void rb_sem_give(uint32_t id)
+{
+    tx_semaphore_put(&rb_sems[id]);
+}
+
+// context switch requested in interrupt is pended to SysTimerSW_IRQn by port
+void rb_sem_give_isr(uint32_t id)
+{
+    tx_semaphore_put(&rb_sems[id]);
+}
+
+void rb_queue_send(uint32_t msg)
+{
+    ULONG data = msg;
+
+    tx_queue_send(&rb_queue, &data, TX_WAIT_FOREVER);
+}
+
+uint32_t rb_queue_recv(void)
+{
+    ULONG data = 0;
+
+    tx_queue_receive(&rb_queue, &data, TX_WAIT_FOREVER);
+    return (uint32_t)data;
+}
+
+void rb_mutex_lock(void)
+{
+    tx_mutex_get(&rb_mutex, TX_WAIT_FOREVER);
+}
+
+void rb_mutex_unlock(void)
+{
+    tx_mutex_put(&rb_mutex);
+}
+
+void rb_irq_handler(void)
+{
+    rtos_bench_isr();
+}
+
+int main(void)
+{
+    /* Enter the ThreadX kernel.  */
+    tx_kernel_enter();
+    return 0;
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+    for (int i = 0; i < RB_SEM_NUM; i ++) {
+        tx_semaphore_create(&rb_sems[i], "rbsem", 0);
+    }
+    tx_mutex_create(&rb_mutex, "rbmtx", TX_INHERIT);
+    tx_queue_create(&rb_queue, "rbqueue", TX_1_ULONG, rb_queue_area, sizeof(rb_queue_area));
+    rb_task_create(RB_TASK_MAIN, rtos_bench_run, RB_PRIO_LOW);
+}
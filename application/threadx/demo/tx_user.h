@@ -321,5 +321,30 @@
 #define TX_BYTE_POOL_DELAY_VALUE              3
 */
 
+/* Determine if the byte pool quick lists of Nuclei port are enabled. When the following is defined,
+   released small blocks are kept on size class lists of their pool and allocated again without the
+   first-fit search, see tx_byte_pool_quick.c, and PortGetBytePoolStats reports their usage.  */
+
+/*
+#define TX_BYTE_POOL_QUICK_LISTS
+*/
+
+/* Determine if tickless idle is required by the application. When the following is defined,
+   the Nuclei port suppresses the tick interrupt until the next timer or time-slice expiration
+   when no thread is ready, see tx_low_power_enter in port.c.  */
+
+/*
+#define TX_LOW_POWER
+*/
+
+/* Determine if the execution profile kit of Nuclei port is enabled, thread, interrupt and idle
+   time are accumulated in mcycle units, use PortGetExecutionProfile to read the totals, and put
+   TX_EXECUTION_ISR_ENTER/TX_EXECUTION_ISR_EXIT in interrupt handlers to exclude their time from
+   the interrupted thread, SysTick_Handler of the port already does it.  */
+
+/*
+#define TX_EXECUTION_PROFILE_ENABLE
+*/
+
 #endif
 
@@ -0,0 +1,108 @@
+// See LICENSE for license details.
+#include <stdint.h>
+#include <stdio.h>
+#include <ucos_ii.h>
+
+#include "nuclei_sdk_soc.h"
+#include "rtos_bench.h"
+
+// uC/OS-II requires unique priority for each task, smaller value means higher priority
+#define RB_PRIO_LOW_BASE        20
+#define RB_PRIO_HIGH_BASE       10
+// priority inheritance priority of mutex, higher than all the benchmark tasks
+#define RB_MUTEX_PIP            5
+
+#define RB_STK_LEN              (RB_STACK_SIZE / sizeof(OS_STK))
+
+const char *rb_rtos_name = "uC/OS-II";
+
+static OS_STK rb_stacks[RB_TASK_NUM][RB_STK_LEN];
+static OS_EVENT *rb_sems[RB_SEM_NUM];
+static OS_EVENT *rb_mutex;
+static OS_EVENT *rb_queue;
+static void *rb_queue_msgs[RB_QUEUE_LEN];
+
+void rb_task_create(uint32_t id, rb_task_func_t func, uint32_t prio)
+{
+    INT8U native = ((prio == RB_PRIO_HIGH) ? RB_PRIO_HIGH_BASE : RB_PRIO_LOW_BASE) + id;
+
+    if (OSTaskCreate(func, NULL, &rb_stacks[id][RB_STK_LEN - 1], native) != OS_ERR_NONE) {
+        printf("Unable to create task %d\n", (int)id);
+        while (1);
+    }
+}
+
+void rb_sem_take(uint32_t id)
+{
+    INT8U err;
+
+    OSSemPend(rb_sems[id], 0, &err);
+}
+
+void rb_sem_give(uint32_t id)
+{
+    OSSemPost(rb_sems[id]);
+}
+
+void rb_sem_give_isr(uint32_t id)
+{
+    OSSemPost(rb_sems[id]);
+}
+
+void rb_queue_send(uint32_t msg)
+{
+    OSQPost(rb_queue, (void *)(uintptr_t)msg);
+}
+
+uint32_t rb_queue_recv(void)
+{
+    INT8U err;
+
+    return (uint32_t)(uintptr_t)OSQPend(rb_queue, 0, &err);
+}
+
+void rb_mutex_lock(void)
+{
+    INT8U err;
+
+    OSMutexPend(rb_mutex, 0, &err);
+}
+
+void rb_mutex_unlock(void)
+{
+    OSMutexPost(rb_mutex);
+}
+
+void rb_irq_handler(void)
+{
+#if OS_CRITICAL_METHOD == 3u                   /* Allocate storage for CPU status register             */
+    OS_CPU_SR cpu_sr;
+#endif
+    OS_ENTER_CRITICAL();
+    OSIntEnter();                              /* Tell uC/OS-II that we are starting an ISR            */
+    OS_EXIT_CRITICAL();
+
+    rtos_bench_isr();
+
+    OSIntExit();                               /* Tell uC/OS-II that we are leaving the ISR            */
+}
+
+int main(void)
+{
+    INT8U err;
+
+    OSInit();
+    for (int i = 0; i < RB_SEM_NUM; i ++) {
+        rb_sems[i] = OSSemCreate(0);
+    }
+    rb_mutex = OSMutexCreate(RB_MUTEX_PIP, &err);
+    rb_queue = OSQCreate(rb_queue_msgs, RB_QUEUE_LEN);
+    if ((rb_mutex == NULL) || (rb_queue == NULL)) {
+        printf("Unable to create benchmark kernel objects\n");
+        return -1;
+    }
+    rb_task_create(RB_TASK_MAIN, rtos_bench_run, RB_PRIO_LOW);
+    OSStart();
+    while (1) {
+    }
+}
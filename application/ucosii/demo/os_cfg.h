@@ -33,6 +33,8 @@
 #define OS_APP_HOOKS_EN           1u   /* Application-defined hooks are called from the uC/OS-II hooks */
 #define OS_ARG_CHK_EN             1u   /* Enable (1) or Disable (0) argument checking                  */
 #define OS_CPU_HOOKS_EN           1u   /* uC/OS-II hooks are found in the processor port files         */
+#define OS_CPU_MTH_CRITICAL_EN    0u   /* Mask by ECLIC MTH(1) or mstatus.MIE(0) in critical sections  */
+#define OS_CPU_TICKLESS_EN        0u   /* Suppress tick interrupts in idle task for low power          */
 
 #define OS_DEBUG_EN               1u   /* Enable(1) debug variables                                    */
 
@@ -84,6 +86,7 @@
 #define OS_FLAG_NAME_EN           1u   /*     Enable names for event flag group                        */
 #define OS_FLAG_QUERY_EN          1u   /*     Include code for OSFlagQuery()                           */
 #define OS_FLAG_WAIT_CLR_EN       1u   /* Include code for Wait on Clear EVENT FLAGS                   */
+#define OS_FLAG_INDEX_EN          0u   /* Group waiters of the same flags to shorten OSFlagPost()      */
 #define OS_FLAGS_NBITS           16u   /* Size in #bits of OS_FLAGS data type (8, 16 or 32)            */
 
 
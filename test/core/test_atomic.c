@@ -196,4 +196,125 @@ CTEST(atomic, amomin_d)
 }
 #endif
 
+CTEST(atomic, ticketlock)
+{
+    static TicketLock_Type lock = TICKETLOCK_INIT;
+
+    ASSERT_EQUAL(TicketLock_TryLock(&lock), 1);
+    ASSERT_EQUAL(TicketLock_TryLock(&lock), 0);
+    TicketLock_Unlock(&lock);
+    TicketLock_Lock(&lock);
+    ASSERT_EQUAL(lock.next, 2);
+    TicketLock_Unlock(&lock);
+    ASSERT_EQUAL(lock.owner, 2);
+    ASSERT_EQUAL((unsigned long)(&lock) % __SMP_CACHELINE_SIZE, 0);
+}
+
+CTEST(atomic, mcslock)
+{
+    static MCSLock_Type lock = MCSLOCK_INIT;
+    static MCSNode_Type node1, node2;
+
+    MCSLock_Lock(&lock, &node1);
+    ASSERT_EQUAL(MCSLock_TryLock(&lock, &node2), 0);
+    MCSLock_Unlock(&lock, &node1);
+    ASSERT_EQUAL(MCSLock_TryLock(&lock, &node2), 1);
+    MCSLock_Unlock(&lock, &node2);
+    ASSERT_NULL(lock.tail);
+}
+
+CTEST(atomic, barrier)
+{
+    static SpinBarrier_Type bar = SPINBARRIER_INIT(1);
+
+    SpinBarrier_Wait(&bar);
+    ASSERT_EQUAL(bar.sense, 1);
+    SpinBarrier_Wait(&bar);
+    ASSERT_EQUAL(bar.sense, 0);
+    ASSERT_EQUAL(bar.count, 0);
+}
+
+CTEST(atomic, seqlock)
+{
+    static SeqLock_Type sl = SEQLOCK_INIT;
+    uint32_t seq = SeqLock_ReadBegin(&sl);
+
+    ASSERT_EQUAL(SeqLock_ReadRetry(&sl, seq), 0);
+    SeqLock_WriteBegin(&sl);
+    ASSERT_EQUAL(sl.seq & 1, 1);
+    SeqLock_WriteEnd(&sl);
+    ASSERT_EQUAL(SeqLock_ReadRetry(&sl, seq), 1);
+    ASSERT_EQUAL(SeqLock_ReadRetry(&sl, SeqLock_ReadBegin(&sl)), 0);
+}
+
+CTEST(atomic, msgq)
+{
+    static MsgQueue_Type q;
+    static void *ring[4];
+    void *in[6] = {(void *)1, (void *)2, (void *)3, (void *)4, (void *)5, (void *)6};
+    void *out[6];
+
+    ASSERT_EQUAL(MsgQ_Init(&q, ring, 3, 0, NULL, 0), -1);
+    ASSERT_EQUAL(MsgQ_Init(&q, ring, 4, 1, NULL, 0), 0);
+    ASSERT_EQUAL(MsgQ_Dequeue(&q, out), -1);
+    ASSERT_EQUAL(MsgQ_EnqueueBurst(&q, in, 6), 4);
+    ASSERT_EQUAL(MsgQ_Enqueue(&q, in[4]), -1);
+    ASSERT_EQUAL(MsgQ_DequeueBurst(&q, out, 3), 3);
+    ASSERT_EQUAL(MsgQ_EnqueueBurst(&q, in + 4, 2), 2);
+    ASSERT_EQUAL(MsgQ_Count(&q), 3);
+    ASSERT_EQUAL(MsgQ_DequeueBurst(&q, out + 3, 6), 3);
+    for (int i = 0; i < 6; i++) {
+        ASSERT_EQUAL((unsigned long)out[i], i + 1);
+    }
+}
+
+static volatile unsigned long msgq_rings, msgq_target;
+
+static void msgq_doorbell(unsigned long target)
+{
+    msgq_rings++;
+    msgq_target = target;
+}
+
+CTEST(atomic, msgq_doorbell)
+{
+    static MsgQueue_Type q;
+    static void *ring[4];
+    void *in[4] = {(void *)1, (void *)2, (void *)3, (void *)4};
+    void *out[4];
+
+    msgq_rings = 0;
+    ASSERT_EQUAL(MsgQ_Init(&q, ring, 4, 0, msgq_doorbell, 7), 0);
+    // rung for the first messages of an empty queue
+    ASSERT_EQUAL(MsgQ_EnqueueBurst(&q, in, 2), 2);
+    ASSERT_EQUAL(msgq_rings, 1);
+    ASSERT_EQUAL(msgq_target, 7);
+    // not rung while the consumer still has messages to read
+    ASSERT_EQUAL(MsgQ_Enqueue(&q, in[2]), 0);
+    ASSERT_EQUAL(msgq_rings, 1);
+    // not rung when nothing is enqueued
+    ASSERT_EQUAL(MsgQ_EnqueueBurst(&q, in, 0), 0);
+    ASSERT_EQUAL(msgq_rings, 1);
+    // rung again once the consumer has drained the queue
+    ASSERT_EQUAL(MsgQ_DequeueBurst(&q, out, 4), 3);
+    ASSERT_EQUAL(MsgQ_Enqueue(&q, in[3]), 0);
+    ASSERT_EQUAL(msgq_rings, 2);
+    // partly drained, the consumer is still awake
+    ASSERT_EQUAL(MsgQ_Enqueue(&q, in[0]), 0);
+    ASSERT_EQUAL(MsgQ_Dequeue(&q, out), 0);
+    ASSERT_EQUAL(MsgQ_Enqueue(&q, in[1]), 0);
+    ASSERT_EQUAL(msgq_rings, 2);
+
+    // the same with multiple producers
+    msgq_rings = 0;
+    ASSERT_EQUAL(MsgQ_Init(&q, ring, 4, 1, msgq_doorbell, 3), 0);
+    ASSERT_EQUAL(MsgQ_Enqueue(&q, in[0]), 0);
+    ASSERT_EQUAL(MsgQ_Enqueue(&q, in[1]), 0);
+    ASSERT_EQUAL(msgq_rings, 1);
+    ASSERT_EQUAL(MsgQ_DequeueBurst(&q, out, 4), 2);
+    ASSERT_EQUAL(MsgQ_EnqueueBurst(&q, in, 4), 4);
+    ASSERT_EQUAL(msgq_rings, 2);
+    ASSERT_EQUAL(msgq_target, 3);
+}
+
 #endif
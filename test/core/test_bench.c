@@ -33,6 +33,49 @@ CTEST(bench, bench)
     printf("usecyc:%lu, lpcnt:%lu, sumcyc:%lu\n", (unsigned long)BENCH_GET_USECYC(), (unsigned long)BENCH_GET_LPCNT(), (unsigned long)BENCH_GET_SUMCYC());
 
 }
+CTEST(bench, calib)
+{
+    BENCH_INIT();
+    BENCH_RESET(empty);
+    for (int i = 0; i < 10; i ++) {
+        BENCH_START(empty);
+        BENCH_SAMPLE(empty);
+    }
+    BENCH_STAT(empty);
+    // empty region cost should be almost removed by the calibrated overhead
+    printf("overhead:%lu, empty sumcyc:%lu\n", (unsigned long)BENCH_GET_OVHCYC(), (unsigned long)BENCH_GET_SUMCYC());
+    ASSERT_TRUE(BENCH_GET_SUMCYC() <= BENCH_GET_OVHCYC() * 10 + 100);
+}
+
+BENCH_SLOT_DECLARE(pipeline);
+BENCH_SLOT_DECLARE(stage0);
+BENCH_SLOT_DECLARE(stage1);
+
+CTEST(bench, slot)
+{
+    BENCH_INIT();
+    for (int i = 0; i < 10; i ++) {
+        BENCH_SLOT_START(pipeline);
+        BENCH_SLOT_START(stage0);
+        memset(test_mem, 0xa5, sizeof(test_mem));
+        BENCH_SLOT_SAMPLE(stage0);
+        BENCH_SLOT_START(stage1);
+        memset(test_mem, 0x5a, sizeof(test_mem) / 2);
+        BENCH_SLOT_SAMPLE(stage1);
+        BENCH_SLOT_SAMPLE(pipeline);
+    }
+    BENCH_SLOT_DUMP();
+#ifndef DISABLE_NMSIS_BENCH
+    ASSERT_EQUAL(10, BENCH_SLOT_GET_LPCNT(pipeline));
+    ASSERT_EQUAL(10, BENCH_SLOT_GET_LPCNT(stage0));
+    ASSERT_EQUAL(10, BENCH_SLOT_GET_LPCNT(stage1));
+    ASSERT_TRUE(BENCH_SLOT_GET_MINCYC(stage0) <= BENCH_SLOT_GET_MAXCYC(stage0));
+    ASSERT_TRUE(BENCH_SLOT_GET_SUMCYC(pipeline) >= BENCH_SLOT_GET_SUMCYC(stage0) + BENCH_SLOT_GET_SUMCYC(stage1));
+#endif
+    BENCH_SLOT_RESET(pipeline);
+    ASSERT_EQUAL(0, BENCH_SLOT_GET_LPCNT(pipeline));
+}
+
 // Declare HPMCOUNTER3 and HPMCOUNTER4
 HPM_DECLARE_VAR(3);
 HPM_DECLARE_VAR(4);
@@ -78,3 +121,83 @@ CTEST(bench, hpm)
     printf("hpm4, usecyc:%lu, lpcnt:%lu, sumcyc:%lu\n", (unsigned long)HPM_GET_USECYC(4), (unsigned long)HPM_GET_LPCNT(4), (unsigned long)HPM_GET_SUMCYC(4));
 }
 
+
+BENCH_HIST_DECLARE(hist, 10, 16);
+
+CTEST(bench, hist)
+{
+    BENCH_HIST_RESET(hist);
+    // 1 ~ 100 cycles, and one overflow sample
+    for (int i = 1; i <= 100; i ++) {
+        BENCH_HIST_ADD(hist, i);
+    }
+    BENCH_HIST_ADD(hist, 1000);
+    BENCH_HIST_STAT(hist);
+    BENCH_HIST_DUMP(hist);
+#ifndef DISABLE_NMSIS_BENCH
+    ASSERT_EQUAL(101, BENCH_HIST_GET_CNT(hist));
+    ASSERT_EQUAL(59, BENCH_HIST_GET_PCT(hist, 50));
+    ASSERT_EQUAL(99, BENCH_HIST_GET_PCT(hist, 90));
+    ASSERT_EQUAL(1000, BENCH_HIST_GET_MAXCYC(hist));
+    ASSERT_EQUAL(1000, BENCH_HIST_GET_PCT(hist, 100));
+#endif
+    BENCH_HIST_RESET(hist);
+    for (int i = 0; i < 10; i ++) {
+        BENCH_HIST_START(hist);
+        memset(test_mem, 0xa5, sizeof(test_mem));
+        BENCH_HIST_SAMPLE(hist);
+    }
+    BENCH_HIST_STAT(hist);
+}
+
+static unsigned char bench_src[1024 + 8];
+static unsigned char bench_dst[1024 + 8];
+
+// memory and string functions of libc, or of fastmem middleware when it is used,
+// copies are done aligned and misaligned to cover the word merging path
+CTEST(bench, memfunc)
+{
+    for (int i = 0; i < (int)sizeof(bench_src); i ++) {
+        bench_src[i] = (unsigned char)((i * 7) % 255 + 1);
+    }
+    bench_src[sizeof(bench_src) - 1] = 0;
+
+    BENCH_INIT();
+    BENCH_START(memcpy_aligned);
+    memcpy(bench_dst, bench_src, 1024);
+    BENCH_END(memcpy_aligned);
+    ASSERT_EQUAL(0, memcmp(bench_dst, bench_src, 1024));
+
+    BENCH_START(memcpy_misaligned);
+    memcpy(bench_dst + 1, bench_src + 3, 1021);
+    BENCH_END(memcpy_misaligned);
+    ASSERT_EQUAL(0, memcmp(bench_dst + 1, bench_src + 3, 1021));
+
+    BENCH_START(memset_1k);
+    memset(bench_dst, 0x5a, 1024);
+    BENCH_END(memset_1k);
+    ASSERT_EQUAL(0x5a, bench_dst[0]);
+    ASSERT_EQUAL(0x5a, bench_dst[1023]);
+
+    memcpy(bench_dst, bench_src, sizeof(bench_src));
+    bench_dst[1000] ^= 0x80;
+    BENCH_START(memcmp_1k);
+    int diff = memcmp(bench_dst, bench_src, 1024);
+    BENCH_END(memcmp_1k);
+    ASSERT_TRUE((diff > 0) == (bench_dst[1000] > bench_src[1000]));
+    ASSERT_TRUE(diff != 0);
+    ASSERT_EQUAL(0, memcmp(bench_dst, bench_src, 1000));
+
+    BENCH_START(strlen_1k);
+    size_t len = strlen((const char *)bench_src + 1);
+    BENCH_END(strlen_1k);
+    ASSERT_EQUAL(sizeof(bench_src) - 2, len);
+
+    memcpy(bench_dst, bench_src, sizeof(bench_src));
+    BENCH_START(strcmp_1k);
+    diff = strcmp((const char *)bench_dst, (const char *)bench_src);
+    BENCH_END(strcmp_1k);
+    ASSERT_EQUAL(0, diff);
+    bench_dst[900] = 0;
+    ASSERT_TRUE(strcmp((const char *)bench_dst, (const char *)bench_src) < 0);
+}
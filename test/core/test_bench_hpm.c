@@ -0,0 +1,34 @@
+#include <stdlib.h>
+#include <string.h>
+#include "ctest.h"
+#include "nuclei_sdk_soc.h"
+
+// enable hpm aware benchmark mode
+#define NMSIS_BENCH_HPM
+
+#include "nmsis_bench.h"
+
+BENCH_DECLARE_VAR();
+
+static unsigned long hpm_test_mem[64];
+
+CTEST(bench, hpm_aware)
+{
+    BENCH_INIT();
+    BENCH_START(memset);
+    memset(hpm_test_mem, 0xa5, sizeof(hpm_test_mem));
+    BENCH_END(memset);
+    ASSERT_TRUE(BENCH_GET_USEINSTRET() > 0);
+
+    BENCH_RESET(memsetloop);
+    for (int i = 0; i < 10; i ++) {
+        BENCH_START(memsetloop);
+        memset(hpm_test_mem, 0x5a, sizeof(hpm_test_mem));
+        BENCH_SAMPLE(memsetloop);
+    }
+    BENCH_STOP(memsetloop);
+    BENCH_STAT(memsetloop);
+    ASSERT_TRUE(BENCH_GET_SUMINSTRET() >= BENCH_GET_USEINSTRET());
+    printf("instret:%lu, icmiss:%lu, dcmiss:%lu, branch:%lu, brmiss:%lu\n", (unsigned long)BENCH_GET_SUMINSTRET(), \
+           (unsigned long)BENCH_GET_SUMHPM(0), (unsigned long)BENCH_GET_SUMHPM(1), (unsigned long)BENCH_GET_SUMHPM(2), (unsigned long)BENCH_GET_SUMHPM(3));
+}
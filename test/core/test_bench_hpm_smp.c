@@ -0,0 +1,28 @@
+#include <stdlib.h>
+#include <string.h>
+#include "ctest.h"
+#include "nuclei_sdk_soc.h"
+
+// per-hart benchmark mode together with hpm aware mode, run by one hart
+#define NMSIS_BENCH_SMP
+#define NMSIS_BENCH_HPM
+#define BENCH_SMP_NUM           1
+
+#include "nmsis_bench.h"
+
+BENCH_DECLARE_VAR();
+
+static unsigned long hpm_smp_test_mem[64];
+
+CTEST(bench, hpm_smp)
+{
+    BENCH_INIT();
+    // the barrier releases when its only hart arrives
+    BENCH_SMP_START(memsetloop);
+    memset(hpm_smp_test_mem, 0xa5, sizeof(hpm_smp_test_mem));
+    BENCH_SAMPLE(memsetloop);
+    BENCH_STOP(memsetloop);
+    BENCH_SMP_STAT(memsetloop);
+    ASSERT_EQUAL(1, (int)BENCH_GET_LPCNT());
+    ASSERT_TRUE(BENCH_GET_USEINSTRET() > 0);
+}
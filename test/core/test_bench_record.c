@@ -0,0 +1,45 @@
+#include <stdlib.h>
+#include <string.h>
+#include "ctest.h"
+#include "nuclei_sdk_soc.h"
+
+// only buffer benchmark results in RAM, and dump them using BENCH_FLUSH
+#define NMSIS_BENCH_RECORD
+
+#include "nmsis_bench.h"
+
+BENCH_DECLARE_VAR();
+
+BENCH_SLOT_DECLARE(record_slot);
+BENCH_SLOT_DECLARE(record_slot_next);
+
+static unsigned long record_test_mem[32];
+
+CTEST(bench, record)
+{
+    BENCH_INIT();
+    BENCH_START(memset);
+    memset(record_test_mem, 0xa5, sizeof(record_test_mem));
+    BENCH_END(memset);
+
+    BENCH_RESET(memsetloop);
+    for (int i = 0; i < 10; i ++) {
+        BENCH_START(memsetloop);
+        BENCH_SLOT_START(record_slot);
+        memset(record_test_mem, 0x5a, sizeof(record_test_mem));
+        BENCH_SLOT_SAMPLE(record_slot);
+        BENCH_SLOT_START(record_slot_next);
+        BENCH_SLOT_SAMPLE(record_slot_next);
+        BENCH_SAMPLE(memsetloop);
+    }
+    BENCH_STOP(memsetloop);
+    BENCH_STAT(memsetloop);
+    BENCH_SLOT_DUMP();
+    ASSERT_EQUAL(5, _bc_recbuf.cnt);
+    BENCH_FLUSH(BENCH_FLUSH_CONSOLE);
+    ASSERT_EQUAL(0, _bc_recbuf.cnt);
+    // a slot registered before others is recorded alone
+    BENCH_SLOT_STAT(record_slot);
+    ASSERT_EQUAL(1, _bc_recbuf.cnt);
+    BENCH_FLUSH(BENCH_FLUSH_CONSOLE);
+}
@@ -0,0 +1,70 @@
+#include "ctest.h"
+#include "nuclei_sdk_soc.h"
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1) && defined(__CCM_PRESENT) && (__CCM_PRESENT == 1)
+
+#define CACHE_TEST_SIZE     512
+
+static uint8_t cache_test_buf[CACHE_TEST_SIZE] __attribute__((aligned(128)));
+
+static void cache_test_fill(uint8_t seed)
+{
+    for (uint32_t i = 0; i < CACHE_TEST_SIZE; i++) {
+        cache_test_buf[i] = (uint8_t)(seed + i);
+    }
+}
+
+static int cache_test_check(uint8_t seed)
+{
+    for (uint32_t i = 0; i < CACHE_TEST_SIZE; i++) {
+        if (cache_test_buf[i] != (uint8_t)(seed + i)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+CTEST(cache, dcache_range_flush)
+{
+    if (DCachePresent() == 0) {
+        return;
+    }
+    EnableDCache();
+    cache_test_fill(0x11);
+    MFlushDCacheRange(cache_test_buf + 3, CACHE_TEST_SIZE - 7);
+    MFlushInvalDCacheRange(cache_test_buf + 5, CACHE_TEST_SIZE - 9);
+    ASSERT_EQUAL(cache_test_check(0x11), 1);
+}
+
+CTEST(cache, dcache_range_inval_unaligned)
+{
+    if (DCachePresent() == 0) {
+        return;
+    }
+    EnableDCache();
+    cache_test_fill(0x22);
+    // dirty data in partial head and tail lines out of the range must not be lost
+    MInvalDCacheRange(cache_test_buf + 1, CACHE_TEST_SIZE - 3);
+    ASSERT_EQUAL(cache_test_buf[0], 0x22);
+    ASSERT_EQUAL(cache_test_buf[CACHE_TEST_SIZE - 1], (uint8_t)(0x22 + CACHE_TEST_SIZE - 1));
+    MInvalDCacheRange(cache_test_buf, 0);
+}
+
+#endif
+
+static uint8_t cmo_test_buf[256] __attribute__((aligned(64)));
+
+CTEST(cache, cmo_zero_range)
+{
+    for (uint32_t i = 0; i < sizeof(cmo_test_buf); i++) {
+        cmo_test_buf[i] = 0x5A;
+    }
+    CMOPrefetchRange(cmo_test_buf, sizeof(cmo_test_buf), 0);
+    // unaligned head and tail must not be touched
+    CMOZeroRange(cmo_test_buf + 3, sizeof(cmo_test_buf) - 10);
+    ASSERT_EQUAL(cmo_test_buf[2], 0x5A);
+    ASSERT_EQUAL(cmo_test_buf[sizeof(cmo_test_buf) - 7], 0x5A);
+    for (uint32_t i = 3; i < sizeof(cmo_test_buf) - 7; i++) {
+        ASSERT_EQUAL(cmo_test_buf[i], 0);
+    }
+}
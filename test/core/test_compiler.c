@@ -129,4 +129,63 @@ CTEST(compiler, fld2val)
     ASSERT_EQUAL(_FLD2VAL(TEST, value), 0x9);
 }
 
+CTEST(compiler, clzl)
+{
+    ASSERT_EQUAL(__CLZL(0), __RISCV_XLEN);
+    ASSERT_EQUAL(__CLZL(1), __RISCV_XLEN - 1);
+    ASSERT_EQUAL(__CLZL(0x80), __RISCV_XLEN - 8);
+    ASSERT_EQUAL(__CLZL(~0UL), 0);
+    for (unsigned long i = 0; i < __RISCV_XLEN; i++) {
+        ASSERT_EQUAL(__FLSL((1UL << i) | ((1UL << i) - 1) / 3), i);
+    }
+}
+
+CTEST(compiler, ctzl)
+{
+    ASSERT_EQUAL(__CTZL(0), __RISCV_XLEN);
+    ASSERT_EQUAL(__CTZL(1), 0);
+    ASSERT_EQUAL(__CTZL(0x80), 7);
+    ASSERT_EQUAL(__CTZL(~0UL), 0);
+    for (unsigned long i = 0; i < __RISCV_XLEN; i++) {
+        ASSERT_EQUAL(__CTZL((1UL << i) | ((~0UL << i) << 1)), i);
+    }
+}
+
+CTEST(compiler, cpopl)
+{
+    ASSERT_EQUAL(__CPOPL(0), 0);
+    ASSERT_EQUAL(__CPOPL(~0UL), __RISCV_XLEN);
+    ASSERT_EQUAL(__CPOPL(0x80000001UL), 2);
+    for (unsigned long i = 0; i < __RISCV_XLEN; i++) {
+        ASSERT_EQUAL(__CPOPL(~0UL << i), __RISCV_XLEN - i);
+    }
+}
 
+CTEST(compiler, rev8l)
+{
+    ASSERT_EQUAL(__REV8L(0), 0);
+#if __RISCV_XLEN == 32
+    ASSERT_EQUAL(__REV8L(0x12345678UL), 0x78563412UL);
+#else
+    ASSERT_EQUAL(__REV8L(0x0123456789ABCDEFUL), 0xEFCDAB8967452301UL);
+#endif
+    ASSERT_EQUAL(__REV(0x12345678UL), 0x78563412UL);
+}
+
+CTEST(compiler, orcbl)
+{
+    ASSERT_EQUAL(__ORCBL(0), 0);
+    ASSERT_EQUAL(__ORCBL(0x80), 0xFF);
+    ASSERT_EQUAL(__ORCBL(0x01000100UL), 0xFF00FF00UL);
+    ASSERT_EQUAL(__ORCBL(~0UL), ~0UL);
+}
+
+CTEST(compiler, clmull)
+{
+    ASSERT_EQUAL(__CLMULL(0, ~0UL), 0);
+    ASSERT_EQUAL(__CLMULL(3, 3), 5);
+    ASSERT_EQUAL(__CLMULL(0x87, 0x13), 0x87 ^ (0x87 << 1) ^ (0x87 << 4));
+    ASSERT_EQUAL(__CLMULHL(3, 3), 0);
+    ASSERT_EQUAL(__CLMULHL(1UL << (__RISCV_XLEN - 1), 6), 3);
+    ASSERT_EQUAL(__CLMULHL(~0UL, ~0UL), ~0UL / 3);
+}
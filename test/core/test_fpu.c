@@ -126,4 +126,75 @@ CTEST(fpu, fpucontext)
     SAVE_FPU_CONTEXT();
     RESTORE_FPU_CONTEXT();
 }
+
+CTEST(fpu, lazycontext)
+{
+    rv_fpu_context_t ctx;
+    rv_csr_t mstatus;
+    rv_fpu_t val = 12345, temp = 0;
+
+    ctx.fcsr = 0xFF;
+    // task never used fpu, nothing is saved
+    mstatus = __FPU_LazySave(&ctx, MSTATUS_FS_INITIAL);
+    ASSERT_EQUAL(mstatus, MSTATUS_FS_INITIAL);
+    ASSERT_EQUAL(ctx.fcsr, 0xFF);
+    // dirty fpu state is saved and marked clean
+    __RV_FLOAD(FREG(5), &val, 0);
+    mstatus = __FPU_LazySave(&ctx, MSTATUS_FS_DIRTY | MSTATUS_MPIE);
+    ASSERT_EQUAL(mstatus, MSTATUS_FS_CLEAN | MSTATUS_MPIE);
+    ASSERT_EQUAL(ctx.freg[5], val);
+    ASSERT_EQUAL(ctx.fcsr, __get_FCSR());
+    ctx.freg[5] = val + 1;
+    __FPU_LazyRestore(&ctx, mstatus);
+    __RV_FSTORE(FREG(5), &temp, 0);
+    ASSERT_EQUAL(temp, val + 1);
+}
+
+CTEST(fpu, lazyisr)
+{
+    rv_fpu_isr_context_t ctx;
+    rv_fpu_t val = 12345, other = 678, temp = 0;
+    rv_csr_t old_fcsr = __get_FCSR();
+
+    // dirty state is saved, marked clean and restored when the handler modified it
+    __RV_FLOAD(FREG(5), &val, 0);
+    __FPU_ISR_Enter(&ctx);
+    ASSERT_EQUAL(ctx.fs, MSTATUS_FS_DIRTY);
+    ASSERT_EQUAL(__RV_CSR_READ(CSR_MSTATUS) & MSTATUS_FS, MSTATUS_FS_CLEAN);
+    ASSERT_EQUAL(ctx.freg[5], val);
+    __RV_FLOAD(FREG(5), &other, 0);
+    __FPU_ISR_Exit(&ctx);
+    ASSERT_EQUAL(__RV_CSR_READ(CSR_MSTATUS) & MSTATUS_FS, MSTATUS_FS_DIRTY);
+    __RV_FSTORE(FREG(5), &temp, 0);
+    ASSERT_EQUAL(temp, val);
+
+    // nothing is restored when the handler did not touch fpu state
+    __FPU_ISR_Enter(&ctx);
+    ctx.freg[5] = other;
+    __FPU_ISR_Exit(&ctx);
+    ASSERT_EQUAL(__RV_CSR_READ(CSR_MSTATUS) & MSTATUS_FS, MSTATUS_FS_DIRTY);
+    __RV_FSTORE(FREG(5), &temp, 0);
+    ASSERT_EQUAL(temp, val);
+
+    // an interrupted context in initial state is not saved and gets its fcsr reset
+    __RV_CSR_CLEAR(CSR_MSTATUS, MSTATUS_FS_CLEAN);
+    __FPU_ISR_Enter(&ctx);
+    ASSERT_EQUAL(ctx.fs, MSTATUS_FS_INITIAL);
+    __set_FRM(FRM_RNDMODE_RUP);
+    __FPU_ISR_Exit(&ctx);
+    ASSERT_EQUAL(__RV_CSR_READ(CSR_MSTATUS) & MSTATUS_FS, MSTATUS_FS_INITIAL);
+    ASSERT_EQUAL(__get_FCSR(), 0);
+
+    // fpu off is enabled for the handler and turned off again
+    __disable_FPU();
+    __FPU_ISR_Enter(&ctx);
+    ASSERT_EQUAL(ctx.fs, 0);
+    ASSERT_EQUAL(__RV_CSR_READ(CSR_MSTATUS) & MSTATUS_FS, MSTATUS_FS_INITIAL);
+    __RV_FLOAD(FREG(5), &other, 0);
+    __FPU_ISR_Exit(&ctx);
+    ASSERT_EQUAL(__RV_CSR_READ(CSR_MSTATUS) & MSTATUS_FS, 0);
+
+    __RV_CSR_SET(CSR_MSTATUS, MSTATUS_FS_DIRTY);
+    __set_FCSR(old_fcsr);
+}
 #endif
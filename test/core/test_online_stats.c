@@ -0,0 +1,41 @@
+#include "ctest.h"
+#include "nuclei_sdk_soc.h"
+#include "riscv_math.h"
+
+// more samples than the 2^17 full scale squares of 1.23 samples that fit q63
+#define ONLINE_STATS_Q31_SAMPLES        300000U
+
+CTEST(online_stats, running_q31_long)
+{
+    riscv_running_stats_instance_q31 S;
+    q31_t mean, var;
+
+    riscv_running_stats_init_q31(&S);
+    // alternating 1.0 and 0.5, mean is 0.75, variance 0.0625
+    for (uint32_t i = 0; i < ONLINE_STATS_Q31_SAMPLES; i ++) {
+        riscv_running_stats_add_q31(&S, (i & 1) ? 0x3FFFFFFF : 0x7FFFFFFF);
+        ASSERT_TRUE(S.count <= RISCV_RUNNING_STATS_Q31_MAX_COUNT);
+        ASSERT_TRUE(S.sumOfSquares >= 0);
+    }
+    mean = riscv_running_stats_mean_q31(&S);
+    var = riscv_running_stats_var_q31(&S);
+    ASSERT_TRUE((mean > 0x5FFF0000) && (mean < 0x60010000));
+    ASSERT_TRUE((var > 0x07FF0000) && (var < 0x08010000));
+    ASSERT_EQUAL(0x3FFFFFFF, S.min);
+    ASSERT_EQUAL(0x7FFFFFFF, S.max);
+}
+
+CTEST(online_stats, running_q31_limit)
+{
+    riscv_running_stats_instance_q31 S;
+
+    riscv_running_stats_init_q31(&S);
+    for (uint32_t i = 0; i < RISCV_RUNNING_STATS_Q31_MAX_COUNT; i ++) {
+        riscv_running_stats_add_q31(&S, (i & 1) ? 0x3FFFFFFF : 0x7FFFFFFF);
+    }
+    // counts all samples up to the limit
+    ASSERT_EQUAL(RISCV_RUNNING_STATS_Q31_MAX_COUNT, S.count);
+    riscv_running_stats_add_q31(&S, 0x7FFFFFFF);
+    ASSERT_EQUAL(RISCV_RUNNING_STATS_Q31_MAX_COUNT / 2 + 1, S.count);
+    ASSERT_TRUE((riscv_running_stats_var_q31(&S) > 0x07FF0000) && (riscv_running_stats_var_q31(&S) < 0x08010000));
+}
@@ -0,0 +1,82 @@
+#include <string.h>
+#include "ctest.h"
+#include "nuclei_sdk_soc.h"
+
+#define PERF_RUNS       8
+#define PERF_WORDS      256
+
+// 1KB buffers on both rv32 and rv64
+static uint32_t perf_src[PERF_WORDS];
+static uint32_t perf_dst[PERF_WORDS];
+
+/*
+ * Cycle baselines of each cpu matched by marchid, take them from the PERF log lines of a
+ * known good run on the cpu, such as
+ *   grep -o "PERF, .*" test.log | awk -F', ' '{printf "    {\"%s\", %s},\n", $2, $3}'
+ * checks without baseline are logged as new and never fail
+ */
+static const struct ctest_perf_baseline perf_baseline_none[] = {
+    {NULL, 0}
+};
+
+static const struct {
+    rv_csr_t marchid;
+    const struct ctest_perf_baseline* table;
+} perf_cpus[] = {
+    {0, perf_baseline_none},
+};
+
+static uint64_t perf_baseline(const char* name)
+{
+    rv_csr_t marchid = __RV_CSR_READ(CSR_MARCHID);
+
+    for (unsigned long i = 0; i < sizeof(perf_cpus) / sizeof(perf_cpus[0]); i++) {
+        if (perf_cpus[i].marchid == marchid) {
+            return ctest_perf_lookup(perf_cpus[i].table, name);
+        }
+    }
+    return 0;
+}
+
+// minimum cycles of PERF_RUNS runs of stmt, the first run warms up the caches
+#define PERF_MIN_CYCLES(mincyc, stmt)                           \
+    do {                                                        \
+        uint64_t _start, _cyc;                                  \
+        (mincyc) = UINT64_MAX;                                  \
+        for (int _i = 0; _i < PERF_RUNS; _i++) {                \
+            _start = __get_rv_cycle();                          \
+            stmt;                                               \
+            _cyc = __get_rv_cycle() - _start;                   \
+            if (_cyc < (mincyc)) {                              \
+                (mincyc) = _cyc;                                \
+            }                                                   \
+        }                                                       \
+    } while (0)
+
+CTEST(perf, memset)
+{
+    uint64_t cyc;
+
+    PERF_MIN_CYCLES(cyc, memset(perf_dst, 0xa5, sizeof(perf_dst)));
+    ASSERT_EQUAL_U(0xa5, ((uint8_t *)perf_dst)[sizeof(perf_dst) - 1]);
+    ASSERT_PERF("memset_1k", cyc, perf_baseline("memset_1k"));
+}
+
+CTEST(perf, memcpy)
+{
+    uint64_t cyc;
+
+    for (int i = 0; i < PERF_WORDS; i++) {
+        perf_src[i] = i;
+    }
+    PERF_MIN_CYCLES(cyc, memcpy(perf_dst, perf_src, sizeof(perf_dst)));
+    ASSERT_EQUAL_U(PERF_WORDS - 1, perf_dst[PERF_WORDS - 1]);
+    ASSERT_PERF("memcpy_1k", cyc, perf_baseline("memcpy_1k"));
+}
+
+CTEST(perf, assert)
+{
+    // within tolerance passes, the measured cycles are fixed here
+    ASSERT_PERF_TOL("selftest", 104, 100, 5);
+    ASSERT_PERF_TOL("selftest", 80, 100, 5);
+}
@@ -1,4 +1,5 @@
 #include <stdlib.h>
+#define __INC_INTRINSIC_API     1
 #include "ctest.h"
 #include "nuclei_sdk_soc.h"
 
@@ -11,3 +12,107 @@ CTEST(core, vector)
     ASSERT_EQUAL(__RV_CSR_READ(CSR_MSTATUS) & MSTATUS_VS, MSTATUS_VS_INITIAL);
 #endif
 }
+
+#ifdef __riscv_vector
+/* lengths around one and two strips of e32m8 and e16m4 */
+#define VEC_TEST_LEN    (2 * 8 * (__riscv_v_min_vlen / 16) + 3)
+
+static int32_t vec_i32[VEC_TEST_LEN];
+static int16_t vec_a16[VEC_TEST_LEN], vec_b16[VEC_TEST_LEN];
+
+CTEST(core, vector_vlmax)
+{
+    unsigned long vlenb;
+
+    __enable_vector();
+    vlenb = __VECTOR_VLENB();
+    ASSERT_TRUE(vlenb * 8 >= __riscv_v_min_vlen);
+    ASSERT_EQUAL(__VECTOR_VLMAX(VTYPE(E8, M1)), vlenb);
+    ASSERT_EQUAL(__VECTOR_VLMAX(VTYPE(E32, M8)), vlenb * 2);
+    ASSERT_EQUAL(__VECTOR_VLMAX(VTYPE(E16, MF2)), vlenb / 4);
+    ASSERT_EQUAL(__VECTOR_VLMAX(VTYPE(E32, M8)), __riscv_vsetvlmax_e32m8());
+    ASSERT_EQUAL(__VECTOR_SetVL(1000000, VTYPE(E32, M4) | VTYPE_VTA | VTYPE_VMA), __VECTOR_VLMAX(VTYPE(E32, M4)));
+    ASSERT_EQUAL(__VECTOR_SetVL(3, VTYPE(E8, M1)), 3);
+    ASSERT_EQUAL(__RV_CSR_READ(CSR_VTYPE), VTYPE(E8, M1));
+}
+
+CTEST(core, vector_foreach)
+{
+    size_t total = 0, strips = 0, n = VEC_TEST_LEN, vlmax;
+
+    __enable_vector();
+    vlmax = __riscv_vsetvlmax_e32m8();
+    __VECTOR_FOREACH(vl, n, 32, 8) {
+        ASSERT_TRUE((vl == vlmax) || (vl == n - total));
+        total += vl;
+        strips++;
+    }
+    ASSERT_EQUAL(total, n);
+    ASSERT_EQUAL(strips, (n + vlmax - 1) / vlmax);
+    __VECTOR_FOREACH(vl, 0, 32, 8) {
+        ASSERT_FAIL();
+    }
+}
+
+CTEST(core, vector_reduce)
+{
+    size_t n, i;
+    uint32_t sum;
+    int32_t max;
+    int64_t dot;
+
+    __enable_vector();
+    for (i = 0; i < VEC_TEST_LEN; i++) {
+        vec_i32[i] = (int32_t)((uint32_t)rand() * 2654435761UL);
+        vec_a16[i] = (int16_t)rand();
+        vec_b16[i] = (i & 1) ? INT16_MIN : (int16_t)rand();
+    }
+    // empty, partial strip, whole strips and a short last strip
+    for (n = 0; n <= VEC_TEST_LEN; n += (n < 4) ? 1 : 7) {
+        sum = 0;
+        max = INT32_MIN;
+        dot = 0;
+        for (i = 0; i < n; i++) {
+            sum += (uint32_t)vec_i32[i];
+            max = (vec_i32[i] > max) ? vec_i32[i] : max;
+            dot += (int64_t)vec_a16[i] * vec_b16[i];
+        }
+        ASSERT_EQUAL((int32_t)sum, __VECTOR_ReduceSum_i32(vec_i32, n));
+        ASSERT_EQUAL(max, __VECTOR_ReduceMax_i32(vec_i32, n));
+#if defined(__riscv_v_elen) && (__riscv_v_elen >= 64)
+        ASSERT_TRUE(dot == __VECTOR_DotProd_i16(vec_a16, vec_b16, n));
+#endif
+    }
+}
+
+#if defined(__riscv_v_elen_fp) && (__riscv_v_elen_fp >= 32)
+static float vec_f32[VEC_TEST_LEN], vec_g32[VEC_TEST_LEN];
+
+CTEST(core, vector_reduce_f32)
+{
+    size_t n, i;
+    float sum, max, dot;
+
+    __enable_vector();
+    __RV_CSR_SET(CSR_MSTATUS, MSTATUS_FS);
+    // multiples of 1/16 sum exactly, so lane order doesn't change the result
+    for (i = 0; i < VEC_TEST_LEN; i++) {
+        vec_f32[i] = (float)(rand() % 1000 - 500) / 16.0f;
+        vec_g32[i] = (float)(rand() % 64 - 32) / 4.0f;
+    }
+    for (n = 0; n <= VEC_TEST_LEN; n += (n < 4) ? 1 : 7) {
+        sum = 0.0f;
+        max = -__builtin_inff();
+        dot = 0.0f;
+        for (i = 0; i < n; i++) {
+            sum += vec_f32[i];
+            max = (vec_f32[i] > max) ? vec_f32[i] : max;
+            dot += vec_f32[i] * vec_g32[i];
+        }
+        ASSERT_DBL_NEAR(sum, __VECTOR_ReduceSum_f32(vec_f32, n));
+        ASSERT_TRUE(max == __VECTOR_ReduceMax_f32(vec_f32, n));
+        ASSERT_DBL_NEAR(dot, __VECTOR_DotProd_f32(vec_f32, vec_g32, n));
+    }
+}
+#endif
+#endif
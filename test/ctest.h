@@ -186,6 +186,25 @@ void assert_dbl_far(double exp, double real, double tol, const char* caller, int
 #define ASSERT_DBL_FAR(exp, real) assert_dbl_far(exp, real, 1e-4, __FILE__, __LINE__)
 #define ASSERT_DBL_FAR_TOL(exp, real, tol) assert_dbl_far(exp, real, tol, __FILE__, __LINE__)
 
+/* Performance asserts: measured cycles of a region are compared with a stored baseline,
+ * more than tol percent above it fails the test unless CTEST_PERF_WARN_ONLY is defined,
+ * baseline 0 means not known yet, each check logs a "PERF, name, cycles, baseline, tol, status"
+ * line which can be collected to update the baselines */
+#ifndef CTEST_PERF_TOL
+#define CTEST_PERF_TOL 5
+#endif
+
+struct ctest_perf_baseline {
+    const char* name;    // name passed to ASSERT_PERF, NULL ends the table
+    uint64_t cycles;
+};
+
+uint64_t ctest_perf_lookup(const struct ctest_perf_baseline* table, const char* name);
+
+void assert_perf(const char* name, uint64_t real, uint64_t baseline, unsigned int tol, const char* caller, int line);
+#define ASSERT_PERF(name, real, baseline) assert_perf(name, real, baseline, CTEST_PERF_TOL, __FILE__, __LINE__)
+#define ASSERT_PERF_TOL(name, real, baseline, tol) assert_perf(name, real, baseline, tol, __FILE__, __LINE__)
+
 #ifdef CTEST_MAIN
 
 #include <setjmp.h>
@@ -424,6 +443,43 @@ void assert_fail(const char* caller, int line) {
     CTEST_ERR("%s:%d  shouldn't come here", caller, line);
 }
 
+static int ctest_perf_ok = 0;
+static int ctest_perf_regressed = 0;
+static int ctest_perf_new = 0;
+
+uint64_t ctest_perf_lookup(const struct ctest_perf_baseline* table, const char* name) {
+    if (table == NULL) {
+        return 0;
+    }
+    for (; table->name != NULL; table++) {
+        if (strcmp(table->name, name) == 0) {
+            return table->cycles;
+        }
+    }
+    return 0;
+}
+
+void assert_perf(const char* name, uint64_t real, uint64_t baseline, unsigned int tol, const char* caller, int line) {
+    // 64 bit values are printed as unsigned long, printf of newlib nano has no %llu
+    if (baseline == 0) {
+        ctest_perf_new++;
+        CTEST_LOG("PERF, %s, %lu, 0, %u%%, new", name, (unsigned long)real, tol);
+    } else if (real > baseline + baseline * tol / 100) {
+        ctest_perf_regressed++;
+#ifdef CTEST_PERF_WARN_ONLY
+        CTEST_LOG("PERF, %s, %lu, %lu, %u%%, regressed", name, (unsigned long)real, (unsigned long)baseline, tol);
+#else
+        CTEST_ERR("%s:%d  PERF, %s, %lu, %lu, %u%%, regressed", caller, line, name,
+                  (unsigned long)real, (unsigned long)baseline, tol);
+#endif
+    } else {
+        ctest_perf_ok++;
+        // much faster is fine, but the baseline should be updated to catch later regressions
+        CTEST_LOG("PERF, %s, %lu, %lu, %u%%, %s", name, (unsigned long)real, (unsigned long)baseline, tol,
+                  (real + baseline * tol / 100 < baseline) ? "faster" : "ok");
+    }
+}
+
 
 static int suite_all(struct ctest* t) {
     (void) t; // fix unused parameter warning
@@ -556,6 +612,11 @@ __attribute__((no_sanitize_address)) int ctest_main(int argc, const char *argv[]
     char results[80];
     snprintf(results, sizeof(results), "RESULTS: %d tests (%d ok, %d failed, %d skipped) ran in %" PRIu64 " ms", total, num_ok, num_fail, num_skip, (uint32_t)((t2 - t1)/1000));
     color_print(color, results);
+    if (ctest_perf_ok + ctest_perf_regressed + ctest_perf_new > 0) {
+        snprintf(results, sizeof(results), "PERF: %d checks (%d ok, %d regressed, %d no baseline)",
+                 ctest_perf_ok + ctest_perf_regressed + ctest_perf_new, ctest_perf_ok, ctest_perf_regressed, ctest_perf_new);
+        color_print((ctest_perf_regressed) ? ANSI_BRED : ANSI_GREEN, results);
+    }
     return num_fail;
 }
 
@@ -0,0 +1,109 @@
+#!/bin/env python3
+
+import sys
+import struct
+import argparse
+
+# SHT_SYMTAB, STT_OBJECT, STT_FUNC, SHF_WRITE, SHN_LORESERVE
+SHT_SYMTAB = 2
+STT_OBJECT = 1
+STT_FUNC = 2
+SHF_WRITE = 0x1
+SHN_LORESERVE = 0xFF00
+
+
+def elf_symbols(elffile):
+    """
+    Read symbol table of elf
+
+    Returns:
+        list: (name, type, value, size, writable) of function and object symbols, writable is
+        True for symbols in a writable section, such as .data and .bss
+    """
+    with open(elffile, "rb") as elf:
+        data = elf.read()
+    if data[:4] != b"\x7fELF":
+        raise ValueError("%s is not an elf file" % (elffile))
+    if data[4] == 2:
+        shoff, = struct.unpack_from("<Q", data, 0x28)
+        shentsize, shnum = struct.unpack_from("<HH", data, 0x3A)
+        shdr = struct.Struct("<IIQQQQIIQQ")
+        sym = struct.Struct("<IBBHQQ")
+    else:
+        shoff, = struct.unpack_from("<I", data, 0x20)
+        shentsize, shnum = struct.unpack_from("<HH", data, 0x2E)
+        shdr = struct.Struct("<IIIIIIIIII")
+        sym = struct.Struct("<IIIBBH")
+    sections = [shdr.unpack_from(data, shoff + i * shentsize) for i in range(shnum)]
+    symbols = []
+    for sec in sections:
+        if sec[1] != SHT_SYMTAB:
+            continue
+        offset, size, link, entsize = sec[4], sec[5], sec[6], sec[9]
+        stroff = sections[link][4]
+        for j in range(size // entsize):
+            fields = sym.unpack_from(data, offset + j * entsize)
+            if data[4] == 2:
+                name, info, shndx, value, ssize = fields[0], fields[1], fields[3], fields[4], fields[5]
+            else:
+                name, value, ssize, info, shndx = fields[0], fields[1], fields[2], fields[3], fields[5]
+            stype = info & 0xF
+            if stype not in (STT_FUNC, STT_OBJECT) or shndx == 0 or shndx >= SHN_LORESERVE:
+                continue
+            end = data.find(b"\0", stroff + name)
+            sname = data[stroff + name:end].decode()
+            writable = (sections[shndx][2] & SHF_WRITE) != 0
+            symbols.append((sname, stype, value, ssize, writable))
+    return symbols
+
+
+def bench_sizes(symbols, names):
+    """
+    Sum sizes of the symbols of each benchmark, a symbol belongs to benchmark name when it
+    is name or starts with name_, the longest matching name wins
+
+    Returns:
+        dict: name to [code, rodata, ram] bytes
+    """
+    sizes = dict((name, [0, 0, 0]) for name in names)
+    seen = set()
+    for sname, stype, value, ssize, writable in symbols:
+        # a function or object may be listed more than once, such as local symbols of lto
+        if (sname, value) in seen:
+            continue
+        seen.add((sname, value))
+        owner = None
+        for name in names:
+            if (sname == name or sname.startswith(name + "_")) and (owner is None or len(name) > len(owner)):
+                owner = name
+        if owner is None:
+            continue
+        if stype == STT_FUNC:
+            sizes[owner][0] += ssize
+        elif writable:
+            sizes[owner][2] += ssize
+        else:
+            sizes[owner][1] += ssize
+    return sizes
+
+
+# Usage:
+# python nuclei_sdk/tools/scripts/benchsize.py --elf build/app.elf crc32 sha256 qsort
+# prints code, read only data and ram bytes of the functions and objects named <bench>_*
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Report code and data size of each benchmark from the symbols of elf")
+    parser.add_argument("--elf", required=True, help="elf file of the benchmark suite")
+    parser.add_argument("benchmarks", nargs="+", help="benchmark names, the prefix of their symbols")
+    args = parser.parse_args()
+
+    sizes = bench_sizes(elf_symbols(args.elf), args.benchmarks)
+    print("BENCHSIZE, name, code, rodata, ram")
+    total = [0, 0, 0]
+    for name in args.benchmarks:
+        code, rodata, ram = sizes[name]
+        if code == 0:
+            print("Warning: no function named %s_* found in %s" % (name, args.elf))
+        print("BENCHSIZE, %s, %d, %d, %d" % (name, code, rodata, ram))
+        total = [total[0] + code, total[1] + rodata, total[2] + ram]
+    print("BENCHSIZE, total, %d, %d, %d" % (total[0], total[1], total[2]))
+    sys.exit(0)
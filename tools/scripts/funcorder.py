@@ -0,0 +1,202 @@
+#!/bin/env python3
+
+import sys
+import bisect
+import struct
+import argparse
+
+GMON_VERSION = 0x00051879
+
+# functions must stay where the startup linker script puts them
+KEEP_FUNCTIONS = ("_start", "_premain_init", "__sync_harts", "_mcount", "__mcount_internal")
+
+
+def decode_gmon(data):
+    """
+    Decode gmon.out written by gprof_collect in Components/profiling/gprof.c
+
+    The header is struct gmonhdr of size_t lpc, hpc and 6 ints, followed by the histogram and
+    struct rawarc of size_t frompc, selfpc and long count, so the xlen is told by the version field
+
+    Returns:
+        dict: lowpc, highpc, histogram bins and arcs as (frompc, selfpc, count), None if data is invalid
+    """
+    for word in ("I", "Q"):
+        hdr = struct.Struct("<%s%sii16x" % (word, word))
+        if len(data) < hdr.size:
+            return None
+        lowpc, highpc, ncnt, version = hdr.unpack_from(data, 0)
+        if version == GMON_VERSION:
+            break
+    else:
+        return None
+    bins = list(struct.unpack_from("<%dH" % ((ncnt - hdr.size) // 2), data, hdr.size))
+    arc = struct.Struct("<%s%s%s" % (word, word, word.lower()))
+    arcs = []
+    for offset in range(ncnt, len(data) - arc.size + 1, arc.size):
+        arcs.append(arc.unpack_from(data, offset))
+    return {"lowpc": lowpc, "highpc": highpc, "bins": bins, "arcs": arcs}
+
+
+def elf_functions(elffile):
+    """ Return sorted list of (address, size, name) of function symbols in elf """
+    with open(elffile, "rb") as elf:
+        data = elf.read()
+    if data[:4] != b"\x7fELF":
+        raise ValueError("%s is not an elf file" % (elffile))
+    if data[4] == 2:
+        shoff, = struct.unpack_from("<Q", data, 0x28)
+        shentsize, shnum = struct.unpack_from("<HH", data, 0x3A)
+        shdr = struct.Struct("<IIQQQQIIQQ")
+        sym = struct.Struct("<IBBHQQ")
+    else:
+        shoff, = struct.unpack_from("<I", data, 0x20)
+        shentsize, shnum = struct.unpack_from("<HH", data, 0x2E)
+        shdr = struct.Struct("<IIIIIIIIII")
+        sym = struct.Struct("<IIIBBH")
+    sections = [shdr.unpack_from(data, shoff + i * shentsize) for i in range(shnum)]
+    funcs = {}
+    for sec in sections:
+        # SHT_SYMTAB
+        if sec[1] != 2:
+            continue
+        offset, size, link, entsize = sec[4], sec[5], sec[6], sec[9]
+        stroff = sections[link][4]
+        for j in range(size // entsize):
+            fields = sym.unpack_from(data, offset + j * entsize)
+            if data[4] == 2:
+                name, info, addr, fsize = fields[0], fields[1], fields[4], fields[5]
+            else:
+                name, addr, fsize, info = fields[0], fields[1], fields[2], fields[3]
+            # STT_FUNC
+            if (info & 0xF) == 2:
+                end = data.find(b"\0", stroff + name)
+                funcs[addr] = (addr, fsize, data[stroff + name:end].decode())
+    return sorted(funcs.values())
+
+
+def lookup_function(funcs, addrs, pc):
+    """ Return name of the function contains pc, None if not found """
+    idx = bisect.bisect_right(addrs, pc) - 1
+    if idx < 0:
+        return None
+    addr, size, name = funcs[idx]
+    return name if pc < addr + max(size, 1) else None
+
+
+def call_graph(gmon, funcs):
+    """
+    Map arcs and histogram of gmon to functions
+
+    Returns:
+        tuple: dict of (caller, callee) to call count, dict of function to histogram samples
+    """
+    addrs = [func[0] for func in funcs]
+    edges = {}
+    for frompc, selfpc, count in gmon["arcs"]:
+        caller = lookup_function(funcs, addrs, frompc)
+        callee = lookup_function(funcs, addrs, selfpc)
+        if caller is None or callee is None or caller == callee:
+            continue
+        key = (caller, callee)
+        edges[key] = edges.get(key, 0) + count
+    samples = {}
+    bins = gmon["bins"]
+    if bins:
+        scale = (gmon["highpc"] - gmon["lowpc"]) / len(bins)
+        for i, cnt in enumerate(bins):
+            if cnt:
+                name = lookup_function(funcs, addrs, int(gmon["lowpc"] + i * scale))
+                if name is not None:
+                    samples[name] = samples.get(name, 0) + cnt
+    return edges, samples
+
+
+def pettis_hansen(edges, samples):
+    """
+    Order functions by Pettis-Hansen clustering of call graph
+
+    Caller and callee are undirected nodes weighted by call count, the heaviest edge merges its
+    two clusters first, and the merged chains are flipped so the two functions connected by the
+    heaviest edge between them end up next to each other, then chains are ordered by samples
+
+    Returns:
+        list: function names in placement order
+    """
+    weight = {}
+    for (caller, callee), count in edges.items():
+        key = (min(caller, callee), max(caller, callee))
+        weight[key] = weight.get(key, 0) + count
+    chains = {}
+    for a, b in weight:
+        chains.setdefault(a, [a])
+        chains.setdefault(b, [b])
+
+    def edge(a, b):
+        return weight.get((min(a, b), max(a, b)), 0)
+
+    for (a, b), _ in sorted(weight.items(), key=lambda item: (-item[1], item[0])):
+        ca, cb = chains[a], chains[b]
+        if ca is cb:
+            continue
+        # join the ends connected by the heaviest edge
+        options = [(ca, cb), (ca, cb[::-1]), (ca[::-1], cb), (ca[::-1], cb[::-1])]
+        first, second = max(options, key=lambda pair: edge(pair[0][-1], pair[1][0]))
+        best = first + second
+        for name in best:
+            chains[name] = best
+    unique = []
+    for chain in chains.values():
+        if not any(chain is seen for seen in unique):
+            unique.append(chain)
+
+    def heat(chain):
+        return (sum(samples.get(name, 0) for name in chain),
+                sum(edge(x, y) for x in chain for y in chain if x < y))
+
+    unique.sort(key=heat, reverse=True)
+    order = [name for chain in unique for name in chain]
+    # hot functions which make no call are placed after the call graph by samples
+    for name, _ in sorted(samples.items(), key=lambda item: item[1], reverse=True):
+        if name not in chains:
+            order.append(name)
+    return order
+
+
+# Usage:
+# python nuclei_sdk/tools/scripts/funcorder.py --elf build/app.elf gmon.out text_order.ld
+# then INCLUDE text_order.ld in .text output section of linker script before *(.text .text.*),
+# and build with -ffunction-sections, or pass --format symbols with lld --symbol-ordering-file
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Generate function placement order of gprof call graph for i-cache locality")
+    parser.add_argument("--elf", required=True, help="elf file of the profiled program, used to map pc to function")
+    parser.add_argument("--format", choices=["ld", "symbols"], default="ld",
+                        help="ld: linker script fragment of .text.<func> patterns, symbols: one function per line")
+    parser.add_argument("--min-calls", type=int, default=1, help="ignore arcs called less than this count")
+    parser.add_argument("gmon", help="gmon.out generated by gprof_collect")
+    parser.add_argument("output", help="generated order file")
+    args = parser.parse_args()
+
+    with open(args.gmon, "rb") as gf:
+        gmon = decode_gmon(gf.read())
+    if gmon is None:
+        print("Error: invalid gmon data %s, please check!" % (args.gmon))
+        sys.exit(1)
+    funcs = elf_functions(args.elf)
+    edges, samples = call_graph(gmon, funcs)
+    edges = {key: count for key, count in edges.items() if count >= args.min_calls}
+    order = [name for name in pettis_hansen(edges, samples) if name not in KEEP_FUNCTIONS]
+    if not order:
+        print("Error: no call arc found in %s, is the program built with -pg?" % (args.gmon))
+        sys.exit(1)
+    sizes = {name: size for _, size, name in funcs}
+    with open(args.output, "w") as of:
+        if args.format == "ld":
+            of.write("/* Generated by funcorder.py from %s, %d functions, %d bytes */\n"
+                     % (args.gmon, len(order), sum(sizes.get(name, 0) for name in order)))
+            for name in order:
+                of.write("*(.text.%s)\n" % (name))
+        else:
+            for name in order:
+                of.write("%s\n" % (name))
+    print("Ordered %d functions of %d call arcs, written to %s" % (len(order), len(edges), args.output))
@@ -0,0 +1,121 @@
+#!/bin/env python3
+
+import re
+import sys
+import struct
+import argparse
+
+# functions run before hot code is copied, they must stay in flash
+BOOT_FUNCTIONS = ("_start", "_premain_init", "SystemInit", "__sync_harts", "Boot_SectionInit",
+                  "HotILM_Init", "main", "_init", "__libc_init_array", "memcpy")
+
+# row of gprof flat profile: %time cumulative self [calls self/call total/call] name
+FLAT_ROW = re.compile(r"^\s*([\d.]+)\s+[\d.]+\s+([\d.]+)\s+(?:\d+\s+[\d.]+\s+[\d.]+\s+)?([A-Za-z_.$][\w.$]*)\s*$")
+
+
+def parse_flat_profile(proffile):
+    """
+    Parse flat profile printed by gprof, such as riscv-nuclei-elf-gprof -b -p app.elf gmon.out
+
+    Returns:
+        list: (name, percent) of functions sorted by self time, hottest first
+    """
+    funcs = []
+    with open(proffile, "r") as pf:
+        for line in pf.readlines():
+            match = FLAT_ROW.match(line)
+            if match:
+                funcs.append((match.group(3), float(match.group(1))))
+    funcs.sort(key=lambda item: item[1], reverse=True)
+    return funcs
+
+
+def elf_function_sizes(elffile):
+    """ Return dict of function name to code size from symbol table of elf """
+    with open(elffile, "rb") as elf:
+        data = elf.read()
+    if data[:4] != b"\x7fELF":
+        raise ValueError("%s is not an elf file" % (elffile))
+    if data[4] == 2:
+        shoff, = struct.unpack_from("<Q", data, 0x28)
+        shentsize, shnum = struct.unpack_from("<HH", data, 0x3A)
+        shdr = struct.Struct("<IIQQQQIIQQ")
+        sym = struct.Struct("<IBBHQQ")
+    else:
+        shoff, = struct.unpack_from("<I", data, 0x20)
+        shentsize, shnum = struct.unpack_from("<HH", data, 0x2E)
+        shdr = struct.Struct("<IIIIIIIIII")
+        sym = struct.Struct("<IIIBBH")
+    sections = [shdr.unpack_from(data, shoff + i * shentsize) for i in range(shnum)]
+    sizes = {}
+    for sec in sections:
+        # SHT_SYMTAB
+        if sec[1] != 2:
+            continue
+        offset, size, link, entsize = sec[4], sec[5], sec[6], sec[9]
+        stroff = sections[link][4]
+        for j in range(size // entsize):
+            fields = sym.unpack_from(data, offset + j * entsize)
+            if data[4] == 2:
+                name, info, fsize = fields[0], fields[1], fields[5]
+            else:
+                name, fsize, info = fields[0], fields[2], fields[3]
+            # STT_FUNC
+            if (info & 0xF) == 2:
+                end = data.find(b"\0", stroff + name)
+                fname = data[stroff + name:end].decode()
+                sizes[fname] = max(sizes.get(fname, 0), fsize)
+    return sizes
+
+
+def select_hot(funcs, sizes, budget, coverage):
+    """ Pick hottest functions until coverage percent of time is reached or budget bytes is used """
+    selected = []
+    used = 0
+    covered = 0.0
+    for name, percent in funcs:
+        if covered >= coverage or percent <= 0:
+            break
+        if name in BOOT_FUNCTIONS:
+            continue
+        size = sizes.get(name, 0) if sizes is not None else 0
+        if sizes is not None and name not in sizes:
+            # not a function of the elf, such as a gprof pseudo entry
+            continue
+        if budget and used + size > budget:
+            continue
+        selected.append((name, percent, size))
+        used += size
+        covered += percent
+    return selected, used, covered
+
+
+# Usage:
+# riscv-nuclei-elf-gprof -b -p build/app.elf gmon.out > flat.txt
+# python nuclei_sdk/tools/scripts/hotilm.py --elf build/app.elf --budget 32768 flat.txt hot_ilm.ld
+# then INCLUDE hot_ilm.ld in .ilm_text output section of linker script, and build with -ffunction-sections
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Generate linker patterns placing hot functions of gprof profile into ILM")
+    parser.add_argument("--elf", help="elf file, used to get function sizes for budget")
+    parser.add_argument("--budget", type=int, default=0, help="max code bytes placed in ILM, 0 for no limit")
+    parser.add_argument("--coverage", type=float, default=90.0, help="stop when selected functions take this percent of time")
+    parser.add_argument("profile", help="gprof flat profile text")
+    parser.add_argument("output", help="generated linker script fragment")
+    args = parser.parse_args()
+
+    funcs = parse_flat_profile(args.profile)
+    if not funcs:
+        print("Error: no function found in flat profile %s" % (args.profile))
+        sys.exit(1)
+    if args.budget and not args.elf:
+        print("Error: --budget requires --elf to know function sizes")
+        sys.exit(1)
+    sizes = elf_function_sizes(args.elf) if args.elf else None
+    selected, used, covered = select_hot(funcs, sizes, args.budget, args.coverage)
+    with open(args.output, "w") as of:
+        of.write("/* Generated by hotilm.py from %s, %.2f%% of time, %d bytes */\n" % (args.profile, covered, used))
+        for name, percent, size in selected:
+            of.write("*(.text.%s) /* %.2f%%, %d bytes */\n" % (name, percent, size))
+    for name, percent, size in selected:
+        print("%6.2f%% %6d bytes  %s" % (percent, size, name))
+    print("Selected %d functions, %.2f%% of time, %d bytes, written to %s" % (len(selected), covered, used, args.output))
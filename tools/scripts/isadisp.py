@@ -0,0 +1,45 @@
+#!/bin/env python3
+
+import sys
+import shutil
+import argparse
+import subprocess
+import tempfile
+
+# must match Components/isadisp/isadisp.c
+VARIANTS = {"scalar": "isadisp_scalar_", "dsp": "isadisp_dsp_", "vector": "isadisp_vector_"}
+
+
+def defined_symbols(nm, lib):
+    """ Global symbols defined by objects of lib """
+    out = subprocess.run([nm, "-g", "--defined-only", "-P", lib], check=True, capture_output=True,
+                         text=True).stdout
+    syms = set()
+    for line in out.splitlines():
+        fields = line.split()
+        # archive member lines end with ':' and have no type
+        if len(fields) >= 2 and not fields[0].endswith(":") and fields[1] not in ("U", "w", "v"):
+            syms.add(fields[0])
+    return sorted(syms)
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Prefix symbols of one ISA variant of a library for isadisp middleware")
+    parser.add_argument("--variant", choices=VARIANTS.keys(), required=True, help="ISA variant of the library")
+    parser.add_argument("--prefix", default="riscv-nuclei-elf-", help="prefix of binutils, default riscv-nuclei-elf-")
+    parser.add_argument("input", help="library built for the variant, such as libnmsis_dsp_rv32imafdcv.a")
+    parser.add_argument("output", help="library with prefixed symbols")
+    args = parser.parse_args()
+
+    prefix = VARIANTS[args.variant]
+    syms = defined_symbols(args.prefix + "nm", args.input)
+    if len(syms) == 0:
+        print("Error: no symbol defined in %s" % (args.input))
+        sys.exit(1)
+    # calls between kernels and tables of the library are renamed too, undefined libc ones are kept
+    with tempfile.NamedTemporaryFile("w", suffix=".syms", delete=False) as sf:
+        for sym in syms:
+            sf.write("%s %s%s\n" % (sym, prefix, sym))
+    shutil.copyfile(args.input, args.output)
+    subprocess.run([args.prefix + "objcopy", "--redefine-syms=" + sf.name, args.output], check=True)
+    print("%s: %d symbols prefixed with %s" % (args.output, len(syms), prefix))
@@ -0,0 +1,137 @@
+#!/bin/env python3
+
+import sys
+import struct
+import argparse
+
+LZ4_MAGIC = b"NLZ4DATA"
+LZ4_MINMATCH = 4
+# lz4 block rules: last 5 bytes are literals, last match starts 12 bytes before end
+LZ4_LASTLITERALS = 5
+LZ4_MFLIMIT = 12
+
+
+def lz4_compress(data):
+    """ Compress data into one lz4 block with greedy hash matching """
+    out = bytearray()
+    table = {}
+    size = len(data)
+    anchor = pos = 0
+
+    def put_length(value):
+        while value >= 255:
+            out.append(255)
+            value -= 255
+        out.append(value)
+
+    while pos + LZ4_MFLIMIT <= size:
+        key = data[pos:pos + LZ4_MINMATCH]
+        cand = table.get(key)
+        table[key] = pos
+        if cand is None or pos - cand > 0xFFFF:
+            pos += 1
+            continue
+        mlen = LZ4_MINMATCH
+        while pos + mlen < size - LZ4_LASTLITERALS and data[cand + mlen] == data[pos + mlen]:
+            mlen += 1
+        lit = pos - anchor
+        out.append((min(lit, 15) << 4) | min(mlen - LZ4_MINMATCH, 15))
+        if lit >= 15:
+            put_length(lit - 15)
+        out += data[anchor:pos]
+        out += struct.pack("<H", pos - cand)
+        if mlen - LZ4_MINMATCH >= 15:
+            put_length(mlen - LZ4_MINMATCH - 15)
+        pos += mlen
+        anchor = pos
+    lit = size - anchor
+    out.append(min(lit, 15) << 4)
+    if lit >= 15:
+        put_length(lit - 15)
+    out += data[anchor:]
+    return bytes(out)
+
+
+def elf_symbols_and_base(elffile):
+    """ Return symbol dict and lowest load address of the elf, which is the start of objcopy binary """
+    with open(elffile, "rb") as elf:
+        data = elf.read()
+    if data[:4] != b"\x7fELF":
+        raise ValueError("%s is not an elf file" % (elffile))
+    is64 = data[4] == 2
+    if is64:
+        phoff, shoff = struct.unpack_from("<QQ", data, 0x20)
+        phentsize, phnum, shentsize, shnum = struct.unpack_from("<HHHH", data, 0x36)
+        phdr = struct.Struct("<IIQQQQQQ")
+        shdr = struct.Struct("<IIQQQQIIQQ")
+        sym = struct.Struct("<IBBHQQ")
+    else:
+        phoff, shoff = struct.unpack_from("<II", data, 0x1C)
+        phentsize, phnum, shentsize, shnum = struct.unpack_from("<HHHH", data, 0x2A)
+        phdr = struct.Struct("<IIIIIIII")
+        shdr = struct.Struct("<IIIIIIIIII")
+        sym = struct.Struct("<IIIBBH")
+    base = None
+    for i in range(phnum):
+        fields = phdr.unpack_from(data, phoff + i * phentsize)
+        if is64:
+            ptype, paddr, filesz = fields[0], fields[4], fields[5]
+        else:
+            ptype, paddr, filesz = fields[0], fields[3], fields[4]
+        # PT_LOAD with content
+        if ptype == 1 and filesz > 0 and (base is None or paddr < base):
+            base = paddr
+    sections = [shdr.unpack_from(data, shoff + i * shentsize) for i in range(shnum)]
+    symbols = {}
+    for sec in sections:
+        # SHT_SYMTAB
+        if sec[1] != 2:
+            continue
+        offset, size, link, entsize = sec[4], sec[5], sec[6], sec[9]
+        stroff = sections[link][4]
+        for j in range(size // entsize):
+            fields = sym.unpack_from(data, offset + j * entsize)
+            name, value = fields[0], (fields[4] if is64 else fields[1])
+            end = data.find(b"\0", stroff + name)
+            symbols[data[stroff + name:end].decode()] = value
+    return symbols, base
+
+
+# Usage:
+# python nuclei_sdk/tools/scripts/lz4data.py build/app.elf build/app.bin build/app_lz4.bin
+# build with -DNUCLEI_BOOT_FASTINIT=1 and program app_lz4.bin instead of app.bin
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Compress .data load image of objcopy binary for NUCLEI_BOOT_FASTINIT")
+    parser.add_argument("elf", help="elf file, used to find .data load address")
+    parser.add_argument("bin", help="binary file generated from elf by objcopy")
+    parser.add_argument("output", help="output binary file with compressed .data")
+    args = parser.parse_args()
+
+    symbols, base = elf_symbols_and_base(args.elf)
+    for name in ("_data_lma", "_data", "_edata"):
+        if name not in symbols:
+            print("Error: symbol %s not found in %s" % (name, args.elf))
+            sys.exit(1)
+    with open(args.bin, "rb") as bf:
+        image = bf.read()
+    lma = symbols["_data_lma"] - base
+    rawsize = symbols["_edata"] - symbols["_data"]
+    if symbols["_data_lma"] == symbols["_data"] or rawsize == 0:
+        print("Error: .data is not loaded from another address, nothing to compress")
+        sys.exit(1)
+    if lma < 0 or lma + rawsize > len(image):
+        print("Error: .data load image is not in %s" % (args.bin))
+        sys.exit(1)
+    # .data is the last load image, anything after it would be cut
+    if lma + rawsize != len(image):
+        print("Error: .data load image is not at the end of %s" % (args.bin))
+        sys.exit(1)
+    block = lz4_compress(image[lma:lma + rawsize])
+    if len(block) + 16 >= rawsize:
+        print("Warning: .data doesn't compress, keep it as it is")
+        output = image
+    else:
+        output = image[:lma] + LZ4_MAGIC + struct.pack("<II", rawsize, len(block)) + block
+    with open(args.output, "wb") as of:
+        of.write(output)
+    print(".data %d bytes -> %d bytes, image %d bytes -> %d bytes" % (rawsize, len(output) - lma, len(image), len(output)))
@@ -0,0 +1,112 @@
+#!/bin/env python3
+
+import sys
+import struct
+import argparse
+
+# must match NMSIS/NN/Include/riscv_nn_packed.h
+PACKED_MAGIC = 0x4b504e4e
+PACKED_ROWS = 1
+PACKED_BLOCKS = 2
+PACKED_ROW_ALIGN = 4
+PACK_COLS = 16
+
+FORMATS = {"rows": PACKED_ROWS, "blocks": PACKED_BLOCKS}
+
+
+def pack_bias(weights, bias, rows, cols, lhs_offset):
+    """ Bias with lhs_offset times the sum of weights of each channel folded in """
+    out = []
+    for c in range(rows):
+        out.append((bias[c] if bias else 0) + lhs_offset * sum(weights[c * cols:(c + 1) * cols]))
+    return out
+
+
+def pack_rows(weights, rows, cols):
+    """ One channel per row, rows zero padded to PACKED_ROW_ALIGN bytes """
+    row_size = (cols + PACKED_ROW_ALIGN - 1) // PACKED_ROW_ALIGN * PACKED_ROW_ALIGN
+    out = []
+    for c in range(rows):
+        out += weights[c * cols:(c + 1) * cols] + [0] * (row_size - cols)
+    return out
+
+
+def pack_blocks(weights, rows, cols, block):
+    """ Blocks of block channels stored k major, channels past rows are zero """
+    out = []
+    for b in range((rows + block - 1) // block):
+        for k in range(cols):
+            for j in range(block):
+                c = b * block + j
+                out.append(weights[c * cols + k] if c < rows else 0)
+    return out
+
+
+def c_array(ctype, name, values, per_line):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(str(v) for v in values[i:i + per_line]) + ",")
+    return "static const %s %s[%d] __attribute__((aligned(4))) = {\n%s\n};\n" % (ctype, name, len(values), "\n".join(lines))
+
+
+def read_values(filename, fmt, count):
+    with open(filename, "rb") as f:
+        data = f.read()
+    size = struct.calcsize(fmt)
+    if len(data) != size * count:
+        print("Error: %s is %d bytes, expect %d" % (filename, len(data), size * count))
+        sys.exit(1)
+    return list(struct.unpack("<%d%s" % (count, fmt), data))
+
+
+# Usage:
+# python nuclei_sdk/tools/scripts/nnpack.py --rows 64 --cols 288 --lhs-offset 128 --format blocks \
+#     --bias fc1_bias.bin fc1_weights.bin fc1 fc1_packed.h
+# weights are rows x cols int8, bias is rows int32 little endian, include fc1_packed.h and
+# pass &fc1 to the riscv_nn_*_packed kernels
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Pack int8 weights offline for the riscv_nn_*_packed kernels of NMSIS-NN")
+    parser.add_argument("--rows", type=int, required=True, help="output channels")
+    parser.add_argument("--cols", type=int, required=True, help="weights of one output channel")
+    parser.add_argument("--lhs-offset", type=int, default=0, help="input offset of the layer, folded in bias")
+    parser.add_argument("--format", choices=FORMATS.keys(), default="blocks",
+                        help="blocks for RVV targets, rows for P-ext and C targets")
+    parser.add_argument("--block", type=int, default=PACK_COLS, help="channels of block, RISCV_NN_PACK_COLS of the target")
+    parser.add_argument("--bias", help="binary file of int32 bias")
+    parser.add_argument("--section", help="section of the arrays, such as .rodata.xip")
+    parser.add_argument("weights", help="binary file of int8 weights, one row of cols per channel")
+    parser.add_argument("name", help="name of riscv_nn_packed_t in the output")
+    parser.add_argument("output", help="output c header")
+    args = parser.parse_args()
+
+    if args.rows <= 0 or args.cols <= 0 or args.block <= 0:
+        print("Error: rows, cols and block must be positive")
+        sys.exit(1)
+    weights = read_values(args.weights, "b", args.rows * args.cols)
+    bias = read_values(args.bias, "i", args.rows) if args.bias else None
+    if args.format == "rows":
+        packed, block = pack_rows(weights, args.rows, args.cols), 1
+    else:
+        packed, block = pack_blocks(weights, args.rows, args.cols, args.block), args.block
+    packed_bias = pack_bias(weights, bias, args.rows, args.cols, args.lhs_offset)
+    if any(v < -(1 << 31) or v >= (1 << 31) for v in packed_bias):
+        print("Error: packed bias overflows int32")
+        sys.exit(1)
+
+    out = "// Generated by tools/scripts/nnpack.py, don't edit\n"
+    out += "#include \"riscv_nn_packed.h\"\n\n"
+    weights_c = c_array("int8_t", args.name + "_weights", packed, 16)
+    bias_c = c_array("int32_t", args.name + "_bias", packed_bias, 8)
+    if args.section:
+        attr = "__attribute__((aligned(4), section(\"%s\")))" % (args.section)
+        weights_c = weights_c.replace("__attribute__((aligned(4)))", attr)
+        bias_c = bias_c.replace("__attribute__((aligned(4)))", attr)
+    out += weights_c + "\n" + bias_c + "\n"
+    out += "static const riscv_nn_packed_t %s = {\n" % (args.name)
+    out += "    0x%08xUL, %d, %d, %d, %d, %d, %s_bias, %s_weights\n};\n" % (PACKED_MAGIC, FORMATS[args.format], block,
+                                                                           args.rows, args.cols, args.lhs_offset,
+                                                                           args.name, args.name)
+    with open(args.output, "w") as of:
+        of.write(out)
+    print("%s: %d x %d weights, %s format, block %d, %d bytes" % (args.name, args.rows, args.cols, args.format,
+                                                                 block, len(packed)))